@@ -49,6 +49,54 @@ extern "C" {
 /* EXPORTED CONSTANTS */
 /*--------------------------------------------------------------------------------------------------------*/
 
+/**
+ * @def ADC_SAMPLE_CONTINUOUS
+ * @brief The sample count which makes a sampling continuous, running until it is halted.
+ */
+#define ADC_SAMPLE_CONTINUOUS			((uint32_t) 0U)
+
+/**
+ * @def ADC_OUTPUT_BUDGET_DEFAULT_US
+ * @brief The default longest time in microseconds a single service of the sampling state spends writing out samples.
+ */
+#define ADC_OUTPUT_BUDGET_DEFAULT_US	((uint32_t) 2000U)
+
+/**
+ * @def ADC_OUTPUT_BUDGET_MIN_US
+ * @brief The smallest longest output time which may be set, in microseconds.
+ */
+#define ADC_OUTPUT_BUDGET_MIN_US		((uint32_t) 100U)
+
+/**
+ * @def ADC_OUTPUT_BUDGET_MAX_US
+ * @brief The largest longest output time which may be set, in microseconds.
+ */
+#define ADC_OUTPUT_BUDGET_MAX_US		((uint32_t) 100000U)
+
+/**
+ * @def ADC_SNAPSHOT_MIN_PERIOD_US
+ * @brief The shortest snapshot frame period in microseconds.
+ */
+#define ADC_SNAPSHOT_MIN_PERIOD_US		((uint32_t) 100U)
+
+/**
+ * @def ADC_SNAPSHOT_MAX_PERIOD_US
+ * @brief The longest snapshot frame period in microseconds.
+ */
+#define ADC_SNAPSHOT_MAX_PERIOD_US		((uint32_t) 10000000U)
+
+/**
+ * @def ADC_PACED_MIN_INTERVAL_US
+ * @brief The shortest scan interval of paced sampling in microseconds.
+ */
+#define ADC_PACED_MIN_INTERVAL_US		((uint32_t) 1000U)
+
+/**
+ * @def ADC_PACED_MAX_INTERVAL_US
+ * @brief The longest scan interval of paced sampling in microseconds, the most the frame timer can count.
+ */
+#define ADC_PACED_MAX_INTERVAL_US		((uint32_t) 50000000U)
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* EXPORTED TYPES */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -68,6 +116,43 @@ typedef enum {
 	ADC_EXTERNAL_MUXING /**< The external multiplexer is switching inputs. Sample the cold junction temperature. */
 } ADC_State_t;
 
+/**
+ * @brief Cold junction refresh policy definitions.
+ * Defines how the interval between cold junction samples taken during external multiplexer switches is measured.
+ */
+typedef enum {
+	ADC_CJ_REFRESH_TIME, /**< The interval is a time in microseconds. */
+	ADC_CJ_REFRESH_SCANS /**< The interval is a number of completed multi-channel scans. */
+} ADC_ColdJunctionRefresh_t;
+
+/**
+ * @brief Analog sample buffer overflow policy definitions.
+ * Defines what happens when samples are produced faster than the writers drain an input's buffer.
+ */
+typedef enum {
+	ADC_OVERFLOW_DROP_NEWEST, /**< A sample arriving at a full buffer is dropped. The default. */
+	ADC_OVERFLOW_DROP_OLDEST, /**< The oldest samples are discarded to keep room for the newest. */
+	ADC_OVERFLOW_PAUSE, /**< Conversions are held off until the buffer has room again, so no sample is lost. */
+	NUM_ADC_OVERFLOW_POLICIES /**< The number of policies, also returned for an invalid string. */
+} ADC_OverflowPolicy_t;
+
+/**
+ * @brief The state of the burst capture.
+ * A burst capture stores the raw codes of a single input in the CCM-RAM left free by the linker, without formatting
+ * or sending anything until it is complete. The codes are kept, and may be downloaded, until the next capture.
+ */
+typedef struct {
+	PhysicalAnalogInput_t input; /**< The input which was captured. */
+	uint32_t capacity; /**< The most codes the capture buffer holds. */
+	uint32_t requested; /**< The number of codes the capture was asked for, up to capacity. */
+	volatile uint32_t count; /**< The number of codes captured. */
+	volatile uint64_t start; /**< The DRDY time of the first code. */
+	volatile uint64_t end; /**< The DRDY time of the last code. */
+	volatile bool active; /**< TRUE while the capture is converting. */
+	bool downloading; /**< TRUE while the codes are being sent to the data connection. */
+	uint32_t downloaded; /**< The number of codes the download has sent. */
+} ADC_BurstCapture_t;
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* INITIALIZATION METHODS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -104,7 +189,12 @@ void ADC_Machine_Service(void);
 /**
  * @brief Halt any current operations and return the idle state.
  */
-void ADC_Machine_Halt(void);
+void ADC_Machine_Halt(bool discard);
+
+/**
+ * @brief Handles the snapshot frame timer interrupt.
+ */
+void ADC_Machine_FrameIRQHandler(void);
 
 /*--------------------------------------------------------------------------------------------------------*/
 /* STATE METHODS */
@@ -120,6 +210,21 @@ void ADC_Machine_Idle(void);
  */
 void ADC_Machine_Input_Sample(Analog_Input_t** inputs, uint32_t count, bool singleChannel);
 
+/**
+ * @brief Starts a burst capture of an input into the free CCM-RAM.
+ */
+bool ADC_Machine_StartBurstCapture(Analog_Input_t* input, uint32_t count);
+
+/**
+ * @brief Starts sending the codes of the last burst capture to the data connection.
+ */
+bool ADC_Machine_ReadBurstCapture(void);
+
+/**
+ * @brief Starts computing the spectrum of the last burst capture.
+ */
+bool ADC_Machine_ReadBurstSpectrum(uint16_t points, uint8_t peaks, uint32_t* binWidth);
+
 /**
  * @brief Reset state handler.
  */
@@ -130,6 +235,123 @@ void ADC_Machine_Reset(void);
  */
 void ADC_External_Muxing(void);
 
+/*--------------------------------------------------------------------------------------------------------*/
+/* CONFIGURATION METHODS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Set the cold junction refresh policy used during external multiplexer switches.
+ */
+void ADC_Machine_SetColdJunctionRefresh(ADC_ColdJunctionRefresh_t policy, uint32_t interval);
+
+/**
+ * @brief Set when offset calibrations are made between scans while sampling.
+ */
+void ADC_Machine_SetBackgroundCalibration(uint32_t interval, float temperatureDelta);
+
+/**
+ * @brief Set how often the sensors of the sampled inputs are checked for an open circuit.
+ */
+void ADC_Machine_SetSensorCheck(uint32_t interval, ADS1256_SENSOR_DETECT_t current);
+
+/**
+ * @brief Set what happens when an analog input's buffer fills up during the next sampling.
+ */
+void ADC_Machine_SetOverflowPolicy(ADC_OverflowPolicy_t policy);
+
+/**
+ * @brief Set the frame period of snapshot mode for the next multi-channel sampling.
+ */
+void ADC_Machine_SetSnapshotPeriod(uint32_t period);
+
+/**
+ * @brief Set the longest time a service of the sampling state may spend writing out samples.
+ */
+void ADC_Machine_SetOutputBudget(uint32_t budget);
+
+/**
+ * @brief Fill in the calibration values of every added input whose register image is out of date.
+ */
+void ADC_Machine_PrepareInputs(void);
+
+/**
+ * @brief Set the scan interval of paced sampling for the next sampling.
+ */
+void ADC_Machine_SetScanInterval(uint32_t interval);
+
+/**
+ * @brief Convert a human readable string into the relevant ADC_OverflowPolicy_t value.
+ */
+ADC_OverflowPolicy_t ADC_Machine_StringToOverflowPolicy(const char* str);
+
+/**
+ * @brief Retrieves the number of background offset calibrations made since start up.
+ */
+uint32_t ADC_Machine_GetBackgroundCalibrationCount(void);
+
+/**
+ * @brief Retrieves the number of sensor checks made since start up.
+ */
+uint32_t ADC_Machine_GetSensorCheckCount(void);
+
+/**
+ * @brief Determines if the latest sensor check of a physical input found it open circuit.
+ */
+bool ADC_Machine_IsSensorOpen(PhysicalAnalogInput_t input);
+
+/**
+ * @brief Estimates the time a multi-channel scan spends refreshing the cold junction.
+ */
+float ADC_Machine_GetColdJunctionTime(float scanTime, uint8_t externalInputs);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* STATUS METHODS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Retrieves the current state of the ADC state machine.
+ */
+ADC_State_t ADC_Machine_GetState(void);
+
+/**
+ * @brief Retrieves the number of samples dropped because their input's buffer was full.
+ */
+uint32_t ADC_Machine_GetOverrunCount(void);
+
+/**
+ * @brief Retrieves the number of conversions read since start up.
+ */
+uint32_t ADC_Machine_GetConversionCount(void);
+
+/**
+ * @brief Retrieves the number of samples produced for a physical input since start up.
+ */
+uint32_t ADC_Machine_GetInputSampleCount(PhysicalAnalogInput_t input);
+
+/**
+ * @brief Retrieves the number of snapshot frames missed because the previous scan had not finished.
+ */
+uint32_t ADC_Machine_GetSnapshotMissedFrames(void);
+
+/**
+ * @brief Retrieves the number of analog inputs being sampled.
+ */
+uint8_t ADC_Machine_GetSamplingInputCount(void);
+
+/**
+ * @brief Retrieves the number of samples waiting in the buffers of the inputs being sampled.
+ */
+uint32_t ADC_Machine_GetBufferedSampleCount(void);
+
+/**
+ * @brief Retrieves the state of the burst capture.
+ */
+void ADC_Machine_GetBurstCapture(ADC_BurstCapture_t* capture);
+
+/**
+ * @brief Retrieves the codes held by the burst capture buffer.
+ */
+const uint8_t* ADC_Machine_GetBurstCaptureCodes(void);
 
 
 #ifdef __cplusplus
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file AnalogInput_Aux.h
+ * @brief Header file for the auxiliary analog inputs read by the processor's own ADC.
+ *
+ * Contains public definitions and data types for the auxiliary analog inputs, the board health and fast low
+ * resolution signals described by AUX_ANALOG_TABLE, which the processor's 12 bit ADC converts continuously beside the
+ * ADS1256 and whose latest readings can be captured with each analog scan.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef ANALOGINPUT_AUX_H_
+#define ANALOGINPUT_AUX_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "Tekdaqc_BSP.h"
+#include "stm32f4xx.h"
+#include "boolean.h"
+
+/** @addtogroup tekdaqc_firmware Tekdaqc Firmware
+ * @{
+ */
+
+/** @addtogroup analog_input_aux Auxiliary Analog Inputs
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def AUX_ANALOG_OVERSAMPLE
+ * @brief The number of scans of the auxiliary inputs the DMA keeps and each reading sums. 16 sums of 12 bit
+ * conversions fill exactly 16 bits.
+ */
+#define AUX_ANALOG_OVERSAMPLE	16U
+
+/**
+ * @def AUX_ANALOG_FULL_SCALE
+ * @brief The reading of an auxiliary input at the ADC reference.
+ */
+#define AUX_ANALOG_FULL_SCALE	((uint32_t) (4095U * AUX_ANALOG_OVERSAMPLE))
+
+/**
+ * @def ANALOG_AUX_BUFFER_SIZE
+ * @brief The number of captured readings waiting to be written which are kept. Must be a power of 2.
+ */
+#define ANALOG_AUX_BUFFER_SIZE	32U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Data structure holding the auxiliary readings captured with an analog scan.
+ */
+typedef struct {
+	uint64_t timestamp; /**< The timestamp of the scan's first sample. */
+	uint16_t values[NUM_AUX_ANALOG_INPUTS]; /**< The reading of each auxiliary input, in AUX_ANALOG_TABLE order. */
+} AnalogAuxState_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Configures the processor's ADC and starts converting the auxiliary inputs.
+ */
+void AnalogAux_Init(void);
+
+/**
+ * @brief Retrieves the latest reading of an auxiliary input.
+ */
+uint16_t AnalogAux_Read(uint8_t input);
+
+/**
+ * @brief Converts a reading of an auxiliary input to millivolts at the signal.
+ */
+uint32_t AnalogAux_ToMillivolts(uint8_t input, uint16_t value);
+
+/**
+ * @brief Retrieves the name of an auxiliary input.
+ */
+const char* AnalogAux_GetName(uint8_t input);
+
+/**
+ * @brief Turns the capture of the auxiliary readings with each analog scan on or off.
+ */
+void AnalogAux_SetEnabled(bool enabled);
+
+/**
+ * @brief Determines if the auxiliary readings are captured with each analog scan.
+ */
+bool AnalogAux_IsEnabled(void);
+
+/**
+ * @brief Discards the captured readings waiting to be written.
+ */
+void AnalogAux_Reset(void);
+
+/**
+ * @brief Captures the auxiliary readings at the instant of an analog scan.
+ */
+void AnalogAux_Capture(uint64_t timestamp);
+
+/**
+ * @brief Determines if any captured readings are waiting to be written.
+ */
+bool AnalogAux_IsPending(void);
+
+/**
+ * @brief Retrieves the oldest captured readings waiting to be written.
+ */
+uint32_t AnalogAux_PeekStates(const AnalogAuxState_t** oldest);
+
+/**
+ * @brief Releases captured readings which have been written.
+ */
+void AnalogAux_ReleaseStates(uint32_t count);
+
+/**
+ * @brief Retrieves the number of captured readings dropped since sampling started because the buffer was full.
+ */
+uint32_t AnalogAux_GetDroppedCount(void);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ANALOGINPUT_AUX_H_ */
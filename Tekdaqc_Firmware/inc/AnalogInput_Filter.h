@@ -0,0 +1,168 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file AnalogInput_Filter.h
+ * @brief Header file for the analog input filters.
+ *
+ * Contains public definitions and data types for the decimating filters which may be applied to the samples of an
+ * analog input before they are buffered, so that slow signals can be reported at a fraction of the ADC's rate.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef ANALOGINPUT_FILTER_H_
+#define ANALOGINPUT_FILTER_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "stm32f4xx.h"
+#include "boolean.h"
+
+/** @addtogroup tekdaqc_firmware Tekdaqc Firmware
+ * @{
+ */
+
+/** @addtogroup analog_input_filter Analog Input Filter
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def ANALOG_FILTER_MAX_DECIMATION
+ * @brief The largest number of samples which may be combined into a single filtered sample.
+ */
+#define ANALOG_FILTER_MAX_DECIMATION	1024U
+
+/**
+ * @def ANALOG_FILTER_CIC_ORDER
+ * @brief The number of integrator and comb stages of the CIC filter.
+ */
+#define ANALOG_FILTER_CIC_ORDER			3U
+
+/**
+ * @def ANALOG_FILTER_FIR_TAPS
+ * @brief The number of taps of the FIR filter.
+ */
+#define ANALOG_FILTER_FIR_TAPS			16U
+
+/**
+ * @def ANALOG_FILTER_FIR_MAX_DECIMATION
+ * @brief The largest decimation the FIR filter supports. Beyond this its cutoff is too narrow for its taps to
+ * realize and the CIC filter should be used instead.
+ */
+#define ANALOG_FILTER_FIR_MAX_DECIMATION	8U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Analog input filter type enumeration.
+ * Defines the filters which may be applied to the samples of an analog input.
+ */
+typedef enum {
+	ANALOG_FILTER_NONE, /**< Samples are passed through unchanged. */
+	ANALOG_FILTER_AVERAGE, /**< Each output is the average of the preceding block of samples. */
+	ANALOG_FILTER_CIC, /**< A cascaded integrator comb decimator, for large decimations. */
+	ANALOG_FILTER_FIR, /**< A windowed sinc low pass FIR decimator, for small decimations. */
+	NUM_ANALOG_FILTER_TYPES /**<@internal The total number of filter types. */
+} AnalogFilterType_t;
+
+/**
+ * @brief Data structure holding the configuration and state of an analog input filter.
+ * Only the state of the configured filter type is kept, so the filter must be reset whenever its type changes.
+ */
+typedef struct {
+	AnalogFilterType_t type; /**< The filter applied. */
+	uint16_t decimation; /**< The number of input samples per output sample. */
+	uint16_t count; /**< The number of input samples since the last output sample. */
+	bool primed; /**< TRUE once the filter has settled and its outputs are valid. */
+	union {
+		struct {
+			int64_t sum; /**< The sum of the samples of the current block. */
+		} average;
+		struct {
+			uint64_t integrators[ANALOG_FILTER_CIC_ORDER]; /**< The integrator stages, which wrap by design. */
+			uint64_t combs[ANALOG_FILTER_CIC_ORDER]; /**< The delayed values of the comb stages. */
+			int64_t scale; /**< The DC gain of the filter, decimation ^ ANALOG_FILTER_CIC_ORDER. */
+			uint8_t settling; /**< The number of outputs remaining before the combs have settled. */
+		} cic;
+		struct {
+			int16_t coefficients[ANALOG_FILTER_FIR_TAPS]; /**< The Q15 filter coefficients, summing to unity. */
+			int32_t history[ANALOG_FILTER_FIR_TAPS]; /**< The most recent input samples. */
+			uint8_t newest; /**< The index of the newest sample in the history. */
+		} fir;
+	} state;
+} AnalogFilter_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Initializes a filter to pass samples through unchanged.
+ */
+void AnalogFilter_Init(AnalogFilter_t* filter);
+
+/**
+ * @brief Configures the type and decimation of a filter.
+ */
+bool AnalogFilter_Configure(AnalogFilter_t* filter, AnalogFilterType_t type, uint16_t decimation);
+
+/**
+ * @brief Discards the state of a filter so it starts again from the next sample.
+ */
+void AnalogFilter_Reset(AnalogFilter_t* filter);
+
+/**
+ * @brief Passes a sample through a filter.
+ */
+bool AnalogFilter_Process(AnalogFilter_t* filter, int32_t* value);
+
+/**
+ * @brief Return the human readable string representation of the provided filter type.
+ */
+const char* AnalogFilter_StringFromType(AnalogFilterType_t type);
+
+/**
+ * @brief Convert a human readable string into the relevant AnalogFilterType_t value.
+ */
+AnalogFilterType_t AnalogFilter_StringToType(const char* str);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ANALOGINPUT_FILTER_H_ */
@@ -0,0 +1,228 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file AnalogInput_Math.h
+ * @brief Header file for the analog input math channels.
+ *
+ * Contains public definitions and data types for the math channels, which derive a value from the samples of one or
+ * more analog inputs with a short arithmetic expression, compiled once to bytecode and evaluated for every scan.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef ANALOGINPUT_MATH_H_
+#define ANALOGINPUT_MATH_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "Tekdaqc_BSP.h"
+#include "stm32f4xx.h"
+#include "boolean.h"
+
+/** @addtogroup tekdaqc_firmware Tekdaqc Firmware
+ * @{
+ */
+
+/** @addtogroup analog_input_math Analog Input Math
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def ANALOG_MATH_MAX_CHANNELS
+ * @brief The number of math channels which may be defined.
+ */
+#define ANALOG_MATH_MAX_CHANNELS	8U
+
+/**
+ * @def ANALOG_MATH_MAX_CODE
+ * @brief The most bytecode instructions an expression may compile to.
+ */
+#define ANALOG_MATH_MAX_CODE		24U
+
+/**
+ * @def ANALOG_MATH_MAX_INPUTS
+ * @brief The most distinct analog inputs an expression may use.
+ */
+#define ANALOG_MATH_MAX_INPUTS		4U
+
+/**
+ * @def ANALOG_MATH_MAX_CONSTANTS
+ * @brief The most distinct constants an expression may use.
+ */
+#define ANALOG_MATH_MAX_CONSTANTS	8U
+
+/**
+ * @def ANALOG_MATH_MAX_STACK
+ * @brief The deepest evaluation stack an expression may need.
+ */
+#define ANALOG_MATH_MAX_STACK		8U
+
+/**
+ * @def ANALOG_MATH_MAX_EXPRESSION
+ * @brief The longest expression, including the NULL terminator.
+ */
+#define ANALOG_MATH_MAX_EXPRESSION	MAX_COMMANDPART_LENGTH
+
+/**
+ * @def ANALOG_MATH_FRACTION_BITS
+ * @brief The number of fractional bits of the fixed point values the bytecode works with.
+ */
+#define ANALOG_MATH_FRACTION_BITS	16U
+
+/**
+ * @def ANALOG_MATH_RESULT_BUFFER_SIZE
+ * @brief The number of results waiting to be written which are kept. Must be a power of 2.
+ */
+#define ANALOG_MATH_RESULT_BUFFER_SIZE	64U
+
+/**
+ * @def ANALOG_MATH_FLAG_SATURATED
+ * @brief Result flag set when a step of the evaluation exceeded the fixed point range and was clamped.
+ */
+#define ANALOG_MATH_FLAG_SATURATED	((uint8_t) 0x01)
+
+/**
+ * @def ANALOG_MATH_FLAG_DIVIDE_BY_ZERO
+ * @brief Result flag set when the evaluation divided by zero, whose quotient is clamped to the range.
+ */
+#define ANALOG_MATH_FLAG_DIVIDE_BY_ZERO	((uint8_t) 0x02)
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Math channel compilation status enumeration.
+ * The possible results of compiling an expression.
+ */
+typedef enum {
+	ANALOG_MATH_OK, /**< The expression was compiled. */
+	ANALOG_MATH_ERR_CHANNEL, /**< The channel number is out of range. */
+	ANALOG_MATH_ERR_SYNTAX, /**< The expression is not well formed. */
+	ANALOG_MATH_ERR_INPUT, /**< The expression uses an analog input which does not exist, or none at all. */
+	ANALOG_MATH_ERR_TOO_COMPLEX, /**< The expression needs more code, inputs, constants or stack than allowed. */
+	NUM_ANALOG_MATH_STATUSES /**<@internal The total number of statuses. */
+} AnalogMathStatus_t;
+
+/**
+ * @brief Data structure holding a math channel's compiled expression and state.
+ */
+typedef struct {
+	bool enabled; /**< True if the channel is defined. */
+	bool raw; /**< True if the samples of the channel's inputs are still written as well. */
+	char expression[ANALOG_MATH_MAX_EXPRESSION]; /**< The source of the expression. */
+	uint8_t length; /**< The number of bytecode instructions. */
+	uint8_t code[ANALOG_MATH_MAX_CODE]; /**< The bytecode, an opcode in the high nibble and operand in the low one. */
+	uint8_t numberInputs; /**< The number of distinct inputs used. */
+	PhysicalAnalogInput_t inputs[ANALOG_MATH_MAX_INPUTS]; /**< The inputs used, indexed by input operands. */
+	uint8_t numberConstants; /**< The number of distinct constants used. */
+	int64_t constants[ANALOG_MATH_MAX_CONSTANTS]; /**< The constants used, indexed by constant operands. */
+	int64_t values[ANALOG_MATH_MAX_INPUTS]; /**< The latest sample of each input in this scan. */
+	uint8_t fresh; /**< Bit field of the inputs sampled since the last evaluation. */
+	uint64_t timestamp; /**< The timestamp of the last input sampled. */
+	uint32_t evaluations; /**< The number of times the expression has been evaluated. */
+	uint32_t dropped; /**< The number of results dropped because the result buffer was full. */
+} AnalogMathChannel_t;
+
+/**
+ * @brief Data structure holding a result of a math channel.
+ */
+typedef struct {
+	uint64_t timestamp; /**< The timestamp of the last input sample of the scan the result is from. */
+	float value; /**< The value of the expression. */
+	uint8_t channel; /**< The number of the math channel. */
+	uint8_t flags; /**< The ANALOG_MATH_FLAG_ bits of the evaluation. */
+} AnalogMathResult_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Compiles an expression into a math channel.
+ */
+AnalogMathStatus_t AnalogMath_Set(uint8_t channel, const char* expression, bool raw);
+
+/**
+ * @brief Removes a math channel.
+ */
+bool AnalogMath_Clear(uint8_t channel);
+
+/**
+ * @brief Retrieves a copy of a math channel.
+ */
+bool AnalogMath_Get(uint8_t channel, AnalogMathChannel_t* copy);
+
+/**
+ * @brief Discards the partial scans and waiting results of every math channel.
+ */
+void AnalogMath_Reset(void);
+
+/**
+ * @brief Adds a sample to the math channels which use its input, evaluating those whose scan it completes.
+ */
+void AnalogMath_Process(PhysicalAnalogInput_t input, int32_t value, uint64_t timestamp);
+
+/**
+ * @brief Determines if the raw samples of an analog input are replaced by math channels.
+ */
+bool AnalogMath_IsRawHidden(PhysicalAnalogInput_t input);
+
+/**
+ * @brief Determines if any math channel results are waiting to be written.
+ */
+bool AnalogMath_IsPending(void);
+
+/**
+ * @brief Retrieves the oldest math channel results waiting to be written.
+ */
+uint32_t AnalogMath_PeekResults(const AnalogMathResult_t** oldest);
+
+/**
+ * @brief Releases math channel results which have been written.
+ */
+void AnalogMath_ReleaseResults(uint32_t count);
+
+/**
+ * @brief Convert an AnalogMathStatus_t value into a human readable string.
+ */
+const char* AnalogMath_StatusToString(AnalogMathStatus_t status);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ANALOGINPUT_MATH_H_ */
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file AnalogInput_Mixed.h
+ * @brief Header file for the mixed-signal state of the analog scans.
+ *
+ * Contains public definitions and data types for the mixed-signal state, the levels of the digital inputs and outputs
+ * captured at the instant of each analog scan so that they leave the board time aligned with its samples.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef ANALOGINPUT_MIXED_H_
+#define ANALOGINPUT_MIXED_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "Tekdaqc_BSP.h"
+#include "stm32f4xx.h"
+#include "boolean.h"
+
+/** @addtogroup tekdaqc_firmware Tekdaqc Firmware
+ * @{
+ */
+
+/** @addtogroup analog_input_mixed Analog Input Mixed-Signal State
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def ANALOG_MIXED_BUFFER_SIZE
+ * @brief The number of captured states waiting to be written which are kept. Must be a power of 2.
+ */
+#define ANALOG_MIXED_BUFFER_SIZE	64U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Data structure holding the digital state captured with an analog scan.
+ */
+typedef struct {
+	uint64_t timestamp; /**< The timestamp of the scan's first sample. */
+	uint32_t inputs; /**< The digital input levels, bit n set if GPIn was high. */
+	DigitalOutputMask_t outputs; /**< The digital output levels, bit n set if output n was on. */
+} AnalogMixedState_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Turns the capture of the digital state with each analog scan on or off.
+ */
+void AnalogMixed_SetEnabled(bool enabled);
+
+/**
+ * @brief Determines if the digital state is captured with each analog scan.
+ */
+bool AnalogMixed_IsEnabled(void);
+
+/**
+ * @brief Discards the captured states waiting to be written.
+ */
+void AnalogMixed_Reset(void);
+
+/**
+ * @brief Captures the digital state at the instant of an analog scan.
+ */
+void AnalogMixed_Capture(uint64_t timestamp);
+
+/**
+ * @brief Determines if any captured states are waiting to be written.
+ */
+bool AnalogMixed_IsPending(void);
+
+/**
+ * @brief Retrieves the oldest captured states waiting to be written.
+ */
+uint32_t AnalogMixed_PeekStates(const AnalogMixedState_t** oldest);
+
+/**
+ * @brief Releases captured states which have been written.
+ */
+void AnalogMixed_ReleaseStates(uint32_t count);
+
+/**
+ * @brief Retrieves the number of states dropped since sampling started because the buffer was full.
+ */
+uint32_t AnalogMixed_GetDroppedCount(void);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ANALOGINPUT_MIXED_H_ */
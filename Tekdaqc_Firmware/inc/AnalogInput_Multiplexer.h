@@ -55,6 +55,11 @@ extern "C" {
 /* EXPORTED TYPES */
 /*--------------------------------------------------------------------------------------------------------*/
 
+/**
+ * @brief Function pointer called from the settle timer interrupt once the external multiplexer has settled.
+ */
+typedef void (*MuxSettledCallback)(void);
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PUBLIC METHODS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -69,11 +74,26 @@ bool isExternalInput(PhysicalAnalogInput_t input);
  */
 bool isInternalInput(PhysicalAnalogInput_t input);
 
+/**
+ * @brief Determines if the specified input is a differential pair input.
+ */
+bool isDifferentialInput(PhysicalAnalogInput_t input);
+
 /**
  * @brief Checks to see if the external input muxing process has completed.
  */
 bool isExternalMuxingComplete(void);
 
+/**
+ * @brief Requests a callback from the settle timer interrupt once the external multiplexer has settled.
+ */
+bool ScheduleAfterExternalMuxing(MuxSettledCallback callback);
+
+/**
+ * @brief Called by the settle timer interrupt handler once the external multiplexer has settled.
+ */
+void InputMultiplexer_SettleIRQHandler(void);
+
 /**
  * @brief Initializes the analog input multiplexer.
  */
@@ -84,6 +104,11 @@ void InputMultiplexerInit(void);
  */
 void SelectAnalogInput(Analog_Input_t* input);
 
+/**
+ * @brief Starts switching the external multiplexer to an input ahead of its selection.
+ */
+void PrepareExternalInput(Analog_Input_t* input);
+
 /**
  * @brief Selects the specified physical input.
  */
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file AnalogInput_Power.h
+ * @brief Header file for the analog input power channels.
+ *
+ * Contains public definitions and data types for the computed power channels, which pair a voltage input with a
+ * current input of the same scan and report the true RMS of each, the real power and the power factor over windows of
+ * whole cycles of the voltage.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef ANALOGINPUT_POWER_H_
+#define ANALOGINPUT_POWER_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "Tekdaqc_BSP.h"
+#include "stm32f4xx.h"
+#include "boolean.h"
+
+/** @addtogroup tekdaqc_firmware Tekdaqc Firmware
+ * @{
+ */
+
+/** @addtogroup analog_input_power Analog Input Power
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def ANALOG_POWER_MAX_CHANNELS
+ * @brief The number of power channels which may be set up.
+ */
+#define ANALOG_POWER_MAX_CHANNELS	4U
+
+/**
+ * @def ANALOG_POWER_DEFAULT_CYCLES
+ * @brief The number of voltage cycles in a window when none is given.
+ */
+#define ANALOG_POWER_DEFAULT_CYCLES	10U
+
+/**
+ * @def ANALOG_POWER_MAX_COUNT
+ * @brief The most sample pairs a window may hold. The sum of the products of this many full scale readings still
+ * fits in its signed 64 bit accumulator, so a window which finds too few cycles, as of a DC voltage, is closed early.
+ */
+#define ANALOG_POWER_MAX_COUNT		65536U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Data structure holding the results of a power channel's window.
+ * The RMS values are of the AC part of each signal, and the power is that of the AC parts, so offsets of either
+ * sensor do not show as power. All are in ADC counts, to be scaled by the host for its sensors.
+ */
+typedef struct {
+	uint8_t channel; /**< The number of the power channel. */
+	PhysicalAnalogInput_t voltage; /**< The voltage input. */
+	PhysicalAnalogInput_t current; /**< The current input. */
+	uint64_t start; /**< The timestamp of the first sample pair of the window. */
+	uint64_t end; /**< The timestamp of the last sample pair of the window. */
+	uint32_t count; /**< The number of sample pairs in the window. */
+	uint16_t cycles; /**< The number of whole voltage cycles in the window, fewer if it was closed early. */
+	float voltageRms; /**< The RMS of the voltage (ADC Counts). */
+	float currentRms; /**< The RMS of the current (ADC Counts). */
+	float power; /**< The mean product of the voltage and current (ADC Counts squared). */
+	float powerFactor; /**< The power over the product of the RMS values, 0 if either is 0. */
+} AnalogPowerResult_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Sets up a power channel.
+ */
+bool AnalogPower_SetChannel(uint8_t channel, PhysicalAnalogInput_t voltage, PhysicalAnalogInput_t current, uint16_t cycles);
+
+/**
+ * @brief Removes a power channel.
+ */
+bool AnalogPower_ClearChannel(uint8_t channel);
+
+/**
+ * @brief Discards the partial windows of every power channel, so each starts again on the next voltage cycle.
+ */
+void AnalogPower_Reset(void);
+
+/**
+ * @brief Adds a sample to the power channels it belongs to.
+ */
+bool AnalogPower_Process(PhysicalAnalogInput_t input, int32_t value, uint64_t timestamp);
+
+/**
+ * @brief Determines if any power channel has a completed window waiting to be written.
+ */
+bool AnalogPower_IsPending(void);
+
+/**
+ * @brief Retrieves the results of the next completed window waiting to be written.
+ */
+bool AnalogPower_PeekResult(AnalogPowerResult_t* result);
+
+/**
+ * @brief Releases the completed window last retrieved with AnalogPower_PeekResult().
+ */
+void AnalogPower_ReleaseResult(uint8_t channel);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ANALOGINPUT_POWER_H_ */
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file AnalogInput_Spectrum.h
+ * @brief Header file for the analog input spectrum.
+ *
+ * Contains public definitions and function prototypes for reducing a burst capture to its amplitude spectrum, sent
+ * either as the bins themselves or as the strongest peaks in place of the raw codes.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef ANALOGINPUT_SPECTRUM_H_
+#define ANALOGINPUT_SPECTRUM_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "Analog_Input.h"
+#include "Tekdaqc_FFT.h"
+#include "boolean.h"
+
+/** @addtogroup tekdaqc_firmware Tekdaqc Firmware
+ * @{
+ */
+
+/** @addtogroup analog_input_spectrum Analog Input Spectrum
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def ANALOG_SPECTRUM_MAX_PEAKS
+ * @brief The most peaks a spectrum may be reduced to, as many as fit in a single status message.
+ */
+#define ANALOG_SPECTRUM_MAX_PEAKS	8U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Starts computing the spectrum of a burst capture.
+ */
+bool AnalogSpectrum_Start(PhysicalAnalogInput_t input, const uint8_t* codes, uint32_t count, uint16_t points,
+		uint8_t peaks, uint32_t binWidth);
+
+/**
+ * @brief Abandons the spectrum in progress.
+ */
+void AnalogSpectrum_Cancel(void);
+
+/**
+ * @brief Determines if a spectrum is being computed or sent.
+ */
+bool AnalogSpectrum_IsBusy(void);
+
+/**
+ * @brief Computes the next block of the spectrum in progress, or sends its next bins.
+ */
+void AnalogSpectrum_Service(void);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ANALOGINPUT_SPECTRUM_H_ */
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file AnalogInput_Thermocouple.h
+ * @brief Header file for the thermocouple linearization of analog inputs.
+ *
+ * Contains public definitions and data types for converting between thermocouple EMFs and temperatures, so that an
+ * analog input wired to a thermocouple can report its temperature directly.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef ANALOGINPUT_THERMOCOUPLE_H_
+#define ANALOGINPUT_THERMOCOUPLE_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "stm32f4xx.h"
+#include "boolean.h"
+
+/** @addtogroup tekdaqc_firmware Tekdaqc Firmware
+ * @{
+ */
+
+/** @addtogroup analog_input_thermocouple Analog Input Thermocouple
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def THERMOCOUPLE_TABLE_STEP
+ * @brief The temperature step of the EMF tables, in milli-degrees Celsius.
+ */
+#define THERMOCOUPLE_TABLE_STEP		10000
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Thermocouple type enumeration.
+ * Defines the thermocouples an analog input may be linearized for.
+ */
+typedef enum {
+	THERMOCOUPLE_NONE, /**< The input is not linearized and reports ADC codes. */
+	THERMOCOUPLE_J, /**< Iron - constantan, -210 to 1200 degrees Celsius. */
+	THERMOCOUPLE_K, /**< Chromel - alumel, -200 to 1370 degrees Celsius. */
+	THERMOCOUPLE_T, /**< Copper - constantan, -200 to 400 degrees Celsius. */
+	NUM_THERMOCOUPLE_TYPES /**<@internal The total number of thermocouple types. */
+} ThermocoupleType_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Converts a thermocouple EMF to the temperature of its measuring junction.
+ */
+int32_t Thermocouple_EMFToTemperature(ThermocoupleType_t type, int32_t emf);
+
+/**
+ * @brief Converts a junction temperature to the EMF a thermocouple produces against a 0 degree reference.
+ */
+int32_t Thermocouple_TemperatureToEMF(ThermocoupleType_t type, int32_t temperature);
+
+/**
+ * @brief Return the human readable string representation of the provided thermocouple type.
+ */
+const char* Thermocouple_StringFromType(ThermocoupleType_t type);
+
+/**
+ * @brief Convert a human readable string into the relevant ThermocoupleType_t value.
+ */
+ThermocoupleType_t Thermocouple_StringToType(const char* str);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ANALOGINPUT_THERMOCOUPLE_H_ */
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file AnalogInput_Trigger.h
+ * @brief Header file for the analog input capture trigger.
+ *
+ * Contains public definitions and data types for triggered burst capture, which holds the most recent samples of an
+ * analog input until a digital input edge or an analog threshold crossing, then keeps a fixed number more and stops so
+ * the capture can be sent at whatever rate the connection allows.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef ANALOGINPUT_TRIGGER_H_
+#define ANALOGINPUT_TRIGGER_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "Analog_Input.h"
+#include "Digital_Input.h"
+#include "boolean.h"
+
+/** @addtogroup tekdaqc_firmware Tekdaqc Firmware
+ * @{
+ */
+
+/** @addtogroup analog_input_trigger Analog Input Trigger
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def ANALOG_TRIGGER_MAX_CAPTURE
+ * @brief The most samples, pre and post trigger together, a capture may hold. The captured input has the whole
+ * sample pool, less one block which StoreAnalogSample() keeps free at each block start.
+ */
+#define ANALOG_TRIGGER_MAX_CAPTURE	(ANALOG_SAMPLE_POOL_SIZE - ANALOG_SAMPLE_BLOCK_SIZE)
+
+/**
+ * @def ANALOG_TRIGGER_SOURCE_ANALOG
+ * @brief String constant for the SOURCE value which triggers on the captured input crossing its threshold.
+ */
+#define ANALOG_TRIGGER_SOURCE_ANALOG	"ANALOG"
+
+/**
+ * @def ANALOG_TRIGGER_SOURCE_CAN
+ * @brief String constant for the SOURCE value which triggers on a trigger frame from the CAN master.
+ */
+#define ANALOG_TRIGGER_SOURCE_CAN		"CAN"
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Analog trigger edge enumeration.
+ * Defines the direction of the change which fires the trigger.
+ */
+typedef enum {
+	ANALOG_TRIGGER_RISING, /**< A digital input going high, or the analog input rising to the level. */
+	ANALOG_TRIGGER_FALLING, /**< A digital input going low, or the analog input falling to the level. */
+	NUM_ANALOG_TRIGGER_EDGES /**<@internal The total number of edges. */
+} AnalogTriggerEdge_t;
+
+/**
+ * @brief Analog trigger state enumeration.
+ * Defines the stages of a capture.
+ */
+typedef enum {
+	ANALOG_TRIGGER_IDLE, /**< No capture is in progress, samples are streamed as usual. */
+	ANALOG_TRIGGER_ARMED, /**< The pre-trigger history is being kept while waiting for the trigger. */
+	ANALOG_TRIGGER_CAPTURING, /**< The trigger fired and the post-trigger samples are being taken. */
+	ANALOG_TRIGGER_COMPLETE /**< The capture is frozen and is being written out. */
+} AnalogTriggerState_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Arms the trigger for a capture.
+ */
+bool AnalogTrigger_Arm(const Digital_Input_t* source, int32_t level, AnalogTriggerEdge_t edge, uint32_t pre, uint32_t post);
+
+/**
+ * @brief Arms the trigger for a capture fired by the CAN master.
+ */
+bool AnalogTrigger_ArmExternal(uint32_t pre, uint32_t post);
+
+/**
+ * @brief Fires an externally armed trigger.
+ */
+void AnalogTrigger_Fire(void);
+
+/**
+ * @brief Abandons any capture in progress.
+ */
+void AnalogTrigger_Disarm(void);
+
+/**
+ * @brief Retrieves the current stage of the capture.
+ */
+AnalogTriggerState_t AnalogTrigger_GetState(void);
+
+/**
+ * @brief Indicates if samples must be held in the buffer rather than written.
+ */
+bool AnalogTrigger_IsHolding(void);
+
+/**
+ * @brief Passes a sample of the captured input through the trigger.
+ */
+bool AnalogTrigger_Process(Analog_Input_t* input, int32_t value, uint64_t timestamp, uint8_t flags);
+
+/**
+ * @brief Convert a human readable string into the relevant AnalogTriggerEdge_t value.
+ */
+AnalogTriggerEdge_t AnalogTrigger_StringToEdge(const char* str);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ANALOGINPUT_TRIGGER_H_ */
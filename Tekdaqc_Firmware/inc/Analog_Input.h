@@ -39,6 +39,13 @@ extern "C" {
 #include "stm32f4xx.h"
 #include "Tekdaqc_Config.h"
 #include "ADS1256_Driver.h"
+#include "AnalogInput_Filter.h"
+#include "AnalogInput_Math.h"
+#include "AnalogInput_Mixed.h"
+#include "AnalogInput_Aux.h"
+#include "AnalogInput_Power.h"
+#include "AnalogInput_Thermocouple.h"
+#include "Tekdaqc_RingBuffer.h"
 #include "boolean.h"
 
 /** @addtogroup tekdaqc_firmware Tekdaqc Firmware
@@ -60,10 +67,135 @@ extern "C" {
 #define MAX_ANALOG_INPUT_NAME_LENGTH 24
 
 /**
- * @def ANALOG_INPUT_BUFFER_SIZE
- * @brief The number or readings to store in the circular buffer for the input.
+ * @def ANALOG_SAMPLE_POOL_SIZE
+ * @brief The number of readings in the sample pool shared by the inputs of the current scan. Must be a power of two,
+ * see RingBuffer_t.
  */
-#define ANALOG_INPUT_BUFFER_SIZE	100U /* 100 samples. Other code expects it to <= 255. */
+#define ANALOG_SAMPLE_POOL_SIZE	4096U
+
+/**
+ * @def COLD_JUNCTION_BUFFER_SIZE
+ * @brief The number of readings in the cold junction's own buffer, which it keeps outside of the sample pool since
+ * it is sampled whether or not it is part of a scan. Must be a power of two.
+ */
+#define COLD_JUNCTION_BUFFER_SIZE	64U
+
+/**
+ * @def ANALOG_SAMPLE_BLOCK_SIZE
+ * @brief The number of consecutive samples of an input which share a base timestamp. Each sample only stores its
+ * offset from the base. Must be a power of two no larger than the smallest share of the sample pool.
+ */
+#define ANALOG_SAMPLE_BLOCK_SIZE	16U
+
+/**
+ * @def ANALOG_SAMPLE_VALUE_SIZE
+ * @brief The number of bytes each sample value is packed into, the width of an ADC reading.
+ */
+#define ANALOG_SAMPLE_VALUE_SIZE	3U
+
+/**
+ * @def ANALOG_SAMPLE_FLAG_OVERRANGE
+ * @brief Sample flag set when a conversion of the sample hit the ADC's full scale, so its value is clipped.
+ */
+#define ANALOG_SAMPLE_FLAG_OVERRANGE	((uint8_t) 0x01)
+
+/**
+ * @def ANALOG_SAMPLE_FLAG_SETTLING
+ * @brief Sample flag set on the first sample of each input after sampling begins, when the input's path and the ADC
+ * have just been brought out of idle.
+ */
+#define ANALOG_SAMPLE_FLAG_SETTLING		((uint8_t) 0x02)
+
+/**
+ * @def ANALOG_SAMPLE_FLAG_MUX_SWITCH
+ * @brief Sample flag set when the ADC's multiplexer was taken away from the scan for a cold junction reading just
+ * before the sample, outside the scan's own order.
+ */
+#define ANALOG_SAMPLE_FLAG_MUX_SWITCH	((uint8_t) 0x04)
+
+/**
+ * @def ANALOG_SAMPLE_FLAG_CALIBRATING
+ * @brief Sample flag set on the first sample of an input after a background calibration paused the scan or changed
+ * the offset calibration of its settings.
+ */
+#define ANALOG_SAMPLE_FLAG_CALIBRATING	((uint8_t) 0x08)
+
+/**
+ * @def ANALOG_SAMPLE_FLAG_GAP
+ * @brief Sample flag set on the first sample stored after samples of the input were dropped because its buffer was
+ * full, marking the gap in its stream. The number of samples lost is the jump in sequence number.
+ */
+#define ANALOG_SAMPLE_FLAG_GAP			((uint8_t) 0x10)
+
+/**
+ * @def ANALOG_SAMPLE_FLAG_RANGE
+ * @brief Sample flag set on the first sample after auto-ranging changed the input's gain, which is the first sample
+ * converted at the new gain.
+ */
+#define ANALOG_SAMPLE_FLAG_RANGE		((uint8_t) 0x20)
+
+/**
+ * @def ANALOG_SAMPLE_FLAG_OPEN
+ * @brief Sample flag set on the first sample after a sensor check found the input open circuit.
+ */
+#define ANALOG_SAMPLE_FLAG_OPEN			((uint8_t) 0x40)
+
+/**
+ * @def ANALOG_RANGE_HISTORY_SIZE
+ * @brief The number of auto-ranging gain changes an input remembers, so the writers can tell the gain of each of its
+ * buffered samples. Must be a power of 2.
+ */
+#define ANALOG_RANGE_HISTORY_SIZE		4U
+
+/**
+ * @def ANALOG_RANGE_WINDOW
+ * @brief The number of consecutive samples which must all be small before auto-ranging raises an input's gain.
+ */
+#define ANALOG_RANGE_WINDOW				8U
+
+/**
+ * @def ANALOG_INPUT_MAX_OVERSAMPLING
+ * @brief The largest number of back to back conversions which may be averaged into a single sample.
+ */
+#define ANALOG_INPUT_MAX_OVERSAMPLING	256U
+
+/**
+ * @def ANALOG_INPUT_DEFAULT_SETTLE_TIME
+ * @brief The time in microseconds an external input is given to settle after the multiplexer switches to it, unless
+ * it is configured otherwise.
+ */
+#define ANALOG_INPUT_DEFAULT_SETTLE_TIME	((uint16_t) EXTERNAL_MUX_DELAY)
+
+/**
+ * @def ANALOG_INPUT_MAX_SETTLE_TIME
+ * @brief The longest settle time in microseconds which may be configured for an external input.
+ */
+#define ANALOG_INPUT_MAX_SETTLE_TIME	65535U
+
+/**
+ * @def ANALOG_GAIN_CORRECTION_BITS
+ * @brief The number of fractional bits of an input's gain correction factor.
+ */
+#define ANALOG_GAIN_CORRECTION_BITS	24U
+
+/**
+ * @def ANALOG_GAIN_CORRECTION_UNITY
+ * @brief The gain correction factor which leaves samples unchanged.
+ */
+#define ANALOG_GAIN_CORRECTION_UNITY	((int32_t) (1L << ANALOG_GAIN_CORRECTION_BITS))
+
+/**
+ * @def ANALOG_EMF_SCALE_BITS
+ * @brief The number of fractional bits of an input's nanovolts per ADC count.
+ */
+#define ANALOG_EMF_SCALE_BITS	16U
+
+/**
+ * @def ANALOG_STATISTICS_MAX_COUNT
+ * @brief The most samples a statistics window may hold. The sum of squares of this many full scale readings still
+ * fits in its 64 bit accumulator, so longer windows are closed early.
+ */
+#define ANALOG_STATISTICS_MAX_COUNT	262144U
 
 /*--------------------------------------------------------------------------------------------------------*/
 /* EXPORTED TYPES */
@@ -79,31 +211,114 @@ typedef enum {
 	ABOVE_RANGE, /**< The current value is above the maximum of the range. */
 } AnalogInputStatus_t;
 
+/**
+ * @brief Data structure holding the running summary of a window of analog samples.
+ * The sums are kept exactly in integers so the mean and RMS are only computed, once, when the window is reported.
+ */
+typedef struct {
+	uint32_t count; /**< The number of samples in the window. */
+	int32_t min; /**< The smallest sample of the window (ADC Counts). */
+	int32_t max; /**< The largest sample of the window (ADC Counts). */
+	int64_t sum; /**< The sum of the samples of the window. */
+	uint64_t sumSquares; /**< The sum of the squares of the samples of the window. */
+	uint64_t start; /**< The timestamp of the first sample of the window. */
+	uint64_t end; /**< The timestamp of the last sample of the window. */
+} AnalogStatistics_t;
+
 /**
  * @brief Data structure used to store the state and requirements of an analog input to the Tekdaqc.
  * This data structure contains all the information related to a particular input to the Tekdaqc, including values and allowable range.
+ * The fields the sampling path uses for every conversion come first, widest first, so they share as few memory words
+ * as possible, and the configuration the sampling path never reads comes last.
  * Please note that while there is nothing to stop you from manipulating the values of the structure directly, it is not recommended as
  * it could put the structure in an indeterminate state. Instead, manipulation functions are provided which will ensure that all state
  * related implications are addressed.
  */
 typedef struct {
+	/* Used by the DRDY interrupt and the scan for every conversion */
+	int64_t oversampleSum; /**< The sum of the conversions accumulated towards the current sample. */
+	uint64_t lastReportTime; /**< The timestamp of the last reported sample. */
+	uint64_t* blockTimestamps; /**< The base timestamp of each block of measurements in UNIX epoch format. */
+	uint8_t* values; /**< The recorded values of this input (ADC Counts), packed little endian. NULL unless part of the current scan. */
+	uint8_t* flags; /**< The ANALOG_SAMPLE_FLAG_ bits of each measurement. */
+	uint32_t* timestampDeltas; /**< The time of each measurement in microseconds after the base of its block. */
+	uint32_t* blockSequences; /**< The sequence number of the first measurement of each block. */
+	uint16_t* sequenceDeltas; /**< The sequence number of each measurement after the base of its block. */
+	uint32_t sequence; /**< The sequence number of the next sample, counting those dropped for lack of buffer space. Owned by the ADC. */
+	RingBuffer_t samples; /**< Indexes values and timestamp deltas. Produced by the ADC, consumed by the writers. */
+	int32_t gainCorrection; /**< Factor correcting samples for the temperature drift since loadedGain was looked up. */
+	uint32_t emfScale; /**< The nanovolts of one ADC count at the input's gain, with ANALOG_EMF_SCALE_BITS fractional bits. */
+	int32_t coldJunctionEMF; /**< The EMF of the thermocouple at the cold junction temperature in nanovolts. */
+	int32_t lastReported; /**< The value of the last reported sample, which the deadband is centered on. */
+	int32_t latestValue; /**< The most recent measurement, whether or not it was reported. */
+	uint64_t latestTimestamp; /**< The time of latestValue, 0 if the input has not been measured since it was added. */
+	uint8_t latestFlags; /**< The ANALOG_SAMPLE_FLAG_ bits of latestValue. */
+	volatile uint32_t latestVersion; /**< Incremented with each update of the latest measurement, so a reader can tell it was interrupted by one. */
+	uint32_t deadband; /**< The change from the last reported value needed to report a sample (ADC Counts). 0 reports every sample. */
+	uint32_t heartbeat; /**< The longest time in microseconds between reported samples when a deadband is set. 0 for no limit. */
+	uint32_t overruns; /**< The samples dropped in the current sampling because the buffer was full. */
+	uint32_t calibrationVersion; /**< The version of the calibration the image's calibration values were taken from. */
+	ADS1256_RegisterImage_t registers; /**< The ADC registers for the buffer, gain and rate settings. */
+	bool registersPending; /**< The register image is out of date, to be compiled when the open configuration is committed. */
+	ThermocoupleType_t thermocouple; /**< The thermocouple the input's samples are linearized for. Such inputs report milli-degrees Celsius. */
 	ChannelAdded_t added; /**< Addition status of the input. */
 	PhysicalAnalogInput_t physicalInput; /**< The physical input for this input. */
 	ExternalMuxedInput_t externalInput; /**< If an external input, which channel. */
-	InternalAnalogInput_t internalInput; /**< If an internal input, which channel. */
+	uint16_t settleTime; /**< The time in microseconds the input is given to settle after the external multiplexer switches to it. */
+	uint16_t oversampling; /**< The number of back to back conversions averaged into each sample. 1 for none. */
+	uint16_t oversampled; /**< The number of conversions accumulated towards the current sample. */
+	uint8_t pendingFlags; /**< The ANALOG_SAMPLE_FLAG_ bits raised since the input's last stored sample. Owned by the ADC. */
+	bool reported; /**< TRUE once a sample has been reported in the current sampling. */
+	/* Auto-ranging state, only touched by the inputs which use it */
+	bool autoRange; /**< TRUE if the gain follows the signal between ADS1256_PGAx1 and maxGain. */
+	ADS1256_PGA_t maxGain; /**< The highest gain auto-ranging may select. */
+	uint8_t rangeQuiet; /**< The number of consecutive samples small enough for the next higher gain. Owned by the ADC. */
+	uint32_t rangeCount; /**< The number of gain history entries ever written this sampling. Owned by the ADC. */
+	uint32_t rangeSequences[ANALOG_RANGE_HISTORY_SIZE]; /**< The sequence number of the first sample of each gain history entry. */
+	ADS1256_PGA_t rangeGains[ANALOG_RANGE_HISTORY_SIZE]; /**< The gain of each gain history entry. */
+	uint32_t rangeChanges; /**< The number of gain changes made by auto-ranging since it was enabled. */
+	/* Filter and statistics state, only touched by the inputs which use them */
+	AnalogFilter_t filter; /**< The filter applied to the input's samples before they are buffered. */
+	AnalogStatistics_t statistics; /**< The window being accumulated in statistics mode. Owned by the ADC. */
+	AnalogStatistics_t window; /**< The last completed window, waiting to be written. */
+	volatile bool windowReady; /**< TRUE while window holds a record the writers have not yet consumed. */
+	/* Configuration, read when the input is added, listed or its settings change */
 	char name[MAX_ANALOG_INPUT_NAME_LENGTH]; /**< Pointer to a C string name for this input. */
 	int32_t min; /**< The low value of the allowable range of this input. */
 	int32_t max; /**< The high value of the allowable range of this input. */
-	int32_t values[ANALOG_INPUT_BUFFER_SIZE]; /**< The recorded values of this input (ADC Counts). */
-	uint64_t timestamps[ANALOG_INPUT_BUFFER_SIZE]; /**< The timestamps of the measurements in UNIX epoch format. */
-	uint8_t bufferReadIdx; /**< The index of the buffer to read data from. */
-	uint8_t bufferWriteIdx; /**< The index of the buffer to write data to. */
 	AnalogInputStatus_t status; /**< The current status of this input. */
 	ADS1256_BUFFER_t buffer; /**< Analog buffer state to use. */
 	ADS1256_PGA_t gain; /**< Gain setting to use for analog measurements. */
 	ADS1256_SPS_t rate; /**< Sample rate to use for measurements. */
+	uint32_t loadedGain; /**< The gain calibration value in the image, looked up at the board temperature of the time. */
+	InternalAnalogInput_t internalInput; /**< If an internal input, which channel. */
+	ADS1256_AIN_t positiveInput; /**< If a differential input, the ADC input of the positive side of its pair. */
+	ADS1256_AIN_t negativeInput; /**< If a differential input, the ADC input of the negative side of its pair. */
+	uint32_t reportedOverruns; /**< The part of overruns already reported to the client. */
 } Analog_Input_t;
 
+/**
+ * @brief Data structure holding the predicted timing of a scan of the added analog inputs.
+ */
+typedef struct {
+	uint8_t inputs; /**< The number of added inputs. */
+	uint8_t externalInputs; /**< The number of added inputs behind the external multiplexer. */
+	float conversionTime; /**< The time a scan spends multiplexing and converting the inputs, in milliseconds. */
+	float coldJunctionTime; /**< The time a scan spends refreshing the cold junction, in milliseconds. */
+	float scanTime; /**< The time of a scan, in milliseconds. */
+	float channelRate; /**< The rate every input reports samples at, in samples per second. */
+	float throughput; /**< The samples reported per second over all inputs. */
+} AnalogScanPrediction_t;
+
+/**
+ * @brief Data structure holding a consistent copy of the most recent measurement of an analog input.
+ */
+typedef struct {
+	int32_t value; /**< The measured value. */
+	uint64_t timestamp; /**< The time of the measurement, 0 if the input has not been measured since it was added. */
+	uint8_t flags; /**< The ANALOG_SAMPLE_FLAG_ bits of the measurement. */
+} AnalogLatestSample_t;
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* EXPORTED VARIABLES */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -126,6 +341,12 @@ void AnalogInputsInit(void);
  */
 Tekdaqc_Function_Error_t CreateAnalogInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
 
+/**
+ * @brief Configures an analog input with already parsed settings and adds it to the board's list.
+ */
+Tekdaqc_Function_Error_t ConfigureAnalogInput(uint8_t input, ADS1256_BUFFER_t buffer, ADS1256_SPS_t rate, ADS1256_PGA_t gain,
+		const char* name, uint32_t deadband, uint32_t heartbeat);
+
 /**
  * @brief Adds an analog input to the board's list.
  */
@@ -136,6 +357,41 @@ Tekdaqc_Function_Error_t AddAnalogInput(Analog_Input_t* input);
  */
 Tekdaqc_Function_Error_t RemoveAnalogInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
 
+/**
+ * @brief Sets the filter applied to an analog input's samples.
+ */
+Tekdaqc_Function_Error_t SetAnalogInputFilter(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @brief Sets the number of back to back conversions averaged into each of an analog input's samples.
+ */
+Tekdaqc_Function_Error_t SetAnalogInputOversampling(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @brief Sets the time an external analog input is given to settle after the multiplexer switches to it.
+ */
+Tekdaqc_Function_Error_t SetAnalogInputSettleTime(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @brief Sets the thermocouple an analog input's samples are linearized for.
+ */
+Tekdaqc_Function_Error_t SetAnalogInputThermocouple(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @brief Sets the automatic gain ranging of an analog input.
+ */
+Tekdaqc_Function_Error_t SetAnalogInputAutoRange(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @brief Sets the pair of ADC inputs a differential analog input measures.
+ */
+Tekdaqc_Function_Error_t SetAnalogInputPair(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* UTILITY METHODS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -145,21 +401,188 @@ Tekdaqc_Function_Error_t RemoveAnalogInput(char keys[][MAX_COMMANDPART_LENGTH],
  */
 Tekdaqc_Function_Error_t ListAnalogInputs(void);
 
+/**
+ * @brief Records the most recent measurement of an analog input.
+ */
+void RecordLatestAnalogSample(Analog_Input_t* input, int32_t value, uint64_t timestamp, uint8_t flags);
+
+/**
+ * @brief Retrieves a consistent copy of the most recent measurement of an analog input.
+ */
+bool GetLatestAnalogSample(uint8_t number, AnalogLatestSample_t* sample);
+
+/**
+ * @brief Prints the most recent measurement of all the added analog inputs.
+ */
+Tekdaqc_Function_Error_t WriteLatestAnalogValues(void);
+
+/**
+ * @brief Divides the sample pool among the inputs of a scan.
+ */
+void AllocateAnalogInputBuffers(Analog_Input_t** inputs, uint8_t count);
+
+/**
+ * @brief Stores a measurement in an analog input's sample buffer.
+ */
+bool StoreAnalogSample(Analog_Input_t* input, int32_t value, uint64_t timestamp, uint8_t flags);
+
+/**
+ * @brief Converts a span of an analog input's stored samples into signed values.
+ */
+uint32_t ReadAnalogSampleValues(const Analog_Input_t* input, uint32_t offset, uint32_t count, int32_t* values);
+
+/**
+ * @brief Sets the window of the statistics output mode, or disables it.
+ */
+void SetAnalogStatisticsWindow(uint32_t samples, uint32_t period);
+
+/**
+ * @brief Indicates if analog inputs report statistics instead of samples.
+ */
+bool isAnalogStatisticsEnabled(void);
+
+/**
+ * @brief Discards the statistics and deadband state an analog input built up while sampling.
+ */
+void ResetAnalogInputReporting(Analog_Input_t* input);
+
+/**
+ * @brief Predicts the timing of a scan of every added analog input.
+ */
+void PredictAnalogScan(AnalogScanPrediction_t* prediction);
+
+/**
+ * @brief Picks the data rate of every added analog input for a requested per channel sample rate.
+ */
+float PlanAnalogInputRates(float bandwidth, ADS1256_SPS_t* rate);
+
+/**
+ * @brief Adds a conversion to the sample an analog input is oversampling.
+ */
+bool OversampleAnalogInput(Analog_Input_t* input, int32_t* value);
+
+/**
+ * @brief Follows the signal of an auto-ranged analog input with its gain.
+ */
+void AutoRangeAnalogInput(Analog_Input_t* input, int32_t value);
+
+/**
+ * @brief Converts a sample of a thermocouple input to the temperature of its measuring junction.
+ */
+int32_t LinearizeAnalogSample(const Analog_Input_t* input, int32_t value);
+
+/**
+ * @brief Updates the cold junction compensation of every thermocouple input.
+ */
+void UpdateAnalogInputColdJunctions(float temperature);
+
+/**
+ * @brief Decides if a measurement is outside an analog input's deadband and should be reported.
+ */
+bool isAnalogSampleReportable(Analog_Input_t* input, int32_t value, uint64_t timestamp);
+
+/**
+ * @brief Adds a measurement to an analog input's statistics window.
+ */
+bool AccumulateAnalogSample(Analog_Input_t* input, int32_t value, uint64_t timestamp);
+
 /**
  * @brief Retrieve the analog input structure corresponding to a physical channel.
  */
 Analog_Input_t* GetAnalogInputByNumber(uint8_t number);
 
+/**
+ * @brief Opens a configuration, deferring the work of input changes until it is committed.
+ */
+void BeginAnalogInputConfig(void);
+
+/**
+ * @brief Commits the open configuration, compiling the register images of the inputs it changed.
+ */
+uint8_t CommitAnalogInputConfig(void);
+
+/**
+ * @brief Determines if a configuration is open.
+ */
+bool isAnalogInputConfigOpen(void);
+
 /**
  * @brief Prints data from the analog input structure to the data connection.
  */
-void WriteAnalogInput(Analog_Input_t* input);
+WriteStatus_t WriteAnalogInput(Analog_Input_t* input);
+
+/**
+ * @brief Writes the next codes of a burst capture to the data connection as a binary capture record.
+ */
+WriteStatus_t WriteAnalogCaptureBinary(PhysicalAnalogInput_t input, uint32_t index, const uint8_t* values, uint32_t count,
+		uint32_t* written);
+
+/**
+ * @brief Writes the results of a power channel's window to the data connection.
+ */
+WriteStatus_t WriteAnalogPowerResult(const AnalogPowerResult_t* result);
+
+/**
+ * @brief Writes math channel results to the data connection.
+ */
+WriteStatus_t WriteAnalogMathResults(const AnalogMathResult_t* results, uint32_t count, uint32_t* written);
+
+/**
+ * @brief Writes the digital states captured with analog scans.
+ */
+WriteStatus_t WriteAnalogMixedStates(const AnalogMixedState_t* states, uint32_t count, uint32_t* written);
+
+/**
+ * @brief Writes the auxiliary readings captured with analog scans.
+ */
+WriteStatus_t WriteAnalogAuxStates(const AnalogAuxState_t* states, uint32_t count, uint32_t* written);
+
+/**
+ * @brief Writes the next bins of a spectrum to the data connection as a binary spectrum record.
+ */
+WriteStatus_t WriteAnalogSpectrumBinary(PhysicalAnalogInput_t input, uint16_t points, uint16_t bin, const float* amplitudes,
+		uint16_t count, uint16_t* written);
+
+/**
+ * @brief Retrieves the number of bytes of analog data the connections have accepted.
+ */
+uint32_t GetAnalogInputWrittenBytes(void);
 
 /**
  * @brief Sets the function to use for writing strings to the data connection.
  */
 void SetAnalogInputWriteFunction(WriteFunction writeFunction);
 
+/**
+ * @brief Sets the function to use for writing binary frames to the data connection.
+ */
+void SetAnalogInputBinaryWriteFunction(BinaryWriteFunction writeFunction);
+
+/**
+ * @brief Resets the binary framing state so every channel is described again.
+ */
+void ResetAnalogInputBinaryFraming(void);
+
+/**
+ * @brief Enables or disables compression of the binary sample frames.
+ */
+void SetAnalogInputCompression(bool enabled);
+
+/**
+ * @brief Indicates if the binary sample frames are compressed.
+ */
+bool isAnalogInputCompressionEnabled(void);
+
+/**
+ * @brief Retrieves the bytes of binary sample frames sent and what they would have been uncompressed.
+ */
+void GetAnalogInputCompressionTotals(uint32_t* sent, uint32_t* raw);
+
+/**
+ * @brief Restarts the compression totals.
+ */
+void ResetAnalogInputCompressionTotals(void);
+
 /**
  * @brief Returns the string representation of an externally muxed analog input.
  */
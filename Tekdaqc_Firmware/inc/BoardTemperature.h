@@ -53,6 +53,11 @@ extern "C" {
  */
 void updateBoardTemperature(Analog_Input_t* input, int32_t code);
 
+/**
+ * @brief Persists the board temperature extremes to the EEPROM in the background.
+ */
+void persistBoardTemperatureExtremes(void);
+
 /**
  * @brief Retrieves the current board temperature reading.
  */
@@ -82,7 +82,7 @@ void ServiceTasks(void);
 /**
  * @brief Halt all in progress tasks, returning to the idle state.
  */
-void HaltTasks(void);
+void HaltTasks(bool discard);
 
 /**
  * @brief Move the state machine to analog input sampling.
@@ -49,6 +49,30 @@ extern "C" {
 /* EXPORTED CONSTANTS */
 /*--------------------------------------------------------------------------------------------------------*/
 
+/**
+ * @def DI_DEFAULT_SAMPLE_RATE_HZ
+ * @brief The default rate at which digital input sampling takes each sample.
+ */
+#define DI_DEFAULT_SAMPLE_RATE_HZ 100U
+
+/**
+ * @def DI_MAX_SAMPLE_RATE_HZ
+ * @brief The maximum rate at which digital input sampling may take samples.
+ */
+#define DI_MAX_SAMPLE_RATE_HZ 1000U
+
+/**
+ * @def DI_DEFAULT_COUNTER_INTERVAL_MS
+ * @brief The default interval between pulse counter reports, in milliseconds.
+ */
+#define DI_DEFAULT_COUNTER_INTERVAL_MS 1000U
+
+/**
+ * @def DI_MAX_COUNTER_INTERVAL_MS
+ * @brief The longest interval between pulse counter reports, in milliseconds.
+ */
+#define DI_MAX_COUNTER_INTERVAL_MS 60000U
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* EXPORTED TYPES */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -62,6 +86,8 @@ typedef enum {
 	DI_INITIALIZED, /**< The state machine is in a valid, initialized state. */
 	DI_IDLE, /**< The state machine is idling. */
 	DI_CHANNEL_SAMPLING, /**< The state machine is configured for sampling digital inputs. */
+	DI_EDGE_CAPTURE, /**< The state machine is streaming the transitions of digital inputs. */
+	DI_COUNTING, /**< The state machine is reporting the pulse counts of digital inputs. */
 	DI_RESET /**< The state machine is resetting. It will return to IDLE after reset completes. */
 } DI_State_t;
 
@@ -93,6 +119,21 @@ void DI_Machine_Service(void);
  */
 void DI_Machine_Halt(void);
 
+/**
+ * @brief Sets the rate at which digital input sampling takes samples.
+ */
+bool DI_Machine_SetSampleRate(uint32_t rate);
+
+/**
+ * @brief Turns pulse latching of the sampled inputs on or off.
+ */
+void DI_Machine_SetLatch(bool enable);
+
+/**
+ * @brief Checks if pulse latching of the sampled inputs is on.
+ */
+bool DI_Machine_GetLatch(void);
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* STATE METHODS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -107,6 +148,16 @@ void DI_Machine_Idle(void);
  */
 void DI_Machine_Input_Sample(Digital_Input_t** inputs, uint32_t count, bool singleChannel);
 
+/**
+ * @brief Edge capture state handler.
+ */
+bool DI_Machine_Edge_Capture(Digital_Input_t** inputs);
+
+/**
+ * @brief Pulse counting state handler.
+ */
+bool DI_Machine_Count(Digital_Input_t** inputs, uint32_t interval);
+
 /**
  * @brief Reset state handler.
  */
@@ -49,6 +49,12 @@ extern "C" {
 /* EXPORTED CONSTANTS */
 /*--------------------------------------------------------------------------------------------------------*/
 
+/**
+ * @def DO_POLL_PERIOD_US
+ * @brief The time in microseconds between checks of the sampled outputs for a change of status.
+ */
+#define DO_POLL_PERIOD_US 10000U
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* EXPORTED TYPES */
 /*--------------------------------------------------------------------------------------------------------*/
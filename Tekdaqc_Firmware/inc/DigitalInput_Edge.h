@@ -0,0 +1,148 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file DigitalInput_Edge.h
+ * @brief Header file for change of state capture of the digital inputs.
+ *
+ * Contains public definitions for edge capture, in which the digital inputs raise external interrupts on every
+ * transition and only the transitions, timestamped as they happen, are written out, and for pulse counting, in which
+ * the rising edges are counted and their count, frequency and period reported once per interval, and for pulse
+ * latching, in which the edges between scans are caught so that short pulses show up in the next scan.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef DIGITALINPUT_EDGE_H_
+#define DIGITALINPUT_EDGE_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "Digital_Input.h"
+#include "boolean.h"
+
+/** @addtogroup tekdaqc_firmware Tekdaqc Firmware
+ * @{
+ */
+
+/** @addtogroup digital_input_edge Digital Input Edge Capture
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def DIGITAL_EDGE_LOG_SIZE
+ * @brief The number of transitions the edge log holds before further ones are dropped. Must be a power of two.
+ */
+#define DIGITAL_EDGE_LOG_SIZE	256U
+
+/**
+ * @def DIGITAL_EDGE_NUM_LINES
+ * @brief The number of EXTI lines which GPIO pins may be routed to.
+ */
+#define DIGITAL_EDGE_NUM_LINES	16U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Digital edge mode enumeration.
+ * Defines what is done with the edges of the captured inputs.
+ */
+typedef enum {
+	DIGITAL_EDGE_LOG, /**< Every transition is logged and written out. */
+	DIGITAL_EDGE_COUNT, /**< Rising edges are counted for periodic counter reports. */
+	DIGITAL_EDGE_LATCH /**< Edges set latched bits which are reported with the next scan. */
+} DigitalEdgeMode_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Starts edge capture of a set of digital inputs.
+ */
+bool DigitalEdge_Start(Digital_Input_t** inputs, DigitalEdgeMode_t mode);
+
+/**
+ * @brief Stops edge capture.
+ */
+void DigitalEdge_Stop(void);
+
+/**
+ * @brief Logs the transitions of any captured inputs whose EXTI lines are pending.
+ */
+void DigitalEdge_IRQHandler(void);
+
+/**
+ * @brief Writes out the logged transitions.
+ */
+void DigitalEdge_Service(void);
+
+/**
+ * @brief Retrieves the pulse count of an input since the last read and starts a new interval.
+ */
+bool DigitalEdge_ReadCounter(const Digital_Input_t* input, Digital_Input_Counter_t* counter);
+
+/**
+ * @brief Writes out the counter report of each counted input and starts a new interval.
+ */
+void DigitalEdge_WriteCounters(void);
+
+/**
+ * @brief Moves the edges latched since the previous scan into the report of the scan being taken.
+ */
+void DigitalEdge_LatchScan(void);
+
+/**
+ * @brief Retrieves the latched edges to report with a scan.
+ */
+bool DigitalEdge_GetLatched(uint32_t* rose, uint32_t* fell);
+
+/**
+ * @brief Clears the latched edges once they have been reported.
+ */
+void DigitalEdge_ClearLatched(void);
+
+/**
+ * @brief Retrieves the number of transitions dropped because the edge log was full.
+ */
+uint32_t DigitalEdge_GetOverflowCount(void);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DIGITALINPUT_EDGE_H_ */
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file DigitalInput_Encoder.h
+ * @brief Header file for quadrature encoder decoding of digital input pairs.
+ *
+ * Contains public definitions for the quadrature encoders, in which the pairs of digital inputs listed in the board's
+ * GPI_ENCODER_TABLE are decoded by a timer's encoder interface, and their position and velocity sampled with each scan
+ * of the digital inputs.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef DIGITALINPUT_ENCODER_H_
+#define DIGITALINPUT_ENCODER_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "Digital_Input.h"
+#include "boolean.h"
+
+/** @addtogroup tekdaqc_firmware Tekdaqc Firmware
+ * @{
+ */
+
+/** @addtogroup digital_input_encoder Digital Input Quadrature Encoders
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Starts decoding a quadrature encoder from zero.
+ */
+bool DigitalEncoder_Start(uint8_t encoder);
+
+/**
+ * @brief Stops decoding a quadrature encoder.
+ */
+void DigitalEncoder_Stop(uint8_t encoder);
+
+/**
+ * @brief Checks if a quadrature encoder is being decoded.
+ */
+bool DigitalEncoder_IsEnabled(uint8_t encoder);
+
+/**
+ * @brief Samples the position and velocity of every enabled quadrature encoder.
+ */
+void DigitalEncoder_Sample(uint64_t timestamp);
+
+/**
+ * @brief Retrieves the latest sample of a quadrature encoder.
+ */
+const Digital_Input_Encoder_t* DigitalEncoder_GetSample(uint8_t encoder);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DIGITALINPUT_ENCODER_H_ */
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file DigitalOutput_Interlock.h
+ * @brief Header file for the digital output interlocks.
+ *
+ * Contains public definitions and data types for the interlock rule table, which drives digital outputs from the
+ * levels of analog and digital inputs on the board, without waiting for the host.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef DIGITALOUTPUT_INTERLOCK_H_
+#define DIGITALOUTPUT_INTERLOCK_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "Tekdaqc_BSP.h"
+#include "stm32f4xx.h"
+#include "boolean.h"
+
+/** @addtogroup tekdaqc_firmware Tekdaqc Firmware
+ * @{
+ */
+
+/** @addtogroup digital_output_interlock Digital Output Interlock
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def DIGITAL_INTERLOCK_MAX_RULES
+ * @brief The number of rules the interlock table holds. Lower numbered rules take precedence for an output.
+ */
+#define DIGITAL_INTERLOCK_MAX_RULES	16U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Interlock source enumeration.
+ * Defines the kinds of input an interlock rule may watch.
+ */
+typedef enum {
+	DIGITAL_INTERLOCK_ANALOG, /**< The rule watches the samples of an analog input. */
+	DIGITAL_INTERLOCK_DIGITAL /**< The rule watches the level of a digital input. */
+} DigitalInterlockSource_t;
+
+/**
+ * @brief Interlock comparator enumeration.
+ * Defines the condition which trips an interlock rule.
+ */
+typedef enum {
+	DIGITAL_INTERLOCK_ABOVE, /**< Trips above the threshold, or on a digital input going high. */
+	DIGITAL_INTERLOCK_BELOW, /**< Trips below the threshold, or on a digital input going low. */
+	NUM_DIGITAL_INTERLOCK_COMPARATORS /**<@internal The total number of comparators. */
+} DigitalInterlockComparator_t;
+
+/**
+ * @brief Data structure holding an interlock rule and its state.
+ * A tripped rule holds its output at the rule's level, over whatever the host or the PWM and sequence players ask of
+ * it, until the input returns past the threshold by the hysteresis, or for a latched rule until it is reset.
+ */
+typedef struct {
+	bool enabled; /**< True if the rule is in use. */
+	DigitalInterlockSource_t source; /**< The kind of input watched. */
+	uint8_t input; /**< The physical input watched. */
+	DigitalInterlockComparator_t comparator; /**< The condition which trips the rule. */
+	int32_t threshold; /**< The level, in ADC counts, an analog input trips the rule past. */
+	uint32_t hysteresis; /**< The distance, in ADC counts, back past the threshold which clears the rule. */
+	uint8_t output; /**< The physical digital output driven. */
+	bool on; /**< True to turn the output on while tripped, false to turn it off. */
+	bool latch; /**< True to hold the rule tripped until it is reset. */
+	volatile bool tripped; /**< True while the rule is driving its output. */
+	volatile uint32_t trips; /**< The number of times the rule has tripped since it was set. */
+	volatile uint64_t tripTime; /**< The timestamp of the sample which last tripped the rule. */
+} DigitalInterlock_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Sets an interlock rule.
+ */
+bool DigitalInterlock_Set(uint8_t number, const DigitalInterlock_t* rule);
+
+/**
+ * @brief Removes an interlock rule, releasing its output.
+ */
+bool DigitalInterlock_Clear(uint8_t number);
+
+/**
+ * @brief Retrieves a copy of an interlock rule.
+ */
+bool DigitalInterlock_Get(uint8_t number, DigitalInterlock_t* rule);
+
+/**
+ * @brief Releases every latched interlock rule.
+ */
+void DigitalInterlock_Reset(void);
+
+/**
+ * @brief Checks an analog sample against the interlock rules watching its input.
+ */
+void DigitalInterlock_ProcessAnalog(PhysicalAnalogInput_t input, int32_t value, uint64_t timestamp);
+
+/**
+ * @brief Checks a digital input level against the interlock rules watching its input.
+ */
+void DigitalInterlock_ProcessDigital(GPI_TypeDef input, DigitalLevel_t level, uint64_t timestamp);
+
+/**
+ * @brief Convert a human readable string into the relevant DigitalInterlockComparator_t value.
+ */
+DigitalInterlockComparator_t DigitalInterlock_StringToComparator(const char* str);
+
+/**
+ * @brief Convert a DigitalInterlockComparator_t value into a human readable string.
+ */
+const char* DigitalInterlock_ComparatorToString(DigitalInterlockComparator_t comparator);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DIGITALOUTPUT_INTERLOCK_H_ */
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file DigitalOutput_PID.h
+ * @brief Header file for the PID control loops of the digital outputs.
+ *
+ * Contains public definitions and data types for the PID loops, which drive the PWM duty cycle of a digital output
+ * from the samples of an analog input on the board, without waiting for the host.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef DIGITALOUTPUT_PID_H_
+#define DIGITALOUTPUT_PID_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "Tekdaqc_BSP.h"
+#include "stm32f4xx.h"
+#include "boolean.h"
+
+/** @addtogroup tekdaqc_firmware Tekdaqc Firmware
+ * @{
+ */
+
+/** @addtogroup digital_output_pid Digital Output PID
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def DIGITAL_PID_MAX_LOOPS
+ * @brief The number of PID loops which may run at once.
+ */
+#define DIGITAL_PID_MAX_LOOPS		4U
+
+/**
+ * @def DIGITAL_PID_GAIN_BITS
+ * @brief The number of fractional bits of the fixed point gains.
+ */
+#define DIGITAL_PID_GAIN_BITS		16U
+
+/**
+ * @def DIGITAL_PID_OUTPUT_MAX
+ * @brief The output of a loop at full duty cycle. The output is in 1/65536ths of the PWM period.
+ */
+#define DIGITAL_PID_OUTPUT_MAX		65535
+
+/**
+ * @def DIGITAL_PID_DEFAULT_RATE
+ * @brief The PWM frequency of a loop's output when none is given, in Hz.
+ */
+#define DIGITAL_PID_DEFAULT_RATE	10U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Data structure holding the settings and state of a PID loop.
+ * The error is the setpoint less the input, in ADC counts, and the gains give the output, in 1/65536ths of full duty
+ * cycle, per count of error as DIGITAL_PID_GAIN_BITS fixed point numbers. The integral and derivative act per sample
+ * of the input, so their gains depend on its rate in the scan. A negative gain reverses the action, as for cooling.
+ */
+typedef struct {
+	bool enabled; /**< True if the loop is running. */
+	PhysicalAnalogInput_t input; /**< The process variable input. */
+	uint8_t output; /**< The physical digital output driven. */
+	int32_t setpoint; /**< The setpoint, in ADC counts. */
+	int32_t kp; /**< The proportional gain. */
+	int32_t ki; /**< The integral gain, per sample. */
+	int32_t kd; /**< The derivative gain, per sample. */
+	int64_t integral; /**< The integral term, in output units with DIGITAL_PID_GAIN_BITS fractional bits. */
+	bool primed; /**< True once a sample has been taken, so the derivative has a previous sample. */
+	int32_t previous; /**< The previous sample of the input. */
+	int32_t value; /**< The output last set, from 0 to DIGITAL_PID_OUTPUT_MAX. */
+	uint32_t saturations; /**< The number of samples the output has been clamped at either limit. */
+} DigitalPID_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Starts a PID loop.
+ */
+bool DigitalPID_Set(uint8_t number, PhysicalAnalogInput_t input, uint8_t output, int32_t setpoint, float kp, float ki,
+		float kd);
+
+/**
+ * @brief Changes the setpoint of a running PID loop.
+ */
+bool DigitalPID_SetSetpoint(uint8_t number, int32_t setpoint);
+
+/**
+ * @brief Stops a PID loop, turning its output off.
+ */
+bool DigitalPID_Clear(uint8_t number);
+
+/**
+ * @brief Retrieves a copy of a PID loop.
+ */
+bool DigitalPID_Get(uint8_t number, DigitalPID_t* loop);
+
+/**
+ * @brief Restarts the integral and derivative of every PID loop.
+ */
+void DigitalPID_Reset(void);
+
+/**
+ * @brief Turns the output of every PID loop off until its input is next sampled.
+ */
+void DigitalPID_Hold(void);
+
+/**
+ * @brief Updates the PID loops controlled by an analog input with a new sample.
+ */
+void DigitalPID_Process(PhysicalAnalogInput_t input, int32_t value);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DIGITALOUTPUT_PID_H_ */
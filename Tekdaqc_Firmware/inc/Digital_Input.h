@@ -57,6 +57,18 @@ extern "C" {
  */
 #define MAX_DIGITAL_INPUT_NAME_LENGTH 24
 
+/**
+ * @def MAX_DIGITAL_INPUT_HOLD_MS
+ * @brief The longest debounce hold time of a digital input, in milliseconds.
+ */
+#define MAX_DIGITAL_INPUT_HOLD_MS 31U
+
+/**
+ * @def DIGITAL_INPUT_DEBOUNCE_TICK_HZ
+ * @brief The rate at which the digital input debounce filter runs.
+ */
+#define DIGITAL_INPUT_DEBOUNCE_TICK_HZ 1000U
+
 
 
 /*--------------------------------------------------------------------------------------------------------*/
@@ -76,8 +88,32 @@ typedef struct {
 	char name[MAX_DIGITAL_INPUT_NAME_LENGTH]; /**< Pointer to a C string name for this input. */
 	DigitalLevel_t level; /**< The recorded status of this input. */
 	uint64_t timestamp; /**< The timestamp of the measurement in UNIX epoch format. */
+	uint8_t hold; /**< The time in milliseconds a new level must be held before it is accepted, 0 for no debounce. */
 } Digital_Input_t;
 
+/**
+ * @brief Data structure holding the pulse count of a digital input over one counting interval.
+ */
+typedef struct {
+	uint64_t start; /**< The local time the interval started. */
+	uint32_t duration; /**< The length of the interval in microseconds. */
+	uint32_t count; /**< The number of rising edges in the interval. */
+	uint32_t frequency_mHz; /**< The pulse frequency in millihertz. */
+	uint32_t period; /**< The pulse period in microseconds, 0 if fewer than two edges were seen. */
+} Digital_Input_Counter_t;
+
+/**
+ * @brief Data structure holding a sample of a quadrature encoder decoded from a pair of digital inputs.
+ */
+typedef struct {
+	uint64_t timestamp; /**< The local time of the sample. */
+	int32_t position; /**< The position in counts, four per encoder cycle, since the encoder was enabled. */
+	int32_t velocity; /**< The velocity in counts per second since the previous sample. */
+	uint8_t encoder; /**< The number of the encoder. */
+	GPI_TypeDef inputA; /**< The digital input of the encoder's A phase. */
+	GPI_TypeDef inputB; /**< The digital input of the encoder's B phase. */
+} Digital_Input_Encoder_t;
+
 
 
 /*--------------------------------------------------------------------------------------------------------*/
@@ -109,6 +145,11 @@ Tekdaqc_Function_Error_t RemoveDigitalInput(char keys[][MAX_COMMANDPART_LENGTH],
  */
 Tekdaqc_Function_Error_t ListDigitalInputs(void);
 
+/**
+ * @brief Prints the most recently sampled level of all the added digital inputs.
+ */
+Tekdaqc_Function_Error_t WriteLatestDigitalValues(void);
+
 /**
  * @brief Configures a digital input with the specified parameters.
  */
@@ -124,15 +165,80 @@ void SetDigitalInputWriteFunction(WriteFunction writeFunction);
  */
 void SampleDigitalInput(Digital_Input_t* input);
 
+/**
+ * @brief Reads the levels of all the digital inputs without recording them.
+ */
+uint32_t ReadDigitalInputLevels(void);
+
+/**
+ * @brief Reads the current unfiltered level of a digital input without recording it.
+ */
+DigitalLevel_t ReadDigitalInputLevel(const Digital_Input_t* input);
+
+/**
+ * @brief Runs one tick of the debounce filter.
+ */
+void DigitalInputsDebounceTick(void);
+
+/**
+ * @brief Retrieves the pin of a digital input.
+ */
+bool GetDigitalInputPin(const Digital_Input_t* input, uint8_t* portSource, uint16_t* pin);
+
+/**
+ * @brief Connects a digital input's pin to a peripheral, or back to plain input.
+ */
+void SetDigitalInputPinFunction(GPI_TypeDef gpi, bool alternate, uint8_t af);
+
+/**
+ * @brief Samples a set of digital inputs from a single snapshot of the GPI ports.
+ */
+void SampleDigitalInputs(Digital_Input_t* inputs[], uint_fast8_t count);
+
 /**
  * @brief Samples the digital input level of all added digital inputs, writing out the results.
  */
 void SampleAllDigitalInputs(void);
 
+/**
+ * @brief Sets the pointer to the function to invoke when binary digital input frames need to be written.
+ */
+void SetDigitalInputBinaryWriteFunction(BinaryWriteFunction writeFunction);
+
+/**
+ * @brief Makes the next binary frame resend the input names.
+ */
+void ResetDigitalInputBinaryFraming(void);
+
+/**
+ * @brief Writes out a scan of a set of digital inputs sampled together.
+ */
+WriteStatus_t WriteDigitalInputScan(Digital_Input_t* inputs[], uint_fast8_t count);
+
 /**
  * @brief Writes out the data for the specified digital input.
  */
-void WriteDigitalInput(Digital_Input_t* input);
+WriteStatus_t WriteDigitalInput(Digital_Input_t* input);
+
+/**
+ * @brief Writes out the counter report of a digital input.
+ */
+WriteStatus_t WriteDigitalInputCounter(const Digital_Input_t* input, const Digital_Input_Counter_t* counter);
+
+/**
+ * @brief Writes out a sample of a quadrature encoder.
+ */
+WriteStatus_t WriteDigitalInputEncoder(const Digital_Input_Encoder_t* encoder);
+
+/**
+ * @brief Writes out the latched edges of a scan.
+ */
+WriteStatus_t WriteDigitalInputLatch(uint64_t timestamp, uint32_t rose, uint32_t fell);
+
+/**
+ * @brief Retrieves the number of digital input records dropped because the connection was busy.
+ */
+unsigned long GetDigitalInputDroppedCount(void);
 
 /**
  * @brief Writes out the data for all added digital inputs.
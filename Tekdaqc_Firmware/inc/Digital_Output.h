@@ -71,12 +71,55 @@ extern "C" {
  */
 #define OUTPUT_OFF	(LOGIC_HIGH)
 
+/**
+ * @def DIGITAL_OUTPUT_TICK_HZ
+ * @brief The rate at which the digital output timer ticks, which sets the resolution of PWM waveforms and sequences.
+ */
+#define DIGITAL_OUTPUT_TICK_HZ 10000U
+
+/**
+ * @def MIN_DIGITAL_OUTPUT_PWM_HZ
+ * @brief The lowest PWM frequency of a digital output, in Hz.
+ */
+#define MIN_DIGITAL_OUTPUT_PWM_HZ 1U
+
+/**
+ * @def MAX_DIGITAL_OUTPUT_PWM_HZ
+ * @brief The highest PWM frequency of a digital output, in Hz. This keeps at least 10 ticks in every period.
+ */
+#define MAX_DIGITAL_OUTPUT_PWM_HZ 1000U
+
+/**
+ * @def DIGITAL_OUTPUT_SEQUENCE_LENGTH
+ * @brief The number of steps the digital output sequence table holds.
+ */
+#define DIGITAL_OUTPUT_SEQUENCE_LENGTH 64U
+
 
 
 /*--------------------------------------------------------------------------------------------------------*/
 /* EXPORTED TYPES */
 /*--------------------------------------------------------------------------------------------------------*/
 
+/**
+ * @brief Digital output sequence state enumeration.
+ * Defines the playback states of the digital output sequence.
+ */
+typedef enum {
+	DO_SEQUENCE_IDLE, /**< The sequence is not playing and may be edited. */
+	DO_SEQUENCE_ARMED, /**< The sequence will start playing when analog input sampling starts. */
+	DO_SEQUENCE_RUNNING, /**< The sequence is playing. */
+	DO_SEQUENCE_DONE /**< The sequence has finished and its outputs hold the levels of its last step. */
+} DigitalOutputSequenceState_t;
+
+/**
+ * @brief A step of the digital output sequence.
+ */
+typedef struct {
+	uint32_t offset; /**< The time of the step from the start of the sequence, in ticks of the output timer. */
+	DigitalOutputMask_t levels; /**< Bit field of the output levels from this step on, a set bit turning output n on. */
+} DigitalOutputStep_t;
+
 /**
  * @brief Data structure used to store the state and requirements of a digital output of the Tekdaqc.
  * This data structure contains all the information related to a particular input to the Tekdaqc. Please
@@ -92,6 +135,8 @@ typedef struct {
 	uint64_t timestamp; /**< The timestamp of the measurement in UNIX epoch format. */
 	uint64_t fault_timestamp; /**< The timestamp of the first occurrence of a fault. */
 	TLE7232_Status_t fault_status; /**< The current fault status of the output. */
+	uint16_t pwm_period; /**< The PWM period in ticks of the PWM timer, 0 if the output is not modulated. */
+	uint16_t pwm_duty; /**< The number of ticks of each PWM period the output is on for. */
 } Digital_Output_t;
 
 
@@ -135,6 +180,61 @@ Tekdaqc_Function_Error_t CreateDigitalOutput(char keys[][MAX_COMMANDPART_LENGTH]
  */
 Tekdaqc_Function_Error_t SetDigitalOutput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
 
+/**
+ * @brief Sets the levels of several digital outputs, switching them together.
+ */
+Tekdaqc_Function_Error_t SetDigitalOutputs(DigitalOutputMask_t mask, DigitalOutputMask_t levels);
+
+/**
+ * @brief Starts driving a digital output with a PWM waveform.
+ */
+Tekdaqc_Function_Error_t SetDigitalOutputPwm(uint8_t number, uint32_t frequency, uint8_t duty);
+
+/**
+ * @brief Changes the duty cycle of a modulated digital output.
+ */
+void SetDigitalOutputPwmDuty(uint8_t number, uint16_t duty);
+
+/**
+ * @brief Advances the PWM waveforms and the sequence of the digital outputs by one tick.
+ */
+void DigitalOutputsTick(void);
+
+/**
+ * @brief Appends a step to the digital output sequence.
+ */
+Tekdaqc_Function_Error_t AddDigitalOutputSequenceStep(uint32_t offset_us, DigitalOutputMask_t levels);
+
+/**
+ * @brief Empties the digital output sequence.
+ */
+Tekdaqc_Function_Error_t ClearDigitalOutputSequence(void);
+
+/**
+ * @brief Starts playing the digital output sequence.
+ */
+Tekdaqc_Function_Error_t StartDigitalOutputSequence(DigitalOutputMask_t mask, uint32_t repeats, uint32_t cycle_us, bool onSampling);
+
+/**
+ * @brief Starts an armed digital output sequence.
+ */
+void TriggerDigitalOutputSequence(void);
+
+/**
+ * @brief Stops the digital output sequence, leaving its outputs at their current levels.
+ */
+void StopDigitalOutputSequence(void);
+
+/**
+ * @brief Sets the levels the interlocks hold digital outputs at, over every other source of levels.
+ */
+void SetDigitalOutputInterlock(DigitalOutputMask_t mask, DigitalOutputMask_t levels);
+
+/**
+ * @brief Starts or stops merging the interlock levels into the outputs on every tick.
+ */
+void EnableDigitalOutputInterlock(bool enabled);
+
 /**
  * @brief Sets the pointer to the function to invoke when digital output data needs to be written.
  */
@@ -153,7 +253,17 @@ void SampleAllDigitalOutputs(void);
 /**
  * @brief Writes out the data for the specified digital output.
  */
-void WriteDigitalOutput(Digital_Output_t* output);
+WriteStatus_t WriteDigitalOutput(Digital_Output_t* output);
+
+/**
+ * @brief Retrieves the number of digital output records dropped because the connection was busy.
+ */
+unsigned long GetDigitalOutputDroppedCount(void);
+
+/**
+ * @brief Retrieves the levels of all the digital outputs.
+ */
+DigitalOutputMask_t GetDigitalOutputLevels(void);
 
 /**
  * @brief Writes out the data for all added digital outputs.
@@ -161,7 +271,7 @@ void WriteDigitalOutput(Digital_Output_t* output);
 void WriteAllDigitalOutputs(void);
 
 /**
- * @brief Checks the stored status register contents for any errors.
+ * @brief Services the background diagnosis of the digital outputs, signaling any new fault.
  */
 bool CheckDigitalOutputStatus(void);
 
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Benchmark.h
+ * @brief Header file for the floating point benchmarks.
+ *
+ * Contains public definitions for the start up benchmarks of the firmware's floating point paths and of the interrupt
+ * context save cost the FPU adds, used to compare builds with and without the hardware FPU. Only built when
+ * FLOAT_BENCHMARK is defined.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_BENCHMARK_H_
+#define TEKDAQC_BENCHMARK_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "stm32f4xx.h"
+
+/** @addtogroup tekdaqc_firmware Tekdaqc Firmware
+ * @{
+ */
+
+/** @addtogroup tekdaqc_benchmark Tekdaqc Benchmark
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def BENCHMARK_ITERATIONS
+ * @brief The number of times each benchmark is repeated, its result being the average.
+ */
+#define BENCHMARK_ITERATIONS	256U
+
+/**
+ * @def BENCHMARK_DELAY_MS
+ * @brief The delay requested of Delay_ms() by its benchmark (ms).
+ */
+#define BENCHMARK_DELAY_MS		0.01f
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#ifdef FLOAT_BENCHMARK
+
+/**
+ * @brief Runs the floating point benchmarks and prints their results.
+ */
+void Tekdaqc_RunFloatBenchmarks(void);
+
+#endif /* FLOAT_BENCHMARK */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_BENCHMARK_H_ */
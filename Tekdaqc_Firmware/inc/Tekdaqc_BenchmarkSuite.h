@@ -0,0 +1,103 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_BenchmarkSuite.h
+ * @brief Header file for the benchmark suite.
+ *
+ * Contains public definitions for the benchmark suite, which runs scripted acquisition scenarios at start up so the
+ * throughput of the hot paths can be compared across releases. Only built when BENCHMARK_SUITE is defined.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_BENCHMARKSUITE_H_
+#define TEKDAQC_BENCHMARKSUITE_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "Tekdaqc_Config.h"
+#include "stm32f4xx.h"
+
+/** @addtogroup tekdaqc_firmware Tekdaqc Firmware
+ * @{
+ */
+
+/** @addtogroup tekdaqc_benchmark_suite Tekdaqc Benchmark Suite
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def BENCHMARK_SCENARIO_TIME_US
+ * @brief The time each scenario is run for (us).
+ */
+#define BENCHMARK_SCENARIO_TIME_US	2000000U
+
+/**
+ * @def BENCHMARK_SETTLE_TIME_US
+ * @brief The time the program loop is run for after each scenario, to let halted sampling drain (us).
+ */
+#define BENCHMARK_SETTLE_TIME_US	250000U
+
+/**
+ * @def BENCHMARK_READY_TIMEOUT_US
+ * @brief The longest the suite waits for the ADC to finish its start up calibration (us).
+ */
+#define BENCHMARK_READY_TIMEOUT_US	30000000U
+
+/**
+ * @def BENCHMARK_SAMPLE_COUNT
+ * @brief The number of samples requested by each scenario, more than any can take before it is halted.
+ */
+#define BENCHMARK_SAMPLE_COUNT		"2000000000"
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#ifdef BENCHMARK_SUITE
+
+/**
+ * @brief Runs the scenarios of the benchmark suite and prints their results.
+ */
+void Tekdaqc_RunBenchmarkSuite(WriteFunction writer, BinaryWriteFunction binaryWriter);
+
+#endif /* BENCHMARK_SUITE */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_BENCHMARKSUITE_H_ */
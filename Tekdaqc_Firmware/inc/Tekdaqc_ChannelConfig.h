@@ -0,0 +1,144 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_ChannelConfig.h
+ * @brief Header file for the saved channel configuration of the Tekdaqc.
+ *
+ * Contains public definitions for saving the added analog inputs, digital inputs and digital outputs to the FLASH disk
+ * and restoring them, so that a board comes out of reset with the channels it was last configured with, and for saving
+ * a sampling job which is started at boot without waiting for a host and the named command macros run on the board.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_CHANNELCONFIG_H_
+#define TEKDAQC_CHANNELCONFIG_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_BSP.h"
+#include "Tekdaqc_Error.h"
+
+/** @addtogroup tekdaqc_firmware Tekdaqc Firmware
+ * @{
+ */
+
+/** @addtogroup channel_config Channel Configuration
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def CHANNEL_CONFIG_MARKER
+ * @brief The value of the marker word of a saved configuration. Changed whenever the record layout changes.
+ */
+#define CHANNEL_CONFIG_MARKER	((uint16_t) 0xC001)
+
+/**
+ * @def SAMPLING_JOB_MARKER
+ * @brief The value of the marker word of a saved sampling job. Changed whenever the record layout changes.
+ */
+#define SAMPLING_JOB_MARKER		((uint16_t) 0x10B1)
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Sampling job data structure.
+ * Holds the parameters of a SAMPLE command which is started at boot, and where its data is published.
+ */
+typedef struct {
+	int32_t number; /**< The number of samples to take, 0 to sample continuously. */
+	uint32_t window; /**< The statistics window in samples, 0 if not used. */
+	uint32_t period; /**< The statistics window in milliseconds, 0 if not used. */
+	uint32_t address; /**< The IPv4 address, in network byte order, data is published to. 0 if not published. */
+	uint16_t port; /**< The UDP port data is published to. */
+	uint16_t overflow; /**< The ADC_OverflowPolicy_t of the analog sample buffers. */
+} SamplingJob_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Saves the configuration of the added channels to the FLASH disk.
+ */
+Tekdaqc_Function_Error_t SaveChannelConfig(void);
+
+/**
+ * @brief Adds the channels of the saved configuration.
+ */
+Tekdaqc_Function_Error_t LoadChannelConfig(void);
+
+/**
+ * @brief Saves a sampling job to the FLASH disk.
+ */
+Tekdaqc_Function_Error_t SaveSamplingJob(const SamplingJob_t* job);
+
+/**
+ * @brief Clears the saved sampling job.
+ */
+Tekdaqc_Function_Error_t ClearSamplingJob(void);
+
+/**
+ * @brief Retrieves the saved sampling job.
+ */
+Tekdaqc_Function_Error_t LoadSamplingJob(SamplingJob_t* job);
+
+/**
+ * @brief Finds the slot of the saved macro of the provided name.
+ */
+int8_t FindMacro(const char* name);
+
+/**
+ * @brief Saves a command macro to the FLASH disk.
+ */
+Tekdaqc_Function_Error_t SaveMacro(const char* name, const char* text, uint16_t length);
+
+/**
+ * @brief Deletes the saved macro of the provided name.
+ */
+Tekdaqc_Function_Error_t DeleteMacro(const char* name);
+
+/**
+ * @brief Retrieves the name and text of the macro saved in a slot.
+ */
+uint16_t LoadMacro(uint8_t slot, char* name, char* text);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_CHANNELCONFIG_H_ */
@@ -39,6 +39,7 @@ extern "C" {
 #include "Analog_Input.h"
 #include "Digital_Input.h"
 #include "Digital_Output.h"
+#include "Tekdaqc_CAN.h"
 #include <string.h>
 
 /** @addtogroup tekdaqc_firmware Tekdaqc Firmware
@@ -112,11 +113,411 @@ extern "C" {
  */
 #define PARAMETER_VALUE			"VALUE"
 
+/**
+ * @def PARAMETER_TIME
+ * @brief String constant definition for the TIME parameter.
+ */
+#define PARAMETER_TIME			"TIME"
+
+/**
+ * @def PARAMETER_SCANS
+ * @brief String constant definition for the SCANS parameter.
+ */
+#define PARAMETER_SCANS			"SCANS"
+
+/**
+ * @def PARAMETER_FORMAT
+ * @brief String constant definition for the FORMAT parameter.
+ */
+#define PARAMETER_FORMAT		"FORMAT"
+
+/**
+ * @def PARAMETER_ADDRESS
+ * @brief String constant definition for the ADDRESS parameter.
+ */
+#define PARAMETER_ADDRESS		"ADDRESS"
+
+/**
+ * @def PARAMETER_PORT
+ * @brief String constant definition for the PORT parameter.
+ */
+#define PARAMETER_PORT			"PORT"
+
+/**
+ * @def PARAMETER_FILTER
+ * @brief String constant definition for the FILTER parameter.
+ */
+#define PARAMETER_FILTER		"FILTER"
+
+/**
+ * @def PARAMETER_DECIMATION
+ * @brief String constant definition for the DECIMATION parameter.
+ */
+#define PARAMETER_DECIMATION	"DECIMATION"
+
+/**
+ * @def PARAMETER_WINDOW
+ * @brief String constant definition for the WINDOW parameter.
+ */
+#define PARAMETER_WINDOW		"WINDOW"
+
+/**
+ * @def PARAMETER_DEADBAND
+ * @brief String constant definition for the DEADBAND parameter.
+ */
+#define PARAMETER_DEADBAND		"DEADBAND"
+
+/**
+ * @def PARAMETER_HEARTBEAT
+ * @brief String constant definition for the HEARTBEAT parameter.
+ */
+#define PARAMETER_HEARTBEAT		"HEARTBEAT"
+
+/**
+ * @def PARAMETER_SOURCE
+ * @brief String constant definition for the SOURCE parameter.
+ */
+#define PARAMETER_SOURCE		"SOURCE"
+
+/**
+ * @def PARAMETER_LEVEL
+ * @brief String constant definition for the LEVEL parameter.
+ */
+#define PARAMETER_LEVEL			"LEVEL"
+
+/**
+ * @def PARAMETER_EDGE
+ * @brief String constant definition for the EDGE parameter.
+ */
+#define PARAMETER_EDGE			"EDGE"
+
+/**
+ * @def PARAMETER_PRE
+ * @brief String constant definition for the PRE parameter.
+ */
+#define PARAMETER_PRE			"PRE"
+
+/**
+ * @def PARAMETER_POST
+ * @brief String constant definition for the POST parameter.
+ */
+#define PARAMETER_POST			"POST"
+
+/**
+ * @def PARAMETER_HOLD
+ * @brief String constant definition for the HOLD parameter.
+ */
+#define PARAMETER_HOLD			"HOLD"
+
+/**
+ * @def PARAMETER_CONNECTION
+ * @brief String constant definition for the CONNECTION parameter.
+ */
+#define PARAMETER_CONNECTION	"CONNECTION"
+
+/**
+ * @def PARAMETER_NETMASK
+ * @brief String constant definition for the NETMASK parameter.
+ */
+#define PARAMETER_NETMASK		"NETMASK"
+
+/**
+ * @def PARAMETER_GATEWAY
+ * @brief String constant definition for the GATEWAY parameter.
+ */
+#define PARAMETER_GATEWAY		"GATEWAY"
+
+/**
+ * @def PARAMETER_BANDWIDTH
+ * @brief String constant definition for the BANDWIDTH parameter.
+ */
+#define PARAMETER_BANDWIDTH		"BANDWIDTH"
+
+/**
+ * @def PARAMETER_TEMPERATURE
+ * @brief String constant definition for the TEMPERATURE parameter.
+ */
+#define PARAMETER_TEMPERATURE	"TEMPERATURE"
+
+/**
+ * @def PARAMETER_TYPE
+ * @brief String constant definition for the TYPE parameter.
+ */
+#define PARAMETER_TYPE			"TYPE"
+
+/**
+ * @def PARAMETER_POSITIVE
+ * @brief String constant definition for the POSITIVE parameter.
+ */
+#define PARAMETER_POSITIVE		"POSITIVE"
+
+/**
+ * @def PARAMETER_NEGATIVE
+ * @brief String constant definition for the NEGATIVE parameter.
+ */
+#define PARAMETER_NEGATIVE		"NEGATIVE"
+
+/**
+ * @def PARAMETER_OVERFLOW
+ * @brief String constant definition for the OVERFLOW parameter.
+ */
+#define PARAMETER_OVERFLOW		"OVERFLOW"
+
+/**
+ * @def PARAMETER_FRAME
+ * @brief String constant definition for the FRAME parameter.
+ */
+#define PARAMETER_FRAME			"FRAME"
+
+/**
+ * @def PARAMETER_INTERVAL
+ * @brief String constant definition for the INTERVAL parameter.
+ */
+#define PARAMETER_INTERVAL		"INTERVAL"
+
+/**
+ * @def PARAMETER_PENDING
+ * @brief String constant definition for the PENDING parameter.
+ */
+#define PARAMETER_PENDING		"PENDING"
+
+/**
+ * @def PARAMETER_SEQUENCE
+ * @brief String constant definition for the SEQUENCE parameter.
+ */
+#define PARAMETER_SEQUENCE		"SEQUENCE"
+
+/**
+ * @def PARAMETER_POINTS
+ * @brief String constant definition for the POINTS parameter.
+ */
+#define PARAMETER_POINTS		"POINTS"
+
+/**
+ * @def PARAMETER_PEAKS
+ * @brief String constant definition for the PEAKS parameter.
+ */
+#define PARAMETER_PEAKS			"PEAKS"
+
+/**
+ * @def PARAMETER_VOLTAGE
+ * @brief String constant definition for the VOLTAGE parameter.
+ */
+#define PARAMETER_VOLTAGE		"VOLTAGE"
+
+/**
+ * @def PARAMETER_CURRENT
+ * @brief String constant definition for the CURRENT parameter.
+ */
+#define PARAMETER_CURRENT		"CURRENT"
+
+/**
+ * @def PARAMETER_CYCLES
+ * @brief String constant definition for the CYCLES parameter.
+ */
+#define PARAMETER_CYCLES		"CYCLES"
+
+/**
+ * @def PARAMETER_COMPARATOR
+ * @brief String constant definition for the COMPARATOR parameter.
+ */
+#define PARAMETER_COMPARATOR	"COMPARATOR"
+
+/**
+ * @def PARAMETER_HYSTERESIS
+ * @brief String constant definition for the HYSTERESIS parameter.
+ */
+#define PARAMETER_HYSTERESIS	"HYSTERESIS"
+
+/**
+ * @def PARAMETER_LATCH
+ * @brief String constant definition for the LATCH parameter.
+ */
+#define PARAMETER_LATCH			"LATCH"
+
+/**
+ * @def PARAMETER_SETPOINT
+ * @brief String constant definition for the SETPOINT parameter.
+ */
+#define PARAMETER_SETPOINT		"SETPOINT"
+
+/**
+ * @def PARAMETER_KP
+ * @brief String constant definition for the KP parameter.
+ */
+#define PARAMETER_KP			"KP"
+
+/**
+ * @def PARAMETER_KI
+ * @brief String constant definition for the KI parameter.
+ */
+#define PARAMETER_KI			"KI"
+
+/**
+ * @def PARAMETER_KD
+ * @brief String constant definition for the KD parameter.
+ */
+#define PARAMETER_KD			"KD"
+
+/**
+ * @def PARAMETER_EXPR
+ * @brief String constant definition for the EXPR parameter.
+ */
+#define PARAMETER_EXPR			"EXPR"
+
+/**
+ * @def PARAMETER_RAW
+ * @brief String constant definition for the RAW parameter.
+ */
+#define PARAMETER_RAW			"RAW"
+
+/**
+ * @def PARAMETER_IDLE
+ * @brief String constant definition for the IDLE parameter.
+ */
+#define PARAMETER_IDLE			"IDLE"
+
+/**
+ * @def PARAMETER_TIMEOUT
+ * @brief String constant definition for the TIMEOUT parameter.
+ */
+#define PARAMETER_TIMEOUT		"TIMEOUT"
+
+/**
+ * @def PARAMETER_ENCODING
+ * @brief String constant definition for the ENCODING parameter.
+ */
+#define PARAMETER_ENCODING		"ENCODING"
+
+/**
+ * @def PARAMETER_FIELDS
+ * @brief String constant definition for the FIELDS parameter.
+ */
+#define PARAMETER_FIELDS		"FIELDS"
+
+/**
+ * @def ADDRESS_NONE_STRING
+ * @brief String constant definition for the NONE value of the ADDRESS parameter.
+ */
+#define ADDRESS_NONE_STRING		"NONE"
+
+/**
+ * @def FORMAT_TEXT_STRING
+ * @brief String constant definition for the TEXT value of the FORMAT parameter.
+ */
+#define FORMAT_TEXT_STRING		"TEXT"
+
+/**
+ * @def FORMAT_BINARY_STRING
+ * @brief String constant definition for the BINARY value of the FORMAT parameter.
+ */
+#define FORMAT_BINARY_STRING	"BINARY"
+
+/**
+ * @def FORMAT_COMPRESSED_STRING
+ * @brief String constant definition for the COMPRESSED value of the FORMAT parameter.
+ */
+#define FORMAT_COMPRESSED_STRING	"COMPRESSED"
+
+/**
+ * @def FIELD_TIMESTAMP_STRING
+ * @brief String constant definition for the TIMESTAMP value of the FIELDS parameter.
+ */
+#define FIELD_TIMESTAMP_STRING	"TIMESTAMP"
+
+/**
+ * @def FIELD_VALUE_STRING
+ * @brief String constant definition for the VALUE value of the FIELDS parameter, which is always sent.
+ */
+#define FIELD_VALUE_STRING		"VALUE"
+
+/**
+ * @def FIELD_FLAGS_STRING
+ * @brief String constant definition for the FLAGS value of the FIELDS parameter.
+ */
+#define FIELD_FLAGS_STRING		"FLAGS"
+
+/**
+ * @def FIELD_SEQUENCE_STRING
+ * @brief String constant definition for the SEQUENCE value of the FIELDS parameter.
+ */
+#define FIELD_SEQUENCE_STRING	"SEQUENCE"
+
+/**
+ * @def CONNECTION_TELNET_STRING
+ * @brief String constant definition for the TELNET value of the CONNECTION parameter.
+ */
+#define CONNECTION_TELNET_STRING	"TELNET"
+
+/**
+ * @def CONNECTION_DATA_STRING
+ * @brief String constant definition for the DATA value of the CONNECTION parameter.
+ */
+#define CONNECTION_DATA_STRING		"DATA"
+
+/**
+ * @def STATE_ON_STRING
+ * @brief String constant definition for the ON value of the STATE parameter.
+ */
+#define STATE_ON_STRING			"ON"
+
+/**
+ * @def STATE_OFF_STRING
+ * @brief String constant definition for the OFF value of the STATE parameter.
+ */
+#define STATE_OFF_STRING		"OFF"
+
+/**
+ * @def PENDING_FLUSH_STRING
+ * @brief String constant definition for the FLUSH value of the PENDING parameter.
+ */
+#define PENDING_FLUSH_STRING	"FLUSH"
+
+/**
+ * @def PENDING_DISCARD_STRING
+ * @brief String constant definition for the DISCARD value of the PENDING parameter.
+ */
+#define PENDING_DISCARD_STRING	"DISCARD"
+
 /**
  * @def NUM_COMMANDS
  * @brief The total number of commands known by this board.
  */
-#define NUM_COMMANDS 28
+#define NUM_COMMANDS 105
+
+/**
+ * @def COMMAND_BATCH_ERROR_LENGTH
+ * @brief The maximum length of the error text kept for the first failure of a command batch.
+ */
+#define COMMAND_BATCH_ERROR_LENGTH 128U
+
+/**
+ * @def COMMAND_BINARY_SYNC
+ * @brief The byte which starts a binary command frame when received at the start of a line.
+ *
+ * A binary frame is laid out as the sync byte, the Command_t of the command, the payload length, the payload and a
+ * checksum byte chosen so that the command, length, payload and checksum bytes sum to 0 modulo 256. Multi-byte
+ * payload fields are little endian. A frame with an empty payload executes any command with no parameters. The
+ * commands which accept a payload, and its layout, are:
+ *
+ * ADD_ANALOG_INPUT: input (1), buffer (1, ADS1256_BUFFER_t), rate (1, ADS1256_SPS_t), gain (1, ADS1256_PGA_t),
+ * deadband (4, ADC counts), heartbeat (4, ms), then an optional name filling the rest of the payload.
+ *
+ * SET_DIGITAL_OUTPUTS: mask (2), levels (2).
+ *
+ * SET_DIGITAL_OUTPUT_PWM: output (1), duty cycle (1, %), frequency (4, Hz).
+ *
+ * ADD_DIGITAL_OUTPUT_SEQUENCE_STEP: offset (4, us), levels (2).
+ *
+ * The reply is the same status or error message as for the text form of the command.
+ */
+#define COMMAND_BINARY_SYNC ((char) 0x02)
+
+/**
+ * @def COMMAND_BINARY_MAX_PAYLOAD
+ * @brief The largest payload a binary command frame may carry.
+ */
+#define COMMAND_BINARY_MAX_PAYLOAD 64U
 
 /**
  * @def TELNET_EOF
@@ -160,15 +561,120 @@ typedef enum {
 	COMMAND_SET_USER_MAC = 24,
 	COMMAND_SET_STATIC_IP = 25,
 	COMMAND_GET_CALIBRATION_STATUS = 26,
-	COMMAND_NONE = 27
+	COMMAND_SET_COLD_JUNCTION_REFRESH = 27,
+	COMMAND_SET_DATA_FORMAT = 28,
+	COMMAND_SET_FLUSH_LATENCY = 29,
+	COMMAND_SET_PUBLISH = 30,
+	COMMAND_SET_DIGITAL_INPUT_RATE = 31,
+	COMMAND_SET_ANALOG_INPUT_FILTER = 32,
+	COMMAND_CAPTURE = 33,
+	COMMAND_PROFILE = 34,
+	COMMAND_GET_TIMING_HISTOGRAMS = 35,
+	COMMAND_RESET_TIMING_HISTOGRAMS = 36,
+	COMMAND_READ_DIGITAL_INPUT_EDGES = 37,
+	COMMAND_READ_DIGITAL_INPUT_COUNTERS = 38,
+	COMMAND_SET_DIGITAL_OUTPUTS = 39,
+	COMMAND_SET_DIGITAL_OUTPUT_PWM = 40,
+	COMMAND_ADD_DIGITAL_OUTPUT_SEQUENCE_STEP = 41,
+	COMMAND_CLEAR_DIGITAL_OUTPUT_SEQUENCE = 42,
+	COMMAND_START_DIGITAL_OUTPUT_SEQUENCE = 43,
+	COMMAND_BEGIN_BATCH = 44,
+	COMMAND_END_BATCH = 45,
+	COMMAND_SAVE_CONFIG = 46,
+	COMMAND_LOAD_CONFIG = 47,
+	COMMAND_SAVE_JOB = 48,
+	COMMAND_CLEAR_JOB = 49,
+	COMMAND_GET_BOOT_TIMES = 50,
+	COMMAND_GET_NETWORK_STATS = 51,
+	COMMAND_SET_NO_DELAY = 52,
+	COMMAND_SET_SUBSCRIPTION = 53,
+	COMMAND_SET_TIME_SERVER = 54,
+	COMMAND_SET_CAN_SYNC = 55,
+	COMMAND_SET_CAN_STREAM = 56,
+	COMMAND_SET_ANALOG_INPUT_OVERSAMPLING = 57,
+	COMMAND_GET_SCAN_TIME = 58,
+	COMMAND_SET_BACKGROUND_CALIBRATION = 59,
+	COMMAND_SET_ANALOG_INPUT_THERMOCOUPLE = 60,
+	COMMAND_SET_ANALOG_INPUT_SETTLE = 61,
+	COMMAND_SET_ANALOG_INPUT_PAIR = 62,
+	COMMAND_GET_TASK_STATS = 63,
+	COMMAND_GET_CRASH_RECORD = 64,
+	COMMAND_GET_UPGRADE_STATUS = 65,
+	COMMAND_APPLY_UPGRADE = 66,
+	COMMAND_DISCARD_UPGRADE = 67,
+	COMMAND_STATS = 68,
+	COMMAND_GET_MEMORY_USAGE = 69,
+	COMMAND_SET_OUTPUT_BUDGET = 70,
+	COMMAND_BEGIN_CONFIG = 71,
+	COMMAND_COMMIT_CONFIG = 72,
+	COMMAND_READ_LATEST_VALUES = 73,
+	COMMAND_SET_SAMPLE_LOG = 74,
+	COMMAND_GET_SAMPLE_LOG_STATUS = 75,
+	COMMAND_RESUME_SAMPLE_LOG = 76,
+	COMMAND_BURST_CAPTURE = 77,
+	COMMAND_READ_BURST_CAPTURE = 78,
+	COMMAND_READ_BURST_SPECTRUM = 79,
+	COMMAND_SET_ANALOG_POWER = 80,
+	COMMAND_SET_INTERLOCK = 81,
+	COMMAND_RESET_INTERLOCKS = 82,
+	COMMAND_LIST_INTERLOCKS = 83,
+	COMMAND_SET_PID = 84,
+	COMMAND_LIST_PID_LOOPS = 85,
+	COMMAND_SET_MATH_CHANNEL = 86,
+	COMMAND_LIST_MATH_CHANNELS = 87,
+	COMMAND_SET_ANALOG_INPUT_AUTO_RANGE = 88,
+	COMMAND_SET_SENSOR_CHECK = 89,
+	COMMAND_GET_SENSOR_CHECK = 90,
+	COMMAND_SET_DIGITAL_INPUT_ENCODER = 91,
+	COMMAND_SET_DIGITAL_INPUT_LATCH = 92,
+	COMMAND_SET_MIXED_SIGNAL = 93,
+	COMMAND_SET_LOG_LEVEL = 94,
+	COMMAND_READ_STATE_TRACE = 95,
+	COMMAND_SET_KEEPALIVE = 96,
+	COMMAND_FORMAT = 97,
+	COMMAND_SET_AUX_ANALOG = 98,
+	COMMAND_BEGIN_MACRO = 99,
+	COMMAND_END_MACRO = 100,
+	COMMAND_RUN_MACRO = 101,
+	COMMAND_DELETE_MACRO = 102,
+	COMMAND_LIST_MACROS = 103,
+	COMMAND_NONE = 104
 } Command_t;
 
+/**
+ * @brief Binary command frame receive state enumeration.
+ * Defines which part of a binary command frame the next received byte is.
+ */
+typedef enum {
+	BINARY_FRAME_IDLE, /**< No binary frame is being received. */
+	BINARY_FRAME_COMMAND, /**< The next byte is the command. */
+	BINARY_FRAME_LENGTH, /**< The next byte is the payload length. */
+	BINARY_FRAME_PAYLOAD, /**< The next byte is part of the payload. */
+	BINARY_FRAME_CHECKSUM /**< The next byte is the checksum. */
+} BinaryFrameState_t;
+
 /**
  * @brief Data structure for maintaining the state of the command interpreter.
  */
 typedef struct {
 	char command_buffer[MAX_COMMANDLINE_LENGTH]; /**< A buffer which stores the currently being built command. */
 	uint16_t buffer_position; /**< The current write position in the command buffer. */
+	bool batch_active; /**< True while the replies of commands are being aggregated into a batch reply. */
+	uint16_t batch_count; /**< The number of commands executed in the current batch. */
+	uint16_t batch_failures; /**< The number of commands in the current batch which failed. */
+	uint16_t batch_first_failure; /**< The position in the batch of the first command to fail, counting from 1. */
+	char batch_error[COMMAND_BATCH_ERROR_LENGTH]; /**< The error text of the first command in the batch to fail. */
+	bool macro_recording; /**< True while the command lines received are being recorded into a macro, not executed. */
+	bool macro_running; /**< True while the command lines of a saved macro are being executed. */
+	bool macro_overflow; /**< True if the macro being recorded has outgrown MACRO_SIZE. */
+	uint16_t macro_length; /**< The number of characters recorded into the macro so far. */
+	char macro_name[MACRO_NAME_LENGTH]; /**< The name of the macro being recorded or run. */
+	BinaryFrameState_t binary_state; /**< The receive state of the current binary command frame. */
+	uint8_t binary_command; /**< The command of the binary frame being received. */
+	uint8_t binary_length; /**< The payload length of the binary frame being received. */
+	uint8_t binary_position; /**< The number of payload bytes of the binary frame received so far. */
+	uint8_t binary_checksum; /**< The running sum of the bytes of the binary frame being received. */
+	uint8_t binary_payload[COMMAND_BINARY_MAX_PAYLOAD]; /**< The payload of the binary frame being received. */
 } Tekdaqc_CommandInterpreter_t;
 
 /*--------------------------------------------------------------------------------------------------------*/
@@ -203,7 +709,7 @@ extern const char* READ_ANALOG_INPUT_PARAMS[NUM_READ_ANALOG_INPUT_PARAMS];
  * @def NUM_ADD_ANALOG_INPUT_PARAMS
  * @brief The number of parameters for the ADD_ANALOG_INPUT command.
  */
-#define NUM_ADD_ANALOG_INPUT_PARAMS 5
+#define NUM_ADD_ANALOG_INPUT_PARAMS 7
 /* Prototype the ADD_ANALOG_INPUT command params array */
 extern const char* ADD_ANALOG_INPUT_PARAMS[NUM_ADD_ANALOG_INPUT_PARAMS];
 
@@ -259,7 +765,7 @@ extern const char* READ_DIGITAL_INPUT_PARAMS[NUM_READ_DIGITAL_INPUT_PARAMS];
  * @def NUM_ADD_DIGITAL_INPUT_PARAMS
  * @brief The number of parameters for the ADD_DIGITAL_INPUT command.
  */
-#define NUM_ADD_DIGITAL_INPUT_PARAMS 2
+#define NUM_ADD_DIGITAL_INPUT_PARAMS 3
 /* Prototype the ADD_DIGITAL_INPUT command params array */
 extern const char* ADD_DIGITAL_INPUT_PARAMS[NUM_ADD_DIGITAL_INPUT_PARAMS];
 
@@ -347,7 +853,7 @@ extern const char* IDENTIFY_PARAMS[NUM_IDENTIFY_PARAMS];
  * @def NUM_SAMPLE_PARAMS
  * @brief The number of parameters for the SAMPLE command.
  */
-#define NUM_SAMPLE_PARAMS 1
+#define NUM_SAMPLE_PARAMS 7
 /* Prototype the SAMPLE command params array */
 extern const char* SAMPLE_PARAMS[NUM_SAMPLE_PARAMS];
 
@@ -355,7 +861,7 @@ extern const char* SAMPLE_PARAMS[NUM_SAMPLE_PARAMS];
  * @def NUM_HALT_PARAMS
  * @brief The number of parameters for the HALT command.
  */
-#define NUM_HALT_PARAMS 0
+#define NUM_HALT_PARAMS 1
 /* Prototype the HALT command params array */
 extern const char* HALT_PARAMS[NUM_HALT_PARAMS];
 
@@ -379,7 +885,7 @@ extern const char* SET_USER_MAC_PARAMS[NUM_SET_USER_MAC_PARAMS];
  * @def NUM_SET_STATIC_IP_PARAMS
  * @brief The number of parameters for the SET_STATIC_IP command.
  */
-#define NUM_SET_STATIC_IP_PARAMS 1
+#define NUM_SET_STATIC_IP_PARAMS 3
 /* Prototype the SET_STATIC_IP command params array */
 extern const char* SET_STATIC_IP_PARAMS[NUM_SET_STATIC_IP_PARAMS];
 
@@ -391,6 +897,622 @@ extern const char* SET_STATIC_IP_PARAMS[NUM_SET_STATIC_IP_PARAMS];
 /* Prototype the GET_CALIBRATION_STATUS command params array */
 extern const char* GET_CALIBRATION_STATUS_PARAMS[NUM_GET_CALIBRATION_STATUS_PARAMS];
 
+/**
+ * @def NUM_SET_COLD_JUNCTION_REFRESH_PARAMS
+ * @brief The number of parameters for the SET_COLD_JUNCTION_REFRESH command.
+ */
+#define NUM_SET_COLD_JUNCTION_REFRESH_PARAMS 2
+/* Prototype the SET_COLD_JUNCTION_REFRESH command params array */
+extern const char* SET_COLD_JUNCTION_REFRESH_PARAMS[NUM_SET_COLD_JUNCTION_REFRESH_PARAMS];
+
+/**
+ * @def NUM_SET_DATA_FORMAT_PARAMS
+ * @brief The number of parameters for the SET_DATA_FORMAT command.
+ */
+#define NUM_SET_DATA_FORMAT_PARAMS 1
+/* Prototype the SET_DATA_FORMAT command params array */
+extern const char* SET_DATA_FORMAT_PARAMS[NUM_SET_DATA_FORMAT_PARAMS];
+
+/**
+ * @def NUM_SET_FLUSH_LATENCY_PARAMS
+ * @brief The number of parameters for the SET_FLUSH_LATENCY command.
+ */
+#define NUM_SET_FLUSH_LATENCY_PARAMS 1
+/* Prototype the SET_FLUSH_LATENCY command params array */
+extern const char* SET_FLUSH_LATENCY_PARAMS[NUM_SET_FLUSH_LATENCY_PARAMS];
+
+/**
+ * @def NUM_SET_PUBLISH_PARAMS
+ * @brief The number of parameters for the SET_PUBLISH command.
+ */
+#define NUM_SET_PUBLISH_PARAMS 2
+/* Prototype the SET_PUBLISH command params array */
+extern const char* SET_PUBLISH_PARAMS[NUM_SET_PUBLISH_PARAMS];
+
+/**
+ * @def NUM_SET_DIGITAL_INPUT_RATE_PARAMS
+ * @brief The number of parameters for the SET_DIGITAL_INPUT_RATE command.
+ */
+#define NUM_SET_DIGITAL_INPUT_RATE_PARAMS 1
+/* Prototype the SET_DIGITAL_INPUT_RATE command params array */
+extern const char* SET_DIGITAL_INPUT_RATE_PARAMS[NUM_SET_DIGITAL_INPUT_RATE_PARAMS];
+
+/**
+ * @def NUM_SET_ANALOG_INPUT_FILTER_PARAMS
+ * @brief The number of parameters for the SET_ANALOG_INPUT_FILTER command.
+ */
+#define NUM_SET_ANALOG_INPUT_FILTER_PARAMS 3
+/* Prototype the SET_ANALOG_INPUT_FILTER command params array */
+extern const char* SET_ANALOG_INPUT_FILTER_PARAMS[NUM_SET_ANALOG_INPUT_FILTER_PARAMS];
+
+/**
+ * @def NUM_CAPTURE_PARAMS
+ * @brief The number of parameters for the CAPTURE command.
+ */
+#define NUM_CAPTURE_PARAMS 6
+/* Prototype the CAPTURE command params array */
+extern const char* CAPTURE_PARAMS[NUM_CAPTURE_PARAMS];
+
+/**
+ * @def NUM_PROFILE_PARAMS
+ * @brief The number of parameters for the PROFILE command.
+ */
+#define NUM_PROFILE_PARAMS 0
+/* Prototype the PROFILE command params array */
+extern const char* PROFILE_PARAMS[NUM_PROFILE_PARAMS];
+
+/**
+ * @def NUM_GET_TIMING_HISTOGRAMS_PARAMS
+ * @brief The number of parameters for the GET_TIMING_HISTOGRAMS command.
+ */
+#define NUM_GET_TIMING_HISTOGRAMS_PARAMS 0
+/* Prototype the GET_TIMING_HISTOGRAMS command params array */
+extern const char* GET_TIMING_HISTOGRAMS_PARAMS[NUM_GET_TIMING_HISTOGRAMS_PARAMS];
+
+/**
+ * @def NUM_RESET_TIMING_HISTOGRAMS_PARAMS
+ * @brief The number of parameters for the RESET_TIMING_HISTOGRAMS command.
+ */
+#define NUM_RESET_TIMING_HISTOGRAMS_PARAMS 0
+/* Prototype the RESET_TIMING_HISTOGRAMS command params array */
+extern const char* RESET_TIMING_HISTOGRAMS_PARAMS[NUM_RESET_TIMING_HISTOGRAMS_PARAMS];
+
+/**
+ * @def NUM_READ_DIGITAL_INPUT_EDGES_PARAMS
+ * @brief The number of parameters for the READ_DIGITAL_INPUT_EDGES command.
+ */
+#define NUM_READ_DIGITAL_INPUT_EDGES_PARAMS 1
+/* Prototype the READ_DIGITAL_INPUT_EDGES command params array */
+extern const char* READ_DIGITAL_INPUT_EDGES_PARAMS[NUM_READ_DIGITAL_INPUT_EDGES_PARAMS];
+
+/**
+ * @def NUM_READ_DIGITAL_INPUT_COUNTERS_PARAMS
+ * @brief The number of parameters for the READ_DIGITAL_INPUT_COUNTERS command.
+ */
+#define NUM_READ_DIGITAL_INPUT_COUNTERS_PARAMS 2
+/* Prototype the READ_DIGITAL_INPUT_COUNTERS command params array */
+extern const char* READ_DIGITAL_INPUT_COUNTERS_PARAMS[NUM_READ_DIGITAL_INPUT_COUNTERS_PARAMS];
+
+/**
+ * @def NUM_SET_DIGITAL_OUTPUTS_PARAMS
+ * @brief The number of parameters for the SET_DIGITAL_OUTPUTS command.
+ */
+#define NUM_SET_DIGITAL_OUTPUTS_PARAMS 2
+/* Prototype the SET_DIGITAL_OUTPUTS command params array */
+extern const char* SET_DIGITAL_OUTPUTS_PARAMS[NUM_SET_DIGITAL_OUTPUTS_PARAMS];
+
+/**
+ * @def NUM_SET_DIGITAL_OUTPUT_PWM_PARAMS
+ * @brief The number of parameters for the SET_DIGITAL_OUTPUT_PWM command.
+ */
+#define NUM_SET_DIGITAL_OUTPUT_PWM_PARAMS 3
+/* Prototype the SET_DIGITAL_OUTPUT_PWM command params array */
+extern const char* SET_DIGITAL_OUTPUT_PWM_PARAMS[NUM_SET_DIGITAL_OUTPUT_PWM_PARAMS];
+
+/**
+ * @def NUM_ADD_DIGITAL_OUTPUT_SEQUENCE_STEP_PARAMS
+ * @brief The number of parameters for the ADD_DIGITAL_OUTPUT_SEQUENCE_STEP command.
+ */
+#define NUM_ADD_DIGITAL_OUTPUT_SEQUENCE_STEP_PARAMS 2
+/* Prototype the ADD_DIGITAL_OUTPUT_SEQUENCE_STEP command params array */
+extern const char* ADD_DIGITAL_OUTPUT_SEQUENCE_STEP_PARAMS[NUM_ADD_DIGITAL_OUTPUT_SEQUENCE_STEP_PARAMS];
+
+/**
+ * @def NUM_CLEAR_DIGITAL_OUTPUT_SEQUENCE_PARAMS
+ * @brief The number of parameters for the CLEAR_DIGITAL_OUTPUT_SEQUENCE command.
+ */
+#define NUM_CLEAR_DIGITAL_OUTPUT_SEQUENCE_PARAMS 0
+/* Prototype the CLEAR_DIGITAL_OUTPUT_SEQUENCE command params array */
+extern const char* CLEAR_DIGITAL_OUTPUT_SEQUENCE_PARAMS[NUM_CLEAR_DIGITAL_OUTPUT_SEQUENCE_PARAMS];
+
+/**
+ * @def NUM_START_DIGITAL_OUTPUT_SEQUENCE_PARAMS
+ * @brief The number of parameters for the START_DIGITAL_OUTPUT_SEQUENCE command.
+ */
+#define NUM_START_DIGITAL_OUTPUT_SEQUENCE_PARAMS 4
+/* Prototype the START_DIGITAL_OUTPUT_SEQUENCE command params array */
+extern const char* START_DIGITAL_OUTPUT_SEQUENCE_PARAMS[NUM_START_DIGITAL_OUTPUT_SEQUENCE_PARAMS];
+
+/**
+ * @def NUM_BEGIN_BATCH_PARAMS
+ * @brief The number of parameters for the BEGIN_BATCH command.
+ */
+#define NUM_BEGIN_BATCH_PARAMS 0
+/* Prototype the BEGIN_BATCH command params array */
+extern const char* BEGIN_BATCH_PARAMS[NUM_BEGIN_BATCH_PARAMS];
+
+/**
+ * @def NUM_END_BATCH_PARAMS
+ * @brief The number of parameters for the END_BATCH command.
+ */
+#define NUM_END_BATCH_PARAMS 0
+/* Prototype the END_BATCH command params array */
+extern const char* END_BATCH_PARAMS[NUM_END_BATCH_PARAMS];
+
+/**
+ * @def NUM_SAVE_CONFIG_PARAMS
+ * @brief The number of parameters for the SAVE_CONFIG command.
+ */
+#define NUM_SAVE_CONFIG_PARAMS 0
+/* Prototype the SAVE_CONFIG command params array */
+extern const char* SAVE_CONFIG_PARAMS[NUM_SAVE_CONFIG_PARAMS];
+
+/**
+ * @def NUM_LOAD_CONFIG_PARAMS
+ * @brief The number of parameters for the LOAD_CONFIG command.
+ */
+#define NUM_LOAD_CONFIG_PARAMS 0
+/* Prototype the LOAD_CONFIG command params array */
+extern const char* LOAD_CONFIG_PARAMS[NUM_LOAD_CONFIG_PARAMS];
+
+/**
+ * @def NUM_SAVE_JOB_PARAMS
+ * @brief The number of parameters for the SAVE_JOB command.
+ */
+#define NUM_SAVE_JOB_PARAMS 6
+/* Prototype the SAVE_JOB command params array */
+extern const char* SAVE_JOB_PARAMS[NUM_SAVE_JOB_PARAMS];
+
+/**
+ * @def NUM_CLEAR_JOB_PARAMS
+ * @brief The number of parameters for the CLEAR_JOB command.
+ */
+#define NUM_CLEAR_JOB_PARAMS 0
+/* Prototype the CLEAR_JOB command params array */
+extern const char* CLEAR_JOB_PARAMS[NUM_CLEAR_JOB_PARAMS];
+
+/**
+ * @def NUM_GET_BOOT_TIMES_PARAMS
+ * @brief The number of parameters for the GET_BOOT_TIMES command.
+ */
+#define NUM_GET_BOOT_TIMES_PARAMS 0
+/* Prototype the GET_BOOT_TIMES command params array */
+extern const char* GET_BOOT_TIMES_PARAMS[NUM_GET_BOOT_TIMES_PARAMS];
+
+/**
+ * @def NUM_GET_NETWORK_STATS_PARAMS
+ * @brief The number of parameters for the GET_NETWORK_STATS command.
+ */
+#define NUM_GET_NETWORK_STATS_PARAMS 0
+/* Prototype the GET_NETWORK_STATS command params array */
+extern const char* GET_NETWORK_STATS_PARAMS[NUM_GET_NETWORK_STATS_PARAMS];
+
+/**
+ * @def NUM_SET_NO_DELAY_PARAMS
+ * @brief The number of parameters for the SET_NO_DELAY command.
+ */
+#define NUM_SET_NO_DELAY_PARAMS 2
+/* Prototype the SET_NO_DELAY command params array */
+extern const char* SET_NO_DELAY_PARAMS[NUM_SET_NO_DELAY_PARAMS];
+
+/**
+ * @def NUM_SET_SUBSCRIPTION_PARAMS
+ * @brief The number of parameters for the SET_SUBSCRIPTION command.
+ */
+#define NUM_SET_SUBSCRIPTION_PARAMS 1
+/* Prototype the SET_SUBSCRIPTION command params array */
+extern const char* SET_SUBSCRIPTION_PARAMS[NUM_SET_SUBSCRIPTION_PARAMS];
+
+/**
+ * @def NUM_SET_TIME_SERVER_PARAMS
+ * @brief The number of parameters for the SET_TIME_SERVER command.
+ */
+#define NUM_SET_TIME_SERVER_PARAMS 1
+/* Prototype the SET_TIME_SERVER command params array */
+extern const char* SET_TIME_SERVER_PARAMS[NUM_SET_TIME_SERVER_PARAMS];
+
+/**
+ * @def NUM_SET_CAN_SYNC_PARAMS
+ * @brief The number of parameters for the SET_CAN_SYNC command.
+ */
+#define NUM_SET_CAN_SYNC_PARAMS 1
+/* Prototype the SET_CAN_SYNC command params array */
+extern const char* SET_CAN_SYNC_PARAMS[NUM_SET_CAN_SYNC_PARAMS];
+
+/**
+ * @def NUM_SET_CAN_STREAM_PARAMS
+ * @brief The number of parameters for the SET_CAN_STREAM command.
+ */
+#define NUM_SET_CAN_STREAM_PARAMS 1
+/* Prototype the SET_CAN_STREAM command params array */
+extern const char* SET_CAN_STREAM_PARAMS[NUM_SET_CAN_STREAM_PARAMS];
+
+/**
+ * @def NUM_SET_ANALOG_INPUT_OVERSAMPLING_PARAMS
+ * @brief The number of parameters for the SET_ANALOG_INPUT_OVERSAMPLING command.
+ */
+#define NUM_SET_ANALOG_INPUT_OVERSAMPLING_PARAMS 2
+/* Prototype the SET_ANALOG_INPUT_OVERSAMPLING command params array */
+extern const char* SET_ANALOG_INPUT_OVERSAMPLING_PARAMS[NUM_SET_ANALOG_INPUT_OVERSAMPLING_PARAMS];
+
+/**
+ * @def NUM_GET_SCAN_TIME_PARAMS
+ * @brief The number of parameters for the GET_SCAN_TIME command.
+ */
+#define NUM_GET_SCAN_TIME_PARAMS 0
+/* Prototype the GET_SCAN_TIME command params array */
+extern const char* GET_SCAN_TIME_PARAMS[NUM_GET_SCAN_TIME_PARAMS];
+
+/**
+ * @def NUM_SET_BACKGROUND_CALIBRATION_PARAMS
+ * @brief The number of parameters for the SET_BACKGROUND_CALIBRATION command.
+ */
+#define NUM_SET_BACKGROUND_CALIBRATION_PARAMS 2
+/* Prototype the SET_BACKGROUND_CALIBRATION command params array */
+extern const char* SET_BACKGROUND_CALIBRATION_PARAMS[NUM_SET_BACKGROUND_CALIBRATION_PARAMS];
+
+/**
+ * @def NUM_SET_ANALOG_INPUT_THERMOCOUPLE_PARAMS
+ * @brief The number of parameters for the SET_ANALOG_INPUT_THERMOCOUPLE command.
+ */
+#define NUM_SET_ANALOG_INPUT_THERMOCOUPLE_PARAMS 2
+/* Prototype the SET_ANALOG_INPUT_THERMOCOUPLE command params array */
+extern const char* SET_ANALOG_INPUT_THERMOCOUPLE_PARAMS[NUM_SET_ANALOG_INPUT_THERMOCOUPLE_PARAMS];
+
+/**
+ * @def NUM_SET_ANALOG_INPUT_SETTLE_PARAMS
+ * @brief The number of parameters for the SET_ANALOG_INPUT_SETTLE command.
+ */
+#define NUM_SET_ANALOG_INPUT_SETTLE_PARAMS 2
+/* Prototype the SET_ANALOG_INPUT_SETTLE command params array */
+extern const char* SET_ANALOG_INPUT_SETTLE_PARAMS[NUM_SET_ANALOG_INPUT_SETTLE_PARAMS];
+
+/**
+ * @def NUM_SET_ANALOG_INPUT_PAIR_PARAMS
+ * @brief The number of parameters for the SET_ANALOG_INPUT_PAIR command.
+ */
+#define NUM_SET_ANALOG_INPUT_PAIR_PARAMS 3
+/* Prototype the SET_ANALOG_INPUT_PAIR command params array */
+extern const char* SET_ANALOG_INPUT_PAIR_PARAMS[NUM_SET_ANALOG_INPUT_PAIR_PARAMS];
+
+/**
+ * @def NUM_GET_TASK_STATS_PARAMS
+ * @brief The number of parameters for the GET_TASK_STATS command.
+ */
+#define NUM_GET_TASK_STATS_PARAMS 0
+/* Prototype the GET_TASK_STATS command params array */
+extern const char* GET_TASK_STATS_PARAMS[NUM_GET_TASK_STATS_PARAMS];
+
+/**
+ * @def NUM_GET_CRASH_RECORD_PARAMS
+ * @brief The number of parameters for the GET_CRASH_RECORD command.
+ */
+#define NUM_GET_CRASH_RECORD_PARAMS 0
+/* Prototype the GET_CRASH_RECORD command params array */
+extern const char* GET_CRASH_RECORD_PARAMS[NUM_GET_CRASH_RECORD_PARAMS];
+
+/**
+ * @def NUM_GET_UPGRADE_STATUS_PARAMS
+ * @brief The number of parameters for the GET_UPGRADE_STATUS command.
+ */
+#define NUM_GET_UPGRADE_STATUS_PARAMS 0
+/* Prototype the GET_UPGRADE_STATUS command params array */
+extern const char* GET_UPGRADE_STATUS_PARAMS[NUM_GET_UPGRADE_STATUS_PARAMS];
+
+/**
+ * @def NUM_APPLY_UPGRADE_PARAMS
+ * @brief The number of parameters for the APPLY_UPGRADE command.
+ */
+#define NUM_APPLY_UPGRADE_PARAMS 0
+/* Prototype the APPLY_UPGRADE command params array */
+extern const char* APPLY_UPGRADE_PARAMS[NUM_APPLY_UPGRADE_PARAMS];
+
+/**
+ * @def NUM_DISCARD_UPGRADE_PARAMS
+ * @brief The number of parameters for the DISCARD_UPGRADE command.
+ */
+#define NUM_DISCARD_UPGRADE_PARAMS 0
+/* Prototype the DISCARD_UPGRADE command params array */
+extern const char* DISCARD_UPGRADE_PARAMS[NUM_DISCARD_UPGRADE_PARAMS];
+
+/**
+ * @def NUM_STATS_PARAMS
+ * @brief The number of parameters for the STATS command.
+ */
+#define NUM_STATS_PARAMS 1
+/* Prototype the STATS command params array */
+extern const char* STATS_PARAMS[NUM_STATS_PARAMS];
+
+/**
+ * @def NUM_GET_MEMORY_USAGE_PARAMS
+ * @brief The number of parameters for the GET_MEMORY_USAGE command.
+ */
+#define NUM_GET_MEMORY_USAGE_PARAMS 0
+/* Prototype the GET_MEMORY_USAGE command params array */
+extern const char* GET_MEMORY_USAGE_PARAMS[NUM_GET_MEMORY_USAGE_PARAMS];
+
+/**
+ * @def NUM_SET_OUTPUT_BUDGET_PARAMS
+ * @brief The number of parameters for the SET_OUTPUT_BUDGET command.
+ */
+#define NUM_SET_OUTPUT_BUDGET_PARAMS 1
+/* Prototype the SET_OUTPUT_BUDGET command params array */
+extern const char* SET_OUTPUT_BUDGET_PARAMS[NUM_SET_OUTPUT_BUDGET_PARAMS];
+
+/**
+ * @def NUM_BEGIN_CONFIG_PARAMS
+ * @brief The number of parameters for the BEGIN_CONFIG command.
+ */
+#define NUM_BEGIN_CONFIG_PARAMS 0
+/* Prototype the BEGIN_CONFIG command params array */
+extern const char* BEGIN_CONFIG_PARAMS[NUM_BEGIN_CONFIG_PARAMS];
+
+/**
+ * @def NUM_COMMIT_CONFIG_PARAMS
+ * @brief The number of parameters for the COMMIT_CONFIG command.
+ */
+#define NUM_COMMIT_CONFIG_PARAMS 0
+/* Prototype the COMMIT_CONFIG command params array */
+extern const char* COMMIT_CONFIG_PARAMS[NUM_COMMIT_CONFIG_PARAMS];
+
+/**
+ * @def NUM_READ_LATEST_VALUES_PARAMS
+ * @brief The number of parameters for the READ_LATEST_VALUES command.
+ */
+#define NUM_READ_LATEST_VALUES_PARAMS 0
+/* Prototype the READ_LATEST_VALUES command params array */
+extern const char* READ_LATEST_VALUES_PARAMS[NUM_READ_LATEST_VALUES_PARAMS];
+
+/**
+ * @def NUM_SET_SAMPLE_LOG_PARAMS
+ * @brief The number of parameters for the SET_SAMPLE_LOG command.
+ */
+#define NUM_SET_SAMPLE_LOG_PARAMS 1
+/* Prototype the SET_SAMPLE_LOG command params array */
+extern const char* SET_SAMPLE_LOG_PARAMS[NUM_SET_SAMPLE_LOG_PARAMS];
+
+/**
+ * @def NUM_GET_SAMPLE_LOG_STATUS_PARAMS
+ * @brief The number of parameters for the GET_SAMPLE_LOG_STATUS command.
+ */
+#define NUM_GET_SAMPLE_LOG_STATUS_PARAMS 0
+/* Prototype the GET_SAMPLE_LOG_STATUS command params array */
+extern const char* GET_SAMPLE_LOG_STATUS_PARAMS[NUM_GET_SAMPLE_LOG_STATUS_PARAMS];
+
+/**
+ * @def NUM_RESUME_SAMPLE_LOG_PARAMS
+ * @brief The number of parameters for the RESUME_SAMPLE_LOG command.
+ */
+#define NUM_RESUME_SAMPLE_LOG_PARAMS 1
+/* Prototype the RESUME_SAMPLE_LOG command params array */
+extern const char* RESUME_SAMPLE_LOG_PARAMS[NUM_RESUME_SAMPLE_LOG_PARAMS];
+
+/**
+ * @def NUM_BURST_CAPTURE_PARAMS
+ * @brief The number of parameters for the BURST_CAPTURE command.
+ */
+#define NUM_BURST_CAPTURE_PARAMS 2
+/* Prototype the BURST_CAPTURE command params array */
+extern const char* BURST_CAPTURE_PARAMS[NUM_BURST_CAPTURE_PARAMS];
+
+/**
+ * @def NUM_READ_BURST_CAPTURE_PARAMS
+ * @brief The number of parameters for the READ_BURST_CAPTURE command.
+ */
+#define NUM_READ_BURST_CAPTURE_PARAMS 0
+/* Prototype the READ_BURST_CAPTURE command params array */
+extern const char* READ_BURST_CAPTURE_PARAMS[NUM_READ_BURST_CAPTURE_PARAMS];
+
+/**
+ * @def NUM_READ_BURST_SPECTRUM_PARAMS
+ * @brief The number of parameters for the READ_BURST_SPECTRUM command.
+ */
+#define NUM_READ_BURST_SPECTRUM_PARAMS 2
+/* Prototype the READ_BURST_SPECTRUM command params array */
+extern const char* READ_BURST_SPECTRUM_PARAMS[NUM_READ_BURST_SPECTRUM_PARAMS];
+
+/**
+ * @def NUM_SET_ANALOG_POWER_PARAMS
+ * @brief The number of parameters for the SET_ANALOG_POWER command.
+ */
+#define NUM_SET_ANALOG_POWER_PARAMS 4
+/* Prototype the SET_ANALOG_POWER command params array */
+extern const char* SET_ANALOG_POWER_PARAMS[NUM_SET_ANALOG_POWER_PARAMS];
+
+/**
+ * @def NUM_SET_INTERLOCK_PARAMS
+ * @brief The number of parameters for the SET_INTERLOCK command.
+ */
+#define NUM_SET_INTERLOCK_PARAMS 9
+/* Prototype the SET_INTERLOCK command params array */
+extern const char* SET_INTERLOCK_PARAMS[NUM_SET_INTERLOCK_PARAMS];
+
+/**
+ * @def NUM_RESET_INTERLOCKS_PARAMS
+ * @brief The number of parameters for the RESET_INTERLOCKS command.
+ */
+#define NUM_RESET_INTERLOCKS_PARAMS 0
+/* Prototype the RESET_INTERLOCKS command params array */
+extern const char* RESET_INTERLOCKS_PARAMS[NUM_RESET_INTERLOCKS_PARAMS];
+
+/**
+ * @def NUM_LIST_INTERLOCKS_PARAMS
+ * @brief The number of parameters for the LIST_INTERLOCKS command.
+ */
+#define NUM_LIST_INTERLOCKS_PARAMS 0
+/* Prototype the LIST_INTERLOCKS command params array */
+extern const char* LIST_INTERLOCKS_PARAMS[NUM_LIST_INTERLOCKS_PARAMS];
+
+/**
+ * @def NUM_SET_PID_PARAMS
+ * @brief The number of parameters for the SET_PID command.
+ */
+#define NUM_SET_PID_PARAMS 8
+/* Prototype the SET_PID command params array */
+extern const char* SET_PID_PARAMS[NUM_SET_PID_PARAMS];
+
+/**
+ * @def NUM_LIST_PID_LOOPS_PARAMS
+ * @brief The number of parameters for the LIST_PID_LOOPS command.
+ */
+#define NUM_LIST_PID_LOOPS_PARAMS 0
+/* Prototype the LIST_PID_LOOPS command params array */
+extern const char* LIST_PID_LOOPS_PARAMS[NUM_LIST_PID_LOOPS_PARAMS];
+
+/**
+ * @def NUM_SET_MATH_CHANNEL_PARAMS
+ * @brief The number of parameters for the SET_MATH_CHANNEL command.
+ */
+#define NUM_SET_MATH_CHANNEL_PARAMS 3
+/* Prototype the SET_MATH_CHANNEL command params array */
+extern const char* SET_MATH_CHANNEL_PARAMS[NUM_SET_MATH_CHANNEL_PARAMS];
+
+/**
+ * @def NUM_LIST_MATH_CHANNELS_PARAMS
+ * @brief The number of parameters for the LIST_MATH_CHANNELS command.
+ */
+#define NUM_LIST_MATH_CHANNELS_PARAMS 0
+/* Prototype the LIST_MATH_CHANNELS command params array */
+extern const char* LIST_MATH_CHANNELS_PARAMS[NUM_LIST_MATH_CHANNELS_PARAMS];
+
+/**
+ * @def NUM_SET_ANALOG_INPUT_AUTO_RANGE_PARAMS
+ * @brief The number of parameters for the SET_ANALOG_INPUT_AUTO_RANGE command.
+ */
+#define NUM_SET_ANALOG_INPUT_AUTO_RANGE_PARAMS 3
+/* Prototype the SET_ANALOG_INPUT_AUTO_RANGE command params array */
+extern const char* SET_ANALOG_INPUT_AUTO_RANGE_PARAMS[NUM_SET_ANALOG_INPUT_AUTO_RANGE_PARAMS];
+
+/**
+ * @def NUM_SET_SENSOR_CHECK_PARAMS
+ * @brief The number of parameters for the SET_SENSOR_CHECK command.
+ */
+#define NUM_SET_SENSOR_CHECK_PARAMS 2
+/* Prototype the SET_SENSOR_CHECK command params array */
+extern const char* SET_SENSOR_CHECK_PARAMS[NUM_SET_SENSOR_CHECK_PARAMS];
+
+/**
+ * @def NUM_GET_SENSOR_CHECK_PARAMS
+ * @brief The number of parameters for the GET_SENSOR_CHECK command.
+ */
+#define NUM_GET_SENSOR_CHECK_PARAMS 0
+/* Prototype the GET_SENSOR_CHECK command params array */
+extern const char* GET_SENSOR_CHECK_PARAMS[NUM_GET_SENSOR_CHECK_PARAMS];
+
+/**
+ * @def NUM_SET_DIGITAL_INPUT_ENCODER_PARAMS
+ * @brief The number of parameters for the SET_DIGITAL_INPUT_ENCODER command.
+ */
+#define NUM_SET_DIGITAL_INPUT_ENCODER_PARAMS 2
+/* Prototype the SET_DIGITAL_INPUT_ENCODER command params array */
+extern const char* SET_DIGITAL_INPUT_ENCODER_PARAMS[NUM_SET_DIGITAL_INPUT_ENCODER_PARAMS];
+
+/**
+ * @def NUM_SET_DIGITAL_INPUT_LATCH_PARAMS
+ * @brief The number of parameters for the SET_DIGITAL_INPUT_LATCH command.
+ */
+#define NUM_SET_DIGITAL_INPUT_LATCH_PARAMS 1
+/* Prototype the SET_DIGITAL_INPUT_LATCH command params array */
+extern const char* SET_DIGITAL_INPUT_LATCH_PARAMS[NUM_SET_DIGITAL_INPUT_LATCH_PARAMS];
+
+/**
+ * @def NUM_SET_MIXED_SIGNAL_PARAMS
+ * @brief The number of parameters for the SET_MIXED_SIGNAL command.
+ */
+#define NUM_SET_MIXED_SIGNAL_PARAMS 1
+/* Prototype the SET_MIXED_SIGNAL command params array */
+extern const char* SET_MIXED_SIGNAL_PARAMS[NUM_SET_MIXED_SIGNAL_PARAMS];
+
+/**
+ * @def NUM_SET_LOG_LEVEL_PARAMS
+ * @brief The number of parameters for the SET_LOG_LEVEL command.
+ */
+#define NUM_SET_LOG_LEVEL_PARAMS 1
+/* Prototype the SET_LOG_LEVEL command params array */
+extern const char* SET_LOG_LEVEL_PARAMS[NUM_SET_LOG_LEVEL_PARAMS];
+
+/**
+ * @def NUM_READ_STATE_TRACE_PARAMS
+ * @brief The number of parameters for the READ_STATE_TRACE command.
+ */
+#define NUM_READ_STATE_TRACE_PARAMS 0
+/* Prototype the READ_STATE_TRACE command params array */
+extern const char* READ_STATE_TRACE_PARAMS[NUM_READ_STATE_TRACE_PARAMS];
+
+/**
+ * @def NUM_SET_KEEPALIVE_PARAMS
+ * @brief The number of parameters for the SET_KEEPALIVE command.
+ */
+#define NUM_SET_KEEPALIVE_PARAMS 4
+/* Prototype the SET_KEEPALIVE command params array */
+extern const char* SET_KEEPALIVE_PARAMS[NUM_SET_KEEPALIVE_PARAMS];
+
+/**
+ * @def NUM_FORMAT_PARAMS
+ * @brief The number of parameters for the FORMAT command.
+ */
+#define NUM_FORMAT_PARAMS 2
+/* Prototype the FORMAT command params array */
+extern const char* FORMAT_PARAMS[NUM_FORMAT_PARAMS];
+
+/**
+ * @def NUM_SET_AUX_ANALOG_PARAMS
+ * @brief The number of parameters for the SET_AUX_ANALOG command.
+ */
+#define NUM_SET_AUX_ANALOG_PARAMS 1
+/* Prototype the SET_AUX_ANALOG command params array */
+extern const char* SET_AUX_ANALOG_PARAMS[NUM_SET_AUX_ANALOG_PARAMS];
+
+/**
+ * @def NUM_BEGIN_MACRO_PARAMS
+ * @brief The number of parameters for the BEGIN_MACRO command.
+ */
+#define NUM_BEGIN_MACRO_PARAMS 1
+/* Prototype the BEGIN_MACRO command params array */
+extern const char* BEGIN_MACRO_PARAMS[NUM_BEGIN_MACRO_PARAMS];
+
+/**
+ * @def NUM_END_MACRO_PARAMS
+ * @brief The number of parameters for the END_MACRO command.
+ */
+#define NUM_END_MACRO_PARAMS 0
+/* Prototype the END_MACRO command params array */
+extern const char* END_MACRO_PARAMS[NUM_END_MACRO_PARAMS];
+
+/**
+ * @def NUM_RUN_MACRO_PARAMS
+ * @brief The number of parameters for the RUN_MACRO command.
+ */
+#define NUM_RUN_MACRO_PARAMS 1
+/* Prototype the RUN_MACRO command params array */
+extern const char* RUN_MACRO_PARAMS[NUM_RUN_MACRO_PARAMS];
+
+/**
+ * @def NUM_DELETE_MACRO_PARAMS
+ * @brief The number of parameters for the DELETE_MACRO command.
+ */
+#define NUM_DELETE_MACRO_PARAMS 1
+/* Prototype the DELETE_MACRO command params array */
+extern const char* DELETE_MACRO_PARAMS[NUM_DELETE_MACRO_PARAMS];
+
+/**
+ * @def NUM_LIST_MACROS_PARAMS
+ * @brief The number of parameters for the LIST_MACROS command.
+ */
+#define NUM_LIST_MACROS_PARAMS 1
+/* Prototype the LIST_MACROS command params array */
+extern const char* LIST_MACROS_PARAMS[NUM_LIST_MACROS_PARAMS];
+
 /**
  * @def NUM_NONE_PARAMS
  * @brief The number of parameters for the NONE command.
@@ -408,16 +1530,41 @@ extern const char* NONE_PARAMS[NUM_NONE_PARAMS];
  */
 void CreateCommandInterpreter(void);
 
+/**
+ * @brief Starts sampling with the saved sampling job, if there is one.
+ */
+bool StartSavedSamplingJob(void);
+
+/**
+ * @brief Acts on a start or stop event received from the CAN master.
+ */
+void HandleSyncEvent(CAN_SyncEvent_t event, uint32_t argument);
+
 /**
  * @brief Adds a character to the command parser's buffer.
  */
 void Command_AddChar(const char character);
 
+/**
+ * @brief Adds a span of characters to the command parser's buffer, parsing every line it completes.
+ */
+void Command_AddChars(const char* data, uint16_t length);
+
 /**
  * @brief Clears the entire contents of the command parser's buffer.
  */
 void ClearCommandBuffer(void);
 
+/**
+ * @brief Determines if the command parser is between commands.
+ */
+bool Command_IsIdle(void);
+
+/**
+ * @brief Discards any partial command held by the command parser.
+ */
+void Command_DiscardInput(void);
+
 /**
  * @brief Gets the index of the specified argument from the list of parameters.
  */
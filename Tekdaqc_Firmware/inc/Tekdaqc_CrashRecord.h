@@ -0,0 +1,194 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_CrashRecord.h
+ * @brief Header file for the Tekdaqc's reset cause and crash record.
+ *
+ * Contains public definitions and data types for recording why the board reset, along with the fault registers and
+ * the state of the firmware when it crashed, in backup SRAM where they survive the reset.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_CRASHRECORD_H_
+#define TEKDAQC_CRASHRECORD_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+#include "boolean.h"
+
+/** @addtogroup tekdaqc_firmware Tekdaqc Firmware
+ * @{
+ */
+
+/** @addtogroup tekdaqc_crash_record Crash Record
+  * @{
+  */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def CRASH_SAMPLING_ADC
+ * @brief Bit of the sampling field of a crash record set when the ADC was sampling.
+ */
+#define CRASH_SAMPLING_ADC	0x01U
+
+/**
+ * @def CRASH_SAMPLING_DI
+ * @brief Bit of the sampling field of a crash record set when the digital inputs were sampling.
+ */
+#define CRASH_SAMPLING_DI	0x02U
+
+/**
+ * @def CRASH_SAMPLING_DO
+ * @brief Bit of the sampling field of a crash record set when the digital outputs were sampling.
+ */
+#define CRASH_SAMPLING_DO	0x04U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Reset cause enumeration.
+ * Defines the causes of the last reset, as reported by the reset flags.
+ */
+typedef enum {
+	RESET_CAUSE_POWER_ON, /**< The board was powered on. */
+	RESET_CAUSE_BROWN_OUT, /**< The supply dropped below the brown out threshold. */
+	RESET_CAUSE_PIN, /**< The reset pin was asserted. */
+	RESET_CAUSE_SOFTWARE, /**< The firmware reset the board, including after recording a fault. */
+	RESET_CAUSE_WATCHDOG, /**< The independent watchdog expired. */
+	RESET_CAUSE_WINDOW_WATCHDOG, /**< The window watchdog expired. */
+	RESET_CAUSE_LOW_POWER, /**< A low power mode was entered illegally. */
+	NUM_RESET_CAUSES /**<@internal The number of reset causes. */
+} ResetCause_t;
+
+/**
+ * @brief Crash cause enumeration.
+ * Defines what ended the run before the last reset.
+ */
+typedef enum {
+	CRASH_NONE, /**< The run ended normally. */
+	CRASH_HARD_FAULT, /**< A hard fault, including any escalated configurable fault. */
+	CRASH_MEM_MANAGE, /**< A memory management fault. */
+	CRASH_BUS_FAULT, /**< A bus fault. */
+	CRASH_USAGE_FAULT, /**< A usage fault. */
+	CRASH_WATCHDOG, /**< The independent watchdog expired. The fault registers are not valid. */
+	NUM_CRASH_CAUSES /**<@internal The number of crash causes. */
+} CrashCause_t;
+
+/**
+ * @brief Data structure holding a crash record. The fault registers are captured by the fault handlers and the
+ * state of the firmware by the periodic snapshot, so the context is the last one taken before the crash.
+ */
+typedef struct {
+	uint32_t magic; /**<@internal Marks the record as valid. */
+	uint32_t cause; /**< The CrashCause_t of the crash. */
+	uint32_t pc; /**< The program counter of the faulting code. */
+	uint32_t lr; /**< The link register of the faulting code. */
+	uint32_t psr; /**< The program status register of the faulting code. */
+	uint32_t cfsr; /**< The configurable fault status register. */
+	uint32_t hfsr; /**< The hard fault status register. */
+	uint32_t bfar; /**< The bus fault address register. */
+	uint32_t mmfar; /**< The memory management fault address register. */
+	uint64_t crashTime; /**< The local time of the crash, 0 for a watchdog reset. */
+	uint64_t snapshotTime; /**< The local time the context was taken. */
+	uint32_t adcState; /**< The ADC_State_t of the ADC state machine. */
+	uint32_t sampling; /**< The CRASH_SAMPLING_ bits of the state machines which were sampling. */
+	uint32_t bufferedSamples; /**< The analog samples waiting to be written. */
+	uint32_t adcOverruns; /**< The analog samples dropped since start up. */
+	uint32_t telnetBuffered; /**< The bytes waiting in the Telnet transmit buffer. */
+	uint32_t longestLoop; /**< The longest pass of the program loop (us). */
+} CrashRecord_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Picks up the cause of the last reset and any crash record left before it.
+ */
+void CrashRecord_Init(void);
+
+/**
+ * @brief Takes a snapshot of the state of the firmware into the crash record.
+ */
+void CrashRecord_Snapshot(void);
+
+/**
+ * @brief Records a hard fault and resets the board.
+ */
+void CrashRecord_HardFault(const uint32_t* frame);
+
+/**
+ * @brief Records a memory management fault and resets the board.
+ */
+void CrashRecord_MemManage(const uint32_t* frame);
+
+/**
+ * @brief Records a bus fault and resets the board.
+ */
+void CrashRecord_BusFault(const uint32_t* frame);
+
+/**
+ * @brief Records a usage fault and resets the board.
+ */
+void CrashRecord_UsageFault(const uint32_t* frame);
+
+/**
+ * @brief Retrieves the cause of the last reset.
+ */
+ResetCause_t CrashRecord_GetResetCause(void);
+
+/**
+ * @brief Retrieves the crash record left before the last reset.
+ */
+const CrashRecord_t* CrashRecord_GetLast(void);
+
+/**
+ * @brief Return the human readable string representation of the provided reset cause.
+ */
+const char* CrashRecord_StringFromResetCause(ResetCause_t cause);
+
+/**
+ * @brief Return the human readable string representation of the provided crash cause.
+ */
+const char* CrashRecord_StringFromCrashCause(CrashCause_t cause);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_CRASHRECORD_H_ */
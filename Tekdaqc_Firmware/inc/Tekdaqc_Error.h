@@ -34,6 +34,8 @@ extern "C" {
 /* INCLUDES */
 /*--------------------------------------------------------------------------------------------------------*/
 
+#include <stdint.h>
+
 /** @addtogroup tekdaqc_firmware Tekdaqc Firmware
  * @{
  */
@@ -46,6 +48,12 @@ extern "C" {
 /* EXPORTED CONSTANTS */
 /*--------------------------------------------------------------------------------------------------------*/
 
+/**
+ * @def STATUS_EVENT_DOUT_FAULT
+ * @brief Status event bit signaled when a digital output enters a fault state.
+ */
+#define STATUS_EVENT_DOUT_FAULT		((uint32_t) 0x00000001)
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* EXPORTED TYPES */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -93,7 +101,17 @@ typedef enum {
 	ERR_DOUT_OUTPUT_UNSPECIFIED	=	19U, /**< The function failed due to an unspecified digital output. */
 	ERR_DOUT_OUTPUT_EXISTS		=	20U, /**< The function failed because the specified digital output already exists. */
 	ERR_DOUT_DOES_NOT_EXIST		= 	21U, /**< The function failed because the specified digital output does not exist. */
-	ERR_DOUT_FAILED_WRITE		=	22U /**< The function failed due to a failure to write digital output data to a string buffer. */
+	ERR_DOUT_FAILED_WRITE		=	22U, /**< The function failed due to a failure to write digital output data to a string buffer. */
+	ERR_DOUT_SEQUENCE_FULL		=	23U, /**< The function failed because the digital output sequence table is full. */
+	ERR_DOUT_SEQUENCE_INVALID	=	24U, /**< The function failed because the digital output sequence is empty or out of order. */
+	ERR_DOUT_SEQUENCE_RUNNING	=	25U, /**< The function failed because the digital output sequence is playing. */
+	ERR_CONFIG_NOT_SAVED		=	26U, /**< The function failed because no channel configuration has been saved. */
+	ERR_CONFIG_WRITE_FAILED		=	27U, /**< The function failed because the channel configuration could not be written. */
+	ERR_JOB_NOT_SAVED			=	28U, /**< The function failed because no sampling job has been saved. */
+	ERR_UPGRADE_NOT_STAGED		=	29U, /**< The function failed because no firmware upgrade has been staged. */
+	ERR_MACRO_NOT_SAVED			=	30U, /**< The function failed because no macro of the given name has been saved. */
+	ERR_MACRO_TABLE_FULL		=	31U, /**< The function failed because every macro slot is in use. */
+	ERR_MACRO_TOO_LONG			=	32U /**< The function failed because the recorded macro does not fit its slot. */
 } Tekdaqc_Function_Error_t;
 
 /*--------------------------------------------------------------------------------------------------------*/
@@ -105,6 +123,11 @@ typedef enum {
  */
 void Tekdaqc_CheckStatus(void);
 
+/**
+ * @brief Signals status events to be reported by the next status check.
+ */
+void Tekdaqc_SignalStatusEvent(uint32_t events);
+
 /**
  * @brief Converts a Tekdaqc_Command_Error_t into a human readable string.
  */
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_MemoryUsage.h
+ * @brief Header file for the Tekdaqc's memory usage report.
+ *
+ * Contains public definitions for measuring how the RAM is spent: the sizes of the statically allocated sections,
+ * taken from the symbols placed by the linker script, the size of the heap and the deepest the stack has reached,
+ * found by painting the free stack at start up.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_MEMORY_USAGE_H_
+#define TEKDAQC_MEMORY_USAGE_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+
+/** @addtogroup tekdaqc_firmware Tekdaqc Firmware
+ * @{
+ */
+
+/** @addtogroup tekdaqc_memory_usage Memory Usage
+  * @{
+  */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def MEMORY_USAGE_STACK_PAINT
+ * @brief The word the free stack is painted with at start up. A word still holding it has never been used.
+ */
+#define MEMORY_USAGE_STACK_PAINT 0xCDCDCDCDU
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Data structure holding the sizes in bytes of the memory in use.
+ */
+typedef struct {
+	uint32_t flash; /**< The code, constants and initial values of the initialized data held in flash. */
+	uint32_t data; /**< The initialized data in SRAM1. */
+	uint32_t bss; /**< The zero initialized data in SRAM1. */
+	uint32_t ccm; /**< The initialized and zero initialized data in the CCM-RAM. */
+	uint32_t sram2; /**< The Ethernet DMA descriptors and buffers in SRAM2. */
+	uint32_t heap; /**< The heap given out so far by the C library. */
+	uint32_t stackPeak; /**< The deepest the stack has reached since start up. */
+	uint32_t stackSize; /**< The SRAM1 left between the heap and the top of the stack. */
+} MemoryUsage_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Paints the unused stack so its deepest use can be found later. Called first thing in main().
+ */
+void MemoryUsage_PaintStack(void);
+
+/**
+ * @brief Retrieves the sizes of the memory in use.
+ */
+void MemoryUsage_Get(MemoryUsage_t* usage);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_MEMORY_USAGE_H_ */
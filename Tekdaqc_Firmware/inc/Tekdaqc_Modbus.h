@@ -0,0 +1,93 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Modbus.h
+ * @brief Header file for the Tekdaqc's Modbus register map.
+ *
+ * Contains public definitions for the map of the Tekdaqc's inputs and outputs onto Modbus coils, discrete inputs
+ * and registers.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_MODBUS_H_
+#define TEKDAQC_MODBUS_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+#include "ModbusServer.h"
+
+/** @addtogroup tekdaqc_firmware Tekdaqc Firmware
+ * @{
+ */
+
+/** @addtogroup tekdaqc_modbus Modbus Register Map
+  * @{
+  */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def MODBUS_REGISTERS_PER_INPUT
+ * @brief The number of registers for each analog input, which starts at its input number times this. The registers
+ * are the high and low words of the latest value, its flags and its age in milliseconds.
+ */
+#define MODBUS_REGISTERS_PER_INPUT	4U
+
+/**
+ * @def MODBUS_NOT_MEASURED
+ * @brief Set in the flags register of an analog input which is not added or has not been measured yet.
+ */
+#define MODBUS_NOT_MEASURED			0x8000U
+
+/**
+ * @def MODBUS_MAX_AGE
+ * @brief The age register value of a sample which is this many milliseconds old or older.
+ */
+#define MODBUS_MAX_AGE				0xFFFFU
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Starts the Modbus server serving the Tekdaqc's inputs and outputs.
+ */
+ModbusServerStatus_t Tekdaqc_ModbusInit(void);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_MODBUS_H_ */
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_SampleRoute.h
+ * @brief Header file for the route sample data takes from the input writers to its transports.
+ *
+ * Contains public definitions and data types for the sample route. The analog, digital input and digital output
+ * writers encode their records once and hand them to the route, which passes them to the first active transport of
+ * its table, to the sample log while there is no destination, and to every tap watching the stream. A transport, log
+ * or tap is added as an entry of its table in Tekdaqc_SampleRoute.c, without touching the writers or the other
+ * entries, and costs the writes nothing while it is inactive beyond checking it.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_SAMPLE_ROUTE_H_
+#define TEKDAQC_SAMPLE_ROUTE_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Config.h"
+#include "stm32f4xx.h"
+#include <boolean.h>
+
+/** @addtogroup tekdaqc_firmware Tekdaqc Firmware
+ * @{
+ */
+
+/** @addtogroup tekdaqc_sample_route Sample Route
+  * @{
+  */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief A transport sample data can be sent over.
+ */
+typedef struct {
+	bool (*IsActive)(void); /**< Indicates if the transport is a destination for sample data. */
+	WriteFunction WriteString; /**< Sends a sample data string. */
+	BinaryWriteFunction WriteBinary; /**< Sends a block of binary sample data. */
+} SampleTransport_t;
+
+/**
+ * @brief An observer shown every write the route has taken, whichever transport it went to.
+ */
+typedef struct {
+	void (*WriteString)(const char* string); /**< Shows a sample data string. */
+	void (*WriteBinary)(const uint8_t* data, uint16_t length); /**< Shows a block of binary sample data. */
+} SampleTap_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Sets whether sample data is held back while there is no destination at all.
+ */
+void SampleRoute_SetHold(bool hold);
+
+/**
+ * @brief Indicates if sample data has somewhere to go.
+ */
+bool SampleRoute_HasDestination(void);
+
+/**
+ * @brief Writes a sample data string to the sample log or a transport.
+ */
+WriteStatus_t SampleRoute_WriteString(char* string);
+
+/**
+ * @brief Writes a block of binary sample data to the sample log or a transport.
+ */
+WriteStatus_t SampleRoute_WriteBinary(const uint8_t* data, uint16_t length);
+
+/**
+ * @brief Sends a sample data string over a transport, bypassing the sample log.
+ */
+WriteStatus_t SampleRoute_SendString(char* string);
+
+/**
+ * @brief Sends a block of binary sample data over a transport, bypassing the sample log.
+ */
+WriteStatus_t SampleRoute_SendBinary(const uint8_t* data, uint16_t length);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_SAMPLE_ROUTE_H_ */
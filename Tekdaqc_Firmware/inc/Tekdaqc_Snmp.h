@@ -0,0 +1,126 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Snmp.h
+ * @brief Header file for the Tekdaqc's private SNMP MIB.
+ *
+ * Contains public definitions for the private MIB of acquisition performance counters served by the SNMP agent,
+ * which is built when SNMP_AGENT is defined, see lwipopts.h. Every object is a read only scalar under
+ * enterprises.TEKDAQC_SNMP_ENTERPRISE_ID.TEKDAQC_SNMP_PERFORMANCE_GROUP:
+ *
+ * Object      Type         Description
+ * --------    ---------    -----------------------------------------------------------
+ * 1           Counter32    ADC conversions read
+ * 2           Counter32    Samples produced, all physical analog inputs
+ * 3           Gauge32      Achieved sample rate, samples per second
+ * 4           Counter32    Analog samples dropped for a full sample buffer
+ * 5           Gauge32      Analog samples waiting in the sample buffer
+ * 6           Gauge32      Bytes waiting in the Telnet buffer
+ * 7           Gauge32      Peak fill of the Telnet buffer in bytes
+ * 8           Gauge32      Size of the Telnet buffer in bytes
+ * 9           Gauge32      Main loop passes per second
+ * 10          Gauge32      Main loop load, the time not spent asleep, per mille
+ * 11          Integer32    Board temperature in thousandths of a degree Celsius
+ * 12          Integer32    Ethernet link state, 1 up or 2 down
+ * 13          Counter32    Times the Ethernet link has gone down
+ * 14          Gauge32      Time from the link last coming up to samples flowing, microseconds
+ * 15          Counter32    Frames dropped for a full receive FIFO or no receive descriptor
+ * 16          Counter32    Frames dropped for no free pool buffer
+ * 17          Counter32    Frames dropped for no free transmit descriptor
+ * 18          Counter32    Bytes sent over Telnet
+ * 19          Counter32    Bytes sent over the data connection
+ * 20          Counter32    Bytes published
+ * 21          Counter32    Bytes streamed in raw Ethernet frames
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_SNMP_H_
+#define TEKDAQC_SNMP_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+
+/** @addtogroup tekdaqc_firmware Tekdaqc Firmware
+ * @{
+ */
+
+/** @addtogroup tekdaqc_snmp SNMP Private MIB
+  * @{
+  */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def TEKDAQC_SNMP_ENTERPRISE_ID
+ * @brief The private enterprise number the MIB is served under, .1.3.6.1.4.1 followed by this. The default is the
+ * number IANA reserves for documentation, to be replaced by the build with the number assigned to the vendor.
+ */
+#ifndef TEKDAQC_SNMP_ENTERPRISE_ID
+#define TEKDAQC_SNMP_ENTERPRISE_ID	32473
+#endif
+
+/**
+ * @def TEKDAQC_SNMP_PERFORMANCE_GROUP
+ * @brief The sub-identifier of the group of performance counters under the enterprise.
+ */
+#define TEKDAQC_SNMP_PERFORMANCE_GROUP	1
+
+/**
+ * @def TEKDAQC_SNMP_OBJECT_COUNT
+ * @brief The number of objects in the group of performance counters, numbered from 1.
+ */
+#define TEKDAQC_SNMP_OBJECT_COUNT	21U
+
+/**
+ * @def TEKDAQC_SNMP_RATE_WINDOW_US
+ * @brief The shortest time in microseconds the rates are found over. Rates read sooner after the previous window
+ * closed are those of the previous window, so a manager polling fast costs no more than one polling slowly.
+ */
+#define TEKDAQC_SNMP_RATE_WINDOW_US	((uint32_t) 1000000U)
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Sets the SNMP agent's system description and object ID to those of the Tekdaqc.
+ */
+void Tekdaqc_SnmpInit(void);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_SNMP_H_ */
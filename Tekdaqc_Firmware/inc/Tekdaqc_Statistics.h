@@ -0,0 +1,91 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Statistics.h
+ * @brief Header file for the Tekdaqc's runtime performance statistics.
+ *
+ * Contains public definitions for reporting how hard the board is working: the sample rates achieved by the analog
+ * inputs, the rates of data sent, the fill of the Telnet buffer and the rate and idle time of the program loop.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_STATISTICS_H_
+#define TEKDAQC_STATISTICS_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+#include "boolean.h"
+
+/** @addtogroup tekdaqc_firmware Tekdaqc Firmware
+ * @{
+ */
+
+/** @addtogroup tekdaqc_statistics Runtime Statistics
+  * @{
+  */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def STATISTICS_MIN_PERIOD_US
+ * @brief The shortest time in microseconds between periodic reports, which keeps the reports from crowding out the
+ * rest of the Telnet output.
+ */
+#define STATISTICS_MIN_PERIOD_US 100000U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Writes a report of the statistics over the time since the previous report.
+ */
+void Statistics_Report(void);
+
+/**
+ * @brief Sets the time between periodic reports.
+ */
+void Statistics_SetPeriod(uint32_t period);
+
+/**
+ * @brief Called from the program loop to write a periodic report once it is due.
+ */
+void Statistics_Service(void);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_STATISTICS_H_ */
@@ -37,6 +37,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "stm32f4xx.h"
+#include "Tekdaqc_BSP.h"
 
 /* Exported types ------------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
@@ -52,9 +53,19 @@ void SVC_Handler(void);
 void DebugMon_Handler(void);
 void PendSV_Handler(void);
 void SysTick_Handler(void);
-void EXTI15_10_IRQHandler(void);
+void EXTI0_IRQHandler(void);
+void EXTI1_IRQHandler(void);
+void EXTI2_IRQHandler(void);
+void EXTI3_IRQHandler(void);
+void EXTI4_IRQHandler(void);
+void EXTI9_5_IRQHandler(void);
+void EXTI15_10_IRQHandler(void) RAM_FUNCTION;
+void TIM2_IRQHandler(void);
 void TIM5_IRQHandler(void);
+void TIM7_IRQHandler(void);
 void CAN1_RX0_IRQHandler(void);
+void DMA1_Stream3_IRQHandler(void) RAM_FUNCTION;
+void RelocateVectorTable(void);
 
 #ifdef __cplusplus
 }
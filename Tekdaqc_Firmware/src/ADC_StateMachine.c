@@ -29,26 +29,90 @@
 #include "Tekdaqc_Debug.h"
 #include "ADC_StateMachine.h"
 #include "AnalogInput_Multiplexer.h"
+#include "AnalogInput_Trigger.h"
+#include "AnalogInput_Spectrum.h"
 #include "CommandState.h"
 #include "BoardTemperature.h"
+#include "Digital_Output.h"
+#include "DigitalOutput_Interlock.h"
+#include "DigitalOutput_PID.h"
 #include "Tekdaqc_Calibration.h"
 #include "Tekdaqc_CalibrationTable.h"
 #include "ADS1256_Driver.h"
 #include "Tekdaqc_Config.h"
 #include "Tekdaqc_Timers.h"
+#include "Tekdaqc_Profile.h"
+#include "Tekdaqc_StateTrace.h"
+#include "Tekdaqc_TimingHistogram.h"
 #include "TelnetServer.h"
 #include "boolean.h"
 #include <inttypes.h>
 #include <stdio.h>
+#include <string.h>
 
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE DEFINES */
 /*--------------------------------------------------------------------------------------------------------*/
 
+/**
+ * @internal
+ * @def COLD_JUNCTION_DEFAULT_INTERVAL_US
+ * @brief The default time in microseconds between cold junction samples taken while switching external inputs.
+ */
+#define COLD_JUNCTION_DEFAULT_INTERVAL_US	((uint32_t) 1000000U)
+
+/**
+ * @internal
+ * @def OVERRUN_REPORT_INTERVAL_US
+ * @brief The shortest time in microseconds between the status messages summarizing dropped samples.
+ */
+#define OVERRUN_REPORT_INTERVAL_US			((uint64_t) 1000000U)
+
+/**
+ * @internal
+ * @def OVERFLOW_HEADROOM
+ * @brief The number of free samples the drop oldest policy keeps in each buffer, and that the pause policy waits for
+ * before resuming a single channel run. Two blocks, so a new block can always be started.
+ */
+#define OVERFLOW_HEADROOM					(2U * ANALOG_SAMPLE_BLOCK_SIZE)
+
+/**
+ * @internal
+ * @def BURST_CAPTURE_FRAMES_PER_SERVICE
+ * @brief The most capture records a single service of the idle state sends while downloading a burst capture.
+ */
+#define BURST_CAPTURE_FRAMES_PER_SERVICE	4U
+
+/**
+ * @internal
+ * @def DRAIN_LOOP_SHARE
+ * @brief How many times as long as the rest of the main loop took a drain of the sample buffers may take, so the rest
+ * of the loop keeps at least a 1 / (DRAIN_LOOP_SHARE + 1) share of the time however much data is waiting.
+ */
+#define DRAIN_LOOP_SHARE					((uint64_t) 3U)
+
+/**
+ * @internal
+ * @def SENSOR_CHECK_OPEN_CODE
+ * @brief The conversion at or above which a sensor check finds its input open circuit. An open input cannot sink the
+ * detect current, which drives it to positive full scale.
+ */
+#define SENSOR_CHECK_OPEN_CODE				((int32_t) ((MAX_CODE / 16U) * 15U))
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE TYPE DEFINITIONS */
 /*--------------------------------------------------------------------------------------------------------*/
 
+/**
+ * @internal
+ * @brief The steps of calibrating a single set of settings.
+ */
+typedef enum {
+	CAL_STEP_CONFIGURE, /**< The next settings are to be applied and their self calibration started. */
+	CAL_STEP_SELF, /**< The self calibration is in progress. */
+	CAL_STEP_OFFSET /**< The system offset calibration is in progress. */
+} CalibrationStep_t;
+
 /**
  * @internal
  * @brief Data structure for keeping track of the current state of the calibration process.
@@ -62,23 +126,71 @@ typedef struct {
 	uint8_t buffer_index; /**< The index of the current buffer setting being calibrated. */
 	bool finished; /**< TRUE if the particular calibration set has completed. Note that this is not the entire process. */
 	uint8_t finished_count; /**< The number of calibration sets which have completed. */
+	CalibrationStep_t step; /**< The step of the current calibration set. */
+	volatile bool due; /**< TRUE once the expected duration of the calibration in progress has passed. */
 } CalibrationState_t;
 
+/**
+ * @internal
+ * @brief Data structure for scheduling the offset calibrations made between scans while sampling.
+ *
+ * Each scan position which starts a group of shared settings is calibrated in turn. Its first self offset
+ * calibration of a sampling run is the reference, and later ones move the system offset in the calibration table by
+ * the drift from it.
+ */
+typedef struct {
+	uint32_t interval; /**< The time between background calibrations in microseconds, 0 if not time based. */
+	float temperatureDelta; /**< The board temperature change which triggers a background calibration, 0 if not used. */
+	uint64_t lastTime; /**< The time of the last background calibration. */
+	float lastTemperature; /**< The board temperature at the last background calibration. */
+	uint8_t next; /**< The scan position whose settings are calibrated next. */
+	uint8_t position; /**< The scan position whose settings are being calibrated. */
+	bool active; /**< TRUE while a background calibration is in progress. */
+	uint32_t count; /**< The number of background calibrations since start up. */
+	bool referenced[NUM_ANALOG_INPUTS]; /**< TRUE once a scan position has its reference for the current run. */
+	int32_t selfReference[NUM_ANALOG_INPUTS]; /**< The self offset calibration of each scan position's reference. */
+	int32_t systemReference[NUM_ANALOG_INPUTS]; /**< The table's system offset calibration at the same time. */
+} BackgroundCalibration_t;
+
+/**
+ * @internal
+ * @brief Data structure for scheduling the sensor checks made while sampling.
+ *
+ * Every interval scans one input of the scan with a sensor attached, an external or differential input, is converted
+ * once more with the ADC's sensor detect current sources on, taking each such input in turn. The extra conversion is
+ * not stored, the input's samples are taken without the current as usual.
+ */
+typedef struct {
+	uint32_t interval; /**< The number of scans between sensor checks, 0 if they are disabled. */
+	ADS1256_SENSOR_DETECT_t current; /**< The detect current a check applies. */
+	uint64_t lastScan; /**< The scan count at the last sensor check. */
+	uint8_t next; /**< The scan position checked next. */
+	Analog_Input_t* input; /**< The input checked after its next sample, NULL if no check is due. */
+	volatile bool converting; /**< TRUE while the check conversion is in progress. */
+	volatile int32_t code; /**< The result of the check conversion. */
+	bool open[NUM_ANALOG_INPUTS]; /**< TRUE for each physical input whose latest check found it open circuit. */
+	uint32_t count; /**< The number of sensor checks since start up. */
+} SensorCheck_t;
+
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE VARIABLES */
 /*--------------------------------------------------------------------------------------------------------*/
 
-/* The current state of the machine. */
-static ADC_State_t CurrentState;
+/* The current state of the machine. Also left by the multiplexer settle interrupt, see ADC_Machine_MuxSettled(). */
+static volatile ADC_State_t CurrentState;
 
 /* The previous state of the adc machine. Used for some intermediate states */
 static ADC_State_t PreviousState;
 
-/* The total number of samples to take */
-static volatile uint32_t SampleTotal;
+/* The total number of samples to take, unused by continuous sampling. */
+static volatile uint64_t SampleTotal;
+
+/* The current sample number. 64 bits wide so a continuous sampling can count for the life of the board. */
+static volatile uint64_t SampleCurrent;
 
-/* The current sample number. */
-static volatile uint32_t SampleCurrent;
+/* Flag indicating the sampling runs until it is halted rather than for SampleTotal samples. */
+static volatile bool continuousSampling = false;
 
 /* List of inputs to sample. */
 static Analog_Input_t** samplingInputs;
@@ -89,106 +201,1222 @@ static uint8_t numberSamplingInputs = 0U;
 /* The current input to sample */
 static uint8_t currentSamplingInput = 0U;
 
-/* Used to indicate if we are waiting on a temperature sample */
-static bool waitingOnTemp = false;
+/* Used to indicate if we are waiting on a temperature sample */
+static bool waitingOnTemp = false;
+
+
+static CalibrationState_t calibrationState;
+
+static bool isFirstIdle = true;
+
+/* The multi-channel scan order, built when sampling begins. The first scanLength entries are the inputs with no gaps,
+ * so the scan advances in constant time, the rest are NULL. Read on every conversion, so kept in CCM RAM. */
+static Analog_Input_t* scanPlan[NUM_ANALOG_INPUTS] CCM_DATA;
+
+/* The number of inputs in the scan plan. */
+static uint8_t scanLength = 0U;
+
+/* The system time of the most recent cold junction sample. */
+static uint64_t lastColdJunctionTime = 0U;
+
+/* The system time at which the cold junction conversion in progress was started. */
+static uint64_t coldJunctionStartTime = 0U;
+
+/* The number of completed scans since the most recent cold junction sample. */
+static uint32_t scansSinceColdJunction = 0U;
+
+/* How the cold junction refresh interval is measured. */
+static ADC_ColdJunctionRefresh_t coldJunctionPolicy = ADC_CJ_REFRESH_TIME;
+
+/* The cold junction refresh interval, in microseconds or scans depending on the policy. */
+static uint32_t coldJunctionInterval = COLD_JUNCTION_DEFAULT_INTERVAL_US;
+
+/* Set when sampling begins so the first external multiplexer switch refreshes the cold junction. */
+static bool coldJunctionStale = true;
+
+/* Set once the next input's settings have been loaded while waiting on the external multiplexer. */
+static volatile bool muxSettingsLoaded = false;
+
+/* Incremented whenever the calibration values of the inputs' register images may have changed. Never 0. */
+static uint32_t calibrationVersion = 1U;
+
+/* Set by the DRDY interrupt each time a sample has been stored for the current input. */
+static volatile bool sampleReady = false;
+
+/* The total number of samples the DRDY interrupt has dropped. */
+static volatile uint32_t sampleOverrunCount = 0U;
+
+/* The value of sampleOverrunCount when dropped samples were last reported. */
+static uint32_t reportedOverrunCount = 0U;
+
+/* The time dropped samples were last reported. */
+static uint64_t lastOverrunReport = 0U;
+
+/* What happens when a buffer fills up. Only lasts for the sampling it was set for. */
+static ADC_OverflowPolicy_t overflowPolicy = ADC_OVERFLOW_DROP_NEWEST;
+
+/* Set by the DRDY interrupt when it holds off a single channel run for lack of buffer space. */
+static volatile bool samplingPaused = false;
+
+/* The scan position the writers serve first on the next drain. */
+static uint8_t drainPosition = 0U;
+
+/* The human readable names of the overflow policies. */
+static const char* OVERFLOW_POLICY_STRINGS[NUM_ADC_OVERFLOW_POLICIES] = { "DROP_NEWEST", "DROP_OLDEST", "PAUSE" };
+
+/* The total number of conversions read by the DRDY interrupt. */
+static volatile uint32_t conversionCount = 0U;
+
+/* The total number of samples produced for each physical input, after oversampling and filtering. */
+static volatile uint32_t inputSampleCounts[NUM_ANALOG_INPUTS];
+
+/* The DRDY time of the previous conversion of each sampling input, 0 until it has been converted. */
+static uint64_t lastConversionTimes[NUM_ANALOG_INPUTS] CCM_DATA;
+
+/* The schedule and references of the calibrations made between scans */
+static BackgroundCalibration_t backgroundCalibration;
+
+/* The schedule and results of the sensor checks made while sampling */
+static SensorCheck_t sensorCheck = { .current = ADS1256_SDC_2 };
+
+/* The snapshot frame period in microseconds, 0 when scans run back to back. */
+static uint32_t snapshotPeriod = 0U;
+
+/* The clock of the frame timer, which ticks once per snapshot frame or paced scan, in Hz. */
+static uint32_t frameTimerClock = 0U;
+
+/* Flag indicating the first input of the next frame is loaded and its conversion waits for the frame tick. */
+static volatile bool snapshotArmed = false;
+
+/* The local time of the frame tick which started the current frame. */
+static volatile uint64_t snapshotFrameTime = 0U;
+
+/* The number of frame ticks which came before the previous frame's scan had finished. */
+static volatile uint32_t snapshotMissedFrames = 0U;
+
+/* The time from the frame tick to the latest conversion of each sampling input, in microseconds. */
+static uint32_t snapshotOffsets[NUM_ANALOG_INPUTS] CCM_DATA;
+
+/* The longest time in microseconds a drain of the sample buffers may take. */
+static uint32_t outputBudget = ADC_OUTPUT_BUDGET_DEFAULT_US;
+
+/* The local time the last drain of the sample buffers ended, 0 before the first drain of a sampling. */
+static uint64_t lastDrainEnd = 0U;
+
+/* The interval between the starts of paced scans in microseconds, 0 when scans run back to back. */
+static uint32_t pacedInterval = 0U;
+
+/* Flag indicating the ADC is in standby with the first input of the next scan loaded, waiting for the scan tick. */
+static volatile bool pacedArmed = false;
+
+/* The number of scan ticks which came before the previous paced scan had finished. */
+static volatile uint32_t pacedMissedScans = 0U;
+
+/* The CCM-RAM the linker leaves after .ccmram and .ccmbss, all of which holds the burst capture codes. */
+extern uint8_t _sccmfree;
+extern uint8_t _eccmfree;
+
+/* The state of the burst capture. */
+static ADC_BurstCapture_t burstCapture;
+
+/* The input list handed to the sampling state for a burst capture. */
+static Analog_Input_t* burstCaptureInputs[1];
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Returns a human readable string of the input state.
+ */
+static inline const char* ADCMachine_StringFromState(ADC_State_t machine_state);
+
+/**
+ * @internal
+ * @brief Changes the state of the machine, recording the transition in the state trace.
+ */
+static inline void ADC_Machine_EnterState(ADC_State_t machine_state);
+
+/**
+ * @internal
+ * @brief Begins a new conversion for the specified input.
+ */
+static void BeginNextConversion(Analog_Input_t* input);
+
+/**
+ * @internal
+ * @brief Performs the necessary calibration steps for the ADC.
+ */
+static void ADC_Machine_Service_Calibrating(void);
+
+/**
+ * @internal
+ * @brief Deadline callback made once a calibration in progress should be complete.
+ */
+static void ADC_Machine_CalibrationDue(void);
+
+/**
+ * @internal
+ * @brief Starts an ADC calibration and schedules when to check for its completion.
+ */
+static void StartCalibrationStep(ADS1256_Command_t cmd, float duration, CalibrationStep_t step);
+
+/**
+ * @internal
+ * @brief Abandons any calibration in progress, waiting for the ADC to finish it.
+ */
+static void AbortCalibrationStep(void);
+
+/**
+ * @internal
+ * @brief Stores a cold junction sample, replacing the oldest if the buffer is full.
+ */
+static void StoreColdJunctionSample(Analog_Input_t* input, int32_t value, uint64_t timestamp);
+
+/**
+ * @internal
+ * @brief Performs the necessary system gain calibration steps for the ADC.
+ */
+static void ADC_Machine_Service_GainCalibrating(void);
+
+/**
+ * @internal
+ * @brief Performs the necessary service functions when the ADC is idling.
+ */
+static void ADC_Machine_Service_Idle(void);
+
+/**
+ * @internal
+ * @brief Performs the necessary service functions when the ADC is sampling.
+ */
+static void ADC_Machine_Service_Sampling(void);
+
+/**
+ * @internal
+ * @brief Reports the samples dropped since the last report.
+ */
+static void ReportSampleOverruns(bool force);
+
+/**
+ * @internal
+ * @brief Determines if an input's buffer has a number of free samples.
+ */
+static bool hasSampleRoom(const Analog_Input_t* input, uint32_t room);
+
+/**
+ * @internal
+ * @brief Discards the oldest samples of each buffer which is close to full.
+ */
+static void DiscardOldestSamples(void);
+
+/**
+ * @internal
+ * @brief Writes the buffered data of the sampling inputs in turn.
+ */
+static void DrainAnalogInputs(void);
+
+/**
+ * @internal
+ * @brief Determines if any sampling input has data left to write.
+ */
+static bool isAnalogOutputPending(void);
+
+/**
+ * @internal
+ * @brief Performs the necessary service functions when the ADC is switching external channels.
+ */
+static void ADC_Machine_Service_Muxing(void);
+
+/**
+ * @internal
+ * @brief Marks the calibration values of the inputs' register images as stale.
+ */
+static void InvalidateCalibration(void);
+
+/**
+ * @internal
+ * @brief Updates the calibration parameters of an input's register image.
+ */
+static void ApplyCalibrationParameters(Analog_Input_t* input);
+
+/**
+ * @internal
+ * @brief Updates the gain corrections of the calibrated inputs for the current board temperature.
+ */
+static void UpdateGainCorrections(void);
+
+/**
+ * @internal
+ * @brief Loads the sampling parameters of an input into the ADC.
+ */
+static void LoadConversionSettings(Analog_Input_t* input);
+
+/**
+ * @internal
+ * @brief Starts a conversion on an input whose settings are already loaded.
+ */
+static void StartConversion(Analog_Input_t* input);
+
+/**
+ * @internal
+ * @brief Determines if the cold junction needs to be sampled during the current external mux switch.
+ */
+static bool isColdJunctionDue(void);
+
+/**
+ * @internal
+ * @brief Starts the conversion of the next input once the external multiplexer has settled.
+ */
+static void ADC_Machine_MuxSettled(void);
+
+/**
+ * @internal
+ * @brief Builds the multi-channel scan order for the provided input list.
+ */
+static uint8_t BuildScanPlan(Analog_Input_t** inputs);
+
+/**
+ * @internal
+ * @brief Determines if two inputs share the same sampling parameters.
+ */
+static bool InputsShareSettings(const Analog_Input_t* a, const Analog_Input_t* b);
+
+/**
+ * @internal
+ * @brief Stores a conversion of a burst capture.
+ */
+static void ADC_Machine_BurstCaptureCallback(int32_t value);
+
+/**
+ * @internal
+ * @brief Ends a burst capture once all its codes have been stored.
+ */
+static void ADC_Machine_Service_BurstCapture(void);
+
+/**
+ * @internal
+ * @brief Sends the next codes of a burst capture download.
+ */
+static void ServiceBurstCaptureDownload(void);
+
+/**
+ * @internal
+ * @brief Stores a sample read by the DRDY interrupt into the current input.
+ */
+static void ADC_Machine_DataReadyCallback(int32_t value);
+
+/**
+ * @internal
+ * @brief Starts switching the external multiplexer to the next input of the scan once a conversion is latched.
+ */
+static void ADC_Machine_DataLatchedCallback(void);
+
+/**
+ * @internal
+ * @brief Finds the input the scan moves on to after the current one, without advancing the scan.
+ */
+static Analog_Input_t* PeekNextScanInput(bool* wraps);
+
+/**
+ * @internal
+ * @brief Determines if a background offset calibration should be made before the next scan.
+ */
+static bool isBackgroundCalibrationDue(void);
+
+/**
+ * @internal
+ * @brief Starts a background offset calibration of the next group of settings in the scan.
+ */
+static void StartBackgroundCalibration(void);
+
+/**
+ * @internal
+ * @brief Completes a background offset calibration and resumes sampling once the ADC is done.
+ */
+static bool ServiceBackgroundCalibration(void);
+
+/**
+ * @internal
+ * @brief Determines if a sensor check should be scheduled.
+ */
+static bool isSensorCheckDue(void);
+
+/**
+ * @internal
+ * @brief Picks the input the next sensor check is made on.
+ */
+static Analog_Input_t* NextSensorCheckInput(void);
+
+/**
+ * @internal
+ * @brief Starts the check conversion of the scheduled input with the sensor detect current on.
+ */
+static void StartSensorCheck(void);
+
+/**
+ * @internal
+ * @brief Stores the result of a sensor check conversion read by the DRDY interrupt.
+ */
+static void ADC_Machine_SensorCheckCallback(int32_t value);
+
+/**
+ * @internal
+ * @brief Turns the sensor detect current off and reports the result of the sensor check.
+ */
+static void FinishSensorCheck(void);
+
+/**
+ * @internal
+ * @brief Sign extends a 24 bit ADC calibration register value.
+ */
+static int32_t SignExtendCalibration(uint32_t value);
+
+/**
+ * @internal
+ * @brief Determines if the sampling has taken all of its samples.
+ */
+static bool isSampleCountReached(void);
+
+/**
+ * @internal
+ * @brief Determines if the next conversion starts a snapshot frame and must wait for the frame tick.
+ */
+static bool isSnapshotFrameStart(void);
+
+/**
+ * @internal
+ * @brief Determines if the next conversion starts a paced scan and must wait in standby for the scan tick.
+ */
+static bool isPacedScanStart(void);
+
+/**
+ * @internal
+ * @brief Configures the frame timer.
+ */
+static void FrameTimerInit(void);
+
+/**
+ * @internal
+ * @brief Starts the frame timer at the provided period.
+ */
+static void StartFrameTimer(uint32_t period);
+
+/**
+ * @internal
+ * @brief Moves the frame timer's interrupt of a paced sampling ahead of each tick by the ADC's settling time.
+ */
+static void ArmPacedWakeup(void);
+
+/**
+ * @internal
+ * @brief Sends a status message with the time from the frame tick to the conversion of each input.
+ */
+static void ReportSnapshotOffsets(void);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Retrieve a human readable string for the provided state.
+ *
+ * @param state ADC_State_t The state to retrieve a string for.
+ * @retval const char* The human readable string representation.
+ */
+static inline const char* ADCMachine_StringFromState(ADC_State_t machine_state) {
+	static const char* strings[] = { "ADC_UNINITIALIZED", "ADC_INITIALIZED", "ADC_CALIBRATING", "ADC_GAIN_CALIBRATING", "ADC_IDLE", "ADC_CHANNEL_SAMPLING",
+			"ADC_RESET", "ADC_EXTERNAL_MUXING" };
+	return strings[machine_state];
+}
+
+/**
+ * Changes the state of the machine, recording the transition in the state trace along with the position in the scan
+ * so the host can attribute the time spent to each input.
+ *
+ * @param machine_state ADC_State_t The state to enter.
+ * @retval none
+ */
+static inline void ADC_Machine_EnterState(ADC_State_t machine_state) {
+	CurrentState = machine_state;
+	StateTrace_Record(STATE_TRACE_ADC, (uint8_t) machine_state, currentSamplingInput);
+}
+
+/**
+ * Begins a new conversion for the provided input. This method is primarily used for multi input conversions.
+ *
+ * @param input Analog_Input to begin conversion for. It is assumed the switch has been made.
+ */
+static void BeginNextConversion(Analog_Input_t* input) {
+	LoadConversionSettings(input);
+	StartConversion(input);
+}
+
+/**
+ * Loads the data rate, gain, buffer and calibration parameters of the provided input into the ADC without
+ * starting a conversion. These come from the input's precomputed register image.
+ *
+ * @param input Analog_Input_t* The input to load settings for.
+ * @retval none
+ */
+static void LoadConversionSettings(Analog_Input_t* input) {
+	ApplyCalibrationParameters(input);
+	/* A single write of only the registers which differ from the previous input's */
+	ADS1256_LoadRegisterImage(&input->registers);
+}
+
+/**
+ * Starts a conversion on the provided input, handing the result to the DRDY interrupt if the machine is sampling.
+ * It is assumed the input has been selected and its settings loaded. In snapshot mode the first input of a frame is
+ * left converting freely until the frame tick restarts it. In paced sampling the ADC instead waits in standby for
+ * the scan tick to wake it for the first input of a scan.
+ *
+ * @param input Analog_Input_t* The input to begin a conversion for.
+ * @retval none
+ */
+static void StartConversion(Analog_Input_t* input) {
+	if ((CurrentState == ADC_CHANNEL_SAMPLING) && (isPacedScanStart() == true)) {
+		/* The scan tick wakes the ADC and hands the bus to the DRDY interrupt */
+		ADS1256_Standby();
+		pacedArmed = true;
+		return;
+	}
+	ADS1256_Wakeup();
+	if (CurrentState == ADC_CHANNEL_SAMPLING) {
+		if (isSnapshotFrameStart() == true) {
+			/* The frame tick restarts the conversion and hands the bus to the DRDY interrupt */
+			snapshotArmed = true;
+			return;
+		}
+		/* Hand the bus to the DRDY interrupt for the result */
+		ADS1256_SetContinuousRead((numberSamplingInputs == 1U) && (pacedInterval == 0U));
+		ADS1256_EnableDataReadyInterrupt(&ADC_Machine_DataReadyCallback);
+	}
+}
+
+/**
+ * Determines if the cold junction temperature needs to be refreshed during the current external multiplexer
+ * switch, based on the configured refresh policy. Switches made outside of channel sampling always refresh it.
+ *
+ * @param none
+ * @retval bool TRUE if a cold junction sample should be taken.
+ */
+static bool isColdJunctionDue(void) {
+	bool due = true;
+	if ((PreviousState == ADC_CHANNEL_SAMPLING) && (coldJunctionStale == false)) {
+		if (coldJunctionPolicy == ADC_CJ_REFRESH_SCANS) {
+			due = (scansSinceColdJunction >= coldJunctionInterval);
+		} else {
+			due = ((GetLocalTime() - lastColdJunctionTime) >= coldJunctionInterval);
+		}
+	}
+	return due;
+}
+
+/**
+ * Starts the conversion of the next input once the external multiplexer has settled. Called from the settle timer
+ * interrupt, which shares the DRDY interrupt's priority, when the switch settles after the input's settings were
+ * loaded, or from the main loop when it had settled already. Nothing is done if sampling stopped meanwhile.
+ *
+ * @param none
+ * @retval none
+ */
+static void ADC_Machine_MuxSettled(void) {
+	if (CurrentState == ADC_EXTERNAL_MUXING) {
+		muxSettingsLoaded = false;
+		ADC_Machine_EnterState(PreviousState);
+		StartConversion(samplingInputs[currentSamplingInput]);
+	}
+}
+
+/**
+ * Determines if two inputs share the same data rate, gain and buffer settings as well as the same multiplexer path
+ * (external or not), meaning the ADC does not need to be reprogrammed when switching between them.
+ *
+ * @param a const Analog_Input_t* The first input.
+ * @param b const Analog_Input_t* The second input.
+ * @retval bool TRUE if the inputs can share ADC settings.
+ */
+static bool InputsShareSettings(const Analog_Input_t* a, const Analog_Input_t* b) {
+	return (isExternalInput(a->physicalInput) == isExternalInput(b->physicalInput)) && (a->rate == b->rate) && (a->gain == b->gain)
+			&& (a->buffer == b->buffer);
+}
+
+/**
+ * Builds the order in which a multi-channel scan will visit its inputs. Inputs which do not need the external
+ * multiplexer, the internal and differential inputs, are placed first so they are sampled back to back, followed by
+ * the external inputs. Within each of these, inputs with identical rate, gain and buffer settings are grouped
+ * together (keeping their requested order) so the ADC registers and calibration only need reprogramming when a
+ * group changes. An input listed more than once is only planned once.
+ *
+ * @param inputs Analog_Input_t** The requested input list, NUM_ANALOG_INPUTS long. NULL and un-added entries are skipped.
+ * @retval uint8_t The number of inputs in the plan.
+ */
+static uint8_t BuildScanPlan(Analog_Input_t** inputs) {
+	uint8_t length = 0U;
+	for (uint_fast8_t i = 0U; i < NUM_ANALOG_INPUTS; ++i) {
+		scanPlan[i] = NULL;
+	}
+	for (uint_fast8_t i = 0U; i < NUM_ANALOG_INPUTS; ++i) {
+		Analog_Input_t* input = inputs[i];
+		if (input == NULL || input->added == CHANNEL_NOTADDED) {
+			continue;
+		}
+		/* Find the end of the matching group, or the end of this input's class if there is none */
+		uint8_t position = length;
+		bool external = isExternalInput(input->physicalInput);
+		for (uint_fast8_t j = 0U; j < length; ++j) {
+			if (scanPlan[j] == input) {
+				/* Already planned */
+				position = NULL_CHANNEL;
+				break;
+			} else if (InputsShareSettings(scanPlan[j], input) == true) {
+				position = j + 1U;
+			} else if (external == false && isExternalInput(scanPlan[j]->physicalInput) == true && position == length) {
+				/* Internal inputs go before all external inputs */
+				position = j;
+			}
+		}
+		if (position == NULL_CHANNEL) {
+			continue;
+		}
+		for (uint_fast8_t j = length; j > position; --j) {
+			scanPlan[j] = scanPlan[j - 1U];
+		}
+		scanPlan[position] = input;
+		++length;
+	}
+#ifdef ADC_STATE_MACHINE_DEBUG
+	printf("[ADC STATE MACHINE] Scan plan built with %i inputs.\n\r", length);
+#endif
+	return length;
+}
+
+/**
+ * Called from interrupt context with each conversion result while sampling. The value is stored in the ring
+ * buffer of the current input. In multi-channel sampling the DRDY interrupt is masked after a single result so
+ * the state machine can switch inputs; in single channel sampling the ADC is left free running and the sample
+ * count is advanced here so no conversions are lost to main loop latency. An oversampled input is left converting
+ * until all of the conversions of its sample have been accumulated, and only the completed sample is counted.
+ *
+ * Each sample is stamped with the time the DRDY interrupt fired, i.e. when its conversion completed. An input with a
+ * filter only buffers the filter's outputs, each stamped with the time of the last conversion which produced it. In
+ * snapshot mode every sample of a frame is stamped with the time of the frame tick instead.
+ * In statistics mode samples are added to the input's statistics window rather than buffered. Otherwise samples
+ * within the input's deadband are discarded here, before they take any buffer space or connection time. During a
+ * triggered capture every sample goes to the capture, and sampling stops once it is complete.
+ *
+ * Each stored sample carries the input's pending flags, raised by the state machine since its last stored sample, and
+ * is flagged overrange if any of its conversions hit the ADC's full scale. Overrange only marks the sample it
+ * belongs to, the other flags wait for the next sample which is stored. An auto-ranged input's gain is adjusted to
+ * each of its samples, to take effect at its next conversion. The conversion of a sensor check is not a sample, it is
+ * only kept for the check.
+ *
+ * Since the main loop owns the read index, a full buffer causes the new sample to be dropped rather than
+ * overwriting the oldest one. The drop is counted against the input, the next sample stored is flagged as following
+ * a gap, and the main loop reports a summary of the drops at most once every OVERRUN_REPORT_INTERVAL_US.
+ *
+ * @param value int32_t The converted ADC reading.
+ * @retval none
+ */
+static void ADC_Machine_DataReadyCallback(int32_t value) {
+	if (burstCapture.active == true) {
+		ADC_Machine_BurstCaptureCallback(value);
+		return;
+	}
+	if (sensorCheck.converting == true) {
+		ADC_Machine_SensorCheckCallback(value);
+		return;
+	}
+	Analog_Input_t* input = samplingInputs[currentSamplingInput];
+	bool captured = false;
+	/* Stamp the sample with the moment DRDY fired rather than when the main loop got to it */
+	const uint64_t timestamp = ADS1256_GetDataReadyTime();
+	TimingHistogram_Record(TIMING_DRDY_TO_READ, (uint32_t) (GetLocalTime() - timestamp));
+	if (lastConversionTimes[currentSamplingInput] != 0U) {
+		TimingHistogram_Record(TIMING_SAMPLE_INTERVAL, (uint32_t) (timestamp - lastConversionTimes[currentSamplingInput]));
+	}
+	lastConversionTimes[currentSamplingInput] = timestamp;
+	++conversionCount;
+	uint64_t sampleTime = timestamp;
+	if (snapshotPeriod != 0U) {
+		/* Every sample of a frame carries the frame's time, the offset of the conversion is kept for the report */
+		snapshotOffsets[currentSamplingInput] = (uint32_t) (timestamp - snapshotFrameTime);
+		sampleTime = snapshotFrameTime;
+	}
+	if ((value >= (int32_t) MAX_CODE) || (value < -((int32_t) MAX_CODE))) {
+		input->pendingFlags |= ANALOG_SAMPLE_FLAG_OVERRANGE;
+	}
+	if (OversampleAnalogInput(input, &value) == false) {
+		/* Stay on the input, its next conversion follows without any switching */
+		return;
+	}
+	if (input->gainCorrection != ANALOG_GAIN_CORRECTION_UNITY) {
+		/* Follow the gain calibration as the board temperature drifts */
+		value = (int32_t) ((((int64_t) value) * input->gainCorrection) >> ANALOG_GAIN_CORRECTION_BITS);
+	}
+	const int32_t code = value;
+	value = LinearizeAnalogSample(input, value);
+	if (numberSamplingInputs > 1) {
+		/* Hold off further reads until the next input has been selected */
+		ADS1256_MaskDataReadyInterrupt();
+	}
+	if ((input->filter.type == ANALOG_FILTER_NONE) || AnalogFilter_Process(&input->filter, &value)) {
+		const uint8_t flags = input->pendingFlags;
+		++inputSampleCounts[input->physicalInput];
+		RecordLatestAnalogSample(input, value, sampleTime, flags);
+		if (currentSamplingInput == 0U) {
+			/* The digital state and auxiliary readings of the scan are taken with its first sample and share its timestamp */
+			AnalogMixed_Capture(sampleTime);
+			AnalogAux_Capture(sampleTime);
+		}
+		AnalogPower_Process(input->physicalInput, value, sampleTime);
+		AnalogMath_Process(input->physicalInput, value, sampleTime);
+		DigitalInterlock_ProcessAnalog(input->physicalInput, value, sampleTime);
+		DigitalPID_Process(input->physicalInput, value);
+		bool stored = true;
+		bool kept = true;
+		if (AnalogTrigger_GetState() != ANALOG_TRIGGER_IDLE) {
+			captured = AnalogTrigger_Process(input, value, sampleTime, flags);
+		} else if (isAnalogStatisticsEnabled() == true) {
+			stored = AccumulateAnalogSample(input, value, sampleTime);
+		} else if ((AnalogMath_IsRawHidden(input->physicalInput) == false)
+				&& (isAnalogSampleReportable(input, value, sampleTime) == true)) {
+			stored = StoreAnalogSample(input, value, sampleTime, flags);
+		} else {
+			kept = false;
+		}
+		uint8_t pending = 0U;
+		if (stored == false) {
+			++sampleOverrunCount;
+			++(input->overruns);
+			/* The lost sample keeps its sequence number, leaving a gap the client can count */
+			++(input->sequence);
+			pending = (uint8_t) ((flags & ~ANALOG_SAMPLE_FLAG_OVERRANGE) | ANALOG_SAMPLE_FLAG_GAP);
+		} else if (kept == false) {
+			pending = (uint8_t) (flags & ~ANALOG_SAMPLE_FLAG_OVERRANGE);
+		}
+		input->pendingFlags = pending;
+	}
+	if ((input->autoRange == true) && (numberSamplingInputs > 1) && (isAnalogStatisticsEnabled() == false)
+			&& (AnalogTrigger_GetState() == ANALOG_TRIGGER_IDLE)) {
+		/* A new gain is loaded with the input's settings when the scan next comes back to it */
+		AutoRangeAnalogInput(input, code);
+	}
+	if (numberSamplingInputs == 1) {
+		++SampleCurrent;
+		if (isSampleCountReached() == true) {
+			ADS1256_MaskDataReadyInterrupt();
+		} else if ((overflowPolicy == ADC_OVERFLOW_PAUSE) && (AnalogTrigger_GetState() == ANALOG_TRIGGER_IDLE)
+				&& (hasSampleRoom(input, ANALOG_SAMPLE_BLOCK_SIZE) == false)) {
+			/* Hold off reads until the writers have made room, the main loop resumes them */
+			ADS1256_MaskDataReadyInterrupt();
+			samplingPaused = true;
+		} else if (pacedInterval != 0U) {
+			/* A paced scan of a lone input is one conversion, the main loop puts the ADC back in standby */
+			ADS1256_MaskDataReadyInterrupt();
+		}
+	}
+	if (captured == true) {
+		/* The capture is frozen, stop converting and let the main loop drain it */
+		ADS1256_MaskDataReadyInterrupt();
+		continuousSampling = false;
+		SampleTotal = SampleCurrent;
+	}
+	sampleReady = true;
+}
+
+/**
+ * Stores a conversion read by the DRDY interrupt during a burst capture. Only the raw code and the times of the first
+ * and last conversions are kept, so the capture can follow the fastest data rate. The interrupt masks itself once
+ * the requested number of codes has been stored.
+ *
+ * @param value int32_t The converted ADC reading.
+ * @retval none
+ */
+static void ADC_Machine_BurstCaptureCallback(int32_t value) {
+	const uint64_t timestamp = ADS1256_GetDataReadyTime();
+	const uint32_t index = burstCapture.count;
+	uint8_t* code = &(&_sccmfree)[index * ANALOG_SAMPLE_VALUE_SIZE];
+	code[0] = (uint8_t) value;
+	code[1] = (uint8_t) (value >> 8);
+	code[2] = (uint8_t) (value >> 16);
+	if (index == 0U) {
+		burstCapture.start = timestamp;
+	}
+	burstCapture.end = timestamp;
+	burstCapture.count = index + 1U;
+	++conversionCount;
+	++SampleCurrent;
+	if (isSampleCountReached() == true) {
+		ADS1256_MaskDataReadyInterrupt();
+	}
+	sampleReady = true;
+}
+
+/**
+ * Starts switching the external multiplexer to the next input of a multi-channel scan as soon as the current
+ * conversion is latched, before the DRDY interrupt reads it. The relays then settle while the conversion is read and
+ * the main loop loads the next input's settings, rather than after. Only switches between two external inputs are
+ * made early, as they keep the ADC's own multiplexer on the external input, and none are made while the current
+ * input still has conversions to oversample, nor when the scan is about to end or stop for a background
+ * calibration.
+ *
+ * @param none
+ * @retval none
+ */
+static void ADC_Machine_DataLatchedCallback(void) {
+	if ((CurrentState != ADC_CHANNEL_SAMPLING) || (numberSamplingInputs <= 1U) || (backgroundCalibration.active == true)) {
+		return;
+	}
+	const Analog_Input_t* input = samplingInputs[currentSamplingInput];
+	if (((input->oversampling > 1U) && ((input->oversampled + 1U) < input->oversampling)) || (sensorCheck.input == input)) {
+		/* The scan stays on the input for its next conversion, or its sensor check */
+		return;
+	}
+	bool wraps = false;
+	Analog_Input_t* next = PeekNextScanInput(&wraps);
+	if ((next == NULL) || (next == input) || (isExternalInput(input->physicalInput) == false)
+			|| (isExternalInput(next->physicalInput) == false)) {
+		return;
+	}
+	if ((wraps == true) && (((continuousSampling == false) && ((SampleCurrent + 1U) >= SampleTotal))
+			|| (isBackgroundCalibrationDue() == true))) {
+		return;
+	}
+	PrepareExternalInput(next);
+}
+
+/**
+ * Finds the input the scan moves on to after the current one, the same way ADC_Machine_Service_Sampling() does, but
+ * without advancing the scan. The plan is compacted, so this is simply the following entry.
+ *
+ * @param wraps bool* Set TRUE if the end of the scan is passed on the way.
+ * @retval Analog_Input_t* The next input, NULL if there is none.
+ */
+static Analog_Input_t* PeekNextScanInput(bool* wraps) {
+	if (scanLength == 0U) {
+		*wraps = false;
+		return NULL;
+	}
+	const uint_fast8_t index = currentSamplingInput + 1U;
+	*wraps = (index >= scanLength);
+	return samplingInputs[(*wraps == true) ? 0U : index];
+}
+
+/**
+ * Stores a cold junction sample in the input's buffer. Unlike the sampled inputs, the cold junction's buffer is both
+ * filled and drained from the main loop, so when it is full the oldest sample is released to make room rather than
+ * refusing the newest.
+ *
+ * @param input Analog_Input_t* The cold junction input.
+ * @param value int32_t The measured value.
+ * @param timestamp uint64_t The time of the measurement.
+ * @retval none
+ */
+static void StoreColdJunctionSample(Analog_Input_t* input, int32_t value, uint64_t timestamp) {
+	/* Starting a new block may need more than one sample released */
+	RecordLatestAnalogSample(input, value, timestamp, 0U);
+	while (StoreAnalogSample(input, value, timestamp, 0U) == false) {
+		RingBuffer_Release(&input->samples, 1U);
+	}
+}
+
+/**
+ * Determines if a background offset calibration should be made before the next scan, either because the configured
+ * interval has passed or because the board temperature has moved far enough since the last one. None are made
+ * during a triggered capture, so its history is contiguous.
+ *
+ * @param none
+ * @retval bool TRUE if a background calibration is due.
+ */
+static bool isBackgroundCalibrationDue(void) {
+	if (AnalogTrigger_GetState() != ANALOG_TRIGGER_IDLE) {
+		return false;
+	}
+	if ((backgroundCalibration.interval != 0U)
+			&& ((GetLocalTime() - backgroundCalibration.lastTime) >= backgroundCalibration.interval)) {
+		return true;
+	}
+	if (backgroundCalibration.temperatureDelta > 0.0f) {
+		const float change = getBoardTemperature() - backgroundCalibration.lastTemperature;
+		return ((change >= backgroundCalibration.temperatureDelta) || (change <= -backgroundCalibration.temperatureDelta));
+	}
+	return false;
+}
+
+/**
+ * Starts a self offset calibration with the settings of the next scan position which begins a group of shared
+ * settings. The scan plan keeps inputs with the same settings together, so each group is calibrated once per round.
+ * The ADC must be halted, and conversions are resumed by ServiceBackgroundCalibration().
+ *
+ * @param none
+ * @retval none
+ */
+static void StartBackgroundCalibration(void) {
+	const uint8_t positions = (numberSamplingInputs == 1U) ? 1U : scanLength;
+	uint8_t position = backgroundCalibration.next % positions;
+	while ((position > 0U) && (InputsShareSettings(samplingInputs[position - 1U], samplingInputs[position]) == true)) {
+		position = (position + 1U) % positions;
+	}
+	backgroundCalibration.position = position;
+	backgroundCalibration.next = (position + 1U) % positions;
+	backgroundCalibration.active = true;
+	lastConversionTimes[currentSamplingInput] = 0U; /* The gap is not a sample interval */
+	LoadConversionSettings(samplingInputs[position]);
+	ADS1256_GetDataRate(); /* Update the driver's rate for the calibration time */
+	StartCalibrationStep(ADS1256_SELFOCAL, ADS1256_GetOffsetCalTime(), CAL_STEP_SELF);
+}
+
+/**
+ * Completes a background offset calibration once the ADC is done. The first calibration of a scan position in a run
+ * becomes its reference; later ones apply their drift from the reference to the system offset in the calibration
+ * table, which every input with those settings picks up on its next conversion. The change is marked in the stream
+ * with a status message carrying its time, so the samples after it can be told apart. Conversions are then resumed
+ * where the scan left off.
+ *
+ * @param none
+ * @retval bool TRUE while the calibration is still in progress.
+ */
+static bool ServiceBackgroundCalibration(void) {
+	if ((calibrationState.due == false) || (ADS1256_IsDataReady(false) == false)) {
+		return true;
+	}
+	ADS1256_FinishCalibration();
+	calibrationState.step = CAL_STEP_CONFIGURE;
+	backgroundCalibration.active = false;
+	const uint8_t position = backgroundCalibration.position;
+	const Analog_Input_t* calibrated = samplingInputs[position];
+	const int32_t self = SignExtendCalibration(ADS1256_GetOffsetCalSetting());
+	int32_t drift = 0;
+	if (backgroundCalibration.referenced[position] == false) {
+		backgroundCalibration.referenced[position] = true;
+		backgroundCalibration.selfReference[position] = self;
+		backgroundCalibration.systemReference[position] = SignExtendCalibration(
+				Tekdaqc_GetOffsetCalibration(calibrated->rate, calibrated->gain, calibrated->buffer));
+	} else {
+		drift = self - backgroundCalibration.selfReference[position];
+		const int32_t offset = __SSAT(backgroundCalibration.systemReference[position] + drift, 24);
+		Tekdaqc_SetOffsetCalibration(((uint32_t) offset) & 0xFFFFFFU, calibrated->rate, calibrated->gain, calibrated->buffer);
+		InvalidateCalibration();
+		/* Every input converted with the calibrated settings steps to the new offset */
+		for (uint_fast8_t i = 0U; i < numberSamplingInputs; ++i) {
+			if ((samplingInputs[i] != NULL) && (InputsShareSettings(samplingInputs[i], calibrated) == true)) {
+				samplingInputs[i]->pendingFlags |= ANALOG_SAMPLE_FLAG_CALIBRATING;
+			}
+		}
+	}
+	backgroundCalibration.lastTime = GetLocalTime();
+	backgroundCalibration.lastTemperature = getBoardTemperature();
+	++backgroundCalibration.count;
+	char message[128];
+	snprintf(message, sizeof(message), "ADC offset recalibrated at %" PRIu64 " RATE: %s GAIN: %s BUFFER: %s DRIFT: %" PRIi32,
+			Timer_ToEpochTime(backgroundCalibration.lastTime), ADS1256_StringFromSPS(calibrated->rate),
+			ADS1256_StringFromPGA(calibrated->gain), ADS1256_StringFromBuffer(calibrated->buffer), drift);
+	TelnetWriteStatusMessage(message);
+	/* Resume the scan, the multiplexer may have to be brought back to the next input */
+	Analog_Input_t* input = samplingInputs[currentSamplingInput];
+	input->pendingFlags |= ANALOG_SAMPLE_FLAG_CALIBRATING;
+	if (numberSamplingInputs > 1U) {
+		SelectAnalogInput(input);
+		if (CurrentState == ADC_CHANNEL_SAMPLING) {
+			BeginNextConversion(input);
+		}
+	} else {
+		BeginNextConversion(input);
+	}
+	return false;
+}
 
-static uint8_t scratch_bytes[3];
+/**
+ * Determines if a sensor check should be scheduled, once the configured number of scans has passed since the last
+ * one. None are made in snapshot or paced sampling, whose scans keep to the frame timer, nor during a triggered
+ * capture, so its history is contiguous. A lone input counts each of its samples as a scan.
+ *
+ * @param none
+ * @retval bool TRUE if a sensor check is due.
+ */
+static bool isSensorCheckDue(void) {
+	return (sensorCheck.interval != 0U) && ((SampleCurrent - sensorCheck.lastScan) >= sensorCheck.interval)
+			&& (snapshotPeriod == 0U) && (pacedInterval == 0U) && (AnalogTrigger_GetState() == ANALOG_TRIGGER_IDLE);
+}
 
-static CalibrationState_t calibrationState;
+/**
+ * Picks the input the next sensor check is made on, the next external or differential input of the scan after the
+ * last one checked. The internal inputs have no sensor to check.
+ *
+ * @param none
+ * @retval Analog_Input_t* The input to check, NULL if the scan has none with a sensor.
+ */
+static Analog_Input_t* NextSensorCheckInput(void) {
+	const uint8_t positions = (numberSamplingInputs == 1U) ? 1U : scanLength;
+	for (uint_fast8_t i = 0U; i < positions; ++i) {
+		const uint8_t position = (uint8_t) ((sensorCheck.next + i) % positions);
+		Analog_Input_t* input = samplingInputs[position];
+		if ((isExternalInput(input->physicalInput) == true) || (isDifferentialInput(input->physicalInput) == true)) {
+			sensorCheck.next = (uint8_t) ((position + 1U) % positions);
+			return input;
+		}
+	}
+	/* Nothing to check, wait out another interval before looking again */
+	sensorCheck.lastScan = SampleCurrent;
+	return NULL;
+}
 
-static bool isFirstIdle = true;
+/**
+ * Starts the check conversion of the scheduled input, which has just been sampled and is still selected, so no
+ * switching or settling is needed. The detect current is a single register write and the conversion is restarted
+ * so it is fully settled under the current. The ADC must be halted.
+ *
+ * @param none
+ * @retval none
+ */
+static void StartSensorCheck(void) {
+	ADS1256_SetSensorDetectCurrent(sensorCheck.current);
+	sensorCheck.converting = true;
+	lastConversionTimes[currentSamplingInput] = 0U; /* The gap is not a sample interval */
+	ADS1256_Wakeup();
+	ADS1256_EnableDataReadyInterrupt(&ADC_Machine_DataReadyCallback);
+}
 
-/*--------------------------------------------------------------------------------------------------------*/
-/* PRIVATE FUNCTION PROTOTYPES */
-/*--------------------------------------------------------------------------------------------------------*/
+/**
+ * Called from interrupt context with the result of a sensor check conversion. The code is kept for the main loop,
+ * which finishes the check and moves the scan on.
+ *
+ * @param value int32_t The converted ADC reading.
+ * @retval none
+ */
+static void ADC_Machine_SensorCheckCallback(int32_t value) {
+	ADS1256_MaskDataReadyInterrupt();
+	sensorCheck.code = value;
+	++conversionCount;
+	sampleReady = true;
+}
 
 /**
- * @internal
- * @brief Returns a human readable string of the input state.
+ * Turns the sensor detect current off and reports the result of the sensor check which has just been converted. An
+ * input found open circuit flags its next sample, and each change of an input between open and connected is marked
+ * in the stream with a status message. The ADC must be halted.
+ *
+ * @param none
+ * @retval none
  */
-static inline const char* ADCMachine_StringFromState(ADC_State_t machine_state);
+static void FinishSensorCheck(void) {
+	ADS1256_SetSensorDetectCurrent(ADS1256_SD_OFF);
+	Analog_Input_t* input = sensorCheck.input;
+	const bool open = (sensorCheck.code >= SENSOR_CHECK_OPEN_CODE);
+	sensorCheck.converting = false;
+	sensorCheck.input = NULL;
+	sensorCheck.lastScan = SampleCurrent;
+	++sensorCheck.count;
+	if (open == true) {
+		input->pendingFlags |= ANALOG_SAMPLE_FLAG_OPEN;
+	}
+	if (open != sensorCheck.open[input->physicalInput]) {
+		sensorCheck.open[input->physicalInput] = open;
+		char message[96];
+		snprintf(message, sizeof(message), "Sensor check at %" PRIu64 " found input %" PRIu8 " %s.",
+				Timer_ToEpochTime(GetLocalTime()), (uint8_t) input->physicalInput, (open == true) ? "OPEN" : "CONNECTED");
+		TelnetWriteStatusMessage(message);
+	}
+#ifdef ADC_STATE_MACHINE_DEBUG
+	printf("[ADC STATE MACHINE] Sensor check of input %i read %" PRIi32 ".\n\r", input->physicalInput, sensorCheck.code);
+#endif
+}
 
 /**
- * @internal
- * @brief Begins a new conversion for the specified input.
+ * Sign extends a 24 bit two's complement ADC calibration register value.
+ *
+ * @param value uint32_t The register value, in the low 24 bits.
+ * @retval int32_t The signed value.
  */
-static void BeginNextConversion(Analog_Input_t* input);
+static int32_t SignExtendCalibration(uint32_t value) {
+	return ((int32_t) (value << 8)) >> 8;
+}
 
 /**
- * @internal
- * @brief Performs the necessary calibration steps for the ADC.
+ * Determines if the sampling has taken all of its samples. A continuous sampling never has, it runs until halted.
+ *
+ * @param none
+ * @retval bool TRUE if the sampling is complete.
  */
-static void ADC_Machine_Service_Calibrating(void);
+static bool isSampleCountReached(void) {
+	/* At or past, as a halt can end the count while the last conversion is still being taken */
+	return (continuousSampling == false) && (SampleCurrent >= SampleTotal);
+}
 
 /**
- * @internal
- * @brief Performs the necessary system gain calibration steps for the ADC.
+ * Determines if the next conversion starts a snapshot frame. In snapshot mode each scan of a multi-channel sampling
+ * is a frame, started by the frame timer rather than by the end of the previous scan.
+ *
+ * @param none
+ * @retval bool TRUE if the conversion must wait for the frame tick.
  */
-static void ADC_Machine_Service_GainCalibrating(void);
+static bool isSnapshotFrameStart(void) {
+	return (snapshotPeriod != 0U) && (numberSamplingInputs > 1U) && (currentSamplingInput == 0U);
+}
 
 /**
- * @internal
- * @brief Performs the necessary service functions when the ADC is idling.
+ * Determines if the next conversion starts a paced scan. In paced sampling each scan, a single conversion for a lone
+ * input, is started by the frame timer and the ADC is kept in standby between scans.
+ *
+ * @param none
+ * @retval bool TRUE if the conversion must wait in standby for the scan tick.
  */
-static void ADC_Machine_Service_Idle(void);
+static bool isPacedScanStart(void) {
+	return (pacedInterval != 0U) && (snapshotPeriod == 0U) && (currentSamplingInput == 0U);
+}
 
 /**
- * @internal
- * @brief Performs the necessary service functions when the ADC is sampling.
+ * Configures the timer which ticks once per snapshot frame or paced scan. It is left stopped, with its update
+ * interrupt enabled, until a snapshot or paced sampling starts it.
+ *
+ * @param none
+ * @retval none
  */
-static void ADC_Machine_Service_Sampling(void);
+static void FrameTimerInit(void) {
+	TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+	NVIC_InitTypeDef NVIC_InitStructure;
+	RCC_ClocksTypeDef RCC_Clocks;
+	RCC_GetClocksFreq(&RCC_Clocks);
+	frameTimerClock = RCC_Clocks.PCLK1_Frequency;
+	if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+		frameTimerClock *= 2U;
+	}
+
+	RCC_APB1PeriphClockCmd(SNAPSHOT_FRAME_TIM_CLK, ENABLE);
+
+	TIM_TimeBaseStructInit(&TIM_TimeBaseStructure);
+	TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+	TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+	TIM_TimeBaseInit(SNAPSHOT_FRAME_TIM, &TIM_TimeBaseStructure);
+	TIM_ClearITPendingBit(SNAPSHOT_FRAME_TIM, TIM_IT_Update);
+
+	NVIC_InitStructure.NVIC_IRQChannel = SNAPSHOT_FRAME_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = SNAPSHOT_FRAME_PREEMPT_PRIORITY;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0U;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+
+	TIM_ITConfig(SNAPSHOT_FRAME_TIM, TIM_IT_Update, ENABLE);
+}
 
 /**
- * @internal
- * @brief Performs the necessary service functions when the ADC is switching external channels.
+ * Starts the frame timer at the provided period, interrupting on each tick. The 16 bit counter counts in whole
+ * microseconds, as many as needed for the period to fit, so long periods are rounded down to a multiple of that count.
+ *
+ * @param period uint32_t The period of the frame ticks in microseconds.
+ * @retval none
  */
-static void ADC_Machine_Service_Muxing(void);
+static void StartFrameTimer(uint32_t period) {
+	const uint32_t tick = (period + 0xFFFFU) / 0x10000U;
+	TIM_Cmd(SNAPSHOT_FRAME_TIM, DISABLE);
+	SNAPSHOT_FRAME_TIM->PSC = (uint16_t) (((frameTimerClock / 1000000U) * tick) - 1U);
+	SNAPSHOT_FRAME_TIM->ARR = (uint16_t) ((period / tick) - 1U);
+	SNAPSHOT_FRAME_TIM->CNT = 0U;
+	/* Load the prescaler, the update event this generates must not count as a frame tick */
+	TIM_GenerateEvent(SNAPSHOT_FRAME_TIM, TIM_EventSource_Update);
+	TIM_ClearITPendingBit(SNAPSHOT_FRAME_TIM, TIM_IT_Update | TIM_IT_CC1);
+	TIM_ITConfig(SNAPSHOT_FRAME_TIM, TIM_IT_CC1, DISABLE);
+	TIM_ITConfig(SNAPSHOT_FRAME_TIM, TIM_IT_Update, ENABLE);
+	TIM_Cmd(SNAPSHOT_FRAME_TIM, ENABLE);
+}
 
 /**
- * @internal
- * @brief Performs a conversion from a 32 bit word to a 3 byte array.
+ * Moves the interrupt of the frame timer, started for a paced sampling, from each tick to the timer's first compare
+ * channel, matching the settling time of the scan's first input before the tick. Woken from standby the ADC needs a
+ * full settling time for its first conversion, so waking it this much early has the conversion complete on the tick
+ * and the scans keep to the interval, while the ADC still sleeps for all of the rest of it. A lead as long as the
+ * interval leaves the wake up on the tick.
+ *
+ * @param none
+ * @retval none
  */
-static void ConvertCalibrationToBytes(uint8_t bytes[], uint32_t cal);
+static void ArmPacedWakeup(void) {
+	const uint32_t counts = (uint32_t) SNAPSHOT_FRAME_TIM->ARR + 1U;
+	const uint32_t tick = (pacedInterval + 0xFFFFU) / 0x10000U;
+	const uint32_t settling = (uint32_t) (ADS1256_GetSettlingTimeForRate(samplingInputs[0]->rate) * 1000.0f + 0.5f);
+	const uint32_t lead = (settling + tick - 1U) / tick;
+	TIM_SetCompare1(SNAPSHOT_FRAME_TIM, (lead < counts) ? (counts - lead) : 0U);
+	TIM_ClearITPendingBit(SNAPSHOT_FRAME_TIM, TIM_IT_CC1);
+	TIM_ITConfig(SNAPSHOT_FRAME_TIM, TIM_IT_Update, DISABLE);
+	TIM_ITConfig(SNAPSHOT_FRAME_TIM, TIM_IT_CC1, ENABLE);
+}
 
 /**
- * @internal
- * @brief Applies any calibration parameters to the ADC.
+ * Sends a status message with the time from the frame tick to the conversion of each input in the frame, in the
+ * order the scan visits them. The samples of a frame all carry the frame's time, so this is what places each of them
+ * within the frame.
+ *
+ * @param none
+ * @retval none
  */
-static void ApplyCalibrationParameters(Analog_Input_t* input);
+static void ReportSnapshotOffsets(void) {
+	char message[256];
+	int length = snprintf(message, sizeof(message), "Analog snapshot every %" PRIu32 " us. Offsets in us by input:",
+			snapshotPeriod);
+	for (uint_fast8_t i = 0U; i < scanLength; ++i) {
+		const Analog_Input_t* input = samplingInputs[i];
+		if ((input == NULL) || (length <= 0) || ((size_t) length >= sizeof(message))) {
+			continue;
+		}
+		length += snprintf(&message[length], sizeof(message) - length, " %i: %" PRIu32, input->physicalInput,
+				snapshotOffsets[i]);
+	}
+#ifdef ADC_STATE_MACHINE_DEBUG
+	printf("[ADC STATE MACHINE] %s\n\r", message);
+#endif
+	TelnetWriteStatusMessage(message);
+}
 
-/*--------------------------------------------------------------------------------------------------------*/
-/* PRIVATE FUNCTIONS */
-/*--------------------------------------------------------------------------------------------------------*/
+/**
+ * Deadline callback made once the expected duration of the calibration in progress has passed.
+ *
+ * @param none
+ * @retval none
+ */
+static void ADC_Machine_CalibrationDue(void) {
+	calibrationState.due = true;
+}
 
 /**
- * Retrieve a human readable string for the provided state.
+ * Starts an ADC calibration without waiting for it, scheduling a deadline for its expected duration so that the
+ * DRDY line is not polled before the ADC could possibly be finished.
  *
- * @param state ADC_State_t The state to retrieve a string for.
- * @retval const char* The human readable string representation.
+ * @param cmd ADS1256_Command_t The calibration command to send.
+ * @param duration float The expected duration of the calibration, in milliseconds.
+ * @param step CalibrationStep_t The calibration step which is being started.
+ * @retval none
  */
-static inline const char* ADCMachine_StringFromState(ADC_State_t machine_state) {
-	static const char* strings[] = { "ADC_UNINITIALIZED", "ADC_INITIALIZED", "ADC_CALIBRATING", "ADC_GAIN_CALIBRATING", "ADC_IDLE", "ADC_CHANNEL_SAMPLING",
-			"ADC_RESET", "ADC_EXTERNAL_MUXING" };
-	return strings[machine_state];
+static void StartCalibrationStep(ADS1256_Command_t cmd, float duration, CalibrationStep_t step) {
+	calibrationState.step = step;
+	calibrationState.due = false;
+	ADS1256_StartCalibration(cmd);
+	if (Timer_ScheduleDeadline(ADC_Machine_CalibrationDue, (uint32_t) (duration * 1000.0f)) == false) {
+		/* Without a deadline, fall back to polling the DRDY line */
+		calibrationState.due = true;
+	}
 }
 
 /**
- * Begins a new conversion for the provided input. This method is primarily used for multi input conversions.
+ * Abandons the calibration in progress, if any. The ADC can not be interrupted, so this blocks until it signals
+ * the calibration is finished.
  *
- * @param input Analog_Input to begin conversion for. It is assumed the switch has been made.
+ * @param none
+ * @retval none
  */
-static void BeginNextConversion(Analog_Input_t* input) {
-	/* Set sampling parameters */
-	ADS1256_SetDataRate(input->rate);
-	ADS1256_SetPGASetting(input->gain);
-	ADS1256_SetInputBufferSetting(input->buffer);
-	ApplyCalibrationParameters(input);
-	ADS1256_Wakeup();
-	input->timestamps[input->bufferWriteIdx] = GetLocalTime();
+static void AbortCalibrationStep(void) {
+	if (calibrationState.step != CAL_STEP_CONFIGURE) {
+		Timer_CancelDeadline(ADC_Machine_CalibrationDue);
+		ADS1256_WaitUntilDataReady(false);
+		ADS1256_FinishCalibration();
+		calibrationState.step = CAL_STEP_CONFIGURE;
+	}
 }
 
 /**
- * Performs the necessary functions to calibrate the ADC and populate its calibration tables.
+ * Performs the necessary functions to calibrate the ADC and populate its calibration tables. Each set of settings is
+ * calibrated in steps, returning to the program loop while the ADC is busy so that networking continues to run.
  *
  * @param none
  * @retval none
@@ -202,19 +1430,30 @@ static void ADC_Machine_Service_Calibrating(void) {
 	static ADS1256_BUFFER_t buffers[] = { ADS1256_BUFFER_ENABLED, ADS1256_BUFFER_DISABLED };
 
 	if (calibrationState.finished == false) {
-		if (calibrationState.gain_index < NUM_PGA_SETTINGS) {
+		if (calibrationState.step != CAL_STEP_CONFIGURE) {
+			if ((calibrationState.due == false) || (ADS1256_IsDataReady(false) == false)) {
+				/* The ADC is still calibrating */
+				return;
+			}
+			ADS1256_FinishCalibration();
+			if (calibrationState.step == CAL_STEP_SELF) {
+				Tekdaqc_SetBaseGainCalibration(ADS1256_GetGainCalSetting(), rates[calibrationState.rate_index],
+						gains[calibrationState.gain_index], buffers[calibrationState.buffer_index]);
+				StartCalibrationStep(ADS1256_SYSOCAL, ADS1256_GetOffsetCalTime(), CAL_STEP_OFFSET);
+				return;
+			}
+			Tekdaqc_SetOffsetCalibration(ADS1256_GetOffsetCalSetting(), rates[calibrationState.rate_index],
+					gains[calibrationState.gain_index], buffers[calibrationState.buffer_index++]);
+			calibrationState.finished_count++;
+			calibrationState.step = CAL_STEP_CONFIGURE;
+		} else if (calibrationState.gain_index < NUM_PGA_SETTINGS) {
 			if (calibrationState.rate_index < NUM_SAMPLE_RATES) {
 				if (calibrationState.buffer_index < NUM_BUFFER_SETTINGS) {
 					ADS1256_SetInputBufferSetting(buffers[calibrationState.buffer_index]);
 					ADS1256_SetDataRate(rates[calibrationState.rate_index]);
 					ADS1256_SetPGASetting(gains[calibrationState.gain_index]);
-					ADS1256_CalibrateSelf();
-					Tekdaqc_SetBaseGainCalibration(ADS1256_GetGainCalSetting(), rates[calibrationState.rate_index],
-							gains[calibrationState.gain_index], buffers[calibrationState.buffer_index]);
-					ADS1256_CalibrateSystem_Offset();
-					Tekdaqc_SetOffsetCalibration(ADS1256_GetOffsetCalSetting(), rates[calibrationState.rate_index],
-							gains[calibrationState.gain_index], buffers[calibrationState.buffer_index++]);
-					calibrationState.finished_count++;
+					StartCalibrationStep(ADS1256_SELFCAL, ADS1256_GetSelfCalTime(), CAL_STEP_SELF);
+					return;
 				} else {
 					calibrationState.buffer_index = 0;
 					calibrationState.rate_index++;
@@ -257,30 +1496,29 @@ static void ADC_Machine_Service_GainCalibrating(void) {
  * @retval none
  */
 static void ADC_Machine_Service_Idle(void) {
+	if (burstCapture.downloading == true) {
+		ServiceBurstCaptureDownload();
+	}
+	if (AnalogSpectrum_IsBusy() == true) {
+		AnalogSpectrum_Service();
+	}
 	/* If a temperature reading is ready, update the board temperature */
 	if (ADS1256_IsDataReady(false)) {
 		Analog_Input_t* input = GetAnalogInputByNumber(IN_COLD_JUNCTION);
 		waitingOnTemp = false;
 		/* We need to read it */
-		input->values[input->bufferWriteIdx] = ADS1256_GetMeasurement();
+		int32_t value = ADS1256_GetMeasurement();
 		/* Update temperature */
-		updateBoardTemperature(input, input->values[input->bufferWriteIdx]);
-		++(input->bufferWriteIdx);
+		updateBoardTemperature(input, value);
+		lastColdJunctionTime = GetLocalTime();
+		scansSinceColdJunction = 0U;
+		coldJunctionStale = false;
+		UpdateGainCorrections(); /* The gain calibration is temperature dependent */
+		UpdateAnalogInputColdJunctions(getBoardTemperature());
+		StoreColdJunctionSample(input, value, lastColdJunctionTime);
 #ifdef BOARD_TEMPERATURE_DEBUG
 		printf("[ADC STATE MACHINE] Cold junction temperature sample is complete.\n\r");
 #endif
-		/* Check the buffer positions for errors/roll over */
-		if (((input->bufferWriteIdx - 1U) == input->bufferReadIdx) && ((input->bufferWriteIdx - 1U) > 0U)) {
-			/* This means we wrote over some data */
-#ifdef BOARD_TEMPERATURE_DEBUG
-			printf("[ADC STATE MACHINE] Cold junction sampling overwrote data before it could be read.\n\r");
-#endif
-			TelnetWriteErrorMessage("Cold junction sampling overwrote data before it could be read.");
-		}
-		if (input->bufferWriteIdx == ANALOG_INPUT_BUFFER_SIZE) {
-			/* We have reached the end of the buffer and need to start writing to the beginning */
-			input->bufferWriteIdx = 0U;
-		}
 	}
 }
 
@@ -291,77 +1529,401 @@ static void ADC_Machine_Service_Idle(void) {
  * @retval none
  */
 static void ADC_Machine_Service_Sampling(void) {
-	/* Check if data is ready */
-	if (ADS1256_IsDataReady(false)) {
-		/* We need to read it */
-		uint8_t writeIndex = samplingInputs[currentSamplingInput]->bufferWriteIdx;
-		samplingInputs[currentSamplingInput]->values[writeIndex] = ADS1256_GetMeasurement();
-		samplingInputs[currentSamplingInput]->bufferWriteIdx = (writeIndex + 1) % ANALOG_INPUT_BUFFER_SIZE;
-		if (samplingInputs[currentSamplingInput]->bufferWriteIdx == samplingInputs[currentSamplingInput]->bufferReadIdx) {
-			/* Check the buffer positions for errors/roll over */
-#ifdef ADC_STATE_MACHINE_DEBUG
-			printf("[ADC STATE MACHINE] Analog sampling overwrote data before it could be read.\n\r");
-#endif
-			TelnetWriteErrorMessage("Analog sampling overwrote data before it could be read.");
-			/* Buffer is full, overwrite */
-			samplingInputs[currentSamplingInput]->bufferReadIdx = (samplingInputs[currentSamplingInput]->bufferReadIdx + 1) % ANALOG_INPUT_BUFFER_SIZE;
+	ReportSampleOverruns(false);
+	if (overflowPolicy == ADC_OVERFLOW_DROP_OLDEST) {
+		DiscardOldestSamples();
+	}
+	if ((samplingPaused == true) && (hasSampleRoom(samplingInputs[currentSamplingInput], OVERFLOW_HEADROOM) == true)) {
+		/* The single channel run was held for space, resume reading its conversions */
+		samplingPaused = false;
+		ADS1256_EnableDataReadyInterrupt(&ADC_Machine_DataReadyCallback);
+	}
+	if ((backgroundCalibration.active == true) && (ServiceBackgroundCalibration() == true)) {
+		/* Sampling resumes once the calibration is done, keep draining what was collected */
+		DrainAnalogInputs();
+		return;
+	}
+	if ((sampleReady == true) && (numberSamplingInputs > 1) && (overflowPolicy == ADC_OVERFLOW_PAUSE)
+			&& (AnalogTrigger_GetState() == ANALOG_TRIGGER_IDLE)) {
+		bool wraps = false;
+		Analog_Input_t* next = PeekNextScanInput(&wraps);
+		if ((next != NULL) && (hasSampleRoom(next, ANALOG_SAMPLE_BLOCK_SIZE) == false)) {
+			/* Hold the scan before the next input until the writers have made room in its buffer */
+			DrainAnalogInputs();
+			return;
 		}
-
-		ADS1256_Sync(true); /*Halt conversion */
-		/* Select the next input */
-
+	}
+	/* Check if the DRDY interrupt has stored a sample */
+	if (sampleReady == true) {
+		sampleReady = false;
 		if (numberSamplingInputs > 1) {
-			Analog_Input_t* input = NULL;
+			/* The interrupt masked itself, make sure its read has released the bus */
+			ADS1256_DisableDataReadyInterrupt();
+			ADS1256_Sync(true); /*Halt conversion */
 			Analog_Input_t* current = samplingInputs[currentSamplingInput];
-			while (input == NULL || input->added == CHANNEL_NOTADDED) { /* Keep searching until we find a non-null input */
-				++currentSamplingInput;
-				if (currentSamplingInput == NUM_ANALOG_INPUTS) {
-					/* We have reached the end of a set */
-					currentSamplingInput = 0U; /* Reset to the start */
+			if (sensorCheck.converting == true) {
+				FinishSensorCheck();
+			} else if ((sensorCheck.input == current) && (isSampleCountReached() == false)) {
+				/* Check the input's sensor before the scan moves on */
+				StartSensorCheck();
+				DrainAnalogInputs();
+				return;
+			}
+			/* Select the next input, the plan holds no empty entries and inputs cannot be removed while sampling */
+			bool scanComplete = false;
+			++currentSamplingInput;
+			if (currentSamplingInput >= scanLength) {
+				/* We have reached the end of a set */
+				currentSamplingInput = 0U; /* Reset to the start */
 #ifdef ADC_STATE_MACHINE_DEBUG
-					printf("[ADC STATE MACHINE] Sample %" PRIi32 " of %" PRIi32 " is complete.\n\r", SampleCurrent + 1, SampleTotal);
+				printf("[ADC STATE MACHINE] Sample %" PRIu64 " of %" PRIu64 " is complete.\n\r", SampleCurrent + 1U, SampleTotal);
 #endif
-					++SampleCurrent; /* Increment the sample counter */
-				}
-				input = samplingInputs[currentSamplingInput];
+				++SampleCurrent; /* Increment the sample counter */
+				++scansSinceColdJunction;
+				scanComplete = true;
 			}
-			if (input != current) { /* Prevent unnecessary external muxings */
-				SelectAnalogInput(input); /* Select the input */
-			} else {
+			Analog_Input_t* input = samplingInputs[currentSamplingInput];
+			if ((scanComplete == true) && (sensorCheck.input == NULL) && (isSensorCheckDue() == true)) {
+				/* Made after the input's next sample, the same scan position never waits more than a scan */
+				sensorCheck.input = NextSensorCheckInput();
+			}
+			if (isSampleCountReached() == false) {
+				if ((scanComplete == true) && (isBackgroundCalibrationDue() == true)) {
+					/* Calibrate between scans, the next scan starts once it is done */
+					StartBackgroundCalibration();
+				} else if (input != current) { /* Prevent unnecessary external muxings */
+					SelectAnalogInput(input); /* Select the input */
+					if (CurrentState == ADC_CHANNEL_SAMPLING) {
+						/* No external muxing was required, begin the next sample immediately */
+						BeginNextConversion(input);
+					}
+				} else {
 #ifdef ADC_STATE_MACHINE_DEBUG
-				printf("[ADC STATE MACHINE] Multi-channel sampling tried to select the currently selected input. Ignoring...\n\r");
+					printf("[ADC STATE MACHINE] Multi-channel sampling tried to select the currently selected input. Ignoring...\n\r");
 #endif
-				ADS1256_Wakeup(); /* Begin the next sample */
-				/* Save the real time clock entry for the sample */
-				samplingInputs[currentSamplingInput]->timestamps[samplingInputs[currentSamplingInput]->bufferWriteIdx] = GetLocalTime();
+					StartConversion(input); /* Begin the next sample */
+				}
+				if ((scanComplete == true) && (snapshotPeriod != 0U) && (SampleCurrent == 1U)) {
+					/* The first frame shows where in a frame each input is converted */
+					ReportSnapshotOffsets();
+				}
 			}
 		} else {
-			/* We are single channel sampling */
+			/* We are single channel sampling, the interrupt keeps the count */
+#ifdef ADC_STATE_MACHINE_DEBUG
+			printf("[ADC STATE MACHINE] Sample %" PRIu64 " of %" PRIu64 " is complete.\n\r", SampleCurrent, SampleTotal);
+#endif
+			if (sensorCheck.converting == true) {
+				/* Resume streaming the input once its sensor check is done */
+				ADS1256_DisableDataReadyInterrupt();
+				ADS1256_Sync(true);
+				FinishSensorCheck();
+				if (isSampleCountReached() == false) {
+					StartConversion(samplingInputs[currentSamplingInput]);
+				}
+			} else if ((isSampleCountReached() == false) && (isBackgroundCalibrationDue() == true)) {
+				/* A lone input has no scan boundary, calibrate between two of its samples */
+				ADS1256_DisableDataReadyInterrupt();
+				ADS1256_Sync(true);
+				StartBackgroundCalibration();
+			} else if ((isSampleCountReached() == false) && (isSensorCheckDue() == true)) {
+				/* Check the sensor between two of the input's samples */
+				sensorCheck.input = NextSensorCheckInput();
+				if (sensorCheck.input != NULL) {
+					ADS1256_DisableDataReadyInterrupt();
+					ADS1256_Sync(true);
+					StartSensorCheck();
+				}
+			} else if ((isSampleCountReached() == false) && (pacedInterval != 0U)) {
+				/* Wait in standby for the next scan tick */
+				ADS1256_DisableDataReadyInterrupt();
+				StartConversion(samplingInputs[currentSamplingInput]);
+			}
+		}
+	}
+	if (isSampleCountReached() == true) {
+		/* We are done sampling, or have been halted, write out any remaining data and return to idle state */
+		ADS1256_DisableDataReadyInterrupt();
+		DrainAnalogInputs();
+		if (isAnalogOutputPending() == true) {
+			/* Finish sending the remaining data of every input before going idle */
+			return;
+		}
+		ReportSampleOverruns(true);
+		if ((snapshotPeriod != 0U) && (snapshotMissedFrames != 0U)) {
+			char message[96];
+			snprintf(message, sizeof(message), "Analog snapshot missed %" PRIu32 " frames, the scan is longer than the frame period.",
+					snapshotMissedFrames);
+			TelnetWriteStatusMessage(message);
+		}
+		if ((pacedInterval != 0U) && (pacedMissedScans != 0U)) {
+			char message[96];
+			snprintf(message, sizeof(message), "Paced sampling missed %" PRIu32 " scans, the scan is longer than the interval.",
+					pacedMissedScans);
+			TelnetWriteStatusMessage(message);
+		}
+		ADC_Machine_Idle();
+#ifdef ADC_STATE_MACHINE_DEBUG
+		printf("[ADC STATE MACHINE] Channel sampling is complete.\n\r");
+#endif
+		TelnetWriteStatusMessage("ADC Channel sampling completed.");
+		/* We are done, return */
+		CompletedADCSampling();
+		return;
+	}
+	/* Write out any data the interrupt has collected */
+	DrainAnalogInputs();
+}
+
+/**
+ * Services the sampling state during a burst capture. Nothing is written out while the capture runs, so all this
+ * does is return the machine to idle once the capture is complete or has been halted, reporting what was captured.
+ *
+ * @param none
+ * @retval none
+ */
+static void ADC_Machine_Service_BurstCapture(void) {
+	if (isSampleCountReached() == false) {
+		return;
+	}
+	ADS1256_DisableDataReadyInterrupt();
+	ADC_Machine_Idle();
+	char message[128];
+	snprintf(message, sizeof(message), "Burst capture completed, Input: %" PRIu8 ", Samples: %" PRIu32 ", Duration: %" PRIu64
+			" us.", (uint8_t) burstCapture.input, burstCapture.count,
+			(burstCapture.count > 0U) ? (burstCapture.end - burstCapture.start) : 0U);
+	TelnetWriteStatusMessage(message);
+	CompletedADCSampling();
+}
+
+/**
+ * Sends the next codes of a burst capture download to the data connection, up to BURST_CAPTURE_FRAMES_PER_SERVICE
+ * capture records at a time so the idle state is not held up. The download resumes from where it stopped when the
+ * connection is busy, and ends early if there is no connection to send to.
+ *
+ * @param none
+ * @retval none
+ */
+static void ServiceBurstCaptureDownload(void) {
+	for (uint_fast8_t i = 0U; (i < BURST_CAPTURE_FRAMES_PER_SERVICE) && (burstCapture.downloading == true); ++i) {
+		uint32_t written = 0U;
+		const uint32_t index = burstCapture.downloaded;
+		const WriteStatus_t status = WriteAnalogCaptureBinary(burstCapture.input, index,
+				&(&_sccmfree)[index * ANALOG_SAMPLE_VALUE_SIZE], burstCapture.count - index, &written);
+		if (status == WRITE_BUSY) {
+			break;
+		}
+		burstCapture.downloaded += written;
+		if ((status != WRITE_OK) || (burstCapture.downloaded >= burstCapture.count)) {
+			burstCapture.downloading = false;
+			char message[96];
+			snprintf(message, sizeof(message), "Burst capture download %s, Samples: %" PRIu32 " of %" PRIu32 ".",
+					(status == WRITE_OK) ? "completed" : "failed", burstCapture.downloaded, burstCapture.count);
+			TelnetWriteStatusMessage(message);
+		}
+	}
+}
+
+/**
+ * Sends a status message summarizing the samples dropped since the last one, with the number each input has dropped
+ * in the current sampling. Reports are rate limited to one every OVERRUN_REPORT_INTERVAL_US, so an overloaded
+ * connection is not given a message for every dropped sample on top of the samples it cannot keep up with.
+ *
+ * @param force bool TRUE to report any unreported drops regardless of the interval, as when sampling completes.
+ * @retval none
+ */
+static void ReportSampleOverruns(bool force) {
+	const uint32_t total = sampleOverrunCount;
+	if (total == reportedOverrunCount) {
+		return;
+	}
+	const uint64_t now = GetLocalTime();
+	if ((force == false) && ((now - lastOverrunReport) < OVERRUN_REPORT_INTERVAL_US)) {
+		return;
+	}
+	char message[128];
+	int length = snprintf(message, sizeof(message), "Analog sampling dropped %" PRIu32 " samples. Dropped by input:",
+			total - reportedOverrunCount);
+	for (uint_fast8_t i = 0U; i < numberSamplingInputs; ++i) {
+		Analog_Input_t* input = samplingInputs[i];
+		if ((input == NULL) || (input->overruns == input->reportedOverruns)) {
+			continue;
+		}
+		input->reportedOverruns = input->overruns;
+		if ((length > 0) && ((size_t) length < sizeof(message))) {
+			length += snprintf(&message[length], sizeof(message) - length, " %i: %" PRIu32, input->physicalInput,
+					input->overruns);
+		}
+	}
 #ifdef ADC_STATE_MACHINE_DEBUG
-			printf("[ADC STATE MACHINE] Sample %" PRIi32 " of %" PRIi32 " is complete.\n\r", SampleCurrent + 1, SampleTotal);
+	printf("[ADC STATE MACHINE] %s\n\r", message);
 #endif
-			++SampleCurrent; /* Increment the sample count */
-			ADS1256_Wakeup(); /* Begin the next sample */
-			/* Save the real time clock entry for the sample */
-			samplingInputs[currentSamplingInput]->timestamps[samplingInputs[currentSamplingInput]->bufferWriteIdx] = GetLocalTime();
+	TelnetWriteStatusMessage(message);
+	reportedOverrunCount = total;
+	lastOverrunReport = now;
+}
+
+/**
+ * Determines if an input's buffer has at least the given number of free samples. An input without a buffer, such as
+ * in statistics mode, never lacks room since nothing is stored in it.
+ *
+ * @param input const Analog_Input_t* The input to check.
+ * @param room uint32_t The number of free samples needed.
+ * @retval bool TRUE if there is room.
+ */
+static bool hasSampleRoom(const Analog_Input_t* input, uint32_t room) {
+	const uint32_t capacity = input->samples.mask + 1U;
+	if ((input->values == NULL) || (capacity <= room)) {
+		return true;
+	}
+	return ((capacity - RingBuffer_Count(&input->samples)) >= room);
+}
+
+/**
+ * Writes out the data the sampling inputs have collected, serving them round robin so that no input waits on another
+ * which produces faster. Each input with data is given one write of up to SINGLE_ANALOG_WRITE_COUNT samples, or its
+ * statistics window, per turn, and turns continue until every buffer is empty or the drain's time budget is spent.
+ *
+ * The budget follows the load: the drain may take DRAIN_LOOP_SHARE times as long as the rest of the main loop took
+ * since the last one, no less than ADC_OUTPUT_BUDGET_MIN_US and no more than the output budget set for the machine.
+ * A multi-channel scan needs the main loop to switch inputs, so the drain also ends as soon as a conversion is
+ * waiting for it. The connection's capacity limits the drain as well: a busy connection ends it, and the input it
+ * refused is served first on the next one, as is the input after the last one served when the budget runs out.
+ * Nothing is written while a capture is holding its history.
+ *
+ * @param none
+ * @retval none
+ */
+static void DrainAnalogInputs(void) {
+	if ((AnalogTrigger_IsHolding() == true) || (numberSamplingInputs == 0U)) {
+		return;
+	}
+	const uint64_t start = GetLocalTime();
+	uint64_t budget = ADC_OUTPUT_BUDGET_MIN_US;
+	if (lastDrainEnd != 0U) {
+		budget = (start - lastDrainEnd) * DRAIN_LOOP_SHARE;
+		if (budget < ADC_OUTPUT_BUDGET_MIN_US) {
+			budget = ADC_OUTPUT_BUDGET_MIN_US;
+		} else if (budget > outputBudget) {
+			budget = outputBudget;
+		}
+	}
+	/* A conversion already waiting is being held back on purpose, as by the pause policy */
+	const bool waiting = (numberSamplingInputs == 1U) || (sampleReady == true);
+	bool draining = true;
+	bool progress = true;
+	while ((draining == true) && (progress == true)) {
+		progress = false;
+		for (uint_fast8_t i = 0U; i < numberSamplingInputs; ++i) {
+			if (drainPosition >= numberSamplingInputs) {
+				drainPosition = 0U;
+			}
+			Analog_Input_t* input = samplingInputs[drainPosition];
+			if ((input != NULL) && ((RingBuffer_IsEmpty(&input->samples) == false) || (input->windowReady == true))) {
+				const uint32_t stored = RingBuffer_Count(&input->samples);
+				const bool window = input->windowReady;
+				if (WriteAnalogInput(input) == WRITE_BUSY) {
+					draining = false;
+					break;
+				}
+				/* A write without a writer consumes nothing, which must not keep the drain going */
+				if ((RingBuffer_Count(&input->samples) != stored) || (input->windowReady != window)) {
+					progress = true;
+				}
+			}
+			++drainPosition;
+			if (((GetLocalTime() - start) >= budget) || ((waiting == false) && (sampleReady == true))) {
+				draining = false;
+				break;
+			}
+		}
+	}
+	/* Power windows come at most a few a second, so any waiting are written once the samples are done */
+	AnalogPowerResult_t result;
+	while ((draining == true) && (AnalogPower_PeekResult(&result) == true)) {
+		if (WriteAnalogPowerResult(&result) == WRITE_BUSY) {
+			break;
+		}
+		/* Either sent or undeliverable, in both cases the window is consumed */
+		AnalogPower_ReleaseResult(result.channel);
+	}
+	/* Math results are written after the samples of their scan */
+	const AnalogMathResult_t* results;
+	uint32_t count;
+	while ((draining == true) && ((count = AnalogMath_PeekResults(&results)) > 0U)) {
+		uint32_t written = count;
+		const WriteStatus_t status = WriteAnalogMathResults(results, count, &written);
+		if (status == WRITE_BUSY) {
+			break;
+		}
+		/* Either sent or undeliverable, in both cases the results are consumed */
+		AnalogMath_ReleaseResults(written);
+	}
+	/* As are the digital states of the scans */
+	const AnalogMixedState_t* states;
+	while ((draining == true) && ((count = AnalogMixed_PeekStates(&states)) > 0U)) {
+		uint32_t written = count;
+		if (WriteAnalogMixedStates(states, count, &written) == WRITE_BUSY) {
+			break;
+		}
+		AnalogMixed_ReleaseStates(written);
+	}
+	/* And their auxiliary readings */
+	const AnalogAuxState_t* readings;
+	while ((draining == true) && ((count = AnalogAux_PeekStates(&readings)) > 0U)) {
+		uint32_t written = count;
+		if (WriteAnalogAuxStates(readings, count, &written) == WRITE_BUSY) {
+			break;
+		}
+		AnalogAux_ReleaseStates(written);
+	}
+	lastDrainEnd = GetLocalTime();
+}
+
+/**
+ * Determines if any of the sampling inputs still has samples or a statistics window, any power channel a window, any
+ * math channel a result or any scan a digital state or auxiliary readings waiting to be written.
+ *
+ * @param none
+ * @retval bool TRUE if there is data left to write.
+ */
+static bool isAnalogOutputPending(void) {
+	for (uint_fast8_t i = 0U; i < numberSamplingInputs; ++i) {
+		const Analog_Input_t* input = samplingInputs[i];
+		if ((input != NULL) && ((RingBuffer_IsEmpty(&input->samples) == false) || (input->windowReady == true))) {
+			return true;
 		}
-		if ((SampleCurrent == SampleTotal) && !((numberSamplingInputs > 1) && SampleCurrent == 0)) {
-			/* The equality check is because we incremented already */
-			/* We are done sampling, write out any remaining data and return to idle state */
-			WriteAnalogInput(samplingInputs[currentSamplingInput]);
-			ADC_Machine_Idle();
-#ifdef ADC_STATE_MACHINE_DEBUG
-			printf("[ADC STATE MACHINE] Channel sampling is complete.\n\r");
-#endif
-			TelnetWriteStatusMessage("ADC Channel sampling completed.");
-			/* We are done, return */
-			CompletedADCSampling();
-			return;
+	}
+	return ((AnalogPower_IsPending() == true) || (AnalogMath_IsPending() == true) || (AnalogMixed_IsPending() == true)
+			|| (AnalogAux_IsPending() == true));
+}
+
+/**
+ * Applies the drop oldest overflow policy. The DRDY interrupt cannot remove samples from a buffer the writers are
+ * reading, so instead the main loop discards the oldest samples of each buffer which has less than OVERFLOW_HEADROOM
+ * free, keeping room for the newest. The discarded samples are counted as overruns and the first sample left is
+ * flagged as following a gap. Nothing is discarded while a capture is holding its history.
+ *
+ * @param none
+ * @retval none
+ */
+static void DiscardOldestSamples(void) {
+	if (AnalogTrigger_IsHolding() == true) {
+		return;
+	}
+	for (uint_fast8_t i = 0U; i < numberSamplingInputs; ++i) {
+		Analog_Input_t* input = samplingInputs[i];
+		if ((input == NULL) || (hasSampleRoom(input, OVERFLOW_HEADROOM) == true)) {
+			continue;
 		}
-	} else {
-		/* There is nothing to read yet, write some data */
-		/* TODO: This needs to handle other inputs most likely */
-		WriteAnalogInput(samplingInputs[currentSamplingInput]);
+		const uint32_t excess = OVERFLOW_HEADROOM - ((input->samples.mask + 1U) - RingBuffer_Count(&input->samples));
+		RingBuffer_Release(&input->samples, excess);
+		input->flags[RingBuffer_PeekIndex(&input->samples, 0U)] |= ANALOG_SAMPLE_FLAG_GAP;
+		/* The counts are shared with the DRDY interrupt */
+		__disable_irq();
+		input->overruns += excess;
+		sampleOverrunCount += excess;
+		__enable_irq();
 	}
 }
 
@@ -374,36 +1936,39 @@ static void ADC_Machine_Service_Sampling(void) {
  */
 static void ADC_Machine_Service_Muxing(void) {
 	Analog_Input_t* input = GetAnalogInputByNumber(IN_COLD_JUNCTION);
-	if (waitingOnTemp == false) {
+	if ((waitingOnTemp == false) && (isColdJunctionDue() == false)) {
+		/* The board temperature is fresh enough, program the next input while the multiplexer settles */
+		Analog_Input_t* next = samplingInputs[currentSamplingInput];
+		if (muxSettingsLoaded == false) {
+			LoadConversionSettings(next);
+			muxSettingsLoaded = true;
+			/* The settle interrupt starts the conversion unless the switch settled while the settings were loaded */
+			if (ScheduleAfterExternalMuxing(&ADC_Machine_MuxSettled) == false) {
+				ADC_Machine_MuxSettled();
+			}
+		}
+	} else if (waitingOnTemp == false) {
 		/* We need to begin a temperature sample */
 		ADS1256_Sync(true);
 		SelectColdJunctionInput();
 		/* Set sampling parameters */
-		ADS1256_SetDataRate(input->rate);
-		ADS1256_SetPGASetting(input->gain);
-		ADS1256_SetInputBufferSetting(input->buffer);
-		ApplyCalibrationParameters(input);
+		LoadConversionSettings(input);
 		ADS1256_Wakeup();
-		input->timestamps[input->bufferWriteIdx] = GetLocalTime();
+		coldJunctionStartTime = GetLocalTime();
 		waitingOnTemp = true;
 	} else {
 		/* We are waiting for a temperature sample to complete */
 		if (ADS1256_IsDataReady(false)) {
 			/* We need to read it */
-			uint8_t writeIndex = input->bufferWriteIdx;
-			input->values[writeIndex] = ADS1256_GetMeasurement();
+			int32_t value = ADS1256_GetMeasurement();
 			/* Update temperature */
-			updateBoardTemperature(input, input->values[writeIndex]);
-			input->bufferWriteIdx = (writeIndex + 1) % ANALOG_INPUT_BUFFER_SIZE;
-			if (input->bufferWriteIdx == input->bufferReadIdx) {
-				/* Check the buffer positions for errors/roll over */
-/*#ifdef ADC_STATE_MACHINE_DEBUG
-				printf("[ADC STATE MACHINE] Analog sampling overwrote data before it could be read.\n\r");
-#endif
-				TelnetWriteErrorMessage("Analog sampling overwrote data before it could be read.");*/
-				/* Buffer is full, overwrite */
-				input->bufferReadIdx = (input->bufferReadIdx + 1) % ANALOG_INPUT_BUFFER_SIZE;
-			}
+			updateBoardTemperature(input, value);
+			lastColdJunctionTime = GetLocalTime();
+			scansSinceColdJunction = 0U;
+			coldJunctionStale = false;
+			UpdateGainCorrections(); /* The gain calibration is temperature dependent */
+			UpdateAnalogInputColdJunctions(getBoardTemperature());
+			StoreColdJunctionSample(input, value, coldJunctionStartTime);
 
 #ifdef BOARD_TEMPERATURE_DEBUG
 			printf("[ADC STATE MACHINE] Cold junction temperature sample is complete.\n\r");
@@ -413,27 +1978,78 @@ static void ADC_Machine_Service_Muxing(void) {
 		if ((PreviousState == ADC_CHANNEL_SAMPLING) && (isExternalMuxingComplete() == true)) {
 			/* We need to select external inputs on the internal multiplexer */
 			ResetSelectedInput();
+			samplingInputs[currentSamplingInput]->pendingFlags |= ANALOG_SAMPLE_FLAG_MUX_SWITCH;
+			ADC_Machine_EnterState(PreviousState); /* Return the state to its previous value */
 			/* We need to begin the next conversion */
 			BeginNextConversion(samplingInputs[currentSamplingInput]);
-			CurrentState = PreviousState; /* Return the state to its previous value */
 		} else if (((PreviousState == ADC_IDLE) || (PreviousState == ADC_CALIBRATING) || (PreviousState == ADC_GAIN_CALIBRATING))
 			&& (isExternalMuxingComplete() == true)) {
-			CurrentState = PreviousState;
+			ADC_Machine_EnterState(PreviousState);
 		}
 	}
 }
 
-static void ConvertCalibrationToBytes(uint8_t bytes[], uint32_t cal) {
-	bytes[0] = cal & 0xFF;
-	bytes[1] = (cal & 0xFF00) >> 8;
-	bytes[2] = (cal & 0xFF0000) >> 16;
+/**
+ * Marks the calibration values of every input's register image as stale, so they are looked up again the next time
+ * each input is converted. Called whenever the board temperature or the ADC's calibration has changed.
+ *
+ * @param none
+ * @retval none
+ */
+static void InvalidateCalibration(void) {
+	++calibrationVersion;
+	if (calibrationVersion == 0U) {
+		calibrationVersion = 1U; /* 0 marks an image which has never been calibrated */
+	}
 }
 
+/**
+ * Updates the offset and gain calibration values of the provided input's register image. The values are only
+ * looked up when the calibration has changed since they were last filled in. Changes of the board temperature alone
+ * do not rewrite the image, they are followed by the input's gain correction instead.
+ *
+ * @param input Analog_Input_t* The input to update calibration parameters for.
+ * @retval none
+ */
 static void ApplyCalibrationParameters(Analog_Input_t* input) {
-	ConvertCalibrationToBytes(scratch_bytes, Tekdaqc_GetOffsetCalibration(input->rate, input->gain, input->buffer));
-	ADS1256_SetOffsetCalSetting(scratch_bytes);
-	ConvertCalibrationToBytes(scratch_bytes, Tekdaqc_GetGainCalibration(input->rate, input->gain, input->buffer, getBoardTemperature()));
-	ADS1256_SetGainCalSetting(scratch_bytes);
+	if (input->calibrationVersion == calibrationVersion) {
+		return;
+	}
+	input->loadedGain = Tekdaqc_GetGainCalibration(input->rate, input->gain, input->buffer, getBoardTemperature());
+	ADS1256_SetRegisterImageCalibration(&input->registers, Tekdaqc_GetOffsetCalibration(input->rate, input->gain, input->buffer),
+			input->loadedGain);
+	input->gainCorrection = ANALOG_GAIN_CORRECTION_UNITY;
+	input->calibrationVersion = calibrationVersion;
+}
+
+/**
+ * Updates the gain correction of every input whose register image is calibrated, so that its samples follow the
+ * gain calibration at the current board temperature without the image, and so the ADC's FSC register, being
+ * rewritten. The ADC's output scales with the FSC value, so the correction is the ratio of the gain calibration
+ * now to the one in the image. Called from the main loop whenever the board temperature is updated, the DRDY
+ * interrupt applies the correction to each sample.
+ *
+ * @param none
+ * @retval none
+ */
+static void UpdateGainCorrections(void) {
+	const float temperature = getBoardTemperature();
+	for (uint_fast8_t i = 0U; i < NUM_ANALOG_INPUTS; ++i) {
+		Analog_Input_t* input = GetAnalogInputByNumber(i);
+		if ((input == NULL) || (input->added != CHANNEL_ADDED) || (input->calibrationVersion != calibrationVersion)
+				|| (input->loadedGain == 0U)) {
+			continue;
+		}
+		const ADS1256_PGA_t pga = input->gain;
+		const uint32_t gain = Tekdaqc_GetGainCalibration(input->rate, pga, input->buffer, temperature);
+		const uint32_t primask = __get_PRIMASK();
+		__disable_irq();
+		/* Auto-ranging may have changed the gain meanwhile, leaving the image to be calibrated afresh */
+		if ((input->gain == pga) && (input->calibrationVersion == calibrationVersion)) {
+			input->gainCorrection = (int32_t) ((((uint64_t) gain) << ANALOG_GAIN_CORRECTION_BITS) / input->loadedGain);
+		}
+		__set_PRIMASK(primask);
+	}
 }
 
 /*--------------------------------------------------------------------------------------------------------*/
@@ -450,7 +2066,7 @@ void ADC_Machine_Create(void) {
 #ifdef ADC_STATE_MACHINE_DEBUG
 	printf("[ADC STATE MACHINE] Creating ADC state machine.\n\r");
 #endif
-	CurrentState = ADC_UNINITIALIZED;
+	ADC_Machine_EnterState(ADC_UNINITIALIZED);
 }
 
 /**
@@ -471,6 +2087,8 @@ void ADC_Machine_Init(void) {
 #endif
 		/* Initialize the ADS1256 */
 		ADS1256_Init();
+		ADS1256_SetDataLatchedCallback(&ADC_Machine_DataLatchedCallback);
+		FrameTimerInit();
 
 		/* Initialize the count variables */
 		SampleTotal = 0U;
@@ -483,9 +2101,10 @@ void ADC_Machine_Init(void) {
 		calibrationState.gain_index = 0U;
 		calibrationState.rate_index = 0U;
 		calibrationState.finished = false;
+		calibrationState.step = CAL_STEP_CONFIGURE;
 
 		/* Update the state */
-		CurrentState = ADC_INITIALIZED;
+		ADC_Machine_EnterState(ADC_INITIALIZED);
 	}
 }
 
@@ -506,7 +2125,8 @@ void ADC_Calibrate(void) {
 		printf("[ADC STATE MACHINE] Moving to state ADC_CALIBRATING.\n\r");
 #endif
 		/* Update the state */
-		CurrentState = ADC_CALIBRATING;
+		ADC_Machine_EnterState(ADC_CALIBRATING);
+		InvalidateCalibration();
 
 		/* Update the finished state */
 		calibrationState.finished = false;
@@ -535,7 +2155,8 @@ void ADC_GainCalibrate(PhysicalAnalogInput_t input) {
 		printf("[ADC STATE MACHINE] Moving to state ADC_CALIBRATING.\n\r");
 #endif
 		/* Update the state */
-		CurrentState = ADC_GAIN_CALIBRATING;
+		ADC_Machine_EnterState(ADC_GAIN_CALIBRATING);
+		InvalidateCalibration();
 
 		/* Update the finished state */
 		calibrationState.finished = false;
@@ -557,6 +2178,7 @@ void ADC_GainCalibrate(PhysicalAnalogInput_t input) {
  * @retval none
  */
 void ADC_Machine_Service(void) {
+	PROFILE_BEGIN();
 	/* Determine the state */
 	switch (CurrentState) {
 	case ADC_UNINITIALIZED:
@@ -580,12 +2202,19 @@ void ADC_Machine_Service(void) {
 		}
 		break;
 	case ADC_CHANNEL_SAMPLING:
-		ADC_Machine_Service_Sampling();
+		if (burstCapture.active == true) {
+			ADC_Machine_Service_BurstCapture();
+		} else {
+			ADC_Machine_Service_Sampling();
+		}
 		break;
 	case ADC_RESET:
+		ADS1256_DisableDataReadyInterrupt();
 		ADS1256_Full_Reset();
+		InvalidateCalibration();
 		SampleCurrent = 0U;
 		SampleTotal = 0U;
+		continuousSampling = false;
 		samplingInputs = NULL;
 		numberSamplingInputs = 0U;
 		currentSamplingInput = NULL_CHANNEL;
@@ -598,23 +2227,85 @@ void ADC_Machine_Service(void) {
 		/* TODO: Throw an error */
 		break;
 	}
+	PROFILE_END(PROFILE_ADC_SERVICE);
 }
 
 /**
  * Halt the current sampling activity of the ADC state machine and return to the idle state. This can be used
- * to interrupt long term or continuous sampling.
+ * to interrupt long term or continuous sampling. Conversions stop at once. By default the samples already collected
+ * are still written out by the sampling service, which then completes the sampling as if its count had been reached.
+ * When they are discarded instead the machine returns to idle immediately, as it does from any other activity.
  *
- * @param none
+ * @param discard bool TRUE to drop the samples which have not been written rather than write them out.
  * @retval none
  */
-void ADC_Machine_Halt(void) {
+void ADC_Machine_Halt(bool discard) {
 #ifdef ADC_STATE_MACHINE_DEBUG
 	printf("[ADC STATE MACHINE] Halting ADC sampling.\n\r");
 #endif
+	if ((CurrentState == ADC_CHANNEL_SAMPLING) || (CurrentState == ADC_EXTERNAL_MUXING)) {
+		/* Stop converting right away rather than when the service next runs */
+		ADS1256_DisableDataReadyInterrupt();
+		ADS1256_Sync(true);
+		TIM_Cmd(SNAPSHOT_FRAME_TIM, DISABLE);
+		if (discard == true) {
+			for (uint_fast8_t i = 0U; i < numberSamplingInputs; ++i) {
+				Analog_Input_t* input = samplingInputs[i];
+				if ((input != NULL) && (input->values != NULL)) {
+					RingBuffer_Release(&input->samples, RingBuffer_Count(&input->samples));
+				}
+			}
+			ADC_Machine_Idle();
+			CompletedADCSampling();
+			return;
+		}
+		/* End the count where it is, the service drains what is buffered and goes idle */
+		snapshotArmed = false;
+		pacedArmed = false;
+		samplingPaused = false;
+		continuousSampling = false;
+		SampleTotal = SampleCurrent;
+		return;
+	}
 	ADC_Machine_Idle();
 	CompletedADCSampling();
 }
 
+/**
+ * Handles the frame timer interrupt, starting a snapshot frame or paced scan. The conversion of a frame's first
+ * input, already selected and free running, is restarted from the SYNC pin so the frame begins at the tick with no
+ * software or SPI latency. A paced scan's first input is already selected too, and the ADC is woken from standby for
+ * it by the compare channel, its settling time ahead of the tick. The DRDY interrupt takes over from there. A tick
+ * which finds the previous frame or scan still in progress is counted as missed and the next one starts on the
+ * following tick.
+ *
+ * @param none
+ * @retval none
+ */
+void ADC_Machine_FrameIRQHandler(void) {
+	if (TIM_GetITStatus(SNAPSHOT_FRAME_TIM, TIM_IT_Update) != RESET) {
+		TIM_ClearITPendingBit(SNAPSHOT_FRAME_TIM, TIM_IT_Update);
+		if ((snapshotArmed == true) && (CurrentState == ADC_CHANNEL_SAMPLING)) {
+			snapshotArmed = false;
+			snapshotFrameTime = GetLocalTime();
+			ADS1256_SyncPulse();
+			ADS1256_EnableDataReadyInterrupt(&ADC_Machine_DataReadyCallback);
+		} else if ((CurrentState == ADC_CHANNEL_SAMPLING) || (CurrentState == ADC_EXTERNAL_MUXING)) {
+			++snapshotMissedFrames;
+		}
+	}
+	if (TIM_GetITStatus(SNAPSHOT_FRAME_TIM, TIM_IT_CC1) != RESET) {
+		TIM_ClearITPendingBit(SNAPSHOT_FRAME_TIM, TIM_IT_CC1);
+		if ((pacedArmed == true) && (CurrentState == ADC_CHANNEL_SAMPLING)) {
+			pacedArmed = false;
+			ADS1256_Wakeup();
+			ADS1256_EnableDataReadyInterrupt(&ADC_Machine_DataReadyCallback);
+		} else if ((CurrentState == ADC_CHANNEL_SAMPLING) || (CurrentState == ADC_EXTERNAL_MUXING)) {
+			++pacedMissedScans;
+		}
+	}
+}
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* STATE METHODS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -636,8 +2327,36 @@ void ADC_Machine_Idle(void) {
 	} else {
 #ifdef ADC_STATE_MACHINE_DEBUG
 		printf("[ADC STATE MACHINE] Moving to state ADC_IDLE.\n\r");
+		if (AnalogMixed_IsEnabled() == true) {
+			printf("[ADC STATE MACHINE] Mixed-signal capture dropped %" PRIu32 " states.\n\r", AnalogMixed_GetDroppedCount());
+		}
+		if (AnalogAux_IsEnabled() == true) {
+			printf("[ADC STATE MACHINE] Auxiliary capture dropped %" PRIu32 " readings.\n\r", AnalogAux_GetDroppedCount());
+		}
 #endif
-		CurrentState = ADC_IDLE;
+		/* Reclaim the bus from the DRDY interrupt */
+		ADS1256_DisableDataReadyInterrupt();
+		AbortCalibrationStep();
+		backgroundCalibration.active = false;
+		/* A sensor check cut short by a halt must not leave the detect current on */
+		ADS1256_SetSensorDetectCurrent(ADS1256_SD_OFF);
+		sensorCheck.converting = false;
+		sensorCheck.input = NULL;
+		sampleReady = false;
+		samplingPaused = false;
+		burstCapture.active = false;
+		/* Statistics mode, captures, snapshots, pacing and the overflow policy only last for the sampling they were requested with */
+		SetAnalogStatisticsWindow(0U, 0U);
+		overflowPolicy = ADC_OVERFLOW_DROP_NEWEST;
+		TIM_Cmd(SNAPSHOT_FRAME_TIM, DISABLE);
+		snapshotArmed = false;
+		snapshotPeriod = 0U;
+		pacedArmed = false;
+		pacedInterval = 0U;
+		AnalogTrigger_Disarm();
+		/* The PID loops no longer see their inputs, so their outputs are made safe */
+		DigitalPID_Hold();
+		ADC_Machine_EnterState(ADC_IDLE);
 		ADS1256_Sync(true);
 		Analog_Input_t* cold = GetAnalogInputByNumber(IN_COLD_JUNCTION);
 		SelectAnalogInput(cold);
@@ -649,7 +2368,7 @@ void ADC_Machine_Idle(void) {
  * Enter the input sampling state. In this state the ADC will be made to sample a set of inputs each the specified number of times.
  *
  * @param inputs Analog_Input_t** Pointer to array of input data structures holding the configurations of the sampling.
- * @param count uint32_t The number of samples of each input to take. 0 results in continuous sampling.
+ * @param count uint32_t The number of samples of each input to take. ADC_SAMPLE_CONTINUOUS samples until halted.
  * @param singleChannel bool True if the sampling is for a single channel only.
  * @retval none
  */
@@ -670,9 +2389,14 @@ void ADC_Machine_Input_Sample(Analog_Input_t** inputs, uint32_t count, bool sing
 		return;
 	}
 
+	/* The inputs must have their register images before they are converted */
+	CommitAnalogInputConfig();
+
 	/* Save sample count */
 	SampleCurrent = 0U;
 	SampleTotal = count;
+	continuousSampling = (count == ADC_SAMPLE_CONTINUOUS);
+	coldJunctionStale = true; /* The temperature may have drifted while idle */
 
 	if (singleChannel == true) {
 		/* Validate the input(s) */
@@ -692,44 +2416,167 @@ void ADC_Machine_Input_Sample(Analog_Input_t** inputs, uint32_t count, bool sing
 		currentSamplingInput = 0;
 		numberSamplingInputs = 1;
 	} else {
-		/* Validate the input(s) */
-		uint8_t i = 0U;
-		for (; i < NUM_ANALOG_INPUTS; ++i) {
-			if (inputs[i] != NULL && inputs[i]->added == CHANNEL_ADDED) {
-				break;
-			}
-		}
-		if (i >= NUM_ANALOG_INPUTS) {
+		/* Validate the input(s) and plan the scan order */
+		scanLength = BuildScanPlan(inputs);
+		if (scanLength == 0U) {
 #ifdef ADC_STATE_MACHINE_DEBUG
 			printf("[ADC STATE MACHINE] Attempted to enter ADC_CHANNEL_SAMPLING state with a NULL analog input. Ignoring...\n\r");
 #endif
 			return;
 		}
 		/* Select input */
-		currentSamplingInput = i; /* Use i here so we don't loose any work from the search earlier */
+		currentSamplingInput = 0U;
 		numberSamplingInputs = NUM_ANALOG_INPUTS;
+		inputs = scanPlan;
 	}
 
 	samplingInputs = inputs;
+	/* Give the sample pool to the inputs being sampled */
+	AllocateAnalogInputBuffers(samplingInputs, numberSamplingInputs);
+	/* Start each filter, statistics window and deadband afresh so no output depends on conversions from separate runs */
+	if (numberSamplingInputs == 1U) {
+		snapshotPeriod = 0U; /* A lone input has no frame to synchronize */
+	}
+	snapshotArmed = false;
+	snapshotMissedFrames = 0U;
+	lastDrainEnd = 0U;
+	pacedArmed = false;
+	pacedMissedScans = 0U;
+	sensorCheck.lastScan = 0U;
+	sensorCheck.next = 0U;
+	for (uint_fast8_t i = 0U; i < numberSamplingInputs; ++i) {
+		lastConversionTimes[i] = 0U;
+		snapshotOffsets[i] = 0U;
+		backgroundCalibration.referenced[i] = false;
+		if (samplingInputs[i] != NULL) {
+			AnalogFilter_Reset(&samplingInputs[i]->filter);
+			ResetAnalogInputReporting(samplingInputs[i]);
+		}
+	}
+	AnalogPower_Reset();
+	AnalogMath_Reset();
+	AnalogMixed_Reset();
+	AnalogAux_Reset();
+	DigitalPID_Reset();
 	Analog_Input_t* input = samplingInputs[currentSamplingInput];
-	CurrentState = ADC_CHANNEL_SAMPLING;
+	ADC_Machine_EnterState(ADC_CHANNEL_SAMPLING);
 	SelectAnalogInput(input);
 
 	if (CurrentState == ADC_CHANNEL_SAMPLING) {
 		/* Set sampling parameters */
-		ADS1256_SetDataRate(input->rate);
-		ADS1256_SetPGASetting(input->gain);
-		ADS1256_SetInputBufferSetting(input->buffer);
-		ApplyCalibrationParameters(input);
+		LoadConversionSettings(input);
 		/* Begin sampling */
 		ADS1256_Sync(false);
+		sampleReady = false;
+		reportedOverrunCount = sampleOverrunCount;
+		drainPosition = 0U;
 		ADS1256_Wakeup(); /* Start Sampling */
-		/* Save the real time clock entry for the sample */
-		input->timestamps[input->bufferWriteIdx] = GetLocalTime();
+		/* Results are collected by the DRDY interrupt from here on. A single input never changes settings, so
+		 * the ADC can stream in continuous read mode until halted, unless it is paced. */
+		ADS1256_SetContinuousRead((numberSamplingInputs == 1U) && (pacedInterval == 0U));
+		if (isPacedScanStart() == true) {
+			/* The first scan tick wakes the ADC for the first scan */
+			ADS1256_Standby();
+			pacedArmed = true;
+		} else if (isSnapshotFrameStart() == true) {
+			/* The first frame tick starts the first scan */
+			snapshotArmed = true;
+		} else {
+			ADS1256_EnableDataReadyInterrupt(&ADC_Machine_DataReadyCallback);
+		}
 	} else {
 		/* We entered the ADC_MUXING state */
 		ADS1256_Sync(false); /* TODO: Is this necessary? It may cause temperature fluctuations */
 	}
+	if (snapshotPeriod != 0U) {
+		StartFrameTimer(snapshotPeriod);
+	} else if (pacedInterval != 0U) {
+		StartFrameTimer(pacedInterval);
+		ArmPacedWakeup();
+	}
+	/* Start any output sequence which was armed to run with the sampling */
+	TriggerDigitalOutputSequence();
+}
+
+/**
+ * Starts a burst capture of a single input. The sampling state is entered for up to count conversions as for any
+ * single channel sampling, so the ADC streams in continuous read mode with each result read over DMA, but the DRDY
+ * interrupt only stores the raw codes in the free CCM-RAM. No filtering, linearization or output takes place until
+ * the capture is complete. Any pacing, snapshot, statistics window or trigger set up for the next sampling is
+ * dropped. The codes of the previous capture are discarded.
+ *
+ * @param input Analog_Input_t* The input to capture.
+ * @param count uint32_t The number of conversions to capture, limited to the capacity of the capture buffer.
+ * @retval bool TRUE if the capture was started, FALSE if the machine is not idle, the input cannot be sampled or
+ * there is no room for a capture.
+ */
+bool ADC_Machine_StartBurstCapture(Analog_Input_t* input, uint32_t count) {
+	const uint32_t capacity = ((uint32_t) (&_eccmfree - &_sccmfree)) / ANALOG_SAMPLE_VALUE_SIZE;
+	if ((CurrentState != ADC_IDLE) || (input == NULL) || (input->added == CHANNEL_NOTADDED) || (count == 0U)
+			|| (capacity == 0U)) {
+		return false;
+	}
+	pacedInterval = 0U;
+	snapshotPeriod = 0U;
+	SetAnalogStatisticsWindow(0U, 0U);
+	AnalogTrigger_Disarm();
+	burstCapture.input = input->physicalInput;
+	burstCapture.capacity = capacity;
+	burstCapture.requested = (count < capacity) ? count : capacity;
+	burstCapture.count = 0U;
+	burstCapture.start = 0U;
+	burstCapture.end = 0U;
+	burstCapture.downloading = false;
+	burstCapture.downloaded = 0U;
+	AnalogSpectrum_Cancel(); /* Its codes are about to be overwritten */
+	burstCapture.active = true;
+	burstCaptureInputs[0] = input;
+	ADC_Machine_Input_Sample(burstCaptureInputs, burstCapture.requested, true);
+	if (CurrentState == ADC_IDLE) {
+		/* The sampling state refused the input */
+		burstCapture.active = false;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Starts sending the codes of the last burst capture to the data connection as binary capture records. The records
+ * are sent from the idle state, a few each service, and a status message reports when the download has ended.
+ * Starting again while a download is in progress sends the codes again from the first.
+ *
+ * @param none
+ * @retval bool TRUE if the download was started, FALSE if a capture is running or there is nothing to send.
+ */
+bool ADC_Machine_ReadBurstCapture(void) {
+	if ((burstCapture.active == true) || (burstCapture.count == 0U)) {
+		return false;
+	}
+	burstCapture.downloaded = 0U;
+	burstCapture.downloading = true;
+	return true;
+}
+
+/**
+ * Starts computing the spectrum of the last burst capture, see AnalogInput_Spectrum.c. The blocks are transformed
+ * from the idle state, one each service, and the spectrum is then reported as its strongest peaks or sent to the data
+ * connection as binary spectrum records. The bin width follows from the rate the capture was actually taken at.
+ *
+ * @param points uint16_t The number of points of each FFT block.
+ * @param peaks uint8_t The number of peaks to report, or 0 to send every bin.
+ * @param binWidth uint32_t* Set to the frequency step between bins in mHz.
+ * @retval bool TRUE if the spectrum was started, FALSE if a capture is running, the parameters are invalid or the
+ * capture does not hold a single block.
+ */
+bool ADC_Machine_ReadBurstSpectrum(uint16_t points, uint8_t peaks, uint32_t* binWidth) {
+	const uint32_t count = burstCapture.count;
+	if ((burstCapture.active == true) || (count < 2U) || (FFT_IsValidSize(points) == false)) {
+		return false;
+	}
+	/* The rate is the number of conversion intervals over the time they took */
+	const uint64_t duration = burstCapture.end - burstCapture.start;
+	*binWidth = (duration == 0U) ? 0U : (uint32_t) ((((uint64_t) (count - 1U)) * 1000000000U) / (duration * points));
+	return AnalogSpectrum_Start(burstCapture.input, &_sccmfree, count, points, peaks, *binWidth);
 }
 
 /**
@@ -746,7 +2593,8 @@ void ADC_Machine_Reset(void) {
 		printf("[ADC STATE MACHINE] Attempted to enter ADC_RESET state from %s\n\r", ADCMachine_StringFromState(CurrentState));
 #endif
 	} else {
-		CurrentState = ADC_RESET;
+		ADS1256_DisableDataReadyInterrupt();
+		ADC_Machine_EnterState(ADC_RESET);
 	}
 }
 
@@ -769,7 +2617,349 @@ void ADC_External_Muxing(void) {
 		printf("[ADC STATE MACHINE] Entering state %s\n\r", ADCMachine_StringFromState(ADC_EXTERNAL_MUXING));
 #endif
 		PreviousState = CurrentState;
-		CurrentState = ADC_EXTERNAL_MUXING;
+		ADC_Machine_EnterState(ADC_EXTERNAL_MUXING);
 		waitingOnTemp = false;
+		muxSettingsLoaded = false;
+	}
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* CONFIGURATION METHODS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Sets how often the cold junction temperature is refreshed while multi-channel sampling switches between
+ * external inputs. An interval of 0 refreshes it on every external multiplexer switch.
+ *
+ * @param policy ADC_ColdJunctionRefresh_t How the interval is measured.
+ * @param interval uint32_t The refresh interval, in microseconds or completed scans depending on the policy.
+ * @retval none
+ */
+void ADC_Machine_SetColdJunctionRefresh(ADC_ColdJunctionRefresh_t policy, uint32_t interval) {
+	coldJunctionPolicy = policy;
+	coldJunctionInterval = interval;
+#ifdef ADC_STATE_MACHINE_DEBUG
+	printf("[ADC STATE MACHINE] Cold junction refresh set to %" PRIu32 " %s.\n\r", interval,
+			(policy == ADC_CJ_REFRESH_SCANS) ? "scans" : "us");
+#endif
+}
+
+/**
+ * Sets when offset calibrations are made between scans while sampling, so that long runs follow the drift of the
+ * ADC without halting. Each one calibrates one group of settings in the scan and costs a single self offset
+ * calibration at that group's data rate. A calibration is made once either the interval has passed or the board
+ * temperature has changed by the delta since the last one. Both 0 turns background calibration off.
+ *
+ * @param interval uint32_t The time between calibrations in microseconds, 0 if not time based.
+ * @param temperatureDelta float The board temperature change in degrees Celsius which triggers a calibration, 0 if
+ * not used.
+ * @retval none
+ */
+void ADC_Machine_SetBackgroundCalibration(uint32_t interval, float temperatureDelta) {
+	backgroundCalibration.interval = interval;
+	backgroundCalibration.temperatureDelta = (temperatureDelta > 0.0f) ? temperatureDelta : 0.0f;
+	backgroundCalibration.lastTime = GetLocalTime();
+	backgroundCalibration.lastTemperature = getBoardTemperature();
+#ifdef ADC_STATE_MACHINE_DEBUG
+	printf("[ADC STATE MACHINE] Background calibration every %" PRIu32 " us or %f Deg C.\n\r", interval,
+			(double) backgroundCalibration.temperatureDelta);
+#endif
+}
+
+/**
+ * Sets how often the sensors of the sampled inputs are checked for an open circuit. Every interval scans one input is
+ * converted once more with the ADC's sensor detect current sources on, so an input with nothing connected is driven
+ * to full scale, and the inputs are taken in turn. A sensor's own resistance only offsets the check conversion by
+ * the detect current times that resistance, so the current should be small enough to keep a connected sensor well
+ * short of full scale at the input's gain. Disabled checks cost nothing while sampling.
+ *
+ * @param interval uint32_t The number of scans between sensor checks, 0 to disable them.
+ * @param current ADS1256_SENSOR_DETECT_t The detect current a check applies.
+ * @retval none
+ */
+void ADC_Machine_SetSensorCheck(uint32_t interval, ADS1256_SENSOR_DETECT_t current) {
+	sensorCheck.interval = interval;
+	sensorCheck.current = (current == ADS1256_SD_OFF) ? ADS1256_SDC_2 : current;
+	sensorCheck.lastScan = SampleCurrent;
+#ifdef ADC_STATE_MACHINE_DEBUG
+	printf("[ADC STATE MACHINE] Sensor check every %" PRIu32 " scans.\n\r", interval);
+#endif
+}
+
+/**
+ * Retrieves the number of sensor checks made since start up.
+ *
+ * @param none
+ * @retval uint32_t The number of sensor checks.
+ */
+uint32_t ADC_Machine_GetSensorCheckCount(void) {
+	return sensorCheck.count;
+}
+
+/**
+ * Determines if the latest sensor check of a physical input found it open circuit.
+ *
+ * @param input PhysicalAnalogInput_t The physical input.
+ * @retval bool TRUE if the input's sensor was found open.
+ */
+bool ADC_Machine_IsSensorOpen(PhysicalAnalogInput_t input) {
+	return (input < NUM_ANALOG_INPUTS) && (sensorCheck.open[input] == true);
+}
+
+/**
+ * Retrieves the number of background offset calibrations made since start up.
+ *
+ * @param none
+ * @retval uint32_t The number of background calibrations.
+ */
+uint32_t ADC_Machine_GetBackgroundCalibrationCount(void) {
+	return backgroundCalibration.count;
+}
+
+/**
+ * Estimates the average time each multi-channel scan spends refreshing the cold junction under the current refresh
+ * policy. A refresh is only made on an external multiplexer switch, and costs the settling time of the cold
+ * junction's data rate. Its overlap with the multiplexer delay is not counted, so this is an upper bound.
+ *
+ * @param scanTime float The time of a scan without cold junction refreshes, in milliseconds.
+ * @param externalInputs uint8_t The number of external inputs in the scan.
+ * @retval float The time spent refreshing the cold junction per scan, in milliseconds.
+ */
+float ADC_Machine_GetColdJunctionTime(float scanTime, uint8_t externalInputs) {
+	const Analog_Input_t* input = GetAnalogInputByNumber(IN_COLD_JUNCTION);
+	const float conversion = ADS1256_GetSettlingTimeForRate(input->rate);
+	float refreshes = (float) externalInputs; /* Refreshes per scan, at most one per external switch */
+	if ((externalInputs > 0U) && (coldJunctionInterval > 0U)) {
+		float perScan;
+		if (coldJunctionPolicy == ADC_CJ_REFRESH_SCANS) {
+			perScan = 1.0f / (float) coldJunctionInterval;
+		} else {
+			/* The refreshes themselves lengthen the scan, solve for the fixed point */
+			const float interval = (float) coldJunctionInterval / 1000.0f;
+			perScan = (interval > conversion) ? (scanTime / (interval - conversion)) : refreshes;
+		}
+		if (perScan < refreshes) {
+			refreshes = perScan;
+		}
+	}
+	return refreshes * conversion;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* STATUS METHODS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Retrieves the current state of the ADC state machine.
+ *
+ * @param none
+ * @retval ADC_State_t The current state.
+ */
+ADC_State_t ADC_Machine_GetState(void) {
+	return CurrentState;
+}
+
+/**
+ * Sets what happens when an analog input's buffer fills up while sampling. Like statistics mode, the policy only lasts
+ * for the next sampling and is returned to ADC_OVERFLOW_DROP_NEWEST when it ends. The pause policy holds off
+ * conversions, a single channel run by ignoring conversions and a scan before starting its next input, so every
+ * sample is delivered at the cost of gaps in time. Must only be called while the ADC is not sampling.
+ *
+ * @param policy ADC_OverflowPolicy_t The policy to apply.
+ * @retval none
+ */
+void ADC_Machine_SetOverflowPolicy(ADC_OverflowPolicy_t policy) {
+	if (policy < NUM_ADC_OVERFLOW_POLICIES) {
+		overflowPolicy = policy;
+	}
+}
+
+/**
+ * Sets the frame period of snapshot mode for the next multi-channel sampling, which lasts until it returns to idle.
+ * In snapshot mode each scan is a frame started by a hardware timer at a fixed rate, rather than as soon as the
+ * previous scan ends, and every sample of a frame is stamped with the frame's start time. The time of each input's
+ * conversion within the frame is reported after the first frame. A period of 0 turns snapshot mode off.
+ *
+ * @param period uint32_t The frame period in microseconds, limited to ADC_SNAPSHOT_MIN_PERIOD_US to
+ * ADC_SNAPSHOT_MAX_PERIOD_US, or 0.
+ * @retval none
+ */
+void ADC_Machine_SetSnapshotPeriod(uint32_t period) {
+	if ((period != 0U) && (period < ADC_SNAPSHOT_MIN_PERIOD_US)) {
+		period = ADC_SNAPSHOT_MIN_PERIOD_US;
+	} else if (period > ADC_SNAPSHOT_MAX_PERIOD_US) {
+		period = ADC_SNAPSHOT_MAX_PERIOD_US;
+	}
+	snapshotPeriod = period;
+}
+
+/**
+ * Sets the longest time a service of the sampling state may spend writing samples out of the sample buffers. Within
+ * it each drain takes a share of the time in proportion to how long the rest of the main loop is taking, so the
+ * output gets as much time as it can use when the loop is lightly loaded, without holding up acquisition or the
+ * network when it is not.
+ *
+ * @param budget uint32_t The longest drain time in microseconds, limited to ADC_OUTPUT_BUDGET_MIN_US to
+ * ADC_OUTPUT_BUDGET_MAX_US.
+ * @retval none
+ */
+void ADC_Machine_SetOutputBudget(uint32_t budget) {
+	if (budget < ADC_OUTPUT_BUDGET_MIN_US) {
+		budget = ADC_OUTPUT_BUDGET_MIN_US;
+	} else if (budget > ADC_OUTPUT_BUDGET_MAX_US) {
+		budget = ADC_OUTPUT_BUDGET_MAX_US;
+	}
+	outputBudget = budget;
+}
+
+/**
+ * Fills in the calibration values of the register image of every added input which is out of date, so that the
+ * first scan after the inputs are reconfigured does not look them up input by input between its conversions.
+ * Nothing is done while sampling, when the images are in use.
+ *
+ * @param none
+ * @retval none
+ */
+void ADC_Machine_PrepareInputs(void) {
+	if (CurrentState == ADC_CHANNEL_SAMPLING) {
+		return;
+	}
+	for (uint_fast8_t i = 0U; i < NUM_ANALOG_INPUTS; ++i) {
+		Analog_Input_t* input = GetAnalogInputByNumber(i);
+		if ((input->added == CHANNEL_ADDED) && (input->registersPending == false)) {
+			ApplyCalibrationParameters(input);
+		}
 	}
 }
+
+/**
+ * Sets the scan interval of paced sampling for the next sampling, which lasts until it returns to idle. In paced
+ * sampling each scan is started by a hardware timer at the interval, rather than as soon as the previous scan ends,
+ * and the ADC is kept in standby between scans. It is woken the settling time of the scan's first input ahead of each
+ * tick, so that conversion completes on the tick. This gives sampling rates far below the data rate without
+ * oversampling and discarding conversions, and keeps both the ADC's self-heating and the DRDY interrupts down to the
+ * conversions which are kept. Samples keep the times of their own conversions. An interval of 0 turns paced sampling
+ * off, and snapshot mode takes precedence over it.
+ *
+ * @param interval uint32_t The scan interval in microseconds, limited to ADC_PACED_MIN_INTERVAL_US to
+ * ADC_PACED_MAX_INTERVAL_US, or 0.
+ * @retval none
+ */
+void ADC_Machine_SetScanInterval(uint32_t interval) {
+	if ((interval != 0U) && (interval < ADC_PACED_MIN_INTERVAL_US)) {
+		interval = ADC_PACED_MIN_INTERVAL_US;
+	} else if (interval > ADC_PACED_MAX_INTERVAL_US) {
+		interval = ADC_PACED_MAX_INTERVAL_US;
+	}
+	pacedInterval = interval;
+}
+
+/**
+ * Retrieves the number of snapshot frames missed in the current or last sampling because the previous frame's scan
+ * had not finished when the frame tick came.
+ *
+ * @param none
+ * @retval uint32_t The number of missed frames.
+ */
+uint32_t ADC_Machine_GetSnapshotMissedFrames(void) {
+	return snapshotMissedFrames;
+}
+
+/**
+ * Convert a human readable string into the relevant ADC_OverflowPolicy_t value.
+ *
+ * @param str const char* The string to convert.
+ * @retval ADC_OverflowPolicy_t The matching policy, NUM_ADC_OVERFLOW_POLICIES if there is none.
+ */
+ADC_OverflowPolicy_t ADC_Machine_StringToOverflowPolicy(const char* str) {
+	for (uint_fast8_t i = 0U; i < NUM_ADC_OVERFLOW_POLICIES; ++i) {
+		if (strcmp(str, OVERFLOW_POLICY_STRINGS[i]) == 0) {
+			return (ADC_OverflowPolicy_t) i;
+		}
+	}
+	return NUM_ADC_OVERFLOW_POLICIES;
+}
+
+/**
+ * Retrieves the number of samples dropped since start up because the buffer of the input being sampled was full,
+ * including those discarded by the drop oldest overflow policy.
+ *
+ * @param none
+ * @retval uint32_t The number of dropped samples.
+ */
+uint32_t ADC_Machine_GetOverrunCount(void) {
+	return sampleOverrunCount;
+}
+
+/**
+ * Retrieves the number of conversions read since start up. The count wraps, so the rate of conversions is found from
+ * the difference of two counts.
+ *
+ * @param none
+ * @retval uint32_t The number of conversions read.
+ */
+uint32_t ADC_Machine_GetConversionCount(void) {
+	return conversionCount;
+}
+
+/**
+ * Retrieves the number of samples produced for a physical input since start up, counted once oversampling and any
+ * filter have reduced its conversions, whether or not the sample was then reported. The count wraps, so the
+ * achieved sample rate is found from the difference of two counts.
+ *
+ * @param input PhysicalAnalogInput_t The physical input.
+ * @retval uint32_t The number of samples produced, 0 if the input is invalid.
+ */
+uint32_t ADC_Machine_GetInputSampleCount(PhysicalAnalogInput_t input) {
+	return (input < NUM_ANALOG_INPUTS) ? inputSampleCounts[input] : 0U;
+}
+
+/**
+ * Retrieves the number of analog inputs being sampled.
+ *
+ * @param none
+ * @retval uint8_t The number of inputs being sampled, 0 if the machine is not sampling.
+ */
+uint8_t ADC_Machine_GetSamplingInputCount(void) {
+	return (CurrentState == ADC_CHANNEL_SAMPLING) ? numberSamplingInputs : 0U;
+}
+
+/**
+ * Retrieves the number of samples waiting in the buffers of the inputs being sampled.
+ *
+ * @param none
+ * @retval uint32_t The number of buffered samples.
+ */
+uint32_t ADC_Machine_GetBufferedSampleCount(void) {
+	uint32_t count = 0U;
+	if (samplingInputs != NULL) {
+		for (uint_fast8_t i = 0U; i < numberSamplingInputs; ++i) {
+			if (samplingInputs[i] != NULL) {
+				count += RingBuffer_Count(&samplingInputs[i]->samples);
+			}
+		}
+	}
+	return count;
+}
+
+/**
+ * Retrieves the state of the burst capture, including the capacity of the capture buffer before the first capture.
+ *
+ * @param capture ADC_BurstCapture_t* Filled in with the state of the burst capture.
+ * @retval none
+ */
+void ADC_Machine_GetBurstCapture(ADC_BurstCapture_t* capture) {
+	*capture = burstCapture;
+	capture->capacity = ((uint32_t) (&_eccmfree - &_sccmfree)) / ANALOG_SAMPLE_VALUE_SIZE;
+}
+
+/**
+ * Retrieves the codes held by the burst capture buffer, ANALOG_SAMPLE_VALUE_SIZE bytes each, least significant byte
+ * first. Only the first count of ADC_Machine_GetBurstCapture() are valid, and only while the capture is not active.
+ *
+ * @param none
+ * @retval const uint8_t* Pointer to the first code.
+ */
+const uint8_t* ADC_Machine_GetBurstCaptureCodes(void) {
+	return &_sccmfree;
+}
@@ -0,0 +1,307 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file AnalogInput_Aux.c
+ * @brief Implements the auxiliary analog inputs read by the processor's own ADC.
+ *
+ * The ADS1256 is precise but slow per channel, and every input it scans lengthens the scan of all the others. The
+ * board health and fast low resolution signals are instead read by the processor's 12 bit ADC, which scans the inputs
+ * of AUX_ANALOG_TABLE continuously while DMA copies each conversion into a circular buffer holding the last
+ * AUX_ANALOG_OVERSAMPLE scans. No interrupt or CPU time is spent until a reading is wanted, and each reading is the
+ * sum of the buffered conversions of its input, a moving average 16 bits wide.
+ *
+ * While enabled, the DRDY interrupt captures the readings of every auxiliary input as it stores the first sample of
+ * each analog scan, stamped with that sample's timestamp. As with the mixed-signal state they are queued for the main
+ * loop, which writes them into the analog stream after the samples of their scan, so the auxiliary inputs appear in
+ * the frames as extra channels without taking any time from the ADS1256.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "AnalogInput_Aux.h"
+#include "Tekdaqc_RingBuffer.h"
+#include "stm32f4xx_adc.h"
+#include "stm32f4xx_dma.h"
+#include "stm32f4xx_gpio.h"
+#include "stm32f4xx_rcc.h"
+#include <stddef.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* Expands an AUX_ANALOG_TABLE entry to its ADC channel */
+#define AUX_ANALOG_CHANNEL_ENTRY(n, channel, name, pin, port, divider) channel,
+
+/* Expands an AUX_ANALOG_TABLE entry to its name */
+#define AUX_ANALOG_NAME_ENTRY(n, channel, name, pin, port, divider) name,
+
+/* Expands an AUX_ANALOG_TABLE entry to its divider ratio */
+#define AUX_ANALOG_DIVIDER_ENTRY(n, channel, name, pin, port, divider) divider,
+
+/* Expands an AUX_ANALOG_TABLE entry to the configuration of its pin as an analog input, if it is wired to one */
+#define AUX_ANALOG_PIN_INIT(n, channel, name, pin, port, divider) \
+	if ((pin) != 0U) { \
+		RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_GPIO##port, ENABLE); \
+		GPIO_InitStructure.GPIO_Pin = (pin); \
+		GPIO_Init(GPIO##port, &GPIO_InitStructure); \
+	}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The ADC channel of each auxiliary input, in scan order */
+static const uint8_t AUX_CHANNELS[NUM_AUX_ANALOG_INPUTS] = { AUX_ANALOG_TABLE(AUX_ANALOG_CHANNEL_ENTRY) };
+
+/* The name of each auxiliary input */
+static const char* AUX_NAMES[NUM_AUX_ANALOG_INPUTS] = { AUX_ANALOG_TABLE(AUX_ANALOG_NAME_ENTRY) };
+
+/* The ratio of the divider in front of each auxiliary input */
+static const uint8_t AUX_DIVIDERS[NUM_AUX_ANALOG_INPUTS] = { AUX_ANALOG_TABLE(AUX_ANALOG_DIVIDER_ENTRY) };
+
+/* The last AUX_ANALOG_OVERSAMPLE scans, written by the DMA. In SRAM, where the DMA can reach them. */
+static volatile uint16_t conversions[AUX_ANALOG_OVERSAMPLE][NUM_AUX_ANALOG_INPUTS];
+
+/* TRUE while the auxiliary readings are captured with each scan */
+static volatile bool auxEnabled = false;
+
+/* Storage of the captured readings waiting to be written */
+static AnalogAuxState_t states[ANALOG_AUX_BUFFER_SIZE];
+
+/* Indices of the captured readings, written from the DRDY interrupt and read from the main loop */
+static RingBuffer_t stateRing;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Configures the processor's ADC to scan the auxiliary inputs continuously, each conversion being copied by a
+ * circular DMA stream into the buffer of the last scans, and starts it. Nothing more is done by the CPU, the readings
+ * only being summed when they are asked for.
+ *
+ * @param none
+ * @retval none
+ */
+void AnalogAux_Init(void) {
+	GPIO_InitTypeDef GPIO_InitStructure;
+	DMA_InitTypeDef DMA_InitStructure;
+	ADC_CommonInitTypeDef ADC_CommonInitStructure;
+	ADC_InitTypeDef ADC_InitStructure;
+
+	/* Configure the pins of the inputs wired to the board */
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AN;
+	GPIO_InitStructure.GPIO_PuPd = GPIO_PuPd_NOPULL;
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_2MHz;
+	GPIO_InitStructure.GPIO_OType = GPIO_OType_PP;
+	AUX_ANALOG_TABLE(AUX_ANALOG_PIN_INIT)
+
+	RCC_AHB1PeriphClockCmd(AUX_ANALOG_DMA_CLK, ENABLE);
+	RCC_APB2PeriphClockCmd(AUX_ANALOG_ADC_CLK, ENABLE);
+
+	DMA_DeInit(AUX_ANALOG_DMA_STREAM);
+	DMA_InitStructure.DMA_Channel = AUX_ANALOG_DMA_CHANNEL;
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t) &(AUX_ANALOG_ADC->DR);
+	DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t) conversions;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
+	DMA_InitStructure.DMA_BufferSize = AUX_ANALOG_OVERSAMPLE * NUM_AUX_ANALOG_INPUTS;
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+	/* A conversion every few microseconds at most, well behind the SPI streams */
+	DMA_InitStructure.DMA_Priority = DMA_Priority_Low;
+	DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+	DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+	DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+	DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+	DMA_Init(AUX_ANALOG_DMA_STREAM, &DMA_InitStructure);
+	DMA_Cmd(AUX_ANALOG_DMA_STREAM, ENABLE);
+
+	ADC_CommonInitStructure.ADC_Mode = ADC_Mode_Independent;
+	ADC_CommonInitStructure.ADC_Prescaler = AUX_ANALOG_ADC_PRESCALER;
+	ADC_CommonInitStructure.ADC_DMAAccessMode = ADC_DMAAccessMode_Disabled;
+	ADC_CommonInitStructure.ADC_TwoSamplingDelay = ADC_TwoSamplingDelay_5Cycles;
+	ADC_CommonInit(&ADC_CommonInitStructure);
+
+	ADC_InitStructure.ADC_Resolution = ADC_Resolution_12b;
+	ADC_InitStructure.ADC_ScanConvMode = ENABLE;
+	ADC_InitStructure.ADC_ContinuousConvMode = ENABLE;
+	ADC_InitStructure.ADC_ExternalTrigConvEdge = ADC_ExternalTrigConvEdge_None;
+	ADC_InitStructure.ADC_ExternalTrigConv = ADC_ExternalTrigConv_T1_CC1;
+	ADC_InitStructure.ADC_DataAlign = ADC_DataAlign_Right;
+	ADC_InitStructure.ADC_NbrOfConversion = NUM_AUX_ANALOG_INPUTS;
+	ADC_Init(AUX_ANALOG_ADC, &ADC_InitStructure);
+	for (uint_fast8_t i = 0U; i < NUM_AUX_ANALOG_INPUTS; ++i) {
+		ADC_RegularChannelConfig(AUX_ANALOG_ADC, AUX_CHANNELS[i], i + 1U, AUX_ANALOG_SAMPLE_TIME);
+	}
+	/* Harmless for a table without them, the internal channels only load themselves */
+	ADC_TempSensorVrefintCmd(ENABLE);
+	ADC_VBATCmd(ENABLE);
+
+	/* Keep requesting DMA after the last conversion of a scan, so the circular buffer never stops */
+	ADC_DMARequestAfterLastTransferCmd(AUX_ANALOG_ADC, ENABLE);
+	ADC_DMACmd(AUX_ANALOG_ADC, ENABLE);
+	ADC_Cmd(AUX_ANALOG_ADC, ENABLE);
+	ADC_SoftwareStartConv(AUX_ANALOG_ADC);
+}
+
+/**
+ * Retrieves the latest reading of an auxiliary input, the sum of its conversions over the last AUX_ANALOG_OVERSAMPLE
+ * scans, AUX_ANALOG_FULL_SCALE at the ADC reference. Safe to call from the DRDY interrupt.
+ *
+ * @param input uint8_t The auxiliary input, its index in AUX_ANALOG_TABLE.
+ * @retval uint16_t The reading, 0 for an input which does not exist.
+ */
+uint16_t AnalogAux_Read(uint8_t input) {
+	if (input >= NUM_AUX_ANALOG_INPUTS) {
+		return 0U;
+	}
+	uint32_t sum = 0U;
+	for (uint_fast8_t i = 0U; i < AUX_ANALOG_OVERSAMPLE; ++i) {
+		sum += conversions[i][input];
+	}
+	return (uint16_t) sum;
+}
+
+/**
+ * Converts a reading of an auxiliary input to millivolts at the signal, scaling it by AUX_ANALOG_VREF_MV and the
+ * input's divider. The VREFINT input gives the actual reference, for a host wanting to correct for the supply.
+ *
+ * @param input uint8_t The auxiliary input, its index in AUX_ANALOG_TABLE.
+ * @param value uint16_t The reading to convert.
+ * @retval uint32_t The voltage at the signal in millivolts.
+ */
+uint32_t AnalogAux_ToMillivolts(uint8_t input, uint16_t value) {
+	const uint32_t divider = (input < NUM_AUX_ANALOG_INPUTS) ? AUX_DIVIDERS[input] : 1U;
+	return ((uint32_t) value * AUX_ANALOG_VREF_MV * divider + (AUX_ANALOG_FULL_SCALE / 2U)) / AUX_ANALOG_FULL_SCALE;
+}
+
+/**
+ * Retrieves the name of an auxiliary input.
+ *
+ * @param input uint8_t The auxiliary input, its index in AUX_ANALOG_TABLE.
+ * @retval const char* The name of the input, or NULL if it does not exist.
+ */
+const char* AnalogAux_GetName(uint8_t input) {
+	return (input < NUM_AUX_ANALOG_INPUTS) ? AUX_NAMES[input] : NULL;
+}
+
+/**
+ * Turns the capture of the auxiliary readings with each analog scan on or off. It may be changed while sampling, the
+ * next scan being the first or the last captured. The ADC converts regardless, so readings are always current.
+ *
+ * @param enabled bool TRUE to capture the auxiliary readings with each scan.
+ * @retval none
+ */
+void AnalogAux_SetEnabled(bool enabled) {
+	auxEnabled = enabled;
+}
+
+/**
+ * Determines if the auxiliary readings are captured with each analog scan.
+ *
+ * @param none
+ * @retval bool TRUE if the auxiliary readings are captured.
+ */
+bool AnalogAux_IsEnabled(void) {
+	return auxEnabled;
+}
+
+/**
+ * Discards the captured readings waiting to be written. Called as sampling starts, while the DRDY interrupt is idle.
+ *
+ * @param none
+ * @retval none
+ */
+void AnalogAux_Reset(void) {
+	RingBuffer_Init(&stateRing, ANALOG_AUX_BUFFER_SIZE);
+}
+
+/**
+ * Captures the readings of every auxiliary input at the instant of an analog scan. Called from the DRDY interrupt
+ * with the scan's first sample. If the buffer is full the readings are dropped and counted.
+ *
+ * @param timestamp uint64_t The timestamp of the scan's first sample.
+ * @retval none
+ */
+void AnalogAux_Capture(uint64_t timestamp) {
+	if (auxEnabled == false) {
+		return;
+	}
+	uint32_t index;
+	if (RingBuffer_BeginWrite(&stateRing, &index) == false) {
+		/* Counted by the ring */
+		return;
+	}
+	states[index].timestamp = timestamp;
+	for (uint_fast8_t i = 0U; i < NUM_AUX_ANALOG_INPUTS; ++i) {
+		states[index].values[i] = AnalogAux_Read(i);
+	}
+	RingBuffer_EndWrite(&stateRing);
+}
+
+/**
+ * Determines if any captured readings are waiting to be written.
+ *
+ * @param none
+ * @retval bool True if readings are waiting.
+ */
+bool AnalogAux_IsPending(void) {
+	return (RingBuffer_IsEmpty(&stateRing) == false);
+}
+
+/**
+ * Retrieves the oldest captured readings waiting to be written, as many as are stored one after another. They stay
+ * waiting until released with AnalogAux_ReleaseStates(), so a write which could not be sent may be retried.
+ *
+ * @param oldest const AnalogAuxState_t** Set to the oldest readings.
+ * @retval uint32_t The number of captures which follow on from it.
+ */
+uint32_t AnalogAux_PeekStates(const AnalogAuxState_t** oldest) {
+	const uint32_t count = RingBuffer_Count(&stateRing);
+	if (count == 0U) {
+		return 0U;
+	}
+	const uint32_t index = RingBuffer_PeekIndex(&stateRing, 0U);
+	*oldest = &states[index];
+	return (count < (ANALOG_AUX_BUFFER_SIZE - index)) ? count : (ANALOG_AUX_BUFFER_SIZE - index);
+}
+
+/**
+ * Releases captured readings which have been written, or which could not be delivered.
+ *
+ * @param count uint32_t The number of captures, at most the number retrieved by AnalogAux_PeekStates().
+ * @retval none
+ */
+void AnalogAux_ReleaseStates(uint32_t count) {
+	RingBuffer_Release(&stateRing, count);
+}
+
+/**
+ * Retrieves the number of captured readings dropped since sampling started because the buffer was full.
+ *
+ * @param none
+ * @retval uint32_t The number of dropped captures.
+ */
+uint32_t AnalogAux_GetDroppedCount(void) {
+	return RingBuffer_GetOverflowCount(&stateRing);
+}
@@ -0,0 +1,324 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file AnalogInput_Filter.c
+ * @brief Implements the decimating filters for analog inputs.
+ *
+ * Each analog input may have one filter applied to its samples as they are taken, producing one output sample for
+ * every decimation input samples. The filters run from the DRDY interrupt, so all of the per sample work is integer
+ * arithmetic; the multiply accumulates compile to the Cortex-M4's single cycle SMLAL and outputs are saturated to the
+ * 24 bit range of the ADC with SSAT so they can be stored like any other reading. The timestamp of an output is that
+ * of the last input sample which produced it.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "AnalogInput_Filter.h"
+#include <string.h>
+#include <math.h>
+
+#ifdef ANALOG_FILTER_DEBUG
+#include <stdio.h>
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The number of fractional bits of the FIR coefficients */
+#define FIR_COEFFICIENT_BITS 15U
+
+/* The cutoff of the FIR filter as a fraction of the output Nyquist frequency, leaving a transition band */
+#define FIR_CUTOFF_FRACTION 0.8f
+
+/* Mask for indexing the FIR history, which must be a power of two long */
+#define FIR_HISTORY_MASK (ANALOG_FILTER_FIR_TAPS - 1U)
+
+/* Pi, for the FIR design */
+#define FILTER_PI 3.14159265358979f
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The human readable names of the filter types, indexed by AnalogFilterType_t */
+static const char* FILTER_TYPE_STRINGS[NUM_ANALOG_FILTER_TYPES] = { "NONE", "AVERAGE", "CIC", "FIR" };
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Designs the FIR coefficients for the filter's decimation.
+ */
+static void DesignFIR(AnalogFilter_t* filter);
+
+/**
+ * @internal
+ * @brief Divides, rounding to the nearest integer.
+ */
+static int64_t DivideRounded(int64_t value, int64_t divisor);
+
+/**
+ * @internal
+ * @brief Saturates a filter output to the range of an ADC reading.
+ */
+static int32_t SaturateOutput(int64_t value);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Designs a Hann windowed sinc low pass for the filter's decimation and quantizes it to Q15. Any rounding error is
+ * folded into the center tap so the coefficients sum to exactly unity and DC passes through unchanged. Only called
+ * when the filter is configured, never from the sampling path.
+ *
+ * @param filter AnalogFilter_t* The filter to design coefficients for.
+ * @retval none
+ */
+static void DesignFIR(AnalogFilter_t* filter) {
+	const float cutoff = FIR_CUTOFF_FRACTION * 0.5f / (float) filter->decimation; /* Cycles per input sample */
+	const float center = (float) (ANALOG_FILTER_FIR_TAPS - 1U) / 2.0f;
+	float taps[ANALOG_FILTER_FIR_TAPS];
+	float total = 0.0f;
+	for (uint_fast8_t i = 0U; i < ANALOG_FILTER_FIR_TAPS; ++i) {
+		const float x = (float) i - center;
+		const float sinc = 2.0f * cutoff * sinf(2.0f * FILTER_PI * cutoff * x) / (2.0f * FILTER_PI * cutoff * x);
+		const float window = 0.5f - 0.5f * cosf(2.0f * FILTER_PI * (float) i / (float) (ANALOG_FILTER_FIR_TAPS - 1U));
+		taps[i] = sinc * window;
+		total += taps[i];
+	}
+	int32_t sum = 0;
+	for (uint_fast8_t i = 0U; i < ANALOG_FILTER_FIR_TAPS; ++i) {
+		filter->state.fir.coefficients[i] = (int16_t) lroundf(taps[i] / total * (float) (1UL << FIR_COEFFICIENT_BITS));
+		sum += filter->state.fir.coefficients[i];
+	}
+	filter->state.fir.coefficients[ANALOG_FILTER_FIR_TAPS / 2U] += (int16_t) ((int32_t) (1UL << FIR_COEFFICIENT_BITS) - sum);
+}
+
+/**
+ * Divides, rounding halves away from zero.
+ *
+ * @param value int64_t The dividend.
+ * @param divisor int64_t The divisor. Must be positive.
+ * @retval int64_t The rounded quotient.
+ */
+static int64_t DivideRounded(int64_t value, int64_t divisor) {
+	return (value >= 0) ? ((value + (divisor / 2)) / divisor) : ((value - (divisor / 2)) / divisor);
+}
+
+/**
+ * Saturates a filter output to the signed 24 bit range of an ADC reading.
+ *
+ * @param value int64_t The filter output.
+ * @retval int32_t The saturated output.
+ */
+static int32_t SaturateOutput(int64_t value) {
+	if (value > INT32_MAX) {
+		value = INT32_MAX;
+	} else if (value < INT32_MIN) {
+		value = INT32_MIN;
+	}
+	return __SSAT((int32_t) value, 24);
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Initializes a filter to pass samples through unchanged.
+ *
+ * @param filter AnalogFilter_t* The filter to initialize.
+ * @retval none
+ */
+void AnalogFilter_Init(AnalogFilter_t* filter) {
+	filter->type = ANALOG_FILTER_NONE;
+	filter->decimation = 1U;
+	AnalogFilter_Reset(filter);
+}
+
+/**
+ * Configures the type and decimation of a filter and resets it. A filter of type ANALOG_FILTER_NONE always has a
+ * decimation of 1. The filter must not be in use by sampling while it is configured.
+ *
+ * @param filter AnalogFilter_t* The filter to configure.
+ * @param type AnalogFilterType_t The filter to apply.
+ * @param decimation uint16_t The number of input samples per output sample, between 1 and
+ * ANALOG_FILTER_MAX_DECIMATION, or ANALOG_FILTER_FIR_MAX_DECIMATION for the FIR filter.
+ * @retval bool FALSE if the configuration is invalid, in which case the filter is unchanged.
+ */
+bool AnalogFilter_Configure(AnalogFilter_t* filter, AnalogFilterType_t type, uint16_t decimation) {
+	if ((type >= NUM_ANALOG_FILTER_TYPES) || (decimation == 0U) || (decimation > ANALOG_FILTER_MAX_DECIMATION)
+			|| ((type == ANALOG_FILTER_FIR) && (decimation > ANALOG_FILTER_FIR_MAX_DECIMATION))) {
+#ifdef ANALOG_FILTER_DEBUG
+		printf("[Analog Filter] Invalid filter configuration, type %i with decimation %i.\n\r", type, decimation);
+#endif
+		return false;
+	}
+	filter->type = type;
+	filter->decimation = (type == ANALOG_FILTER_NONE) ? 1U : decimation;
+	AnalogFilter_Reset(filter);
+	if (type == ANALOG_FILTER_FIR) {
+		DesignFIR(filter);
+	} else if (type == ANALOG_FILTER_CIC) {
+		filter->state.cic.scale = 1;
+		for (uint_fast8_t i = 0U; i < ANALOG_FILTER_CIC_ORDER; ++i) {
+			filter->state.cic.scale *= filter->decimation;
+		}
+	}
+	return true;
+}
+
+/**
+ * Discards the state of a filter so it starts again from the next sample, keeping its configuration. Called
+ * whenever sampling begins so blocks do not span separate sampling runs.
+ *
+ * @param filter AnalogFilter_t* The filter to reset.
+ * @retval none
+ */
+void AnalogFilter_Reset(AnalogFilter_t* filter) {
+	filter->count = 0U;
+	filter->primed = false;
+	switch (filter->type) {
+	case ANALOG_FILTER_AVERAGE:
+		filter->state.average.sum = 0;
+		break;
+	case ANALOG_FILTER_CIC:
+		memset(filter->state.cic.integrators, 0, sizeof(filter->state.cic.integrators));
+		memset(filter->state.cic.combs, 0, sizeof(filter->state.cic.combs));
+		filter->state.cic.settling = ANALOG_FILTER_CIC_ORDER;
+		break;
+	case ANALOG_FILTER_FIR:
+		filter->state.fir.newest = 0U;
+		break;
+	case ANALOG_FILTER_NONE:
+	case NUM_ANALOG_FILTER_TYPES:
+	default:
+		break;
+	}
+}
+
+/**
+ * Passes a sample through a filter. Called from the DRDY interrupt for every sample of the filter's input.
+ *
+ * The CIC filter holds back its first ANALOG_FILTER_CIC_ORDER outputs while its combs settle, and the FIR filter
+ * starts with its history filled by its first sample, so neither reports the transient of starting from zero.
+ *
+ * @param filter AnalogFilter_t* The filter to apply.
+ * @param value int32_t* The sample to filter. Replaced by the filter's output when one is produced.
+ * @retval bool TRUE if an output sample was produced.
+ */
+bool AnalogFilter_Process(AnalogFilter_t* filter, int32_t* value) {
+	const int32_t sample = *value;
+	int64_t output = sample;
+	switch (filter->type) {
+	case ANALOG_FILTER_AVERAGE:
+		filter->state.average.sum += sample;
+		if (++(filter->count) < filter->decimation) {
+			return false;
+		}
+		output = DivideRounded(filter->state.average.sum, filter->decimation);
+		filter->state.average.sum = 0;
+		break;
+	case ANALOG_FILTER_CIC: {
+		/* Integrators run at the input rate, wrapping modulo 2^64 which the combs undo */
+		uint64_t stage = (uint64_t) (int64_t) sample;
+		for (uint_fast8_t i = 0U; i < ANALOG_FILTER_CIC_ORDER; ++i) {
+			filter->state.cic.integrators[i] += stage;
+			stage = filter->state.cic.integrators[i];
+		}
+		if (++(filter->count) < filter->decimation) {
+			return false;
+		}
+		/* Combs run at the output rate */
+		for (uint_fast8_t i = 0U; i < ANALOG_FILTER_CIC_ORDER; ++i) {
+			const uint64_t delayed = filter->state.cic.combs[i];
+			filter->state.cic.combs[i] = stage;
+			stage -= delayed;
+		}
+		filter->count = 0U;
+		if (filter->state.cic.settling > 0U) {
+			--(filter->state.cic.settling);
+			return false;
+		}
+		output = DivideRounded((int64_t) stage, filter->state.cic.scale);
+		break;
+	}
+	case ANALOG_FILTER_FIR: {
+		int32_t* history = filter->state.fir.history;
+		if (filter->primed == false) {
+			for (uint_fast8_t i = 0U; i < ANALOG_FILTER_FIR_TAPS; ++i) {
+				history[i] = sample;
+			}
+		}
+		filter->state.fir.newest = (uint8_t) ((filter->state.fir.newest + 1U) & FIR_HISTORY_MASK);
+		history[filter->state.fir.newest] = sample;
+		filter->primed = true;
+		if (++(filter->count) < filter->decimation) {
+			return false;
+		}
+		/* Only the outputs which are kept are computed */
+		int64_t accumulator = 0;
+		uint_fast8_t index = filter->state.fir.newest;
+		for (uint_fast8_t i = 0U; i < ANALOG_FILTER_FIR_TAPS; ++i) {
+			accumulator += (int64_t) filter->state.fir.coefficients[i] * history[index];
+			index = (index - 1U) & FIR_HISTORY_MASK;
+		}
+		output = (accumulator + (1LL << (FIR_COEFFICIENT_BITS - 1U))) >> FIR_COEFFICIENT_BITS;
+		break;
+	}
+	case ANALOG_FILTER_NONE:
+	case NUM_ANALOG_FILTER_TYPES:
+	default:
+		return true;
+	}
+	filter->count = 0U;
+	filter->primed = true;
+	*value = SaturateOutput(output);
+	return true;
+}
+
+/**
+ * Return the human readable string representation of the provided filter type.
+ *
+ * @param type AnalogFilterType_t The filter type.
+ * @retval const char* The string representation.
+ */
+const char* AnalogFilter_StringFromType(AnalogFilterType_t type) {
+	return (type < NUM_ANALOG_FILTER_TYPES) ? FILTER_TYPE_STRINGS[type] : "UNKNOWN";
+}
+
+/**
+ * Convert a human readable string into the relevant AnalogFilterType_t value.
+ *
+ * @param str const char* The string to convert.
+ * @retval AnalogFilterType_t The filter type, or NUM_ANALOG_FILTER_TYPES if the string is not recognized.
+ */
+AnalogFilterType_t AnalogFilter_StringToType(const char* str) {
+	for (uint_fast8_t i = 0U; i < NUM_ANALOG_FILTER_TYPES; ++i) {
+		if (strcmp(str, FILTER_TYPE_STRINGS[i]) == 0) {
+			return (AnalogFilterType_t) i;
+		}
+	}
+	return NUM_ANALOG_FILTER_TYPES;
+}
@@ -0,0 +1,741 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file AnalogInput_Math.c
+ * @brief Implements the math channels of the analog inputs.
+ *
+ * A math channel's expression is written with the analog inputs as A followed by their number, decimal constants, the
+ * operators + - * and / and parentheses, for example (A0-A1)*2.5. It is compiled once, by recursive descent, into a
+ * short bytecode for a stack machine, so nothing is parsed in the DRDY interrupt. Each sample of a used input is kept
+ * as it arrives, and once every input of the expression has been sampled in the scan the bytecode is run on 64 bit
+ * fixed point values with 16 fractional bits. Every step saturates rather than wrapping, so a result is either correct
+ * or marked. Constants are rounded to the nearest 1/65536, so a small scale factor is better written as a division,
+ * A0/1000 rather than A0*0.001. The results are queued for the main loop to write, and the raw samples of the inputs
+ * can be left out of the stream so the derived values take their place.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "AnalogInput_Math.h"
+#include "Analog_Input.h"
+#include "Tekdaqc_RingBuffer.h"
+#include <string.h>
+
+#ifdef ANALOG_MATH_DEBUG
+#include <stdio.h>
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* Bytecode opcodes, held in the high nibble of an instruction */
+#define MATH_OP_INPUT 0x1U
+#define MATH_OP_CONSTANT 0x2U
+#define MATH_OP_ADD 0x3U
+#define MATH_OP_SUBTRACT 0x4U
+#define MATH_OP_MULTIPLY 0x5U
+#define MATH_OP_DIVIDE 0x6U
+#define MATH_OP_NEGATE 0x7U
+
+/* Builds an instruction from an opcode and operand */
+#define MATH_INSTRUCTION(op, operand) ((uint8_t) (((op) << 4U) | ((operand) & 0x0FU)))
+
+/* The largest magnitude of a fixed point value, which leaves room to multiply without overflowing an int64_t */
+#define MATH_VALUE_LIMIT ((int64_t) ((1LL << 47) - 1))
+
+/* The fixed point value of one */
+#define MATH_ONE ((int64_t) (1LL << ANALOG_MATH_FRACTION_BITS))
+
+/* The most decimal digits of a constant's fraction which are used */
+#define MATH_MAX_FRACTION_DIGITS 6U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Data structure holding the state of an expression being compiled.
+ */
+typedef struct {
+	const char* text; /**< The expression. */
+	uint8_t position; /**< The index of the next character of the expression. */
+	uint8_t depth; /**< The depth of the evaluation stack after the code emitted so far. */
+	AnalogMathChannel_t* channel; /**< The channel being compiled into. */
+	AnalogMathStatus_t status; /**< The first error found, ANALOG_MATH_OK if none. */
+} AnalogMathCompiler_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The math channels */
+static AnalogMathChannel_t channels[ANALOG_MATH_MAX_CHANNELS];
+
+/* The results waiting to be written */
+static AnalogMathResult_t results[ANALOG_MATH_RESULT_BUFFER_SIZE];
+
+/* The indices of the results ring */
+static RingBuffer_t resultRing = { 0U, 0U, ANALOG_MATH_RESULT_BUFFER_SIZE - 1U, 0U };
+
+/* True for the inputs whose raw samples are replaced by math channels */
+static bool rawHidden[NUM_ANALOG_INPUTS];
+
+/* The strings for each status value */
+static const char* STATUS_STRINGS[NUM_ANALOG_MATH_STATUSES] = { "OK", "BAD CHANNEL", "SYNTAX ERROR", "BAD INPUT",
+		"TOO COMPLEX" };
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Records the first error found while compiling.
+ */
+static void CompileError(AnalogMathCompiler_t* compiler, AnalogMathStatus_t status);
+
+/**
+ * @internal
+ * @brief Appends an instruction to the code being compiled.
+ */
+static void Emit(AnalogMathCompiler_t* compiler, uint8_t op, uint8_t operand);
+
+/**
+ * @internal
+ * @brief Compiles a sum or difference of terms.
+ */
+static void CompileExpression(AnalogMathCompiler_t* compiler);
+
+/**
+ * @internal
+ * @brief Compiles a product or quotient of factors.
+ */
+static void CompileTerm(AnalogMathCompiler_t* compiler);
+
+/**
+ * @internal
+ * @brief Compiles a factor, which may be negated.
+ */
+static void CompileFactor(AnalogMathCompiler_t* compiler);
+
+/**
+ * @internal
+ * @brief Compiles an input reference, a constant or a parenthesized expression.
+ */
+static void CompilePrimary(AnalogMathCompiler_t* compiler);
+
+/**
+ * @internal
+ * @brief Compiles a decimal constant.
+ */
+static void CompileConstant(AnalogMathCompiler_t* compiler);
+
+/**
+ * @internal
+ * @brief Compiles a reference to an analog input.
+ */
+static void CompileInput(AnalogMathCompiler_t* compiler);
+
+/**
+ * @internal
+ * @brief Clamps a fixed point value to the allowed range.
+ */
+static int64_t Saturate(int64_t value, uint8_t* flags);
+
+/**
+ * @internal
+ * @brief Multiplies two fixed point values.
+ */
+static int64_t Multiply(int64_t a, int64_t b, uint8_t* flags);
+
+/**
+ * @internal
+ * @brief Divides two fixed point values.
+ */
+static int64_t Divide(int64_t a, int64_t b, uint8_t* flags);
+
+/**
+ * @internal
+ * @brief Runs a channel's bytecode on its latest input samples.
+ */
+static int64_t Evaluate(const AnalogMathChannel_t* channel, uint8_t* flags);
+
+/**
+ * @internal
+ * @brief Works out which inputs have their raw samples replaced.
+ */
+static void UpdateRawHidden(void);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Records the first error found while compiling. Later errors are usually a result of the first.
+ *
+ * @param compiler AnalogMathCompiler_t* The compiler state.
+ * @param status AnalogMathStatus_t The error found.
+ * @retval none
+ */
+static void CompileError(AnalogMathCompiler_t* compiler, AnalogMathStatus_t status) {
+	if (compiler->status == ANALOG_MATH_OK) {
+		compiler->status = status;
+	}
+}
+
+/**
+ * Appends an instruction to the code being compiled, tracking the depth of the stack it will need.
+ *
+ * @param compiler AnalogMathCompiler_t* The compiler state.
+ * @param op uint8_t The MATH_OP_ opcode.
+ * @param operand uint8_t The index of the input or constant, 0 for other opcodes.
+ * @retval none
+ */
+static void Emit(AnalogMathCompiler_t* compiler, uint8_t op, uint8_t operand) {
+	AnalogMathChannel_t* channel = compiler->channel;
+	if (channel->length >= ANALOG_MATH_MAX_CODE) {
+		CompileError(compiler, ANALOG_MATH_ERR_TOO_COMPLEX);
+		return;
+	}
+	if ((op == MATH_OP_INPUT) || (op == MATH_OP_CONSTANT)) {
+		if (compiler->depth >= ANALOG_MATH_MAX_STACK) {
+			CompileError(compiler, ANALOG_MATH_ERR_TOO_COMPLEX);
+			return;
+		}
+		++compiler->depth;
+	} else if (op != MATH_OP_NEGATE) {
+		--compiler->depth;
+	}
+	channel->code[channel->length++] = MATH_INSTRUCTION(op, operand);
+}
+
+/**
+ * Compiles a sum or difference of terms.
+ *
+ * @param compiler AnalogMathCompiler_t* The compiler state.
+ * @retval none
+ */
+static void CompileExpression(AnalogMathCompiler_t* compiler) {
+	CompileTerm(compiler);
+	while (compiler->status == ANALOG_MATH_OK) {
+		const char c = compiler->text[compiler->position];
+		if ((c != '+') && (c != '-')) {
+			break;
+		}
+		++compiler->position;
+		CompileTerm(compiler);
+		Emit(compiler, (c == '+') ? MATH_OP_ADD : MATH_OP_SUBTRACT, 0U);
+	}
+}
+
+/**
+ * Compiles a product or quotient of factors.
+ *
+ * @param compiler AnalogMathCompiler_t* The compiler state.
+ * @retval none
+ */
+static void CompileTerm(AnalogMathCompiler_t* compiler) {
+	CompileFactor(compiler);
+	while (compiler->status == ANALOG_MATH_OK) {
+		const char c = compiler->text[compiler->position];
+		if ((c != '*') && (c != '/')) {
+			break;
+		}
+		++compiler->position;
+		CompileFactor(compiler);
+		Emit(compiler, (c == '*') ? MATH_OP_MULTIPLY : MATH_OP_DIVIDE, 0U);
+	}
+}
+
+/**
+ * Compiles a factor, which may be negated.
+ *
+ * @param compiler AnalogMathCompiler_t* The compiler state.
+ * @retval none
+ */
+static void CompileFactor(AnalogMathCompiler_t* compiler) {
+	if (compiler->text[compiler->position] == '-') {
+		++compiler->position;
+		CompileFactor(compiler);
+		Emit(compiler, MATH_OP_NEGATE, 0U);
+	} else {
+		CompilePrimary(compiler);
+	}
+}
+
+/**
+ * Compiles an input reference, a constant or a parenthesized expression.
+ *
+ * @param compiler AnalogMathCompiler_t* The compiler state.
+ * @retval none
+ */
+static void CompilePrimary(AnalogMathCompiler_t* compiler) {
+	const char c = compiler->text[compiler->position];
+	if (c == '(') {
+		++compiler->position;
+		CompileExpression(compiler);
+		if (compiler->text[compiler->position] == ')') {
+			++compiler->position;
+		} else {
+			CompileError(compiler, ANALOG_MATH_ERR_SYNTAX);
+		}
+	} else if (c == 'A') {
+		++compiler->position;
+		CompileInput(compiler);
+	} else if (((c >= '0') && (c <= '9')) || (c == '.')) {
+		CompileConstant(compiler);
+	} else {
+		CompileError(compiler, ANALOG_MATH_ERR_SYNTAX);
+	}
+}
+
+/**
+ * Compiles a decimal constant, adding it to the channel's constants unless it is already there.
+ *
+ * @param compiler AnalogMathCompiler_t* The compiler state.
+ * @retval none
+ */
+static void CompileConstant(AnalogMathCompiler_t* compiler) {
+	const char* text = compiler->text;
+	uint64_t whole = 0U;
+	uint64_t fraction = 0U;
+	uint64_t scale = 1U;
+	bool digits = false;
+	while ((text[compiler->position] >= '0') && (text[compiler->position] <= '9')) {
+		whole = (whole * 10U) + (uint64_t) (text[compiler->position++] - '0');
+		if (whole > (uint64_t) (MATH_VALUE_LIMIT >> ANALOG_MATH_FRACTION_BITS)) {
+			CompileError(compiler, ANALOG_MATH_ERR_SYNTAX);
+			return;
+		}
+		digits = true;
+	}
+	if (text[compiler->position] == '.') {
+		++compiler->position;
+		while ((text[compiler->position] >= '0') && (text[compiler->position] <= '9')) {
+			if (scale < 1000000U) {
+				fraction = (fraction * 10U) + (uint64_t) (text[compiler->position] - '0');
+				scale *= 10U;
+			}
+			++compiler->position;
+			digits = true;
+		}
+	}
+	if (digits == false) {
+		CompileError(compiler, ANALOG_MATH_ERR_SYNTAX);
+		return;
+	}
+	/* Round the fraction to the nearest fixed point step */
+	const int64_t value = (int64_t) ((whole << ANALOG_MATH_FRACTION_BITS)
+			+ (((fraction << ANALOG_MATH_FRACTION_BITS) + (scale / 2U)) / scale));
+	AnalogMathChannel_t* channel = compiler->channel;
+	uint8_t index = 0U;
+	while ((index < channel->numberConstants) && (channel->constants[index] != value)) {
+		++index;
+	}
+	if (index == channel->numberConstants) {
+		if (index >= ANALOG_MATH_MAX_CONSTANTS) {
+			CompileError(compiler, ANALOG_MATH_ERR_TOO_COMPLEX);
+			return;
+		}
+		channel->constants[channel->numberConstants++] = value;
+	}
+	Emit(compiler, MATH_OP_CONSTANT, index);
+}
+
+/**
+ * Compiles a reference to an analog input, following its 'A', adding the input to the channel's inputs unless it is
+ * already there.
+ *
+ * @param compiler AnalogMathCompiler_t* The compiler state.
+ * @retval none
+ */
+static void CompileInput(AnalogMathCompiler_t* compiler) {
+	const char* text = compiler->text;
+	uint32_t number = 0U;
+	bool digits = false;
+	while ((text[compiler->position] >= '0') && (text[compiler->position] <= '9')) {
+		number = (number * 10U) + (uint32_t) (text[compiler->position++] - '0');
+		if (number >= NUM_ANALOG_INPUTS) {
+			CompileError(compiler, ANALOG_MATH_ERR_INPUT);
+			return;
+		}
+		digits = true;
+	}
+	if (digits == false) {
+		CompileError(compiler, ANALOG_MATH_ERR_SYNTAX);
+		return;
+	}
+	const Analog_Input_t* analog = GetAnalogInputByNumber((uint8_t) number);
+	if (analog == NULL) {
+		CompileError(compiler, ANALOG_MATH_ERR_INPUT);
+		return;
+	}
+	AnalogMathChannel_t* channel = compiler->channel;
+	uint8_t index = 0U;
+	while ((index < channel->numberInputs) && (channel->inputs[index] != analog->physicalInput)) {
+		++index;
+	}
+	if (index == channel->numberInputs) {
+		if (index >= ANALOG_MATH_MAX_INPUTS) {
+			CompileError(compiler, ANALOG_MATH_ERR_TOO_COMPLEX);
+			return;
+		}
+		channel->inputs[channel->numberInputs++] = analog->physicalInput;
+	}
+	Emit(compiler, MATH_OP_INPUT, index);
+}
+
+/**
+ * Clamps a fixed point value to the allowed range.
+ *
+ * @param value int64_t The value.
+ * @param flags uint8_t* The evaluation's flags, to which ANALOG_MATH_FLAG_SATURATED is added if clamped.
+ * @retval int64_t The clamped value.
+ */
+static int64_t Saturate(int64_t value, uint8_t* flags) {
+	if (value > MATH_VALUE_LIMIT) {
+		*flags |= ANALOG_MATH_FLAG_SATURATED;
+		return MATH_VALUE_LIMIT;
+	} else if (value < -MATH_VALUE_LIMIT) {
+		*flags |= ANALOG_MATH_FLAG_SATURATED;
+		return -MATH_VALUE_LIMIT;
+	}
+	return value;
+}
+
+/**
+ * Multiplies two fixed point values. The second is split into its whole and fractional parts so neither partial
+ * product can overflow before it is checked.
+ *
+ * @param a int64_t The first value, within the allowed range.
+ * @param b int64_t The second value, within the allowed range.
+ * @param flags uint8_t* The evaluation's flags.
+ * @retval int64_t The saturated product.
+ */
+static int64_t Multiply(int64_t a, int64_t b, uint8_t* flags) {
+	const int64_t high = b >> ANALOG_MATH_FRACTION_BITS;
+	const int64_t low = b & (MATH_ONE - 1);
+	int64_t product;
+	if (__builtin_mul_overflow(a, high, &product) || (product > MATH_VALUE_LIMIT) || (product < -MATH_VALUE_LIMIT)) {
+		*flags |= ANALOG_MATH_FLAG_SATURATED;
+		return (((a < 0) != (b < 0)) ? -MATH_VALUE_LIMIT : MATH_VALUE_LIMIT);
+	}
+	return Saturate(product + ((a * low) >> ANALOG_MATH_FRACTION_BITS), flags);
+}
+
+/**
+ * Divides two fixed point values. The quotient is worked out from the integer quotient and remainder so the dividend
+ * never needs shifting beyond 64 bits.
+ *
+ * @param a int64_t The dividend, within the allowed range.
+ * @param b int64_t The divisor, within the allowed range.
+ * @param flags uint8_t* The evaluation's flags, to which ANALOG_MATH_FLAG_DIVIDE_BY_ZERO is added for a zero divisor.
+ * @retval int64_t The saturated quotient.
+ */
+static int64_t Divide(int64_t a, int64_t b, uint8_t* flags) {
+	if (b == 0) {
+		*flags |= ANALOG_MATH_FLAG_DIVIDE_BY_ZERO;
+		return ((a < 0) ? -MATH_VALUE_LIMIT : MATH_VALUE_LIMIT);
+	}
+	const int64_t quotient = a / b;
+	const int64_t remainder = a % b;
+	if ((quotient > (MATH_VALUE_LIMIT >> ANALOG_MATH_FRACTION_BITS))
+			|| (quotient < -(MATH_VALUE_LIMIT >> ANALOG_MATH_FRACTION_BITS))) {
+		*flags |= ANALOG_MATH_FLAG_SATURATED;
+		return (((a < 0) != (b < 0)) ? -MATH_VALUE_LIMIT : MATH_VALUE_LIMIT);
+	}
+	return Saturate((quotient * MATH_ONE) + ((remainder * MATH_ONE) / b), flags);
+}
+
+/**
+ * Runs a channel's bytecode on its latest input samples. The code was checked when compiled, so the stack can
+ * neither overflow nor underflow.
+ *
+ * @param channel const AnalogMathChannel_t* The channel to evaluate.
+ * @param flags uint8_t* Set to the ANALOG_MATH_FLAG_ bits of the evaluation.
+ * @retval int64_t The fixed point result.
+ */
+static int64_t Evaluate(const AnalogMathChannel_t* channel, uint8_t* flags) {
+	int64_t stack[ANALOG_MATH_MAX_STACK];
+	uint8_t depth = 0U;
+	*flags = 0U;
+	for (uint8_t pc = 0U; pc < channel->length; ++pc) {
+		const uint8_t instruction = channel->code[pc];
+		const uint8_t operand = instruction & 0x0FU;
+		switch (instruction >> 4U) {
+		case MATH_OP_INPUT:
+			stack[depth++] = channel->values[operand];
+			break;
+		case MATH_OP_CONSTANT:
+			stack[depth++] = channel->constants[operand];
+			break;
+		case MATH_OP_ADD:
+			--depth;
+			stack[depth - 1U] = Saturate(stack[depth - 1U] + stack[depth], flags);
+			break;
+		case MATH_OP_SUBTRACT:
+			--depth;
+			stack[depth - 1U] = Saturate(stack[depth - 1U] - stack[depth], flags);
+			break;
+		case MATH_OP_MULTIPLY:
+			--depth;
+			stack[depth - 1U] = Multiply(stack[depth - 1U], stack[depth], flags);
+			break;
+		case MATH_OP_DIVIDE:
+			--depth;
+			stack[depth - 1U] = Divide(stack[depth - 1U], stack[depth], flags);
+			break;
+		case MATH_OP_NEGATE:
+			stack[depth - 1U] = -stack[depth - 1U];
+			break;
+		default:
+			break;
+		}
+	}
+	return stack[0];
+}
+
+/**
+ * Works out which inputs have their raw samples replaced, from the inputs of the channels without the raw option.
+ *
+ * @param none
+ * @retval none
+ */
+static void UpdateRawHidden(void) {
+	bool hidden[NUM_ANALOG_INPUTS];
+	memset(hidden, 0, sizeof(hidden));
+	for (uint8_t i = 0U; i < ANALOG_MATH_MAX_CHANNELS; ++i) {
+		const AnalogMathChannel_t* channel = &channels[i];
+		if ((channel->enabled == false) || (channel->raw == true)) {
+			continue;
+		}
+		for (uint8_t j = 0U; j < channel->numberInputs; ++j) {
+			if (channel->inputs[j] < NUM_ANALOG_INPUTS) {
+				hidden[channel->inputs[j]] = true;
+			}
+		}
+	}
+	memcpy(rawHidden, hidden, sizeof(rawHidden));
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Compiles an expression into a math channel, replacing any expression it had. The channel is left unchanged if the
+ * expression does not compile.
+ *
+ * @param channel uint8_t The number of the math channel.
+ * @param expression const char* The expression, NULL terminated.
+ * @param raw bool True if the raw samples of the expression's inputs should still be written.
+ * @retval AnalogMathStatus_t ANALOG_MATH_OK if the channel was set, otherwise the reason it was not.
+ */
+AnalogMathStatus_t AnalogMath_Set(uint8_t channel, const char* expression, bool raw) {
+	if (channel >= ANALOG_MATH_MAX_CHANNELS) {
+		return ANALOG_MATH_ERR_CHANNEL;
+	}
+	if ((expression == NULL) || (strlen(expression) >= ANALOG_MATH_MAX_EXPRESSION)) {
+		return ANALOG_MATH_ERR_SYNTAX;
+	}
+	AnalogMathChannel_t compiled;
+	memset(&compiled, 0, sizeof(compiled));
+	AnalogMathCompiler_t compiler = { expression, 0U, 0U, &compiled, ANALOG_MATH_OK };
+	CompileExpression(&compiler);
+	if ((compiler.status == ANALOG_MATH_OK) && (expression[compiler.position] != '\0')) {
+		CompileError(&compiler, ANALOG_MATH_ERR_SYNTAX);
+	}
+	if (compiled.numberInputs == 0U) {
+		/* Without an input there is no scan to evaluate it on */
+		CompileError(&compiler, ANALOG_MATH_ERR_INPUT);
+	}
+	if (compiler.status != ANALOG_MATH_OK) {
+#ifdef ANALOG_MATH_DEBUG
+		printf("[Analog Math] Channel %i expression %s failed at %i: %s\n\r", channel, expression,
+				compiler.position, AnalogMath_StatusToString(compiler.status));
+#endif
+		return compiler.status;
+	}
+	strcpy(compiled.expression, expression);
+	compiled.enabled = true;
+	compiled.raw = raw;
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	channels[channel] = compiled;
+	UpdateRawHidden();
+	__set_PRIMASK(primask);
+#ifdef ANALOG_MATH_DEBUG
+	printf("[Analog Math] Channel %i compiled %s to %i instructions on %i inputs.\n\r", channel, expression,
+			compiled.length, compiled.numberInputs);
+#endif
+	return ANALOG_MATH_OK;
+}
+
+/**
+ * Removes a math channel. Results it has already queued are still written.
+ *
+ * @param channel uint8_t The number of the math channel.
+ * @retval bool True if the channel number is valid.
+ */
+bool AnalogMath_Clear(uint8_t channel) {
+	if (channel >= ANALOG_MATH_MAX_CHANNELS) {
+		return false;
+	}
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	channels[channel].enabled = false;
+	UpdateRawHidden();
+	__set_PRIMASK(primask);
+	return true;
+}
+
+/**
+ * Retrieves a copy of a math channel, taken with interrupts disabled so its counts are consistent.
+ *
+ * @param channel uint8_t The number of the math channel.
+ * @param copy AnalogMathChannel_t* Pointer/Reference to the structure to fill in.
+ * @retval bool True if the channel number is valid.
+ */
+bool AnalogMath_Get(uint8_t channel, AnalogMathChannel_t* copy) {
+	if (channel >= ANALOG_MATH_MAX_CHANNELS) {
+		return false;
+	}
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	*copy = channels[channel];
+	__set_PRIMASK(primask);
+	return true;
+}
+
+/**
+ * Discards the partial scans and waiting results of every math channel, as when sampling starts. Must not be called
+ * while sampling.
+ *
+ * @param none
+ * @retval none
+ */
+void AnalogMath_Reset(void) {
+	for (uint8_t i = 0U; i < ANALOG_MATH_MAX_CHANNELS; ++i) {
+		channels[i].fresh = 0U;
+	}
+	RingBuffer_Init(&resultRing, ANALOG_MATH_RESULT_BUFFER_SIZE);
+}
+
+/**
+ * Adds a sample to the math channels which use its input. A channel is evaluated once every one of its inputs has
+ * been sampled since its last evaluation, which for a scan is when the last of them is converted. Called from the
+ * DRDY interrupt for every sample of the scan.
+ *
+ * @param input PhysicalAnalogInput_t The input the sample was taken from.
+ * @param value int32_t The sample.
+ * @param timestamp uint64_t The timestamp of the sample.
+ * @retval none
+ */
+void AnalogMath_Process(PhysicalAnalogInput_t input, int32_t value, uint64_t timestamp) {
+	for (uint8_t i = 0U; i < ANALOG_MATH_MAX_CHANNELS; ++i) {
+		AnalogMathChannel_t* channel = &channels[i];
+		if (channel->enabled == false) {
+			continue;
+		}
+		for (uint8_t j = 0U; j < channel->numberInputs; ++j) {
+			if (channel->inputs[j] == input) {
+				channel->values[j] = ((int64_t) value) * MATH_ONE;
+				channel->fresh |= (uint8_t) (1U << j);
+				channel->timestamp = timestamp;
+			}
+		}
+		if ((channel->numberInputs == 0U) || (channel->fresh != (uint8_t) ((1U << channel->numberInputs) - 1U))) {
+			continue;
+		}
+		channel->fresh = 0U;
+		uint8_t flags;
+		const int64_t result = Evaluate(channel, &flags);
+		++channel->evaluations;
+		uint32_t index;
+		if (RingBuffer_BeginWrite(&resultRing, &index) == false) {
+			++channel->dropped;
+			continue;
+		}
+		results[index].timestamp = channel->timestamp;
+		results[index].value = ((float) result) / ((float) MATH_ONE);
+		results[index].channel = i;
+		results[index].flags = flags;
+		RingBuffer_EndWrite(&resultRing);
+	}
+}
+
+/**
+ * Determines if the raw samples of an analog input are replaced by math channels, and so should not be written.
+ * Called from the DRDY interrupt.
+ *
+ * @param input PhysicalAnalogInput_t The input to check.
+ * @retval bool True if its raw samples are replaced.
+ */
+bool AnalogMath_IsRawHidden(PhysicalAnalogInput_t input) {
+	return ((input < NUM_ANALOG_INPUTS) && (rawHidden[input] == true));
+}
+
+/**
+ * Determines if any math channel results are waiting to be written.
+ *
+ * @param none
+ * @retval bool True if results are waiting.
+ */
+bool AnalogMath_IsPending(void) {
+	return (RingBuffer_IsEmpty(&resultRing) == false);
+}
+
+/**
+ * Retrieves the oldest math channel results waiting to be written, as many as are stored one after another. They
+ * stay waiting until released with AnalogMath_ReleaseResults(), so a write which could not be sent may be retried.
+ *
+ * @param oldest const AnalogMathResult_t** Set to the oldest result.
+ * @retval uint32_t The number of results which follow on from it.
+ */
+uint32_t AnalogMath_PeekResults(const AnalogMathResult_t** oldest) {
+	const uint32_t count = RingBuffer_Count(&resultRing);
+	if (count == 0U) {
+		return 0U;
+	}
+	const uint32_t index = RingBuffer_PeekIndex(&resultRing, 0U);
+	*oldest = &results[index];
+	return (count < (ANALOG_MATH_RESULT_BUFFER_SIZE - index)) ? count : (ANALOG_MATH_RESULT_BUFFER_SIZE - index);
+}
+
+/**
+ * Releases math channel results which have been written.
+ *
+ * @param count uint32_t The number of results, at most the number retrieved by AnalogMath_PeekResults().
+ * @retval none
+ */
+void AnalogMath_ReleaseResults(uint32_t count) {
+	RingBuffer_Release(&resultRing, count);
+}
+
+/**
+ * Convert an AnalogMathStatus_t value into a human readable string.
+ *
+ * @param status AnalogMathStatus_t The status to convert.
+ * @retval const char* The human readable string.
+ */
+const char* AnalogMath_StatusToString(AnalogMathStatus_t status) {
+	return ((status < NUM_ANALOG_MATH_STATUSES) ? STATUS_STRINGS[status] : "UNKNOWN");
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file AnalogInput_Mixed.c
+ * @brief Implements the mixed-signal state of the analog scans.
+ *
+ * While enabled, the DRDY interrupt captures the levels of the digital inputs and outputs as it stores the first
+ * sample of each analog scan, stamped with that sample's timestamp. The inputs are read as one snapshot of the GPI
+ * ports, debounced where configured, and the outputs are the levels last sent to the relay drivers, so the capture
+ * costs a handful of register reads. The states are queued for the main loop, which writes them into the analog
+ * stream after the samples of their scan, so a client sees the digital state of every scan without joining the
+ * separate digital streams by time.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "AnalogInput_Mixed.h"
+#include "Digital_Input.h"
+#include "Digital_Output.h"
+#include "Tekdaqc_RingBuffer.h"
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* TRUE while the digital state is captured with each scan */
+static volatile bool mixedEnabled = false;
+
+/* Storage of the captured states waiting to be written */
+static AnalogMixedState_t states[ANALOG_MIXED_BUFFER_SIZE];
+
+/* Indices of the captured states, written from the DRDY interrupt and read from the main loop */
+static RingBuffer_t stateRing;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Turns the capture of the digital state with each analog scan on or off. It may be changed while sampling, the
+ * next scan being the first or the last captured.
+ *
+ * @param enabled bool TRUE to capture the digital state with each scan.
+ * @retval none
+ */
+void AnalogMixed_SetEnabled(bool enabled) {
+	mixedEnabled = enabled;
+}
+
+/**
+ * Determines if the digital state is captured with each analog scan.
+ *
+ * @param none
+ * @retval bool TRUE if the digital state is captured.
+ */
+bool AnalogMixed_IsEnabled(void) {
+	return mixedEnabled;
+}
+
+/**
+ * Discards the captured states waiting to be written. Called as sampling starts, while the DRDY interrupt is idle.
+ *
+ * @param none
+ * @retval none
+ */
+void AnalogMixed_Reset(void) {
+	RingBuffer_Init(&stateRing, ANALOG_MIXED_BUFFER_SIZE);
+}
+
+/**
+ * Captures the levels of the digital inputs and outputs at the instant of an analog scan. Called from the DRDY
+ * interrupt with the scan's first sample. If the buffer is full the state is dropped and counted.
+ *
+ * @param timestamp uint64_t The timestamp of the scan's first sample.
+ * @retval none
+ */
+void AnalogMixed_Capture(uint64_t timestamp) {
+	if (mixedEnabled == false) {
+		return;
+	}
+	uint32_t index;
+	if (RingBuffer_BeginWrite(&stateRing, &index) == false) {
+		/* Counted by the ring */
+		return;
+	}
+	states[index].timestamp = timestamp;
+	states[index].inputs = ReadDigitalInputLevels();
+	states[index].outputs = GetDigitalOutputLevels();
+	RingBuffer_EndWrite(&stateRing);
+}
+
+/**
+ * Determines if any captured states are waiting to be written.
+ *
+ * @param none
+ * @retval bool True if states are waiting.
+ */
+bool AnalogMixed_IsPending(void) {
+	return (RingBuffer_IsEmpty(&stateRing) == false);
+}
+
+/**
+ * Retrieves the oldest captured states waiting to be written, as many as are stored one after another. They stay
+ * waiting until released with AnalogMixed_ReleaseStates(), so a write which could not be sent may be retried.
+ *
+ * @param oldest const AnalogMixedState_t** Set to the oldest state.
+ * @retval uint32_t The number of states which follow on from it.
+ */
+uint32_t AnalogMixed_PeekStates(const AnalogMixedState_t** oldest) {
+	const uint32_t count = RingBuffer_Count(&stateRing);
+	if (count == 0U) {
+		return 0U;
+	}
+	const uint32_t index = RingBuffer_PeekIndex(&stateRing, 0U);
+	*oldest = &states[index];
+	return (count < (ANALOG_MIXED_BUFFER_SIZE - index)) ? count : (ANALOG_MIXED_BUFFER_SIZE - index);
+}
+
+/**
+ * Releases captured states which have been written, or which could not be delivered.
+ *
+ * @param count uint32_t The number of states, at most the number retrieved by AnalogMixed_PeekStates().
+ * @retval none
+ */
+void AnalogMixed_ReleaseStates(uint32_t count) {
+	RingBuffer_Release(&stateRing, count);
+}
+
+/**
+ * Retrieves the number of captured states dropped since sampling started because the buffer was full.
+ *
+ * @param none
+ * @retval uint32_t The number of dropped states.
+ */
+uint32_t AnalogMixed_GetDroppedCount(void) {
+	return RingBuffer_GetOverflowCount(&stateRing);
+}
@@ -32,23 +32,56 @@
 #include "AnalogInput_Multiplexer.h"
 #include "ADC_StateMachine.h"
 #include "ADS1256_Driver.h"
-#include "Tekdaqc_Timers.h"
 #include "TelnetServer.h"
 
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE DEFINES */
 /*--------------------------------------------------------------------------------------------------------*/
 
+#ifdef EXT_MUX_ADC_GPIO
+/* The select lines of the external multiplexer's port value which are driven by the ADC's GPIO pins */
+#define EXT_MUX_ADC_LINES	((uint16_t) ((uint16_t) EXT_MUX_ADC_GPIO_MASK << EXT_MUX_ADC_GPIO_SHIFT))
+#endif
+
+/* Expand EXTERNAL_MUX_TABLE and INTERNAL_INPUT_TABLE entries to the elements of the lookup tables below */
+#define EXTERNAL_MUX_CODE(n, code) EXTERN_##n,
+#define INTERNAL_INPUT_CHANNELS(input, number, name, pos, neg) [input] = { pos, neg },
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief The pair of ADC inputs an internal input is read between.
+ */
+typedef struct {
+	ADS1256_AIN_t pos; /**< The positive ADC input. */
+	ADS1256_AIN_t neg; /**< The negative ADC input. */
+} InternalInputChannels_t;
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE VARIABLES */
 /*--------------------------------------------------------------------------------------------------------*/
 
-/* The system time at which the multiplexing process will be completed. */
-static uint64_t MuxCompleteTime = 0U;
+/* Set by the settle timer interrupt once the multiplexing process is completed. */
+static volatile bool MuxSettled = true;
+
+/* Made from the settle timer interrupt once the multiplexing process is completed. NULL for none. */
+static volatile MuxSettledCallback SettledCallback = NULL;
 
 /* The analog input which is currently selected. Used for reverting state when handling cold junction sampling. */
 static Analog_Input_t* CurrentInput = NULL;
 
+/* The external input the external multiplexer was switched to ahead of its selection. NULL for none. */
+static Analog_Input_t* volatile PreparedInput = NULL;
+
+/* The external multiplexer code of each external input, indexed by input number */
+static const ExternalMuxedInput_t EXTERNAL_MUX_CODES[NUM_EXT_ANALOG_INPUTS] = { EXTERNAL_MUX_TABLE(EXTERNAL_MUX_CODE) };
+
+/* The ADC inputs of each internal input, indexed by InternalAnalogInput_t */
+static const InternalInputChannels_t INTERNAL_INPUT_CHANNELS[] = { INTERNAL_INPUT_TABLE(INTERNAL_INPUT_CHANNELS) };
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE FUNCTION PROTOTYPES */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -57,7 +90,13 @@ static Analog_Input_t* CurrentInput = NULL;
  * @internal
  * @brief Selects the specified external input.
  */
-static void SelectExternalInput(ExternalMuxedInput_t input);
+static void SelectExternalInput(ExternalMuxedInput_t input, uint16_t settle);
+
+/**
+ * @internal
+ * @brief Writes the external multiplexer's select lines which are driven by the processor.
+ */
+static void WriteExternalMuxLines(ExternalMuxedInput_t input);
 
 /**
  * @internal
@@ -65,6 +104,24 @@ static void SelectExternalInput(ExternalMuxedInput_t input);
  */
 static void SelectInternalInput(InternalAnalogInput_t input);
 
+/**
+ * @internal
+ * @brief Selects the pair of ADC inputs of a differential input.
+ */
+static void SelectDifferentialInput(const Analog_Input_t* input);
+
+/**
+ * @internal
+ * @brief Configures the timer which measures the external multiplexer settle time.
+ */
+static void SettleTimerInit(void);
+
+/**
+ * @internal
+ * @brief Starts timing the settling of an external multiplexer switch.
+ */
+static void StartSettleTimer(uint16_t settle);
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE FUNCTIONS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -72,12 +129,14 @@ static void SelectInternalInput(InternalAnalogInput_t input);
 /**
  * Selects the specified external input. This will cause the board to temporarily enter the ADC_EXTERNAL_MUXING
  * state (which will also sample the boards temperature sensor). This function is non-blocking but any analog
- * sampling will be held up by the state machine until the muxing process is completed.
+ * sampling will be held up by the state machine until the muxing process is completed, which the settle timer
+ * signals the settle time after the switch. Any callback scheduled for a previous switch is dropped.
  *
  * @param input ExternalMuxedInput_t The external input to select.
+ * @param settle uint16_t The time in microseconds to allow the input to settle, at least 1.
  * @retval none
  */
-static void SelectExternalInput(ExternalMuxedInput_t input) {
+static void SelectExternalInput(ExternalMuxedInput_t input, uint16_t settle) {
 	/* Verify that the internal input parameter is set */
 	if (input == NULL_CHANNEL ) {
 #ifdef INPUT_MULTIPLEXER_DEBUG
@@ -86,14 +145,39 @@ static void SelectExternalInput(ExternalMuxedInput_t input) {
 		return;
 	}
 	/* Make the switch */
+#ifdef EXT_MUX_ADC_GPIO
+	/* The lines on the ADC's GPIO pins switch in the same register write which points the ADC at the external path */
+	PreparedInput = NULL;
+	ADS1256_SetInputChannelsAndGPIO(EXTERNAL_ANALOG_IN_AINP, EXTERNAL_ANALOG_IN_AINN, EXT_MUX_ADC_GPIO_MASK,
+			(uint8_t) ((uint16_t) input >> EXT_MUX_ADC_GPIO_SHIFT));
+#else
 	SelectInternalInput(EXTERNAL_ANALOG_IN);
-	GPIO_Write(EXT_ANALOG_IN_MUX_PORT, (input | (GPIO_ReadOutputData(EXT_ANALOG_IN_MUX_PORT ) & EXT_ANALOG_IN_BITMASK )));
+	PreparedInput = NULL;
+#endif
+	WriteExternalMuxLines(input);
 	/* Wait for the external multiplexing relays to conduct */
-	MuxCompleteTime = GetLocalTime() + EXTERNAL_MUX_DELAY;
+	StartSettleTimer(settle);
 	/* Change ADC state machine to ADC_MUXING state */
 	ADC_External_Muxing();
 }
 
+/**
+ * Writes the select lines of the external multiplexer which are driven by the processor's port, leaving the port's
+ * other pins as they are. On boards where the ADC's GPIO pins drive some of the lines, see EXT_MUX_ADC_GPIO, those
+ * are written with the ADC's registers instead.
+ *
+ * @param input ExternalMuxedInput_t The external input to switch the lines to.
+ * @retval none
+ */
+static void WriteExternalMuxLines(ExternalMuxedInput_t input) {
+#ifdef EXT_MUX_ADC_GPIO
+	GPIO_Write(EXT_ANALOG_IN_MUX_PORT, (((uint16_t) input & ~EXT_MUX_ADC_LINES)
+			| (GPIO_ReadOutputData(EXT_ANALOG_IN_MUX_PORT ) & (EXT_ANALOG_IN_BITMASK | EXT_MUX_ADC_LINES))));
+#else
+	GPIO_Write(EXT_ANALOG_IN_MUX_PORT, (input | (GPIO_ReadOutputData(EXT_ANALOG_IN_MUX_PORT ) & EXT_ANALOG_IN_BITMASK )));
+#endif
+}
+
 /**
  * Selects the specified internal input. NOTE: A SYNC command should be issued after calling this function to ensure the ADC
  * provides settled data on the next conversion.
@@ -109,37 +193,84 @@ static void SelectInternalInput(InternalAnalogInput_t input) {
 #endif
 		return;
 	}
-	ADS1256_AIN_t pos;
-	ADS1256_AIN_t neg;
-	/* Make the switch */
-	switch (input) {
-	case SUPPLY_9V:
-		pos = SUPPLY_9V_AINP;
-		neg = SUPPLY_9V_AINN;
-		break;
-	case SUPPLY_5V:
-		pos = SUPPLY_5V_AINP;
-		neg = SUPPLY_5V_AINN;
-		break;
-	case SUPPLY_3_3V:
-		pos = SUPPLY_3_3V_AINP;
-		neg = SUPPLY_3_3V_AINN;
-		break;
-	case COLD_JUNCTION:
-		pos = COLD_JUNCTION_AINP;
-		neg = COLD_JUNCTION_AINN;
-		break;
-	case EXTERNAL_ANALOG_IN:
-		pos = EXTERNAL_ANALOG_IN_AINP;
-		neg = EXTERNAL_ANALOG_IN_AINN;
-		break;
-	default:
+	if (input >= (sizeof(INTERNAL_INPUT_CHANNELS) / sizeof(INTERNAL_INPUT_CHANNELS[0]))) {
 #ifdef INPUT_MULTIPLEXER_DEBUG
 		printf("[Analog Input Multiplexer] The requested internal input is invalid.\n\r");
 #endif
 		return;
 	}
-	ADS1256_SetInputChannels(pos, neg);
+	PreparedInput = NULL; /* The ADC no longer follows the external multiplexer */
+	/* Make the switch */
+	ADS1256_SetInputChannels(INTERNAL_INPUT_CHANNELS[input].pos, INTERNAL_INPUT_CHANNELS[input].neg);
+}
+
+/**
+ * Selects the pair of ADC inputs of a differential input. The pair is switched by the ADC's own multiplexer, so like
+ * an internal input there is no settle time to wait for. NOTE: A SYNC command should be issued after calling this
+ * function to ensure the ADC provides settled data on the next conversion.
+ *
+ * @param input const Analog_Input_t* The differential input to select.
+ * @retval none
+ */
+static void SelectDifferentialInput(const Analog_Input_t* input) {
+	PreparedInput = NULL; /* The ADC no longer follows the external multiplexer */
+	ADS1256_SetInputChannels(input->positiveInput, input->negativeInput);
+}
+
+/**
+ * Starts timing the settling of an external multiplexer switch, restarting the timer if it is already running. Any
+ * callback scheduled for a previous switch is dropped.
+ *
+ * @param settle uint16_t The time in microseconds to allow the input to settle, at least 1.
+ * @retval none
+ */
+static void StartSettleTimer(uint16_t settle) {
+	SettledCallback = NULL;
+	MuxSettled = false;
+	/* Counting from 1 overflows settle ticks later. The reload is not preloaded, so it applies to this count, and
+	 * must not be 0, which would block the counter */
+	EXT_MUX_SETTLE_TIM->ARR = (settle > 0U) ? settle : 1U;
+	EXT_MUX_SETTLE_TIM->CNT = 1U;
+	EXT_MUX_SETTLE_TIM->CR1 |= TIM_CR1_CEN;
+}
+
+/**
+ * Configures the timer which measures the external multiplexer settle time. It counts microseconds in one pulse
+ * mode, so each switch loads the settle time, starts it and it stops itself with a single interrupt once it is over.
+ *
+ * @param none
+ * @retval none
+ */
+static void SettleTimerInit(void) {
+	TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+	NVIC_InitTypeDef NVIC_InitStructure;
+	RCC_ClocksTypeDef RCC_Clocks;
+	RCC_GetClocksFreq(&RCC_Clocks);
+	uint32_t timerClock = RCC_Clocks.PCLK1_Frequency;
+	if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+		timerClock *= 2U;
+	}
+
+	RCC_APB1PeriphClockCmd(EXT_MUX_SETTLE_TIM_CLK, ENABLE);
+
+	TIM_TimeBaseStructInit(&TIM_TimeBaseStructure);
+	/* Count at 1MHz, so the 16 bit counter covers ANALOG_INPUT_MAX_SETTLE_TIME */
+	TIM_TimeBaseStructure.TIM_Prescaler = (uint16_t) ((timerClock / 1000000U) - 1U);
+	TIM_TimeBaseStructure.TIM_Period = ANALOG_INPUT_DEFAULT_SETTLE_TIME;
+	TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+	TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+	TIM_TimeBaseInit(EXT_MUX_SETTLE_TIM, &TIM_TimeBaseStructure);
+	TIM_SelectOnePulseMode(EXT_MUX_SETTLE_TIM, TIM_OPMode_Single);
+	/* Loading the prescaler generates an update event, which must not count as a settled switch */
+	TIM_ClearITPendingBit(EXT_MUX_SETTLE_TIM, TIM_IT_Update);
+
+	NVIC_InitStructure.NVIC_IRQChannel = EXT_MUX_SETTLE_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = EXT_MUX_SETTLE_PREEMPT_PRIORITY;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0U;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+
+	TIM_ITConfig(EXT_MUX_SETTLE_TIM, TIM_IT_Update, ENABLE);
 }
 
 /*--------------------------------------------------------------------------------------------------------*/
@@ -153,14 +284,7 @@ static void SelectInternalInput(InternalAnalogInput_t input) {
  * @retval bool TRUE if the input is an external input.
  */
 bool isExternalInput(PhysicalAnalogInput_t input) {
-	return ((input == EXTERNAL_0) || (input == EXTERNAL_1) || (input == EXTERNAL_2) || (input == EXTERNAL_3) || (input == EXTERNAL_4)
-			|| (input == EXTERNAL_5) || (input == EXTERNAL_6) || (input == EXTERNAL_7) || (input == EXTERNAL_8) || (input == EXTERNAL_9)
-			|| (input == EXTERNAL_10) || (input == EXTERNAL_11) || (input == EXTERNAL_12) || (input == EXTERNAL_13)
-			|| (input == EXTERNAL_14) || (input == EXTERNAL_15) || (input == EXTERNAL_16) || (input == EXTERNAL_17)
-			|| (input == EXTERNAL_18) || (input == EXTERNAL_19) || (input == EXTERNAL_20) || (input == EXTERNAL_21)
-			|| (input == EXTERNAL_22) || (input == EXTERNAL_23) || (input == EXTERNAL_24) || (input == EXTERNAL_25)
-			|| (input == EXTERNAL_26) || (input == EXTERNAL_27) || (input == EXTERNAL_28) || (input == EXTERNAL_29)
-			|| (input == EXTERNAL_30) || (input == EXTERNAL_31));
+	return (input < NUM_EXT_ANALOG_INPUTS);
 }
 
 /**
@@ -173,6 +297,16 @@ bool isInternalInput(PhysicalAnalogInput_t input) {
 	return ((input == IN_SUPPLY_9V) || (input == IN_SUPPLY_5V) || (input == IN_SUPPLY_3_3V) || (input == IN_COLD_JUNCTION));
 }
 
+/**
+ * Checks if the specified analog input is a differential input, measuring a configurable pair of the ADC's inputs.
+ *
+ * @param input PhysicalAnalogInput_t The physical analog input to check.
+ * @retval bool TRUE if the input is a differential input.
+ */
+bool isDifferentialInput(PhysicalAnalogInput_t input) {
+	return ((input == DIFFERENTIAL_0) || (input == DIFFERENTIAL_1) || (input == DIFFERENTIAL_2) || (input == DIFFERENTIAL_3));
+}
+
 /**
  * Checks if the external multiplexing process has completed.
  *
@@ -180,7 +314,47 @@ bool isInternalInput(PhysicalAnalogInput_t input) {
  * @retval bool TRUE if the external multiplexing process is completed.
  */
 bool isExternalMuxingComplete(void) {
-	return (GetLocalTime() >= MuxCompleteTime) ? true : false;
+	return MuxSettled;
+}
+
+/**
+ * Requests a callback from the settle timer interrupt once the external multiplexer has settled, so that whatever
+ * waits on the switch can follow it with no more than the minimum dead time. The check and the scheduling are made
+ * with the interrupt masked, so a switch which settles meanwhile is never missed. Only one callback is held and it
+ * is dropped by the next switch.
+ *
+ * @param callback MuxSettledCallback The function to call from the interrupt.
+ * @retval bool TRUE if the callback was scheduled, FALSE if the multiplexer has already settled and the caller
+ * should proceed itself.
+ */
+bool ScheduleAfterExternalMuxing(MuxSettledCallback callback) {
+	bool scheduled = false;
+	NVIC_DisableIRQ(EXT_MUX_SETTLE_IRQn);
+	if (MuxSettled == false) {
+		SettledCallback = callback;
+		scheduled = true;
+	}
+	NVIC_EnableIRQ(EXT_MUX_SETTLE_IRQn);
+	return scheduled;
+}
+
+/**
+ * Called by the settle timer interrupt handler once the external multiplexer has settled. Marks the switch
+ * complete and makes any scheduled callback.
+ *
+ * @param none
+ * @retval none
+ */
+void InputMultiplexer_SettleIRQHandler(void) {
+	if (TIM_GetITStatus(EXT_MUX_SETTLE_TIM, TIM_IT_Update) != RESET) {
+		TIM_ClearITPendingBit(EXT_MUX_SETTLE_TIM, TIM_IT_Update);
+		MuxSettled = true;
+		const MuxSettledCallback callback = SettledCallback;
+		SettledCallback = NULL;
+		if (callback != NULL) {
+			callback();
+		}
+	}
 }
 
 /**
@@ -215,23 +389,68 @@ void InputMultiplexerInit(void) {
 	GPIO_InitStructure.GPIO_PuPd = GPIO_PuPd_UP;
 	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_2MHz; /* At most the multiplexer can handle a few hundred Hz */
 	GPIO_Init(EXT_ANALOG_IN_MUX_PORT, &GPIO_InitStructure);
-	GPIO_Write(EXT_ANALOG_IN_MUX_PORT, (EXTERN_0 | (GPIO_ReadOutputData(EXT_ANALOG_IN_MUX_PORT ) & EXT_ANALOG_IN_BITMASK )));
+	WriteExternalMuxLines(EXTERN_0);
+#ifdef EXT_MUX_ADC_GPIO
+	/* The ADC keeps the directions through its resets, it is initialized before the inputs */
+	for (uint_fast8_t i = 0U; i < 4U; ++i) {
+		if ((EXT_MUX_ADC_GPIO_MASK & (1U << i)) != 0U) {
+			ADS1256_SetGPIODirection((ADS1256_GPIO_t) i, ADS1256_GPIO_OUTPUT);
+		}
+	}
+	ADS1256_SetInputChannelsAndGPIO(EXTERNAL_ANALOG_IN_AINP, EXTERNAL_ANALOG_IN_AINN, EXT_MUX_ADC_GPIO_MASK,
+			(uint8_t) ((uint16_t) EXTERN_0 >> EXT_MUX_ADC_GPIO_SHIFT));
+#endif
+
+	SettleTimerInit();
 }
 
 /**
- * Selects the specified analog input, automatically handling any multiplexing and timing needs.
+ * Starts switching the external multiplexer to an external input ahead of its selection, while the ADC is still
+ * reading the previous external input's conversion. Only the external multiplexer and the settle timer are touched,
+ * not the SPI bus, so this may be called from the DRDY interrupt once the conversion is latched. The following
+ * SelectAnalogInput() of the input then waits out what is left of the settle time instead of starting it again.
+ * Any other selection drops the preparation. Boards which drive select lines from the ADC's GPIO pins, see
+ * EXT_MUX_ADC_GPIO, cannot switch them without the SPI bus, so there nothing is prepared.
+ *
+ * @param input Analog_Input_t* The external input to switch to.
+ * @retval none
+ */
+void PrepareExternalInput(Analog_Input_t* input) {
+#ifdef EXT_MUX_ADC_GPIO
+	(void) input; /* The ADC cannot be written while the conversion is read from it */
+#else
+	if ((input == NULL) || (input->externalInput == NULL_CHANNEL)) {
+		return;
+	}
+	WriteExternalMuxLines(input->externalInput);
+	StartSettleTimer(input->settleTime);
+	PreparedInput = input;
+#endif
+}
+
+/**
+ * Selects the specified analog input, automatically handling any multiplexing and timing needs. An external input
+ * which PrepareExternalInput() has already switched to only enters the ADC_EXTERNAL_MUXING state for the rest of its
+ * settle time.
  *
  * @param input Analog_Input_t* The analog input to select.
  * @retval none
  */
 void SelectAnalogInput(Analog_Input_t* input) {
 	if (input != NULL ) {
-		if (isExternalInput(input->physicalInput)) {
-			SelectExternalInput(input->externalInput);
+		if ((input == PreparedInput) && isExternalInput(input->physicalInput)) {
+			PreparedInput = NULL;
+			CurrentInput = input;
+			ADC_External_Muxing();
+		} else if (isExternalInput(input->physicalInput)) {
+			SelectExternalInput(input->externalInput, input->settleTime);
 			CurrentInput = input;
 		} else if (isInternalInput(input->physicalInput)) {
 			SelectInternalInput(input->internalInput);
 			CurrentInput = input;
+		} else if (isDifferentialInput(input->physicalInput)) {
+			SelectDifferentialInput(input);
+			CurrentInput = input;
 		} else if (input->physicalInput == EXTERNAL_OFFSET_CAL) {
 			SelectCalibrationInput();
 			CurrentInput = input;
@@ -259,11 +478,14 @@ void SelectAnalogInput(Analog_Input_t* input) {
  */
 void SelectPhysicalInput(PhysicalAnalogInput_t input) {
 	if (isExternalInput(input)) {
-		SelectExternalInput(input);
+		SelectExternalInput(input, ANALOG_INPUT_DEFAULT_SETTLE_TIME);
 		CurrentInput = NULL;
 	} else if (isInternalInput(input)) {
 		SelectInternalInput(input);
 		CurrentInput = NULL;
+	} else if (isDifferentialInput(input)) {
+		SelectDifferentialInput(GetAnalogInputByNumber(input));
+		CurrentInput = NULL;
 	} else if (input == EXTERNAL_OFFSET_CAL) {
 		SelectCalibrationInput();
 		CurrentInput = NULL;
@@ -286,7 +508,7 @@ void SelectPhysicalInput(PhysicalAnalogInput_t input) {
  * @retval none
  */
 void SelectCalibrationInput(void) {
-	SelectExternalInput(EXTERN_0);
+	SelectExternalInput(EXTERN_0, ANALOG_INPUT_DEFAULT_SETTLE_TIME);
 }
 
 /**
@@ -322,107 +544,7 @@ void ResetSelectedInput(void) {
 ExternalMuxedInput_t GetExternalMuxedInputByNumber(uint8_t input) {
 	ExternalMuxedInput_t in = NULL_CHANNEL;
 	if (isExternalInput(input)) {
-		switch (input) {
-		case 0:
-			in = EXTERN_0;
-			break;
-		case 1:
-			in = EXTERN_1;
-			break;
-		case 2:
-			in = EXTERN_2;
-			break;
-		case 3:
-			in = EXTERN_3;
-			break;
-		case 4:
-			in = EXTERN_4;
-			break;
-		case 5:
-			in = EXTERN_5;
-			break;
-		case 6:
-			in = EXTERN_6;
-			break;
-		case 7:
-			in = EXTERN_7;
-			break;
-		case 8:
-			in = EXTERN_8;
-			break;
-		case 9:
-			in = EXTERN_9;
-			break;
-		case 10:
-			in = EXTERN_10;
-			break;
-		case 11:
-			in = EXTERN_11;
-			break;
-		case 12:
-			in = EXTERN_12;
-			break;
-		case 13:
-			in = EXTERN_13;
-			break;
-		case 14:
-			in = EXTERN_14;
-			break;
-		case 15:
-			in = EXTERN_15;
-			break;
-		case 16:
-			in = EXTERN_16;
-			break;
-		case 17:
-			in = EXTERN_17;
-			break;
-		case 18:
-			in = EXTERN_18;
-			break;
-		case 19:
-			in = EXTERN_19;
-			break;
-		case 20:
-			in = EXTERN_20;
-			break;
-		case 21:
-			in = EXTERN_21;
-			break;
-		case 22:
-			in = EXTERN_22;
-			break;
-		case 23:
-			in = EXTERN_23;
-			break;
-		case 24:
-			in = EXTERN_24;
-			break;
-		case 25:
-			in = EXTERN_25;
-			break;
-		case 26:
-			in = EXTERN_26;
-			break;
-		case 27:
-			in = EXTERN_27;
-			break;
-		case 28:
-			in = EXTERN_28;
-			break;
-		case 29:
-			in = EXTERN_29;
-			break;
-		case 30:
-			in = EXTERN_30;
-			break;
-		case 31:
-			in = EXTERN_31;
-			break;
-		default:
-			/* Do nothing */
-			break;
-		}
+		in = EXTERNAL_MUX_CODES[input];
 	}
 	return in;
 }
@@ -0,0 +1,413 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file AnalogInput_Power.c
+ * @brief Implements the computed power channels of the analog inputs.
+ *
+ * A power channel pairs a voltage input with a current input of the same scan. Each sample of the current is paired
+ * with the latest sample of the voltage, and the sums of the pair's values, squares and product are accumulated in
+ * 64 bit integers from the DRDY interrupt, so no precision is lost however long the window. Windows begin and end on
+ * rising crossings of the voltage through its mean over the previous window, with a hysteresis of a sixteenth of its
+ * previous peak to peak swing, so each holds a whole number of cycles and the results do not ripple with the phase
+ * the window happened to start at. The RMS values, power and power factor are worked out from the sums of a
+ * completed window in the main loop.
+ *
+ * The inputs of a scan are converted one after another, so the current of a pair lags its voltage by the time of one
+ * or more conversions. This shows as a small phase error in the power factor, which the host may correct for knowing
+ * the rates of the scan.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "AnalogInput_Power.h"
+#include <string.h>
+#include <math.h>
+
+#ifdef ANALOG_POWER_DEBUG
+#include <stdio.h>
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The shift giving the crossing hysteresis from the previous window's peak to peak swing of the voltage */
+#define POWER_HYSTERESIS_SHIFT 4U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Data structure holding the sums of a power channel's window.
+ */
+typedef struct {
+	uint32_t count; /**< The number of sample pairs summed. */
+	uint16_t cycles; /**< The number of voltage cycles completed. */
+	int32_t minVoltage; /**< The lowest voltage of the window. */
+	int32_t maxVoltage; /**< The highest voltage of the window. */
+	int64_t sumV; /**< The sum of the voltages. */
+	int64_t sumI; /**< The sum of the currents. */
+	uint64_t sumVV; /**< The sum of the squares of the voltages. */
+	uint64_t sumII; /**< The sum of the squares of the currents. */
+	int64_t sumVI; /**< The sum of the products of the voltages and currents. */
+	uint64_t start; /**< The timestamp of the first pair. */
+	uint64_t end; /**< The timestamp of the last pair. */
+} AnalogPowerSums_t;
+
+/**
+ * @internal
+ * @brief Data structure holding the state of a power channel.
+ */
+typedef struct {
+	bool enabled; /**< True if the channel has been set up. */
+	PhysicalAnalogInput_t voltage; /**< The voltage input. */
+	PhysicalAnalogInput_t current; /**< The current input. */
+	uint16_t cycles; /**< The number of voltage cycles in a window. */
+	bool haveVoltage; /**< True once a voltage sample has been taken. */
+	int32_t lastVoltage; /**< The latest voltage sample. */
+	bool synchronized; /**< True once the first rising crossing has been found, so a window is being summed. */
+	bool armed; /**< True once the voltage has fallen below the crossing band, so the next rise is a crossing. */
+	int32_t level; /**< The crossing level, the mean voltage of the previous window. */
+	int32_t hysteresis; /**< The depth below level the voltage must fall to arm the next crossing. */
+	AnalogPowerSums_t sums; /**< The sums of the window in progress. */
+	AnalogPowerSums_t window; /**< The sums of the last completed window. */
+	volatile bool windowReady; /**< True if window holds a completed window waiting to be written. */
+	uint32_t dropped; /**< The number of windows completed while the previous one was waiting. */
+} AnalogPowerChannel_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The power channels */
+static AnalogPowerChannel_t channels[ANALOG_POWER_MAX_CHANNELS];
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Restarts the window of a channel, to begin at its next rising crossing.
+ */
+static void ResetChannel(AnalogPowerChannel_t* channel);
+
+/**
+ * @internal
+ * @brief Clears the sums of a channel's window in progress.
+ */
+static void ClearSums(AnalogPowerSums_t* sums);
+
+/**
+ * @internal
+ * @brief Hands over a channel's window in progress as completed and starts the next.
+ */
+static void CloseWindow(AnalogPowerChannel_t* channel);
+
+/**
+ * @internal
+ * @brief Tracks the crossings of a channel's voltage, opening and closing its windows.
+ */
+static void ProcessVoltage(AnalogPowerChannel_t* channel, int32_t value);
+
+/**
+ * @internal
+ * @brief Sums a pair of a channel's voltage and current.
+ */
+static void ProcessCurrent(AnalogPowerChannel_t* channel, int32_t value, uint64_t timestamp);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Restarts the window of a channel. Samples are not summed again until the voltage next rises through the crossing
+ * level. The level and hysteresis of the previous window are kept, as the signal is likely the same; a channel
+ * which has never completed a window crosses at 0 with no hysteresis until a window of ANALOG_POWER_MAX_COUNT pairs
+ * gives it a level.
+ *
+ * @param channel AnalogPowerChannel_t* Pointer/Reference to the power channel.
+ * @retval none
+ */
+static void ResetChannel(AnalogPowerChannel_t* channel) {
+	channel->haveVoltage = false;
+	channel->synchronized = false;
+	channel->armed = false;
+	ClearSums(&channel->sums);
+}
+
+/**
+ * Clears the sums of a window.
+ *
+ * @param sums AnalogPowerSums_t* Pointer/Reference to the sums.
+ * @retval none
+ */
+static void ClearSums(AnalogPowerSums_t* sums) {
+	memset(sums, 0, sizeof(AnalogPowerSums_t));
+	sums->minVoltage = INT32_MAX;
+	sums->maxVoltage = INT32_MIN;
+}
+
+/**
+ * Hands over a channel's window in progress to be written, unless the previous window has not yet been, in which
+ * case this one is dropped. The next window's crossing level and hysteresis are taken from this one. The pairs
+ * summed before the first crossing are only used for the level.
+ *
+ * @param channel AnalogPowerChannel_t* Pointer/Reference to the power channel.
+ * @retval none
+ */
+static void CloseWindow(AnalogPowerChannel_t* channel) {
+	AnalogPowerSums_t* sums = &channel->sums;
+	if (sums->count > 0U) {
+		channel->level = (int32_t) (sums->sumV / (int64_t) sums->count);
+		channel->hysteresis = (sums->maxVoltage - sums->minVoltage) >> POWER_HYSTERESIS_SHIFT;
+		if (channel->synchronized == false) {
+			/* Not started on a crossing, only the level is of use */
+		} else if (channel->windowReady == false) {
+			channel->window = *sums;
+			channel->windowReady = true;
+		} else {
+			++(channel->dropped);
+#ifdef ANALOG_POWER_DEBUG
+			printf("[Analog Power] Dropped a window of power channel %i.\n\r", (int) (channel - channels));
+#endif
+		}
+	}
+	ClearSums(sums);
+}
+
+/**
+ * Tracks the crossings of a channel's voltage. Falling below the crossing band arms the channel and rising back
+ * through the level with it armed is a crossing. The first crossing starts the first window, and each window is
+ * closed, and the next started, when it has completed its cycles.
+ *
+ * @param channel AnalogPowerChannel_t* Pointer/Reference to the power channel.
+ * @param value int32_t The voltage sample.
+ * @retval none
+ */
+static void ProcessVoltage(AnalogPowerChannel_t* channel, int32_t value) {
+	channel->lastVoltage = value;
+	channel->haveVoltage = true;
+	if (value < (channel->level - channel->hysteresis)) {
+		channel->armed = true;
+	} else if ((channel->armed == true) && (value >= channel->level)) {
+		channel->armed = false;
+		if (channel->synchronized == false) {
+			channel->synchronized = true;
+			ClearSums(&channel->sums);
+		} else {
+			++(channel->sums.cycles);
+			if (channel->sums.cycles >= channel->cycles) {
+				CloseWindow(channel);
+			}
+		}
+	}
+}
+
+/**
+ * Sums a pair of a channel's latest voltage and a current sample. A window which reaches ANALOG_POWER_MAX_COUNT pairs
+ * before completing its cycles is closed early. Pairs are summed before the first crossing too, so that a voltage
+ * which never crosses the level still has its level learnt from them.
+ *
+ * @param channel AnalogPowerChannel_t* Pointer/Reference to the power channel.
+ * @param value int32_t The current sample.
+ * @param timestamp uint64_t The timestamp of the current sample.
+ * @retval none
+ */
+static void ProcessCurrent(AnalogPowerChannel_t* channel, int32_t value, uint64_t timestamp) {
+	if (channel->haveVoltage == false) {
+		return;
+	}
+	AnalogPowerSums_t* sums = &channel->sums;
+	const int32_t voltage = channel->lastVoltage;
+	if (sums->count == 0U) {
+		sums->start = timestamp;
+	}
+	sums->end = timestamp;
+	++(sums->count);
+	if (voltage < sums->minVoltage) {
+		sums->minVoltage = voltage;
+	}
+	if (voltage > sums->maxVoltage) {
+		sums->maxVoltage = voltage;
+	}
+	sums->sumV += voltage;
+	sums->sumI += value;
+	sums->sumVV += (uint64_t) ((int64_t) voltage * voltage);
+	sums->sumII += (uint64_t) ((int64_t) value * value);
+	sums->sumVI += (int64_t) voltage * value;
+	if (sums->count >= ANALOG_POWER_MAX_COUNT) {
+		CloseWindow(channel);
+	}
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Sets up a power channel for a voltage and current input. The inputs must differ, and both must be in the scan for
+ * the channel to produce results. The channel's window restarts, and may only be set up while not sampling.
+ *
+ * @param channel uint8_t The number of the power channel.
+ * @param voltage PhysicalAnalogInput_t The voltage input.
+ * @param current PhysicalAnalogInput_t The current input.
+ * @param cycles uint16_t The number of voltage cycles in a window, at least 1.
+ * @retval bool True if the channel was set up.
+ */
+bool AnalogPower_SetChannel(uint8_t channel, PhysicalAnalogInput_t voltage, PhysicalAnalogInput_t current, uint16_t cycles) {
+	if ((channel >= ANALOG_POWER_MAX_CHANNELS) || (voltage == current) || (cycles == 0U)) {
+		return false;
+	}
+	AnalogPowerChannel_t* power = &channels[channel];
+	power->enabled = true;
+	power->voltage = voltage;
+	power->current = current;
+	power->cycles = cycles;
+	power->level = 0;
+	power->hysteresis = 0;
+	power->windowReady = false;
+	power->dropped = 0U;
+	ResetChannel(power);
+	return true;
+}
+
+/**
+ * Removes a power channel, discarding any window waiting to be written.
+ *
+ * @param channel uint8_t The number of the power channel.
+ * @retval bool True if the channel number is valid.
+ */
+bool AnalogPower_ClearChannel(uint8_t channel) {
+	if (channel >= ANALOG_POWER_MAX_CHANNELS) {
+		return false;
+	}
+	channels[channel].enabled = false;
+	channels[channel].windowReady = false;
+	return true;
+}
+
+/**
+ * Discards the partial windows of every power channel, as when sampling starts, so each starts again on the next
+ * rising crossing of its voltage. Completed windows waiting to be written are kept.
+ *
+ * @param none
+ * @retval none
+ */
+void AnalogPower_Reset(void) {
+	for (uint8_t i = 0U; i < ANALOG_POWER_MAX_CHANNELS; ++i) {
+		ResetChannel(&channels[i]);
+	}
+}
+
+/**
+ * Adds a sample to the power channels it belongs to. Called from the DRDY interrupt for every sample of the scan.
+ *
+ * @param input PhysicalAnalogInput_t The input the sample was taken from.
+ * @param value int32_t The sample.
+ * @param timestamp uint64_t The timestamp of the sample.
+ * @retval bool True if the sample belongs to a power channel.
+ */
+bool AnalogPower_Process(PhysicalAnalogInput_t input, int32_t value, uint64_t timestamp) {
+	bool used = false;
+	for (uint8_t i = 0U; i < ANALOG_POWER_MAX_CHANNELS; ++i) {
+		AnalogPowerChannel_t* channel = &channels[i];
+		if (channel->enabled == false) {
+			continue;
+		}
+		if (input == channel->voltage) {
+			ProcessVoltage(channel, value);
+			used = true;
+		} else if (input == channel->current) {
+			ProcessCurrent(channel, value, timestamp);
+			used = true;
+		}
+	}
+	return used;
+}
+
+/**
+ * Determines if any power channel has a completed window waiting to be written.
+ *
+ * @param none
+ * @retval bool True if a window is waiting.
+ */
+bool AnalogPower_IsPending(void) {
+	for (uint8_t i = 0U; i < ANALOG_POWER_MAX_CHANNELS; ++i) {
+		if ((channels[i].enabled == true) && (channels[i].windowReady == true)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Works out the results of the next completed window waiting to be written. The window stays waiting until it is
+ * released with AnalogPower_ReleaseResult(), so a write which could not be sent may be retried. The means are taken
+ * out of the sums in double precision, as the mean squares of a signal with a large offset differ from the squares
+ * of its mean only in their low digits.
+ *
+ * @param result AnalogPowerResult_t* Pointer/Reference to the structure to fill in.
+ * @retval bool True if a window was waiting.
+ */
+bool AnalogPower_PeekResult(AnalogPowerResult_t* result) {
+	for (uint8_t i = 0U; i < ANALOG_POWER_MAX_CHANNELS; ++i) {
+		const AnalogPowerChannel_t* channel = &channels[i];
+		if ((channel->enabled == false) || (channel->windowReady == false)) {
+			continue;
+		}
+		const AnalogPowerSums_t* sums = &channel->window;
+		const double count = (double) sums->count;
+		const double meanV = (double) sums->sumV / count;
+		const double meanI = (double) sums->sumI / count;
+		double squareV = ((double) sums->sumVV / count) - (meanV * meanV);
+		double squareI = ((double) sums->sumII / count) - (meanI * meanI);
+		const double power = ((double) sums->sumVI / count) - (meanV * meanI);
+		squareV = (squareV > 0.0) ? squareV : 0.0;
+		squareI = (squareI > 0.0) ? squareI : 0.0;
+		const double apparent = sqrt(squareV * squareI);
+		result->channel = i;
+		result->voltage = channel->voltage;
+		result->current = channel->current;
+		result->start = sums->start;
+		result->end = sums->end;
+		result->count = sums->count;
+		result->cycles = sums->cycles;
+		result->voltageRms = (float) sqrt(squareV);
+		result->currentRms = (float) sqrt(squareI);
+		result->power = (float) power;
+		result->powerFactor = (apparent > 0.0) ? (float) (power / apparent) : 0.0f;
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Releases a power channel's completed window, once it has been written or found to be undeliverable.
+ *
+ * @param channel uint8_t The number of the power channel.
+ * @retval none
+ */
+void AnalogPower_ReleaseResult(uint8_t channel) {
+	if (channel < ANALOG_POWER_MAX_CHANNELS) {
+		channels[channel].windowReady = false;
+	}
+}
@@ -0,0 +1,316 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file AnalogInput_Spectrum.c
+ * @brief Implements the analog input spectrum.
+ *
+ * The codes of a burst capture are split into consecutive blocks of a power of 2 points. Each block has its mean
+ * removed and a Hann window applied before its real FFT, and the amplitudes of its bins are averaged with those of the
+ * other blocks. Amplitudes are in ADC codes, scaled for the window so a sine of amplitude A shows as A in its bin, and
+ * the DC bin holds the mean of the blocks. One block is transformed per service so the main loop is never held up for
+ * more than a single FFT.
+ *
+ * The averaged spectrum is then either sent to the data connection as binary spectrum records, see Analog_Input.c,
+ * or reduced to its strongest peaks, the bins larger than both their neighbors, which are reported in a single status
+ * message.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "AnalogInput_Spectrum.h"
+#include "TelnetServer.h"
+#include <math.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def SPECTRUM_FRAMES_PER_SERVICE
+ * @brief The most spectrum records a single service sends.
+ */
+#define SPECTRUM_FRAMES_PER_SERVICE	4U
+
+/**
+ * @internal
+ * @def SPECTRUM_MESSAGE_SIZE
+ * @brief The size of the buffer the peaks are reported in.
+ */
+#define SPECTRUM_MESSAGE_SIZE		256U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief The stages of a spectrum.
+ */
+typedef enum {
+	SPECTRUM_IDLE, /**< No spectrum is in progress. */
+	SPECTRUM_COMPUTING, /**< The blocks of the capture are being transformed. */
+	SPECTRUM_SENDING /**< The averaged bins are being sent to the data connection. */
+} SpectrumStage_t;
+
+/**
+ * @internal
+ * @brief Data structure holding the configuration and progress of a spectrum.
+ */
+typedef struct {
+	SpectrumStage_t stage; /**< The current stage of the spectrum. */
+	PhysicalAnalogInput_t input; /**< The input which was captured. */
+	const uint8_t* codes; /**< The captured codes, three bytes each, least significant first. */
+	uint16_t points; /**< The number of points in each block. */
+	uint8_t peaks; /**< The number of peaks to report, 0 to send the bins instead. */
+	uint32_t binWidth; /**< The frequency step between bins in mHz. */
+	uint32_t blocks; /**< The number of blocks in the capture. */
+	uint32_t block; /**< The number of blocks transformed so far. */
+	uint16_t sent; /**< The number of bins sent so far. */
+} Spectrum_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The spectrum in progress. */
+static Spectrum_t spectrum;
+
+/* The block being transformed. */
+static float block[FFT_MAX_POINTS];
+
+/* The sum, then the average, of the amplitudes of each bin over the blocks. */
+static float amplitudes[(FFT_MAX_POINTS / 2U) + 1U];
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Transforms the next block of the capture and adds its amplitudes to the sums.
+ */
+static void TransformBlock(void);
+
+/**
+ * @internal
+ * @brief Reports the strongest peaks of the averaged spectrum.
+ */
+static void ReportPeaks(void);
+
+/**
+ * @internal
+ * @brief Sends the next bins of the averaged spectrum.
+ */
+static void SendBins(void);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Transforms the next block of the capture and adds the amplitudes of its bins to the sums.
+ *
+ * @param none
+ * @retval none
+ */
+static void TransformBlock(void) {
+	const uint16_t points = spectrum.points;
+	const uint8_t* code = &spectrum.codes[spectrum.block * points * ANALOG_SAMPLE_VALUE_SIZE];
+	float mean = 0.0f;
+	for (uint32_t n = 0U; n < points; ++n) {
+		/* Sign extend the 24 bit code */
+		const uint32_t raw = ((uint32_t) code[0]) | (((uint32_t) code[1]) << 8U) | (((uint32_t) code[2]) << 16U);
+		block[n] = (float) (((int32_t) (raw << 8U)) >> 8);
+		mean += block[n];
+		code += ANALOG_SAMPLE_VALUE_SIZE;
+	}
+	mean /= (float) points;
+	for (uint32_t n = 0U; n < points; ++n) {
+		block[n] -= mean;
+	}
+	FFT_ApplyHannWindow(block, points);
+	FFT_Real(block, points);
+	/* The window sums to points / 2, and each bin but DC and the last holds half of its sine's power */
+	const float scale = 4.0f / (float) points;
+	const uint32_t half = points / 2U;
+	amplitudes[0] += fabsf(mean);
+	for (uint32_t k = 1U; k < half; ++k) {
+		const float re = block[2U * k];
+		const float im = block[(2U * k) + 1U];
+		amplitudes[k] += scale * sqrtf((re * re) + (im * im));
+	}
+	amplitudes[half] += 0.5f * scale * fabsf(block[1]);
+	++spectrum.block;
+}
+
+/**
+ * Reports the strongest peaks of the averaged spectrum, strongest first, with the frequency of each in mHz and its
+ * amplitude in ADC codes. Only bins larger than both their neighbors are peaks.
+ *
+ * @param none
+ * @retval none
+ */
+static void ReportPeaks(void) {
+	uint16_t bins[ANALOG_SPECTRUM_MAX_PEAKS];
+	uint8_t found = 0U;
+	const uint32_t half = spectrum.points / 2U;
+	for (uint32_t k = 1U; k < half; ++k) {
+		const float amplitude = amplitudes[k];
+		if ((amplitude <= amplitudes[k - 1U]) || (amplitude < amplitudes[k + 1U])) {
+			continue;
+		}
+		/* Insert the peak in order, dropping the weakest once the list is full */
+		uint8_t position = found;
+		while ((position > 0U) && (amplitudes[bins[position - 1U]] < amplitude)) {
+			if (position < spectrum.peaks) {
+				bins[position] = bins[position - 1U];
+			}
+			--position;
+		}
+		if (position < spectrum.peaks) {
+			bins[position] = (uint16_t) k;
+			if (found < spectrum.peaks) {
+				++found;
+			}
+		}
+	}
+	char message[SPECTRUM_MESSAGE_SIZE];
+	int length = snprintf(message, sizeof(message), "Spectrum Peaks, Input: %" PRIu8 ", Blocks: %" PRIu32 ",",
+			(uint8_t) spectrum.input, spectrum.blocks);
+	for (uint8_t i = 0U; (i < found) && (length > 0) && (length < (int) sizeof(message)); ++i) {
+		length += snprintf(&message[length], sizeof(message) - (size_t) length, " %" PRIu32 " mHz: %" PRIu32,
+				bins[i] * spectrum.binWidth, (uint32_t) (amplitudes[bins[i]] + 0.5f));
+	}
+	TelnetWriteStatusMessage(message);
+}
+
+/**
+ * Sends the next bins of the averaged spectrum, up to SPECTRUM_FRAMES_PER_SERVICE spectrum records at a time. Resumes
+ * from where it stopped when the connection is busy, and ends early if there is no connection to send to.
+ *
+ * @param none
+ * @retval none
+ */
+static void SendBins(void) {
+	const uint16_t bins = (uint16_t) ((spectrum.points / 2U) + 1U);
+	for (uint_fast8_t i = 0U; (i < SPECTRUM_FRAMES_PER_SERVICE) && (spectrum.stage == SPECTRUM_SENDING); ++i) {
+		uint16_t written = 0U;
+		const WriteStatus_t status = WriteAnalogSpectrumBinary(spectrum.input, spectrum.points, spectrum.sent,
+				&amplitudes[spectrum.sent], (uint16_t) (bins - spectrum.sent), &written);
+		if (status == WRITE_BUSY) {
+			break;
+		}
+		spectrum.sent += written;
+		if ((status != WRITE_OK) || (spectrum.sent >= bins)) {
+			spectrum.stage = SPECTRUM_IDLE;
+			char message[96];
+			snprintf(message, sizeof(message), "Spectrum download %s, Bins: %" PRIu16 " of %" PRIu16 ".",
+					(status == WRITE_OK) ? "completed" : "failed", spectrum.sent, bins);
+			TelnetWriteStatusMessage(message);
+		}
+	}
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Starts computing the averaged spectrum of a burst capture, in as many whole blocks as the capture holds; any codes
+ * after the last whole block are left out. Any spectrum already in progress is abandoned. The codes must not change
+ * until the spectrum is complete.
+ *
+ * @param input PhysicalAnalogInput_t The input which was captured.
+ * @param codes const uint8_t* The captured codes, three bytes each, least significant first.
+ * @param count uint32_t The number of captured codes.
+ * @param points uint16_t The number of points in each block, a valid FFT size.
+ * @param peaks uint8_t The number of peaks to report, up to ANALOG_SPECTRUM_MAX_PEAKS, or 0 to send the bins.
+ * @param binWidth uint32_t The frequency step between bins in mHz, the sample rate divided by the points.
+ * @retval bool TRUE if the spectrum was started, FALSE if the parameters are invalid or the capture does not hold a
+ * single block.
+ */
+bool AnalogSpectrum_Start(PhysicalAnalogInput_t input, const uint8_t* codes, uint32_t count, uint16_t points,
+		uint8_t peaks, uint32_t binWidth) {
+	if ((codes == NULL) || (FFT_IsValidSize(points) == false) || (count < points) || (peaks > ANALOG_SPECTRUM_MAX_PEAKS)) {
+		return false;
+	}
+	spectrum.input = input;
+	spectrum.codes = codes;
+	spectrum.points = points;
+	spectrum.peaks = peaks;
+	spectrum.binWidth = binWidth;
+	spectrum.blocks = count / points;
+	spectrum.block = 0U;
+	spectrum.sent = 0U;
+	for (uint32_t k = 0U; k <= (points / 2U); ++k) {
+		amplitudes[k] = 0.0f;
+	}
+	spectrum.stage = SPECTRUM_COMPUTING;
+	return true;
+}
+
+/**
+ * Abandons the spectrum in progress, if any, without reporting it.
+ *
+ * @param none
+ * @retval none
+ */
+void AnalogSpectrum_Cancel(void) {
+	spectrum.stage = SPECTRUM_IDLE;
+}
+
+/**
+ * Determines if a spectrum is being computed or sent.
+ *
+ * @param none
+ * @retval bool TRUE if a spectrum is in progress.
+ */
+bool AnalogSpectrum_IsBusy(void) {
+	return (spectrum.stage != SPECTRUM_IDLE);
+}
+
+/**
+ * Transforms the next block of the spectrum in progress, or sends its next bins once every block has been
+ * transformed. Called from the main loop while the ADC is idle.
+ *
+ * @param none
+ * @retval none
+ */
+void AnalogSpectrum_Service(void) {
+	if (spectrum.stage == SPECTRUM_COMPUTING) {
+		TransformBlock();
+		if (spectrum.block >= spectrum.blocks) {
+			for (uint32_t k = 0U; k <= (spectrum.points / 2U); ++k) {
+				amplitudes[k] /= (float) spectrum.blocks;
+			}
+			if (spectrum.peaks > 0U) {
+				ReportPeaks();
+				spectrum.stage = SPECTRUM_IDLE;
+			} else {
+				spectrum.stage = SPECTRUM_SENDING;
+			}
+		}
+	} else if (spectrum.stage == SPECTRUM_SENDING) {
+		SendBins();
+	}
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file AnalogInput_Thermocouple.c
+ * @brief Implements the thermocouple linearization of analog inputs.
+ *
+ * The NIST ITS-90 reference functions are tabulated every 10 degrees Celsius and interpolated linearly, which stays
+ * within a few hundredths of a degree of the polynomials while needing only integer arithmetic, so the conversion can
+ * run from the DRDY interrupt. EMFs are in nanovolts and temperatures in milli-degrees Celsius, both of which fit the
+ * 24 bit range of a reading. Conversions beyond the range of a table are clamped to its ends.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "AnalogInput_Thermocouple.h"
+#include <string.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The number of fractional bits used when interpolating between table entries */
+#define INTERPOLATION_BITS 12U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* An EMF table, holding the EMF in nanovolts every THERMOCOUPLE_TABLE_STEP from its minimum temperature */
+typedef struct {
+	const int32_t* emf; /* The EMFs, strictly increasing */
+	int32_t minimum; /* The temperature of the first entry in milli-degrees Celsius */
+	uint32_t count; /* The number of entries */
+} ThermocoupleTable_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The human readable names of the thermocouple types, indexed by ThermocoupleType_t */
+static const char* THERMOCOUPLE_TYPE_STRINGS[NUM_THERMOCOUPLE_TYPES] = { "NONE", "J", "K", "T" };
+
+/* Type J EMFs from -210 to 1200 degrees Celsius */
+static const int32_t THERMOCOUPLE_J_EMF[] = {
+	-8095380, -7890483, -7658943, -7402508, -7122821, -6821428, -6499777, -6159230, -5801068, -5426489, -5036622,
+	-4632524, -4215188, -3785546, -3344475, -2892794, -2431276, -1960646, -1481583, -994726, -500677, 0, 506775,
+	1019149, 1536654, 2058847, 2585315, 3115668, 3649539, 4186583, 4726477, 5268916, 5813615, 6360306, 6908738, 7458677,
+	8009905, 8562217, 9115426, 9669355, 10223844, 10778746, 11333926, 11889263, 12444648, 12999985, 13555192, 14110197,
+	14664941, 15219378, 15773474, 16327206, 16880563, 17433549, 17986175, 18538468, 19090463, 19642210, 20193768,
+	20745207, 21296608, 21848065, 22399679, 22951561, 23503835, 24056630, 24610085, 25164346, 25719569, 26275912,
+	26833543, 27392631, 27953351, 28515881, 29080398, 29647082, 30216111, 30787661, 31361904, 31939005, 32519124,
+	33102410, 33689004, 34279030, 34872601, 35469808, 36070725, 36675405, 37283872, 37896125, 38512131, 39131825,
+	39755103, 40381823, 41011796, 41644789, 42280518, 42918641, 43559497, 44203012, 44848257, 45494394, 46140670,
+	46786416, 47431041, 48074029, 48714937, 49353388, 49989071, 50621735, 51251186, 51877283, 52499934, 53119094,
+	53734759, 54346963, 54955778, 55561303, 56163667, 56763023, 57359541, 57953410, 58544832, 59134017, 59721180,
+	60306538, 60890306, 61472694, 62053901, 62634114, 63213503, 63792218, 64370384, 64948099, 65525428, 66102403,
+	66679016, 67255216, 67830906, 68405940, 68980117, 69553180 };
+
+/* Type K EMFs from -200 to 1370 degrees Celsius */
+static const int32_t THERMOCOUPLE_K_EMF[] = {
+	-5891404, -5729720, -5550347, -5353976, -5141233, -4912708, -4668978, -4410619, -4138211, -3852348, -3553631,
+	-3242679, -2920126, -2586621, -2242821, -1889383, -1526948, -1156131, -777540, -391854, 0, 396862, 798120, 1203275,
+	1611792, 2023078, 2436472, 2851249, 3266642, 3681879, 4096230, 4509060, 4919882, 5328395, 5734508, 6138344, 6540216,
+	6940588, 7340023, 7739124, 8138473, 8538590, 8939893, 9342685, 9747152, 10153369, 10561326, 10970948, 11382118,
+	11794703, 12208566, 12623577, 13039627, 13456620, 13874481, 14293149, 14712576, 15132723, 15553553, 15975037,
+	16397142, 16819837, 17243088, 17666860, 18091113, 18515807, 18940899, 19366342, 19792087, 20218086, 20644286,
+	21070635, 21497078, 21923562, 22350030, 22776428, 23202702, 23628796, 24054656, 24480231, 24905467, 25330315,
+	25754724, 26178649, 26602043, 27024863, 27447068, 27868617, 28289474, 28709604, 29128974, 29547554, 29965317,
+	30382236, 30798289, 31213454, 31627713, 32041049, 32453447, 32864894, 33275380, 33684895, 34093431, 34500981,
+	34907541, 35313106, 35717673, 36121240, 36523803, 36925362, 37325915, 37725461, 38123998, 38521524, 38918036,
+	39313533, 39708009, 40101461, 40493883, 40885267, 41275606, 41664891, 42053111, 42440253, 42826304, 43211248,
+	43595069, 43977749, 44359268, 44739604, 45118736, 45496639, 45873290, 46248663, 46622731, 46995468, 47366846,
+	47736839, 48105419, 48472560, 48838238, 49202427, 49565105, 49926251, 50285848, 50643879, 51000333, 51355201,
+	51708479, 52060168, 52410275, 52758810, 53105793, 53451248, 53795208, 54137714, 54478814, 54818569 };
+
+/* Type T EMFs from -200 to 400 degrees Celsius */
+static const int32_t THERMOCOUPLE_T_EMF[] = {
+	-5602961, -5438644, -5260754, -5069579, -4865396, -4648468, -4418994, -4177112, -3922953, -3656694, -3378582,
+	-3088893, -2787882, -2475760, -2152727, -1819036, -1474992, -1120873, -756838, -383050, 0, 390040, 788764, 1196107,
+	1611976, 2036256, 2468806, 2909468, 3358065, 3814409, 4278301, 4749536, 5227909, 5713214, 6205251, 6703826, 7208752,
+	7719853, 8236965, 8759933, 9288611, 9822864, 10362563, 10907585, 11457811, 12013124, 12573407, 13138540, 13708400,
+	14282861, 14861792, 15445063, 16032542, 16624102, 17219628, 17819023, 18422222, 19029199, 19639988, 20254701,
+	20873548 };
+
+/* The EMF tables, indexed by ThermocoupleType_t */
+static const ThermocoupleTable_t THERMOCOUPLE_TABLES[NUM_THERMOCOUPLE_TYPES] = {
+	{ NULL, 0, 0U },
+	{ THERMOCOUPLE_J_EMF, -210000, sizeof(THERMOCOUPLE_J_EMF) / sizeof(THERMOCOUPLE_J_EMF[0]) },
+	{ THERMOCOUPLE_K_EMF, -200000, sizeof(THERMOCOUPLE_K_EMF) / sizeof(THERMOCOUPLE_K_EMF[0]) },
+	{ THERMOCOUPLE_T_EMF, -200000, sizeof(THERMOCOUPLE_T_EMF) / sizeof(THERMOCOUPLE_T_EMF[0]) }
+};
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC METHODS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Converts a thermocouple EMF to the temperature of its measuring junction, against a 0 degree reference junction.
+ * The segment of the table holding the EMF is found with a binary search and the temperature is interpolated
+ * within it. An input which is not linearized has its value returned unchanged.
+ *
+ * @param type ThermocoupleType_t The type of thermocouple.
+ * @param emf int32_t The EMF in nanovolts.
+ * @retval int32_t The temperature in milli-degrees Celsius.
+ */
+int32_t Thermocouple_EMFToTemperature(ThermocoupleType_t type, int32_t emf) {
+	if ((type == THERMOCOUPLE_NONE) || (type >= NUM_THERMOCOUPLE_TYPES)) {
+		return emf;
+	}
+	const ThermocoupleTable_t* table = &THERMOCOUPLE_TABLES[type];
+	const int32_t maximum = table->minimum + (int32_t) (table->count - 1U) * THERMOCOUPLE_TABLE_STEP;
+	if (emf <= table->emf[0]) {
+		return table->minimum;
+	} else if (emf >= table->emf[table->count - 1U]) {
+		return maximum;
+	}
+	/* Find the segment with emf[low] <= emf < emf[low + 1] */
+	uint32_t low = 0U;
+	uint32_t high = table->count - 1U;
+	while ((high - low) > 1U) {
+		const uint32_t middle = (low + high) / 2U;
+		if (table->emf[middle] <= emf) {
+			low = middle;
+		} else {
+			high = middle;
+		}
+	}
+	/* The segments are under 1mV wide, so the fraction fits 32 bits */
+	const uint32_t span = (uint32_t) (table->emf[high] - table->emf[low]);
+	const uint32_t fraction = (((uint32_t) (emf - table->emf[low]) << INTERPOLATION_BITS) + (span / 2U)) / span;
+	return table->minimum + (int32_t) low * THERMOCOUPLE_TABLE_STEP
+			+ (int32_t) ((fraction * THERMOCOUPLE_TABLE_STEP + (1U << (INTERPOLATION_BITS - 1U))) >> INTERPOLATION_BITS);
+}
+
+/**
+ * Converts a junction temperature to the EMF a thermocouple produces against a 0 degree reference junction. This is
+ * used to compensate for the temperature of the cold junction at the terminals. An input which is not linearized has
+ * no EMF.
+ *
+ * @param type ThermocoupleType_t The type of thermocouple.
+ * @param temperature int32_t The temperature in milli-degrees Celsius.
+ * @retval int32_t The EMF in nanovolts.
+ */
+int32_t Thermocouple_TemperatureToEMF(ThermocoupleType_t type, int32_t temperature) {
+	if ((type == THERMOCOUPLE_NONE) || (type >= NUM_THERMOCOUPLE_TYPES)) {
+		return 0;
+	}
+	const ThermocoupleTable_t* table = &THERMOCOUPLE_TABLES[type];
+	if (temperature <= table->minimum) {
+		return table->emf[0];
+	}
+	const uint32_t offset = (uint32_t) (temperature - table->minimum);
+	const uint32_t low = offset / (uint32_t) THERMOCOUPLE_TABLE_STEP;
+	if (low >= (table->count - 1U)) {
+		return table->emf[table->count - 1U];
+	}
+	const uint32_t span = (uint32_t) (table->emf[low + 1U] - table->emf[low]);
+	const uint32_t fraction = ((offset - low * (uint32_t) THERMOCOUPLE_TABLE_STEP) << INTERPOLATION_BITS)
+			/ (uint32_t) THERMOCOUPLE_TABLE_STEP;
+	return table->emf[low] + (int32_t) ((span * fraction + (1U << (INTERPOLATION_BITS - 1U))) >> INTERPOLATION_BITS);
+}
+
+/**
+ * Return the human readable string representation of the provided thermocouple type.
+ *
+ * @param type ThermocoupleType_t The thermocouple type to convert.
+ * @retval const char* The human readable string representation.
+ */
+const char* Thermocouple_StringFromType(ThermocoupleType_t type) {
+	return (type < NUM_THERMOCOUPLE_TYPES) ? THERMOCOUPLE_TYPE_STRINGS[type] : "UNKNOWN";
+}
+
+/**
+ * Convert a human readable string into the relevant ThermocoupleType_t value.
+ *
+ * @param str const char* The string to convert.
+ * @retval ThermocoupleType_t The thermocouple type, or NUM_THERMOCOUPLE_TYPES if the string is not recognized.
+ */
+ThermocoupleType_t Thermocouple_StringToType(const char* str) {
+	for (uint_fast8_t i = 0U; i < NUM_THERMOCOUPLE_TYPES; ++i) {
+		if (strcmp(str, THERMOCOUPLE_TYPE_STRINGS[i]) == 0) {
+			return (ThermocoupleType_t) i;
+		}
+	}
+	return NUM_THERMOCOUPLE_TYPES;
+}
@@ -0,0 +1,272 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file AnalogInput_Trigger.c
+ * @brief Implements triggered burst capture of an analog input.
+ *
+ * While armed, the captured input's ring buffer is used as a circular pre-trigger history: each new sample is stored
+ * and the oldest ones released so only the most recent pre samples are kept. The writers leave the buffer alone during
+ * this time, so the DRDY interrupt is its only user. When the trigger fires post more samples are stored and the
+ * capture is frozen, at which point the ADC stops and the writers drain the buffer as the connection allows.
+ *
+ * The trigger is evaluated once per conversion, on the same sample clock as the data, so its position in the capture
+ * is exact to the sample. A trigger received from the CAN master is taken on the next conversion, and a CAN master
+ * hands its own trigger on to the slaves as it fires, so the captures of several boards line up.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "AnalogInput_Trigger.h"
+#include "Tekdaqc_CAN.h"
+#include <string.h>
+
+#ifdef ANALOG_TRIGGER_DEBUG
+#include <stdio.h>
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Data structure holding the configuration and progress of a capture.
+ */
+typedef struct {
+	volatile AnalogTriggerState_t state; /**< The current stage of the capture. */
+	const Digital_Input_t* source; /**< The digital input which fires the trigger, NULL for the analog threshold. */
+	bool external; /**< TRUE if the trigger is fired by the CAN master rather than a source. */
+	volatile bool fired; /**< TRUE once the CAN master has fired the trigger. */
+	int32_t level; /**< The analog threshold (ADC Counts). */
+	AnalogTriggerEdge_t edge; /**< The direction of change which fires the trigger. */
+	uint32_t pre; /**< The number of samples kept from before the trigger. */
+	uint32_t remaining; /**< The number of post-trigger samples still to be taken. */
+	bool primed; /**< TRUE once a previous sample has been seen to compare against. */
+	int32_t previousValue; /**< The previous analog sample. */
+	DigitalLevel_t previousLevel; /**< The previous digital input level. */
+} AnalogTrigger_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The capture in progress, if any */
+static AnalogTrigger_t trigger = { .state = ANALOG_TRIGGER_IDLE };
+
+/* The human readable names of the edges, indexed by AnalogTriggerEdge_t */
+static const char* EDGE_STRINGS[NUM_ANALOG_TRIGGER_EDGES] = { "RISING", "FALLING" };
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Checks if a sample fires the trigger.
+ */
+static bool isTriggered(int32_t value);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Checks if the trigger condition was met between the previous sample and this one. The first sample only sets the
+ * reference, since there is nothing to detect a change from.
+ *
+ * @param value int32_t The analog sample just taken (ADC Counts).
+ * @retval bool TRUE if the trigger fired.
+ */
+static bool isTriggered(int32_t value) {
+	bool fired = false;
+	if (trigger.external == true) {
+		fired = trigger.fired;
+	} else if (trigger.source != NULL) {
+		const DigitalLevel_t level = ReadDigitalInputLevel(trigger.source);
+		if (trigger.primed == true) {
+			fired = (level != trigger.previousLevel)
+					&& (level == ((trigger.edge == ANALOG_TRIGGER_RISING) ? LOGIC_HIGH : LOGIC_LOW));
+		}
+		trigger.previousLevel = level;
+	} else {
+		if (trigger.primed == true) {
+			fired = (trigger.edge == ANALOG_TRIGGER_RISING) ?
+					((trigger.previousValue < trigger.level) && (value >= trigger.level)) :
+					((trigger.previousValue > trigger.level) && (value <= trigger.level));
+		}
+		trigger.previousValue = value;
+	}
+	trigger.primed = true;
+	return fired;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Arms the trigger for a capture of the next single channel sampling. Must only be called while the ADC is not
+ * sampling.
+ *
+ * @param source const Digital_Input_t* The digital input whose edge fires the trigger, or NULL to fire on the captured
+ * input crossing the level.
+ * @param level int32_t The analog threshold (ADC Counts). Ignored for a digital source.
+ * @param edge AnalogTriggerEdge_t The direction of change which fires the trigger.
+ * @param pre uint32_t The number of samples to keep from before the trigger.
+ * @param post uint32_t The number of samples to take from the trigger on, at least 1. The sample which fired the
+ * trigger is the first of these.
+ * @retval bool FALSE if the capture does not fit in the sample pool or the edge is invalid.
+ */
+bool AnalogTrigger_Arm(const Digital_Input_t* source, int32_t level, AnalogTriggerEdge_t edge, uint32_t pre, uint32_t post) {
+	if ((edge >= NUM_ANALOG_TRIGGER_EDGES) || (post == 0U) || (pre > ANALOG_TRIGGER_MAX_CAPTURE)
+			|| (post > (ANALOG_TRIGGER_MAX_CAPTURE - pre))) {
+#ifdef ANALOG_TRIGGER_DEBUG
+		printf("[Analog Trigger] Invalid capture of %lu pre and %lu post samples.\n\r", pre, post);
+#endif
+		return false;
+	}
+	trigger.source = source;
+	trigger.external = false;
+	trigger.fired = false;
+	trigger.level = level;
+	trigger.edge = edge;
+	trigger.pre = pre;
+	trigger.remaining = post;
+	trigger.primed = false;
+	trigger.state = ANALOG_TRIGGER_ARMED;
+	return true;
+}
+
+/**
+ * Arms the trigger for a capture of the next single channel sampling, fired by a trigger frame from the CAN master.
+ * Must only be called while the ADC is not sampling.
+ *
+ * @param pre uint32_t The number of samples to keep from before the trigger.
+ * @param post uint32_t The number of samples to take from the trigger on, at least 1.
+ * @retval bool FALSE if the capture does not fit in the sample pool.
+ */
+bool AnalogTrigger_ArmExternal(uint32_t pre, uint32_t post) {
+	if (AnalogTrigger_Arm(NULL, 0, ANALOG_TRIGGER_RISING, pre, post) == false) {
+		return false;
+	}
+	trigger.external = true;
+	return true;
+}
+
+/**
+ * Fires an externally armed trigger, which is taken on the next conversion. Called from the CAN receive interrupt.
+ *
+ * @param none
+ * @retval none
+ */
+void AnalogTrigger_Fire(void) {
+	if ((trigger.state == ANALOG_TRIGGER_ARMED) && (trigger.external == true)) {
+		trigger.fired = true;
+	}
+}
+
+/**
+ * Abandons any capture in progress, returning the input to normal streaming. Called whenever the ADC goes idle.
+ *
+ * @param none
+ * @retval none
+ */
+void AnalogTrigger_Disarm(void) {
+	trigger.state = ANALOG_TRIGGER_IDLE;
+}
+
+/**
+ * Retrieves the current stage of the capture.
+ *
+ * @param none
+ * @retval AnalogTriggerState_t The stage of the capture.
+ */
+AnalogTriggerState_t AnalogTrigger_GetState(void) {
+	return trigger.state;
+}
+
+/**
+ * Indicates if samples must be held in the buffer rather than written, because the capture is not yet frozen.
+ *
+ * @param none
+ * @retval bool TRUE while the trigger is armed or capturing.
+ */
+bool AnalogTrigger_IsHolding(void) {
+	return ((trigger.state == ANALOG_TRIGGER_ARMED) || (trigger.state == ANALOG_TRIGGER_CAPTURING));
+}
+
+/**
+ * Passes a sample of the captured input through the trigger, storing it as part of the capture. Called from the DRDY
+ * interrupt for every sample while a capture is in progress.
+ *
+ * @param input Analog_Input_t* The captured input. It must have the whole sample pool.
+ * @param value int32_t The measured value (ADC Counts).
+ * @param timestamp uint64_t The time of the measurement.
+ * @param flags uint8_t The ANALOG_SAMPLE_FLAG_ bits of the measurement.
+ * @retval bool TRUE once the capture is complete and sampling should stop.
+ */
+bool AnalogTrigger_Process(Analog_Input_t* input, int32_t value, uint64_t timestamp, uint8_t flags) {
+	switch (trigger.state) {
+	case ANALOG_TRIGGER_ARMED:
+		if (isTriggered(value) == false) {
+			/* Keep only the most recent history */
+			StoreAnalogSample(input, value, timestamp, flags);
+			const uint32_t held = RingBuffer_Count(&input->samples);
+			if (held > trigger.pre) {
+				RingBuffer_Release(&input->samples, held - trigger.pre);
+			}
+			break;
+		}
+#ifdef ANALOG_TRIGGER_DEBUG
+		printf("[Analog Trigger] Triggered.\n\r");
+#endif
+		trigger.state = ANALOG_TRIGGER_CAPTURING;
+		/* Hand the trigger on to any slaves, which take it on their next conversion */
+		Tekdaqc_CAN_SendSync(CAN_SYNC_TRIGGER, 0U);
+		/* The triggering sample starts the post-trigger samples */
+	case ANALOG_TRIGGER_CAPTURING:
+		StoreAnalogSample(input, value, timestamp, flags);
+		if (--(trigger.remaining) == 0U) {
+			trigger.state = ANALOG_TRIGGER_COMPLETE;
+			return true;
+		}
+		break;
+	case ANALOG_TRIGGER_IDLE:
+	case ANALOG_TRIGGER_COMPLETE:
+	default:
+		break;
+	}
+	return false;
+}
+
+/**
+ * Convert a human readable string into the relevant AnalogTriggerEdge_t value.
+ *
+ * @param str const char* The string to convert.
+ * @retval AnalogTriggerEdge_t The edge, or NUM_ANALOG_TRIGGER_EDGES if the string is not recognized.
+ */
+AnalogTriggerEdge_t AnalogTrigger_StringToEdge(const char* str) {
+	for (uint_fast8_t i = 0U; i < NUM_ANALOG_TRIGGER_EDGES; ++i) {
+		if (strcmp(str, EDGE_STRINGS[i]) == 0) {
+			return (AnalogTriggerEdge_t) i;
+		}
+	}
+	return NUM_ANALOG_TRIGGER_EDGES;
+}
@@ -30,9 +30,18 @@
 #include "AnalogInput_Multiplexer.h"
 #include "Tekdaqc_CommandInterpreter.h"
 #include "ADS1256_Driver.h"
+#include "TelnetServer.h"
+#include "Tekdaqc_Profile.h"
+#include "Tekdaqc_Format.h"
+#include "Tekdaqc_Rice.h"
+#include "Tekdaqc_Timers.h"
+#include "Tekdaqc_CAN.h"
+#include "ADC_StateMachine.h"
+#include "BoardTemperature.h"
 #include <stdlib.h>
 #include <string.h>
 #include <inttypes.h>
+#include <math.h>
 
 #ifdef PRINTF_OUTPUT
 #include <stdio.h>
@@ -49,6 +58,486 @@
  */
 #define ANALOG_INPUT_HEADER "\n\r--------------------\n\rAnalog Input\n\r\tName: %s\n\r\tPhysical Input: %i\n\r\tPGA: %s\n\r\tRate: %s\n\r\tBuffer Status: %s\n\r--------------------\n\r"
 
+/**
+ * @internal
+ * @def ANALOG_INPUT_ID_HEADER
+ * @brief The header format string for a batch of text samples from an input whose full header the client has already
+ * been sent during this sampling run.
+ */
+#define ANALOG_INPUT_ID_HEADER "\n\rAnalog Input %i\n\r"
+
+/**
+ * @internal
+ * @def ANALOG_STREAM_HEADER
+ * @brief The format string of the text stream descriptor, giving the descriptor version and the columns of each
+ * sample line.
+ */
+#define ANALOG_STREAM_HEADER "\n\r--------------------\n\rStream Format\n\r\tVersion: %u\n\r\tEncoding: TEXT\n\r\tFields: %s%s%s%s\n\r--------------------\n\r"
+
+/*
+ * Binary sample framing. All multi-byte fields are little endian. Each call to WriteAnalogInput() produces one frame:
+ *
+ *   Frame:   [ANALOG_BINARY_FRAME_START][length:2][records...]
+ *   Config:  [ANALOG_BINARY_CONFIG_RECORD][channel][gain][rate][buffer][timestamp:8][sequence:4]
+ *   Gap:     [ANALOG_BINARY_SEQUENCE_RECORD][channel][sequence:4]
+ *   Sample:  [channel][delta timestamp:2][value:3][flags]
+ *   Stats:   [ANALOG_BINARY_STATISTICS_RECORD][channel][start:8][duration:4][count:4][min:3][max:3][mean:3][rms:3]
+ *   Packed:  [ANALOG_BINARY_COMPRESSED_RECORD][channel][count][time k][value k][size:2][bits...]
+ *   Capture: [ANALOG_BINARY_CAPTURE_RECORD][channel][index:4][count:2][value:3 x count]
+ *   Spectrum:[ANALOG_BINARY_SPECTRUM_RECORD][channel][points:2][bin:2][count:2][amplitude:4 x count]
+ *   Power:   [ANALOG_BINARY_POWER_RECORD][power channel][voltage][current][start:8][duration:4][count:4][cycles:2]
+ *            [voltage rms:4][current rms:4][power:4][power factor:4]
+ *   Math:    [ANALOG_BINARY_MATH_RECORD][math channel][flags][timestamp:8][value:4]
+ *   Mixed:   [ANALOG_BINARY_MIXED_RECORD][timestamp:8][inputs:4][outputs:4]
+ *   Format:  [ANALOG_BINARY_FORMAT_RECORD][version][compressed][fields][sample size]
+ *   Aux:     [ANALOG_BINARY_AUX_RECORD][timestamp:8][count][value:2 x count]
+ *
+ * A config record is sent before the first sample of a channel, whenever its settings change and whenever the time
+ * since its previous sample does not fit in the delta field. Its timestamp is that of the following sample, whose
+ * delta is then 0. In statistics mode a statistics record replaces the samples of each window, preceded by a config
+ * record when the client has not yet been told the channel's settings.
+ *
+ * Every sample of a channel has a sequence number, which counts up from 0 when sampling starts and also counts the
+ * samples lost when the channel's buffer overflowed. A sample record carries no sequence number, it is one more than
+ * that of the channel's previous sample. A config record gives the sequence number of the following sample, and a gap
+ * record is sent in place of a config record when only the sequence number has jumped, so every lost sample is
+ * counted without widening the sample records. The frame start byte is distinct from the
+ * first byte of every text message. The flags of a sample are its ANALOG_SAMPLE_FLAG_ bits.
+ *
+ * The gain of an auto-ranged input changes between its samples. The first sample at a new gain carries
+ * ANALOG_SAMPLE_FLAG_RANGE and is preceded by a config record with the gain, so every value can be scaled by the gain
+ * it was converted at.
+ *
+ * When compression is enabled a run of samples is sent as a single packed record if that is smaller than their
+ * sample records. Its size bytes of bits hold, for each sample, the change in its timestamp delta, the change in its
+ * value and its flags. Both changes are zigzag coded (0, -1, 1, -2... as 0, 1, 2, 3...) and Rice coded, see
+ * Tekdaqc_Rice.h, with the record's time and value parameters; escaped numbers are 17 and 25 bits wide. The first
+ * sample's changes are relative to a delta and value of 0. The flags are a 0 bit, or a 1 bit followed by the 8 flag
+ * bits. Bits are packed least significant first and the last byte is padded with zeros.
+ *
+ * A burst capture is downloaded as capture records, each in a frame of its own. They carry the raw codes of count
+ * consecutive conversions starting with conversion index of the capture, without timestamps or flags. The spectrum
+ * of a capture, see AnalogInput_Spectrum.c, is sent as spectrum records of count consecutive bins starting with bin
+ * of the points / 2 + 1 bins of a points point FFT. Each amplitude is an IEEE 754 single precision float in ADC codes.
+ *
+ * A power record, see AnalogInput_Power.c, holds the results of a window of cycles of a power channel, whose voltage
+ * and current are the physical inputs given. The results are IEEE 754 single precision floats in ADC codes.
+ *
+ * A mixed record, see AnalogInput_Mixed.c, holds the digital state captured with a scan, bit n of inputs set if GPIn
+ * was high and bit n of outputs if output n was on. Its timestamp is exactly that of the scan's first sample, so the
+ * two can be matched without any tolerance.
+ *
+ * The fields of a sample record follow the client's DATA_FIELD_ selection: without DATA_FIELD_TIMESTAMP it has no
+ * delta timestamp, the timing following from the config records and the rate, and without DATA_FIELD_FLAGS no flags.
+ * A client which selected its format with the FORMAT command also asked for DATA_FIELD_DESCRIPTOR, and the first
+ * frame of each sampling run then starts with a format record: ANALOG_STREAM_FORMAT_VERSION, 1 if runs may be packed,
+ * the DATA_FIELD_ bits in use and the size of each sample record, so the stream describes itself. In the text format
+ * the descriptor is the ANALOG_STREAM_HEADER, and the fields select the columns of each sample line. Packed records
+ * always hold every field, so compression is only used with all of them.
+ */
+
+/**
+ * @internal
+ * @def ANALOG_INPUT_MAX_LINE_LENGTH
+ * @brief The longest text line a single sample can produce, including the NULL terminator.
+ */
+#define ANALOG_INPUT_MAX_LINE_LENGTH	53U
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_FRAME_START
+ * @brief The byte which begins every binary sample frame (ASCII group separator).
+ */
+#define ANALOG_BINARY_FRAME_START		((uint8_t) 0x1D)
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_CONFIG_RECORD
+ * @brief The channel byte which marks a config record. Physical inputs never use this value.
+ */
+#define ANALOG_BINARY_CONFIG_RECORD		((uint8_t) 0xFF)
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_STATISTICS_RECORD
+ * @brief The channel byte which marks a statistics record. Physical inputs never use this value.
+ */
+#define ANALOG_BINARY_STATISTICS_RECORD	((uint8_t) 0xFE)
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_COMPRESSED_RECORD
+ * @brief The channel byte which marks a packed record of compressed samples. Physical inputs never use this value.
+ */
+#define ANALOG_BINARY_COMPRESSED_RECORD	((uint8_t) 0xFD)
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_SEQUENCE_RECORD
+ * @brief The channel byte which marks a gap record. Physical inputs never use this value.
+ */
+#define ANALOG_BINARY_SEQUENCE_RECORD	((uint8_t) 0xFC)
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_CAPTURE_RECORD
+ * @brief The channel byte which marks a record of burst capture codes. Physical inputs never use this value.
+ */
+#define ANALOG_BINARY_CAPTURE_RECORD	((uint8_t) 0xFB)
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_CAPTURE_HEADER_SIZE
+ * @brief The size in bytes of a capture record before its values.
+ */
+#define ANALOG_BINARY_CAPTURE_HEADER_SIZE	8U
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_SPECTRUM_RECORD
+ * @brief The channel byte which marks a record of spectrum bins. Physical inputs never use this value.
+ */
+#define ANALOG_BINARY_SPECTRUM_RECORD	((uint8_t) 0xFA)
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_SPECTRUM_HEADER_SIZE
+ * @brief The size in bytes of a spectrum record before its amplitudes.
+ */
+#define ANALOG_BINARY_SPECTRUM_HEADER_SIZE	8U
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_AMPLITUDE_SIZE
+ * @brief The size in bytes of an amplitude in a spectrum record.
+ */
+#define ANALOG_BINARY_AMPLITUDE_SIZE		4U
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_POWER_RECORD
+ * @brief The channel byte which marks a power record. Physical inputs never use this value.
+ */
+#define ANALOG_BINARY_POWER_RECORD		((uint8_t) 0xF9)
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_MATH_RECORD
+ * @brief The channel byte which marks a math channel record. Physical inputs never use this value.
+ */
+#define ANALOG_BINARY_MATH_RECORD		((uint8_t) 0xF8)
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_MATH_SIZE
+ * @brief The size in bytes of a math channel record.
+ */
+#define ANALOG_BINARY_MATH_SIZE			15U
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_MIXED_RECORD
+ * @brief The type byte which marks a mixed-signal state record.
+ */
+#define ANALOG_BINARY_MIXED_RECORD		((uint8_t) 0xF7)
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_MIXED_SIZE
+ * @brief The size in bytes of a mixed-signal state record.
+ */
+#define ANALOG_BINARY_MIXED_SIZE		17U
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_FORMAT_RECORD
+ * @brief The record type of a stream format record.
+ */
+#define ANALOG_BINARY_FORMAT_RECORD		((uint8_t) 0xF6)
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_FORMAT_SIZE
+ * @brief The size in bytes of a stream format record.
+ */
+#define ANALOG_BINARY_FORMAT_SIZE		5U
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_AUX_RECORD
+ * @brief The record type of an auxiliary analog readings record.
+ */
+#define ANALOG_BINARY_AUX_RECORD		((uint8_t) 0xF5)
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_AUX_SIZE
+ * @brief The size in bytes of an auxiliary analog readings record.
+ */
+#define ANALOG_BINARY_AUX_SIZE			(10U + (2U * NUM_AUX_ANALOG_INPUTS))
+
+/**
+ * @internal
+ * @def ANALOG_STREAM_FORMAT_VERSION
+ * @brief The version of the stream descriptor, raised whenever the layout of the records or lines it describes
+ * changes.
+ */
+#define ANALOG_STREAM_FORMAT_VERSION	1U
+
+/**
+ * @internal
+ * @def ANALOG_RANGE_HIGH
+ * @brief The magnitude above which auto-ranging lowers an input's gain, 7/8 of full scale.
+ */
+#define ANALOG_RANGE_HIGH				((MAX_CODE / 8U) * 7U)
+
+/**
+ * @internal
+ * @def ANALOG_RANGE_LOW
+ * @brief The magnitude below which auto-ranging may raise an input's gain, 3/8 of full scale. Twice it is still below
+ * ANALOG_RANGE_HIGH, so the gain does not hunt between two settings.
+ */
+#define ANALOG_RANGE_LOW				((MAX_CODE / 8U) * 3U)
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_COMPRESSED_HEADER_SIZE
+ * @brief The size in bytes of a packed record before its bits.
+ */
+#define ANALOG_BINARY_COMPRESSED_HEADER_SIZE	7U
+
+/**
+ * @internal
+ * @def ANALOG_COMPRESSED_TIME_WIDTH
+ * @brief The width in bits of an escaped change in timestamp delta.
+ */
+#define ANALOG_COMPRESSED_TIME_WIDTH	17U
+
+/**
+ * @internal
+ * @def ANALOG_COMPRESSED_VALUE_WIDTH
+ * @brief The width in bits of an escaped change in value.
+ */
+#define ANALOG_COMPRESSED_VALUE_WIDTH	25U
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_FRAME_HEADER_SIZE
+ * @brief The size in bytes of the binary frame header.
+ */
+#define ANALOG_BINARY_FRAME_HEADER_SIZE	3U
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_CONFIG_SIZE
+ * @brief The size in bytes of a binary config record.
+ */
+#define ANALOG_BINARY_CONFIG_SIZE		17U
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_SAMPLE_SIZE
+ * @brief The size in bytes of a binary sample record.
+ */
+#define ANALOG_BINARY_SAMPLE_SIZE		7U
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_STATISTICS_SIZE
+ * @brief The size in bytes of a binary statistics record.
+ */
+#define ANALOG_BINARY_STATISTICS_SIZE	30U
+
+/**
+ * @internal
+ * @def ANALOG_STATISTICS_FORMAT
+ * @brief The format string for printing a statistics window to a human readable string.
+ */
+#define ANALOG_STATISTICS_FORMAT "Statistics: %" PRIu64 " - %" PRIu64 ", Count: %" PRIu32 ", Min: %" PRIi32 ", Max: %" PRIi32 ", Mean: %" PRIi32 ", RMS: %" PRIu32 "\n\r"
+
+/**
+ * @internal
+ * @def ANALOG_MATH_FORMAT
+ * @brief The format string for printing a math channel result to a human readable string. The value is printed to
+ * three decimal places with integers, as user output has no floating point formatting.
+ */
+#define ANALOG_MATH_FORMAT "\n\rMath Channel %" PRIu8 ": %s%" PRIu32 ".%03" PRIu32 ", Timestamp: %" PRIu64 ", Flags: 0x%02" PRIX8 "\n\r"
+
+/**
+ * @internal
+ * @def ANALOG_MIXED_FORMAT
+ * @brief The format string for printing the digital state captured with a scan to a human readable string.
+ */
+#define ANALOG_MIXED_FORMAT "\n\rMixed State: Inputs: 0x%06" PRIX32 ", Outputs: 0x%06" PRIX32 ", Timestamp: %" PRIu64 "\n\r"
+
+/**
+ * @internal
+ * @def ANALOG_AUX_FORMAT
+ * @brief The format string for printing one auxiliary reading captured with a scan, the line listing each in turn.
+ */
+#define ANALOG_AUX_FORMAT "%s: %" PRIu32 " mV, "
+
+/**
+ * @internal
+ * @def ANALOG_POWER_FORMAT
+ * @brief The format string for printing a power channel's window to a human readable string. The power factor is
+ * printed in thousandths, as user output has no floating point formatting.
+ */
+#define ANALOG_POWER_FORMAT "\n\rPower Channel %" PRIu8 " (Voltage %" PRIi32 ", Current %" PRIi32 ")\n\rWindow: %" PRIu64 " - %" PRIu64 ", Count: %" PRIu32 ", Cycles: %" PRIu16 ", Frequency: %" PRIu32 " mHz, Vrms: %" PRIi32 ", Irms: %" PRIi32 ", Power: %" PRIi64 ", Power Factor: %" PRIi32 "/1000\n\r"
+
+/**
+ * @internal
+ * @def ANALOG_LATEST_FORMAT
+ * @brief The format string for printing the most recent measurement of an input to a human readable string.
+ */
+#define ANALOG_LATEST_FORMAT "\t%" PRIu8 ": %" PRIi32 " @ %s, Flags: 0x%02" PRIX8 "\n\r"
+
+/**
+ * @internal
+ * @def ANALOG_LIST_ENTRY_SIZE
+ * @brief The space kept for the rendered list description of each input, which fits the longest name and settings.
+ */
+#define ANALOG_LIST_ENTRY_SIZE			320U
+
+/**
+ * @internal
+ * @def ANALOG_LIST_HEADER
+ * @brief The string opening the list of added analog inputs and its external inputs section.
+ */
+#define ANALOG_LIST_HEADER "\n\r--------------------\n\rAdded Analog Inputs\n\r\tExternal Inputs:\n\r"
+
+/**
+ * @internal
+ * @def ANALOG_LIST_INTERNAL_HEADER
+ * @brief The string opening the internal inputs section of the list of added analog inputs.
+ */
+#define ANALOG_LIST_INTERNAL_HEADER "\n\r\tInternal Inputs:\n\r"
+
+/**
+ * @internal
+ * @def ANALOG_LIST_DIFFERENTIAL_HEADER
+ * @brief The string opening the differential inputs section of the list of added analog inputs.
+ */
+#define ANALOG_LIST_DIFFERENTIAL_HEADER "\n\r\tDifferential Inputs:\n\r"
+
+/**
+ * @internal
+ * @def ANALOG_LIST_EXTERNAL_FORMAT
+ * @brief The format string for describing an external input in the list of added analog inputs.
+ */
+#define ANALOG_LIST_EXTERNAL_FORMAT "\t\tPhysical Input %" PRIi8 ":\n\r\t\t\tExternal Input: %s\n\r\t\t\tName: %s\n\r\t\t\tGain: %s\n\r\t\t\tRate: %s\n\r\t\t\tBuffer: %s\n\r\t\t\tFilter: %s/%" PRIu16 "\n\r\t\t\tOversampling: %" PRIu16 "\n\r\t\t\tSettle Time: %" PRIu16 " us\n\r\t\t\tThermocouple: %s\n\r"
+
+/**
+ * @internal
+ * @def ANALOG_LIST_INTERNAL_FORMAT
+ * @brief The format string for describing an internal input in the list of added analog inputs.
+ */
+#define ANALOG_LIST_INTERNAL_FORMAT "\t\tPhysical Input %" PRIi8 ":\n\r\t\t\tInternal Input: %s\n\r\t\t\tName: %s\n\r\t\t\tGain: %s\n\r\t\t\tRate: %s\n\r\t\t\tBuffer: %s\n\r\t\t\tFilter: %s/%" PRIu16 "\n\r\t\t\tOversampling: %" PRIu16 "\n\r"
+
+/**
+ * @internal
+ * @def ANALOG_LIST_DIFFERENTIAL_FORMAT
+ * @brief The format string for describing a differential input in the list of added analog inputs.
+ */
+#define ANALOG_LIST_DIFFERENTIAL_FORMAT "\t\tPhysical Input %" PRIi8 ":\n\r\t\t\tPair: %s - %s\n\r\t\t\tName: %s\n\r\t\t\tGain: %s\n\r\t\t\tRate: %s\n\r\t\t\tBuffer: %s\n\r\t\t\tFilter: %s/%" PRIu16 "\n\r\t\t\tOversampling: %" PRIu16 "\n\r"
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_MAX_DELTA
+ * @brief The largest timestamp delta which fits in a sample record.
+ */
+#define ANALOG_BINARY_MAX_DELTA			((uint64_t) 0xFFFFU)
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_BUFFER_SIZE
+ * @brief The size of the buffer a binary frame is built in.
+ */
+#define ANALOG_BINARY_BUFFER_SIZE		(ANALOG_BINARY_FRAME_HEADER_SIZE + (SINGLE_ANALOG_WRITE_COUNT * (ANALOG_BINARY_CONFIG_SIZE + ANALOG_BINARY_SAMPLE_SIZE)))
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_CAPTURE_COUNT
+ * @brief The most burst capture codes a single capture record carries, as many as fit in the frame buffer.
+ */
+#define ANALOG_BINARY_CAPTURE_COUNT		((ANALOG_BINARY_BUFFER_SIZE - ANALOG_BINARY_FRAME_HEADER_SIZE - ANALOG_BINARY_CAPTURE_HEADER_SIZE) / ANALOG_SAMPLE_VALUE_SIZE)
+
+/**
+ * @internal
+ * @def ANALOG_BINARY_SPECTRUM_COUNT
+ * @brief The most spectrum bins a single spectrum record carries, as many as fit in the frame buffer.
+ */
+#define ANALOG_BINARY_SPECTRUM_COUNT	((ANALOG_BINARY_BUFFER_SIZE - ANALOG_BINARY_FRAME_HEADER_SIZE - ANALOG_BINARY_SPECTRUM_HEADER_SIZE) / ANALOG_BINARY_AMPLITUDE_SIZE)
+
+/**
+ * @internal
+ * @def NUM_PLAN_RATES
+ * @brief The number of data rates the sampling planner chooses from.
+ */
+#define NUM_PLAN_RATES					16U
+
+/* Expand EXTERNAL_MUX_TABLE and INTERNAL_INPUT_TABLE entries to the names of the inputs */
+#define EXTERNAL_INPUT_NAME(n, code) "External " #n,
+#define INTERNAL_INPUT_NAME(input, number, name, pos, neg) [input] = name,
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Data structure for tracking what a binary client has been told about a channel.
+ */
+typedef struct {
+	bool valid; /**< TRUE if a config record has been sent for this channel. */
+	ADS1256_PGA_t gain; /**< The gain reported in the last config record. */
+	ADS1256_SPS_t rate; /**< The rate reported in the last config record. */
+	ADS1256_BUFFER_t buffer; /**< The buffer setting reported in the last config record. */
+	uint64_t timestamp; /**< The timestamp of the last sample sent, which deltas are relative to. */
+	uint32_t sequence; /**< The sequence number the next sample sent is implied to have. */
+} BinaryChannelState_t;
+
+/**
+ * @internal
+ * @brief Data structure for tracking what a text client has been told about a channel.
+ */
+typedef struct {
+	bool valid; /**< TRUE if the full header has been sent for this channel. */
+	ADS1256_PGA_t gain; /**< The gain reported in the last full header. */
+	ADS1256_SPS_t rate; /**< The rate reported in the last full header. */
+	ADS1256_BUFFER_t buffer; /**< The buffer setting reported in the last full header. */
+} TextChannelState_t;
+
+/**
+ * @internal
+ * @brief Data structure holding the settings an input's list description is rendered from.
+ */
+typedef struct {
+	char name[MAX_ANALOG_INPUT_NAME_LENGTH]; /**< The name of the input. */
+	ExternalMuxedInput_t externalInput; /**< The external channel of the input. */
+	InternalAnalogInput_t internalInput; /**< The internal channel of the input. */
+	ADS1256_AIN_t positiveInput; /**< The positive side of a differential pair. */
+	ADS1256_AIN_t negativeInput; /**< The negative side of a differential pair. */
+	ADS1256_PGA_t gain; /**< The gain of the input. */
+	ADS1256_SPS_t rate; /**< The rate of the input. */
+	ADS1256_BUFFER_t buffer; /**< The buffer setting of the input. */
+	AnalogFilterType_t filter; /**< The filter applied to the input. */
+	uint16_t decimation; /**< The decimation of the filter. */
+	uint16_t oversampling; /**< The oversampling of the input. */
+	uint16_t settleTime; /**< The settle time of the input. */
+	ThermocoupleType_t thermocouple; /**< The thermocouple the input is linearized for. */
+} AnalogListKey_t;
+
+/**
+ * @internal
+ * @brief Data structure caching the rendered list description of an input.
+ */
+typedef struct {
+	AnalogListKey_t key; /**< The settings the description was rendered from. */
+	uint16_t length; /**< The length of the description, 0 if none has been rendered. */
+	char text[ANALOG_LIST_ENTRY_SIZE]; /**< The description. */
+} AnalogListEntry_t;
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE VARIABLES */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -56,458 +545,2776 @@
 /* The function pointer used for writing strings to the data connection */
 static WriteFunction writer = 0;
 
-/*--------------------------------------------------------------------------------------------------------*/
-/* PRIVATE EXTERNAL VARIABLES */
-/*--------------------------------------------------------------------------------------------------------*/
+/* The function pointer used for writing binary frames to the data connection */
+static BinaryWriteFunction binaryWriter = 0;
 
-/* List of external analog inputs */
-Analog_Input_t Ext_AInputs[NUM_EXT_ANALOG_INPUTS];
+/* The binary framing state of each physical input */
+static BinaryChannelState_t binaryChannels[NUM_ANALOG_INPUTS] CCM_DATA;
 
-/* The offset calibration input */
-Analog_Input_t Offset_Cal_AInput;
+/* The text header state of each physical input */
+static TextChannelState_t textChannels[NUM_ANALOG_INPUTS] CCM_DATA;
 
-/* List of internal analog inputs */
-Analog_Input_t Int_AInputs[NUM_INT_ANALOG_INPUTS];
+/* The buffer binary frames are built in */
+static uint8_t binaryFrame[ANALOG_BINARY_BUFFER_SIZE];
 
-/*--------------------------------------------------------------------------------------------------------*/
-/* PRIVATE FUNCTION PROTOTYPES */
-/*--------------------------------------------------------------------------------------------------------*/
+/* The cached list description of each physical input */
+static AnalogListEntry_t analogListCache[NUM_ANALOG_INPUTS];
+
+/* TRUE if runs of binary sample records are compressed */
+static bool compressionEnabled = false;
+
+/* TRUE until the stream descriptor of the current sampling run has been sent */
+static bool descriptorPending = false;
+
+/* The bytes of binary sample frames sent since the last reset, and what they would have been uncompressed */
+static uint32_t compressionSentBytes = 0U;
+static uint32_t compressionRawBytes = 0U;
+
+/* The packed sample values shared among the inputs of the current scan */
+static uint8_t sampleValuePool[ANALOG_SAMPLE_POOL_SIZE * ANALOG_SAMPLE_VALUE_SIZE];
+
+/* The sample flags shared among the inputs of the current scan */
+static uint8_t sampleFlagPool[ANALOG_SAMPLE_POOL_SIZE];
+
+/* The sample timestamp deltas shared among the inputs of the current scan */
+static uint32_t sampleDeltaPool[ANALOG_SAMPLE_POOL_SIZE];
+
+/* The sample sequence number deltas shared among the inputs of the current scan */
+static uint16_t sampleSequencePool[ANALOG_SAMPLE_POOL_SIZE];
+
+/* The block base timestamps shared among the inputs of the current scan */
+static uint64_t sampleBlockPool[ANALOG_SAMPLE_POOL_SIZE / ANALOG_SAMPLE_BLOCK_SIZE];
+
+/* The block base sequence numbers shared among the inputs of the current scan */
+static uint32_t sampleBlockSequencePool[ANALOG_SAMPLE_POOL_SIZE / ANALOG_SAMPLE_BLOCK_SIZE];
+
+/* The cold junction's own packed sample values */
+static uint8_t coldJunctionValues[COLD_JUNCTION_BUFFER_SIZE * ANALOG_SAMPLE_VALUE_SIZE];
+
+/* The cold junction's own sample flags */
+static uint8_t coldJunctionFlags[COLD_JUNCTION_BUFFER_SIZE];
+
+/* The cold junction's own sample timestamp deltas */
+static uint32_t coldJunctionDeltas[COLD_JUNCTION_BUFFER_SIZE];
+
+/* The cold junction's own sample sequence number deltas */
+static uint16_t coldJunctionSequences[COLD_JUNCTION_BUFFER_SIZE];
+
+/* The cold junction's own block base timestamps */
+static uint64_t coldJunctionBlocks[COLD_JUNCTION_BUFFER_SIZE / ANALOG_SAMPLE_BLOCK_SIZE];
+
+/* The cold junction's own block base sequence numbers */
+static uint32_t coldJunctionBlockSequences[COLD_JUNCTION_BUFFER_SIZE / ANALOG_SAMPLE_BLOCK_SIZE];
+
+/* The number of bytes of analog data accepted by the connections since start up, wrapping */
+static uint32_t writtenBytes = 0U;
+
+/* The number of samples in a statistics window, 0 for no limit */
+static uint32_t statisticsWindow = 0U;
+
+/* The duration of a statistics window in microseconds, 0 for no limit */
+static uint64_t statisticsPeriod = 0U;
+
+/* Set while a configuration is open. The register images of the inputs changed in it are compiled when it is
+ * committed rather than after each command. */
+static bool configOpen = false;
+
+/* The data rates the sampling planner chooses from, slowest and so quietest first */
+static const ADS1256_SPS_t PLAN_RATES[NUM_PLAN_RATES] = { ADS1256_SPS_2_5, ADS1256_SPS_5, ADS1256_SPS_10, ADS1256_SPS_15,
+		ADS1256_SPS_25, ADS1256_SPS_30, ADS1256_SPS_50, ADS1256_SPS_60, ADS1256_SPS_100, ADS1256_SPS_500, ADS1256_SPS_1000,
+		ADS1256_SPS_2000, ADS1256_SPS_3750, ADS1256_SPS_7500, ADS1256_SPS_15000, ADS1256_SPS_30000 };
+
+/* The conversion rates of PLAN_RATES in samples per second */
+static const float PLAN_RATE_VALUES[NUM_PLAN_RATES] = { 2.5f, 5.0f, 10.0f, 15.0f, 25.0f, 30.0f, 50.0f, 60.0f, 100.0f, 500.0f,
+		1000.0f, 2000.0f, 3750.0f, 7500.0f, 15000.0f, 30000.0f };
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE EXTERNAL VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The inputs are read by the DRDY interrupt with every conversion, so they are kept off the DMA busses. Their sample
+ * storage, which the writers hand to the connections, stays in the shared pools. */
+
+/* List of external analog inputs */
+Analog_Input_t Ext_AInputs[NUM_EXT_ANALOG_INPUTS] CCM_DATA;
+
+/* The offset calibration input */
+Analog_Input_t Offset_Cal_AInput CCM_DATA;
+
+/* List of internal analog inputs */
+Analog_Input_t Int_AInputs[NUM_INT_ANALOG_INPUTS] CCM_DATA;
+
+/* List of differential analog inputs */
+Analog_Input_t Diff_AInputs[NUM_DIFF_ANALOG_INPUTS] CCM_DATA;
+
+/* Expands an EXTERNAL_MUX_TABLE entry to the address of its input */
+#define EXTERNAL_INPUT_ADDRESS(n, code) &Ext_AInputs[n],
+
+#if ((NUM_INT_ANALOG_INPUTS != 4U) || (NUM_DIFF_ANALOG_INPUTS != 4U))
+#error "The analog input table lists four internal and four differential inputs."
+#endif
+
+/* Every analog input indexed by its physical input number, so finding one is a single load rather than a search of
+ * the input classes. The inputs never move, so the table is fixed and kept in flash. */
+static Analog_Input_t* const analogInputTable[NUM_ANALOG_INPUTS] = {
+	EXTERNAL_MUX_TABLE(EXTERNAL_INPUT_ADDRESS)
+	&Offset_Cal_AInput,
+	&Int_AInputs[IN_SUPPLY_9V - (NUM_EXT_ANALOG_INPUTS + NUM_CAL_ANALOG_INPUTS)],
+	&Int_AInputs[IN_SUPPLY_5V - (NUM_EXT_ANALOG_INPUTS + NUM_CAL_ANALOG_INPUTS)],
+	&Int_AInputs[IN_SUPPLY_3_3V - (NUM_EXT_ANALOG_INPUTS + NUM_CAL_ANALOG_INPUTS)],
+	&Int_AInputs[IN_COLD_JUNCTION - (NUM_EXT_ANALOG_INPUTS + NUM_CAL_ANALOG_INPUTS)],
+	&Diff_AInputs[DIFFERENTIAL_0 - DIFFERENTIAL_0],
+	&Diff_AInputs[DIFFERENTIAL_1 - DIFFERENTIAL_0],
+	&Diff_AInputs[DIFFERENTIAL_2 - DIFFERENTIAL_0],
+	&Diff_AInputs[DIFFERENTIAL_3 - DIFFERENTIAL_0]
+};
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Initializes the members of the specified input structure.
+ */
+static void InitializeInput(Analog_Input_t* input);
+
+/**
+ * @internal
+ * @brief Returns an input's sample buffer to the state it has outside of a scan.
+ */
+static void ReleaseInputBuffer(Analog_Input_t* input);
+
+/**
+ * @internal
+ * @brief Builds the ADC register image for an input's settings.
+ */
+static void CompileInputRegisters(Analog_Input_t* input);
+
+/**
+ * @internal
+ * @brief Builds the ADC register image and thermocouple scale of an input's settings.
+ */
+static void BuildInputRegisters(Analog_Input_t* input);
+
+/**
+ * @internal
+ * @brief Removes an analog input from the board's list by physical channel.
+ */
+static void RemoveAnalogInputByID(uint8_t id);
+
+/**
+ * @internal
+ * @brief Converts the name of an ADC input into its channel.
+ */
+static bool StringToAnalogPin(const char* str, ADS1256_AIN_t* pin);
+
+/**
+ * @internal
+ * @brief Writes the data for an analog input in the selected data format.
+ */
+static WriteStatus_t WriteAnalogInputRecord(Analog_Input_t* input);
+
+/**
+ * @internal
+ * @brief Retrieves the list description of an input, rendering it only if the input has changed since it last was.
+ */
+static const AnalogListEntry_t* GetAnalogListEntry(const Analog_Input_t* input);
+
+/**
+ * @internal
+ * @brief Appends text to the list gathered in the string buffer, writing the buffer out first if it would overflow.
+ */
+static bool AppendAnalogList(const char* text, uint16_t length, uint16_t* used);
+
+/**
+ * @internal
+ * @brief Writes the data for an analog input as a binary frame.
+ */
+static WriteStatus_t WriteAnalogInputBinary(Analog_Input_t* input);
+
+/**
+ * @internal
+ * @brief Appends a run of samples to a binary frame, compressed if that is smaller.
+ */
+static uint16_t AppendSampleRun(const Analog_Input_t* input, BinaryChannelState_t* state, const int32_t* values,
+		uint8_t first, uint8_t run, uint16_t length);
+
+/**
+ * @internal
+ * @brief Appends a run of samples to a binary frame as a packed record.
+ */
+static uint16_t AppendCompressedRecord(const Analog_Input_t* input, BinaryChannelState_t* state, const int32_t* values,
+		uint8_t first, uint8_t run, uint16_t length);
+
+/**
+ * @internal
+ * @brief Retrieves the size of a binary sample record with the selected fields.
+ */
+static uint8_t GetBinarySampleSize(uint8_t fields);
+
+/**
+ * @internal
+ * @brief Writes the descriptor of the stream's format and fields.
+ */
+static WriteStatus_t WriteStreamDescriptor(void);
+
+/**
+ * @internal
+ * @brief Writes the samples of an input as CAN sample frames.
+ */
+static WriteStatus_t WriteAnalogInputCAN(Analog_Input_t* input);
+
+/**
+ * @internal
+ * @brief Retrieves the conversion rate of a data rate setting.
+ */
+static float GetConversionRate(ADS1256_SPS_t rate);
+
+/**
+ * @internal
+ * @brief Predicts the timing of a scan of every added input.
+ */
+static void EstimateScan(const ADS1256_SPS_t* rate, AnalogScanPrediction_t* prediction);
+
+/**
+ * @internal
+ * @brief Packs a little endian value into a buffer.
+ */
+static uint8_t PackLittleEndian(uint8_t* dest, uint64_t value, uint8_t size);
+
+/**
+ * @internal
+ * @brief Retrieves the timestamp of a stored sample.
+ */
+static uint64_t GetSampleTimestamp(const Analog_Input_t* input, uint32_t index);
+
+/**
+ * @internal
+ * @brief Retrieves the sequence number of a stored sample.
+ */
+static uint32_t GetSampleSequence(const Analog_Input_t* input, uint32_t index);
+
+/**
+ * @internal
+ * @brief Retrieves the gain a sample was converted at.
+ */
+static ADS1256_PGA_t GetSampleGain(const Analog_Input_t* input, uint32_t sequence);
+
+/**
+ * @internal
+ * @brief Appends a config or gap record to a binary frame if the client needs one.
+ */
+static uint16_t AppendConfigRecord(const Analog_Input_t* input, BinaryChannelState_t* state, uint64_t timestamp,
+		uint32_t sequence, uint16_t length);
+
+/**
+ * @internal
+ * @brief Starts a text batch with the full header of an input or, if the client already has it, just its id.
+ */
+static uint16_t FormatTextHeader(const Analog_Input_t* input, TextChannelState_t* state, ADS1256_PGA_t gain);
+
+/**
+ * @internal
+ * @brief Hands the running statistics window of an input to the writers.
+ */
+static bool CloseStatisticsWindow(Analog_Input_t* input);
+
+/**
+ * @internal
+ * @brief Computes the rounded mean and RMS of a statistics window.
+ */
+static void SummarizeStatistics(const AnalogStatistics_t* stats, int32_t* mean, uint32_t* rms);
+
+/**
+ * @internal
+ * @brief Writes the completed statistics window of an analog input.
+ */
+static WriteStatus_t WriteAnalogStatistics(Analog_Input_t* input);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Initializes the members of the specified input structure.
+ *
+ * @param input Analog_Input_t* Pointer/Reference to an analog input structure.
+ * @retval none
+ */
+static void InitializeInput(Analog_Input_t* input) {
+	input->buffer = ADS1256_BUFFER_ENABLED;
+	input->gain = ADS1256_PGAx1;
+	input->rate = ADS1256_SPS_10;
+	input->thermocouple = THERMOCOUPLE_NONE;
+	input->coldJunctionEMF = 0;
+	CompileInputRegisters(input);
+	ReleaseInputBuffer(input);
+	AnalogFilter_Init(&input->filter);
+	input->oversampling = 1U;
+	input->settleTime = ANALOG_INPUT_DEFAULT_SETTLE_TIME;
+	input->positiveInput = DIFFERENTIAL_DEFAULT_AINP;
+	input->negativeInput = DIFFERENTIAL_DEFAULT_AINN;
+	input->deadband = 0U;
+	input->heartbeat = 0U;
+	input->autoRange = false;
+	input->maxGain = ADS1256_PGAx64;
+	input->rangeChanges = 0U;
+	ResetAnalogInputReporting(input);
+	input->min = 0;
+	input->max = 0;
+	input->latestTimestamp = 0U;
+	++(input->latestVersion);
+	input->added = CHANNEL_NOTADDED;
+}
+
+/**
+ * Builds the ADC register image for an input's buffer, gain and rate settings, so that selecting the input for a
+ * conversion does not need to work out any register contents. The calibration values are left to be filled in by
+ * the ADC state machine, which knows the board temperature they depend on. The scale from ADC counts to the
+ * nanovolts a thermocouple is linearized from is also worked out here, as it depends on the gain.
+ *
+ * @param input Analog_Input_t* Pointer/Reference to an analog input structure.
+ * @retval none
+ */
+static void CompileInputRegisters(Analog_Input_t* input) {
+	if ((configOpen == true) && (input->physicalInput != IN_COLD_JUNCTION)) {
+		/* Compiled once when the configuration is committed. The cold junction is converted while idle, so it is
+		 * never left waiting. */
+		input->registersPending = true;
+		return;
+	}
+	input->registersPending = false;
+	BuildInputRegisters(input);
+}
+
+/**
+ * Builds the ADC register image and thermocouple scale of an input's settings. The image's calibration values are
+ * left to be looked up again by the ADC state machine when it next loads the image. Also used from the DRDY interrupt
+ * when auto-ranging changes the gain.
+ *
+ * @param input Analog_Input_t* Pointer/Reference to an analog input structure.
+ * @retval none
+ */
+static void BuildInputRegisters(Analog_Input_t* input) {
+	ADS1256_BuildRegisterImage(&input->registers, input->buffer, input->gain, input->rate);
+	input->calibrationVersion = 0U; /* No calibration has been applied to the image */
+	input->gainCorrection = ANALOG_GAIN_CORRECTION_UNITY;
+	/* Full scale, MAX_CODE, is 2 * V_REFERENCE / gain */
+	input->emfScale = (uint32_t) ((2.0f * V_REFERENCE * 1.0e9f * (float) (1UL << ANALOG_EMF_SCALE_BITS))
+			/ ((float) ADS1256_GetGainMultiplier(input->gain) * (float) MAX_CODE) + 0.5f);
+}
+
+/**
+ * Returns an input's sample buffer to the state it has outside of a scan. The cold junction keeps its own buffer,
+ * every other input is left without one. A ring of capacity 1 with no storage is never written, since only the
+ * inputs of a scan are sampled, and always reads as empty.
+ *
+ * @param input Analog_Input_t* Pointer/Reference to an analog input structure.
+ * @retval none
+ */
+static void ReleaseInputBuffer(Analog_Input_t* input) {
+	if (input == GetAnalogInputByNumber(IN_COLD_JUNCTION)) {
+		input->values = coldJunctionValues;
+		input->flags = coldJunctionFlags;
+		input->timestampDeltas = coldJunctionDeltas;
+		input->blockTimestamps = coldJunctionBlocks;
+		input->sequenceDeltas = coldJunctionSequences;
+		input->blockSequences = coldJunctionBlockSequences;
+		RingBuffer_Init(&input->samples, COLD_JUNCTION_BUFFER_SIZE);
+	} else {
+		input->values = NULL;
+		input->flags = NULL;
+		input->timestampDeltas = NULL;
+		input->blockTimestamps = NULL;
+		input->sequenceDeltas = NULL;
+		input->blockSequences = NULL;
+		RingBuffer_Init(&input->samples, 1U);
+	}
+}
+
+/**
+ * Removes an analog input structure from the board's list by specifying its physical input channel.
+ *
+ * @param id uint8_t The physical channel to remove, if present.
+ * @retval none
+ */
+static void RemoveAnalogInputByID(uint8_t id) {
+	if (id >= NUM_ANALOG_INPUTS) {
+		/* This is out of range */
+#ifdef ANALOGINPUT_DEBUG
+		printf("[Analog Input] Cannot find the requested analog input. Input does not exist on the board.\n\r");
+#endif
+	} else if ((id == IN_COLD_JUNCTION) || (id == EXTERNAL_OFFSET_CAL)) {
+		/* Do nothing, we don't want to remove these inputs. */
+	} else {
+		InitializeInput(analogInputTable[id]);
+	}
+}
+
+/**
+ * Converts the name of an ADC input, as given by ADS1256_StringFromAIN(), into its channel.
+ *
+ * @param str const char* The name of the input.
+ * @param pin ADS1256_AIN_t* Set to the channel if the name is valid.
+ * @retval bool TRUE if the name is that of an ADC input.
+ */
+static bool StringToAnalogPin(const char* str, ADS1256_AIN_t* pin) {
+	for (uint_fast8_t i = ADS1256_AIN0; i <= ADS1256_AIN_COM; ++i) {
+		if (strcmp(str, ADS1256_StringFromAIN((ADS1256_AIN_t) i)) == 0) {
+			*pin = (ADS1256_AIN_t) i;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Packs the lowest bytes of a value into a buffer, least significant byte first.
+ *
+ * @param dest uint8_t* The buffer to write to.
+ * @param value uint64_t The value to pack.
+ * @param size uint8_t The number of bytes to pack.
+ * @retval uint8_t The number of bytes written.
+ */
+static uint8_t PackLittleEndian(uint8_t* dest, uint64_t value, uint8_t size) {
+	for (uint_fast8_t i = 0U; i < size; ++i) {
+		dest[i] = (uint8_t) (value >> (8U * i));
+	}
+	return size;
+}
+
+/**
+ * Retrieves the timestamp of a stored sample from the base of its block.
+ *
+ * @param input const Analog_Input_t* The input the sample belongs to.
+ * @param index uint32_t The storage index of the sample.
+ * @retval uint64_t The timestamp of the sample.
+ */
+static uint64_t GetSampleTimestamp(const Analog_Input_t* input, uint32_t index) {
+	return input->blockTimestamps[index / ANALOG_SAMPLE_BLOCK_SIZE] + input->timestampDeltas[index];
+}
+
+/**
+ * Retrieves the sequence number of a stored sample from the base of its block.
+ *
+ * @param input const Analog_Input_t* The input the sample belongs to.
+ * @param index uint32_t The storage index of the sample.
+ * @retval uint32_t The sequence number of the sample.
+ */
+static uint32_t GetSampleSequence(const Analog_Input_t* input, uint32_t index) {
+	return input->blockSequences[index / ANALOG_SAMPLE_BLOCK_SIZE] + input->sequenceDeltas[index];
+}
+
+/**
+ * Retrieves the gain a sample was converted at, from the input's gain history. The DRDY interrupt only overwrites a
+ * history entry once no buffered sample needs it, so the gain of every buffered sample is known.
+ *
+ * @param input const Analog_Input_t* The input the sample belongs to.
+ * @param sequence uint32_t The sequence number of the sample.
+ * @retval ADS1256_PGA_t The gain of the sample.
+ */
+static ADS1256_PGA_t GetSampleGain(const Analog_Input_t* input, uint32_t sequence) {
+	const uint32_t entries = input->rangeCount;
+	if ((input->autoRange == false) || (entries == 0U)) {
+		return input->gain;
+	}
+	const uint32_t oldest = (entries > ANALOG_RANGE_HISTORY_SIZE) ? (entries - ANALOG_RANGE_HISTORY_SIZE) : 0U;
+	for (uint32_t k = entries; k > oldest; --k) {
+		const uint32_t slot = (k - 1U) & (ANALOG_RANGE_HISTORY_SIZE - 1U);
+		if ((int32_t) (sequence - input->rangeSequences[slot]) >= 0) {
+			return input->rangeGains[slot];
+		}
+	}
+	return input->rangeGains[oldest & (ANALOG_RANGE_HISTORY_SIZE - 1U)];
+}
+
+/**
+ * Writes up to SINGLE_ANALOG_WRITE_COUNT samples from the provided input as a single binary frame, preceded by
+ * config records as needed. See the framing description at the top of this file. If the connection is busy the
+ * samples are left in the input's buffer and the frame is rebuilt on the next call.
+ *
+ * @param input Analog_Input_t* Pointer to the data structure to write out.
+ * @retval WriteStatus_t The result of writing the frame.
+ */
+static WriteStatus_t WriteAnalogInputBinary(Analog_Input_t* input) {
+	if (binaryWriter == 0) {
+#ifdef ANALOGINPUT_DEBUG
+		printf("[Analog Input] Cannot write analog input to binary due to NULL write function.\n\r");
+#endif
+		return WRITE_NOT_CONNECTED;
+	}
+	/* Work on a copy of the channel state so nothing changes unless the frame is accepted */
+	BinaryChannelState_t state = binaryChannels[input->physicalInput];
+	const uint32_t available = RingBuffer_Count(&input->samples);
+	int32_t values[SINGLE_ANALOG_WRITE_COUNT];
+	if (compressionEnabled == true) {
+		ReadAnalogSampleValues(input, 0U, SINGLE_ANALOG_WRITE_COUNT, values);
+	}
+	uint16_t length = ANALOG_BINARY_FRAME_HEADER_SIZE;
+	uint16_t rawLength = ANALOG_BINARY_FRAME_HEADER_SIZE;
+	const uint8_t sampleSize = GetBinarySampleSize(TelnetGetDataFields());
+	uint8_t count = 0U;
+	while ((count < SINGLE_ANALOG_WRITE_COUNT) && (count < available)) {
+		const uint32_t readIdx = RingBuffer_PeekIndex(&input->samples, count);
+		uint64_t timestamp = GetSampleTimestamp(input, readIdx);
+		uint32_t sequence = GetSampleSequence(input, readIdx);
+		const uint16_t configLength = AppendConfigRecord(input, &state, timestamp, sequence, length);
+		rawLength += configLength - length;
+		/* A run lasts until a sample needs a config or gap record of its own */
+		uint8_t run = 1U;
+		while (((count + run) < SINGLE_ANALOG_WRITE_COUNT) && ((count + run) < available)) {
+			const uint32_t nextIdx = RingBuffer_PeekIndex(&input->samples, count + run);
+			const uint64_t next = GetSampleTimestamp(input, nextIdx);
+			if ((next < timestamp) || ((next - timestamp) > ANALOG_BINARY_MAX_DELTA)
+					|| (GetSampleSequence(input, nextIdx) != (sequence + 1U))
+					|| ((input->flags[nextIdx] & ANALOG_SAMPLE_FLAG_RANGE) != 0U)) {
+				break;
+			}
+			timestamp = next;
+			++sequence;
+			++run;
+		}
+		length = AppendSampleRun(input, &state, values, count, run, configLength);
+		rawLength += run * sampleSize;
+		count += run;
+	}
+	WriteStatus_t status = WRITE_OK;
+	if (count > 0U) {
+		binaryFrame[0] = ANALOG_BINARY_FRAME_START;
+		PackLittleEndian(&binaryFrame[1], length - ANALOG_BINARY_FRAME_HEADER_SIZE, 2U);
+		status = binaryWriter(binaryFrame, length);
+		if (status != WRITE_BUSY) {
+			/* Either sent or undeliverable, in both cases the samples are consumed */
+			RingBuffer_Release(&input->samples, count);
+			if (status == WRITE_OK) {
+				writtenBytes += length;
+				compressionSentBytes += length;
+				compressionRawBytes += rawLength;
+				binaryChannels[input->physicalInput] = state;
+			}
+		}
+	}
+	return status;
+}
+
+/**
+ * Appends a run of samples to a binary frame. The run is sent as a packed record when compression is enabled and the
+ * record is smaller than the run's sample records, otherwise as sample records holding the selected fields. Since
+ * packed records hold every field, compression may only be enabled with all of them. The first sample must not need a
+ * config or gap record, no later one may be more than ANALOG_BINARY_MAX_DELTA after its predecessor and their
+ * sequence numbers must follow on without a gap.
+ *
+ * @param input const Analog_Input_t* The input the samples belong to.
+ * @param state BinaryChannelState_t* The framing state of the input, updated to the last sample of the run.
+ * @param values const int32_t* The values of the samples of the frame. Only used when compression is enabled.
+ * @param first uint8_t The position in the input's buffer of the first sample of the run.
+ * @param run uint8_t The number of samples in the run.
+ * @param length uint16_t The current length of the frame.
+ * @retval uint16_t The new length of the frame.
+ */
+static uint16_t AppendSampleRun(const Analog_Input_t* input, BinaryChannelState_t* state, const int32_t* values,
+		uint8_t first, uint8_t run, uint16_t length) {
+	if (compressionEnabled == true) {
+		const uint16_t packed = AppendCompressedRecord(input, state, values, first, run, length);
+		if (packed != length) {
+			return packed;
+		}
+	}
+	const uint8_t fields = TelnetGetDataFields();
+	for (uint_fast8_t i = first; i < (first + run); ++i) {
+		const uint32_t readIdx = RingBuffer_PeekIndex(&input->samples, i);
+		const uint64_t timestamp = GetSampleTimestamp(input, readIdx);
+		binaryFrame[length++] = (uint8_t) input->physicalInput;
+		if ((fields & DATA_FIELD_TIMESTAMP) != 0U) {
+			length += PackLittleEndian(&binaryFrame[length], timestamp - state->timestamp, 2U);
+		}
+		/* The value is already stored in its wire format */
+		memcpy(&binaryFrame[length], &input->values[readIdx * ANALOG_SAMPLE_VALUE_SIZE], ANALOG_SAMPLE_VALUE_SIZE);
+		length += ANALOG_SAMPLE_VALUE_SIZE;
+		if ((fields & DATA_FIELD_FLAGS) != 0U) {
+			binaryFrame[length++] = input->flags[readIdx];
+		}
+		state->timestamp = timestamp;
+		state->sequence = GetSampleSequence(input, readIdx) + 1U;
+	}
+	return length;
+}
+
+/**
+ * Appends a run of samples to a binary frame as a packed record, see the framing description at the top of this
+ * file. The record is only kept if it is smaller than the run's sample records, so it always fits the space they
+ * would take and the encoding stops early once it clearly will not pay off.
+ *
+ * @param input const Analog_Input_t* The input the samples belong to.
+ * @param state BinaryChannelState_t* The framing state of the input, updated to the last sample if the record is kept.
+ * @param values const int32_t* The values of the samples of the frame.
+ * @param first uint8_t The position in the input's buffer of the first sample of the run.
+ * @param run uint8_t The number of samples in the run.
+ * @param length uint16_t The current length of the frame.
+ * @retval uint16_t The new length of the frame, unchanged if the record was not kept.
+ */
+static uint16_t AppendCompressedRecord(const Analog_Input_t* input, BinaryChannelState_t* state, const int32_t* values,
+		uint8_t first, uint8_t run, uint16_t length) {
+	PROFILE_BEGIN();
+	const uint16_t rawSize = run * ANALOG_BINARY_SAMPLE_SIZE;
+	if (rawSize <= ANALOG_BINARY_COMPRESSED_HEADER_SIZE) {
+		return length;
+	}
+	/* Choose the parameters from the mean size of the changes, each capped so the sums can not overflow */
+	uint32_t timeSum = 0U;
+	uint32_t valueSum = 0U;
+	int32_t previousDelta = 0;
+	int32_t previousValue = 0;
+	uint64_t previousTimestamp = state->timestamp;
+	for (uint_fast8_t i = first; i < (first + run); ++i) {
+		const uint64_t timestamp = GetSampleTimestamp(input, RingBuffer_PeekIndex(&input->samples, i));
+		const int32_t delta = (int32_t) (timestamp - previousTimestamp);
+		const uint32_t timeChange = Rice_ZigZag(delta - previousDelta);
+		const uint32_t valueChange = Rice_ZigZag(values[i] - previousValue);
+		timeSum += (timeChange > 0xFFFFU) ? 0xFFFFU : timeChange;
+		valueSum += (valueChange > 0xFFFFFFU) ? 0xFFFFFFU : valueChange;
+		previousTimestamp = timestamp;
+		previousDelta = delta;
+		previousValue = values[i];
+	}
+	const uint8_t timeK = Rice_ChooseParameter(timeSum, run, ANALOG_COMPRESSED_TIME_WIDTH - 1U);
+	const uint8_t valueK = Rice_ChooseParameter(valueSum, run, ANALOG_COMPRESSED_VALUE_WIDTH - 1U);
+	RiceWriter_t bits;
+	Rice_Begin(&bits, &binaryFrame[length + ANALOG_BINARY_COMPRESSED_HEADER_SIZE],
+			rawSize - ANALOG_BINARY_COMPRESSED_HEADER_SIZE - 1U);
+	previousDelta = 0;
+	previousValue = 0;
+	previousTimestamp = state->timestamp;
+	for (uint_fast8_t i = first; (i < (first + run)) && (bits.overflow == false); ++i) {
+		const uint32_t readIdx = RingBuffer_PeekIndex(&input->samples, i);
+		const uint64_t timestamp = GetSampleTimestamp(input, readIdx);
+		const int32_t delta = (int32_t) (timestamp - previousTimestamp);
+		Rice_WriteCode(&bits, Rice_ZigZag(delta - previousDelta), timeK, ANALOG_COMPRESSED_TIME_WIDTH);
+		Rice_WriteCode(&bits, Rice_ZigZag(values[i] - previousValue), valueK, ANALOG_COMPRESSED_VALUE_WIDTH);
+		if (input->flags[readIdx] == 0U) {
+			Rice_WriteBits(&bits, 0U, 1U);
+		} else {
+			Rice_WriteBits(&bits, 1U, 1U);
+			Rice_WriteBits(&bits, input->flags[readIdx], 8U);
+		}
+		previousTimestamp = timestamp;
+		previousDelta = delta;
+		previousValue = values[i];
+	}
+	const uint16_t size = Rice_End(&bits);
+	if (size > 0U) {
+		binaryFrame[length] = ANALOG_BINARY_COMPRESSED_RECORD;
+		binaryFrame[length + 1U] = (uint8_t) input->physicalInput;
+		binaryFrame[length + 2U] = run;
+		binaryFrame[length + 3U] = timeK;
+		binaryFrame[length + 4U] = valueK;
+		PackLittleEndian(&binaryFrame[length + 5U], size, 2U);
+		length += ANALOG_BINARY_COMPRESSED_HEADER_SIZE + size;
+		state->timestamp = previousTimestamp;
+		state->sequence += run;
+	}
+	PROFILE_END(PROFILE_COMPRESS_ANALOG_INPUT);
+	return length;
+}
+
+/**
+ * Retrieves the size of a binary sample record holding the selected fields, see the framing description at the top
+ * of this file.
+ *
+ * @param fields uint8_t The DATA_FIELD_ bits of the fields sent.
+ * @retval uint8_t The size in bytes of a sample record.
+ */
+static uint8_t GetBinarySampleSize(uint8_t fields) {
+	uint8_t size = ANALOG_BINARY_SAMPLE_SIZE;
+	if ((fields & DATA_FIELD_TIMESTAMP) == 0U) {
+		size -= 2U;
+	}
+	if ((fields & DATA_FIELD_FLAGS) == 0U) {
+		--size;
+	}
+	return size;
+}
+
+/**
+ * Writes the descriptor of the stream's format and fields, a frame holding a format record in the binary format or
+ * the ANALOG_STREAM_HEADER in the text format. See the framing description at the top of this file.
+ *
+ * @param none
+ * @retval WriteStatus_t The result of the write.
+ */
+static WriteStatus_t WriteStreamDescriptor(void) {
+	const uint8_t fields = TelnetGetDataFields();
+	uint16_t length = 0U;
+	WriteStatus_t status;
+	if (TelnetGetDataFormat() == DATA_FORMAT_BINARY) {
+		if (binaryWriter == 0) {
+			return WRITE_NOT_CONNECTED;
+		}
+		length = ANALOG_BINARY_FRAME_HEADER_SIZE;
+		binaryFrame[length++] = ANALOG_BINARY_FORMAT_RECORD;
+		binaryFrame[length++] = ANALOG_STREAM_FORMAT_VERSION;
+		binaryFrame[length++] = (compressionEnabled == true) ? 1U : 0U;
+		binaryFrame[length++] = (uint8_t) (fields & ((uint8_t) ~DATA_FIELD_DESCRIPTOR));
+		binaryFrame[length++] = GetBinarySampleSize(fields);
+		binaryFrame[0] = ANALOG_BINARY_FRAME_START;
+		PackLittleEndian(&binaryFrame[1], length - ANALOG_BINARY_FRAME_HEADER_SIZE, 2U);
+		status = binaryWriter(binaryFrame, length);
+	} else {
+		if (writer == 0) {
+			return WRITE_NOT_CONNECTED;
+		}
+		const int retval = snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER - 1U, ANALOG_STREAM_HEADER,
+				ANALOG_STREAM_FORMAT_VERSION, ((fields & DATA_FIELD_TIMESTAMP) != 0U) ? "TIMESTAMP, " : "", "VALUE",
+				((fields & DATA_FIELD_FLAGS) != 0U) ? ", FLAGS" : "", ((fields & DATA_FIELD_SEQUENCE) != 0U) ? ", SEQUENCE" : "");
+		if (retval > 0) {
+			length = (uint16_t) retval;
+		}
+		TOSTRING_BUFFER[length++] = '\x1E';
+		TOSTRING_BUFFER[length] = '\0';
+		status = writer(TOSTRING_BUFFER);
+	}
+	if (status == WRITE_OK) {
+		writtenBytes += length;
+	}
+	return status;
+}
+
+/**
+ * Writes the samples of the provided input as CAN sample frames on the identifier of its physical input. Each frame
+ * holds the low 16 bits of the epoch timestamp of its first sample in microseconds, little endian, followed by one or
+ * two samples in their wire format, so it fits the 8 data bytes of a frame. A sample with any flags set is sent alone
+ * with its flags byte after its value, making a 6 byte frame, so every frame length tells its layout. The samples are released as their frames
+ * are queued, and left in the buffer once the queue is full.
+ *
+ * @param input Analog_Input_t* Pointer to the data structure to write out.
+ * @retval WriteStatus_t The result of the write.
+ */
+static WriteStatus_t WriteAnalogInputCAN(Analog_Input_t* input) {
+	uint8_t frame[8];
+	WriteStatus_t status = WRITE_OK;
+	uint32_t available = RingBuffer_Count(&input->samples);
+	while ((available > 0U) && (status == WRITE_OK)) {
+		const uint32_t readIdx = RingBuffer_PeekIndex(&input->samples, 0U);
+		uint8_t count = 1U;
+		if ((available > 1U) && (input->flags[readIdx] == 0U)
+				&& (input->flags[RingBuffer_PeekIndex(&input->samples, 1U)] == 0U)) {
+			count = 2U;
+		}
+		uint8_t length = PackLittleEndian(frame, Timer_ToEpochTime(GetSampleTimestamp(input, readIdx)), 2U);
+		for (uint8_t i = 0U; i < count; ++i) {
+			/* The value is already stored in its wire format */
+			const uint32_t idx = RingBuffer_PeekIndex(&input->samples, i);
+			memcpy(&frame[length], &input->values[idx * ANALOG_SAMPLE_VALUE_SIZE], ANALOG_SAMPLE_VALUE_SIZE);
+			length += ANALOG_SAMPLE_VALUE_SIZE;
+		}
+		if (input->flags[readIdx] != 0U) {
+			frame[length++] = input->flags[readIdx];
+		}
+		status = Tekdaqc_CAN_StreamWrite((uint8_t) input->physicalInput, frame, length);
+		if (status == WRITE_OK) {
+			writtenBytes += length;
+		}
+		if (status != WRITE_BUSY) {
+			/* Either queued or undeliverable, in both cases the samples are consumed */
+			RingBuffer_Release(&input->samples, count);
+			available -= count;
+		}
+	}
+	return status;
+}
+
+/**
+ * Retrieves the conversion rate of a data rate setting.
+ *
+ * @param rate ADS1256_SPS_t The data rate setting.
+ * @retval float The conversion rate in samples per second.
+ */
+static float GetConversionRate(ADS1256_SPS_t rate) {
+	for (uint_fast8_t i = 0U; i < NUM_PLAN_RATES; ++i) {
+		if (PLAN_RATES[i] == rate) {
+			return PLAN_RATE_VALUES[i];
+		}
+	}
+	return PLAN_RATE_VALUES[0];
+}
+
+/**
+ * Predicts the timing of a scan of every added input, either at the inputs' own data rates or with all of them at
+ * one rate. A lone input is converted continuously, so each sample costs its conversions. In a multi-channel scan
+ * each input costs the settling time of its first conversion, the conversion period of the rest of its oversampled
+ * conversions and, for external inputs, their settle time after the switch, and the scan also pays for the cold
+ * junction refreshes its external switches make. The channel rate is that of the scan divided by the largest filter
+ * decimation, so every input reaches it, while the throughput adds up what each input reports.
+ *
+ * @param rate const ADS1256_SPS_t* The data rate to predict all inputs at, NULL for their own rates.
+ * @param prediction AnalogScanPrediction_t* Filled in with the prediction. All zero if no inputs are added.
+ * @retval none
+ */
+static void EstimateScan(const ADS1256_SPS_t* rate, AnalogScanPrediction_t* prediction) {
+	uint16_t decimation = 1U;
+	uint16_t oversampling = 1U;
+	float period = 0.0f;
+	float outputs = 0.0f; /* Samples reported per scan, over all inputs */
+	memset(prediction, 0, sizeof(AnalogScanPrediction_t));
+	for (uint_fast8_t i = 0U; i < NUM_ANALOG_INPUTS; ++i) {
+		const Analog_Input_t* input = GetAnalogInputByNumber(i);
+		if ((i != EXTERNAL_OFFSET_CAL) && (input->added == CHANNEL_ADDED)) {
+			const ADS1256_SPS_t inputRate = (rate != NULL) ? *rate : input->rate;
+			period = 1000.0f / GetConversionRate(inputRate); /* Milliseconds */
+			oversampling = input->oversampling;
+			++(prediction->inputs);
+			prediction->conversionTime += ADS1256_GetSettlingTimeForRate(inputRate)
+					+ ((float) (input->oversampling - 1U) * period);
+			if (isExternalInput(i)) {
+				++(prediction->externalInputs);
+				prediction->conversionTime += (float) input->settleTime / 1000.0f; /* The settle time is in microseconds */
+			}
+			if (input->filter.decimation > decimation) {
+				decimation = input->filter.decimation;
+			}
+			outputs += 1.0f / (float) input->filter.decimation;
+		}
+	}
+	if (prediction->inputs == 0U) {
+		return;
+	}
+	if (prediction->inputs == 1U) {
+		prediction->conversionTime = (float) oversampling * period;
+	} else {
+		prediction->coldJunctionTime = ADC_Machine_GetColdJunctionTime(prediction->conversionTime,
+				prediction->externalInputs);
+	}
+	prediction->scanTime = prediction->conversionTime + prediction->coldJunctionTime;
+	prediction->channelRate = 1000.0f / (prediction->scanTime * (float) decimation);
+	prediction->throughput = outputs * 1000.0f / prediction->scanTime;
+}
+
+/**
+ * Appends a config record for an input to the binary frame if the client has not been told the settings of the next
+ * record, or if the time since its previous sample does not fit in a sample record's delta. Otherwise a gap record is appended
+ * if the sequence number of the next record does not follow on from the previous sample's.
+ *
+ * @param input const Analog_Input_t* The input the next record belongs to.
+ * @param state BinaryChannelState_t* The framing state of the input, updated if a record is appended.
+ * @param timestamp uint64_t The timestamp of the next record.
+ * @param sequence uint32_t The sequence number of the next record, that of the state for records without one.
+ * @param length uint16_t The current length of the frame.
+ * @retval uint16_t The new length of the frame.
+ */
+static uint16_t AppendConfigRecord(const Analog_Input_t* input, BinaryChannelState_t* state, uint64_t timestamp,
+		uint32_t sequence, uint16_t length) {
+	const ADS1256_PGA_t gain = GetSampleGain(input, sequence);
+	if ((state->valid == false) || (state->gain != gain) || (state->rate != input->rate) || (state->buffer != input->buffer)
+			|| (timestamp < state->timestamp) || ((timestamp - state->timestamp) > ANALOG_BINARY_MAX_DELTA)) {
+		/* The client needs a new reference for this channel */
+		binaryFrame[length++] = ANALOG_BINARY_CONFIG_RECORD;
+		binaryFrame[length++] = (uint8_t) input->physicalInput;
+		binaryFrame[length++] = (uint8_t) gain;
+		binaryFrame[length++] = (uint8_t) input->rate;
+		binaryFrame[length++] = (uint8_t) input->buffer;
+		length += PackLittleEndian(&binaryFrame[length], Timer_ToEpochTime(timestamp), 8U);
+		length += PackLittleEndian(&binaryFrame[length], sequence, 4U);
+		state->valid = true;
+		state->gain = gain;
+		state->rate = input->rate;
+		state->buffer = input->buffer;
+		state->timestamp = timestamp;
+		state->sequence = sequence;
+	} else if (sequence != state->sequence) {
+		/* Samples were lost, tell the client how many */
+		binaryFrame[length++] = ANALOG_BINARY_SEQUENCE_RECORD;
+		binaryFrame[length++] = (uint8_t) input->physicalInput;
+		length += PackLittleEndian(&binaryFrame[length], sequence, 4U);
+		state->sequence = sequence;
+	}
+	return length;
+}
+
+/**
+ * Starts a text batch in TOSTRING_BUFFER with the full header of an input if the client has not been told its current
+ * settings during this sampling run, otherwise with a short line identifying the input.
+ *
+ * @param input const Analog_Input_t* The input the batch belongs to.
+ * @param state TextChannelState_t* The header state of the input, updated if the full header is used.
+ * @param gain ADS1256_PGA_t The gain of the batch, which differs from the input's when it is auto-ranged.
+ * @retval uint16_t The length of the header.
+ */
+static uint16_t FormatTextHeader(const Analog_Input_t* input, TextChannelState_t* state, ADS1256_PGA_t gain) {
+	int retval;
+	if ((state->valid == false) || (state->gain != gain) || (state->rate != input->rate) || (state->buffer != input->buffer)) {
+		retval = snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, ANALOG_INPUT_HEADER, input->name, input->physicalInput,
+				ADS1256_StringFromPGA(gain), ADS1256_StringFromSPS(input->rate), ADS1256_StringFromBuffer(input->buffer));
+		state->valid = true;
+		state->gain = gain;
+		state->rate = input->rate;
+		state->buffer = input->buffer;
+	} else {
+		retval = snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, ANALOG_INPUT_ID_HEADER, input->physicalInput);
+	}
+	return (retval > 0) ? (uint16_t) retval : 0U;
+}
+
+/**
+ * Hands the running statistics window of an input to the writers and starts a new one. Called only from the ADC
+ * side. If the writers have not yet consumed the previous window there is nowhere to put this one, so it is dropped.
+ *
+ * @param input Analog_Input_t* The input whose window is complete.
+ * @retval bool FALSE if the window was dropped.
+ */
+static bool CloseStatisticsWindow(Analog_Input_t* input) {
+	bool retval = false;
+	if (input->windowReady == false) {
+		input->window = input->statistics;
+		input->windowReady = true;
+		retval = true;
+	}
+	input->statistics.count = 0U;
+	return retval;
+}
+
+/**
+ * Computes the mean and RMS of a statistics window from its exact sums, both rounded to the nearest count.
+ *
+ * @param stats const AnalogStatistics_t* The window to summarize. It must hold at least one sample.
+ * @param mean int32_t* Set to the mean of the window (ADC Counts).
+ * @param rms uint32_t* Set to the RMS of the window (ADC Counts).
+ * @retval none
+ */
+static void SummarizeStatistics(const AnalogStatistics_t* stats, int32_t* mean, uint32_t* rms) {
+	const int64_t half = stats->count / 2U;
+	*mean = (int32_t) ((stats->sum >= 0) ? ((stats->sum + half) / stats->count) : ((stats->sum - half) / stats->count));
+	/* Integer square root of the mean square, one result bit at a time */
+	const uint64_t square = (stats->sumSquares + (uint64_t) half) / stats->count;
+	uint64_t remainder = square;
+	uint64_t root = 0U;
+	uint64_t bit = 1ULL << 62U;
+	while (bit > remainder) {
+		bit >>= 2U;
+	}
+	while (bit != 0U) {
+		if (remainder >= (root + bit)) {
+			remainder -= root + bit;
+			root = (root >> 1U) + bit;
+		} else {
+			root >>= 1U;
+		}
+		bit >>= 2U;
+	}
+	if (remainder > root) {
+		++root; /* Round to nearest */
+	}
+	*rms = (uint32_t) root;
+}
+
+/**
+ * Writes the completed statistics window of an analog input as a single text record or binary frame, depending on
+ * the selected data format. If the connection is busy the window is kept so the caller can try again later.
+ *
+ * @param input Analog_Input_t* Pointer to the data structure to write out. Its window must be ready.
+ * @retval WriteStatus_t The result of the write.
+ */
+static WriteStatus_t WriteAnalogStatistics(Analog_Input_t* input) {
+	const AnalogStatistics_t* stats = &input->window;
+	int32_t mean;
+	uint32_t rms;
+	SummarizeStatistics(stats, &mean, &rms);
+	WriteStatus_t status;
+	if (TelnetGetDataFormat() == DATA_FORMAT_BINARY) {
+		if (binaryWriter == 0) {
+			return WRITE_NOT_CONNECTED;
+		}
+		BinaryChannelState_t state = binaryChannels[input->physicalInput];
+		uint16_t length = AppendConfigRecord(input, &state, stats->start, state.sequence, ANALOG_BINARY_FRAME_HEADER_SIZE);
+		const uint64_t duration = stats->end - stats->start;
+		binaryFrame[length++] = ANALOG_BINARY_STATISTICS_RECORD;
+		binaryFrame[length++] = (uint8_t) input->physicalInput;
+		length += PackLittleEndian(&binaryFrame[length], Timer_ToEpochTime(stats->start), 8U);
+		length += PackLittleEndian(&binaryFrame[length], (duration > UINT32_MAX) ? UINT32_MAX : duration, 4U);
+		length += PackLittleEndian(&binaryFrame[length], stats->count, 4U);
+		length += PackLittleEndian(&binaryFrame[length], (uint32_t) stats->min, ANALOG_SAMPLE_VALUE_SIZE);
+		length += PackLittleEndian(&binaryFrame[length], (uint32_t) stats->max, ANALOG_SAMPLE_VALUE_SIZE);
+		length += PackLittleEndian(&binaryFrame[length], (uint32_t) mean, ANALOG_SAMPLE_VALUE_SIZE);
+		length += PackLittleEndian(&binaryFrame[length], rms, ANALOG_SAMPLE_VALUE_SIZE);
+		binaryFrame[0] = ANALOG_BINARY_FRAME_START;
+		PackLittleEndian(&binaryFrame[1], length - ANALOG_BINARY_FRAME_HEADER_SIZE, 2U);
+		status = binaryWriter(binaryFrame, length);
+		if (status == WRITE_OK) {
+			writtenBytes += length;
+			binaryChannels[input->physicalInput] = state;
+		}
+	} else {
+		if (writer == 0) {
+			return WRITE_NOT_CONNECTED;
+		}
+		TextChannelState_t state = textChannels[input->physicalInput];
+		uint16_t length = FormatTextHeader(input, &state, GetSampleGain(input, input->sequence));
+		int retval = snprintf(TOSTRING_BUFFER + length, SIZE_TOSTRING_BUFFER - length - 1U, ANALOG_STATISTICS_FORMAT,
+				Timer_ToEpochTime(stats->start), Timer_ToEpochTime(stats->end), stats->count, stats->min, stats->max, mean, rms);
+		if (retval > 0) {
+			length += retval;
+		}
+		TOSTRING_BUFFER[length++] = '\x1E';
+		TOSTRING_BUFFER[length] = '\0';
+		status = writer(TOSTRING_BUFFER);
+		if (status == WRITE_OK) {
+			writtenBytes += length;
+			textChannels[input->physicalInput] = state;
+		}
+	}
+	if (status != WRITE_BUSY) {
+		/* Either sent or undeliverable, in both cases the window is consumed */
+		input->windowReady = false;
+	}
+	return status;
+}
+
+/**
+ * @internal
+ * Retrieves the list description of an added input. The description is kept with the settings it was rendered from,
+ * and only rendered again when they differ, so listing an unchanged input costs a comparison rather than a format.
+ *
+ * @param input const Analog_Input_t* The input to describe.
+ * @retval const AnalogListEntry_t* The description, NULL if it could not be rendered.
+ */
+static const AnalogListEntry_t* GetAnalogListEntry(const Analog_Input_t* input) {
+	AnalogListEntry_t* entry = &analogListCache[input->physicalInput];
+	AnalogListKey_t key;
+	/* Cleared so that padding never makes equal settings compare unequal */
+	memset(&key, 0, sizeof(key));
+	strncpy(key.name, input->name, sizeof(key.name));
+	key.externalInput = input->externalInput;
+	key.internalInput = input->internalInput;
+	key.positiveInput = input->positiveInput;
+	key.negativeInput = input->negativeInput;
+	key.gain = input->gain;
+	key.rate = input->rate;
+	key.buffer = input->buffer;
+	key.filter = input->filter.type;
+	key.decimation = input->filter.decimation;
+	key.oversampling = input->oversampling;
+	key.settleTime = input->settleTime;
+	key.thermocouple = input->thermocouple;
+	if ((entry->length > 0U) && (memcmp(&key, &entry->key, sizeof(key)) == 0)) {
+		return entry;
+	}
+	int n;
+	if (isExternalInput(input->physicalInput)) {
+		n = snprintf(entry->text, sizeof(entry->text), ANALOG_LIST_EXTERNAL_FORMAT, input->physicalInput,
+				ExtAnalogInputToString(input->externalInput), input->name, ADS1256_StringFromPGA(input->gain),
+				ADS1256_StringFromSPS(input->rate), ADS1256_StringFromBuffer(input->buffer),
+				AnalogFilter_StringFromType(input->filter.type), input->filter.decimation, input->oversampling,
+				input->settleTime, Thermocouple_StringFromType(input->thermocouple));
+	} else if (isInternalInput(input->physicalInput)) {
+		n = snprintf(entry->text, sizeof(entry->text), ANALOG_LIST_INTERNAL_FORMAT, input->physicalInput,
+				IntAnalogInputToString(input->internalInput), input->name, ADS1256_StringFromPGA(input->gain),
+				ADS1256_StringFromSPS(input->rate), ADS1256_StringFromBuffer(input->buffer),
+				AnalogFilter_StringFromType(input->filter.type), input->filter.decimation, input->oversampling);
+	} else {
+		n = snprintf(entry->text, sizeof(entry->text), ANALOG_LIST_DIFFERENTIAL_FORMAT, input->physicalInput,
+				ADS1256_StringFromAIN(input->positiveInput), ADS1256_StringFromAIN(input->negativeInput), input->name,
+				ADS1256_StringFromPGA(input->gain), ADS1256_StringFromSPS(input->rate),
+				ADS1256_StringFromBuffer(input->buffer), AnalogFilter_StringFromType(input->filter.type),
+				input->filter.decimation, input->oversampling);
+	}
+	if ((n <= 0) || (n >= (int) sizeof(entry->text))) {
+#ifdef ANALOGINPUT_DEBUG
+		printf("Failed to write an analog input to the list.\n\r");
+#endif
+		entry->length = 0U;
+		return NULL;
+	}
+	entry->key = key;
+	entry->length = (uint16_t) n;
+	return entry;
+}
+
+/**
+ * @internal
+ * Appends text to the list being gathered in the string buffer. The gathered text is written out when the addition
+ * would not fit, so a whole list goes out in as few writes as the buffer allows.
+ *
+ * @param text const char* The text to append.
+ * @param length uint16_t The length of the text, which must be less than SIZE_TOSTRING_BUFFER.
+ * @param used uint16_t* The number of bytes gathered in the string buffer, updated.
+ * @retval bool FALSE if gathered text could not be written.
+ */
+static bool AppendAnalogList(const char* text, uint16_t length, uint16_t* used) {
+	if ((*used + length) >= SIZE_TOSTRING_BUFFER) {
+		/* Send what is gathered and start again */
+		if (writer(TOSTRING_BUFFER) != WRITE_OK) {
+			return false;
+		}
+		*used = 0U;
+	}
+	memcpy(&TOSTRING_BUFFER[*used], text, length);
+	*used += length;
+	TOSTRING_BUFFER[*used] = '\0';
+	return true;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INITIALIZATION METHODS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Initializes all requisite sub-modules to properly operate analog inputs. This includes any multiplexing and
+ * default inputs.
+ *
+ * @param none
+ * @retval none
+ */
+void AnalogInputsInit(void) {
+	/* Initialize the input multiplexer */
+	InputMultiplexerInit();
+	uint_fast8_t i = 0;
+	for (; i < NUM_EXT_ANALOG_INPUTS; ++i) {
+		InitializeInput(&Ext_AInputs[i]);
+	}
+	for (i = 0; i < NUM_INT_ANALOG_INPUTS; ++i) {
+		InitializeInput(&Int_AInputs[i]);
+	}
+	for (i = 0; i < NUM_DIFF_ANALOG_INPUTS; ++i) {
+		InitializeInput(&Diff_AInputs[i]);
+	}
+	/* Configure the offset cal input */
+	InitializeInput(&Offset_Cal_AInput);
+
+	/* Configure the cold junction input */
+	Analog_Input_t* cold = GetAnalogInputByNumber(IN_COLD_JUNCTION);
+	cold->physicalInput = IN_COLD_JUNCTION;
+	cold->buffer = ADS1256_BUFFER_ENABLED;
+	cold->rate = ADS1256_SPS_30000;
+	cold->gain = ADS1256_PGAx8;
+	strcpy(cold->name, "COLD JUNCTION");
+	ReleaseInputBuffer(cold);
+	cold->min = 0;
+	cold->max = 0;
+	AddAnalogInput(cold);
+}
+
+/**
+ * Records the most recent measurement of an analog input, which is kept whether or not the measurement is reported so
+ * that WriteLatestAnalogValues() can answer a poll without any sampling. Called from the DRDY interrupt for the
+ * sampled inputs, the version lets a reader in the main loop detect that it was interrupted part way through.
+ *
+ * @param input Analog_Input_t* The measured input.
+ * @param value int32_t The measured value.
+ * @param timestamp uint64_t The time of the measurement.
+ * @param flags uint8_t The ANALOG_SAMPLE_FLAG_ bits of the measurement.
+ * @retval none
+ */
+void RecordLatestAnalogSample(Analog_Input_t* input, int32_t value, uint64_t timestamp, uint8_t flags) {
+	input->latestValue = value;
+	input->latestTimestamp = timestamp;
+	input->latestFlags = flags;
+	++(input->latestVersion);
+}
+
+/**
+ * Retrieves a copy of the most recent measurement of an analog input, as kept by RecordLatestAnalogSample(). The
+ * measurement is copied again if it was updated while being copied, so its value, time and flags always belong
+ * together. The ADC is not involved, so this may be called from the main loop at any time without disturbing a
+ * sampling.
+ *
+ * @param number uint8_t The physical input.
+ * @param sample AnalogLatestSample_t* Filled in with the measurement.
+ * @retval bool FALSE if the input does not exist or has not been added.
+ */
+bool GetLatestAnalogSample(uint8_t number, AnalogLatestSample_t* sample) {
+	if (number >= NUM_ANALOG_INPUTS) {
+		return false;
+	}
+	const volatile Analog_Input_t* input = analogInputTable[number];
+	if (input->added != CHANNEL_ADDED) {
+		return false;
+	}
+	uint32_t version;
+	do {
+		version = input->latestVersion;
+		sample->value = input->latestValue;
+		sample->timestamp = input->latestTimestamp;
+		sample->flags = input->latestFlags;
+	} while (version != input->latestVersion);
+	return true;
+}
+
+/**
+ * Prints the most recent measurement of every added analog input via the current write function, see
+ * GetLatestAnalogSample(). Inputs which have not been measured since being added are listed as NONE.
+ *
+ * @param none
+ * @return Tekdaqc_Function_Error_t The error status of this function.
+ */
+Tekdaqc_Function_Error_t WriteLatestAnalogValues(void) {
+	if (writer == 0) {
+		return ERR_AIN_FAILED_WRITE;
+	}
+	int length = snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "\n\r--------------------\n\rLatest Analog Values\n\r");
+	char line[64];
+	for (uint_fast8_t i = 0U; i < NUM_ANALOG_INPUTS; ++i) {
+		AnalogLatestSample_t sample;
+		if (GetLatestAnalogSample((uint8_t) i, &sample) == false) {
+			continue;
+		}
+		int n;
+		if (sample.timestamp == 0U) {
+			n = snprintf(line, sizeof(line), "\t%" PRIu8 ": NONE\n\r", (uint8_t) i);
+		} else {
+			/* The timestamp is formatted separately as the C library's 64 bit conversion is slow */
+			char time[FORMAT_UINT64_MAX_LENGTH + 1U];
+			Format_UInt64(time, Timer_ToEpochTime(sample.timestamp));
+			n = snprintf(line, sizeof(line), ANALOG_LATEST_FORMAT, (uint8_t) i, sample.value, time, sample.flags);
+		}
+		if ((n <= 0) || (length < 0)) {
+#ifdef ANALOGINPUT_DEBUG
+			printf("Failed to write the latest value of an analog input.\n\r");
+#endif
+			return ERR_AIN_FAILED_WRITE;
+		}
+		if ((length + n) >= (int) SIZE_TOSTRING_BUFFER) {
+			/* Send what is gathered and start again */
+			writer(TOSTRING_BUFFER);
+			length = 0;
+		}
+		memcpy(&TOSTRING_BUFFER[length], line, (size_t) n + 1U);
+		length += n;
+	}
+	return (writer(TOSTRING_BUFFER) == WRITE_OK) ? ERR_FUNCTION_OK : ERR_AIN_FAILED_WRITE;
+}
+
+/**
+ * Prints a human readable representation of all the added analog inputs via the current write function. Each
+ * input's description is cached until its settings change, see GetAnalogListEntry(), and the list is gathered into
+ * the string buffer so it goes out in as few writes as possible.
+ *
+ * @param none
+ * @return Tekdaqc_Function_Error_t The error status of this function.
+ */
+Tekdaqc_Function_Error_t ListAnalogInputs(void) {
+	if (writer == 0) {
+		return ERR_FUNCTION_OK;
+	}
+	uint16_t used = 0U;
+	const AnalogListEntry_t* entry;
+	bool ok = AppendAnalogList(ANALOG_LIST_HEADER, sizeof(ANALOG_LIST_HEADER) - 1U, &used);
+	for (uint_fast8_t i = 0U; (i < NUM_EXT_ANALOG_INPUTS) && (ok == true); ++i) {
+		if (Ext_AInputs[i].added == CHANNEL_ADDED) {
+			entry = GetAnalogListEntry(&Ext_AInputs[i]);
+			ok = (entry != NULL) && (AppendAnalogList(entry->text, entry->length, &used) == true);
+		}
+	}
+	if (ok == true) {
+		ok = AppendAnalogList(ANALOG_LIST_INTERNAL_HEADER, sizeof(ANALOG_LIST_INTERNAL_HEADER) - 1U, &used);
+	}
+	for (uint_fast8_t i = 0U; (i < NUM_INT_ANALOG_INPUTS) && (ok == true); ++i) {
+		if (Int_AInputs[i].added == CHANNEL_ADDED) {
+			entry = GetAnalogListEntry(&Int_AInputs[i]);
+			ok = (entry != NULL) && (AppendAnalogList(entry->text, entry->length, &used) == true);
+		}
+	}
+	if (ok == true) {
+		ok = AppendAnalogList(ANALOG_LIST_DIFFERENTIAL_HEADER, sizeof(ANALOG_LIST_DIFFERENTIAL_HEADER) - 1U, &used);
+	}
+	for (uint_fast8_t i = 0U; (i < NUM_DIFF_ANALOG_INPUTS) && (ok == true); ++i) {
+		if (Diff_AInputs[i].added == CHANNEL_ADDED) {
+			entry = GetAnalogListEntry(&Diff_AInputs[i]);
+			ok = (entry != NULL) && (AppendAnalogList(entry->text, entry->length, &used) == true);
+		}
+	}
+	if ((ok == true) && (writer(TOSTRING_BUFFER) == WRITE_OK)) {
+		return ERR_FUNCTION_OK;
+	}
+	return ERR_AIN_FAILED_WRITE;
+}
+
+/**
+ * Creates a new analog input data structure from the supplied parameters and adds it to the board's relevant
+ * input list.
+ *
+ * @param keys char** Array of strings containing the command line keys. Indexed with values.
+ * @param values char** Array of strings containing the command line values. Indexed with keys.
+ * @param count uint8_t The number of parameters passed on the command line.
+ * @retval uint8_t The error status code.
+ */
+Tekdaqc_Function_Error_t CreateAnalogInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Function_Error_t retval = ERR_FUNCTION_OK;
+	char* param;
+	int8_t index = -1;
+	/* Set the default parameters */
+	uint8_t input = NULL_CHANNEL; /* The physical input */
+	ADS1256_BUFFER_t buffer = ADS1256_BUFFER_ENABLED; /* The default buffer setting */
+	ADS1256_SPS_t rate = ADS1256_SPS_10; /* The default sample rate setting */
+	ADS1256_PGA_t gain = ADS1256_PGAx1; /* The default gain setting */
+	uint32_t deadband = 0U; /* The default deadband, report every sample */
+	uint32_t heartbeat = 0U; /* The default heartbeat, none */
+	char name[MAX_ANALOG_INPUT_NAME_LENGTH]; /* The name */
+	strcpy(name, "NONE");
+	uint_fast8_t i = 0U;
+	for (; i < NUM_ADD_ANALOG_INPUT_PARAMS; ++i) {
+		index = GetIndexOfArgument(keys, ADD_ANALOG_INPUT_PARAMS[i], count);
+		if (index >= 0) { /* We found the key in the list */
+			param = values[index]; /* We use the discovered index for this key */
+			switch (i) { /* Switch on the key not position in arguments list */
+			case 0U: { /* INPUT key */
+				char* testPtr = NULL;
+				uint8_t in = (uint8_t) strtol(param, &testPtr, 10);
+				if (testPtr == param) {
+					retval = ERR_AIN_PARSE_ERROR;
+				} else {
+					if (in >= 0U && in <= NUM_ANALOG_INPUTS) {
+						/* A valid input number */
+						input = in;
+					} else {
+						/* Input number out of range */
+#ifdef ANALOGINPUT_DEBUG
+						printf("[Analog Input] The requested input number is invalid.\n\r");
+#endif
+						retval = ERR_AIN_INPUT_OUTOFRANGE;
+					}
+				}
+				break;
+			}
+			case 1U: /* BUFFER key */
+				buffer = ADS1256_StringToBuffer(param);
+				break;
+			case 2U: /* RATE key */
+				rate = ADS1256_StringToDataRate(param);
+				break;
+			case 3U: /* GAIN key */
+				gain = ADS1256_StringToPGA(param);
+				break;
+			case 4U: /* NAME key */
+				strcpy(name, param);
+				break;
+			case 5U: /* DEADBAND key */
+				deadband = (uint32_t) strtoul(param, NULL, 10);
+				break;
+			case 6U: /* HEARTBEAT key */
+				heartbeat = (uint32_t) strtoul(param, NULL, 10);
+				if (heartbeat > (UINT32_MAX / 1000U)) {
+					retval = ERR_AIN_PARSE_ERROR;
+				}
+				break;
+			default:
+				retval = ERR_AIN_PARSE_ERROR;
+			}
+		} else if (i == 1U || i == 2U || i == 3U || i == 4U || i == 5U || i == 6U) {
+			/* The BUFFER, RATE, GAIN, NAME, DEADBAND and HEARTBEAT keys are not strictly required, leave the defaults */
+			continue;
+		} else {
+			/* Somehow an error happened */
+#ifdef ANALOGINPUT_DEBUG
+			printf("[Analog Input] Unable to locate required key: %s\n\r", ADD_ANALOG_INPUT_PARAMS[i]);
+#endif
+			retval = ERR_AIN_PARSE_MISSING_KEY; /* Failed to locate a key */
+		}
+		if (retval != ERR_FUNCTION_OK) {
+			break;
+		}
+	}
+	if (retval == ERR_FUNCTION_OK) {
+		retval = ConfigureAnalogInput(input, buffer, rate, gain, name, deadband, heartbeat);
+	}
+	return retval; /* Return the status */
+}
 
 /**
- * @internal
- * @brief Initializes the members of the specified input structure.
+ * Configures an analog input with the provided settings and adds it to the board's list. This is the common path of
+ * the text and binary forms of the ADD_ANALOG_INPUT command, taking settings which have already been parsed.
+ *
+ * @param input uint8_t The physical input number, or NULL_CHANNEL if none was specified.
+ * @param buffer ADS1256_BUFFER_t The analog buffer setting.
+ * @param rate ADS1256_SPS_t The sample rate setting.
+ * @param gain ADS1256_PGA_t The gain setting.
+ * @param name const char* C-String of the name of the input.
+ * @param deadband uint32_t The deadband of the input (ADC Counts). 0 reports every sample.
+ * @param heartbeat uint32_t The longest time between reported samples when a deadband is set (ms). 0 for no limit.
+ * @retval Tekdaqc_Function_Error_t The error status of this function.
  */
-static void InitializeInput(Analog_Input_t* input);
+Tekdaqc_Function_Error_t ConfigureAnalogInput(uint8_t input, ADS1256_BUFFER_t buffer, ADS1256_SPS_t rate, ADS1256_PGA_t gain,
+		const char* name, uint32_t deadband, uint32_t heartbeat) {
+	Tekdaqc_Function_Error_t retval = ERR_FUNCTION_OK;
+	if (input != NULL_CHANNEL ) {
+		Analog_Input_t* an_input = GetAnalogInputByNumber(input);
+		if (an_input != NULL ) {
+			if (an_input->added == CHANNEL_NOTADDED) {
+				an_input->physicalInput = input;
+				an_input->buffer = buffer;
+				an_input->rate = rate;
+				an_input->gain = gain;
+				strncpy(an_input->name, name, MAX_ANALOG_INPUT_NAME_LENGTH - 1U);
+				an_input->name[MAX_ANALOG_INPUT_NAME_LENGTH - 1U] = '\0';
+				an_input->deadband = deadband;
+				an_input->heartbeat = heartbeat * 1000U;
+				an_input->min = 0;
+				an_input->max = 0;
+				retval = AddAnalogInput(an_input);
+			} else {
+				retval = ERR_AIN_INPUT_EXISTS;
+			}
+		} else {
+			/* The input could not be found */
+			retval = ERR_AIN_INPUT_NOT_FOUND;
+		}
+	} else {
+		/* A valid input was never specified */
+		retval = ERR_AIN_INPUT_UNSPECIFIED;
+	}
+	return retval;
+}
 
 /**
- * @internal
- * @brief Removes an analog input from the board's list by physical channel.
+ * Adds an analog input structure to the board's appropriate list of inputs.
+ *
+ * @param input Analog_Input_t* The analog input structure to add.
+ * @retval none
  */
-static void RemoveAnalogInputByID(uint8_t id);
-
-/*--------------------------------------------------------------------------------------------------------*/
-/* PRIVATE FUNCTIONS */
-/*--------------------------------------------------------------------------------------------------------*/
+Tekdaqc_Function_Error_t AddAnalogInput(Analog_Input_t* input) {
+	Tekdaqc_Function_Error_t retval = ERR_FUNCTION_OK;
+	PhysicalAnalogInput_t index = input->physicalInput;
+	if (isExternalInput(index)) {
+		/* This is an external analog input */
+		input->externalInput = GetExternalMuxedInputByNumber(index);
+		input->internalInput = NULL_CHANNEL;
+		input->added = CHANNEL_ADDED;
+#ifdef ANALOGINPUT_DEBUG
+		printf("[Analog Input] Added input to external inputs list.\n\r");
+#endif
+	} else if (isInternalInput(index)) {
+		/* This is an internal analog input */
+		input->externalInput = NULL_CHANNEL;
+		input->internalInput = index - (NUM_EXT_ANALOG_INPUTS + NUM_CAL_ANALOG_INPUTS);
+		input->added = CHANNEL_ADDED;
+#ifdef ANALOGINPUT_DEBUG
+		printf("[Analog Input] Added input to internal inputs list.\n\r");
+#endif
+	} else if (isDifferentialInput(index)) {
+		/* This is a differential analog input, measuring its pair on the ADC's own multiplexer */
+		input->externalInput = NULL_CHANNEL;
+		input->internalInput = NULL_CHANNEL;
+		input->added = CHANNEL_ADDED;
+#ifdef ANALOGINPUT_DEBUG
+		printf("[Analog Input] Added input to differential inputs list.\n\r");
+#endif
+	} else if (index == EXTERNAL_OFFSET_CAL) {
+		/* This is the offset calibration input */
+		input->externalInput = NULL_CHANNEL;
+		input->internalInput = NULL_CHANNEL;
+		input->added = CHANNEL_ADDED;
+#ifdef ANALOGINPUT_DEBUG
+		printf("[Analog Input] Added external offset input.\n\r");
+#endif
+	} else {
+		/* This is out of range */
+#ifdef ANALOGINPUT_DEBUG
+		printf("[Analog Input] Cannot add the provided analog input. Input does not exist on the board.\n\r");
+#endif
+		retval = ERR_AIN_INPUT_OUTOFRANGE;
+	}
+	if (retval == ERR_FUNCTION_OK) {
+		CompileInputRegisters(input);
+	}
+	return retval;
+}
 
 /**
- * Initializes the members of the specified input structure.
+ * Removes an analog input from the board's list based on the supplied parameters.
  *
- * @param input Analog_Input_t* Pointer/Reference to an analog input structure.
- * @retval none
+ * @param keys char** Array of strings containing the command line keys. Indexed with values.
+ * @param values char** Array of strings containing the command line values. Indexed with keys.
+ * @param count uint8_t The number of parameters passed on the command line.
+ * @retval int The error status code.
  */
-static void InitializeInput(Analog_Input_t* input) {
-	input->buffer = ADS1256_BUFFER_ENABLED;
-	input->gain = ADS1256_PGAx1;
-	input->rate = ADS1256_SPS_10;
-	input->bufferReadIdx = 0U;
-	input->bufferWriteIdx = 0U;
-	input->min = 0;
-	input->max = 0;
+Tekdaqc_Function_Error_t RemoveAnalogInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Function_Error_t retval = ERR_FUNCTION_OK;
+	char* param;
+	int8_t index = -1;
 	uint_fast8_t i = 0U;
-	for (; i < ANALOG_INPUT_BUFFER_SIZE; ++i) {
-		input->values[i] = 0;
-		input->timestamps[i] = 0U;
+	for (; i < NUM_REMOVE_ANALOG_INPUT_PARAMS; ++i) {
+		index = GetIndexOfArgument(keys, REMOVE_ANALOG_INPUT_PARAMS[i], count);
+		if (index >= 0) { /* We found the key in the list */
+			param = values[index]; /* We use the discovered index for this key */
+			switch (i) { /* Switch on the key not position in arguments list */
+			case 0U: { /* INPUT key */
+				printf("Processing INPUT key\n\r");
+				uint8_t in = (uint8_t) strtol(param, NULL, 10);
+				if (in >= 0U && in <= NUM_ANALOG_INPUTS) {
+					/* A valid input number */
+					RemoveAnalogInputByID(in);
+				} else {
+					/* Input number out of range */
+#ifdef ANALOGINPUT_DEBUG
+					printf("[Analog Input] The requested input number is invalid.\n\r");
+#endif
+					retval = ERR_AIN_INPUT_OUTOFRANGE;
+				}
+				break;
+			}
+			default:
+				retval = ERR_AIN_PARSE_ERROR;
+			}
+		} else {
+			/* Somehow an error happened */
+#ifdef ANALOGINPUT_DEBUG
+			printf("[Analog Input] Unable to locate required key: %s\n\r", REMOVE_ANALOG_INPUT_PARAMS[i]);
+#endif
+			retval = ERR_AIN_PARSE_MISSING_KEY; /* Failed to locate a key */
+		}
 	}
-	input->added = CHANNEL_NOTADDED;
+	return retval;
 }
 
 /**
- * Removes an analog input structure from the board's list by specifying its physical input channel.
+ * Sets the filter applied to an analog input's samples based on the supplied parameters. The input need not have
+ * been added, so a filter may be configured before or after the input is. Every parameter is checked before any is
+ * applied, so a failure leaves the input's filter unchanged.
  *
- * @param id uint8_t The physical channel to remove, if present.
- * @retval none
+ * @param keys char** Array of strings containing the command line keys. Indexed with values.
+ * @param values char** Array of strings containing the command line values. Indexed with keys.
+ * @param count uint8_t The number of parameters passed on the command line.
+ * @retval Tekdaqc_Function_Error_t The error status code.
  */
-static void RemoveAnalogInputByID(uint8_t id) {
-	if (isExternalInput(id)) {
-		InitializeInput(&Ext_AInputs[id]);
-	} else if (isInternalInput(id)) {
-		if (id == IN_COLD_JUNCTION) {
-			/* We don't want to allow removal of this, so we return immediately. */
-			return;
+Tekdaqc_Function_Error_t SetAnalogInputFilter(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Function_Error_t retval = ERR_FUNCTION_OK;
+	Analog_Input_t* input = NULL;
+	AnalogFilterType_t type = NUM_ANALOG_FILTER_TYPES;
+	uint16_t decimation = 0U;
+	char* param;
+	int8_t index = -1;
+	for (uint_fast8_t i = 0U; (i < NUM_SET_ANALOG_INPUT_FILTER_PARAMS) && (retval == ERR_FUNCTION_OK); ++i) {
+		index = GetIndexOfArgument(keys, SET_ANALOG_INPUT_FILTER_PARAMS[i], count);
+		if (index >= 0) { /* We found the key in the list */
+			param = values[index]; /* We use the discovered index for this key */
+			switch (i) { /* Switch on the key not position in arguments list */
+			case 0U: /* INPUT key */
+				input = GetAnalogInputByNumber((uint8_t) strtol(param, NULL, 10));
+				if (input == NULL) {
+					retval = ERR_AIN_INPUT_OUTOFRANGE;
+				}
+				break;
+			case 1U: /* FILTER key */
+				type = AnalogFilter_StringToType(param);
+				if (type == NUM_ANALOG_FILTER_TYPES) {
+					retval = ERR_AIN_PARSE_ERROR;
+				}
+				break;
+			case 2U: /* DECIMATION key */
+				decimation = (uint16_t) strtoul(param, NULL, 10);
+				break;
+			default:
+				retval = ERR_AIN_PARSE_ERROR;
+			}
+		} else {
+#ifdef ANALOGINPUT_DEBUG
+			printf("[Analog Input] Unable to locate required key: %s\n\r", SET_ANALOG_INPUT_FILTER_PARAMS[i]);
+#endif
+			retval = ERR_AIN_PARSE_MISSING_KEY; /* Failed to locate a key */
 		}
-		InitializeInput(&Int_AInputs[id - (NUM_EXT_ANALOG_INPUTS + NUM_CAL_ANALOG_INPUTS)]);
-	} else if (id == EXTERNAL_OFFSET_CAL) {
-		/* Do nothing, we don't want to remove this input. */
-	} else {
-		/* This is out of range */
+	}
+	if ((retval == ERR_FUNCTION_OK) && (AnalogFilter_Configure(&input->filter, type, decimation) == false)) {
 #ifdef ANALOGINPUT_DEBUG
-		printf("[Analog Input] Cannot find the requested analog input. Input does not exist on the board.\n\r");
+		printf("[Analog Input] The requested filter decimation is invalid.\n\r");
 #endif
+		retval = ERR_AIN_PARSE_ERROR;
 	}
+	return retval;
 }
 
-/*--------------------------------------------------------------------------------------------------------*/
-/* INITIALIZATION METHODS */
-/*--------------------------------------------------------------------------------------------------------*/
+/**
+ * Sets the number of back to back conversions averaged into each of an analog input's samples. The INPUT key selects
+ * the input and the VALUE key the number of conversions, between 1 and ANALOG_INPUT_MAX_OVERSAMPLING. Unlike the
+ * filters, which combine samples taken a scan apart, the conversions of an oversampled input are taken one after the
+ * other before the scan moves on, so a multiplexed input pays its settling time once per sample.
+ *
+ * @param keys char** Array of strings containing the command line keys. Indexed with values.
+ * @param values char** Array of strings containing the command line values. Indexed with keys.
+ * @param count uint8_t The number of parameters passed on the command line.
+ * @retval Tekdaqc_Function_Error_t The error status code.
+ */
+Tekdaqc_Function_Error_t SetAnalogInputOversampling(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Function_Error_t retval = ERR_FUNCTION_OK;
+	Analog_Input_t* input = NULL;
+	uint32_t oversampling = 0U;
+	char* param;
+	int8_t index = -1;
+	for (uint_fast8_t i = 0U; (i < NUM_SET_ANALOG_INPUT_OVERSAMPLING_PARAMS) && (retval == ERR_FUNCTION_OK); ++i) {
+		index = GetIndexOfArgument(keys, SET_ANALOG_INPUT_OVERSAMPLING_PARAMS[i], count);
+		if (index >= 0) { /* We found the key in the list */
+			param = values[index]; /* We use the discovered index for this key */
+			switch (i) { /* Switch on the key not position in arguments list */
+			case 0U: /* INPUT key */
+				input = GetAnalogInputByNumber((uint8_t) strtol(param, NULL, 10));
+				if (input == NULL) {
+					retval = ERR_AIN_INPUT_OUTOFRANGE;
+				}
+				break;
+			case 1U: /* VALUE key */
+				oversampling = (uint32_t) strtoul(param, NULL, 10);
+				if ((oversampling == 0U) || (oversampling > ANALOG_INPUT_MAX_OVERSAMPLING)) {
+					retval = ERR_AIN_PARSE_ERROR;
+				}
+				break;
+			default:
+				retval = ERR_AIN_PARSE_ERROR;
+			}
+		} else {
+#ifdef ANALOGINPUT_DEBUG
+			printf("[Analog Input] Unable to locate required key: %s\n\r", SET_ANALOG_INPUT_OVERSAMPLING_PARAMS[i]);
+#endif
+			retval = ERR_AIN_PARSE_MISSING_KEY; /* Failed to locate a key */
+		}
+	}
+	if (retval == ERR_FUNCTION_OK) {
+		input->oversampling = (uint16_t) oversampling;
+		input->oversampled = 0U;
+		input->oversampleSum = 0;
+	}
+	return retval;
+}
 
 /**
- * Initializes all requisite sub-modules to properly operate analog inputs. This includes any multiplexing and
- * default inputs.
+ * Sets the time an external analog input is given to settle after the external multiplexer switches to it. The
+ * INPUT key selects the input, which must be an external one, and the TIME key the settle time in microseconds, up
+ * to ANALOG_INPUT_MAX_SETTLE_TIME. Low impedance sources may be given less than the default to raise the scan rate,
+ * high impedance ones more so their first conversion is settled.
  *
- * @param none
- * @retval none
+ * @param keys char** Array of strings containing the command line keys. Indexed with values.
+ * @param values char** Array of strings containing the command line values. Indexed with keys.
+ * @param count uint8_t The number of parameters passed on the command line.
+ * @retval Tekdaqc_Function_Error_t The error status code.
  */
-void AnalogInputsInit(void) {
-	/* Initialize the input multiplexer */
-	InputMultiplexerInit();
-	uint_fast8_t i = 0;
-	for (; i < NUM_EXT_ANALOG_INPUTS; ++i) {
-		InitializeInput(&Ext_AInputs[i]);
+Tekdaqc_Function_Error_t SetAnalogInputSettleTime(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Function_Error_t retval = ERR_FUNCTION_OK;
+	Analog_Input_t* input = NULL;
+	uint32_t settle = 0U;
+	uint8_t number = 0U;
+	char* param;
+	int8_t index = -1;
+	for (uint_fast8_t i = 0U; (i < NUM_SET_ANALOG_INPUT_SETTLE_PARAMS) && (retval == ERR_FUNCTION_OK); ++i) {
+		index = GetIndexOfArgument(keys, SET_ANALOG_INPUT_SETTLE_PARAMS[i], count);
+		if (index >= 0) { /* We found the key in the list */
+			param = values[index]; /* We use the discovered index for this key */
+			switch (i) { /* Switch on the key not position in arguments list */
+			case 0U: /* INPUT key */
+				number = (uint8_t) strtol(param, NULL, 10);
+				if (isExternalInput(number)) {
+					input = GetAnalogInputByNumber(number);
+				} else {
+#ifdef ANALOGINPUT_DEBUG
+					printf("[Analog Input] Only external inputs are switched by the external multiplexer.\n\r");
+#endif
+					retval = ERR_AIN_INPUT_OUTOFRANGE;
+				}
+				break;
+			case 1U: /* TIME key */
+				settle = (uint32_t) strtoul(param, NULL, 10);
+				if ((settle == 0U) || (settle > ANALOG_INPUT_MAX_SETTLE_TIME)) {
+					retval = ERR_AIN_PARSE_ERROR;
+				}
+				break;
+			default:
+				retval = ERR_AIN_PARSE_ERROR;
+			}
+		} else {
+#ifdef ANALOGINPUT_DEBUG
+			printf("[Analog Input] Unable to locate required key: %s\n\r", SET_ANALOG_INPUT_SETTLE_PARAMS[i]);
+#endif
+			retval = ERR_AIN_PARSE_MISSING_KEY; /* Failed to locate a key */
+		}
 	}
-	for (i = 0; i < NUM_INT_ANALOG_INPUTS; ++i) {
-		InitializeInput(&Int_AInputs[i]);
+	if (retval == ERR_FUNCTION_OK) {
+		input->settleTime = (uint16_t) settle;
 	}
-	/* Configure the offset cal input */
-	InitializeInput(&Offset_Cal_AInput);
-
-	/* Configure the cold junction input */
-	Analog_Input_t* cold = GetAnalogInputByNumber(IN_COLD_JUNCTION);
-	cold->physicalInput = IN_COLD_JUNCTION;
-	cold->buffer = ADS1256_BUFFER_ENABLED;
-	cold->rate = ADS1256_SPS_30000;
-	cold->gain = ADS1256_PGAx8;
-	strcpy(cold->name, "COLD JUNCTION");
-	cold->bufferReadIdx = 0U;
-	cold->bufferWriteIdx = 0U;
-	cold->min = 0;
-	cold->max = 0;
-	AddAnalogInput(cold);
+	return retval;
 }
 
 /**
- * Prints a human readable representation of all the added analog inputs via the current write function.
+ * Sets the thermocouple an analog input's samples are linearized for. The INPUT key selects the input, which must be
+ * an external one, and the TYPE key one of NONE, J, K or T. A linearized input reports the temperature of its
+ * measuring junction in milli-degrees Celsius, compensated for the board temperature at the terminals, instead of
+ * ADC counts, so its range, deadband and trigger levels are in the same units. The input's filter is reset as its
+ * history is in the old units.
  *
- * @param none
- * @return Tekdaqc_Function_Error_t The error status of this function.
+ * @param keys char** Array of strings containing the command line keys. Indexed with values.
+ * @param values char** Array of strings containing the command line values. Indexed with keys.
+ * @param count uint8_t The number of parameters passed on the command line.
+ * @retval Tekdaqc_Function_Error_t The error status code.
  */
-Tekdaqc_Function_Error_t ListAnalogInputs(void) {
+Tekdaqc_Function_Error_t SetAnalogInputThermocouple(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
 	Tekdaqc_Function_Error_t retval = ERR_FUNCTION_OK;
-	ClearToStringBuffer();
-	uint8_t n = snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER,
-			"\n\r--------------------\n\rAdded Analog Inputs\n\r\tExternal Inputs:\n\r");
-	if (n <= 0) {
-#ifdef ANALOGINPUT_DEBUG
-		printf("Failed to write header of analog input list.\n\r");
-#endif
-		retval = ERR_AIN_FAILED_WRITE;
-	} else {
-		if (writer != 0) {
-			writer(TOSTRING_BUFFER);
-		}
-		Analog_Input_t input;
-		for (uint_fast8_t i = 0U; i < NUM_EXT_ANALOG_INPUTS; ++i) {
-			input = Ext_AInputs[i];
-			if (input.added == CHANNEL_ADDED) {
-				/* This input has been added */
-				n = snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "\t\tPhysical Input %" PRIi8
-				":\n\r\t\t\tExternal Input: %s\n\r\t\t\tName: %s\n\r\t\t\tGain: %s\n\r\t\t\tRate: %s\n\r\t\t\tBuffer: %s\n\r",
-						input.physicalInput, ExtAnalogInputToString(input.externalInput), input.name, ADS1256_StringFromPGA(input.gain),
-						ADS1256_StringFromSPS(input.rate), ADS1256_StringFromBuffer(input.buffer));
-				if (n <= 0) {
+	Analog_Input_t* input = NULL;
+	ThermocoupleType_t type = NUM_THERMOCOUPLE_TYPES;
+	uint8_t number = 0U;
+	char* param;
+	int8_t index = -1;
+	for (uint_fast8_t i = 0U; (i < NUM_SET_ANALOG_INPUT_THERMOCOUPLE_PARAMS) && (retval == ERR_FUNCTION_OK); ++i) {
+		index = GetIndexOfArgument(keys, SET_ANALOG_INPUT_THERMOCOUPLE_PARAMS[i], count);
+		if (index >= 0) { /* We found the key in the list */
+			param = values[index]; /* We use the discovered index for this key */
+			switch (i) { /* Switch on the key not position in arguments list */
+			case 0U: /* INPUT key */
+				number = (uint8_t) strtol(param, NULL, 10);
+				if (isExternalInput(number)) {
+					input = GetAnalogInputByNumber(number);
+				} else {
 #ifdef ANALOGINPUT_DEBUG
-					printf("Failed to write an analog input to the list.\n\r");
+					printf("[Analog Input] Only external inputs may be linearized for a thermocouple.\n\r");
 #endif
-					retval = ERR_AIN_FAILED_WRITE;
-					break;
-				} else {
-					if (writer != 0) {
-						writer(TOSTRING_BUFFER);
-					}
+					retval = ERR_AIN_INPUT_OUTOFRANGE;
+				}
+				break;
+			case 1U: /* TYPE key */
+				type = Thermocouple_StringToType(param);
+				if (type == NUM_THERMOCOUPLE_TYPES) {
+					retval = ERR_AIN_PARSE_ERROR;
 				}
+				break;
+			default:
+				retval = ERR_AIN_PARSE_ERROR;
 			}
-		}
-		if (retval == ERR_FUNCTION_OK) {
-			n = snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "\n\r\tInternal Inputs:\n\r");
-			if (n <= 0) {
+		} else {
 #ifdef ANALOGINPUT_DEBUG
-				printf("Failed to write header of internal analog input list.\n\r");
+			printf("[Analog Input] Unable to locate required key: %s\n\r", SET_ANALOG_INPUT_THERMOCOUPLE_PARAMS[i]);
 #endif
-				retval = ERR_AIN_FAILED_WRITE;
-			} else {
-				if (writer != 0) {
-					writer(TOSTRING_BUFFER);
+			retval = ERR_AIN_PARSE_MISSING_KEY; /* Failed to locate a key */
+		}
+	}
+	if (retval == ERR_FUNCTION_OK) {
+		input->thermocouple = type;
+		input->coldJunctionEMF = Thermocouple_TemperatureToEMF(type, (int32_t) (getBoardTemperature() * 1000.0f));
+		AnalogFilter_Reset(&input->filter);
+	}
+	return retval;
+}
+
+/**
+ * Sets the automatic gain ranging of an analog input. The INPUT key selects the input, which may be any but the cold
+ * junction, and the STATE key turns auto-ranging ON or OFF. The optional GAIN key sets the highest gain it may select,
+ * 64 if not given, and the input's gain is lowered to it if above. While scanning more than one input outside of the
+ * statistics mode and triggered captures, the gain of an auto-ranged input then follows its signal between scans, see
+ * AutoRangeAnalogInput(). Turning auto-ranging off leaves the input at the gain it last selected.
+ *
+ * @param keys char** Array of strings containing the command line keys. Indexed with values.
+ * @param values char** Array of strings containing the command line values. Indexed with keys.
+ * @param count uint8_t The number of parameters passed on the command line.
+ * @retval Tekdaqc_Function_Error_t The error status code.
+ */
+Tekdaqc_Function_Error_t SetAnalogInputAutoRange(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Function_Error_t retval = ERR_FUNCTION_OK;
+	Analog_Input_t* input = NULL;
+	bool enabled = false;
+	ADS1256_PGA_t maxGain = ADS1256_PGAx64;
+	char* param;
+	int8_t index = -1;
+	for (uint_fast8_t i = 0U; (i < NUM_SET_ANALOG_INPUT_AUTO_RANGE_PARAMS) && (retval == ERR_FUNCTION_OK); ++i) {
+		index = GetIndexOfArgument(keys, SET_ANALOG_INPUT_AUTO_RANGE_PARAMS[i], count);
+		if (index >= 0) { /* We found the key in the list */
+			param = values[index]; /* We use the discovered index for this key */
+			switch (i) { /* Switch on the key not position in arguments list */
+			case 0U: /* INPUT key */
+				input = GetAnalogInputByNumber((uint8_t) strtol(param, NULL, 10));
+				if ((input == NULL) || (input->physicalInput == IN_COLD_JUNCTION)) {
+					retval = ERR_AIN_INPUT_OUTOFRANGE;
 				}
-				for (uint_fast8_t i = 0U; i < NUM_INT_ANALOG_INPUTS; ++i) {
-					input = Int_AInputs[i];
-					if (input.added == CHANNEL_ADDED) {
-						/* This input has been added */
-						n = snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "\t\tPhysical Input %" PRIi8
-						":\n\r\t\t\tInternal Input: %s\n\r\t\t\tName: %s\n\r\t\t\tGain: %s\n\r\t\t\tRate: %s\n\r\t\t\tBuffer: %s\n\r",
-								input.physicalInput, IntAnalogInputToString(input.internalInput), input.name,
-								ADS1256_StringFromPGA(input.gain), ADS1256_StringFromSPS(input.rate),
-								ADS1256_StringFromBuffer(input.buffer));
-						if (n <= 0) {
-#ifdef ANALOGINPUT_DEBUG
-							printf("Failed to write an analog input to the list.\n\r");
-#endif
-							retval = ERR_AIN_FAILED_WRITE;
-							break;
-						} else {
-							if (writer != 0) {
-								writer(TOSTRING_BUFFER);
-							}
-						}
-					}
+				break;
+			case 1U: /* STATE key */
+				if (strcmp(param, STATE_ON_STRING) == 0) {
+					enabled = true;
+				} else if (strcmp(param, STATE_OFF_STRING) != 0) {
+					retval = ERR_AIN_PARSE_ERROR;
 				}
+				break;
+			case 2U: /* GAIN key */
+				maxGain = ADS1256_StringToPGA(param);
+				break;
+			default:
+				retval = ERR_AIN_PARSE_ERROR;
 			}
+		} else if (i == 2U) {
+			/* The GAIN key is not strictly required, leave the default */
+			continue;
+		} else {
+#ifdef ANALOGINPUT_DEBUG
+			printf("[Analog Input] Unable to locate required key: %s\n\r", SET_ANALOG_INPUT_AUTO_RANGE_PARAMS[i]);
+#endif
+			retval = ERR_AIN_PARSE_MISSING_KEY; /* Failed to locate a key */
+		}
+	}
+	if (retval == ERR_FUNCTION_OK) {
+		input->autoRange = enabled;
+		input->maxGain = maxGain;
+		input->rangeChanges = 0U;
+		if ((enabled == true) && (input->gain > maxGain)) {
+			input->gain = maxGain;
+			CompileInputRegisters(input);
 		}
 	}
 	return retval;
 }
 
 /**
- * Creates a new analog input data structure from the supplied parameters and adds it to the board's relevant
- * input list.
+ * Sets the pair of ADC inputs a differential analog input measures. The INPUT key selects the input, which must be a
+ * differential one, and the POSITIVE and NEGATIVE keys the ADC inputs of either side of the pair, AIN0 to AIN7 or
+ * AINCOM. This lets a bridge or other floating source be measured in a single conversion rather than as two single
+ * ended inputs subtracted by the host. The input's filter is reset as its history is of the old pair.
  *
  * @param keys char** Array of strings containing the command line keys. Indexed with values.
  * @param values char** Array of strings containing the command line values. Indexed with keys.
  * @param count uint8_t The number of parameters passed on the command line.
- * @retval uint8_t The error status code.
+ * @retval Tekdaqc_Function_Error_t The error status code.
  */
-Tekdaqc_Function_Error_t CreateAnalogInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+Tekdaqc_Function_Error_t SetAnalogInputPair(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
 	Tekdaqc_Function_Error_t retval = ERR_FUNCTION_OK;
+	Analog_Input_t* input = NULL;
+	ADS1256_AIN_t positive = DIFFERENTIAL_DEFAULT_AINP;
+	ADS1256_AIN_t negative = DIFFERENTIAL_DEFAULT_AINN;
+	uint8_t number = 0U;
 	char* param;
 	int8_t index = -1;
-	/* Set the default parameters */
-	uint8_t input = NULL_CHANNEL; /* The physical input */
-	ADS1256_BUFFER_t buffer = ADS1256_BUFFER_ENABLED; /* The default buffer setting */
-	ADS1256_SPS_t rate = ADS1256_SPS_10; /* The default sample rate setting */
-	ADS1256_PGA_t gain = ADS1256_PGAx1; /* The default gain setting */
-	char name[MAX_ANALOG_INPUT_NAME_LENGTH]; /* The name */
-	strcpy(name, "NONE");
-	uint_fast8_t i = 0U;
-	for (; i < NUM_ADD_ANALOG_INPUT_PARAMS; ++i) {
-		index = GetIndexOfArgument(keys, ADD_ANALOG_INPUT_PARAMS[i], count);
+	for (uint_fast8_t i = 0U; (i < NUM_SET_ANALOG_INPUT_PAIR_PARAMS) && (retval == ERR_FUNCTION_OK); ++i) {
+		index = GetIndexOfArgument(keys, SET_ANALOG_INPUT_PAIR_PARAMS[i], count);
 		if (index >= 0) { /* We found the key in the list */
 			param = values[index]; /* We use the discovered index for this key */
 			switch (i) { /* Switch on the key not position in arguments list */
-			case 0U: { /* INPUT key */
-				char* testPtr = NULL;
-				uint8_t in = (uint8_t) strtol(param, &testPtr, 10);
-				if (testPtr == param) {
-					retval = ERR_AIN_PARSE_ERROR;
+			case 0U: /* INPUT key */
+				number = (uint8_t) strtol(param, NULL, 10);
+				if (isDifferentialInput(number)) {
+					input = GetAnalogInputByNumber(number);
 				} else {
-					if (in >= 0U && in <= NUM_ANALOG_INPUTS) {
-						/* A valid input number */
-						input = in;
-					} else {
-						/* Input number out of range */
 #ifdef ANALOGINPUT_DEBUG
-						printf("[Analog Input] The requested input number is invalid.\n\r");
+					printf("[Analog Input] Only differential inputs may be given a pair.\n\r");
 #endif
-						retval = ERR_AIN_INPUT_OUTOFRANGE;
-					}
+					retval = ERR_AIN_INPUT_OUTOFRANGE;
 				}
 				break;
-			}
-			case 1U: /* BUFFER key */
-				buffer = ADS1256_StringToBuffer(param);
-				break;
-			case 2U: /* RATE key */
-				rate = ADS1256_StringToDataRate(param);
-				break;
-			case 3U: /* GAIN key */
-				gain = ADS1256_StringToPGA(param);
+			case 1U: /* POSITIVE key */
+				if (StringToAnalogPin(param, &positive) == false) {
+					retval = ERR_AIN_PARSE_ERROR;
+				}
 				break;
-			case 4U: /* NAME key */
-				strcpy(name, param);
+			case 2U: /* NEGATIVE key */
+				if (StringToAnalogPin(param, &negative) == false) {
+					retval = ERR_AIN_PARSE_ERROR;
+				}
 				break;
 			default:
 				retval = ERR_AIN_PARSE_ERROR;
 			}
-		} else if (i == 1U || i == 2U || i == 3U || i == 4U || i == 5U) {
-			/* The BUFFER, RATE, GAIN and NAME keys are not strictly required, leave the defaults */
-			continue;
 		} else {
-			/* Somehow an error happened */
 #ifdef ANALOGINPUT_DEBUG
-			printf("[Analog Input] Unable to locate required key: %s\n\r", ADD_ANALOG_INPUT_PARAMS[i]);
+			printf("[Analog Input] Unable to locate required key: %s\n\r", SET_ANALOG_INPUT_PAIR_PARAMS[i]);
 #endif
 			retval = ERR_AIN_PARSE_MISSING_KEY; /* Failed to locate a key */
 		}
-		if (retval != ERR_FUNCTION_OK) {
-			break;
+	}
+	if ((retval == ERR_FUNCTION_OK) && (positive == negative)) {
+#ifdef ANALOGINPUT_DEBUG
+		printf("[Analog Input] The two sides of a pair must be different inputs.\n\r");
+#endif
+		retval = ERR_AIN_PARSE_ERROR;
+	}
+	if (retval == ERR_FUNCTION_OK) {
+		input->positiveInput = positive;
+		input->negativeInput = negative;
+		AnalogFilter_Reset(&input->filter);
+	}
+	return retval;
+}
+
+/**
+ * Picks the data rate of every added analog input for a requested per channel sample rate. The slowest rate, which
+ * is also the quietest, that still lets a scan of all the added inputs reach the requested rate is chosen; if none
+ * can, the fastest rate is. All inputs are given the same rate so the scan plan can group them and the ADC is only
+ * reprogrammed between the internal and external inputs. See EstimateScan() for the timing model. Must not be
+ * called while the ADC is sampling.
+ *
+ * @param bandwidth float The requested per channel sample rate in samples per second.
+ * @param rate ADS1256_SPS_t* Set to the chosen data rate.
+ * @retval float The estimated per channel sample rate at the chosen data rate, 0 if no inputs are added.
+ */
+float PlanAnalogInputRates(float bandwidth, ADS1256_SPS_t* rate) {
+	AnalogScanPrediction_t prediction;
+	uint_fast8_t plan = 0U;
+	EstimateScan(&PLAN_RATES[plan], &prediction);
+	while ((prediction.channelRate < bandwidth) && (plan < (NUM_PLAN_RATES - 1U))) {
+		++plan;
+		EstimateScan(&PLAN_RATES[plan], &prediction);
+	}
+	const float achievable = prediction.channelRate;
+	*rate = PLAN_RATES[plan];
+	for (uint_fast8_t i = 0U; i < NUM_ANALOG_INPUTS; ++i) {
+		Analog_Input_t* input = GetAnalogInputByNumber(i);
+		if ((i != EXTERNAL_OFFSET_CAL) && (input->added == CHANNEL_ADDED) && (input->rate != *rate)) {
+			input->rate = *rate;
+			CompileInputRegisters(input);
+		}
+	}
+#ifdef ANALOGINPUT_DEBUG
+	printf("[Analog Input] Planned a rate of %s SPS for %.1f samples per second per channel.\n\r",
+			ADS1256_StringFromSPS(*rate), (double) achievable);
+#endif
+	return achievable;
+}
+
+/**
+ * Predicts the timing of a scan of every added analog input at their current settings. See EstimateScan() for the
+ * timing model.
+ *
+ * @param prediction AnalogScanPrediction_t* Filled in with the prediction. All zero if no inputs are added.
+ * @retval none
+ */
+void PredictAnalogScan(AnalogScanPrediction_t* prediction) {
+	EstimateScan(NULL, prediction);
+}
+
+/**
+ * Retrieve an analog input structure by specifying the physical input channel.
+ *
+ * @param number uint8_t The physical input channel to retrieve.
+ * @retval Analog_Input_t* Pointer to the analog input structure.
+ */
+Analog_Input_t* GetAnalogInputByNumber(uint8_t number) {
+	if (number < NUM_ANALOG_INPUTS) {
+		return analogInputTable[number];
+	} else {
+		/* This is out of range */
+#ifdef ANALOGINPUT_DEBUG
+		printf("[Analog Input] Cannot find the requested analog input. Input does not exist on the board.\n\r");
+#endif
+		return NULL ;
+	}
+}
+
+/**
+ * Opens a configuration. Until it is committed, adding, removing and changing the settings of inputs only records
+ * their settings, and the work which depends on them, compiling each input's register image, is left for
+ * CommitAnalogInputConfig() to do once for all of them. Opening a configuration which is already open has no effect.
+ *
+ * @param none
+ * @retval none
+ */
+void BeginAnalogInputConfig(void) {
+	configOpen = true;
+}
+
+/**
+ * Commits the open configuration, compiling the register image of each input changed since it was opened. The ADC
+ * state machine fills in their calibration values the next time each is converted, see ADC_Machine_PrepareInputs().
+ * Committing when no configuration is open has no effect.
+ *
+ * @param none
+ * @retval uint8_t The number of inputs whose register images were compiled.
+ */
+uint8_t CommitAnalogInputConfig(void) {
+	uint8_t compiled = 0U;
+	if (configOpen == false) {
+		return compiled;
+	}
+	configOpen = false;
+	for (uint_fast8_t i = 0U; i < NUM_ANALOG_INPUTS; ++i) {
+		Analog_Input_t* input = analogInputTable[i];
+		if (input->registersPending == true) {
+			CompileInputRegisters(input);
+			++compiled;
+		}
+	}
+#ifdef ANALOGINPUT_DEBUG
+	printf("[Analog Input] Committed the configuration, compiling %i register images.\n\r", compiled);
+#endif
+	return compiled;
+}
+
+/**
+ * Determines if a configuration is open, see BeginAnalogInputConfig().
+ *
+ * @param none
+ * @retval bool TRUE if a configuration is open.
+ */
+bool isAnalogInputConfigOpen(void) {
+	return configOpen;
+}
+
+/**
+ * Divides the sample pool among the inputs of a scan, giving each an equal, power of two share so that a single
+ * input may buffer the entire pool. Every other input is left without a buffer. The cold junction keeps its own
+ * buffer and takes no share. This must only be called while the ADC is not sampling, as it discards any samples
+ * which have not yet been written.
+ *
+ * @param inputs Analog_Input_t** The list of inputs in the scan. Unused entries are NULL.
+ * @param count uint8_t The length of the list.
+ * @retval none
+ */
+void AllocateAnalogInputBuffers(Analog_Input_t** inputs, uint8_t count) {
+	Analog_Input_t* cold = GetAnalogInputByNumber(IN_COLD_JUNCTION);
+	uint_fast8_t i = 0U;
+	for (; i < NUM_EXT_ANALOG_INPUTS; ++i) {
+		ReleaseInputBuffer(&Ext_AInputs[i]);
+	}
+	for (i = 0U; i < NUM_INT_ANALOG_INPUTS; ++i) {
+		ReleaseInputBuffer(&Int_AInputs[i]);
+	}
+	for (i = 0U; i < NUM_DIFF_ANALOG_INPUTS; ++i) {
+		ReleaseInputBuffer(&Diff_AInputs[i]);
+	}
+	ReleaseInputBuffer(&Offset_Cal_AInput);
+
+	uint32_t sharing = 0U;
+	for (i = 0U; i < count; ++i) {
+		if ((inputs[i] != NULL) && (inputs[i] != cold)) {
+			++sharing;
+		}
+	}
+	if (sharing == 0U) {
+		return;
+	}
+	/* Round the share down to a power of two */
+	uint32_t share = ANALOG_SAMPLE_POOL_SIZE;
+	while ((share * sharing) > ANALOG_SAMPLE_POOL_SIZE) {
+		share >>= 1U;
+	}
+	uint32_t offset = 0U;
+	for (i = 0U; i < count; ++i) {
+		if ((inputs[i] != NULL) && (inputs[i] != cold)) {
+			inputs[i]->values = &sampleValuePool[offset * ANALOG_SAMPLE_VALUE_SIZE];
+			inputs[i]->flags = &sampleFlagPool[offset];
+			inputs[i]->timestampDeltas = &sampleDeltaPool[offset];
+			inputs[i]->blockTimestamps = &sampleBlockPool[offset / ANALOG_SAMPLE_BLOCK_SIZE];
+			inputs[i]->sequenceDeltas = &sampleSequencePool[offset];
+			inputs[i]->blockSequences = &sampleBlockSequencePool[offset / ANALOG_SAMPLE_BLOCK_SIZE];
+			RingBuffer_Init(&inputs[i]->samples, share);
+			offset += share;
+		}
+	}
+#ifdef ANALOGINPUT_DEBUG
+	printf("[Analog Input] Allocated %" PRIu32 " samples to each of %" PRIu32 " inputs.\n\r", share, sharing);
+#endif
+}
+
+/**
+ * Stores a measurement in an analog input's sample buffer. The value is packed into its 3 significant bytes and the
+ * timestamp is stored as an offset from the first sample of its block. Offsets beyond the 32 bit range, over an hour
+ * into a block, saturate. The sample takes the input's next sequence number, likewise stored as an offset from its
+ * block's base which saturates beyond 16 bits. Since every sample of a block depends on its base, a new block is only
+ * started once the previous occupant of its storage has been completely read. Called only from the producer side of
+ * the ring; a dropped sample must still be counted by advancing the input's sequence number.
+ *
+ * @param input Analog_Input_t* The input the measurement belongs to. It must have a sample buffer.
+ * @param value int32_t The measured value (ADC Counts).
+ * @param timestamp uint64_t The time of the measurement.
+ * @param flags uint8_t The ANALOG_SAMPLE_FLAG_ bits of the measurement.
+ * @retval bool FALSE if the buffer was full and the measurement was dropped.
+ */
+bool StoreAnalogSample(Analog_Input_t* input, int32_t value, uint64_t timestamp, uint8_t flags) {
+	const bool blockStart = ((input->samples.head & (ANALOG_SAMPLE_BLOCK_SIZE - 1U)) == 0U);
+	uint32_t index;
+	if (RingBuffer_BeginWriteReserve(&input->samples, &index, (blockStart == true) ? ANALOG_SAMPLE_BLOCK_SIZE : 1U) == false) {
+		return false;
+	}
+	uint8_t* packed = &input->values[index * ANALOG_SAMPLE_VALUE_SIZE];
+	packed[0] = (uint8_t) value;
+	packed[1] = (uint8_t) (value >> 8);
+	packed[2] = (uint8_t) (value >> 16);
+	input->flags[index] = flags;
+	uint64_t* base = &input->blockTimestamps[index / ANALOG_SAMPLE_BLOCK_SIZE];
+	if (blockStart == true) {
+		*base = timestamp;
+	}
+	const uint64_t delta = timestamp - *base;
+	input->timestampDeltas[index] = (delta > UINT32_MAX) ? UINT32_MAX : (uint32_t) delta;
+	uint32_t* sequenceBase = &input->blockSequences[index / ANALOG_SAMPLE_BLOCK_SIZE];
+	if (blockStart == true) {
+		*sequenceBase = input->sequence;
+	}
+	const uint32_t sequenceDelta = input->sequence - *sequenceBase;
+	input->sequenceDeltas[index] = (sequenceDelta > UINT16_MAX) ? UINT16_MAX : (uint16_t) sequenceDelta;
+	++(input->sequence);
+	RingBuffer_EndWrite(&input->samples);
+	return true;
+}
+
+/**
+ * Converts a span of an analog input's stored samples into signed values, a block at a time. A span which wraps past
+ * the end of the input's storage is converted as two blocks. Consumer side; the samples are not released.
+ *
+ * @param input const Analog_Input_t* The input the samples belong to.
+ * @param offset uint32_t The position of the first sample from the oldest stored, which is 0.
+ * @param count uint32_t The number of samples to convert.
+ * @param values int32_t* The converted values (ADC Counts). Must have room for count values.
+ * @retval uint32_t The number of samples converted, which is less than count if fewer are stored.
+ */
+uint32_t ReadAnalogSampleValues(const Analog_Input_t* input, uint32_t offset, uint32_t count, int32_t* values) {
+	const uint32_t stored = RingBuffer_Count(&input->samples);
+	if (offset >= stored) {
+		return 0U;
+	}
+	if (count > (stored - offset)) {
+		count = stored - offset;
+	}
+	const uint32_t first = RingBuffer_PeekIndex(&input->samples, offset);
+	const uint32_t capacity = input->samples.mask + 1U;
+	const uint32_t contiguous = ((capacity - first) < count) ? (capacity - first) : count;
+	ADS1256_ConvertRawBlock(&input->values[first * ANALOG_SAMPLE_VALUE_SIZE], values, contiguous);
+	ADS1256_ConvertRawBlock(input->values, &values[contiguous], count - contiguous);
+	return count;
+}
+
+/**
+ * Sets the window of the statistics output mode. While enabled, sampled inputs report one record of the minimum,
+ * maximum, mean and RMS of each window instead of their samples. A window closes after the given number of samples or
+ * once the given time has passed since its first sample, whichever comes first, and never holds more than
+ * ANALOG_STATISTICS_MAX_COUNT samples. Must only be called while the ADC is not sampling.
+ *
+ * @param samples uint32_t The number of samples in a window, 0 for no limit.
+ * @param period uint32_t The duration of a window in milliseconds, 0 for no limit. If both are 0 statistics mode is
+ * disabled.
+ * @retval none
+ */
+void SetAnalogStatisticsWindow(uint32_t samples, uint32_t period) {
+	statisticsWindow = samples;
+	statisticsPeriod = (uint64_t) period * 1000U;
+}
+
+/**
+ * Indicates if analog inputs report statistics instead of samples.
+ *
+ * @param none
+ * @retval bool TRUE if statistics mode is enabled.
+ */
+bool isAnalogStatisticsEnabled(void) {
+	return ((statisticsWindow != 0U) || (statisticsPeriod != 0U));
+}
+
+/**
+ * Discards any partial or unwritten statistics window and partly oversampled sample of an analog input and forgets
+ * its last reported value, so the first sample is always reported. The input's first sample is flagged as settling,
+ * its overrun counts are cleared, its sequence numbers restart from 0 and its first text batch carries the full header
+ * again. The run starts with a stream descriptor if the client asked for one. Called whenever sampling begins so none
+ * of them span separate sampling runs.
+ *
+ * @param input Analog_Input_t* Pointer/Reference to an analog input structure.
+ * @retval none
+ */
+void ResetAnalogInputReporting(Analog_Input_t* input) {
+	input->oversampled = 0U;
+	input->oversampleSum = 0;
+	input->statistics.count = 0U;
+	input->windowReady = false;
+	input->reported = false;
+	input->pendingFlags = ANALOG_SAMPLE_FLAG_SETTLING;
+	input->overruns = 0U;
+	input->reportedOverruns = 0U;
+	input->sequence = 0U;
+	input->rangeQuiet = 0U;
+	input->rangeSequences[0] = 0U;
+	input->rangeGains[0] = input->gain;
+	input->rangeCount = 1U;
+	textChannels[input->physicalInput].valid = false;
+	descriptorPending = true;
+}
+
+/**
+ * Adds a conversion to the sample an analog input is oversampling. Once the input's oversampling count of
+ * conversions has been accumulated, their average, rounded to the nearest count, replaces the conversion. Called
+ * only from the producer side, like StoreAnalogSample().
+ *
+ * @param input Analog_Input_t* The input the conversion belongs to.
+ * @param value int32_t* The conversion. Replaced by the completed sample when there is one.
+ * @retval bool TRUE if a sample was completed.
+ */
+bool OversampleAnalogInput(Analog_Input_t* input, int32_t* value) {
+	if (input->oversampling <= 1U) {
+		return true;
+	}
+	input->oversampleSum += *value;
+	if (++(input->oversampled) < input->oversampling) {
+		return false;
+	}
+	const int64_t half = input->oversampling / 2;
+	const int64_t sum = input->oversampleSum;
+	*value = (int32_t) ((sum >= 0) ? ((sum + half) / input->oversampling) : ((sum - half) / input->oversampling));
+	input->oversampled = 0U;
+	input->oversampleSum = 0;
+	return true;
+}
+
+/**
+ * Follows the signal of an auto-ranged input with its gain. The gain is lowered a step once a sample is above 7/8 of
+ * full scale, or straight to ADS1256_PGAx1 once one clips, and raised a step once ANALOG_RANGE_WINDOW samples in a row
+ * are below 3/8 of it, up to the input's maxGain. The new gain is noted in the input's gain history against the
+ * sequence number of its next sample, which is flagged ANALOG_SAMPLE_FLAG_RANGE, and its register image is rebuilt so
+ * the ADC state machine loads the gain, and looks up its calibration, when it next selects the input. A change is put
+ * off while the history entry it would replace is still needed by a buffered sample. The filter and deadband of an
+ * input which reports ADC counts are restarted, as their history is in counts of the old gain. Called only from the
+ * producer side, like StoreAnalogSample(), with each completed sample before it is linearized.
+ *
+ * @param input Analog_Input_t* The input the sample belongs to.
+ * @param value int32_t The sample (ADC Counts).
+ * @retval none
+ */
+void AutoRangeAnalogInput(Analog_Input_t* input, int32_t value) {
+	const uint32_t magnitude = (value < 0) ? (uint32_t) (-(int64_t) value) : (uint32_t) value;
+	ADS1256_PGA_t gain = input->gain;
+	if (magnitude < ANALOG_RANGE_LOW) {
+		if ((gain < input->maxGain) && (++(input->rangeQuiet) >= ANALOG_RANGE_WINDOW)) {
+			gain = (ADS1256_PGA_t) (gain + 1U);
+		}
+	} else {
+		input->rangeQuiet = 0U;
+		if (magnitude >= MAX_CODE) {
+			/* Clipped, so how far the signal is beyond full scale is unknown */
+			gain = ADS1256_PGAx1;
+		} else if ((magnitude > ANALOG_RANGE_HIGH) && (gain > ADS1256_PGAx1)) {
+			gain = (ADS1256_PGA_t) (gain - 1U);
 		}
 	}
-	if (retval == ERR_FUNCTION_OK) {
-		if (input != NULL_CHANNEL ) {
-			Analog_Input_t* an_input = GetAnalogInputByNumber(input);
-			if (an_input != NULL ) {
-				if (an_input->added == CHANNEL_NOTADDED) {
-					an_input->physicalInput = input;
-					an_input->buffer = buffer;
-					an_input->rate = rate;
-					an_input->gain = gain;
-					strcpy(an_input->name, name);
-					an_input->bufferReadIdx = 0U;
-					an_input->bufferWriteIdx = 0U;
-					an_input->min = 0;
-					an_input->max = 0;
-					retval = AddAnalogInput(an_input);
-				} else {
-					retval = ERR_AIN_INPUT_EXISTS;
-				}
-			} else {
-				/* The input could not be found */
-				retval = ERR_AIN_INPUT_NOT_FOUND;
-			}
-		} else {
-			/* A valid input was never specified */
-			retval = ERR_AIN_INPUT_UNSPECIFIED;
+	if (gain == input->gain) {
+		return;
+	}
+	if ((input->rangeCount >= ANALOG_RANGE_HISTORY_SIZE) && (RingBuffer_IsEmpty(&input->samples) == false)) {
+		const uint32_t needed = input->rangeSequences[(input->rangeCount + 1U) & (ANALOG_RANGE_HISTORY_SIZE - 1U)];
+		const uint32_t oldest = GetSampleSequence(input, RingBuffer_PeekIndex(&input->samples, 0U));
+		if ((int32_t) (oldest - needed) < 0) {
+			/* The oldest buffered sample still needs the entry this change would replace */
+			return;
 		}
 	}
-	return retval; /* Return the status */
+	const uint32_t slot = input->rangeCount & (ANALOG_RANGE_HISTORY_SIZE - 1U);
+	input->rangeSequences[slot] = input->sequence;
+	input->rangeGains[slot] = gain;
+	++(input->rangeCount);
+	++(input->rangeChanges);
+	input->rangeQuiet = 0U;
+	input->gain = gain;
+	BuildInputRegisters(input);
+	input->pendingFlags |= ANALOG_SAMPLE_FLAG_RANGE;
+	if (input->thermocouple == THERMOCOUPLE_NONE) {
+		AnalogFilter_Reset(&input->filter);
+		input->reported = false;
+	}
 }
 
 /**
- * Adds an analog input structure to the board's appropriate list of inputs.
+ * Converts a sample of a thermocouple input to the temperature of its measuring junction. The sample is scaled to
+ * nanovolts, the EMF of the cold junction is added to refer it to a 0 degree junction and the result is
+ * linearized. Samples of other inputs are returned unchanged. Called only from the producer side, like
+ * StoreAnalogSample().
  *
- * @param input Analog_Input_t* The analog input structure to add.
+ * @param input const Analog_Input_t* The input the sample belongs to.
+ * @param value int32_t The sample (ADC Counts).
+ * @retval int32_t The temperature in milli-degrees Celsius, or the unchanged sample.
+ */
+int32_t LinearizeAnalogSample(const Analog_Input_t* input, int32_t value) {
+	if (input->thermocouple == THERMOCOUPLE_NONE) {
+		return value;
+	}
+	int64_t emf = ((((int64_t) value) * input->emfScale) >> ANALOG_EMF_SCALE_BITS) + input->coldJunctionEMF;
+	/* Readings beyond every table saturate rather than wrap */
+	if (emf > INT32_MAX) {
+		emf = INT32_MAX;
+	} else if (emf < INT32_MIN) {
+		emf = INT32_MIN;
+	}
+	return Thermocouple_EMFToTemperature(input->thermocouple, (int32_t) emf);
+}
+
+/**
+ * Updates the cold junction compensation of every thermocouple input for a new temperature of the terminals. Called
+ * from the main loop whenever the board temperature is updated. Each EMF is a single word store, so the DRDY
+ * interrupt never sees one half written.
+ *
+ * @param temperature float The cold junction temperature in degrees Celsius.
  * @retval none
  */
-Tekdaqc_Function_Error_t AddAnalogInput(Analog_Input_t* input) {
-	Tekdaqc_Function_Error_t retval = ERR_FUNCTION_OK;
-	PhysicalAnalogInput_t index = input->physicalInput;
-	if (isExternalInput(index)) {
-		/* This is an external analog input */
-		input->externalInput = GetExternalMuxedInputByNumber(index);
-		input->internalInput = NULL_CHANNEL;
-		input->added = CHANNEL_ADDED;
-#ifdef ANALOGINPUT_DEBUG
-		printf("[Analog Input] Added input to external inputs list.\n\r");
-#endif
-	} else if (isInternalInput(index)) {
-		/* This is an internal analog input */
-		input->externalInput = NULL_CHANNEL;
-		input->internalInput = index - (NUM_EXT_ANALOG_INPUTS + NUM_CAL_ANALOG_INPUTS);
-		input->added = CHANNEL_ADDED;
-#ifdef ANALOGINPUT_DEBUG
-		printf("[Analog Input] Added input to internal inputs list.\n\r");
-#endif
-	} else if (index == EXTERNAL_OFFSET_CAL) {
-		/* This is the offset calibration input */
-		input->externalInput = NULL_CHANNEL;
-		input->internalInput = NULL_CHANNEL;
-		input->added = CHANNEL_ADDED;
-#ifdef ANALOGINPUT_DEBUG
-		printf("[Analog Input] Added external offset input.\n\r");
-#endif
-	} else {
-		/* This is out of range */
-#ifdef ANALOGINPUT_DEBUG
-		printf("[Analog Input] Cannot add the provided analog input. Input does not exist on the board.\n\r");
-#endif
-		retval = ERR_AIN_INPUT_OUTOFRANGE;
+void UpdateAnalogInputColdJunctions(float temperature) {
+	const int32_t milliDegrees = (int32_t) (temperature * 1000.0f);
+	for (uint_fast8_t i = 0U; i < NUM_EXT_ANALOG_INPUTS; ++i) {
+		if (Ext_AInputs[i].thermocouple != THERMOCOUPLE_NONE) {
+			Ext_AInputs[i].coldJunctionEMF = Thermocouple_TemperatureToEMF(Ext_AInputs[i].thermocouple, milliDegrees);
+		}
 	}
-	return retval;
 }
 
 /**
- * Removes an analog input from the board's list based on the supplied parameters.
+ * Decides if a measurement should be reported under an analog input's deadband. A sample is reported if it is the
+ * first of the sampling, if it differs from the last reported value by more than the deadband or if the heartbeat
+ * interval has passed since the last report, so a host can tell a quiet channel from a lost one. A reported sample
+ * becomes the new center of the deadband. Called only from the producer side, like StoreAnalogSample().
  *
- * @param keys char** Array of strings containing the command line keys. Indexed with values.
- * @param values char** Array of strings containing the command line values. Indexed with keys.
- * @param count uint8_t The number of parameters passed on the command line.
- * @retval int The error status code.
+ * @param input Analog_Input_t* The input the measurement belongs to.
+ * @param value int32_t The measured value (ADC Counts).
+ * @param timestamp uint64_t The time of the measurement.
+ * @retval bool TRUE if the sample should be reported.
  */
-Tekdaqc_Function_Error_t RemoveAnalogInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
-	Tekdaqc_Function_Error_t retval = ERR_FUNCTION_OK;
-	char* param;
-	int8_t index = -1;
-	uint_fast8_t i = 0U;
-	for (; i < NUM_REMOVE_ANALOG_INPUT_PARAMS; ++i) {
-		index = GetIndexOfArgument(keys, REMOVE_ANALOG_INPUT_PARAMS[i], count);
-		if (index >= 0) { /* We found the key in the list */
-			param = values[index]; /* We use the discovered index for this key */
-			switch (i) { /* Switch on the key not position in arguments list */
-			case 0U: { /* INPUT key */
-				printf("Processing INPUT key\n\r");
-				uint8_t in = (uint8_t) strtol(param, NULL, 10);
-				if (in >= 0U && in <= NUM_ANALOG_INPUTS) {
-					/* A valid input number */
-					RemoveAnalogInputByID(in);
-				} else {
-					/* Input number out of range */
-#ifdef ANALOGINPUT_DEBUG
-					printf("[Analog Input] The requested input number is invalid.\n\r");
-#endif
-					retval = ERR_AIN_INPUT_OUTOFRANGE;
-				}
-				break;
-			}
-			default:
-				retval = ERR_AIN_PARSE_ERROR;
-			}
-		} else {
-			/* Somehow an error happened */
-#ifdef ANALOGINPUT_DEBUG
-			printf("[Analog Input] Unable to locate required key: %s\n\r", REMOVE_ANALOG_INPUT_PARAMS[i]);
-#endif
-			retval = ERR_AIN_PARSE_MISSING_KEY; /* Failed to locate a key */
+bool isAnalogSampleReportable(Analog_Input_t* input, int32_t value, uint64_t timestamp) {
+	if (input->deadband != 0U) {
+		const int64_t change = (int64_t) value - input->lastReported;
+		const uint64_t magnitude = (uint64_t) ((change < 0) ? -change : change);
+		if ((input->reported == true) && (magnitude <= input->deadband)
+				&& ((input->heartbeat == 0U) || ((timestamp - input->lastReportTime) < input->heartbeat))) {
+			return false;
 		}
 	}
+	input->lastReported = value;
+	input->lastReportTime = timestamp;
+	input->reported = true;
+	return true;
+}
+
+/**
+ * Adds a measurement to an analog input's statistics window, closing the window when it is complete. A sample which
+ * falls past the end of a timed window closes it and begins the next one. Only complete windows are reported; any
+ * partial window left when sampling ends is discarded. Called only from the producer side, like StoreAnalogSample().
+ *
+ * @param input Analog_Input_t* The input the measurement belongs to.
+ * @param value int32_t The measured value (ADC Counts).
+ * @param timestamp uint64_t The time of the measurement.
+ * @retval bool FALSE if a completed window had to be dropped because the previous one was not yet written.
+ */
+bool AccumulateAnalogSample(Analog_Input_t* input, int32_t value, uint64_t timestamp) {
+	AnalogStatistics_t* stats = &input->statistics;
+	bool retval = true;
+	if ((stats->count > 0U) && (statisticsPeriod != 0U) && ((timestamp - stats->start) >= statisticsPeriod)) {
+		retval = CloseStatisticsWindow(input);
+	}
+	if (stats->count == 0U) {
+		stats->min = value;
+		stats->max = value;
+		stats->sum = 0;
+		stats->sumSquares = 0U;
+		stats->start = timestamp;
+	} else if (value < stats->min) {
+		stats->min = value;
+	} else if (value > stats->max) {
+		stats->max = value;
+	}
+	stats->sum += value;
+	stats->sumSquares += (uint64_t) ((int64_t) value * value);
+	stats->end = timestamp;
+	++(stats->count);
+	if (((statisticsWindow != 0U) && (stats->count >= statisticsWindow)) || (stats->count >= ANALOG_STATISTICS_MAX_COUNT)) {
+		retval = CloseStatisticsWindow(input) && retval;
+	}
 	return retval;
 }
 
 /**
- * Retrieve an analog input structure by specifying the physical input channel.
+ * Writes the data for an analog input in the selected data format. See WriteAnalogInput().
  *
- * @param number uint8_t The physical input channel to retrieve.
- * @retval Analog_Input_t* Pointer to the analog input structure.
+ * @param input Analog_Input_t* Pointer to the data structure to write out.
+ * @retval WriteStatus_t The result of the write. WRITE_OK is also returned when there was nothing to write.
  */
-Analog_Input_t* GetAnalogInputByNumber(uint8_t number) {
-	if (isExternalInput(number)) {
-		return &Ext_AInputs[number];
-	} else if (isInternalInput(number)) {
-		return &Int_AInputs[number - (NUM_EXT_ANALOG_INPUTS + NUM_CAL_ANALOG_INPUTS)];
-	} else if (number == EXTERNAL_OFFSET_CAL) {
-		return &Offset_Cal_AInput;
-	} else {
-		/* This is out of range */
+static WriteStatus_t WriteAnalogInputRecord(Analog_Input_t* input) {
+	if (descriptorPending == true) {
+		/* The descriptor goes ahead of the run's first record, CAN frames have no room for one */
+		if (((TelnetGetDataFields() & DATA_FIELD_DESCRIPTOR) != 0U) && (Tekdaqc_CAN_IsStreaming() == FALSE)) {
+			const WriteStatus_t status = WriteStreamDescriptor();
+			if (status == WRITE_BUSY) {
+				return status;
+			}
+		}
+		descriptorPending = false;
+	}
+	if (input->windowReady == true) {
+		return WriteAnalogStatistics(input);
+	}
+	if (Tekdaqc_CAN_IsStreaming() == TRUE) {
+		return WriteAnalogInputCAN(input);
+	}
+	if (TelnetGetDataFormat() == DATA_FORMAT_BINARY) {
+		return WriteAnalogInputBinary(input);
+	}
+	if (writer == 0) {
 #ifdef ANALOGINPUT_DEBUG
-		printf("[Analog Input] Cannot find the requested analog input. Input does not exist on the board.\n\r");
+		printf("[Analog Input] Cannot write analog input to string due to NULL write function.\n\r");
 #endif
-		return NULL ;
+		return WRITE_NOT_CONNECTED;
+	}
+	const uint32_t available = RingBuffer_Count(&input->samples);
+	if (available == 0U) {
+		/* Nothing to write */
+		return WRITE_OK;
+	}
+	/* Samples are batched into TOSTRING_BUFFER so the connection sees a single write */
+	int32_t values[SINGLE_ANALOG_WRITE_COUNT];
+	ReadAnalogSampleValues(input, 0U, SINGLE_ANALOG_WRITE_COUNT, values);
+	uint8_t count = 0;
+	TextChannelState_t state = textChannels[input->physicalInput];
+	const uint8_t fields = TelnetGetDataFields();
+	const ADS1256_PGA_t gain = GetSampleGain(input, GetSampleSequence(input, RingBuffer_PeekIndex(&input->samples, 0U)));
+	uint16_t length = FormatTextHeader(input, &state, gain);
+	/* Leave room for the record separator after the last line. Each line is "timestamp, value, flags, sequence", less
+	 * the fields not selected, formatted directly rather than through snprintf() as this is the hot path of text
+	 * streaming. */
+	while ((count < SINGLE_ANALOG_WRITE_COUNT) && (count < available)
+			&& ((SIZE_TOSTRING_BUFFER - length) > ANALOG_INPUT_MAX_LINE_LENGTH)) {
+		const uint32_t readIdx = RingBuffer_PeekIndex(&input->samples, count);
+		if ((count > 0U) && ((input->flags[readIdx] & ANALOG_SAMPLE_FLAG_RANGE) != 0U)) {
+			/* A sample at a new gain starts a batch of its own, under a header with the gain */
+			break;
+		}
+		char* line = &TOSTRING_BUFFER[length];
+		uint8_t n = 0U;
+		if ((fields & DATA_FIELD_TIMESTAMP) != 0U) {
+			n += Format_UInt64(line, Timer_ToEpochTime(GetSampleTimestamp(input, readIdx)));
+			line[n++] = ',';
+			line[n++] = ' ';
+		}
+		n += Format_Int32(&line[n], values[count]);
+		if ((fields & DATA_FIELD_FLAGS) != 0U) {
+			line[n++] = ',';
+			line[n++] = ' ';
+			n += Format_UInt32(&line[n], input->flags[readIdx]);
+		}
+		if ((fields & DATA_FIELD_SEQUENCE) != 0U) {
+			line[n++] = ',';
+			line[n++] = ' ';
+			n += Format_UInt32(&line[n], GetSampleSequence(input, readIdx));
+		}
+		line[n++] = '\n';
+		line[n++] = '\r';
+		line[n] = '\0';
+		length += n;
+		++count;
+	}
+	TOSTRING_BUFFER[length++] = '\x1E';
+	TOSTRING_BUFFER[length] = '\0';
+	WriteStatus_t status = writer(TOSTRING_BUFFER);
+	if (status == WRITE_OK) {
+		writtenBytes += length;
+		textChannels[input->physicalInput] = state;
+	}
+	if (status != WRITE_BUSY) {
+		/* Either sent or undeliverable, in both cases the samples are consumed */
+		RingBuffer_Release(&input->samples, count);
 	}
+	return status;
 }
 
 /**
  * Writes the data for the provided Analog_Input_t structure to the stream controlled by the WriteFunction, if set.
+ * Up to SINGLE_ANALOG_WRITE_COUNT samples are sent in a single write. If the connection is busy the samples are
+ * left in the input's buffer so the caller can try again later. A completed statistics window is written in place of
+ * samples, in its own write. In the text format only the first batch of an input in each sampling run, or the first
+ * after its settings change, carries the full ANALOG_INPUT_HEADER; later batches carry just the physical input.
  *
  * @param input Analog_Input_t* Pointer to the data structure to write out.
- * @retval none
+ * @retval WriteStatus_t The result of the write. WRITE_OK is also returned when there was nothing to write.
  */
-void WriteAnalogInput(Analog_Input_t* input) {
-	uint8_t count = 0;
-	uint8_t retval;
-	while (count < SINGLE_ANALOG_WRITE_COUNT && input->bufferReadIdx != input->bufferWriteIdx) {
-		/* We have data to print */
-		if (count == 0) {
-			retval = sprintf(TOSTRING_BUFFER, ANALOG_INPUT_HEADER, input->name, input->physicalInput, ADS1256_StringFromPGA(input->gain),
-					ADS1256_StringFromSPS(input->rate), ADS1256_StringFromBuffer(input->buffer));
-			writer(TOSTRING_BUFFER);
+WriteStatus_t WriteAnalogInput(Analog_Input_t* input) {
+	PROFILE_BEGIN();
+	const WriteStatus_t status = WriteAnalogInputRecord(input);
+	PROFILE_END(PROFILE_WRITE_ANALOG_INPUT);
+	return status;
+}
+
+/**
+ * Writes the next codes of a burst capture as a single capture record, see the framing description at the top of this
+ * file. The codes are sent as they were stored, three bytes each, least significant first. If the connection is busy
+ * nothing is consumed and the caller can try again later.
+ *
+ * @param input PhysicalAnalogInput_t The input which was captured.
+ * @param index uint32_t The index within the capture of the first code.
+ * @param values const uint8_t* The stored codes, starting with the one at index.
+ * @param count uint32_t The number of codes left to send from values.
+ * @param written uint32_t* Set to the number of codes which were sent, up to ANALOG_BINARY_CAPTURE_COUNT.
+ * @retval WriteStatus_t The result of writing the frame.
+ */
+WriteStatus_t WriteAnalogCaptureBinary(PhysicalAnalogInput_t input, uint32_t index, const uint8_t* values, uint32_t count,
+		uint32_t* written) {
+	*written = 0U;
+	if (binaryWriter == 0) {
+		return WRITE_NOT_CONNECTED;
+	}
+	const uint32_t run = (count < ANALOG_BINARY_CAPTURE_COUNT) ? count : ANALOG_BINARY_CAPTURE_COUNT;
+	uint16_t length = ANALOG_BINARY_FRAME_HEADER_SIZE;
+	binaryFrame[length++] = ANALOG_BINARY_CAPTURE_RECORD;
+	binaryFrame[length++] = (uint8_t) input;
+	length += PackLittleEndian(&binaryFrame[length], index, 4U);
+	length += PackLittleEndian(&binaryFrame[length], run, 2U);
+	memcpy(&binaryFrame[length], values, run * ANALOG_SAMPLE_VALUE_SIZE);
+	length += (uint16_t) (run * ANALOG_SAMPLE_VALUE_SIZE);
+	binaryFrame[0] = ANALOG_BINARY_FRAME_START;
+	PackLittleEndian(&binaryFrame[1], length - ANALOG_BINARY_FRAME_HEADER_SIZE, 2U);
+	const WriteStatus_t status = binaryWriter(binaryFrame, length);
+	if (status == WRITE_OK) {
+		writtenBytes += length;
+		*written = run;
+	}
+	return status;
+}
+
+/**
+ * Writes the next bins of a spectrum as a single spectrum record, see the framing description at the top of this
+ * file. If the connection is busy nothing is consumed and the caller can try again later.
+ *
+ * @param input PhysicalAnalogInput_t The input the spectrum is of.
+ * @param points uint16_t The number of points of the FFT the spectrum was computed with.
+ * @param bin uint16_t The number of the first bin.
+ * @param amplitudes const float* The amplitudes of the bins, starting with the one at bin.
+ * @param count uint16_t The number of bins left to send from amplitudes.
+ * @param written uint16_t* Set to the number of bins which were sent, up to ANALOG_BINARY_SPECTRUM_COUNT.
+ * @retval WriteStatus_t The result of writing the frame.
+ */
+WriteStatus_t WriteAnalogSpectrumBinary(PhysicalAnalogInput_t input, uint16_t points, uint16_t bin, const float* amplitudes,
+		uint16_t count, uint16_t* written) {
+	*written = 0U;
+	if (binaryWriter == 0) {
+		return WRITE_NOT_CONNECTED;
+	}
+	const uint16_t run = (count < ANALOG_BINARY_SPECTRUM_COUNT) ? count : (uint16_t) ANALOG_BINARY_SPECTRUM_COUNT;
+	uint16_t length = ANALOG_BINARY_FRAME_HEADER_SIZE;
+	binaryFrame[length++] = ANALOG_BINARY_SPECTRUM_RECORD;
+	binaryFrame[length++] = (uint8_t) input;
+	length += PackLittleEndian(&binaryFrame[length], points, 2U);
+	length += PackLittleEndian(&binaryFrame[length], bin, 2U);
+	length += PackLittleEndian(&binaryFrame[length], run, 2U);
+	/* The processor is little endian, so the floats are copied as they are */
+	memcpy(&binaryFrame[length], amplitudes, run * ANALOG_BINARY_AMPLITUDE_SIZE);
+	length += (uint16_t) (run * ANALOG_BINARY_AMPLITUDE_SIZE);
+	binaryFrame[0] = ANALOG_BINARY_FRAME_START;
+	PackLittleEndian(&binaryFrame[1], length - ANALOG_BINARY_FRAME_HEADER_SIZE, 2U);
+	const WriteStatus_t status = binaryWriter(binaryFrame, length);
+	if (status == WRITE_OK) {
+		writtenBytes += length;
+		*written = run;
+	}
+	return status;
+}
+
+/**
+ * Writes the results of a power channel's window, as a power record in its own frame in binary format, see the
+ * framing description at the top of this file, or as a text record otherwise. The values are rounded to whole ADC
+ * codes for text.
+ *
+ * @param result const AnalogPowerResult_t* Pointer/Reference to the results to write.
+ * @retval WriteStatus_t The result of writing the window.
+ */
+WriteStatus_t WriteAnalogPowerResult(const AnalogPowerResult_t* result) {
+	const uint64_t duration = result->end - result->start;
+	uint16_t length;
+	WriteStatus_t status;
+	if (TelnetGetDataFormat() == DATA_FORMAT_BINARY) {
+		if (binaryWriter == 0) {
+			return WRITE_NOT_CONNECTED;
 		}
-		retval = sprintf(TOSTRING_BUFFER, "%" PRIu64 ", %" PRIi32 "\n\r", input->timestamps[input->bufferReadIdx],
-				input->values[input->bufferReadIdx]);
-		input->bufferReadIdx = (input->bufferReadIdx + 1) % ANALOG_INPUT_BUFFER_SIZE;
-		if (retval >= 0) {
-			if (writer != 0) {
-				writer(TOSTRING_BUFFER);
-			} else {
-#ifdef ANALOGINPUT_DEBUG
-				printf("[Analog Input] Cannot write analog input to string due to NULL write function.\n\r");
-#endif
+		length = ANALOG_BINARY_FRAME_HEADER_SIZE;
+		binaryFrame[length++] = ANALOG_BINARY_POWER_RECORD;
+		binaryFrame[length++] = result->channel;
+		binaryFrame[length++] = (uint8_t) result->voltage;
+		binaryFrame[length++] = (uint8_t) result->current;
+		length += PackLittleEndian(&binaryFrame[length], Timer_ToEpochTime(result->start), 8U);
+		length += PackLittleEndian(&binaryFrame[length], (duration > UINT32_MAX) ? UINT32_MAX : duration, 4U);
+		length += PackLittleEndian(&binaryFrame[length], result->count, 4U);
+		length += PackLittleEndian(&binaryFrame[length], result->cycles, 2U);
+		/* The processor is little endian, so the floats are copied as they are */
+		memcpy(&binaryFrame[length], &result->voltageRms, sizeof(float));
+		length += sizeof(float);
+		memcpy(&binaryFrame[length], &result->currentRms, sizeof(float));
+		length += sizeof(float);
+		memcpy(&binaryFrame[length], &result->power, sizeof(float));
+		length += sizeof(float);
+		memcpy(&binaryFrame[length], &result->powerFactor, sizeof(float));
+		length += sizeof(float);
+		binaryFrame[0] = ANALOG_BINARY_FRAME_START;
+		PackLittleEndian(&binaryFrame[1], length - ANALOG_BINARY_FRAME_HEADER_SIZE, 2U);
+		status = binaryWriter(binaryFrame, length);
+	} else {
+		if (writer == 0) {
+			return WRITE_NOT_CONNECTED;
+		}
+		/* The timestamps are in microseconds */
+		const uint32_t frequency = (duration > 0U) ? (uint32_t) ((result->cycles * 1000000000ULL) / duration) : 0U;
+		int retval = snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER - 1U, ANALOG_POWER_FORMAT, result->channel,
+				(int32_t) result->voltage, (int32_t) result->current, Timer_ToEpochTime(result->start),
+				Timer_ToEpochTime(result->end), result->count, result->cycles, frequency,
+				(int32_t) lroundf(result->voltageRms), (int32_t) lroundf(result->currentRms),
+				(int64_t) llroundf(result->power), (int32_t) lroundf(result->powerFactor * 1000.0f));
+		length = (retval > 0) ? (uint16_t) retval : 0U;
+		TOSTRING_BUFFER[length++] = '\x1E';
+		TOSTRING_BUFFER[length] = '\0';
+		status = writer(TOSTRING_BUFFER);
+	}
+	if (status == WRITE_OK) {
+		writtenBytes += length;
+	}
+	return status;
+}
+
+/**
+ * Writes math channel results, as math records packed into one frame in binary format, see the framing description
+ * at the top of this file, or a single text record otherwise.
+ *
+ * @param results const AnalogMathResult_t* Pointer/Reference to the results to write.
+ * @param count uint32_t The number of results, at least 1.
+ * @param written uint32_t* Set to the number of results written if the write succeeds.
+ * @retval WriteStatus_t The result of writing the results.
+ */
+WriteStatus_t WriteAnalogMathResults(const AnalogMathResult_t* results, uint32_t count, uint32_t* written) {
+	uint16_t length;
+	uint32_t run;
+	WriteStatus_t status;
+	if (TelnetGetDataFormat() == DATA_FORMAT_BINARY) {
+		if (binaryWriter == 0) {
+			return WRITE_NOT_CONNECTED;
+		}
+		const uint32_t fit = (ANALOG_BINARY_BUFFER_SIZE - ANALOG_BINARY_FRAME_HEADER_SIZE) / ANALOG_BINARY_MATH_SIZE;
+		run = (count < fit) ? count : fit;
+		length = ANALOG_BINARY_FRAME_HEADER_SIZE;
+		for (uint32_t i = 0U; i < run; ++i) {
+			binaryFrame[length++] = ANALOG_BINARY_MATH_RECORD;
+			binaryFrame[length++] = results[i].channel;
+			binaryFrame[length++] = results[i].flags;
+			length += PackLittleEndian(&binaryFrame[length], Timer_ToEpochTime(results[i].timestamp), 8U);
+			/* The processor is little endian, so the float is copied as it is */
+			memcpy(&binaryFrame[length], &results[i].value, sizeof(float));
+			length += sizeof(float);
+		}
+		binaryFrame[0] = ANALOG_BINARY_FRAME_START;
+		PackLittleEndian(&binaryFrame[1], length - ANALOG_BINARY_FRAME_HEADER_SIZE, 2U);
+		status = binaryWriter(binaryFrame, length);
+	} else {
+		if (writer == 0) {
+			return WRITE_NOT_CONNECTED;
+		}
+		run = 1U;
+		const int64_t thousandths = llroundf(results->value * 1000.0f);
+		const uint64_t magnitude = (uint64_t) ((thousandths < 0) ? -thousandths : thousandths);
+		int retval = snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER - 1U, ANALOG_MATH_FORMAT, results->channel,
+				(thousandths < 0) ? "-" : "", (uint32_t) (magnitude / 1000U), (uint32_t) (magnitude % 1000U),
+				Timer_ToEpochTime(results->timestamp), results->flags);
+		length = (retval > 0) ? (uint16_t) retval : 0U;
+		TOSTRING_BUFFER[length++] = '\x1E';
+		TOSTRING_BUFFER[length] = '\0';
+		status = writer(TOSTRING_BUFFER);
+	}
+	if (status == WRITE_OK) {
+		writtenBytes += length;
+		*written = run;
+	}
+	return status;
+}
+
+/**
+ * Writes the digital states captured with analog scans, as mixed records packed into one frame in binary format, see
+ * the framing description at the top of this file, or a single text record otherwise.
+ *
+ * @param states const AnalogMixedState_t* Pointer/Reference to the states to write.
+ * @param count uint32_t The number of states, at least 1.
+ * @param written uint32_t* Set to the number of states written if the write succeeds.
+ * @retval WriteStatus_t The result of writing the states.
+ */
+WriteStatus_t WriteAnalogMixedStates(const AnalogMixedState_t* states, uint32_t count, uint32_t* written) {
+	uint16_t length;
+	uint32_t run;
+	WriteStatus_t status;
+	if (TelnetGetDataFormat() == DATA_FORMAT_BINARY) {
+		if (binaryWriter == 0) {
+			return WRITE_NOT_CONNECTED;
+		}
+		const uint32_t fit = (ANALOG_BINARY_BUFFER_SIZE - ANALOG_BINARY_FRAME_HEADER_SIZE) / ANALOG_BINARY_MIXED_SIZE;
+		run = (count < fit) ? count : fit;
+		length = ANALOG_BINARY_FRAME_HEADER_SIZE;
+		for (uint32_t i = 0U; i < run; ++i) {
+			binaryFrame[length++] = ANALOG_BINARY_MIXED_RECORD;
+			length += PackLittleEndian(&binaryFrame[length], Timer_ToEpochTime(states[i].timestamp), 8U);
+			length += PackLittleEndian(&binaryFrame[length], states[i].inputs, 4U);
+			length += PackLittleEndian(&binaryFrame[length], states[i].outputs, 4U);
+		}
+		binaryFrame[0] = ANALOG_BINARY_FRAME_START;
+		PackLittleEndian(&binaryFrame[1], length - ANALOG_BINARY_FRAME_HEADER_SIZE, 2U);
+		status = binaryWriter(binaryFrame, length);
+	} else {
+		if (writer == 0) {
+			return WRITE_NOT_CONNECTED;
+		}
+		run = 1U;
+		int retval = snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER - 1U, ANALOG_MIXED_FORMAT, states->inputs,
+				(uint32_t) states->outputs, Timer_ToEpochTime(states->timestamp));
+		length = (retval > 0) ? (uint16_t) retval : 0U;
+		TOSTRING_BUFFER[length++] = '\x1E';
+		TOSTRING_BUFFER[length] = '\0';
+		status = writer(TOSTRING_BUFFER);
+	}
+	if (status == WRITE_OK) {
+		writtenBytes += length;
+		*written = run;
+	}
+	return status;
+}
+
+/**
+ * Writes the auxiliary readings captured with analog scans, as aux records packed into one frame in binary format, see
+ * the framing description at the top of this file, or a single text record of the readings in millivolts otherwise.
+ * A binary record holds the raw readings, AUX_ANALOG_FULL_SCALE at the ADC reference, in AUX_ANALOG_TABLE order.
+ *
+ * @param states const AnalogAuxState_t* Pointer/Reference to the readings to write.
+ * @param count uint32_t The number of captures, at least 1.
+ * @param written uint32_t* Set to the number of captures written if the write succeeds.
+ * @retval WriteStatus_t The result of writing the readings.
+ */
+WriteStatus_t WriteAnalogAuxStates(const AnalogAuxState_t* states, uint32_t count, uint32_t* written) {
+	uint16_t length;
+	uint32_t run;
+	WriteStatus_t status;
+	if (TelnetGetDataFormat() == DATA_FORMAT_BINARY) {
+		if (binaryWriter == 0) {
+			return WRITE_NOT_CONNECTED;
+		}
+		const uint32_t fit = (ANALOG_BINARY_BUFFER_SIZE - ANALOG_BINARY_FRAME_HEADER_SIZE) / ANALOG_BINARY_AUX_SIZE;
+		run = (count < fit) ? count : fit;
+		length = ANALOG_BINARY_FRAME_HEADER_SIZE;
+		for (uint32_t i = 0U; i < run; ++i) {
+			binaryFrame[length++] = ANALOG_BINARY_AUX_RECORD;
+			length += PackLittleEndian(&binaryFrame[length], Timer_ToEpochTime(states[i].timestamp), 8U);
+			binaryFrame[length++] = NUM_AUX_ANALOG_INPUTS;
+			for (uint_fast8_t input = 0U; input < NUM_AUX_ANALOG_INPUTS; ++input) {
+				length += PackLittleEndian(&binaryFrame[length], states[i].values[input], 2U);
 			}
-		} else {
-#ifdef ANALOGINPUT_DEBUG
-			printf("[Analog Input] Error occurred while writing analog input to string.\n\r");
-#endif
 		}
-		++count;
+		binaryFrame[0] = ANALOG_BINARY_FRAME_START;
+		PackLittleEndian(&binaryFrame[1], length - ANALOG_BINARY_FRAME_HEADER_SIZE, 2U);
+		status = binaryWriter(binaryFrame, length);
+	} else {
+		if (writer == 0) {
+			return WRITE_NOT_CONNECTED;
+		}
+		run = 1U;
+		int retval = snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER - 1U, "\n\rAux Analog: ");
+		length = (retval > 0) ? (uint16_t) retval : 0U;
+		for (uint_fast8_t input = 0U; input < NUM_AUX_ANALOG_INPUTS; ++input) {
+			retval = snprintf(&TOSTRING_BUFFER[length], SIZE_TOSTRING_BUFFER - 1U - length, ANALOG_AUX_FORMAT,
+					AnalogAux_GetName(input), AnalogAux_ToMillivolts(input, states->values[input]));
+			length += (retval > 0) ? (uint16_t) retval : 0U;
+		}
+		retval = snprintf(&TOSTRING_BUFFER[length], SIZE_TOSTRING_BUFFER - 1U - length, "Timestamp: %" PRIu64 "\n\r",
+				Timer_ToEpochTime(states->timestamp));
+		length += (retval > 0) ? (uint16_t) retval : 0U;
+		TOSTRING_BUFFER[length++] = '\x1E';
+		TOSTRING_BUFFER[length] = '\0';
+		status = writer(TOSTRING_BUFFER);
 	}
-	if (writer != 0) {
-		writer("\x1E");
+	if (status == WRITE_OK) {
+		writtenBytes += length;
+		*written = run;
 	}
+	return status;
+}
+
+/**
+ * Retrieves the number of bytes of analog data, samples, statistics and their framing, which the data connection or
+ * CAN bus has accepted since start up. The count wraps, so callers should only use differences of it.
+ *
+ * @param none
+ * @retval uint32_t The number of bytes written.
+ */
+uint32_t GetAnalogInputWrittenBytes(void) {
+	return writtenBytes;
 }
 
 /**
@@ -520,6 +3327,73 @@ void SetAnalogInputWriteFunction(WriteFunction writeFunction) {
 	writer = writeFunction;
 }
 
+/**
+ * Set the function pointer to use when writing binary frames from an analog input to the data connection.
+ *
+ * @param writeFunction BinaryWriteFunction pointer to the desired binary writing function.
+ * @retval none
+ */
+void SetAnalogInputBinaryWriteFunction(BinaryWriteFunction writeFunction) {
+	binaryWriter = writeFunction;
+}
+
+/**
+ * Enables or disables compression of the binary sample frames. See the framing description at the top of this file.
+ *
+ * @param enabled bool TRUE to send runs of samples as packed records where that is smaller.
+ * @retval none
+ */
+void SetAnalogInputCompression(bool enabled) {
+	compressionEnabled = enabled;
+}
+
+/**
+ * Indicates if the binary sample frames are compressed.
+ *
+ * @param none
+ * @retval bool TRUE if runs of samples are sent as packed records where that is smaller.
+ */
+bool isAnalogInputCompressionEnabled(void) {
+	return compressionEnabled;
+}
+
+/**
+ * Retrieves the bytes of binary sample frames sent since the last reset and what they would have been without
+ * compression, from which the compression ratio follows.
+ *
+ * @param sent uint32_t* The location to store the bytes sent.
+ * @param raw uint32_t* The location to store the bytes the frames would have been uncompressed.
+ * @retval none
+ */
+void GetAnalogInputCompressionTotals(uint32_t* sent, uint32_t* raw) {
+	*sent = compressionSentBytes;
+	*raw = compressionRawBytes;
+}
+
+/**
+ * Restarts the totals reported by GetAnalogInputCompressionTotals().
+ *
+ * @param none
+ * @retval none
+ */
+void ResetAnalogInputCompressionTotals(void) {
+	compressionSentBytes = 0U;
+	compressionRawBytes = 0U;
+}
+
+/**
+ * Forgets everything sent to a binary client so that the next frame for each channel starts with a config
+ * record. This should be called whenever a client selects the binary format.
+ *
+ * @param none
+ * @retval none
+ */
+void ResetAnalogInputBinaryFraming(void) {
+	for (uint_fast8_t i = 0U; i < NUM_ANALOG_INPUTS; ++i) {
+		binaryChannels[i].valid = false;
+	}
+}
+
 /**
  * Returns the string representation of an externally muxed analog input.
  *
@@ -527,113 +3401,13 @@ void SetAnalogInputWriteFunction(WriteFunction writeFunction) {
  * @return const char* The string representation.
  */
 const char* ExtAnalogInputToString(ExternalMuxedInput_t input) {
-	static const char* strings[] = { "External 0", "External 1", "External 2", "External 3", "External 4", "External 5", "External 6",
-			"External 7", "External 8", "External 9", "External 10", "External 11", "External 12", "External 13", "External 14",
-			"External 15", "External 16", "External 17", "External 18", "External 19", "External 20", "External 21", "External 22",
-			"External 23", "External 24", "External 25", "External 26", "External 27", "External 28", "External 29", "External 30",
-			"External 31" };
-	const char* retval = NULL;
-	switch (input) {
-	case EXTERN_0:
-		retval = strings[0];
-		break;
-	case EXTERN_1:
-		retval = strings[1];
-		break;
-	case EXTERN_2:
-		retval = strings[2];
-		break;
-	case EXTERN_3:
-		retval = strings[3];
-		break;
-	case EXTERN_4:
-		retval = strings[4];
-		break;
-	case EXTERN_5:
-		retval = strings[5];
-		break;
-	case EXTERN_6:
-		retval = strings[6];
-		break;
-	case EXTERN_7:
-		retval = strings[7];
-		break;
-	case EXTERN_8:
-		retval = strings[8];
-		break;
-	case EXTERN_9:
-		retval = strings[9];
-		break;
-	case EXTERN_10:
-		retval = strings[10];
-		break;
-	case EXTERN_11:
-		retval = strings[11];
-		break;
-	case EXTERN_12:
-		retval = strings[12];
-		break;
-	case EXTERN_13:
-		retval = strings[13];
-		break;
-	case EXTERN_14:
-		retval = strings[14];
-		break;
-	case EXTERN_15:
-		retval = strings[15];
-		break;
-	case EXTERN_16:
-		retval = strings[16];
-		break;
-	case EXTERN_17:
-		retval = strings[17];
-		break;
-	case EXTERN_18:
-		retval = strings[18];
-		break;
-	case EXTERN_19:
-		retval = strings[19];
-		break;
-	case EXTERN_20:
-		retval = strings[20];
-		break;
-	case EXTERN_21:
-		retval = strings[21];
-		break;
-	case EXTERN_22:
-		retval = strings[22];
-		break;
-	case EXTERN_23:
-		retval = strings[23];
-		break;
-	case EXTERN_24:
-		retval = strings[24];
-		break;
-	case EXTERN_25:
-		retval = strings[25];
-		break;
-	case EXTERN_26:
-		retval = strings[26];
-		break;
-	case EXTERN_27:
-		retval = strings[27];
-		break;
-	case EXTERN_28:
-		retval = strings[28];
-		break;
-	case EXTERN_29:
-		retval = strings[29];
-		break;
-	case EXTERN_30:
-		retval = strings[30];
-		break;
-	case EXTERN_31:
-		retval = strings[31];
-		break;
-	default:
-		retval = NULL;
+	static const char* const strings[NUM_EXT_ANALOG_INPUTS] = { EXTERNAL_MUX_TABLE(EXTERNAL_INPUT_NAME) };
+	for (uint_fast8_t i = 0U; i < NUM_EXT_ANALOG_INPUTS; ++i) {
+		if (GetExternalMuxedInputByNumber(i) == input) {
+			return strings[i];
+		}
 	}
-	return retval;
+	return NULL;
 }
 
 /**
@@ -643,24 +3417,9 @@ const char* ExtAnalogInputToString(ExternalMuxedInput_t input) {
  * @retval const char* The string representation.
  */
 const char* IntAnalogInputToString(InternalAnalogInput_t input) {
-	char* str;
-	switch (input) {
-	case SUPPLY_9V:
-		str = "9V SUPPLY";
-		break;
-	case SUPPLY_5V:
-		str = "5V SUPPLY";
-		break;
-	case SUPPLY_3_3V:
-		str = "3.3V SUPPLY";
-		break;
-	case COLD_JUNCTION:
-		str = "COLD JUNCTION";
-		break;
-	case EXTERNAL_ANALOG_IN:
-		str = "EXTERNAL ANALOG INPUT";
-	default:
-		str = "UNKNOWN";
-	}
-	return str;
+	static const char* const strings[] = { INTERNAL_INPUT_TABLE(INTERNAL_INPUT_NAME) };
+	if (input < (sizeof(strings) / sizeof(strings[0]))) {
+		return strings[input];
+	}
+	return "UNKNOWN";
 }
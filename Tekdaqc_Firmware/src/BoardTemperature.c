@@ -16,6 +16,8 @@
  * @brief Source file for the board temperature monitoring system.
  *
  * Contains methods for updating the board's temperature as well as reading current and historical temperatures.
+ * The historical minimum and maximum are tracked in RAM and persisted to the emulated EEPROM by a background job,
+ * so that the sampling path never waits on FLASH programming.
  *
  * @author Jared Woolston (jwoolston@tenkiv.com)
  * @since v1.0.0.0
@@ -31,6 +33,9 @@
 #include "Tekdaqc_BSP.h"
 #include "Tekdaqc_Debug.h"
 #include "eeprom.h"
+#include "Tekdaqc_Timers.h"
+#include "Tekdaqc_Log.h"
+#include <string.h>
 
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE DEFINES */
@@ -43,6 +48,21 @@
  */
 #define LM35_SLOPE	100
 
+/**
+ * @internal
+ * @def BOARD_TEMPERATURE_HYSTERESIS
+ * @brief The distance in degrees C a new extreme must move past the persisted one to be persisted straight away.
+ */
+#define BOARD_TEMPERATURE_HYSTERESIS	0.5f
+
+/**
+ * @internal
+ * @def BOARD_TEMPERATURE_PERSIST_INTERVAL
+ * @brief The minimum time in microseconds between persisting extremes which are within the hysteresis.
+ */
+#define BOARD_TEMPERATURE_PERSIST_INTERVAL	60000000U
+
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE VARIABLES */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -56,20 +76,100 @@ static float max_temp = 0.0f;
 /* The minimum board temperature ever recorded. */
 static float min_temp = 0.0f;
 
-/* The lower 16 bits of the maximum temperature reading. */
-static uint16_t low_max_word;
+/* Have the extremes been read from the EEPROM */
+static bool extremes_loaded = false;
 
-/* The upper 16 bits of the maximum temperature reading. */
-static uint16_t high_max_word;
+/* The maximum board temperature as last persisted. */
+static float persisted_max = 0.0f;
 
-/* The lower 16 bits of the minimum temperature reading. */
-static uint16_t low_min_word;
+/* The minimum board temperature as last persisted. */
+static float persisted_min = 0.0f;
+
+/* The time the extremes were last persisted */
+static uint64_t last_persist = 0U;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Reads a temperature from a pair of EEPROM variables.
+ */
+static bool ReadTemperature(uint16_t high_address, uint16_t low_address, float* value);
+
+/**
+ * @internal
+ * @brief Reads the persisted extremes from the EEPROM.
+ */
+static void LoadExtremes(void);
+
+/**
+ * @internal
+ * @brief Queues a temperature to be written to a pair of EEPROM variables.
+ */
+static void WriteTemperature(uint16_t high_address, uint16_t low_address, float value);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * Reads a temperature from the pair of EEPROM variables holding the upper and lower 16 bits of its float.
+ *
+ * @param high_address uint16_t The address of the upper 16 bits.
+ * @param low_address uint16_t The address of the lower 16 bits.
+ * @param value float* Set to the temperature if both variables exist.
+ * @retval bool TRUE if both variables exist.
+ */
+static bool ReadTemperature(uint16_t high_address, uint16_t low_address, float* value) {
+	uint16_t high = 0U;
+	uint16_t low = 0U;
+	if ((EE_ReadVariable(high_address, &high) != 0U) || (EE_ReadVariable(low_address, &low) != 0U)) {
+		return FALSE;
+	}
+	const uint32_t word = (((uint32_t) high) << 16) | low;
+	memcpy(value, &word, sizeof(*value));
+	return TRUE;
+}
 
-/* The upper 16 bits of the minimum temperature reading. */
-static uint16_t high_min_word;
+/**
+ * @internal
+ * Queues a temperature to be written to the pair of EEPROM variables holding the upper and lower 16 bits of its float.
+ *
+ * @param high_address uint16_t The address of the upper 16 bits.
+ * @param low_address uint16_t The address of the lower 16 bits.
+ * @param value float The temperature.
+ * @retval none
+ */
+static void WriteTemperature(uint16_t high_address, uint16_t low_address, float value) {
+	uint32_t word;
+	memcpy(&word, &value, sizeof(word));
+	EE_QueueWrite(low_address, (uint16_t) (word & 0xFFFF));
+	EE_QueueWrite(high_address, (uint16_t) (word >> 16));
+}
 
-/* Temporary scratch variable */
-static uint32_t scratch;
+/**
+ * @internal
+ * Reads the persisted extremes from the EEPROM. Extremes which have never been persisted start at the current
+ * temperature.
+ *
+ * @param none
+ * @retval none
+ */
+static void LoadExtremes(void) {
+	if (ReadTemperature(ADDR_BOARD_MAX_TEMP_HIGH, ADDR_BOARD_MAX_TEMP_LOW, &max_temp) == FALSE) {
+		max_temp = temperature;
+	}
+	if (ReadTemperature(ADDR_BOARD_MIN_TEMP_HIGH, ADDR_BOARD_MIN_TEMP_LOW, &min_temp) == FALSE) {
+		min_temp = temperature;
+	}
+	persisted_max = max_temp;
+	persisted_min = min_temp;
+	last_persist = GetLocalTime();
+	extremes_loaded = true;
+}
 
 /*--------------------------------------------------------------------------------------------------------*/
 /* PUBLIC FUNCTIONS */
@@ -77,7 +177,7 @@ static uint32_t scratch;
 
 /**
  * Updates the boards internal temperature. This will also check to see if a new minimum or maximum temperature
- * has been reached.
+ * has been reached, which is only recorded in RAM. persistBoardTemperatureExtremes() writes it to the EEPROM.
  *
  * @param input Analog_Input_t* The analog input which took the measurement.
  * @param code int32_t The integer code from the ADC.
@@ -88,39 +188,55 @@ void updateBoardTemperature(Analog_Input_t* input, int32_t code) {
 	if (code < 0)
 		++max; /* Add one for negative range. */
 	temperature = LM35_SLOPE * ((2.0f * V_REFERENCE )/ADS1256_GetGainMultiplier(input->gain))* (((float) code)/max);
-	return;
-#ifdef BOARD_TEMPERATURE_DEBUG
-	printf("[Board Temperature] New board temperature: %f Deg C.\n\r", temperature);
-#endif
-	if (max_temp == 0.0f) {
-		EE_ReadVariable(ADDR_BOARD_MAX_TEMP_HIGH, &high_max_word);
-		EE_ReadVariable(ADDR_BOARD_MAX_TEMP_LOW, &low_max_word);
-		scratch = (((uint32_t) high_max_word) << 16) | low_max_word;
-		max_temp = *(float*) (void*)(&scratch);
+	LOG_TRACE("[Board Temperature] New board temperature: %f Deg C.\n\r", temperature);
+	if (extremes_loaded == false) {
+		/* The extremes are loaded by the background job */
+		return;
 	}
-	if (min_temp == 0.0f) {
-		EE_ReadVariable(ADDR_BOARD_MIN_TEMP_HIGH, &high_min_word);
-		EE_ReadVariable(ADDR_BOARD_MIN_TEMP_LOW, &low_min_word);
-		scratch = (((uint32_t) high_min_word) << 16) | low_min_word;
-		min_temp = *(float*) (void*)(&scratch);
-	}
-
 	if (temperature > max_temp) {
-		printf("[Board Temperature] New board max temperature: %f Deg C.\n\r", temperature);
+		LOG_TRACE("[Board Temperature] New board max temperature: %f Deg C.\n\r", temperature);
 		max_temp = temperature;
-		scratch = *(uint32_t*) (void*)(&temperature);
-		EE_WriteVariable(ADDR_BOARD_MAX_TEMP_LOW, (uint16_t) (scratch & 0xFFFF));
-		EE_WriteVariable(ADDR_BOARD_MAX_TEMP_HIGH, (uint16_t) (scratch >> 16));
 	}
 	if (temperature < min_temp) {
-		printf("[Board Temperature] New board min temperature: %f Deg C.\n\r", temperature);
+		LOG_TRACE("[Board Temperature] New board min temperature: %f Deg C.\n\r", temperature);
 		min_temp = temperature;
-		scratch = *(uint32_t*) (void*)(&temperature);
-		EE_WriteVariable(ADDR_BOARD_MIN_TEMP_LOW, (uint16_t) (scratch & 0xFFFF));
-		EE_WriteVariable(ADDR_BOARD_MIN_TEMP_HIGH, (uint16_t) (scratch >> 16));
 	}
 }
 
+/**
+ * Persists the board temperature extremes to the emulated EEPROM's write queue, which programs them in the
+ * background. New extremes are persisted as soon as they move BOARD_TEMPERATURE_HYSTERESIS past the persisted ones,
+ * and otherwise at most once per BOARD_TEMPERATURE_PERSIST_INTERVAL, which avoids a write for every sample while
+ * the board warms up. Intended to be called periodically from a background task.
+ *
+ * @param none
+ * @retval none
+ */
+void persistBoardTemperatureExtremes(void) {
+	if (extremes_loaded == false) {
+		LoadExtremes();
+		return;
+	}
+	if ((max_temp == persisted_max) && (min_temp == persisted_min)) {
+		return;
+	}
+	const bool moved = ((max_temp - persisted_max) >= BOARD_TEMPERATURE_HYSTERESIS)
+			|| ((persisted_min - min_temp) >= BOARD_TEMPERATURE_HYSTERESIS);
+	const uint64_t now = GetLocalTime();
+	if ((moved == false) && ((now - last_persist) < BOARD_TEMPERATURE_PERSIST_INTERVAL)) {
+		return;
+	}
+	if (max_temp != persisted_max) {
+		WriteTemperature(ADDR_BOARD_MAX_TEMP_HIGH, ADDR_BOARD_MAX_TEMP_LOW, max_temp);
+		persisted_max = max_temp;
+	}
+	if (min_temp != persisted_min) {
+		WriteTemperature(ADDR_BOARD_MIN_TEMP_HIGH, ADDR_BOARD_MIN_TEMP_LOW, min_temp);
+		persisted_min = min_temp;
+	}
+	last_persist = now;
+}
+
 /**
  * Retrieves the board's most current temperature reading.
  *
@@ -138,11 +254,8 @@ float getBoardTemperature(void) {
  * @retval float The maximum temperature in degrees C.
  */
 float getMaximumBoardTemperature(void) {
-	if (max_temp == 0.0f) {
-		EE_ReadVariable(ADDR_BOARD_MAX_TEMP_HIGH, &high_max_word);
-		EE_ReadVariable(ADDR_BOARD_MAX_TEMP_LOW, &low_max_word);
-		scratch = (((uint32_t) high_max_word) << 16) | low_max_word;
-		max_temp = *(float*) (void*)(&scratch);
+	if (extremes_loaded == false) {
+		LoadExtremes();
 	}
 	return max_temp;
 }
@@ -154,11 +267,8 @@ float getMaximumBoardTemperature(void) {
  * @retval float The minimum temperature in degrees C.
  */
 float getMinimumBoardTemperature(void) {
-	if (min_temp == 0.0f) {
-		EE_ReadVariable(ADDR_BOARD_MIN_TEMP_HIGH, &high_min_word);
-		EE_ReadVariable(ADDR_BOARD_MIN_TEMP_LOW, &low_min_word);
-		scratch = (((uint32_t) high_min_word) << 16) | low_min_word;
-		min_temp = *(float*) (void*)(&scratch);
+	if (extremes_loaded == false) {
+		LoadExtremes();
 	}
 	return min_temp;
 }
@@ -32,7 +32,10 @@
 #include "ADC_StateMachine.h"
 #include "DI_StateMachine.h"
 #include "DO_StateMachine.h"
+#include "Digital_Output.h"
 #include "TLE7232_RelayDriver.h"
+#include "Tekdaqc_Log.h"
+#include "TelnetServer.h"
 
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE DEFINES */
@@ -139,13 +142,15 @@ void ServiceTasks(void) {
 
 /**
  * Halt the current activity of the command state machine and return to the idle state. This can be used
- * to interrupt long term or continuous tasks.
+ * to interrupt long term or continuous tasks. Analog sampling stops converting at once; its samples which have not
+ * been written are either written out as it completes or, with discard, dropped along with all of the data still
+ * waiting in the Telnet transmit buffers, so the board is idle straight away.
  *
- * @param none
+ * @param discard bool TRUE to drop any data which has not been sent rather than send it.
  * @retval none
  */
-void HaltTasks(void) {
-	printf("[Command State] Halting all tasks.\n\r");
+void HaltTasks(bool discard) {
+	LOG_DEBUG("[Command State] Halting all tasks.\n\r");
 	switch (CurrentState) {
 	case UNINITIALIZED:
 		/* There is nothing to halt */
@@ -154,32 +159,37 @@ void HaltTasks(void) {
 		/* There is nothing to halt */
 		break;
 	case STATE_ANALOG_INPUT_SAMPLE:
-		printf("[Command State] Halting analog input sampling.\n\r");
-		ADC_Machine_Halt();
+		LOG_DEBUG("[Command State] Halting analog input sampling.\n\r");
+		ADC_Machine_Halt(discard);
 		CurrentState = STATE_IDLE;
 		break;
 	case STATE_DIGITAL_INPUT_SAMPLE:
-		printf("[Command State] Halting digital input sampling.\n\r");
+		LOG_DEBUG("[Command State] Halting digital input sampling.\n\r");
 		DI_Machine_Halt();
 		CurrentState = STATE_IDLE;
 		break;
 	case STATE_DIGITAL_OUTPUT_SAMPLE:
-		printf("[Command State] Halting digital output sampling.\n\r");
+		LOG_DEBUG("[Command State] Halting digital output sampling.\n\r");
 		DO_Machine_Halt();
 		CurrentState = STATE_IDLE;
 		break;
 	case STATE_GENERAL_SAMPLE:
-		printf("[Command State] Halting all sampling.\n\r");
-		ADC_Machine_Halt();
+		LOG_DEBUG("[Command State] Halting all sampling.\n\r");
+		ADC_Machine_Halt(discard);
 		DI_Machine_Halt();
 		DO_Machine_Halt();
 		CurrentState = STATE_IDLE;
 		break;
 	default:
-		printf("[Command State] Halt tasks called while in an unknown command state.");
+		LOG_WARNING("[Command State] Halt tasks called while in an unknown command state.\n\r");
 		/* TODO: Throw error */
 		break;
 	}
+	/* A playing output sequence is stopped as well, leaving its outputs where they are */
+	StopDigitalOutputSequence();
+	if (discard == true) {
+		TelnetDiscardPending();
+	}
 }
 
 /**
@@ -28,8 +28,13 @@
 
 #include "Tekdaqc_Debug.h"
 #include "DI_StateMachine.h"
+#include "DigitalInput_Edge.h"
 #include "CommandState.h"
 #include "TelnetServer.h"
+#include "Tekdaqc_Timers.h"
+#include "Tekdaqc_StateTrace.h"
+#include "stm32f4xx.h"
+#include <inttypes.h>
 
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE DEFINES */
@@ -48,15 +53,36 @@ static uint32_t SampleTotal;
 /* The current sample number. */
 static uint32_t SampleCurrent;
 
-/* List of inputs to sample. */
+/* List of inputs to sample, compacted so it holds no NULL entries. */
 static Digital_Input_t** samplingInputs;
 
+/* The inputs of a multi-channel sampling in input number order, the first numberSamplingInputs entries being used. */
+static Digital_Input_t* scanInputs[NUM_DIGITAL_INPUTS];
+
 /* Length of list. */
 static uint8_t numberSamplingInputs = 0U;
 
+/* Flag indicating a single input is being sampled rather than a set. */
+static bool singleSampling = false;
+
 /* The current input to sample */
 static uint8_t currentSamplingInput = 0U;
 
+/* The time in microseconds between samples */
+static uint32_t samplePeriod = 1000000U / DI_DEFAULT_SAMPLE_RATE_HZ;
+
+/* The time in microseconds between pulse counter reports */
+static uint32_t counterPeriod = DI_DEFAULT_COUNTER_INTERVAL_MS * 1000U;
+
+/* The local time at which the next sample is due */
+static uint64_t nextSampleTime = 0U;
+
+/* Set by the sample deadline once the next sample is due */
+static volatile bool sampleDue = false;
+
+/* TRUE if the edges of the sampled inputs are latched between scans */
+static bool latchEnabled = false;
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE FUNCTION PROTOTYPES */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -66,6 +92,26 @@ static uint8_t currentSamplingInput = 0U;
  */
 static inline const char* DIMachine_StringFromState(DI_State_t state);
 
+/*
+ * @brief Changes the state of the machine, recording the transition in the state trace.
+ */
+static inline void DI_Machine_EnterState(DI_State_t newState);
+
+/*
+ * @brief Deadline callback made when the next sample is due.
+ */
+static void DI_Machine_SampleDue(void);
+
+/*
+ * @brief Schedules the deadline of the sample after the one just taken.
+ */
+static void ScheduleNextSample(uint32_t period);
+
+/*
+ * @brief Builds the compacted list of inputs for a multi-channel sampling.
+ */
+static uint8_t BuildScanInputs(Digital_Input_t** inputs);
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE FUNCTIONS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -78,10 +124,84 @@ static inline const char* DIMachine_StringFromState(DI_State_t state);
  */
 static inline const char* DIMachine_StringFromState(DI_State_t state) {
 	static const char* strings[] = { "DI_UNINITIALIZED", "DI_INITIALIZED", "DI_IDLE",
-			"DI_CHANNEL_SAMPLING", "DI_RESET" };
+			"DI_CHANNEL_SAMPLING", "DI_EDGE_CAPTURE", "DI_COUNTING", "DI_RESET" };
 	return strings[state];
 }
 
+/**
+ * Changes the state of the machine, recording the transition in the state trace.
+ *
+ * @param newState DI_State_t The state to enter.
+ * @retval none
+ */
+static inline void DI_Machine_EnterState(DI_State_t newState) {
+	state = newState;
+	StateTrace_Record(STATE_TRACE_DI, (uint8_t) newState, 0U);
+}
+
+/**
+ * Deadline callback made when the next sample is due.
+ *
+ * @param none
+ * @retval none
+ */
+static void DI_Machine_SampleDue(void) {
+	sampleDue = true;
+}
+
+/**
+ * Schedules the deadline of the sample after the one just taken. Samples are kept on a fixed cadence from the
+ * start of sampling; if sampling has fallen a full period behind, the missed samples are skipped rather than
+ * taken in a burst. Pulse counter reports use the same cadence.
+ *
+ * @param period uint32_t The time in microseconds between samples.
+ * @retval none
+ */
+static void ScheduleNextSample(uint32_t period) {
+	const uint64_t now = GetLocalTime();
+	nextSampleTime += period;
+	if (nextSampleTime <= now) {
+		nextSampleTime = now + period;
+	}
+	sampleDue = false;
+	if (Timer_ScheduleDeadline(DI_Machine_SampleDue, (uint32_t) (nextSampleTime - now)) == false) {
+		/* Without a deadline, sample on the next pass */
+		sampleDue = true;
+	}
+}
+
+/**
+ * Builds the list of inputs a multi-channel sampling visits. The requested inputs are gathered into a bitmask, which
+ * drops any listed twice, and the set bits are then walked lowest first, each step finding the next with a single
+ * count leading zeros, to fill scanInputs with no NULL entries. Sampling a scan is then a walk of exactly the inputs in
+ * it.
+ *
+ * @param inputs Digital_Input_t** The requested input list, NUM_DIGITAL_INPUTS long. NULL entries are skipped.
+ * @retval uint8_t The number of inputs in the list.
+ */
+static uint8_t BuildScanInputs(Digital_Input_t** inputs) {
+	Digital_Input_t* byNumber[NUM_DIGITAL_INPUTS];
+	uint32_t mask = 0U;
+	for (uint_fast8_t i = 0U; i < NUM_DIGITAL_INPUTS; ++i) {
+		Digital_Input_t* input = inputs[i];
+		if ((input != NULL) && (input->input < NUM_DIGITAL_INPUTS)) {
+			mask |= (1UL << input->input);
+			byNumber[input->input] = input;
+		}
+	}
+	uint8_t length = 0U;
+	while (mask != 0U) {
+		/* The reversed word's leading zeros are the original's trailing zeros, the number of the lowest input left */
+		const uint_fast8_t number = __CLZ(__RBIT(mask));
+		scanInputs[length++] = byNumber[number];
+		mask &= (mask - 1U);
+	}
+	for (uint_fast8_t i = length; i < NUM_DIGITAL_INPUTS; ++i) {
+		scanInputs[i] = NULL;
+	}
+	return length;
+}
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* INITIALIZATION METHODS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -96,7 +216,7 @@ void DI_Machine_Create(void) {
 #ifdef DI_STATE_MACHINE_DEBUG
 	printf("[DI STATE MACHINE] Creating DI state machine.\n\r");
 #endif
-	state = DI_UNINITIALIZED;
+	DI_Machine_EnterState(DI_UNINITIALIZED);
 }
 
 /**
@@ -124,7 +244,7 @@ void DI_Machine_Init(void) {
 	numberSamplingInputs = 0U;
 
 	/* Update the state */
-	state = DI_INITIALIZED;
+	DI_Machine_EnterState(DI_INITIALIZED);
 }
 
 /*--------------------------------------------------------------------------------------------------------*/
@@ -150,21 +270,23 @@ void DI_Machine_Service(void) {
 		/* We don't need to do anything, just let it run */
 		break;
 	case DI_CHANNEL_SAMPLING: {
-		Digital_Input_t* input = NULL;
 		if (SampleCurrent < SampleTotal) {
-			if (numberSamplingInputs == 1) {
+			if (sampleDue == false) {
+				/* Wait for the next sample period */
+				break;
+			}
+			if (singleSampling == true) {
 				SampleDigitalInput(samplingInputs[0]);
-				WriteDigitalInput(samplingInputs[0]);
-				++SampleCurrent;
-			} else {
-				for (uint_fast8_t i = 0; i < NUM_DIGITAL_INPUTS; ++i) {
-					input = samplingInputs[i];
-					if (input != NULL) {
-						SampleDigitalInput(input);
-						WriteDigitalInput(input);
-					}
+				if (WriteDigitalInputScan(samplingInputs, 1U) != WRITE_BUSY) {
+					/* A busy connection leaves this sample to be retaken on the next pass */
+					++SampleCurrent;
+					ScheduleNextSample(samplePeriod);
 				}
+			} else {
+				SampleDigitalInputs(samplingInputs, numberSamplingInputs);
+				WriteDigitalInputScan(samplingInputs, numberSamplingInputs);
 				++SampleCurrent;
+				ScheduleNextSample(samplePeriod);
 			}
 		} else {
 			/* Sampling has completed. */
@@ -177,6 +299,17 @@ void DI_Machine_Service(void) {
 		}
 	}
 	break;
+	case DI_EDGE_CAPTURE:
+		/* Transitions are logged by the EXTI interrupts, write out any which have been */
+		DigitalEdge_Service();
+		break;
+	case DI_COUNTING:
+		/* Edges are counted by the EXTI interrupts, report them once per interval */
+		if (sampleDue == true) {
+			DigitalEdge_WriteCounters();
+			ScheduleNextSample(counterPeriod);
+		}
+		break;
 	case DI_RESET:
 		SampleCurrent = 0U;
 		SampleTotal = 0U;
@@ -205,6 +338,44 @@ void DI_Machine_Halt(void) {
 	CompletedDISampling();
 }
 
+/**
+ * Sets the rate at which digital input sampling takes samples. This takes effect from the next sample.
+ *
+ * @param rate uint32_t The sample rate in Hz, between 1 and DI_MAX_SAMPLE_RATE_HZ.
+ * @retval bool True if the rate was valid and has been set.
+ */
+bool DI_Machine_SetSampleRate(uint32_t rate) {
+	if ((rate == 0U) || (rate > DI_MAX_SAMPLE_RATE_HZ)) {
+#ifdef DI_STATE_MACHINE_DEBUG
+		printf("[DI STATE MACHINE] Invalid sample rate of %" PRIu32 " Hz.\n\r", rate);
+#endif
+		return false;
+	}
+	samplePeriod = 1000000U / rate;
+	return true;
+}
+
+/**
+ * Turns pulse latching of the sampled inputs on or off. While it is on, each sampling routes its inputs to their EXTI
+ * lines, which catch any edge between scans for the next scan to report. This takes effect from the next sampling.
+ *
+ * @param enable bool TRUE to latch the edges of the sampled inputs.
+ * @retval none
+ */
+void DI_Machine_SetLatch(bool enable) {
+	latchEnabled = enable;
+}
+
+/**
+ * Checks if pulse latching of the sampled inputs is on.
+ *
+ * @param none
+ * @retval bool TRUE if the edges of the sampled inputs are latched between scans.
+ */
+bool DI_Machine_GetLatch(void) {
+	return latchEnabled;
+}
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* STATE METHODS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -217,7 +388,8 @@ void DI_Machine_Halt(void) {
  */
 void DI_Machine_Idle(void) {
 	/* We use explicit checking here in case other state are added later */
-	if ((state != DI_INITIALIZED) && (state != DI_CHANNEL_SAMPLING)) {
+	if ((state != DI_INITIALIZED) && (state != DI_CHANNEL_SAMPLING) && (state != DI_EDGE_CAPTURE)
+			&& (state != DI_COUNTING)) {
 		/* We can only enter this state from these states */
 #ifdef DI_STATE_MACHINE_DEBUG
 		printf("[DI STATE MACHINE] Attempted to enter DI_IDLE state from %s\n\r", DIMachine_StringFromState(state));
@@ -227,7 +399,18 @@ void DI_Machine_Idle(void) {
 #ifdef DI_STATE_MACHINE_DEBUG
 	printf("[DI STATE MACHINE] Moving to state DI_IDLE.\n\r");
 #endif
-	state = DI_IDLE;
+	if (state == DI_EDGE_CAPTURE) {
+#ifdef DI_STATE_MACHINE_DEBUG
+		printf("[DI STATE MACHINE] Edge capture dropped %" PRIu32 " transitions.\n\r", DigitalEdge_GetOverflowCount());
+#endif
+		DigitalEdge_Stop();
+	} else if ((state == DI_COUNTING) || (state == DI_CHANNEL_SAMPLING)) {
+		/* Channel sampling may be latching pulses */
+		DigitalEdge_Stop();
+	}
+	Timer_CancelDeadline(DI_Machine_SampleDue);
+	sampleDue = false;
+	DI_Machine_EnterState(DI_IDLE);
 }
 
 /**
@@ -262,43 +445,96 @@ void DI_Machine_Input_Sample(Digital_Input_t** inputs, uint32_t count, bool sing
 			return;
 		}
 		/* Select input */
-		currentSamplingInput = 0; /* Use i here so we don't loose any work from the search earlier */
+		currentSamplingInput = 0;
 		numberSamplingInputs = 1;
 	} else {
-		/* Validate the input(s) */
-		uint8_t i = 0U;
-		for (; i < NUM_DIGITAL_INPUTS; ++i) {
-			if (inputs[i] != NULL) {
-				break;
-			}
-		}
-		if (i >= NUM_DIGITAL_INPUTS) {
+		/* Validate the input(s) and gather them into a list without gaps */
+		const uint8_t length = BuildScanInputs(inputs);
+		if (length == 0U) {
 #ifdef DI_STATE_MACHINE_DEBUG
 			printf("[DI STATE MACHINE] Attempted to enter DI_CHANNEL_SAMPLING state with NULL digital inputs. Ignoring...\n\r");
 #endif
 			return;
 		}
 		/* Select input */
-		currentSamplingInput = i; /* Use i here so we don't loose any work from the search earlier */
-		numberSamplingInputs = NUM_DIGITAL_INPUTS;
+		currentSamplingInput = 0U;
+		numberSamplingInputs = length;
+		inputs = scanInputs;
 	}
 
 	/* Select input */
 	samplingInputs = inputs;
-	uint8_t i = 0U;
-	Digital_Input_t* input = samplingInputs[currentSamplingInput];
-	while (input == NULL) { /* Keep searching until we find a non-null input */
-		input = samplingInputs[++i];
-		if (i == NUM_DIGITAL_INPUTS) {
-			/* We have reached the end of a set */
-			/* There is nothing to sample */
-			return;
+	singleSampling = singleChannel;
+	if (latchEnabled == true) {
+		Digital_Input_t* latchInputs[NUM_DIGITAL_INPUTS];
+		for (uint_fast8_t i = 0U; i < NUM_DIGITAL_INPUTS; ++i) {
+			latchInputs[i] = (i < numberSamplingInputs) ? inputs[i] : NULL;
+		}
+		if (DigitalEdge_Start(latchInputs, DIGITAL_EDGE_LATCH) == false) {
+			/* Sampling still goes ahead, only without the latch */
+			TelnetWriteStatusMessage("DI pulse latching is not available for these inputs.");
 		}
 	}
 	/* Save current time and sample count */
 	SampleCurrent = 0U;
 	SampleTotal = count;
-	state = DI_CHANNEL_SAMPLING;
+	nextSampleTime = GetLocalTime();
+	sampleDue = true; /* The first sample is taken immediately */
+	DI_Machine_EnterState(DI_CHANNEL_SAMPLING);
+}
+
+/**
+ * Enter the edge capture state. In this state the DI will stream each transition of a set of inputs, timestamped by
+ * its EXTI interrupt, until halted.
+ *
+ * @param inputs Digital_Input_t** List of NUM_DIGITAL_INPUTS inputs to capture. NULL entries are skipped.
+ * @retval bool FALSE if the state could not be entered or the inputs cannot be captured together.
+ */
+bool DI_Machine_Edge_Capture(Digital_Input_t** inputs) {
+	if (state != DI_IDLE) {
+#ifdef DI_STATE_MACHINE_DEBUG
+		printf("[DI STATE MACHINE] Attempted to enter DI_EDGE_CAPTURE state from %s\n\r", DIMachine_StringFromState(state));
+#endif
+		return false;
+	}
+	if ((inputs == NULL) || (DigitalEdge_Start(inputs, DIGITAL_EDGE_LOG) == false)) {
+#ifdef DI_STATE_MACHINE_DEBUG
+		printf("[DI STATE MACHINE] Attempted to enter DI_EDGE_CAPTURE state with inputs which cannot be captured. Ignoring...\n\r");
+#endif
+		return false;
+	}
+	DI_Machine_EnterState(DI_EDGE_CAPTURE);
+	return true;
+}
+
+/**
+ * Enter the pulse counting state. In this state the DI will count the rising edges of a set of inputs in their EXTI
+ * interrupts and report the count, frequency and period of each once per interval, until halted.
+ *
+ * @param inputs Digital_Input_t** List of NUM_DIGITAL_INPUTS inputs to count. NULL entries are skipped.
+ * @param interval uint32_t The time between reports in milliseconds, between 1 and DI_MAX_COUNTER_INTERVAL_MS.
+ * @retval bool FALSE if the state could not be entered, the interval is invalid or the inputs cannot be counted
+ * together.
+ */
+bool DI_Machine_Count(Digital_Input_t** inputs, uint32_t interval) {
+	if (state != DI_IDLE) {
+#ifdef DI_STATE_MACHINE_DEBUG
+		printf("[DI STATE MACHINE] Attempted to enter DI_COUNTING state from %s\n\r", DIMachine_StringFromState(state));
+#endif
+		return false;
+	}
+	if ((interval == 0U) || (interval > DI_MAX_COUNTER_INTERVAL_MS) || (inputs == NULL)
+			|| (DigitalEdge_Start(inputs, DIGITAL_EDGE_COUNT) == false)) {
+#ifdef DI_STATE_MACHINE_DEBUG
+		printf("[DI STATE MACHINE] Attempted to enter DI_COUNTING state with inputs which cannot be counted. Ignoring...\n\r");
+#endif
+		return false;
+	}
+	counterPeriod = interval * 1000U;
+	nextSampleTime = GetLocalTime();
+	DI_Machine_EnterState(DI_COUNTING);
+	ScheduleNextSample(counterPeriod);
+	return true;
 }
 
 /**
@@ -310,11 +546,11 @@ void DI_Machine_Input_Sample(Digital_Input_t** inputs, uint32_t count, bool sing
 void DI_Machine_Reset(void) {
 	/* We use explicit checking here in case other state are added later */
 	if ((state != DI_IDLE) && (state != DI_INITIALIZED) && (state != DI_CHANNEL_SAMPLING)
-			&& (state != DI_RESET)) {
+			&& (state != DI_EDGE_CAPTURE) && (state != DI_COUNTING) && (state != DI_RESET)) {
 #ifdef DI_STATE_MACHINE_DEBUG
 		printf("[DI STATE MACHINE] Attempted to enter DI_RESET state from %s\n\r", DIMachine_StringFromState(state));
 #endif
 		return;
 	}
-	state = DI_RESET;
+	DI_Machine_EnterState(DI_RESET);
 }
@@ -31,6 +31,8 @@
 #include "TLE7232_RelayDriver.h"
 #include "TelnetServer.h"
 #include "CommandState.h"
+#include "Tekdaqc_Timers.h"
+#include "Tekdaqc_StateTrace.h"
 
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE DEFINES */
@@ -58,6 +60,18 @@ static uint8_t numberSamplingOutputs = 0U;
 /* The current input to sample */
 static uint8_t currentSamplingOutput = 0U;
 
+/* The level of each sampled output when its status was last written */
+static DigitalLevel_t reportedLevel[NUM_DIGITAL_OUTPUTS];
+
+/* The fault status of each sampled output when its status was last written */
+static TLE7232_Status_t reportedFault[NUM_DIGITAL_OUTPUTS];
+
+/* True once the status of each sampled output has been written at least once */
+static bool reported[NUM_DIGITAL_OUTPUTS];
+
+/* Set by the poll deadline once the sampled outputs are due to be checked */
+static volatile bool pollDue = false;
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE FUNCTION PROTOTYPES */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -67,6 +81,21 @@ static uint8_t currentSamplingOutput = 0U;
  */
 static inline const char* DOMachine_StringFromState(DO_State_t state);
 
+/*
+ * @brief Changes the state of the machine, recording the transition in the state trace.
+ */
+static inline void DO_Machine_EnterState(DO_State_t newState);
+
+/*
+ * @brief Deadline callback made when the sampled outputs are due to be checked.
+ */
+static void DO_Machine_PollDue(void);
+
+/*
+ * @brief Writes the status of a sampled output if it has changed since it was last written.
+ */
+static void ReportOutputIfChanged(uint8_t index, Digital_Output_t* output);
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE FUNCTIONS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -83,6 +112,49 @@ static inline const char* DOMachine_StringFromState(DO_State_t state) {
 	return strings[state];
 }
 
+/**
+ * Changes the state of the machine, recording the transition in the state trace.
+ *
+ * @param newState DO_State_t The state to enter.
+ * @retval none
+ */
+static inline void DO_Machine_EnterState(DO_State_t newState) {
+	state = newState;
+	StateTrace_Record(STATE_TRACE_DO, (uint8_t) newState, 0U);
+}
+
+/**
+ * Deadline callback made when the sampled outputs are due to be checked.
+ *
+ * @param none
+ * @retval none
+ */
+static void DO_Machine_PollDue(void) {
+	pollDue = true;
+}
+
+/**
+ * Writes the status of a sampled output if its level or fault status has changed since it was last written, or if
+ * it has not yet been written during this sampling. A write refused because the connection is busy is retried on
+ * the next poll.
+ *
+ * @param index uint8_t The index of the output in the sampling list.
+ * @param output Digital_Output_t* The output to check.
+ * @retval none
+ */
+static void ReportOutputIfChanged(uint8_t index, Digital_Output_t* output) {
+	if ((reported[index] == true) && (reportedLevel[index] == output->level)
+			&& (reportedFault[index] == output->fault_status)) {
+		return;
+	}
+	output->timestamp = GetLocalTime();
+	if (WriteDigitalOutput(output) != WRITE_BUSY) {
+		reported[index] = true;
+		reportedLevel[index] = output->level;
+		reportedFault[index] = output->fault_status;
+	}
+}
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* INITIALIZATION METHODS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -97,7 +169,7 @@ void DO_Machine_Create(void) {
 #ifdef DO_STATE_MACHINE_DEBUG
 	printf("[DO STATE MACHINE] Creating DO state machine.\n\r");
 #endif
-	state = DO_UNINITIALIZED;
+	DO_Machine_EnterState(DO_UNINITIALIZED);
 }
 
 /**
@@ -128,7 +200,7 @@ void DO_Machine_Init(void) {
 	numberSamplingOutputs = 0U;
 
 	/* Update the state */
-	state = DO_INITIALIZED;
+	DO_Machine_EnterState(DO_INITIALIZED);
 }
 
 /*--------------------------------------------------------------------------------------------------------*/
@@ -155,17 +227,25 @@ void DO_Machine_Service(void) {
 	case DO_CHANNEL_SAMPLING: {
 		Digital_Output_t* output = NULL;
 		if (SampleCurrent < SampleTotal) {
+			if (pollDue == false) {
+				/* Wait for the next poll period */
+				break;
+			}
 			if (numberSamplingOutputs == 1) {
-				/* TODO: Output channel sampling */
-				++SampleCurrent;
+				ReportOutputIfChanged(0U, samplingOutputs[0]);
 			} else {
 				for (uint_fast8_t i = 0; i < NUM_DIGITAL_OUTPUTS; ++i) {
 					output = samplingOutputs[i];
 					if (output != NULL) {
-						/* TODO: Output channel sampling */
+						ReportOutputIfChanged(i, output);
 					}
 				}
-				++SampleCurrent;
+			}
+			++SampleCurrent;
+			pollDue = false;
+			if (Timer_ScheduleDeadline(DO_Machine_PollDue, DO_POLL_PERIOD_US) == false) {
+				/* Without a deadline, poll on the next pass */
+				pollDue = true;
 			}
 		} else {
 #ifdef DO_STATE_MACHINE_DEBUG
@@ -227,7 +307,9 @@ void DO_Machine_Idle(void) {
 #ifdef DO_STATE_MACHINE_DEBUG
 	printf("[DO STATE MACHINE] Moving to state DO_IDLE.\n\r");
 #endif
-	state = DO_IDLE;
+	Timer_CancelDeadline(DO_Machine_PollDue);
+	pollDue = false;
+	DO_Machine_EnterState(DO_IDLE);
 }
 
 /**
@@ -299,7 +381,11 @@ void DO_Machine_Output_Sample(Digital_Output_t** outputs, uint32_t count, bool s
 	/* Save current time and sample count */
 	SampleCurrent = 0U;
 	SampleTotal = count;
-	state = DO_CHANNEL_SAMPLING;
+	for (uint_fast8_t j = 0U; j < NUM_DIGITAL_OUTPUTS; ++j) {
+		reported[j] = false;
+	}
+	pollDue = true; /* Every output's status is written on the first poll */
+	DO_Machine_EnterState(DO_CHANNEL_SAMPLING);
 }
 
 /**
@@ -317,5 +403,5 @@ void DO_Machine_Reset(void) {
 #endif
 		return;
 	}
-	state = DO_RESET;
+	DO_Machine_EnterState(DO_RESET);
 }
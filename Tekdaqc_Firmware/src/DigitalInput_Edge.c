@@ -0,0 +1,462 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file DigitalInput_Edge.c
+ * @brief Implements change of state capture of the digital inputs.
+ *
+ * Each captured input's pin is routed to its EXTI line, set to interrupt on both edges. The interrupt takes the local
+ * time first, so the timestamp is within the interrupt latency of the edge, then reads the new level and logs both in
+ * a ring. The EXTI interrupts all run at the same priority, so the ring has a single producer and needs no locking.
+ * The main loop drains the ring through the digital input writer, so only transitions are streamed.
+ *
+ * In counting mode the lines interrupt on rising edges only, and the interrupt just counts the edge and notes the
+ * time of the first and last of the interval. The frequency and period come from those two times, so they are as
+ * precise as the edge timestamps rather than being limited by the length of the interval.
+ *
+ * In latching mode the lines interrupt on both edges and the interrupt only sets the input's bit in a "went high" or
+ * "went low" word, so a pulse shorter than the scan period is still seen by the next scan. The level read in the
+ * interrupt tells which edge it was; if it is unchanged since the previous interrupt, the pin went and came back
+ * before it could be read, and both bits are set. The scan takes the words at its sampling instant and keeps them
+ * until they have been written out, so an edge is neither lost to a busy connection nor reported twice.
+ *
+ * An EXTI line can only be routed from one port at a time, so inputs sharing a pin number cannot be captured
+ * together, and the lines of the ADS1256 DRDY and ethernet link interrupts are not available at all.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "DigitalInput_Edge.h"
+#include "DigitalOutput_Interlock.h"
+#include "Tekdaqc_BSP.h"
+#include "Tekdaqc_RingBuffer.h"
+#include "Tekdaqc_Timers.h"
+#include "stm32f4xx.h"
+
+#ifdef DIGITAL_EDGE_DEBUG
+#include <stdio.h>
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief A logged transition of a digital input.
+ */
+typedef struct {
+	uint64_t timestamp; /**< The local time of the transition. */
+	Digital_Input_t* input; /**< The input which changed. */
+	DigitalLevel_t level; /**< The level of the input after the transition. */
+} DigitalEdge_t;
+
+/**
+ * @internal
+ * @brief The running pulse count of a counted line.
+ */
+typedef struct {
+	uint32_t count; /**< The number of rising edges in the current interval. */
+	uint64_t start; /**< The local time the current interval started. */
+	uint64_t firstEdge; /**< The local time of the first edge of the current interval. */
+	uint64_t lastEdge; /**< The local time of the most recent edge. */
+} DigitalEdgeCounter_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The input routed to each EXTI line, NULL if the line is not captured */
+static Digital_Input_t* lineInputs[DIGITAL_EDGE_NUM_LINES];
+
+/* Mask of the EXTI lines being captured, 0 when capture is stopped */
+static volatile uint32_t captureLines = 0U;
+
+/* What is done with the edges of the captured lines */
+static DigitalEdgeMode_t captureMode = DIGITAL_EDGE_LOG;
+
+/* The pulse count of each line in counting mode */
+static DigitalEdgeCounter_t lineCounters[DIGITAL_EDGE_NUM_LINES];
+
+/* The inputs which went high and low since the previous scan in latching mode, bit n holding GPIn */
+static volatile uint32_t latchedRose = 0U;
+static volatile uint32_t latchedFell = 0U;
+
+/* The level of each latched input at its previous interrupt, bit n holding GPIn */
+static uint32_t latchLevels = 0U;
+
+/* The latched edges taken by the scans since the last were written out */
+static uint32_t reportedRose = 0U;
+static uint32_t reportedFell = 0U;
+
+/* Storage of the edge log */
+static DigitalEdge_t edgeLog[DIGITAL_EDGE_LOG_SIZE];
+
+/* Indices of the edge log, written from the EXTI interrupts and read from the main loop */
+static RingBuffer_t edgeRing;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Logs the level of an input.
+ */
+static void LogLevel(Digital_Input_t* input, uint64_t timestamp);
+
+/**
+ * @internal
+ * @brief Enables or disables the EXTI vectors serving the captured lines.
+ */
+static void ConfigureVectors(uint32_t lines, FunctionalState enable);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Reads the current level of an input and logs it with the provided timestamp. If the log is full the entry is
+ * dropped and counted as an overflow. The interlocks see the level either way.
+ *
+ * @param input Digital_Input_t* The input to log.
+ * @param timestamp uint64_t The local time to log the level with.
+ * @retval none
+ */
+static void LogLevel(Digital_Input_t* input, uint64_t timestamp) {
+	const DigitalLevel_t level = ReadDigitalInputLevel(input);
+	DigitalInterlock_ProcessDigital(input->input, level, timestamp);
+	uint32_t index = 0U;
+	if (RingBuffer_BeginWrite(&edgeRing, &index) == true) {
+		edgeLog[index].timestamp = timestamp;
+		edgeLog[index].input = input;
+		edgeLog[index].level = level;
+		RingBuffer_EndWrite(&edgeRing);
+	}
+}
+
+/**
+ * Enables or disables the EXTI vectors serving the captured lines. The EXTI15_10 vector is left alone, as it is
+ * configured and always enabled for the ADS1256 DRDY and ethernet link interrupts.
+ *
+ * @param lines uint32_t Mask of the captured EXTI lines.
+ * @param enable FunctionalState ENABLE to enable the vectors, DISABLE to disable them.
+ * @retval none
+ */
+static void ConfigureVectors(uint32_t lines, FunctionalState enable) {
+	NVIC_InitTypeDef NVIC_InitStructure;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = GPI_EXTI_PREEMPT_PRIORITY;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0U;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = enable;
+	for (uint_fast8_t line = 0U; line < 5U; ++line) {
+		if ((lines & (1UL << line)) != 0U) {
+			NVIC_InitStructure.NVIC_IRQChannel = (uint8_t) (EXTI0_IRQn + line);
+			NVIC_Init(&NVIC_InitStructure);
+		}
+	}
+	if ((lines & (EXTI_Line5 | EXTI_Line6 | EXTI_Line7 | EXTI_Line8 | EXTI_Line9)) != 0U) {
+		NVIC_InitStructure.NVIC_IRQChannel = EXTI9_5_IRQn;
+		NVIC_Init(&NVIC_InitStructure);
+	}
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Starts edge capture of a set of digital inputs. In logging mode the current level of each input is logged first, so
+ * the stream starts from a known state, then every transition is logged until DigitalEdge_Stop() is called. In
+ * counting mode the first interval of each input starts now. In latching mode nothing is latched until the first edge.
+ *
+ * @param inputs Digital_Input_t** List of NUM_DIGITAL_INPUTS inputs to capture. NULL entries are skipped.
+ * @param mode DigitalEdgeMode_t What is done with the edges.
+ * @retval bool FALSE if capture is already running, there are no inputs, or an input's EXTI line is reserved or shared
+ * with another of the inputs.
+ */
+bool DigitalEdge_Start(Digital_Input_t** inputs, DigitalEdgeMode_t mode) {
+	if (captureLines != 0U) {
+		return false;
+	}
+	uint8_t portSources[DIGITAL_EDGE_NUM_LINES];
+	uint32_t lines = 0U;
+	for (uint_fast8_t i = 0U; i < DIGITAL_EDGE_NUM_LINES; ++i) {
+		lineInputs[i] = NULL;
+	}
+	for (uint_fast8_t i = 0U; i < NUM_DIGITAL_INPUTS; ++i) {
+		Digital_Input_t* input = inputs[i];
+		uint8_t portSource = 0U;
+		uint16_t pin = 0U;
+		if (input == NULL) {
+			continue;
+		}
+		if ((GetDigitalInputPin(input, &portSource, &pin) == false) || ((pin & GPI_EXTI_RESERVED_LINES) != 0U)
+				|| ((lines & pin) != 0U)) {
+#ifdef DIGITAL_EDGE_DEBUG
+			printf("[Digital Edge] Input %i cannot be captured, its EXTI line is reserved or already in use.\n\r", input->input);
+#endif
+			return false;
+		}
+		const uint_fast8_t line = 31U - __CLZ(pin);
+		lineInputs[line] = input;
+		portSources[line] = portSource;
+		lines |= pin;
+	}
+	if (lines == 0U) {
+		return false;
+	}
+
+	RingBuffer_Init(&edgeRing, DIGITAL_EDGE_LOG_SIZE);
+	const uint64_t now = GetLocalTime();
+	latchedRose = 0U;
+	latchedFell = 0U;
+	latchLevels = 0U;
+	reportedRose = 0U;
+	reportedFell = 0U;
+	for (uint_fast8_t line = 0U; line < DIGITAL_EDGE_NUM_LINES; ++line) {
+		lineCounters[line].count = 0U;
+		lineCounters[line].start = now;
+		if ((lineInputs[line] != NULL) && (mode == DIGITAL_EDGE_LOG)) {
+			LogLevel(lineInputs[line], now);
+		} else if ((lineInputs[line] != NULL) && (ReadDigitalInputLevel(lineInputs[line]) == LOGIC_HIGH)) {
+			latchLevels |= (1UL << lineInputs[line]->input);
+		}
+	}
+	captureMode = mode;
+
+	/* Route the pins to their lines and interrupt on both edges */
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_SYSCFG, ENABLE);
+	for (uint_fast8_t line = 0U; line < DIGITAL_EDGE_NUM_LINES; ++line) {
+		if (lineInputs[line] != NULL) {
+			SYSCFG_EXTILineConfig(portSources[line], (uint8_t) line);
+		}
+	}
+	EXTI_InitTypeDef EXTI_InitStructure;
+	EXTI_InitStructure.EXTI_Line = lines;
+	EXTI_InitStructure.EXTI_Mode = EXTI_Mode_Interrupt;
+	EXTI_InitStructure.EXTI_Trigger = (mode == DIGITAL_EDGE_COUNT) ? EXTI_Trigger_Rising : EXTI_Trigger_Rising_Falling;
+	EXTI_InitStructure.EXTI_LineCmd = ENABLE;
+	captureLines = lines;
+	EXTI_ClearITPendingBit(lines);
+	EXTI_Init(&EXTI_InitStructure);
+	ConfigureVectors(lines, ENABLE);
+#ifdef DIGITAL_EDGE_DEBUG
+	printf("[Digital Edge] Capturing EXTI lines 0x%04lX.\n\r", lines);
+#endif
+	return true;
+}
+
+/**
+ * Stops edge capture, masking the lines of the captured inputs. Any transitions still in the log are discarded.
+ *
+ * @param none
+ * @retval none
+ */
+void DigitalEdge_Stop(void) {
+	const uint32_t lines = captureLines;
+	if (lines == 0U) {
+		return;
+	}
+	EXTI->IMR &= ~lines;
+	EXTI->RTSR &= ~lines;
+	EXTI->FTSR &= ~lines;
+	EXTI_ClearITPendingBit(lines);
+	ConfigureVectors(lines, DISABLE);
+	captureLines = 0U;
+}
+
+/**
+ * Logs the transitions of any captured inputs whose EXTI lines are pending. Called from each EXTI interrupt handler
+ * which may serve a digital input; lines which are not captured are left for their own handlers.
+ *
+ * @param none
+ * @retval none
+ */
+void DigitalEdge_IRQHandler(void) {
+	uint32_t pending = EXTI->PR & captureLines;
+	if (pending == 0U) {
+		return;
+	}
+	const uint64_t timestamp = GetLocalTime();
+	/* Clear before reading the level, so an edge after the read is not lost */
+	EXTI_ClearITPendingBit(pending);
+	while (pending != 0U) {
+		const uint_fast8_t line = 31U - __CLZ(pending);
+		pending &= ~(1UL << line);
+		if (captureMode == DIGITAL_EDGE_COUNT) {
+			DigitalEdgeCounter_t* counter = &lineCounters[line];
+			if (counter->count == 0U) {
+				counter->firstEdge = timestamp;
+			}
+			++(counter->count);
+			counter->lastEdge = timestamp;
+		} else if (captureMode == DIGITAL_EDGE_LATCH) {
+			const uint32_t bit = 1UL << lineInputs[line]->input;
+			const bool high = (ReadDigitalInputLevel(lineInputs[line]) == LOGIC_HIGH);
+			if (high == ((latchLevels & bit) != 0U)) {
+				/* Back at the level of the previous edge, so the pin made a whole pulse */
+				latchedRose |= bit;
+				latchedFell |= bit;
+			} else if (high == true) {
+				latchedRose |= bit;
+				latchLevels |= bit;
+			} else {
+				latchedFell |= bit;
+				latchLevels &= ~bit;
+			}
+		} else {
+			LogLevel(lineInputs[line], timestamp);
+		}
+	}
+}
+
+/**
+ * Writes out the logged transitions, oldest first, through the digital input writer. A busy connection leaves the
+ * rest in the log for the next service.
+ *
+ * @param none
+ * @retval none
+ */
+void DigitalEdge_Service(void) {
+	uint32_t count = RingBuffer_Count(&edgeRing);
+	while (count > 0U) {
+		const DigitalEdge_t* edge = &edgeLog[RingBuffer_PeekIndex(&edgeRing, 0U)];
+		edge->input->timestamp = edge->timestamp;
+		edge->input->level = edge->level;
+		if (WriteDigitalInput(edge->input) == WRITE_BUSY) {
+			break;
+		}
+		RingBuffer_Release(&edgeRing, 1U);
+		--count;
+	}
+}
+
+/**
+ * Retrieves the pulse count of a counted input over the interval since the last read, or since counting started, and
+ * starts a new interval. The frequency is taken from the times of the first and last edges of the interval when there
+ * are at least two, otherwise from the edge count over the interval.
+ *
+ * @param input const Digital_Input_t* The counted input.
+ * @param counter Digital_Input_Counter_t* Filled in with the counter report.
+ * @retval bool FALSE if the input is not being counted.
+ */
+bool DigitalEdge_ReadCounter(const Digital_Input_t* input, Digital_Input_Counter_t* counter) {
+	uint8_t portSource = 0U;
+	uint16_t pin = 0U;
+	if ((captureMode != DIGITAL_EDGE_COUNT) || (GetDigitalInputPin(input, &portSource, &pin) == false)
+			|| ((captureLines & pin) == 0U)) {
+		return false;
+	}
+	DigitalEdgeCounter_t* running = &lineCounters[31U - __CLZ(pin)];
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	const uint64_t now = GetLocalTime();
+	const DigitalEdgeCounter_t snapshot = *running;
+	running->count = 0U;
+	running->start = now;
+	__set_PRIMASK(primask);
+
+	counter->start = snapshot.start;
+	counter->duration = now - snapshot.start;
+	counter->count = snapshot.count;
+	counter->frequency_mHz = 0U;
+	counter->period = 0U;
+	if ((snapshot.count >= 2U) && (snapshot.lastEdge > snapshot.firstEdge)) {
+		const uint64_t span = snapshot.lastEdge - snapshot.firstEdge;
+		counter->frequency_mHz = (uint32_t) ((((uint64_t) (snapshot.count - 1U)) * 1000000000ULL) / span);
+		counter->period = (uint32_t) (span / (snapshot.count - 1U));
+	} else if (counter->duration > 0U) {
+		counter->frequency_mHz = (uint32_t) ((((uint64_t) snapshot.count) * 1000000000ULL) / counter->duration);
+	}
+	return true;
+}
+
+/**
+ * Writes out the counter report of each counted input, in input order, and starts a new interval for each.
+ *
+ * @param none
+ * @retval none
+ */
+void DigitalEdge_WriteCounters(void) {
+	Digital_Input_Counter_t counter;
+	for (uint_fast8_t i = 0U; i < NUM_DIGITAL_INPUTS; ++i) {
+		const Digital_Input_t* input = GetDigitalInputByNumber(i);
+		if ((input != NULL) && (DigitalEdge_ReadCounter(input, &counter) == true)) {
+			WriteDigitalInputCounter(input, &counter);
+		}
+	}
+}
+
+/**
+ * Moves the edges latched since the previous scan into the report of the scan being taken. Called at the sampling
+ * instant of each scan, so an edge after it is left for the next scan. Edges of earlier scans which have not yet
+ * been written out stay in the report.
+ *
+ * @param none
+ * @retval none
+ */
+void DigitalEdge_LatchScan(void) {
+	if ((captureLines == 0U) || (captureMode != DIGITAL_EDGE_LATCH)) {
+		return;
+	}
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	reportedRose |= latchedRose;
+	reportedFell |= latchedFell;
+	latchedRose = 0U;
+	latchedFell = 0U;
+	__set_PRIMASK(primask);
+}
+
+/**
+ * Retrieves the latched edges to report with a scan, those taken by DigitalEdge_LatchScan() since they were last
+ * cleared.
+ *
+ * @param rose uint32_t* Set to the mask of the inputs which went high, bit n holding GPIn.
+ * @param fell uint32_t* Set to the mask of the inputs which went low, bit n holding GPIn.
+ * @retval bool FALSE if the inputs are not being latched.
+ */
+bool DigitalEdge_GetLatched(uint32_t* rose, uint32_t* fell) {
+	if ((captureLines == 0U) || (captureMode != DIGITAL_EDGE_LATCH)) {
+		return false;
+	}
+	*rose = reportedRose;
+	*fell = reportedFell;
+	return true;
+}
+
+/**
+ * Clears the latched edges once the scan reporting them has been written out.
+ *
+ * @param none
+ * @retval none
+ */
+void DigitalEdge_ClearLatched(void) {
+	reportedRose = 0U;
+	reportedFell = 0U;
+}
+
+/**
+ * Retrieves the number of transitions dropped since capture started because the edge log was full.
+ *
+ * @param none
+ * @retval uint32_t The number of dropped transitions.
+ */
+uint32_t DigitalEdge_GetOverflowCount(void) {
+	return RingBuffer_GetOverflowCount(&edgeRing);
+}
@@ -0,0 +1,223 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file DigitalInput_Encoder.c
+ * @brief Implements quadrature encoder decoding of digital input pairs.
+ *
+ * The A and B inputs of each encoder are connected to channels 1 and 2 of a timer running in encoder mode, which
+ * counts up or down on every edge of either phase by itself, so no interrupt or any other CPU time is spent per edge.
+ * The counter is read once per scan of the digital inputs: the difference from the previous read, taken modulo the
+ * width of the counter, is the signed movement since then, which extends the position and over the time between the
+ * reads gives the velocity. The counter may therefore be 16 bits wide as long as it moves less than half its range
+ * between scans.
+ *
+ * The inputs stay readable as digital inputs while their pins are connected to the timer.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "DigitalInput_Encoder.h"
+#include "Tekdaqc_BSP.h"
+#include "Tekdaqc_Timers.h"
+#include "stm32f4xx.h"
+
+#ifdef DIGITAL_ENCODER_DEBUG
+#include <stdio.h>
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def DIGITAL_ENCODER_INPUT_FILTER
+ * @brief The timer input filter of the encoder inputs, 6 samples at a quarter of the timer clock, which rejects
+ * glitches shorter than a few hundred nanoseconds.
+ */
+#define DIGITAL_ENCODER_INPUT_FILTER	6U
+
+/* Expands a GPI_ENCODER_TABLE entry to its element of ENCODER_MAP */
+#define GPI_ENCODER_MAP_ENTRY(n, a, b, timer, af, clock) { timer, clock, GPI##a, GPI##b, af },
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief The timer and inputs of an encoder.
+ */
+typedef struct {
+	TIM_TypeDef* timer; /**< The timer decoding the encoder. */
+	uint32_t clock; /**< The APB1 peripheral clock of the timer. */
+	GPI_TypeDef inputA; /**< The input connected to channel 1 of the timer. */
+	GPI_TypeDef inputB; /**< The input connected to channel 2 of the timer. */
+	uint8_t af; /**< The alternate function connecting the inputs to the timer. */
+} DigitalEncoderMap_t;
+
+/**
+ * @internal
+ * @brief The running state of an encoder.
+ */
+typedef struct {
+	bool enabled; /**< TRUE while the encoder is decoded. */
+	uint32_t mask; /**< The mask of the bits of the timer's counter. */
+	uint32_t lastCount; /**< The counter at the previous sample. */
+	Digital_Input_Encoder_t sample; /**< The latest sample. */
+} DigitalEncoderState_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The timer and inputs of each encoder, indexed by encoder number */
+static const DigitalEncoderMap_t ENCODER_MAP[NUM_DIGITAL_ENCODERS] = { GPI_ENCODER_TABLE(GPI_ENCODER_MAP_ENTRY) };
+
+/* The running state of each encoder */
+static DigitalEncoderState_t encoders[NUM_DIGITAL_ENCODERS];
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Starts decoding a quadrature encoder, connecting its inputs to its timer and counting from a position of zero. An
+ * encoder which is already running is restarted from zero.
+ *
+ * @param encoder uint8_t The number of the encoder.
+ * @retval bool FALSE if there is no such encoder.
+ */
+bool DigitalEncoder_Start(uint8_t encoder) {
+	if (encoder >= NUM_DIGITAL_ENCODERS) {
+		return false;
+	}
+	const DigitalEncoderMap_t* map = &ENCODER_MAP[encoder];
+	DigitalEncoderState_t* state = &encoders[encoder];
+	state->enabled = false;
+
+	RCC_APB1PeriphClockCmd(map->clock, ENABLE);
+	TIM_DeInit(map->timer);
+	TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+	TIM_TimeBaseStructInit(&TIM_TimeBaseStructure);
+	/* The widest period the counter takes, a 16 bit timer keeps only the low half */
+	TIM_TimeBaseStructure.TIM_Period = 0xFFFFFFFFU;
+	TIM_TimeBaseInit(map->timer, &TIM_TimeBaseStructure);
+	TIM_EncoderInterfaceConfig(map->timer, TIM_EncoderMode_TI12, TIM_ICPolarity_Rising, TIM_ICPolarity_Rising);
+	TIM_ICInitTypeDef TIM_ICInitStructure;
+	TIM_ICStructInit(&TIM_ICInitStructure);
+	TIM_ICInitStructure.TIM_ICFilter = DIGITAL_ENCODER_INPUT_FILTER;
+	TIM_ICInitStructure.TIM_Channel = TIM_Channel_1;
+	TIM_ICInit(map->timer, &TIM_ICInitStructure);
+	TIM_ICInitStructure.TIM_Channel = TIM_Channel_2;
+	TIM_ICInit(map->timer, &TIM_ICInitStructure);
+	TIM_SetCounter(map->timer, 0U);
+	state->mask = map->timer->ARR;
+	state->lastCount = 0U;
+
+	SetDigitalInputPinFunction(map->inputA, true, map->af);
+	SetDigitalInputPinFunction(map->inputB, true, map->af);
+	TIM_Cmd(map->timer, ENABLE);
+
+	state->sample.timestamp = GetLocalTime();
+	state->sample.position = 0;
+	state->sample.velocity = 0;
+	state->sample.encoder = encoder;
+	state->sample.inputA = map->inputA;
+	state->sample.inputB = map->inputB;
+	state->enabled = true;
+#ifdef DIGITAL_ENCODER_DEBUG
+	printf("[Digital Encoder] Encoder %i started on GPI%i and GPI%i, counter mask 0x%08lX.\n\r", encoder, map->inputA,
+			map->inputB, state->mask);
+#endif
+	return true;
+}
+
+/**
+ * Stops decoding a quadrature encoder, returning its inputs to plain digital inputs and turning its timer off.
+ *
+ * @param encoder uint8_t The number of the encoder.
+ * @retval none
+ */
+void DigitalEncoder_Stop(uint8_t encoder) {
+	if ((encoder >= NUM_DIGITAL_ENCODERS) || (encoders[encoder].enabled == false)) {
+		return;
+	}
+	const DigitalEncoderMap_t* map = &ENCODER_MAP[encoder];
+	encoders[encoder].enabled = false;
+	TIM_Cmd(map->timer, DISABLE);
+	SetDigitalInputPinFunction(map->inputA, false, map->af);
+	SetDigitalInputPinFunction(map->inputB, false, map->af);
+	TIM_DeInit(map->timer);
+	RCC_APB1PeriphClockCmd(map->clock, DISABLE);
+}
+
+/**
+ * Checks if a quadrature encoder is being decoded.
+ *
+ * @param encoder uint8_t The number of the encoder.
+ * @retval bool TRUE if the encoder has been started and not stopped since.
+ */
+bool DigitalEncoder_IsEnabled(uint8_t encoder) {
+	return (encoder < NUM_DIGITAL_ENCODERS) && (encoders[encoder].enabled == true);
+}
+
+/**
+ * Samples the position and velocity of every enabled quadrature encoder. Called with each scan of the digital inputs,
+ * with the scan's timestamp, so the encoders share its instant.
+ *
+ * @param timestamp uint64_t The local time of the sample.
+ * @retval none
+ */
+void DigitalEncoder_Sample(uint64_t timestamp) {
+	for (uint_fast8_t i = 0U; i < NUM_DIGITAL_ENCODERS; ++i) {
+		DigitalEncoderState_t* state = &encoders[i];
+		if (state->enabled == false) {
+			continue;
+		}
+		const uint32_t count = ENCODER_MAP[i].timer->CNT & state->mask;
+		uint32_t delta = (count - state->lastCount) & state->mask;
+		if (delta > (state->mask >> 1U)) {
+			/* The counter went backwards, sign extend from its width */
+			delta -= state->mask + 1U;
+		}
+		const int32_t movement = (int32_t) delta;
+		state->lastCount = count;
+		if (timestamp > state->sample.timestamp) {
+			state->sample.velocity = (int32_t) ((((int64_t) movement) * 1000000LL)
+					/ (int64_t) (timestamp - state->sample.timestamp));
+		}
+		/* The position wraps rather than saturating, as the counter itself does */
+		state->sample.position = (int32_t) (((uint32_t) state->sample.position) + delta);
+		state->sample.timestamp = timestamp;
+	}
+}
+
+/**
+ * Retrieves the latest sample of a quadrature encoder, taken by DigitalEncoder_Sample().
+ *
+ * @param encoder uint8_t The number of the encoder.
+ * @retval const Digital_Input_Encoder_t* The latest sample, NULL if the encoder is not enabled.
+ */
+const Digital_Input_Encoder_t* DigitalEncoder_GetSample(uint8_t encoder) {
+	if (DigitalEncoder_IsEnabled(encoder) == false) {
+		return NULL;
+	}
+	return &encoders[encoder].sample;
+}
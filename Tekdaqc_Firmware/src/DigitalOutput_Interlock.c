@@ -0,0 +1,329 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file DigitalOutput_Interlock.c
+ * @brief Implements the digital output interlocks.
+ *
+ * Each rule of the interlock table watches an analog or digital input and drives a digital output while the input is
+ * past its threshold. Analog rules are checked from the DRDY interrupt against every sample of their input, after
+ * its filter, so they react within one sample period of the input's scan. Digital rules are checked whenever their
+ * input is sampled or, during edge capture, on every edge. Unsampled inputs are not watched.
+ *
+ * Tripped rules do not write to the relay drivers themselves. They hand the digital outputs an override mask, which
+ * is merged over every other source of output levels by the output timer, running whenever a rule is set, so the
+ * change reaches the relay drivers through the timer's batched DMA frame within one of its ticks of the trip.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "DigitalOutput_Interlock.h"
+#include "Digital_Output.h"
+#include <string.h>
+
+#ifdef DIGITAL_INTERLOCK_DEBUG
+#include <stdio.h>
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The human readable names of the comparators, indexed by DigitalInterlockComparator_t */
+static const char* COMPARATOR_STRINGS[NUM_DIGITAL_INTERLOCK_COMPARATORS] = { "ABOVE", "BELOW" };
+
+/* The interlock rule table */
+static DigitalInterlock_t rules[DIGITAL_INTERLOCK_MAX_RULES];
+
+/* Bit masks of the enabled rules watching analog and digital inputs, bit n for rule n */
+static volatile uint32_t analogRules = 0U;
+static volatile uint32_t digitalRules = 0U;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Checks a value against a rule, tripping or clearing it.
+ */
+static bool EvaluateRule(DigitalInterlock_t* rule, int32_t value, uint64_t timestamp);
+
+/**
+ * @internal
+ * @brief Hands the outputs of the tripped rules to the digital outputs as their override.
+ */
+static void UpdateOverride(void);
+
+/**
+ * @internal
+ * @brief Rebuilds the masks of the enabled rules and starts or stops the output timer's merging of the override.
+ */
+static void UpdateRuleMasks(void);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Checks a value against a rule. An untripped rule trips on the value passing its threshold, and a tripped rule
+ * which is not latched clears when the value is back past the threshold by the hysteresis.
+ *
+ * @param rule DigitalInterlock_t* Pointer/Reference to the rule.
+ * @param value int32_t The value of the rule's input.
+ * @param timestamp uint64_t The timestamp of the value.
+ * @retval bool True if the rule tripped or cleared.
+ */
+static bool EvaluateRule(DigitalInterlock_t* rule, int32_t value, uint64_t timestamp) {
+	const int64_t threshold = rule->threshold;
+	if (rule->tripped == false) {
+		const bool trip = (rule->comparator == DIGITAL_INTERLOCK_ABOVE) ? (value > threshold) : (value < threshold);
+		if (trip == true) {
+			rule->tripped = true;
+			++(rule->trips);
+			rule->tripTime = timestamp;
+			return true;
+		}
+	} else if (rule->latch == false) {
+		const bool clear = (rule->comparator == DIGITAL_INTERLOCK_ABOVE) ?
+				(value <= (threshold - rule->hysteresis)) : (value >= (threshold + rule->hysteresis));
+		if (clear == true) {
+			rule->tripped = false;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Hands the outputs of the tripped rules to the digital outputs as their override. When several tripped rules drive
+ * the same output the lowest numbered one sets its level. Interrupts are held off so that a rule tripped from
+ * another interrupt part way through can not be overwritten by a stale override.
+ *
+ * @param none
+ * @retval none
+ */
+static void UpdateOverride(void) {
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	DigitalOutputMask_t mask = 0U;
+	DigitalOutputMask_t levels = 0U;
+	for (uint_fast8_t i = 0U; i < DIGITAL_INTERLOCK_MAX_RULES; ++i) {
+		const DigitalInterlock_t* rule = &rules[i];
+		const DigitalOutputMask_t bit = (DigitalOutputMask_t) (1UL << rule->output);
+		if ((rule->enabled == true) && (rule->tripped == true) && ((mask & bit) == 0U)) {
+			mask |= bit;
+			if (rule->on == true) {
+				levels |= bit;
+			}
+		}
+	}
+	SetDigitalOutputInterlock(mask, levels);
+	__set_PRIMASK(primask);
+}
+
+/**
+ * Rebuilds the masks of the enabled rules, which let the sample paths skip inputs no rule watches, and keeps the
+ * output timer merging the override for as long as any rule is set.
+ *
+ * @param none
+ * @retval none
+ */
+static void UpdateRuleMasks(void) {
+	uint32_t analog = 0U;
+	uint32_t digital = 0U;
+	for (uint_fast8_t i = 0U; i < DIGITAL_INTERLOCK_MAX_RULES; ++i) {
+		if (rules[i].enabled == true) {
+			if (rules[i].source == DIGITAL_INTERLOCK_ANALOG) {
+				analog |= (1UL << i);
+			} else {
+				digital |= (1UL << i);
+			}
+		}
+	}
+	analogRules = analog;
+	digitalRules = digital;
+	EnableDigitalOutputInterlock((analog | digital) != 0U);
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Sets an interlock rule, replacing any rule of the same number. The rule starts untripped and is checked from the
+ * next sample of its input. A digital rule's threshold and hysteresis are set from its comparator, so it trips on
+ * the input's level alone.
+ *
+ * @param number uint8_t The number of the rule.
+ * @param rule const DigitalInterlock_t* Pointer/Reference to the rule's settings.
+ * @retval bool True if the rule was set.
+ */
+bool DigitalInterlock_Set(uint8_t number, const DigitalInterlock_t* rule) {
+	if ((number >= DIGITAL_INTERLOCK_MAX_RULES) || (rule->output >= NUM_DIGITAL_OUTPUTS)
+			|| (rule->comparator >= NUM_DIGITAL_INTERLOCK_COMPARATORS)
+			|| ((rule->source == DIGITAL_INTERLOCK_DIGITAL) && (rule->input >= NUM_DIGITAL_INPUTS))
+			|| ((rule->source == DIGITAL_INTERLOCK_ANALOG) && (rule->input >= NUM_ANALOG_INPUTS))) {
+		return false;
+	}
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	rules[number] = *rule;
+	rules[number].tripped = false;
+	rules[number].trips = 0U;
+	rules[number].tripTime = 0U;
+	if (rule->source == DIGITAL_INTERLOCK_DIGITAL) {
+		/* A high input is 1 and a low one 0 */
+		rules[number].threshold = (rule->comparator == DIGITAL_INTERLOCK_ABOVE) ? 0 : 1;
+		rules[number].hysteresis = 0U;
+	}
+	rules[number].enabled = true;
+	__set_PRIMASK(primask);
+	UpdateRuleMasks();
+	UpdateOverride();
+#ifdef DIGITAL_INTERLOCK_DEBUG
+	printf("[Digital Interlock] Set rule %i driving output %i.\n\r", number, rule->output);
+#endif
+	return true;
+}
+
+/**
+ * Removes an interlock rule. If it was tripped its output returns to the level the host last set.
+ *
+ * @param number uint8_t The number of the rule.
+ * @retval bool True if the rule number is valid.
+ */
+bool DigitalInterlock_Clear(uint8_t number) {
+	if (number >= DIGITAL_INTERLOCK_MAX_RULES) {
+		return false;
+	}
+	rules[number].enabled = false;
+	rules[number].tripped = false;
+	UpdateRuleMasks();
+	UpdateOverride();
+	return true;
+}
+
+/**
+ * Retrieves a copy of an interlock rule, with its current state.
+ *
+ * @param number uint8_t The number of the rule.
+ * @param rule DigitalInterlock_t* Pointer/Reference to the structure to fill in.
+ * @retval bool True if the rule number is valid.
+ */
+bool DigitalInterlock_Get(uint8_t number, DigitalInterlock_t* rule) {
+	if (number >= DIGITAL_INTERLOCK_MAX_RULES) {
+		return false;
+	}
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	*rule = rules[number];
+	__set_PRIMASK(primask);
+	return true;
+}
+
+/**
+ * Releases every latched interlock rule which has tripped. A rule whose input is still past its threshold trips again
+ * on its next sample.
+ *
+ * @param none
+ * @retval none
+ */
+void DigitalInterlock_Reset(void) {
+	for (uint_fast8_t i = 0U; i < DIGITAL_INTERLOCK_MAX_RULES; ++i) {
+		if (rules[i].latch == true) {
+			rules[i].tripped = false;
+		}
+	}
+	UpdateOverride();
+}
+
+/**
+ * Checks an analog sample against the interlock rules watching its input. Called from the DRDY interrupt for every
+ * sample of the scan.
+ *
+ * @param input PhysicalAnalogInput_t The input the sample was taken from.
+ * @param value int32_t The sample, in ADC counts.
+ * @param timestamp uint64_t The timestamp of the sample.
+ * @retval none
+ */
+void DigitalInterlock_ProcessAnalog(PhysicalAnalogInput_t input, int32_t value, uint64_t timestamp) {
+	uint32_t pending = analogRules;
+	bool changed = false;
+	while (pending != 0U) {
+		const uint_fast8_t i = 31U - __CLZ(pending);
+		pending &= ~(1UL << i);
+		if ((rules[i].input == (uint8_t) input) && (EvaluateRule(&rules[i], value, timestamp) == true)) {
+			changed = true;
+		}
+	}
+	if (changed == true) {
+		UpdateOverride();
+	}
+}
+
+/**
+ * Checks a digital input level against the interlock rules watching its input. Called whenever the input is sampled
+ * and from the edge capture interrupt.
+ *
+ * @param input GPI_TypeDef The input the level was read from.
+ * @param level DigitalLevel_t The level of the input.
+ * @param timestamp uint64_t The time the level was read.
+ * @retval none
+ */
+void DigitalInterlock_ProcessDigital(GPI_TypeDef input, DigitalLevel_t level, uint64_t timestamp) {
+	uint32_t pending = digitalRules;
+	bool changed = false;
+	const int32_t value = (level == LOGIC_HIGH) ? 1 : 0;
+	while (pending != 0U) {
+		const uint_fast8_t i = 31U - __CLZ(pending);
+		pending &= ~(1UL << i);
+		if ((rules[i].input == (uint8_t) input) && (EvaluateRule(&rules[i], value, timestamp) == true)) {
+			changed = true;
+		}
+	}
+	if (changed == true) {
+		UpdateOverride();
+	}
+}
+
+/**
+ * Convert a human readable string into the relevant DigitalInterlockComparator_t value.
+ *
+ * @param str const char* The string to convert.
+ * @retval DigitalInterlockComparator_t The comparator, or NUM_DIGITAL_INTERLOCK_COMPARATORS if the string is not
+ * recognized.
+ */
+DigitalInterlockComparator_t DigitalInterlock_StringToComparator(const char* str) {
+	for (uint_fast8_t i = 0U; i < NUM_DIGITAL_INTERLOCK_COMPARATORS; ++i) {
+		if (strcmp(str, COMPARATOR_STRINGS[i]) == 0) {
+			return (DigitalInterlockComparator_t) i;
+		}
+	}
+	return NUM_DIGITAL_INTERLOCK_COMPARATORS;
+}
+
+/**
+ * Convert a DigitalInterlockComparator_t value into a human readable string.
+ *
+ * @param comparator DigitalInterlockComparator_t The comparator to convert.
+ * @retval const char* The name of the comparator.
+ */
+const char* DigitalInterlock_ComparatorToString(DigitalInterlockComparator_t comparator) {
+	return (comparator < NUM_DIGITAL_INTERLOCK_COMPARATORS) ? COMPARATOR_STRINGS[comparator] : "UNKNOWN";
+}
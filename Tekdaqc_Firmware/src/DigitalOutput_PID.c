@@ -0,0 +1,297 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file DigitalOutput_PID.c
+ * @brief Implements the PID control loops of the digital outputs.
+ *
+ * Each loop is updated from the DRDY interrupt with every sample of its input, after the input's filter, and sets
+ * the PWM duty cycle of its output, so it runs at the input's rate in the scan. The arithmetic is all fixed point:
+ * an error of up to 25 bits times a gain of 32 bits fits the 64 bit products, so nothing saturates before the
+ * output is clamped.
+ *
+ * The derivative is taken of the input rather than of the error, so a change of setpoint does not kick the output.
+ * The integral is protected against windup in two ways: it is not accumulated on a sample whose output is clamped
+ * when doing so would push the output further past the limit, and it is itself kept within the output range.
+ *
+ * The loops only run while their input is sampled. When sampling stops their outputs are turned off, so a heater is
+ * never left on by a loop which is no longer watching its temperature. An interlock on the output takes precedence
+ * over the loop.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "DigitalOutput_PID.h"
+#include "Digital_Output.h"
+#include <math.h>
+
+#ifdef DIGITAL_PID_DEBUG
+#include <stdio.h>
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The largest magnitude of a gain, which keeps its fixed point value within 32 bits */
+#define PID_MAX_GAIN 32767.0f
+
+/* The integral at full output, with its fractional bits */
+#define PID_INTEGRAL_MAX (((int64_t) DIGITAL_PID_OUTPUT_MAX) << DIGITAL_PID_GAIN_BITS)
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The PID loops */
+static DigitalPID_t loops[DIGITAL_PID_MAX_LOOPS];
+
+/* Bit mask of the running loops, bit n for loop n */
+static volatile uint32_t activeLoops = 0U;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Converts a gain to fixed point.
+ */
+static bool ConvertGain(float gain, int32_t* fixed);
+
+/**
+ * @internal
+ * @brief Runs one update of a loop.
+ */
+static void UpdateLoop(DigitalPID_t* loop, int32_t value);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Converts a gain to a DIGITAL_PID_GAIN_BITS fixed point number, rounding to the nearest step.
+ *
+ * @param gain float The gain.
+ * @param fixed int32_t* Set to the fixed point gain.
+ * @retval bool True if the gain is within range.
+ */
+static bool ConvertGain(float gain, int32_t* fixed) {
+	if ((isfinite(gain) == 0) || (fabsf(gain) > PID_MAX_GAIN)) {
+		return false;
+	}
+	*fixed = (int32_t) lroundf(gain * (float) (1UL << DIGITAL_PID_GAIN_BITS));
+	return true;
+}
+
+/**
+ * Runs one update of a loop with a new sample of its input, setting the duty cycle of its output.
+ *
+ * @param loop DigitalPID_t* Pointer/Reference to the loop.
+ * @param value int32_t The sample of the loop's input.
+ * @retval none
+ */
+static void UpdateLoop(DigitalPID_t* loop, int32_t value) {
+	const int64_t error = (int64_t) loop->setpoint - value;
+	const int64_t change = (loop->primed == true) ? ((int64_t) value - loop->previous) : 0;
+	loop->previous = value;
+	loop->primed = true;
+	const int64_t proportional = loop->kp * error;
+	const int64_t derivative = -(loop->kd * change);
+	const int64_t step = loop->ki * error;
+	int64_t integral = loop->integral + step;
+	int64_t output = (proportional + integral + derivative) >> DIGITAL_PID_GAIN_BITS;
+	if (((output > DIGITAL_PID_OUTPUT_MAX) && (step > 0)) || ((output < 0) && (step < 0))) {
+		/* Accumulating would only wind the integral further past the limit */
+		integral = loop->integral;
+		output = (proportional + integral + derivative) >> DIGITAL_PID_GAIN_BITS;
+	}
+	if (integral > PID_INTEGRAL_MAX) {
+		integral = PID_INTEGRAL_MAX;
+	} else if (integral < 0) {
+		integral = 0;
+	}
+	loop->integral = integral;
+	if (output > DIGITAL_PID_OUTPUT_MAX) {
+		output = DIGITAL_PID_OUTPUT_MAX;
+		++(loop->saturations);
+	} else if (output < 0) {
+		output = 0;
+		++(loop->saturations);
+	}
+	loop->value = (int32_t) output;
+	SetDigitalOutputPwmDuty(loop->output, (uint16_t) output);
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Starts a PID loop, replacing any loop of the same number. The output must already be driven with a PWM waveform,
+ * whose duty cycle the loop then sets. The loop starts with no integral, so the first samples are controlled by the
+ * proportional gain alone.
+ *
+ * @param number uint8_t The number of the loop.
+ * @param input PhysicalAnalogInput_t The process variable input.
+ * @param output uint8_t The physical digital output, already modulated.
+ * @param setpoint int32_t The setpoint, in ADC counts.
+ * @param kp float The proportional gain, in 1/65536ths of full duty cycle per count.
+ * @param ki float The integral gain, in 1/65536ths of full duty cycle per count per sample.
+ * @param kd float The derivative gain, in 1/65536ths of full duty cycle per count of change per sample.
+ * @retval bool True if the loop was started.
+ */
+bool DigitalPID_Set(uint8_t number, PhysicalAnalogInput_t input, uint8_t output, int32_t setpoint, float kp, float ki,
+		float kd) {
+	DigitalPID_t loop;
+	if ((number >= DIGITAL_PID_MAX_LOOPS) || (input >= NUM_ANALOG_INPUTS) || (output >= NUM_DIGITAL_OUTPUTS)
+			|| (ConvertGain(kp, &loop.kp) == false) || (ConvertGain(ki, &loop.ki) == false)
+			|| (ConvertGain(kd, &loop.kd) == false)) {
+		return false;
+	}
+	for (uint_fast8_t i = 0U; i < DIGITAL_PID_MAX_LOOPS; ++i) {
+		if ((i != number) && (loops[i].enabled == true) && (loops[i].output == output)) {
+			/* An output can only follow one loop */
+			return false;
+		}
+	}
+	loop.input = input;
+	loop.output = output;
+	loop.setpoint = setpoint;
+	loop.integral = 0;
+	loop.primed = false;
+	loop.previous = 0;
+	loop.value = 0;
+	loop.saturations = 0U;
+	loop.enabled = true;
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	loops[number] = loop;
+	activeLoops |= (1UL << number);
+	__set_PRIMASK(primask);
+#ifdef DIGITAL_PID_DEBUG
+	printf("[Digital PID] Started loop %i driving output %i.\n\r", number, output);
+#endif
+	return true;
+}
+
+/**
+ * Changes the setpoint of a running PID loop. The integral is kept, so the output moves smoothly to the new setpoint.
+ *
+ * @param number uint8_t The number of the loop.
+ * @param setpoint int32_t The setpoint, in ADC counts.
+ * @retval bool True if the loop is running.
+ */
+bool DigitalPID_SetSetpoint(uint8_t number, int32_t setpoint) {
+	if ((number >= DIGITAL_PID_MAX_LOOPS) || (loops[number].enabled == false)) {
+		return false;
+	}
+	loops[number].setpoint = setpoint;
+	return true;
+}
+
+/**
+ * Stops a PID loop and sets the duty cycle of its output to 0, turning it off.
+ *
+ * @param number uint8_t The number of the loop.
+ * @retval bool True if the loop number is valid.
+ */
+bool DigitalPID_Clear(uint8_t number) {
+	if (number >= DIGITAL_PID_MAX_LOOPS) {
+		return false;
+	}
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	activeLoops &= ~(1UL << number);
+	if (loops[number].enabled == true) {
+		loops[number].enabled = false;
+		SetDigitalOutputPwmDuty(loops[number].output, 0U);
+	}
+	__set_PRIMASK(primask);
+	return true;
+}
+
+/**
+ * Retrieves a copy of a PID loop, with its current state.
+ *
+ * @param number uint8_t The number of the loop.
+ * @param loop DigitalPID_t* Pointer/Reference to the structure to fill in.
+ * @retval bool True if the loop number is valid.
+ */
+bool DigitalPID_Get(uint8_t number, DigitalPID_t* loop) {
+	if (number >= DIGITAL_PID_MAX_LOOPS) {
+		return false;
+	}
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	*loop = loops[number];
+	__set_PRIMASK(primask);
+	return true;
+}
+
+/**
+ * Restarts the integral and derivative of every PID loop, as when sampling starts, so no loop acts on the samples of
+ * an earlier run.
+ *
+ * @param none
+ * @retval none
+ */
+void DigitalPID_Reset(void) {
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	for (uint_fast8_t i = 0U; i < DIGITAL_PID_MAX_LOOPS; ++i) {
+		loops[i].integral = 0;
+		loops[i].primed = false;
+	}
+	__set_PRIMASK(primask);
+}
+
+/**
+ * Turns the output of every running PID loop off, as when sampling stops. The loops stay set up and take over their
+ * outputs again with the next sample of their inputs.
+ *
+ * @param none
+ * @retval none
+ */
+void DigitalPID_Hold(void) {
+	for (uint_fast8_t i = 0U; i < DIGITAL_PID_MAX_LOOPS; ++i) {
+		if (loops[i].enabled == true) {
+			loops[i].value = 0;
+			SetDigitalOutputPwmDuty(loops[i].output, 0U);
+		}
+	}
+}
+
+/**
+ * Updates the PID loops controlled by an analog input with a new sample. Called from the DRDY interrupt for every
+ * sample of the scan.
+ *
+ * @param input PhysicalAnalogInput_t The input the sample was taken from.
+ * @param value int32_t The sample, in ADC counts.
+ * @retval none
+ */
+void DigitalPID_Process(PhysicalAnalogInput_t input, int32_t value) {
+	uint32_t pending = activeLoops;
+	while (pending != 0U) {
+		const uint_fast8_t i = 31U - __CLZ(pending);
+		pending &= ~(1UL << i);
+		if (loops[i].input == input) {
+			UpdateLoop(&loops[i], value);
+		}
+	}
+}
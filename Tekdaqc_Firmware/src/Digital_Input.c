@@ -26,9 +26,14 @@
 
 #include "Tekdaqc_Debug.h"
 #include "Digital_Input.h"
+#include "DigitalInput_Edge.h"
+#include "DigitalInput_Encoder.h"
+#include "DigitalOutput_Interlock.h"
 #include "Tekdaqc_BSP.h"
 #include "Tekdaqc_CommandInterpreter.h"
 #include "Tekdaqc_Timers.h"
+#include "Tekdaqc_Format.h"
+#include "TelnetServer.h"
 #include "boolean.h"
 #include <stdlib.h>
 #include <string.h>
@@ -47,7 +52,184 @@
  * @def DIGITAL_INPUT_FORMATTER
  * @brief The message format string for printing a digital input to a human readable string.
  */
-#define DIGITAL_INPUT_FORMATTER "\n\r--------------------\n\rDigital Input\n\r\tName: %s\n\r\tPhysical Channel: %i\n\r\tTimestamp: %" PRIu64 "\n\r\tLevel: %s\n\r--------------------\n\r\x1E"
+#define DIGITAL_INPUT_FORMATTER "\n\r--------------------\n\rDigital Input\n\r\tName: %s\n\r\tPhysical Channel: %i\n\r\tTimestamp: %s\n\r\tLevel: %s\n\r--------------------\n\r\x1E"
+
+/**
+ * @internal
+ * @def DIGITAL_LIST_HEADER
+ * @brief The string opening the list of added digital inputs.
+ */
+#define DIGITAL_LIST_HEADER "\n\r----------\n\rAdded Digital Inputs\n\r----------\n\r"
+
+/**
+ * @internal
+ * @def DIGITAL_LIST_FORMAT
+ * @brief The format string for describing an input in the list of added digital inputs.
+ */
+#define DIGITAL_LIST_FORMAT "\tPhysical Input %" PRIi8 ":\n\r\t\tName: %s\n\r\t\tHold: %u ms\n\r"
+
+/**
+ * @internal
+ * @def DIGITAL_LIST_ENTRY_SIZE
+ * @brief The space kept for the rendered list description of each input.
+ */
+#define DIGITAL_LIST_ENTRY_SIZE			80U
+
+/**
+ * @internal
+ * @def DEBOUNCE_COUNTER_BITS
+ * @brief The number of bits of the debounce vertical counters, enough to count to MAX_DIGITAL_INPUT_HOLD_MS.
+ */
+#define DEBOUNCE_COUNTER_BITS	5U
+
+/**
+ * @internal
+ * @def DIGITAL_COUNTER_FORMATTER
+ * @brief The message format string for printing a digital input counter report to a human readable string.
+ */
+#define DIGITAL_COUNTER_FORMATTER "\n\r--------------------\n\rDigital Input Counter\n\r\tName: %s\n\r\tPhysical Channel: %i\n\r\tTimestamp: %s\n\r\tInterval: %" PRIu32 " us\n\r\tCount: %" PRIu32 "\n\r\tFrequency: %" PRIu32 ".%03" PRIu32 " Hz\n\r\tPeriod: %" PRIu32 " us\n\r--------------------\n\r\x1E"
+
+/**
+ * @internal
+ * @def DIGITAL_ENCODER_FORMATTER
+ * @brief The message format string for printing a quadrature encoder sample to a human readable string.
+ */
+#define DIGITAL_ENCODER_FORMATTER "\n\r--------------------\n\rDigital Input Encoder\n\r\tEncoder: %" PRIu8 "\n\r\tInputs: %i, %i\n\r\tTimestamp: %s\n\r\tPosition: %" PRIi32 "\n\r\tVelocity: %" PRIi32 " counts/s\n\r--------------------\n\r\x1E"
+
+/**
+ * @internal
+ * @def DIGITAL_LATCH_FORMATTER
+ * @brief The message format string for printing the latched edges of a scan to a human readable string.
+ */
+#define DIGITAL_LATCH_FORMATTER "\n\r--------------------\n\rDigital Input Latch\n\r\tTimestamp: %s\n\r\tRose: 0x%06" PRIX32 "\n\r\tFell: 0x%06" PRIX32 "\n\r--------------------\n\r\x1E"
+
+/*
+ * Binary scan framing. All multi-byte fields are little endian. Each call to WriteDigitalInputScan() produces one
+ * frame:
+ *
+ *   Frame:   [DIGITAL_BINARY_FRAME_START][length:2][records...]
+ *   Name:    [DIGITAL_BINARY_NAME_RECORD][input][length][name...]
+ *   Scan:    [DIGITAL_BINARY_SCAN_RECORD][timestamp:8][levels:3]
+ *   Encoder: [DIGITAL_BINARY_ENCODER_RECORD][encoder][position:4][velocity:4]
+ *   Latch:   [DIGITAL_BINARY_LATCH_RECORD][rose:3][fell:3]
+ *
+ * Bit n of the levels is set if GPIn was high. Only the bits of the scanned inputs are meaningful; a name record is
+ * sent for each of them before the first scan, whenever the set of scanned inputs changes and whenever an input is
+ * added or removed, so a client always knows which bits to read. The frame start byte is distinct from the analog
+ * frame start and from the first byte of every text message. An encoder record follows the scan for each
+ * enabled quadrature encoder, sampled at the scan's timestamp, its position and velocity being signed. While pulse
+ * latching is on, a latch record follows with bit n of rose and fell set if GPIn went high or low since the previous
+ * scan written out, so even a pulse too short to be seen in the levels is reported.
+ */
+
+/**
+ * @internal
+ * @def DIGITAL_BINARY_FRAME_START
+ * @brief The byte which begins every binary scan frame (ASCII file separator).
+ */
+#define DIGITAL_BINARY_FRAME_START		((uint8_t) 0x1C)
+
+/**
+ * @internal
+ * @def DIGITAL_BINARY_NAME_RECORD
+ * @brief The type byte which marks a name record.
+ */
+#define DIGITAL_BINARY_NAME_RECORD		((uint8_t) 0xFF)
+
+/**
+ * @internal
+ * @def DIGITAL_BINARY_SCAN_RECORD
+ * @brief The type byte which marks a scan record.
+ */
+#define DIGITAL_BINARY_SCAN_RECORD		((uint8_t) 0xFE)
+
+/**
+ * @internal
+ * @def DIGITAL_BINARY_ENCODER_RECORD
+ * @brief The type byte which marks an encoder record.
+ */
+#define DIGITAL_BINARY_ENCODER_RECORD	((uint8_t) 0xFD)
+
+/**
+ * @internal
+ * @def DIGITAL_BINARY_LATCH_RECORD
+ * @brief The type byte which marks a latch record.
+ */
+#define DIGITAL_BINARY_LATCH_RECORD		((uint8_t) 0xFC)
+
+/**
+ * @internal
+ * @def DIGITAL_BINARY_FRAME_HEADER_SIZE
+ * @brief The size in bytes of the binary frame header.
+ */
+#define DIGITAL_BINARY_FRAME_HEADER_SIZE	3U
+
+/**
+ * @internal
+ * @def DIGITAL_BINARY_NAME_HEADER_SIZE
+ * @brief The size in bytes of a binary name record, less the name.
+ */
+#define DIGITAL_BINARY_NAME_HEADER_SIZE	3U
+
+/**
+ * @internal
+ * @def DIGITAL_BINARY_SCAN_SIZE
+ * @brief The size in bytes of a binary scan record.
+ */
+#define DIGITAL_BINARY_SCAN_SIZE		12U
+
+/**
+ * @internal
+ * @def DIGITAL_BINARY_ENCODER_SIZE
+ * @brief The size in bytes of a binary encoder record.
+ */
+#define DIGITAL_BINARY_ENCODER_SIZE		10U
+
+/**
+ * @internal
+ * @def DIGITAL_BINARY_LATCH_SIZE
+ * @brief The size in bytes of a binary latch record.
+ */
+#define DIGITAL_BINARY_LATCH_SIZE		7U
+
+/**
+ * @internal
+ * @def DIGITAL_BINARY_BUFFER_SIZE
+ * @brief The size of the buffer a binary frame is built in, enough for a name record of every input, a scan, a record
+ * of every encoder and a latch record.
+ */
+#define DIGITAL_BINARY_BUFFER_SIZE		(DIGITAL_BINARY_FRAME_HEADER_SIZE + (NUM_DIGITAL_INPUTS * (DIGITAL_BINARY_NAME_HEADER_SIZE + MAX_DIGITAL_INPUT_NAME_LENGTH)) + DIGITAL_BINARY_SCAN_SIZE + (NUM_DIGITAL_ENCODERS * DIGITAL_BINARY_ENCODER_SIZE) + DIGITAL_BINARY_LATCH_SIZE)
+
+/* Expand GPI_PORT_TABLE and GPI_PIN_TABLE entries to the elements of the lookup tables below */
+#define GPI_PORT_REGISTERS(port) GPIO##port,
+#define GPI_PORT_SOURCE(port) EXTI_PortSourceGPIO##port,
+#define GPI_PORT_MASK(port) GPI_PORT_PINS(GPI_PORT_INDEX_##port),
+#define GPI_PIN_MAP_ENTRY(arg, n, pin, port) { GPI_PORT_INDEX_##port, pin },
+#define GPI_NAME(arg, n, pin, port) "GPI" #n,
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Location of a digital input's pin, as an index into GPI_PORTS and the pin's mask within that port.
+ */
+typedef struct {
+	uint8_t port; /**< Index of the GPIO port in GPI_PORTS. */
+	uint16_t pin; /**< The pin mask within the port. */
+} GPI_PinMap_t;
+
+/**
+ * @internal
+ * @brief Data structure caching the rendered list description of an input, with the settings it was rendered from.
+ */
+typedef struct {
+	char name[MAX_DIGITAL_INPUT_NAME_LENGTH]; /**< The name of the input when rendered. */
+	uint8_t hold; /**< The hold time of the input when rendered. */
+	uint8_t length; /**< The length of the description, 0 if none has been rendered. */
+	char text[DIGITAL_LIST_ENTRY_SIZE]; /**< The description. */
+} DigitalListEntry_t;
 
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE VARIABLES */
@@ -56,9 +238,61 @@
 /* The function pointer used for writing strings to the data connection */
 static WriteFunction writer = NULL;
 
+/*
+ * Debounce filter state. Each tick runs a vertical counter per input, bit b of every input's count being held in
+ * debounceCounters[b], so all 24 inputs are filtered together in a handful of word operations. An input's count runs
+ * while its pin differs from its debounced level and is cleared whenever they agree; when it reaches the input's hold
+ * time, also stored as bit planes, the debounced level takes the new value.
+ */
+
+/* The debounced level of each filtered input, bit n holding GPIn */
+static volatile uint32_t debouncedLevels = 0U;
+
+/* Mask of the inputs being debounced */
+static volatile uint32_t debounceMask = 0U;
+
+/* The bit planes of the vertical counters, updated on every debounce tick */
+static uint32_t debounceCounters[DEBOUNCE_COUNTER_BITS] CCM_DATA;
+
+/* The bit planes of the hold times */
+static uint32_t debounceHolds[DEBOUNCE_COUNTER_BITS];
+
+/* The function pointer used for writing binary frames to the data connection */
+static BinaryWriteFunction binaryWriter = NULL;
+
+/* TRUE once the names of the inputs in binaryNamesMask have been sent to a binary client */
+static bool binaryNamesSent = false;
+
+/* Mask of the inputs whose names were last sent to a binary client */
+static uint32_t binaryNamesMask = 0U;
+
+/* The buffer binary frames are built in */
+static uint8_t binaryFrame[DIGITAL_BINARY_BUFFER_SIZE];
+
+/* Number of digital input records which could not be written because the connection was busy */
+static unsigned long droppedWrites = 0U;
+
 /* List of external digital inputs */
 static Digital_Input_t Ext_DInputs[NUM_DIGITAL_INPUTS];
 
+/* The cached list description of each digital input */
+static DigitalListEntry_t digitalListCache[NUM_DIGITAL_INPUTS];
+
+/* The GPIO ports holding digital inputs, each read once per snapshot, indexed by GPI_PortIndex_t */
+static GPIO_TypeDef* const GPI_PORTS[NUM_GPI_PORTS] = { GPI_PORT_TABLE(GPI_PORT_REGISTERS) };
+
+/* The EXTI port source of each port in GPI_PORTS */
+static const uint8_t GPI_PORT_SOURCES[NUM_GPI_PORTS] = { GPI_PORT_TABLE(GPI_PORT_SOURCE) };
+
+/* The mask of the digital input pins on each port in GPI_PORTS */
+static const uint16_t GPI_PORT_MASKS[NUM_GPI_PORTS] = { GPI_PORT_TABLE(GPI_PORT_MASK) };
+
+/* The location of each digital input's pin, indexed by GPI_TypeDef */
+static const GPI_PinMap_t GPI_PIN_MAP[NUM_DIGITAL_INPUTS] = { GPI_PIN_TABLE(GPI_PIN_MAP_ENTRY, ~) };
+
+/* The name of each digital input, indexed by GPI_TypeDef */
+static const char* const GPI_NAMES[NUM_DIGITAL_INPUTS] = { GPI_PIN_TABLE(GPI_NAME, ~) };
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE FUNCTION PROTOTYPES */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -75,6 +309,24 @@ static inline const char* GPIToString(GPI_TypeDef gpi);
  */
 static DigitalLevel_t ReadGPI_Pin(GPI_TypeDef gpi);
 
+/**
+ * @internal
+ * @brief Reads the logic level of every GPI pin at once.
+ */
+static uint32_t ReadGPI_Word(void);
+
+/**
+ * @internal
+ * @brief Reads the levels of all GPI pins, debounced where configured.
+ */
+static uint32_t ReadFilteredWord(void);
+
+/**
+ * @internal
+ * @brief Rebuilds the debounce filter from the hold times of the added inputs.
+ */
+static void ConfigureDebounce(void);
+
 /**
  * @internal
  * @brief Checks if the specified input is an external input.
@@ -93,6 +345,24 @@ static void InitializeInput(Digital_Input_t* input);
  */
 static void RemoveDigitalInputByID(uint8_t id);
 
+/**
+ * @internal
+ * @brief Packs a little endian value into a buffer.
+ */
+static uint8_t PackLittleEndian(uint8_t* dest, uint64_t value, uint8_t size);
+
+/**
+ * @internal
+ * @brief Writes a scan of a set of inputs as a binary frame.
+ */
+static WriteStatus_t WriteDigitalInputScanBinary(Digital_Input_t* inputs[], uint_fast8_t count);
+
+/**
+ * @internal
+ * @brief Retrieves the list description of an input, rendering it only if the input has changed since it last was.
+ */
+static const DigitalListEntry_t* GetDigitalListEntry(const Digital_Input_t* input);
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE FUNCTIONS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -104,9 +374,7 @@ static void RemoveDigitalInputByID(uint8_t id);
  * @retval const char* The human readable string.
  */
 static inline const char* GPIToString(GPI_TypeDef gpi) {
-	static const char* strings[] = { "GPI0", "GPI1", "GPI2", "GPI3", "GPI4", "GPI5", "GPI6", "GPI7", "GPI8", "GPI9", "GPI10", "GPI11",
-			"GPI12", "GPI13", "GPI14", "GPI15", "GPI16", "GPI17", "GPI18", "GPI19", "GPI20", "GPI21", "GPI22", "GPI23" };
-	return strings[gpi];
+	return GPI_NAMES[gpi];
 }
 
 /**
@@ -116,88 +384,83 @@ static inline const char* GPIToString(GPI_TypeDef gpi) {
  * @retval DigitalLevel_t The digital logic level of the input pin.
  */
 static DigitalLevel_t ReadGPI_Pin(GPI_TypeDef gpi) {
-	uint8_t state = 0;
-	switch (gpi) {
-	case GPI0:
-		state = GPIO_ReadInputDataBit(GPI0_GPIO_PORT, GPI0_PIN );
-		break;
-	case GPI1:
-		state = GPIO_ReadInputDataBit(GPI1_GPIO_PORT, GPI1_PIN );
-		break;
-	case GPI2:
-		state = GPIO_ReadInputDataBit(GPI2_GPIO_PORT, GPI2_PIN );
-		break;
-	case GPI3:
-		state = GPIO_ReadInputDataBit(GPI3_GPIO_PORT, GPI3_PIN );
-		break;
-	case GPI4:
-		state = GPIO_ReadInputDataBit(GPI4_GPIO_PORT, GPI4_PIN );
-		break;
-	case GPI5:
-		state = GPIO_ReadInputDataBit(GPI5_GPIO_PORT, GPI5_PIN );
-		break;
-	case GPI6:
-		state = GPIO_ReadInputDataBit(GPI6_GPIO_PORT, GPI6_PIN );
-		break;
-	case GPI7:
-		state = GPIO_ReadInputDataBit(GPI7_GPIO_PORT, GPI7_PIN );
-		break;
-	case GPI8:
-		state = GPIO_ReadInputDataBit(GPI8_GPIO_PORT, GPI8_PIN );
-		break;
-	case GPI9:
-		state = GPIO_ReadInputDataBit(GPI9_GPIO_PORT, GPI9_PIN );
-		break;
-	case GPI10:
-		state = GPIO_ReadInputDataBit(GPI10_GPIO_PORT, GPI10_PIN );
-		break;
-	case GPI11:
-		state = GPIO_ReadInputDataBit(GPI11_GPIO_PORT, GPI11_PIN );
-		break;
-	case GPI12:
-		state = GPIO_ReadInputDataBit(GPI12_GPIO_PORT, GPI12_PIN );
-		break;
-	case GPI13:
-		state = GPIO_ReadInputDataBit(GPI13_GPIO_PORT, GPI13_PIN );
-		break;
-	case GPI14:
-		state = GPIO_ReadInputDataBit(GPI14_GPIO_PORT, GPI14_PIN );
-		break;
-	case GPI15:
-		state = GPIO_ReadInputDataBit(GPI15_GPIO_PORT, GPI15_PIN );
-		break;
-	case GPI16:
-		state = GPIO_ReadInputDataBit(GPI16_GPIO_PORT, GPI16_PIN );
-		break;
-	case GPI17:
-		state = GPIO_ReadInputDataBit(GPI17_GPIO_PORT, GPI17_PIN );
-		break;
-	case GPI18:
-		state = GPIO_ReadInputDataBit(GPI18_GPIO_PORT, GPI18_PIN );
-		break;
-	case GPI19:
-		state = GPIO_ReadInputDataBit(GPI19_GPIO_PORT, GPI19_PIN );
-		break;
-	case GPI20:
-		state = GPIO_ReadInputDataBit(GPI20_GPIO_PORT, GPI20_PIN );
-		break;
-	case GPI21:
-		state = GPIO_ReadInputDataBit(GPI21_GPIO_PORT, GPI21_PIN );
-		break;
-	case GPI22:
-		state = GPIO_ReadInputDataBit(GPI22_GPIO_PORT, GPI22_PIN );
-		break;
-	case GPI23:
-		state = GPIO_ReadInputDataBit(GPI23_GPIO_PORT, GPI23_PIN );
-		break;
-	default:
-		/* TODO: Throw an error */
-		break;
-	}
-	if (state) {
-		return LOGIC_HIGH;
-	} else {
-		return LOGIC_LOW;
+	if (gpi < NUM_DIGITAL_INPUTS) {
+		const GPI_PinMap_t* map = &GPI_PIN_MAP[gpi];
+		if ((GPI_PORTS[map->port]->IDR & map->pin) != 0U) {
+			return LOGIC_HIGH;
+		}
+	}
+	return LOGIC_LOW;
+}
+
+/**
+ * Reads the input data register of each GPI port once and gathers the pins into a single word, bit n holding the level
+ * of GPIn. All inputs are captured within a few bus cycles of each other, rather than one peripheral access per input.
+ *
+ * @param none
+ * @retval uint32_t The levels of all GPI pins, a set bit being LOGIC_HIGH.
+ */
+static uint32_t ReadGPI_Word(void) {
+	uint16_t snapshot[NUM_GPI_PORTS];
+	for (uint_fast8_t i = 0U; i < NUM_GPI_PORTS; ++i) {
+		snapshot[i] = (uint16_t) GPI_PORTS[i]->IDR;
+	}
+	uint32_t word = 0U;
+	for (uint_fast8_t i = 0U; i < NUM_DIGITAL_INPUTS; ++i) {
+		if ((snapshot[GPI_PIN_MAP[i].port] & GPI_PIN_MAP[i].pin) != 0U) {
+			word |= (1UL << i);
+		}
+	}
+	return word;
+}
+
+/**
+ * Reads the levels of all GPI pins at once, substituting the debounced level for each input with a hold time.
+ *
+ * @param none
+ * @retval uint32_t The levels of all GPI pins, a set bit being LOGIC_HIGH.
+ */
+static uint32_t ReadFilteredWord(void) {
+	const uint32_t mask = debounceMask;
+	return (ReadGPI_Word() & ~mask) | (debouncedLevels & mask);
+}
+
+/**
+ * Rebuilds the debounce filter from the hold times of the added inputs, starting the filter tick when the first input
+ * is debounced and stopping it after the last. Newly debounced inputs start from their current pin level.
+ *
+ * @param none
+ * @retval none
+ */
+static void ConfigureDebounce(void) {
+	uint32_t mask = 0U;
+	uint32_t holds[DEBOUNCE_COUNTER_BITS] = { 0U };
+	for (uint_fast8_t i = 0U; i < NUM_DIGITAL_INPUTS; ++i) {
+		const Digital_Input_t* input = &Ext_DInputs[i];
+		if ((input->added == CHANNEL_ADDED) && (input->hold > 0U)) {
+			mask |= (1UL << i);
+			for (uint_fast8_t b = 0U; b < DEBOUNCE_COUNTER_BITS; ++b) {
+				if ((input->hold & (1U << b)) != 0U) {
+					holds[b] |= (1UL << i);
+				}
+			}
+		}
+	}
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	const uint32_t added = mask & ~debounceMask;
+	debouncedLevels = (debouncedLevels & ~added) | (ReadGPI_Word() & added);
+	for (uint_fast8_t b = 0U; b < DEBOUNCE_COUNTER_BITS; ++b) {
+		debounceHolds[b] = holds[b];
+		debounceCounters[b] &= mask & ~added;
+	}
+	debounceMask = mask;
+	__set_PRIMASK(primask);
+	if (mask == 0U) {
+		SysTick->CTRL = 0U;
+	} else if ((SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) == 0U) {
+		/* SysTick_Config() leaves the tick at the lowest priority */
+		SysTick_Config(SystemCoreClock / DIGITAL_INPUT_DEBOUNCE_TICK_HZ);
 	}
 }
 
@@ -225,6 +488,7 @@ static void InitializeInput(Digital_Input_t* input) {
 	input->added = CHANNEL_NOTADDED;
 	input->level = LOGIC_LOW;
 	input->timestamp = 0U;
+	input->hold = 0U;
 	strcpy(input->name, "NONE");
 	input->input = NULL_CHANNEL;
 }
@@ -238,6 +502,8 @@ static void InitializeInput(Digital_Input_t* input) {
 static void RemoveDigitalInputByID(uint8_t id) {
 	if (isExternalInput(id)) {
 		InitializeInput(&Ext_DInputs[id]);
+		binaryNamesSent = false;
+		ConfigureDebounce();
 	} else {
 		/* This is out of range */
 #ifdef DIGITALINPUT_DEBUG
@@ -246,6 +512,129 @@ static void RemoveDigitalInputByID(uint8_t id) {
 	}
 }
 
+/**
+ * Packs the low bytes of a value into a buffer, least significant byte first.
+ *
+ * @param dest uint8_t* The buffer to write to.
+ * @param value uint64_t The value to pack.
+ * @param size uint8_t The number of bytes to write.
+ * @retval uint8_t The number of bytes written.
+ */
+static uint8_t PackLittleEndian(uint8_t* dest, uint64_t value, uint8_t size) {
+	for (uint_fast8_t i = 0U; i < size; ++i) {
+		dest[i] = (uint8_t) (value >> (8U * i));
+	}
+	return size;
+}
+
+/**
+ * Writes a scan of a set of inputs as a single binary frame, preceded by their names if the client does not yet know
+ * them. The inputs must have been sampled together, the scan taking its timestamp from the first of them.
+ *
+ * @param inputs Digital_Input_t*[] The scanned inputs. NULL entries are skipped.
+ * @param count uint_fast8_t The number of entries in inputs.
+ * @retval WriteStatus_t The result of the write.
+ */
+static WriteStatus_t WriteDigitalInputScanBinary(Digital_Input_t* inputs[], uint_fast8_t count) {
+	if (binaryWriter == NULL) {
+		return WRITE_NOT_CONNECTED;
+	}
+	uint32_t mask = 0U;
+	uint32_t levels = 0U;
+	uint64_t timestamp = 0U;
+	for (uint_fast8_t i = count; i > 0U; --i) {
+		const Digital_Input_t* input = inputs[i - 1U];
+		if ((input != NULL) && (input->input < NUM_DIGITAL_INPUTS)) {
+			mask |= (1UL << input->input);
+			if (input->level == LOGIC_HIGH) {
+				levels |= (1UL << input->input);
+			}
+			timestamp = input->timestamp;
+		}
+	}
+	if (mask == 0U) {
+		return WRITE_NOT_CONNECTED;
+	}
+	uint16_t length = DIGITAL_BINARY_FRAME_HEADER_SIZE;
+	const bool sendNames = (binaryNamesSent == false) || (mask != binaryNamesMask);
+	if (sendNames == true) {
+		for (uint_fast8_t i = 0U; i < NUM_DIGITAL_INPUTS; ++i) {
+			if ((mask & (1UL << i)) != 0U) {
+				const uint8_t nameLength = (uint8_t) Format_BoundedLength(Ext_DInputs[i].name, MAX_DIGITAL_INPUT_NAME_LENGTH);
+				binaryFrame[length++] = DIGITAL_BINARY_NAME_RECORD;
+				binaryFrame[length++] = (uint8_t) i;
+				binaryFrame[length++] = nameLength;
+				memcpy(&binaryFrame[length], Ext_DInputs[i].name, nameLength);
+				length += nameLength;
+			}
+		}
+	}
+	binaryFrame[length++] = DIGITAL_BINARY_SCAN_RECORD;
+	length += PackLittleEndian(&binaryFrame[length], Timer_ToEpochTime(timestamp), 8U);
+	length += PackLittleEndian(&binaryFrame[length], levels, 3U);
+	for (uint_fast8_t i = 0U; i < NUM_DIGITAL_ENCODERS; ++i) {
+		const Digital_Input_Encoder_t* encoder = DigitalEncoder_GetSample(i);
+		if (encoder != NULL) {
+			binaryFrame[length++] = DIGITAL_BINARY_ENCODER_RECORD;
+			binaryFrame[length++] = encoder->encoder;
+			length += PackLittleEndian(&binaryFrame[length], (uint32_t) encoder->position, 4U);
+			length += PackLittleEndian(&binaryFrame[length], (uint32_t) encoder->velocity, 4U);
+		}
+	}
+	uint32_t rose = 0U;
+	uint32_t fell = 0U;
+	const bool latched = DigitalEdge_GetLatched(&rose, &fell);
+	if (latched == true) {
+		binaryFrame[length++] = DIGITAL_BINARY_LATCH_RECORD;
+		length += PackLittleEndian(&binaryFrame[length], rose & mask, 3U);
+		length += PackLittleEndian(&binaryFrame[length], fell & mask, 3U);
+	}
+	binaryFrame[0] = DIGITAL_BINARY_FRAME_START;
+	PackLittleEndian(&binaryFrame[1], length - DIGITAL_BINARY_FRAME_HEADER_SIZE, 2U);
+	const WriteStatus_t status = binaryWriter(binaryFrame, length);
+	if (status == WRITE_OK) {
+		if (sendNames == true) {
+			binaryNamesSent = true;
+			binaryNamesMask = mask;
+		}
+		if (latched == true) {
+			DigitalEdge_ClearLatched();
+		}
+	} else if (status == WRITE_BUSY) {
+		++droppedWrites;
+	}
+	return status;
+}
+
+/**
+ * @internal
+ * Retrieves the list description of an added input. The description is only rendered again when the name or hold
+ * time it was rendered from has changed.
+ *
+ * @param input const Digital_Input_t* The input to describe.
+ * @retval const DigitalListEntry_t* The description, NULL if it could not be rendered.
+ */
+static const DigitalListEntry_t* GetDigitalListEntry(const Digital_Input_t* input) {
+	DigitalListEntry_t* entry = &digitalListCache[input->input];
+	if ((entry->length > 0U) && (entry->hold == input->hold)
+			&& (strncmp(entry->name, input->name, sizeof(entry->name)) == 0)) {
+		return entry;
+	}
+	const int n = snprintf(entry->text, sizeof(entry->text), DIGITAL_LIST_FORMAT, input->input, input->name,
+			(unsigned int) input->hold);
+	if ((n <= 0) || (n >= (int) sizeof(entry->text))) {
+#ifdef DIGITALINPUT_DEBUG
+		printf("Failed to write an digital input to the list.\n\r");
+#endif
+		entry->length = 0U;
+		return NULL;
+	}
+	strncpy(entry->name, input->name, sizeof(entry->name));
+	entry->hold = input->hold;
+	entry->length = (uint8_t) n;
+	return entry;
+}
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PUBLIC METHODS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -267,33 +656,11 @@ void DigitalInputsInit(void) {
 	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN;
 	GPIO_InitStructure.GPIO_PuPd = GPIO_PuPd_NOPULL;
 
-	/* Configure the Port B Pins */
-	GPIO_InitStructure.GPIO_Pin = GPI_PORTB_PINS;
-	GPIO_Init(GPIOB, &GPIO_InitStructure);
-
-	/* Configure the Port C Pins */
-	GPIO_InitStructure.GPIO_Pin = GPI_PORTC_PINS;
-	GPIO_Init(GPIOC, &GPIO_InitStructure);
-
-	/* Configure the Port E Pins */
-	GPIO_InitStructure.GPIO_Pin = GPI_PORTE_PINS;
-	GPIO_Init(GPIOE, &GPIO_InitStructure);
-
-	/* Configure the Port F Pins */
-	GPIO_InitStructure.GPIO_Pin = GPI_PORTF_PINS;
-	GPIO_Init(GPIOF, &GPIO_InitStructure);
-
-	/* Configure the Port G Pins */
-	GPIO_InitStructure.GPIO_Pin = GPI_PORTG_PINS;
-	GPIO_Init(GPIOG, &GPIO_InitStructure);
-
-	/* Configure the Port H Pins */
-	GPIO_InitStructure.GPIO_Pin = GPI_PORTH_PINS;
-	GPIO_Init(GPIOH, &GPIO_InitStructure);
-
-	/* Configure the Port I Pins */
-	GPIO_InitStructure.GPIO_Pin = GPI_PORTI_PINS;
-	GPIO_Init(GPIOI, &GPIO_InitStructure);
+	/* Configure the pins of each port */
+	for (uint_fast8_t i = 0U; i < NUM_GPI_PORTS; ++i) {
+		GPIO_InitStructure.GPIO_Pin = GPI_PORT_MASKS[i];
+		GPIO_Init(GPI_PORTS[i], &GPIO_InitStructure);
+	}
 
 	for (int i = 0; i < NUM_DIGITAL_INPUTS; ++i) {
 		InitializeInput(&Ext_DInputs[i]);
@@ -301,45 +668,86 @@ void DigitalInputsInit(void) {
 }
 
 /**
- * Prints a human readable representation of all the added digital inputs via the current write function.
+ * Prints a human readable representation of all the added digital inputs via the current write function. Each
+ * input's description is cached until it changes and the list is gathered into as few writes as possible.
  *
  * @param none
  * @return Tekdaqc_Function_Error_t The error status of this function.
  */
 Tekdaqc_Function_Error_t ListDigitalInputs(void) {
-	Tekdaqc_Function_Error_t retval = ERR_FUNCTION_OK;
-	uint8_t n = snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "\n\r----------\n\rAdded Digital Inputs\n\r----------\n\r");
-	if (n <= 0) {
-#ifdef DIGITALINPUT_DEBUG
-		printf("Failed to write header of digital input list.\n\r");
-#endif
-		retval = ERR_DIN_FAILED_WRITE;
-	} else {
-		if (writer != 0) {
+	if (writer == 0) {
+		return ERR_FUNCTION_OK;
+	}
+	uint16_t length = sizeof(DIGITAL_LIST_HEADER) - 1U;
+	memcpy(TOSTRING_BUFFER, DIGITAL_LIST_HEADER, sizeof(DIGITAL_LIST_HEADER));
+	for (uint_fast8_t i = 0U; i < NUM_DIGITAL_INPUTS; ++i) {
+		if (Ext_DInputs[i].added != CHANNEL_ADDED) {
+			continue;
+		}
+		const DigitalListEntry_t* entry = GetDigitalListEntry(&Ext_DInputs[i]);
+		if (entry == NULL) {
+			return ERR_DIN_FAILED_WRITE;
+		}
+		if ((length + entry->length) >= SIZE_TOSTRING_BUFFER) {
+			/* Send what is gathered and start again */
+			if (writer(TOSTRING_BUFFER) != WRITE_OK) {
+				return ERR_DIN_FAILED_WRITE;
+			}
+			length = 0U;
+		}
+		memcpy(&TOSTRING_BUFFER[length], entry->text, entry->length);
+		length += entry->length;
+		TOSTRING_BUFFER[length] = '\0';
+	}
+	return (writer(TOSTRING_BUFFER) == WRITE_OK) ? ERR_FUNCTION_OK : ERR_DIN_FAILED_WRITE;
+}
+
+/**
+ * Prints the most recently sampled level of every added digital input via the current write function, without
+ * sampling them. Inputs which have not been sampled are listed as NONE.
+ *
+ * @param none
+ * @return Tekdaqc_Function_Error_t The error status of this function.
+ */
+Tekdaqc_Function_Error_t WriteLatestDigitalValues(void) {
+	if (writer == 0) {
+		return ERR_DIN_FAILED_WRITE;
+	}
+	int length = snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "\n\r--------------------\n\rLatest Digital Values\n\r");
+	char line[48];
+	for (uint_fast8_t i = 0U; (i < NUM_DIGITAL_INPUTS) && (length > 0); ++i) {
+		const Digital_Input_t* input = &Ext_DInputs[i];
+		if (input->added != CHANNEL_ADDED) {
+			continue;
+		}
+		int n;
+		if (input->timestamp == 0U) {
+			n = snprintf(line, sizeof(line), "\t%" PRIu8 ": NONE\n\r", (uint8_t) i);
+		} else {
+			char timestamp[FORMAT_UINT64_MAX_LENGTH + 1U];
+			Format_UInt64(timestamp, Timer_ToEpochTime(input->timestamp));
+			n = snprintf(line, sizeof(line), "\t%" PRIu8 ": %s @ %s\n\r", (uint8_t) i, DigitalLevelToString(input->level),
+					timestamp);
+		}
+		if (n <= 0) {
+			length = n;
+			break;
+		}
+		if ((length + n) >= (int) SIZE_TOSTRING_BUFFER) {
+			/* Send what is gathered and start again */
 			writer(TOSTRING_BUFFER);
+			length = 0;
 		}
-		Digital_Input_t input;
-		for (uint_fast8_t i = 0U; i < NUM_DIGITAL_INPUTS; ++i) {
-			input = Ext_DInputs[i];
-			if (input.added == CHANNEL_ADDED) {
-				/* This input has been added */
-				n = snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "\tPhysical Input %" PRIi8 ":\n\r\t\tName: %s\n\r", input.input,
-						input.name);
-				if (n <= 0) {
+		memcpy(&TOSTRING_BUFFER[length], line, (size_t) n + 1U);
+		length += n;
+	}
+	if (length <= 0) {
 #ifdef DIGITALINPUT_DEBUG
-					printf("Failed to write an digital input to the list.\n\r");
+		printf("Failed to write the latest value of a digital input.\n\r");
 #endif
-					retval = ERR_DIN_FAILED_WRITE;
-					break;
-				} else {
-					if (writer != 0) {
-						writer(TOSTRING_BUFFER);
-					}
-				}
-			}
-		}
+		return ERR_DIN_FAILED_WRITE;
 	}
-	return retval;
+	return (writer(TOSTRING_BUFFER) == WRITE_OK) ? ERR_FUNCTION_OK : ERR_DIN_FAILED_WRITE;
 }
 
 /**
@@ -359,6 +767,7 @@ Tekdaqc_Function_Error_t CreateDigitalInput(char keys[][MAX_COMMANDPART_LENGTH],
 	uint8_t input = NULL_CHANNEL; /* The physical input */
 	uint8_t in = 255U;
 	char name[MAX_DIGITAL_INPUT_NAME_LENGTH]; /* The name */
+	uint8_t hold = 0U; /* The debounce hold time */
 	strcpy(name, "NONE");
 	for (int i = 0; i < NUM_ADD_DIGITAL_INPUT_PARAMS; ++i) {
 		index = GetIndexOfArgument(keys, ADD_DIGITAL_INPUT_PARAMS[i], count);
@@ -385,11 +794,23 @@ Tekdaqc_Function_Error_t CreateDigitalInput(char keys[][MAX_COMMANDPART_LENGTH],
 			case 1U: /* NAME key */
 				strcpy(name, param);
 				break;
+			case 2U: { /* HOLD key */
+				const unsigned long ms = strtoul(param, &testPtr, 10);
+				if ((testPtr == param) || (ms > MAX_DIGITAL_INPUT_HOLD_MS)) {
+#ifdef DIGITALINPUT_DEBUG
+					printf("[Digital Input] The requested hold time is invalid.\n\r");
+#endif
+					retval = ERR_DIN_PARSE_ERROR;
+				} else {
+					hold = (uint8_t) ms;
+				}
+				break;
+			}
 			default:
 				retval = ERR_DIN_PARSE_ERROR;
 			}
-		} else if (i == 1U) {
-			/* The NAME key is not strictly required, apply the defaults */
+		} else if (i >= 1U) {
+			/* The NAME and HOLD keys are not strictly required, apply the defaults */
 			continue;
 		} else {
 			/* Somehow an error happened */
@@ -409,6 +830,7 @@ Tekdaqc_Function_Error_t CreateDigitalInput(char keys[][MAX_COMMANDPART_LENGTH],
 				if (dig_input->added == CHANNEL_NOTADDED) {
 					dig_input->input = input;
 					strcpy(dig_input->name, name);
+					dig_input->hold = hold;
 					dig_input->level = LOGIC_LOW;
 					dig_input->timestamp = 0U;
 					AddDigitalInput(dig_input);
@@ -438,6 +860,8 @@ void AddDigitalInput(Digital_Input_t* input) {
 	if (index < NUM_DIGITAL_INPUTS) {
 		/* This is a valid digital input */
 		input->added = CHANNEL_ADDED;
+		binaryNamesSent = false;
+		ConfigureDebounce();
 #ifdef DIGITALINPUT_DEBUG
 		printf("[Digital Input] Added input to external inputs list.\n\r");
 #endif
@@ -518,28 +942,153 @@ Digital_Input_t* GetDigitalInputByNumber(uint8_t number) {
 }
 
 /**
- * Reads the state of a digital input and stores it in the internal buffer.
+ * Reads the state of a digital input and stores it in the internal buffer. The interlocks watching the input are
+ * checked against the new level.
  *
  * @param input Digital_Input_t The data structure of the digital input to sample.
  * @retval none
  */
 void SampleDigitalInput(Digital_Input_t* input) {
 	input->timestamp = GetLocalTime();
-	input->level = ReadGPI_Pin(input->input);
+	DigitalEdge_LatchScan();
+	DigitalEncoder_Sample(input->timestamp);
+	if ((input->input < NUM_DIGITAL_INPUTS) && ((debounceMask & (1UL << input->input)) != 0U)) {
+		input->level = ((debouncedLevels & (1UL << input->input)) != 0U) ? LOGIC_HIGH : LOGIC_LOW;
+	} else {
+		input->level = ReadGPI_Pin(input->input);
+	}
+	DigitalInterlock_ProcessDigital(input->input, input->level, input->timestamp);
+}
+
+/**
+ * Reads the levels of all the digital inputs from a single snapshot of the GPI ports, debounced where configured,
+ * without recording them, so it may be called from interrupts which need the digital state, such as the DRDY
+ * interrupt capturing it with an analog scan.
+ *
+ * @param none
+ * @retval uint32_t The levels of the inputs, bit n set if GPIn is high.
+ */
+uint32_t ReadDigitalInputLevels(void) {
+	return ReadFilteredWord();
+}
+
+/**
+ * Reads the current level of a digital input without recording it, so it may be called from interrupts which need to
+ * know the level, such as the analog capture trigger. The pin is read directly, without debouncing, so edges are seen
+ * as soon as they happen.
+ *
+ * @param input const Digital_Input_t* The data structure of the digital input to read.
+ * @retval DigitalLevel_t The digital logic level of the input.
+ */
+DigitalLevel_t ReadDigitalInputLevel(const Digital_Input_t* input) {
+	return ReadGPI_Pin(input->input);
+}
+
+/**
+ * Runs one tick of the debounce filter over a snapshot of the GPI ports. Called from the SysTick interrupt at
+ * DIGITAL_INPUT_DEBOUNCE_TICK_HZ while any input is debounced, so a hold time is a number of ticks.
+ *
+ * @param none
+ * @retval none
+ */
+void DigitalInputsDebounceTick(void) {
+	const uint32_t delta = (ReadGPI_Word() ^ debouncedLevels) & debounceMask;
+	uint32_t carry = delta;
+	uint32_t reached = delta;
+	for (uint_fast8_t b = 0U; b < DEBOUNCE_COUNTER_BITS; ++b) {
+		/* Clear the counts of inputs matching their debounced level, then count the others up by one */
+		const uint32_t plane = debounceCounters[b] & delta;
+		debounceCounters[b] = plane ^ carry;
+		carry &= plane;
+		reached &= ~(debounceCounters[b] ^ debounceHolds[b]);
+	}
+	debouncedLevels ^= reached;
+	for (uint_fast8_t b = 0U; b < DEBOUNCE_COUNTER_BITS; ++b) {
+		debounceCounters[b] &= ~reached;
+	}
+}
+
+/**
+ * Retrieves the pin of a digital input, for routing it to its external interrupt line.
+ *
+ * @param input const Digital_Input_t* The digital input to locate.
+ * @param portSource uint8_t* Set to the EXTI port source of the input's GPIO port.
+ * @param pin uint16_t* Set to the input's pin mask, which is also the mask of its EXTI line.
+ * @retval bool FALSE if the input is not a physical input.
+ */
+bool GetDigitalInputPin(const Digital_Input_t* input, uint8_t* portSource, uint16_t* pin) {
+	if (input->input >= NUM_DIGITAL_INPUTS) {
+		return false;
+	}
+	const GPI_PinMap_t* map = &GPI_PIN_MAP[input->input];
+	*portSource = GPI_PORT_SOURCES[map->port];
+	*pin = map->pin;
+	return true;
 }
 
 /**
- * Reads the state of all digital inputs which have been added to the device and stores the result in the respective internal buffers.
+ * Connects a digital input's pin to a peripheral through one of its alternate functions, or back to a plain input.
+ * The input data register still follows the pin while it is connected, so the input can be sampled as usual.
+ *
+ * @param gpi GPI_TypeDef The digital input to connect.
+ * @param alternate bool TRUE to connect the pin to the alternate function, FALSE to make it a plain input again.
+ * @param af uint8_t The GPIO_AF_* alternate function to connect the pin to.
+ * @retval none
+ */
+void SetDigitalInputPinFunction(GPI_TypeDef gpi, bool alternate, uint8_t af) {
+	if (gpi >= NUM_DIGITAL_INPUTS) {
+		return;
+	}
+	const GPI_PinMap_t* map = &GPI_PIN_MAP[gpi];
+	GPIO_InitTypeDef GPIO_InitStructure;
+	GPIO_InitStructure.GPIO_Pin = map->pin;
+	GPIO_InitStructure.GPIO_Mode = (alternate == true) ? GPIO_Mode_AF : GPIO_Mode_IN;
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_2MHz;
+	GPIO_InitStructure.GPIO_OType = GPIO_OType_PP;
+	GPIO_InitStructure.GPIO_PuPd = GPIO_PuPd_NOPULL;
+	if (alternate == true) {
+		GPIO_PinAFConfig(GPI_PORTS[map->port], (uint16_t) (31U - __CLZ(map->pin)), af);
+	}
+	GPIO_Init(GPI_PORTS[map->port], &GPIO_InitStructure);
+}
+
+/**
+ * Reads the state of a set of digital inputs from a single snapshot of the GPI ports, so they all share the same instant
+ * and timestamp, and stores the results in their internal buffers.
+ *
+ * @param inputs Digital_Input_t*[] The inputs to sample. NULL entries are skipped.
+ * @param count uint_fast8_t The number of entries in inputs.
+ * @retval none
+ */
+void SampleDigitalInputs(Digital_Input_t* inputs[], uint_fast8_t count) {
+	const uint64_t timestamp = GetLocalTime();
+	const uint32_t word = ReadFilteredWord();
+	DigitalEdge_LatchScan();
+	DigitalEncoder_Sample(timestamp);
+	for (uint_fast8_t i = 0U; i < count; ++i) {
+		Digital_Input_t* input = inputs[i];
+		if ((input != NULL) && (input->input < NUM_DIGITAL_INPUTS)) {
+			input->timestamp = timestamp;
+			input->level = ((word & (1UL << input->input)) != 0U) ? LOGIC_HIGH : LOGIC_LOW;
+		}
+	}
+}
+
+/**
+ * Reads the state of all digital inputs which have been added to the device from a single snapshot of the GPI ports
+ * and stores the result in the respective internal buffers.
  *
  * @param none
  * @retval none
  */
 void SampleAllDigitalInputs(void) {
-	Digital_Input_t input;
-	for (int i = 0; i < NUM_DIGITAL_INPUTS; ++i) {
-		input = Ext_DInputs[i];
-		if (input.added == CHANNEL_ADDED) {
-			SampleDigitalInput(&input);
+	const uint64_t timestamp = GetLocalTime();
+	const uint32_t word = ReadFilteredWord();
+	for (uint_fast8_t i = 0U; i < NUM_DIGITAL_INPUTS; ++i) {
+		Digital_Input_t* input = &Ext_DInputs[i];
+		if (input->added == CHANNEL_ADDED) {
+			input->timestamp = timestamp;
+			input->level = ((word & (1UL << i)) != 0U) ? LOGIC_HIGH : LOGIC_LOW;
 		}
 	}
 }
@@ -554,18 +1103,82 @@ void SetDigitalInputWriteFunction(WriteFunction writeFunction) {
 	writer = writeFunction;
 }
 
+/**
+ * Set the function pointer to use when writing binary scan frames to the data connection.
+ *
+ * @param writeFunction BinaryWriteFunction pointer to the desired binary writing function.
+ * @retval none
+ */
+void SetDigitalInputBinaryWriteFunction(BinaryWriteFunction writeFunction) {
+	binaryWriter = writeFunction;
+}
+
+/**
+ * Forgets the input names sent to a binary client so that the next frame starts with them. This should be called
+ * whenever a client selects the binary format.
+ *
+ * @param none
+ * @retval none
+ */
+void ResetDigitalInputBinaryFraming(void) {
+	binaryNamesSent = false;
+}
+
+/**
+ * Writes out a scan of a set of inputs which were sampled together. In the binary data format the whole scan is a
+ * single frame holding a timestamp and a bitmap of the levels; otherwise a text record is written for each input.
+ *
+ * @param inputs Digital_Input_t*[] The scanned inputs. NULL entries are skipped.
+ * @param count uint_fast8_t The number of entries in inputs.
+ * @retval WriteStatus_t The result of the write, or of the last text record.
+ */
+WriteStatus_t WriteDigitalInputScan(Digital_Input_t* inputs[], uint_fast8_t count) {
+	if (TelnetGetDataFormat() == DATA_FORMAT_BINARY) {
+		return WriteDigitalInputScanBinary(inputs, count);
+	}
+	WriteStatus_t status = WRITE_NOT_CONNECTED;
+	for (uint_fast8_t i = 0U; i < count; ++i) {
+		if (inputs[i] != NULL) {
+			status = WriteDigitalInput(inputs[i]);
+		}
+	}
+	for (uint_fast8_t i = 0U; i < NUM_DIGITAL_ENCODERS; ++i) {
+		const Digital_Input_Encoder_t* encoder = DigitalEncoder_GetSample(i);
+		if (encoder != NULL) {
+			status = WriteDigitalInputEncoder(encoder);
+		}
+	}
+	uint32_t rose = 0U;
+	uint32_t fell = 0U;
+	if ((count > 0U) && (inputs[0] != NULL) && (DigitalEdge_GetLatched(&rose, &fell) == true)) {
+		status = WriteDigitalInputLatch(inputs[0]->timestamp, rose, fell);
+		if (status == WRITE_OK) {
+			DigitalEdge_ClearLatched();
+		}
+	}
+	return status;
+}
+
 /**
  * Writes the data for the provided Digital_Input_t structure to the stream controlled by the WriteFunction, if set.
+ * Records which are refused because the connection is busy are counted, see GetDigitalInputDroppedCount().
  *
  * @param input Digital_Input_t* Pointer to the data structure to write out.
- * @retval none
+ * @retval WriteStatus_t The result of the write.
  */
-void WriteDigitalInput(Digital_Input_t* input) {
-	uint8_t retval = sprintf(TOSTRING_BUFFER, DIGITAL_INPUT_FORMATTER, input->name, input->input, input->timestamp,
+WriteStatus_t WriteDigitalInput(Digital_Input_t* input) {
+	WriteStatus_t status = WRITE_NOT_CONNECTED;
+	/* The timestamp is formatted separately as the C library's 64 bit conversion is slow */
+	char timestamp[FORMAT_UINT64_MAX_LENGTH + 1U];
+	Format_UInt64(timestamp, Timer_ToEpochTime(input->timestamp));
+	int retval = sprintf(TOSTRING_BUFFER, DIGITAL_INPUT_FORMATTER, input->name, input->input, timestamp,
 			DigitalLevelToString(input->level));
 	if (retval >= 0) {
 		if (writer != NULL ) {
-			writer(TOSTRING_BUFFER);
+			status = writer(TOSTRING_BUFFER);
+			if (status == WRITE_BUSY) {
+				++droppedWrites;
+			}
 		} else {
 #ifdef DIGITALINPUT_DEBUG
 			printf("[Digital Input] Cannot write digital input to string due to NULL write function.\n\r");
@@ -576,6 +1189,104 @@ void WriteDigitalInput(Digital_Input_t* input) {
 		printf("[Digital Input] Error occurred while writing digital input to string.\n\r");
 #endif
 	}
+	return status;
+}
+
+/**
+ * Writes a counter report for the provided input to the stream controlled by the WriteFunction, if set. Reports which
+ * are refused because the connection is busy are counted as dropped records, as the interval has already ended.
+ *
+ * @param input const Digital_Input_t* The counted input.
+ * @param counter const Digital_Input_Counter_t* The counter report to write.
+ * @retval WriteStatus_t The result of the write.
+ */
+WriteStatus_t WriteDigitalInputCounter(const Digital_Input_t* input, const Digital_Input_Counter_t* counter) {
+	WriteStatus_t status = WRITE_NOT_CONNECTED;
+	char timestamp[FORMAT_UINT64_MAX_LENGTH + 1U];
+	Format_UInt64(timestamp, Timer_ToEpochTime(counter->start));
+	int retval = snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, DIGITAL_COUNTER_FORMATTER, input->name, input->input,
+			timestamp, counter->duration, counter->count, counter->frequency_mHz / 1000U,
+			counter->frequency_mHz % 1000U, counter->period);
+	if (retval >= 0) {
+		if (writer != NULL ) {
+			status = writer(TOSTRING_BUFFER);
+			if (status == WRITE_BUSY) {
+				++droppedWrites;
+			}
+		}
+	} else {
+#ifdef DIGITALINPUT_DEBUG
+		printf("[Digital Input] Error occurred while writing digital input counter to string.\n\r");
+#endif
+	}
+	return status;
+}
+
+/**
+ * Writes a sample of a quadrature encoder to the stream controlled by the WriteFunction, if set. Samples which are
+ * refused because the connection is busy are counted as dropped records.
+ *
+ * @param encoder const Digital_Input_Encoder_t* The encoder sample to write.
+ * @retval WriteStatus_t The result of the write.
+ */
+WriteStatus_t WriteDigitalInputEncoder(const Digital_Input_Encoder_t* encoder) {
+	WriteStatus_t status = WRITE_NOT_CONNECTED;
+	char timestamp[FORMAT_UINT64_MAX_LENGTH + 1U];
+	Format_UInt64(timestamp, Timer_ToEpochTime(encoder->timestamp));
+	int retval = snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, DIGITAL_ENCODER_FORMATTER, encoder->encoder,
+			encoder->inputA, encoder->inputB, timestamp, encoder->position, encoder->velocity);
+	if (retval >= 0) {
+		if (writer != NULL ) {
+			status = writer(TOSTRING_BUFFER);
+			if (status == WRITE_BUSY) {
+				++droppedWrites;
+			}
+		}
+	} else {
+#ifdef DIGITALINPUT_DEBUG
+		printf("[Digital Input] Error occurred while writing digital input encoder to string.\n\r");
+#endif
+	}
+	return status;
+}
+
+/**
+ * Writes the latched edges of a scan to the stream controlled by the WriteFunction, if set. Records which are refused
+ * because the connection is busy are counted as dropped.
+ *
+ * @param timestamp uint64_t The local time of the scan.
+ * @param rose uint32_t Mask of the inputs which went high since the previous scan written out, bit n holding GPIn.
+ * @param fell uint32_t Mask of the inputs which went low since the previous scan written out, bit n holding GPIn.
+ * @retval WriteStatus_t The result of the write.
+ */
+WriteStatus_t WriteDigitalInputLatch(uint64_t timestamp, uint32_t rose, uint32_t fell) {
+	WriteStatus_t status = WRITE_NOT_CONNECTED;
+	char time[FORMAT_UINT64_MAX_LENGTH + 1U];
+	Format_UInt64(time, Timer_ToEpochTime(timestamp));
+	int retval = snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, DIGITAL_LATCH_FORMATTER, time, rose, fell);
+	if (retval >= 0) {
+		if (writer != NULL ) {
+			status = writer(TOSTRING_BUFFER);
+			if (status == WRITE_BUSY) {
+				++droppedWrites;
+			}
+		}
+	} else {
+#ifdef DIGITALINPUT_DEBUG
+		printf("[Digital Input] Error occurred while writing digital input latch to string.\n\r");
+#endif
+	}
+	return status;
+}
+
+/**
+ * Retrieves the number of digital input records which were refused by the data connection because it was busy.
+ *
+ * @param none
+ * @retval unsigned long The number of dropped records.
+ */
+unsigned long GetDigitalInputDroppedCount(void) {
+	return droppedWrites;
 }
 
 /**
@@ -32,6 +32,7 @@
 #include "TLE7232_RelayDriver.h"
 #include "boolean.h"
 #include <stdlib.h>
+#include <string.h>
 #include <inttypes.h>
 
 /*--------------------------------------------------------------------------------------------------------*/
@@ -45,6 +46,41 @@
  */
 #define DIGITAL_OUTPUT_FORMATTER "\n\r--------------------\n\rDigital Output\n\r\tName: %s\n\r\tPhysical Channel: %i\n\r\tTimestamp: %" PRIu64 "\n\r\tLevel: %s\n\r--------------------\n\r\x1E"
 
+/**
+ * @internal
+ * @def DIGITAL_LIST_HEADER
+ * @brief The string opening the list of added digital outputs.
+ */
+#define DIGITAL_LIST_HEADER "\n\r----------\n\rAdded Digital Outputs\n\r----------\n\r"
+
+/**
+ * @internal
+ * @def DIGITAL_LIST_FORMAT
+ * @brief The format string for describing an output in the list of added digital outputs.
+ */
+#define DIGITAL_LIST_FORMAT "\tPhysical Output %" PRIi8 ":\n\r\t\tName: %s\n\r"
+
+/**
+ * @internal
+ * @def DIGITAL_LIST_ENTRY_SIZE
+ * @brief The space kept for the rendered list description of each output.
+ */
+#define DIGITAL_LIST_ENTRY_SIZE			64U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Data structure caching the rendered list description of an output, with the name it was rendered from.
+ */
+typedef struct {
+	char name[MAX_DIGITAL_OUTPUT_NAME_LENGTH]; /**< The name of the output when rendered. */
+	uint8_t length; /**< The length of the description, 0 if none has been rendered. */
+	char text[DIGITAL_LIST_ENTRY_SIZE]; /**< The description. */
+} DigitalListEntry_t;
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE VARIABLES */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -52,6 +88,66 @@
 /* Pointer to the function to use when writing data to the output stream. */
 static WriteFunction writer = NULL;
 
+/* Number of digital output records which could not be written because the connection was busy */
+static unsigned long droppedWrites = 0U;
+
+/* Control register contents last written to the relay drivers, indexed by chip index */
+static uint8_t ControlShadow[NUMBER_TLE7232_CHIPS];
+
+/* Control register contents staged for the next commit, indexed by chip index */
+static uint8_t ControlStaged[NUMBER_TLE7232_CHIPS];
+
+/* Bit mask of the physical outputs driven by the PWM timer */
+static volatile DigitalOutputMask_t PwmMask = 0U;
+
+/* Current levels of the PWM driven outputs, a set bit meaning on */
+static volatile DigitalOutputMask_t PwmLevels = 0U;
+
+/* Position of each PWM driven output within its period, in ticks */
+static uint16_t PwmPhase[NUM_DIGITAL_OUTPUTS];
+
+/* Bit mask of the physical outputs held by a tripped interlock */
+static volatile DigitalOutputMask_t InterlockMask = 0U;
+
+/* Levels the interlocks hold their outputs at, a set bit meaning on */
+static volatile DigitalOutputMask_t InterlockLevels = 0U;
+
+/* True while any interlock rule is set, which keeps the output timer ticking to apply a trip */
+static volatile bool InterlockEnabled = false;
+
+/* The steps of the digital output sequence, in order of their offsets */
+static DigitalOutputStep_t Sequence[DIGITAL_OUTPUT_SEQUENCE_LENGTH];
+
+/* The number of steps in the sequence */
+static uint_fast8_t SequenceLength = 0U;
+
+/* The playback state of the sequence */
+static volatile DigitalOutputSequenceState_t SequenceState = DO_SEQUENCE_IDLE;
+
+/* Bit mask of the physical outputs the sequence plays to once started */
+static DigitalOutputMask_t SequenceOutputs = 0U;
+
+/* Bit mask of the physical outputs currently driven by the sequence */
+static volatile DigitalOutputMask_t SequenceMask = 0U;
+
+/* Current levels of the sequence driven outputs, a set bit meaning on */
+static volatile DigitalOutputMask_t SequenceLevels = 0U;
+
+/* The length of one pass of the sequence, in ticks */
+static uint32_t SequenceCycle = 0U;
+
+/* The number of passes to play, 0 to play until stopped */
+static uint32_t SequenceRepeats = 0U;
+
+/* The number of passes played so far */
+static uint32_t SequencePass = 0U;
+
+/* The position within the current pass, in ticks */
+static uint32_t SequenceTick = 0U;
+
+/* The index of the next step to play */
+static uint_fast8_t SequenceIndex = 0U;
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE EXTERNAL VARIABLES */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -59,6 +155,9 @@ static WriteFunction writer = NULL;
 /* List of external digital outputs */
 static Digital_Output_t Ext_DOutputs[NUM_DIGITAL_OUTPUTS];
 
+/* The cached list description of each digital output */
+static DigitalListEntry_t digitalListCache[NUM_DIGITAL_OUTPUTS];
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE FUNCTION PROTOTYPES */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -81,6 +180,54 @@ static bool isExternalOutput(uint8_t id);
  */
 static void InitializeOutput(Digital_Output_t* output);
 
+/**
+ * @internal
+ * @brief Stages the level of a physical output in the control register shadow.
+ */
+static void StageOutputLevel(uint8_t output, DigitalLevel_t level);
+
+/**
+ * @internal
+ * @brief Writes the staged control registers to the relay drivers if any of them changed.
+ */
+static bool CommitOutputLevels(void);
+
+/**
+ * @internal
+ * @brief Merges the PWM levels into the staged control registers.
+ */
+static void ComposeControl(uint8_t control[NUMBER_TLE7232_CHIPS]);
+
+/**
+ * @internal
+ * @brief Starts or stops the PWM timer depending on whether any output is modulated.
+ */
+static void ConfigureTickTimer(void);
+
+/**
+ * @internal
+ * @brief Stops driving a physical output with a PWM waveform.
+ */
+static void ReleaseOutput(uint8_t output);
+
+/**
+ * @internal
+ * @brief Determines if the output timer has any work to do.
+ */
+static bool isTickRequired(void);
+
+/**
+ * @internal
+ * @brief Starts playing the sequence from its first step.
+ */
+static void BeginSequence(void);
+
+/**
+ * @internal
+ * @brief Retrieves the list description of an output, rendering it only if the output has changed since it last was.
+ */
+static const DigitalListEntry_t* GetDigitalListEntry(const Digital_Output_t* output);
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE FUNCTIONS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -94,6 +241,7 @@ static void InitializeOutput(Digital_Output_t* output);
  */
 static void RemoveDigitalOutputByID(uint8_t id) {
 	if (isExternalOutput(id)) {
+		ReleaseOutput(id);
 		InitializeOutput(&Ext_DOutputs[id]);
 	} else {
 		/* This is out of range */
@@ -131,6 +279,209 @@ static void InitializeOutput(Digital_Output_t* output) {
 	output->output = NULL_CHANNEL;
 	output->fault_status = TLE7232_Normal_Operation;
 	output->fault_timestamp = 0U;
+	output->pwm_period = 0U;
+	output->pwm_duty = 0U;
+}
+
+/**
+ * Stages the level of a physical output in the control register shadow. Nothing is sent to the relay drivers until
+ * the staged registers are committed, so any number of outputs may be staged and then switched together.
+ *
+ * @param output uint8_t The physical output to stage.
+ * @param level DigitalLevel_t The level to drive the output to.
+ * @retval none
+ */
+static void StageOutputLevel(uint8_t output, DigitalLevel_t level) {
+	uint8_t chip = output / TLE7232_NUM_CHANNELS; /* The chip index the output is driven by */
+	uint8_t mask = 0x01 << (output % TLE7232_NUM_CHANNELS); /* Move the bit flag to the correct position */
+	if (level == OUTPUT_ON) {
+		ControlStaged[chip] |= mask; /* Set the appropriate bit */
+	} else {
+		ControlStaged[chip] &= ~mask; /* Clear the appropriate bit */
+	}
+}
+
+/**
+ * Writes the staged control registers of every relay driver in a single daisy chain frame, so that all of the
+ * staged output changes take effect together on the rising edge of the chip select. If no register differs from
+ * what was last written, no frame is sent at all.
+ *
+ * @param none
+ * @retval bool TRUE if a frame was sent.
+ */
+static bool CommitOutputLevels(void) {
+	bool changed = false;
+	uint8_t control[NUMBER_TLE7232_CHIPS];
+	/* Hold off the output timer so it can not update the shadow between our write and our update of it */
+	NVIC_DisableIRQ(GPO_TICK_IRQn);
+	ComposeControl(control);
+	for (uint_fast8_t i = 0U; i < NUMBER_TLE7232_CHIPS; ++i) {
+		if (control[i] != ControlShadow[i]) {
+			changed = true;
+			break;
+		}
+	}
+	if (changed == true) {
+		TLE7232_WriteRegisterAll(TLE7232_REG_CTL, control);
+		for (uint_fast8_t i = 0U; i < NUMBER_TLE7232_CHIPS; ++i) {
+			ControlShadow[i] = control[i];
+		}
+	}
+	if (isTickRequired() == true) {
+		NVIC_EnableIRQ(GPO_TICK_IRQn);
+	}
+	return changed;
+}
+
+/**
+ * Merges the current levels of the PWM and sequence driven outputs into the staged control registers, giving the
+ * contents the control registers should have right now. The levels held by the interlocks take precedence over all
+ * of them.
+ *
+ * @param control uint8_t[] The composed control registers, indexed by chip index.
+ * @retval none
+ */
+static void ComposeControl(uint8_t control[NUMBER_TLE7232_CHIPS]) {
+	const DigitalOutputMask_t pwmMask = PwmMask;
+	const DigitalOutputMask_t sequenceMask = SequenceMask;
+	/* The interlocks are updated from higher priority interrupts, so their mask and levels are read together */
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	const DigitalOutputMask_t interlockMask = InterlockMask;
+	const DigitalOutputMask_t interlockLevels = InterlockLevels;
+	__set_PRIMASK(primask);
+	const DigitalOutputMask_t mask = pwmMask | sequenceMask | interlockMask;
+	const DigitalOutputMask_t levels = (((PwmLevels & pwmMask) | (SequenceLevels & sequenceMask)) & ~interlockMask)
+			| (interlockLevels & interlockMask);
+	for (uint_fast8_t i = 0U; i < NUMBER_TLE7232_CHIPS; ++i) {
+		const uint8_t chipMask = (uint8_t) (mask >> (i * TLE7232_NUM_CHANNELS));
+		const uint8_t chipLevels = (uint8_t) (levels >> (i * TLE7232_NUM_CHANNELS));
+		control[i] = (ControlStaged[i] & ~chipMask) | (chipLevels & chipMask);
+	}
+}
+
+/**
+ * Starts the output timer ticking at DIGITAL_OUTPUT_TICK_HZ if any output is modulated or the sequence is playing,
+ * and stops it otherwise so that it costs nothing when neither is being used.
+ *
+ * @param none
+ * @retval none
+ */
+static void ConfigureTickTimer(void) {
+	if (isTickRequired() == true) {
+		if ((GPO_TICK_TIM->CR1 & TIM_CR1_CEN) == 0U) {
+			TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+			NVIC_InitTypeDef NVIC_InitStructure;
+			RCC_ClocksTypeDef RCC_Clocks;
+			RCC_GetClocksFreq(&RCC_Clocks);
+			uint32_t timerClock = RCC_Clocks.PCLK1_Frequency;
+			if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+				timerClock *= 2U;
+			}
+
+			RCC_APB1PeriphClockCmd(GPO_TICK_TIM_CLK, ENABLE);
+
+			/* Count at 1MHz and update once per tick */
+			TIM_TimeBaseStructInit(&TIM_TimeBaseStructure);
+			TIM_TimeBaseStructure.TIM_Prescaler = (uint16_t) ((timerClock / 1000000U) - 1U);
+			TIM_TimeBaseStructure.TIM_Period = (1000000U / DIGITAL_OUTPUT_TICK_HZ) - 1U;
+			TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+			TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+			TIM_TimeBaseInit(GPO_TICK_TIM, &TIM_TimeBaseStructure);
+			TIM_ClearITPendingBit(GPO_TICK_TIM, TIM_IT_Update);
+
+			NVIC_InitStructure.NVIC_IRQChannel = GPO_TICK_IRQn;
+			NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = GPO_TICK_PREEMPT_PRIORITY;
+			NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0U;
+			NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+			NVIC_Init(&NVIC_InitStructure);
+
+			TIM_ITConfig(GPO_TICK_TIM, TIM_IT_Update, ENABLE);
+			TIM_Cmd(GPO_TICK_TIM, ENABLE);
+		}
+	} else {
+		TIM_Cmd(GPO_TICK_TIM, DISABLE);
+		TIM_ITConfig(GPO_TICK_TIM, TIM_IT_Update, DISABLE);
+		NVIC_DisableIRQ(GPO_TICK_IRQn);
+	}
+}
+
+/**
+ * Stops driving a physical output with a PWM waveform or the sequence. The output is left at its staged level, which
+ * is applied by the next commit.
+ *
+ * @param output uint8_t The physical output to release.
+ * @retval none
+ */
+static void ReleaseOutput(uint8_t output) {
+	const DigitalOutputMask_t bit = (DigitalOutputMask_t) (1UL << output);
+	if (((PwmMask | SequenceMask) & bit) != 0U) {
+		NVIC_DisableIRQ(GPO_TICK_IRQn);
+		PwmMask &= ~bit;
+		SequenceMask &= ~bit;
+		Ext_DOutputs[output].pwm_period = 0U;
+		Ext_DOutputs[output].pwm_duty = 0U;
+		ConfigureTickTimer();
+		if (isTickRequired() == true) {
+			NVIC_EnableIRQ(GPO_TICK_IRQn);
+		}
+	}
+	SequenceOutputs &= ~bit;
+}
+
+/**
+ * Determines if the output timer has any work to do, which is the case while any output is modulated, the sequence
+ * is playing or an interlock rule is set.
+ *
+ * @param none
+ * @retval bool TRUE if the output timer needs to run.
+ */
+static bool isTickRequired(void) {
+	return (PwmMask != 0U || SequenceState == DO_SEQUENCE_RUNNING || InterlockEnabled == true) ? true : false;
+}
+
+/**
+ * Starts playing the sequence from its first step. Until that step is played the sequence outputs hold the levels
+ * they already had, so taking them over causes no glitch.
+ *
+ * @param none
+ * @retval none
+ */
+static void BeginSequence(void) {
+	NVIC_DisableIRQ(GPO_TICK_IRQn);
+	SequenceLevels = GetDigitalOutputLevels();
+	SequenceMask = SequenceOutputs;
+	SequenceTick = 0U;
+	SequenceIndex = 0U;
+	SequencePass = 0U;
+	SequenceState = DO_SEQUENCE_RUNNING;
+	ConfigureTickTimer();
+	NVIC_EnableIRQ(GPO_TICK_IRQn);
+}
+
+/**
+ * Retrieves the list description of an added output. The description is only rendered again when the name it was
+ * rendered from has changed.
+ *
+ * @param output const Digital_Output_t* The output to describe.
+ * @retval const DigitalListEntry_t* The description, NULL if it could not be rendered.
+ */
+static const DigitalListEntry_t* GetDigitalListEntry(const Digital_Output_t* output) {
+	DigitalListEntry_t* entry = &digitalListCache[output->output];
+	if ((entry->length > 0U) && (strncmp(entry->name, output->name, sizeof(entry->name)) == 0)) {
+		return entry;
+	}
+	const int n = snprintf(entry->text, sizeof(entry->text), DIGITAL_LIST_FORMAT, output->output, output->name);
+	if ((n <= 0) || (n >= (int) sizeof(entry->text))) {
+#ifdef DIGITALOUTPUT_DEBUG
+		printf("Failed to write an digital output to the list.\n\r");
+#endif
+		entry->length = 0U;
+		return NULL;
+	}
+	strncpy(entry->name, output->name, sizeof(entry->name));
+	entry->length = (uint8_t) n;
+	return entry;
 }
 
 /*--------------------------------------------------------------------------------------------------------*/
@@ -149,49 +500,46 @@ void DigitalOutputsInit(void) {
 		InitializeOutput(&Ext_DOutputs[i]);
 	}
 
-	uint8_t data[NUMBER_TLE7232_CHIPS] = {0xFF, 0xFF};
-	TLE7232_WriteRegisterAll(TLE7232_REG_CTL, data);
+	for (uint_fast8_t i = 0U; i < NUMBER_TLE7232_CHIPS; ++i) {
+		ControlStaged[i] = 0xFF;
+		ControlShadow[i] = 0xFF;
+	}
+	TLE7232_WriteRegisterAll(TLE7232_REG_CTL, ControlShadow);
 }
 
 /**
- * Prints a human readable representation of all the added digital outputs via the current write function.
+ * Prints a human readable representation of all the added digital outputs via the current write function. Each
+ * output's description is cached until it changes and the list is gathered into as few writes as possible.
  *
  * @param none
  * @return Tekdaqc_Function_Error_t The error status of this function.
  */
 Tekdaqc_Function_Error_t ListDigitalOutputs(void) {
-	Tekdaqc_Function_Error_t retval = ERR_FUNCTION_OK;
-	uint8_t n = snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "\n\r----------\n\rAdded Digital Outputs\n\r----------\n\r");
-	if (n <= 0) {
-#ifdef DIGITALOUTPUT_DEBUG
-		printf("Failed to write header of digital output list.\n\r");
-#endif
-		retval = ERR_DOUT_FAILED_WRITE;
-	} else {
-		if (writer != 0) {
-			writer(TOSTRING_BUFFER);
+	if (writer == NULL) {
+		return ERR_FUNCTION_OK;
+	}
+	uint16_t length = sizeof(DIGITAL_LIST_HEADER) - 1U;
+	memcpy(TOSTRING_BUFFER, DIGITAL_LIST_HEADER, sizeof(DIGITAL_LIST_HEADER));
+	for (uint_fast8_t i = 0U; i < NUM_DIGITAL_OUTPUTS; ++i) {
+		if (Ext_DOutputs[i].added != CHANNEL_ADDED) {
+			continue;
 		}
-		Digital_Output_t output;
-		for(uint_fast8_t i = 0U; i < NUM_DIGITAL_OUTPUTS; ++i) {
-			output = Ext_DOutputs[i];
-			if (output.added == CHANNEL_ADDED) {
-				/* This input has been added */
-				n = snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "\tPhysical Output %" PRIi8 ":\n\r\t\tName: %s\n\r", output.output, output.name);
-				if (n <= 0) {
-#ifdef DIGITALOUTPUT_DEBUG
-					printf("Failed to write an digital output to the list.\n\r");
-#endif
-					retval = ERR_DOUT_FAILED_WRITE;
-					break;
-				} else {
-					if (writer != 0) {
-						writer(TOSTRING_BUFFER);
-					}
-				}
+		const DigitalListEntry_t* entry = GetDigitalListEntry(&Ext_DOutputs[i]);
+		if (entry == NULL) {
+			return ERR_DOUT_FAILED_WRITE;
+		}
+		if ((length + entry->length) >= SIZE_TOSTRING_BUFFER) {
+			/* Send what is gathered and start again */
+			if (writer(TOSTRING_BUFFER) != WRITE_OK) {
+				return ERR_DOUT_FAILED_WRITE;
 			}
+			length = 0U;
 		}
+		memcpy(&TOSTRING_BUFFER[length], entry->text, entry->length);
+		length += entry->length;
+		TOSTRING_BUFFER[length] = '\0';
 	}
-	return retval;
+	return (writer(TOSTRING_BUFFER) == WRITE_OK) ? ERR_FUNCTION_OK : ERR_DOUT_FAILED_WRITE;
 }
 
 /**
@@ -428,18 +776,11 @@ Tekdaqc_Function_Error_t SetDigitalOutput(char keys[][MAX_COMMANDPART_LENGTH], c
 			if (dig_output != NULL) {
 				if (dig_output->added == CHANNEL_ADDED) {
 					/* Set the state */
-					uint8_t control = TLE7232_ReadRegister(TLE7232_REG_CTL, dig_output->output % 8U);
-					uint8_t channel = dig_output->output;
-					if (channel >= 8) { /* Convert the channel to a single chip index */
-						channel -= 8;
-					}
-					uint8_t mask = 0x01 << channel; /* Move the bit flag to the correct position */
-					if (level == OUTPUT_ON) {
-						control |= mask; /* Set the appropriate bit */
-					} else {
-						control ^= mask;	/* Clear the appropriate bit */
-					}
-					TLE7232_WriteRegister(TLE7232_REG_CTL, control, dig_output->output %8U); /* Update the register */
+					ReleaseOutput(dig_output->output);
+					StageOutputLevel(dig_output->output, level);
+					CommitOutputLevels();
+					dig_output->level = level;
+					dig_output->timestamp = GetLocalTime();
 				} else {
 #ifdef DIGITALOUTPUT_DEBUG
 					printf("[Digital Output] Tried to change the state of an output which has not been added.\n\r");
@@ -458,6 +799,361 @@ Tekdaqc_Function_Error_t SetDigitalOutput(char keys[][MAX_COMMANDPART_LENGTH], c
 	return retval;
 }
 
+/**
+ * Sets the levels of several digital outputs at once. Every output selected by the mask is staged, and the relay
+ * drivers are then updated in a single daisy chain frame so that the outputs switch together, even when they are
+ * spread across both chips. Outputs which are already at the requested level cost nothing, and if none of them
+ * change no SPI traffic is generated.
+ *
+ * @param mask DigitalOutputMask_t Bit mask of the physical outputs to change, bit n selecting output n.
+ * @param levels DigitalOutputMask_t Bit field of the requested levels, a set bit turning the output on.
+ * @retval Tekdaqc_Function_Error_t The error status of this function.
+ */
+Tekdaqc_Function_Error_t SetDigitalOutputs(DigitalOutputMask_t mask, DigitalOutputMask_t levels) {
+	Tekdaqc_Function_Error_t retval = ERR_FUNCTION_OK;
+	if (mask == 0U) {
+		/* No outputs were selected */
+		retval = ERR_DOUT_OUTPUT_UNSPECIFIED;
+	} else {
+		for (uint_fast8_t i = 0U; i < NUM_DIGITAL_OUTPUTS; ++i) {
+			if ((mask & (1UL << i)) != 0U && Ext_DOutputs[i].added != CHANNEL_ADDED) {
+#ifdef DIGITALOUTPUT_DEBUG
+				printf("[Digital Output] Tried to change the state of an output which has not been added.\n\r");
+#endif
+				retval = ERR_DOUT_DOES_NOT_EXIST;
+				break;
+			}
+		}
+	}
+	if (retval == ERR_FUNCTION_OK) {
+		uint64_t timestamp = GetLocalTime();
+		for (uint_fast8_t i = 0U; i < NUM_DIGITAL_OUTPUTS; ++i) {
+			if ((mask & (1UL << i)) != 0U) {
+				DigitalLevel_t level = ((levels & (1UL << i)) != 0U) ? OUTPUT_ON : OUTPUT_OFF;
+				ReleaseOutput(Ext_DOutputs[i].output);
+				StageOutputLevel(Ext_DOutputs[i].output, level);
+				Ext_DOutputs[i].level = level;
+				Ext_DOutputs[i].timestamp = timestamp;
+			}
+		}
+		CommitOutputLevels();
+	}
+	return retval;
+}
+
+/**
+ * Starts driving a digital output with a PWM waveform. The waveform is produced on the board by the PWM timer, which
+ * switches the output through DMA writes of the relay driver control registers, so no further commands are needed
+ * to keep it running. A duty cycle of 0 or 100 percent holds the output off or on. The output returns to a static
+ * level when it is next set with SetDigitalOutput() or SetDigitalOutputs(), or is removed. An output played by the
+ * sequence is taken out of it.
+ *
+ * @param number uint8_t The physical output to modulate.
+ * @param frequency uint32_t The PWM frequency in Hz.
+ * @param duty uint8_t The duty cycle in percent.
+ * @retval Tekdaqc_Function_Error_t The error status of this function.
+ */
+Tekdaqc_Function_Error_t SetDigitalOutputPwm(uint8_t number, uint32_t frequency, uint8_t duty) {
+	Tekdaqc_Function_Error_t retval = ERR_FUNCTION_OK;
+	Digital_Output_t* output = GetDigitalOutputByNumber(number);
+	if (output == NULL) {
+		retval = ERR_DOUT_OUTPUT_NOT_FOUND;
+	} else if (output->added != CHANNEL_ADDED) {
+#ifdef DIGITALOUTPUT_DEBUG
+		printf("[Digital Output] Tried to modulate an output which has not been added.\n\r");
+#endif
+		retval = ERR_DOUT_DOES_NOT_EXIST;
+	} else if (frequency < MIN_DIGITAL_OUTPUT_PWM_HZ || frequency > MAX_DIGITAL_OUTPUT_PWM_HZ || duty > 100U) {
+#ifdef DIGITALOUTPUT_DEBUG
+		printf("[Digital Output] The requested PWM frequency or duty cycle is out of range.\n\r");
+#endif
+		retval = ERR_DOUT_PARSE_ERROR;
+	} else {
+		const uint16_t period = (uint16_t) (DIGITAL_OUTPUT_TICK_HZ / frequency);
+		ReleaseOutput(output->output);
+		NVIC_DisableIRQ(GPO_TICK_IRQn);
+		output->pwm_period = period;
+		output->pwm_duty = (uint16_t) ((period * (uint32_t) duty) / 100U);
+		output->level = OUTPUT_ON;
+		output->timestamp = GetLocalTime();
+		PwmPhase[output->output] = 0U;
+		PwmMask |= (1UL << output->output);
+		ConfigureTickTimer();
+		NVIC_EnableIRQ(GPO_TICK_IRQn);
+	}
+	return retval;
+}
+
+/**
+ * Changes the duty cycle of an output already being driven with a PWM waveform, keeping its frequency and phase.
+ * The new duty cycle takes effect from the next tick of the output timer, so this may be called from interrupts,
+ * as by the PID loops. Outputs which are not modulated are left alone.
+ *
+ * @param number uint8_t The physical output to change.
+ * @param duty uint16_t The duty cycle in 1/65536ths of the period, 65535 for fully on.
+ * @retval none
+ */
+void SetDigitalOutputPwmDuty(uint8_t number, uint16_t duty) {
+	if ((number < NUM_DIGITAL_OUTPUTS) && ((PwmMask & (1UL << number)) != 0U)) {
+		const uint32_t period = Ext_DOutputs[number].pwm_period;
+		/* Rounded so that the full scale duty is the whole period */
+		Ext_DOutputs[number].pwm_duty = (uint16_t) (((period * duty) + (period / 2U)) >> 16U);
+	}
+}
+
+/**
+ * Advances the PWM waveforms and the sequence of the digital outputs by one tick and, if any output changed level,
+ * writes the control registers through the DMA engine. Should the relay driver bus be in use, the write is retried
+ * on the next tick, so an edge is delayed by at most one tick. Once the sequence has finished and nothing is
+ * modulated, the timer stops itself. This must be called from the output timer IRQ handler.
+ *
+ * @param none
+ * @retval none
+ */
+void DigitalOutputsTick(void) {
+	if (TIM_GetITStatus(GPO_TICK_TIM, TIM_IT_Update) != RESET) {
+		TIM_ClearITPendingBit(GPO_TICK_TIM, TIM_IT_Update);
+		if (SequenceState == DO_SEQUENCE_RUNNING) {
+			if (SequenceIndex >= SequenceLength && SequenceTick >= SequenceCycle) {
+				/* This pass is over */
+				++SequencePass;
+				if (SequenceRepeats != 0U && SequencePass >= SequenceRepeats) {
+					SequenceState = DO_SEQUENCE_DONE;
+				} else {
+					SequenceTick = 0U;
+					SequenceIndex = 0U;
+				}
+			}
+			if (SequenceState == DO_SEQUENCE_RUNNING) {
+				while (SequenceIndex < SequenceLength && Sequence[SequenceIndex].offset <= SequenceTick) {
+					SequenceLevels = Sequence[SequenceIndex].levels;
+					++SequenceIndex;
+				}
+				++SequenceTick;
+			}
+		}
+
+		const DigitalOutputMask_t mask = PwmMask;
+		DigitalOutputMask_t levels = 0U;
+		for (uint_fast8_t i = 0U; i < NUM_DIGITAL_OUTPUTS; ++i) {
+			if ((mask & (1UL << i)) != 0U) {
+				if (++PwmPhase[i] >= Ext_DOutputs[i].pwm_period) {
+					PwmPhase[i] = 0U;
+				}
+				if (PwmPhase[i] < Ext_DOutputs[i].pwm_duty) {
+					levels |= (1UL << i);
+				}
+			}
+		}
+		PwmLevels = levels;
+
+		uint8_t control[NUMBER_TLE7232_CHIPS];
+		ComposeControl(control);
+		bool changed = false;
+		for (uint_fast8_t i = 0U; i < NUMBER_TLE7232_CHIPS; ++i) {
+			if (control[i] != ControlShadow[i]) {
+				changed = true;
+				break;
+			}
+		}
+		if (changed == true && TLE7232_WriteRegisterAll_DMA(TLE7232_REG_CTL, control) == true) {
+			for (uint_fast8_t i = 0U; i < NUMBER_TLE7232_CHIPS; ++i) {
+				ControlShadow[i] = control[i];
+			}
+			changed = false;
+		}
+		if (changed == false && isTickRequired() == false) {
+			/* Everything has been written and there is nothing left to play */
+			ConfigureTickTimer();
+		}
+	}
+}
+
+/**
+ * Appends a step to the digital output sequence. Steps must be added in order of their offsets, which are rounded
+ * down to the resolution of the output timer, and no two steps may fall on the same tick. The sequence may not be
+ * edited while it is armed or playing.
+ *
+ * @param offset_us uint32_t The time of the step from the start of the sequence, in microseconds.
+ * @param levels DigitalOutputMask_t Bit field of the output levels from this step on, a set bit turning output n on.
+ * @retval Tekdaqc_Function_Error_t The error status of this function.
+ */
+Tekdaqc_Function_Error_t AddDigitalOutputSequenceStep(uint32_t offset_us, DigitalOutputMask_t levels) {
+	Tekdaqc_Function_Error_t retval = ERR_FUNCTION_OK;
+	const uint32_t offset = offset_us / (1000000U / DIGITAL_OUTPUT_TICK_HZ);
+	if (SequenceState == DO_SEQUENCE_ARMED || SequenceState == DO_SEQUENCE_RUNNING) {
+		retval = ERR_DOUT_SEQUENCE_RUNNING;
+	} else if (SequenceLength >= DIGITAL_OUTPUT_SEQUENCE_LENGTH) {
+		retval = ERR_DOUT_SEQUENCE_FULL;
+	} else if (SequenceLength > 0U && offset <= Sequence[SequenceLength - 1U].offset) {
+#ifdef DIGITALOUTPUT_DEBUG
+		printf("[Digital Output] Sequence steps must be added in order of their offsets.\n\r");
+#endif
+		retval = ERR_DOUT_SEQUENCE_INVALID;
+	} else {
+		Sequence[SequenceLength].offset = offset;
+		Sequence[SequenceLength].levels = levels;
+		++SequenceLength;
+	}
+	return retval;
+}
+
+/**
+ * Empties the digital output sequence. The sequence may not be cleared while it is armed or playing.
+ *
+ * @param none
+ * @retval Tekdaqc_Function_Error_t The error status of this function.
+ */
+Tekdaqc_Function_Error_t ClearDigitalOutputSequence(void) {
+	Tekdaqc_Function_Error_t retval = ERR_FUNCTION_OK;
+	if (SequenceState == DO_SEQUENCE_ARMED || SequenceState == DO_SEQUENCE_RUNNING) {
+		retval = ERR_DOUT_SEQUENCE_RUNNING;
+	} else {
+		SequenceLength = 0U;
+	}
+	return retval;
+}
+
+/**
+ * Starts playing the digital output sequence to a set of outputs. The outputs are taken over from PWM or static
+ * control for the duration, and the steps are played by the output timer through the batched control register path,
+ * so every output changed by a step switches in the same frame. The sequence either starts immediately or is armed
+ * to start with the next analog input sampling, see TriggerDigitalOutputSequence().
+ *
+ * @param mask DigitalOutputMask_t Bit mask of the physical outputs to play the sequence to, bit n selecting output n.
+ * @param repeats uint32_t The number of passes to play, 0 to play until stopped.
+ * @param cycle_us uint32_t The length of one pass in microseconds, 0 to end each pass one tick after its last step.
+ * @param onSampling bool TRUE to arm the sequence to start with analog input sampling.
+ * @retval Tekdaqc_Function_Error_t The error status of this function.
+ */
+Tekdaqc_Function_Error_t StartDigitalOutputSequence(DigitalOutputMask_t mask, uint32_t repeats, uint32_t cycle_us, bool onSampling) {
+	Tekdaqc_Function_Error_t retval = ERR_FUNCTION_OK;
+	uint32_t cycle = cycle_us / (1000000U / DIGITAL_OUTPUT_TICK_HZ);
+	if (SequenceState == DO_SEQUENCE_ARMED || SequenceState == DO_SEQUENCE_RUNNING) {
+		retval = ERR_DOUT_SEQUENCE_RUNNING;
+	} else if (SequenceLength == 0U) {
+		retval = ERR_DOUT_SEQUENCE_INVALID;
+	} else if (mask == 0U) {
+		retval = ERR_DOUT_OUTPUT_UNSPECIFIED;
+	} else {
+		if (cycle == 0U) {
+			cycle = Sequence[SequenceLength - 1U].offset + 1U;
+		} else if (cycle <= Sequence[SequenceLength - 1U].offset) {
+			/* The last step would never be played */
+			retval = ERR_DOUT_SEQUENCE_INVALID;
+		}
+		for (uint_fast8_t i = 0U; i < NUM_DIGITAL_OUTPUTS; ++i) {
+			if ((mask & (1UL << i)) != 0U && Ext_DOutputs[i].added != CHANNEL_ADDED) {
+				retval = ERR_DOUT_DOES_NOT_EXIST;
+				break;
+			}
+		}
+	}
+	if (retval == ERR_FUNCTION_OK) {
+		/* Hand back the outputs of a finished sequence before taking over the new ones */
+		StopDigitalOutputSequence();
+		for (uint_fast8_t i = 0U; i < NUM_DIGITAL_OUTPUTS; ++i) {
+			if ((mask & (1UL << i)) != 0U) {
+				ReleaseOutput(i);
+			}
+		}
+		CommitOutputLevels();
+		SequenceOutputs = mask;
+		SequenceCycle = cycle;
+		SequenceRepeats = repeats;
+		if (onSampling == true) {
+			SequenceState = DO_SEQUENCE_ARMED;
+		} else {
+			BeginSequence();
+		}
+	}
+	return retval;
+}
+
+/**
+ * Starts an armed digital output sequence. This is called as analog input sampling starts, so that the sequence and
+ * the samples share a time origin. It does nothing if the sequence is not armed.
+ *
+ * @param none
+ * @retval none
+ */
+void TriggerDigitalOutputSequence(void) {
+	if (SequenceState == DO_SEQUENCE_ARMED) {
+		BeginSequence();
+	}
+}
+
+/**
+ * Stops the digital output sequence. Its outputs are handed back to static control at the levels the sequence last
+ * gave them, so stopping causes no change at the outputs.
+ *
+ * @param none
+ * @retval none
+ */
+void StopDigitalOutputSequence(void) {
+	if (SequenceState != DO_SEQUENCE_IDLE) {
+		NVIC_DisableIRQ(GPO_TICK_IRQn);
+		const DigitalOutputMask_t mask = SequenceMask;
+		const DigitalOutputMask_t levels = SequenceLevels;
+		const uint64_t timestamp = GetLocalTime();
+		for (uint_fast8_t i = 0U; i < NUM_DIGITAL_OUTPUTS; ++i) {
+			if ((mask & (1UL << i)) != 0U) {
+				const DigitalLevel_t level = ((levels & (1UL << i)) != 0U) ? OUTPUT_ON : OUTPUT_OFF;
+				StageOutputLevel(i, level);
+				Ext_DOutputs[i].level = level;
+				Ext_DOutputs[i].timestamp = timestamp;
+			}
+		}
+		SequenceMask = 0U;
+		SequenceOutputs = 0U;
+		SequenceState = DO_SEQUENCE_IDLE;
+		ConfigureTickTimer();
+		if (isTickRequired() == true) {
+			NVIC_EnableIRQ(GPO_TICK_IRQn);
+		}
+		CommitOutputLevels();
+	}
+}
+
+/**
+ * Sets the levels the interlocks hold digital outputs at. They take precedence over the levels set by the host and
+ * over the PWM and sequence players, and are applied by the next tick of the output timer, so this may be called from
+ * interrupts. An output left out of the mask returns to the level it would otherwise have.
+ *
+ * @param mask DigitalOutputMask_t Bit mask of the physical outputs held, bit n selecting output n.
+ * @param levels DigitalOutputMask_t Bit field of the held levels, a set bit turning the output on.
+ * @retval none
+ */
+void SetDigitalOutputInterlock(DigitalOutputMask_t mask, DigitalOutputMask_t levels) {
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	InterlockMask = mask;
+	InterlockLevels = levels;
+	__set_PRIMASK(primask);
+}
+
+/**
+ * Starts or stops merging the interlock levels into the outputs. While enabled the output timer ticks even when no
+ * output is modulated, so that a trip reaches the relay drivers within one tick. Released outputs are written back
+ * to their levels before the timer stops.
+ *
+ * @param enabled bool True while any interlock rule is set.
+ * @retval none
+ */
+void EnableDigitalOutputInterlock(bool enabled) {
+	NVIC_DisableIRQ(GPO_TICK_IRQn);
+	InterlockEnabled = enabled;
+	if (enabled == false) {
+		InterlockMask = 0U;
+		InterlockLevels = 0U;
+		CommitOutputLevels();
+	}
+	ConfigureTickTimer();
+	if (isTickRequired() == true) {
+		NVIC_EnableIRQ(GPO_TICK_IRQn);
+	}
+}
+
 /**
  * Set the function pointer to use when writing data from a digital output to the data connection.
  *
@@ -496,16 +1192,21 @@ void SampleAllDigitalOutputs(void) {
 
 /**
  * Writes the data for the provided Digital_Output_t structure to the stream controlled by the WriteFunction, if set.
+ * Records which are refused because the connection is busy are counted, see GetDigitalOutputDroppedCount().
  *
  * @param output Digital_Output_t* Pointer to the data structure to write out.
- * @retval none
+ * @retval WriteStatus_t The result of the write.
  */
-void WriteDigitalOutput(Digital_Output_t* output) {
-	uint8_t retval = sprintf(TOSTRING_BUFFER, DIGITAL_OUTPUT_FORMATTER, output->name, output->output, output->timestamp,
-			DigitalLevelToString(output->level));
+WriteStatus_t WriteDigitalOutput(Digital_Output_t* output) {
+	WriteStatus_t status = WRITE_NOT_CONNECTED;
+	int retval = sprintf(TOSTRING_BUFFER, DIGITAL_OUTPUT_FORMATTER, output->name, output->output,
+			Timer_ToEpochTime(output->timestamp), DigitalLevelToString(output->level));
 	if (retval >= 0) {
 		if (writer != NULL ) {
-			writer(TOSTRING_BUFFER);
+			status = writer(TOSTRING_BUFFER);
+			if (status == WRITE_BUSY) {
+				++droppedWrites;
+			}
 		} else {
 #ifdef DIGITALOUTPUT_DEBUG
 			printf("[Digital Output] Cannot write digital output to string due to NULL write function.\n\r");
@@ -516,6 +1217,32 @@ void WriteDigitalOutput(Digital_Output_t* output) {
 		printf("[Digital Output] Error occurred while writing digital output to string.\n\r");
 #endif
 	}
+	return status;
+}
+
+/**
+ * Retrieves the levels of all the digital outputs, as last written to the relay drivers. Only the control register
+ * shadow is read, so this may be called from interrupts.
+ *
+ * @param none
+ * @retval DigitalOutputMask_t The output levels, bit n set if output n is on.
+ */
+DigitalOutputMask_t GetDigitalOutputLevels(void) {
+	DigitalOutputMask_t levels = 0U;
+	for (uint_fast8_t i = 0U; i < NUMBER_TLE7232_CHIPS; ++i) {
+		levels |= ((DigitalOutputMask_t) ControlShadow[i]) << (i * TLE7232_NUM_CHANNELS);
+	}
+	return levels;
+}
+
+/**
+ * Retrieves the number of digital output records which were refused by the data connection because it was busy.
+ *
+ * @param none
+ * @retval unsigned long The number of dropped records.
+ */
+unsigned long GetDigitalOutputDroppedCount(void) {
+	return droppedWrites;
 }
 
 /**
@@ -537,24 +1264,15 @@ void WriteAllDigitalOutputs(void) {
 }
 
 /**
- * Checks the current status of all digital outputs on the board, returning if a fault has occurred or not.
+ * Services the background diagnosis of the digital outputs on the board. The relay drivers are diagnosed in the
+ * background, so this never waits on the SPI bus, and any output found entering a fault state signals
+ * STATUS_EVENT_DOUT_FAULT through SetDigitalOutputFaultStatus().
  *
  * @param none
- * @retval bool TRUE if a fault was detected.
+ * @retval bool TRUE if a change in the diagnosis was evaluated.
  */
 bool CheckDigitalOutputStatus(void) {
-	bool retval = false;
-	TLE7232_ReadAllDiagnosis();
-	Digital_Output_t output;
-	for (uint_fast8_t i = 0U; i < NUM_DIGITAL_OUTPUTS; ++i) {
-		output = Ext_DOutputs[i];
-		if (output.fault_status != TLE7232_Normal_Operation) {
-			/* A fault has occurred on this channel */
-			retval = true;
-			break;
-		}
-	}
-	return retval;
+	return TLE7232_ServiceDiagnosis();
 }
 
 /**
@@ -566,8 +1284,11 @@ bool CheckDigitalOutputStatus(void) {
  */
 bool SetDigitalOutputFaultStatus(TLE7232_Status_t status, uint8_t chip_id, uint8_t channel) {
 	bool retval = false;
-	uint8_t out = channel * (chip_id + 1);
+	uint8_t out = (chip_id * TLE7232_NUM_CHANNELS) + channel;
 	if (out < NUM_DIGITAL_OUTPUTS) {
+		if ((status != TLE7232_Normal_Operation) && (Ext_DOutputs[out].fault_status != status)) {
+			Tekdaqc_SignalStatusEvent(STATUS_EVENT_DOUT_FAULT);
+		}
 		Ext_DOutputs[out].fault_status = status;
 		Ext_DOutputs[out].fault_timestamp = GetLocalTime();
 		retval = true;
@@ -0,0 +1,288 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Benchmark.c
+ * @brief Implements the floating point benchmarks.
+ *
+ * Times the firmware's floating point paths - the board temperature conversion, the temperature compensated gain
+ * calibration lookup and Delay_ms() - with the DWT cycle counter, averaging over BENCHMARK_ITERATIONS runs. Run once
+ * in a build using the hardware FPU and once in a build using software floating point, the results show what the FPU
+ * saves.
+ *
+ * The FPU is not free in interrupts: once a thread has used it, each exception entry must reserve room for its
+ * registers. With lazy stacking they are only saved if the handler itself uses the FPU, so the interrupt round trip is
+ * timed for each combination of the interrupted code and the handler using the FPU or not. The otherwise unused FPU
+ * interrupt is pended from software for this.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Benchmark.h"
+
+#ifdef FLOAT_BENCHMARK
+
+#include "Tekdaqc_BSP.h"
+#include "Tekdaqc_Timers.h"
+#include "Tekdaqc_CalibrationTable.h"
+#include "Analog_Input.h"
+#include "BoardTemperature.h"
+#include "boolean.h"
+#include <inttypes.h>
+#include <stdio.h>
+
+#if (__FPU_USED != 1)
+#warning "FLOAT_BENCHMARK is defined but the build does not use the hardware FPU, software floating point will be timed."
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The FP extension active bit of the CONTROL register */
+#define BENCHMARK_CONTROL_FPCA	(1UL << 2)
+
+/* The code converted by the board temperature benchmark, roughly 25 Deg C at unity gain */
+#define BENCHMARK_TEMPERATURE_CODE	0x0A0000
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief A benchmarked function.
+ */
+typedef void (*BenchmarkFunction_t)(void);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The input whose settings the benchmarks convert with */
+static Analog_Input_t* benchmarkInput = NULL;
+
+/* The temperatures the calibration benchmark alternates between, so the lookup cache is always missed */
+static float benchmarkTemperatures[2] = { 0.0f, 0.0f };
+
+/* The number of calibration lookups made so far */
+static uint32_t benchmarkLookups = 0U;
+
+/* Results kept volatile so the benchmarked work is not optimized away */
+static volatile uint32_t benchmarkSink = 0U;
+static volatile float benchmarkScratch = 1.0f;
+
+/* TRUE if the benchmark interrupt handler should use the FPU */
+static volatile bool isrUsesFloat = false;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Does nothing, for measuring the overhead of a benchmark.
+ */
+static void BenchmarkEmpty(void);
+
+/**
+ * @internal
+ * @brief Benchmarks the board temperature conversion.
+ */
+static void BenchmarkBoardTemperature(void);
+
+/**
+ * @internal
+ * @brief Benchmarks the gain calibration lookup.
+ */
+static void BenchmarkGainCalibration(void);
+
+/**
+ * @internal
+ * @brief Benchmarks a short Delay_ms().
+ */
+static void BenchmarkDelay(void);
+
+/**
+ * @internal
+ * @brief Measures the average number of cycles a function takes.
+ */
+static uint32_t MeasureCycles(BenchmarkFunction_t function);
+
+/**
+ * @internal
+ * @brief Measures the average number of cycles an interrupt round trip takes.
+ */
+static uint32_t MeasureInterrupt(bool threadFloat, bool handlerFloat);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Does nothing, for measuring the overhead of calling a benchmark and reading the cycle counter.
+ *
+ * @param none
+ * @retval none
+ */
+static void BenchmarkEmpty(void) {
+	__NOP();
+}
+
+/**
+ * Converts a fixed code into the board temperature.
+ *
+ * @param none
+ * @retval none
+ */
+static void BenchmarkBoardTemperature(void) {
+	updateBoardTemperature(benchmarkInput, BENCHMARK_TEMPERATURE_CODE);
+}
+
+/**
+ * Looks up the gain calibration of the benchmark input, alternating between two temperatures.
+ *
+ * @param none
+ * @retval none
+ */
+static void BenchmarkGainCalibration(void) {
+	benchmarkSink = Tekdaqc_GetGainCalibration(benchmarkInput->rate, benchmarkInput->gain, benchmarkInput->buffer,
+			benchmarkTemperatures[benchmarkLookups & 0x01]);
+	++benchmarkLookups;
+}
+
+/**
+ * Waits for BENCHMARK_DELAY_MS.
+ *
+ * @param none
+ * @retval none
+ */
+static void BenchmarkDelay(void) {
+	Delay_ms(BENCHMARK_DELAY_MS);
+}
+
+/**
+ * Measures the average number of cycles a function takes over BENCHMARK_ITERATIONS calls, less the overhead of an
+ * empty one.
+ *
+ * @param function BenchmarkFunction_t The function to measure.
+ * @retval uint32_t The average number of cycles.
+ */
+static uint32_t MeasureCycles(BenchmarkFunction_t function) {
+	uint32_t total = 0U;
+	uint32_t overhead = 0U;
+	for (uint32_t i = 0U; i < BENCHMARK_ITERATIONS; ++i) {
+		uint32_t start = DWT->CYCCNT;
+		BenchmarkEmpty();
+		overhead += DWT->CYCCNT - start;
+		start = DWT->CYCCNT;
+		function();
+		total += DWT->CYCCNT - start;
+	}
+	return ((total > overhead) ? (total - overhead) : 0U) / BENCHMARK_ITERATIONS;
+}
+
+/**
+ * Measures the average number of cycles taken to pend the FPU interrupt and return from its handler, over
+ * BENCHMARK_ITERATIONS interrupts.
+ *
+ * @param threadFloat bool TRUE if the interrupted code has an active FPU context.
+ * @param handlerFloat bool TRUE if the handler uses the FPU, forcing any lazily reserved registers to be saved.
+ * @retval uint32_t The average number of cycles.
+ */
+static uint32_t MeasureInterrupt(bool threadFloat, bool handlerFloat) {
+	uint32_t total = 0U;
+	isrUsesFloat = handlerFloat;
+	for (uint32_t i = 0U; i < BENCHMARK_ITERATIONS; ++i) {
+#if (__FPU_USED == 1)
+		if (threadFloat == true) {
+			/* Any FPU instruction makes the context active */
+			benchmarkScratch = benchmarkScratch * 1.0f;
+		} else {
+			__set_CONTROL(__get_CONTROL() & ~BENCHMARK_CONTROL_FPCA);
+			__ISB();
+		}
+#else
+		(void) threadFloat;
+#endif
+		const uint32_t start = DWT->CYCCNT;
+		NVIC_SetPendingIRQ(FPU_IRQn);
+		__DSB();
+		__ISB();
+		total += DWT->CYCCNT - start;
+	}
+	return total / BENCHMARK_ITERATIONS;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Handler for the FPU interrupt, which is only enabled while the interrupt benchmarks run.
+ *
+ * @param none
+ * @retval none
+ */
+void FPU_IRQHandler(void) {
+	if (isrUsesFloat == true) {
+		benchmarkScratch = benchmarkScratch * 1.0f;
+	}
+}
+
+/**
+ * Runs the floating point benchmarks and prints their results. Must be called after the timers, analog inputs and
+ * calibration table are initialized, and before sampling starts.
+ *
+ * @param none
+ * @retval none
+ */
+void Tekdaqc_RunFloatBenchmarks(void) {
+	benchmarkInput = GetAnalogInputByNumber(IN_COLD_JUNCTION);
+	const float low = *(__IO float*) CAL_TEMP_LOW_ADDR;
+	const float high = *(__IO float*) CAL_TEMP_HIGH_ADDR;
+	benchmarkTemperatures[0] = low;
+	benchmarkTemperatures[1] = (low + high) / 2.0f;
+
+#if (__FPU_USED == 1)
+	printf("[Benchmark] Hardware FPU, lazy stacking %s.\n\r",
+			((FPU->FPCCR & (FPU_FPCCR_ASPEN_Msk | FPU_FPCCR_LSPEN_Msk)) == (FPU_FPCCR_ASPEN_Msk | FPU_FPCCR_LSPEN_Msk)) ?
+					"enabled" : "disabled");
+#else
+	printf("[Benchmark] Software floating point.\n\r");
+#endif
+	printf("[Benchmark] Board temperature: %" PRIu32 " cycles.\n\r", MeasureCycles(&BenchmarkBoardTemperature));
+	printf("[Benchmark] Gain calibration: %" PRIu32 " cycles.\n\r", MeasureCycles(&BenchmarkGainCalibration));
+	printf("[Benchmark] Delay of %u us: %" PRIu32 " cycles for %" PRIu32 " requested.\n\r",
+			(unsigned int) (BENCHMARK_DELAY_MS * 1000.0f), MeasureCycles(&BenchmarkDelay),
+			(uint32_t) ((SystemCoreClock / 1000.0f) * BENCHMARK_DELAY_MS));
+
+	NVIC_ClearPendingIRQ(FPU_IRQn);
+	NVIC_EnableIRQ(FPU_IRQn);
+	const uint32_t integerEntry = MeasureInterrupt(false, false);
+	printf("[Benchmark] Interrupt without FPU context: %" PRIu32 " cycles.\n\r", integerEntry);
+#if (__FPU_USED == 1)
+	printf("[Benchmark] Interrupt using FPU without FPU context: %" PRIu32 " cycles.\n\r", MeasureInterrupt(false, true));
+	printf("[Benchmark] Interrupt with FPU context: %" PRIu32 " cycles.\n\r", MeasureInterrupt(true, false));
+	printf("[Benchmark] Interrupt using FPU with FPU context: %" PRIu32 " cycles.\n\r", MeasureInterrupt(true, true));
+#endif
+	NVIC_DisableIRQ(FPU_IRQn);
+	isrUsesFloat = false;
+}
+
+#endif /* FLOAT_BENCHMARK */
@@ -0,0 +1,550 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_BenchmarkSuite.c
+ * @brief Implements the benchmark suite.
+ *
+ * Each scenario is a script of command lines fed through the command interpreter, exactly as a client would send them,
+ * after which the program loop is run for BENCHMARK_SCENARIO_TIME_US before sampling is halted. The sample writers are
+ * replaced by counting sinks for the duration of the suite, so the results do not depend on a client being connected
+ * and the write path is timed up to the point the data would be handed to the connection.
+ *
+ * For each scenario the conversion rate, the rate of digital input records and of bytes written, the dropped samples
+ * and the idle fraction are printed. The idle fraction is the number of program loop passes made relative to a first
+ * scenario with nothing sampling, so it falls as the sampling and write paths take more of the loop.
+ *
+ * Before the scenarios, the same short routine is timed from FLASH and from RAM with the ART caches flushed before
+ * each run, as an interrupt handler finds them after the program loop has run, showing the latency and jitter the
+ * RAM_FUNCTION hot paths save.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_BenchmarkSuite.h"
+
+#ifdef BENCHMARK_SUITE
+
+#include "Tekdaqc_BSP.h"
+#include "Tekdaqc_CommandInterpreter.h"
+#include "Tekdaqc_Scheduler.h"
+#include "Tekdaqc_Timers.h"
+#include "Tekdaqc_TimingHistogram.h"
+#include "ADC_StateMachine.h"
+#include "Analog_Input.h"
+#include "Digital_Input.h"
+#include "TelnetServer.h"
+#include "DataServer.h"
+#include "lwip/tcp_impl.h"
+#include "lwip/inet_chksum.h"
+#include "ethernetif.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The number of sample rates the multi-channel scan is run at */
+#define NUM_BENCHMARK_RATES		16U
+
+/* The longest command line a scenario uses */
+#define BENCHMARK_COMMAND_LENGTH	64U
+
+/* The number of full segments the software checksum is averaged over */
+#define BENCHMARK_CHECKSUM_ITERATIONS	64U
+
+/* The number of cold runs each placement of the code placement benchmark is timed over */
+#define BENCHMARK_PLACEMENT_ITERATIONS	64U
+
+/* The number of words summed by each run of the code placement benchmark */
+#define BENCHMARK_PLACEMENT_WORDS		16U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Data structure holding the counts taken over a scenario.
+ */
+typedef struct {
+	uint32_t passes; /**< The number of program loop passes made. */
+	uint32_t conversions; /**< The number of ADC conversions read. */
+	uint32_t records; /**< The number of digital input records written. */
+	uint32_t bytes; /**< The number of bytes written. */
+	uint32_t overruns; /**< The number of samples dropped. */
+} BenchmarkResult_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* Every ADS1256_SPS_t, as the RATE values of ADD_ANALOG_INPUT */
+static const char* BENCHMARK_RATES[NUM_BENCHMARK_RATES] = { "30000", "15000", "7500", "3750", "2000", "1000", "500",
+		"100", "60", "50", "30", "25", "15", "10", "5", "2.5" };
+
+/* The bytes written to the sinks since the start of the scenario */
+static uint32_t sinkBytes = 0U;
+
+/* The digital input records written to the sink since the start of the scenario */
+static uint32_t sinkRecords = 0U;
+
+/* The program loop passes made by the idle scenario, 0 until it has run */
+static uint32_t idlePasses = 0U;
+
+/* Scratch buffer for building command lines */
+static char commandLine[BENCHMARK_COMMAND_LENGTH];
+
+/* A full TCP segment of payload, summed by the software checksum benchmark */
+static uint8_t checksumSegment[TCP_MSS];
+
+/* The result of the software checksum, kept volatile so the benchmarked work is not optimized away */
+static volatile uint16_t checksumSink = 0U;
+
+/* The words summed by the code placement benchmark */
+static uint32_t placementWords[BENCHMARK_PLACEMENT_WORDS];
+
+/* The result of the code placement benchmark, kept volatile so the benchmarked work is not optimized away */
+static volatile uint32_t placementSink = 0U;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Counts the bytes of an analog input string instead of writing it.
+ */
+static WriteStatus_t BenchmarkWriteString(char* string);
+
+/**
+ * @internal
+ * @brief Counts a digital input record instead of writing it.
+ */
+static WriteStatus_t BenchmarkWriteRecord(char* string);
+
+/**
+ * @internal
+ * @brief Counts the bytes of a binary frame instead of writing it.
+ */
+static WriteStatus_t BenchmarkWriteBinary(const uint8_t* data, uint16_t length);
+
+/**
+ * @internal
+ * @brief Feeds a command line through the command interpreter.
+ */
+static void RunCommand(const char* line);
+
+/**
+ * @internal
+ * @brief Runs the program loop for a time.
+ */
+static uint32_t RunLoop(uint32_t duration);
+
+/**
+ * @internal
+ * @brief Runs a scenario and prints its results.
+ */
+static void RunScenario(const char* name, const char* start);
+
+/**
+ * @internal
+ * @brief Adds a range of analog inputs at the provided rate.
+ */
+static void AddBenchmarkInputs(uint8_t first, uint8_t last, const char* rate);
+
+/**
+ * @internal
+ * @brief Prints the memory cost of the selected network profile.
+ */
+static void PrintNetworkProfile(void);
+
+/**
+ * @internal
+ * @brief Prints the checksum offload state and the cost of the software checksum it saves.
+ */
+static void PrintChecksumProfile(void);
+
+/**
+ * @internal
+ * @brief The work of the code placement benchmark, inlined into each placement.
+ */
+static inline void PlacementWork(void) __attribute__ ((always_inline));
+
+/**
+ * @internal
+ * @brief Runs the code placement benchmark's work from FLASH.
+ */
+static void PlacementFlash(void) __attribute__ ((noinline));
+
+/**
+ * @internal
+ * @brief Runs the code placement benchmark's work from RAM.
+ */
+static void PlacementRam(void) RAM_FUNCTION;
+
+/**
+ * @internal
+ * @brief Measures the fewest and most cycles a placement of the code placement benchmark takes from cold.
+ */
+static void MeasurePlacement(void (*placement)(void), uint32_t* minimum, uint32_t* maximum);
+
+/**
+ * @internal
+ * @brief Prints the cold latency and jitter of the same code run from FLASH and from RAM.
+ */
+static void PrintCodePlacementProfile(void);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Counts the bytes of an analog input string instead of writing it.
+ *
+ * @param string char* The string which would be written.
+ * @retval WriteStatus_t Always WRITE_OK.
+ */
+static WriteStatus_t BenchmarkWriteString(char* string) {
+	sinkBytes += strlen(string);
+	return WRITE_OK;
+}
+
+/**
+ * Counts a digital input record instead of writing it.
+ *
+ * @param string char* The record which would be written.
+ * @retval WriteStatus_t Always WRITE_OK.
+ */
+static WriteStatus_t BenchmarkWriteRecord(char* string) {
+	sinkBytes += strlen(string);
+	++sinkRecords;
+	return WRITE_OK;
+}
+
+/**
+ * Counts the bytes of a binary frame instead of writing it.
+ *
+ * @param data const uint8_t* The frame which would be written.
+ * @param length uint16_t The length of the frame.
+ * @retval WriteStatus_t Always WRITE_OK.
+ */
+static WriteStatus_t BenchmarkWriteBinary(const uint8_t* data, uint16_t length) {
+	(void) data;
+	sinkBytes += length;
+	return WRITE_OK;
+}
+
+/**
+ * Feeds a command line through the command interpreter, followed by the line terminator.
+ *
+ * @param line const char* The command line.
+ * @retval none
+ */
+static void RunCommand(const char* line) {
+	while (*line != '\0') {
+		Command_AddChar(*line);
+		++line;
+	}
+	Command_AddChar('\r');
+}
+
+/**
+ * Runs the program loop for a time, as program_loop() would.
+ *
+ * @param duration uint32_t The time to run for (us).
+ * @retval uint32_t The number of passes made.
+ */
+static uint32_t RunLoop(uint32_t duration) {
+	const uint64_t start = GetLocalTime();
+	uint32_t passes = 0U;
+	while ((GetLocalTime() - start) < duration) {
+		Scheduler_Run();
+		IWDG_ReloadCounter();
+		++passes;
+	}
+	return passes;
+}
+
+/**
+ * Runs a scenario and prints its results. The inputs it samples must already have been added.
+ *
+ * @param name const char* The name of the scenario.
+ * @param start const char* The command line which starts sampling, or NULL to run the loop with nothing sampling.
+ * @retval none
+ */
+static void RunScenario(const char* name, const char* start) {
+	BenchmarkResult_t result;
+	TimingHistogramData_t conversions;
+	const uint32_t overruns = ADC_Machine_GetOverrunCount();
+	const unsigned long dropped = GetDigitalInputDroppedCount();
+	TimingHistogram_Reset();
+	sinkBytes = 0U;
+	sinkRecords = 0U;
+	if (start != NULL) {
+		RunCommand(start);
+	}
+	result.passes = RunLoop(BENCHMARK_SCENARIO_TIME_US);
+	/* Every conversion read is timed from its DRDY */
+	TimingHistogram_Get(TIMING_DRDY_TO_READ, &conversions);
+	result.conversions = conversions.count;
+	result.records = sinkRecords;
+	result.bytes = sinkBytes;
+	result.overruns = (ADC_Machine_GetOverrunCount() - overruns) + (uint32_t) (GetDigitalInputDroppedCount() - dropped);
+	if (start != NULL) {
+		RunCommand("HALT");
+	}
+	RunLoop(BENCHMARK_SETTLE_TIME_US);
+
+	if (idlePasses == 0U) {
+		idlePasses = result.passes;
+	}
+	/* Idle in tenths of a percent of the passes made with nothing sampling */
+	uint32_t idle = (uint32_t) (((uint64_t) result.passes * 1000U) / idlePasses);
+	if (idle > 1000U) {
+		idle = 1000U;
+	}
+	printf("[Benchmark] %s: %" PRIu32 " samples/s, %" PRIu32 " records/s, %" PRIu32 " bytes/s, %" PRIu32 ".%" PRIu32
+			"%% idle, %" PRIu32 " overruns.\n\r", name,
+			(uint32_t) (((uint64_t) result.conversions * 1000000U) / BENCHMARK_SCENARIO_TIME_US),
+			(uint32_t) (((uint64_t) result.records * 1000000U) / BENCHMARK_SCENARIO_TIME_US),
+			(uint32_t) (((uint64_t) result.bytes * 1000000U) / BENCHMARK_SCENARIO_TIME_US), idle / 10U, idle % 10U,
+			result.overruns);
+}
+
+/**
+ * Adds a range of analog inputs at the provided rate, with unity gain and the buffer enabled.
+ *
+ * @param first uint8_t The first physical input.
+ * @param last uint8_t The last physical input.
+ * @param rate const char* The RATE value.
+ * @retval none
+ */
+static void AddBenchmarkInputs(uint8_t first, uint8_t last, const char* rate) {
+	for (uint8_t i = first; i <= last; ++i) {
+		snprintf(commandLine, sizeof(commandLine), "ADD_ANALOG_INPUT --INPUT=%u --RATE=%s --GAIN=1 --NAME=BENCH",
+				(unsigned int) i, rate);
+		RunCommand(commandLine);
+	}
+}
+
+/**
+ * Prints the memory the selected network profile reserves for the lwIP heap, the pbuf pool, the TCP segment queue
+ * and the transmit rings of the Telnet and data servers, so that the throughput of each profile can be weighed
+ * against its cost.
+ *
+ * @param none
+ * @retval none
+ */
+static void PrintNetworkProfile(void) {
+	const uint32_t heap = MEM_SIZE;
+	const uint32_t pool = PBUF_POOL_SIZE
+			* (LWIP_MEM_ALIGN_SIZE(sizeof(struct pbuf)) + LWIP_MEM_ALIGN_SIZE(PBUF_POOL_BUFSIZE));
+	const uint32_t segments = MEMP_NUM_TCP_SEG * LWIP_MEM_ALIGN_SIZE(sizeof(struct tcp_seg));
+	const uint32_t rings = (TELNET_TX_SEGMENT_COUNT * TELNET_TX_SEGMENT_SIZE)
+			+ (DATA_TX_SEGMENT_COUNT * DATA_TX_SEGMENT_SIZE);
+	printf("[Benchmark] Network profile %s: %" PRIu32 " bytes (heap %" PRIu32 ", pbuf pool %" PRIu32
+			", TCP segments %" PRIu32 ", transmit rings %" PRIu32 "), TCP send buffer %" PRIu32 " bytes.\n\r",
+			NETWORK_PROFILE_NAME, heap + pool + segments + rings, heap, pool, segments, rings, (uint32_t) TCP_SND_BUF);
+}
+
+/**
+ * Prints the checksum offload state verified by the Ethernet driver and the average number of cycles the software
+ * checksum takes over a full TCP segment, which is the CPU time each transmitted and each received segment would cost
+ * without offload.
+ *
+ * @param none
+ * @retval none
+ */
+static void PrintChecksumProfile(void) {
+	for (uint32_t i = 0U; i < sizeof(checksumSegment); ++i) {
+		checksumSegment[i] = (uint8_t) i;
+	}
+	const uint32_t start = DWT->CYCCNT;
+	for (uint32_t i = 0U; i < BENCHMARK_CHECKSUM_ITERATIONS; ++i) {
+		checksumSink = inet_chksum(checksumSegment, sizeof(checksumSegment));
+	}
+	const uint32_t cycles = (DWT->CYCCNT - start) / BENCHMARK_CHECKSUM_ITERATIONS;
+	printf("[Benchmark] Checksum offload %s, software checksum of a %" PRIu32 " byte segment: %" PRIu32 " cycles (%"
+			PRIu32 " ns).\n\r", (ethernetif_get_checksum_offload() == ETHERNETIF_CHECKSUM_SOFTWARE) ? "OFF" : "ON",
+			(uint32_t) TCP_MSS, cycles, (uint32_t) (((uint64_t) cycles * 1000000000ULL) / SystemCoreClock));
+}
+
+/**
+ * Sums the benchmark words with a branch on each, so the timing depends on instruction fetch as interrupt code does.
+ *
+ * @param none
+ * @retval none
+ */
+static inline void PlacementWork(void) {
+	uint32_t sum = 0U;
+	for (uint32_t i = 0U; i < BENCHMARK_PLACEMENT_WORDS; ++i) {
+		const uint32_t word = placementWords[i];
+		sum = ((word & 0x01U) != 0U) ? (sum + word) : (sum ^ (word << 3));
+	}
+	placementSink = sum;
+}
+
+/**
+ * Runs the code placement benchmark's work from FLASH.
+ *
+ * @param none
+ * @retval none
+ */
+static void PlacementFlash(void) {
+	PlacementWork();
+}
+
+/**
+ * Runs the code placement benchmark's work from RAM.
+ *
+ * @param none
+ * @retval none
+ */
+static void PlacementRam(void) {
+	PlacementWork();
+}
+
+/**
+ * Times a placement of the code placement benchmark BENCHMARK_PLACEMENT_ITERATIONS times with interrupts disabled,
+ * resetting the ART instruction and data caches before each run so every one starts cold.
+ *
+ * @param placement void (*)(void) The placement to time.
+ * @param minimum uint32_t* Set to the fewest cycles a run took.
+ * @param maximum uint32_t* Set to the most cycles a run took.
+ * @retval none
+ */
+static void MeasurePlacement(void (*placement)(void), uint32_t* minimum, uint32_t* maximum) {
+	*minimum = UINT32_MAX;
+	*maximum = 0U;
+	for (uint32_t i = 0U; i < BENCHMARK_PLACEMENT_ITERATIONS; ++i) {
+		const uint32_t primask = __get_PRIMASK();
+		__disable_irq();
+		/* The caches may only be reset while disabled */
+		FLASH->ACR &= ~(FLASH_ACR_ICEN | FLASH_ACR_DCEN);
+		FLASH->ACR |= (FLASH_ACR_ICRST | FLASH_ACR_DCRST);
+		FLASH->ACR &= ~(FLASH_ACR_ICRST | FLASH_ACR_DCRST);
+		FLASH->ACR |= (FLASH_ACR_ICEN | FLASH_ACR_DCEN);
+		__ISB();
+		const uint32_t start = DWT->CYCCNT;
+		placement();
+		const uint32_t cycles = DWT->CYCCNT - start;
+		__set_PRIMASK(primask);
+		if (cycles < *minimum) {
+			*minimum = cycles;
+		}
+		if (cycles > *maximum) {
+			*maximum = cycles;
+		}
+	}
+}
+
+/**
+ * Prints the fewest and most cycles the same routine takes from cold when run from FLASH and when run from RAM. The
+ * difference in the fewest is the latency a RAM_FUNCTION saves, the spread of each is its jitter.
+ *
+ * @param none
+ * @retval none
+ */
+static void PrintCodePlacementProfile(void) {
+	for (uint32_t i = 0U; i < BENCHMARK_PLACEMENT_WORDS; ++i) {
+		placementWords[i] = i * 0x9E3779B9U;
+	}
+	uint32_t flashMinimum;
+	uint32_t flashMaximum;
+	uint32_t ramMinimum;
+	uint32_t ramMaximum;
+	MeasurePlacement(&PlacementFlash, &flashMinimum, &flashMaximum);
+	MeasurePlacement(&PlacementRam, &ramMinimum, &ramMaximum);
+	printf("[Benchmark] Cold code from FLASH: %" PRIu32 " to %" PRIu32 " cycles, from RAM: %" PRIu32 " to %" PRIu32
+			" cycles.\n\r", flashMinimum, flashMaximum, ramMinimum, ramMaximum);
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Runs the scenarios of the benchmark suite and prints their results. Must be called once the scheduler tasks have been
+ * added, before the program loop starts. The inputs added by the scenarios are removed and the provided writers
+ * restored afterwards, so the board then starts as usual.
+ *
+ * @param writer WriteFunction The string write function to restore.
+ * @param binaryWriter BinaryWriteFunction The binary write function to restore.
+ * @retval none
+ */
+void Tekdaqc_RunBenchmarkSuite(WriteFunction writer, BinaryWriteFunction binaryWriter) {
+	SetAnalogInputWriteFunction(&BenchmarkWriteString);
+	SetAnalogInputBinaryWriteFunction(&BenchmarkWriteBinary);
+	SetDigitalInputWriteFunction(&BenchmarkWriteRecord);
+
+	/* Let the ADC finish its start up calibration */
+	const uint64_t start = GetLocalTime();
+	while ((ADC_Machine_GetState() != ADC_IDLE) && ((GetLocalTime() - start) < BENCHMARK_READY_TIMEOUT_US)) {
+		RunLoop(BENCHMARK_SETTLE_TIME_US);
+	}
+	RunLoop(BENCHMARK_SETTLE_TIME_US);
+	PrintNetworkProfile();
+	PrintChecksumProfile();
+	PrintCodePlacementProfile();
+	printf("[Benchmark] Starting the benchmark suite, %" PRIu32 " ms per scenario.\n\r",
+			BENCHMARK_SCENARIO_TIME_US / 1000U);
+
+	/* The idle scenario must run first, it is the reference for the others */
+	RunScenario("IDLE", NULL);
+
+	/* Single channel at the maximum rate, in both data formats */
+	AddBenchmarkInputs(0U, 0U, BENCHMARK_RATES[0]);
+	RunCommand("SET_DATA_FORMAT --FORMAT=" FORMAT_TEXT_STRING);
+	RunScenario("SINGLE_CHANNEL_TEXT", "READ_ANALOG_INPUT --INPUT=0 --NUMBER=" BENCHMARK_SAMPLE_COUNT);
+	RunCommand("SET_DATA_FORMAT --FORMAT=" FORMAT_BINARY_STRING);
+	RunScenario("SINGLE_CHANNEL_BINARY", "READ_ANALOG_INPUT --INPUT=0 --NUMBER=" BENCHMARK_SAMPLE_COUNT);
+	RunCommand("SET_DATA_FORMAT --FORMAT=" FORMAT_TEXT_STRING);
+
+	/* Every external input at each rate */
+	char name[BENCHMARK_COMMAND_LENGTH];
+	for (uint_fast8_t i = 0U; i < NUM_BENCHMARK_RATES; ++i) {
+		AddBenchmarkInputs(0U, NUM_EXT_ANALOG_INPUTS - 1U, BENCHMARK_RATES[i]);
+		snprintf(name, sizeof(name), "SCAN_32_%s", BENCHMARK_RATES[i]);
+		RunScenario(name, "READ_ANALOG_INPUT --INPUT=0-31 --NUMBER=" BENCHMARK_SAMPLE_COUNT);
+	}
+	for (uint8_t i = 0U; i < NUM_EXT_ANALOG_INPUTS; ++i) {
+		snprintf(commandLine, sizeof(commandLine), "REMOVE_ANALOG_INPUT --INPUT=%u", (unsigned int) i);
+		RunCommand(commandLine);
+	}
+
+	/* Every digital input */
+	for (uint8_t i = 0U; i < NUM_DIGITAL_INPUTS; ++i) {
+		snprintf(commandLine, sizeof(commandLine), "ADD_DIGITAL_INPUT --INPUT=%u --NAME=BENCH", (unsigned int) i);
+		RunCommand(commandLine);
+	}
+	RunScenario("DIGITAL_SCAN", "READ_DIGITAL_INPUT --INPUT=0-23 --NUMBER=" BENCHMARK_SAMPLE_COUNT);
+	for (uint8_t i = 0U; i < NUM_DIGITAL_INPUTS; ++i) {
+		snprintf(commandLine, sizeof(commandLine), "REMOVE_DIGITAL_INPUT --INPUT=%u", (unsigned int) i);
+		RunCommand(commandLine);
+	}
+
+	printf("[Benchmark] The benchmark suite is complete.\n\r");
+	SetAnalogInputWriteFunction(writer);
+	SetAnalogInputBinaryWriteFunction(binaryWriter);
+	SetDigitalInputWriteFunction(writer);
+}
+
+#endif /* BENCHMARK_SUITE */
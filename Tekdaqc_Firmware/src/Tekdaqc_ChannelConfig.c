@@ -0,0 +1,538 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_ChannelConfig.c
+ * @brief Saves and restores the channel configuration of the Tekdaqc.
+ *
+ * Saves the settings of the added channels as compact records in the FLASH disk's emulated EEPROM and adds them back
+ * again, so that the board does not need to be sent every ADD command after each reset. Each analog input has a record
+ * of its buffer, gain and rate settings, deadband and heartbeat. The digital inputs are saved as a bit field of the
+ * added inputs plus their debounce hold times and the digital outputs as a bit field of the added outputs. Channel
+ * names are not saved and are restored as NONE. A sampling job is saved alongside as the parameters of a SAMPLE command
+ * and a publish destination, as are up to MACRO_COUNT named command macros, each the text of its command lines.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "Tekdaqc_ChannelConfig.h"
+#include "Analog_Input.h"
+#include "AnalogInput_Multiplexer.h"
+#include "Digital_Input.h"
+#include "Digital_Output.h"
+#include "ADS1256_Driver.h"
+#include "eeprom.h"
+#include <string.h>
+
+#ifdef PRINTF_OUTPUT
+#include <stdio.h>
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def CONFIG_ANALOG_ADDED
+ * @brief The bit of an analog input record's settings word which marks the input as added.
+ */
+#define CONFIG_ANALOG_ADDED			(1U << 15)
+
+/**
+ * @internal
+ * @def CONFIG_ANALOG_BUFFER_SHIFT
+ * @brief The position of the buffer setting in an analog input record's settings word.
+ */
+#define CONFIG_ANALOG_BUFFER_SHIFT	11U
+
+/**
+ * @internal
+ * @def CONFIG_ANALOG_GAIN_SHIFT
+ * @brief The position of the gain setting in an analog input record's settings word. The rate fills the low byte.
+ */
+#define CONFIG_ANALOG_GAIN_SHIFT	8U
+
+/**
+ * @internal
+ * @def CONFIG_DIFF_NEGATIVE_SHIFT
+ * @brief The position of the negative input in a differential input record's pair word. The positive fills the low byte.
+ */
+#define CONFIG_DIFF_NEGATIVE_SHIFT	8U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Writes a word of the configuration, skipping the write if it is unchanged.
+ */
+static bool WriteConfigWord(uint16_t address, uint16_t value);
+
+/**
+ * @internal
+ * @brief Reads a word of the configuration.
+ */
+static uint16_t ReadConfigWord(uint16_t address);
+
+/**
+ * @internal
+ * @brief Finds the address of an analog input's saved record.
+ */
+static uint16_t GetAnalogRecordAddress(uint8_t number);
+
+/**
+ * @internal
+ * @brief Restores an analog input from its saved record.
+ */
+static void LoadAnalogInput(uint8_t number);
+
+/**
+ * @internal
+ * @brief Writes a 32 bit value of the configuration as two words.
+ */
+static bool WriteConfigLong(uint16_t address, uint32_t value);
+
+/**
+ * @internal
+ * @brief Reads a 32 bit value of the configuration from two words.
+ */
+static uint32_t ReadConfigLong(uint16_t address);
+
+/**
+ * @internal
+ * @brief Writes a run of characters of the configuration, two to a word.
+ */
+static bool WriteConfigText(uint16_t address, const char* text, uint16_t length);
+
+/**
+ * @internal
+ * @brief Reads a run of characters of the configuration, two to a word.
+ */
+static void ReadConfigText(uint16_t address, char* text, uint16_t length);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Writes a word of the configuration to the emulated EEPROM. Words which already hold the value are not written again,
+ * so saving an unchanged configuration does not wear the FLASH.
+ *
+ * @param address uint16_t The virtual address of the word.
+ * @param value uint16_t The value to write.
+ * @retval bool TRUE if the word holds the value.
+ */
+static bool WriteConfigWord(uint16_t address, uint16_t value) {
+	uint16_t current = 0U;
+	if (EE_ReadVariable(address, &current) == 0U && current == value) {
+		return TRUE;
+	}
+	return (EE_QueueWrite(address, value) == FLASH_COMPLETE) ? TRUE : FALSE;
+}
+
+/**
+ * Reads a word of the configuration from the emulated EEPROM.
+ *
+ * @param address uint16_t The virtual address of the word.
+ * @retval uint16_t The value of the word, 0 if it has never been written.
+ */
+static uint16_t ReadConfigWord(uint16_t address) {
+	uint16_t value = 0U;
+	if (EE_ReadVariable(address, &value) != 0U) {
+		value = 0U;
+	}
+	return value;
+}
+
+/**
+ * Writes a 32 bit value of the configuration to the emulated EEPROM, low word first.
+ *
+ * @param address uint16_t The virtual address of the low word.
+ * @param value uint32_t The value to write.
+ * @retval bool TRUE if both words hold the value.
+ */
+static bool WriteConfigLong(uint16_t address, uint32_t value) {
+	return WriteConfigWord(address, (uint16_t) value) && WriteConfigWord(address + 1U, (uint16_t) (value >> 16));
+}
+
+/**
+ * Reads a 32 bit value of the configuration from the emulated EEPROM.
+ *
+ * @param address uint16_t The virtual address of the low word.
+ * @retval uint32_t The value, with any word which has never been written read as 0.
+ */
+static uint32_t ReadConfigLong(uint16_t address) {
+	return ((uint32_t) ReadConfigWord(address + 1U) << 16) | ReadConfigWord(address);
+}
+
+/**
+ * Writes a run of characters of the configuration to the emulated EEPROM, two to a word with the first in the low
+ * byte. An odd length is padded with a 0 character.
+ *
+ * @param address uint16_t The virtual address of the first word.
+ * @param text const char* Pointer to the characters to write.
+ * @param length uint16_t The number of characters to write.
+ * @retval bool TRUE if every word holds its characters.
+ */
+static bool WriteConfigText(uint16_t address, const char* text, uint16_t length) {
+	bool written = TRUE;
+	for (uint16_t i = 0U; (i < length) && (written == TRUE); i += 2U) {
+		const uint16_t high = ((i + 1U) < length) ? (uint8_t) text[i + 1U] : 0U;
+		written = WriteConfigWord(address + (i / 2U), (uint16_t) (high << 8) | (uint8_t) text[i]);
+	}
+	return written;
+}
+
+/**
+ * Reads a run of characters of the configuration from the emulated EEPROM, as written by WriteConfigText().
+ *
+ * @param address uint16_t The virtual address of the first word.
+ * @param text char* Pointer to the buffer to fill, at least length characters long rounded up to even.
+ * @param length uint16_t The number of characters to read.
+ * @retval none
+ */
+static void ReadConfigText(uint16_t address, char* text, uint16_t length) {
+	for (uint16_t i = 0U; i < length; i += 2U) {
+		const uint16_t word = ReadConfigWord(address + (i / 2U));
+		text[i] = (char) (word & 0xFFU);
+		text[i + 1U] = (char) (word >> 8);
+	}
+}
+
+/**
+ * Finds the address of an analog input's saved record. The differential inputs' records are kept apart from the
+ * others, with the pair following the common words.
+ *
+ * @param number uint8_t The number of the analog input.
+ * @retval uint16_t The virtual address of the first word of the record.
+ */
+static uint16_t GetAnalogRecordAddress(uint8_t number) {
+	if (isDifferentialInput(number)) {
+		return ADDR_CONFIG_DIFF_BASE + ((number - DIFFERENTIAL_0) * CONFIG_DIFF_RECORD_WORDS);
+	} else {
+		return ADDR_CONFIG_ANALOG_BASE + (number * CONFIG_ANALOG_RECORD_WORDS);
+	}
+}
+
+/**
+ * Restores an analog input from its saved record, if the record marks it as added and its settings are valid.
+ *
+ * @param number uint8_t The number of the analog input.
+ * @retval none
+ */
+static void LoadAnalogInput(uint8_t number) {
+	const uint16_t base = GetAnalogRecordAddress(number);
+	const uint16_t settings = ReadConfigWord(base);
+	if ((settings & CONFIG_ANALOG_ADDED) == 0U) {
+		return;
+	}
+	const uint8_t buffer = (settings >> CONFIG_ANALOG_BUFFER_SHIFT) & 0x01U;
+	const uint8_t gain = (settings >> CONFIG_ANALOG_GAIN_SHIFT) & 0x07U;
+	const uint8_t rate = settings & 0xFFU;
+	if (!IS_ADS1256_PGA_SETTING(gain) || !IS_ADS1256_SPS_SETTING(rate)) {
+#ifdef CHANNEL_CONFIG_DEBUG
+		printf("[Channel Config] Saved settings of analog input %i are invalid.\n\r", number);
+#endif
+		return;
+	}
+	const uint32_t deadband = ((uint32_t) ReadConfigWord(base + 2U) << 16) | ReadConfigWord(base + 1U);
+	const uint32_t heartbeat = ((uint32_t) ReadConfigWord(base + 4U) << 16) | ReadConfigWord(base + 3U);
+	if (isDifferentialInput(number)) {
+		const uint16_t pair = ReadConfigWord(base + CONFIG_ANALOG_RECORD_WORDS);
+		const uint8_t positive = pair & 0xFFU;
+		const uint8_t negative = pair >> CONFIG_DIFF_NEGATIVE_SHIFT;
+		if (!IS_ADS1256_AIN_SETTING(positive) || !IS_ADS1256_AIN_SETTING(negative) || (positive == negative)) {
+#ifdef CHANNEL_CONFIG_DEBUG
+			printf("[Channel Config] Saved pair of analog input %i is invalid.\n\r", number);
+#endif
+			return;
+		}
+		Analog_Input_t* input = GetAnalogInputByNumber(number);
+		if (input->added == CHANNEL_NOTADDED) {
+			input->positiveInput = (ADS1256_AIN_t) positive;
+			input->negativeInput = (ADS1256_AIN_t) negative;
+		}
+	}
+	Tekdaqc_Function_Error_t status = ConfigureAnalogInput(number, (ADS1256_BUFFER_t) buffer, (ADS1256_SPS_t) rate,
+			(ADS1256_PGA_t) gain, "NONE", deadband, heartbeat);
+#ifdef CHANNEL_CONFIG_DEBUG
+	if (status != ERR_FUNCTION_OK) {
+		printf("[Channel Config] Restoring analog input %i failed: %s\n\r", number, Tekdaqc_FunctionError_ToString(status));
+	}
+#else
+	(void) status;
+#endif
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Saves the configuration of the added channels to the FLASH disk. The marker is cleared while the records are written
+ * and set again last, so a save which is interrupted leaves no configuration rather than a partial one.
+ *
+ * @param none
+ * @retval Tekdaqc_Function_Error_t The error status of this function.
+ */
+Tekdaqc_Function_Error_t SaveChannelConfig(void) {
+	bool written = WriteConfigWord(ADDR_CONFIG_MARKER, 0U);
+	for (uint_fast8_t i = 0U; i < NUM_ANALOG_INPUTS && written == TRUE; ++i) {
+		const uint16_t base = GetAnalogRecordAddress(i);
+		const Analog_Input_t* input = GetAnalogInputByNumber(i);
+		uint16_t settings = 0U;
+		uint32_t deadband = 0U;
+		uint32_t heartbeat = 0U;
+		if (input != NULL && input->added == CHANNEL_ADDED) {
+			settings = CONFIG_ANALOG_ADDED | ((uint16_t) input->buffer << CONFIG_ANALOG_BUFFER_SHIFT)
+					| ((uint16_t) input->gain << CONFIG_ANALOG_GAIN_SHIFT) | (uint16_t) input->rate;
+			deadband = input->deadband;
+			heartbeat = input->heartbeat / 1000U;
+		}
+		written = WriteConfigWord(base, settings) && WriteConfigWord(base + 1U, (uint16_t) deadband)
+				&& WriteConfigWord(base + 2U, (uint16_t) (deadband >> 16)) && WriteConfigWord(base + 3U, (uint16_t) heartbeat)
+				&& WriteConfigWord(base + 4U, (uint16_t) (heartbeat >> 16));
+		if (isDifferentialInput(i) && written == TRUE) {
+			written = WriteConfigWord(base + CONFIG_ANALOG_RECORD_WORDS,
+					((uint16_t) input->negativeInput << CONFIG_DIFF_NEGATIVE_SHIFT) | (uint16_t) input->positiveInput);
+		}
+	}
+	uint32_t inputs = 0U;
+	uint16_t holds[(NUM_DIGITAL_INPUTS + 1U) / 2U];
+	memset(holds, 0, sizeof(holds));
+	for (uint_fast8_t i = 0U; i < NUM_DIGITAL_INPUTS; ++i) {
+		const Digital_Input_t* input = GetDigitalInputByNumber(i);
+		if (input != NULL && input->added == CHANNEL_ADDED) {
+			inputs |= (1UL << i);
+			holds[i / 2U] |= (uint16_t) input->hold << ((i % 2U) * 8U);
+		}
+	}
+	written = written && WriteConfigWord(ADDR_CONFIG_DIGITAL_INPUTS, (uint16_t) inputs)
+			&& WriteConfigWord(ADDR_CONFIG_DIGITAL_INPUTS + 1U, (uint16_t) (inputs >> 16));
+	for (uint_fast8_t i = 0U; i < ((NUM_DIGITAL_INPUTS + 1U) / 2U) && written == TRUE; ++i) {
+		written = WriteConfigWord(ADDR_CONFIG_DIGITAL_HOLDS + i, holds[i]);
+	}
+	uint32_t outputs = 0U;
+	for (uint_fast8_t i = 0U; i < NUM_DIGITAL_OUTPUTS; ++i) {
+		const Digital_Output_t* output = GetDigitalOutputByNumber(i);
+		if (output != NULL && output->added == CHANNEL_ADDED) {
+			outputs |= (1UL << i);
+		}
+	}
+	written = written && WriteConfigWord(ADDR_CONFIG_DIGITAL_OUTPUTS, (uint16_t) outputs)
+			&& WriteConfigWord(ADDR_CONFIG_DIGITAL_OUTPUTS_HIGH, (uint16_t) (outputs >> 16));
+	written = written && WriteConfigWord(ADDR_CONFIG_MARKER, CHANNEL_CONFIG_MARKER);
+#ifdef CHANNEL_CONFIG_DEBUG
+	printf("[Channel Config] Saving the channel configuration %s.\n\r", (written == TRUE) ? "succeeded" : "failed");
+#endif
+	return (written == TRUE) ? ERR_FUNCTION_OK : ERR_CONFIG_WRITE_FAILED;
+}
+
+/**
+ * Adds the channels of the saved configuration. Channels which are already added are left as they are.
+ *
+ * @param none
+ * @retval Tekdaqc_Function_Error_t The error status of this function.
+ */
+Tekdaqc_Function_Error_t LoadChannelConfig(void) {
+	if (ReadConfigWord(ADDR_CONFIG_MARKER) != CHANNEL_CONFIG_MARKER) {
+		return ERR_CONFIG_NOT_SAVED;
+	}
+	const bool open = isAnalogInputConfigOpen();
+	BeginAnalogInputConfig();
+	for (uint_fast8_t i = 0U; i < NUM_ANALOG_INPUTS; ++i) {
+		LoadAnalogInput(i);
+	}
+	if (open == false) {
+		CommitAnalogInputConfig();
+	}
+	const uint32_t inputs = ((uint32_t) ReadConfigWord(ADDR_CONFIG_DIGITAL_INPUTS + 1U) << 16)
+			| ReadConfigWord(ADDR_CONFIG_DIGITAL_INPUTS);
+	for (uint_fast8_t i = 0U; i < NUM_DIGITAL_INPUTS; ++i) {
+		Digital_Input_t* input = GetDigitalInputByNumber(i);
+		if ((inputs & (1UL << i)) != 0U && input != NULL && input->added == CHANNEL_NOTADDED) {
+			input->input = (GPI_TypeDef) i;
+			strcpy(input->name, "NONE");
+			input->hold = (uint8_t) (ReadConfigWord(ADDR_CONFIG_DIGITAL_HOLDS + (i / 2U)) >> ((i % 2U) * 8U));
+			input->level = LOGIC_LOW;
+			input->timestamp = 0U;
+			AddDigitalInput(input);
+		}
+	}
+	const uint32_t outputs = ((uint32_t) ReadConfigWord(ADDR_CONFIG_DIGITAL_OUTPUTS_HIGH) << 16)
+			| ReadConfigWord(ADDR_CONFIG_DIGITAL_OUTPUTS);
+	for (uint_fast8_t i = 0U; i < NUM_DIGITAL_OUTPUTS; ++i) {
+		Digital_Output_t* output = GetDigitalOutputByNumber(i);
+		if ((outputs & (1UL << i)) != 0U && output != NULL && output->added == CHANNEL_NOTADDED) {
+			output->output = (GPO_TypeDef) i;
+			strcpy(output->name, "NONE");
+			output->level = LOGIC_LOW;
+			output->timestamp = 0U;
+			AddDigitalOutput(output);
+		}
+	}
+#ifdef CHANNEL_CONFIG_DEBUG
+	printf("[Channel Config] Restored the saved channel configuration.\n\r");
+#endif
+	return ERR_FUNCTION_OK;
+}
+
+/**
+ * Saves a sampling job to the FLASH disk. As with the channel configuration, the marker is written last so that an
+ * interrupted save leaves no job.
+ *
+ * @param job const SamplingJob_t* Pointer to the job to save.
+ * @retval Tekdaqc_Function_Error_t The error status of this function.
+ */
+Tekdaqc_Function_Error_t SaveSamplingJob(const SamplingJob_t* job) {
+	bool written = WriteConfigWord(ADDR_JOB_MARKER, 0U) && WriteConfigLong(ADDR_JOB_NUMBER, (uint32_t) job->number)
+			&& WriteConfigLong(ADDR_JOB_WINDOW, job->window) && WriteConfigLong(ADDR_JOB_TIME, job->period)
+			&& WriteConfigLong(ADDR_JOB_ADDRESS, job->address) && WriteConfigWord(ADDR_JOB_PORT, job->port)
+			&& WriteConfigWord(ADDR_JOB_OVERFLOW, job->overflow)
+			&& WriteConfigWord(ADDR_JOB_MARKER, SAMPLING_JOB_MARKER);
+#ifdef CHANNEL_CONFIG_DEBUG
+	printf("[Channel Config] Saving the sampling job %s.\n\r", (written == TRUE) ? "succeeded" : "failed");
+#endif
+	return (written == TRUE) ? ERR_FUNCTION_OK : ERR_CONFIG_WRITE_FAILED;
+}
+
+/**
+ * Clears the saved sampling job, so that nothing is sampled at boot.
+ *
+ * @param none
+ * @retval Tekdaqc_Function_Error_t The error status of this function.
+ */
+Tekdaqc_Function_Error_t ClearSamplingJob(void) {
+	return (WriteConfigWord(ADDR_JOB_MARKER, 0U) == TRUE) ? ERR_FUNCTION_OK : ERR_CONFIG_WRITE_FAILED;
+}
+
+/**
+ * Retrieves the saved sampling job.
+ *
+ * @param job SamplingJob_t* Pointer to the job to fill.
+ * @retval Tekdaqc_Function_Error_t The error status of this function.
+ */
+Tekdaqc_Function_Error_t LoadSamplingJob(SamplingJob_t* job) {
+	if (ReadConfigWord(ADDR_JOB_MARKER) != SAMPLING_JOB_MARKER) {
+		return ERR_JOB_NOT_SAVED;
+	}
+	job->number = (int32_t) ReadConfigLong(ADDR_JOB_NUMBER);
+	job->window = ReadConfigLong(ADDR_JOB_WINDOW);
+	job->period = ReadConfigLong(ADDR_JOB_TIME);
+	job->address = ReadConfigLong(ADDR_JOB_ADDRESS);
+	job->port = ReadConfigWord(ADDR_JOB_PORT);
+	/* Jobs saved before the policy existed read as 0, the default */
+	job->overflow = ReadConfigWord(ADDR_JOB_OVERFLOW);
+	return ERR_FUNCTION_OK;
+}
+
+/**
+ * Finds the slot of the saved macro of the provided name.
+ *
+ * @param name const char* C-String of the name of the macro.
+ * @retval int8_t The slot of the macro, or -1 if no macro of the name is saved.
+ */
+int8_t FindMacro(const char* name) {
+	char saved[MACRO_NAME_LENGTH];
+	for (uint_fast8_t slot = 0U; slot < MACRO_COUNT; ++slot) {
+		if ((LoadMacro(slot, saved, NULL) > 0U) && (strncmp(saved, name, MACRO_NAME_LENGTH) == 0)) {
+			return (int8_t) slot;
+		}
+	}
+	return -1;
+}
+
+/**
+ * Saves a command macro to the FLASH disk, replacing any saved macro of the same name. Only the words the text covers
+ * are written. The length is cleared while the name and text are written and set last, so a save which is
+ * interrupted leaves the slot unused rather than holding a partial macro.
+ *
+ * @param name const char* C-String of the name of the macro, shorter than MACRO_NAME_LENGTH.
+ * @param text const char* Pointer to the text of the macro, its command lines each ended by a line feed.
+ * @param length uint16_t The length of the text, from 1 to MACRO_SIZE.
+ * @retval Tekdaqc_Function_Error_t The error status of this function.
+ */
+Tekdaqc_Function_Error_t SaveMacro(const char* name, const char* text, uint16_t length) {
+	if ((length == 0U) || (length > MACRO_SIZE)) {
+		return ERR_MACRO_TOO_LONG;
+	}
+	int8_t slot = FindMacro(name);
+	for (uint_fast8_t i = 0U; (i < MACRO_COUNT) && (slot < 0); ++i) {
+		if (LoadMacro(i, NULL, NULL) == 0U) {
+			slot = (int8_t) i;
+		}
+	}
+	if (slot < 0) {
+		return ERR_MACRO_TABLE_FULL;
+	}
+	char padded[MACRO_NAME_LENGTH];
+	memset(padded, 0, sizeof(padded));
+	strncpy(padded, name, MACRO_NAME_LENGTH - 1U);
+	const uint16_t base = ADDR_MACRO_BASE + (slot * MACRO_RECORD_WORDS);
+	const bool written = WriteConfigWord(base, 0U) && WriteConfigText(base + 1U, padded, MACRO_NAME_LENGTH)
+			&& WriteConfigText(base + 1U + (MACRO_NAME_LENGTH / 2U), text, length) && WriteConfigWord(base, length);
+#ifdef CHANNEL_CONFIG_DEBUG
+	printf("[Channel Config] Saving macro %s to slot %i %s.\n\r", padded, slot, (written == TRUE) ? "succeeded" : "failed");
+#endif
+	return (written == TRUE) ? ERR_FUNCTION_OK : ERR_CONFIG_WRITE_FAILED;
+}
+
+/**
+ * Deletes the saved macro of the provided name, freeing its slot.
+ *
+ * @param name const char* C-String of the name of the macro.
+ * @retval Tekdaqc_Function_Error_t The error status of this function.
+ */
+Tekdaqc_Function_Error_t DeleteMacro(const char* name) {
+	const int8_t slot = FindMacro(name);
+	if (slot < 0) {
+		return ERR_MACRO_NOT_SAVED;
+	}
+	return (WriteConfigWord(ADDR_MACRO_BASE + (slot * MACRO_RECORD_WORDS), 0U) == TRUE) ? ERR_FUNCTION_OK
+			: ERR_CONFIG_WRITE_FAILED;
+}
+
+/**
+ * Retrieves the name and text of the macro saved in a slot. Either buffer may be NULL if it is not wanted.
+ *
+ * @param slot uint8_t The slot of the macro, from 0 to MACRO_COUNT - 1.
+ * @param name char* Pointer to the MACRO_NAME_LENGTH character buffer to fill with the C-String of the macro's name.
+ * @param text char* Pointer to the MACRO_SIZE character buffer to fill with the text of the macro.
+ * @retval uint16_t The length of the macro's text, 0 if the slot is unused.
+ */
+uint16_t LoadMacro(uint8_t slot, char* name, char* text) {
+	if (slot >= MACRO_COUNT) {
+		return 0U;
+	}
+	const uint16_t base = ADDR_MACRO_BASE + (slot * MACRO_RECORD_WORDS);
+	const uint16_t length = ReadConfigWord(base);
+	if (length > MACRO_SIZE) {
+		return 0U;
+	}
+	if ((length > 0U) && (name != NULL)) {
+		ReadConfigText(base + 1U, name, MACRO_NAME_LENGTH);
+		name[MACRO_NAME_LENGTH - 1U] = '\0';
+	}
+	if ((length > 0U) && (text != NULL)) {
+		ReadConfigText(base + 1U + (MACRO_NAME_LENGTH / 2U), text, (length + 1U) & ~1U);
+	}
+	return length;
+}
@@ -35,9 +35,17 @@
 #include "DI_StateMachine.h"
 #include "DO_StateMachine.h"
 #include "Analog_Input.h"
+#include "AnalogInput_Trigger.h"
+#include "AnalogInput_Spectrum.h"
 #include "Digital_Input.h"
+#include "DigitalInput_Encoder.h"
 #include "Digital_Output.h"
+#include "DigitalOutput_Interlock.h"
+#include "DigitalOutput_PID.h"
 #include "TelnetServer.h"
+#include "DataServer.h"
+#include "SamplePublisher.h"
+#include "RawStream.h"
 #include "ADS1256_Driver.h"
 #include "Tekdaqc_Calibration.h"
 #include "CommandState.h"
@@ -45,7 +53,29 @@
 #include "Tekdaqc_Error.h"
 #include "boolean.h"
 #include "Tekdaqc_Locator.h"
+#include "Tekdaqc_Profile.h"
+#include "Tekdaqc_Timers.h"
+#include "Tekdaqc_TimingHistogram.h"
+#include "Tekdaqc_BootTimes.h"
+#include "Tekdaqc_Scheduler.h"
+#include "Tekdaqc_CrashRecord.h"
+#include "Tekdaqc_Statistics.h"
+#include "Tekdaqc_MemoryUsage.h"
+#include "Tekdaqc_Log.h"
+#include "Tekdaqc_StateTrace.h"
+#include "Tekdaqc_Upgrade.h"
+#include "Tekdaqc_SampleLog.h"
+#include "Tekdaqc_Format.h"
+#include "eeprom.h"
+#include "Tekdaqc_ChannelConfig.h"
+#include "ethernetif.h"
+#include "netconf.h"
+#include "SNTPClient.h"
+#include "Tekdaqc_CAN.h"
+#include "lwip/stats.h"
+#include "lwip/memp.h"
 #include <stdlib.h>
+#include <inttypes.h>
 
 #ifdef PRINTF_OUTPUT
 #include <stdio.h>
@@ -90,6 +120,28 @@
  */
 #define KEY_VALUE_PAIR_DELIMETER		"="
 
+/**
+ * @internal
+ * @def COMMAND_HASH_TABLE_SIZE
+ * @brief The number of slots in the command lookup table. Must be a power of two and at least twice NUM_COMMANDS so
+ * that probe chains stay short.
+ */
+#define COMMAND_HASH_TABLE_SIZE			256U
+
+/**
+ * @internal
+ * @def COMMAND_HASH_EMPTY
+ * @brief The value marking an unused slot of the command lookup table.
+ */
+#define COMMAND_HASH_EMPTY				0xFFU
+
+/**
+ * @internal
+ * @def MACRO_LINE_SEPARATOR
+ * @brief The character which ends each command line in the text of a macro.
+ */
+#define MACRO_LINE_SEPARATOR			'\n'
+
 
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE VARIABLES */
@@ -107,7 +159,27 @@ static const char* COMMAND_STRINGS[NUM_COMMANDS] = { "LIST_ANALOG_INPUTS", "READ
 		"REMOVE_ANALOG_INPUT", "CHECK_ANALOG_INPUT", "SYSTEM_GCAL", "SYSTEM_CAL", "LIST_DIGITAL_INPUTS", "READ_DIGITAL_INPUT",
 		"ADD_DIGITAL_INPUT", "REMOVE_DIGITAL_INPUT", "LIST_DIGITAL_OUTPUTS", "SET_DIGITAL_OUTPUT", "READ_DIGITAL_OUTPUT",
 		"ADD_DIGITAL_OUTPUT", "REMOVE_DIGITAL_OUTPUT", "CLEAR_DIG_OUTPUT_FAULT", "DISCONNECT", "UPGRADE", "IDENTIFY", "SAMPLE", "HALT",
-		"SET_RTC", "SET_USER_MAC", "SET_STATIC_IP", "GET_CALIBRATION_STATUS", "NONE" };
+		"SET_RTC", "SET_USER_MAC", "SET_STATIC_IP", "GET_CALIBRATION_STATUS", "SET_COLD_JUNCTION_REFRESH", "SET_DATA_FORMAT",
+		"SET_FLUSH_LATENCY", "SET_PUBLISH", "SET_DIGITAL_INPUT_RATE", "SET_ANALOG_INPUT_FILTER", "CAPTURE", "PROFILE",
+		"GET_TIMING_HISTOGRAMS", "RESET_TIMING_HISTOGRAMS", "READ_DIGITAL_INPUT_EDGES", "READ_DIGITAL_INPUT_COUNTERS",
+		"SET_DIGITAL_OUTPUTS", "SET_DIGITAL_OUTPUT_PWM", "ADD_DIGITAL_OUTPUT_SEQUENCE_STEP",
+		"CLEAR_DIGITAL_OUTPUT_SEQUENCE", "START_DIGITAL_OUTPUT_SEQUENCE", "BEGIN_BATCH", "END_BATCH", "SAVE_CONFIG",
+		"LOAD_CONFIG", "SAVE_JOB", "CLEAR_JOB", "GET_BOOT_TIMES", "GET_NETWORK_STATS", "SET_NO_DELAY",
+		"SET_SUBSCRIPTION", "SET_TIME_SERVER", "SET_CAN_SYNC", "SET_CAN_STREAM", "SET_ANALOG_INPUT_OVERSAMPLING",
+		"GET_SCAN_TIME", "SET_BACKGROUND_CALIBRATION", "SET_ANALOG_INPUT_THERMOCOUPLE", "SET_ANALOG_INPUT_SETTLE",
+		"SET_ANALOG_INPUT_PAIR", "GET_TASK_STATS", "GET_CRASH_RECORD", "GET_UPGRADE_STATUS", "APPLY_UPGRADE",
+		"DISCARD_UPGRADE", "STATS", "GET_MEMORY_USAGE", "SET_OUTPUT_BUDGET", "BEGIN_CONFIG", "COMMIT_CONFIG",
+		"READ_LATEST_VALUES", "SET_SAMPLE_LOG", "GET_SAMPLE_LOG_STATUS", "RESUME_SAMPLE_LOG", "BURST_CAPTURE",
+		"READ_BURST_CAPTURE", "READ_BURST_SPECTRUM", "SET_ANALOG_POWER", "SET_INTERLOCK", "RESET_INTERLOCKS",
+		"LIST_INTERLOCKS", "SET_PID", "LIST_PID_LOOPS", "SET_MATH_CHANNEL", "LIST_MATH_CHANNELS",
+		"SET_ANALOG_INPUT_AUTO_RANGE", "SET_SENSOR_CHECK", "GET_SENSOR_CHECK", "SET_DIGITAL_INPUT_ENCODER",
+		"SET_DIGITAL_INPUT_LATCH", "SET_MIXED_SIGNAL", "SET_LOG_LEVEL", "READ_STATE_TRACE", "SET_KEEPALIVE", "FORMAT",
+		"SET_AUX_ANALOG", "BEGIN_MACRO", "END_MACRO", "RUN_MACRO", "DELETE_MACRO", "LIST_MACROS", "NONE" };
+
+/**
+ * List of the values of the SET_CAN_SYNC command, indexed by CAN_SyncRole_t.
+ */
+static const char* CAN_SYNC_ROLE_STRINGS[NUM_CAN_SYNC_ROLES] = { "NONE", "MASTER", "SLAVE" };
 
 /**
  * List of all parameters for the LIST_ANALOG_INPUTS command.
@@ -128,7 +200,7 @@ const char* READ_ANALOG_INPUT_PARAMS[NUM_READ_ANALOG_INPUT_PARAMS] = { PARAMETER
  * List of all parameters for the ADD_ANALOG_INPUT command.
  */
 const char* ADD_ANALOG_INPUT_PARAMS[NUM_ADD_ANALOG_INPUT_PARAMS] = { PARAMETER_INPUT, PARAMETER_BUFFER, PARAMETER_RATE, PARAMETER_GAIN,
-		PARAMETER_NAME };
+		PARAMETER_NAME, PARAMETER_DEADBAND, PARAMETER_HEARTBEAT };
 
 /**
  * List of all parameters for the REMOVE_ANALOG_INPUT command.
@@ -163,7 +235,7 @@ const char* READ_DIGITAL_INPUT_PARAMS[NUM_READ_DIGITAL_INPUT_PARAMS] = { PARAMET
 /**
  * List of all parameters for the ADD_DIGITAL_INPUT command.
  */
-const char* ADD_DIGITAL_INPUT_PARAMS[NUM_ADD_DIGITAL_INPUT_PARAMS] = { PARAMETER_INPUT, PARAMETER_NAME };
+const char* ADD_DIGITAL_INPUT_PARAMS[NUM_ADD_DIGITAL_INPUT_PARAMS] = { PARAMETER_INPUT, PARAMETER_NAME, PARAMETER_HOLD };
 
 /**
  * List of all parameters for the REMOVE_DIGITAL_INPUT command.
@@ -218,12 +290,13 @@ const char* IDENTIFY_PARAMS[NUM_IDENTIFY_PARAMS] = { };
 /**
  * List of all parameters for the SAMPLE command.
  */
-const char* SAMPLE_PARAMS[NUM_SAMPLE_PARAMS] = { PARAMETER_NUMBER };
+const char* SAMPLE_PARAMS[NUM_SAMPLE_PARAMS] = { PARAMETER_NUMBER, PARAMETER_WINDOW, PARAMETER_TIME, PARAMETER_BANDWIDTH,
+		PARAMETER_OVERFLOW, PARAMETER_FRAME, PARAMETER_INTERVAL };
 
 /**
  * List of all parameters for the HALT command.
  */
-const char* HALT_PARAMS[NUM_HALT_PARAMS] = { };
+const char* HALT_PARAMS[NUM_HALT_PARAMS] = { PARAMETER_PENDING };
 
 /**
  * List of all parameters for the SET_RTC command.
@@ -238,7 +311,7 @@ const char* SET_USER_MAC_PARAMS[NUM_SET_USER_MAC_PARAMS] = { PARAMETER_VALUE };
 /**
  * List of all parameters for the SET_STATIC_IP command.
  */
-const char* SET_STATIC_IP_PARAMS[NUM_SET_STATIC_IP_PARAMS] = { PARAMETER_VALUE };
+const char* SET_STATIC_IP_PARAMS[NUM_SET_STATIC_IP_PARAMS] = { PARAMETER_VALUE, PARAMETER_NETMASK, PARAMETER_GATEWAY };
 
 /**
  * List of all parameters for the GET_CALIBRATION_STATUS command.
@@ -246,1050 +319,5587 @@ const char* SET_STATIC_IP_PARAMS[NUM_SET_STATIC_IP_PARAMS] = { PARAMETER_VALUE }
 const char* GET_CALIBRATION_STATUS_PARAMS[NUM_GET_CALIBRATION_STATUS_PARAMS] = { };
 
 /**
- * List of all parameters for the NONE command.
+ * List of all parameters for the SET_COLD_JUNCTION_REFRESH command.
  */
-const char* NONE_PARAMS[NUM_NONE_PARAMS] = { };
+const char* SET_COLD_JUNCTION_REFRESH_PARAMS[NUM_SET_COLD_JUNCTION_REFRESH_PARAMS] = { PARAMETER_TIME, PARAMETER_SCANS };
 
 /**
- * The command interpreter data structure instance.
+ * List of all parameters for the SET_DATA_FORMAT command.
  */
-static Tekdaqc_CommandInterpreter_t interpreter;
+const char* SET_DATA_FORMAT_PARAMS[NUM_SET_DATA_FORMAT_PARAMS] = { PARAMETER_FORMAT };
 
 /**
- * List of analog inputs referenced for use by a command.
+ * List of all parameters for the SET_FLUSH_LATENCY command.
  */
-Analog_Input_t* aInputs[NUM_ANALOG_INPUTS];
+const char* SET_FLUSH_LATENCY_PARAMS[NUM_SET_FLUSH_LATENCY_PARAMS] = { PARAMETER_TIME };
 
 /**
- * List of digital inputs referenced for use by a command.
+ * List of all parameters for the SET_PUBLISH command.
  */
-Digital_Input_t* dInputs[NUM_DIGITAL_INPUTS];
+const char* SET_PUBLISH_PARAMS[NUM_SET_PUBLISH_PARAMS] = { PARAMETER_ADDRESS, PARAMETER_PORT };
 
 /**
- * List of digital outputs referenced for use by a command.
+ * List of all parameters for the SET_DIGITAL_INPUT_RATE command.
  */
-Digital_Output_t* dOutputs[NUM_DIGITAL_OUTPUTS];
+const char* SET_DIGITAL_INPUT_RATE_PARAMS[NUM_SET_DIGITAL_INPUT_RATE_PARAMS] = { PARAMETER_RATE };
 
 /**
- * The last function error which occurred.
+ * List of all parameters for the SET_ANALOG_INPUT_FILTER command.
  */
-static Tekdaqc_Function_Error_t lastFunctionError = ERR_FUNCTION_OK;
+const char* SET_ANALOG_INPUT_FILTER_PARAMS[NUM_SET_ANALOG_INPUT_FILTER_PARAMS] = { PARAMETER_INPUT, PARAMETER_FILTER,
+		PARAMETER_DECIMATION };
 
-/*--------------------------------------------------------------------------------------------------------*/
-/* PRIVATE TYPES */
-/*--------------------------------------------------------------------------------------------------------*/
+/**
+ * List of all parameters for the CAPTURE command.
+ */
+const char* CAPTURE_PARAMS[NUM_CAPTURE_PARAMS] = { PARAMETER_INPUT, PARAMETER_SOURCE, PARAMETER_LEVEL, PARAMETER_EDGE,
+		PARAMETER_PRE, PARAMETER_POST };
 
 /**
- * @internal
- * @brief Enumeration of the different channel selection types.
- * Defines the possible channel selection set types.
+ * List of all parameters for the PROFILE command.
  */
-typedef enum {
-	SINGLE_CHANNEL, /**< A single channel is selected. */
-	CHANNEL_RANGE,  /**< A range of channels is selected. */
-	CHANNEL_SET,  /**< A set of channels is selected. */
-	ALL_CHANNELS /**< All added channels are selected. */
-} Channel_List_t;
+const char* PROFILE_PARAMS[NUM_PROFILE_PARAMS] = { };
 
 /**
- * @internal
- * @brief Enumeration of the different multi-channel sampling types.
- * Enumeration of the different multi-channel sampling types.
+ * List of all parameters for the GET_TIMING_HISTOGRAMS command.
  */
-typedef enum {
-	MULTI_ANALOG_INPUT, /**< Multi-sampling analog inputs. */
-	MULTI_DIGITAL_INPUT, /**< Multi-sampling digital inputs. */
-	MULTI_DIGITAL_OUTPUT /**< Multi-sampling digital outputs. */
-} Multisampling_t;
+const char* GET_TIMING_HISTOGRAMS_PARAMS[NUM_GET_TIMING_HISTOGRAMS_PARAMS] = { };
 
-/*--------------------------------------------------------------------------------------------------------*/
-/* PRIVATE FUNCTION PROTOTYPES */
-/*--------------------------------------------------------------------------------------------------------*/
+/**
+ * List of all parameters for the RESET_TIMING_HISTOGRAMS command.
+ */
+const char* RESET_TIMING_HISTOGRAMS_PARAMS[NUM_RESET_TIMING_HISTOGRAMS_PARAMS] = { };
 
 /**
- * @internal
- * @brief Processes a command and any arguments it has.
+ * List of all parameters for the READ_DIGITAL_INPUT_EDGES command.
  */
-static void ProcessCommand(char* command, char raw_args[][MAX_COMMANDPART_LENGTH], uint8_t arg_count);
+const char* READ_DIGITAL_INPUT_EDGES_PARAMS[NUM_READ_DIGITAL_INPUT_EDGES_PARAMS] = { PARAMETER_INPUT };
 
 /**
- * @internal
- * @brief Parses a line from the command buffer.
+ * List of all parameters for the READ_DIGITAL_INPUT_COUNTERS command.
  */
-static void Command_ParseLine(void);
+const char* READ_DIGITAL_INPUT_COUNTERS_PARAMS[NUM_READ_DIGITAL_INPUT_COUNTERS_PARAMS] = { PARAMETER_INPUT, PARAMETER_TIME };
 
 /**
- * @internal
- * @brief Parses the command portion of a command line.
+ * List of all parameters for the SET_DIGITAL_OUTPUTS command.
  */
-static Command_t ParseCommand(const char* command);
+const char* SET_DIGITAL_OUTPUTS_PARAMS[NUM_SET_DIGITAL_OUTPUTS_PARAMS] = { PARAMETER_OUTPUT, PARAMETER_VALUE };
 
 /**
- * @internal
- * @brief Process a command error.
+ * List of all parameters for the SET_DIGITAL_OUTPUT_PWM command.
  */
-static void ProcessCommandError(const Tekdaqc_Command_Error_t error);
+const char* SET_DIGITAL_OUTPUT_PWM_PARAMS[NUM_SET_DIGITAL_OUTPUT_PWM_PARAMS] = { PARAMETER_OUTPUT, PARAMETER_RATE, PARAMETER_VALUE };
 
 /**
- * @internal
- * @brief Process a function error.
+ * List of all parameters for the ADD_DIGITAL_OUTPUT_SEQUENCE_STEP command.
  */
-static void ProcessFunctionError(void);
+const char* ADD_DIGITAL_OUTPUT_SEQUENCE_STEP_PARAMS[NUM_ADD_DIGITAL_OUTPUT_SEQUENCE_STEP_PARAMS] = { PARAMETER_TIME, PARAMETER_VALUE };
 
 /**
- * @internal
- * @brief Process the raw key/value pair string to extract the key/values.
+ * List of all parameters for the CLEAR_DIGITAL_OUTPUT_SEQUENCE command.
  */
-static void ParseKeyValuePairs(char raw_args[][MAX_COMMANDPART_LENGTH], char keys[][MAX_COMMANDPART_LENGTH],
-		char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+const char* CLEAR_DIGITAL_OUTPUT_SEQUENCE_PARAMS[NUM_CLEAR_DIGITAL_OUTPUT_SEQUENCE_PARAMS] = { };
 
 /**
- * @internal
- * @brief Checks the input arguments to ensure that they are appropriate for the specified command.
+ * List of all parameters for the START_DIGITAL_OUTPUT_SEQUENCE command.
  */
-static bool InputArgsCheck(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count, uint8_t num_params,
-		const char** params);
+const char* START_DIGITAL_OUTPUT_SEQUENCE_PARAMS[NUM_START_DIGITAL_OUTPUT_SEQUENCE_PARAMS] = { PARAMETER_OUTPUT, PARAMETER_NUMBER, PARAMETER_TIME, PARAMETER_SOURCE };
 
 /**
- * @internal
- * @brief Determine the channel list type.
+ * List of all parameters for the BEGIN_BATCH command.
  */
-static Channel_List_t GetChannelListType(char* arg);
+const char* BEGIN_BATCH_PARAMS[NUM_BEGIN_BATCH_PARAMS] = { };
 
 /**
- * @internal
- * @brief Build the list of analog inputs to sample.
+ * List of all parameters for the END_BATCH command.
  */
-static void BuildAnalogInputList(Channel_List_t list_type, char* param);
+const char* END_BATCH_PARAMS[NUM_END_BATCH_PARAMS] = { };
 
 /**
- * @internal
- * @brief Build the list of digital inputs to sample.
+ * List of all parameters for the SAVE_CONFIG command.
  */
-static void BuildDigitalInputList(Channel_List_t list_type, char* param);
+const char* SAVE_CONFIG_PARAMS[NUM_SAVE_CONFIG_PARAMS] = { };
 
 /**
- * @internal
- * @brief Build the list of digital outputs to sample.
+ * List of all parameters for the LOAD_CONFIG command.
  */
-static void BuildDigitalOutputList(Channel_List_t list_type, char* param);
+const char* LOAD_CONFIG_PARAMS[NUM_LOAD_CONFIG_PARAMS] = { };
 
 /**
- * @internal
- * @brief Determine if the provided character is a valid text character.
+ * List of all parameters for the SAVE_JOB command.
  */
-static bool isValidTextCharacter(const char character);
+const char* SAVE_JOB_PARAMS[NUM_SAVE_JOB_PARAMS] = { PARAMETER_NUMBER, PARAMETER_WINDOW, PARAMETER_TIME, PARAMETER_ADDRESS, PARAMETER_PORT,
+		PARAMETER_OVERFLOW };
 
 /**
- * @internal
- * @brief Converts the provided string to be entirely upper case.
+ * List of all parameters for the CLEAR_JOB command.
  */
-static void ToUpperCase(char* string);
+const char* CLEAR_JOB_PARAMS[NUM_CLEAR_JOB_PARAMS] = { };
 
 /**
- * @internal
- * @brief Execute the specified command with the provided parameters.
+ * List of all parameters for the GET_BOOT_TIMES command.
  */
-static Tekdaqc_Command_Error_t ExecuteCommand(Command_t command, char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
-		uint8_t count);
+const char* GET_BOOT_TIMES_PARAMS[NUM_GET_BOOT_TIMES_PARAMS] = { };
 
 /**
- * @internal
- * @brief Execute the LIST_ANALOG_INPUTS command with the provided parameters.
+ * List of all parameters for the GET_NETWORK_STATS command.
  */
-static Tekdaqc_Command_Error_t Ex_ListAnalogInputs(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
-		uint8_t count);
+const char* GET_NETWORK_STATS_PARAMS[NUM_GET_NETWORK_STATS_PARAMS] = { };
 
 /**
- * @internal
- * @brief Execute the READ_ADC_REGISTERS command with the provided parameters.
+ * List of all parameters for the SET_NO_DELAY command.
  */
-static Tekdaqc_Command_Error_t Ex_ReadADCRegisters(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
-		uint8_t count);
+const char* SET_NO_DELAY_PARAMS[NUM_SET_NO_DELAY_PARAMS] = { PARAMETER_CONNECTION, PARAMETER_STATE };
 
 /**
- * @internal
- * @brief Execute the READ_ANALOG_INPUT command with the provided parameters.
+ * List of all parameters for the SET_SUBSCRIPTION command.
  */
-static Tekdaqc_Command_Error_t Ex_ReadAnalogInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+const char* SET_SUBSCRIPTION_PARAMS[NUM_SET_SUBSCRIPTION_PARAMS] = { PARAMETER_STATE };
 
 /**
- * @internal
- * @brief Execute the ADD_ANALOG_INPUT command with the provided parameters.
+ * List of all parameters for the SET_TIME_SERVER command.
  */
-static Tekdaqc_Command_Error_t Ex_AddAnalogInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+const char* SET_TIME_SERVER_PARAMS[NUM_SET_TIME_SERVER_PARAMS] = { PARAMETER_VALUE };
 
 /**
- * @internal
- * @brief Execute the REMOVE_ANALOG_INPUT command with the provided parameters.
+ * List of all parameters for the SET_CAN_SYNC command.
  */
-static Tekdaqc_Command_Error_t Ex_RemoveAnalogInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
-		uint8_t count);
+const char* SET_CAN_SYNC_PARAMS[NUM_SET_CAN_SYNC_PARAMS] = { PARAMETER_VALUE };
 
 /**
- * @internal
- * @brief Execute the CHECK_ANALOG_INPUT command with the provided parameters.
+ * List of all parameters for the SET_CAN_STREAM command.
  */
-static Tekdaqc_Command_Error_t Ex_CheckAnalogInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
-		uint8_t count);
+const char* SET_CAN_STREAM_PARAMS[NUM_SET_CAN_STREAM_PARAMS] = { PARAMETER_VALUE };
 
 /**
- * @internal
- * @brief Execute the SYSTEM_GCAL command with the provided parameters.
+ * List of all parameters for the SET_ANALOG_INPUT_OVERSAMPLING command.
  */
-static Tekdaqc_Command_Error_t Ex_SystemGainCal(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+const char* SET_ANALOG_INPUT_OVERSAMPLING_PARAMS[NUM_SET_ANALOG_INPUT_OVERSAMPLING_PARAMS] = { PARAMETER_INPUT, PARAMETER_VALUE };
 
 /**
- * @internal
- * @brief Execute the SYSTEM_CAL command with the provided parameters.
+ * List of all parameters for the GET_SCAN_TIME command.
  */
-static Tekdaqc_Command_Error_t Ex_SystemCal(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+const char* GET_SCAN_TIME_PARAMS[NUM_GET_SCAN_TIME_PARAMS] = { };
 
 /**
- * @internal
- * @brief Execute the LIST_DIGITAL_INPUTS command with the provided parameters.
+ * List of all parameters for the SET_BACKGROUND_CALIBRATION command.
  */
-static Tekdaqc_Command_Error_t Ex_ListDigitalInputs(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
-		uint8_t count);
+const char* SET_BACKGROUND_CALIBRATION_PARAMS[NUM_SET_BACKGROUND_CALIBRATION_PARAMS] = { PARAMETER_TIME, PARAMETER_TEMPERATURE };
 
 /**
- * @internal
- * @brief Execute the READ_DIGITAL_INPUT command with the provided parameters.
+ * List of all parameters for the SET_ANALOG_INPUT_THERMOCOUPLE command.
  */
-static Tekdaqc_Command_Error_t Ex_ReadDigitalInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
-		uint8_t count);
+const char* SET_ANALOG_INPUT_THERMOCOUPLE_PARAMS[NUM_SET_ANALOG_INPUT_THERMOCOUPLE_PARAMS] = { PARAMETER_INPUT, PARAMETER_TYPE };
 
 /**
- * @internal
- * @brief Execute the ADD_DIGITAL_INPUT command with the provided parameters.
+ * List of all parameters for the SET_ANALOG_INPUT_SETTLE command.
  */
-static Tekdaqc_Command_Error_t Ex_AddDigitalInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+const char* SET_ANALOG_INPUT_SETTLE_PARAMS[NUM_SET_ANALOG_INPUT_SETTLE_PARAMS] = { PARAMETER_INPUT, PARAMETER_TIME };
 
 /**
- * @internal
- * @brief Execute the REMOVE_DIGITAL_INPUT command with the provided parameters.
+ * List of all parameters for the SET_ANALOG_INPUT_PAIR command.
  */
-static Tekdaqc_Command_Error_t Ex_RemoveDigitalInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
-		uint8_t count);
+const char* SET_ANALOG_INPUT_PAIR_PARAMS[NUM_SET_ANALOG_INPUT_PAIR_PARAMS] = { PARAMETER_INPUT, PARAMETER_POSITIVE, PARAMETER_NEGATIVE };
 
 /**
- * @internal
- * @brief Execute the LIST_DIGITAL_OUTPUTS command with the provided parameters.
+ * List of all parameters for the GET_TASK_STATS command.
  */
-static Tekdaqc_Command_Error_t Ex_ListDigitalOutputs(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
-		uint8_t count);
+const char* GET_TASK_STATS_PARAMS[NUM_GET_TASK_STATS_PARAMS] = { };
 
 /**
- * @internal
- * @brief Execute the SET_DIGITAL_OUTPUT command with the provided parameters.
+ * List of all parameters for the GET_CRASH_RECORD command.
  */
-static Tekdaqc_Command_Error_t Ex_SetDigitalOutput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
-		uint8_t count);
+const char* GET_CRASH_RECORD_PARAMS[NUM_GET_CRASH_RECORD_PARAMS] = { };
 
 /**
- * @internal
- * @brief Execute the READ_DIGITAL_OUTPUT command with the provided parameters.
+ * List of all parameters for the GET_UPGRADE_STATUS command.
  */
-static Tekdaqc_Command_Error_t Ex_ReadDigitalOutput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
-		uint8_t count);
+const char* GET_UPGRADE_STATUS_PARAMS[NUM_GET_UPGRADE_STATUS_PARAMS] = { };
 
 /**
- * @internal
- * @brief Execute the ADD_DIGITAL_OUTPUT command with the provided parameters.
+ * List of all parameters for the APPLY_UPGRADE command.
  */
-static Tekdaqc_Command_Error_t Ex_AddDigitalOutput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
-		uint8_t count);
+const char* APPLY_UPGRADE_PARAMS[NUM_APPLY_UPGRADE_PARAMS] = { };
 
 /**
- * @internal
- * @brief Execute the REMOVE_DIGITAL_OUTPUT command with the provided parameters.
+ * List of all parameters for the DISCARD_UPGRADE command.
  */
-static Tekdaqc_Command_Error_t Ex_RemoveDigitalOutput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
-		uint8_t count);
+const char* DISCARD_UPGRADE_PARAMS[NUM_DISCARD_UPGRADE_PARAMS] = { };
 
 /**
- * @internal
- * @brief Execute the CLEAR_DIGITAL_OUTPUT_FAULT command with the provided parameters.
+ * List of all parameters for the STATS command.
  */
-static Tekdaqc_Command_Error_t Ex_ClearDigitalOutputFault(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
-		uint8_t count);
+const char* STATS_PARAMS[NUM_STATS_PARAMS] = { PARAMETER_TIME };
 
 /**
- * @internal
- * @brief Execute the SAMPLE command with the provided parameters.
+ * List of all parameters for the GET_MEMORY_USAGE command.
  */
-static Tekdaqc_Command_Error_t Ex_Sample(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+const char* GET_MEMORY_USAGE_PARAMS[NUM_GET_MEMORY_USAGE_PARAMS] = { };
 
 /**
- * @internal
- * @brief Execute the IDENTIFY command with the provided parameters.
+ * List of all parameters for the SET_OUTPUT_BUDGET command.
  */
-static Tekdaqc_Command_Error_t Ex_Identify(void);
+const char* SET_OUTPUT_BUDGET_PARAMS[NUM_SET_OUTPUT_BUDGET_PARAMS] = { PARAMETER_TIME };
 
 /**
- * @internal
- * @brief Execute the SET_RTC command with the provided parameters.
+ * List of all parameters for the BEGIN_CONFIG command.
  */
-static Tekdaqc_Command_Error_t Ex_SetRTC(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+const char* BEGIN_CONFIG_PARAMS[NUM_BEGIN_CONFIG_PARAMS] = { };
 
 /**
- * @internal
- * @brief Execute the SET_USER_MAC command with the provided parameters.
+ * List of all parameters for the COMMIT_CONFIG command.
  */
-static Tekdaqc_Command_Error_t Ex_SetUserMac(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+const char* COMMIT_CONFIG_PARAMS[NUM_COMMIT_CONFIG_PARAMS] = { };
 
 /**
- * @internal
- * @brief Execute the SET_STATIC_IP command with the provided parameters.
+ * List of all parameters for the READ_LATEST_VALUES command.
  */
-static Tekdaqc_Command_Error_t Ex_SetStaticIP(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+const char* READ_LATEST_VALUES_PARAMS[NUM_READ_LATEST_VALUES_PARAMS] = { };
 
 /**
- * @internal
- * @brief Execute the GET_CALIBRATION_STATUS command with the provided parameters.
+ * List of all parameters for the SET_SAMPLE_LOG command.
  */
-static Tekdaqc_Command_Error_t Ex_GetCalibrationStatus(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+const char* SET_SAMPLE_LOG_PARAMS[NUM_SET_SAMPLE_LOG_PARAMS] = { PARAMETER_STATE };
 
+/**
+ * List of all parameters for the GET_SAMPLE_LOG_STATUS command.
+ */
+const char* GET_SAMPLE_LOG_STATUS_PARAMS[NUM_GET_SAMPLE_LOG_STATUS_PARAMS] = { };
 
+/**
+ * List of all parameters for the RESUME_SAMPLE_LOG command.
+ */
+const char* RESUME_SAMPLE_LOG_PARAMS[NUM_RESUME_SAMPLE_LOG_PARAMS] = { PARAMETER_SEQUENCE };
 
-/*--------------------------------------------------------------------------------------------------------*/
-/* PRIVATE FUNCTIONS */
-/*--------------------------------------------------------------------------------------------------------*/
+/**
+ * List of all parameters for the BURST_CAPTURE command.
+ */
+const char* BURST_CAPTURE_PARAMS[NUM_BURST_CAPTURE_PARAMS] = { PARAMETER_INPUT, PARAMETER_SCANS };
 
 /**
- * Process a command and its arguments.
- *
- * @param command char* Pointer to the C-String holding the command.
- * @param raw_args char[][] Array of C-String's holding the unprocessed command arguments.
- * @param arg_count uint8_t The number of arguments provided.
- * @retval none
+ * List of all parameters for the READ_BURST_CAPTURE command.
  */
-static void ProcessCommand(char* command, char raw_args[][MAX_COMMANDPART_LENGTH], uint8_t arg_count) {
-#ifdef COMMAND_DEBUG
-	printf("[Command Interpreter] Processing command.\n\r");
-#endif
-	ToUpperCase(command); /* Convert the command string to upper case */
-	Command_t command_type = ParseCommand(command); /* Determine which command this is */
-	char keys[MAX_NUM_ARGUMENTS][MAX_COMMANDPART_LENGTH];
-	char values[MAX_NUM_ARGUMENTS][MAX_COMMANDPART_LENGTH];
-	ParseKeyValuePairs(raw_args, keys, values, arg_count); /* Parse the argument key/value pairs. */
-	Tekdaqc_Command_Error_t error = ExecuteCommand(command_type, keys, values, arg_count); /* Execute the command */
-	ProcessCommandError(error); /* Handle any errors. */
-}
+const char* READ_BURST_CAPTURE_PARAMS[NUM_READ_BURST_CAPTURE_PARAMS] = { };
 
 /**
- * Parse a command line from the command buffer.
- *
- * @param none
- * @retval none
+ * List of all parameters for the READ_BURST_SPECTRUM command.
  */
-static void Command_ParseLine(void) {
-#ifdef COMMAND_DEBUG
-	printf("Parsing command: %s\n\r", interpreter.command_buffer);
-#endif
-	char raw_args[MAX_NUM_ARGUMENTS][MAX_COMMANDPART_LENGTH];
-	char* pch;
-	uint8_t count = 0U;
-	char command[MAX_COMMANDPART_LENGTH];
-	pch = strpbrk(interpreter.command_buffer, COMMAND_DELIMETER);
-	while (pch != NULL ) {
-		++count;
-		pch = strpbrk(pch + 1, COMMAND_DELIMETER);
-	}
-#ifdef COMMAND_DEBUG
-	printf("[Command Parser] Parts count: %i\n\r", count);
-#endif
-	if (count > 0) { /* Command with arguments */
-		/* Extract the command first */
-		int command_end = strcspn(interpreter.command_buffer, COMMAND_DELIMETER);
-		if (command_end == MAX_COMMANDPART_LENGTH) {
-			/* This is not a valid command */
-#ifdef COMMAND_DEBUG
-			printf("[Command Interpreter] Command was too long, ignoring.\n\r");
-#endif
-			ClearCommandBuffer();
-			return;
-		} else {
-			/* This is a valid command */
-			pch = strtok(interpreter.command_buffer, COMMAND_DELIMETER);
-			strcpy(command, pch);
-			for (int i = 0; i < count; ++i) {
-				pch = strtok(NULL, COMMAND_DELIMETER);
-				if (pch == NULL ) {
-					break;
-				}
-				strcpy(*(raw_args + i), pch);
-			}
-#ifdef COMMAND_DEBUG
-			printf("[Command Interpreter] Command: %s\n\r\tParts:\n\r", command);
-			for (int i = 0; i < count; ++i) {
-				printf("\t\tArg[%i]: %s\n\r", i, raw_args[i]);
-			}
-#endif 
+const char* READ_BURST_SPECTRUM_PARAMS[NUM_READ_BURST_SPECTRUM_PARAMS] = { PARAMETER_POINTS, PARAMETER_PEAKS };
+
+/**
+ * List of all parameters for the SET_ANALOG_POWER command.
+ */
+const char* SET_ANALOG_POWER_PARAMS[NUM_SET_ANALOG_POWER_PARAMS] = { PARAMETER_NUMBER, PARAMETER_VOLTAGE, PARAMETER_CURRENT, PARAMETER_CYCLES };
+
+/**
+ * List of all parameters for the SET_INTERLOCK command.
+ */
+const char* SET_INTERLOCK_PARAMS[NUM_SET_INTERLOCK_PARAMS] = { PARAMETER_NUMBER, PARAMETER_INPUT, PARAMETER_SOURCE, PARAMETER_COMPARATOR, PARAMETER_LEVEL, PARAMETER_HYSTERESIS, PARAMETER_OUTPUT, PARAMETER_STATE, PARAMETER_LATCH };
+
+/**
+ * List of all parameters for the RESET_INTERLOCKS command.
+ */
+const char* RESET_INTERLOCKS_PARAMS[NUM_RESET_INTERLOCKS_PARAMS] = { };
+
+/**
+ * List of all parameters for the LIST_INTERLOCKS command.
+ */
+const char* LIST_INTERLOCKS_PARAMS[NUM_LIST_INTERLOCKS_PARAMS] = { };
+
+/**
+ * List of all parameters for the SET_PID command.
+ */
+const char* SET_PID_PARAMS[NUM_SET_PID_PARAMS] = { PARAMETER_NUMBER, PARAMETER_INPUT, PARAMETER_OUTPUT, PARAMETER_SETPOINT, PARAMETER_KP, PARAMETER_KI, PARAMETER_KD, PARAMETER_RATE };
+
+/**
+ * List of all parameters for the LIST_PID_LOOPS command.
+ */
+const char* LIST_PID_LOOPS_PARAMS[NUM_LIST_PID_LOOPS_PARAMS] = { };
+
+/**
+ * List of all parameters for the SET_MATH_CHANNEL command.
+ */
+const char* SET_MATH_CHANNEL_PARAMS[NUM_SET_MATH_CHANNEL_PARAMS] = { PARAMETER_NUMBER, PARAMETER_EXPR, PARAMETER_RAW };
+
+/**
+ * List of all parameters for the LIST_MATH_CHANNELS command.
+ */
+const char* LIST_MATH_CHANNELS_PARAMS[NUM_LIST_MATH_CHANNELS_PARAMS] = { };
+
+/**
+ * List of all parameters for the SET_ANALOG_INPUT_AUTO_RANGE command.
+ */
+const char* SET_ANALOG_INPUT_AUTO_RANGE_PARAMS[NUM_SET_ANALOG_INPUT_AUTO_RANGE_PARAMS] = { PARAMETER_INPUT, PARAMETER_STATE, PARAMETER_GAIN };
+
+/**
+ * List of all parameters for the SET_SENSOR_CHECK command.
+ */
+const char* SET_SENSOR_CHECK_PARAMS[NUM_SET_SENSOR_CHECK_PARAMS] = { PARAMETER_SCANS, PARAMETER_CURRENT };
+
+/**
+ * List of all parameters for the GET_SENSOR_CHECK command.
+ */
+const char* GET_SENSOR_CHECK_PARAMS[NUM_GET_SENSOR_CHECK_PARAMS] = { };
+
+/**
+ * List of all parameters for the SET_DIGITAL_INPUT_ENCODER command.
+ */
+const char* SET_DIGITAL_INPUT_ENCODER_PARAMS[NUM_SET_DIGITAL_INPUT_ENCODER_PARAMS] = { PARAMETER_NUMBER, PARAMETER_STATE };
+
+/**
+ * List of all parameters for the SET_DIGITAL_INPUT_LATCH command.
+ */
+const char* SET_DIGITAL_INPUT_LATCH_PARAMS[NUM_SET_DIGITAL_INPUT_LATCH_PARAMS] = { PARAMETER_STATE };
+
+/**
+ * List of all parameters for the SET_MIXED_SIGNAL command.
+ */
+const char* SET_MIXED_SIGNAL_PARAMS[NUM_SET_MIXED_SIGNAL_PARAMS] = { PARAMETER_STATE };
+
+/**
+ * List of all parameters for the SET_LOG_LEVEL command.
+ */
+const char* SET_LOG_LEVEL_PARAMS[NUM_SET_LOG_LEVEL_PARAMS] = { PARAMETER_LEVEL };
+
+/**
+ * List of all parameters for the READ_STATE_TRACE command.
+ */
+const char* READ_STATE_TRACE_PARAMS[NUM_READ_STATE_TRACE_PARAMS] = { };
+
+/**
+ * List of all parameters for the SET_KEEPALIVE command.
+ */
+const char* SET_KEEPALIVE_PARAMS[NUM_SET_KEEPALIVE_PARAMS] = { PARAMETER_IDLE, PARAMETER_INTERVAL, PARAMETER_NUMBER, PARAMETER_TIMEOUT };
+
+/**
+ * List of all parameters for the FORMAT command.
+ */
+const char* FORMAT_PARAMS[NUM_FORMAT_PARAMS] = { PARAMETER_ENCODING, PARAMETER_FIELDS };
+
+/**
+ * List of all parameters for the SET_AUX_ANALOG command.
+ */
+const char* SET_AUX_ANALOG_PARAMS[NUM_SET_AUX_ANALOG_PARAMS] = { PARAMETER_STATE };
+
+/**
+ * List of all parameters for the BEGIN_MACRO command.
+ */
+const char* BEGIN_MACRO_PARAMS[NUM_BEGIN_MACRO_PARAMS] = { PARAMETER_NAME };
+
+/**
+ * List of all parameters for the END_MACRO command.
+ */
+const char* END_MACRO_PARAMS[NUM_END_MACRO_PARAMS] = { };
+
+/**
+ * List of all parameters for the RUN_MACRO command.
+ */
+const char* RUN_MACRO_PARAMS[NUM_RUN_MACRO_PARAMS] = { PARAMETER_NAME };
+
+/**
+ * List of all parameters for the DELETE_MACRO command.
+ */
+const char* DELETE_MACRO_PARAMS[NUM_DELETE_MACRO_PARAMS] = { PARAMETER_NAME };
+
+/**
+ * List of all parameters for the LIST_MACROS command.
+ */
+const char* LIST_MACROS_PARAMS[NUM_LIST_MACROS_PARAMS] = { PARAMETER_NAME };
+
+/**
+ * List of all parameters for the NONE command.
+ */
+const char* NONE_PARAMS[NUM_NONE_PARAMS] = { };
+
+/**
+ * The command interpreter data structure instance.
+ */
+static Tekdaqc_CommandInterpreter_t interpreter;
+
+/**
+ * Open addressed lookup table mapping the hash of each command string to its Command_t.
+ */
+static uint8_t CommandHashTable[COMMAND_HASH_TABLE_SIZE];
+
+/**
+ * The hashes of the keys of the command currently being processed, interned as they are parsed.
+ */
+static uint32_t KeyHashes[MAX_NUM_ARGUMENTS];
+
+/**
+ * The key array the interned key hashes belong to, or NULL if none have been interned.
+ */
+static char (*InternedKeys)[MAX_COMMANDPART_LENGTH] = NULL;
+
+/**
+ * List of analog inputs referenced for use by a command.
+ */
+Analog_Input_t* aInputs[NUM_ANALOG_INPUTS];
+
+/**
+ * List of digital inputs referenced for use by a command.
+ */
+Digital_Input_t* dInputs[NUM_DIGITAL_INPUTS];
+
+/**
+ * List of digital outputs referenced for use by a command.
+ */
+Digital_Output_t* dOutputs[NUM_DIGITAL_OUTPUTS];
+
+/**
+ * The last function error which occurred.
+ */
+static Tekdaqc_Function_Error_t lastFunctionError = ERR_FUNCTION_OK;
+
+/**
+ * The text of the macro being recorded or run.
+ */
+static char macroText[MACRO_SIZE];
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Enumeration of the different channel selection types.
+ * Defines the possible channel selection set types.
+ */
+typedef enum {
+	SINGLE_CHANNEL, /**< A single channel is selected. */
+	CHANNEL_RANGE,  /**< A range of channels is selected. */
+	CHANNEL_SET,  /**< A set of channels is selected. */
+	ALL_CHANNELS /**< All added channels are selected. */
+} Channel_List_t;
+
+/**
+ * @internal
+ * @brief Enumeration of the different multi-channel sampling types.
+ * Enumeration of the different multi-channel sampling types.
+ */
+typedef enum {
+	MULTI_ANALOG_INPUT, /**< Multi-sampling analog inputs. */
+	MULTI_DIGITAL_INPUT, /**< Multi-sampling digital inputs. */
+	MULTI_DIGITAL_OUTPUT /**< Multi-sampling digital outputs. */
+} Multisampling_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Processes a command and any arguments it has.
+ */
+static void ProcessCommand(char* command, char raw_args[][MAX_COMMANDPART_LENGTH], uint8_t arg_count);
+
+/**
+ * @internal
+ * @brief Parses a line from the command buffer.
+ */
+static void Command_ParseLine(void);
+
+/**
+ * @internal
+ * @brief Determines if the command buffer holds the END_MACRO command.
+ */
+static bool IsEndMacroLine(void);
+
+/**
+ * @internal
+ * @brief Adds the command line in the command buffer to the macro being recorded.
+ */
+static void RecordMacroLine(void);
+
+/**
+ * @internal
+ * @brief Parses the command portion of a command line.
+ */
+static Command_t ParseCommand(const char* command);
+
+/**
+ * @internal
+ * @brief Computes the hash of a C-String.
+ */
+static uint32_t HashString(const char* string);
+
+/**
+ * @internal
+ * @brief Builds the command lookup table.
+ */
+static void BuildCommandHashTable(void);
+
+/**
+ * @internal
+ * @brief Determines if a key matches a parameter, using the interned key hashes where available.
+ */
+static bool IsKeyMatch(char keys[][MAX_COMMANDPART_LENGTH], uint8_t index, const char* target, uint32_t target_hash);
+
+/**
+ * @internal
+ * @brief Process a command error.
+ */
+static void ProcessCommandError(const Tekdaqc_Command_Error_t error);
+
+/**
+ * @internal
+ * @brief Tallies the result of a batched command.
+ */
+static void RecordBatchResult(const Tekdaqc_Command_Error_t error);
+
+/**
+ * @internal
+ * @brief Replies to an executed command or tallies its batch result.
+ */
+static void CompleteCommand(Command_t command, const Tekdaqc_Command_Error_t error);
+
+/**
+ * @internal
+ * @brief Adds a byte to the binary command frame being received.
+ */
+static void AddBinaryByte(uint8_t byte);
+
+/**
+ * @internal
+ * @brief Executes a received binary command frame.
+ */
+static Tekdaqc_Command_Error_t ExecuteBinaryCommand(Command_t command, const uint8_t* payload, uint8_t length);
+
+/**
+ * @internal
+ * @brief Executes the binary form of the ADD_ANALOG_INPUT command.
+ */
+static Tekdaqc_Command_Error_t ExBin_AddAnalogInput(const uint8_t* payload, uint8_t length);
+
+/**
+ * @internal
+ * @brief Executes the binary form of the SET_DIGITAL_OUTPUTS command.
+ */
+static Tekdaqc_Command_Error_t ExBin_SetDigitalOutputs(const uint8_t* payload, uint8_t length);
+
+/**
+ * @internal
+ * @brief Executes the binary form of the SET_DIGITAL_OUTPUT_PWM command.
+ */
+static Tekdaqc_Command_Error_t ExBin_SetDigitalOutputPwm(const uint8_t* payload, uint8_t length);
+
+/**
+ * @internal
+ * @brief Executes the binary form of the ADD_DIGITAL_OUTPUT_SEQUENCE_STEP command.
+ */
+static Tekdaqc_Command_Error_t ExBin_AddDigitalOutputSequenceStep(const uint8_t* payload, uint8_t length);
+
+/**
+ * @internal
+ * @brief Reads a little endian 16 bit field from a binary payload.
+ */
+static uint16_t ReadPayloadUint16(const uint8_t* field);
+
+/**
+ * @internal
+ * @brief Reads a little endian 32 bit field from a binary payload.
+ */
+static uint32_t ReadPayloadUint32(const uint8_t* field);
+
+/**
+ * @internal
+ * @brief Process a function error.
+ */
+static void ProcessFunctionError(void);
+
+/**
+ * @internal
+ * @brief Process the raw key/value pair string to extract the key/values.
+ */
+static void ParseKeyValuePairs(char raw_args[][MAX_COMMANDPART_LENGTH], char keys[][MAX_COMMANDPART_LENGTH],
+		char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Checks the input arguments to ensure that they are appropriate for the specified command.
+ */
+static bool InputArgsCheck(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count, uint8_t num_params,
+		const char** params);
+
+/**
+ * @internal
+ * @brief Determine the channel list type.
+ */
+static Channel_List_t GetChannelListType(char* arg);
+
+/**
+ * @internal
+ * @brief Build the list of analog inputs to sample.
+ */
+static void BuildAnalogInputList(Channel_List_t list_type, char* param);
+
+/**
+ * @internal
+ * @brief Build the list of digital inputs to sample.
+ */
+static void BuildDigitalInputList(Channel_List_t list_type, char* param);
+
+/**
+ * @internal
+ * @brief Build the list of digital outputs to sample.
+ */
+static void BuildDigitalOutputList(Channel_List_t list_type, char* param);
+
+/**
+ * @internal
+ * @brief Determine if the provided character is a valid text character.
+ */
+static bool isValidTextCharacter(const char character);
+
+/**
+ * @internal
+ * @brief Converts the provided string to be entirely upper case.
+ */
+static void ToUpperCase(char* string);
+
+/**
+ * @internal
+ * @brief Parses an Ethernet MAC address written as six colon separated hexadecimal bytes.
+ */
+static bool ParseMacAddress(const char* string, uint8_t* address);
+
+/**
+ * @internal
+ * @brief Parses a set of sample field names into DATA_FIELD_ bits.
+ */
+static bool ParseDataFields(const char* string, uint8_t* fields);
+
+/**
+ * @internal
+ * @brief Starts sampling all of the added channels.
+ */
+static void StartSampling(int32_t numSamples, uint32_t window, uint32_t period, ADC_OverflowPolicy_t overflow);
+
+#if LWIP_STATS
+/**
+ * @internal
+ * @brief Writes the usage of an lwIP memory pool or the heap as a status message.
+ */
+static void WriteNetworkMemoryStats(const char* name, const struct stats_mem* stats);
+#endif
+
+/**
+ * @internal
+ * @brief Execute the specified command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t ExecuteCommand(Command_t command, char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the LIST_ANALOG_INPUTS command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ListAnalogInputs(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the READ_ADC_REGISTERS command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ReadADCRegisters(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the READ_ANALOG_INPUT command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ReadAnalogInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the ADD_ANALOG_INPUT command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_AddAnalogInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the REMOVE_ANALOG_INPUT command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_RemoveAnalogInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the CHECK_ANALOG_INPUT command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_CheckAnalogInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SYSTEM_GCAL command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SystemGainCal(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SYSTEM_CAL command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SystemCal(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the LIST_DIGITAL_INPUTS command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ListDigitalInputs(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the READ_DIGITAL_INPUT command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ReadDigitalInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the ADD_DIGITAL_INPUT command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_AddDigitalInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the REMOVE_DIGITAL_INPUT command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_RemoveDigitalInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the LIST_DIGITAL_OUTPUTS command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ListDigitalOutputs(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_DIGITAL_OUTPUT command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetDigitalOutput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the READ_DIGITAL_OUTPUT command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ReadDigitalOutput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the ADD_DIGITAL_OUTPUT command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_AddDigitalOutput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the REMOVE_DIGITAL_OUTPUT command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_RemoveDigitalOutput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the CLEAR_DIGITAL_OUTPUT_FAULT command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ClearDigitalOutputFault(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SAMPLE command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_Sample(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the IDENTIFY command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_Identify(void);
+
+/**
+ * @internal
+ * @brief Execute the HALT command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_Halt(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_RTC command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetRTC(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_USER_MAC command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetUserMac(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_STATIC_IP command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetStaticIP(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the GET_CALIBRATION_STATUS command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_GetCalibrationStatus(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_COLD_JUNCTION_REFRESH command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetColdJunctionRefresh(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_DATA_FORMAT command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetDataFormat(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_FLUSH_LATENCY command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetFlushLatency(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_PUBLISH command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetPublish(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_DIGITAL_INPUT_RATE command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetDigitalInputRate(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_ANALOG_INPUT_FILTER command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetAnalogInputFilter(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the CAPTURE command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_Capture(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the PROFILE command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_Profile(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the GET_TIMING_HISTOGRAMS command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_GetTimingHistograms(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the RESET_TIMING_HISTOGRAMS command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ResetTimingHistograms(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the READ_DIGITAL_INPUT_EDGES command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ReadDigitalInputEdges(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the READ_DIGITAL_INPUT_COUNTERS command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ReadDigitalInputCounters(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_DIGITAL_OUTPUTS command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetDigitalOutputs(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_DIGITAL_OUTPUT_PWM command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetDigitalOutputPwm(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the ADD_DIGITAL_OUTPUT_SEQUENCE_STEP command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_AddDigitalOutputSequenceStep(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the CLEAR_DIGITAL_OUTPUT_SEQUENCE command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ClearDigitalOutputSequence(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the START_DIGITAL_OUTPUT_SEQUENCE command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_StartDigitalOutputSequence(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the BEGIN_BATCH command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_BeginBatch(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the END_BATCH command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_EndBatch(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SAVE_CONFIG command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SaveConfig(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the LOAD_CONFIG command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_LoadConfig(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SAVE_JOB command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SaveJob(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the CLEAR_JOB command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ClearJob(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the GET_BOOT_TIMES command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_GetBootTimes(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the GET_NETWORK_STATS command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_GetNetworkStats(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_NO_DELAY command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetNoDelay(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_SUBSCRIPTION command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetSubscription(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_TIME_SERVER command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetTimeServer(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_CAN_SYNC command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetCanSync(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_CAN_STREAM command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetCanStream(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_ANALOG_INPUT_OVERSAMPLING command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetAnalogInputOversampling(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the GET_SCAN_TIME command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_GetScanTime(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_BACKGROUND_CALIBRATION command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetBackgroundCalibration(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_ANALOG_INPUT_THERMOCOUPLE command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetAnalogInputThermocouple(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_ANALOG_INPUT_SETTLE command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetAnalogInputSettle(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_ANALOG_INPUT_PAIR command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetAnalogInputPair(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the GET_TASK_STATS command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_GetTaskStats(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the GET_CRASH_RECORD command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_GetCrashRecord(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the GET_UPGRADE_STATUS command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_GetUpgradeStatus(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the APPLY_UPGRADE command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ApplyUpgrade(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the DISCARD_UPGRADE command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_DiscardUpgrade(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the STATS command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_Stats(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the GET_MEMORY_USAGE command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_GetMemoryUsage(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_OUTPUT_BUDGET command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetOutputBudget(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the BEGIN_CONFIG command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_BeginConfig(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the COMMIT_CONFIG command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_CommitConfig(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the READ_LATEST_VALUES command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ReadLatestValues(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_SAMPLE_LOG command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetSampleLog(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the GET_SAMPLE_LOG_STATUS command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_GetSampleLogStatus(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the RESUME_SAMPLE_LOG command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ResumeSampleLog(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the BURST_CAPTURE command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_BurstCapture(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the READ_BURST_CAPTURE command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ReadBurstCapture(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the READ_BURST_SPECTRUM command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ReadBurstSpectrum(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_ANALOG_POWER command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetAnalogPower(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_INTERLOCK command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetInterlock(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the RESET_INTERLOCKS command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ResetInterlocks(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the LIST_INTERLOCKS command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ListInterlocks(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_PID command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetPid(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the LIST_PID_LOOPS command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ListPidLoops(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_MATH_CHANNEL command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetMathChannel(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the LIST_MATH_CHANNELS command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ListMathChannels(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_ANALOG_INPUT_AUTO_RANGE command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetAnalogInputAutoRange(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_SENSOR_CHECK command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetSensorCheck(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the GET_SENSOR_CHECK command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_GetSensorCheck(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_DIGITAL_INPUT_ENCODER command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetDigitalInputEncoder(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_DIGITAL_INPUT_LATCH command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetDigitalInputLatch(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_MIXED_SIGNAL command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetMixedSignal(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_LOG_LEVEL command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetLogLevel(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the READ_STATE_TRACE command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ReadStateTrace(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_KEEPALIVE command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetKeepalive(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the FORMAT command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_Format(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the SET_AUX_ANALOG command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_SetAuxAnalog(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the BEGIN_MACRO command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_BeginMacro(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the END_MACRO command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_EndMacro(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the RUN_MACRO command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_RunMacro(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the DELETE_MACRO command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_DeleteMacro(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+/**
+ * @internal
+ * @brief Execute the LIST_MACROS command with the provided parameters.
+ */
+static Tekdaqc_Command_Error_t Ex_ListMacros(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count);
+
+
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Process a command and its arguments.
+ *
+ * @param command char* Pointer to the C-String holding the command.
+ * @param raw_args char[][] Array of C-String's holding the unprocessed command arguments.
+ * @param arg_count uint8_t The number of arguments provided.
+ * @retval none
+ */
+static void ProcessCommand(char* command, char raw_args[][MAX_COMMANDPART_LENGTH], uint8_t arg_count) {
+#ifdef COMMAND_DEBUG
+	printf("[Command Interpreter] Processing command.\n\r");
+#endif
+	ToUpperCase(command); /* Convert the command string to upper case */
+	Command_t command_type = ParseCommand(command); /* Determine which command this is */
+	char keys[MAX_NUM_ARGUMENTS][MAX_COMMANDPART_LENGTH];
+	char values[MAX_NUM_ARGUMENTS][MAX_COMMANDPART_LENGTH];
+	ParseKeyValuePairs(raw_args, keys, values, arg_count); /* Parse the argument key/value pairs. */
+	Tekdaqc_Command_Error_t error = ExecuteCommand(command_type, keys, values, arg_count); /* Execute the command */
+	CompleteCommand(command_type, error);
+}
+
+/**
+ * Reply to an executed command, or tally its result if a batch is active. A macro which ran has already replied with
+ * the outcome of its commands.
+ *
+ * @param command Command_t The command which was executed.
+ * @param error Tekdaqc_Command_Error_t The command error.
+ * @retval none
+ */
+static void CompleteCommand(Command_t command, const Tekdaqc_Command_Error_t error) {
+	if (interpreter.batch_active == TRUE) {
+		if (command != COMMAND_BEGIN_BATCH) {
+			RecordBatchResult(error); /* Tally the result for the batch reply. */
+		}
+	} else if ((command != COMMAND_END_BATCH) && ((command != COMMAND_RUN_MACRO) || (error != ERR_COMMAND_OK))) {
+		ProcessCommandError(error); /* Handle any errors. */
+	}
+}
+
+/**
+ * Tally the result of a command executed as part of a batch, keeping the error text of the first one to fail so that
+ * it can be included in the reply to END_BATCH.
+ *
+ * @param error Tekdaqc_Command_Error_t The command error.
+ * @retval none
+ */
+static void RecordBatchResult(const Tekdaqc_Command_Error_t error) {
+	++interpreter.batch_count;
+	if (error != ERR_COMMAND_OK) {
+		if (interpreter.batch_failures == 0U) {
+			interpreter.batch_first_failure = interpreter.batch_count;
+			if (error == ERR_COMMAND_FUNCTION_ERROR) {
+				snprintf(interpreter.batch_error, COMMAND_BATCH_ERROR_LENGTH, "Function Error: %s",
+						Tekdaqc_FunctionError_ToString(lastFunctionError));
+			} else {
+				snprintf(interpreter.batch_error, COMMAND_BATCH_ERROR_LENGTH, "%s", Tekdaqc_CommandError_ToString(error));
+			}
+		}
+		++interpreter.batch_failures;
+	}
+}
+
+/**
+ * Add a byte to the binary command frame being received, executing the frame once its checksum has been received. A
+ * frame whose checksum does not match is discarded with a parse error.
+ *
+ * @param byte uint8_t The received byte.
+ * @retval none
+ */
+static void AddBinaryByte(uint8_t byte) {
+	switch (interpreter.binary_state) {
+	case BINARY_FRAME_COMMAND:
+		interpreter.binary_command = byte;
+		interpreter.binary_checksum = byte;
+		interpreter.binary_state = BINARY_FRAME_LENGTH;
+		break;
+	case BINARY_FRAME_LENGTH:
+		interpreter.binary_length = byte;
+		interpreter.binary_position = 0U;
+		interpreter.binary_checksum += byte;
+		if (byte > COMMAND_BINARY_MAX_PAYLOAD) {
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Binary command payload is too long, ignoring.\n\r");
+#endif
+			interpreter.binary_state = BINARY_FRAME_IDLE;
+			CompleteCommand(COMMAND_NONE, ERR_COMMAND_PARSE_ERROR);
+		} else {
+			interpreter.binary_state = (byte == 0U) ? BINARY_FRAME_CHECKSUM : BINARY_FRAME_PAYLOAD;
+		}
+		break;
+	case BINARY_FRAME_PAYLOAD:
+		interpreter.binary_payload[interpreter.binary_position++] = byte;
+		interpreter.binary_checksum += byte;
+		if (interpreter.binary_position == interpreter.binary_length) {
+			interpreter.binary_state = BINARY_FRAME_CHECKSUM;
+		}
+		break;
+	case BINARY_FRAME_CHECKSUM: {
+		interpreter.binary_state = BINARY_FRAME_IDLE;
+		Tekdaqc_Command_Error_t error = ERR_COMMAND_PARSE_ERROR;
+		if ((uint8_t) (interpreter.binary_checksum + byte) == 0U) {
+			PROFILE_BEGIN();
+			error = ExecuteBinaryCommand((Command_t) interpreter.binary_command, interpreter.binary_payload,
+					interpreter.binary_length);
+			PROFILE_END(PROFILE_COMMAND_PARSE_LINE);
+		} else {
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Binary command checksum mismatch, ignoring.\n\r");
+#endif
+		}
+		CompleteCommand((Command_t) interpreter.binary_command, error);
+		break;
+	}
+	case BINARY_FRAME_IDLE:
+	default:
+		interpreter.binary_state = BINARY_FRAME_IDLE;
+		break;
+	}
+}
+
+/**
+ * Execute a received binary command frame. An empty payload runs the command's handler with no parameters, the same
+ * as its text form without arguments. A payload is decoded directly from its fixed layout into the settings the text
+ * form would have parsed, skipping all string handling.
+ *
+ * @param command Command_t The command of the frame.
+ * @param payload const uint8_t* The payload of the frame.
+ * @param length uint8_t The length of the payload.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t ExecuteBinaryCommand(Command_t command, const uint8_t* payload, uint8_t length) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (length == 0U) {
+		char keys[MAX_NUM_ARGUMENTS][MAX_COMMANDPART_LENGTH];
+		char values[MAX_NUM_ARGUMENTS][MAX_COMMANDPART_LENGTH];
+		retval = ExecuteCommand(command, keys, values, 0U);
+	} else {
+		/* Only a few commands have a binary form, so they are looked up rather than switched on */
+		static const struct {
+			Command_t command;
+			Tekdaqc_Command_Error_t (*handler)(const uint8_t* payload, uint8_t length);
+		} BINARY_HANDLERS[] = {
+			{ COMMAND_ADD_ANALOG_INPUT, ExBin_AddAnalogInput },
+			{ COMMAND_SET_DIGITAL_OUTPUTS, ExBin_SetDigitalOutputs },
+			{ COMMAND_SET_DIGITAL_OUTPUT_PWM, ExBin_SetDigitalOutputPwm },
+			{ COMMAND_ADD_DIGITAL_OUTPUT_SEQUENCE_STEP, ExBin_AddDigitalOutputSequenceStep }
+		};
+		retval = ERR_COMMAND_BAD_COMMAND;
+		for (uint_fast8_t i = 0U; i < (sizeof(BINARY_HANDLERS) / sizeof(BINARY_HANDLERS[0])); ++i) {
+			if (BINARY_HANDLERS[i].command == command) {
+				retval = BINARY_HANDLERS[i].handler(payload, length);
+				break;
+			}
+		}
+#ifdef COMMAND_DEBUG
+		if (retval == ERR_COMMAND_BAD_COMMAND) {
+			printf("[Command Interpreter] Command has no binary form, doing nothing.\n\r");
+		}
+#endif
+	}
+	return retval;
+}
+
+/**
+ * Execute the binary form of the ADD_ANALOG_INPUT command.
+ *
+ * @param payload const uint8_t* The payload of the frame.
+ * @param length uint8_t The length of the payload.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t ExBin_AddAnalogInput(const uint8_t* payload, uint8_t length) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (isADCSampling() == FALSE) {
+		const uint32_t heartbeat = (length >= 12U) ? ReadPayloadUint32(&payload[8]) : 0U;
+		if (length < 12U || payload[0] > NUM_ANALOG_INPUTS || payload[1] > ADS1256_BUFFER_ENABLED
+				|| !IS_ADS1256_SPS_SETTING(payload[2]) || !IS_ADS1256_PGA_SETTING(payload[3])
+				|| heartbeat > (UINT32_MAX / 1000U)) {
+			retval = ERR_COMMAND_BAD_PARAM;
+		} else {
+			char name[MAX_ANALOG_INPUT_NAME_LENGTH];
+			uint8_t nameLength = length - 12U;
+			if (nameLength == 0U) {
+				strcpy(name, "NONE");
+			} else {
+				if (nameLength > (MAX_ANALOG_INPUT_NAME_LENGTH - 1U)) {
+					nameLength = MAX_ANALOG_INPUT_NAME_LENGTH - 1U;
+				}
+				memcpy(name, &payload[12], nameLength);
+				name[nameLength] = '\0';
+			}
+			Tekdaqc_Function_Error_t status = ConfigureAnalogInput(payload[0], (ADS1256_BUFFER_t) payload[1],
+					(ADS1256_SPS_t) payload[2], (ADS1256_PGA_t) payload[3], name, ReadPayloadUint32(&payload[4]), heartbeat);
+			if (status != ERR_FUNCTION_OK) {
+				/* Something went wrong with creating the input */
+				lastFunctionError = status;
+				retval = ERR_COMMAND_FUNCTION_ERROR;
+			}
+		}
+	} else {
+		retval = ERR_COMMAND_ADC_INVALID_OPERATION;
+	}
+	return retval;
+}
+
+/**
+ * Execute the binary form of the SET_DIGITAL_OUTPUTS command. Only the added outputs set in the mask are changed.
+ *
+ * @param payload const uint8_t* The payload of the frame.
+ * @param length uint8_t The length of the payload.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t ExBin_SetDigitalOutputs(const uint8_t* payload, uint8_t length) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (length != 4U) {
+		retval = ERR_COMMAND_BAD_PARAM;
+	} else {
+		uint16_t mask = 0U;
+		const uint16_t requested = ReadPayloadUint16(&payload[0]);
+		for (uint_fast8_t i = 0U; i < NUM_DIGITAL_OUTPUTS; ++i) {
+			Digital_Output_t* output = GetDigitalOutputByNumber(i);
+			if ((requested & (1U << i)) != 0U && output != NULL && output->added == CHANNEL_ADDED) {
+				mask |= (1U << i);
+			}
+		}
+		Tekdaqc_Function_Error_t status = SetDigitalOutputs(mask, ReadPayloadUint16(&payload[2]));
+		if (status != ERR_FUNCTION_OK) {
+			/* Something went wrong with setting the outputs */
+			lastFunctionError = status;
+			retval = ERR_COMMAND_FUNCTION_ERROR;
+		}
+	}
+	return retval;
+}
+
+/**
+ * Execute the binary form of the SET_DIGITAL_OUTPUT_PWM command.
+ *
+ * @param payload const uint8_t* The payload of the frame.
+ * @param length uint8_t The length of the payload.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t ExBin_SetDigitalOutputPwm(const uint8_t* payload, uint8_t length) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (length != 6U || payload[0] >= NUM_DIGITAL_OUTPUTS || payload[1] > 100U) {
+		retval = ERR_COMMAND_BAD_PARAM;
+	} else {
+		Tekdaqc_Function_Error_t status = SetDigitalOutputPwm(payload[0], ReadPayloadUint32(&payload[2]), payload[1]);
+		if (status != ERR_FUNCTION_OK) {
+			/* Something went wrong with modulating the output */
+			lastFunctionError = status;
+			retval = ERR_COMMAND_FUNCTION_ERROR;
+		}
+	}
+	return retval;
+}
+
+/**
+ * Execute the binary form of the ADD_DIGITAL_OUTPUT_SEQUENCE_STEP command.
+ *
+ * @param payload const uint8_t* The payload of the frame.
+ * @param length uint8_t The length of the payload.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t ExBin_AddDigitalOutputSequenceStep(const uint8_t* payload, uint8_t length) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (length != 6U) {
+		retval = ERR_COMMAND_BAD_PARAM;
+	} else {
+		Tekdaqc_Function_Error_t status = AddDigitalOutputSequenceStep(ReadPayloadUint32(&payload[0]),
+				ReadPayloadUint16(&payload[4]));
+		if (status != ERR_FUNCTION_OK) {
+			/* Something went wrong with the sequence */
+			lastFunctionError = status;
+			retval = ERR_COMMAND_FUNCTION_ERROR;
+		}
+	}
+	return retval;
+}
+
+/**
+ * Read a little endian 16 bit field from a binary payload.
+ *
+ * @param field const uint8_t* Pointer to the first byte of the field.
+ * @retval uint16_t The value of the field.
+ */
+static uint16_t ReadPayloadUint16(const uint8_t* field) {
+	return (uint16_t) (field[0] | (field[1] << 8));
+}
+
+/**
+ * Read a little endian 32 bit field from a binary payload.
+ *
+ * @param field const uint8_t* Pointer to the first byte of the field.
+ * @retval uint32_t The value of the field.
+ */
+static uint32_t ReadPayloadUint32(const uint8_t* field) {
+	return ((uint32_t) field[0]) | ((uint32_t) field[1] << 8) | ((uint32_t) field[2] << 16) | ((uint32_t) field[3] << 24);
+}
+
+/**
+ * Parse a command line from the command buffer. While a macro is being recorded the line is added to it instead,
+ * unless it is the END_MACRO command.
+ *
+ * @param none
+ * @retval none
+ */
+static void Command_ParseLine(void) {
+#ifdef COMMAND_DEBUG
+	printf("Parsing command: %s\n\r", interpreter.command_buffer);
+#endif
+	if ((interpreter.macro_recording == TRUE) && (IsEndMacroLine() == FALSE)) {
+		RecordMacroLine();
+		return;
+	}
+	char raw_args[MAX_NUM_ARGUMENTS][MAX_COMMANDPART_LENGTH];
+	char* pch;
+	uint8_t count = 0U;
+	char command[MAX_COMMANDPART_LENGTH];
+	pch = strpbrk(interpreter.command_buffer, COMMAND_DELIMETER);
+	while (pch != NULL ) {
+		++count;
+		pch = strpbrk(pch + 1, COMMAND_DELIMETER);
+	}
+#ifdef COMMAND_DEBUG
+	printf("[Command Parser] Parts count: %i\n\r", count);
+#endif
+	if (count > 0) { /* Command with arguments */
+		/* Extract the command first */
+		int command_end = strcspn(interpreter.command_buffer, COMMAND_DELIMETER);
+		if (command_end == MAX_COMMANDPART_LENGTH) {
+			/* This is not a valid command */
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Command was too long, ignoring.\n\r");
+#endif
+			ClearCommandBuffer();
+			return;
+		} else {
+			/* This is a valid command */
+			pch = strtok(interpreter.command_buffer, COMMAND_DELIMETER);
+			strcpy(command, pch);
+			for (int i = 0; i < count; ++i) {
+				pch = strtok(NULL, COMMAND_DELIMETER);
+				if (pch == NULL ) {
+					break;
+				}
+				strcpy(*(raw_args + i), pch);
+			}
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Command: %s\n\r\tParts:\n\r", command);
+			for (int i = 0; i < count; ++i) {
+				printf("\t\tArg[%i]: %s\n\r", i, raw_args[i]);
+			}
+#endif 
+		}
+	} else {
+		/* Command without arguments */
+		int length = strlen(interpreter.command_buffer);
+		if (length > (MAX_COMMANDPART_LENGTH - 1)) {
+			/* This is not a valid command */
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Command was too long, ignoring.\n\r");
+#endif
+			/* Cleanup */
+			ClearCommandBuffer();
+			return;
+		} else {
+			/* Its a valid command */
+			/* Copy the command */
+			strcpy(command, interpreter.command_buffer);
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Command: %s\n\r", command);
+#endif
+		}
+	}
+	/* Process the command */
+	ProcessCommand(command, raw_args, count);
+}
+
+/**
+ * Determines if the command buffer holds the END_MACRO command, in any case and with or without arguments.
+ *
+ * @param none
+ * @retval bool TRUE if the command of the line is END_MACRO.
+ */
+static bool IsEndMacroLine(void) {
+	char command[MAX_COMMANDPART_LENGTH];
+	const size_t length = strcspn(interpreter.command_buffer, COMMAND_DELIMETER);
+	if (length >= MAX_COMMANDPART_LENGTH) {
+		return FALSE;
+	}
+	memcpy(command, interpreter.command_buffer, length);
+	command[length] = '\0';
+	ToUpperCase(command);
+	return (strcmp(command, COMMAND_STRINGS[COMMAND_END_MACRO]) == 0) ? TRUE : FALSE;
+}
+
+/**
+ * Adds the command line in the command buffer to the macro being recorded, ended by a MACRO_LINE_SEPARATOR. Empty
+ * lines are skipped. A line which does not fit marks the macro as overflowed, so that END_MACRO fails rather than
+ * saving part of it.
+ *
+ * @param none
+ * @retval none
+ */
+static void RecordMacroLine(void) {
+	const size_t length = Format_BoundedLength(interpreter.command_buffer, MAX_COMMANDLINE_LENGTH);
+	if (length == 0U) {
+		return;
+	}
+	if ((interpreter.macro_length + length + 1U) > MACRO_SIZE) {
+		interpreter.macro_overflow = TRUE;
+		return;
+	}
+	memcpy(&macroText[interpreter.macro_length], interpreter.command_buffer, length);
+	interpreter.macro_length += length;
+	macroText[interpreter.macro_length++] = MACRO_LINE_SEPARATOR;
+}
+
+/**
+ * Parse a command string to determine which command it is.
+ *
+ * @param command const char* C-String containing the command text.
+ * @retval Command_t The determined command.
+ */
+static Command_t ParseCommand(const char* command) {
+#ifdef COMMAND_DEBUG
+	printf("[Command Interpreter] Parsing command.\n\r");
+#endif
+	Command_t ret_command = COMMAND_NONE + 1;
+	uint32_t slot = HashString(command) & (COMMAND_HASH_TABLE_SIZE - 1U);
+	while (CommandHashTable[slot] != COMMAND_HASH_EMPTY) {
+		if (strcmp(command, COMMAND_STRINGS[CommandHashTable[slot]]) == 0) {
+			ret_command = (Command_t) CommandHashTable[slot];
+			break;
+		}
+		slot = (slot + 1U) & (COMMAND_HASH_TABLE_SIZE - 1U);
+	}
+#ifdef COMMAND_DEBUG
+	if (ret_command <= COMMAND_NONE) {
+		printf("[Command Interpreter] Determined command to be: %s\n\r", COMMAND_STRINGS[ret_command]);
+	} else {
+		printf("[Command Interpreter] Unable to determine command.\n\r");
+	}
+#endif
+	return ret_command;
+}
+
+/**
+ * Compute the 32 bit FNV-1a hash of a C-String.
+ *
+ * @param string const char* The C-String to hash.
+ * @retval uint32_t The hash of the string.
+ */
+static uint32_t HashString(const char* string) {
+	uint32_t hash = 2166136261U;
+	while (*string != '\0') {
+		hash ^= (uint8_t) *string++;
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
+/**
+ * Build the command lookup table, inserting each command string at the slot its hash selects and probing linearly
+ * past occupied slots. ParseCommand() then finds a command with a single hash and, barring collisions, a single
+ * string comparison.
+ *
+ * @param none
+ * @retval none
+ */
+static void BuildCommandHashTable(void) {
+	uint32_t slot;
+	for (uint_fast16_t i = 0U; i < COMMAND_HASH_TABLE_SIZE; ++i) {
+		CommandHashTable[i] = COMMAND_HASH_EMPTY;
+	}
+	for (uint_fast8_t command = 0U; command < NUM_COMMANDS; ++command) {
+		slot = HashString(COMMAND_STRINGS[command]) & (COMMAND_HASH_TABLE_SIZE - 1U);
+		while (CommandHashTable[slot] != COMMAND_HASH_EMPTY) {
+			slot = (slot + 1U) & (COMMAND_HASH_TABLE_SIZE - 1U);
+		}
+		CommandHashTable[slot] = command;
+	}
+}
+
+/**
+ * Determine if a key matches a parameter. When the keys are the ones most recently parsed, their interned hashes are
+ * compared first so that only a matching key is compared character by character.
+ *
+ * @param keys char[][] Array of C-Strings containing the keys.
+ * @param index uint8_t The index of the key to compare.
+ * @param target const char* The parameter key C-String to compare against.
+ * @param target_hash uint32_t The hash of the target.
+ * @retval bool True if the key matches the target.
+ */
+static bool IsKeyMatch(char keys[][MAX_COMMANDPART_LENGTH], uint8_t index, const char* target, uint32_t target_hash) {
+	if (keys == InternedKeys && KeyHashes[index] != target_hash) {
+		return false;
+	}
+	return (strcmp(keys[index], target) == 0);
+}
+
+/**
+ * Evaluate the specified Tekdaqc_Command_Error_t and handle any errors appropriately.
+ *
+ * @param error Tekdaqc_Command_Error_t The command error.
+ * @retval none
+ */
+static void ProcessCommandError(const Tekdaqc_Command_Error_t error) {
+	const char* error_string = Tekdaqc_CommandError_ToString(error);
+	bool isErrored = TRUE;
+	switch (error) {
+	case ERR_COMMAND_OK:
+		snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "SUCCESS - %s", error_string);
+		isErrored = FALSE;
+		break;
+	case ERR_COMMAND_BAD_PARAM:
+		snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "FAIL - %s.", error_string);
+		break;
+	case ERR_COMMAND_BAD_COMMAND:
+		snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "FAIL - %s", error_string);
+		break;
+	case ERR_COMMAND_PARSE_ERROR:
+		snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "FAIL - %s", error_string);
+		break;
+	case ERR_COMMAND_FUNCTION_ERROR:
+		snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "FAIL - %s:\n\r\t", error_string);
+		ProcessFunctionError();
+		break;
+	case ERR_COMMAND_UNKNOWN_ERROR:
+		snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "FAIL - %s", error_string);
+		break;
+	case ERR_COMMAND_ADC_INVALID_OPERATION:
+		snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "FAIL - %s", error_string);
+		break;
+	case ERR_COMMAND_DI_INVALID_OPERATION:
+		snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "FAIL - %s", error_string);
+		break;
+	case ERR_COMMAND_DO_INVALID_OPERATION:
+		snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "FAIL - %s", error_string);
+		break;
+	default:
+		snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "ERROR - %s", error_string);
+		break;
+	}
+	if (isErrored == TRUE) {
+		TelnetWriteErrorMessage(TOSTRING_BUFFER);
+	} else {
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+	}
+}
+
+/**
+ * Evaluate the specified Tekdaqc_Function_Error_t and handle any errors appropriately.
+ *
+ * @param error Tekdaqc_Function_Error_t The command error.
+ * @retval none
+ */
+static void ProcessFunctionError(void) {
+	snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "Function Error: %s", Tekdaqc_FunctionError_ToString(lastFunctionError));
+}
+
+/**
+ * Parse the raw key/value strings to determine the specific key/value parameters.
+ *
+ * @param raw_args char[][] Array of C-Strings containing the raw key/value pairs.
+ * @param keys char[][] Array of C-Strings to store the parsed keys in.
+ * @param values char[][] Array of C-Strings to store the parsed values in.
+ * @param count uint8_t The number of arguments passed.
+ */
+static void ParseKeyValuePairs(char raw_args[][MAX_COMMANDPART_LENGTH], char keys[][MAX_COMMANDPART_LENGTH],
+		char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	char* raw;
+	char temp[MAX_COMMANDPART_LENGTH];
+	InternedKeys = keys;
+	for (int i = 0; i < count; ++i) {
+		raw = raw_args[i];
+		if (strncmp(raw, KEY_VALUE_PAIR_FLAG, 2) == 0) {
+			/* Properly formatted command */
+			strcpy(temp, (raw + 2)); /* Offset for the first two characters */
+			raw = strtok(temp, KEY_VALUE_PAIR_DELIMETER);
+			ToUpperCase(raw);
+			strcpy(keys[i], raw);
+			KeyHashes[i] = HashString(keys[i]);
+			raw = strtok(NULL, KEY_VALUE_PAIR_DELIMETER);
+			if (raw != NULL ) {
+				ToUpperCase(raw);
+				strcpy(values[i], raw);
+			} else {
+				strcpy(values[i], "");
+			}
+		} else {
+			/* Not a properly formatted command */
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Key/value pair %i (%s) was not properly formatted.\n\r", i, raw);
+#endif
+			KeyHashes[i] = 0U;
+		}
+	}
+}
+
+/**
+ * Evaluate the input arguments to determine if they are properly formatted.
+ *
+ * @param keys char[][] Array of C-Strings containing the parameter keys.
+ * @param values[][] Array of C-Strings containing the parameter values.
+ * @param count uint8_t The number of parameters provided.
+ * @param num_params uint8_t The total number of parameters associated with the command.
+ * @retval bool True if the check passes.
+ */
+static bool InputArgsCheck(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count, uint8_t num_params,
+		const char** params) {
+	if (count > num_params) {
+		return false;
+	}
+	int idx = 0;
+	bool valid = false;
+	for (int i = 0; i < count; ++i) {
+		idx = 0;
+		valid = false;
+		while (idx < num_params) {
+			if (strcmp(keys[i], params[idx++]) == 0) {
+				valid = true;
+				break;
+			}
+		}
+		if (valid == false) {
+			/* This is a bad key */
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Determine which type of channel list was provided.
+ *
+ * @param arg char* C-String containing the channel list.
+ * @retval Channel_List_t The type of channel list specified.
+ */
+static Channel_List_t GetChannelListType(char* arg) {
+	if (strcmp(arg, ALL_CHANNELS_STRING) == 0) {
+		return ALL_CHANNELS;
+	} else if (strchr(arg, SET_DELIMETER) != NULL ) {
+		return CHANNEL_SET;
+	} else if (strchr(arg, RANGE_DELIMETER) != NULL ) {
+		return CHANNEL_RANGE;
+	} else {
+		return SINGLE_CHANNEL;
+	}
+}
+
+/**
+ * Build the list of analog inputs which are to be sampled.
+ *
+ * @param list_type Channel_List_t The type of list provided in the parameter.
+ * @param param char* C-String containing the inputs to use.
+ * @retval none
+ */
+static void BuildAnalogInputList(Channel_List_t list_type, char* param) {
+	uint8_t count = 0U;
+	char* ptr = NULL;
+	int8_t channel = -1;
+	long int value = 0L;
+	char* str = NULL;
+	uint8_t start = 0U;
+	uint8_t end = 0U;
+	uint8_t value1 = 0U;
+	uint8_t value2 = 0U;
+
+	for (uint_fast8_t i = 0; i < NUM_ANALOG_INPUTS; ++i) {
+		aInputs[i] = NULL; /* NULL them all initially */
+	}
+
+	switch (list_type) {
+	case SINGLE_CHANNEL: /* SINGLE_CHANNEL */
+		channel = (int8_t) strtol(param, NULL, 10);
+		if (channel < 0 || channel > NUM_ANALOG_INPUTS) {
+			/* Input number out of range */
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] The requested input number is out of range.\n\r");
+#endif
+			break;
+		}
+		aInputs[0] = GetAnalogInputByNumber(channel);
+		break;
+	case CHANNEL_SET: /* CHANNEL_SET */
+		value = strtol(param, &ptr, 10);
+		while (value != 0L) {
+			++count;
+			if (*ptr == SET_DELIMETER) {
+				str = ptr + 1;
+			}
+			value = strtol(str, &ptr, 10);
+		}
+		value = strtol(param, &ptr, 10);
+		for (int i = 0; i < count; ++i) {
+			if (*ptr == SET_DELIMETER) {
+				str = ptr + 1;
+			}
+			aInputs[i] = GetAnalogInputByNumber(strtol(str, &ptr, 10));
+		}
+		break;
+	case CHANNEL_RANGE: /* INPUT_RANGE */
+		start = 0U;
+		end = 0U;
+		value1 = (uint8_t) strtol(param, &ptr, 10); /* We know these can potentially loose data...it would be invalid anyway */
+		value2 = (uint8_t) strtol((ptr + 1), NULL, 10);
+		if (value1 != 0L) {
+			start = value1;
+			if (value2 != 0L) {
+				end = value2;
+			} else {
+				end = NUM_ANALOG_INPUTS;
+			}
+		} else {
+			start = 0U;
+		}
+		count = end - start + 1;
+		for (int i = 0; i < count; ++i) {
+			aInputs[i] = GetAnalogInputByNumber(start + i); /* Some of these may be NULL, this is OK. */
+		}
+		break;
+	case ALL_CHANNELS: /* ALL_CHANNELS */
+		count = NUM_ANALOG_INPUTS;
+		for (int i = 0; i < count; ++i) {
+			aInputs[i] = GetAnalogInputByNumber(i); /* Some of these may be NULL, this is OK. */
+		}
+		break;
+	default:
+#ifdef COMMAND_DEBUG
+		printf("[Command Interpreter] The specified input range is invalid.\n\r");
+#endif
+		break;
+	}
+}
+
+/**
+ * Build the list of digital inputs which are to be sampled.
+ *
+ * @param list_type Channel_List_t The type of list provided in the parameter.
+ * @param param char* C-String containing the inputs to use.
+ * @retval none
+ */
+static void BuildDigitalInputList(Channel_List_t list_type, char* param) {
+	uint8_t count = 0U;
+	char* ptr = NULL;
+	int8_t channel = -1;
+	long int value = 0L;
+	char* str = NULL;
+	uint8_t start = 0U;
+	uint8_t end = 0U;
+	uint8_t value1 = 0U;
+	uint8_t value2 = 0U;
+
+	for (uint_fast8_t i = 0U; i < NUM_DIGITAL_INPUTS; ++i) {
+		dInputs[i] = NULL; /* NULL them all initially */
+	}
+
+	switch (list_type) {
+	case SINGLE_CHANNEL: /* SINGLE_CHANNEL */
+		channel = (int8_t) strtol(param, NULL, 10);
+		if (channel < 0 || channel > NUM_DIGITAL_INPUTS) {
+			/* Input number out of range */
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] The requested input number is out of range.\n\r");
+#endif
+			break;
+		}
+		dInputs[0] = GetDigitalInputByNumber(channel);
+		break; /* END SINGLE_INPUT */
+	case CHANNEL_SET: /* CHANNEL_SET */
+		value = 0L;
+		str = param;
+		value = strtol(str, &ptr, 10);
+		while (value != 0L) {
+			++count;
+			if (*ptr == SET_DELIMETER) {
+				str = ptr + 1;
+			}
+			value = strtol(str, &ptr, 10);
+		}
+		str = param;
+		value = strtol(str, &ptr, 10);
+		for (int i = 0; i < count; ++i) {
+			if (*ptr == SET_DELIMETER) {
+				str = ptr + 1;
+			}
+			dInputs[i] = GetDigitalInputByNumber(strtol(str, &ptr, 10));
+		}
+		break;
+	case CHANNEL_RANGE: /* INPUT_RANGE */
+		start = 0U;
+		end = 0U;
+		value1 = strtol(param, &ptr, 10); /* We know these can potentially loose data...it would be invalid anyway */
+		value2 = strtol((ptr + 1), NULL, 10);
+		if (value1 != 0L) {
+			start = (uint8_t) value1;
+			if (value2 != 0L) {
+				end = (uint8_t) value2;
+			} else {
+				end = NUM_DIGITAL_INPUTS;
+			}
+		} else {
+			start = 0U;
+		}
+		count = end - start + 1U;
+		for (int i = 0; i < count; ++i) {
+			dInputs[i] = GetDigitalInputByNumber(start + i); /* Some of these may be NULL, this is OK. */
+		}
+		break; /* END INPUT_RANGE */
+	case ALL_CHANNELS: /* ALL_CHANNELS */
+		count = NUM_DIGITAL_INPUTS;
+		for (int i = 0; i < count; ++i) {
+			dInputs[i] = GetDigitalInputByNumber(i); /* Some of these may be NULL, this is OK. */
+		}
+		break; /* END ALL_CHANNELS */
+	default:
+#ifdef COMMAND_DEBUG
+		printf("[Command Interpreter] The specified input range is invalid.\n\r");
+#endif
+		break;
+	}
+}
+
+/**
+ * Build the list of digital outputs which are to be sampled.
+ *
+ * @param list_type Channel_List_t The type of list provided in the parameter.
+ * @param param char* C-String containing the outputs to use.
+ * @retval none
+ */
+static void BuildDigitalOutputList(Channel_List_t list_type, char* param) {
+	uint8_t count = 0U;
+	char* ptr = NULL;
+	int8_t channel = -1;
+	long int value = 0L;
+	char* str = NULL;
+	uint8_t start = 0U;
+	uint8_t end = 0U;
+	uint8_t value1 = 0U;
+	uint8_t value2 = 0U;
+
+	for (uint_fast8_t i = 0; i < NUM_DIGITAL_OUTPUTS; ++i) {
+		dOutputs[i] = NULL; /* NULL them all initially */
+	}
+
+	switch (list_type) {
+	case SINGLE_CHANNEL:
+		channel = (int8_t) strtol(param, NULL, 10);
+		if (channel < 0 || channel > NUM_DIGITAL_OUTPUTS) {
+			/* Input number out of range */
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] The requested input number is out of range.\n\r");
+#endif
+			break;
+		}
+		dOutputs[0] = GetDigitalOutputByNumber(channel);
+		break;
+	case CHANNEL_SET:
+		value = 0L;
+		str = param;
+		value = strtol(str, &ptr, 10);
+		while (value != 0L) {
+			++count;
+			if (*ptr == SET_DELIMETER) {
+				str = ptr + 1;
+			}
+			value = strtol(str, &ptr, 10);
+		}
+		str = param;
+		value = strtol(str, &ptr, 10);
+		for (int i = 0; i < count; ++i) {
+			if (*ptr == SET_DELIMETER) {
+				str = ptr + 1;
+			}
+			dOutputs[i] = GetDigitalOutputByNumber(strtol(str, &ptr, 10));
+		}
+		break;
+	case CHANNEL_RANGE:
+		start = 0;
+		end = 0;
+		value1 = strtol(param, &ptr, 10);
+		value2 = strtol((ptr + 1), NULL, 10);
+		if (value1 != 0L) {
+			start = (uint8_t) value1;
+			if (value2 != 0L) {
+				end = (uint8_t) value2;
+			} else {
+				end = NUM_DIGITAL_OUTPUTS;
+			}
+		} else {
+			start = 0;
+		}
+		count = end - start + 1;
+		for (int i = 0; i < count; ++i) {
+			dOutputs[i] = GetDigitalOutputByNumber(start + i); /* Some of these may be NULL, this is OK. */
+		}
+		break;
+	case ALL_CHANNELS:
+		count = NUM_DIGITAL_OUTPUTS;
+		for (int i = 0; i < count; ++i) {
+			dOutputs[i] = GetDigitalOutputByNumber(i); /* Some of these may be NULL, this is OK. */
+		}
+		break;
+	default:
+#ifdef COMMAND_DEBUG
+		printf("[Command Interpreter] The specified input range is invalid.\n\r");
+#endif
+	}
+}
+
+/**
+ * Determines if the character provided is a valid text character for commands.
+ *
+ * @param character const char The character to check.
+ * @retval bool True if the character is valid.
+ */
+static bool isValidTextCharacter(const char character) {
+	return (character == 0x5F || (character >= 0x41 && character <= 0x5A) || (character >= 0x61 && character <= 0x7A)) ? true : false;
+}
+
+/**
+ * Converts the provided C-String into all upper case characters, in place.
+ *
+ * @param string char* The C-String to convert.
+ * @retval none
+ */
+static void ToUpperCase(char* string) {
+	int i = 0;
+	char character;
+	while (string[i]) {
+		character = string[i];
+		if (isValidTextCharacter(character)) {
+			if ((character >= 0x41 && character <= 0x5A) == false) {
+				if (character != 0x5F) { /* Don't treat underscores */
+					string[i] = (character - 0x20);
+				}
+			}
+		}
+		++i;
+	}
+}
+
+/**
+ * Parses an Ethernet MAC address written as six colon separated hexadecimal bytes, such as 02:00:5E:10:00:01.
+ *
+ * @param string const char* The C-String to parse.
+ * @param address uint8_t* Filled in with the RAW_STREAM_ADDRESS_LENGTH bytes of the address.
+ * @retval bool TRUE if the string is a MAC address.
+ */
+static bool ParseMacAddress(const char* string, uint8_t* address) {
+	for (uint_fast8_t i = 0U; i < RAW_STREAM_ADDRESS_LENGTH; ++i) {
+		const char* byte = &string[3U * i];
+		uint8_t value = 0U;
+		for (uint_fast8_t j = 0U; j < 2U; ++j) {
+			const char digit = byte[j];
+			value <<= 4U;
+			if ((digit >= '0') && (digit <= '9')) {
+				value |= (uint8_t) (digit - '0');
+			} else if ((digit >= 'A') && (digit <= 'F')) {
+				value |= (uint8_t) (digit - 'A' + 10);
+			} else if ((digit >= 'a') && (digit <= 'f')) {
+				value |= (uint8_t) (digit - 'a' + 10);
+			} else {
+				return false;
+			}
+		}
+		if (byte[2] != ((i < (RAW_STREAM_ADDRESS_LENGTH - 1U)) ? ':' : '\0')) {
+			return false;
+		}
+		address[i] = value;
+	}
+	return true;
+}
+
+/**
+ * Parses a set of sample field names, such as TIMESTAMP,VALUE,FLAGS, into DATA_FIELD_ bits. VALUE may be given but
+ * adds nothing, since the value is always sent.
+ *
+ * @param string const char* The C-String to parse.
+ * @param fields uint8_t* Filled in with the DATA_FIELD_ bits of the named fields.
+ * @retval bool TRUE if every name is that of a field.
+ */
+static bool ParseDataFields(const char* string, uint8_t* fields) {
+	static const char* const names[] = { FIELD_TIMESTAMP_STRING, FIELD_VALUE_STRING, FIELD_FLAGS_STRING,
+			FIELD_SEQUENCE_STRING };
+	static const uint8_t bits[] = { DATA_FIELD_TIMESTAMP, 0U, DATA_FIELD_FLAGS, DATA_FIELD_SEQUENCE };
+	*fields = 0U;
+	while (*string != '\0') {
+		const char* end = strchr(string, SET_DELIMETER);
+		const size_t length = (end != NULL) ? (size_t) (end - string) : strlen(string);
+		bool found = false;
+		for (uint_fast8_t i = 0U; i < (sizeof(bits) / sizeof(bits[0])); ++i) {
+			if ((strlen(names[i]) == length) && (strncmp(string, names[i], length) == 0)) {
+				*fields |= bits[i];
+				found = true;
+				break;
+			}
+		}
+		if (found == false) {
+			return false;
+		}
+		string += length;
+		if (*string == SET_DELIMETER) {
+			++string;
+		}
+	}
+	return true;
+}
+
+/**
+ * Executes the specified command with the specified parameters.
+ *
+ * @param command Command_t The command to execute.
+ * @param keys char[][] Array of C-String parameter keys for the command.
+ * @param values char[][] Array of C-String parameter values for the command.
+ * @param count uint8_t The number of parameters for the command.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t ExecuteCommand(Command_t command, char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	switch (command) {
+	case COMMAND_LIST_ANALOG_INPUTS:
+		retval = Ex_ListAnalogInputs(keys, values, count);
+		break;
+	case COMMAND_READ_ADC_REGISTERS:
+		retval = Ex_ReadADCRegisters(keys, values, count);
+		break;
+	case COMMAND_READ_ANALOG_INPUT:
+		retval = Ex_ReadAnalogInput(keys, values, count);
+		break;
+	case COMMAND_ADD_ANALOG_INPUT:
+		retval = Ex_AddAnalogInput(keys, values, count);
+		break;
+	case COMMAND_REMOVE_ANALOG_INPUT:
+		retval = Ex_RemoveAnalogInput(keys, values, count);
+		break;
+	case COMMAND_CHECK_ANALOG_INPUT:
+		retval = Ex_CheckAnalogInput(keys, values, count);
+		break;
+	case COMMAND_SYSTEM_GCAL:
+		retval = Ex_SystemGainCal(keys, values, count);
+		break;
+	case COMMAND_SYSTEM_CAL:
+		retval = Ex_SystemCal(keys, values, count);
+		break;
+	case COMMAND_LIST_DIGITAL_INPUTS:
+		retval = Ex_ListDigitalInputs(keys, values, count);
+		break;
+	case COMMAND_READ_DIGITAL_INPUT:
+		retval = Ex_ReadDigitalInput(keys, values, count);
+		break;
+	case COMMAND_ADD_DIGITAL_INPUT:
+		retval = Ex_AddDigitalInput(keys, values, count);
+		break;
+	case COMMAND_REMOVE_DIGITAL_INPUT:
+		retval = Ex_RemoveDigitalInput(keys, values, count);
+		break;
+	case COMMAND_LIST_DIGITAL_OUTPUTS:
+		retval = Ex_ListDigitalOutputs(keys, values, count);
+		break;
+	case COMMAND_SET_DIGITAL_OUTPUT:
+		retval = Ex_SetDigitalOutput(keys, values, count);
+		break;
+	case COMMAND_READ_DIGITAL_OUTPUT:
+		retval = Ex_ReadDigitalOutput(keys, values, count);
+		break;
+	case COMMAND_ADD_DIGITAL_OUTPUT:
+		retval = Ex_AddDigitalOutput(keys, values, count);
+		break;
+	case COMMAND_REMOVE_DIGITAL_OUTPUT:
+		retval = Ex_RemoveDigitalOutput(keys, values, count);
+		break;
+	case COMMAND_CLEAR_DIG_OUTPUT_FAULT:
+		retval = Ex_ClearDigitalOutputFault(keys, values, count);
+		break;
+	case COMMAND_DISCONNECT:
+		/* Close the telnet connection */
+		TelnetClose();
+		break;
+	case COMMAND_UPGRADE:
+		/* Write the update flag to the backup register */
+		RTC_WriteBackupRegister(UPDATE_FLAG_REGISTER, (RTC_ReadBackupRegister(UPDATE_FLAG_REGISTER ) | UPDATE_FLAG_ENABLED));
+		/* Close the telnet connection */
+		TelnetClose();
+		/* Reset the processor */
+		NVIC_SystemReset();
+		break;
+	case COMMAND_IDENTIFY:
+		Ex_Identify();
+		break;
+	case COMMAND_SAMPLE:
+		retval = Ex_Sample(keys, values, count);
+		break;
+	case COMMAND_HALT:
+		retval = Ex_Halt(keys, values, count);
+		break;
+	case COMMAND_SET_RTC:
+		retval = Ex_SetRTC(keys, values, count);
+		break;
+	case COMMAND_SET_USER_MAC:
+		retval = Ex_SetUserMac(keys, values, count);
+		break;
+	case COMMAND_SET_STATIC_IP:
+		retval = Ex_SetStaticIP(keys, values, count);
+		break;
+	case COMMAND_GET_CALIBRATION_STATUS:
+		retval = Ex_GetCalibrationStatus(keys, values, count);
+		break;
+	case COMMAND_SET_COLD_JUNCTION_REFRESH:
+		retval = Ex_SetColdJunctionRefresh(keys, values, count);
+		break;
+	case COMMAND_SET_DATA_FORMAT:
+		retval = Ex_SetDataFormat(keys, values, count);
+		break;
+	case COMMAND_SET_FLUSH_LATENCY:
+		retval = Ex_SetFlushLatency(keys, values, count);
+		break;
+	case COMMAND_SET_PUBLISH:
+		retval = Ex_SetPublish(keys, values, count);
+		break;
+	case COMMAND_SET_DIGITAL_INPUT_RATE:
+		retval = Ex_SetDigitalInputRate(keys, values, count);
+		break;
+	case COMMAND_SET_ANALOG_INPUT_FILTER:
+		retval = Ex_SetAnalogInputFilter(keys, values, count);
+		break;
+	case COMMAND_CAPTURE:
+		retval = Ex_Capture(keys, values, count);
+		break;
+	case COMMAND_PROFILE:
+		retval = Ex_Profile(keys, values, count);
+		break;
+	case COMMAND_GET_TIMING_HISTOGRAMS:
+		retval = Ex_GetTimingHistograms(keys, values, count);
+		break;
+	case COMMAND_RESET_TIMING_HISTOGRAMS:
+		retval = Ex_ResetTimingHistograms(keys, values, count);
+		break;
+	case COMMAND_READ_DIGITAL_INPUT_EDGES:
+		retval = Ex_ReadDigitalInputEdges(keys, values, count);
+		break;
+	case COMMAND_READ_DIGITAL_INPUT_COUNTERS:
+		retval = Ex_ReadDigitalInputCounters(keys, values, count);
+		break;
+	case COMMAND_SET_DIGITAL_OUTPUTS:
+		retval = Ex_SetDigitalOutputs(keys, values, count);
+		break;
+	case COMMAND_SET_DIGITAL_OUTPUT_PWM:
+		retval = Ex_SetDigitalOutputPwm(keys, values, count);
+		break;
+	case COMMAND_ADD_DIGITAL_OUTPUT_SEQUENCE_STEP:
+		retval = Ex_AddDigitalOutputSequenceStep(keys, values, count);
+		break;
+	case COMMAND_CLEAR_DIGITAL_OUTPUT_SEQUENCE:
+		retval = Ex_ClearDigitalOutputSequence(keys, values, count);
+		break;
+	case COMMAND_START_DIGITAL_OUTPUT_SEQUENCE:
+		retval = Ex_StartDigitalOutputSequence(keys, values, count);
+		break;
+	case COMMAND_BEGIN_BATCH:
+		retval = Ex_BeginBatch(keys, values, count);
+		break;
+	case COMMAND_END_BATCH:
+		retval = Ex_EndBatch(keys, values, count);
+		break;
+	case COMMAND_SAVE_CONFIG:
+		retval = Ex_SaveConfig(keys, values, count);
+		break;
+	case COMMAND_LOAD_CONFIG:
+		retval = Ex_LoadConfig(keys, values, count);
+		break;
+	case COMMAND_SAVE_JOB:
+		retval = Ex_SaveJob(keys, values, count);
+		break;
+	case COMMAND_CLEAR_JOB:
+		retval = Ex_ClearJob(keys, values, count);
+		break;
+	case COMMAND_GET_BOOT_TIMES:
+		retval = Ex_GetBootTimes(keys, values, count);
+		break;
+	case COMMAND_GET_NETWORK_STATS:
+		retval = Ex_GetNetworkStats(keys, values, count);
+		break;
+	case COMMAND_SET_NO_DELAY:
+		retval = Ex_SetNoDelay(keys, values, count);
+		break;
+	case COMMAND_SET_SUBSCRIPTION:
+		retval = Ex_SetSubscription(keys, values, count);
+		break;
+	case COMMAND_SET_TIME_SERVER:
+		retval = Ex_SetTimeServer(keys, values, count);
+		break;
+	case COMMAND_SET_CAN_SYNC:
+		retval = Ex_SetCanSync(keys, values, count);
+		break;
+	case COMMAND_SET_CAN_STREAM:
+		retval = Ex_SetCanStream(keys, values, count);
+		break;
+	case COMMAND_SET_ANALOG_INPUT_OVERSAMPLING:
+		retval = Ex_SetAnalogInputOversampling(keys, values, count);
+		break;
+	case COMMAND_GET_SCAN_TIME:
+		retval = Ex_GetScanTime(keys, values, count);
+		break;
+	case COMMAND_SET_BACKGROUND_CALIBRATION:
+		retval = Ex_SetBackgroundCalibration(keys, values, count);
+		break;
+	case COMMAND_SET_ANALOG_INPUT_THERMOCOUPLE:
+		retval = Ex_SetAnalogInputThermocouple(keys, values, count);
+		break;
+	case COMMAND_SET_ANALOG_INPUT_SETTLE:
+		retval = Ex_SetAnalogInputSettle(keys, values, count);
+		break;
+	case COMMAND_SET_ANALOG_INPUT_PAIR:
+		retval = Ex_SetAnalogInputPair(keys, values, count);
+		break;
+	case COMMAND_GET_TASK_STATS:
+		retval = Ex_GetTaskStats(keys, values, count);
+		break;
+	case COMMAND_GET_CRASH_RECORD:
+		retval = Ex_GetCrashRecord(keys, values, count);
+		break;
+	case COMMAND_GET_UPGRADE_STATUS:
+		retval = Ex_GetUpgradeStatus(keys, values, count);
+		break;
+	case COMMAND_APPLY_UPGRADE:
+		retval = Ex_ApplyUpgrade(keys, values, count);
+		break;
+	case COMMAND_DISCARD_UPGRADE:
+		retval = Ex_DiscardUpgrade(keys, values, count);
+		break;
+	case COMMAND_STATS:
+		retval = Ex_Stats(keys, values, count);
+		break;
+	case COMMAND_GET_MEMORY_USAGE:
+		retval = Ex_GetMemoryUsage(keys, values, count);
+		break;
+	case COMMAND_SET_OUTPUT_BUDGET:
+		retval = Ex_SetOutputBudget(keys, values, count);
+		break;
+	case COMMAND_BEGIN_CONFIG:
+		retval = Ex_BeginConfig(keys, values, count);
+		break;
+	case COMMAND_COMMIT_CONFIG:
+		retval = Ex_CommitConfig(keys, values, count);
+		break;
+	case COMMAND_READ_LATEST_VALUES:
+		retval = Ex_ReadLatestValues(keys, values, count);
+		break;
+	case COMMAND_SET_SAMPLE_LOG:
+		retval = Ex_SetSampleLog(keys, values, count);
+		break;
+	case COMMAND_GET_SAMPLE_LOG_STATUS:
+		retval = Ex_GetSampleLogStatus(keys, values, count);
+		break;
+	case COMMAND_RESUME_SAMPLE_LOG:
+		retval = Ex_ResumeSampleLog(keys, values, count);
+		break;
+	case COMMAND_BURST_CAPTURE:
+		retval = Ex_BurstCapture(keys, values, count);
+		break;
+	case COMMAND_READ_BURST_CAPTURE:
+		retval = Ex_ReadBurstCapture(keys, values, count);
+		break;
+	case COMMAND_READ_BURST_SPECTRUM:
+		retval = Ex_ReadBurstSpectrum(keys, values, count);
+		break;
+	case COMMAND_SET_ANALOG_POWER:
+		retval = Ex_SetAnalogPower(keys, values, count);
+		break;
+	case COMMAND_SET_INTERLOCK:
+		retval = Ex_SetInterlock(keys, values, count);
+		break;
+	case COMMAND_RESET_INTERLOCKS:
+		retval = Ex_ResetInterlocks(keys, values, count);
+		break;
+	case COMMAND_LIST_INTERLOCKS:
+		retval = Ex_ListInterlocks(keys, values, count);
+		break;
+	case COMMAND_SET_PID:
+		retval = Ex_SetPid(keys, values, count);
+		break;
+	case COMMAND_LIST_PID_LOOPS:
+		retval = Ex_ListPidLoops(keys, values, count);
+		break;
+	case COMMAND_SET_MATH_CHANNEL:
+		retval = Ex_SetMathChannel(keys, values, count);
+		break;
+	case COMMAND_LIST_MATH_CHANNELS:
+		retval = Ex_ListMathChannels(keys, values, count);
+		break;
+	case COMMAND_SET_ANALOG_INPUT_AUTO_RANGE:
+		retval = Ex_SetAnalogInputAutoRange(keys, values, count);
+		break;
+	case COMMAND_SET_SENSOR_CHECK:
+		retval = Ex_SetSensorCheck(keys, values, count);
+		break;
+	case COMMAND_GET_SENSOR_CHECK:
+		retval = Ex_GetSensorCheck(keys, values, count);
+		break;
+	case COMMAND_SET_DIGITAL_INPUT_ENCODER:
+		retval = Ex_SetDigitalInputEncoder(keys, values, count);
+		break;
+	case COMMAND_SET_DIGITAL_INPUT_LATCH:
+		retval = Ex_SetDigitalInputLatch(keys, values, count);
+		break;
+	case COMMAND_SET_MIXED_SIGNAL:
+		retval = Ex_SetMixedSignal(keys, values, count);
+		break;
+	case COMMAND_SET_LOG_LEVEL:
+		retval = Ex_SetLogLevel(keys, values, count);
+		break;
+	case COMMAND_READ_STATE_TRACE:
+		retval = Ex_ReadStateTrace(keys, values, count);
+		break;
+	case COMMAND_SET_KEEPALIVE:
+		retval = Ex_SetKeepalive(keys, values, count);
+		break;
+	case COMMAND_FORMAT:
+		retval = Ex_Format(keys, values, count);
+		break;
+	case COMMAND_SET_AUX_ANALOG:
+		retval = Ex_SetAuxAnalog(keys, values, count);
+		break;
+	case COMMAND_BEGIN_MACRO:
+		retval = Ex_BeginMacro(keys, values, count);
+		break;
+	case COMMAND_END_MACRO:
+		retval = Ex_EndMacro(keys, values, count);
+		break;
+	case COMMAND_RUN_MACRO:
+		retval = Ex_RunMacro(keys, values, count);
+		break;
+	case COMMAND_DELETE_MACRO:
+		retval = Ex_DeleteMacro(keys, values, count);
+		break;
+	case COMMAND_LIST_MACROS:
+		retval = Ex_ListMacros(keys, values, count);
+		break;
+	case COMMAND_NONE:
+		/* Do nothing */
+		break;
+	default:
+		/* Do nothing */
+#ifdef COMMAND_DEBUG
+		printf("[Command Interpreter] Unrecognized command, doing nothing.\n\r");
+#endif
+		retval = ERR_COMMAND_BAD_COMMAND;
+	}
+	return retval;
+}
+
+/**
+ * Execute the LIST_ANALOG_INPUTS command.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_ListAnalogInputs(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_LIST_ANALOG_INPUTS_PARAMS, LIST_ANALOG_INPUTS_PARAMS)) {
+		Tekdaqc_Function_Error_t status = ListAnalogInputs();
+		if (status != ERR_FUNCTION_OK) {
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Listing of analog inputs failed with error: %s.\n\r", Tekdaqc_FunctionError_ToString(status));
+#endif
+			lastFunctionError = status;
+			retval = ERR_COMMAND_FUNCTION_ERROR;
+		}
+	} else {
+		/* We can't create a new input */
+#ifdef COMMAND_DEBUG
+		printf("[Command Interpreter] Provided arguments are not valid for listing the analog inputs.\n\r");
+#endif
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+
+/**
+ * Execute the READ_ADC_REGISTERS command.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_ReadADCRegisters(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_READ_ADC_REGISTERS_PARAMS, READ_ADC_REGISTERS_PARAMS)) {
+		ClearToStringBuffer();
+		ADS1256_RegistersToString();
+		if (TOSTRING_BUFFER[0] != '\0') {
+			TelnetWriteString(TOSTRING_BUFFER);
+			ClearToStringBuffer();
+		} else {
+			/* An error occurred */
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Unable to build string to print ADC registers.\n\r");
+#endif
+			retval = ERR_COMMAND_FUNCTION_ERROR;
+		}
+	} else {
+		/* We can't create a new input */
+#ifdef COMMAND_DEBUG
+		printf("[Command Interpreter] Provided arguments are not valid for reading the ADC registers.\n\r");
+#endif
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the READ_ANALOG_INPUT command.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_ReadAnalogInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_READ_ANALOG_INPUT_PARAMS, READ_ANALOG_INPUT_PARAMS)) {
+		int32_t numSamples = 0;
+		Channel_List_t list_type = ALL_CHANNELS;
+		int8_t index = -1;
+		for (int i = 0; i < NUM_READ_ANALOG_INPUT_PARAMS; ++i) {
+			index = GetIndexOfArgument(keys, READ_ANALOG_INPUT_PARAMS[i], count);
+			if (index >= 0) { /* We found the key in the list */
+				switch (i) { /* Switch on the key not position in arguments list */
+				case 0: /* INPUT key */
+#ifdef COMMAND_DEBUG
+					printf("Processing INPUT key\n\r");
+#endif
+					list_type = GetChannelListType(values[index]);
+					BuildAnalogInputList(list_type, values[index]);
+					break;
+				case 1: /* NUMBER key */
+#ifdef COMMAND_DEBUG
+					printf("Processing NUMBER key\n\r");
+#endif
+					numSamples = (int32_t) strtol(values[index], NULL, 10);
+					break;
+				default:
+					/* Return an error */
+					retval = ERR_COMMAND_PARSE_ERROR;
+				}
+			}
+			if (retval != ERR_COMMAND_OK) {
+				break; /* If an error occurred, don't bother continuing */
+			}
+		}
+		if (retval == ERR_COMMAND_OK) { /* If an error occurred, don't bother continuing */
+			switch (list_type) {
+			case SINGLE_CHANNEL:
+				ADC_Machine_Input_Sample(aInputs, numSamples, true);
+				break;
+			case CHANNEL_SET:
+				ADC_Machine_Input_Sample(aInputs, numSamples, false);
+				break;
+			case CHANNEL_RANGE:
+				ADC_Machine_Input_Sample(aInputs, numSamples, false);
+				break;
+			case ALL_CHANNELS:
+				ADC_Machine_Input_Sample(aInputs, numSamples, false);
+				break;
+			default:
+				/* Return an error */
+				retval = ERR_COMMAND_FUNCTION_ERROR;
+			}
+			CommandStateMoveToAnalogInputSample();
+		}
+	} else {
+		/* We can't create a new input */
+#ifdef COMMAND_DEBUG
+		printf("[Command Interpreter] Provided arguments are not valid for read of an analog input.\n\r");
+#endif
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the ADD_ANALOG_INPUT command.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_AddAnalogInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (isADCSampling() == FALSE) {
+		if (InputArgsCheck(keys, values, count, NUM_ADD_ANALOG_INPUT_PARAMS, ADD_ANALOG_INPUT_PARAMS) == true) {
+			/* Create a new input */
+			Tekdaqc_Function_Error_t status = CreateAnalogInput(keys, values, count);
+			if (status != ERR_FUNCTION_OK) {
+				/* Something went wrong with creating the input */
+#ifdef COMMAND_DEBUG
+				printf("[Command Interpreter] Creating a new analog input failed with error: %s.\n\r",
+						Tekdaqc_FunctionError_ToString(status));
+#endif
+				lastFunctionError = status;
+				retval = ERR_COMMAND_FUNCTION_ERROR;
+			}
+		} else {
+			/* We can't create a new input */
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Provided arguments are not valid for creation of a new analog input.\n\r");
+#endif
+			retval = ERR_COMMAND_OK;
+		}
+	} else {
+		retval = ERR_COMMAND_ADC_INVALID_OPERATION;
+	}
+	return retval;
+}
+
+/**
+ * Execute the REMOVE_ANALOG_INPUT command.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_RemoveAnalogInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (isADCSampling() == FALSE) {
+		if (InputArgsCheck(keys, values, count, NUM_REMOVE_ANALOG_INPUT_PARAMS, REMOVE_ANALOG_INPUT_PARAMS)) {
+			Tekdaqc_Function_Error_t status = RemoveAnalogInput(keys, values, count);
+			if (status != ERR_FUNCTION_OK) {
+				/* Something went wrong with removing the input */
+#ifdef COMMAND_DEBUG
+				printf("[Command Interpreter] Removing an analog input failed with error code: %s.\n\r",
+						Tekdaqc_FunctionError_ToString(status));
+#endif
+				lastFunctionError = status;
+				retval = ERR_COMMAND_FUNCTION_ERROR;
+			}
+		} else {
+			/* We can't delete an input */
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Provided arguments are not valid for removal of an analog input.\n\r");
+#endif
+			retval = ERR_COMMAND_BAD_PARAM;
+		}
+	} else {
+		retval = ERR_COMMAND_ADC_INVALID_OPERATION;
+	}
+	return retval;
+}
+
+/**
+ * Execute the CHECK_ANALOG_INPUT command.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_CheckAnalogInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	/* TODO: Fill in this method */
+	return retval;
+}
+
+/**
+ * Execute the SYSTEM_GCAL command.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SystemGainCal(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_SYSTEM_GCAL_PARAMS, SYSTEM_GCAL_PARAMS)) {
+		/* Perform a system gain calibration */
+		Tekdaqc_Function_Error_t status = PerformSystemGainCalibration(keys, values, count);
+		if (status != ERR_FUNCTION_OK) {
+			lastFunctionError = status;
+			retval = ERR_COMMAND_FUNCTION_ERROR;
+		}
+	} else {
+#ifdef COMMAND_DEBUG
+		printf("[Command Interpreter] Provided arguments are not valid for performing a system gain calibration.\n\r");
+#endif
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the SYSTEM_CAL command.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SystemCal(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	Tekdaqc_Function_Error_t status = PerformSystemCalibration();
+	if (status != ERR_FUNCTION_OK) {
+		lastFunctionError = status;
+		retval = ERR_COMMAND_FUNCTION_ERROR;
+	}
+	return retval;
+}
+
+/**
+ * Execute the LIST_DIGITAL_INPUTS command.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_ListDigitalInputs(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_LIST_DIGITAL_INPUTS_PARAMS, LIST_DIGITAL_INPUTS_PARAMS)) {
+		Tekdaqc_Function_Error_t status = ListDigitalInputs();
+		if (status != ERR_FUNCTION_OK) {
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Listing of digital inputs failed with error: %s.\n\r", Tekdaqc_FunctionError_ToString(status));
+#endif
+			lastFunctionError = status;
+			retval = ERR_COMMAND_FUNCTION_ERROR;
+		}
+	} else {
+		/* We can't create a new input */
+#ifdef COMMAND_DEBUG
+		printf("[Command Interpreter] Provided arguments are not valid for listing the digital inputs.\n\r");
+#endif
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the READ_DIGITAL_INPUT command.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_ReadDigitalInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_READ_DIGITAL_INPUT_PARAMS, READ_DIGITAL_INPUT_PARAMS)) {
+		int32_t numSamples = 0;
+		Channel_List_t list_type = 0;
+		int8_t index = -1;
+		for (int i = 0; i < NUM_READ_DIGITAL_INPUT_PARAMS; ++i) {
+			index = GetIndexOfArgument(keys, READ_DIGITAL_INPUT_PARAMS[i], count);
+			if (index >= 0) { /* We found the key in the list */
+				switch (i) { /*Switch on the key not position in arguments list */
+				case 0: /* INPUT key */
+#ifdef COMMAND_DEBUG
+					printf("Processing INPUT key\n\r");
+#endif
+					list_type = GetChannelListType(values[index]);
+					BuildDigitalInputList(list_type, values[index]);
+					break;
+				case 1: /* NUMBER key */
+#ifdef COMMAND_DEBUG
+					printf("Processing NUMBER key\n\r");
+#endif
+					numSamples = strtol(values[index], NULL, 10);
+					break;
+				default:
+					/* Return error */
+					retval = ERR_COMMAND_PARSE_ERROR;
+				}
+			}
+			if (retval != ERR_COMMAND_OK) { /* If there was an error, don't both continuing. */
+				break;
+			}
+		}
+		if (retval == ERR_COMMAND_OK) {
+			switch (list_type) {
+			case SINGLE_CHANNEL:
+				DI_Machine_Input_Sample(dInputs, numSamples, true);
+				break;
+			case CHANNEL_SET:
+				DI_Machine_Input_Sample(dInputs, numSamples, false);
+				break;
+			case CHANNEL_RANGE:
+				DI_Machine_Input_Sample(dInputs, numSamples, false);
+				break;
+			case ALL_CHANNELS:
+				DI_Machine_Input_Sample(dInputs, numSamples, false);
+				break;
+			default:
+				/* Return an error */
+				retval = ERR_COMMAND_FUNCTION_ERROR;
+			}
+			CommandStateMoveToDigitalInputSample();
+		}
+	}
+	return retval;
+}
+
+/**
+ * Execute the ADD_DIGITAL_INPUT command.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_AddDigitalInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (isDISampling() == FALSE) {
+		if (InputArgsCheck(keys, values, count, NUM_ADD_DIGITAL_INPUT_PARAMS, ADD_DIGITAL_INPUT_PARAMS) == true) {
+			/* Create a new input */
+			Tekdaqc_Function_Error_t status = CreateDigitalInput(keys, values, count);
+			if (status != ERR_FUNCTION_OK) {
+				/* Something went wrong with creating the input */
+#ifdef COMMAND_DEBUG
+				printf("[Command Interpreter] Creating a new digital input failed with error code: %s.\n\r",
+						Tekdaqc_FunctionError_ToString(status));
+#endif
+				lastFunctionError = status;
+				retval = ERR_COMMAND_FUNCTION_ERROR;
+			}
+		} else {
+			/* We can't create a new input */
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Provided arguments are not valid for creation of a new digital input.\n\r");
+#endif
+			retval = ERR_COMMAND_BAD_PARAM;
+		}
+	} else {
+		retval = ERR_COMMAND_DI_INVALID_OPERATION;
+	}
+	return retval;
+}
+
+/**
+ * Execute the REMOVE_DIGITAL_INPUT command.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_RemoveDigitalInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (isDISampling() == FALSE) {
+		if (InputArgsCheck(keys, values, count, NUM_REMOVE_DIGITAL_INPUT_PARAMS, REMOVE_DIGITAL_INPUT_PARAMS)) {
+			Tekdaqc_Function_Error_t status = RemoveDigitalInput(keys, values, count);
+			if (status != ERR_FUNCTION_OK) {
+				/* Something went wrong with removing the input */
+#ifdef COMMAND_DEBUG
+				printf("[Command Interpreter] Removing a digital input failed with error code: %s.\n\r",
+						Tekdaqc_FunctionError_ToString(status));
+#endif
+				lastFunctionError = status;
+				retval = ERR_COMMAND_FUNCTION_ERROR;
+			}
+		} else {
+			/* We can't delete an input */
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Provided arguments are not valid for removal of a digital input.\n\r");
+#endif
+			retval = ERR_COMMAND_BAD_PARAM;
+		}
+	} else {
+		retval = ERR_COMMAND_DI_INVALID_OPERATION;
+	}
+	return retval;
+}
+
+/**
+ * Execute the LIST_DIGITAL_OUTPUTS command.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_ListDigitalOutputs(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_LIST_DIGITAL_OUTPUTS_PARAMS, LIST_DIGITAL_OUTPUTS_PARAMS)) {
+		Tekdaqc_Function_Error_t status = ListDigitalOutputs();
+		if (status != ERR_FUNCTION_OK) {
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Listing of digital outputs failed with error: %s.\n\r", Tekdaqc_FunctionError_ToString(status));
+#endif
+			lastFunctionError = status;
+			retval = ERR_COMMAND_FUNCTION_ERROR;
+		}
+	} else {
+		/* We can't create a new input */
+#ifdef COMMAND_DEBUG
+		printf("[Command Interpreter] Provided arguments are not valid for listing the digital outputs.\n\r");
+#endif
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the SET_DIGITAL_OUTPUT command.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SetDigitalOutput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_SET_DIGITAL_OUTPUT_PARAMS, SET_DIGITAL_OUTPUT_PARAMS)) {
+		/* Set digital output */
+		Tekdaqc_Function_Error_t status = SetDigitalOutput(keys, values, count);
+		if (status != ERR_FUNCTION_OK) {
+			/* Something went wrong with setting the output */
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Setting digital output failed with error code: %i.\n\r", status);
+#endif
+			lastFunctionError = status;
+			retval = ERR_COMMAND_FUNCTION_ERROR;
+		}
+	} else {
+		/* We can't set an output */
+#ifdef COMMAND_DEBUG
+		printf("[Command Interpreter] Provided arguments are not valid for setting a digital output.\n\r");
+#endif
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the READ_DIGITAL_OUTPUT command.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_ReadDigitalOutput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_READ_DIGITAL_OUTPUT_PARAMS, READ_DIGITAL_OUTPUT_PARAMS)) {
+		int32_t numSamples = 0;
+		Channel_List_t list_type = 0;
+		int8_t index = -1;
+		for (int i = 0; i < NUM_READ_DIGITAL_OUTPUT_PARAMS; ++i) {
+			index = GetIndexOfArgument(keys, READ_DIGITAL_OUTPUT_PARAMS[i], count);
+			if (index >= 0) { /* We found the key in the list */
+				switch (i) { /* Switch on the key not position in arguments list */
+				case 0: /* INPUT key */
+#ifdef COMMAND_DEBUG
+					printf("Processing INPUT key\n\r");
+#endif
+					list_type = GetChannelListType(values[index]);
+					BuildDigitalOutputList(list_type, values[index]);
+					break;
+				case 1: /* NUMBER key */
+#ifdef COMMAND_DEBUG
+					printf("Processing NUMBER key\n\r");
+#endif
+					numSamples = strtol(values[index], NULL, 10);
+					break;
+				default:
+					/* Return error */
+					retval = ERR_COMMAND_PARSE_ERROR;
+				}
+			}
+			if (retval != ERR_COMMAND_OK) {
+				break;
+			}
+		}
+		if (retval == ERR_COMMAND_OK) {
+			switch (list_type) {
+			case SINGLE_CHANNEL:
+				DO_Machine_Output_Sample(dOutputs, numSamples, true);
+				break;
+			case CHANNEL_SET:
+				DO_Machine_Output_Sample(dOutputs, numSamples, false);
+				break;
+			case CHANNEL_RANGE:
+				DO_Machine_Output_Sample(dOutputs, numSamples, false);
+				break;
+			case ALL_CHANNELS:
+				DO_Machine_Output_Sample(dOutputs, numSamples, false);
+				break;
+			default:
+				/* Return an error */
+				retval = ERR_COMMAND_FUNCTION_ERROR;
+			}
+			CommandStateMoveToDigitalOutputSample();
+		}
+	} else {
+		/* We can't read an output */
+#ifdef COMMAND_DEBUG
+		printf("[Command Interpreter] Provided arguments are not valid for reading a digital output.\n\r");
+#endif
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the ADD_DIGITAL_OUTPUT command.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_AddDigitalOutput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (isDOSampling() == FALSE) {
+		if (InputArgsCheck(keys, values, count, NUM_ADD_DIGITAL_OUTPUT_PARAMS, ADD_DIGITAL_OUTPUT_PARAMS)) {
+			/* Create a new input */
+			Tekdaqc_Function_Error_t status = CreateDigitalOutput(keys, values, count);
+			if (status != ERR_FUNCTION_OK) {
+				/* Something went wrong with creating the output */
+#ifdef COMMAND_DEBUG
+				printf("[Command Interpreter] Creating a new digital output failed with error code: %s.\n\r",
+						Tekdaqc_FunctionError_ToString(status));
+#endif
+				lastFunctionError = status;
+				retval = ERR_COMMAND_FUNCTION_ERROR;
+			}
+		} else {
+			/* We can't create a new output */
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Provided arguments are not valid for creation of a new digital output.\n\r");
+#endif
+			retval = ERR_COMMAND_BAD_PARAM;
+		}
+	} else {
+		retval = ERR_COMMAND_DO_INVALID_OPERATION;
+	}
+	return retval;
+}
+
+/**
+ * Execute the REMOVE_DIGITAL_OUTPUT command.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_RemoveDigitalOutput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (isDOSampling() == FALSE) {
+		if (InputArgsCheck(keys, values, count, NUM_REMOVE_DIGITAL_OUTPUT_PARAMS, REMOVE_DIGITAL_OUTPUT_PARAMS)) {
+			Tekdaqc_Function_Error_t status = RemoveDigitalOutput(keys, values, count);
+			if (status != ERR_FUNCTION_OK) {
+				/* Something went wrong with removing the input */
+#ifdef COMMAND_DEBUG
+				printf("[Command Interpreter] Removing an digital output failed with error code: %s.\n\r",
+						Tekdaqc_FunctionError_ToString(status));
+#endif
+				lastFunctionError = status;
+				retval = ERR_COMMAND_FUNCTION_ERROR;
+			}
+		} else {
+			/* We can't delete an output */
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Provided arguments are not valid for removal of an digital output.\n\r");
+#endif
+			retval = ERR_COMMAND_BAD_PARAM;
+		}
+	} else {
+		retval = ERR_COMMAND_DO_INVALID_OPERATION;
+	}
+	return retval;
+}
+
+/**
+ * Execute the CLEAR_DIGITAL_OUTPUT_FAULT command.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_ClearDigitalOutputFault(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+
+	/* TODO: Clear digital faults */
+
+	return retval;
+}
+
+#if LWIP_STATS
+/**
+ * Writes the usage of an lwIP memory pool or the heap as a status message. A high-water mark equal to the size, or a
+ * growing error count, means the pool has run out and the stack has dropped or delayed data.
+ *
+ * @param name const char* C-String of the name to report the memory as.
+ * @param stats const struct stats_mem* Pointer to the lwIP statistics of the memory.
+ * @retval none
+ */
+static void WriteNetworkMemoryStats(const char* name, const struct stats_mem* stats) {
+	snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER),
+			"Network %s USED: %" PRIu32 " MAX: %" PRIu32 " OF: %" PRIu32 " ERRORS: %" PRIu32, name,
+			(uint32_t) stats->used, (uint32_t) stats->max, (uint32_t) stats->avail, (uint32_t) stats->err);
+	TelnetWriteStatusMessage(TOSTRING_BUFFER);
+}
+#endif
+
+/**
+ * Starts sampling all of the added analog inputs, digital inputs and digital outputs, as the SAMPLE command does.
+ *
+ * @param numSamples int32_t The number of samples to take, 0 to sample continuously.
+ * @param window uint32_t The statistics window in samples, 0 if not used.
+ * @param period uint32_t The statistics window in milliseconds, 0 if not used.
+ * @param overflow ADC_OverflowPolicy_t What happens when an analog input's buffer fills up.
+ * @retval none
+ */
+static void StartSampling(int32_t numSamples, uint32_t window, uint32_t period, ADC_OverflowPolicy_t overflow) {
+	BuildAnalogInputList(ALL_CHANNELS, NULL );
+	BuildDigitalInputList(ALL_CHANNELS, NULL );
+	BuildDigitalOutputList(ALL_CHANNELS, NULL );
+	if (isADCSampling() == FALSE) {
+		SetAnalogStatisticsWindow(window, period);
+		ADC_Machine_SetOverflowPolicy(overflow);
+	}
+	ADC_Machine_Input_Sample(aInputs, numSamples, false);
+	DI_Machine_Input_Sample(dInputs, numSamples, false);
+	DO_Machine_Output_Sample(dOutputs, numSamples, false);
+	CommandStateMoveToGeneralSample();
+	/* Start any slaves with the same number of samples */
+	Tekdaqc_CAN_SendSync(CAN_SYNC_START, (uint32_t) numSamples);
+}
+
+/**
+ * Execute the SAMPLE command. The optional WINDOW and TIME keys select statistics mode for the analog inputs, which
+ * then report the minimum, maximum, mean and RMS of each window of WINDOW samples or TIME milliseconds instead of
+ * their samples. The optional BANDWIDTH key plans the sampling for that many samples per second per channel: the
+ * data rate of the analog inputs is chosen to suit and the per channel rate the scan is expected to reach is
+ * reported before sampling starts. The optional OVERFLOW key, DROP_NEWEST (the default), DROP_OLDEST or PAUSE,
+ * selects what happens when an analog input's buffer fills up; PAUSE holds off sampling so that no sample is lost.
+ * The optional FRAME key, a frame rate in frames per second, selects snapshot mode: a timer starts each scan of the
+ * analog inputs with a SYNC pulse and every sample of a scan carries the timestamp of its frame. The optional INTERVAL
+ * key, in milliseconds, paces the analog inputs instead: a timer starts each scan at the interval and the ADC waits
+ * in standby between scans. FRAME and INTERVAL cannot be combined.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_Sample(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_SAMPLE_PARAMS, SAMPLE_PARAMS)) {
+		int32_t numSamples = 0;
+		uint32_t window = 0U;
+		uint32_t period = 0U;
+		float bandwidth = 0.0f;
+		ADC_OverflowPolicy_t overflow = ADC_OVERFLOW_DROP_NEWEST;
+		uint32_t frame = 0U;
+		float frameRate = 0.0f;
+		uint32_t interval = 0U;
+		int8_t index = -1;
+		for (int i = 0; i < NUM_SAMPLE_PARAMS; ++i) {
+			index = GetIndexOfArgument(keys, SAMPLE_PARAMS[i], count);
+			if (index >= 0) { /* We found the key in the list */
+				switch (i) { /* Switch on the key not position in arguments list */
+				case 0: /* NUMBER key */
+#ifdef COMMAND_DEBUG
+					printf("Processing NUMBER key\n\r");
+#endif
+					numSamples = (int32_t) strtol(values[index], NULL, 10);
+					break;
+				case 1: /* WINDOW key */
+					window = (uint32_t) strtoul(values[index], NULL, 10);
+					break;
+				case 2: /* TIME key */
+					period = (uint32_t) strtoul(values[index], NULL, 10);
+					break;
+				case 3: /* BANDWIDTH key */
+					bandwidth = strtof(values[index], NULL);
+					if (bandwidth <= 0.0f) {
+						retval = ERR_COMMAND_BAD_PARAM;
+					}
+					break;
+				case 4: /* OVERFLOW key */
+					overflow = ADC_Machine_StringToOverflowPolicy(values[index]);
+					if (overflow == NUM_ADC_OVERFLOW_POLICIES) {
+						retval = ERR_COMMAND_BAD_PARAM;
+					}
+					break;
+				case 5: /* FRAME key */
+					frameRate = strtof(values[index], NULL);
+					if (frameRate > 0.0f) {
+						frame = (uint32_t) (1000000.0f / frameRate);
+					}
+					if ((frame < ADC_SNAPSHOT_MIN_PERIOD_US) || (frame > ADC_SNAPSHOT_MAX_PERIOD_US)) {
+						retval = ERR_COMMAND_BAD_PARAM;
+					}
+					break;
+				case 6: /* INTERVAL key */
+					interval = (uint32_t) strtoul(values[index], NULL, 10);
+					if (interval <= (ADC_PACED_MAX_INTERVAL_US / 1000U)) {
+						interval *= 1000U; /* Milliseconds to microseconds */
+					}
+					if ((interval < ADC_PACED_MIN_INTERVAL_US) || (interval > ADC_PACED_MAX_INTERVAL_US)) {
+						retval = ERR_COMMAND_BAD_PARAM;
+					}
+					break;
+				default:
+					/* Return an error */
+					retval = ERR_COMMAND_PARSE_ERROR;
+				}
+			}
+			if (retval != ERR_COMMAND_OK) {
+				break; /* If an error occurred, don't bother continuing */
+			}
+		}
+		if ((frame != 0U) && (interval != 0U)) {
+			/* A sampling is either synchronized into frames or paced, not both */
+			retval = ERR_COMMAND_BAD_PARAM;
+		}
+		if ((retval == ERR_COMMAND_OK) && (bandwidth > 0.0f)) {
+			if (isADCSampling() == FALSE) {
+				ADS1256_SPS_t rate;
+				const float achievable = PlanAnalogInputRates(bandwidth, &rate);
+				snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "Planned analog sampling at RATE %s: %" PRIu32
+						" of %" PRIu32 " requested samples per second per channel.", ADS1256_StringFromSPS(rate),
+						(uint32_t) (achievable + 0.5f), (uint32_t) (bandwidth + 0.5f));
+				TelnetWriteStatusMessage(TOSTRING_BUFFER);
+			} else {
+				retval = ERR_COMMAND_ADC_INVALID_OPERATION;
+			}
+		}
+		if (retval == ERR_COMMAND_OK) { /* If an error occurred, don't bother continuing */
+			if (isADCSampling() == FALSE) {
+				ADC_Machine_SetSnapshotPeriod(frame);
+				ADC_Machine_SetScanInterval(interval);
+			}
+			StartSampling(numSamples, window, period, overflow);
+		}
+	} else {
+		/* We can't create a new input */
+#ifdef COMMAND_DEBUG
+		printf("[Command Interpreter] Provided arguments are not valid for read of an analog input.\n\r");
+#endif
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the HALT command. The optional PENDING key selects what becomes of the sample data which has not yet been
+ * sent: FLUSH (the default) sends it before analog sampling completes, DISCARD drops it so the board is idle at once,
+ * which suits halting only to reconfigure.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_Halt(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_HALT_PARAMS, HALT_PARAMS)) {
+		bool discard = false;
+		const int8_t index = GetIndexOfArgument(keys, PARAMETER_PENDING, count);
+		if (index >= 0) {
+			if (strcmp(values[index], PENDING_DISCARD_STRING) == 0) {
+				discard = true;
+			} else if (strcmp(values[index], PENDING_FLUSH_STRING) != 0) {
+				retval = ERR_COMMAND_BAD_PARAM;
+			}
+		}
+		if (retval == ERR_COMMAND_OK) {
+			HaltTasks(discard);
+			Tekdaqc_CAN_SendSync(CAN_SYNC_STOP, 0U);
+		}
+	} else {
+#ifdef COMMAND_DEBUG
+		printf("[Command Interpreter] Provided arguments are not valid for a halt.\n\r");
+#endif
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the IDENTIFY command.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_Identify(void) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	unsigned char* serial = Tekdaqc_GetLocatorBoardID();
+	if (serial == '\0') {
+		serial = ((unsigned char*) "None");
+	}
+	uint8_t type = Tekdaqc_GetLocatorBoardType();
+	uint32_t ip = Tekdaqc_GetLocatorIp();
+	unsigned char* MAC = Tekdaqc_GetLocatorMAC();
+	uint32_t version = Tekdaqc_GetLocatorVersion();
+	uint32_t count = 0;
+	count = snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Board Identity");
+	count += snprintf(TOSTRING_BUFFER + count, 51*sizeof(char), "\n\r\tSerial Number: %s", serial);
+	count -= 2;
+	count += snprintf(TOSTRING_BUFFER + count, sizeof(TOSTRING_BUFFER), "\n\r\tBoard Revision: %c\n\r\tFirmware Version: %lu.%lu.%lu.%lu", (char) type,
+			(version & 0xff), ((version >> 8) & 0xff), ((version >> 16) & 0xff), ((version >> 24) & 0xff));
+	count += snprintf(TOSTRING_BUFFER + count, sizeof(TOSTRING_BUFFER), "\n\r\tIP Address: %lu.%lu.%lu.%lu", ip & 0xff, (ip >> 8) & 0xff, (ip >> 16) & 0xff,
+			(ip >> 24) & 0xff);
+	count += snprintf(TOSTRING_BUFFER + count, sizeof(TOSTRING_BUFFER), "\n\r\tMAC Address: %02X:%02X:%02X:%02X:%02X:%02X\n\r", *MAC, *(MAC+1), *(MAC+2),
+			*(MAC+3), *(MAC+4), *(MAC+5));
+	TelnetWriteStatusMessage(TOSTRING_BUFFER);
+	return retval;
+}
+
+/**
+ * Execute the SET_RTC command.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SetRTC(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+
+	/* TODO: Set RTC */
+
+	return retval;
+}
+
+/**
+ * Execute the SET_USER_MAC command.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SetUserMac(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+
+	/* TODO: Clear user MAC */
+
+	return retval;
+}
+
+/**
+ * Execute the SET_STATIC_IP command. The VALUE key is the address to use from the next reset on, skipping DHCP, or
+ * NONE to go back to DHCP. The NETMASK defaults to 255.255.255.0 and the GATEWAY to the first host of the subnet.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SetStaticIP(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	int8_t index = GetIndexOfArgument(keys, PARAMETER_VALUE, count);
+	if ((index >= 0) && InputArgsCheck(keys, values, count, NUM_SET_STATIC_IP_PARAMS, SET_STATIC_IP_PARAMS)) {
+		bool valid = TRUE;
+		bool saved = FALSE;
+		if (strcmp(values[index], ADDRESS_NONE_STRING) == 0) {
+			saved = LwIP_SaveStaticAddress(NULL, NULL, NULL);
+		} else {
+			ip_addr_t address;
+			ip_addr_t netmask;
+			ip_addr_t gateway;
+			ip_addr_set_zero(&address);
+			valid = (ipaddr_aton(values[index], &address) != 0) ? TRUE : FALSE;
+			IP4_ADDR(&netmask, 255, 255, 255, 0);
+			int8_t keyIndex = GetIndexOfArgument(keys, PARAMETER_NETMASK, count);
+			if ((keyIndex >= 0) && (ipaddr_aton(values[keyIndex], &netmask) == 0)) {
+				valid = FALSE;
+			}
+			ip4_addr_set_u32(&gateway, (ip4_addr_get_u32(&address) & ip4_addr_get_u32(&netmask)) | PP_HTONL(1UL));
+			keyIndex = GetIndexOfArgument(keys, PARAMETER_GATEWAY, count);
+			if ((keyIndex >= 0) && (ipaddr_aton(values[keyIndex], &gateway) == 0)) {
+				valid = FALSE;
+			}
+			if (ip_addr_isany(&address) || !ip_addr_netmask_valid(&netmask)) {
+				valid = FALSE;
+			}
+			if (valid == TRUE) {
+				saved = LwIP_SaveStaticAddress(&address, &netmask, &gateway);
+			}
+		}
+		if (valid == FALSE) {
+			retval = ERR_COMMAND_BAD_PARAM;
+		} else if (saved == TRUE) {
+			TelnetWriteStatusMessage("The network address takes effect after a reset.");
+		} else {
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Saving the static IP address failed.\n\r");
+#endif
+			lastFunctionError = ERR_CONFIG_WRITE_FAILED;
+			retval = ERR_COMMAND_FUNCTION_ERROR;
+		}
+	} else {
+#ifdef COMMAND_DEBUG
+		printf("[Command Interpreter] Provided arguments are not valid for setting the static IP address.\n\r");
+#endif
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the GET_CALIBRATION_STATUS command.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_GetCalibrationStatus(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	bool valid = isTekdaqc_CalibrationValid();
+	count = snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Calibration Status: %s", (valid == true) ? "VALID" : "INVALID");
+	TelnetWriteStatusMessage(TOSTRING_BUFFER);
+	return retval;
+}
+
+/**
+ * Execute the SET_COLD_JUNCTION_REFRESH command. Exactly one of the TIME (milliseconds) or SCANS keys must be
+ * provided. A value of 0 refreshes the cold junction on every external multiplexer switch.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SetColdJunctionRefresh(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if ((count == 1U) && InputArgsCheck(keys, values, count, NUM_SET_COLD_JUNCTION_REFRESH_PARAMS, SET_COLD_JUNCTION_REFRESH_PARAMS)) {
+		ADC_ColdJunctionRefresh_t policy = ADC_CJ_REFRESH_TIME;
+		uint32_t interval = 0U;
+		int8_t index = -1;
+		for (int i = 0; i < NUM_SET_COLD_JUNCTION_REFRESH_PARAMS; ++i) {
+			index = GetIndexOfArgument(keys, SET_COLD_JUNCTION_REFRESH_PARAMS[i], count);
+			if (index >= 0) { /* We found the key in the list */
+				switch (i) { /* Switch on the key not position in arguments list */
+				case 0: /* TIME key */
+#ifdef COMMAND_DEBUG
+					printf("Processing TIME key\n\r");
+#endif
+					policy = ADC_CJ_REFRESH_TIME;
+					interval = ((uint32_t) strtoul(values[index], NULL, 10)) * 1000U; /* Convert to microseconds */
+					break;
+				case 1: /* SCANS key */
+#ifdef COMMAND_DEBUG
+					printf("Processing SCANS key\n\r");
+#endif
+					policy = ADC_CJ_REFRESH_SCANS;
+					interval = (uint32_t) strtoul(values[index], NULL, 10);
+					break;
+				default:
+					/* Return an error */
+					retval = ERR_COMMAND_PARSE_ERROR;
+				}
+			}
+			if (retval != ERR_COMMAND_OK) {
+				break; /* If an error occurred, don't bother continuing */
+			}
+		}
+		if (retval == ERR_COMMAND_OK) {
+			ADC_Machine_SetColdJunctionRefresh(policy, interval);
+		}
+	} else {
+#ifdef COMMAND_DEBUG
+		printf("[Command Interpreter] Provided arguments are not valid for setting the cold junction refresh.\n\r");
+#endif
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the SET_DATA_FORMAT command. Selects whether analog samples and digital input scans are sent to this
+ * connection as text records or as binary frames. COMPRESSED selects binary frames in which runs of analog samples
+ * are packed into compressed records. Every sample field is sent and no stream descriptor, as clients written before
+ * the FORMAT command expect. The format can not be changed while the ADC is sampling.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SetDataFormat(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (isADCSampling() == FALSE) {
+		int8_t index = GetIndexOfArgument(keys, PARAMETER_FORMAT, count);
+		if ((index >= 0) && InputArgsCheck(keys, values, count, NUM_SET_DATA_FORMAT_PARAMS, SET_DATA_FORMAT_PARAMS)) {
+			if (strcmp(values[index], FORMAT_TEXT_STRING) == 0) {
+				SetAnalogInputCompression(false);
+				TelnetSetDataFormat(DATA_FORMAT_TEXT);
+				TelnetSetDataFields(DATA_FIELDS_DEFAULT);
+			} else if ((strcmp(values[index], FORMAT_BINARY_STRING) == 0)
+					|| (strcmp(values[index], FORMAT_COMPRESSED_STRING) == 0)) {
+				ResetAnalogInputBinaryFraming();
+				ResetDigitalInputBinaryFraming();
+				SetAnalogInputCompression(strcmp(values[index], FORMAT_COMPRESSED_STRING) == 0);
+				TelnetSetDataFormat(DATA_FORMAT_BINARY);
+				TelnetSetDataFields(DATA_FIELDS_DEFAULT);
+			} else {
+				retval = ERR_COMMAND_BAD_PARAM;
+			}
+		} else {
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Provided arguments are not valid for setting the data format.\n\r");
+#endif
+			retval = ERR_COMMAND_BAD_PARAM;
+		}
+	} else {
+		retval = ERR_COMMAND_ADC_INVALID_OPERATION;
+	}
+	return retval;
+}
+
+/**
+ * Execute the SET_FLUSH_LATENCY command. The TIME key sets the maximum number of milliseconds data waits in the
+ * telnet and data server transmit buffers, or a published batch waits, for a full packet to accumulate. A value of 0 sends data as soon as it is written.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SetFlushLatency(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	int8_t index = GetIndexOfArgument(keys, PARAMETER_TIME, count);
+	if ((index >= 0) && InputArgsCheck(keys, values, count, NUM_SET_FLUSH_LATENCY_PARAMS, SET_FLUSH_LATENCY_PARAMS)) {
+		uint32_t latency = ((uint32_t) strtoul(values[index], NULL, 10)) * 1000U; /* Convert to microseconds */
+		TelnetSetFlushLatency(latency);
+		DataServerSetFlushLatency(latency);
+		SamplePublisherSetLatency(latency);
+		RawStreamSetLatency(latency);
+	} else {
+#ifdef COMMAND_DEBUG
+		printf("[Command Interpreter] Provided arguments are not valid for setting the flush latency.\n\r");
+#endif
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the SET_PUBLISH command. The ADDRESS key selects the unicast or multicast address sample data is published
+ * to over UDP, or NONE to stop publishing. The optional PORT key selects the destination port, defaulting to
+ * PUBLISH_PORT. An ADDRESS given as a MAC address instead, such as 02:00:5E:10:00:01, streams the sample data in raw
+ * Ethernet frames to that address, bypassing IP, for a dedicated point to point link; see RawStream.c. While
+ * publishing, sample data is sent only to the publish destination. The destination can not be changed while the ADC
+ * is sampling.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SetPublish(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (isADCSampling() == FALSE) {
+		int8_t index = GetIndexOfArgument(keys, PARAMETER_ADDRESS, count);
+		if ((index >= 0) && InputArgsCheck(keys, values, count, NUM_SET_PUBLISH_PARAMS, SET_PUBLISH_PARAMS)) {
+			uint8_t mac[RAW_STREAM_ADDRESS_LENGTH];
+			if (strcmp(values[index], ADDRESS_NONE_STRING) == 0) {
+				SamplePublisherStop();
+				RawStreamStop();
+			} else if (ParseMacAddress(values[index], mac) == true) {
+				SamplePublisherStop();
+				RawStreamStop();
+				/* The receiving host needs the channel settings before the first sample */
+				ResetAnalogInputBinaryFraming();
+				ResetDigitalInputBinaryFraming();
+				RawStreamStart(mac);
+			} else {
+				ip_addr_t address;
+				uint16_t port = PUBLISH_PORT;
+				int8_t portIndex = GetIndexOfArgument(keys, PARAMETER_PORT, count);
+				if (portIndex >= 0) {
+					port = (uint16_t) strtoul(values[portIndex], NULL, 10);
+				}
+				if ((ipaddr_aton(values[index], &address) != 0) && (port != 0U)) {
+					SamplePublisherStop();
+					RawStreamStop();
+					/* New subscribers need the channel settings before the first sample */
+					ResetAnalogInputBinaryFraming();
+					ResetDigitalInputBinaryFraming();
+					SamplePublisherStart(&address, port);
+				} else {
+					retval = ERR_COMMAND_BAD_PARAM;
+				}
+			}
+		} else {
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Provided arguments are not valid for setting the publish destination.\n\r");
+#endif
+			retval = ERR_COMMAND_BAD_PARAM;
+		}
+	} else {
+		retval = ERR_COMMAND_ADC_INVALID_OPERATION;
+	}
+	return retval;
+}
+
+/**
+ * Execute the SET_DIGITAL_INPUT_RATE command. The RATE key sets the rate in Hz at which digital input sampling takes
+ * its samples, between 1 and DI_MAX_SAMPLE_RATE_HZ. Digital inputs are sampled on this fixed cadence so that they
+ * do not take time from the analog inputs when both are sampled together.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SetDigitalInputRate(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	int8_t index = GetIndexOfArgument(keys, PARAMETER_RATE, count);
+	if ((index >= 0) && InputArgsCheck(keys, values, count, NUM_SET_DIGITAL_INPUT_RATE_PARAMS, SET_DIGITAL_INPUT_RATE_PARAMS)) {
+		if (DI_Machine_SetSampleRate((uint32_t) strtoul(values[index], NULL, 10)) == false) {
+			retval = ERR_COMMAND_BAD_PARAM;
+		}
+	} else {
+#ifdef COMMAND_DEBUG
+		printf("[Command Interpreter] Provided arguments are not valid for setting the digital input rate.\n\r");
+#endif
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the SET_ANALOG_INPUT_FILTER command. The INPUT key selects the analog input, the FILTER key one of NONE,
+ * AVERAGE, CIC or FIR and the DECIMATION key the number of conversions combined into each reported sample. Sample
+ * counts given to the sampling commands still refer to conversions, so a filtered input reports SCANS / DECIMATION
+ * samples.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SetAnalogInputFilter(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (isADCSampling() == FALSE) {
+		if (InputArgsCheck(keys, values, count, NUM_SET_ANALOG_INPUT_FILTER_PARAMS, SET_ANALOG_INPUT_FILTER_PARAMS)) {
+			Tekdaqc_Function_Error_t status = SetAnalogInputFilter(keys, values, count);
+			if (status != ERR_FUNCTION_OK) {
+				/* Something went wrong with setting the filter */
+#ifdef COMMAND_DEBUG
+				printf("[Command Interpreter] Setting an analog input filter failed with error code: %s.\n\r",
+						Tekdaqc_FunctionError_ToString(status));
+#endif
+				lastFunctionError = status;
+				retval = ERR_COMMAND_FUNCTION_ERROR;
+			}
+		} else {
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Provided arguments are not valid for setting an analog input filter.\n\r");
+#endif
+			retval = ERR_COMMAND_BAD_PARAM;
+		}
+	} else {
+		retval = ERR_COMMAND_ADC_INVALID_OPERATION;
+	}
+	return retval;
+}
+
+/**
+ * Execute the CAPTURE command. Samples the single analog input given by the INPUT key at its full rate, keeping the
+ * PRE most recent samples until the trigger fires, then POST samples from the trigger on, after which sampling stops
+ * and the capture is written out. The SOURCE key selects a digital input number to trigger on its EDGE, CAN to trigger
+ * on a trigger frame from the CAN master, or ANALOG (the default) to trigger when the captured input crosses LEVEL
+ * counts in the EDGE direction. EDGE is RISING or
+ * FALLING, RISING by default.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_Capture(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (isADCSampling() == TRUE) {
+		return ERR_COMMAND_ADC_INVALID_OPERATION;
+	}
+	if (InputArgsCheck(keys, values, count, NUM_CAPTURE_PARAMS, CAPTURE_PARAMS)) {
+		Analog_Input_t* input = NULL;
+		const Digital_Input_t* source = NULL;
+		bool external = FALSE;
+		int32_t level = 0;
+		AnalogTriggerEdge_t edge = ANALOG_TRIGGER_RISING;
+		uint32_t pre = 0U;
+		uint32_t post = 0U;
+		int8_t index = -1;
+		for (uint_fast8_t i = 0U; (i < NUM_CAPTURE_PARAMS) && (retval == ERR_COMMAND_OK); ++i) {
+			index = GetIndexOfArgument(keys, CAPTURE_PARAMS[i], count);
+			if (index < 0) {
+				/* Only the INPUT and POST keys are required */
+				if ((i == 0U) || (i == 5U)) {
+					retval = ERR_COMMAND_BAD_PARAM;
+				}
+				continue;
+			}
+			switch (i) { /* Switch on the key not position in arguments list */
+			case 0U: /* INPUT key */
+				input = GetAnalogInputByNumber((uint8_t) strtol(values[index], NULL, 10));
+				if ((input == NULL) || (input->added == CHANNEL_NOTADDED) || (input->physicalInput == IN_COLD_JUNCTION)) {
+					retval = ERR_COMMAND_BAD_PARAM;
+				}
+				break;
+			case 1U: /* SOURCE key */
+				if (strcmp(values[index], ANALOG_TRIGGER_SOURCE_CAN) == 0) {
+					external = TRUE;
+				} else if (strcmp(values[index], ANALOG_TRIGGER_SOURCE_ANALOG) != 0) {
+					source = GetDigitalInputByNumber((uint8_t) strtol(values[index], NULL, 10));
+					if ((source == NULL) || (source->added == CHANNEL_NOTADDED)) {
+						retval = ERR_COMMAND_BAD_PARAM;
+					}
+				}
+				break;
+			case 2U: /* LEVEL key */
+				level = (int32_t) strtol(values[index], NULL, 10);
+				break;
+			case 3U: /* EDGE key */
+				edge = AnalogTrigger_StringToEdge(values[index]);
+				break;
+			case 4U: /* PRE key */
+				pre = (uint32_t) strtoul(values[index], NULL, 10);
+				break;
+			case 5U: /* POST key */
+				post = (uint32_t) strtoul(values[index], NULL, 10);
+				break;
+			default:
+				retval = ERR_COMMAND_PARSE_ERROR;
+			}
+		}
+		if ((retval == ERR_COMMAND_OK) && (((external == TRUE) ? AnalogTrigger_ArmExternal(pre, post) :
+				AnalogTrigger_Arm(source, level, edge, pre, post)) == false)) {
+			retval = ERR_COMMAND_BAD_PARAM;
+		}
+		if (retval == ERR_COMMAND_OK) {
+			for (uint_fast8_t i = 0U; i < NUM_ANALOG_INPUTS; ++i) {
+				aInputs[i] = NULL;
+			}
+			aInputs[0] = input;
+			/* Sample until the trigger stops it */
+			ADC_Machine_Input_Sample(aInputs, ADC_SAMPLE_CONTINUOUS, true);
+			CommandStateMoveToAnalogInputSample();
+		}
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+#ifdef COMMAND_DEBUG
+	if (retval != ERR_COMMAND_OK) {
+		printf("[Command Interpreter] Provided arguments are not valid for a triggered capture.\n\r");
+	}
+#endif
+	return retval;
+}
+
+/**
+ * Execute the PROFILE command. Reports the cycle counts of each profiled hot path since the last report, then starts
+ * a new interval. The bytes of binary sample frames sent and the compression ratio achieved are reported with them.
+ * Only available in builds with HOT_PATH_PROFILE defined.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_Profile(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+#ifdef HOT_PATH_PROFILE
+	ProfileStatistics_t stats;
+	for (uint_fast8_t i = 0U; i < NUM_PROFILE_POINTS; ++i) {
+		if (Profile_GetStatistics((ProfilePoint_t) i, &stats) == true) {
+			const uint32_t average = (stats.count > 0U) ? (uint32_t) (stats.total / stats.count) : 0U;
+			snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER),
+					"Profile %s: Count: %" PRIu32 ", Min: %" PRIu32 ", Max: %" PRIu32 ", Average: %" PRIu32 " cycles",
+					Profile_StringFromPoint((ProfilePoint_t) i), stats.count, stats.min, stats.max, average);
+			TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		}
+	}
+	uint32_t sent;
+	uint32_t raw;
+	GetAnalogInputCompressionTotals(&sent, &raw);
+	if (sent > 0U) {
+		/* The ratio in hundredths, 100 meaning no saving */
+		const uint32_t ratio = (uint32_t) (((uint64_t) raw * 100U) / sent);
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER),
+				"Compression: Sent: %" PRIu32 " bytes, Uncompressed: %" PRIu32 " bytes, Ratio: %" PRIu32 ".%02" PRIu32,
+				sent, raw, ratio / 100U, ratio % 100U);
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+	}
+	ResetAnalogInputCompressionTotals();
+	Profile_Reset();
+#else
+	TelnetWriteStatusMessage("Profiling is not enabled in this build.");
+#endif
+	return retval;
+}
+
+/**
+ * Execute the GET_TIMING_HISTOGRAMS command. Reports the histograms of the time from DRDY to the data read, between
+ * successive conversions of an input and between passes of the program loop, recorded since the last reset.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_GetTimingHistograms(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	TimingHistogramData_t data;
+	for (uint_fast8_t i = 0U; i < NUM_TIMING_HISTOGRAMS; ++i) {
+		if (TimingHistogram_Get((TimingHistogram_t) i, &data) == false) {
+			continue;
+		}
+		int length = snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Timing %s: Count: %" PRIu32 ", Min: %" PRIu32
+				" us, Max: %" PRIu32 " us, Buckets:", TimingHistogram_StringFromHistogram((TimingHistogram_t) i), data.count,
+				(data.count > 0U) ? data.min : 0U, (data.count > 0U) ? data.max : 0U);
+		/* Only the occupied buckets are listed, by their upper limit */
+		for (uint8_t bucket = 0U; (bucket < TIMING_HISTOGRAM_BUCKETS) && (length > 0)
+				&& (length < (int) sizeof(TOSTRING_BUFFER)); ++bucket) {
+			if (data.buckets[bucket] == 0U) {
+				continue;
+			}
+			if (bucket < (TIMING_HISTOGRAM_BUCKETS - 1U)) {
+				length += snprintf(TOSTRING_BUFFER + length, sizeof(TOSTRING_BUFFER) - length, " <%" PRIu32 ": %" PRIu32,
+						TimingHistogram_BucketLimit(bucket), data.buckets[bucket]);
+			} else {
+				length += snprintf(TOSTRING_BUFFER + length, sizeof(TOSTRING_BUFFER) - length, " >=%" PRIu32 ": %" PRIu32,
+						TimingHistogram_BucketLimit(bucket - 1U), data.buckets[bucket]);
+			}
+		}
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+	}
+	return retval;
+}
+
+/**
+ * Execute the RESET_TIMING_HISTOGRAMS command. Discards the intervals recorded in all timing histograms.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_ResetTimingHistograms(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	TimingHistogram_Reset();
+	return retval;
+}
+
+/**
+ * Execute the READ_DIGITAL_INPUT_EDGES command. Streams the current level of each digital input given by the INPUT key,
+ * then each of their transitions, timestamped when it happens, until halted. Inputs sharing a pin number, and inputs on
+ * the EXTI lines of the ADS1256 DRDY and ethernet link interrupts, cannot be captured.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_ReadDigitalInputEdges(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (isDISampling() == TRUE) {
+		return ERR_COMMAND_DI_INVALID_OPERATION;
+	}
+	if (InputArgsCheck(keys, values, count, NUM_READ_DIGITAL_INPUT_EDGES_PARAMS, READ_DIGITAL_INPUT_EDGES_PARAMS)) {
+		const int8_t index = GetIndexOfArgument(keys, READ_DIGITAL_INPUT_EDGES_PARAMS[0], count);
+		if (index < 0) {
+			retval = ERR_COMMAND_BAD_PARAM;
+		} else {
+			BuildDigitalInputList(GetChannelListType(values[index]), values[index]);
+			if (DI_Machine_Edge_Capture(dInputs) == true) {
+				CommandStateMoveToDigitalInputSample();
+			} else {
+				retval = ERR_COMMAND_DI_INVALID_OPERATION;
+			}
+		}
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the READ_DIGITAL_INPUT_COUNTERS command. Counts the rising edges of each digital input given by the INPUT
+ * key in hardware and reports the count, frequency and period of each every TIME milliseconds, 1000 by default, until
+ * halted. The same inputs as for READ_DIGITAL_INPUT_EDGES can be counted.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_ReadDigitalInputCounters(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (isDISampling() == TRUE) {
+		return ERR_COMMAND_DI_INVALID_OPERATION;
+	}
+	if (InputArgsCheck(keys, values, count, NUM_READ_DIGITAL_INPUT_COUNTERS_PARAMS, READ_DIGITAL_INPUT_COUNTERS_PARAMS)) {
+		uint32_t interval = DI_DEFAULT_COUNTER_INTERVAL_MS;
+		const int8_t timeIndex = GetIndexOfArgument(keys, PARAMETER_TIME, count);
+		if (timeIndex >= 0) {
+			interval = (uint32_t) strtoul(values[timeIndex], NULL, 10);
+		}
+		const int8_t index = GetIndexOfArgument(keys, PARAMETER_INPUT, count);
+		if (index < 0) {
+			retval = ERR_COMMAND_BAD_PARAM;
+		} else {
+			BuildDigitalInputList(GetChannelListType(values[index]), values[index]);
+			if (DI_Machine_Count(dInputs, interval) == true) {
+				CommandStateMoveToDigitalInputSample();
+			} else {
+				retval = ERR_COMMAND_DI_INVALID_OPERATION;
+			}
+		}
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the SET_DIGITAL_OUTPUTS command. The VALUE key is a bit field of output levels, bit n turning output n
+ * on, and may be given in hex with a 0x prefix. Only the outputs listed by the optional OUTPUT key are changed; when it
+ * is omitted, every added output is. All of the changes are written to the relay drivers in a single frame.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SetDigitalOutputs(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_SET_DIGITAL_OUTPUTS_PARAMS, SET_DIGITAL_OUTPUTS_PARAMS)) {
+		const int8_t valueIndex = GetIndexOfArgument(keys, PARAMETER_VALUE, count);
+		const int8_t outputIndex = GetIndexOfArgument(keys, PARAMETER_OUTPUT, count);
+		char* testPtr = NULL;
+		unsigned long levels = 0UL;
+		if (valueIndex >= 0) {
+			levels = strtoul(values[valueIndex], &testPtr, 0);
+		}
+		if (valueIndex < 0 || testPtr == values[valueIndex] || (levels >> (NUM_DIGITAL_OUTPUTS - 1U)) > 1UL) {
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Provided arguments are not valid for setting digital outputs.\n\r");
+#endif
+			retval = ERR_COMMAND_BAD_PARAM;
+		} else {
+			DigitalOutputMask_t mask = 0U;
+			if (outputIndex >= 0) {
+				/* Only the listed outputs are changed */
+				BuildDigitalOutputList(GetChannelListType(values[outputIndex]), values[outputIndex]);
+				for (uint_fast8_t i = 0U; i < NUM_DIGITAL_OUTPUTS; ++i) {
+					if (dOutputs[i] != NULL && dOutputs[i]->added == CHANNEL_ADDED) {
+						mask |= (1UL << dOutputs[i]->output);
+					}
+				}
+			} else {
+				/* Every added output is changed */
+				for (uint_fast8_t i = 0U; i < NUM_DIGITAL_OUTPUTS; ++i) {
+					Digital_Output_t* output = GetDigitalOutputByNumber(i);
+					if (output != NULL && output->added == CHANNEL_ADDED) {
+						mask |= (1UL << i);
+					}
+				}
+			}
+			Tekdaqc_Function_Error_t status = SetDigitalOutputs(mask, (DigitalOutputMask_t) levels);
+			if (status != ERR_FUNCTION_OK) {
+				/* Something went wrong with setting the outputs */
+#ifdef COMMAND_DEBUG
+				printf("[Command Interpreter] Setting digital outputs failed with error code: %i.\n\r", status);
+#endif
+				lastFunctionError = status;
+				retval = ERR_COMMAND_FUNCTION_ERROR;
+			}
+		}
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the SET_DIGITAL_OUTPUT_PWM command. The output given by the OUTPUT key is driven with a PWM waveform of the
+ * frequency given by the RATE key, in Hz, and the duty cycle given by the VALUE key, in percent. The waveform is
+ * produced by the board until the output is next set.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SetDigitalOutputPwm(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_SET_DIGITAL_OUTPUT_PWM_PARAMS, SET_DIGITAL_OUTPUT_PWM_PARAMS)) {
+		const int8_t outputIndex = GetIndexOfArgument(keys, PARAMETER_OUTPUT, count);
+		const int8_t rateIndex = GetIndexOfArgument(keys, PARAMETER_RATE, count);
+		const int8_t valueIndex = GetIndexOfArgument(keys, PARAMETER_VALUE, count);
+		if (outputIndex < 0 || rateIndex < 0 || valueIndex < 0) {
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Provided arguments are not valid for modulating a digital output.\n\r");
+#endif
+			retval = ERR_COMMAND_BAD_PARAM;
+		} else {
+			const unsigned long output = strtoul(values[outputIndex], NULL, 10);
+			const unsigned long frequency = strtoul(values[rateIndex], NULL, 10);
+			const unsigned long duty = strtoul(values[valueIndex], NULL, 10);
+			if (output >= NUM_DIGITAL_OUTPUTS || duty > 100UL) {
+				retval = ERR_COMMAND_BAD_PARAM;
+			} else {
+				Tekdaqc_Function_Error_t status = SetDigitalOutputPwm((uint8_t) output, (uint32_t) frequency, (uint8_t) duty);
+				if (status != ERR_FUNCTION_OK) {
+					/* Something went wrong with modulating the output */
+#ifdef COMMAND_DEBUG
+					printf("[Command Interpreter] Modulating digital output failed with error code: %i.\n\r", status);
+#endif
+					lastFunctionError = status;
+					retval = ERR_COMMAND_FUNCTION_ERROR;
+				}
+			}
+		}
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the ADD_DIGITAL_OUTPUT_SEQUENCE_STEP command. A step setting the outputs to the bit field given by the VALUE
+ * key, bit n turning output n on, is appended to the sequence. The TIME key is the offset of the step from the start
+ * of the sequence, in microseconds.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_AddDigitalOutputSequenceStep(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_ADD_DIGITAL_OUTPUT_SEQUENCE_STEP_PARAMS, ADD_DIGITAL_OUTPUT_SEQUENCE_STEP_PARAMS)) {
+		const int8_t timeIndex = GetIndexOfArgument(keys, PARAMETER_TIME, count);
+		const int8_t valueIndex = GetIndexOfArgument(keys, PARAMETER_VALUE, count);
+		char* testPtr = NULL;
+		unsigned long levels = 0UL;
+		if (valueIndex >= 0) {
+			levels = strtoul(values[valueIndex], &testPtr, 0);
+		}
+		if (timeIndex < 0 || valueIndex < 0 || testPtr == values[valueIndex] || (levels >> (NUM_DIGITAL_OUTPUTS - 1U)) > 1UL) {
+			retval = ERR_COMMAND_BAD_PARAM;
+		} else {
+			const uint32_t offset = (uint32_t) strtoul(values[timeIndex], NULL, 10);
+			Tekdaqc_Function_Error_t status = AddDigitalOutputSequenceStep(offset, (DigitalOutputMask_t) levels);
+			if (status != ERR_FUNCTION_OK) {
+				/* Something went wrong with the sequence */
+#ifdef COMMAND_DEBUG
+				printf("[Command Interpreter] Adding a sequence step failed with error code: %i.\n\r", status);
+#endif
+				lastFunctionError = status;
+				retval = ERR_COMMAND_FUNCTION_ERROR;
+			}
+		}
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the CLEAR_DIGITAL_OUTPUT_SEQUENCE command, emptying the sequence.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_ClearDigitalOutputSequence(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_CLEAR_DIGITAL_OUTPUT_SEQUENCE_PARAMS, CLEAR_DIGITAL_OUTPUT_SEQUENCE_PARAMS)) {
+		Tekdaqc_Function_Error_t status = ClearDigitalOutputSequence();
+		if (status != ERR_FUNCTION_OK) {
+			/* Something went wrong with the sequence */
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Clearing the sequence failed with error code: %i.\n\r", status);
+#endif
+			lastFunctionError = status;
+			retval = ERR_COMMAND_FUNCTION_ERROR;
+		}
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the START_DIGITAL_OUTPUT_SEQUENCE command. The sequence is played to the outputs listed by the optional
+ * OUTPUT key, or to every added output, for the number of passes given by the optional NUMBER key (default 1, 0 to
+ * play until halted). The optional TIME key sets the length of a pass in microseconds. With SOURCE=ADC the sequence
+ * is armed and starts with the next analog input sampling instead of immediately.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_StartDigitalOutputSequence(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_START_DIGITAL_OUTPUT_SEQUENCE_PARAMS, START_DIGITAL_OUTPUT_SEQUENCE_PARAMS)) {
+		const int8_t outputIndex = GetIndexOfArgument(keys, PARAMETER_OUTPUT, count);
+		const int8_t numberIndex = GetIndexOfArgument(keys, PARAMETER_NUMBER, count);
+		const int8_t timeIndex = GetIndexOfArgument(keys, PARAMETER_TIME, count);
+		const int8_t sourceIndex = GetIndexOfArgument(keys, PARAMETER_SOURCE, count);
+		uint32_t repeats = 1U;
+		uint32_t cycle = 0U;
+		bool onSampling = false;
+		DigitalOutputMask_t mask = 0U;
+		if (numberIndex >= 0) {
+			repeats = (uint32_t) strtoul(values[numberIndex], NULL, 10);
+		}
+		if (timeIndex >= 0) {
+			cycle = (uint32_t) strtoul(values[timeIndex], NULL, 10);
+		}
+		if (sourceIndex >= 0) {
+			if (strcmp(values[sourceIndex], "ADC") == 0) {
+				onSampling = true;
+			} else if (strcmp(values[sourceIndex], "NOW") != 0) {
+				retval = ERR_COMMAND_BAD_PARAM;
+			}
+		}
+		if (outputIndex >= 0) {
+			/* Only the listed outputs are played to */
+			BuildDigitalOutputList(GetChannelListType(values[outputIndex]), values[outputIndex]);
+			for (uint_fast8_t i = 0U; i < NUM_DIGITAL_OUTPUTS; ++i) {
+				if (dOutputs[i] != NULL && dOutputs[i]->added == CHANNEL_ADDED) {
+					mask |= (1UL << dOutputs[i]->output);
+				}
+			}
+		} else {
+			/* Every added output is played to */
+			for (uint_fast8_t i = 0U; i < NUM_DIGITAL_OUTPUTS; ++i) {
+				Digital_Output_t* output = GetDigitalOutputByNumber(i);
+				if (output != NULL && output->added == CHANNEL_ADDED) {
+					mask |= (1UL << i);
+				}
+			}
+		}
+		if (retval == ERR_COMMAND_OK) {
+			Tekdaqc_Function_Error_t status = StartDigitalOutputSequence(mask, repeats, cycle, onSampling);
+			if (status != ERR_FUNCTION_OK) {
+				/* Something went wrong with the sequence */
+#ifdef COMMAND_DEBUG
+				printf("[Command Interpreter] Starting the sequence failed with error code: %i.\n\r", status);
+#endif
+				lastFunctionError = status;
+				retval = ERR_COMMAND_FUNCTION_ERROR;
+			}
+		}
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the BEGIN_BATCH command with the provided parameters. Until END_BATCH is received, the status and error
+ * replies of the commands which follow are suppressed and only their outcomes are tallied. It is refused within a
+ * macro, whose commands are batched already.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_BeginBatch(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	if (interpreter.macro_running == TRUE) {
+		/* The commands of a running macro are already batched */
+		return ERR_COMMAND_BAD_PARAM;
+	} else if (InputArgsCheck(keys, values, count, NUM_BEGIN_BATCH_PARAMS, BEGIN_BATCH_PARAMS)) {
+		interpreter.batch_active = TRUE;
+		interpreter.batch_count = 0U;
+		interpreter.batch_failures = 0U;
+		interpreter.batch_first_failure = 0U;
+		interpreter.batch_error[0] = '\0';
+		return ERR_COMMAND_OK;
+	} else {
+		return ERR_COMMAND_PARSE_ERROR;
+	}
+}
+
+/**
+ * Execute the END_BATCH command with the provided parameters, ending the current batch and writing a single reply
+ * summarizing the outcome of every command in it.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_EndBatch(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	if (interpreter.macro_running == TRUE) {
+		return ERR_COMMAND_BAD_PARAM;
+	} else if (InputArgsCheck(keys, values, count, NUM_END_BATCH_PARAMS, END_BATCH_PARAMS)) {
+		interpreter.batch_active = FALSE;
+		if (interpreter.batch_failures == 0U) {
+			snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "SUCCESS - Batch of %" PRIu16 " commands completed.",
+					interpreter.batch_count);
+			TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		} else {
+			snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "FAIL - %" PRIu16 " of %" PRIu16
+					" batched commands failed, first at command %" PRIu16 ": %s", interpreter.batch_failures, interpreter.batch_count, interpreter.batch_first_failure, interpreter.batch_error);
+			TelnetWriteErrorMessage(TOSTRING_BUFFER);
+		}
+		return ERR_COMMAND_OK;
+	} else {
+		return ERR_COMMAND_PARSE_ERROR;
+	}
+}
+
+/**
+ * Execute the SAVE_CONFIG command, saving the configuration of the added channels to the FLASH disk so that they are
+ * added again when the board starts.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SaveConfig(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (isADCSampling() == FALSE && isDISampling() == FALSE && isDOSampling() == FALSE) {
+		if (InputArgsCheck(keys, values, count, NUM_SAVE_CONFIG_PARAMS, SAVE_CONFIG_PARAMS)) {
+			Tekdaqc_Function_Error_t status = SaveChannelConfig();
+			if (status != ERR_FUNCTION_OK) {
+				/* Something went wrong with the configuration */
+#ifdef COMMAND_DEBUG
+				printf("[Command Interpreter] Saving the channel configuration failed with error code: %i.\n\r", status);
+#endif
+				lastFunctionError = status;
+				retval = ERR_COMMAND_FUNCTION_ERROR;
+			}
+		} else {
+			retval = ERR_COMMAND_BAD_PARAM;
+		}
+	} else {
+		retval = ERR_COMMAND_ADC_INVALID_OPERATION;
+	}
+	return retval;
+}
+
+/**
+ * Execute the LOAD_CONFIG command, adding the channels of the saved configuration. Channels which are already added are
+ * left as they are.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_LoadConfig(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (isADCSampling() == FALSE && isDISampling() == FALSE && isDOSampling() == FALSE) {
+		if (InputArgsCheck(keys, values, count, NUM_LOAD_CONFIG_PARAMS, LOAD_CONFIG_PARAMS)) {
+			Tekdaqc_Function_Error_t status = LoadChannelConfig();
+			if (status != ERR_FUNCTION_OK) {
+				/* Something went wrong with the configuration */
+#ifdef COMMAND_DEBUG
+				printf("[Command Interpreter] Loading the channel configuration failed with error code: %i.\n\r", status);
+#endif
+				lastFunctionError = status;
+				retval = ERR_COMMAND_FUNCTION_ERROR;
+			}
+		} else {
+			retval = ERR_COMMAND_BAD_PARAM;
+		}
+	} else {
+		retval = ERR_COMMAND_ADC_INVALID_OPERATION;
+	}
+	return retval;
+}
+
+/**
+ * Execute the SAVE_JOB command, saving the channel configuration together with a sampling job which is started when
+ * the board boots. The NUMBER, WINDOW, TIME and OVERFLOW keys are those of the SAMPLE command. The optional ADDRESS and PORT keys
+ * select a destination the job's data is published to as with SET_PUBLISH; without one the data is held in the sample
+ * buffers until a client connects.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SaveJob(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (isADCSampling() == FALSE && isDISampling() == FALSE && isDOSampling() == FALSE) {
+		if (InputArgsCheck(keys, values, count, NUM_SAVE_JOB_PARAMS, SAVE_JOB_PARAMS)) {
+			SamplingJob_t job = { 0, 0U, 0U, 0U, PUBLISH_PORT, ADC_OVERFLOW_DROP_NEWEST };
+			int8_t index = GetIndexOfArgument(keys, PARAMETER_NUMBER, count);
+			if (index >= 0) {
+				job.number = (int32_t) strtol(values[index], NULL, 10);
+			}
+			index = GetIndexOfArgument(keys, PARAMETER_WINDOW, count);
+			if (index >= 0) {
+				job.window = (uint32_t) strtoul(values[index], NULL, 10);
+			}
+			index = GetIndexOfArgument(keys, PARAMETER_TIME, count);
+			if (index >= 0) {
+				job.period = (uint32_t) strtoul(values[index], NULL, 10);
+			}
+			index = GetIndexOfArgument(keys, PARAMETER_OVERFLOW, count);
+			if (index >= 0) {
+				const ADC_OverflowPolicy_t overflow = ADC_Machine_StringToOverflowPolicy(values[index]);
+				if (overflow == NUM_ADC_OVERFLOW_POLICIES) {
+					retval = ERR_COMMAND_BAD_PARAM;
+				}
+				job.overflow = (uint16_t) overflow;
+			}
+			index = GetIndexOfArgument(keys, PARAMETER_PORT, count);
+			if (index >= 0) {
+				job.port = (uint16_t) strtoul(values[index], NULL, 10);
+			}
+			index = GetIndexOfArgument(keys, PARAMETER_ADDRESS, count);
+			if (index >= 0 && strcmp(values[index], ADDRESS_NONE_STRING) != 0) {
+				ip_addr_t address;
+				if ((ipaddr_aton(values[index], &address) != 0) && (job.port != 0U)) {
+					job.address = address.addr;
+				} else {
+					retval = ERR_COMMAND_BAD_PARAM;
+				}
+			}
+			if (retval == ERR_COMMAND_OK) {
+				Tekdaqc_Function_Error_t status = SaveChannelConfig();
+				if (status == ERR_FUNCTION_OK) {
+					status = SaveSamplingJob(&job);
+				}
+				if (status != ERR_FUNCTION_OK) {
+					/* Something went wrong with the configuration */
+#ifdef COMMAND_DEBUG
+					printf("[Command Interpreter] Saving the sampling job failed with error code: %i.\n\r", status);
+#endif
+					lastFunctionError = status;
+					retval = ERR_COMMAND_FUNCTION_ERROR;
+				}
+			}
+		} else {
+			retval = ERR_COMMAND_BAD_PARAM;
+		}
+	} else {
+		retval = ERR_COMMAND_ADC_INVALID_OPERATION;
+	}
+	return retval;
+}
+
+/**
+ * Execute the CLEAR_JOB command, clearing the saved sampling job so that the board waits for a SAMPLE command after it
+ * boots. The saved channel configuration is kept.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_ClearJob(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_CLEAR_JOB_PARAMS, CLEAR_JOB_PARAMS)) {
+		Tekdaqc_Function_Error_t status = ClearSamplingJob();
+		if (status != ERR_FUNCTION_OK) {
+			lastFunctionError = status;
+			retval = ERR_COMMAND_FUNCTION_ERROR;
+		}
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the GET_BOOT_TIMES command. Reports how long each stage of the last start up took and the total time from
+ * the start of the time base until the board was ready for commands.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_GetBootTimes(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_GET_BOOT_TIMES_PARAMS, GET_BOOT_TIMES_PARAMS)) {
+		for (uint_fast8_t i = 0U; i < NUM_BOOT_STAGES; ++i) {
+			snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Boot %s: %" PRIu32 " us",
+					BootTimes_StringFromStage((BootStage_t) i), BootTimes_Get((BootStage_t) i));
+			TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		}
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Boot TOTAL: %" PRIu32 " us", BootTimes_Total());
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the GET_NETWORK_STATS command, writing the network counters as status messages: the Ethernet receive and
+ * transmit drops, where growing counts mean frames arrive faster than the network receive task reads them or are sent
+ * faster than the DMA drains them, the transmit buffer fill of the Telnet session the command came on, and the number
+ * of times the link has gone down with the time from it last coming back to sample data flowing again. When the
+ * firmware is built with NETWORK_STATISTICS the lwIP link and TCP counters, including retransmissions, and the
+ * high-water marks of the heap and the pbuf and TCP pools follow.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_GetNetworkStats(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_GET_NETWORK_STATS_PARAMS, GET_NETWORK_STATS_PARAMS)) {
+		ethernetif_rx_stats_t stats;
+		ethernetif_get_rx_stats(&stats);
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Network RX BUFFER UNAVAILABLE: %" PRIu32,
+				(uint32_t) stats.buffer_unavailable);
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Network RX MISSED NO BUFFER: %" PRIu32,
+				(uint32_t) stats.missed_no_buffer);
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Network RX MISSED OVERFLOW: %" PRIu32,
+				(uint32_t) stats.missed_overflow);
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Network RX NO PBUF: %" PRIu32, (uint32_t) stats.no_pbuf);
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		ethernetif_tx_stats_t txStats;
+		ethernetif_get_tx_stats(&txStats);
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Network TX NO DESCRIPTOR: %" PRIu32,
+				(uint32_t) txStats.no_descriptor);
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		static const char* const CHECKSUM_OFFLOAD_STRINGS[] = { "SOFTWARE", "VERIFIED", "REPAIRED", "FAILED" };
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Network CHECKSUM OFFLOAD: %s",
+				CHECKSUM_OFFLOAD_STRINGS[ethernetif_get_checksum_offload()]);
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		SNTPClientStatus_t timeStatus;
+		SNTPClientGetStatus(&timeStatus);
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Network TIME SYNCHRONIZED: %s UPDATES: %" PRIu32
+				" OFFSET: %" PRIi32 " us DELAY: %" PRIu32 " us DRIFT: %" PRIi32 " ppb",
+				(timeStatus.synchronized == true) ? "TRUE" : "FALSE", timeStatus.updates, timeStatus.offset,
+				timeStatus.delay, timeStatus.drift);
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Network TELNET BUFFER USED: %" PRIu32 " PEAK: %" PRIu32
+				" OF: %" PRIu32, (uint32_t) TelnetGetBufferUsed(), (uint32_t) TelnetGetBufferPeak(),
+				(uint32_t) TELNET_TX_RING_SIZE);
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		uint32_t linkDowns = 0U;
+		uint32_t linkRecovery = 0U;
+		LwIP_GetLinkRecovery(&linkDowns, &linkRecovery);
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Network LINK DOWNS: %" PRIu32 " RECOVERY: %" PRIu32 " us",
+				linkDowns, linkRecovery);
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+#if LWIP_STATS
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Network LINK TX: %" PRIu32 " RX: %" PRIu32 " DROPPED: %"
+				PRIu32, (uint32_t) lwip_stats.link.xmit, (uint32_t) lwip_stats.link.recv, (uint32_t) lwip_stats.link.drop);
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Network TCP TX: %" PRIu32 " RX: %" PRIu32 " RETRANSMITTED: %"
+				PRIu32 " DROPPED: %" PRIu32 " MEMORY ERRORS: %" PRIu32, (uint32_t) lwip_stats.tcp.xmit,
+				(uint32_t) lwip_stats.tcp.recv, (uint32_t) lwip_stats.tcp.rexmit, (uint32_t) lwip_stats.tcp.drop,
+				(uint32_t) lwip_stats.tcp.memerr);
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		WriteNetworkMemoryStats("HEAP", &lwip_stats.mem);
+		WriteNetworkMemoryStats("PBUF POOL", &lwip_stats.memp[MEMP_PBUF_POOL]);
+		WriteNetworkMemoryStats("PBUF REF", &lwip_stats.memp[MEMP_PBUF]);
+		WriteNetworkMemoryStats("TCP SEG", &lwip_stats.memp[MEMP_TCP_SEG]);
+		WriteNetworkMemoryStats("TCP PCB", &lwip_stats.memp[MEMP_TCP_PCB]);
+#endif
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the SET_NO_DELAY command. The CONNECTION key selects the TELNET control connection or the DATA stream
+ * connection, and the STATE key turns no delay ON, sending small writes without waiting under Nagle's algorithm, or
+ * OFF, coalescing them. With no delay on, the Telnet connection also ACKs received commands at once. By default it is
+ * on for the Telnet connection and off for the data connection. The setting applies to the current connection and to
+ * those accepted later.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SetNoDelay(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	const int8_t connectionIndex = GetIndexOfArgument(keys, PARAMETER_CONNECTION, count);
+	const int8_t stateIndex = GetIndexOfArgument(keys, PARAMETER_STATE, count);
+	if ((connectionIndex >= 0) && (stateIndex >= 0)
+			&& InputArgsCheck(keys, values, count, NUM_SET_NO_DELAY_PARAMS, SET_NO_DELAY_PARAMS)) {
+		bool enable = false;
+		if (strcmp(values[stateIndex], STATE_ON_STRING) == 0) {
+			enable = true;
+		} else if (strcmp(values[stateIndex], STATE_OFF_STRING) != 0) {
+			retval = ERR_COMMAND_BAD_PARAM;
+		}
+		if (retval == ERR_COMMAND_OK) {
+			if (strcmp(values[connectionIndex], CONNECTION_TELNET_STRING) == 0) {
+				TelnetSetNoDelay(enable);
+			} else if (strcmp(values[connectionIndex], CONNECTION_DATA_STRING) == 0) {
+				DataServerSetNoDelay(enable);
+			} else {
+				retval = ERR_COMMAND_BAD_PARAM;
+			}
 		}
 	} else {
-		/* Command without arguments */
-		int length = strlen(interpreter.command_buffer);
-		if (length > (MAX_COMMANDPART_LENGTH - 1)) {
-			/* This is not a valid command */
 #ifdef COMMAND_DEBUG
-			printf("[Command Interpreter] Command was too long, ignoring.\n\r");
+		printf("[Command Interpreter] Provided arguments are not valid for setting no delay.\n\r");
 #endif
-			/* Cleanup */
-			ClearCommandBuffer();
-			return;
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the SET_SUBSCRIPTION command. The STATE key turns the delivery of sample data to the Telnet session the
+ * command was received on ON or OFF, so a client which only monitors status or sends occasional commands does not
+ * hold back the data of a streaming client. Every session is subscribed when it connects.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SetSubscription(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	const int8_t stateIndex = GetIndexOfArgument(keys, PARAMETER_STATE, count);
+	if ((stateIndex >= 0) && InputArgsCheck(keys, values, count, NUM_SET_SUBSCRIPTION_PARAMS, SET_SUBSCRIPTION_PARAMS)) {
+		if (strcmp(values[stateIndex], STATE_ON_STRING) == 0) {
+			TelnetSetSubscribed(true);
+		} else if (strcmp(values[stateIndex], STATE_OFF_STRING) == 0) {
+			TelnetSetSubscribed(false);
 		} else {
-			/* Its a valid command */
-			/* Copy the command */
-			strcpy(command, interpreter.command_buffer);
+			retval = ERR_COMMAND_BAD_PARAM;
+		}
+	} else {
 #ifdef COMMAND_DEBUG
-			printf("[Command Interpreter] Command: %s\n\r", command);
+		printf("[Command Interpreter] Provided arguments are not valid for setting the subscription.\n\r");
 #endif
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the SET_TIME_SERVER command. The VALUE key is the address of the SNTP server to synchronize sample
+ * timestamps with, kept across resets, or NONE to stop synchronizing.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SetTimeServer(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	int8_t index = GetIndexOfArgument(keys, PARAMETER_VALUE, count);
+	if ((index >= 0) && InputArgsCheck(keys, values, count, NUM_SET_TIME_SERVER_PARAMS, SET_TIME_SERVER_PARAMS)) {
+		bool valid = TRUE;
+		bool saved = FALSE;
+		if (strcmp(values[index], ADDRESS_NONE_STRING) == 0) {
+			saved = SNTPClientSetServer(NULL);
+		} else {
+			ip_addr_t server;
+			ip_addr_set_zero(&server);
+			if ((ipaddr_aton(values[index], &server) == 0) || ip_addr_isany(&server)) {
+				valid = FALSE;
+			} else {
+				saved = SNTPClientSetServer(&server);
+			}
+		}
+		if (valid == FALSE) {
+			retval = ERR_COMMAND_BAD_PARAM;
+		} else if (saved == FALSE) {
+			lastFunctionError = ERR_CONFIG_WRITE_FAILED;
+			retval = ERR_COMMAND_FUNCTION_ERROR;
 		}
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
 	}
-	/* Process the command */
-	ProcessCommand(command, raw_args, count);
+	return retval;
 }
 
 /**
- * Parse a command string to determine which command it is.
+ * Execute the SET_CAN_SYNC command. The VALUE key is MASTER to broadcast sampling and triggers over the CAN bus,
+ * SLAVE to follow them, or NONE. The role is kept across resets.
  *
- * @param command const char* C-String containing the command text.
- * @retval Command_t The determined command.
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Command_t ParseCommand(const char* command) {
-#ifdef COMMAND_DEBUG
-	printf("[Command Interpreter] Parsing command.\n\r");
-#endif
-	Command_t ret_command = COMMAND_LIST_ANALOG_INPUTS;
-	while (ret_command <= COMMAND_NONE) {
-		if (strcmp(command, COMMAND_STRINGS[ret_command]) == 0) {
-			break;
+static Tekdaqc_Command_Error_t Ex_SetCanSync(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	int8_t index = GetIndexOfArgument(keys, PARAMETER_VALUE, count);
+	if ((index >= 0) && InputArgsCheck(keys, values, count, NUM_SET_CAN_SYNC_PARAMS, SET_CAN_SYNC_PARAMS)) {
+		CAN_SyncRole_t role = NUM_CAN_SYNC_ROLES;
+		for (uint_fast8_t i = 0U; i < NUM_CAN_SYNC_ROLES; ++i) {
+			if (strcmp(values[index], CAN_SYNC_ROLE_STRINGS[i]) == 0) {
+				role = (CAN_SyncRole_t) i;
+			}
+		}
+		if (role == NUM_CAN_SYNC_ROLES) {
+			retval = ERR_COMMAND_BAD_PARAM;
+		} else if (Tekdaqc_CAN_SetSyncRole(role) == FALSE) {
+			lastFunctionError = ERR_CONFIG_WRITE_FAILED;
+			retval = ERR_COMMAND_FUNCTION_ERROR;
+		}
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the SET_CAN_STREAM command with the provided parameters. VALUE is the identifier of the CAN sample frames of
+ * the first physical input, in decimal or with a 0x prefix, or NONE to stop streaming. While streaming, analog samples
+ * are sent on the CAN bus instead of the command connection. Only allowed while the ADC is idle.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SetCanStream(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (isADCSampling() == FALSE) {
+		int8_t index = GetIndexOfArgument(keys, PARAMETER_VALUE, count);
+		if ((index >= 0) && InputArgsCheck(keys, values, count, NUM_SET_CAN_STREAM_PARAMS, SET_CAN_STREAM_PARAMS)) {
+			if (strcmp(values[index], ADDRESS_NONE_STRING) == 0) {
+				Tekdaqc_CAN_StreamStop();
+			} else {
+				char* end = NULL;
+				const uint32_t id = (uint32_t) strtoul(values[index], &end, 0);
+				if ((end == values[index]) || (*end != '\0') || (Tekdaqc_CAN_StreamStart(id) == FALSE)) {
+					retval = ERR_COMMAND_BAD_PARAM;
+				}
+			}
 		} else {
-			++ret_command;
+			retval = ERR_COMMAND_BAD_PARAM;
 		}
+	} else {
+		retval = ERR_COMMAND_ADC_INVALID_OPERATION;
 	}
+	return retval;
+}
+
+/**
+ * Execute the SET_ANALOG_INPUT_OVERSAMPLING command. The INPUT key selects the analog input and the VALUE key the
+ * number of back to back conversions averaged into each of its samples, 1 to turn oversampling off. Sample counts
+ * given to the sampling commands refer to the averaged samples. Pairing a higher input rate with oversampling trades
+ * data rate for resolution without any host involvement.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SetAnalogInputOversampling(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (isADCSampling() == FALSE) {
+		if (InputArgsCheck(keys, values, count, NUM_SET_ANALOG_INPUT_OVERSAMPLING_PARAMS, SET_ANALOG_INPUT_OVERSAMPLING_PARAMS)) {
+			Tekdaqc_Function_Error_t status = SetAnalogInputOversampling(keys, values, count);
+			if (status != ERR_FUNCTION_OK) {
+				/* Something went wrong with setting the oversampling */
 #ifdef COMMAND_DEBUG
-	if (ret_command <= COMMAND_NONE) {
-		printf("[Command Interpreter] Determined command to be: %s\n\r", COMMAND_STRINGS[ret_command]);
+				printf("[Command Interpreter] Setting analog input oversampling failed with error code: %s.\n\r",
+						Tekdaqc_FunctionError_ToString(status));
+#endif
+				lastFunctionError = status;
+				retval = ERR_COMMAND_FUNCTION_ERROR;
+			}
+		} else {
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Provided arguments are not valid for setting analog input oversampling.\n\r");
+#endif
+			retval = ERR_COMMAND_BAD_PARAM;
+		}
 	} else {
-		printf("[Command Interpreter] Unable to determine command.\n\r");
+		retval = ERR_COMMAND_ADC_INVALID_OPERATION;
 	}
-#endif
-	return ret_command;
+	return retval;
 }
 
 /**
- * Evaluate the specified Tekdaqc_Command_Error_t and handle any errors appropriately.
+ * Execute the GET_SCAN_TIME command, writing the predicted timing of a scan of the added analog inputs at their current
+ * settings as status messages: the time spent multiplexing and converting the inputs, the time spent refreshing the
+ * cold junction under the current refresh policy, the total cycle time, the rate every input reports samples at and
+ * the samples reported per second over all inputs. The prediction uses the settling times of the ADC and the external
+ * multiplexer delay, so the measured rates may be lower if the connection cannot keep up.
  *
- * @param error Tekdaqc_Command_Error_t The command error.
- * @retval none
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static void ProcessCommandError(const Tekdaqc_Command_Error_t error) {
-	const char* error_string = Tekdaqc_CommandError_ToString(error);
-	bool isErrored = TRUE;
-	switch (error) {
-	case ERR_COMMAND_OK:
-		snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "SUCCESS - %s", error_string);
-		isErrored = FALSE;
-		break;
-	case ERR_COMMAND_BAD_PARAM:
-		snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "FAIL - %s.", error_string);
-		break;
-	case ERR_COMMAND_BAD_COMMAND:
-		snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "FAIL - %s", error_string);
-		break;
-	case ERR_COMMAND_PARSE_ERROR:
-		snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "FAIL - %s", error_string);
-		break;
-	case ERR_COMMAND_FUNCTION_ERROR:
-		snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "FAIL - %s:\n\r\t", error_string);
-		ProcessFunctionError();
-		break;
-	case ERR_COMMAND_UNKNOWN_ERROR:
-		snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "FAIL - %s", error_string);
-		break;
-	case ERR_COMMAND_ADC_INVALID_OPERATION:
-		snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "FAIL - %s", error_string);
-		break;
-	case ERR_COMMAND_DI_INVALID_OPERATION:
-		snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "FAIL - %s", error_string);
-		break;
-	case ERR_COMMAND_DO_INVALID_OPERATION:
-		snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "FAIL - %s", error_string);
-		break;
-	default:
-		snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "ERROR - %s", error_string);
-		break;
+static Tekdaqc_Command_Error_t Ex_GetScanTime(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_GET_SCAN_TIME_PARAMS, GET_SCAN_TIME_PARAMS)) {
+		AnalogScanPrediction_t prediction;
+		PredictAnalogScan(&prediction);
+		/* Rates are reported in thousandths so slow scans do not round to zero */
+		const uint32_t channelRate = (uint32_t) ((prediction.channelRate * 1000.0f) + 0.5f);
+		const uint32_t throughput = (uint32_t) ((prediction.throughput * 1000.0f) + 0.5f);
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Scan INPUTS: %" PRIu8 " EXTERNAL: %" PRIu8,
+				prediction.inputs, prediction.externalInputs);
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Scan CONVERSION: %" PRIu32 " us COLD JUNCTION: %" PRIu32
+				" us CYCLE: %" PRIu32 " us", (uint32_t) ((prediction.conversionTime * 1000.0f) + 0.5f),
+				(uint32_t) ((prediction.coldJunctionTime * 1000.0f) + 0.5f),
+				(uint32_t) ((prediction.scanTime * 1000.0f) + 0.5f));
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Scan CHANNEL RATE: %" PRIu32 ".%03" PRIu32
+				" SPS THROUGHPUT: %" PRIu32 ".%03" PRIu32 " SPS", channelRate / 1000U, channelRate % 1000U,
+				throughput / 1000U, throughput % 1000U);
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
 	}
-	if (isErrored == TRUE) {
-		TelnetWriteErrorMessage(TOSTRING_BUFFER);
+	return retval;
+}
+
+/**
+ * Execute the SET_BACKGROUND_CALIBRATION command. The optional TIME key sets the interval in milliseconds and the
+ * optional TEMPERATURE key the board temperature change in degrees Celsius after which an offset calibration is made
+ * between two scans while sampling. Keys which are left out, or 0, are not used, so giving neither turns background
+ * calibration off. Each calibration is reported in the stream with a status message.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SetBackgroundCalibration(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_SET_BACKGROUND_CALIBRATION_PARAMS, SET_BACKGROUND_CALIBRATION_PARAMS)) {
+		uint32_t interval = 0U;
+		float temperature = 0.0f;
+		int8_t index = GetIndexOfArgument(keys, PARAMETER_TIME, count);
+		if (index >= 0) {
+			interval = ((uint32_t) strtoul(values[index], NULL, 10)) * 1000U; /* Convert to microseconds */
+		}
+		index = GetIndexOfArgument(keys, PARAMETER_TEMPERATURE, count);
+		if (index >= 0) {
+			temperature = strtof(values[index], NULL);
+			if (temperature < 0.0f) {
+				retval = ERR_COMMAND_BAD_PARAM;
+			}
+		}
+		if (retval == ERR_COMMAND_OK) {
+			ADC_Machine_SetBackgroundCalibration(interval, temperature);
+		}
 	} else {
-		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		retval = ERR_COMMAND_BAD_PARAM;
 	}
+	return retval;
 }
 
 /**
- * Evaluate the specified Tekdaqc_Function_Error_t and handle any errors appropriately.
+ * Execute the SET_ANALOG_INPUT_THERMOCOUPLE command. The INPUT key selects the external analog input and the TYPE key
+ * one of NONE, J, K or T. A linearized input reports its temperature in milli-degrees Celsius, compensated for the
+ * board temperature, in place of ADC counts.
  *
- * @param error Tekdaqc_Function_Error_t The command error.
- * @retval none
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static void ProcessFunctionError(void) {
-	snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "Function Error: %s", Tekdaqc_FunctionError_ToString(lastFunctionError));
+static Tekdaqc_Command_Error_t Ex_SetAnalogInputThermocouple(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (isADCSampling() == FALSE) {
+		if (InputArgsCheck(keys, values, count, NUM_SET_ANALOG_INPUT_THERMOCOUPLE_PARAMS, SET_ANALOG_INPUT_THERMOCOUPLE_PARAMS)) {
+			Tekdaqc_Function_Error_t status = SetAnalogInputThermocouple(keys, values, count);
+			if (status != ERR_FUNCTION_OK) {
+				/* Something went wrong with setting the thermocouple */
+#ifdef COMMAND_DEBUG
+				printf("[Command Interpreter] Setting an analog input thermocouple failed with error code: %s.\n\r",
+						Tekdaqc_FunctionError_ToString(status));
+#endif
+				lastFunctionError = status;
+				retval = ERR_COMMAND_FUNCTION_ERROR;
+			}
+		} else {
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Provided arguments are not valid for setting an analog input thermocouple.\n\r");
+#endif
+			retval = ERR_COMMAND_BAD_PARAM;
+		}
+	} else {
+		retval = ERR_COMMAND_ADC_INVALID_OPERATION;
+	}
+	return retval;
 }
 
 /**
- * Parse the raw key/value strings to determine the specific key/value parameters.
+ * Execute the SET_ANALOG_INPUT_SETTLE command. The INPUT key selects the external analog input and the TIME key the
+ * microseconds it is given to settle after the external multiplexer switches to it. The scan predictions of
+ * GET_SCAN_TIME and the BANDWIDTH key of SAMPLE account for each input's settle time.
  *
- * @param raw_args char[][] Array of C-Strings containing the raw key/value pairs.
- * @param keys char[][] Array of C-Strings to store the parsed keys in.
- * @param values char[][] Array of C-Strings to store the parsed values in.
- * @param count uint8_t The number of arguments passed.
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static void ParseKeyValuePairs(char raw_args[][MAX_COMMANDPART_LENGTH], char keys[][MAX_COMMANDPART_LENGTH],
-		char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
-	char* raw;
-	char temp[MAX_COMMANDPART_LENGTH];
-	for (int i = 0; i < count; ++i) {
-		raw = raw_args[i];
-		if (strncmp(raw, KEY_VALUE_PAIR_FLAG, 2) == 0) {
-			/* Properly formatted command */
-			strcpy(temp, (raw + 2)); /* Offset for the first two characters */
-			raw = strtok(temp, KEY_VALUE_PAIR_DELIMETER);
-			ToUpperCase(raw);
-			strcpy(keys[i], raw);
-			raw = strtok(NULL, KEY_VALUE_PAIR_DELIMETER);
-			if (raw != NULL ) {
-				ToUpperCase(raw);
-				strcpy(values[i], raw);
-			} else {
-				strcpy(values[i], "");
+static Tekdaqc_Command_Error_t Ex_SetAnalogInputSettle(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (isADCSampling() == FALSE) {
+		if (InputArgsCheck(keys, values, count, NUM_SET_ANALOG_INPUT_SETTLE_PARAMS, SET_ANALOG_INPUT_SETTLE_PARAMS)) {
+			Tekdaqc_Function_Error_t status = SetAnalogInputSettleTime(keys, values, count);
+			if (status != ERR_FUNCTION_OK) {
+				/* Something went wrong with setting the settle time */
+#ifdef COMMAND_DEBUG
+				printf("[Command Interpreter] Setting an analog input settle time failed with error code: %s.\n\r",
+						Tekdaqc_FunctionError_ToString(status));
+#endif
+				lastFunctionError = status;
+				retval = ERR_COMMAND_FUNCTION_ERROR;
 			}
 		} else {
-			/* Not a properly formatted command */
 #ifdef COMMAND_DEBUG
-			printf("[Command Interpreter] Key/value pair %i (%s) was not properly formatted.\n\r", i, raw);
+			printf("[Command Interpreter] Provided arguments are not valid for setting an analog input settle time.\n\r");
 #endif
+			retval = ERR_COMMAND_BAD_PARAM;
 		}
+	} else {
+		retval = ERR_COMMAND_ADC_INVALID_OPERATION;
 	}
+	return retval;
 }
 
 /**
- * Evaluate the input arguments to determine if they are properly formatted.
+ * Execute the SET_ANALOG_INPUT_PAIR command. The INPUT key selects the differential analog input and the POSITIVE and
+ * NEGATIVE keys the ADC inputs of its pair, which are measured against each other in a single conversion.
  *
- * @param keys char[][] Array of C-Strings containing the parameter keys.
- * @param values[][] Array of C-Strings containing the parameter values.
- * @param count uint8_t The number of parameters provided.
- * @param num_params uint8_t The total number of parameters associated with the command.
- * @retval bool True if the check passes.
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static bool InputArgsCheck(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count, uint8_t num_params,
-		const char** params) {
-	if (count > num_params) {
-		return false;
-	}
-	int idx = 0;
-	bool valid = false;
-	for (int i = 0; i < count; ++i) {
-		idx = 0;
-		valid = false;
-		while (idx < num_params) {
-			if (strcmp(keys[i], params[idx++]) == 0) {
-				valid = true;
-				break;
+static Tekdaqc_Command_Error_t Ex_SetAnalogInputPair(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (isADCSampling() == FALSE) {
+		if (InputArgsCheck(keys, values, count, NUM_SET_ANALOG_INPUT_PAIR_PARAMS, SET_ANALOG_INPUT_PAIR_PARAMS)) {
+			Tekdaqc_Function_Error_t status = SetAnalogInputPair(keys, values, count);
+			if (status != ERR_FUNCTION_OK) {
+				/* Something went wrong with setting the pair */
+#ifdef COMMAND_DEBUG
+				printf("[Command Interpreter] Setting an analog input pair failed with error code: %s.\n\r",
+						Tekdaqc_FunctionError_ToString(status));
+#endif
+				lastFunctionError = status;
+				retval = ERR_COMMAND_FUNCTION_ERROR;
 			}
+		} else {
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Provided arguments are not valid for setting an analog input pair.\n\r");
+#endif
+			retval = ERR_COMMAND_BAD_PARAM;
 		}
-		if (valid == false) {
-			/* This is a bad key */
-			return false;
-		}
+	} else {
+		retval = ERR_COMMAND_ADC_INVALID_OPERATION;
 	}
-	return true;
+	return retval;
 }
 
 /**
- * Determine which type of channel list was provided.
+ * Execute the GET_TASK_STATS command. Reports, for each task supervised on behalf of the watchdog, its timeout, the
+ * longest single run it has taken and how many runs overran the timeout, followed by the fraction of the time since
+ * start up the scheduler has slept for lack of work and which task stalled or starved before the last watchdog
+ * reset, if one did.
  *
- * @param arg char* C-String containing the channel list.
- * @retval Channel_List_t The type of channel list specified.
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Channel_List_t GetChannelListType(char* arg) {
-	if (strcmp(arg, ALL_CHANNELS_STRING) == 0) {
-		return ALL_CHANNELS;
-	} else if (strchr(arg, SET_DELIMETER) != NULL ) {
-		return CHANNEL_SET;
-	} else if (strchr(arg, RANGE_DELIMETER) != NULL ) {
-		return CHANNEL_RANGE;
+static Tekdaqc_Command_Error_t Ex_GetTaskStats(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_GET_TASK_STATS_PARAMS, GET_TASK_STATS_PARAMS)) {
+		SupervisorStatistics_t stats;
+		for (uint_fast8_t i = 0U; i < SCHEDULER_MAX_TASKS; ++i) {
+			if (Scheduler_GetStatistics(i, &stats) == true) {
+				snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER),
+						"Task %s: Timeout: %" PRIu32 " us, Longest: %" PRIu32 " us, Overruns: %" PRIu32, stats.name,
+						stats.timeout, stats.longest, stats.overruns);
+				TelnetWriteStatusMessage(TOSTRING_BUFFER);
+			}
+		}
+		const uint64_t uptime = GetLocalTime();
+		const uint32_t idle = (uptime > 0U) ? (uint32_t) ((Scheduler_GetIdleTime() * 1000U) / uptime) : 0U;
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Idle: %" PRIu32 ".%" PRIu32 " %%", idle / 10U, idle % 10U);
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		const char* name;
+		const SupervisorCause_t cause = Scheduler_GetResetRecord(&name);
+		if (cause != SUPERVISOR_NO_RECORD) {
+			snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Watchdog reset: Task %s %s",
+					(name != NULL) ? name : "UNKNOWN", Scheduler_StringFromCause(cause));
+		} else {
+			snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Watchdog reset: NONE");
+		}
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
 	} else {
-		return SINGLE_CHANNEL;
+		retval = ERR_COMMAND_BAD_PARAM;
 	}
+	return retval;
 }
 
 /**
- * Build the list of analog inputs which are to be sampled.
+ * Execute the GET_CRASH_RECORD command. Reports the cause of the last reset and, if the run before it crashed, the
+ * fault, the registers captured by the fault handler and the state of the firmware at the last snapshot before the
+ * crash, followed by the task record kept by the watchdog supervisor.
  *
- * @param list_type Channel_List_t The type of list provided in the parameter.
- * @param param char* C-String containing the inputs to use.
- * @retval none
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static void BuildAnalogInputList(Channel_List_t list_type, char* param) {
-	uint8_t count = 0U;
-	char* ptr = NULL;
-	int8_t channel = -1;
-	long int value = 0L;
-	char* str = NULL;
-	uint8_t start = 0U;
-	uint8_t end = 0U;
-	uint8_t value1 = 0U;
-	uint8_t value2 = 0U;
-
-	for (uint_fast8_t i = 0; i < NUM_ANALOG_INPUTS; ++i) {
-		aInputs[i] = NULL; /* NULL them all initially */
-	}
-
-	switch (list_type) {
-	case SINGLE_CHANNEL: /* SINGLE_CHANNEL */
-		channel = (int8_t) strtol(param, NULL, 10);
-		if (channel < 0 || channel > NUM_ANALOG_INPUTS) {
-			/* Input number out of range */
-#ifdef COMMAND_DEBUG
-			printf("[Command Interpreter] The requested input number is out of range.\n\r");
-#endif
-			break;
-		}
-		aInputs[0] = GetAnalogInputByNumber(channel);
-		break;
-	case CHANNEL_SET: /* CHANNEL_SET */
-		value = strtol(param, &ptr, 10);
-		while (value != 0L) {
-			++count;
-			if (*ptr == SET_DELIMETER) {
-				str = ptr + 1;
-			}
-			value = strtol(str, &ptr, 10);
-		}
-		value = strtol(param, &ptr, 10);
-		for (int i = 0; i < count; ++i) {
-			if (*ptr == SET_DELIMETER) {
-				str = ptr + 1;
-			}
-			aInputs[i] = GetAnalogInputByNumber(strtol(str, &ptr, 10));
-		}
-		break;
-	case CHANNEL_RANGE: /* INPUT_RANGE */
-		start = 0U;
-		end = 0U;
-		value1 = (uint8_t) strtol(param, &ptr, 10); /* We know these can potentially loose data...it would be invalid anyway */
-		value2 = (uint8_t) strtol((ptr + 1), NULL, 10);
-		if (value1 != 0L) {
-			start = value1;
-			if (value2 != 0L) {
-				end = value2;
-			} else {
-				end = NUM_ANALOG_INPUTS;
+static Tekdaqc_Command_Error_t Ex_GetCrashRecord(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_GET_CRASH_RECORD_PARAMS, GET_CRASH_RECORD_PARAMS)) {
+		const CrashRecord_t* record = CrashRecord_GetLast();
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Reset cause: %s, Crash cause: %s",
+				CrashRecord_StringFromResetCause(CrashRecord_GetResetCause()),
+				CrashRecord_StringFromCrashCause((CrashCause_t) record->cause));
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		if (record->cause != CRASH_NONE) {
+			if (record->cause != CRASH_WATCHDOG) {
+				snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER),
+						"PC: 0x%08" PRIX32 ", LR: 0x%08" PRIX32 ", PSR: 0x%08" PRIX32 ", Time: %" PRIu64, record->pc,
+						record->lr, record->psr, record->crashTime);
+				TelnetWriteStatusMessage(TOSTRING_BUFFER);
+				snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER),
+						"CFSR: 0x%08" PRIX32 ", HFSR: 0x%08" PRIX32 ", BFAR: 0x%08" PRIX32 ", MMFAR: 0x%08" PRIX32,
+						record->cfsr, record->hfsr, record->bfar, record->mmfar);
+				TelnetWriteStatusMessage(TOSTRING_BUFFER);
 			}
-		} else {
-			start = 0U;
-		}
-		count = end - start + 1;
-		for (int i = 0; i < count; ++i) {
-			aInputs[i] = GetAnalogInputByNumber(start + i); /* Some of these may be NULL, this is OK. */
+			snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER),
+					"Snapshot: %" PRIu64 ", ADC State: %" PRIu32 ", Sampling:%s%s%s, Buffered: %" PRIu32 ", Overruns: %"
+					PRIu32 ", Telnet: %" PRIu32 ", Longest Loop: %" PRIu32 " us", record->snapshotTime,
+					record->adcState, ((record->sampling & CRASH_SAMPLING_ADC) != 0U) ? " ADC" : "",
+					((record->sampling & CRASH_SAMPLING_DI) != 0U) ? " DI" : "",
+					((record->sampling & CRASH_SAMPLING_DO) != 0U) ? " DO" : "", record->bufferedSamples,
+					record->adcOverruns, record->telnetBuffered, record->longestLoop);
+			TelnetWriteStatusMessage(TOSTRING_BUFFER);
 		}
-		break;
-	case ALL_CHANNELS: /* ALL_CHANNELS */
-		count = NUM_ANALOG_INPUTS;
-		for (int i = 0; i < count; ++i) {
-			aInputs[i] = GetAnalogInputByNumber(i); /* Some of these may be NULL, this is OK. */
+		const char* name;
+		const SupervisorCause_t cause = Scheduler_GetResetRecord(&name);
+		if (cause != SUPERVISOR_NO_RECORD) {
+			snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Watchdog reset: Task %s %s",
+					(name != NULL) ? name : "UNKNOWN", Scheduler_StringFromCause(cause));
+			TelnetWriteStatusMessage(TOSTRING_BUFFER);
 		}
-		break;
-	default:
-#ifdef COMMAND_DEBUG
-		printf("[Command Interpreter] The specified input range is invalid.\n\r");
-#endif
-		break;
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
 	}
+	return retval;
 }
 
 /**
- * Build the list of digital inputs which are to be sampled.
+ * Execute the GET_UPGRADE_STATUS command. Reports the state of the upgrade staging sectors, the progress of the image
+ * being received or staged and, if the last reset installed an image, its length and CRC.
  *
- * @param list_type Channel_List_t The type of list provided in the parameter.
- * @param param char* C-String containing the inputs to use.
- * @retval none
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static void BuildDigitalInputList(Channel_List_t list_type, char* param) {
-	uint8_t count = 0U;
-	char* ptr = NULL;
-	int8_t channel = -1;
-	long int value = 0L;
-	char* str = NULL;
-	uint8_t start = 0U;
-	uint8_t end = 0U;
-	uint8_t value1 = 0U;
-	uint8_t value2 = 0U;
-
-	for (uint_fast8_t i = 0U; i < NUM_DIGITAL_INPUTS; ++i) {
-		dInputs[i] = NULL; /* NULL them all initially */
+static Tekdaqc_Command_Error_t Ex_GetUpgradeStatus(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_GET_UPGRADE_STATUS_PARAMS, GET_UPGRADE_STATUS_PARAMS)) {
+		uint32_t received;
+		uint32_t length;
+		uint32_t crc;
+		Upgrade_GetProgress(&received, &length, &crc);
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER),
+				"Upgrade: %s, Received: %" PRIu32 " of %" PRIu32 " bytes, CRC: 0x%08" PRIX32,
+				Upgrade_StringFromState(Upgrade_GetState()), received, length, crc);
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		if (Upgrade_GetInstalled(&length, &crc) == true) {
+			snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Installed: %" PRIu32 " bytes, CRC: 0x%08" PRIX32, length,
+					crc);
+			TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		}
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
 	}
+	return retval;
+}
 
-	switch (list_type) {
-	case SINGLE_CHANNEL: /* SINGLE_CHANNEL */
-		channel = (int8_t) strtol(param, NULL, 10);
-		if (channel < 0 || channel > NUM_DIGITAL_INPUTS) {
-			/* Input number out of range */
-#ifdef COMMAND_DEBUG
-			printf("[Command Interpreter] The requested input number is out of range.\n\r");
-#endif
-			break;
-		}
-		dInputs[0] = GetDigitalInputByNumber(channel);
-		break; /* END SINGLE_INPUT */
-	case CHANNEL_SET: /* CHANNEL_SET */
-		value = 0L;
-		str = param;
-		value = strtol(str, &ptr, 10);
-		while (value != 0L) {
-			++count;
-			if (*ptr == SET_DELIMETER) {
-				str = ptr + 1;
-			}
-			value = strtol(str, &ptr, 10);
-		}
-		str = param;
-		value = strtol(str, &ptr, 10);
-		for (int i = 0; i < count; ++i) {
-			if (*ptr == SET_DELIMETER) {
-				str = ptr + 1;
-			}
-			dInputs[i] = GetDigitalInputByNumber(strtol(str, &ptr, 10));
-		}
-		break;
-	case CHANNEL_RANGE: /* INPUT_RANGE */
-		start = 0U;
-		end = 0U;
-		value1 = strtol(param, &ptr, 10); /* We know these can potentially loose data...it would be invalid anyway */
-		value2 = strtol((ptr + 1), NULL, 10);
-		if (value1 != 0L) {
-			start = (uint8_t) value1;
-			if (value2 != 0L) {
-				end = (uint8_t) value2;
-			} else {
-				end = NUM_DIGITAL_INPUTS;
+/**
+ * Execute the APPLY_UPGRADE command. Resets the board to install the staged firmware image, once any queued EEPROM
+ * writes have been programmed. Fails if no image is staged.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_ApplyUpgrade(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_APPLY_UPGRADE_PARAMS, APPLY_UPGRADE_PARAMS)) {
+		if (Upgrade_GetState() == UPGRADE_STAGED) {
+			while (EE_IsBusy() == TRUE) {
+				EE_Service(TRUE);
 			}
+			/* Close the telnet connection */
+			TelnetClose();
+			/* Reset the processor, which installs the image */
+			NVIC_SystemReset();
 		} else {
-			start = 0U;
-		}
-		count = end - start + 1U;
-		for (int i = 0; i < count; ++i) {
-			dInputs[i] = GetDigitalInputByNumber(start + i); /* Some of these may be NULL, this is OK. */
-		}
-		break; /* END INPUT_RANGE */
-	case ALL_CHANNELS: /* ALL_CHANNELS */
-		count = NUM_DIGITAL_INPUTS;
-		for (int i = 0; i < count; ++i) {
-			dInputs[i] = GetDigitalInputByNumber(i); /* Some of these may be NULL, this is OK. */
-		}
-		break; /* END ALL_CHANNELS */
-	default:
-#ifdef COMMAND_DEBUG
-		printf("[Command Interpreter] The specified input range is invalid.\n\r");
-#endif
-		break;
+			lastFunctionError = ERR_UPGRADE_NOT_STAGED;
+			retval = ERR_COMMAND_FUNCTION_ERROR;
+		}
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
 	}
+	return retval;
 }
 
 /**
- * Build the list of digital outputs which are to be sampled.
+ * Execute the DISCARD_UPGRADE command. Abandons the staged firmware image, so that the next reset leaves the running
+ * firmware in place. The staging sectors are erased the next time the inputs are idle. Fails if no image is staged.
  *
- * @param list_type Channel_List_t The type of list provided in the parameter.
- * @param param char* C-String containing the outputs to use.
- * @retval none
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static void BuildDigitalOutputList(Channel_List_t list_type, char* param) {
-	uint8_t count = 0U;
-	char* ptr = NULL;
-	int8_t channel = -1;
-	long int value = 0L;
-	char* str = NULL;
-	uint8_t start = 0U;
-	uint8_t end = 0U;
-	uint8_t value1 = 0U;
-	uint8_t value2 = 0U;
-
-	for (uint_fast8_t i = 0; i < NUM_DIGITAL_OUTPUTS; ++i) {
-		dOutputs[i] = NULL; /* NULL them all initially */
-	}
-
-	switch (list_type) {
-	case SINGLE_CHANNEL:
-		channel = (int8_t) strtol(param, NULL, 10);
-		if (channel < 0 || channel > NUM_DIGITAL_OUTPUTS) {
-			/* Input number out of range */
-#ifdef COMMAND_DEBUG
-			printf("[Command Interpreter] The requested input number is out of range.\n\r");
-#endif
-			break;
-		}
-		dOutputs[0] = GetDigitalOutputByNumber(channel);
-		break;
-	case CHANNEL_SET:
-		value = 0L;
-		str = param;
-		value = strtol(str, &ptr, 10);
-		while (value != 0L) {
-			++count;
-			if (*ptr == SET_DELIMETER) {
-				str = ptr + 1;
-			}
-			value = strtol(str, &ptr, 10);
-		}
-		str = param;
-		value = strtol(str, &ptr, 10);
-		for (int i = 0; i < count; ++i) {
-			if (*ptr == SET_DELIMETER) {
-				str = ptr + 1;
-			}
-			dOutputs[i] = GetDigitalOutputByNumber(strtol(str, &ptr, 10));
-		}
-		break;
-	case CHANNEL_RANGE:
-		start = 0;
-		end = 0;
-		value1 = strtol(param, &ptr, 10);
-		value2 = strtol((ptr + 1), NULL, 10);
-		if (value1 != 0L) {
-			start = (uint8_t) value1;
-			if (value2 != 0L) {
-				end = (uint8_t) value2;
-			} else {
-				end = NUM_DIGITAL_OUTPUTS;
-			}
+static Tekdaqc_Command_Error_t Ex_DiscardUpgrade(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_DISCARD_UPGRADE_PARAMS, DISCARD_UPGRADE_PARAMS)) {
+		if (Upgrade_GetState() == UPGRADE_STAGED) {
+			Upgrade_Abort();
 		} else {
-			start = 0;
-		}
-		count = end - start + 1;
-		for (int i = 0; i < count; ++i) {
-			dOutputs[i] = GetDigitalOutputByNumber(start + i); /* Some of these may be NULL, this is OK. */
-		}
-		break;
-	case ALL_CHANNELS:
-		count = NUM_DIGITAL_OUTPUTS;
-		for (int i = 0; i < count; ++i) {
-			dOutputs[i] = GetDigitalOutputByNumber(i); /* Some of these may be NULL, this is OK. */
+			lastFunctionError = ERR_UPGRADE_NOT_STAGED;
+			retval = ERR_COMMAND_FUNCTION_ERROR;
 		}
-		break;
-	default:
-#ifdef COMMAND_DEBUG
-		printf("[Command Interpreter] The specified input range is invalid.\n\r");
-#endif
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
 	}
+	return retval;
 }
 
 /**
- * Determines if the character provided is a valid text character for commands.
+ * Execute the STATS command. Writes a report of the runtime statistics over the time since the previous report,
+ * see Statistics_Report(). The optional TIME key sets the number of milliseconds between further reports written
+ * periodically until the client disconnects, with 0 stopping them.
  *
- * @param character const char The character to check.
- * @retval bool True if the character is valid.
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static bool isValidTextCharacter(const char character) {
-	return (character == 0x5F || (character >= 0x41 && character <= 0x5A) || (character >= 0x61 && character <= 0x7A)) ? true : false;
+static Tekdaqc_Command_Error_t Ex_Stats(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_STATS_PARAMS, STATS_PARAMS)) {
+		Statistics_Report();
+		int8_t index = GetIndexOfArgument(keys, PARAMETER_TIME, count);
+		if (index >= 0) {
+			Statistics_SetPeriod(((uint32_t) strtoul(values[index], NULL, 10)) * 1000U); /* Convert to microseconds */
+		}
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
 }
 
 /**
- * Converts the provided C-String into all upper case characters, in place.
+ * Execute the GET_MEMORY_USAGE command. Reports the bytes of flash taken by the image, the bytes of each RAM
+ * section, the heap given out by the C library and the deepest the stack has reached since start up against the room
+ * left for it, followed by the sizes of the buffers most often traded against each other. Together with the pool
+ * peaks of GET_NETWORK_STATS these show how much room each buffer may be given.
  *
- * @param string char* The C-String to convert.
- * @retval none
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static void ToUpperCase(char* string) {
-	int i = 0;
-	char character;
-	while (string[i]) {
-		character = string[i];
-		if (isValidTextCharacter(character)) {
-			if ((character >= 0x41 && character <= 0x5A) == false) {
-				if (character != 0x5F) { /* Don't treat underscores */
-					string[i] = (character - 0x20);
-				}
-			}
-		}
-		++i;
+static Tekdaqc_Command_Error_t Ex_GetMemoryUsage(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_GET_MEMORY_USAGE_PARAMS, GET_MEMORY_USAGE_PARAMS)) {
+		MemoryUsage_t usage;
+		MemoryUsage_Get(&usage);
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Memory FLASH: %" PRIu32 " DATA: %" PRIu32 " BSS: %" PRIu32
+				" CCM: %" PRIu32 " SRAM2: %" PRIu32 " HEAP: %" PRIu32, usage.flash, usage.data, usage.bss, usage.ccm,
+				usage.sram2, usage.heap);
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Memory STACK PEAK: %" PRIu32 " OF: %" PRIu32,
+				usage.stackPeak, usage.stackSize);
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Memory LWIP HEAP: %" PRIu32 " PBUF POOL: %" PRIu32
+				" TELNET BUFFER: %" PRIu32, (uint32_t) MEM_SIZE, (uint32_t) (PBUF_POOL_SIZE * PBUF_POOL_BUFSIZE),
+				(uint32_t) TELNET_TX_RING_SIZE);
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
 	}
+	return retval;
 }
 
 /**
- * Executes the specified command with the specified parameters.
+ * Execute the SET_OUTPUT_BUDGET command. The TIME key sets the longest time in milliseconds each pass of the main loop
+ * may spend writing out analog samples. Within it, the time taken follows the load of the rest of the loop.
  *
- * @param command Command_t The command to execute.
- * @param keys char[][] Array of C-String parameter keys for the command.
- * @param values char[][] Array of C-String parameter values for the command.
- * @param count uint8_t The number of parameters for the command.
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t ExecuteCommand(Command_t command, char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
-		uint8_t count) {
+static Tekdaqc_Command_Error_t Ex_SetOutputBudget(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-	switch (command) {
-	case COMMAND_LIST_ANALOG_INPUTS:
-		retval = Ex_ListAnalogInputs(keys, values, count);
-		break;
-	case COMMAND_READ_ADC_REGISTERS:
-		retval = Ex_ReadADCRegisters(keys, values, count);
-		break;
-	case COMMAND_READ_ANALOG_INPUT:
-		retval = Ex_ReadAnalogInput(keys, values, count);
-		break;
-	case COMMAND_ADD_ANALOG_INPUT:
-		retval = Ex_AddAnalogInput(keys, values, count);
-		break;
-	case COMMAND_REMOVE_ANALOG_INPUT:
-		retval = Ex_RemoveAnalogInput(keys, values, count);
-		break;
-	case COMMAND_CHECK_ANALOG_INPUT:
-		retval = Ex_CheckAnalogInput(keys, values, count);
-		break;
-	case COMMAND_SYSTEM_GCAL:
-		retval = Ex_SystemGainCal(keys, values, count);
-		break;
-	case COMMAND_SYSTEM_CAL:
-		retval = Ex_SystemCal(keys, values, count);
-		break;
-	case COMMAND_LIST_DIGITAL_INPUTS:
-		retval = Ex_ListDigitalInputs(keys, values, count);
-		break;
-	case COMMAND_READ_DIGITAL_INPUT:
-		retval = Ex_ReadDigitalInput(keys, values, count);
-		break;
-	case COMMAND_ADD_DIGITAL_INPUT:
-		retval = Ex_AddDigitalInput(keys, values, count);
-		break;
-	case COMMAND_REMOVE_DIGITAL_INPUT:
-		retval = Ex_RemoveDigitalInput(keys, values, count);
-		break;
-	case COMMAND_LIST_DIGITAL_OUTPUTS:
-		retval = Ex_ListDigitalOutputs(keys, values, count);
-		break;
-	case COMMAND_SET_DIGITAL_OUTPUT:
-		retval = Ex_SetDigitalOutput(keys, values, count);
-		break;
-	case COMMAND_READ_DIGITAL_OUTPUT:
-		retval = Ex_ReadDigitalOutput(keys, values, count);
-		break;
-	case COMMAND_ADD_DIGITAL_OUTPUT:
-		retval = Ex_AddDigitalOutput(keys, values, count);
-		break;
-	case COMMAND_REMOVE_DIGITAL_OUTPUT:
-		retval = Ex_RemoveDigitalOutput(keys, values, count);
-		break;
-	case COMMAND_CLEAR_DIG_OUTPUT_FAULT:
-		retval = Ex_ClearDigitalOutputFault(keys, values, count);
-		break;
-	case COMMAND_DISCONNECT:
-		/* Close the telnet connection */
-		TelnetClose();
-		break;
-	case COMMAND_UPGRADE:
-		/* Write the update flag to the backup register */
-		RTC_WriteBackupRegister(UPDATE_FLAG_REGISTER, (RTC_ReadBackupRegister(UPDATE_FLAG_REGISTER ) | UPDATE_FLAG_ENABLED));
-		/* Close the telnet connection */
-		TelnetClose();
-		/* Reset the processor */
-		NVIC_SystemReset();
-		break;
-	case COMMAND_IDENTIFY:
-		Ex_Identify();
-		break;
-	case COMMAND_SAMPLE:
-		retval = Ex_Sample(keys, values, count);
-		break;
-	case COMMAND_HALT:
-		HaltTasks();
-		break;
-	case COMMAND_SET_RTC:
-		retval = Ex_SetRTC(keys, values, count);
-		break;
-	case COMMAND_SET_USER_MAC:
-		retval = Ex_SetUserMac(keys, values, count);
-		break;
-	case COMMAND_SET_STATIC_IP:
-		retval = Ex_SetStaticIP(keys, values, count);
-		break;
-	case COMMAND_GET_CALIBRATION_STATUS:
-		retval = Ex_GetCalibrationStatus(keys, values, count);
-		break;
-	case COMMAND_NONE:
-		/* Do nothing */
-		break;
-	default:
-		/* Do nothing */
+	const int8_t index = GetIndexOfArgument(keys, PARAMETER_TIME, count);
+	if ((index >= 0) && InputArgsCheck(keys, values, count, NUM_SET_OUTPUT_BUDGET_PARAMS, SET_OUTPUT_BUDGET_PARAMS)) {
+		const uint32_t budget = (uint32_t) strtoul(values[index], NULL, 10);
+		if ((budget == 0U) || (budget > (ADC_OUTPUT_BUDGET_MAX_US / 1000U))) {
+			retval = ERR_COMMAND_BAD_PARAM;
+		} else {
+			ADC_Machine_SetOutputBudget(budget * 1000U); /* Convert to microseconds */
+		}
+	} else {
 #ifdef COMMAND_DEBUG
-		printf("[Command Interpreter] Unrecognized command, doing nothing.\n\r");
+		printf("[Command Interpreter] Provided arguments are not valid for setting the output budget.\n\r");
 #endif
-		retval = ERR_COMMAND_BAD_COMMAND;
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the BEGIN_CONFIG command with the provided parameters. Until COMMIT_CONFIG is received, the analog input
+ * commands only record the settings of the inputs they change, and the register images of all of them are compiled
+ * once on commit. Sampling commits the configuration if it is still open.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_BeginConfig(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_BEGIN_CONFIG_PARAMS, BEGIN_CONFIG_PARAMS)) {
+		if (isADCSampling() == FALSE) {
+			BeginAnalogInputConfig();
+		} else {
+			retval = ERR_COMMAND_ADC_INVALID_OPERATION;
+		}
+	} else {
+		retval = ERR_COMMAND_PARSE_ERROR;
 	}
 	return retval;
 }
 
 /**
- * Execute the LIST_ANALOG_INPUTS command.
+ * Execute the COMMIT_CONFIG command with the provided parameters, ending the configuration opened by BEGIN_CONFIG.
+ * The register images of the inputs changed in it are compiled and the calibration values of every added input are
+ * filled in, so the first scan starts without looking them up.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_ListAnalogInputs(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+static Tekdaqc_Command_Error_t Ex_CommitConfig(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_COMMIT_CONFIG_PARAMS, COMMIT_CONFIG_PARAMS)) {
+		if (isAnalogInputConfigOpen() == true) {
+			const uint8_t compiled = CommitAnalogInputConfig();
+			ADC_Machine_PrepareInputs();
+			snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "Configuration committed, %" PRIu8 " analog inputs updated.",
+					compiled);
+			TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		} else {
+			retval = ERR_COMMAND_ADC_INVALID_OPERATION;
+		}
+	} else {
+		retval = ERR_COMMAND_PARSE_ERROR;
+	}
+	return retval;
+}
+
+/**
+ * Execute the READ_LATEST_VALUES command with the provided parameters, printing the most recent measurement of every
+ * added analog input and the last sampled level of every added digital input in a single reply. Nothing is sampled, so
+ * this answers a poll at any time without starting or disturbing a sampling.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_ReadLatestValues(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
 		uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-	if (InputArgsCheck(keys, values, count, NUM_LIST_ANALOG_INPUTS_PARAMS, LIST_ANALOG_INPUTS_PARAMS)) {
-		Tekdaqc_Function_Error_t status = ListAnalogInputs();
+	if (InputArgsCheck(keys, values, count, NUM_READ_LATEST_VALUES_PARAMS, READ_LATEST_VALUES_PARAMS)) {
+		Tekdaqc_Function_Error_t status = WriteLatestAnalogValues();
+		if (status == ERR_FUNCTION_OK) {
+			status = WriteLatestDigitalValues();
+		}
 		if (status != ERR_FUNCTION_OK) {
 #ifdef COMMAND_DEBUG
-			printf("[Command Interpreter] Listing of analog inputs failed with error: %s.\n\r", Tekdaqc_FunctionError_ToString(status));
+			printf("[Command Interpreter] Reading the latest values failed with error: %s.\n\r", Tekdaqc_FunctionError_ToString(status));
 #endif
 			lastFunctionError = status;
 			retval = ERR_COMMAND_FUNCTION_ERROR;
 		}
 	} else {
-		/* We can't create a new input */
 #ifdef COMMAND_DEBUG
-		printf("[Command Interpreter] Provided arguments are not valid for listing the analog inputs.\n\r");
+		printf("[Command Interpreter] Provided arguments are not valid for reading the latest values.\n\r");
 #endif
 		retval = ERR_COMMAND_BAD_PARAM;
 	}
 	return retval;
 }
 
-
 /**
- * Execute the READ_ADC_REGISTERS command.
+ * Execute the SET_SAMPLE_LOG command. The STATE key turns the logging of sample data to FLASH ON or OFF. While it is
+ * on, sample data which has no destination is logged and replayed in order once there is one again. Turning it OFF
+ * abandons any logged data still waiting to be replayed. It is off at start up, but data logged before a reset is
+ * still replayed.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_ReadADCRegisters(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
-		uint8_t count) {
+static Tekdaqc_Command_Error_t Ex_SetSampleLog(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-	if (InputArgsCheck(keys, values, count, NUM_READ_ADC_REGISTERS_PARAMS, READ_ADC_REGISTERS_PARAMS)) {
-		ClearToStringBuffer();
-		ADS1256_RegistersToString();
-		if (TOSTRING_BUFFER[0] != '\0') {
-			TelnetWriteString(TOSTRING_BUFFER);
-			ClearToStringBuffer();
+	const int8_t stateIndex = GetIndexOfArgument(keys, PARAMETER_STATE, count);
+	if ((stateIndex >= 0) && InputArgsCheck(keys, values, count, NUM_SET_SAMPLE_LOG_PARAMS, SET_SAMPLE_LOG_PARAMS)) {
+		if (strcmp(values[stateIndex], STATE_ON_STRING) == 0) {
+			SampleLog_SetEnabled(true);
+		} else if (strcmp(values[stateIndex], STATE_OFF_STRING) == 0) {
+			SampleLog_SetEnabled(false);
 		} else {
-			/* An error occurred */
+			retval = ERR_COMMAND_BAD_PARAM;
+		}
+	} else {
 #ifdef COMMAND_DEBUG
-			printf("[Command Interpreter] Unable to build string to print ADC registers.\n\r");
+		printf("[Command Interpreter] Provided arguments are not valid for setting the sample log.\n\r");
 #endif
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the GET_SAMPLE_LOG_STATUS command. Reports whether logging is on, the bytes of the log sector used and
+ * waiting to be replayed, the sequence numbers of the records held and of the next to be replayed, and the number of
+ * records logged, replayed and lost since start up.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_GetSampleLogStatus(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_GET_SAMPLE_LOG_STATUS_PARAMS, GET_SAMPLE_LOG_STATUS_PARAMS)) {
+		SampleLogCounts_t counts;
+		SampleLog_GetCounts(&counts);
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER),
+				"Sample Log: %s, Used: %" PRIu32 " bytes, Backlog: %" PRIu32 " bytes, Sequence: %" PRIu32 " to %" PRIu32
+				", Next: %" PRIu32 ", Logged: %" PRIu32 ", Replayed: %" PRIu32 ", Dropped: %" PRIu32,
+				(SampleLog_IsEnabled() == true) ? STATE_ON_STRING : STATE_OFF_STRING, counts.used, counts.backlog,
+				counts.firstSequence, counts.lastSequence, counts.nextSequence, counts.logged, counts.replayed,
+				counts.dropped);
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the RESUME_SAMPLE_LOG command. The SEQUENCE key is the sequence number of the last logged record the host
+ * has received, from the last marker it was sent, or 0 for none. Those records are acknowledged and the replay
+ * carries on from the next one, sending again any which were lost with a previous connection. From then on each
+ * replayed record is preceded by a marker with its sequence number. Replies with the first record to be replayed and
+ * the last one logged; a first record past the one asked for means the records between were erased.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_ResumeSampleLog(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	const int8_t sequenceIndex = GetIndexOfArgument(keys, PARAMETER_SEQUENCE, count);
+	if ((sequenceIndex >= 0)
+			&& InputArgsCheck(keys, values, count, NUM_RESUME_SAMPLE_LOG_PARAMS, RESUME_SAMPLE_LOG_PARAMS)) {
+		char* end = NULL;
+		const uint32_t sequence = (uint32_t) strtoul(values[sequenceIndex], &end, 10);
+		uint32_t first;
+		uint32_t last;
+		if ((end == values[sequenceIndex]) || (*end != '\0')) {
+			retval = ERR_COMMAND_BAD_PARAM;
+		} else if (SampleLog_Resume(sequence, &first, &last) == false) {
+			/* The log sector is being erased */
 			retval = ERR_COMMAND_FUNCTION_ERROR;
+		} else {
+			snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Sample Log Resumed, First: %" PRIu32 ", Last: %" PRIu32,
+					first, last);
+			TelnetWriteStatusMessage(TOSTRING_BUFFER);
 		}
 	} else {
-		/* We can't create a new input */
 #ifdef COMMAND_DEBUG
-		printf("[Command Interpreter] Provided arguments are not valid for reading the ADC registers.\n\r");
+		printf("[Command Interpreter] Provided arguments are not valid for resuming the sample log.\n\r");
 #endif
 		retval = ERR_COMMAND_BAD_PARAM;
 	}
@@ -1297,69 +5907,46 @@ static Tekdaqc_Command_Error_t Ex_ReadADCRegisters(char keys[][MAX_COMMANDPART_L
 }
 
 /**
- * Execute the READ_ANALOG_INPUT command.
+ * Execute the BURST_CAPTURE command. Captures the raw codes of the INPUT key's input into the free CCM-RAM as fast
+ * as its data rate allows, with nothing sent until the capture is complete. The SCANS key is the number of
+ * conversions, by default and at most as many as the capture buffer holds. Replies with the number which will be
+ * captured, a status message reports when the capture is complete and READ_BURST_CAPTURE downloads it.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_ReadAnalogInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+static Tekdaqc_Command_Error_t Ex_BurstCapture(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-	if (InputArgsCheck(keys, values, count, NUM_READ_ANALOG_INPUT_PARAMS, READ_ANALOG_INPUT_PARAMS)) {
-		int32_t numSamples = 0;
-		Channel_List_t list_type = ALL_CHANNELS;
-		int8_t index = -1;
-		for (int i = 0; i < NUM_READ_ANALOG_INPUT_PARAMS; ++i) {
-			index = GetIndexOfArgument(keys, READ_ANALOG_INPUT_PARAMS[i], count);
-			if (index >= 0) { /* We found the key in the list */
-				switch (i) { /* Switch on the key not position in arguments list */
-				case 0: /* INPUT key */
-#ifdef COMMAND_DEBUG
-					printf("Processing INPUT key\n\r");
-#endif
-					list_type = GetChannelListType(values[index]);
-					BuildAnalogInputList(list_type, values[index]);
-					break;
-				case 1: /* NUMBER key */
-#ifdef COMMAND_DEBUG
-					printf("Processing NUMBER key\n\r");
-#endif
-					numSamples = (int32_t) strtol(values[index], NULL, 10);
-					break;
-				default:
-					/* Return an error */
-					retval = ERR_COMMAND_PARSE_ERROR;
-				}
-			}
-			if (retval != ERR_COMMAND_OK) {
-				break; /* If an error occurred, don't bother continuing */
-			}
+	if (isADCSampling() == TRUE) {
+		return ERR_COMMAND_ADC_INVALID_OPERATION;
+	}
+	const int8_t inputIndex = GetIndexOfArgument(keys, PARAMETER_INPUT, count);
+	if ((inputIndex >= 0) && InputArgsCheck(keys, values, count, NUM_BURST_CAPTURE_PARAMS, BURST_CAPTURE_PARAMS)) {
+		Analog_Input_t* input = GetAnalogInputByNumber((uint8_t) strtol(values[inputIndex], NULL, 10));
+		ADC_BurstCapture_t capture;
+		ADC_Machine_GetBurstCapture(&capture);
+		uint32_t scans = capture.capacity;
+		const int8_t scansIndex = GetIndexOfArgument(keys, PARAMETER_SCANS, count);
+		if (scansIndex >= 0) {
+			scans = (uint32_t) strtoul(values[scansIndex], NULL, 10);
 		}
-		if (retval == ERR_COMMAND_OK) { /* If an error occurred, don't bother continuing */
-			switch (list_type) {
-			case SINGLE_CHANNEL:
-				ADC_Machine_Input_Sample(aInputs, numSamples, true);
-				break;
-			case CHANNEL_SET:
-				ADC_Machine_Input_Sample(aInputs, numSamples, false);
-				break;
-			case CHANNEL_RANGE:
-				ADC_Machine_Input_Sample(aInputs, numSamples, false);
-				break;
-			case ALL_CHANNELS:
-				ADC_Machine_Input_Sample(aInputs, numSamples, false);
-				break;
-			default:
-				/* Return an error */
-				retval = ERR_COMMAND_FUNCTION_ERROR;
-			}
+		if ((input == NULL) || (input->added == CHANNEL_NOTADDED) || (input->physicalInput == IN_COLD_JUNCTION)
+				|| (scans == 0U)) {
+			retval = ERR_COMMAND_BAD_PARAM;
+		} else if (ADC_Machine_StartBurstCapture(input, scans) == false) {
+			retval = ERR_COMMAND_ADC_INVALID_OPERATION;
+		} else {
 			CommandStateMoveToAnalogInputSample();
+			ADC_Machine_GetBurstCapture(&capture);
+			snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Burst Capture Started, Input: %" PRIu8 ", Samples: %" PRIu32
+					", Capacity: %" PRIu32, (uint8_t) capture.input, capture.requested, capture.capacity);
+			TelnetWriteStatusMessage(TOSTRING_BUFFER);
 		}
 	} else {
-		/* We can't create a new input */
 #ifdef COMMAND_DEBUG
-		printf("[Command Interpreter] Provided arguments are not valid for read of an analog input.\n\r");
+		printf("[Command Interpreter] Provided arguments are not valid for a burst capture.\n\r");
 #endif
 		retval = ERR_COMMAND_BAD_PARAM;
 	}
@@ -1367,160 +5954,483 @@ static Tekdaqc_Command_Error_t Ex_ReadAnalogInput(char keys[][MAX_COMMANDPART_LE
 }
 
 /**
- * Execute the ADD_ANALOG_INPUT command.
+ * Execute the READ_BURST_CAPTURE command. Replies with the input, number of codes and first and last conversion
+ * times of the last burst capture, then sends its codes to the data connection as binary capture records. Only
+ * available while the ADC is not sampling.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_AddAnalogInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+static Tekdaqc_Command_Error_t Ex_ReadBurstCapture(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-	if (isADCSampling() == FALSE) {
-		if (InputArgsCheck(keys, values, count, NUM_ADD_ANALOG_INPUT_PARAMS, ADD_ANALOG_INPUT_PARAMS) == true) {
-			/* Create a new input */
-			Tekdaqc_Function_Error_t status = CreateAnalogInput(keys, values, count);
-			if (status != ERR_FUNCTION_OK) {
-				/* Something went wrong with creating the input */
-#ifdef COMMAND_DEBUG
-				printf("[Command Interpreter] Creating a new analog input failed with error: %s.\n\r",
-						Tekdaqc_FunctionError_ToString(status));
-#endif
-				lastFunctionError = status;
-				retval = ERR_COMMAND_FUNCTION_ERROR;
-			}
+	if (isADCSampling() == TRUE) {
+		return ERR_COMMAND_ADC_INVALID_OPERATION;
+	}
+	if (InputArgsCheck(keys, values, count, NUM_READ_BURST_CAPTURE_PARAMS, READ_BURST_CAPTURE_PARAMS)) {
+		ADC_BurstCapture_t capture;
+		ADC_Machine_GetBurstCapture(&capture);
+		if (ADC_Machine_ReadBurstCapture() == false) {
+			retval = ERR_COMMAND_FUNCTION_ERROR;
 		} else {
-			/* We can't create a new input */
-#ifdef COMMAND_DEBUG
-			printf("[Command Interpreter] Provided arguments are not valid for creation of a new analog input.\n\r");
-#endif
-			retval = ERR_COMMAND_OK;
+			snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Burst Capture, Input: %" PRIu8 ", Samples: %" PRIu32
+					", Start: %" PRIu64 ", End: %" PRIu64, (uint8_t) capture.input, capture.count, capture.start, capture.end);
+			TelnetWriteStatusMessage(TOSTRING_BUFFER);
 		}
 	} else {
-		retval = ERR_COMMAND_ADC_INVALID_OPERATION;
+		retval = ERR_COMMAND_BAD_PARAM;
 	}
 	return retval;
 }
 
 /**
- * Execute the REMOVE_ANALOG_INPUT command.
+ * Execute the READ_BURST_SPECTRUM command. Reduces the last burst capture to its averaged amplitude spectrum, computed
+ * with a Hann windowed FFT of the POINTS key's number of points, a power of 2 from FFT_MIN_POINTS to FFT_MAX_POINTS.
+ * With the PEAKS key the strongest peaks, up to ANALOG_SPECTRUM_MAX_PEAKS, are reported in a status message,
+ * otherwise every bin is sent to the data connection as binary spectrum records. Replies with the number of blocks
+ * averaged and the width of the bins. Only available while the ADC is not sampling.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_RemoveAnalogInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+static Tekdaqc_Command_Error_t Ex_ReadBurstSpectrum(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
 		uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-	if (isADCSampling() == FALSE) {
-		if (InputArgsCheck(keys, values, count, NUM_REMOVE_ANALOG_INPUT_PARAMS, REMOVE_ANALOG_INPUT_PARAMS)) {
-			Tekdaqc_Function_Error_t status = RemoveAnalogInput(keys, values, count);
-			if (status != ERR_FUNCTION_OK) {
-				/* Something went wrong with removing the input */
+	if (isADCSampling() == TRUE) {
+		return ERR_COMMAND_ADC_INVALID_OPERATION;
+	}
+	const int8_t pointsIndex = GetIndexOfArgument(keys, PARAMETER_POINTS, count);
+	if ((pointsIndex >= 0)
+			&& InputArgsCheck(keys, values, count, NUM_READ_BURST_SPECTRUM_PARAMS, READ_BURST_SPECTRUM_PARAMS)) {
+		const uint32_t points = (uint32_t) strtoul(values[pointsIndex], NULL, 10);
+		uint32_t peaks = 0U;
+		const int8_t peaksIndex = GetIndexOfArgument(keys, PARAMETER_PEAKS, count);
+		if (peaksIndex >= 0) {
+			peaks = (uint32_t) strtoul(values[peaksIndex], NULL, 10);
+		}
+		uint32_t binWidth = 0U;
+		if ((points > FFT_MAX_POINTS) || (FFT_IsValidSize((uint16_t) points) == false) || (peaks > ANALOG_SPECTRUM_MAX_PEAKS)
+				|| ((peaksIndex >= 0) && (peaks == 0U))) {
+			retval = ERR_COMMAND_BAD_PARAM;
+		} else if (ADC_Machine_ReadBurstSpectrum((uint16_t) points, (uint8_t) peaks, &binWidth) == false) {
+			/* There is no capture holding a whole block */
+			retval = ERR_COMMAND_FUNCTION_ERROR;
+		} else {
+			ADC_BurstCapture_t capture;
+			ADC_Machine_GetBurstCapture(&capture);
+			snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Burst Spectrum, Input: %" PRIu8 ", Points: %" PRIu32
+					", Blocks: %" PRIu32 ", Bin Width: %" PRIu32 " mHz", (uint8_t) capture.input, points,
+					capture.count / points, binWidth);
+			TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		}
+	} else {
 #ifdef COMMAND_DEBUG
-				printf("[Command Interpreter] Removing an analog input failed with error code: %s.\n\r",
-						Tekdaqc_FunctionError_ToString(status));
+		printf("[Command Interpreter] Provided arguments are not valid for reading a burst spectrum.\n\r");
 #endif
-				lastFunctionError = status;
-				retval = ERR_COMMAND_FUNCTION_ERROR;
-			}
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the SET_ANALOG_POWER command. Sets up the power channel given by the NUMBER key, from 0 to
+ * ANALOG_POWER_MAX_CHANNELS - 1, to pair the analog input of the VOLTAGE key with that of the CURRENT key. While both
+ * are sampled it reports the true RMS of each, the real power and the power factor for every CYCLES cycles of the
+ * voltage, ANALOG_POWER_DEFAULT_CYCLES if not given. Without the VOLTAGE and CURRENT keys the channel is removed. Only
+ * available while the ADC is not sampling.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SetAnalogPower(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (isADCSampling() == TRUE) {
+		return ERR_COMMAND_ADC_INVALID_OPERATION;
+	}
+	const int8_t numberIndex = GetIndexOfArgument(keys, PARAMETER_NUMBER, count);
+	if ((numberIndex >= 0) && InputArgsCheck(keys, values, count, NUM_SET_ANALOG_POWER_PARAMS, SET_ANALOG_POWER_PARAMS)) {
+		const uint32_t number = (uint32_t) strtoul(values[numberIndex], NULL, 10);
+		const int8_t voltageIndex = GetIndexOfArgument(keys, PARAMETER_VOLTAGE, count);
+		const int8_t currentIndex = GetIndexOfArgument(keys, PARAMETER_CURRENT, count);
+		const int8_t cyclesIndex = GetIndexOfArgument(keys, PARAMETER_CYCLES, count);
+		if (number >= ANALOG_POWER_MAX_CHANNELS) {
+			retval = ERR_COMMAND_BAD_PARAM;
+		} else if ((voltageIndex < 0) && (currentIndex < 0) && (cyclesIndex < 0)) {
+			AnalogPower_ClearChannel((uint8_t) number);
+			snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Analog Power Channel %" PRIu32 " Removed", number);
+			TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		} else if ((voltageIndex < 0) || (currentIndex < 0)) {
+			retval = ERR_COMMAND_BAD_PARAM;
 		} else {
-			/* We can't delete an input */
+			const Analog_Input_t* voltage = GetAnalogInputByNumber((uint8_t) strtol(values[voltageIndex], NULL, 10));
+			const Analog_Input_t* current = GetAnalogInputByNumber((uint8_t) strtol(values[currentIndex], NULL, 10));
+			uint32_t cycles = ANALOG_POWER_DEFAULT_CYCLES;
+			if (cyclesIndex >= 0) {
+				cycles = (uint32_t) strtoul(values[cyclesIndex], NULL, 10);
+			}
+			if ((voltage == NULL) || (current == NULL) || (voltage->physicalInput == IN_COLD_JUNCTION)
+					|| (current->physicalInput == IN_COLD_JUNCTION) || (cycles == 0U) || (cycles > UINT16_MAX)
+					|| (AnalogPower_SetChannel((uint8_t) number, voltage->physicalInput, current->physicalInput,
+							(uint16_t) cycles) == false)) {
+				retval = ERR_COMMAND_BAD_PARAM;
+			} else {
+				snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Analog Power Channel %" PRIu32 ", Voltage: %" PRIu8
+						", Current: %" PRIu8 ", Cycles: %" PRIu32, number, (uint8_t) voltage->physicalInput,
+						(uint8_t) current->physicalInput, cycles);
+				TelnetWriteStatusMessage(TOSTRING_BUFFER);
+			}
+		}
+	} else {
 #ifdef COMMAND_DEBUG
-			printf("[Command Interpreter] Provided arguments are not valid for removal of an analog input.\n\r");
+		printf("[Command Interpreter] Provided arguments are not valid for setting an analog power channel.\n\r");
 #endif
-			retval = ERR_COMMAND_BAD_PARAM;
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the SET_INTERLOCK command. Sets the interlock rule given by the NUMBER key, from 0 to
+ * DIGITAL_INTERLOCK_MAX_RULES - 1. The rule watches the analog input of the INPUT key, tripping when its samples go
+ * ABOVE or BELOW, as given by the COMPARATOR key, the LEVEL key's counts, or the digital input of the SOURCE key,
+ * tripping when it goes high (ABOVE) or low (BELOW). While tripped it holds the digital output of the OUTPUT key in the
+ * STATE key's level, OFF by default. It clears once an analog input is back past the level by the HYSTERESIS key's
+ * counts, 0 by default, or for LATCH=ON only with RESET_INTERLOCKS. Without the INPUT and SOURCE keys the rule is
+ * removed.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SetInterlock(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	const int8_t numberIndex = GetIndexOfArgument(keys, PARAMETER_NUMBER, count);
+	if ((numberIndex < 0) || (InputArgsCheck(keys, values, count, NUM_SET_INTERLOCK_PARAMS, SET_INTERLOCK_PARAMS) == false)) {
+#ifdef COMMAND_DEBUG
+		printf("[Command Interpreter] Provided arguments are not valid for setting an interlock.\n\r");
+#endif
+		return ERR_COMMAND_BAD_PARAM;
+	}
+	const uint32_t number = (uint32_t) strtoul(values[numberIndex], NULL, 10);
+	const int8_t inputIndex = GetIndexOfArgument(keys, PARAMETER_INPUT, count);
+	const int8_t sourceIndex = GetIndexOfArgument(keys, PARAMETER_SOURCE, count);
+	if (number >= DIGITAL_INTERLOCK_MAX_RULES) {
+		return ERR_COMMAND_BAD_PARAM;
+	}
+	if ((inputIndex < 0) && (sourceIndex < 0)) {
+		DigitalInterlock_Clear((uint8_t) number);
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Interlock %" PRIu32 " Removed", number);
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		return retval;
+	}
+	DigitalInterlock_t rule;
+	memset(&rule, 0, sizeof(DigitalInterlock_t));
+	rule.comparator = DIGITAL_INTERLOCK_ABOVE;
+	int8_t index = -1;
+	for (uint_fast8_t i = 1U; (i < NUM_SET_INTERLOCK_PARAMS) && (retval == ERR_COMMAND_OK); ++i) {
+		index = GetIndexOfArgument(keys, SET_INTERLOCK_PARAMS[i], count);
+		if (index < 0) {
+			/* Only the OUTPUT key is required, along with one of INPUT and SOURCE */
+			if (i == 6U) {
+				retval = ERR_COMMAND_BAD_PARAM;
+			}
+			continue;
+		}
+		switch (i) { /* Switch on the key not position in arguments list */
+		case 1U: /* INPUT key */
+		{
+			const Analog_Input_t* input = GetAnalogInputByNumber((uint8_t) strtol(values[index], NULL, 10));
+			if ((input == NULL) || (sourceIndex >= 0)) {
+				retval = ERR_COMMAND_BAD_PARAM;
+			} else {
+				rule.source = DIGITAL_INTERLOCK_ANALOG;
+				rule.input = (uint8_t) input->physicalInput;
+			}
+			break;
+		}
+		case 2U: /* SOURCE key */
+		{
+			const Digital_Input_t* input = GetDigitalInputByNumber((uint8_t) strtol(values[index], NULL, 10));
+			if (input == NULL) {
+				retval = ERR_COMMAND_BAD_PARAM;
+			} else {
+				rule.source = DIGITAL_INTERLOCK_DIGITAL;
+				rule.input = (uint8_t) input->input;
+			}
+			break;
+		}
+		case 3U: /* COMPARATOR key */
+			rule.comparator = DigitalInterlock_StringToComparator(values[index]);
+			break;
+		case 4U: /* LEVEL key */
+			rule.threshold = (int32_t) strtol(values[index], NULL, 10);
+			break;
+		case 5U: /* HYSTERESIS key */
+			rule.hysteresis = (uint32_t) strtoul(values[index], NULL, 10);
+			break;
+		case 6U: /* OUTPUT key */
+		{
+			const Digital_Output_t* output = GetDigitalOutputByNumber((uint8_t) strtol(values[index], NULL, 10));
+			if (output == NULL) {
+				retval = ERR_COMMAND_BAD_PARAM;
+			} else {
+				rule.output = (uint8_t) output->output;
+			}
+			break;
 		}
+		case 7U: /* STATE key */
+			if (strcmp(values[index], STATE_ON_STRING) == 0) {
+				rule.on = true;
+			} else if (strcmp(values[index], STATE_OFF_STRING) != 0) {
+				retval = ERR_COMMAND_BAD_PARAM;
+			}
+			break;
+		case 8U: /* LATCH key */
+			if (strcmp(values[index], STATE_ON_STRING) == 0) {
+				rule.latch = true;
+			} else if (strcmp(values[index], STATE_OFF_STRING) != 0) {
+				retval = ERR_COMMAND_BAD_PARAM;
+			}
+			break;
+		default:
+			retval = ERR_COMMAND_PARSE_ERROR;
+		}
+	}
+	if ((retval == ERR_COMMAND_OK) && (DigitalInterlock_Set((uint8_t) number, &rule) == false)) {
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	if (retval == ERR_COMMAND_OK) {
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Interlock %" PRIu32 " Set, %s Input: %" PRIu8 ", %s: %" PRIi32
+				", Hysteresis: %" PRIu32 ", Output: %" PRIu8 " %s%s", number,
+				(rule.source == DIGITAL_INTERLOCK_ANALOG) ? "Analog" : "Digital", rule.input,
+				DigitalInterlock_ComparatorToString(rule.comparator), rule.threshold, rule.hysteresis, rule.output,
+				(rule.on == true) ? STATE_ON_STRING : STATE_OFF_STRING, (rule.latch == true) ? ", Latched" : "");
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+	}
+	return retval;
+}
+
+/**
+ * Execute the RESET_INTERLOCKS command. Releases every latched interlock rule which has tripped, returning its output
+ * to the level it would otherwise have. A rule whose input is still past its level trips again on its next sample.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_ResetInterlocks(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	if (InputArgsCheck(keys, values, count, NUM_RESET_INTERLOCKS_PARAMS, RESET_INTERLOCKS_PARAMS)) {
+		DigitalInterlock_Reset();
+		TelnetWriteStatusMessage("Interlocks Reset");
 	} else {
-		retval = ERR_COMMAND_ADC_INVALID_OPERATION;
+		retval = ERR_COMMAND_BAD_PARAM;
 	}
 	return retval;
 }
 
 /**
- * Execute the CHECK_ANALOG_INPUT command.
+ * Execute the LIST_INTERLOCKS command. Reports each interlock rule which is set, with whether it is tripped, the number
+ * of times it has tripped and the time it last did.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_CheckAnalogInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
-		uint8_t count) {
+static Tekdaqc_Command_Error_t Ex_ListInterlocks(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-	/* TODO: Fill in this method */
+	if (InputArgsCheck(keys, values, count, NUM_LIST_INTERLOCKS_PARAMS, LIST_INTERLOCKS_PARAMS)) {
+		uint_fast8_t listed = 0U;
+		DigitalInterlock_t rule;
+		for (uint_fast8_t i = 0U; i < DIGITAL_INTERLOCK_MAX_RULES; ++i) {
+			if ((DigitalInterlock_Get((uint8_t) i, &rule) == true) && (rule.enabled == true)) {
+				snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Interlock %" PRIu8 ", %s Input: %" PRIu8 ", %s: %" PRIi32
+						", Hysteresis: %" PRIu32 ", Output: %" PRIu8 " %s%s, Tripped: %s, Trips: %" PRIu32 ", Last Trip: %" PRIu64,
+						(uint8_t) i, (rule.source == DIGITAL_INTERLOCK_ANALOG) ? "Analog" : "Digital", rule.input,
+						DigitalInterlock_ComparatorToString(rule.comparator), rule.threshold, rule.hysteresis, rule.output,
+						(rule.on == true) ? STATE_ON_STRING : STATE_OFF_STRING, (rule.latch == true) ? ", Latched" : "",
+						(rule.tripped == true) ? "TRUE" : "FALSE", rule.trips, rule.tripTime);
+				TelnetWriteStatusMessage(TOSTRING_BUFFER);
+				++listed;
+			}
+		}
+		if (listed == 0U) {
+			TelnetWriteStatusMessage("No Interlocks Set");
+		}
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
 	return retval;
 }
 
 /**
- * Execute the SYSTEM_GCAL command.
+ * Execute the SET_PID command. Starts the PID loop given by the NUMBER key, from 0 to DIGITAL_PID_MAX_LOOPS - 1,
+ * controlling the analog input of the INPUT key at the SETPOINT key's counts by modulating the digital output of the
+ * OUTPUT key at the RATE key's frequency in Hz, DIGITAL_PID_DEFAULT_RATE by default. The KP, KI and KD keys give the
+ * gains, 0 by default, in 1/65536ths of full duty cycle per count of error, the KI and KD keys per sample. With only
+ * the SETPOINT key the setpoint of the running loop is changed, and with neither it the loop is stopped and its output
+ * turned off.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_SystemGainCal(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+static Tekdaqc_Command_Error_t Ex_SetPid(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-	if (InputArgsCheck(keys, values, count, NUM_SYSTEM_GCAL_PARAMS, SYSTEM_GCAL_PARAMS)) {
-		/* Perform a system gain calibration */
-		Tekdaqc_Function_Error_t status = PerformSystemGainCalibration(keys, values, count);
-		if (status != ERR_FUNCTION_OK) {
-			lastFunctionError = status;
-			retval = ERR_COMMAND_FUNCTION_ERROR;
-		}
-	} else {
+	const int8_t numberIndex = GetIndexOfArgument(keys, PARAMETER_NUMBER, count);
+	if ((numberIndex < 0) || (InputArgsCheck(keys, values, count, NUM_SET_PID_PARAMS, SET_PID_PARAMS) == false)) {
 #ifdef COMMAND_DEBUG
-		printf("[Command Interpreter] Provided arguments are not valid for performing a system gain calibration.\n\r");
+		printf("[Command Interpreter] Provided arguments are not valid for setting a PID loop.\n\r");
 #endif
+		return ERR_COMMAND_BAD_PARAM;
+	}
+	const uint32_t number = (uint32_t) strtoul(values[numberIndex], NULL, 10);
+	const int8_t inputIndex = GetIndexOfArgument(keys, PARAMETER_INPUT, count);
+	const int8_t outputIndex = GetIndexOfArgument(keys, PARAMETER_OUTPUT, count);
+	const int8_t setpointIndex = GetIndexOfArgument(keys, PARAMETER_SETPOINT, count);
+	if (number >= DIGITAL_PID_MAX_LOOPS) {
+		retval = ERR_COMMAND_BAD_PARAM;
+	} else if ((inputIndex < 0) && (outputIndex < 0) && (count == 1U)) {
+		DigitalPID_Clear((uint8_t) number);
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "PID Loop %" PRIu32 " Stopped", number);
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+	} else if ((inputIndex < 0) && (outputIndex < 0) && (setpointIndex >= 0) && (count == 2U)) {
+		const int32_t setpoint = (int32_t) strtol(values[setpointIndex], NULL, 10);
+		if (DigitalPID_SetSetpoint((uint8_t) number, setpoint) == false) {
+			retval = ERR_COMMAND_FUNCTION_ERROR;
+		} else {
+			snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "PID Loop %" PRIu32 ", Setpoint: %" PRIi32, number, setpoint);
+			TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		}
+	} else if ((inputIndex < 0) || (outputIndex < 0) || (setpointIndex < 0)) {
 		retval = ERR_COMMAND_BAD_PARAM;
+	} else {
+		const Analog_Input_t* input = GetAnalogInputByNumber((uint8_t) strtol(values[inputIndex], NULL, 10));
+		const Digital_Output_t* output = GetDigitalOutputByNumber((uint8_t) strtol(values[outputIndex], NULL, 10));
+		const int32_t setpoint = (int32_t) strtol(values[setpointIndex], NULL, 10);
+		float gains[3] = { 0.0f, 0.0f, 0.0f };
+		const char* gainKeys[3] = { PARAMETER_KP, PARAMETER_KI, PARAMETER_KD };
+		for (uint_fast8_t i = 0U; i < 3U; ++i) {
+			const int8_t index = GetIndexOfArgument(keys, gainKeys[i], count);
+			if (index >= 0) {
+				gains[i] = strtof(values[index], NULL);
+			}
+		}
+		uint32_t rate = DIGITAL_PID_DEFAULT_RATE;
+		const int8_t rateIndex = GetIndexOfArgument(keys, PARAMETER_RATE, count);
+		if (rateIndex >= 0) {
+			rate = (uint32_t) strtoul(values[rateIndex], NULL, 10);
+		}
+		if ((input == NULL) || (output == NULL) || (input->physicalInput == IN_COLD_JUNCTION)
+				|| (DigitalPID_Set((uint8_t) number, input->physicalInput, (uint8_t) output->output, setpoint, gains[0],
+						gains[1], gains[2]) == false)) {
+			retval = ERR_COMMAND_BAD_PARAM;
+		} else if (SetDigitalOutputPwm((uint8_t) output->output, rate, 0U) != ERR_FUNCTION_OK) {
+			/* The output is not added or the rate is out of range */
+			DigitalPID_Clear((uint8_t) number);
+			retval = ERR_COMMAND_BAD_PARAM;
+		} else {
+			snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "PID Loop %" PRIu32 " Started, Input: %" PRIu8 ", Output: %"
+					PRIu8 ", Setpoint: %" PRIi32 ", Rate: %" PRIu32 " Hz", number, (uint8_t) input->physicalInput,
+					(uint8_t) output->output, setpoint, rate);
+			TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		}
 	}
 	return retval;
 }
 
 /**
- * Execute the SYSTEM_CAL command.
+ * Execute the LIST_PID_LOOPS command. Reports each running PID loop, with its gains in 1/65536ths, the last sample of
+ * its input, its output duty cycle in thousandths and the number of samples its output has been clamped at a limit.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_SystemCal(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+static Tekdaqc_Command_Error_t Ex_ListPidLoops(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-	Tekdaqc_Function_Error_t status = PerformSystemCalibration();
-	if (status != ERR_FUNCTION_OK) {
-		lastFunctionError = status;
-		retval = ERR_COMMAND_FUNCTION_ERROR;
+	if (InputArgsCheck(keys, values, count, NUM_LIST_PID_LOOPS_PARAMS, LIST_PID_LOOPS_PARAMS)) {
+		uint_fast8_t listed = 0U;
+		DigitalPID_t loop;
+		for (uint_fast8_t i = 0U; i < DIGITAL_PID_MAX_LOOPS; ++i) {
+			if ((DigitalPID_Get((uint8_t) i, &loop) == true) && (loop.enabled == true)) {
+				snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "PID Loop %" PRIu8 ", Input: %" PRIu8 ", Output: %" PRIu8
+						", Setpoint: %" PRIi32 ", KP: %" PRIi32 ", KI: %" PRIi32 ", KD: %" PRIi32 ", Last Input: %" PRIi32
+						", Duty: %" PRIi32 "/1000, Saturations: %" PRIu32, (uint8_t) i, (uint8_t) loop.input, loop.output,
+						loop.setpoint, loop.kp, loop.ki, loop.kd, loop.previous,
+						(int32_t) ((loop.value * 1000 + (DIGITAL_PID_OUTPUT_MAX / 2)) / DIGITAL_PID_OUTPUT_MAX), loop.saturations);
+				TelnetWriteStatusMessage(TOSTRING_BUFFER);
+				++listed;
+			}
+		}
+		if (listed == 0U) {
+			TelnetWriteStatusMessage("No PID Loops Running");
+		}
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
 	}
 	return retval;
 }
 
 /**
- * Execute the LIST_DIGITAL_INPUTS command.
+ * Execute the SET_MATH_CHANNEL command. Compiles the expression of the EXPR key into the math channel given by the
+ * NUMBER key, from 0 to ANALOG_MATH_MAX_CHANNELS - 1. The expression uses the analog inputs as A followed by their
+ * number, decimal constants, + - * / and parentheses, without spaces, for example --EXPR=(A0-A1)*2.5. Its value is
+ * written for every scan of its inputs, and their raw samples are left out unless the RAW key is ON. Without the EXPR
+ * key the channel is removed.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_ListDigitalInputs(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
-		uint8_t count) {
+static Tekdaqc_Command_Error_t Ex_SetMathChannel(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-	if (InputArgsCheck(keys, values, count, NUM_LIST_DIGITAL_INPUTS_PARAMS, LIST_DIGITAL_INPUTS_PARAMS)) {
-		Tekdaqc_Function_Error_t status = ListDigitalInputs();
-		if (status != ERR_FUNCTION_OK) {
-#ifdef COMMAND_DEBUG
-			printf("[Command Interpreter] Listing of digital inputs failed with error: %s.\n\r", Tekdaqc_FunctionError_ToString(status));
-#endif
-			lastFunctionError = status;
-			retval = ERR_COMMAND_FUNCTION_ERROR;
+	const int8_t numberIndex = GetIndexOfArgument(keys, PARAMETER_NUMBER, count);
+	if ((numberIndex >= 0) && InputArgsCheck(keys, values, count, NUM_SET_MATH_CHANNEL_PARAMS, SET_MATH_CHANNEL_PARAMS)) {
+		const uint32_t number = (uint32_t) strtoul(values[numberIndex], NULL, 10);
+		const int8_t exprIndex = GetIndexOfArgument(keys, PARAMETER_EXPR, count);
+		const int8_t rawIndex = GetIndexOfArgument(keys, PARAMETER_RAW, count);
+		bool raw = false;
+		if (rawIndex >= 0) {
+			if (strcmp(values[rawIndex], STATE_ON_STRING) == 0) {
+				raw = true;
+			} else if (strcmp(values[rawIndex], STATE_OFF_STRING) != 0) {
+				return ERR_COMMAND_BAD_PARAM;
+			}
+		}
+		if (number >= ANALOG_MATH_MAX_CHANNELS) {
+			retval = ERR_COMMAND_BAD_PARAM;
+		} else if (exprIndex < 0) {
+			AnalogMath_Clear((uint8_t) number);
+			snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Math Channel %" PRIu32 " Removed", number);
+			TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		} else {
+			const AnalogMathStatus_t status = AnalogMath_Set((uint8_t) number, values[exprIndex], raw);
+			if (status == ANALOG_MATH_OK) {
+				snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Math Channel %" PRIu32 ": %s, Raw: %s", number,
+						values[exprIndex], (raw == true) ? STATE_ON_STRING : STATE_OFF_STRING);
+			} else {
+				snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Math Channel %" PRIu32 " Not Set: %s", number,
+						AnalogMath_StatusToString(status));
+				retval = ERR_COMMAND_BAD_PARAM;
+			}
+			TelnetWriteStatusMessage(TOSTRING_BUFFER);
 		}
 	} else {
-		/* We can't create a new input */
 #ifdef COMMAND_DEBUG
-		printf("[Command Interpreter] Provided arguments are not valid for listing the digital inputs.\n\r");
+		printf("[Command Interpreter] Provided arguments are not valid for setting a math channel.\n\r");
 #endif
 		retval = ERR_COMMAND_BAD_PARAM;
 	}
@@ -1528,198 +6438,182 @@ static Tekdaqc_Command_Error_t Ex_ListDigitalInputs(char keys[][MAX_COMMANDPART_
 }
 
 /**
- * Execute the READ_DIGITAL_INPUT command.
+ * Execute the LIST_MATH_CHANNELS command. Reports each math channel with its expression, the length of its compiled
+ * code, the number of times it has been evaluated and the number of results dropped because they could not be
+ * written in time.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_ReadDigitalInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+static Tekdaqc_Command_Error_t Ex_ListMathChannels(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
 		uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-	if (InputArgsCheck(keys, values, count, NUM_READ_DIGITAL_INPUT_PARAMS, READ_DIGITAL_INPUT_PARAMS)) {
-		int32_t numSamples = 0;
-		Channel_List_t list_type = 0;
-		int8_t index = -1;
-		for (int i = 0; i < NUM_READ_DIGITAL_INPUT_PARAMS; ++i) {
-			index = GetIndexOfArgument(keys, READ_DIGITAL_INPUT_PARAMS[i], count);
-			if (index >= 0) { /* We found the key in the list */
-				switch (i) { /*Switch on the key not position in arguments list */
-				case 0: /* INPUT key */
-#ifdef COMMAND_DEBUG
-					printf("Processing INPUT key\n\r");
-#endif
-					list_type = GetChannelListType(values[index]);
-					BuildDigitalInputList(list_type, values[index]);
-					break;
-				case 1: /* NUMBER key */
-#ifdef COMMAND_DEBUG
-					printf("Processing NUMBER key\n\r");
-#endif
-					numSamples = strtol(values[index], NULL, 10);
-					break;
-				default:
-					/* Return error */
-					retval = ERR_COMMAND_PARSE_ERROR;
-				}
-			}
-			if (retval != ERR_COMMAND_OK) { /* If there was an error, don't both continuing. */
-				break;
+	if (InputArgsCheck(keys, values, count, NUM_LIST_MATH_CHANNELS_PARAMS, LIST_MATH_CHANNELS_PARAMS)) {
+		uint_fast8_t listed = 0U;
+		AnalogMathChannel_t channel;
+		for (uint_fast8_t i = 0U; i < ANALOG_MATH_MAX_CHANNELS; ++i) {
+			if ((AnalogMath_Get((uint8_t) i, &channel) == true) && (channel.enabled == true)) {
+				snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Math Channel %" PRIu8 ": %s, Raw: %s, Code: %" PRIu8
+						", Inputs: %" PRIu8 ", Evaluations: %" PRIu32 ", Dropped: %" PRIu32, (uint8_t) i, channel.expression,
+						(channel.raw == true) ? STATE_ON_STRING : STATE_OFF_STRING, channel.length, channel.numberInputs,
+						channel.evaluations, channel.dropped);
+				TelnetWriteStatusMessage(TOSTRING_BUFFER);
+				++listed;
 			}
 		}
-		if (retval == ERR_COMMAND_OK) {
-			switch (list_type) {
-			case SINGLE_CHANNEL:
-				DI_Machine_Input_Sample(dInputs, numSamples, true);
-				break;
-			case CHANNEL_SET:
-				DI_Machine_Input_Sample(dInputs, numSamples, false);
-				break;
-			case CHANNEL_RANGE:
-				DI_Machine_Input_Sample(dInputs, numSamples, false);
-				break;
-			case ALL_CHANNELS:
-				DI_Machine_Input_Sample(dInputs, numSamples, false);
-				break;
-			default:
-				/* Return an error */
-				retval = ERR_COMMAND_FUNCTION_ERROR;
-			}
-			CommandStateMoveToDigitalInputSample();
+		if (listed == 0U) {
+			TelnetWriteStatusMessage("No Math Channels Set");
 		}
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
 	}
 	return retval;
 }
 
 /**
- * Execute the ADD_DIGITAL_INPUT command.
+ * Execute the SET_ANALOG_INPUT_AUTO_RANGE command. The INPUT key selects the analog input, the STATE key turns
+ * auto-ranging ON or OFF and the optional GAIN key sets the highest gain it may select. The gain of an auto-ranged
+ * input follows its signal between scans, each change is marked with ANALOG_SAMPLE_FLAG_RANGE and reported with the
+ * new gain before the first sample at it.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_AddDigitalInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+static Tekdaqc_Command_Error_t Ex_SetAnalogInputAutoRange(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+		uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-	if (isDISampling() == FALSE) {
-		if (InputArgsCheck(keys, values, count, NUM_ADD_DIGITAL_INPUT_PARAMS, ADD_DIGITAL_INPUT_PARAMS) == true) {
-			/* Create a new input */
-			Tekdaqc_Function_Error_t status = CreateDigitalInput(keys, values, count);
+	if (isADCSampling() == FALSE) {
+		if (InputArgsCheck(keys, values, count, NUM_SET_ANALOG_INPUT_AUTO_RANGE_PARAMS, SET_ANALOG_INPUT_AUTO_RANGE_PARAMS)) {
+			Tekdaqc_Function_Error_t status = SetAnalogInputAutoRange(keys, values, count);
 			if (status != ERR_FUNCTION_OK) {
-				/* Something went wrong with creating the input */
+				/* Something went wrong with setting the auto-ranging */
 #ifdef COMMAND_DEBUG
-				printf("[Command Interpreter] Creating a new digital input failed with error code: %s.\n\r",
+				printf("[Command Interpreter] Setting analog input auto-ranging failed with error code: %s.\n\r",
 						Tekdaqc_FunctionError_ToString(status));
 #endif
 				lastFunctionError = status;
 				retval = ERR_COMMAND_FUNCTION_ERROR;
 			}
 		} else {
-			/* We can't create a new input */
 #ifdef COMMAND_DEBUG
-			printf("[Command Interpreter] Provided arguments are not valid for creation of a new digital input.\n\r");
+			printf("[Command Interpreter] Provided arguments are not valid for setting analog input auto-ranging.\n\r");
 #endif
 			retval = ERR_COMMAND_BAD_PARAM;
 		}
 	} else {
-		retval = ERR_COMMAND_DI_INVALID_OPERATION;
+		retval = ERR_COMMAND_ADC_INVALID_OPERATION;
 	}
 	return retval;
 }
 
 /**
- * Execute the REMOVE_DIGITAL_INPUT command.
+ * Execute the SET_SENSOR_CHECK command. The SCANS key sets the number of scans between the sensor checks made while
+ * sampling, each of which converts one external or differential input once more with the ADC's sensor detect current
+ * on to find an open circuit. Leaving it out, or 0, turns the checks off. The optional CURRENT key sets the detect
+ * current in microamps, one of 0.5, 2 or 10, 2 by default.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_RemoveDigitalInput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
-		uint8_t count) {
+static Tekdaqc_Command_Error_t Ex_SetSensorCheck(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-	if (isDISampling() == FALSE) {
-		if (InputArgsCheck(keys, values, count, NUM_REMOVE_DIGITAL_INPUT_PARAMS, REMOVE_DIGITAL_INPUT_PARAMS)) {
-			Tekdaqc_Function_Error_t status = RemoveDigitalInput(keys, values, count);
-			if (status != ERR_FUNCTION_OK) {
-				/* Something went wrong with removing the input */
-#ifdef COMMAND_DEBUG
-				printf("[Command Interpreter] Removing a digital input failed with error code: %s.\n\r",
-						Tekdaqc_FunctionError_ToString(status));
-#endif
-				lastFunctionError = status;
-				retval = ERR_COMMAND_FUNCTION_ERROR;
+	if (InputArgsCheck(keys, values, count, NUM_SET_SENSOR_CHECK_PARAMS, SET_SENSOR_CHECK_PARAMS)) {
+		uint32_t interval = 0U;
+		ADS1256_SENSOR_DETECT_t current = ADS1256_SDC_2;
+		int8_t index = GetIndexOfArgument(keys, PARAMETER_SCANS, count);
+		if (index >= 0) {
+			interval = (uint32_t) strtoul(values[index], NULL, 10);
+		}
+		index = GetIndexOfArgument(keys, PARAMETER_CURRENT, count);
+		if (index >= 0) {
+			if (strcmp(values[index], "0.5") == 0) {
+				current = ADS1256_SDC_0_5;
+			} else if (strcmp(values[index], "2") == 0) {
+				current = ADS1256_SDC_2;
+			} else if (strcmp(values[index], "10") == 0) {
+				current = ADS1256_SDC_10;
+			} else {
+				retval = ERR_COMMAND_BAD_PARAM;
 			}
-		} else {
-			/* We can't delete an input */
-#ifdef COMMAND_DEBUG
-			printf("[Command Interpreter] Provided arguments are not valid for removal of a digital input.\n\r");
-#endif
-			retval = ERR_COMMAND_BAD_PARAM;
+		}
+		if (retval == ERR_COMMAND_OK) {
+			ADC_Machine_SetSensorCheck(interval, current);
 		}
 	} else {
-		retval = ERR_COMMAND_DI_INVALID_OPERATION;
+		retval = ERR_COMMAND_BAD_PARAM;
 	}
 	return retval;
 }
 
 /**
- * Execute the LIST_DIGITAL_OUTPUTS command.
+ * Execute the GET_SENSOR_CHECK command. Replies with the number of sensor checks made since start up and the inputs
+ * whose latest check found them open circuit.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_ListDigitalOutputs(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
-		uint8_t count) {
+static Tekdaqc_Command_Error_t Ex_GetSensorCheck(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-	if (InputArgsCheck(keys, values, count, NUM_LIST_DIGITAL_OUTPUTS_PARAMS, LIST_DIGITAL_OUTPUTS_PARAMS)) {
-		Tekdaqc_Function_Error_t status = ListDigitalOutputs();
-		if (status != ERR_FUNCTION_OK) {
-#ifdef COMMAND_DEBUG
-			printf("[Command Interpreter] Listing of digital outputs failed with error: %s.\n\r", Tekdaqc_FunctionError_ToString(status));
-#endif
-			lastFunctionError = status;
-			retval = ERR_COMMAND_FUNCTION_ERROR;
+	if (InputArgsCheck(keys, values, count, NUM_GET_SENSOR_CHECK_PARAMS, GET_SENSOR_CHECK_PARAMS)) {
+		int n = snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Sensor check CHECKS: %" PRIu32 " OPEN:",
+				ADC_Machine_GetSensorCheckCount());
+		bool open = false;
+		for (uint_fast8_t i = 0U; (i < NUM_ANALOG_INPUTS) && (n > 0) && ((size_t) n < sizeof(TOSTRING_BUFFER)); ++i) {
+			if (ADC_Machine_IsSensorOpen((PhysicalAnalogInput_t) i) == true) {
+				n += snprintf(&TOSTRING_BUFFER[n], sizeof(TOSTRING_BUFFER) - (size_t) n, " %" PRIu8, (uint8_t) i);
+				open = true;
+			}
+		}
+		if ((open == false) && (n > 0) && ((size_t) n < sizeof(TOSTRING_BUFFER))) {
+			snprintf(&TOSTRING_BUFFER[n], sizeof(TOSTRING_BUFFER) - (size_t) n, " NONE");
 		}
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
 	} else {
-		/* We can't create a new input */
-#ifdef COMMAND_DEBUG
-		printf("[Command Interpreter] Provided arguments are not valid for listing the digital outputs.\n\r");
-#endif
 		retval = ERR_COMMAND_BAD_PARAM;
 	}
 	return retval;
 }
 
 /**
- * Execute the SET_DIGITAL_OUTPUT command.
+ * Execute the SET_DIGITAL_INPUT_ENCODER command. The NUMBER key selects one of the board's quadrature encoders and the
+ * STATE key turns its decoding ON, from a position of zero, or OFF. While it is on, the encoder's position and velocity
+ * are sampled with every scan of the digital inputs and written out after it, its two inputs remaining readable as
+ * digital inputs.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_SetDigitalOutput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+static Tekdaqc_Command_Error_t Ex_SetDigitalInputEncoder(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
 		uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-	if (InputArgsCheck(keys, values, count, NUM_SET_DIGITAL_OUTPUT_PARAMS, SET_DIGITAL_OUTPUT_PARAMS)) {
-		/* Set digital output */
-		Tekdaqc_Function_Error_t status = SetDigitalOutput(keys, values, count);
-		if (status != ERR_FUNCTION_OK) {
-			/* Something went wrong with setting the output */
-#ifdef COMMAND_DEBUG
-			printf("[Command Interpreter] Setting digital output failed with error code: %i.\n\r", status);
-#endif
-			lastFunctionError = status;
-			retval = ERR_COMMAND_FUNCTION_ERROR;
+	const int8_t numberIndex = GetIndexOfArgument(keys, PARAMETER_NUMBER, count);
+	const int8_t stateIndex = GetIndexOfArgument(keys, PARAMETER_STATE, count);
+	if ((numberIndex >= 0) && (stateIndex >= 0)
+			&& InputArgsCheck(keys, values, count, NUM_SET_DIGITAL_INPUT_ENCODER_PARAMS, SET_DIGITAL_INPUT_ENCODER_PARAMS)) {
+		char* end = NULL;
+		const unsigned long encoder = strtoul(values[numberIndex], &end, 10);
+		if ((end == values[numberIndex]) || (*end != '\0') || (encoder >= NUM_DIGITAL_ENCODERS)) {
+			retval = ERR_COMMAND_BAD_PARAM;
+		} else if (strcmp(values[stateIndex], STATE_ON_STRING) == 0) {
+			DigitalEncoder_Start((uint8_t) encoder);
+		} else if (strcmp(values[stateIndex], STATE_OFF_STRING) == 0) {
+			DigitalEncoder_Stop((uint8_t) encoder);
+		} else {
+			retval = ERR_COMMAND_BAD_PARAM;
 		}
 	} else {
-		/* We can't set an output */
 #ifdef COMMAND_DEBUG
-		printf("[Command Interpreter] Provided arguments are not valid for setting a digital output.\n\r");
+		printf("[Command Interpreter] Provided arguments are not valid for setting a digital input encoder.\n\r");
 #endif
 		retval = ERR_COMMAND_BAD_PARAM;
 	}
@@ -1727,70 +6621,62 @@ static Tekdaqc_Command_Error_t Ex_SetDigitalOutput(char keys[][MAX_COMMANDPART_L
 }
 
 /**
- * Execute the READ_DIGITAL_OUTPUT command.
+ * Execute the SET_DIGITAL_INPUT_LATCH command. The STATE key turns pulse latching ON or OFF for the digital input
+ * samplings started after it. While it is on, every edge of a sampled input between two scans is caught by its external
+ * interrupt, and the next scan reports which inputs went high and which went low, so pulses shorter than the sample
+ * period are not missed. Inputs which cannot have their EXTI lines routed together are sampled without the latch.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_ReadDigitalOutput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
+static Tekdaqc_Command_Error_t Ex_SetDigitalInputLatch(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
 		uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-	if (InputArgsCheck(keys, values, count, NUM_READ_DIGITAL_OUTPUT_PARAMS, READ_DIGITAL_OUTPUT_PARAMS)) {
-		int32_t numSamples = 0;
-		Channel_List_t list_type = 0;
-		int8_t index = -1;
-		for (int i = 0; i < NUM_READ_DIGITAL_OUTPUT_PARAMS; ++i) {
-			index = GetIndexOfArgument(keys, READ_DIGITAL_OUTPUT_PARAMS[i], count);
-			if (index >= 0) { /* We found the key in the list */
-				switch (i) { /* Switch on the key not position in arguments list */
-				case 0: /* INPUT key */
-#ifdef COMMAND_DEBUG
-					printf("Processing INPUT key\n\r");
-#endif
-					list_type = GetChannelListType(values[index]);
-					BuildDigitalOutputList(list_type, values[index]);
-					break;
-				case 1: /* NUMBER key */
+	const int8_t stateIndex = GetIndexOfArgument(keys, PARAMETER_STATE, count);
+	if ((stateIndex >= 0) && InputArgsCheck(keys, values, count, NUM_SET_DIGITAL_INPUT_LATCH_PARAMS, SET_DIGITAL_INPUT_LATCH_PARAMS)) {
+		if (strcmp(values[stateIndex], STATE_ON_STRING) == 0) {
+			DI_Machine_SetLatch(true);
+		} else if (strcmp(values[stateIndex], STATE_OFF_STRING) == 0) {
+			DI_Machine_SetLatch(false);
+		} else {
+			retval = ERR_COMMAND_BAD_PARAM;
+		}
+	} else {
 #ifdef COMMAND_DEBUG
-					printf("Processing NUMBER key\n\r");
+		printf("[Command Interpreter] Provided arguments are not valid for setting digital input latching.\n\r");
 #endif
-					numSamples = strtol(values[index], NULL, 10);
-					break;
-				default:
-					/* Return error */
-					retval = ERR_COMMAND_PARSE_ERROR;
-				}
-			}
-			if (retval != ERR_COMMAND_OK) {
-				break;
-			}
-		}
-		if (retval == ERR_COMMAND_OK) {
-			switch (list_type) {
-			case SINGLE_CHANNEL:
-				DO_Machine_Output_Sample(dOutputs, numSamples, true);
-				break;
-			case CHANNEL_SET:
-				DO_Machine_Output_Sample(dOutputs, numSamples, false);
-				break;
-			case CHANNEL_RANGE:
-				DO_Machine_Output_Sample(dOutputs, numSamples, false);
-				break;
-			case ALL_CHANNELS:
-				DO_Machine_Output_Sample(dOutputs, numSamples, false);
-				break;
-			default:
-				/* Return an error */
-				retval = ERR_COMMAND_FUNCTION_ERROR;
-			}
-			CommandStateMoveToDigitalOutputSample();
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
+	return retval;
+}
+
+/**
+ * Execute the SET_MIXED_SIGNAL command. The STATE key turns ON or OFF the capture of the digital input and output
+ * levels with every analog scan. While it is on, the levels are read as the first sample of each scan is stored and
+ * written into the analog stream after the scan's samples, stamped with that sample's timestamp, so the digital state of
+ * every scan needs no joining with the digital streams. It may be changed while sampling.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_SetMixedSignal(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	const int8_t stateIndex = GetIndexOfArgument(keys, PARAMETER_STATE, count);
+	if ((stateIndex >= 0) && InputArgsCheck(keys, values, count, NUM_SET_MIXED_SIGNAL_PARAMS, SET_MIXED_SIGNAL_PARAMS)) {
+		if (strcmp(values[stateIndex], STATE_ON_STRING) == 0) {
+			AnalogMixed_SetEnabled(true);
+		} else if (strcmp(values[stateIndex], STATE_OFF_STRING) == 0) {
+			AnalogMixed_SetEnabled(false);
+		} else {
+			retval = ERR_COMMAND_BAD_PARAM;
 		}
 	} else {
-		/* We can't read an output */
 #ifdef COMMAND_DEBUG
-		printf("[Command Interpreter] Provided arguments are not valid for reading a digital output.\n\r");
+		printf("[Command Interpreter] Provided arguments are not valid for setting mixed-signal capture.\n\r");
 #endif
 		retval = ERR_COMMAND_BAD_PARAM;
 	}
@@ -1798,140 +6684,179 @@ static Tekdaqc_Command_Error_t Ex_ReadDigitalOutput(char keys[][MAX_COMMANDPART_
 }
 
 /**
- * Execute the ADD_DIGITAL_OUTPUT command.
+ * Execute the SET_LOG_LEVEL command. The LEVEL key sets the highest level of the messages sent out of the debug
+ * serial port, one of NONE, ERROR, WARNING, INFO, DEBUG or TRACE. Messages above it are discarded before they are
+ * formatted, and the rest are sent in the background, so tracing may be left on while sampling.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_AddDigitalOutput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
-		uint8_t count) {
+static Tekdaqc_Command_Error_t Ex_SetLogLevel(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-	if (isDOSampling() == FALSE) {
-		if (InputArgsCheck(keys, values, count, NUM_ADD_DIGITAL_OUTPUT_PARAMS, ADD_DIGITAL_OUTPUT_PARAMS)) {
-			/* Create a new input */
-			Tekdaqc_Function_Error_t status = CreateDigitalOutput(keys, values, count);
-			if (status != ERR_FUNCTION_OK) {
-				/* Something went wrong with creating the output */
-#ifdef COMMAND_DEBUG
-				printf("[Command Interpreter] Creating a new digital output failed with error code: %s.\n\r",
-						Tekdaqc_FunctionError_ToString(status));
-#endif
-				lastFunctionError = status;
-				retval = ERR_COMMAND_FUNCTION_ERROR;
-			}
-		} else {
-			/* We can't create a new output */
+	const int8_t index = GetIndexOfArgument(keys, PARAMETER_LEVEL, count);
+	LogLevel_t level;
+	if ((index >= 0) && InputArgsCheck(keys, values, count, NUM_SET_LOG_LEVEL_PARAMS, SET_LOG_LEVEL_PARAMS)
+			&& (Log_LevelFromString(values[index], &level) == true)) {
+		Log_SetLevel(level);
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Log LEVEL: %s DROPPED: %" PRIu32, Log_StringFromLevel(level),
+				Log_GetDroppedCount());
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
+	} else {
 #ifdef COMMAND_DEBUG
-			printf("[Command Interpreter] Provided arguments are not valid for creation of a new digital output.\n\r");
+		printf("[Command Interpreter] Provided arguments are not valid for setting the log level.\n\r");
 #endif
-			retval = ERR_COMMAND_BAD_PARAM;
-		}
-	} else {
-		retval = ERR_COMMAND_DO_INVALID_OPERATION;
+		retval = ERR_COMMAND_BAD_PARAM;
 	}
 	return retval;
 }
 
 /**
- * Execute the REMOVE_DIGITAL_OUTPUT command.
+ * Execute the READ_STATE_TRACE command. Sends the state machine transitions recorded since the last read as binary
+ * trace frames, see Tekdaqc_StateTrace.c for their layout, then reports how many were sent. If the connection fills
+ * up the rest are kept for the next read.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_RemoveDigitalOutput(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
-		uint8_t count) {
+static Tekdaqc_Command_Error_t Ex_ReadStateTrace(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-	if (isDOSampling() == FALSE) {
-		if (InputArgsCheck(keys, values, count, NUM_REMOVE_DIGITAL_OUTPUT_PARAMS, REMOVE_DIGITAL_OUTPUT_PARAMS)) {
-			Tekdaqc_Function_Error_t status = RemoveDigitalOutput(keys, values, count);
-			if (status != ERR_FUNCTION_OK) {
-				/* Something went wrong with removing the input */
-#ifdef COMMAND_DEBUG
-				printf("[Command Interpreter] Removing an digital output failed with error code: %s.\n\r",
-						Tekdaqc_FunctionError_ToString(status));
-#endif
-				lastFunctionError = status;
-				retval = ERR_COMMAND_FUNCTION_ERROR;
+	if (InputArgsCheck(keys, values, count, NUM_READ_STATE_TRACE_PARAMS, READ_STATE_TRACE_PARAMS)) {
+		uint8_t frame[STATE_TRACE_FRAME_SIZE];
+		uint16_t length;
+		uint32_t sent = 0U;
+		uint16_t events;
+		while ((events = StateTrace_BuildFrame(frame, &length)) > 0U) {
+			if (TelnetWriteBinary(frame, length) != WRITE_OK) {
+				break;
 			}
-		} else {
-			/* We can't delete an output */
-#ifdef COMMAND_DEBUG
-			printf("[Command Interpreter] Provided arguments are not valid for removal of an digital output.\n\r");
-#endif
-			retval = ERR_COMMAND_BAD_PARAM;
+			StateTrace_ConsumeFrame();
+			sent += events;
 		}
+		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "State Trace: Sent: %" PRIu32 ", Pending: %" PRIu32
+				", Recorded: %" PRIu32, sent, StateTrace_GetPending(), StateTrace_GetRecorded());
+		TelnetWriteStatusMessage(TOSTRING_BUFFER);
 	} else {
-		retval = ERR_COMMAND_DO_INVALID_OPERATION;
+		retval = ERR_COMMAND_BAD_PARAM;
 	}
 	return retval;
 }
 
 /**
- * Execute the CLEAR_DIGITAL_OUTPUT_FAULT command.
+ * Execute the SET_KEEPALIVE command, which sets how quickly the Telnet and data server connections of a host which
+ * has vanished without closing them are torn down. IDLE is the time in ms without hearing from the host before the
+ * first keepalive probe, INTERVAL the time in ms between probes and NUMBER the number of unanswered probes after which
+ * the connection is aborted. TIMEOUT is the time in ms the host may leave sent data unacknowledged before it is taken
+ * to be gone, 0 to leave it to TCP's retransmission limit. Each key is optional, the others keeping their values, and
+ * the settings apply to the current connections and to those accepted later. The settings are then written as a
+ * status message.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_ClearDigitalOutputFault(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH],
-		uint8_t count) {
+static Tekdaqc_Command_Error_t Ex_SetKeepalive(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-
-	/* TODO: Clear digital faults */
-
+	if ((count > 0U) && InputArgsCheck(keys, values, count, NUM_SET_KEEPALIVE_PARAMS, SET_KEEPALIVE_PARAMS)) {
+		uint32_t settings[NUM_SET_KEEPALIVE_PARAMS];
+		LwIP_GetKeepalive(&settings[0], &settings[1], &settings[2], &settings[3]);
+		for (int i = 0; i < NUM_SET_KEEPALIVE_PARAMS; ++i) {
+			const int8_t index = GetIndexOfArgument(keys, SET_KEEPALIVE_PARAMS[i], count);
+			if (index >= 0) {
+				settings[i] = (uint32_t) strtoul(values[index], NULL, 10);
+				/* Only the stall timeout may be 0 */
+				if ((settings[i] == 0U) && (i != 3)) {
+					retval = ERR_COMMAND_BAD_PARAM;
+					break;
+				}
+			}
+		}
+		if (retval == ERR_COMMAND_OK) {
+			LwIP_SetKeepalive(settings[0], settings[1], settings[2], settings[3]);
+			snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Keepalive IDLE: %" PRIu32 " ms INTERVAL: %" PRIu32
+					" ms NUMBER: %" PRIu32 " TIMEOUT: %" PRIu32 " ms", settings[0], settings[1], settings[2], settings[3]);
+			TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		}
+	} else {
+#ifdef COMMAND_DEBUG
+		printf("[Command Interpreter] Provided arguments are not valid for setting the keepalive.\n\r");
+#endif
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
 	return retval;
 }
 
 /**
- * Execute the SAMPLE command.
+ * Execute the FORMAT command, which negotiates how sample data is sent. ENCODING selects TEXT records, BINARY frames
+ * or COMPRESSED binary frames, as SET_DATA_FORMAT does. FIELDS selects which of TIMESTAMP, FLAGS and SEQUENCE each
+ * analog sample carries besides its VALUE, as a set such as TIMESTAMP,VALUE. Binary frames always imply the sequence
+ * numbers, and packed records always hold the timestamps and flags, so COMPRESSED needs both of them. Each key is
+ * optional, the other keeping its setting, and once either is given every sampling run starts with a descriptor of
+ * the format and fields, so the client can decode the stream without knowing the firmware. Like the data format the
+ * settings are shared by every session, and can not be changed while the ADC is sampling. The settings are then
+ * written as a status message; with no keys only that is done.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_Sample(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+static Tekdaqc_Command_Error_t Ex_Format(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-	if (InputArgsCheck(keys, values, count, NUM_SAMPLE_PARAMS, SAMPLE_PARAMS)) {
-		int32_t numSamples = 0;
-		int8_t index = -1;
-		for (int i = 0; i < NUM_SAMPLE_PARAMS; ++i) {
-			index = GetIndexOfArgument(keys, SAMPLE_PARAMS[i], count);
-			if (index >= 0) { /* We found the key in the list */
-				switch (i) { /* Switch on the key not position in arguments list */
-				case 0: /* NUMBER key */
-#ifdef COMMAND_DEBUG
-					printf("Processing NUMBER key\n\r");
-#endif
-					numSamples = (int32_t) strtol(values[index], NULL, 10);
-					break;
-				default:
-					/* Return an error */
-					retval = ERR_COMMAND_PARSE_ERROR;
-				}
+	if (InputArgsCheck(keys, values, count, NUM_FORMAT_PARAMS, FORMAT_PARAMS)) {
+		DataFormat_t format = TelnetGetDataFormat();
+		bool compressed = (format == DATA_FORMAT_BINARY) && isAnalogInputCompressionEnabled();
+		uint8_t fields = TelnetGetDataFields();
+		const int8_t encoding = GetIndexOfArgument(keys, PARAMETER_ENCODING, count);
+		const int8_t list = GetIndexOfArgument(keys, PARAMETER_FIELDS, count);
+		if (encoding >= 0) {
+			compressed = (strcmp(values[encoding], FORMAT_COMPRESSED_STRING) == 0);
+			if (strcmp(values[encoding], FORMAT_TEXT_STRING) == 0) {
+				format = DATA_FORMAT_TEXT;
+			} else if ((strcmp(values[encoding], FORMAT_BINARY_STRING) == 0) || (compressed == true)) {
+				format = DATA_FORMAT_BINARY;
+			} else {
+				retval = ERR_COMMAND_BAD_PARAM;
 			}
-			if (retval != ERR_COMMAND_OK) {
-				break; /* If an error occurred, don't bother continuing */
+		}
+		if ((list >= 0) && (ParseDataFields(values[list], &fields) == false)) {
+			retval = ERR_COMMAND_BAD_PARAM;
+		}
+		if ((compressed == true) && ((fields & (DATA_FIELD_TIMESTAMP | DATA_FIELD_FLAGS))
+				!= (DATA_FIELD_TIMESTAMP | DATA_FIELD_FLAGS))) {
+			retval = ERR_COMMAND_BAD_PARAM;
+		}
+		if ((retval == ERR_COMMAND_OK) && (count > 0U)) {
+			if (isADCSampling() == FALSE) {
+				if (format == DATA_FORMAT_BINARY) {
+					ResetAnalogInputBinaryFraming();
+					ResetDigitalInputBinaryFraming();
+				}
+				SetAnalogInputCompression(compressed);
+				TelnetSetDataFormat(format);
+				fields |= DATA_FIELD_DESCRIPTOR;
+				TelnetSetDataFields(fields);
+			} else {
+				retval = ERR_COMMAND_ADC_INVALID_OPERATION;
 			}
 		}
-		if (retval == ERR_COMMAND_OK) { /* If an error occurred, don't bother continuing */
-			BuildAnalogInputList(ALL_CHANNELS, NULL );
-			BuildDigitalInputList(ALL_CHANNELS, NULL );
-			BuildDigitalOutputList(ALL_CHANNELS, NULL );
-			ADC_Machine_Input_Sample(aInputs, numSamples, false);
-			DI_Machine_Input_Sample(dInputs, numSamples, false);
-			DO_Machine_Output_Sample(dOutputs, numSamples, false);
-			CommandStateMoveToGeneralSample();
+		if (retval == ERR_COMMAND_OK) {
+			snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Format ENCODING: %s FIELDS: %s%s%s%s DESCRIPTOR: %s",
+					(format == DATA_FORMAT_TEXT) ? FORMAT_TEXT_STRING :
+							((compressed == true) ? FORMAT_COMPRESSED_STRING : FORMAT_BINARY_STRING),
+					((fields & DATA_FIELD_TIMESTAMP) != 0U) ? FIELD_TIMESTAMP_STRING "," : "", FIELD_VALUE_STRING,
+					((fields & DATA_FIELD_FLAGS) != 0U) ? "," FIELD_FLAGS_STRING : "",
+					((fields & DATA_FIELD_SEQUENCE) != 0U) ? "," FIELD_SEQUENCE_STRING : "",
+					((fields & DATA_FIELD_DESCRIPTOR) != 0U) ? STATE_ON_STRING : STATE_OFF_STRING);
+			TelnetWriteStatusMessage(TOSTRING_BUFFER);
 		}
 	} else {
-		/* We can't create a new input */
 #ifdef COMMAND_DEBUG
-		printf("[Command Interpreter] Provided arguments are not valid for read of an analog input.\n\r");
+		printf("[Command Interpreter] Provided arguments are not valid for setting the format.\n\r");
 #endif
 		retval = ERR_COMMAND_BAD_PARAM;
 	}
@@ -1939,98 +6864,253 @@ static Tekdaqc_Command_Error_t Ex_Sample(char keys[][MAX_COMMANDPART_LENGTH], ch
 }
 
 /**
- * Execute the IDENTIFY command.
+ * Execute the SET_AUX_ANALOG command. The optional STATE key turns ON or OFF the capture of the auxiliary analog
+ * inputs, those read by the processor's own ADC, with every analog scan. While it is on, their readings are taken as
+ * the first sample of each scan is stored and written into the analog stream after the scan's samples, stamped with
+ * that sample's timestamp, so they arrive as extra channels of each frame without slowing the scan. It may be changed
+ * while sampling. The state and the latest reading of each input in millivolts are then written as a status message;
+ * with no keys only that is done.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_Identify(void) {
+static Tekdaqc_Command_Error_t Ex_SetAuxAnalog(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-	unsigned char* serial = Tekdaqc_GetLocatorBoardID();
-	if (serial == '\0') {
-		serial = ((unsigned char*) "None");
+	if (InputArgsCheck(keys, values, count, NUM_SET_AUX_ANALOG_PARAMS, SET_AUX_ANALOG_PARAMS)) {
+		const int8_t stateIndex = GetIndexOfArgument(keys, PARAMETER_STATE, count);
+		if (stateIndex >= 0) {
+			if (strcmp(values[stateIndex], STATE_ON_STRING) == 0) {
+				AnalogAux_SetEnabled(true);
+			} else if (strcmp(values[stateIndex], STATE_OFF_STRING) == 0) {
+				AnalogAux_SetEnabled(false);
+			} else {
+				retval = ERR_COMMAND_BAD_PARAM;
+			}
+		}
+		if (retval == ERR_COMMAND_OK) {
+			int length = snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Aux Analog STATE: %s",
+					(AnalogAux_IsEnabled() == true) ? STATE_ON_STRING : STATE_OFF_STRING);
+			for (uint_fast8_t input = 0U; (input < NUM_AUX_ANALOG_INPUTS) && (length > 0)
+					&& (length < (int) sizeof(TOSTRING_BUFFER)); ++input) {
+				length += snprintf(&TOSTRING_BUFFER[length], sizeof(TOSTRING_BUFFER) - length, " %s: %" PRIu32 " mV",
+						AnalogAux_GetName(input), AnalogAux_ToMillivolts(input, AnalogAux_Read(input)));
+			}
+			TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		}
+	} else {
+#ifdef COMMAND_DEBUG
+		printf("[Command Interpreter] Provided arguments are not valid for setting auxiliary analog capture.\n\r");
+#endif
+		retval = ERR_COMMAND_BAD_PARAM;
 	}
-	uint8_t type = Tekdaqc_GetLocatorBoardType();
-	uint32_t ip = Tekdaqc_GetLocatorIp();
-	unsigned char* MAC = Tekdaqc_GetLocatorMAC();
-	uint32_t version = Tekdaqc_GetLocatorVersion();
-	uint32_t count = 0;
-	count = snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Board Identity");
-	count += snprintf(TOSTRING_BUFFER + count, 51*sizeof(char), "\n\r\tSerial Number: %s", serial);
-	count -= 2;
-	count += snprintf(TOSTRING_BUFFER + count, sizeof(TOSTRING_BUFFER), "\n\r\tBoard Revision: %c\n\r\tFirmware Version: %lu.%lu.%lu.%lu", (char) type,
-			(version & 0xff), ((version >> 8) & 0xff), ((version >> 16) & 0xff), ((version >> 24) & 0xff));
-	count += snprintf(TOSTRING_BUFFER + count, sizeof(TOSTRING_BUFFER), "\n\r\tIP Address: %lu.%lu.%lu.%lu", ip & 0xff, (ip >> 8) & 0xff, (ip >> 16) & 0xff,
-			(ip >> 24) & 0xff);
-	count += snprintf(TOSTRING_BUFFER + count, sizeof(TOSTRING_BUFFER), "\n\r\tMAC Address: %02X:%02X:%02X:%02X:%02X:%02X\n\r", *MAC, *(MAC+1), *(MAC+2),
-			*(MAC+3), *(MAC+4), *(MAC+5));
-	TelnetWriteStatusMessage(TOSTRING_BUFFER);
 	return retval;
 }
 
 /**
- * Execute the SET_RTC command.
+ * Execute the BEGIN_MACRO command. The command lines received after it, up to END_MACRO, are recorded into the macro
+ * of the NAME key, shorter than MACRO_NAME_LENGTH, rather than executed. Nothing is replied to the recorded lines.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_SetRTC(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+static Tekdaqc_Command_Error_t Ex_BeginMacro(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-
-	/* TODO: Set RTC */
-
+	const int8_t nameIndex = GetIndexOfArgument(keys, PARAMETER_NAME, count);
+	if (InputArgsCheck(keys, values, count, NUM_BEGIN_MACRO_PARAMS, BEGIN_MACRO_PARAMS) && (nameIndex >= 0)
+			&& (strlen(values[nameIndex]) > 0U) && (strlen(values[nameIndex]) < MACRO_NAME_LENGTH)
+			&& (interpreter.macro_running == FALSE)) {
+		strcpy(interpreter.macro_name, values[nameIndex]);
+		interpreter.macro_length = 0U;
+		interpreter.macro_overflow = FALSE;
+		interpreter.macro_recording = TRUE;
+	} else {
+#ifdef COMMAND_DEBUG
+		printf("[Command Interpreter] Provided arguments are not valid for recording a macro.\n\r");
+#endif
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
 	return retval;
 }
 
 /**
- * Execute the SET_USER_MAC command.
+ * Execute the END_MACRO command, ending the recording started by BEGIN_MACRO and saving the recorded command lines to
+ * the FLASH disk under the macro's name, replacing any macro already saved under it.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_SetUserMac(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+static Tekdaqc_Command_Error_t Ex_EndMacro(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-
-	/* TODO: Clear user MAC */
-
+	if (InputArgsCheck(keys, values, count, NUM_END_MACRO_PARAMS, END_MACRO_PARAMS)
+			&& (interpreter.macro_recording == TRUE)) {
+		interpreter.macro_recording = FALSE;
+		Tekdaqc_Function_Error_t status = ERR_MACRO_TOO_LONG;
+		if (interpreter.macro_overflow == FALSE) {
+			status = SaveMacro(interpreter.macro_name, macroText, interpreter.macro_length);
+		}
+		if (status != ERR_FUNCTION_OK) {
+#ifdef COMMAND_DEBUG
+			printf("[Command Interpreter] Saving macro %s failed with error code: %i.\n\r", interpreter.macro_name, status);
+#endif
+			lastFunctionError = status;
+			retval = ERR_COMMAND_FUNCTION_ERROR;
+		}
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
 	return retval;
 }
 
 /**
- * Execute the SET_STATIC_IP command.
+ * Execute the RUN_MACRO command, executing each command line of the saved macro of the NAME key in turn. The status
+ * and error replies of the macro's commands are suppressed as in a batch, and a single reply summarizing their
+ * outcome is written once all of them have run. Run within a batch, the macro's commands are tallied as part of it
+ * instead. Macros may not run other macros, nor batch their commands themselves.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_SetStaticIP(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
-	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-
-	/* TODO: Set static IP */
+static Tekdaqc_Command_Error_t Ex_RunMacro(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	const int8_t nameIndex = GetIndexOfArgument(keys, PARAMETER_NAME, count);
+	if (!InputArgsCheck(keys, values, count, NUM_RUN_MACRO_PARAMS, RUN_MACRO_PARAMS) || (nameIndex < 0)
+			|| (interpreter.macro_running == TRUE)) {
+#ifdef COMMAND_DEBUG
+		printf("[Command Interpreter] Provided arguments are not valid for running a macro.\n\r");
+#endif
+		return ERR_COMMAND_BAD_PARAM;
+	}
+	const int8_t slot = FindMacro(values[nameIndex]);
+	if (slot < 0) {
+		lastFunctionError = ERR_MACRO_NOT_SAVED;
+		return ERR_COMMAND_FUNCTION_ERROR;
+	}
+	const uint16_t length = LoadMacro((uint8_t) slot, interpreter.macro_name, macroText);
+	const bool batched = interpreter.batch_active;
+	if (batched == FALSE) {
+		interpreter.batch_active = TRUE;
+		interpreter.batch_count = 0U;
+		interpreter.batch_failures = 0U;
+		interpreter.batch_first_failure = 0U;
+		interpreter.batch_error[0] = '\0';
+	}
+	interpreter.macro_running = TRUE;
+	uint16_t start = 0U;
+	while (start < length) {
+		uint16_t end = start;
+		while ((end < length) && (macroText[end] != MACRO_LINE_SEPARATOR)) {
+			++end;
+		}
+		uint16_t line = end - start;
+		if (line >= MAX_COMMANDLINE_LENGTH) {
+			line = MAX_COMMANDLINE_LENGTH - 1U;
+		}
+		if (line > 0U) {
+			ClearCommandBuffer();
+			memcpy(interpreter.command_buffer, &macroText[start], line);
+			Command_ParseLine();
+		}
+		start = end + 1U;
+	}
+	ClearCommandBuffer();
+	interpreter.macro_running = FALSE;
+	if (batched == FALSE) {
+		interpreter.batch_active = FALSE;
+		if (interpreter.batch_failures == 0U) {
+			snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "SUCCESS - Macro %s of %" PRIu16 " commands completed.",
+					interpreter.macro_name, interpreter.batch_count);
+			TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		} else {
+			snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "FAIL - %" PRIu16 " of %" PRIu16 " commands of macro %s failed,"
+					" first at command %" PRIu16 ": %s", interpreter.batch_failures, interpreter.batch_count,
+					interpreter.macro_name, interpreter.batch_first_failure, interpreter.batch_error);
+			TelnetWriteErrorMessage(TOSTRING_BUFFER);
+		}
+	}
+	return ERR_COMMAND_OK;
+}
 
+/**
+ * Execute the DELETE_MACRO command, deleting the saved macro of the NAME key.
+ *
+ * @param keys char[][] C-String of the command parameter keys.
+ * @param values char[][] C-String of the command parameter values.
+ * @param count uint8_t The number of command parameters.
+ * @retval Tekdaqc_Command_Error_t The command error status.
+ */
+static Tekdaqc_Command_Error_t Ex_DeleteMacro(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
+	const int8_t nameIndex = GetIndexOfArgument(keys, PARAMETER_NAME, count);
+	if (InputArgsCheck(keys, values, count, NUM_DELETE_MACRO_PARAMS, DELETE_MACRO_PARAMS) && (nameIndex >= 0)) {
+		Tekdaqc_Function_Error_t status = DeleteMacro(values[nameIndex]);
+		if (status != ERR_FUNCTION_OK) {
+			lastFunctionError = status;
+			retval = ERR_COMMAND_FUNCTION_ERROR;
+		}
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
 	return retval;
 }
 
 /**
- * Execute the GET_CALIBRATION_STATUS command.
+ * Execute the LIST_MACROS command. Writes the name and length of each saved macro as a status message, or with the
+ * NAME key each command line of that macro, so that a macro can be read back and copied to other boards.
  *
  * @param keys char[][] C-String of the command parameter keys.
  * @param values char[][] C-String of the command parameter values.
  * @param count uint8_t The number of command parameters.
  * @retval Tekdaqc_Command_Error_t The command error status.
  */
-static Tekdaqc_Command_Error_t Ex_GetCalibrationStatus(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
+static Tekdaqc_Command_Error_t Ex_ListMacros(char keys[][MAX_COMMANDPART_LENGTH], char values[][MAX_COMMANDPART_LENGTH], uint8_t count) {
 	Tekdaqc_Command_Error_t retval = ERR_COMMAND_OK;
-	bool valid = isTekdaqc_CalibrationValid();
-	count = snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Calibration Status: %s", (valid == true) ? "VALID" : "INVALID");
-	TelnetWriteStatusMessage(TOSTRING_BUFFER);
+	if (InputArgsCheck(keys, values, count, NUM_LIST_MACROS_PARAMS, LIST_MACROS_PARAMS)) {
+		const int8_t nameIndex = GetIndexOfArgument(keys, PARAMETER_NAME, count);
+		char name[MACRO_NAME_LENGTH];
+		if (nameIndex >= 0) {
+			const int8_t slot = FindMacro(values[nameIndex]);
+			if ((slot < 0) || (interpreter.macro_running == TRUE)) {
+				/* A running macro's text is in use */
+				lastFunctionError = ERR_MACRO_NOT_SAVED;
+				return ERR_COMMAND_FUNCTION_ERROR;
+			}
+			const uint16_t length = LoadMacro((uint8_t) slot, name, macroText);
+			uint16_t start = 0U;
+			while (start < length) {
+				uint16_t end = start;
+				while ((end < length) && (macroText[end] != MACRO_LINE_SEPARATOR)) {
+					++end;
+				}
+				snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Macro %s: %.*s", name, (int) (end - start),
+						&macroText[start]);
+				TelnetWriteStatusMessage(TOSTRING_BUFFER);
+				start = end + 1U;
+			}
+		} else {
+			uint_fast8_t listed = 0U;
+			for (uint_fast8_t slot = 0U; slot < MACRO_COUNT; ++slot) {
+				const uint16_t length = LoadMacro((uint8_t) slot, name, NULL);
+				if (length > 0U) {
+					snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Macro %s, Length: %" PRIu16 " of %u bytes", name,
+							length, MACRO_SIZE);
+					TelnetWriteStatusMessage(TOSTRING_BUFFER);
+					++listed;
+				}
+			}
+			if (listed == 0U) {
+				TelnetWriteStatusMessage("No Macros Saved");
+			}
+		}
+	} else {
+		retval = ERR_COMMAND_BAD_PARAM;
+	}
 	return retval;
 }
 
@@ -2046,6 +7126,63 @@ static Tekdaqc_Command_Error_t Ex_GetCalibrationStatus(char keys[][MAX_COMMANDPA
  */
 void CreateCommandInterpreter(void) {
 	ClearCommandBuffer();
+	BuildCommandHashTable();
+	interpreter.batch_active = FALSE;
+	interpreter.macro_recording = FALSE;
+	interpreter.macro_running = FALSE;
+	interpreter.binary_state = BINARY_FRAME_IDLE;
+}
+
+/**
+ * Starts the saved sampling job, if there is one. The job's publish destination, if it has one, is started first so
+ * that the data is published from the first sample.
+ *
+ * @param none
+ * @retval bool TRUE if a saved job was started.
+ */
+bool StartSavedSamplingJob(void) {
+	SamplingJob_t job;
+	if (LoadSamplingJob(&job) != ERR_FUNCTION_OK) {
+		return FALSE;
+	}
+	if (job.address != 0U && job.port != 0U) {
+		ip_addr_t address;
+		address.addr = job.address;
+		ResetAnalogInputBinaryFraming();
+		ResetDigitalInputBinaryFraming();
+		SamplePublisherStart(&address, job.port);
+	}
+#ifdef COMMAND_DEBUG
+	printf("[Command Interpreter] Starting the saved sampling job.\n\r");
+#endif
+	StartSampling(job.number, job.window, job.period, (ADC_OverflowPolicy_t) job.overflow);
+	return TRUE;
+}
+
+/**
+ * Acts on a start or stop event received from the CAN master, as the SAMPLE and HALT commands would. A start does not
+ * replace a capture which is armed or in progress, since that is started by the trigger instead.
+ *
+ * @param event CAN_SyncEvent_t The received event.
+ * @param argument uint32_t The argument of the event, the number of samples for CAN_SYNC_START.
+ * @retval none
+ */
+void HandleSyncEvent(CAN_SyncEvent_t event, uint32_t argument) {
+	switch (event) {
+	case CAN_SYNC_START:
+		if (AnalogTrigger_GetState() == ANALOG_TRIGGER_IDLE) {
+			StartSampling((int32_t) argument, 0U, 0U, ADC_OVERFLOW_DROP_NEWEST);
+		}
+		break;
+	case CAN_SYNC_STOP:
+		HaltTasks(false);
+		break;
+	case CAN_SYNC_TRIGGER:
+		/* Triggers are handed on by the CAN receive handler and never deferred here */
+	case NUM_CAN_SYNC_EVENTS:
+	default:
+		break;
+	}
 }
 
 /**
@@ -2068,10 +7205,18 @@ void ClearCommandBuffer(void) {
  * @retval none
  */
 void Command_AddChar(const char character) {
-	if (character != 0x00 && interpreter.buffer_position < MAX_COMMANDLINE_LENGTH) {
+	if (interpreter.binary_state != BINARY_FRAME_IDLE) {
+		/* We are part way through a binary frame */
+		AddBinaryByte((uint8_t) character);
+	} else if (character == COMMAND_BINARY_SYNC && interpreter.buffer_position == 0U) {
+		/* A binary frame is starting */
+		interpreter.binary_state = BINARY_FRAME_COMMAND;
+	} else if (character != 0x00 && interpreter.buffer_position < MAX_COMMANDLINE_LENGTH) {
 		if (character == 0x0A || character == 0x0D) {
 			/* We have reached the end of a command, parse it */
+			PROFILE_BEGIN();
 			Command_ParseLine();
+			PROFILE_END(PROFILE_COMMAND_PARSE_LINE);
 			/* Clear the command buffer */
 			ClearCommandBuffer();
 		} else if (character == 0x08 || character == 0x7F) {
@@ -2088,6 +7233,68 @@ void Command_AddChar(const char character) {
 	}
 }
 
+/**
+ * Adds a span of characters to the command buffer. Runs of ordinary characters are copied into the command buffer in
+ * one go, and every line completed by the span is parsed, so a command received in a single packet is processed in a
+ * single call rather than one call per character. Line endings, editing characters and binary frames are handled as
+ * by Command_AddChar().
+ *
+ * @param data const char* Pointer to the characters to add.
+ * @param length uint16_t The number of characters to add.
+ * @retval none
+ */
+void Command_AddChars(const char* data, uint16_t length) {
+	uint16_t i = 0U;
+	while (i < length) {
+		uint16_t run = i;
+		if (interpreter.binary_state == BINARY_FRAME_IDLE && interpreter.buffer_position > 0U) {
+			/* Find the run of ordinary characters continuing the current line */
+			while (run < length && data[run] >= 0x20 && data[run] != 0x7F) {
+				++run;
+			}
+		}
+		if (run > i) {
+			uint16_t copy = run - i;
+			if (copy > (MAX_COMMANDLINE_LENGTH - interpreter.buffer_position)) {
+				/* Characters beyond the end of the buffer are dropped, as they would be one at a time */
+				copy = MAX_COMMANDLINE_LENGTH - interpreter.buffer_position;
+			}
+			memcpy(&interpreter.command_buffer[interpreter.buffer_position], &data[i], copy);
+			interpreter.buffer_position += copy;
+			i = run;
+		} else {
+			Command_AddChar(data[i++]);
+		}
+	}
+}
+
+/**
+ * Determines if the interpreter is between commands, with no partial command line, binary frame, batch or macro
+ * recording pending.
+ * Input from another source may only be added while the interpreter is idle.
+ *
+ * @param none
+ * @retval bool TRUE if the interpreter is idle.
+ */
+bool Command_IsIdle(void) {
+	return ((interpreter.buffer_position == 0U) && (interpreter.binary_state == BINARY_FRAME_IDLE)
+			&& (interpreter.batch_active == FALSE) && (interpreter.macro_recording == FALSE));
+}
+
+/**
+ * Discards any partial command line, binary frame, batch or macro recording, for when the source of the input has
+ * gone away.
+ *
+ * @param none
+ * @retval none
+ */
+void Command_DiscardInput(void) {
+	ClearCommandBuffer();
+	interpreter.binary_state = BINARY_FRAME_IDLE;
+	interpreter.batch_active = FALSE;
+	interpreter.macro_recording = FALSE;
+}
+
 /**
  * Retrieves the last set value for a function error and resets it to ERR_FUNCTION_OK.
  *
@@ -2110,8 +7317,9 @@ Tekdaqc_Function_Error_t GetLastFunctionError(void) {
  */
 int8_t GetIndexOfArgument(char keys[][MAX_COMMANDPART_LENGTH], const char* target, uint8_t total) {
 	int8_t index = -1;
+	uint32_t target_hash = HashString(target);
 	for (uint_fast8_t i = 0U; i < total; ++i) {
-		if (strcmp(keys[i], target) == 0) {
+		if (IsKeyMatch(keys, i, target, target_hash)) {
 			/* Match found */
 			index = i;
 			break;
@@ -0,0 +1,275 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_CrashRecord.c
+ * @brief Implements the Tekdaqc's reset cause and crash record.
+ *
+ * The live record is kept at the start of backup SRAM, which keeps its contents through any reset other than a loss
+ * of power. The status task refreshes its snapshot of the firmware state and the fault handlers add the fault
+ * registers before resetting the board. At start up the live record is copied out, being marked as a watchdog crash
+ * if the watchdog caused the reset, and a fresh one is started.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "Tekdaqc_CrashRecord.h"
+#include "ADC_StateMachine.h"
+#include "CommandState.h"
+#include "TelnetServer.h"
+#include "Tekdaqc_Timers.h"
+#include "Tekdaqc_TimingHistogram.h"
+#include <string.h>
+
+#ifdef CRASH_RECORD_DEBUG
+#include <stdio.h>
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def CRASH_RECORD_MAGIC
+ * @brief The value marking a live record as valid, rather than the random contents of backup SRAM after power up.
+ */
+#define CRASH_RECORD_MAGIC	0x43524153U
+
+/**
+ * @internal
+ * @def LIVE_RECORD
+ * @brief The live crash record, at the start of backup SRAM.
+ */
+#define LIVE_RECORD			((volatile CrashRecord_t*) BKPSRAM_BASE)
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The human readable names of the reset causes, indexed by ResetCause_t */
+static const char* RESET_STRINGS[NUM_RESET_CAUSES] = { "POWER_ON", "BROWN_OUT", "PIN", "SOFTWARE", "WATCHDOG",
+		"WINDOW_WATCHDOG", "LOW_POWER" };
+
+/* The human readable names of the crash causes, indexed by CrashCause_t */
+static const char* CRASH_STRINGS[NUM_CRASH_CAUSES] = { "NONE", "HARD_FAULT", "MEM_MANAGE", "BUS_FAULT",
+		"USAGE_FAULT", "WATCHDOG" };
+
+/* The cause of the last reset */
+static ResetCause_t resetCause = RESET_CAUSE_POWER_ON;
+
+/* The crash record left before the last reset */
+static CrashRecord_t lastRecord;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Records a fault in the live record and resets the board.
+ */
+static void RecordFault(const uint32_t* frame, CrashCause_t cause);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Records a fault in the live record and resets the board. Only the fault registers are written here, as little as
+ * possible being trusted in a fault, so the record keeps the context of the last snapshot.
+ *
+ * @param frame const uint32_t* The exception frame stacked by the faulting code: R0-R3, R12, LR, PC and PSR.
+ * @param cause CrashCause_t The fault which occurred.
+ * @retval none
+ */
+static void RecordFault(const uint32_t* frame, CrashCause_t cause) {
+	volatile CrashRecord_t* record = LIVE_RECORD;
+	record->cause = cause;
+	record->lr = frame[5];
+	record->pc = frame[6];
+	record->psr = frame[7];
+	record->cfsr = SCB->CFSR;
+	record->hfsr = SCB->HFSR;
+	record->bfar = SCB->BFAR;
+	record->mmfar = SCB->MMFAR;
+	record->crashTime = GetLocalTime();
+	record->magic = CRASH_RECORD_MAGIC;
+#ifdef DEBUG
+	/* Stop in the debugger, if one is attached, before the state is lost */
+	if ((CoreDebug->DHCSR & CoreDebug_DHCSR_C_DEBUGEN_Msk) != 0U) {
+		__asm("BKPT #0\n");
+	}
+#endif
+	NVIC_SystemReset();
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Picks up the cause of the last reset and any crash record left before it, then starts a fresh live record. Must be
+ * called at start up once the backup domain is accessible and before the reset flags are cleared.
+ *
+ * @param none
+ * @retval none
+ */
+void CrashRecord_Init(void) {
+	RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_BKPSRAM, ENABLE);
+	/* A power on reset also sets the pin and brown out flags, so it is checked first */
+	if (RCC_GetFlagStatus(RCC_FLAG_IWDGRST) != RESET) {
+		resetCause = RESET_CAUSE_WATCHDOG;
+	} else if (RCC_GetFlagStatus(RCC_FLAG_WWDGRST) != RESET) {
+		resetCause = RESET_CAUSE_WINDOW_WATCHDOG;
+	} else if (RCC_GetFlagStatus(RCC_FLAG_LPWRRST) != RESET) {
+		resetCause = RESET_CAUSE_LOW_POWER;
+	} else if (RCC_GetFlagStatus(RCC_FLAG_SFTRST) != RESET) {
+		resetCause = RESET_CAUSE_SOFTWARE;
+	} else if (RCC_GetFlagStatus(RCC_FLAG_PORRST) != RESET) {
+		resetCause = RESET_CAUSE_POWER_ON;
+	} else if (RCC_GetFlagStatus(RCC_FLAG_BORRST) != RESET) {
+		resetCause = RESET_CAUSE_BROWN_OUT;
+	} else {
+		resetCause = RESET_CAUSE_PIN;
+	}
+
+	memset(&lastRecord, 0, sizeof(lastRecord));
+	if ((resetCause != RESET_CAUSE_POWER_ON) && (resetCause != RESET_CAUSE_BROWN_OUT)
+			&& (LIVE_RECORD->magic == CRASH_RECORD_MAGIC)) {
+		memcpy(&lastRecord, (const void*) LIVE_RECORD, sizeof(lastRecord));
+		if ((lastRecord.cause == CRASH_NONE) && (resetCause == RESET_CAUSE_WATCHDOG)) {
+			/* The watchdog leaves no registers, but the snapshot shows what the firmware was doing */
+			lastRecord.cause = CRASH_WATCHDOG;
+		}
+		if (lastRecord.cause >= NUM_CRASH_CAUSES) {
+			lastRecord.cause = CRASH_NONE;
+		}
+	}
+#ifdef CRASH_RECORD_DEBUG
+	printf("[Crash Record] Reset by %s, crash %s.\n\r", RESET_STRINGS[resetCause], CRASH_STRINGS[lastRecord.cause]);
+#endif
+
+	volatile CrashRecord_t* record = LIVE_RECORD;
+	memset((void*) record, 0, sizeof(CrashRecord_t));
+	record->magic = CRASH_RECORD_MAGIC;
+}
+
+/**
+ * Takes a snapshot of the state of the firmware into the live record, where it is kept should the board crash
+ * before the next snapshot. Called periodically from the program loop.
+ *
+ * @param none
+ * @retval none
+ */
+void CrashRecord_Snapshot(void) {
+	volatile CrashRecord_t* record = LIVE_RECORD;
+	record->snapshotTime = GetLocalTime();
+	record->adcState = (uint32_t) ADC_Machine_GetState();
+	record->sampling = ((isADCSampling() == TRUE) ? CRASH_SAMPLING_ADC : 0U)
+			| ((isDISampling() == TRUE) ? CRASH_SAMPLING_DI : 0U) | ((isDOSampling() == TRUE) ? CRASH_SAMPLING_DO : 0U);
+	record->bufferedSamples = ADC_Machine_GetBufferedSampleCount();
+	record->adcOverruns = ADC_Machine_GetOverrunCount();
+	record->telnetBuffered = TelnetGetBufferUsed();
+	TimingHistogramData_t loop;
+	if (TimingHistogram_Get(TIMING_LOOP_PERIOD, &loop) == true) {
+		record->longestLoop = loop.max;
+	}
+}
+
+/**
+ * Records a hard fault and resets the board. Called from HardFault_Handler() with the stacked exception frame.
+ *
+ * @param frame const uint32_t* The exception frame of the faulting code.
+ * @retval none
+ */
+void CrashRecord_HardFault(const uint32_t* frame) {
+	RecordFault(frame, CRASH_HARD_FAULT);
+}
+
+/**
+ * Records a memory management fault and resets the board. Called from MemManage_Handler() with the stacked
+ * exception frame.
+ *
+ * @param frame const uint32_t* The exception frame of the faulting code.
+ * @retval none
+ */
+void CrashRecord_MemManage(const uint32_t* frame) {
+	RecordFault(frame, CRASH_MEM_MANAGE);
+}
+
+/**
+ * Records a bus fault and resets the board. Called from BusFault_Handler() with the stacked exception frame.
+ *
+ * @param frame const uint32_t* The exception frame of the faulting code.
+ * @retval none
+ */
+void CrashRecord_BusFault(const uint32_t* frame) {
+	RecordFault(frame, CRASH_BUS_FAULT);
+}
+
+/**
+ * Records a usage fault and resets the board. Called from UsageFault_Handler() with the stacked exception frame.
+ *
+ * @param frame const uint32_t* The exception frame of the faulting code.
+ * @retval none
+ */
+void CrashRecord_UsageFault(const uint32_t* frame) {
+	RecordFault(frame, CRASH_USAGE_FAULT);
+}
+
+/**
+ * Retrieves the cause of the last reset.
+ *
+ * @param none
+ * @retval ResetCause_t The cause of the last reset.
+ */
+ResetCause_t CrashRecord_GetResetCause(void) {
+	return resetCause;
+}
+
+/**
+ * Retrieves the crash record left before the last reset. Its cause is CRASH_NONE if the run ended normally.
+ *
+ * @param none
+ * @retval const CrashRecord_t* The crash record.
+ */
+const CrashRecord_t* CrashRecord_GetLast(void) {
+	return &lastRecord;
+}
+
+/**
+ * Return the human readable string representation of the provided reset cause.
+ *
+ * @param cause ResetCause_t The cause to convert.
+ * @retval const char* The human readable string, or NULL if the cause is invalid.
+ */
+const char* CrashRecord_StringFromResetCause(ResetCause_t cause) {
+	return (cause < NUM_RESET_CAUSES) ? RESET_STRINGS[cause] : NULL;
+}
+
+/**
+ * Return the human readable string representation of the provided crash cause.
+ *
+ * @param cause CrashCause_t The cause to convert.
+ * @retval const char* The human readable string, or NULL if the cause is invalid.
+ */
+const char* CrashRecord_StringFromCrashCause(CrashCause_t cause) {
+	return (cause < NUM_CRASH_CAUSES) ? CRASH_STRINGS[cause] : NULL;
+}
@@ -30,22 +30,37 @@
 #include "TelnetServer.h"
 #include <stdlib.h>
 
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
 
+/* The STATUS_EVENT_ bits signaled since the last status check */
+static volatile uint32_t statusEvents = 0U;
 
 /*--------------------------------------------------------------------------------------------------------*/
 /* PUBLIC METHODS */
 /*--------------------------------------------------------------------------------------------------------*/
 
 /**
- * Checks the overall error status of the Tekdaqc. Currently this consists only of checking the digital output
- * error conditions. Future firmware can expand upon this.
+ * Checks the overall error status of the Tekdaqc. Faults are signaled as status events by the code which detects
+ * them, so nothing is scanned here unless an event is pending. The background diagnosis of the digital outputs is
+ * serviced first, as it is what signals their faults.
  *
  * @param none
  * @retval none
  */
 void Tekdaqc_CheckStatus(void) {
-	/* Check on the digital outputs */
-	if (CheckDigitalOutputStatus() == true) {
+	CheckDigitalOutputStatus();
+	if (statusEvents == 0U) {
+		return;
+	}
+	/* Take the pending events, leaving any signaled from here on for the next check */
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	const uint32_t events = statusEvents;
+	statusEvents = 0U;
+	__set_PRIMASK(primask);
+	if ((events & STATUS_EVENT_DOUT_FAULT) != 0U) {
 		if (TelnetIsConnected() == true) {
 			/* A fault was detected */
 			uint8_t n = snprintf(TOSTRING_BUFFER, SIZE_TOSTRING_BUFFER, "\n\r*DIGITAL OUTPUT FAULT DETECTED!*\n\r");
@@ -60,6 +75,19 @@ void Tekdaqc_CheckStatus(void) {
 	}
 }
 
+/**
+ * Signals status events to be reported by the next status check. May be called from interrupts.
+ *
+ * @param events uint32_t The STATUS_EVENT_ bits to signal.
+ * @retval none
+ */
+void Tekdaqc_SignalStatusEvent(uint32_t events) {
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	statusEvents |= events;
+	__set_PRIMASK(primask);
+}
+
 /**
  * Converts the specified Tekdaqc_Command_Error_t into a human readable string.
  *
@@ -85,6 +113,9 @@ const char* Tekdaqc_FunctionError_ToString(Tekdaqc_Function_Error_t error) {
 			"AIN: FAILED WRITE", "DIN: INPUT OUT OF RANGE", "DIN: PARSE MISSING KEY", "DIN: INPUT NOT FOUND",
 			"DIN: PARSE ERROR", "DIN: INPUT UNSPECIFIED", "DIN: INPUT EXISTS", "DIN: FAILED WRITE",
 			"DOUT: OUTPUT OUT OF RANGE", "DOUT: PARSE MISSING KEY", "OUT: OUTPUT NOT FOUND", "DOUT: PARSE ERROR",
-			"DOUT: OUTPUT EXISTS", "DOUT: OUTPUT UNSPECIFIED", "DOUT: DOES NOT EXIST", "DOUT: FAILED WRITE"};
+			"DOUT: OUTPUT EXISTS", "DOUT: OUTPUT UNSPECIFIED", "DOUT: DOES NOT EXIST", "DOUT: FAILED WRITE",
+			"DOUT: SEQUENCE FULL", "DOUT: SEQUENCE INVALID", "DOUT: SEQUENCE RUNNING",
+			"CONFIG: NOT SAVED", "CONFIG: WRITE FAILED", "JOB: NOT SAVED", "UPGRADE: NOT STAGED",
+			"MACRO: NOT SAVED", "MACRO: TABLE FULL", "MACRO: TOO LONG"};
 	return strings[error];
 }
@@ -0,0 +1,514 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Http.c
+ * @brief Implements the Tekdaqc's HTTP documents.
+ *
+ * Provides the documents served by the HTTP server, each read in place from where the Tekdaqc keeps it:
+ *
+ *   /status   application/json  The identity of the board and the state of the documents below.
+ *   /capture  binary            The codes of the last burst capture, 3 bytes each, least significant byte first.
+ *   /log      binary            The sample log sector as programmed, see Tekdaqc_SampleLog.c for its layout.
+ *   /trace    binary            The state trace frames not yet read, see Tekdaqc_StateTrace.c for their layout.
+ *   /stream   WebSocket         The sample records as they are written, and a table of latest values.
+ *
+ * The capture and log are snapshotted when requested; a document which changes under a download, because a new
+ * capture is started or the log is erased, aborts the download rather than sending a mix of old and new. The trace
+ * is read like READ_STATE_TRACE does, so downloading it marks the transitions sent as read, and only those pending
+ * when it was requested are sent.
+ *
+ * A client of the stream is sent every text or binary sample record the board writes, with the analog binary framing
+ * restarted when it joins so its first frames carry the input configuration. The table of latest values is sent at
+ * the interval asked for, see WebSocketServer.c, and is framed like the binary sample records. All multi-byte fields
+ * are little endian:
+ *
+ *   Frame:   [HTTP_TABLE_FRAME_START][length:2][timestamp:8][count][entries...][inputs:3][outputs:4]
+ *   Entry:   [input][value:4][flags][age:2]
+ *
+ * An entry is sent for each analog input which has been measured since it was added, its age being the milliseconds
+ * since, saturating at 0xFFFF. Bit n of inputs is set if GPIn is added and high, and bit n of outputs if output n is
+ * added and on.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "Tekdaqc_Http.h"
+#include "ADC_StateMachine.h"
+#include "Analog_Input.h"
+#include "Tekdaqc_SampleLog.h"
+#include "Tekdaqc_StateTrace.h"
+#include "Digital_Input.h"
+#include "Digital_Output.h"
+#include "WebSocketServer.h"
+#include "Tekdaqc_Locator.h"
+#include "Tekdaqc_Timers.h"
+#include "Tekdaqc_BSP.h"
+#include "netconf.h"
+#include <stdio.h>
+#include <inttypes.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def HTTP_TABLE_FRAME_START
+ * @brief The first byte of a table of latest values, distinct from the start of every other sample record.
+ */
+#define HTTP_TABLE_FRAME_START		((uint8_t) 0x1F)
+
+/**
+ * @internal
+ * @def HTTP_TABLE_HEADER_SIZE
+ * @brief The size of the start, length, timestamp and count of a table of latest values.
+ */
+#define HTTP_TABLE_HEADER_SIZE		12U
+
+/**
+ * @internal
+ * @def HTTP_TABLE_ENTRY_SIZE
+ * @brief The size of an analog input entry of a table of latest values.
+ */
+#define HTTP_TABLE_ENTRY_SIZE		8U
+
+/**
+ * @internal
+ * @def HTTP_TABLE_TRAILER_SIZE
+ * @brief The size of the digital input and output levels of a table of latest values.
+ */
+#define HTTP_TABLE_TRAILER_SIZE		7U
+
+/**
+ * @internal
+ * @def HTTP_TABLE_MAX_AGE
+ * @brief The age sent for a measurement older than the age field can hold.
+ */
+#define HTTP_TABLE_MAX_AGE			0xFFFFU
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Formats the status document.
+ */
+static bool HttpOpenStatus(void);
+
+/**
+ * @internal
+ * @brief Reads the status document.
+ */
+static bool HttpReadStatus(uint32_t offset, const uint8_t** data, uint32_t* length);
+
+/**
+ * @internal
+ * @brief Snapshots the burst capture.
+ */
+static bool HttpOpenCapture(void);
+
+/**
+ * @internal
+ * @brief Reads the burst capture codes.
+ */
+static bool HttpReadCapture(uint32_t offset, const uint8_t** data, uint32_t* length);
+
+/**
+ * @internal
+ * @brief Snapshots the sample log.
+ */
+static bool HttpOpenLog(void);
+
+/**
+ * @internal
+ * @brief Reads the sample log sector.
+ */
+static bool HttpReadLog(uint32_t offset, const uint8_t** data, uint32_t* length);
+
+/**
+ * @internal
+ * @brief Starts reading the state trace.
+ */
+static bool HttpOpenTrace(void);
+
+/**
+ * @internal
+ * @brief Reads the state trace frames.
+ */
+static bool HttpReadTrace(uint32_t offset, const uint8_t** data, uint32_t* length);
+
+/**
+ * @internal
+ * @brief Hands a stream request over to the WebSocket server.
+ */
+static HttpUpgradeResult_t HttpUpgradeStream(struct tcp_pcb* pcb, const char* query, const char* headers);
+
+/**
+ * @internal
+ * @brief Builds the table of latest values sent to stream clients.
+ */
+static uint16_t HttpBuildTable(uint8_t* buffer, uint16_t size);
+
+/**
+ * @internal
+ * @brief Writes a little endian value to a buffer.
+ */
+static uint8_t* HttpPutLittleEndian(uint8_t* buffer, uint64_t value, uint_fast8_t size);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief The Tekdaqc's HTTP documents.
+ */
+static const HttpResource_t tekdaqcHttpResources[] = {
+	{ "/status", "application/json", HttpOpenStatus, HttpReadStatus, NULL },
+	{ "/capture", "application/octet-stream", HttpOpenCapture, HttpReadCapture, NULL },
+	{ "/log", "application/octet-stream", HttpOpenLog, HttpReadLog, NULL },
+	{ "/trace", "application/octet-stream", HttpOpenTrace, HttpReadTrace, NULL },
+	{ "/stream", "application/octet-stream", NULL, NULL, HttpUpgradeStream }
+};
+
+/**
+ * @internal
+ * @brief The status document, formatted when it is requested.
+ */
+static char statusDocument[HTTP_STATUS_DOCUMENT_SIZE];
+
+/**
+ * @internal
+ * @brief The length of the status document.
+ */
+static uint32_t statusLength = 0U;
+
+/**
+ * @internal
+ * @brief The burst capture being downloaded.
+ */
+static ADC_BurstCapture_t capture;
+
+/**
+ * @internal
+ * @brief The number of bytes of the sample log sector being downloaded.
+ */
+static uint32_t logLength = 0U;
+
+/**
+ * @internal
+ * @brief The trace frame being downloaded.
+ */
+static uint8_t traceFrame[STATE_TRACE_FRAME_SIZE];
+
+/**
+ * @internal
+ * @brief The document offset of the start of traceFrame, and its length.
+ */
+static uint32_t traceFrameOffset = 0U;
+static uint16_t traceFrameLength = 0U;
+
+/**
+ * @internal
+ * @brief The number of transitions left to send of those pending when the trace was requested.
+ */
+static uint32_t traceRemaining = 0U;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * Formats the status document, a single JSON object. Times are in microseconds of local time and sizes in bytes.
+ *
+ * @param none
+ * @retval bool TRUE if the document fit its buffer.
+ */
+static bool HttpOpenStatus(void) {
+	ADC_BurstCapture_t burst;
+	ADC_Machine_GetBurstCapture(&burst);
+	SampleLogCounts_t log;
+	SampleLog_GetCounts(&log);
+	uint32_t downs;
+	uint32_t recovery;
+	LwIP_GetLinkRecovery(&downs, &recovery);
+	const uint32_t version = Tekdaqc_GetLocatorVersion();
+	const uint32_t ip = Tekdaqc_GetLocatorIp();
+	int count = snprintf(statusDocument, sizeof(statusDocument),
+			"{\"serial\":\"%.*s\",\"firmware\":\"%" PRIu32 ".%" PRIu32 ".%" PRIu32 ".%" PRIu32
+			"\",\"ip\":\"%" PRIu32 ".%" PRIu32 ".%" PRIu32 ".%" PRIu32 "\",\"time\":%" PRIu64
+			",\"adc\":{\"state\":%u,\"conversions\":%" PRIu32 "}"
+			",\"capture\":{\"input\":%u,\"count\":%" PRIu32 ",\"capacity\":%" PRIu32 ",\"start\":%" PRIu64
+			",\"end\":%" PRIu64 ",\"active\":%s}"
+			",\"log\":{\"used\":%" PRIu32 ",\"backlog\":%" PRIu32 ",\"first\":%" PRIu32 ",\"next\":%" PRIu32
+			",\"last\":%" PRIu32 ",\"logged\":%" PRIu32 ",\"replayed\":%" PRIu32 ",\"dropped\":%" PRIu32 "}"
+			",\"trace\":{\"recorded\":%" PRIu32 ",\"pending\":%" PRIu32 "}"
+			",\"network\":{\"link\":%s,\"downs\":%" PRIu32 ",\"recovery\":%" PRIu32 "}"
+			",\"http\":{\"requests\":%" PRIu32 "}"
+			",\"stream\":{\"clients\":%s,\"dropped\":%" PRIu32 "}}\n",
+			BOARD_SERIAL_NUM_LENGTH, (const char*) Tekdaqc_GetLocatorBoardID(), (version & 0xff),
+			((version >> 8) & 0xff), ((version >> 16) & 0xff), ((version >> 24) & 0xff), ip & 0xff, (ip >> 8) & 0xff,
+			(ip >> 16) & 0xff, (ip >> 24) & 0xff, GetLocalTime(), (unsigned int) ADC_Machine_GetState(),
+			ADC_Machine_GetConversionCount(), (unsigned int) burst.input, burst.count, burst.capacity, burst.start,
+			burst.end, (burst.active == true) ? "true" : "false", log.used, log.backlog, log.firstSequence,
+			log.nextSequence, log.lastSequence, log.logged, log.replayed, log.dropped, StateTrace_GetRecorded(),
+			StateTrace_GetPending(), (LwIP_IsLinkUp() == true) ? "true" : "false", downs, recovery,
+			HttpServerGetRequestCount(), (WebSocketHasClients() == true) ? "true" : "false",
+			WebSocketGetDroppedCount());
+	if ((count <= 0) || (count >= (int) sizeof(statusDocument))) {
+		return false;
+	}
+	statusLength = (uint32_t) count;
+	return true;
+}
+
+/**
+ * @internal
+ * Reads the status document formatted by HttpOpenStatus().
+ *
+ * @param offset uint32_t The offset into the document to read from.
+ * @param data const uint8_t** Set to the bytes at offset.
+ * @param length uint32_t* Set to the number of bytes at data, 0 at the end of the document.
+ * @retval bool TRUE, the document is always readable.
+ */
+static bool HttpReadStatus(uint32_t offset, const uint8_t** data, uint32_t* length) {
+	*data = (const uint8_t*) &statusDocument[offset];
+	*length = (offset < statusLength) ? (statusLength - offset) : 0U;
+	return true;
+}
+
+/**
+ * @internal
+ * Snapshots the burst capture to download. A capture which is still converting is not served.
+ *
+ * @param none
+ * @retval bool TRUE if the capture is complete.
+ */
+static bool HttpOpenCapture(void) {
+	ADC_Machine_GetBurstCapture(&capture);
+	return (capture.active == false);
+}
+
+/**
+ * @internal
+ * Reads the codes of the burst capture snapshotted by HttpOpenCapture(), straight from the capture buffer.
+ *
+ * @param offset uint32_t The offset into the document to read from.
+ * @param data const uint8_t** Set to the bytes at offset.
+ * @param length uint32_t* Set to the number of bytes at data, 0 at the end of the document.
+ * @retval bool FALSE if a new capture has been started since.
+ */
+static bool HttpReadCapture(uint32_t offset, const uint8_t** data, uint32_t* length) {
+	ADC_BurstCapture_t current;
+	ADC_Machine_GetBurstCapture(&current);
+	if ((current.active == true) || (current.start != capture.start) || (current.count != capture.count)) {
+		return false;
+	}
+	const uint32_t size = capture.count * ANALOG_SAMPLE_VALUE_SIZE;
+	*data = &ADC_Machine_GetBurstCaptureCodes()[offset];
+	*length = (offset < size) ? (size - offset) : 0U;
+	return true;
+}
+
+/**
+ * @internal
+ * Snapshots the extent of the sample log sector to download. The log is not served while it is being erased.
+ *
+ * @param none
+ * @retval bool TRUE if the log sector may be read.
+ */
+static bool HttpOpenLog(void) {
+	SampleLogCounts_t counts;
+	SampleLog_GetCounts(&counts);
+	logLength = counts.used;
+	return (SampleLog_IsErasing() == false);
+}
+
+/**
+ * @internal
+ * Reads the sample log sector from its start, straight from FLASH, up to the extent snapshotted by HttpOpenLog().
+ * Records programmed since are left for the next download.
+ *
+ * @param offset uint32_t The offset into the document to read from.
+ * @param data const uint8_t** Set to the bytes at offset.
+ * @param length uint32_t* Set to the number of bytes at data, 0 at the end of the document.
+ * @retval bool FALSE if the log sector has been erased since.
+ */
+static bool HttpReadLog(uint32_t offset, const uint8_t** data, uint32_t* length) {
+	SampleLogCounts_t counts;
+	SampleLog_GetCounts(&counts);
+	if ((SampleLog_IsErasing() == true) || (counts.used < logLength)) {
+		return false;
+	}
+	*data = &((const uint8_t*) SAMPLE_LOG_BASE)[offset];
+	*length = (offset < logLength) ? (logLength - offset) : 0U;
+	return true;
+}
+
+/**
+ * @internal
+ * Starts reading the state trace, noting how many transitions are pending so a busy trace can not keep the
+ * download going forever.
+ *
+ * @param none
+ * @retval bool TRUE, the trace is always readable.
+ */
+static bool HttpOpenTrace(void) {
+	traceRemaining = StateTrace_GetPending();
+	if (traceRemaining > STATE_TRACE_SIZE) {
+		traceRemaining = STATE_TRACE_SIZE;
+	}
+	traceFrameOffset = 0U;
+	traceFrameLength = 0U;
+	return true;
+}
+
+/**
+ * @internal
+ * Reads the state trace a frame at a time. Once the server has read past the end of a frame it is marked read and
+ * the next one is built, until the transitions pending at the request have been sent.
+ *
+ * @param offset uint32_t The offset into the document to read from.
+ * @param data const uint8_t** Set to the bytes at offset.
+ * @param length uint32_t* Set to the number of bytes at data, 0 at the end of the document.
+ * @retval bool TRUE, the trace is always readable.
+ */
+static bool HttpReadTrace(uint32_t offset, const uint8_t** data, uint32_t* length) {
+	if (offset >= (traceFrameOffset + traceFrameLength)) {
+		if (traceFrameLength > 0U) {
+			StateTrace_ConsumeFrame();
+			traceFrameLength = 0U;
+		}
+		traceFrameOffset = offset;
+		if (traceRemaining > 0U) {
+			const uint16_t events = StateTrace_BuildFrame(traceFrame, &traceFrameLength);
+			if (events == 0U) {
+				traceFrameLength = 0U;
+			}
+			traceRemaining = (events < traceRemaining) ? (traceRemaining - events) : 0U;
+		}
+	}
+	*data = &traceFrame[offset - traceFrameOffset];
+	*length = (traceFrameOffset + traceFrameLength) - offset;
+	return true;
+}
+
+/**
+ * @internal
+ * Hands a stream request over to the WebSocket server. A client which joins has missed the input configuration
+ * records of the analog binary framing, so the framing is restarted to send them again with the next frame.
+ *
+ * @param pcb tcp_pcb* struct The PCB of the connection.
+ * @param query const char* The query string of the request.
+ * @param headers const char* The headers of the request.
+ * @retval HttpUpgradeResult_t The result of the handshake.
+ */
+static HttpUpgradeResult_t HttpUpgradeStream(struct tcp_pcb* pcb, const char* query, const char* headers) {
+	HttpUpgradeResult_t result = WebSocketServerUpgrade(pcb, query, headers);
+	if (result == HTTP_UPGRADE_OK) {
+		ResetAnalogInputBinaryFraming();
+	}
+	return result;
+}
+
+/**
+ * @internal
+ * Builds the table of latest values, laid out as described at the top of this file.
+ *
+ * @param buffer uint8_t* Pointer to the buffer to build the table in.
+ * @param size uint16_t The size of the buffer.
+ * @retval uint16_t The length of the table.
+ */
+static uint16_t HttpBuildTable(uint8_t* buffer, uint16_t size) {
+	const uint64_t now = GetLocalTime();
+	uint8_t* out = &buffer[HTTP_TABLE_HEADER_SIZE];
+	uint8_t count = 0U;
+	for (uint_fast8_t number = 0U; number < NUM_ANALOG_INPUTS; ++number) {
+		AnalogLatestSample_t sample;
+		if ((out + HTTP_TABLE_ENTRY_SIZE + HTTP_TABLE_TRAILER_SIZE) > &buffer[size]) {
+			break;
+		}
+		if ((GetLatestAnalogSample(number, &sample) == false) || (sample.timestamp == 0U)) {
+			continue;
+		}
+		const uint64_t age = (now - sample.timestamp) / 1000U;
+		*out++ = (uint8_t) number;
+		out = HttpPutLittleEndian(out, (uint32_t) sample.value, 4U);
+		*out++ = sample.flags;
+		out = HttpPutLittleEndian(out, (age < HTTP_TABLE_MAX_AGE) ? age : HTTP_TABLE_MAX_AGE, 2U);
+		++count;
+	}
+	uint32_t inputs = 0U;
+	for (uint_fast8_t i = 0U; i < NUM_DIGITAL_INPUTS; ++i) {
+		const Digital_Input_t* input = GetDigitalInputByNumber(i);
+		if ((input != NULL) && (input->added == CHANNEL_ADDED) && (ReadDigitalInputLevel(input) == LOGIC_HIGH)) {
+			inputs |= (1UL << i);
+		}
+	}
+	uint32_t outputs = 0U;
+	for (uint_fast8_t i = 0U; i < NUM_DIGITAL_OUTPUTS; ++i) {
+		const Digital_Output_t* output = GetDigitalOutputByNumber(i);
+		if ((output != NULL) && (output->added == CHANNEL_ADDED) && (output->level == OUTPUT_ON)) {
+			outputs |= (1UL << i);
+		}
+	}
+	out = HttpPutLittleEndian(out, inputs, 3U);
+	out = HttpPutLittleEndian(out, outputs, 4U);
+	const uint16_t length = (uint16_t) (out - buffer);
+	buffer[0] = HTTP_TABLE_FRAME_START;
+	HttpPutLittleEndian(&buffer[1], length, 2U);
+	HttpPutLittleEndian(&buffer[3], now, 8U);
+	buffer[11] = count;
+	return length;
+}
+
+/**
+ * @internal
+ * Writes a value to a buffer, least significant byte first.
+ *
+ * @param buffer uint8_t* Pointer to where the value is written.
+ * @param value uint64_t The value to write.
+ * @param size uint_fast8_t The number of bytes to write.
+ * @retval uint8_t* Pointer to the byte after the value.
+ */
+static uint8_t* HttpPutLittleEndian(uint8_t* buffer, uint64_t value, uint_fast8_t size) {
+	for (uint_fast8_t i = 0U; i < size; ++i) {
+		*buffer++ = (uint8_t) (value >> (8U * i));
+	}
+	return buffer;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Starts the HTTP server serving the Tekdaqc's documents on HTTP_PORT, with the WebSocket stream behind it.
+ *
+ * @param none
+ * @retval HttpServerStatus_t The result of starting the server.
+ */
+HttpServerStatus_t Tekdaqc_HttpInit(void) {
+	WebSocketServerInit(HttpBuildTable);
+	return InitializeHttpServer(tekdaqcHttpResources,
+			(uint8_t) (sizeof(tekdaqcHttpResources) / sizeof(tekdaqcHttpResources[0])));
+}
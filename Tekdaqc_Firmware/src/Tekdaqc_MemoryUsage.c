@@ -0,0 +1,127 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_MemoryUsage.c
+ * @brief Implements the Tekdaqc's memory usage report.
+ *
+ * The section sizes are the differences between the start and end symbols the linker script places around each
+ * section, so they always match the image actually running. The stack shares the SRAM1 above the heap, which the
+ * C library grows upwards from the end of the .bss. Before anything else runs, every word between the top of the
+ * heap and the stack pointer is painted with MEMORY_USAGE_STACK_PAINT. The lowest word no longer holding it marks
+ * the deepest the stack, its interrupts included, has reached since.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_MemoryUsage.h"
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* Symbols placed by the linker script, stm32f4_flash.ld. Only their addresses are meaningful. */
+extern uint32_t _estack;
+extern uint32_t _sdata;
+extern uint32_t _edata;
+extern uint32_t _siccmram;
+extern uint32_t _sccmram;
+extern uint32_t _eccmram;
+extern uint32_t _sccmbss;
+extern uint32_t _eccmbss;
+extern uint32_t _sbss;
+extern uint32_t _ebss;
+extern uint32_t _ssram2;
+extern uint32_t _esram2;
+extern uint32_t _end;
+
+/* The C library's heap allocator, implemented in syscalls.c. Its caddr_t is a char* and is not defined in ISO C. */
+extern char* _sbrk(int32_t incr);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Retrieves the lowest word the stack may use, just above the heap.
+ */
+static uint32_t* GetStackLimit(void);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Retrieves the lowest word the stack may use. The heap only grows, so any word below its current top belongs to
+ * the heap and is never counted as stack.
+ *
+ * @param none
+ * @retval uint32_t* The first word aligned address at or above the top of the heap.
+ */
+static uint32_t* GetStackLimit(void) {
+	const uint32_t heapEnd = (uint32_t) _sbrk(0);
+	return (uint32_t*) ((heapEnd + 3U) & ~3U);
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Paints every word between the top of the heap and the stack pointer. Everything below the stack pointer is
+ * unused, so this is safe from anywhere, but it must be called before the interrupts are enabled and before the
+ * program has been deep in the stack, or the peak found later is only the peak since this call.
+ *
+ * @param none
+ * @retval none
+ */
+void MemoryUsage_PaintStack(void) {
+	uint32_t* const top = (uint32_t*) __get_MSP();
+	for (uint32_t* word = GetStackLimit(); word < top; ++word) {
+		*word = MEMORY_USAGE_STACK_PAINT;
+	}
+}
+
+/**
+ * Retrieves the sizes of the memory in use. The stack peak is found by scanning up from the top of the heap for the
+ * first word which is no longer painted, so its cost grows with the free stack. A heap grown over painted words
+ * since start up hides that part of the stack's history, so the peak is never overstated by the heap.
+ *
+ * @param usage MemoryUsage_t* The location to store the sizes.
+ * @retval none
+ */
+void MemoryUsage_Get(MemoryUsage_t* usage) {
+	const uint32_t dataSize = ((uint32_t) &_edata) - ((uint32_t) &_sdata);
+	const uint32_t ccmDataSize = ((uint32_t) &_eccmram) - ((uint32_t) &_sccmram);
+	usage->flash = (((uint32_t) &_siccmram) + ccmDataSize) - FLASH_BASE;
+	usage->data = dataSize;
+	usage->bss = ((uint32_t) &_ebss) - ((uint32_t) &_sbss);
+	usage->ccm = ccmDataSize + (((uint32_t) &_eccmbss) - ((uint32_t) &_sccmbss));
+	usage->sram2 = ((uint32_t) &_esram2) - ((uint32_t) &_ssram2);
+	usage->heap = ((uint32_t) _sbrk(0)) - ((uint32_t) &_end);
+
+	uint32_t* const limit = GetStackLimit();
+	uint32_t* const top = &_estack;
+	uint32_t* word = limit;
+	while ((word < top) && (*word == MEMORY_USAGE_STACK_PAINT)) {
+		++word;
+	}
+	usage->stackPeak = ((uint32_t) top) - ((uint32_t) word);
+	usage->stackSize = ((uint32_t) top) - ((uint32_t) limit);
+}
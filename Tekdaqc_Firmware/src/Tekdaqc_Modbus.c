@@ -0,0 +1,223 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Modbus.c
+ * @brief Implements the Tekdaqc's Modbus register map.
+ *
+ * Maps the Tekdaqc's inputs and outputs onto the Modbus data served by the Modbus server. The analog inputs are
+ * served from the latest value of each input, so a register read never waits on, or disturbs, a conversion. The
+ * input and holding registers are the same read only table, MODBUS_REGISTERS_PER_INPUT registers per analog input.
+ * The discrete inputs are the digital input levels and the coils are the digital outputs, ON when the output is on.
+ * Coils written by a single request are switched together.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "Tekdaqc_Modbus.h"
+#include "Analog_Input.h"
+#include "Digital_Input.h"
+#include "Digital_Output.h"
+#include "Tekdaqc_Timers.h"
+#include "Tekdaqc_BSP.h"
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Reads the analog input registers.
+ */
+static ModbusException_t ModbusReadAnalogRegisters(uint16_t address, uint16_t quantity, uint16_t* registers);
+
+/**
+ * @internal
+ * @brief Reads the digital input levels.
+ */
+static ModbusException_t ModbusReadDigitalInputs(uint16_t address, uint16_t quantity, uint8_t* bits);
+
+/**
+ * @internal
+ * @brief Reads the digital output levels.
+ */
+static ModbusException_t ModbusReadDigitalOutputs(uint16_t address, uint16_t quantity, uint8_t* bits);
+
+/**
+ * @internal
+ * @brief Sets the digital output levels.
+ */
+static ModbusException_t ModbusWriteDigitalOutputs(uint16_t address, uint16_t quantity, const uint8_t* bits);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief The Tekdaqc's Modbus data.
+ */
+static const ModbusMap_t tekdaqcModbusMap = {
+	ModbusReadDigitalOutputs,
+	ModbusReadDigitalInputs,
+	ModbusReadAnalogRegisters,
+	ModbusReadAnalogRegisters,
+	ModbusWriteDigitalOutputs
+};
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * Reads the analog input registers. The first register of each input is the high word of its latest value, the
+ * second the low word, the third its flags and the fourth the milliseconds since it was measured. An input which
+ * is not added or has not been measured reads as 0 with MODBUS_NOT_MEASURED set in its flags.
+ *
+ * @param address uint16_t The first register to read.
+ * @param quantity uint16_t The number of registers to read.
+ * @param registers uint16_t* Pointer to the array to fill in.
+ * @retval ModbusException_t The result of the read.
+ */
+static ModbusException_t ModbusReadAnalogRegisters(uint16_t address, uint16_t quantity, uint16_t* registers) {
+	if (((uint32_t) address + quantity) > (NUM_ANALOG_INPUTS * MODBUS_REGISTERS_PER_INPUT)) {
+		return MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+	}
+	uint64_t now = GetLocalTime();
+	uint16_t end = address + quantity;
+	uint16_t index = address;
+	while (index < end) {
+		uint8_t number = index / MODBUS_REGISTERS_PER_INPUT;
+		AnalogLatestSample_t sample;
+		uint16_t block[MODBUS_REGISTERS_PER_INPUT] = { 0U, 0U, MODBUS_NOT_MEASURED, MODBUS_MAX_AGE };
+		if ((GetLatestAnalogSample(number, &sample) == true) && (sample.timestamp != 0U)) {
+			uint64_t age = (now - sample.timestamp) / 1000U;
+			block[0] = (uint16_t) (((uint32_t) sample.value) >> 16);
+			block[1] = (uint16_t) sample.value;
+			block[2] = sample.flags;
+			block[3] = (age < MODBUS_MAX_AGE) ? (uint16_t) age : MODBUS_MAX_AGE;
+		}
+		/* A read may start or end part way through an input */
+		for (uint_fast8_t i = index % MODBUS_REGISTERS_PER_INPUT; (i < MODBUS_REGISTERS_PER_INPUT) && (index < end);
+				++i) {
+			registers[index - address] = block[i];
+			++index;
+		}
+	}
+	return MODBUS_EXCEPTION_NONE;
+}
+
+/**
+ * @internal
+ * Reads the digital input levels, ON for an input at logic high. Inputs which are not added read as OFF.
+ *
+ * @param address uint16_t The first input to read.
+ * @param quantity uint16_t The number of inputs to read.
+ * @param bits uint8_t* Pointer to the zeroed bit array to fill in.
+ * @retval ModbusException_t The result of the read.
+ */
+static ModbusException_t ModbusReadDigitalInputs(uint16_t address, uint16_t quantity, uint8_t* bits) {
+	if (((uint32_t) address + quantity) > NUM_DIGITAL_INPUTS) {
+		return MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+	}
+	for (uint_fast8_t i = 0U; i < quantity; ++i) {
+		const Digital_Input_t* input = GetDigitalInputByNumber(address + i);
+		if ((input != NULL) && (input->added == CHANNEL_ADDED) && (ReadDigitalInputLevel(input) == LOGIC_HIGH)) {
+			bits[i / 8U] |= (uint8_t) (1U << (i % 8U));
+		}
+	}
+	return MODBUS_EXCEPTION_NONE;
+}
+
+/**
+ * @internal
+ * Reads the digital output levels, ON for an output which is on. Outputs which are not added read as OFF.
+ *
+ * @param address uint16_t The first output to read.
+ * @param quantity uint16_t The number of outputs to read.
+ * @param bits uint8_t* Pointer to the zeroed bit array to fill in.
+ * @retval ModbusException_t The result of the read.
+ */
+static ModbusException_t ModbusReadDigitalOutputs(uint16_t address, uint16_t quantity, uint8_t* bits) {
+	if (((uint32_t) address + quantity) > NUM_DIGITAL_OUTPUTS) {
+		return MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+	}
+	for (uint_fast8_t i = 0U; i < quantity; ++i) {
+		const Digital_Output_t* output = GetDigitalOutputByNumber(address + i);
+		if ((output != NULL) && (output->added == CHANNEL_ADDED) && (output->level == OUTPUT_ON)) {
+			bits[i / 8U] |= (uint8_t) (1U << (i % 8U));
+		}
+	}
+	return MODBUS_EXCEPTION_NONE;
+}
+
+/**
+ * @internal
+ * Sets the digital output levels. The outputs are switched together by a single commit to the drivers, and none is
+ * changed unless every one of them has been added.
+ *
+ * @param address uint16_t The first output to write.
+ * @param quantity uint16_t The number of outputs to write.
+ * @param bits const uint8_t* Pointer to the bit array of levels, a set bit turning the output on.
+ * @retval ModbusException_t The result of the write.
+ */
+static ModbusException_t ModbusWriteDigitalOutputs(uint16_t address, uint16_t quantity, const uint8_t* bits) {
+	if (((uint32_t) address + quantity) > NUM_DIGITAL_OUTPUTS) {
+		return MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+	}
+	DigitalOutputMask_t mask = 0U;
+	DigitalOutputMask_t levels = 0U;
+	for (uint_fast8_t i = 0U; i < quantity; ++i) {
+		DigitalOutputMask_t bit = (DigitalOutputMask_t) (1UL << (address + i));
+		mask |= bit;
+		if ((bits[i / 8U] & (1U << (i % 8U))) != 0U) {
+			levels |= bit;
+		}
+	}
+	/* Any function error not listed here is a failure of the device rather than of the request */
+	static const struct {
+		Tekdaqc_Function_Error_t error;
+		ModbusException_t exception;
+	} EXCEPTIONS[] = {
+		{ ERR_FUNCTION_OK, MODBUS_EXCEPTION_NONE },
+		{ ERR_DOUT_DOES_NOT_EXIST, MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS }
+	};
+	const Tekdaqc_Function_Error_t error = SetDigitalOutputs(mask, levels);
+	for (uint_fast8_t i = 0U; i < (sizeof(EXCEPTIONS) / sizeof(EXCEPTIONS[0])); ++i) {
+		if (EXCEPTIONS[i].error == error) {
+			return EXCEPTIONS[i].exception;
+		}
+	}
+	return MODBUS_EXCEPTION_SERVER_DEVICE_FAILURE;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Starts the Modbus server serving the Tekdaqc's inputs and outputs on MODBUS_PORT.
+ *
+ * @param none
+ * @retval ModbusServerStatus_t The result of starting the server.
+ */
+ModbusServerStatus_t Tekdaqc_ModbusInit(void) {
+	return InitializeModbusServer(&tekdaqcModbusMap);
+}
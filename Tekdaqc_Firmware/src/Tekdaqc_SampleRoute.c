@@ -0,0 +1,268 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_SampleRoute.c
+ * @brief Routes the encoded sample data of the input writers to the sample log, a transport and the taps.
+ *
+ * Each write is routed in three steps:
+ *
+ *   1. While logging is on and there is no destination, or logged data is still waiting to be replayed, the write is
+ *      logged to keep it in order, see Tekdaqc_SampleLog.c. The log replays through SampleRoute_Send*().
+ *   2. Otherwise it is sent over the first active transport in SampleTransports, which is in order of preference: a
+ *      raw Ethernet stream or UDP publishing when set up, then a data server client, leaving the Telnet connection
+ *      for commands and status messages. The last transport takes the data when none is active, except that the
+ *      data of a job started at boot is held back while there is no destination at all, a tap counting as one.
+ *   3. Once the write has been taken it is shown to every tap in SampleTaps. A write to be retried is left until the
+ *      retry, so no tap sees it twice.
+ *
+ * The writers encode each record once, whichever way it goes, and the route only passes the block along, so a
+ * transport or tap which is not in use costs each write no more than the check of whether it is active.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_SampleRoute.h"
+#include "Tekdaqc_SampleLog.h"
+#include "TelnetServer.h"
+#include "DataServer.h"
+#include "SamplePublisher.h"
+#include "RawStream.h"
+#include "WebSocketServer.h"
+#include "netconf.h"
+#include <stddef.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def NUM_SAMPLE_TRANSPORTS
+ * @brief The number of transports sample data can be sent over.
+ */
+#define NUM_SAMPLE_TRANSPORTS	(sizeof(SampleTransports) / sizeof(SampleTransports[0]))
+
+/**
+ * @internal
+ * @def NUM_SAMPLE_TAPS
+ * @brief The number of taps shown the sample data.
+ */
+#define NUM_SAMPLE_TAPS			(sizeof(SampleTaps) / sizeof(SampleTaps[0]))
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The transports in order of preference. The last one takes the data when none is active. */
+static const SampleTransport_t SampleTransports[] = {
+		{ &RawStreamIsActive, &RawStreamWriteString, &RawStreamWriteBinary },
+		{ &SamplePublisherIsActive, &SamplePublisherWriteString, &SamplePublisherWriteBinary },
+		{ &DataServerIsConnected, &DataServerWriteString, &DataServerWriteBinary },
+		{ &TelnetHasSubscribers, &TelnetPublishString, &TelnetPublishBinary } };
+
+/* The observers shown every write which was taken */
+static const SampleTap_t SampleTaps[] = {
+		{ &WebSocketBroadcastString, &WebSocketBroadcastBinary } };
+
+/* Set when a saved sampling job was started at boot. Its sample data is held in the sample buffers, rather than
+ * discarded, while it has nowhere to go */
+static bool holdSamples = false;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Retrieves the first active transport.
+ */
+static const SampleTransport_t* GetActiveTransport(void);
+
+/**
+ * @internal
+ * @brief Retrieves the transport to send over, or none if the data is to be held back.
+ */
+static const SampleTransport_t* SelectTransport(void);
+
+/**
+ * @internal
+ * @brief Indicates if a write is to go to the sample log.
+ */
+static bool IsLogging(void);
+
+/**
+ * @internal
+ * @brief Passes on the result of sending sample data, noting when it flows.
+ */
+static WriteStatus_t NoteSampleSent(WriteStatus_t status);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * Retrieves the first active transport in order of preference.
+ *
+ * @param none
+ * @retval const SampleTransport_t* Pointer to the transport, NULL if none is active.
+ */
+static const SampleTransport_t* GetActiveTransport(void) {
+	for (uint_fast8_t i = 0U; i < NUM_SAMPLE_TRANSPORTS; ++i) {
+		if (SampleTransports[i].IsActive() == true) {
+			return &SampleTransports[i];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @internal
+ * Retrieves the transport to send over: the first active one, otherwise the last one unless the data is being held
+ * back and no tap is watching either.
+ *
+ * @param none
+ * @retval const SampleTransport_t* Pointer to the transport, NULL if the data is to be held back.
+ */
+static const SampleTransport_t* SelectTransport(void) {
+	const SampleTransport_t* transport = GetActiveTransport();
+	if ((transport == NULL) && ((holdSamples == false) || (WebSocketHasClients() == true))) {
+		transport = &SampleTransports[NUM_SAMPLE_TRANSPORTS - 1U];
+	}
+	return transport;
+}
+
+/**
+ * @internal
+ * Indicates if a write is to go to the sample log: while logging is on and there is no destination, or logged data
+ * is still waiting to be replayed.
+ *
+ * @param none
+ * @retval bool TRUE if the write is to be logged.
+ */
+static bool IsLogging(void) {
+	return (SampleLog_HasBacklog() == true)
+			|| ((SampleLog_IsEnabled() == true) && (SampleRoute_HasDestination() == false));
+}
+
+/**
+ * @internal
+ * Passes on the result of sending sample data, noting the data flowing for the link recovery time.
+ *
+ * @param status WriteStatus_t The result of the send.
+ * @retval WriteStatus_t The same result.
+ */
+static WriteStatus_t NoteSampleSent(WriteStatus_t status) {
+	if (status == WRITE_OK) {
+		LwIP_NoteDataFlowing();
+	}
+	return status;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Sets whether sample data is held back in the sample buffers while there is no destination at all, as for a saved
+ * sampling job started at boot, rather than given to the last transport to be discarded.
+ *
+ * @param hold bool TRUE to hold sample data back.
+ * @retval none
+ */
+void SampleRoute_SetHold(bool hold) {
+	holdSamples = hold;
+}
+
+/**
+ * Indicates if there is a destination for sample data: an active transport. While the link is down there is none,
+ * even though the connections are held open, so the data is logged and replayed once the link is back.
+ *
+ * @param none
+ * @retval bool TRUE if sample data has somewhere to go.
+ */
+bool SampleRoute_HasDestination(void) {
+	return (LwIP_IsLinkUp() == true) && (GetActiveTransport() != NULL);
+}
+
+/**
+ * Writes a sample data string, to the sample log or a transport as described at the top of this file. Once the
+ * string has been taken it is also shown to the taps.
+ *
+ * @param string char* Pointer to the C-String to write.
+ * @retval WriteStatus_t The result of the write.
+ */
+WriteStatus_t SampleRoute_WriteString(char* string) {
+	const WriteStatus_t status = (IsLogging() == true) ? SampleLog_WriteString(string) : SampleRoute_SendString(string);
+	if (status != WRITE_BUSY) {
+		for (uint_fast8_t i = 0U; i < NUM_SAMPLE_TAPS; ++i) {
+			SampleTaps[i].WriteString(string);
+		}
+	}
+	return status;
+}
+
+/**
+ * Writes a block of binary sample data, to the sample log or a transport as described at the top of this file. Once
+ * the block has been taken the same encoded block is also shown to the taps.
+ *
+ * @param data const uint8_t* Pointer to the data to write.
+ * @param length uint16_t The number of bytes to write.
+ * @retval WriteStatus_t The result of the write.
+ */
+WriteStatus_t SampleRoute_WriteBinary(const uint8_t* data, uint16_t length) {
+	const WriteStatus_t status = (IsLogging() == true) ? SampleLog_WriteBinary(data, length)
+			: SampleRoute_SendBinary(data, length);
+	if (status != WRITE_BUSY) {
+		for (uint_fast8_t i = 0U; i < NUM_SAMPLE_TAPS; ++i) {
+			SampleTaps[i].WriteBinary(data, length);
+		}
+	}
+	return status;
+}
+
+/**
+ * Sends a sample data string over the selected transport, bypassing the sample log. This is how the log replays.
+ *
+ * @param string char* Pointer to the C-String to send.
+ * @retval WriteStatus_t The result of the write, WRITE_BUSY while the data is held back.
+ */
+WriteStatus_t SampleRoute_SendString(char* string) {
+	const SampleTransport_t* transport = SelectTransport();
+	if (transport == NULL) {
+		return WRITE_BUSY;
+	}
+	return NoteSampleSent(transport->WriteString(string));
+}
+
+/**
+ * Sends a block of binary sample data over the selected transport, bypassing the sample log. This is how the log
+ * replays.
+ *
+ * @param data const uint8_t* Pointer to the data to send.
+ * @param length uint16_t The number of bytes to send.
+ * @retval WriteStatus_t The result of the write, WRITE_BUSY while the data is held back.
+ */
+WriteStatus_t SampleRoute_SendBinary(const uint8_t* data, uint16_t length) {
+	const SampleTransport_t* transport = SelectTransport();
+	if (transport == NULL) {
+		return WRITE_BUSY;
+	}
+	return NoteSampleSent(transport->WriteBinary(data, length));
+}
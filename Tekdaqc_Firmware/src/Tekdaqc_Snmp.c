@@ -0,0 +1,449 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Snmp.c
+ * @brief Implements the Tekdaqc's private SNMP MIB.
+ *
+ * Defines the private MIB the lwIP SNMP agent serves next to MIB-II, a group of read only scalars holding the
+ * acquisition performance counters. The objects are read when they are polled, from the same free running counters
+ * the STATS command reports, so the agent adds nothing to the sampling or transport paths. The counters are served
+ * as they are and wrap harmlessly, leaving the manager to find their rates. The few rates which need the elapsed
+ * time, the sample rate, loop rate and loop load, are found here over a window of at least
+ * TEKDAQC_SNMP_RATE_WINDOW_US which is closed by the first read after it has passed.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "Tekdaqc_Snmp.h"
+#include "lwip/opt.h"
+
+#if LWIP_SNMP /* Only built with the SNMP agent, see SNMP_AGENT in lwipopts.h */
+
+#include "lwip/snmp.h"
+#include "lwip/snmp_asn1.h"
+#include "lwip/snmp_structs.h"
+#include "ADC_StateMachine.h"
+#include "Analog_Input.h"
+#include "BoardTemperature.h"
+#include "TelnetServer.h"
+#include "DataServer.h"
+#include "SamplePublisher.h"
+#include "RawStream.h"
+#include "Tekdaqc_Scheduler.h"
+#include "Tekdaqc_Timers.h"
+#include "Tekdaqc_Version.h"
+#include "netconf.h"
+#include "ethernetif.h"
+#include <stdio.h>
+#include <string.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def SNMP_TYPE_COUNTER32
+ * @brief The ASN.1 type of a Counter32 object.
+ */
+#define SNMP_TYPE_COUNTER32	(SNMP_ASN1_APPLIC | SNMP_ASN1_PRIMIT | SNMP_ASN1_COUNTER)
+
+/**
+ * @internal
+ * @def SNMP_TYPE_GAUGE32
+ * @brief The ASN.1 type of a Gauge32 object.
+ */
+#define SNMP_TYPE_GAUGE32	(SNMP_ASN1_APPLIC | SNMP_ASN1_PRIMIT | SNMP_ASN1_GAUGE)
+
+/**
+ * @internal
+ * @def SNMP_TYPE_INTEGER32
+ * @brief The ASN.1 type of an Integer32 object.
+ */
+#define SNMP_TYPE_INTEGER32	(SNMP_ASN1_UNIV | SNMP_ASN1_PRIMIT | SNMP_ASN1_INTEG)
+
+/**
+ * @internal
+ * @def SNMP_DESCRIPTION_SIZE
+ * @brief The size of the buffer the system description is formatted in.
+ */
+#define SNMP_DESCRIPTION_SIZE	32U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Data structure holding the counters at the start of a rate window.
+ */
+typedef struct {
+	uint64_t time; /**< The local time the window started. */
+	uint64_t idle; /**< The total time the scheduler had slept for. */
+	uint32_t passes; /**< The number of scheduler passes made. */
+	uint32_t samples; /**< The number of samples produced by all physical inputs. */
+} SnmpWindow_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Describes a performance object to the agent.
+ */
+static void PerformanceGetObjectDef(u8_t ident_len, s32_t *ident, struct obj_def *od);
+
+/**
+ * @internal
+ * @brief Reads the value of a performance object.
+ */
+static void PerformanceGetValue(struct obj_def *od, u16_t len, void *value);
+
+/**
+ * @internal
+ * @brief Finds the rates over the current window once it has lasted long enough.
+ */
+static void UpdateRates(void);
+
+/**
+ * @internal
+ * @brief Retrieves the number of samples produced by all physical inputs.
+ */
+static uint32_t GetSampleCount(void);
+
+/**
+ * @internal
+ * @brief Converts the change of a counter over an interval to a rate per second.
+ */
+static uint32_t RatePerSecond(uint32_t change, uint64_t elapsed);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief The ASN.1 type of each performance object, indexed by the object's number less 1.
+ */
+static const u8_t ObjectTypes[TEKDAQC_SNMP_OBJECT_COUNT] = {
+	SNMP_TYPE_COUNTER32, SNMP_TYPE_COUNTER32, SNMP_TYPE_GAUGE32, SNMP_TYPE_COUNTER32, SNMP_TYPE_GAUGE32,
+	SNMP_TYPE_GAUGE32, SNMP_TYPE_GAUGE32, SNMP_TYPE_GAUGE32, SNMP_TYPE_GAUGE32, SNMP_TYPE_GAUGE32,
+	SNMP_TYPE_INTEGER32, SNMP_TYPE_INTEGER32, SNMP_TYPE_COUNTER32, SNMP_TYPE_GAUGE32, SNMP_TYPE_COUNTER32,
+	SNMP_TYPE_COUNTER32, SNMP_TYPE_COUNTER32, SNMP_TYPE_COUNTER32, SNMP_TYPE_COUNTER32, SNMP_TYPE_COUNTER32,
+	SNMP_TYPE_COUNTER32
+};
+
+/* performance .1.3.6.1.4.1.TEKDAQC_SNMP_ENTERPRISE_ID.1, every object is served by the one scalar node */
+static const mib_scalar_node performance_scalar = {
+	&PerformanceGetObjectDef,
+	&PerformanceGetValue,
+	&noleafs_set_test,
+	&noleafs_set_value,
+	MIB_NODE_SC,
+	0
+};
+static const s32_t performance_ids[TEKDAQC_SNMP_OBJECT_COUNT] = {
+	1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21
+};
+static struct mib_node* const performance_nodes[TEKDAQC_SNMP_OBJECT_COUNT] = {
+	(struct mib_node*) &performance_scalar, (struct mib_node*) &performance_scalar,
+	(struct mib_node*) &performance_scalar, (struct mib_node*) &performance_scalar,
+	(struct mib_node*) &performance_scalar, (struct mib_node*) &performance_scalar,
+	(struct mib_node*) &performance_scalar, (struct mib_node*) &performance_scalar,
+	(struct mib_node*) &performance_scalar, (struct mib_node*) &performance_scalar,
+	(struct mib_node*) &performance_scalar, (struct mib_node*) &performance_scalar,
+	(struct mib_node*) &performance_scalar, (struct mib_node*) &performance_scalar,
+	(struct mib_node*) &performance_scalar, (struct mib_node*) &performance_scalar,
+	(struct mib_node*) &performance_scalar, (struct mib_node*) &performance_scalar,
+	(struct mib_node*) &performance_scalar, (struct mib_node*) &performance_scalar,
+	(struct mib_node*) &performance_scalar
+};
+static const struct mib_array_node performance = {
+	&noleafs_get_object_def,
+	&noleafs_get_value,
+	&noleafs_set_test,
+	&noleafs_set_value,
+	MIB_NODE_AR,
+	TEKDAQC_SNMP_OBJECT_COUNT,
+	performance_ids,
+	performance_nodes
+};
+
+/* tekdaqc .1.3.6.1.4.1.TEKDAQC_SNMP_ENTERPRISE_ID */
+static const s32_t tekdaqc_ids[1] = { TEKDAQC_SNMP_PERFORMANCE_GROUP };
+static struct mib_node* const tekdaqc_nodes[1] = { (struct mib_node*) &performance };
+static const struct mib_array_node tekdaqc = {
+	&noleafs_get_object_def,
+	&noleafs_get_value,
+	&noleafs_set_test,
+	&noleafs_set_value,
+	MIB_NODE_AR,
+	1,
+	tekdaqc_ids,
+	tekdaqc_nodes
+};
+
+/* enterprises .1.3.6.1.4.1 */
+static const s32_t enterprises_ids[1] = { TEKDAQC_SNMP_ENTERPRISE_ID };
+static struct mib_node* const enterprises_nodes[1] = { (struct mib_node*) &tekdaqc };
+static const struct mib_array_node enterprises = {
+	&noleafs_get_object_def,
+	&noleafs_get_value,
+	&noleafs_set_test,
+	&noleafs_set_value,
+	MIB_NODE_AR,
+	1,
+	enterprises_ids,
+	enterprises_nodes
+};
+
+/* private .1.3.6.1.4, attached by lwIP next to MIB-II */
+static const s32_t private_ids[1] = { 1 };
+static struct mib_node* const private_nodes[1] = { (struct mib_node*) &enterprises };
+const struct mib_array_node mib_private = {
+	&noleafs_get_object_def,
+	&noleafs_get_value,
+	&noleafs_set_test,
+	&noleafs_set_value,
+	MIB_NODE_AR,
+	1,
+	private_ids,
+	private_nodes
+};
+
+/* The system object ID, the Tekdaqc's enterprise */
+static struct snmp_obj_id SystemObjectId = { 7, { 1, 3, 6, 1, 4, 1, TEKDAQC_SNMP_ENTERPRISE_ID } };
+
+/* The system description, kept for the agent */
+static u8_t SystemDescription[SNMP_DESCRIPTION_SIZE];
+
+/* The length of the system description, excluding the terminator */
+static u8_t SystemDescriptionLength = 0U;
+
+/* The counters at the start of the current rate window. All zero before the first, so it covers the time since
+ * start up. */
+static SnmpWindow_t WindowStart;
+
+/* The achieved sample rate over the previous window, in samples per second */
+static uint32_t SampleRate = 0U;
+
+/* The main loop rate over the previous window, in passes per second */
+static uint32_t LoopRate = 0U;
+
+/* The main loop load over the previous window, per mille */
+static uint32_t LoopLoad = 0U;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * Describes a performance object to the agent. Every object is a read only 32 bit scalar.
+ *
+ * @param ident_len u8_t The length of the object identifier trailer, excluding the object's number.
+ * @param ident s32_t* Pointer to the object identifier trailer, after the object's number.
+ * @param od struct obj_def* Pointer to the definition to fill in.
+ * @retval none
+ */
+static void PerformanceGetObjectDef(u8_t ident_len, s32_t *ident, struct obj_def *od) {
+	/* Return to the object's number, adding the index depth (1) */
+	ident_len += 1U;
+	ident -= 1;
+	if ((ident_len == 2U) && (ident[0] >= 1) && (ident[0] <= (s32_t) TEKDAQC_SNMP_OBJECT_COUNT)) {
+		od->id_inst_len = ident_len;
+		od->id_inst_ptr = ident;
+		od->instance = MIB_OBJECT_SCALAR;
+		od->access = MIB_OBJECT_READ_ONLY;
+		od->asn_type = ObjectTypes[ident[0] - 1];
+		od->v_len = sizeof(u32_t);
+	} else {
+		od->instance = MIB_OBJECT_NONE;
+	}
+}
+
+/**
+ * @internal
+ * Reads the value of a performance object from the counter it serves, see Tekdaqc_Snmp.h for their numbers.
+ *
+ * @param od struct obj_def* Pointer to the definition of the object, filled in by PerformanceGetObjectDef().
+ * @param len u16_t The size of the value, always that of a 32 bit integer.
+ * @param value void* Pointer to the value to fill in.
+ * @retval none
+ */
+static void PerformanceGetValue(struct obj_def *od, u16_t len, void *value) {
+	LWIP_UNUSED_ARG(len);
+	u32_t* result = (u32_t*) value;
+	ethernetif_rx_stats_t rx;
+	ethernetif_tx_stats_t tx;
+	uint32_t downs;
+	uint32_t recovery;
+	switch (od->id_inst_ptr[0]) {
+	case 1:
+		*result = ADC_Machine_GetConversionCount();
+		break;
+	case 2:
+		*result = GetSampleCount();
+		break;
+	case 3:
+		UpdateRates();
+		*result = SampleRate;
+		break;
+	case 4:
+		*result = ADC_Machine_GetOverrunCount();
+		break;
+	case 5:
+		*result = ADC_Machine_GetBufferedSampleCount();
+		break;
+	case 6:
+		*result = TelnetGetBufferUsed();
+		break;
+	case 7:
+		*result = TelnetGetBufferPeak();
+		break;
+	case 8:
+		*result = TELNET_TX_RING_SIZE;
+		break;
+	case 9:
+		UpdateRates();
+		*result = LoopRate;
+		break;
+	case 10:
+		UpdateRates();
+		*result = LoopLoad;
+		break;
+	case 11:
+		*((s32_t*) value) = (s32_t) (getBoardTemperature() * 1000.0f);
+		break;
+	case 12:
+		*((s32_t*) value) = (LwIP_IsLinkUp() == TRUE) ? 1 : 2;
+		break;
+	case 13:
+		LwIP_GetLinkRecovery(&downs, &recovery);
+		*result = downs;
+		break;
+	case 14:
+		LwIP_GetLinkRecovery(&downs, &recovery);
+		*result = recovery;
+		break;
+	case 15:
+		ethernetif_get_rx_stats(&rx);
+		*result = rx.missed_no_buffer + rx.missed_overflow;
+		break;
+	case 16:
+		ethernetif_get_rx_stats(&rx);
+		*result = rx.no_pbuf;
+		break;
+	case 17:
+		ethernetif_get_tx_stats(&tx);
+		*result = tx.no_descriptor;
+		break;
+	case 18:
+		*result = TelnetGetBytesSent();
+		break;
+	case 19:
+		*result = DataServerGetBytesSent();
+		break;
+	case 20:
+		*result = SamplePublisherGetBytesSent();
+		break;
+	case 21:
+		*result = RawStreamGetBytesSent();
+		break;
+	default:
+		*result = 0U;
+		break;
+	}
+}
+
+/**
+ * @internal
+ * Finds the sample rate, loop rate and loop load over the current window once it has lasted at least
+ * TEKDAQC_SNMP_RATE_WINDOW_US, and starts the next window. Until then the rates of the previous window stand.
+ *
+ * @param none
+ * @retval none
+ */
+static void UpdateRates(void) {
+	SnmpWindow_t current;
+	current.time = GetLocalTime();
+	const uint64_t elapsed = current.time - WindowStart.time;
+	if (elapsed < TEKDAQC_SNMP_RATE_WINDOW_US) {
+		return;
+	}
+	current.idle = Scheduler_GetIdleTime();
+	current.passes = Scheduler_GetPassCount();
+	current.samples = GetSampleCount();
+	SampleRate = RatePerSecond(current.samples - WindowStart.samples, elapsed);
+	LoopRate = RatePerSecond(current.passes - WindowStart.passes, elapsed);
+	const uint64_t idle = ((current.idle - WindowStart.idle) * 1000U) / elapsed;
+	LoopLoad = (idle < 1000U) ? (1000U - (uint32_t) idle) : 0U;
+	WindowStart = current;
+}
+
+/**
+ * @internal
+ * Retrieves the number of samples produced by all physical inputs since start up. The count wraps.
+ *
+ * @param none
+ * @retval uint32_t The number of samples produced.
+ */
+static uint32_t GetSampleCount(void) {
+	uint32_t samples = 0U;
+	for (uint_fast8_t i = 0U; i < NUM_ANALOG_INPUTS; ++i) {
+		samples += ADC_Machine_GetInputSampleCount((PhysicalAnalogInput_t) i);
+	}
+	return samples;
+}
+
+/**
+ * @internal
+ * Converts the change of a counter over an interval to a rate per second.
+ *
+ * @param change uint32_t The change of the counter.
+ * @param elapsed uint64_t The length of the interval in microseconds. Must not be 0.
+ * @retval uint32_t The rate per second.
+ */
+static uint32_t RatePerSecond(uint32_t change, uint64_t elapsed) {
+	return (uint32_t) ((((uint64_t) change) * 1000000U) / elapsed);
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Sets the SNMP agent's sysDescr to the Tekdaqc's firmware version and its sysObjectID to the Tekdaqc's
+ * enterprise, so a manager can tell the board apart from other agents. Called once at start up.
+ *
+ * @param none
+ * @retval none
+ */
+void Tekdaqc_SnmpInit(void) {
+	snprintf((char*) SystemDescription, sizeof(SystemDescription), "Tekdaqc v%u.%u.%u.%u",
+			(unsigned int) MAJOR_VERSION, (unsigned int) MINOR_VERSION, (unsigned int) BUILD_NUMBER,
+			(unsigned int) SPECIAL_BUILD);
+	SystemDescriptionLength = (u8_t) strlen((char*) SystemDescription);
+	snmp_set_sysdesr(SystemDescription, &SystemDescriptionLength);
+	snmp_set_sysobjid(&SystemObjectId);
+}
+
+#endif /* LWIP_SNMP */
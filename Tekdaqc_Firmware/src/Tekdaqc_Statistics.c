@@ -0,0 +1,222 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Statistics.c
+ * @brief Implements the Tekdaqc's runtime performance statistics.
+ *
+ * The statistics are rates, found from the free running counters kept by the sampling and transport paths. Each
+ * report takes a snapshot of the counters and reports their change since the snapshot of the previous report, so
+ * the counters themselves cost no more than an increment and wrap harmlessly. Reports are written as status
+ * messages, either on request or periodically from the status task.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "Tekdaqc_Statistics.h"
+#include "ADC_StateMachine.h"
+#include "Analog_Input.h"
+#include "TelnetServer.h"
+#include "DataServer.h"
+#include "SamplePublisher.h"
+#include "RawStream.h"
+#include "Tekdaqc_Scheduler.h"
+#include "Tekdaqc_Timers.h"
+#include "Tekdaqc_Config.h"
+#include "Tekdaqc_BSP.h"
+#include <stdio.h>
+#include <inttypes.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Data structure holding the counters at the time of a report.
+ */
+typedef struct {
+	uint64_t time; /**< The local time of the snapshot. */
+	uint64_t idle; /**< The total time the scheduler had slept for. */
+	uint32_t passes; /**< The number of scheduler passes made. */
+	uint32_t conversions; /**< The number of ADC conversions read. */
+	uint32_t overruns; /**< The number of analog samples dropped. */
+	uint32_t telnetBytes; /**< The number of bytes sent over Telnet. */
+	uint32_t dataBytes; /**< The number of bytes sent over the data connection. */
+	uint32_t publishBytes; /**< The number of bytes published. */
+	uint32_t rawBytes; /**< The number of bytes streamed in raw Ethernet frames. */
+	uint32_t samples[NUM_ANALOG_INPUTS]; /**< The number of samples produced for each physical input. */
+} StatisticsSnapshot_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief The counters at the time of the previous report. All zero before the first, so it covers the time since
+ * start up.
+ */
+static StatisticsSnapshot_t Previous;
+
+/**
+ * @internal
+ * @brief The time in microseconds between periodic reports, 0 if they are off.
+ */
+static uint32_t ReportPeriod = 0U;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Takes a snapshot of the counters.
+ */
+static void TakeSnapshot(StatisticsSnapshot_t* snapshot);
+
+/**
+ * @internal
+ * @brief Converts the change of a counter over an interval to a rate per second.
+ */
+static uint32_t RatePerSecond(uint32_t change, uint64_t elapsed);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Takes a snapshot of the counters kept by the scheduler, the ADC and the servers.
+ *
+ * @param snapshot StatisticsSnapshot_t* The location to store the snapshot.
+ * @retval none
+ */
+static void TakeSnapshot(StatisticsSnapshot_t* snapshot) {
+	snapshot->time = GetLocalTime();
+	snapshot->idle = Scheduler_GetIdleTime();
+	snapshot->passes = Scheduler_GetPassCount();
+	snapshot->conversions = ADC_Machine_GetConversionCount();
+	snapshot->overruns = ADC_Machine_GetOverrunCount();
+	snapshot->telnetBytes = TelnetGetBytesSent();
+	snapshot->dataBytes = DataServerGetBytesSent();
+	snapshot->publishBytes = SamplePublisherGetBytesSent();
+	snapshot->rawBytes = RawStreamGetBytesSent();
+	for (uint_fast8_t i = 0U; i < NUM_ANALOG_INPUTS; ++i) {
+		snapshot->samples[i] = ADC_Machine_GetInputSampleCount((PhysicalAnalogInput_t) i);
+	}
+}
+
+/**
+ * Converts the change of a counter over an interval to a rate per second.
+ *
+ * @param change uint32_t The change of the counter.
+ * @param elapsed uint64_t The length of the interval in microseconds. Must not be 0.
+ * @retval uint32_t The rate per second.
+ */
+static uint32_t RatePerSecond(uint32_t change, uint64_t elapsed) {
+	return (uint32_t) ((((uint64_t) change) * 1000000U) / elapsed);
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Writes a report of the statistics over the time since the previous report as status messages: the rate of
+ * scheduler passes and the fraction of the time spent asleep, the bytes per second sent on each connection, the
+ * peak fill of the Telnet buffer, the ADC conversion and overrun rates and the achieved sample rate of each added
+ * analog input which produced samples. A loop rate falling towards the conversion rate, an idle fraction near zero,
+ * a buffer peak near its size or overruns growing all mean the board is saturated.
+ *
+ * @param none
+ * @retval none
+ */
+void Statistics_Report(void) {
+	StatisticsSnapshot_t current;
+	TakeSnapshot(&current);
+	const uint64_t elapsed = current.time - Previous.time;
+	if (elapsed == 0U) {
+		return;
+	}
+	const uint32_t idle = (uint32_t) (((current.idle - Previous.idle) * 1000U) / elapsed);
+	snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Stats INTERVAL: %" PRIu32 " ms LOOP: %" PRIu32 " Hz IDLE: %"
+			PRIu32 ".%" PRIu32 " %%", (uint32_t) (elapsed / 1000U), RatePerSecond(current.passes - Previous.passes, elapsed),
+			idle / 10U, idle % 10U);
+	TelnetWriteStatusMessage(TOSTRING_BUFFER);
+	snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Stats SENT TELNET: %" PRIu32 " B/s DATA: %" PRIu32
+			" B/s PUBLISH: %" PRIu32 " B/s RAW: %" PRIu32 " B/s",
+			RatePerSecond(current.telnetBytes - Previous.telnetBytes, elapsed),
+			RatePerSecond(current.dataBytes - Previous.dataBytes, elapsed),
+			RatePerSecond(current.publishBytes - Previous.publishBytes, elapsed),
+			RatePerSecond(current.rawBytes - Previous.rawBytes, elapsed));
+	TelnetWriteStatusMessage(TOSTRING_BUFFER);
+	snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Stats TELNET BUFFER PEAK: %" PRIu32 " OF: %" PRIu32,
+			(uint32_t) TelnetGetBufferPeak(), (uint32_t) TELNET_TX_RING_SIZE);
+	TelnetWriteStatusMessage(TOSTRING_BUFFER);
+	snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Stats ANALOG CONVERSIONS: %" PRIu32 " /s OVERRUNS: %" PRIu32
+			" /s", RatePerSecond(current.conversions - Previous.conversions, elapsed),
+			RatePerSecond(current.overruns - Previous.overruns, elapsed));
+	TelnetWriteStatusMessage(TOSTRING_BUFFER);
+	for (uint_fast8_t i = 0U; i < NUM_ANALOG_INPUTS; ++i) {
+		const uint32_t samples = current.samples[i] - Previous.samples[i];
+		const Analog_Input_t* input = GetAnalogInputByNumber(i);
+		if ((samples != 0U) && (input != NULL) && (input->added == CHANNEL_ADDED)) {
+			snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER), "Stats INPUT %" PRIu32 " %s: %" PRIu32 " samples/s",
+					(uint32_t) i, input->name, RatePerSecond(samples, elapsed));
+			TelnetWriteStatusMessage(TOSTRING_BUFFER);
+		}
+	}
+	Previous = current;
+}
+
+/**
+ * Sets the time between periodic reports. Periods shorter than STATISTICS_MIN_PERIOD_US are raised to it.
+ *
+ * @param period uint32_t The time in microseconds between reports, 0 to stop them.
+ * @retval none
+ */
+void Statistics_SetPeriod(uint32_t period) {
+	if ((period != 0U) && (period < STATISTICS_MIN_PERIOD_US)) {
+		period = STATISTICS_MIN_PERIOD_US;
+	}
+	ReportPeriod = period;
+#ifdef STATISTICS_DEBUG
+	printf("[Statistics] Reporting every %" PRIu32 " us.\n\r", ReportPeriod);
+#endif
+}
+
+/**
+ * Writes a periodic report once the report period has passed since the previous report. Reports stop when the
+ * client disconnects, so they are not left running for the next client.
+ *
+ * @param none
+ * @retval none
+ */
+void Statistics_Service(void) {
+	if (ReportPeriod == 0U) {
+		return;
+	}
+	if (TelnetIsConnected() == false) {
+		ReportPeriod = 0U;
+		return;
+	}
+	if ((GetLocalTime() - Previous.time) >= ReportPeriod) {
+		Statistics_Report();
+	}
+}
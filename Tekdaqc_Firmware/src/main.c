@@ -16,30 +16,133 @@
 #include "Tekdaqc_Config.h"
 #include "stm32f4x7_eth.h"
 #include "netconf.h"
+#include "ethernetif.h"
 #include "TelnetServer.h"
+#include "DataServer.h"
+#include "UpgradeServer.h"
+#include "WebSocketServer.h"
+#include "Tekdaqc_Modbus.h"
+#include "Tekdaqc_Http.h"
+#include "Tekdaqc_Snmp.h"
+#include "Tekdaqc_Upgrade.h"
+#include "Tekdaqc_SampleLog.h"
+#include "Tekdaqc_SampleRoute.h"
+#include "SamplePublisher.h"
+#include "RawStream.h"
+#include "SNTPClient.h"
+#include "Tekdaqc_CAN.h"
+#include "AnalogInput_Trigger.h"
+#include "AnalogInput_Aux.h"
 #include "Tekdaqc_Locator.h"
 #include "Tekdaqc_CommandInterpreter.h"
 #include "Tekdaqc_CalibrationTable.h"
 #include "Tekdaqc_Calibration.h"
+#include "BoardTemperature.h"
+#include "eeprom.h"
+#include "Tekdaqc_ChannelConfig.h"
 #include "Tekdaqc_RTC.h"
 #include "CommandState.h"
 #include "ADS1256_SPI_Controller.h"
+#include "ADC_StateMachine.h"
 #include "Tekdaqc_Error.h"
 #include "Tekdaqc_Version.h"
+#include "Tekdaqc_Scheduler.h"
+#include "Tekdaqc_Benchmark.h"
+#include "Tekdaqc_BenchmarkSuite.h"
+#include "Tekdaqc_TimingHistogram.h"
+#include "Tekdaqc_BootTimes.h"
+#include "Tekdaqc_CrashRecord.h"
+#include "Tekdaqc_Statistics.h"
+#include "Tekdaqc_MemoryUsage.h"
+#include "Tekdaqc_Log.h"
+#include "stm32f4xx_it.h"
 #include <stdio.h>
 
 /* Private variables ---------------------------------------------------------*/
 
 #define CMDMaxLength 512
 
+/* The time in microseconds received Ethernet frames may be processed for on each pass */
+#define NETWORK_RX_BUDGET_US 1000U
+
+/* The time in microseconds received command characters may be processed for on each pass */
+#define COMMAND_BUDGET_US 500U
+
+/* The most received command characters passed to the interpreter in one run of the command task, bounding the time
+ * a run can take so that the budget above is honored */
+#define COMMAND_CHUNK_BYTES 128U
+
+/* The minimum time in microseconds between checks of the board status */
+#define STATUS_PERIOD_US 10000U
+
+/* The time in microseconds queued EEPROM writes and upgrade image words may be programmed for on each pass */
+#define STORAGE_BUDGET_US 200U
+
+/* The time in microseconds between passes of the board temperature extremes background job */
+#define BOARD_TEMPERATURE_PERIOD_US 100000U
+
+/* The longest time in microseconds a single run of each supervised task should take */
+#define SAMPLING_TIMEOUT_US 5000U
+#define NETWORK_TIMEOUT_US 5000U
+#define COMMAND_TIMEOUT_US 20000U
+#define STATUS_TIMEOUT_US 5000U
+
+/* The time in microseconds between updates of the load reported by the locator */
+#define LOCATOR_LOAD_PERIOD_US 1000000U
+
 Tekdaqc_CommandInterpreter_t* interpreter;
-char character;
 TelnetStatus_t status;
 
 /* Private functions ---------------------------------------------------------*/
 static void program_loop(void);
 static void Init_Locator();
 
+/**
+ * @brief Adds the work of the program loop to the scheduler.
+ */
+static void Init_Tasks(void);
+
+/**
+ * @brief Scheduler task which services deadlines and the input/output state machines.
+ */
+static bool Task_Sampling(void);
+
+/**
+ * @brief Scheduler task which processes a received Ethernet frame.
+ */
+static bool Task_NetworkReceive(void);
+
+/**
+ * @brief Scheduler task which handles the LwIP timers and sends any output which is due.
+ */
+static bool Task_NetworkTransmit(void);
+
+/**
+ * @brief Scheduler task which passes the received Telnet data to the command interpreter.
+ */
+static bool Task_Commands(void);
+
+/**
+ * @brief Scheduler task which checks to see if any faults have occurred.
+ */
+static bool Task_Status(void);
+
+/**
+ * @brief Scheduler task which persists the board temperature extremes.
+ */
+static bool Task_BoardTemperature(void);
+
+/**
+ * @brief Scheduler task which programs the queued EEPROM writes, the firmware upgrade image and the sample log in the
+ * background.
+ */
+static bool Task_Storage(void);
+
+/**
+ * @brief Updates the load reported by the locator.
+ */
+static void UpdateLocatorLoad(void);
+
 /**
  * @brief Initializes all the Tekdaqc specific structures and hardware features.
  */
@@ -58,11 +161,17 @@ int main(void) {
 	 system_stm32f4xx.c file
 	 */
 
+	/* Paint the free stack while nothing has used it, for the stack peak of GET_MEMORY_USAGE */
+	MemoryUsage_PaintStack();
+
+	/* Run exception entry from the RAM copy of the vector table before any interrupt is enabled */
+	RelocateVectorTable();
+
+	/* All preemption levels, no sub priorities, see the interrupt priority plan in Tekdaqc_BSP.h */
 	NVIC_PriorityGroupConfig(NVIC_PriorityGroup_4);
 
-#ifdef SERIAL_DEBUG /* Configure serial debugging. */
-	DebugComPort_Init();
-#endif
+	/* Configure the debug serial port the log is sent out of */
+	Log_Init();
 #ifdef DEBUG
 	printf("Serial Port Initialized.\n\r");
 #endif
@@ -90,30 +199,14 @@ int main(void) {
 
 	/* Setup Watchdog debug leds */
 
-	/**
-	 * Check if the system has resumed from a WWDG reset
-	 */
-	if (RCC_GetFlagStatus(RCC_FLAG_IWDGRST ) != RESET) {
-		/* This is a watchdog reset */
+	/* Install a staged firmware image, before the reset flags and crash record are taken so they survive its reset */
+	Upgrade_Init();
 
-		/* Clear the reset flags */
-		RCC_ClearFlag();
+	/* Keep the cause of the reset and any crash record before the flags are cleared */
+	CrashRecord_Init();
 
-		/* Do any watchdog reset specific stuff here */
-		/* TODO: Watchdog reset specific handling */
-	} else {
-		/* This is not a watchdog reset */
-		/* Do any normal reset stuff here */
-		if (RCC_GetFlagStatus(RCC_FLAG_SFTRST )) {
-			/* Software reset */
-		} else if (RCC_GetFlagStatus(RCC_FLAG_PORRST )) {
-			/* Power on Reset/Power down reset */
-		} else if (RCC_GetFlagStatus(RCC_FLAG_PINRST )) {
-			/* Reset pin reset */
-		} else {
-			/* Some other reset */
-		}
-	}
+	/* Keep the name of the task which stalled or starved, if it was a supervised one */
+	Scheduler_CaptureResetRecord(CrashRecord_GetResetCause() == RESET_CAUSE_WATCHDOG);
 
 	/* Clear the reset flags */
 	RCC_ClearFlag();
@@ -121,48 +214,230 @@ int main(void) {
 	/* Initialize the Tekdaqc's peripheral hardware */
 	Tekdaqc_Init();
 
+#ifdef FLOAT_BENCHMARK
+	/* Time the floating point paths before sampling starts */
+	Tekdaqc_RunFloatBenchmarks();
+#endif
+
 	Init_Locator();
 
-	if (InitializeTelnetServer() == TELNET_OK) {
+	SamplePublisherInit();
+
+	SNTPClientInit();
+
+	if ((InitializeTelnetServer() == TELNET_OK) && (InitializeDataServer() == DATA_SERVER_OK)
+			&& (InitializeUpgradeServer() == UPGRADE_SERVER_OK)) {
+		/* The Modbus server is an optional view of the board, so the board runs on without it */
+		if (Tekdaqc_ModbusInit() != MODBUS_SERVER_OK) {
+#ifdef DEBUG
+			printf("[Boot] The Modbus server could not be started.\n\r");
+#endif
+		}
+		/* As is the HTTP download server */
+		if (Tekdaqc_HttpInit() != HTTP_SERVER_OK) {
+#ifdef DEBUG
+			printf("[Boot] The HTTP server could not be started.\n\r");
+#endif
+		}
+#if LWIP_SNMP
+		/* The SNMP agent was started by lwIP, it only needs to describe the board */
+		Tekdaqc_SnmpInit();
+#endif
 		CreateCommandInterpreter();
+		Init_Tasks();
+		/* Start sampling right away if a job was saved, without waiting for a host */
+		SampleRoute_SetHold(StartSavedSamplingJob());
+		BootTimes_Mark(BOOT_SERVERS);
+#ifdef DEBUG
+		printf("[Boot] Ready after %lu us.\n\r", BootTimes_Total());
+#endif
+#ifdef BENCHMARK_SUITE
+		/* Run the scripted scenarios before taking commands */
+		Tekdaqc_RunBenchmarkSuite(&SampleRoute_WriteString, &SampleRoute_WriteBinary);
+#endif
 		program_loop();
 	} else {
 		/* We have a fatal error */
-		/* Reset the board */
+		/* Send what was logged about it before resetting the board */
+		Log_Flush();
 		NVIC_SystemReset();
 	}
 	return 0;
 }
 
 static void program_loop(void) {
+	uint64_t lastPass = GetLocalTime();
 	/* Infinite loop */
 	while (1) {
-		/* Service the inputs/outputs */
-		ServiceTasks();
+		/* Run the next pass of the scheduled tasks */
+		Scheduler_Run();
 
-		/* Check if any packet received */
-		if (ETH_CheckFrameReceived()) {
-			/* Process received ethernet packet */
-			LwIP_Pkt_Handle();
+		/* Reload the IWDG Counter to prevent reset, unless a supervised task has starved */
+		if (Scheduler_IsHealthy() == true) {
+			IWDG_ReloadCounter();
 		}
 
-		/* Handle periodic timers for LwIP */
-		LwIP_Periodic_Handle(GetLocalTime());
+		/* Sleep until an interrupt or the next task is due, if there is nothing to do */
+		Scheduler_Idle();
+
+		/* Record how regularly the loop comes around */
+		const uint64_t now = GetLocalTime();
+		TimingHistogram_Record(TIMING_LOOP_PERIOD, (uint32_t) (now - lastPass));
+		lastPass = now;
+	}
+}
+
+static void Init_Tasks(void) {
+	/* Sampling runs on every pass and between each low priority task */
+	Scheduler_AddTask(&Task_Sampling, TASK_PRIORITY_HIGH, 0U, 0U);
+
+	/* The network is guaranteed a slot on every pass */
+	Scheduler_AddTask(&Task_NetworkReceive, TASK_PRIORITY_NORMAL, 0U, NETWORK_RX_BUDGET_US);
+	Scheduler_AddTask(&Task_NetworkTransmit, TASK_PRIORITY_NORMAL, 0U, 0U);
+
+	/* Commands and status checks are deferred behind everything else */
+	Scheduler_AddTask(&Task_Commands, TASK_PRIORITY_LOW, 0U, COMMAND_BUDGET_US);
+	Scheduler_AddTask(&Task_Status, TASK_PRIORITY_LOW, STATUS_PERIOD_US, 0U);
+	Scheduler_AddTask(&Task_BoardTemperature, TASK_PRIORITY_LOW, BOARD_TEMPERATURE_PERIOD_US, 0U);
+	Scheduler_AddTask(&Task_Storage, TASK_PRIORITY_LOW, 0U, STORAGE_BUDGET_US);
+
+	/* Each of these must keep coming around for the watchdog to be fed */
+	Scheduler_SuperviseTask(&Task_Sampling, "SAMPLING", SAMPLING_TIMEOUT_US);
+	Scheduler_SuperviseTask(&Task_NetworkReceive, "NETWORK_RECEIVE", NETWORK_TIMEOUT_US);
+	Scheduler_SuperviseTask(&Task_NetworkTransmit, "NETWORK_TRANSMIT", NETWORK_TIMEOUT_US);
+	Scheduler_SuperviseTask(&Task_Commands, "COMMANDS", COMMAND_TIMEOUT_US);
+	Scheduler_SuperviseTask(&Task_Status, "STATUS", STATUS_TIMEOUT_US);
+}
+
+static bool Task_Sampling(void) {
+	/* Make the callbacks of any deadlines which have passed */
+	Timer_ServiceDeadlines();
+
+	/* Service the inputs/outputs */
+	ServiceTasks();
+	return false;
+}
+
+static bool Task_NetworkReceive(void) {
+	/* Check if any packet received */
+	if (ethernetif_frame_received()) {
+		/* Process received ethernet packet */
+		LwIP_Pkt_Handle();
+		return true;
+	}
+	return false;
+}
+
+static bool Task_NetworkTransmit(void) {
+	/* Free any frames the Ethernet DMA is done transmitting */
+	ethernetif_release_tx();
+
+	/* Handle periodic timers for LwIP */
+	LwIP_Periodic_Handle(GetLocalTime());
+
+	/* Send any pending output which is due */
+	TelnetService();
+	DataServerService();
+	UpgradeServerService();
+	WebSocketServerService();
+	SamplePublisherService();
+	RawStreamService();
+	return false;
+}
 
-		if (TelnetIsConnected() == true) { /* We have an active Telnet connection to service */
-			/* Do server stuff */
-			character = TelnetRead();
-			if (character != '\0') {
-				Command_AddChar(character);
-			}
+static bool Task_Commands(void) {
+	if (Command_IsIdle() == true) {
+		/* Take commands from each session in turn. A session keeps the interpreter until its command line, binary frame
+		 or batch is complete, so the commands of different clients are never mixed. */
+		TelnetSelectNextSession();
+	} else if (TelnetIsSessionConnected() == false) {
+		/* The client went away part way through a command */
+		Command_DiscardInput();
+	}
+	if (TelnetIsSessionConnected() == true) { /* We have an active Telnet connection to service */
+		/* Do server stuff */
+		const char* data;
+		uint16_t length = TelnetPeek(&data);
+		if (length > COMMAND_CHUNK_BYTES) {
+			length = COMMAND_CHUNK_BYTES;
+		}
+		if (length > 0U) {
+			Command_AddChars(data, length);
+			TelnetConsume(length);
+			return true;
 		}
+	}
+	return false;
+}
+
+static bool Task_Status(void) {
+	/* Check to see if any faults have occurred */
+	Tekdaqc_CheckStatus();
+
+	/* Keep the state of the firmware in the crash record */
+	CrashRecord_Snapshot();
 
-		/* Check to see if any faults have occurred */
-		Tekdaqc_CheckStatus();
+	/* Keep the time base synchronized with the time server */
+	SNTPClientService();
 
-		/* Reload the IWDG Counter to prevent reset */
-		IWDG_ReloadCounter();
+	/* Keep the load reported to discovery queries current */
+	UpdateLocatorLoad();
+
+	/* Write the runtime statistics, if they are being reported periodically */
+	Statistics_Service();
+	return false;
+}
+
+static bool Task_BoardTemperature(void) {
+	/* Queue the extremes, if they are due to be persisted */
+	persistBoardTemperatureExtremes();
+	return false;
+}
+
+static bool Task_Storage(void) {
+	/* Page erases stall the CPU, so they wait for the inputs to stop sampling */
+	const bool idle = (isADCSampling() == false) && (isDISampling() == false) && (isDOSampling() == false);
+	/* The EEPROM, the upgrade staging and the sample log share the FLASH controller, so only one of them is stepped
+	 at a time and none while another is erasing */
+	if ((EE_IsBusy() == TRUE) && (Upgrade_IsErasing() == false) && (SampleLog_IsErasing() == false)) {
+		return EE_Service(idle);
+	}
+	if ((SampleLog_IsErasing() == false) && (Upgrade_Service(idle) == true)) {
+		return true;
 	}
+	if (Upgrade_IsErasing() == false) {
+		return SampleLog_Service(idle);
+	}
+	return false;
+}
+
+static void UpdateLocatorLoad(void) {
+	static uint64_t lastUpdate = 0U;
+	static uint32_t lastConversions = 0U;
+	const uint64_t now = GetLocalTime();
+	if ((now - lastUpdate) < LOCATOR_LOAD_PERIOD_US) {
+		return;
+	}
+	const uint32_t conversions = ADC_Machine_GetConversionCount();
+	Tekdaqc_LocatorLoad_t load;
+	load.sampling = 0U;
+	if (isADCSampling() == true) {
+		load.sampling |= LOCATOR_SAMPLING_ANALOG;
+	}
+	if (isDISampling() == true) {
+		load.sampling |= LOCATOR_SAMPLING_DIGITAL_INPUTS;
+	}
+	if (isDOSampling() == true) {
+		load.sampling |= LOCATOR_SAMPLING_DIGITAL_OUTPUTS;
+	}
+	load.analogInputs = ADC_Machine_GetSamplingInputCount();
+	load.samplesPerSecond = (uint32_t) (((uint64_t) (conversions - lastConversions) * 1000000U) / (now - lastUpdate));
+	load.sessions = TelnetGetSessionCount();
+	load.maxSessions = TELNET_MAX_SESSIONS;
+	load.bufferFree = TelnetGetLowestFreeSpace();
+	Tekdaqc_LocatorLoadSet(&load);
+	lastUpdate = now;
+	lastConversions = conversions;
 }
 
 static void Init_Locator() {
@@ -187,29 +462,46 @@ static void Init_Locator() {
  * @retval none
  */
 static void Tekdaqc_Init(void) {
-	/* Initialize the Tekdaqc's communication methods */
+	/* Start the Tekdaqc's communication methods. The PHY comes out of reset while the rest of the hardware is
+	 * initialized below */
 	Communication_Init();
 
 	/* Initialize the command state handler. This will initialize any */
 	/* Input/Output state machines. */
 	InitCommandStateHandler();
+	BootTimes_Mark(BOOT_STATE_MACHINES);
 
 	/* Initialize the analog inputs */
 	AnalogInputsInit();
+	AnalogAux_Init();
+	BootTimes_Mark(BOOT_ANALOG_INPUTS);
 
 	/* Initialize the digital inputs */
 	DigitalInputsInit();
+	BootTimes_Mark(BOOT_DIGITAL_INPUTS);
 
 	/* Initialize the digital outputs */
 	DigitalOutputsInit();
+	BootTimes_Mark(BOOT_DIGITAL_OUTPUTS);
 
-	/* Set the write functions */
-	SetAnalogInputWriteFunction(&TelnetWriteString);
-	SetDigitalInputWriteFunction(&TelnetWriteString);
+	/* Route the sample data of every writer to the sample log and transports */
+	SetAnalogInputWriteFunction(&SampleRoute_WriteString);
+	SetAnalogInputBinaryWriteFunction(&SampleRoute_WriteBinary);
+	SetDigitalInputWriteFunction(&SampleRoute_WriteString);
+	SetDigitalInputBinaryWriteFunction(&SampleRoute_WriteBinary);
+	SetDigitalOutputWriteFunction(&SampleRoute_WriteString);
 
 	/* Initialize the FLASH disk */
 	FlashDiskInit();
 
+	/* Find any sample data logged before the reset, it is replayed once there is somewhere to send it */
+	SampleLog_Init(&SampleRoute_SendString, &SampleRoute_SendBinary);
+	BootTimes_Mark(BOOT_FLASH_DISK);
+
+	/* Start the CAN bus with the saved synchronization role */
+	Tekdaqc_CAN_Config();
+	Tekdaqc_CAN_SetSyncHandlers(&HandleSyncEvent, &AnalogTrigger_Fire);
+
 	/* Initialize the calibration table and fetch the board serial number */
 	Tekdaqc_CalibrationInit();
 	char data = '\0';
@@ -227,6 +519,14 @@ static void Tekdaqc_Init(void) {
 		Address += sizeof(char);
 	}
 	TEKDAQC_BOARD_SERIAL_NUM[BOARD_SERIAL_NUM_LENGTH] = '\0'; /* Apply the NULL termination character */
+	BootTimes_Mark(BOOT_CALIBRATION);
+
+	/* Add back the channels of the saved configuration, if there is one */
+	LoadChannelConfig();
+	BootTimes_Mark(BOOT_CHANNEL_CONFIG);
+
+	/* Complete the communication methods once the PHY is out of reset */
+	Communication_Complete();
 
 #ifdef USE_WATCHDOG
 	// Initialize the watchdog timer
@@ -100,6 +100,45 @@ LoopFillZerobss:
   cmp  r2, r3
   bcc  FillZerobss
 
+/* Copy the CCM RAM data initializers from flash. */
+  movs  r1, #0
+  b  LoopCopyCcmInit
+
+CopyCcmInit:
+  ldr  r3, =_siccmram
+  ldr  r3, [r3, r1]
+  str  r3, [r0, r1]
+  adds  r1, r1, #4
+
+LoopCopyCcmInit:
+  ldr  r0, =_sccmram
+  ldr  r3, =_eccmram
+  adds  r2, r0, r1
+  cmp  r2, r3
+  bcc  CopyCcmInit
+  ldr  r2, =_sccmbss
+  b  LoopFillZeroCcm
+/* Zero fill the CCM RAM bss segment. */
+FillZeroCcm:
+  movs  r3, #0
+  str  r3, [r2], #4
+
+LoopFillZeroCcm:
+  ldr  r3, = _eccmbss
+  cmp  r2, r3
+  bcc  FillZeroCcm
+  ldr  r2, =_ssram2
+  b  LoopFillZeroSram2
+/* Zero fill the SRAM2 segment of the Ethernet DMA. */
+FillZeroSram2:
+  movs  r3, #0
+  str  r3, [r2], #4
+
+LoopFillZeroSram2:
+  ldr  r3, = _esram2
+  cmp  r2, r3
+  bcc  FillZeroSram2
+
 /* Call the clock system intitialization function.*/
   bl  SystemInit   
 /* Call static constructors */
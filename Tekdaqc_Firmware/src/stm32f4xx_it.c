@@ -34,20 +34,68 @@
  */
 
 /* Includes ------------------------------------------------------------------*/
+#include "stm32f4xx_it.h"
 #include "Tekdaqc_Timers.h"
 #include "Tekdaqc_Config.h"
 #include "Tekdaqc_CAN.h"
-#include <stdio.h>
-#include <inttypes.h>
+#include "DigitalInput_Edge.h"
+#include "TLE7232_RelayDriver.h"
+#include "Digital_Output.h"
+#include "AnalogInput_Multiplexer.h"
+#include "ADC_StateMachine.h"
+#include "ethernetif.h"
+#include "Tekdaqc_CrashRecord.h"
+#include "Tekdaqc_Scheduler.h"
+#include "Tekdaqc_Log.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
+/* The initial stack pointer, the 15 system exceptions and the 82 interrupts up to FPU_IRQn */
+#define RAM_VECTOR_COUNT		98U
+
+/* VTOR needs the table aligned to its size rounded up to a power of two */
+#define RAM_VECTOR_ALIGNMENT	512U
+
+#if ((RAM_VECTOR_COUNT * 4U) > RAM_VECTOR_ALIGNMENT)
+#error "RAM_VECTOR_ALIGNMENT must be at least the size of the vector table."
+#endif
+
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 uint16_t tmpCC4[2] = {0, 0};
+
+/* The vector table in FLASH, from the startup file */
+extern const uint32_t g_pfnVectors[];
+
+/* The copy of the vector table the core runs from, so exception entry never fetches from FLASH */
+static uint32_t RamVectors[RAM_VECTOR_COUNT] __attribute__ ((aligned (RAM_VECTOR_ALIGNMENT)));
+
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 
+/******************************************************************************/
+/*                         Vector Table Relocation                            */
+/******************************************************************************/
+
+/**
+ * @brief  Copies the vector table into SRAM1 and points the core at the copy. Exception entry fetches the vector in
+ *         parallel with stacking, from FLASH this can miss the ART cache and stalls for the whole of a FLASH erase,
+ *         from SRAM1 it never waits. Handlers declared RAM_FUNCTION are entered at their RAM addresses as before.
+ *         Must be called before any interrupt is enabled, handlers cannot be changed afterwards.
+ * @param  None
+ * @retval None
+ */
+void RelocateVectorTable(void) {
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	for (uint32_t i = 0U; i < RAM_VECTOR_COUNT; ++i) {
+		RamVectors[i] = g_pfnVectors[i];
+	}
+	SCB->VTOR = (uint32_t) RamVectors;
+	__DSB();
+	__set_PRIMASK(primask);
+}
+
 /******************************************************************************/
 /*            Cortex-M4 Processor Exceptions Handlers                         */
 /******************************************************************************/
@@ -61,67 +109,17 @@ void NMI_Handler(void) {
 }
 
 /**
- * @brief  This function handles Hard Fault exception.
+ * @brief  This function handles Hard Fault exception. The stack holding the exception frame is passed on to the
+ * crash record, which saves the fault and resets the board.
  * @param  None
  * @retval None
  */
-void HardFault_Handler(void) {
-	volatile unsigned long stacked_r0;
-	volatile unsigned long stacked_r1;
-	volatile unsigned long stacked_r2;
-	volatile unsigned long stacked_r3;
-	volatile unsigned long stacked_r12;
-	volatile unsigned long stacked_lr;
-	volatile unsigned long stacked_pc;
-	volatile unsigned long stacked_psr;
-	/*volatile unsigned long _CFSR;
-	volatile unsigned long _HFSR;
-	volatile unsigned long _DFSR;
-	volatile unsigned long _AFSR;
-	volatile unsigned long _BFAR;
-	volatile unsigned long _MMAR;*/
-	uint32_t* hardfault_args = (uint32_t*) 0x20000400;
-
-	asm("TST LR, #4 \n"
+__attribute__((naked)) void HardFault_Handler(void) {
+	__asm volatile("TST LR, #4 \n"
 			"ITE EQ \n"
 			"MRSEQ R0, MSP \n"
-			"MRSNE R0, PSP \n");
-
-	stacked_r0 = ((unsigned long) hardfault_args[0]);
-	stacked_r1 = ((unsigned long) hardfault_args[1]);
-	stacked_r2 = ((unsigned long) hardfault_args[2]);
-	stacked_r3 = ((unsigned long) hardfault_args[3]);
-
-	stacked_r12 = ((unsigned long) hardfault_args[4]);
-	stacked_lr = ((unsigned long) hardfault_args[5]);
-	stacked_pc = ((unsigned long) hardfault_args[6]);
-	stacked_psr = ((unsigned long) hardfault_args[7]);
-
-	printf("[Hard fault handler]\n");
-	printf("R0 = %" PRIx32 "\n", stacked_r0);
-	printf("R1 = %" PRIx32 "\n", stacked_r1);
-	printf("R2 = %" PRIx32 "\n", stacked_r2);
-	printf("R3 = %" PRIx32 "\n", stacked_r3);
-	printf("R12 = %" PRIx32 "\n", stacked_r12);
-	printf("LR = %" PRIx32 "\n", stacked_lr);
-	printf("PC = %" PRIx32 "\n", stacked_pc);
-	printf("PSR = %" PRIx32 "\n", stacked_psr);
-	printf("BFAR = %" PRIx32 "\n", (*((volatile unsigned long *) (0xE000ED38))));
-	printf("CFSR = %" PRIx32 "\n", (*((volatile unsigned long *) (0xE000ED28))));
-	printf("HFSR = %" PRIx32 "\n", (*((volatile unsigned long *) (0xE000ED2C))));
-	printf("SCB->HFSR = 0x%08" PRIx32 "\n", SCB ->HFSR);
-	printf("DFSR = %" PRIx32 "\n", (*((volatile unsigned long *) (0xE000ED30))));
-	printf("AFSR = %" PRIx32 "\n", (*((volatile unsigned long *) (0xE000ED3C))));
-
-	if ((SCB ->HFSR & (1 << 30)) != 0) {
-		printf("Forced Hard Fault\n");
-		printf("SCB->CFSR = 0x%08" PRIx32 "\n", SCB ->CFSR);
-	}
-
-	/* Go to infinite loop when Hard Fault exception occurs */
-	while (1) {
-		__asm("BKPT #0\n"); //Break into the debugger
-	}
+			"MRSNE R0, PSP \n"
+			"B CrashRecord_HardFault \n");
 }
 
 /**
@@ -129,10 +127,12 @@ void HardFault_Handler(void) {
  * @param  None
  * @retval None
  */
-void MemManage_Handler(void) {
-	/* Go to infinite loop when Memory Manage exception occurs */
-	while (1) {
-	}
+__attribute__((naked)) void MemManage_Handler(void) {
+	__asm volatile("TST LR, #4 \n"
+			"ITE EQ \n"
+			"MRSEQ R0, MSP \n"
+			"MRSNE R0, PSP \n"
+			"B CrashRecord_MemManage \n");
 }
 
 /**
@@ -140,10 +140,12 @@ void MemManage_Handler(void) {
  * @param  None
  * @retval None
  */
-void BusFault_Handler(void) {
-	/* Go to infinite loop when Bus Fault exception occurs */
-	while (1) {
-	}
+__attribute__((naked)) void BusFault_Handler(void) {
+	__asm volatile("TST LR, #4 \n"
+			"ITE EQ \n"
+			"MRSEQ R0, MSP \n"
+			"MRSNE R0, PSP \n"
+			"B CrashRecord_BusFault \n");
 }
 
 /**
@@ -151,10 +153,12 @@ void BusFault_Handler(void) {
  * @param  None
  * @retval None
  */
-void UsageFault_Handler(void) {
-	/* Go to infinite loop when Usage Fault exception occurs */
-	while (1) {
-	}
+__attribute__((naked)) void UsageFault_Handler(void) {
+	__asm volatile("TST LR, #4 \n"
+			"ITE EQ \n"
+			"MRSEQ R0, MSP \n"
+			"MRSNE R0, PSP \n"
+			"B CrashRecord_UsageFault \n");
 }
 
 /**
@@ -171,17 +175,76 @@ void DebugMon_Handler(void) {
  * @retval None
  */
 void SysTick_Handler(void) {
-	/* Update the LocalTime by adding SYSTEMTICK_PERIOD_MS each SysTick interrupt */
-	//printf("SysTick_Handler...\n");
-	//TestPin_On(PIN2);
-	Time_Update();
-	//TestPin_Off(PIN2);
+	/* The local time is kept by the time base timer, see TIM2_IRQHandler(). The tick only runs while any digital input
+	 * is debounced. */
+	DigitalInputsDebounceTick();
+	Scheduler_RequestPass();
 }
 
 /******************************************************************************/
 /*            STM32F4xx Peripherals Interrupt Handlers                        */
 /******************************************************************************/
 
+/**
+ * @brief  This function handles External line 0 interrupt request.
+ * @param  None
+ * @retval None
+ */
+void EXTI0_IRQHandler(void) {
+	DigitalEdge_IRQHandler();
+	Scheduler_RequestPass();
+}
+
+/**
+ * @brief  This function handles External line 1 interrupt request.
+ * @param  None
+ * @retval None
+ */
+void EXTI1_IRQHandler(void) {
+	DigitalEdge_IRQHandler();
+	Scheduler_RequestPass();
+}
+
+/**
+ * @brief  This function handles External line 2 interrupt request.
+ * @param  None
+ * @retval None
+ */
+void EXTI2_IRQHandler(void) {
+	DigitalEdge_IRQHandler();
+	Scheduler_RequestPass();
+}
+
+/**
+ * @brief  This function handles External line 3 interrupt request.
+ * @param  None
+ * @retval None
+ */
+void EXTI3_IRQHandler(void) {
+	DigitalEdge_IRQHandler();
+	Scheduler_RequestPass();
+}
+
+/**
+ * @brief  This function handles External line 4 interrupt request.
+ * @param  None
+ * @retval None
+ */
+void EXTI4_IRQHandler(void) {
+	DigitalEdge_IRQHandler();
+	Scheduler_RequestPass();
+}
+
+/**
+ * @brief  This function handles External lines 5 to 9 interrupt request.
+ * @param  None
+ * @retval None
+ */
+void EXTI9_5_IRQHandler(void) {
+	DigitalEdge_IRQHandler();
+	Scheduler_RequestPass();
+}
+
 /**
  * @brief  This function handles External line 10 interrupt request.
  * @param  None
@@ -189,10 +252,31 @@ void SysTick_Handler(void) {
  */
 void EXTI15_10_IRQHandler(void) {
 	if (EXTI_GetITStatus(ETH_LINK_EXTI_LINE) != RESET) {
-		Eth_Link_ITHandler(DP83848_PHY_ADDRESS);
-		// Clear interrupt pending bit
+		/* Reading the PHY would hold off the DRDY interrupt sharing this vector, so it is left for the program loop */
 		EXTI_ClearITPendingBit(ETH_LINK_EXTI_LINE);
+		Scheduler_Defer(&Eth_Link_Deferred, DP83848_PHY_ADDRESS);
 	}
+	ADS1256_DRDY_IRQHandler();
+	DigitalEdge_IRQHandler();
+	Scheduler_RequestPass();
+}
+
+/**
+ * @brief  This function handles the Ethernet DMA interrupt.
+ * @param  None
+ * @retval None
+ */
+void ETH_IRQHandler(void) {
+	ethernetif_irq_handler();
+}
+
+/**
+ * @brief  This function handles the time base timer overflow interrupt.
+ * @param  None
+ * @retval None
+ */
+void TIM2_IRQHandler(void) {
+	Time_Update();
 }
 
 void TIM5_IRQHandler(void) {
@@ -210,16 +294,81 @@ void TIM5_IRQHandler(void) {
 	}
 }
 
+/**
+ * @brief  This function handles the ADS1256 SPI receive DMA stream interrupt.
+ * @param  None
+ * @retval None
+ */
+void DMA1_Stream3_IRQHandler(void) {
+	ADS1256_SPI_DMA_IRQHandler();
+	Scheduler_RequestPass();
+}
+
+/**
+ * @brief  This function handles the debug serial port interrupt, which drains the debug log.
+ * @param  None
+ * @retval None
+ */
+void USART3_IRQHandler(void) {
+	Log_IRQHandler();
+}
+
+/**
+ * @brief  This function handles the TLE7232 SPI receive DMA stream interrupt.
+ * @param  None
+ * @retval None
+ */
+void DMA2_Stream0_IRQHandler(void) {
+	TLE7232_SPI_DMA_IRQHandler();
+	Scheduler_RequestPass();
+}
+
+/**
+ * @brief  This function handles the external multiplexer settle timer interrupt.
+ * @param  None
+ * @retval None
+ */
+void TIM6_DAC_IRQHandler(void) {
+	InputMultiplexer_SettleIRQHandler();
+	Scheduler_RequestPass();
+}
+
+/**
+ * @brief  This function handles the snapshot frame timer interrupt.
+ * @param  None
+ * @retval None
+ */
+void TIM3_IRQHandler(void) {
+	ADC_Machine_FrameIRQHandler();
+	Scheduler_RequestPass();
+}
+
+/**
+ * @brief  This function handles the digital output tick timer interrupt.
+ * @param  None
+ * @retval None
+ */
+void TIM7_IRQHandler(void) {
+	DigitalOutputsTick();
+}
+
 /**
   * @brief  This function handles CAN1 RX0 request.
   * @param  None
   * @retval None
   */
 void CAN1_RX0_IRQHandler(void) {
-  CAN_Receive(CAN1, CAN_FIFO0, &RxMessage);
-  if ((RxMessage.StdId == 0x321)&&(RxMessage.IDE == CAN_ID_STD) && (RxMessage.DLC == 1)) {
-    printf("[CAN Handler] Data: %" PRIu8 "\n\r", RxMessage.Data[0]);
-  }
+  Tekdaqc_CAN_ReceiveHandler();
+  Scheduler_RequestPass();
+}
+
+/**
+  * @brief  This function handles CAN1 TX request.
+  * @param  None
+  * @retval None
+  */
+void CAN1_TX_IRQHandler(void) {
+  Tekdaqc_CAN_TransmitHandler();
 }
 
 /******************************************************************************/
@@ -41,6 +41,7 @@
 #include <sys/times.h>
 #include "Tekdaqc_Debug.h"
 #include "Tekdaqc_BSP.h"
+#include "Tekdaqc_Log.h"
 
 /* Variables */
 #undef errno
@@ -72,15 +73,8 @@ void _exit(int32_t status) {
 
 int _write(int32_t file, uint8_t *ptr, int32_t len) {
 #if defined(SERIAL_DEBUG)
-	int32_t i = 0;
-	for (i = 0; i < len; ++i) {
-		/* Write a character to the USART */
-		USART_SendData(COM2_USART, ptr[i]);
-
-		/* Loop until the end of transmission */
-		while (USART_GetFlagStatus(COM2_USART, USART_FLAG_TC) == RESET) {
-		}
-	}
+	/* Queue the characters in the debug log, which sends them in the background */
+	Log_Write((const char*) ptr, (uint32_t) len);
 #elif defined(SWV_DEBUG)
 	int i=0;
 	for(i=0 ; i<len ; i++) {
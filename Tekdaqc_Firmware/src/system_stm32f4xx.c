@@ -216,6 +216,8 @@ void SystemInit(void)
   /* FPU settings ------------------------------------------------------------*/
   #if (__FPU_PRESENT == 1) && (__FPU_USED == 1)
     SCB->CPACR |= ((3UL << 10*2)|(3UL << 11*2));  /* set CP10 and CP11 Full Access */
+    /* Save the FPU registers on exception entry only once the handler uses them (lazy stacking) */
+    FPU->FPCCR |= (FPU_FPCCR_ASPEN_Msk | FPU_FPCCR_LSPEN_Msk);
   #endif
   /* Reset the RCC clock configuration to the default reset state ------------*/
   /* Set HSION bit */
@@ -0,0 +1,280 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Receiver.h
+ * @brief Header file for the host side reference receiver of the Tekdaqc's sample streams.
+ *
+ * Contains public definitions and data types for decoding the Tekdaqc's sample data on a host. The receiver is
+ * independent of the transport: the bytes of a Telnet or data connection are fed to it as they arrive, in pieces of
+ * any size, and each datagram published over UDP is fed to it whole. It decodes the binary analog frames, packed
+ * records included, keeps the timestamp and sequence number of every channel and counts the samples the board
+ * reports lost, and hands each sample, record and text message to a callback. The framing itself is described at the
+ * top of Analog_Input.c, Digital_Input.c, Tekdaqc_SampleLog.c and SamplePublisher.c in the firmware.
+ *
+ * This is host code, built with the host's C99 compiler rather than as part of the firmware, see
+ * Tekdaqc_ReceiverBenchmark.c.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_RECEIVER_H_
+#define TEKDAQC_RECEIVER_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/** @addtogroup tekdaqc_host Tekdaqc Host
+ * @{
+ */
+
+/** @addtogroup tekdaqc_receiver Tekdaqc Reference Receiver
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def RECEIVER_CHANNEL_COUNT
+ * @brief The number of channels the receiver keeps state for, every value of a record's channel byte.
+ */
+#define RECEIVER_CHANNEL_COUNT		256U
+
+/**
+ * @def RECEIVER_BUFFER_SIZE
+ * @brief The size of the buffer holding an incomplete frame or text message, enough for the longest frame.
+ */
+#define RECEIVER_BUFFER_SIZE		(3U + 0xFFFFU)
+
+/**
+ * @def RECEIVER_REORDER_COUNT
+ * @brief The number of published datagrams held while waiting for a missing one to be sent again. The board keeps
+ * only its last few batches, so waiting past this many is pointless.
+ */
+#define RECEIVER_REORDER_COUNT		3U
+
+/**
+ * @def RECEIVER_DATAGRAM_SIZE
+ * @brief The largest published datagram the receiver can hold for reordering.
+ */
+#define RECEIVER_DATAGRAM_SIZE		1500U
+
+/**
+ * @def RECEIVER_FIELD_TIMESTAMP
+ * @brief Sample records carry a delta timestamp, as DATA_FIELD_TIMESTAMP in the firmware.
+ */
+#define RECEIVER_FIELD_TIMESTAMP	((uint8_t) 0x01)
+
+/**
+ * @def RECEIVER_FIELD_FLAGS
+ * @brief Sample records carry their flags, as DATA_FIELD_FLAGS in the firmware.
+ */
+#define RECEIVER_FIELD_FLAGS		((uint8_t) 0x02)
+
+/**
+ * @def RECEIVER_FIELD_SEQUENCE
+ * @brief Samples are sequence numbered, as DATA_FIELD_SEQUENCE in the firmware.
+ */
+#define RECEIVER_FIELD_SEQUENCE		((uint8_t) 0x04)
+
+/**
+ * @def RECEIVER_FIELDS_DEFAULT
+ * @brief The fields sent to a client which did not select them with the FORMAT command.
+ */
+#define RECEIVER_FIELDS_DEFAULT		(RECEIVER_FIELD_TIMESTAMP | RECEIVER_FIELD_FLAGS | RECEIVER_FIELD_SEQUENCE)
+
+/**
+ * @def RECEIVER_PUBLISH_RESEND_REQUEST
+ * @brief The first byte of a datagram asking the board to publish a batch again, as PUBLISH_RESEND_REQUEST.
+ */
+#define RECEIVER_PUBLISH_RESEND_REQUEST	((uint8_t) 'R')
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief The kinds of events the receiver reports.
+ */
+typedef enum {
+	RECEIVER_EVENT_SAMPLE, /**< An analog sample, from a sample or a packed record. */
+	RECEIVER_EVENT_CONFIG, /**< A channel's settings, timestamp and sequence number were given. */
+	RECEIVER_EVENT_GAP, /**< A channel's sequence number jumped; lost holds the number of samples lost. */
+	RECEIVER_EVENT_FORMAT, /**< A stream descriptor changed the fields of the sample records. */
+	RECEIVER_EVENT_RECORD, /**< Any other analog record, left raw in data. */
+	RECEIVER_EVENT_DIGITAL, /**< A digital input frame, its records left raw in data. */
+	RECEIVER_EVENT_MARKER, /**< A sample log marker; sequence is that of the replayed record which follows. */
+	RECEIVER_EVENT_TEXT, /**< A text message or text sample record, without its record separator. */
+	RECEIVER_EVENT_RESEND, /**< A published datagram is missing; ask for batch sequence to be sent again. */
+	RECEIVER_EVENT_DATAGRAMS_LOST /**< Published datagrams were given up on; lost holds how many. */
+} Receiver_EventType_t;
+
+/**
+ * @brief An event reported by the receiver. Only the members relevant to the type are set.
+ */
+typedef struct {
+	Receiver_EventType_t type; /**< The kind of event. */
+	uint8_t channel; /**< The physical input of an analog event. */
+	bool timed; /**< TRUE if the timestamp of a sample is known. */
+	uint8_t flags; /**< The flags of a sample. */
+	int32_t value; /**< The raw ADC code of a sample, sign extended. */
+	uint64_t timestamp; /**< The timestamp of a sample or config record, in the board's epoch microseconds. */
+	uint32_t sequence; /**< The sequence number of a sample, config, gap, marker or resend event. */
+	uint32_t lost; /**< The number of samples or datagrams lost. */
+	const uint8_t* data; /**< The raw bytes of a record, frame or text message, starting with its type byte. */
+	uint32_t length; /**< The number of bytes in data. */
+} Receiver_Event_t;
+
+/**
+ * @brief The function the receiver reports its events to.
+ *
+ * @param event const Receiver_Event_t* The event, only valid for the duration of the call.
+ * @param context void* The context the receiver was initialized with.
+ */
+typedef void (*Receiver_Callback)(const Receiver_Event_t* event, void* context);
+
+/**
+ * @brief The decoding state of a single analog channel, mirroring the board's BinaryChannelState_t.
+ */
+typedef struct {
+	bool valid; /**< TRUE once a config record was received for the channel. */
+	uint8_t gain; /**< The gain of the channel's samples. */
+	uint8_t rate; /**< The data rate setting of the channel. */
+	uint64_t timestamp; /**< The timestamp of the channel's previous sample. */
+	uint32_t sequence; /**< The sequence number of the channel's next sample. */
+} Receiver_Channel_t;
+
+/**
+ * @brief A published datagram held until those before it have arrived.
+ */
+typedef struct {
+	bool used; /**< TRUE if the slot holds a datagram. */
+	uint32_t sequence; /**< The sequence number of the datagram. */
+	uint16_t length; /**< The number of bytes in data. */
+	uint8_t data[RECEIVER_DATAGRAM_SIZE]; /**< The datagram, header included. */
+} Receiver_Datagram_t;
+
+/**
+ * @brief The counters kept by the receiver since it was initialized.
+ */
+typedef struct {
+	uint64_t samples; /**< Analog samples decoded. */
+	uint64_t lostSamples; /**< Analog samples reported lost through config and gap records. */
+	uint64_t frames; /**< Analog and digital frames decoded. */
+	uint64_t bytes; /**< Bytes fed to the receiver. */
+	uint64_t discarded; /**< Bytes dropped as undecodable. */
+	uint64_t datagrams; /**< Published datagrams decoded in order. */
+	uint64_t lostDatagrams; /**< Published datagrams never received. */
+	uint64_t resentDatagrams; /**< Published datagrams recovered after a resend request. */
+} Receiver_Counters_t;
+
+/**
+ * @brief The state of a reference receiver. Large, so best not placed on the stack.
+ */
+typedef struct {
+	Receiver_Callback callback; /**< The function events are reported to. */
+	void* context; /**< The context passed to the callback. */
+	uint8_t fields; /**< The RECEIVER_FIELD_ bits of the sample records. */
+	uint8_t sampleSize; /**< The size of a sample record with these fields. */
+	bool resumed; /**< TRUE if a sample log resume was requested, so the board sends markers. */
+	uint32_t marker; /**< The sequence number of the last sample log marker received. */
+	bool publishing; /**< TRUE once the first published datagram was received. */
+	uint32_t datagram; /**< The sequence number of the next published datagram. */
+	Receiver_Datagram_t held[RECEIVER_REORDER_COUNT]; /**< Datagrams waiting for a missing one. */
+	Receiver_Channel_t channels[RECEIVER_CHANNEL_COUNT]; /**< The state of every analog channel. */
+	Receiver_Counters_t counters; /**< The counters since initialization. */
+	uint32_t length; /**< The number of bytes in buffer. */
+	uint8_t buffer[RECEIVER_BUFFER_SIZE]; /**< The start of a frame or message not yet complete. */
+} Tekdaqc_Receiver_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Initializes a receiver to report its events to the provided callback.
+ */
+void Receiver_Init(Tekdaqc_Receiver_t* receiver, Receiver_Callback callback, void* context);
+
+/**
+ * @brief Forgets every channel's state, as the board does when the data format is set.
+ */
+void Receiver_ResetFraming(Tekdaqc_Receiver_t* receiver);
+
+/**
+ * @brief Sets the fields of the sample records, for a client which selected them without a stream descriptor.
+ */
+void Receiver_SetFields(Tekdaqc_Receiver_t* receiver, uint8_t fields);
+
+/**
+ * @brief Tells the receiver a sample log resume was requested, so sample log markers are to be expected.
+ */
+void Receiver_SetResumed(Tekdaqc_Receiver_t* receiver, uint32_t sequence);
+
+/**
+ * @brief Retrieves the sequence number of the last sample log marker received, to resume from on reconnecting.
+ */
+uint32_t Receiver_GetMarker(const Tekdaqc_Receiver_t* receiver);
+
+/**
+ * @brief Feeds the bytes received on a Telnet or data connection to the receiver.
+ */
+void Receiver_Feed(Tekdaqc_Receiver_t* receiver, const uint8_t* data, size_t length);
+
+/**
+ * @brief Feeds a datagram published over UDP to the receiver.
+ */
+void Receiver_FeedDatagram(Tekdaqc_Receiver_t* receiver, const uint8_t* data, size_t length);
+
+/**
+ * @brief Gives up on any missing published datagrams and decodes those held back waiting for them.
+ */
+void Receiver_FlushDatagrams(Tekdaqc_Receiver_t* receiver);
+
+/**
+ * @brief Fills in a datagram asking the board to publish a batch again.
+ */
+size_t Receiver_ResendRequest(uint32_t sequence, uint8_t* request);
+
+/**
+ * @brief Retrieves the counters of the receiver.
+ */
+const Receiver_Counters_t* Receiver_GetCounters(const Tekdaqc_Receiver_t* receiver);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_RECEIVER_H_ */
@@ -0,0 +1,301 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Sim.h
+ * @brief Header file for the simulated board the acquisition firmware is run on by a host.
+ *
+ * Contains the interface between the parts of the simulated board: its clock, the peripherals and analog front end
+ * of Tekdaqc_SimBoard.c, the ADS1256 of Tekdaqc_SimADS1256.c and the TCP connection of Tekdaqc_SimSink.c. Time only
+ * passes when Sim_Advance() is called, by the stand ins for the delays and the SPI bus while the firmware runs and by
+ * the program loop of Tekdaqc_AcquisitionSim.c between its calls into the firmware. The firmware's own code takes no
+ * simulated time between its accesses to the hardware. The interrupts of the simulated peripherals are taken as soon
+ * as time passes after they are raised, in a delay, an SPI byte or a pin read, unless an interrupt handler is already
+ * running, as all of the acquisition interrupts share a priority on the board.
+ *
+ * Only fixed width types are used here, as the sink is built against the receiver's stdbool.h and the rest of the
+ * simulation against the firmware's boolean.h.
+ *
+ * This is host code, built with the host's C99 compiler rather than as part of the firmware, see
+ * Tekdaqc_AcquisitionSim.c.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_SIM_H_
+#define TEKDAQC_SIM_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include <stdint.h>
+
+/** @addtogroup tekdaqc_host Tekdaqc Host
+ * @{
+ */
+
+/** @addtogroup tekdaqc_sim Tekdaqc Acquisition Simulation
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def SIM_CORE_CLOCK_HZ
+ * @brief The simulated core clock, that of the board.
+ */
+#define SIM_CORE_CLOCK_HZ			168000000U
+
+/**
+ * @def SIM_TIMER_CLOCK_HZ
+ * @brief The simulated clock of the APB1 timers, twice PCLK1 as the APB1 prescaler is 4.
+ */
+#define SIM_TIMER_CLOCK_HZ			84000000U
+
+/**
+ * @def SIM_SPI_CLOCK_HZ
+ * @brief The simulated SCLK of the ADS1256, the fastest the SPI prescalers give within ADS1256_SPI_MAX_SCLK_HZ.
+ */
+#define SIM_SPI_CLOCK_HZ			1312500U
+
+/**
+ * @def SIM_AIN_COUNT
+ * @brief The number of analog inputs of the ADS1256, AIN0 to AIN7 and AINCOM, numbered as ADS1256_AIN_t.
+ */
+#define SIM_AIN_COUNT				9U
+
+/**
+ * @def SIM_EXTERNAL_COUNT
+ * @brief The number of external inputs of the simulated board, as NUM_EXT_ANALOG_INPUTS.
+ */
+#define SIM_EXTERNAL_COUNT			32U
+
+/**
+ * @def SIM_NO_EXTERNAL
+ * @brief The external multiplexer selection when its select lines match no input.
+ */
+#define SIM_NO_EXTERNAL				((uint8_t) 0xFFU)
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief The results of offering data to the simulated TCP connection, which mirror WriteStatus_t.
+ */
+typedef enum {
+	SIM_SINK_ACCEPTED, /**< All of the data was queued. */
+	SIM_SINK_FULL, /**< There is not currently enough room for the data. */
+	SIM_SINK_TOO_LARGE /**< The data can never fit in the send buffer. */
+} SimSink_Status_t;
+
+/**
+ * @brief What the simulated ADS1256 counted since it was last powered up.
+ */
+typedef struct {
+	uint32_t conversions; /**< Conversions completed. */
+	uint32_t reads; /**< Conversions read out over SPI. */
+	uint32_t missed; /**< Conversions replaced by the next before they were read. */
+	uint32_t unsettled; /**< Conversions read out whose input was still switching while they were taken. */
+	uint32_t restarts; /**< Times the conversions were restarted, by a command, a register write or the SYNC pin. */
+	uint32_t commands; /**< Command bytes received, register reads and writes included. */
+	uint32_t bytes; /**< Bytes clocked over SPI. */
+} SimADS1256_Counters_t;
+
+/**
+ * @brief What the receiver on the other end of the simulated TCP connection saw of a single channel.
+ */
+typedef struct {
+	uint32_t samples; /**< Samples received. */
+	uint32_t lost; /**< Samples the board reported lost, through gaps in the sequence numbers. */
+	uint32_t errors; /**< Samples whose value was not the one applied to the input. */
+	uint32_t disordered; /**< Samples timestamped before the channel's previous one. */
+	int32_t first; /**< The value of the first sample. */
+	uint64_t start; /**< The timestamp of the first sample, in microseconds. */
+	uint64_t end; /**< The timestamp of the last sample, in microseconds. */
+	uint64_t minInterval; /**< The shortest time between two of the channel's samples, in microseconds. */
+	uint64_t maxInterval; /**< The longest time between two of the channel's samples, in microseconds. */
+	uint64_t maxLatency; /**< The longest time from a sample's timestamp to its arrival, in microseconds. */
+} SimSink_Channel_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Maps the peripheral memory and powers up the simulated board at time 0.
+ */
+void SimBoard_Init(void);
+
+/**
+ * @brief Retrieves the simulated time in nanoseconds.
+ */
+uint64_t Sim_GetTime(void);
+
+/**
+ * @brief Runs the simulated hardware for the provided number of nanoseconds, taking its interrupts as they are raised.
+ */
+void Sim_Advance(uint64_t ns);
+
+/**
+ * @brief Sets the voltage applied to an external input, relative to the analog ground.
+ */
+void SimBoard_SetExternalVoltage(uint8_t input, double volts);
+
+/**
+ * @brief Sets the voltage on one of the ADS1256's own analog inputs. AIN0 follows the external multiplexer and
+ * AIN1, its analog ground, is 0 V.
+ */
+void SimBoard_SetAinVoltage(uint8_t ain, double volts);
+
+/**
+ * @brief Sets the time the external multiplexer takes to conduct once its select lines change, in nanoseconds.
+ */
+void SimBoard_SetMuxSettleTime(uint32_t ns);
+
+/**
+ * @brief Retrieves the external input the external multiplexer's select lines point at, SIM_NO_EXTERNAL for none.
+ */
+uint8_t SimBoard_GetExternalSelection(void);
+
+/**
+ * @brief Retrieves the mean voltage on an ADS1256 input over a window of simulated time. Sets unsettled to 1 if the
+ * external multiplexer was still switching during it.
+ */
+double SimBoard_GetAinVoltage(uint8_t ain, uint64_t start, uint64_t end, uint8_t* unsettled);
+
+/**
+ * @brief Drives the ADS1256's DRDY output, 0 for data ready.
+ */
+void SimBoard_SetDataReady(uint8_t level);
+
+/**
+ * @brief Powers up the simulated ADS1256, its registers at their defaults and converting.
+ */
+void SimADS1256_PowerUp(void);
+
+/**
+ * @brief Called as the ADS1256's chip select changes, 0 for selected.
+ */
+void SimADS1256_SetChipSelect(uint8_t level);
+
+/**
+ * @brief Called as the ADS1256's SYNC/PDWN pin changes.
+ */
+void SimADS1256_SetSyncPin(uint8_t level);
+
+/**
+ * @brief Called as the ADS1256's RESET pin changes.
+ */
+void SimADS1256_SetResetPin(uint8_t level);
+
+/**
+ * @brief Retrieves the simulated time of the next event of the ADS1256, UINT64_MAX for none.
+ */
+uint64_t SimADS1256_GetNextEvent(void);
+
+/**
+ * @brief Makes the ADS1256's events which are due at the current simulated time.
+ */
+void SimADS1256_Process(void);
+
+/**
+ * @brief Retrieves what the simulated ADS1256 counted since it was powered up.
+ */
+void SimADS1256_GetCounters(SimADS1256_Counters_t* counters);
+
+/**
+ * @brief Retrieves the code the ADS1256 converts a differential voltage to at the provided PGA gain, its calibration
+ * registers at unity.
+ */
+int32_t SimADS1256_IdealCode(double volts, uint8_t gain);
+
+/**
+ * @brief Sets up the simulated TCP connection with a send buffer of the provided size, sent at the provided rate in
+ * bytes per second. Anything queued is discarded and the receiver started afresh.
+ */
+void SimSink_Init(uint32_t capacity, uint32_t rate);
+
+/**
+ * @brief Offers data to the simulated TCP connection, which queues all of it or none.
+ */
+SimSink_Status_t SimSink_Write(const uint8_t* data, uint16_t length);
+
+/**
+ * @brief Sends what the link has had time to send since the last call, handing it to the receiver.
+ */
+void SimSink_Service(void);
+
+/**
+ * @brief Retrieves the number of bytes queued and not yet sent.
+ */
+uint32_t SimSink_GetQueued(void);
+
+/**
+ * @brief Sets the value a channel's samples are expected to have, checked as they are received.
+ */
+void SimSink_Expect(uint8_t channel, int32_t value, int32_t tolerance);
+
+/**
+ * @brief Clears what was seen of every channel.
+ */
+void SimSink_ResetChannels(void);
+
+/**
+ * @brief Retrieves what was seen of a channel since the channels were last reset.
+ */
+const SimSink_Channel_t* SimSink_GetChannel(uint8_t channel);
+
+/**
+ * @brief Retrieves the number of writes refused because the send buffer was full.
+ */
+uint32_t SimSink_GetRefusedCount(void);
+
+/**
+ * @brief Retrieves the number of bytes the receiver could not decode.
+ */
+uint64_t SimSink_GetDiscardedBytes(void);
+
+/**
+ * @brief Retrieves the number of errors the firmware reported, through its error messages and its log.
+ */
+uint32_t SimStubs_GetErrorCount(void);
+
+/**
+ * @brief Retrieves whether the firmware reported its sampling complete since the last call, 1 if it did.
+ */
+uint8_t SimStubs_TakeSamplingCompleted(void);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_SIM_H_ */
@@ -0,0 +1,26 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Config.h
+ * @brief Host forward of the configuration header, for building firmware modules on a host.
+ *
+ * The firmware includes the configuration header as Tekdaqc_Config.h, which the board's build finds as
+ * Tekdaqc_config.h on a file system ignoring case. Host file systems usually do not, so this forwards to it. It is
+ * never part of the firmware.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+#include "Tekdaqc_config.h"
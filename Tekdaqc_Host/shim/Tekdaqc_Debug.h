@@ -0,0 +1,31 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Debug.h
+ * @brief Host stand in for the debugging configuration, for building firmware modules on a host.
+ *
+ * Found ahead of the firmware's own Tekdaqc_Debug.h, and defines none of its switches, so the firmware modules built
+ * on a host print nothing of their own. Their debugging output is written once per state change or sample on the
+ * board, which would both bury the host's results and measure the host's console rather than the firmware. It is
+ * never part of the firmware.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_DEBUG_H
+#define TEKDAQC_DEBUG_H
+
+#endif /* TEKDAQC_DEBUG_H */
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file core_cmFunc.h
+ * @brief Host stand in for the CMSIS core register header, for building firmware modules on a host.
+ *
+ * Provides the Cortex-M4 core register intrinsics the firmware uses. On the host the simulated interrupts are only
+ * taken as the firmware touches the simulated hardware, and none of its critical sections does, so masking them has
+ * nothing to do and PRIMASK always reads as enabled. It is placed ahead of the CMSIS include directory by the host builds, see
+ * Tekdaqc_PipelineCheck.c, and is never part of the firmware.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CORE_CMFUNC_H
+#define __CORE_CMFUNC_H
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include <stdint.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Enables interrupts.
+ *
+ * @param none
+ * @retval none
+ */
+static inline void __enable_irq(void) {
+}
+
+/**
+ * Disables interrupts.
+ *
+ * @param none
+ * @retval none
+ */
+static inline void __disable_irq(void) {
+}
+
+/**
+ * Reads PRIMASK.
+ *
+ * @param none
+ * @retval uint32_t 0, interrupts are enabled.
+ */
+static inline uint32_t __get_PRIMASK(void) {
+	return 0U;
+}
+
+/**
+ * Writes PRIMASK.
+ *
+ * @param priMask uint32_t The value to write.
+ * @retval none
+ */
+static inline void __set_PRIMASK(uint32_t priMask) {
+	(void) priMask;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CORE_CMFUNC_H */
@@ -0,0 +1,168 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file core_cmInstr.h
+ * @brief Host stand in for the CMSIS core instruction header, for building firmware modules on a host.
+ *
+ * Provides the Cortex-M4 instruction intrinsics the firmware uses, written in portable C with the same results as
+ * the instructions. The device header and the rest of CMSIS are used as they are. It is placed ahead of the CMSIS
+ * include directory by the host builds, see Tekdaqc_PipelineCheck.c, and is never part of the firmware.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CORE_CMINSTR_H
+#define __CORE_CMINSTR_H
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include <stdint.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * No operation.
+ *
+ * @param none
+ * @retval none
+ */
+static inline void __NOP(void) {
+}
+
+/**
+ * Wait for interrupt. On the host the simulated interrupts are taken as the simulated time passes, which waiting here
+ * would not make, so it returns at once.
+ *
+ * @param none
+ * @retval none
+ */
+static inline void __WFI(void) {
+}
+
+/**
+ * Instruction synchronization barrier. On the host the firmware runs in a single thread, so only the compiler needs
+ * to be kept from reordering accesses across it.
+ *
+ * @param none
+ * @retval none
+ */
+static inline void __ISB(void) {
+	__asm__ volatile ("" ::: "memory");
+}
+
+/**
+ * Data synchronization barrier, see __ISB().
+ *
+ * @param none
+ * @retval none
+ */
+static inline void __DSB(void) {
+	__asm__ volatile ("" ::: "memory");
+}
+
+/**
+ * Data memory barrier, see __ISB().
+ *
+ * @param none
+ * @retval none
+ */
+static inline void __DMB(void) {
+	__asm__ volatile ("" ::: "memory");
+}
+
+/**
+ * Reverses the bit order of a word, as the RBIT instruction.
+ *
+ * @param value uint32_t The word to reverse.
+ * @retval uint32_t The reversed word.
+ */
+static inline uint32_t __RBIT(uint32_t value) {
+	uint32_t result = 0U;
+	for (uint_fast8_t i = 0U; i < 32U; ++i) {
+		result = (result << 1U) | ((value >> i) & 1U);
+	}
+	return result;
+}
+
+/**
+ * Counts the leading zero bits of a word, as the CLZ instruction, which gives 32 for zero.
+ *
+ * @param value uint32_t The word to count in.
+ * @retval uint8_t The number of leading zero bits.
+ */
+static inline uint8_t __CLZ(uint32_t value) {
+	return (value == 0U) ? 32U : (uint8_t) __builtin_clz(value);
+}
+
+/**
+ * Saturates a signed value to a bit width, as the SSAT instruction.
+ *
+ * @param value int32_t The value to saturate.
+ * @param bits uint32_t The width to saturate to, between 1 and 32.
+ * @retval int32_t The saturated value.
+ */
+static inline int32_t __SSAT(int32_t value, uint32_t bits) {
+	const int64_t max = ((int64_t) 1 << (bits - 1U)) - 1;
+	const int64_t min = -((int64_t) 1 << (bits - 1U));
+	return (int32_t) ((value > max) ? max : ((value < min) ? min : value));
+}
+
+/**
+ * Exclusive load of a word, as the LDREX instruction. On the host nothing else can store to the word before the
+ * matching __STREXW(), so it is a plain load.
+ *
+ * @param addr volatile uint32_t* The word to load.
+ * @retval uint32_t The loaded word.
+ */
+static inline uint32_t __LDREXW(volatile uint32_t* addr) {
+	return *addr;
+}
+
+/**
+ * Exclusive store of a word, as the STREX instruction, which always succeeds on the host, see __LDREXW().
+ *
+ * @param value uint32_t The word to store.
+ * @param addr volatile uint32_t* Where to store it.
+ * @retval uint32_t 0, the store succeeded.
+ */
+static inline uint32_t __STREXW(uint32_t value, volatile uint32_t* addr) {
+	*addr = value;
+	return 0U;
+}
+
+/**
+ * Clears the exclusive monitor, as the CLREX instruction, which has nothing to do on the host.
+ *
+ * @param none
+ * @retval none
+ */
+static inline void __CLREX(void) {
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CORE_CMINSTR_H */
@@ -0,0 +1,515 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_AcquisitionSim.c
+ * @brief Runs the acquisition firmware on a simulated board on a host, and checks the samples it sends.
+ *
+ * Builds the firmware's own ADC state machine, analog inputs and ADS1256 driver against a simulated board: the
+ * ADS1256 behind its SPI bus and DRDY line (Tekdaqc_SimADS1256.c), the external multiplexer, the timers and the
+ * interrupt controller (Tekdaqc_SimBoard.c) and the TCP connection of the data stream (Tekdaqc_SimSink.c). The
+ * simulated time only passes as the hardware is used and between the passes of the program loop here, so a run is
+ * repeatable and runs as fast as the host allows. The samples are decoded by the reference receiver on the other end
+ * of the connection and checked for their count, value, routing and timing:
+ *
+ *   - the board coming up, calibrating and reading its temperature;
+ *   - a single channel read at 1000 SPS and at 30000 SPS in continuous read mode;
+ *   - a scan of external, internal and differential inputs, with each conversion taken after its input settled;
+ *   - a connection too slow for the stream, on which every conversion is sent or counted as dropped.
+ *
+ * The host's time per sample of the 30000 SPS stream is also reported. It is the host's, not the board's, but shows
+ * a change making the acquisition path faster or slower. The firmware's own code takes no simulated time between its
+ * accesses to the hardware, so the timing checked is that of the hardware, and the board's CPU load is not measured
+ * here; a BENCHMARK_SUITE build and the PROFILE command measure it on the board.
+ *
+ * This is host code, built with the host's C99 compiler on any POSIX system which lets it map the peripheral
+ * addresses. The sink and the receiver are built without the firmware's headers, and the shim directory stands in for
+ * the device's core headers and must come first for the rest:
+ *
+ *   cc -std=c99 -O2 -D_POSIX_C_SOURCE=200809L -ITekdaqc_Host/inc -c Tekdaqc_Host/src/Tekdaqc_SimSink.c \
+ *       Tekdaqc_Host/src/Tekdaqc_Receiver.c
+ *   cc -std=c99 -O2 -D_POSIX_C_SOURCE=200809L -DSTM32F40XX -D__FPU_PRESENT=1 -ITekdaqc_Host/shim \
+ *       -ITekdaqc_Host/inc -ITekdaqc_Firmware/inc -ITekdaqc_Libraries_Firmware/inc \
+ *       -ITekdaqc_Libraries_Firmware/Libraries/STM32F4xx_StdPeriph_Driver/inc \
+ *       -ITekdaqc_Libraries_Firmware/Libraries/CMSIS/Include \
+ *       -ITekdaqc_Libraries_Firmware/Libraries/Device/STM32F4xx/Include \
+ *       -ITekdaqc_Libraries_Firmware/lwIP/src/include -ITekdaqc_Libraries_Firmware/lwIP/src/include/ipv4 \
+ *       -ITekdaqc_Libraries_Firmware/lwIP/port/STM32F4x7 \
+ *       -ITekdaqc_Libraries_Firmware/lwIP/port/STM32F4x7/Standalone/include -o tekdaqc_acquisition_sim \
+ *       Tekdaqc_Host/src/Tekdaqc_AcquisitionSim.c Tekdaqc_Host/src/Tekdaqc_SimBoard.c \
+ *       Tekdaqc_Host/src/Tekdaqc_SimADS1256.c Tekdaqc_Host/src/Tekdaqc_SimStubs.c Tekdaqc_SimSink.o \
+ *       Tekdaqc_Receiver.o Tekdaqc_Firmware/src/ADC_StateMachine.c Tekdaqc_Firmware/src/Analog_Input.c \
+ *       Tekdaqc_Firmware/src/AnalogInput_Multiplexer.c Tekdaqc_Firmware/src/AnalogInput_Filter.c \
+ *       Tekdaqc_Firmware/src/AnalogInput_Trigger.c Tekdaqc_Firmware/src/AnalogInput_Math.c \
+ *       Tekdaqc_Firmware/src/AnalogInput_Power.c Tekdaqc_Firmware/src/AnalogInput_Thermocouple.c \
+ *       Tekdaqc_Firmware/src/AnalogInput_Mixed.c Tekdaqc_Firmware/src/AnalogInput_Spectrum.c \
+ *       Tekdaqc_Firmware/src/BoardTemperature.c Tekdaqc_Libraries_Firmware/src/ADS1256_Driver.c \
+ *       Tekdaqc_Libraries_Firmware/src/Tekdaqc_Format.c Tekdaqc_Libraries_Firmware/src/Tekdaqc_Rice.c \
+ *       Tekdaqc_Libraries_Firmware/src/Tekdaqc_StateTrace.c Tekdaqc_Libraries_Firmware/src/Tekdaqc_TimingHistogram.c \
+ *       Tekdaqc_Libraries_Firmware/src/Tekdaqc_FFT.c -lm
+ *
+ * It exits with 0 when every check passed.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Sim.h"
+#include "Tekdaqc_Config.h"
+#include "Tekdaqc_Timers.h"
+#include "ADC_StateMachine.h"
+#include "Analog_Input.h"
+#include "BoardTemperature.h"
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def CHECK
+ * @brief Counts a check, and reports it with its location if it failed.
+ */
+#define CHECK(CONDITION)	do { \
+		++checks; \
+		if (!(CONDITION)) { \
+			++failures; \
+			printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #CONDITION); \
+		} \
+	} while (0)
+
+/**
+ * @internal
+ * @def SIM_LOOP_NS
+ * @brief The simulated time each pass of the program loop takes, in nanoseconds.
+ */
+#define SIM_LOOP_NS				5000U
+
+/**
+ * @internal
+ * @def SIM_LINK_RATE
+ * @brief The rate of the simulated 100 Mbit link, in bytes per second.
+ */
+#define SIM_LINK_RATE			12500000U
+
+/**
+ * @internal
+ * @def SIM_SLOW_LINK_RATE
+ * @brief The rate of a link too slow for a 30000 SPS stream, in bytes per second.
+ */
+#define SIM_SLOW_LINK_RATE		20000U
+
+/**
+ * @internal
+ * @def SIM_TIMEOUT_NS
+ * @brief The longest simulated time a step is given to finish, in nanoseconds.
+ */
+#define SIM_TIMEOUT_NS			10000000000ULL
+
+/**
+ * @internal
+ * @def SIM_CODE_TOLERANCE
+ * @brief The largest difference from the ideal code accepted of a sample.
+ */
+#define SIM_CODE_TOLERANCE		1
+
+/* The inputs each step samples, named for the physical input numbers of Tekdaqc_BSP.h */
+#define SIM_SLOW_INPUT			((uint8_t) 0U) /**< @internal The input read at 1000 SPS. */
+#define SIM_FAST_INPUT			((uint8_t) 2U) /**< @internal The input read at 30000 SPS. */
+#define SIM_LOSSY_INPUT			((uint8_t) 3U) /**< @internal The input read over the slow link. */
+#define SIM_SCAN_COUNT			5U /**< @internal The number of inputs scanned. */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The number of checks made */
+static uint32_t checks = 0U;
+
+/* The number of checks which failed */
+static uint32_t failures = 0U;
+
+/* The inputs of a sampling request, NULL terminated as the command interpreter builds them */
+static Analog_Input_t* Inputs[NUM_ANALOG_INPUTS];
+
+/* The inputs scanned */
+static const uint8_t ScanInputs[SIM_SCAN_COUNT] = { 1U, 5U, 9U, IN_SUPPLY_5V, DIFFERENTIAL_0 };
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Hands the firmware's binary sample frames to the simulated TCP connection.
+ */
+static WriteStatus_t WriteBinary(const uint8_t* data, uint16_t length);
+
+/**
+ * @internal
+ * @brief Hands the firmware's text data to the simulated TCP connection.
+ */
+static WriteStatus_t WriteString(char* string);
+
+/**
+ * @internal
+ * @brief Runs a single pass of the program loop.
+ */
+static void Step(void);
+
+/**
+ * @internal
+ * @brief Runs the program loop until a sampling request has finished and its samples have been sent.
+ */
+static bool RunUntilSent(void);
+
+/**
+ * @internal
+ * @brief Retrieves the code an input's samples are expected to have.
+ */
+static int32_t ExpectedCode(uint8_t input);
+
+/**
+ * @internal
+ * @brief Samples a set of inputs and waits for their samples to be sent.
+ */
+static bool Sample(const uint8_t* inputs, uint8_t count, uint32_t samples);
+
+/**
+ * @internal
+ * @brief Checks the board comes up, calibrates and reads its temperature.
+ */
+static void CheckBoot(void);
+
+/**
+ * @internal
+ * @brief Checks a single channel read at 1000 SPS.
+ */
+static void CheckSlowChannel(void);
+
+/**
+ * @internal
+ * @brief Checks a single channel read at 30000 SPS, and reports the host's time per sample.
+ */
+static void CheckFastChannel(void);
+
+/**
+ * @internal
+ * @brief Checks a scan of external, internal and differential inputs.
+ */
+static void CheckScan(void);
+
+/**
+ * @internal
+ * @brief Checks a stream over a link too slow for it.
+ */
+static void CheckSlowLink(void);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * Hands the firmware's binary sample frames to the simulated TCP connection, as the data connection's writer does.
+ *
+ * @param data const uint8_t* The frame.
+ * @param length uint16_t The number of bytes.
+ * @retval WriteStatus_t WRITE_OK if the frame was queued, WRITE_BUSY if there is not currently room for it or
+ * WRITE_TOO_LARGE if there never will be.
+ */
+static WriteStatus_t WriteBinary(const uint8_t* data, uint16_t length) {
+	switch (SimSink_Write(data, length)) {
+	case SIM_SINK_ACCEPTED:
+		return WRITE_OK;
+	case SIM_SINK_FULL:
+		return WRITE_BUSY;
+	case SIM_SINK_TOO_LARGE:
+		return WRITE_TOO_LARGE;
+	default:
+		return WRITE_NOT_CONNECTED;
+	}
+}
+
+/**
+ * @internal
+ * Hands the firmware's text data to the simulated TCP connection, as the data connection's writer does.
+ *
+ * @param string char* The C-String.
+ * @retval WriteStatus_t The status of the write, as WriteBinary().
+ */
+static WriteStatus_t WriteString(char* string) {
+	return WriteBinary((const uint8_t*) string, (uint16_t) strlen(string));
+}
+
+/**
+ * @internal
+ * Runs a single pass of the program loop, as the firmware's main loop does for the acquisition, and lets the
+ * simulated time pass by SIM_LOOP_NS.
+ *
+ * @param none
+ * @retval none
+ */
+static void Step(void) {
+	Timer_ServiceDeadlines();
+	ADC_Machine_Service();
+	SimSink_Service();
+	Sim_Advance(SIM_LOOP_NS);
+}
+
+/**
+ * @internal
+ * Runs the program loop until a sampling request has finished, the state machine is idle and every sample it
+ * buffered has been sent, or SIM_TIMEOUT_NS has passed.
+ *
+ * @param none
+ * @retval bool TRUE if the request finished in time.
+ */
+static bool RunUntilSent(void) {
+	const uint64_t deadline = Sim_GetTime() + SIM_TIMEOUT_NS;
+	bool completed = false;
+	while (Sim_GetTime() < deadline) {
+		Step();
+		if (SimStubs_TakeSamplingCompleted() != 0U) {
+			completed = true;
+		}
+		if ((completed == true) && (ADC_Machine_GetState() == ADC_IDLE) && (ADC_Machine_GetBufferedSampleCount() == 0U)
+				&& (SimSink_GetQueued() == 0U)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @internal
+ * Retrieves the code an input's samples are expected to have, the ideal conversion of the voltages its pair of
+ * ADS1256 inputs is routed to at unity gain.
+ *
+ * @param input uint8_t The physical input number.
+ * @retval int32_t The code.
+ */
+static int32_t ExpectedCode(uint8_t input) {
+	double volts = 0.0;
+	if (input < NUM_EXT_ANALOG_INPUTS) {
+		/* Each external input is routed to AIN0, against their analog ground on AIN1 */
+		volts = (-2.0 + (0.125 * (double) input)) - SimBoard_GetAinVoltage(ADS1256_AIN1, 0U, 1U, NULL);
+	} else if (input == IN_SUPPLY_5V) {
+		volts = SimBoard_GetAinVoltage(ADS1256_AIN4, 0U, 1U, NULL) - SimBoard_GetAinVoltage(ADS1256_AIN_COM, 0U, 1U,
+		NULL);
+	} else if (input == DIFFERENTIAL_0) {
+		volts = SimBoard_GetAinVoltage(ADS1256_AIN2, 0U, 1U, NULL) - SimBoard_GetAinVoltage(ADS1256_AIN5, 0U, 1U,
+		NULL);
+	}
+	return SimADS1256_IdealCode(volts, 1U);
+}
+
+/**
+ * @internal
+ * Samples a set of inputs as the READ_ANALOG_INPUT command does and waits for their samples to be sent. What the
+ * receiver saw of the channels is cleared first, and each input's samples are expected to have its ideal code.
+ *
+ * @param inputs const uint8_t* The physical input numbers.
+ * @param count uint8_t The number of inputs.
+ * @param samples uint32_t The number of samples, or scans of more than one input.
+ * @retval bool TRUE if the request finished in time.
+ */
+static bool Sample(const uint8_t* inputs, uint8_t count, uint32_t samples) {
+	memset(Inputs, 0, sizeof(Inputs));
+	for (uint_fast8_t i = 0U; i < count; ++i) {
+		Inputs[i] = GetAnalogInputByNumber(inputs[i]);
+		SimSink_Expect(inputs[i], ExpectedCode(inputs[i]), SIM_CODE_TOLERANCE);
+	}
+	SimSink_ResetChannels();
+	ADC_Machine_Input_Sample(Inputs, samples, (count == 1U) ? true : false);
+	return RunUntilSent();
+}
+
+/**
+ * @internal
+ * Checks the board comes up from reset to idle, with its ADS1256 calibrated and its temperature read from the cold
+ * junction sensor, 25 Deg C on the simulated board.
+ *
+ * @param none
+ * @retval none
+ */
+static void CheckBoot(void) {
+	const uint64_t deadline = Sim_GetTime() + SIM_TIMEOUT_NS;
+	while ((ADC_Machine_GetState() != ADC_IDLE) && (Sim_GetTime() < deadline)) {
+		Step();
+	}
+	CHECK(ADC_Machine_GetState() == ADC_IDLE);
+
+	/* The first pass of the idle state reads the cold junction */
+	for (uint_fast16_t i = 0U; i < 1000U; ++i) {
+		Step();
+	}
+	const float temperature = getBoardTemperature();
+	CHECK((temperature > 24.5f) && (temperature < 25.5f));
+}
+
+/**
+ * @internal
+ * Checks a single channel read at 1000 SPS: every sample is sent with its ideal code, one conversion period apart.
+ *
+ * @param none
+ * @retval none
+ */
+static void CheckSlowChannel(void) {
+	const uint8_t input = SIM_SLOW_INPUT;
+	CHECK(ConfigureAnalogInput(input, ADS1256_BUFFER_DISABLED, ADS1256_SPS_1000, ADS1256_PGAx1, "SLOW", 0U, 0U)
+			== ERR_FUNCTION_OK);
+	CHECK(Sample(&input, 1U, 500U) == true);
+
+	const SimSink_Channel_t* channel = SimSink_GetChannel(input);
+	CHECK(channel->samples == 500U);
+	CHECK(channel->lost == 0U);
+	CHECK(channel->errors == 0U);
+	CHECK(channel->disordered == 0U);
+	CHECK((channel->minInterval >= 999U) && (channel->maxInterval <= 1001U));
+}
+
+/**
+ * @internal
+ * Checks a single channel read at 30000 SPS, in continuous read mode: every sample is sent with its ideal code, one
+ * conversion period apart, and no conversion is missed. The host's time per sample is reported.
+ *
+ * @param none
+ * @retval none
+ */
+static void CheckFastChannel(void) {
+	const uint8_t input = SIM_FAST_INPUT;
+	const uint32_t samples = 30000U;
+	CHECK(ConfigureAnalogInput(input, ADS1256_BUFFER_DISABLED, ADS1256_SPS_30000, ADS1256_PGAx1, "FAST", 0U, 0U)
+			== ERR_FUNCTION_OK);
+	SimADS1256_Counters_t before;
+	SimADS1256_GetCounters(&before);
+	struct timespec start;
+	struct timespec end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	CHECK(Sample(&input, 1U, samples) == true);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	SimADS1256_Counters_t after;
+	SimADS1256_GetCounters(&after);
+
+	const SimSink_Channel_t* channel = SimSink_GetChannel(input);
+	CHECK(channel->samples == samples);
+	CHECK(channel->lost == 0U);
+	CHECK(channel->errors == 0U);
+	CHECK(channel->disordered == 0U);
+	CHECK((channel->minInterval >= 33U) && (channel->maxInterval <= 34U));
+	CHECK(after.missed == before.missed);
+
+	const double elapsed = ((double) (end.tv_sec - start.tv_sec) * 1e9) + (double) (end.tv_nsec - start.tv_nsec);
+	printf("30000 SPS stream: %.0f host ns per sample, %" PRIu64 " us from conversion to receiver at most\n",
+			elapsed / (double) samples, channel->maxLatency);
+}
+
+/**
+ * @internal
+ * Checks a scan of external, internal and differential inputs at 7500 SPS: each input's samples have its own ideal
+ * code, so each was routed to the ADS1256 as it should be, and no conversion was read out while its input was
+ * still switching.
+ *
+ * @param none
+ * @retval none
+ */
+static void CheckScan(void) {
+	const uint32_t scans = 200U;
+	for (uint_fast8_t i = 0U; i < SIM_SCAN_COUNT; ++i) {
+		CHECK(ConfigureAnalogInput(ScanInputs[i], ADS1256_BUFFER_DISABLED, ADS1256_SPS_7500, ADS1256_PGAx1, "SCAN", 0U,
+				0U) == ERR_FUNCTION_OK);
+	}
+	SimADS1256_Counters_t before;
+	SimADS1256_GetCounters(&before);
+	CHECK(Sample(ScanInputs, SIM_SCAN_COUNT, scans) == true);
+	SimADS1256_Counters_t after;
+	SimADS1256_GetCounters(&after);
+
+	for (uint_fast8_t i = 0U; i < SIM_SCAN_COUNT; ++i) {
+		const SimSink_Channel_t* channel = SimSink_GetChannel(ScanInputs[i]);
+		CHECK(channel->samples == scans);
+		CHECK(channel->lost == 0U);
+		CHECK(channel->errors == 0U);
+		CHECK(channel->disordered == 0U);
+	}
+	CHECK(after.unsettled == before.unsettled);
+}
+
+/**
+ * @internal
+ * Checks a 30000 SPS stream over a link too slow for it: the buffers fill, and every conversion taken is either
+ * received or counted as dropped by the board, never lost without a trace. The receiver sees the drops through the
+ * gaps in the sequence numbers, so only those before the last sample it received; the board's status message reports
+ * the rest.
+ *
+ * @param none
+ * @retval none
+ */
+static void CheckSlowLink(void) {
+	const uint8_t input = SIM_LOSSY_INPUT;
+	const uint32_t samples = 30000U;
+	CHECK(ConfigureAnalogInput(input, ADS1256_BUFFER_DISABLED, ADS1256_SPS_30000, ADS1256_PGAx1, "LOSSY", 0U, 0U)
+			== ERR_FUNCTION_OK);
+	SimSink_Init(TCP_SND_BUF, SIM_SLOW_LINK_RATE);
+	CHECK(Sample(&input, 1U, samples) == true);
+
+	const SimSink_Channel_t* channel = SimSink_GetChannel(input);
+	CHECK(channel->lost > 0U);
+	CHECK((channel->samples + ADC_Machine_GetOverrunCount()) == samples);
+	CHECK(channel->lost <= ADC_Machine_GetOverrunCount());
+	CHECK(channel->errors == 0U);
+	CHECK(channel->disordered == 0U);
+	CHECK(SimSink_GetRefusedCount() > 0U);
+	SimSink_Init(TCP_SND_BUF, SIM_LINK_RATE);
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Brings up the simulated board and the firmware's acquisition as the firmware's main() does, runs each of the
+ * checks and reports the results.
+ *
+ * @param none
+ * @retval int 0 if every check passed, 1 otherwise.
+ */
+int main(void) {
+	SimBoard_Init();
+	SimSink_Init(TCP_SND_BUF, SIM_LINK_RATE);
+	ADC_Machine_Create();
+	ADC_Machine_Init();
+	AnalogInputsInit();
+	SetAnalogInputWriteFunction(&WriteString);
+	SetAnalogInputBinaryWriteFunction(&WriteBinary);
+
+	CheckBoot();
+	CheckSlowChannel();
+	CheckFastChannel();
+	CheckScan();
+	CheckSlowLink();
+	CHECK(SimStubs_GetErrorCount() == 0U);
+	CHECK(SimSink_GetDiscardedBytes() == 0U);
+	printf("%" PRIu32 " of %" PRIu32 " checks passed\n", checks - failures, checks);
+
+	return (failures == 0U) ? 0 : 1;
+}
@@ -0,0 +1,807 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_PipelineCheck.c
+ * @brief Checks the hardware free modules of the sampling pipeline on a host, and measures their cost per sample.
+ *
+ * Builds the firmware's own sources for the parts of the sampling pipeline which do not touch the hardware and
+ * checks their results against straightforward references, so a change to them can be caught in seconds on a PC
+ * rather than on a board:
+ *
+ *   - the ring buffer indexing of the sample buffers, including its free running counts wrapping;
+ *   - the decimating analog filters, their DC gain, output rate, rounding, settling and saturation;
+ *   - the calibration table's temperature interpolation;
+ *   - the Rice coder of the packed records, round tripped through a decoder;
+ *   - the integer formatting of the text data streams, against the C library's.
+ *
+ * With -b the cost of each, per sample or per call, is also measured on the host. The figures are the host's, not
+ * the board's, but show a change making a path faster or slower. The acquisition state machine, the ADS1256 driver
+ * and the analog inputs are run against a simulated board by Tekdaqc_AcquisitionSim.c; the network stack is not
+ * built on a host, and a BENCHMARK_SUITE build and the PROFILE command measure the board's own costs.
+ *
+ * This is host code, built with the host's C99 compiler on any POSIX system. The shim directory stands in for the
+ * device's core headers and must come first:
+ *
+ *   cc -std=c99 -O2 -D_POSIX_C_SOURCE=200809L -DSTM32F40XX -D__FPU_PRESENT=1 -ITekdaqc_Host/shim \
+ *       -ITekdaqc_Libraries_Firmware/inc -ITekdaqc_Firmware/inc \
+ *       -ITekdaqc_Libraries_Firmware/Libraries/CMSIS/Include \
+ *       -ITekdaqc_Libraries_Firmware/Libraries/Device/STM32F4xx/Include -o tekdaqc_pipeline_check \
+ *       Tekdaqc_Host/src/Tekdaqc_PipelineCheck.c Tekdaqc_Firmware/src/AnalogInput_Filter.c \
+ *       Tekdaqc_Libraries_Firmware/src/Tekdaqc_Rice.c Tekdaqc_Libraries_Firmware/src/Tekdaqc_Format.c -lm
+ *
+ * It exits with 0 when every check passed.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_RingBuffer.h"
+#include "Tekdaqc_CalibrationInterpolation.h"
+#include "Tekdaqc_Rice.h"
+#include "Tekdaqc_Format.h"
+#include "AnalogInput_Filter.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def CHECK
+ * @brief Counts and reports a failed check, with the line it is on.
+ */
+#define CHECK(CONDITION)	do { \
+		++checks; \
+		if (!(CONDITION)) { \
+			++failures; \
+			printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #CONDITION); \
+		} \
+	} while (0)
+
+/**
+ * @internal
+ * @def RING_CAPACITY
+ * @brief The capacity of the rings checked, small so they fill and wrap quickly.
+ */
+#define RING_CAPACITY			8U
+
+/**
+ * @internal
+ * @def RICE_CHECK_VALUES
+ * @brief The number of values round tripped through the Rice coder for each parameter.
+ */
+#define RICE_CHECK_VALUES		4096U
+
+/**
+ * @internal
+ * @def RICE_BUFFER_SIZE
+ * @brief The size of the buffer the Rice coded values are written to, enough for every value escaped.
+ */
+#define RICE_BUFFER_SIZE		((RICE_CHECK_VALUES * (RICE_ESCAPE + 32U)) / 8U)
+
+/**
+ * @internal
+ * @def RICE_VALUE_WIDTH
+ * @brief The width of an escaped value, as that of a packed record's value change.
+ */
+#define RICE_VALUE_WIDTH		25U
+
+/**
+ * @internal
+ * @def FORMAT_CHECK_VALUES
+ * @brief The number of random values formatted by each formatting check.
+ */
+#define FORMAT_CHECK_VALUES		100000U
+
+/**
+ * @internal
+ * @def ADC_MAX
+ * @brief The largest reading of the ADS1256.
+ */
+#define ADC_MAX					((int32_t) 0x7FFFFF)
+
+/**
+ * @internal
+ * @def ADC_MIN
+ * @brief The smallest reading of the ADS1256.
+ */
+#define ADC_MIN					((int32_t) -0x800000)
+
+/**
+ * @internal
+ * @def BENCHMARK_SAMPLES
+ * @brief The number of samples or calls each cost is measured over.
+ */
+#define BENCHMARK_SAMPLES		4000000U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Data structure for reading a bit stream packed least significant bit first, as the host receiver does.
+ */
+typedef struct {
+	const uint8_t* data; /**< The bytes of the stream. */
+	uint32_t size; /**< The number of bytes in the stream. */
+	uint32_t position; /**< The index of the next bit to read. */
+} BitReader_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The number of checks made */
+static uint32_t checks = 0U;
+
+/* The number of checks which failed */
+static uint32_t failures = 0U;
+
+/* The state of the pseudo random sequence, fixed so every run checks the same values */
+static uint32_t randomState = 0x2545F491U;
+
+/* The buffer the Rice coded values are written to */
+static uint8_t riceBuffer[RICE_BUFFER_SIZE];
+
+/* Keeps the benchmarked results alive so the compiler cannot discard the work */
+static volatile uint64_t benchmarkSink = 0U;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Retrieves the next number of a pseudo random sequence.
+ */
+static uint32_t NextRandom(void);
+
+/**
+ * @internal
+ * @brief Retrieves a pseudo random ADC reading near a level.
+ */
+static int32_t NoisyReading(int32_t level, uint32_t noise);
+
+/**
+ * @internal
+ * @brief Reads a number of bits from a bit stream.
+ */
+static uint32_t ReadBits(BitReader_t* reader, uint8_t count);
+
+/**
+ * @internal
+ * @brief Reads a Rice coded number from a bit stream.
+ */
+static uint32_t ReadRice(BitReader_t* reader, uint8_t k, uint8_t width);
+
+/**
+ * @internal
+ * @brief Retrieves the host's monotonic time in nanoseconds.
+ */
+static uint64_t GetNanoseconds(void);
+
+/**
+ * @internal
+ * @brief Checks the ring buffer indexing.
+ */
+static void CheckRingBuffer(void);
+
+/**
+ * @internal
+ * @brief Checks the decimating analog filters.
+ */
+static void CheckFilters(void);
+
+/**
+ * @internal
+ * @brief Checks the calibration table's temperature interpolation.
+ */
+static void CheckCalibrationInterpolation(void);
+
+/**
+ * @internal
+ * @brief Checks the Rice coder.
+ */
+static void CheckRice(void);
+
+/**
+ * @internal
+ * @brief Checks the integer formatting.
+ */
+static void CheckFormat(void);
+
+/**
+ * @internal
+ * @brief Measures the cost of filtering a sample with a filter.
+ */
+static void BenchmarkFilter(AnalogFilterType_t type, uint16_t decimation);
+
+/**
+ * @internal
+ * @brief Measures the cost of each pipeline module.
+ */
+static void Benchmark(void);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * Retrieves the next number of a 32 bit xorshift sequence.
+ *
+ * @param none
+ * @retval uint32_t The number.
+ */
+static uint32_t NextRandom(void) {
+	randomState ^= randomState << 13U;
+	randomState ^= randomState >> 17U;
+	randomState ^= randomState << 5U;
+	return randomState;
+}
+
+/**
+ * @internal
+ * Retrieves a pseudo random ADC reading within a range of a level, clamped to the range of the ADC.
+ *
+ * @param level int32_t The level the reading is near.
+ * @param noise uint32_t The most the reading may differ from the level.
+ * @retval int32_t The reading.
+ */
+static int32_t NoisyReading(int32_t level, uint32_t noise) {
+	const int64_t reading = (int64_t) level + (int64_t) (NextRandom() % ((2U * noise) + 1U)) - (int64_t) noise;
+	return (int32_t) ((reading > ADC_MAX) ? ADC_MAX : ((reading < ADC_MIN) ? ADC_MIN : reading));
+}
+
+/**
+ * @internal
+ * Reads a number of bits from a bit stream packed least significant bit first. Bits past its end read as zero.
+ *
+ * @param reader BitReader_t* The stream to read from.
+ * @param count uint8_t The number of bits to read, at most 32.
+ * @retval uint32_t The bits read.
+ */
+static uint32_t ReadBits(BitReader_t* reader, uint8_t count) {
+	uint32_t value = 0U;
+	for (uint_fast8_t i = 0U; i < count; ++i) {
+		const uint32_t byte = reader->position >> 3U;
+		if ((byte < reader->size) && (((reader->data[byte] >> (reader->position & 7U)) & 1U) != 0U)) {
+			value |= (1UL << i);
+		}
+		++(reader->position);
+	}
+	return value;
+}
+
+/**
+ * @internal
+ * Reads a Rice coded number from a bit stream, as written by Rice_WriteCode().
+ *
+ * @param reader BitReader_t* The stream to read from.
+ * @param k uint8_t The Rice parameter.
+ * @param width uint8_t The width of the number when escaped.
+ * @retval uint32_t The number.
+ */
+static uint32_t ReadRice(BitReader_t* reader, uint8_t k, uint8_t width) {
+	uint32_t quotient = 0U;
+	while ((quotient < RICE_ESCAPE) && (ReadBits(reader, 1U) == 1U)) {
+		++quotient;
+	}
+	if (quotient == RICE_ESCAPE) {
+		return ReadBits(reader, width);
+	}
+	return (quotient << k) | ReadBits(reader, k);
+}
+
+/**
+ * @internal
+ * Retrieves the host's monotonic time in nanoseconds.
+ *
+ * @param none
+ * @retval uint64_t The time.
+ */
+static uint64_t GetNanoseconds(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64_t) now.tv_sec * 1000000000U) + (uint64_t) now.tv_nsec;
+}
+
+/**
+ * @internal
+ * Checks the ring buffer indexing: that a ring holds exactly its capacity, refuses and counts elements beyond it,
+ * hands elements back in order, and keeps working when its free running counts wrap.
+ *
+ * @param none
+ * @retval none
+ */
+static void CheckRingBuffer(void) {
+	RingBuffer_t ring;
+	uint32_t storage[RING_CAPACITY];
+	uint32_t index = 0U;
+
+	CHECK(IS_RING_BUFFER_CAPACITY(RING_CAPACITY));
+	CHECK(!IS_RING_BUFFER_CAPACITY(0U));
+	CHECK(!IS_RING_BUFFER_CAPACITY(12U));
+
+	/* Fills to its capacity and no further */
+	RingBuffer_Init(&ring, RING_CAPACITY);
+	CHECK(RingBuffer_IsEmpty(&ring));
+	for (uint32_t i = 0U; i < RING_CAPACITY; ++i) {
+		CHECK(RingBuffer_BeginWrite(&ring, &index));
+		storage[index] = i;
+		RingBuffer_EndWrite(&ring);
+	}
+	CHECK(RingBuffer_Count(&ring) == RING_CAPACITY);
+	CHECK(!RingBuffer_BeginWrite(&ring, &index));
+	CHECK(!RingBuffer_BeginWrite(&ring, &index));
+	CHECK(RingBuffer_GetOverflowCount(&ring) == 2U);
+
+	/* Hands the elements back oldest first */
+	for (uint32_t i = 0U; i < RING_CAPACITY; ++i) {
+		CHECK(storage[RingBuffer_PeekIndex(&ring, i)] == i);
+	}
+	RingBuffer_Release(&ring, 3U);
+	CHECK(RingBuffer_Count(&ring) == (RING_CAPACITY - 3U));
+	CHECK(storage[RingBuffer_PeekIndex(&ring, 0U)] == 3U);
+
+	/* Reserving refuses an element unless the whole group fits */
+	CHECK(RingBuffer_BeginWriteReserve(&ring, &index, 3U));
+	CHECK(!RingBuffer_BeginWriteReserve(&ring, &index, 4U));
+	CHECK(RingBuffer_GetOverflowCount(&ring) == 3U);
+
+	/* Keeps its order across the counts wrapping past the top of their range */
+	RingBuffer_Init(&ring, RING_CAPACITY);
+	ring.head = UINT32_MAX - 2U;
+	ring.tail = UINT32_MAX - 2U;
+	uint32_t written = 0U;
+	uint32_t read = 0U;
+	for (uint32_t round = 0U; round < 100U; ++round) {
+		const uint32_t writes = NextRandom() % (RING_CAPACITY + 2U);
+		for (uint32_t i = 0U; i < writes; ++i) {
+			if (RingBuffer_BeginWrite(&ring, &index) == true) {
+				storage[index] = written++;
+				RingBuffer_EndWrite(&ring);
+			}
+		}
+		CHECK(RingBuffer_Count(&ring) <= RING_CAPACITY);
+		const uint32_t reads = (RingBuffer_Count(&ring) > 0U) ? (NextRandom() % (RingBuffer_Count(&ring) + 1U)) : 0U;
+		for (uint32_t i = 0U; i < reads; ++i) {
+			CHECK(storage[RingBuffer_PeekIndex(&ring, i)] == (read + i));
+		}
+		RingBuffer_Release(&ring, reads);
+		read += reads;
+	}
+	CHECK(RingBuffer_Count(&ring) == (written - read));
+	CHECK(ring.head < (UINT32_MAX - 2U));
+}
+
+/**
+ * @internal
+ * Checks the decimating analog filters: that invalid configurations are refused, each type passes DC unchanged at
+ * its decimated rate once settled, the average rounds halves away from zero and outputs saturate to the ADC's range.
+ *
+ * @param none
+ * @retval none
+ */
+static void CheckFilters(void) {
+	static const uint16_t decimations[] = { 1U, 2U, 5U, 8U, 64U, 1000U, ANALOG_FILTER_MAX_DECIMATION };
+	static const int32_t levels[] = { 0, 1, -1, 123456, -654321, ADC_MAX, ADC_MIN };
+	AnalogFilter_t filter;
+	int32_t value = 0;
+
+	/* Refuses what cannot be configured, leaving the filter as it was */
+	AnalogFilter_Init(&filter);
+	CHECK(!AnalogFilter_Configure(&filter, ANALOG_FILTER_AVERAGE, 0U));
+	CHECK(!AnalogFilter_Configure(&filter, ANALOG_FILTER_CIC, ANALOG_FILTER_MAX_DECIMATION + 1U));
+	CHECK(!AnalogFilter_Configure(&filter, ANALOG_FILTER_FIR, ANALOG_FILTER_FIR_MAX_DECIMATION + 1U));
+	CHECK(!AnalogFilter_Configure(&filter, NUM_ANALOG_FILTER_TYPES, 1U));
+	CHECK(filter.type == ANALOG_FILTER_NONE);
+
+	/* Passes samples through unchanged without a filter */
+	CHECK(AnalogFilter_Configure(&filter, ANALOG_FILTER_NONE, 16U));
+	CHECK(filter.decimation == 1U);
+	for (uint_fast8_t i = 0U; i < 100U; ++i) {
+		const int32_t sample = NoisyReading(0, (uint32_t) ADC_MAX);
+		value = sample;
+		CHECK(AnalogFilter_Process(&filter, &value) && (value == sample));
+	}
+
+	/* Each type passes DC unchanged, at one output per decimation samples once settled */
+	for (AnalogFilterType_t type = ANALOG_FILTER_AVERAGE; type < NUM_ANALOG_FILTER_TYPES; ++type) {
+		for (uint_fast8_t d = 0U; d < (sizeof(decimations) / sizeof(decimations[0])); ++d) {
+			const uint16_t decimation = decimations[d];
+			if ((type == ANALOG_FILTER_FIR) && (decimation > ANALOG_FILTER_FIR_MAX_DECIMATION)) {
+				continue;
+			}
+			for (uint_fast8_t l = 0U; l < (sizeof(levels) / sizeof(levels[0])); ++l) {
+				CHECK(AnalogFilter_Configure(&filter, type, decimation));
+				const uint32_t settling = (type == ANALOG_FILTER_CIC) ? ANALOG_FILTER_CIC_ORDER : 0U;
+				const uint32_t inputs = (settling + 4U) * decimation;
+				uint32_t outputs = 0U;
+				uint32_t wrong = 0U;
+				uint32_t misplaced = 0U;
+				for (uint32_t i = 1U; i <= inputs; ++i) {
+					value = levels[l];
+					if (AnalogFilter_Process(&filter, &value) == true) {
+						++outputs;
+						wrong += (value != levels[l]) ? 1U : 0U;
+						misplaced += ((i % decimation) != 0U) ? 1U : 0U;
+					}
+				}
+				CHECK(outputs == 4U);
+				CHECK(wrong == 0U);
+				CHECK(misplaced == 0U);
+			}
+		}
+	}
+
+	/* The average rounds halves away from zero */
+	CHECK(AnalogFilter_Configure(&filter, ANALOG_FILTER_AVERAGE, 2U));
+	value = 1;
+	CHECK(!AnalogFilter_Process(&filter, &value));
+	value = 2;
+	CHECK(AnalogFilter_Process(&filter, &value) && (value == 2));
+	value = -1;
+	CHECK(!AnalogFilter_Process(&filter, &value));
+	value = -2;
+	CHECK(AnalogFilter_Process(&filter, &value) && (value == -2));
+
+	/* The average of noise matches the exact average of its block */
+	CHECK(AnalogFilter_Configure(&filter, ANALOG_FILTER_AVERAGE, 100U));
+	for (uint_fast8_t block = 0U; block < 20U; ++block) {
+		int64_t sum = 0;
+		bool produced = false;
+		for (uint_fast8_t i = 0U; i < 100U; ++i) {
+			value = NoisyReading(0x1000 * (int32_t) block, 50000U);
+			sum += value;
+			produced = AnalogFilter_Process(&filter, &value);
+		}
+		const int64_t expected = (sum >= 0) ? ((sum + 50) / 100) : ((sum - 50) / 100);
+		CHECK(produced && (value == (int32_t) expected));
+	}
+
+	/* The CIC's output tracks its input's mean, within the noise of a block */
+	CHECK(AnalogFilter_Configure(&filter, ANALOG_FILTER_CIC, 32U));
+	uint32_t far = 0U;
+	for (uint32_t i = 0U; i < (32U * 40U); ++i) {
+		value = NoisyReading(-300000, 1000U);
+		if ((AnalogFilter_Process(&filter, &value) == true) && ((value < -301000) || (value > -299000))) {
+			++far;
+		}
+	}
+	CHECK(far == 0U);
+
+	/* A step overshooting through the FIR's ringing is held to the ADC's range */
+	CHECK(AnalogFilter_Configure(&filter, ANALOG_FILTER_FIR, 2U));
+	uint32_t outside = 0U;
+	for (uint32_t i = 0U; i < (4U * ANALOG_FILTER_FIR_TAPS); ++i) {
+		value = ((i / ANALOG_FILTER_FIR_TAPS) % 2U == 0U) ? ADC_MIN : ADC_MAX;
+		if ((AnalogFilter_Process(&filter, &value) == true) && ((value > ADC_MAX) || (value < ADC_MIN))) {
+			++outside;
+		}
+	}
+	CHECK(outside == 0U);
+
+	/* Resetting starts the next block afresh */
+	CHECK(AnalogFilter_Configure(&filter, ANALOG_FILTER_AVERAGE, 4U));
+	value = 1000;
+	CHECK(!AnalogFilter_Process(&filter, &value));
+	AnalogFilter_Reset(&filter);
+	for (uint_fast8_t i = 0U; i < 4U; ++i) {
+		value = 8;
+		AnalogFilter_Process(&filter, &value);
+	}
+	CHECK(value == 8);
+
+	/* The names round trip */
+	for (AnalogFilterType_t type = ANALOG_FILTER_NONE; type < NUM_ANALOG_FILTER_TYPES; ++type) {
+		CHECK(AnalogFilter_StringToType(AnalogFilter_StringFromType(type)) == type);
+	}
+	CHECK(AnalogFilter_StringToType("MEDIAN") == NUM_ANALOG_FILTER_TYPES);
+}
+
+/**
+ * @internal
+ * Checks the calibration table's temperature interpolation: conversion to fixed point, locating a temperature
+ * between the data points with temperatures beyond the table clamped to its ends, and interpolating rising and
+ * falling values with rounding to the nearest.
+ *
+ * @param none
+ * @retval none
+ */
+static void CheckCalibrationInterpolation(void) {
+	const uint32_t one = 1UL << CAL_FACTOR_FRACTION_BITS;
+	const int32_t low = Calibration_TemperatureToFixed(0.0f);
+	const int32_t step = Calibration_TemperatureToFixed(5.0f);
+	const uint32_t count = 11U; /* 0 to 50 Deg C */
+	uint32_t factor = 0U;
+
+	CHECK(Calibration_TemperatureToFixed(1.0f) == (1 << CAL_TEMP_FRACTION_BITS));
+	CHECK(Calibration_TemperatureToFixed(-1.0f) == -(1 << CAL_TEMP_FRACTION_BITS));
+	CHECK(Calibration_TemperatureToFixed(0.5f / (float) (1U << CAL_TEMP_FRACTION_BITS)) == 1);
+	CHECK(Calibration_TemperatureToFixed(-0.5f / (float) (1U << CAL_TEMP_FRACTION_BITS)) == -1);
+
+	/* Data points are found with no fraction, temperatures between them with their position in the step */
+	CHECK((Calibration_LocateTemperature(low, low, step, count, &factor) == 0U) && (factor == 0U));
+	CHECK((Calibration_LocateTemperature(Calibration_TemperatureToFixed(10.0f), low, step, count, &factor) == 2U)
+			&& (factor == 0U));
+	CHECK((Calibration_LocateTemperature(Calibration_TemperatureToFixed(12.5f), low, step, count, &factor) == 2U)
+			&& (factor == (one / 2U)));
+	CHECK((Calibration_LocateTemperature(Calibration_TemperatureToFixed(23.75f), low, step, count, &factor) == 4U)
+			&& (factor == ((3U * one) / 4U)));
+
+	/* The last data point is the high end of the last step, and beyond the table is clamped to its ends */
+	CHECK((Calibration_LocateTemperature(Calibration_TemperatureToFixed(50.0f), low, step, count, &factor) == 9U)
+			&& (factor == one));
+	CHECK((Calibration_LocateTemperature(Calibration_TemperatureToFixed(80.0f), low, step, count, &factor) == 9U)
+			&& (factor == one));
+	CHECK((Calibration_LocateTemperature(Calibration_TemperatureToFixed(-20.0f), low, step, count, &factor) == 0U)
+			&& (factor == 0U));
+
+	/* A table of a single point, or without a step, always uses its first point */
+	CHECK((Calibration_LocateTemperature(step, low, step, 1U, &factor) == 0U) && (factor == 0U));
+	CHECK((Calibration_LocateTemperature(step, low, 0, count, &factor) == 0U) && (factor == 0U));
+	CHECK(Calibration_LocateTemperature(step, low, step, count, NULL) == 1U);
+
+	/* Interpolation meets the data points at its ends and rounds to the nearest between them */
+	CHECK(Calibration_InterpolateValue(1000U, 2000U, 0U) == 1000U);
+	CHECK(Calibration_InterpolateValue(1000U, 2000U, one) == 2000U);
+	CHECK(Calibration_InterpolateValue(1000U, 2000U, one / 2U) == 1500U);
+	CHECK(Calibration_InterpolateValue(2000U, 1000U, one / 4U) == 1750U);
+	CHECK(Calibration_InterpolateValue(0U, 1U, one / 2U) == 1U);
+	CHECK(Calibration_InterpolateValue(1U, 0U, one / 2U) == 1U);
+	CHECK(Calibration_InterpolateValue(0U, UINT32_MAX, one) == UINT32_MAX);
+	CHECK(Calibration_InterpolateValue(UINT32_MAX, 0U, one) == 0U);
+
+	/* Against a double precision reference across the range of the values */
+	uint32_t far = 0U;
+	for (uint32_t i = 0U; i < 100000U; ++i) {
+		const uint32_t a = NextRandom();
+		const uint32_t b = NextRandom();
+		const uint32_t f = NextRandom() % (one + 1U);
+		const double exact = (double) a + (((double) b - (double) a) * (double) f / (double) one);
+		const double error = (double) Calibration_InterpolateValue(a, b, f) - exact;
+		far += ((error > 0.5) || (error < -0.5)) ? 1U : 0U;
+	}
+	CHECK(far == 0U);
+}
+
+/**
+ * @internal
+ * Checks the Rice coder: zigzag mapping, the choice of parameter, round tripping values of every size through each
+ * parameter, escapes included, and a stream which does not fit its buffer being refused.
+ *
+ * @param none
+ * @retval none
+ */
+static void CheckRice(void) {
+	static uint32_t values[RICE_CHECK_VALUES];
+	RiceWriter_t writer;
+
+	CHECK(Rice_ZigZag(0) == 0U);
+	CHECK(Rice_ZigZag(-1) == 1U);
+	CHECK(Rice_ZigZag(1) == 2U);
+	CHECK(Rice_ZigZag(-2) == 3U);
+	CHECK(Rice_ZigZag(INT32_MAX) == (UINT32_MAX - 1U));
+	CHECK(Rice_ZigZag(INT32_MIN) == UINT32_MAX);
+
+	CHECK(Rice_ChooseParameter(0U, 0U, 20U) == 0U);
+	CHECK(Rice_ChooseParameter(10U, 10U, 20U) == 0U);
+	CHECK(Rice_ChooseParameter(1024U, 1U, 20U) == 10U);
+	CHECK(Rice_ChooseParameter(1023U, 1U, 20U) == 9U);
+	CHECK(Rice_ChooseParameter(UINT32_MAX, 1U, 20U) == 20U);
+
+	for (uint8_t k = 0U; k <= 20U; ++k) {
+		/* Mostly values near the parameter's scale, some far beyond it so they escape */
+		for (uint32_t i = 0U; i < RICE_CHECK_VALUES; ++i) {
+			const uint32_t scale = ((NextRandom() % 8U) == 0U) ? 24U : (uint32_t) (k + 2U);
+			values[i] = NextRandom() & ((1UL << scale) - 1U) & ((1UL << RICE_VALUE_WIDTH) - 1U);
+		}
+		Rice_Begin(&writer, riceBuffer, (uint16_t) ((sizeof(riceBuffer) > UINT16_MAX) ? UINT16_MAX : sizeof(riceBuffer)));
+		for (uint32_t i = 0U; i < RICE_CHECK_VALUES; ++i) {
+			Rice_WriteCode(&writer, values[i], k, RICE_VALUE_WIDTH);
+		}
+		const uint16_t length = Rice_End(&writer);
+		CHECK(length > 0U);
+
+		BitReader_t reader = { riceBuffer, length, 0U };
+		uint32_t wrong = 0U;
+		for (uint32_t i = 0U; i < RICE_CHECK_VALUES; ++i) {
+			wrong += (ReadRice(&reader, k, RICE_VALUE_WIDTH) != values[i]) ? 1U : 0U;
+		}
+		CHECK(wrong == 0U);
+		CHECK(((reader.position + 7U) / 8U) == length);
+	}
+
+	/* A stream which does not fit is refused whole */
+	Rice_Begin(&writer, riceBuffer, 4U);
+	for (uint32_t i = 0U; i < 16U; ++i) {
+		Rice_WriteCode(&writer, 0xFFFFU, 2U, RICE_VALUE_WIDTH);
+	}
+	CHECK(Rice_End(&writer) == 0U);
+}
+
+/**
+ * @internal
+ * Checks the integer formatting against the C library's for the edges of each type and random values of every
+ * length.
+ *
+ * @param none
+ * @retval none
+ */
+static void CheckFormat(void) {
+	static const uint64_t edges[] = { 0U, 1U, 9U, 10U, 99U, 100U, 4294967295U, 4294967296U, 99999999U, 100000000U,
+			9999999999999999U, 10000000000000000U, UINT64_MAX };
+	char formatted[FORMAT_UINT64_MAX_LENGTH + 1U];
+	char expected[FORMAT_UINT64_MAX_LENGTH + 1U];
+	uint32_t wrong = 0U;
+
+	for (uint_fast8_t i = 0U; i < (sizeof(edges) / sizeof(edges[0])); ++i) {
+		const uint8_t length = Format_UInt64(formatted, edges[i]);
+		snprintf(expected, sizeof(expected), "%" PRIu64, edges[i]);
+		CHECK((strcmp(formatted, expected) == 0) && (length == strlen(expected)));
+	}
+	CHECK((Format_Int32(formatted, INT32_MIN) == 11U) && (strcmp(formatted, "-2147483648") == 0));
+	CHECK((Format_Int32(formatted, INT32_MAX) == 10U) && (strcmp(formatted, "2147483647") == 0));
+	CHECK((Format_UInt32(formatted, UINT32_MAX) == 10U) && (strcmp(formatted, "4294967295") == 0));
+	CHECK((Format_Int32(formatted, 0) == 1U) && (strcmp(formatted, "0") == 0));
+
+	for (uint32_t i = 0U; i < FORMAT_CHECK_VALUES; ++i) {
+		/* Shifted so every length of number is as likely */
+		const uint64_t value = (((uint64_t) NextRandom() << 32U) | NextRandom()) >> (NextRandom() % 64U);
+		const int32_t signedValue = (int32_t) NextRandom() >> (NextRandom() % 32U);
+		Format_UInt64(formatted, value);
+		snprintf(expected, sizeof(expected), "%" PRIu64, value);
+		wrong += (strcmp(formatted, expected) != 0) ? 1U : 0U;
+		Format_UInt32(formatted, (uint32_t) value);
+		snprintf(expected, sizeof(expected), "%" PRIu32, (uint32_t) value);
+		wrong += (strcmp(formatted, expected) != 0) ? 1U : 0U;
+		Format_Int32(formatted, signedValue);
+		snprintf(expected, sizeof(expected), "%" PRId32, signedValue);
+		wrong += (strcmp(formatted, expected) != 0) ? 1U : 0U;
+	}
+	CHECK(wrong == 0U);
+}
+
+/**
+ * @internal
+ * Measures the cost of filtering a sample, averaged over every input sample whether or not it produced an output.
+ *
+ * @param type AnalogFilterType_t The filter to measure.
+ * @param decimation uint16_t The decimation to measure it at.
+ * @retval none
+ */
+static void BenchmarkFilter(AnalogFilterType_t type, uint16_t decimation) {
+	static int32_t samples[1024];
+	AnalogFilter_t filter;
+	AnalogFilter_Init(&filter);
+	AnalogFilter_Configure(&filter, type, decimation);
+	for (uint32_t i = 0U; i < (sizeof(samples) / sizeof(samples[0])); ++i) {
+		samples[i] = NoisyReading(0, 100000U);
+	}
+	uint64_t sum = 0U;
+	const uint64_t start = GetNanoseconds();
+	for (uint32_t i = 0U; i < BENCHMARK_SAMPLES; ++i) {
+		int32_t value = samples[i & ((sizeof(samples) / sizeof(samples[0])) - 1U)];
+		if (AnalogFilter_Process(&filter, &value) == true) {
+			sum += (uint32_t) value;
+		}
+	}
+	const uint64_t elapsed = GetNanoseconds() - start;
+	benchmarkSink += sum;
+	printf("  filter %-7s / %-4u %8.2f ns/sample\n", AnalogFilter_StringFromType(type), decimation,
+			(double) elapsed / (double) BENCHMARK_SAMPLES);
+}
+
+/**
+ * @internal
+ * Measures the cost of each module of the pipeline on the host.
+ *
+ * @param none
+ * @retval none
+ */
+static void Benchmark(void) {
+	printf("Cost on this host:\n");
+	BenchmarkFilter(ANALOG_FILTER_NONE, 1U);
+	BenchmarkFilter(ANALOG_FILTER_AVERAGE, 16U);
+	BenchmarkFilter(ANALOG_FILTER_CIC, 64U);
+	BenchmarkFilter(ANALOG_FILTER_FIR, 4U);
+
+	/* Packing the value changes of a record's samples */
+	RiceWriter_t writer;
+	uint64_t bytes = 0U;
+	uint64_t start = GetNanoseconds();
+	for (uint32_t i = 0U; i < BENCHMARK_SAMPLES; i += 256U) {
+		Rice_Begin(&writer, riceBuffer, UINT16_MAX);
+		for (uint32_t j = 0U; j < 256U; ++j) {
+			Rice_WriteCode(&writer, Rice_ZigZag(NoisyReading(0, 400U)), 8U, RICE_VALUE_WIDTH);
+		}
+		bytes += Rice_End(&writer);
+	}
+	uint64_t elapsed = GetNanoseconds() - start;
+	benchmarkSink += bytes;
+	printf("  rice code          %8.2f ns/sample (%.2f bits/sample)\n", (double) elapsed / (double) BENCHMARK_SAMPLES,
+			(double) (bytes * 8U) / (double) BENCHMARK_SAMPLES);
+
+	/* Formatting the timestamps of the text data streams */
+	char formatted[FORMAT_UINT64_MAX_LENGTH + 1U];
+	uint64_t length = 0U;
+	start = GetNanoseconds();
+	for (uint32_t i = 0U; i < BENCHMARK_SAMPLES; ++i) {
+		length += Format_UInt64(formatted, 1400000000000000ULL + ((uint64_t) i * 33U));
+	}
+	elapsed = GetNanoseconds() - start;
+	benchmarkSink += length;
+	printf("  format uint64      %8.2f ns/call\n", (double) elapsed / (double) BENCHMARK_SAMPLES);
+
+	/* Looking up a gain calibration */
+	const int32_t low = Calibration_TemperatureToFixed(0.0f);
+	const int32_t step = Calibration_TemperatureToFixed(5.0f);
+	uint64_t sum = 0U;
+	start = GetNanoseconds();
+	for (uint32_t i = 0U; i < BENCHMARK_SAMPLES; ++i) {
+		uint32_t factor = 0U;
+		const int32_t temperature = Calibration_TemperatureToFixed(20.0f + (float) (i & 0xFFU) / 32.0f);
+		const uint32_t index = Calibration_LocateTemperature(temperature, low, step, 11U, &factor);
+		sum += Calibration_InterpolateValue(index * 1000U, (index + 1U) * 1000U, factor);
+	}
+	elapsed = GetNanoseconds() - start;
+	benchmarkSink += sum;
+	printf("  calibration lookup %8.2f ns/call\n", (double) elapsed / (double) BENCHMARK_SAMPLES);
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Runs every check, and with -b measures the cost of each module afterwards.
+ *
+ * @param argc int The number of arguments.
+ * @param argv char** The arguments.
+ * @retval int 0 if every check passed, 1 if any failed, 2 for invalid arguments.
+ */
+int main(int argc, char** argv) {
+	bool benchmark = false;
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "-b") == 0) {
+			benchmark = true;
+		} else {
+			fprintf(stderr, "Usage: %s [-b]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	CheckRingBuffer();
+	CheckFilters();
+	CheckCalibrationInterpolation();
+	CheckRice();
+	CheckFormat();
+	printf("%" PRIu32 " of %" PRIu32 " checks passed\n", checks - failures, checks);
+
+	if (benchmark == true) {
+		Benchmark();
+	}
+	return (failures == 0U) ? 0 : 1;
+}
@@ -0,0 +1,1022 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Receiver.c
+ * @brief Implements the host side reference receiver of the Tekdaqc's sample streams.
+ *
+ * The bytes of a connection are gathered until a whole unit is held, then decoded. A unit is told apart by its first
+ * byte: an analog frame starts with 0x1D and a digital frame with 0x1C, a Telnet option negotiation with IAC (0xFF),
+ * and anything else is text running up to its record separator (0x1E) or the next binary unit. Each analog frame is
+ * decoded record by record exactly as the board's BinaryChannelState_t tracks it: a sample's timestamp is its delta
+ * from the channel's previous sample, its sequence number one more than that sample's, and config and gap records
+ * reset both.
+ *
+ * A sample log marker also starts with 0x1C. Markers are only sent after a resume was requested, and then one is
+ * told from a digital frame by the byte where a frame has its first record type (0xFC to 0xFF): a marker has the
+ * third byte of its sequence number there, which only reaches those values after 16 million logged records, and any
+ * marker carrying the sequence number following the last one is taken as a marker regardless.
+ *
+ * Published datagrams are decoded in sequence order. One arriving ahead of a missing one is held, and a resend
+ * event asks the application to request the missing one from the board, which keeps its last few batches. Once
+ * RECEIVER_REORDER_COUNT datagrams are held the missing ones are given up on and counted as lost. The timestamps and
+ * sequence numbers of the samples after a lost datagram are then off by those of the samples in it, since the board
+ * believes they were delivered, until each channel's next config record.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Receiver.h"
+#include <string.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def ANALOG_FRAME_START
+ * @brief The byte which begins every binary analog frame, as ANALOG_BINARY_FRAME_START.
+ */
+#define ANALOG_FRAME_START		((uint8_t) 0x1D)
+
+/**
+ * @internal
+ * @def DIGITAL_FRAME_START
+ * @brief The byte which begins every binary digital frame and sample log marker.
+ */
+#define DIGITAL_FRAME_START		((uint8_t) 0x1C)
+
+/**
+ * @internal
+ * @def RECORD_SEPARATOR
+ * @brief The record separator which terminates text messages and text sample records.
+ */
+#define RECORD_SEPARATOR		((uint8_t) 0x1E)
+
+/**
+ * @internal
+ * @def TELNET_IAC
+ * @brief The Telnet interpret as command byte, which begins an option negotiation.
+ */
+#define TELNET_IAC				((uint8_t) 0xFF)
+
+/**
+ * @internal
+ * @def FRAME_HEADER_SIZE
+ * @brief The size of the header of a binary frame, the start byte and the length of its records.
+ */
+#define FRAME_HEADER_SIZE		3U
+
+/**
+ * @internal
+ * @def MARKER_SIZE
+ * @brief The size of a sample log marker, the start byte and the sequence number.
+ */
+#define MARKER_SIZE				5U
+
+/**
+ * @internal
+ * @def DIGITAL_RECORD_MIN
+ * @brief The lowest record type of a digital frame, the latch record.
+ */
+#define DIGITAL_RECORD_MIN		((uint8_t) 0xFC)
+
+/**
+ * @internal
+ * @def PUBLISH_HEADER_SIZE
+ * @brief The size of the header of a published datagram, its sequence number.
+ */
+#define PUBLISH_HEADER_SIZE		4U
+
+/**
+ * @internal
+ * @def RESEND_REQUEST_SIZE
+ * @brief The size of a resend request datagram.
+ */
+#define RESEND_REQUEST_SIZE		5U
+
+/**
+ * @internal
+ * @def RICE_ESCAPE
+ * @brief The quotient of an escaped Rice code, sent as that many 1 bits followed by the number in full.
+ */
+#define RICE_ESCAPE				16U
+
+/**
+ * @internal
+ * @def COMPRESSED_TIME_WIDTH
+ * @brief The width of an escaped timestamp change in a packed record.
+ */
+#define COMPRESSED_TIME_WIDTH	17U
+
+/**
+ * @internal
+ * @def COMPRESSED_VALUE_WIDTH
+ * @brief The width of an escaped value change in a packed record.
+ */
+#define COMPRESSED_VALUE_WIDTH	25U
+
+/* The analog record types, as the ANALOG_BINARY_ record definitions in Analog_Input.c */
+#define RECORD_CONFIG			((uint8_t) 0xFF)
+#define RECORD_STATISTICS		((uint8_t) 0xFE)
+#define RECORD_COMPRESSED		((uint8_t) 0xFD)
+#define RECORD_SEQUENCE			((uint8_t) 0xFC)
+#define RECORD_CAPTURE			((uint8_t) 0xFB)
+#define RECORD_SPECTRUM			((uint8_t) 0xFA)
+#define RECORD_POWER			((uint8_t) 0xF9)
+#define RECORD_MATH				((uint8_t) 0xF8)
+#define RECORD_MIXED			((uint8_t) 0xF7)
+#define RECORD_FORMAT			((uint8_t) 0xF6)
+#define RECORD_AUX				((uint8_t) 0xF5)
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Data structure for reading a bit stream packed least significant bit first.
+ */
+typedef struct {
+	const uint8_t* data; /**< The bytes of the stream. */
+	uint32_t size; /**< The number of bytes in the stream. */
+	uint32_t position; /**< The index of the next bit to read. */
+	bool overrun; /**< TRUE if a read went past the end of the stream. */
+} BitReader_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Reads a little endian number of up to 8 bytes.
+ */
+static uint64_t ReadLittleEndian(const uint8_t* data, uint8_t size);
+
+/**
+ * @internal
+ * @brief Reads a 24 bit two's complement sample value.
+ */
+static int32_t ReadValue(const uint8_t* data);
+
+/**
+ * @internal
+ * @brief Reads a number of bits from a bit stream.
+ */
+static uint32_t ReadBits(BitReader_t* reader, uint8_t count);
+
+/**
+ * @internal
+ * @brief Reads a Rice coded number from a bit stream.
+ */
+static uint32_t ReadRice(BitReader_t* reader, uint8_t k, uint8_t width);
+
+/**
+ * @internal
+ * @brief Reports an event with only its type, channel and raw data set.
+ */
+static void ReportRaw(Tekdaqc_Receiver_t* receiver, Receiver_EventType_t type, uint8_t channel, const uint8_t* data,
+		uint32_t length);
+
+/**
+ * @internal
+ * @brief Reports a sample of a channel and advances the channel to it.
+ */
+static void ReportSample(Tekdaqc_Receiver_t* receiver, uint8_t channel, bool timed, uint64_t timestamp, int32_t value,
+		uint8_t flags);
+
+/**
+ * @internal
+ * @brief Accounts for a channel's sequence number jumping to a new value.
+ */
+static uint32_t JumpSequence(Tekdaqc_Receiver_t* receiver, Receiver_Channel_t* state, uint32_t sequence);
+
+/**
+ * @internal
+ * @brief Retrieves the size of the analog record at the start of the provided data.
+ */
+static uint32_t GetRecordSize(const Tekdaqc_Receiver_t* receiver, const uint8_t* data, uint32_t available);
+
+/**
+ * @internal
+ * @brief Decodes a packed record.
+ */
+static void DecodeCompressed(Tekdaqc_Receiver_t* receiver, const uint8_t* record, uint32_t length);
+
+/**
+ * @internal
+ * @brief Decodes a single analog record.
+ */
+static void DecodeRecord(Tekdaqc_Receiver_t* receiver, const uint8_t* record, uint32_t length);
+
+/**
+ * @internal
+ * @brief Decodes the records of an analog frame.
+ */
+static void DecodeAnalogFrame(Tekdaqc_Receiver_t* receiver, const uint8_t* records, uint32_t length);
+
+/**
+ * @internal
+ * @brief Decodes whatever whole units the buffer holds.
+ */
+static uint32_t DecodeUnit(Tekdaqc_Receiver_t* receiver, const uint8_t* data, uint32_t available, bool final);
+
+/**
+ * @internal
+ * @brief Adds bytes to the buffer and decodes the whole units it then holds.
+ */
+static void FeedBytes(Tekdaqc_Receiver_t* receiver, const uint8_t* data, size_t length, bool final);
+
+/**
+ * @internal
+ * @brief Decodes the records of a published datagram known to be next in sequence.
+ */
+static void DecodeDatagram(Tekdaqc_Receiver_t* receiver, const uint8_t* data, size_t length);
+
+/**
+ * @internal
+ * @brief Decodes the held datagrams which have become next in sequence.
+ */
+static void DrainHeld(Tekdaqc_Receiver_t* receiver);
+
+/**
+ * @internal
+ * @brief Gives up on the datagrams missing before the earliest held one.
+ */
+static bool SkipMissing(Tekdaqc_Receiver_t* receiver);
+
+/**
+ * @internal
+ * @brief Decodes a published datagram if it is next in sequence, otherwise holds it.
+ */
+static void QueueDatagram(Tekdaqc_Receiver_t* receiver, const uint8_t* data, size_t length);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * Reads a little endian number of up to 8 bytes, as written by the board's PackLittleEndian().
+ *
+ * @param data const uint8_t* Pointer to the first byte of the number.
+ * @param size uint8_t The number of bytes in the number.
+ * @retval uint64_t The number.
+ */
+static uint64_t ReadLittleEndian(const uint8_t* data, uint8_t size) {
+	uint64_t value = 0U;
+	for (uint8_t i = size; i > 0U; --i) {
+		value = (value << 8U) | data[i - 1U];
+	}
+	return value;
+}
+
+/**
+ * @internal
+ * Reads a 24 bit two's complement sample value, little endian as the board stores it.
+ *
+ * @param data const uint8_t* Pointer to the first byte of the value.
+ * @retval int32_t The value, sign extended.
+ */
+static int32_t ReadValue(const uint8_t* data) {
+	uint32_t value = (uint32_t) ReadLittleEndian(data, 3U);
+	if ((value & 0x800000U) != 0U) {
+		value |= 0xFF000000U;
+	}
+	return (int32_t) value;
+}
+
+/**
+ * @internal
+ * Reads a number of bits from a bit stream, least significant first. Bits past the end of the stream read as 0 and
+ * mark it overrun.
+ *
+ * @param reader BitReader_t* The stream to read.
+ * @param count uint8_t The number of bits to read, at most 32.
+ * @retval uint32_t The bits read.
+ */
+static uint32_t ReadBits(BitReader_t* reader, uint8_t count) {
+	uint32_t value = 0U;
+	for (uint8_t i = 0U; i < count; ++i) {
+		const uint32_t byte = reader->position >> 3U;
+		if (byte >= reader->size) {
+			reader->overrun = true;
+			return value;
+		}
+		value |= (uint32_t) ((reader->data[byte] >> (reader->position & 7U)) & 1U) << i;
+		++reader->position;
+	}
+	return value;
+}
+
+/**
+ * @internal
+ * Reads a Rice coded number, as written by the board's Rice_WriteCode(): the quotient in unary, 1 bits terminated by
+ * a 0, followed by the low k bits, or RICE_ESCAPE 1 bits followed by the number in full.
+ *
+ * @param reader BitReader_t* The stream to read.
+ * @param k uint8_t The Rice parameter.
+ * @param width uint8_t The width of an escaped number.
+ * @retval uint32_t The number read.
+ */
+static uint32_t ReadRice(BitReader_t* reader, uint8_t k, uint8_t width) {
+	uint32_t quotient = 0U;
+	while (quotient < RICE_ESCAPE) {
+		if ((ReadBits(reader, 1U) == 0U) || (reader->overrun == true)) {
+			break;
+		}
+		++quotient;
+	}
+	if (quotient == RICE_ESCAPE) {
+		return ReadBits(reader, width);
+	}
+	return (quotient << k) | ReadBits(reader, k);
+}
+
+/**
+ * @internal
+ * Reports an event carrying only its type, channel and the raw bytes it came from.
+ *
+ * @param receiver Tekdaqc_Receiver_t* The receiver reporting the event.
+ * @param type Receiver_EventType_t The kind of event.
+ * @param channel uint8_t The channel of the event, if any.
+ * @param data const uint8_t* Pointer to the raw bytes of the event.
+ * @param length uint32_t The number of raw bytes.
+ * @retval none
+ */
+static void ReportRaw(Tekdaqc_Receiver_t* receiver, Receiver_EventType_t type, uint8_t channel, const uint8_t* data,
+		uint32_t length) {
+	Receiver_Event_t event;
+	memset(&event, 0, sizeof(event));
+	event.type = type;
+	event.channel = channel;
+	event.data = data;
+	event.length = length;
+	receiver->callback(&event, receiver->context);
+}
+
+/**
+ * @internal
+ * Reports a sample of a channel with the channel's next sequence number, then advances the channel past it.
+ *
+ * @param receiver Tekdaqc_Receiver_t* The receiver reporting the sample.
+ * @param channel uint8_t The physical input of the sample.
+ * @param timed bool TRUE if the timestamp is that of the sample.
+ * @param timestamp uint64_t The timestamp of the sample.
+ * @param value int32_t The raw ADC code of the sample.
+ * @param flags uint8_t The flags of the sample.
+ * @retval none
+ */
+static void ReportSample(Tekdaqc_Receiver_t* receiver, uint8_t channel, bool timed, uint64_t timestamp, int32_t value,
+		uint8_t flags) {
+	Receiver_Channel_t* state = &receiver->channels[channel];
+	Receiver_Event_t event;
+	memset(&event, 0, sizeof(event));
+	event.type = RECEIVER_EVENT_SAMPLE;
+	event.channel = channel;
+	event.timed = timed && state->valid;
+	event.flags = flags;
+	event.value = value;
+	event.timestamp = timestamp;
+	event.sequence = state->sequence;
+	if (timed == true) {
+		state->timestamp = timestamp;
+	}
+	++state->sequence;
+	++receiver->counters.samples;
+	receiver->callback(&event, receiver->context);
+}
+
+/**
+ * @internal
+ * Accounts for a channel's sequence number jumping to a new value. A jump forward counts the samples skipped as lost,
+ * while a jump back is a new sampling run counting up from 0 again.
+ *
+ * @param receiver Tekdaqc_Receiver_t* The receiver the channel belongs to.
+ * @param state Receiver_Channel_t* The channel's state.
+ * @param sequence uint32_t The sequence number of the channel's next sample.
+ * @retval uint32_t The number of samples lost.
+ */
+static uint32_t JumpSequence(Tekdaqc_Receiver_t* receiver, Receiver_Channel_t* state, uint32_t sequence) {
+	uint32_t lost = 0U;
+	if ((state->valid == true) && ((int32_t) (sequence - state->sequence) > 0)) {
+		lost = sequence - state->sequence;
+		receiver->counters.lostSamples += lost;
+	}
+	state->sequence = sequence;
+	return lost;
+}
+
+/**
+ * @internal
+ * Retrieves the size of the analog record at the start of the provided data, from its type and, for the variable
+ * length records, its count.
+ *
+ * @param receiver const Tekdaqc_Receiver_t* The receiver, for the size of a sample record.
+ * @param data const uint8_t* Pointer to the record.
+ * @param available uint32_t The number of bytes left in the frame.
+ * @retval uint32_t The size of the record, 0 if it does not fit in the frame.
+ */
+static uint32_t GetRecordSize(const Tekdaqc_Receiver_t* receiver, const uint8_t* data, uint32_t available) {
+	uint32_t size;
+	switch (data[0]) {
+	case RECORD_CONFIG:
+		size = 17U;
+		break;
+	case RECORD_STATISTICS:
+		size = 30U;
+		break;
+	case RECORD_COMPRESSED:
+		size = (available >= 7U) ? (7U + (uint32_t) ReadLittleEndian(&data[5], 2U)) : 7U;
+		break;
+	case RECORD_SEQUENCE:
+		size = 6U;
+		break;
+	case RECORD_CAPTURE:
+		size = (available >= 8U) ? (8U + (3U * (uint32_t) ReadLittleEndian(&data[6], 2U))) : 8U;
+		break;
+	case RECORD_SPECTRUM:
+		size = (available >= 8U) ? (8U + (4U * (uint32_t) ReadLittleEndian(&data[6], 2U))) : 8U;
+		break;
+	case RECORD_POWER:
+		size = 38U;
+		break;
+	case RECORD_MATH:
+		size = 15U;
+		break;
+	case RECORD_MIXED:
+		size = 17U;
+		break;
+	case RECORD_FORMAT:
+		size = 5U;
+		break;
+	case RECORD_AUX:
+		size = (available >= 10U) ? (10U + (2U * (uint32_t) data[9])) : 10U;
+		break;
+	default:
+		/* A sample record, starting with its channel */
+		size = receiver->sampleSize;
+		break;
+	}
+	return (size <= available) ? size : 0U;
+}
+
+/**
+ * @internal
+ * Decodes a packed record into its samples, see the framing description at the top of Analog_Input.c. A record whose
+ * bits run out early is reported up to the last whole sample.
+ *
+ * @param receiver Tekdaqc_Receiver_t* The receiver decoding the record.
+ * @param record const uint8_t* Pointer to the record.
+ * @param length uint32_t The size of the record.
+ * @retval none
+ */
+static void DecodeCompressed(Tekdaqc_Receiver_t* receiver, const uint8_t* record, uint32_t length) {
+	const uint8_t channel = record[1];
+	const uint8_t count = record[2];
+	const uint8_t timeK = record[3];
+	const uint8_t valueK = record[4];
+	BitReader_t bits = { &record[7], length - 7U, 0U, false };
+	int32_t previousDelta = 0;
+	int32_t previousValue = 0;
+	uint64_t previousTimestamp = receiver->channels[channel].timestamp;
+	for (uint8_t i = 0U; i < count; ++i) {
+		const uint32_t timeCode = ReadRice(&bits, timeK, COMPRESSED_TIME_WIDTH);
+		const uint32_t valueCode = ReadRice(&bits, valueK, COMPRESSED_VALUE_WIDTH);
+		uint8_t flags = 0U;
+		if (ReadBits(&bits, 1U) != 0U) {
+			flags = (uint8_t) ReadBits(&bits, 8U);
+		}
+		if (bits.overrun == true) {
+			receiver->counters.discarded += length;
+			return;
+		}
+		/* Undo the zigzag coding */
+		const int32_t delta = previousDelta + (int32_t) ((timeCode >> 1U) ^ (0U - (timeCode & 1U)));
+		const int32_t value = previousValue + (int32_t) ((valueCode >> 1U) ^ (0U - (valueCode & 1U)));
+		previousTimestamp += (uint64_t) (int64_t) delta;
+		ReportSample(receiver, channel, true, previousTimestamp, value, flags);
+		previousDelta = delta;
+		previousValue = value;
+	}
+}
+
+/**
+ * @internal
+ * Decodes a single analog record, updating the state of its channel as the board did when it wrote it.
+ *
+ * @param receiver Tekdaqc_Receiver_t* The receiver decoding the record.
+ * @param record const uint8_t* Pointer to the record.
+ * @param length uint32_t The size of the record.
+ * @retval none
+ */
+static void DecodeRecord(Tekdaqc_Receiver_t* receiver, const uint8_t* record, uint32_t length) {
+	Receiver_Event_t event;
+	Receiver_Channel_t* state = &receiver->channels[record[1]];
+	switch (record[0]) {
+	case RECORD_CONFIG:
+		memset(&event, 0, sizeof(event));
+		event.type = RECEIVER_EVENT_CONFIG;
+		event.channel = record[1];
+		event.timestamp = ReadLittleEndian(&record[5], 8U);
+		event.sequence = (uint32_t) ReadLittleEndian(&record[13], 4U);
+		event.lost = JumpSequence(receiver, state, event.sequence);
+		event.data = record;
+		event.length = length;
+		state->valid = true;
+		state->gain = record[2];
+		state->rate = record[3];
+		state->timestamp = event.timestamp;
+		receiver->callback(&event, receiver->context);
+		break;
+	case RECORD_SEQUENCE:
+		memset(&event, 0, sizeof(event));
+		event.type = RECEIVER_EVENT_GAP;
+		event.channel = record[1];
+		event.sequence = (uint32_t) ReadLittleEndian(&record[2], 4U);
+		event.lost = JumpSequence(receiver, state, event.sequence);
+		event.data = record;
+		event.length = length;
+		receiver->callback(&event, receiver->context);
+		break;
+	case RECORD_COMPRESSED:
+		DecodeCompressed(receiver, record, length);
+		break;
+	case RECORD_FORMAT:
+		receiver->fields = record[3];
+		receiver->sampleSize = record[4];
+		ReportRaw(receiver, RECEIVER_EVENT_FORMAT, 0U, record, length);
+		break;
+	case RECORD_STATISTICS:
+	case RECORD_CAPTURE:
+	case RECORD_SPECTRUM:
+	case RECORD_POWER:
+	case RECORD_MATH:
+		ReportRaw(receiver, RECEIVER_EVENT_RECORD, record[1], record, length);
+		break;
+	case RECORD_MIXED:
+	case RECORD_AUX:
+		/* Neither belongs to a channel */
+		ReportRaw(receiver, RECEIVER_EVENT_RECORD, 0U, record, length);
+		break;
+	default: {
+		/* A sample record: [channel][delta timestamp:2][value:3][flags], the optional fields as selected */
+		uint32_t position = 1U;
+		uint64_t timestamp = receiver->channels[record[0]].timestamp;
+		const bool timed = (receiver->fields & RECEIVER_FIELD_TIMESTAMP) != 0U;
+		if (timed == true) {
+			timestamp += ReadLittleEndian(&record[position], 2U);
+			position += 2U;
+		}
+		const int32_t value = ReadValue(&record[position]);
+		position += 3U;
+		const uint8_t flags = ((receiver->fields & RECEIVER_FIELD_FLAGS) != 0U) ? record[position] : 0U;
+		ReportSample(receiver, record[0], timed, timestamp, value, flags);
+		break;
+	}
+	}
+}
+
+/**
+ * @internal
+ * Decodes the records of an analog frame in order. A record which runs past the end of the frame means the frame was
+ * not understood, and the rest of it is dropped.
+ *
+ * @param receiver Tekdaqc_Receiver_t* The receiver decoding the frame.
+ * @param records const uint8_t* Pointer to the first record of the frame.
+ * @param length uint32_t The length of the frame's records.
+ * @retval none
+ */
+static void DecodeAnalogFrame(Tekdaqc_Receiver_t* receiver, const uint8_t* records, uint32_t length) {
+	uint32_t position = 0U;
+	while (position < length) {
+		const uint32_t size = GetRecordSize(receiver, &records[position], length - position);
+		if (size == 0U) {
+			receiver->counters.discarded += length - position;
+			return;
+		}
+		DecodeRecord(receiver, &records[position], size);
+		position += size;
+	}
+}
+
+/**
+ * @internal
+ * Decodes the unit at the start of the provided data if it is complete. Text with neither a record separator nor a
+ * binary unit after it is only taken as complete when no more data can follow.
+ *
+ * @param receiver Tekdaqc_Receiver_t* The receiver decoding the data.
+ * @param data const uint8_t* Pointer to the data not yet decoded.
+ * @param available uint32_t The number of bytes of data.
+ * @param final bool TRUE if the data ends here, so that incomplete text is reported as it is.
+ * @retval uint32_t The number of bytes decoded, 0 if the unit is not complete yet.
+ */
+static uint32_t DecodeUnit(Tekdaqc_Receiver_t* receiver, const uint8_t* data, uint32_t available, bool final) {
+	if (data[0] == ANALOG_FRAME_START) {
+		if (available < FRAME_HEADER_SIZE) {
+			return 0U;
+		}
+		const uint32_t size = FRAME_HEADER_SIZE + (uint32_t) ReadLittleEndian(&data[1], 2U);
+		if (available < size) {
+			return 0U;
+		}
+		++receiver->counters.frames;
+		DecodeAnalogFrame(receiver, &data[FRAME_HEADER_SIZE], size - FRAME_HEADER_SIZE);
+		return size;
+	} else if (data[0] == DIGITAL_FRAME_START) {
+		if (receiver->resumed == true) {
+			if (available < MARKER_SIZE) {
+				return 0U;
+			}
+			const uint32_t sequence = (uint32_t) ReadLittleEndian(&data[1], 4U);
+			if ((data[3] < DIGITAL_RECORD_MIN) || (sequence == (receiver->marker + 1U))) {
+				Receiver_Event_t event;
+				memset(&event, 0, sizeof(event));
+				event.type = RECEIVER_EVENT_MARKER;
+				event.sequence = sequence;
+				event.data = data;
+				event.length = MARKER_SIZE;
+				receiver->marker = sequence;
+				receiver->callback(&event, receiver->context);
+				return MARKER_SIZE;
+			}
+		}
+		if (available < FRAME_HEADER_SIZE) {
+			return 0U;
+		}
+		const uint32_t size = FRAME_HEADER_SIZE + (uint32_t) ReadLittleEndian(&data[1], 2U);
+		if (available < size) {
+			return 0U;
+		}
+		++receiver->counters.frames;
+		ReportRaw(receiver, RECEIVER_EVENT_DIGITAL, 0U, data, size);
+		return size;
+	} else if (data[0] == TELNET_IAC) {
+		/* WILL, WONT, DO and DONT carry an option, every other command stands alone */
+		if (available < 2U) {
+			return 0U;
+		}
+		const uint32_t size = ((data[1] >= 0xFBU) && (data[1] <= 0xFEU)) ? 3U : 2U;
+		if (available < size) {
+			return 0U;
+		}
+		return size;
+	}
+	for (uint32_t i = 0U; i < available; ++i) {
+		if (data[i] == RECORD_SEPARATOR) {
+			if (i > 0U) {
+				ReportRaw(receiver, RECEIVER_EVENT_TEXT, 0U, data, i);
+			}
+			return i + 1U;
+		} else if ((data[i] == ANALOG_FRAME_START) || (data[i] == DIGITAL_FRAME_START) || (data[i] == TELNET_IAC)) {
+			/* Text without a separator, such as an echoed command */
+			ReportRaw(receiver, RECEIVER_EVENT_TEXT, 0U, data, i);
+			return i;
+		}
+	}
+	if ((final == true) || (available == RECEIVER_BUFFER_SIZE)) {
+		ReportRaw(receiver, RECEIVER_EVENT_TEXT, 0U, data, available);
+		return available;
+	}
+	return 0U;
+}
+
+/**
+ * @internal
+ * Adds bytes to the buffer, as many at a time as fit, and decodes every whole unit the buffer then holds. The
+ * remainder is kept at the start of the buffer for the next bytes.
+ *
+ * @param receiver Tekdaqc_Receiver_t* The receiver to feed.
+ * @param data const uint8_t* Pointer to the bytes.
+ * @param length size_t The number of bytes.
+ * @param final bool TRUE if nothing follows these bytes, as at the end of a datagram.
+ * @retval none
+ */
+static void FeedBytes(Tekdaqc_Receiver_t* receiver, const uint8_t* data, size_t length, bool final) {
+	do {
+		uint32_t chunk = RECEIVER_BUFFER_SIZE - receiver->length;
+		if (chunk > length) {
+			chunk = (uint32_t) length;
+		}
+		memcpy(&receiver->buffer[receiver->length], data, chunk);
+		receiver->length += chunk;
+		data += chunk;
+		length -= chunk;
+		uint32_t position = 0U;
+		while (position < receiver->length) {
+			const uint32_t used = DecodeUnit(receiver, &receiver->buffer[position], receiver->length - position,
+					final && (length == 0U));
+			if (used == 0U) {
+				break;
+			}
+			position += used;
+		}
+		receiver->length -= position;
+		memmove(receiver->buffer, &receiver->buffer[position], receiver->length);
+	} while (length > 0U);
+}
+
+/**
+ * @internal
+ * Decodes the records of a published datagram known to be next in sequence. A datagram always holds whole records,
+ * so anything left over at its end was not understood.
+ *
+ * @param receiver Tekdaqc_Receiver_t* The receiver decoding the datagram.
+ * @param data const uint8_t* Pointer to the datagram, header included.
+ * @param length size_t The length of the datagram.
+ * @retval none
+ */
+static void DecodeDatagram(Tekdaqc_Receiver_t* receiver, const uint8_t* data, size_t length) {
+	receiver->length = 0U;
+	FeedBytes(receiver, &data[PUBLISH_HEADER_SIZE], length - PUBLISH_HEADER_SIZE, true);
+	receiver->counters.discarded += receiver->length;
+	receiver->length = 0U;
+	++receiver->counters.datagrams;
+	++receiver->datagram;
+}
+
+/**
+ * @internal
+ * Decodes, in order, the held datagrams which follow on from those already decoded.
+ *
+ * @param receiver Tekdaqc_Receiver_t* The receiver holding the datagrams.
+ * @retval none
+ */
+static void DrainHeld(Tekdaqc_Receiver_t* receiver) {
+	bool found;
+	do {
+		found = false;
+		for (uint8_t i = 0U; i < RECEIVER_REORDER_COUNT; ++i) {
+			Receiver_Datagram_t* held = &receiver->held[i];
+			if ((held->used == true) && (held->sequence == receiver->datagram)) {
+				held->used = false;
+				DecodeDatagram(receiver, held->data, held->length);
+				found = true;
+			}
+		}
+	} while (found == true);
+}
+
+/**
+ * @internal
+ * Gives up on the datagrams missing before the earliest held one, counting them as lost, and decodes the held ones
+ * which then follow on.
+ *
+ * @param receiver Tekdaqc_Receiver_t* The receiver holding the datagrams.
+ * @retval bool TRUE if any datagram was held.
+ */
+static bool SkipMissing(Tekdaqc_Receiver_t* receiver) {
+	bool any = false;
+	uint32_t earliest = 0U;
+	for (uint8_t i = 0U; i < RECEIVER_REORDER_COUNT; ++i) {
+		const Receiver_Datagram_t* held = &receiver->held[i];
+		if ((held->used == true) && ((any == false) || ((int32_t) (held->sequence - earliest) < 0))) {
+			earliest = held->sequence;
+			any = true;
+		}
+	}
+	if (any == true) {
+		Receiver_Event_t event;
+		memset(&event, 0, sizeof(event));
+		event.type = RECEIVER_EVENT_DATAGRAMS_LOST;
+		event.sequence = receiver->datagram;
+		event.lost = earliest - receiver->datagram;
+		receiver->counters.lostDatagrams += event.lost;
+		receiver->datagram = earliest;
+		receiver->callback(&event, receiver->context);
+		DrainHeld(receiver);
+	}
+	return any;
+}
+
+/**
+ * @internal
+ * Decodes a published datagram if it is next in sequence, followed by any held ones which then follow on. One ahead
+ * of a missing datagram is held, and a resend event reported for each newly missing one; once every slot is taken
+ * the missing ones are given up on. Duplicates, and datagrams already given up on, are dropped.
+ *
+ * @param receiver Tekdaqc_Receiver_t* The receiver decoding the datagram.
+ * @param data const uint8_t* Pointer to the datagram, header included.
+ * @param length size_t The length of the datagram.
+ * @retval none
+ */
+static void QueueDatagram(Tekdaqc_Receiver_t* receiver, const uint8_t* data, size_t length) {
+	const uint32_t sequence = (uint32_t) ReadLittleEndian(data, 4U);
+	if (receiver->publishing == false) {
+		receiver->publishing = true;
+		receiver->datagram = sequence;
+	}
+	const int32_t ahead = (int32_t) (sequence - receiver->datagram);
+	if (ahead < 0) {
+		receiver->counters.discarded += length;
+		return;
+	}
+	uint8_t free = RECEIVER_REORDER_COUNT;
+	uint32_t highest = receiver->datagram - 1U;
+	bool holding = false;
+	for (uint8_t i = 0U; i < RECEIVER_REORDER_COUNT; ++i) {
+		const Receiver_Datagram_t* held = &receiver->held[i];
+		if (held->used == false) {
+			free = i;
+		} else if (held->sequence == sequence) {
+			receiver->counters.discarded += length;
+			return;
+		} else {
+			if ((int32_t) (held->sequence - highest) > 0) {
+				highest = held->sequence;
+			}
+			holding = true;
+		}
+	}
+	if (ahead == 0) {
+		if (holding == true) {
+			++receiver->counters.resentDatagrams;
+		}
+		DecodeDatagram(receiver, data, length);
+		DrainHeld(receiver);
+		return;
+	}
+	if (free == RECEIVER_REORDER_COUNT) {
+		/* The board will have dropped the missing batches from its history by now */
+		SkipMissing(receiver);
+		QueueDatagram(receiver, data, length);
+		return;
+	}
+	Receiver_Datagram_t* slot = &receiver->held[free];
+	slot->used = true;
+	slot->sequence = sequence;
+	slot->length = (uint16_t) length;
+	memcpy(slot->data, data, length);
+	/* Ask only for the datagrams not already known to be missing, and still in the board's history */
+	uint32_t missing = highest + 1U;
+	if ((sequence - missing) > RECEIVER_REORDER_COUNT) {
+		missing = sequence - RECEIVER_REORDER_COUNT;
+	}
+	for (; missing != sequence; ++missing) {
+		Receiver_Event_t event;
+		memset(&event, 0, sizeof(event));
+		event.type = RECEIVER_EVENT_RESEND;
+		event.sequence = missing;
+		receiver->callback(&event, receiver->context);
+	}
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Initializes a receiver to report its events to the provided callback, expecting the default sample fields.
+ *
+ * @param receiver Tekdaqc_Receiver_t* The receiver to initialize.
+ * @param callback Receiver_Callback The function to report events to.
+ * @param context void* The context passed to the callback.
+ * @retval none
+ */
+void Receiver_Init(Tekdaqc_Receiver_t* receiver, Receiver_Callback callback, void* context) {
+	memset(receiver, 0, sizeof(*receiver));
+	receiver->callback = callback;
+	receiver->context = context;
+	Receiver_SetFields(receiver, RECEIVER_FIELDS_DEFAULT);
+}
+
+/**
+ * Forgets every channel's state, as the board does when the data format is set, so the sequence numbers of the next
+ * run are not mistaken for a jump.
+ *
+ * @param receiver Tekdaqc_Receiver_t* The receiver to reset.
+ * @retval none
+ */
+void Receiver_ResetFraming(Tekdaqc_Receiver_t* receiver) {
+	memset(receiver->channels, 0, sizeof(receiver->channels));
+}
+
+/**
+ * Sets the fields of the sample records. A stream descriptor sets them itself, so this is only needed by a client
+ * which selected its fields with the FORMAT command without asking for the descriptor.
+ *
+ * @param receiver Tekdaqc_Receiver_t* The receiver to set.
+ * @param fields uint8_t The RECEIVER_FIELD_ bits of the sample records.
+ * @retval none
+ */
+void Receiver_SetFields(Tekdaqc_Receiver_t* receiver, uint8_t fields) {
+	receiver->fields = fields;
+	receiver->sampleSize = 4U;
+	if ((fields & RECEIVER_FIELD_TIMESTAMP) != 0U) {
+		receiver->sampleSize += 2U;
+	}
+	if ((fields & RECEIVER_FIELD_FLAGS) != 0U) {
+		receiver->sampleSize += 1U;
+	}
+}
+
+/**
+ * Tells the receiver RESUME_SAMPLE_LOG was sent, so the records replayed from the sample log are preceded by markers.
+ *
+ * @param receiver Tekdaqc_Receiver_t* The receiver to set.
+ * @param sequence uint32_t The sequence number the resume was requested from.
+ * @retval none
+ */
+void Receiver_SetResumed(Tekdaqc_Receiver_t* receiver, uint32_t sequence) {
+	receiver->resumed = true;
+	receiver->marker = sequence;
+}
+
+/**
+ * Retrieves the sequence number of the last sample log marker received, which is what to resume from on
+ * reconnecting.
+ *
+ * @param receiver const Tekdaqc_Receiver_t* The receiver to query.
+ * @retval uint32_t The sequence number of the last marker, or that resumed from if none has been received.
+ */
+uint32_t Receiver_GetMarker(const Tekdaqc_Receiver_t* receiver) {
+	return receiver->marker;
+}
+
+/**
+ * Feeds the bytes received on a Telnet or data connection to the receiver, in pieces of any size. Events are
+ * reported for every unit completed by them.
+ *
+ * @param receiver Tekdaqc_Receiver_t* The receiver to feed.
+ * @param data const uint8_t* Pointer to the bytes received.
+ * @param length size_t The number of bytes received.
+ * @retval none
+ */
+void Receiver_Feed(Tekdaqc_Receiver_t* receiver, const uint8_t* data, size_t length) {
+	receiver->counters.bytes += length;
+	if (length > 0U) {
+		FeedBytes(receiver, data, length, false);
+	}
+}
+
+/**
+ * Feeds a datagram published over UDP to the receiver, whole as it was received. Datagrams are decoded in sequence
+ * order, see the description at the top of this file.
+ *
+ * @param receiver Tekdaqc_Receiver_t* The receiver to feed.
+ * @param data const uint8_t* Pointer to the datagram, header included.
+ * @param length size_t The length of the datagram.
+ * @retval none
+ */
+void Receiver_FeedDatagram(Tekdaqc_Receiver_t* receiver, const uint8_t* data, size_t length) {
+	receiver->counters.bytes += length;
+	if ((length < PUBLISH_HEADER_SIZE) || (length > RECEIVER_DATAGRAM_SIZE)) {
+		receiver->counters.discarded += length;
+		return;
+	}
+	QueueDatagram(receiver, data, length);
+}
+
+/**
+ * Gives up on any missing published datagrams, counting them as lost, and decodes those held back waiting for them.
+ * Called once no more datagrams are expected, as after sampling has stopped.
+ *
+ * @param receiver Tekdaqc_Receiver_t* The receiver to flush.
+ * @retval none
+ */
+void Receiver_FlushDatagrams(Tekdaqc_Receiver_t* receiver) {
+	while (SkipMissing(receiver) == true) {
+	}
+}
+
+/**
+ * Fills in a datagram asking the board to publish a batch again, to be sent to its publish port.
+ *
+ * @param sequence uint32_t The sequence number of the missing batch.
+ * @param request uint8_t* The buffer to fill in, at least 5 bytes.
+ * @retval size_t The length of the request.
+ */
+size_t Receiver_ResendRequest(uint32_t sequence, uint8_t* request) {
+	request[0] = RECEIVER_PUBLISH_RESEND_REQUEST;
+	for (uint8_t i = 0U; i < 4U; ++i) {
+		request[1U + i] = (uint8_t) (sequence >> (8U * i));
+	}
+	return RESEND_REQUEST_SIZE;
+}
+
+/**
+ * Retrieves the counters of the receiver, kept since it was initialized.
+ *
+ * @param receiver const Tekdaqc_Receiver_t* The receiver to query.
+ * @retval const Receiver_Counters_t* Pointer to the counters.
+ */
+const Receiver_Counters_t* Receiver_GetCounters(const Tekdaqc_Receiver_t* receiver) {
+	return &receiver->counters;
+}
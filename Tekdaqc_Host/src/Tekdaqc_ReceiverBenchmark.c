@@ -0,0 +1,659 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_ReceiverBenchmark.c
+ * @brief Measures the end to end throughput, latency and loss of a Tekdaqc's sample stream from the host.
+ *
+ * Drives a board over its Telnet connection and receives its samples with the reference receiver, over the data
+ * connection, in band on the Telnet connection or published over UDP. The setup commands given are sent first, such
+ * as ADD_ANALOG_INPUT, then the data format is set and sampling started. Once the run time has passed sampling is
+ * halted, what is still in flight is drained and the following are reported:
+ *
+ *   - the samples received per second, from the first sample to the last, and the bytes per second carrying them;
+ *   - the percentiles of the latency of each sample, from its timestamp to its arrival at the host;
+ *   - the samples the board reported lost, and over UDP the datagrams recovered and not recovered.
+ *
+ * A sample's latency is only absolute when the board's clock is synchronized to the host's, as by its SNTP client;
+ * otherwise its timestamps are local time and the latencies are reported relative to the smallest one seen, which
+ * still shows the spread added by batching and the network. With -r the sample log is resumed from the sequence
+ * number given and the last marker received is reported, to resume from on the next run.
+ *
+ * This is host code, built with the host's C99 compiler on any POSIX system:
+ *
+ *   cc -std=c99 -O2 -D_POSIX_C_SOURCE=200809L -ITekdaqc_Host/inc -o tekdaqc_benchmark \
+ *       Tekdaqc_Host/src/Tekdaqc_Receiver.c Tekdaqc_Host/src/Tekdaqc_ReceiverBenchmark.c
+ *
+ * and run as, for example:
+ *
+ *   tekdaqc_benchmark -t 30 -c "ADD_ANALOG_INPUT --INPUT=0 --RATE=30000 --GAIN=1" 192.168.1.20
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Receiver.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <inttypes.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def TELNET_PORT
+ * @brief The board's Telnet port, as TELNET_PORT in Tekdaqc_BSP.h.
+ */
+#define TELNET_PORT				"9801"
+
+/**
+ * @internal
+ * @def DATA_PORT
+ * @brief The board's data port, as DATA_PORT in Tekdaqc_BSP.h.
+ */
+#define DATA_PORT				"9802"
+
+/**
+ * @internal
+ * @def PUBLISH_PORT
+ * @brief The board's publish port, to which resend requests are sent, as PUBLISH_PORT in Tekdaqc_BSP.h.
+ */
+#define PUBLISH_PORT			9803U
+
+/**
+ * @internal
+ * @def MAX_SETUP_COMMANDS
+ * @brief The most setup commands which may be given.
+ */
+#define MAX_SETUP_COMMANDS		32U
+
+/**
+ * @internal
+ * @def READ_SIZE
+ * @brief The most bytes read from a socket at a time.
+ */
+#define READ_SIZE				65536U
+
+/**
+ * @internal
+ * @def SETTLE_US
+ * @brief The time given the setup commands to complete before sampling is started.
+ */
+#define SETTLE_US				((uint64_t) 500000U)
+
+/**
+ * @internal
+ * @def DRAIN_QUIET_US
+ * @brief The time without any data after which the stream is taken as drained once sampling is halted.
+ */
+#define DRAIN_QUIET_US			((uint64_t) 500000U)
+
+/**
+ * @internal
+ * @def DRAIN_MAX_US
+ * @brief The longest time waited for the stream to drain once sampling is halted.
+ */
+#define DRAIN_MAX_US			((uint64_t) 5000000U)
+
+/**
+ * @internal
+ * @def SYNCHRONIZED_LIMIT_US
+ * @brief The largest median latency taken to mean the board's clock is synchronized to the host's.
+ */
+#define SYNCHRONIZED_LIMIT_US	((int64_t) 10000000)
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief The ways the samples can be received.
+ */
+typedef enum {
+	TRANSPORT_DATA, /**< Over the data connection. */
+	TRANSPORT_TELNET, /**< In band on the Telnet connection. */
+	TRANSPORT_UDP /**< Published over UDP. */
+} Transport_t;
+
+/**
+ * @internal
+ * @brief The state of a benchmark run, passed to the receivers' callback.
+ */
+typedef struct {
+	bool verbose; /**< TRUE to print every text message. */
+	bool sampling; /**< TRUE once sampling was started, so samples are measured. */
+	uint64_t arrival; /**< The host time at which the data being decoded arrived. */
+	uint64_t first; /**< The arrival of the first sample. */
+	uint64_t last; /**< The arrival of the last sample. */
+	uint64_t samples; /**< The samples received while measuring. */
+	uint64_t failures; /**< The error messages and failed commands seen. */
+	int64_t* latencies; /**< The latency of each timed sample in microseconds. */
+	size_t latencyCount; /**< The number of latencies. */
+	size_t latencyCapacity; /**< The room for latencies. */
+	int udp; /**< The publish socket, or -1. */
+	struct sockaddr_in board; /**< The board's publish port, for resend requests. */
+} Benchmark_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The receiver of the Telnet connection, large so kept off the stack */
+static Tekdaqc_Receiver_t telnetReceiver;
+
+/* The receiver of the data connection or published datagrams */
+static Tekdaqc_Receiver_t dataReceiver;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Retrieves the host's time in microseconds since the epoch.
+ */
+static uint64_t GetHostTime(void);
+
+/**
+ * @internal
+ * @brief Handles the events of both receivers.
+ */
+static void OnEvent(const Receiver_Event_t* event, void* context);
+
+/**
+ * @internal
+ * @brief Indicates if a text event contains a string.
+ */
+static bool ContainsText(const Receiver_Event_t* event, const char* text);
+
+/**
+ * @internal
+ * @brief Opens a TCP connection to a port of the board.
+ */
+static int ConnectTo(const char* host, const char* port);
+
+/**
+ * @internal
+ * @brief Sends a command line to the board.
+ */
+static bool SendCommand(int telnet, const char* command);
+
+/**
+ * @internal
+ * @brief Receives and decodes whatever arrives on the sockets for a time.
+ */
+static uint64_t Pump(Benchmark_t* bench, int telnet, int data, Transport_t transport, uint64_t duration,
+		uint64_t quiet);
+
+/**
+ * @internal
+ * @brief Compares two latencies for sorting.
+ */
+static int CompareLatency(const void* a, const void* b);
+
+/**
+ * @internal
+ * @brief Prints the results of the run.
+ */
+static void Report(Benchmark_t* bench, Transport_t transport);
+
+/**
+ * @internal
+ * @brief Prints how the program is used.
+ */
+static void Usage(const char* program);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * Retrieves the host's wall clock time, to compare with the board's epoch timestamps.
+ *
+ * @param none
+ * @retval uint64_t The time in microseconds since 1970-01-01 00:00:00 UTC.
+ */
+static uint64_t GetHostTime(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_REALTIME, &now);
+	return ((uint64_t) now.tv_sec * 1000000U) + ((uint64_t) now.tv_nsec / 1000U);
+}
+
+/**
+ * @internal
+ * Handles the events of both receivers: measures each sample, prints error messages and failed commands, and asks
+ * the board again for missing published datagrams.
+ *
+ * @param event const Receiver_Event_t* The event.
+ * @param context void* The benchmark run.
+ * @retval none
+ */
+static void OnEvent(const Receiver_Event_t* event, void* context) {
+	Benchmark_t* bench = (Benchmark_t*) context;
+	switch (event->type) {
+	case RECEIVER_EVENT_SAMPLE:
+		if (bench->sampling == false) {
+			break;
+		}
+		if (bench->samples == 0U) {
+			bench->first = bench->arrival;
+		}
+		bench->last = bench->arrival;
+		++bench->samples;
+		if (event->timed == true) {
+			if (bench->latencyCount == bench->latencyCapacity) {
+				const size_t capacity = (bench->latencyCapacity == 0U) ? 65536U : (2U * bench->latencyCapacity);
+				int64_t* latencies = realloc(bench->latencies, capacity * sizeof(int64_t));
+				if (latencies == NULL) {
+					break;
+				}
+				bench->latencies = latencies;
+				bench->latencyCapacity = capacity;
+			}
+			bench->latencies[bench->latencyCount++] = (int64_t) (bench->arrival - event->timestamp);
+		}
+		break;
+	case RECEIVER_EVENT_TEXT: {
+		const bool failed = (ContainsText(event, "FAIL") == true) || (ContainsText(event, "Error Message") == true);
+		if (failed == true) {
+			++bench->failures;
+		}
+		if ((failed == true) || (bench->verbose == true)) {
+			fprintf((failed == true) ? stderr : stdout, "%.*s\n", (int) event->length, (const char*) event->data);
+		}
+		break;
+	}
+	case RECEIVER_EVENT_RESEND:
+		if (bench->udp >= 0) {
+			uint8_t request[8];
+			const size_t length = Receiver_ResendRequest(event->sequence, request);
+			sendto(bench->udp, request, length, 0, (const struct sockaddr*) &bench->board, sizeof(bench->board));
+		}
+		break;
+	case RECEIVER_EVENT_MARKER:
+		if (bench->verbose == true) {
+			printf("Sample log record %" PRIu32 "\n", event->sequence);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * @internal
+ * Indicates if a text event contains a string. The text of an event is not terminated, so it is searched in place.
+ *
+ * @param event const Receiver_Event_t* The text event.
+ * @param text const char* The string to look for.
+ * @retval bool TRUE if the string was found.
+ */
+static bool ContainsText(const Receiver_Event_t* event, const char* text) {
+	const size_t length = strlen(text);
+	for (size_t i = 0U; (i + length) <= event->length; ++i) {
+		if (memcmp(&event->data[i], text, length) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @internal
+ * Opens a TCP connection to a port of the board, with Nagle's algorithm disabled so commands go out at once.
+ *
+ * @param host const char* The board's address or name.
+ * @param port const char* The port to connect to.
+ * @retval int The socket, or -1 if the connection failed.
+ */
+static int ConnectTo(const char* host, const char* port) {
+	struct addrinfo hints;
+	struct addrinfo* result = NULL;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_STREAM;
+	if (getaddrinfo(host, port, &hints, &result) != 0) {
+		fprintf(stderr, "Could not resolve %s.\n", host);
+		return -1;
+	}
+	int fd = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+	if ((fd >= 0) && (connect(fd, result->ai_addr, result->ai_addrlen) != 0)) {
+		close(fd);
+		fd = -1;
+	}
+	freeaddrinfo(result);
+	if (fd < 0) {
+		fprintf(stderr, "Could not connect to %s:%s.\n", host, port);
+		return -1;
+	}
+	const int one = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+	return fd;
+}
+
+/**
+ * @internal
+ * Sends a command line to the board, terminated as a Telnet client would.
+ *
+ * @param telnet int The Telnet socket.
+ * @param command const char* The command line, without its line ending.
+ * @retval bool TRUE if the command was sent.
+ */
+static bool SendCommand(int telnet, const char* command) {
+	char line[512];
+	const int length = snprintf(line, sizeof(line), "%s\r\n", command);
+	if ((length <= 0) || ((size_t) length >= sizeof(line))) {
+		fprintf(stderr, "Command is too long: %s\n", command);
+		return false;
+	}
+	return send(telnet, line, (size_t) length, 0) == length;
+}
+
+/**
+ * @internal
+ * Receives and decodes whatever arrives on the sockets, noting the arrival time of each read for the latencies,
+ * until the duration has passed or, if quiet is not 0, no data has arrived for that long.
+ *
+ * @param bench Benchmark_t* The benchmark run.
+ * @param telnet int The Telnet socket.
+ * @param data int The data connection or publish socket, or -1.
+ * @param transport Transport_t How the samples are received.
+ * @param duration uint64_t The longest time to receive for, in microseconds.
+ * @param quiet uint64_t The time without data after which to stop, 0 to receive for the whole duration.
+ * @retval uint64_t The number of bytes received.
+ */
+static uint64_t Pump(Benchmark_t* bench, int telnet, int data, Transport_t transport, uint64_t duration,
+		uint64_t quiet) {
+	static uint8_t buffer[READ_SIZE];
+	const uint64_t start = GetHostTime();
+	uint64_t lastData = start;
+	uint64_t received = 0U;
+	struct pollfd fds[2];
+	fds[0].fd = telnet;
+	fds[0].events = POLLIN;
+	fds[1].fd = data;
+	fds[1].events = POLLIN;
+	for (;;) {
+		const uint64_t now = GetHostTime();
+		if (((now - start) >= duration) || ((quiet != 0U) && ((now - lastData) >= quiet))) {
+			break;
+		}
+		if (poll(fds, (data >= 0) ? 2U : 1U, 10) <= 0) {
+			continue;
+		}
+		for (uint8_t i = 0U; i < ((data >= 0) ? 2U : 1U); ++i) {
+			if ((fds[i].revents & (POLLIN | POLLHUP | POLLERR)) == 0) {
+				continue;
+			}
+			const ssize_t length = recv(fds[i].fd, buffer, sizeof(buffer), 0);
+			if (length <= 0) {
+				fprintf(stderr, "The board closed the %s connection.\n", (i == 0U) ? "Telnet" : "data");
+				return received;
+			}
+			bench->arrival = GetHostTime();
+			lastData = bench->arrival;
+			received += (uint64_t) length;
+			if ((i == 1U) && (transport == TRANSPORT_UDP)) {
+				Receiver_FeedDatagram(&dataReceiver, buffer, (size_t) length);
+			} else {
+				Receiver_Feed((i == 0U) ? &telnetReceiver : &dataReceiver, buffer, (size_t) length);
+			}
+		}
+	}
+	return received;
+}
+
+/**
+ * @internal
+ * Compares two latencies for sorting in ascending order.
+ *
+ * @param a const void* Pointer to the first latency.
+ * @param b const void* Pointer to the second latency.
+ * @retval int Less than, equal to or greater than 0 as the first is less than, equal to or greater than the second.
+ */
+static int CompareLatency(const void* a, const void* b) {
+	const int64_t first = *(const int64_t*) a;
+	const int64_t second = *(const int64_t*) b;
+	return (first > second) - (first < second);
+}
+
+/**
+ * @internal
+ * Prints the throughput, latency percentiles and loss of the run.
+ *
+ * @param bench Benchmark_t* The benchmark run, whose latencies are sorted.
+ * @param transport Transport_t How the samples were received.
+ * @retval none
+ */
+static void Report(Benchmark_t* bench, Transport_t transport) {
+	const Tekdaqc_Receiver_t* receiver = (transport == TRANSPORT_TELNET) ? &telnetReceiver : &dataReceiver;
+	const Receiver_Counters_t* counters = Receiver_GetCounters(receiver);
+	const double seconds = (double) (bench->last - bench->first) / 1000000.0;
+	printf("Samples:          %" PRIu64 "\n", bench->samples);
+	if (seconds > 0.0) {
+		printf("Throughput:       %.1f samples/s, %.1f kB/s\n", (double) bench->samples / seconds,
+				(double) counters->bytes / seconds / 1000.0);
+	}
+	printf("Lost samples:     %" PRIu64 "\n", counters->lostSamples);
+	if (transport == TRANSPORT_UDP) {
+		printf("Datagrams:        %" PRIu64 ", %" PRIu64 " recovered, %" PRIu64 " lost\n", counters->datagrams,
+				counters->resentDatagrams, counters->lostDatagrams);
+	}
+	if (counters->discarded > 0U) {
+		printf("Undecoded bytes:  %" PRIu64 "\n", counters->discarded);
+	}
+	if (bench->latencyCount > 0U) {
+		qsort(bench->latencies, bench->latencyCount, sizeof(int64_t), CompareLatency);
+		const int64_t median = bench->latencies[bench->latencyCount / 2U];
+		const bool synchronized = (median > -SYNCHRONIZED_LIMIT_US) && (median < SYNCHRONIZED_LIMIT_US);
+		const int64_t base = (synchronized == true) ? 0 : bench->latencies[0];
+		static const double percentiles[] = { 50.0, 90.0, 99.0, 99.9 };
+		printf("Latency:          %s\n", (synchronized == true) ? "absolute, board clock synchronized"
+				: "relative to the smallest, board clock not synchronized");
+		for (size_t i = 0U; i < (sizeof(percentiles) / sizeof(percentiles[0])); ++i) {
+			const size_t index = (size_t) ((percentiles[i] / 100.0) * (double) (bench->latencyCount - 1U));
+			printf("  p%-5g          %.3f ms\n", percentiles[i], (double) (bench->latencies[index] - base) / 1000.0);
+		}
+		printf("  max             %.3f ms\n", (double) (bench->latencies[bench->latencyCount - 1U] - base) / 1000.0);
+	}
+	if (receiver->resumed == true) {
+		printf("Last log marker:  %" PRIu32 "\n", Receiver_GetMarker(receiver));
+	}
+	if (bench->failures > 0U) {
+		printf("Errors reported:  %" PRIu64 "\n", bench->failures);
+	}
+}
+
+/**
+ * @internal
+ * Prints how the program is used.
+ *
+ * @param program const char* The name the program was run as.
+ * @retval none
+ */
+static void Usage(const char* program) {
+	fprintf(stderr, "Usage: %s [options] <board address>\n"
+			"  -t <seconds>   Time to sample for, 10 by default.\n"
+			"  -m <transport> DATA (the default), TELNET or UDP.\n"
+			"  -e <encoding>  BINARY (the default) or COMPRESSED.\n"
+			"  -c <command>   A setup command sent before sampling, may be repeated.\n"
+			"  -s <command>   The command starting the sampling, SAMPLE --NUMBER=0 by default.\n"
+			"  -u <port>      The local port published datagrams are sent to, 9803 by default.\n"
+			"  -r <sequence>  Resume the sample log from the sequence number of the last marker received.\n"
+			"  -v             Print every message from the board.\n", program);
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Runs a benchmark of a board's sample stream, as described at the top of this file.
+ *
+ * @param argc int The number of arguments.
+ * @param argv char** The arguments.
+ * @retval int 0 if the run completed without errors from the board.
+ */
+int main(int argc, char** argv) {
+	Benchmark_t bench;
+	memset(&bench, 0, sizeof(bench));
+	bench.udp = -1;
+	Transport_t transport = TRANSPORT_DATA;
+	const char* encoding = "BINARY";
+	const char* sampleCommand = "SAMPLE --NUMBER=0";
+	const char* setup[MAX_SETUP_COMMANDS];
+	uint8_t setupCount = 0U;
+	double seconds = 10.0;
+	uint16_t udpPort = PUBLISH_PORT;
+	bool resume = false;
+	uint32_t resumeFrom = 0U;
+	int option;
+	while ((option = getopt(argc, argv, "t:m:e:c:s:u:r:v")) != -1) {
+		switch (option) {
+		case 't':
+			seconds = strtod(optarg, NULL);
+			break;
+		case 'm':
+			if (strcasecmp(optarg, "DATA") == 0) {
+				transport = TRANSPORT_DATA;
+			} else if (strcasecmp(optarg, "TELNET") == 0) {
+				transport = TRANSPORT_TELNET;
+			} else if (strcasecmp(optarg, "UDP") == 0) {
+				transport = TRANSPORT_UDP;
+			} else {
+				Usage(argv[0]);
+				return 2;
+			}
+			break;
+		case 'e':
+			encoding = optarg;
+			break;
+		case 'c':
+			if (setupCount == MAX_SETUP_COMMANDS) {
+				fprintf(stderr, "At most %u setup commands may be given.\n", MAX_SETUP_COMMANDS);
+				return 2;
+			}
+			setup[setupCount++] = optarg;
+			break;
+		case 's':
+			sampleCommand = optarg;
+			break;
+		case 'u':
+			udpPort = (uint16_t) strtoul(optarg, NULL, 10);
+			break;
+		case 'r':
+			resume = true;
+			resumeFrom = (uint32_t) strtoul(optarg, NULL, 10);
+			break;
+		case 'v':
+			bench.verbose = true;
+			break;
+		default:
+			Usage(argv[0]);
+			return 2;
+		}
+	}
+	if ((optind != (argc - 1)) || (seconds <= 0.0)) {
+		Usage(argv[0]);
+		return 2;
+	}
+	const char* host = argv[optind];
+	Receiver_Init(&telnetReceiver, OnEvent, &bench);
+	Receiver_Init(&dataReceiver, OnEvent, &bench);
+
+	const int telnet = ConnectTo(host, TELNET_PORT);
+	if (telnet < 0) {
+		return 1;
+	}
+	int data = -1;
+	char command[128];
+	if (transport == TRANSPORT_DATA) {
+		data = ConnectTo(host, DATA_PORT);
+		if (data < 0) {
+			return 1;
+		}
+	} else if (transport == TRANSPORT_UDP) {
+		/* Published to this host at the address the board sees it by */
+		struct sockaddr_in local;
+		socklen_t length = sizeof(local);
+		getsockname(telnet, (struct sockaddr*) &local, &length);
+		length = sizeof(bench.board);
+		getpeername(telnet, (struct sockaddr*) &bench.board, &length);
+		bench.board.sin_port = htons(PUBLISH_PORT);
+		data = socket(AF_INET, SOCK_DGRAM, 0);
+		struct sockaddr_in bound;
+		memset(&bound, 0, sizeof(bound));
+		bound.sin_family = AF_INET;
+		bound.sin_addr.s_addr = htonl(INADDR_ANY);
+		bound.sin_port = htons(udpPort);
+		const int size = 4 * 1024 * 1024;
+		setsockopt(data, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+		if ((data < 0) || (bind(data, (const struct sockaddr*) &bound, sizeof(bound)) != 0)) {
+			fprintf(stderr, "Could not bind UDP port %u.\n", udpPort);
+			return 1;
+		}
+		bench.udp = data;
+		snprintf(command, sizeof(command), "SET_PUBLISH --ADDRESS=%s --PORT=%u", inet_ntoa(local.sin_addr), udpPort);
+		SendCommand(telnet, command);
+	}
+
+	/* Set up, then give the board time to answer before the clock starts */
+	for (uint8_t i = 0U; i < setupCount; ++i) {
+		SendCommand(telnet, setup[i]);
+	}
+	snprintf(command, sizeof(command), "SET_DATA_FORMAT --FORMAT=%s", encoding);
+	SendCommand(telnet, command);
+	if (resume == true) {
+		Receiver_SetResumed((transport == TRANSPORT_TELNET) ? &telnetReceiver : &dataReceiver, resumeFrom);
+		snprintf(command, sizeof(command), "RESUME_SAMPLE_LOG --SEQUENCE=%" PRIu32, resumeFrom);
+		SendCommand(telnet, command);
+	}
+	Pump(&bench, telnet, data, transport, SETTLE_US, 0U);
+
+	bench.sampling = true;
+	SendCommand(telnet, sampleCommand);
+	Pump(&bench, telnet, data, transport, (uint64_t) (seconds * 1000000.0), 0U);
+	SendCommand(telnet, "HALT");
+	Pump(&bench, telnet, data, transport, DRAIN_MAX_US, DRAIN_QUIET_US);
+	if (transport == TRANSPORT_UDP) {
+		Receiver_FlushDatagrams(&dataReceiver);
+		SendCommand(telnet, "SET_PUBLISH --ADDRESS=NONE");
+		Pump(&bench, telnet, -1, transport, SETTLE_US, SETTLE_US);
+	}
+	close(telnet);
+	if (data >= 0) {
+		close(data);
+	}
+
+	Report(&bench, transport);
+	free(bench.latencies);
+	return (bench.failures == 0U) ? 0 : 1;
+}
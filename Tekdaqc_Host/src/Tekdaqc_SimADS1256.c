@@ -0,0 +1,944 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_SimADS1256.c
+ * @brief The simulated ADS1256 the acquisition firmware is run against by a host.
+ *
+ * Models the ADS1256 as the driver sees it over its SPI bus and pins, and stands in for ADS1256_SPI_Controller.c,
+ * whose SPI peripheral and DMA streams the host does not have:
+ *
+ *   - the command set, registers, continuous read mode and serial interface reset of the chip select;
+ *   - the conversion timing of each data rate, restarted by SYNC, WAKEUP, RESET, register writes and the SYNC and
+ *     RESET pins, with the settling time of the digital filter before the first conversion;
+ *   - the conversion of the mean voltage on the selected inputs over each conversion's window of time, through the
+ *     PGA and the calibration registers, and the self and system calibrations which set them;
+ *   - the DRDY output, which falls as each conversion completes and rises as it is read.
+ *
+ * Each byte takes its time on the bus at SIM_SPI_CLOCK_HZ, and is taken by the ADS1256 once it has been clocked. The
+ * DMA transfers are made the same way, the callback being called as the last byte is received, so the firmware does
+ * not run while they are made, which is the worst case for the program loop. The chip responds as soon as it is
+ * allowed to, the timing characteristics between commands being left to the driver's own delays.
+ *
+ * This is host code, built with the host's C99 compiler rather than as part of the firmware, see
+ * Tekdaqc_AcquisitionSim.c.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Sim.h"
+#include "ADS1256_Driver.h"
+#include "ADS1256_SPI_Controller.h"
+#include <math.h>
+#include <string.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def SIM_BYTE_NS
+ * @brief The time each byte takes on the bus, 8 bits of SCLK.
+ */
+#define SIM_BYTE_NS				((8000000000ULL + (SIM_SPI_CLOCK_HZ / 2U)) / SIM_SPI_CLOCK_HZ)
+
+/**
+ * @internal
+ * @def SIM_VREF
+ * @brief The ADS1256's reference voltage.
+ */
+#define SIM_VREF				2.5
+
+/**
+ * @internal
+ * @def SIM_MAX_CODE
+ * @brief The largest positive code of the ADS1256.
+ */
+#define SIM_MAX_CODE			0x7FFFFF
+
+/**
+ * @internal
+ * @def SIM_MIN_CODE
+ * @brief The largest negative code of the ADS1256.
+ */
+#define SIM_MIN_CODE			(-0x800000)
+
+/**
+ * @internal
+ * @def SIM_UNITY_GAIN
+ * @brief The gain calibration which leaves the conversions unscaled.
+ */
+#define SIM_UNITY_GAIN			0x400000
+
+/**
+ * @internal
+ * @def SIM_STATUS_DEFAULT
+ * @brief The status register out of reset, factory ID 3 in the upper bits and DRDY in the lowest.
+ */
+#define SIM_STATUS_DEFAULT		((uint8_t) 0x30U)
+
+/**
+ * @internal
+ * @def SIM_STATUS_WRITABLE
+ * @brief The bits of the status register which can be written, ORDER, ACAL and BUFEN.
+ */
+#define SIM_STATUS_WRITABLE		((uint8_t) 0x0EU)
+
+/**
+ * @internal
+ * @def SIM_NO_DATA
+ * @brief The data index when no conversion is being clocked out.
+ */
+#define SIM_NO_DATA				3U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief The states of the ADS1256's modulator.
+ */
+typedef enum {
+	SIM_CONVERTING, /**< Converting continuously. */
+	SIM_CALIBRATING, /**< Calibrating, converting again once done. */
+	SIM_SYNCED, /**< Halted by the SYNC command until the next byte is clocked. */
+	SIM_STANDBY, /**< Halted by the STANDBY command until WAKEUP. */
+	SIM_PIN_HALTED /**< Halted while the SYNC or RESET pin is held low. */
+} SimMode_t;
+
+/**
+ * @internal
+ * @brief The states of the ADS1256's command parser.
+ */
+typedef enum {
+	SIM_PARSE_COMMAND, /**< Waiting for a command. */
+	SIM_PARSE_COUNT, /**< Waiting for the count of a register read or write. */
+	SIM_PARSE_WRITE /**< Receiving the registers of a register write. */
+} SimParse_t;
+
+/**
+ * @internal
+ * @brief A data rate of the ADS1256 and the settling time of its digital filter.
+ */
+typedef struct {
+	uint8_t code; /**< The DRATE register value. */
+	double rate; /**< The data rate in samples per second. */
+	uint64_t settle; /**< The time from a restart to the first conversion in nanoseconds. */
+} SimRate_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The data rates and settling times of the datasheet's table 13 */
+static const SimRate_t RATES[] = {
+	{ 0xF0U, 30000.0, 210000U }, { 0xE0U, 15000.0, 250000U }, { 0xD0U, 7500.0, 310000U },
+	{ 0xC0U, 3750.0, 440000U }, { 0xB0U, 2000.0, 680000U }, { 0xA1U, 1000.0, 1180000U },
+	{ 0x92U, 500.0, 2180000U }, { 0x82U, 100.0, 10180000U }, { 0x72U, 60.0, 16840000U },
+	{ 0x63U, 50.0, 20180000U }, { 0x53U, 30.0, 33510000U }, { 0x43U, 25.0, 40180000U },
+	{ 0x33U, 15.0, 66840000U }, { 0x23U, 10.0, 100180000U }, { 0x13U, 5.0, 200180000U },
+	{ 0x03U, 2.5, 400180000U }
+};
+
+/* The registers of the ADS1256 */
+static uint8_t Registers[ADS1256_NREGS];
+
+/* The registers of a register write while they are received */
+static uint8_t Written[ADS1256_NREGS];
+
+/* The state of the modulator */
+static SimMode_t Mode = SIM_PIN_HALTED;
+
+/* The calibration made once the modulator is done calibrating */
+static uint8_t Calibration = 0U;
+
+/* The simulated time of the last restart of the conversions */
+static uint64_t RestartTime = 0U;
+
+/* The number of conversions completed since the last restart */
+static uint64_t ConversionIndex = 0U;
+
+/* The simulated time of the next conversion, or of the end of the calibration */
+static uint64_t NextTime = UINT64_MAX;
+
+/* The latest conversion */
+static int32_t Data = 0;
+
+/* TRUE while the latest conversion has not been clocked out */
+static bool Unread = false;
+
+/* TRUE if the latest conversion's input was switching while it was taken */
+static bool DataUnsettled = false;
+
+/* The next byte of the latest conversion to clock out, SIM_NO_DATA for none */
+static uint8_t DataIndex = SIM_NO_DATA;
+
+/* TRUE in continuous read mode */
+static bool Continuous = false;
+
+/* TRUE while the chip select is low */
+static bool Selected = false;
+
+/* The state of the command parser */
+static SimParse_t Parse = SIM_PARSE_COMMAND;
+
+/* The register read or write being parsed */
+static uint8_t RegisterCommand = 0U;
+
+/* The first register of the register read or write */
+static uint8_t RegisterFirst = 0U;
+
+/* The number of registers of the register read or write */
+static uint8_t RegisterCount = 0U;
+
+/* The registers of the register write received */
+static uint8_t RegisterIndex = 0U;
+
+/* The bytes waiting to be clocked out */
+static uint8_t Output[ADS1256_NREGS];
+
+/* The number of bytes waiting to be clocked out */
+static uint8_t OutputLength = 0U;
+
+/* The next byte to be clocked out */
+static uint8_t OutputIndex = 0U;
+
+/* What has been counted since the chip was powered up */
+static SimADS1256_Counters_t Counters;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Restores the registers to their defaults.
+ */
+static void ResetRegisters(void);
+
+/**
+ * @internal
+ * @brief Retrieves the data rate the DRATE register selects.
+ */
+static const SimRate_t* GetRate(void);
+
+/**
+ * @internal
+ * @brief Retrieves the PGA gain the ADCON register selects.
+ */
+static uint8_t GetGain(void);
+
+/**
+ * @internal
+ * @brief Restarts the conversions from the current simulated time.
+ */
+static void Restart(void);
+
+/**
+ * @internal
+ * @brief Starts a calibration from the current simulated time.
+ */
+static void StartCalibration(uint8_t command);
+
+/**
+ * @internal
+ * @brief Halts the modulator.
+ */
+static void Halt(SimMode_t mode);
+
+/**
+ * @internal
+ * @brief Retrieves the code of the selected inputs over a window of simulated time before the calibration registers.
+ */
+static int32_t MeasureWindow(uint64_t start, uint64_t end, bool* unsettled);
+
+/**
+ * @internal
+ * @brief Completes the conversion or calibration due at the current simulated time.
+ */
+static void Complete(void);
+
+/**
+ * @internal
+ * @brief Sets the level of the DRDY output.
+ */
+static void SetDataReady(bool high);
+
+/**
+ * @internal
+ * @brief Applies the registers of a register write.
+ */
+static void ApplyWrite(void);
+
+/**
+ * @internal
+ * @brief Takes a byte clocked in, returning the byte clocked out.
+ */
+static uint8_t ClockByte(uint8_t in);
+
+/**
+ * @internal
+ * @brief Takes a command byte.
+ */
+static void TakeCommand(uint8_t command);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * Restores the registers to their defaults: AIN0 against AIN1, unity gain, 30000 SPS and unity calibration.
+ *
+ * @param none
+ * @retval none
+ */
+static void ResetRegisters(void) {
+	memset(Registers, 0, sizeof(Registers));
+	Registers[ADS1256_STATUS] = SIM_STATUS_DEFAULT;
+	Registers[ADS1256_MUX] = 0x01U;
+	Registers[ADS1256_ADCON] = 0x20U;
+	Registers[ADS1256_DRATE] = 0xF0U;
+	Registers[ADS1256_IO] = 0xE0U;
+	Registers[ADS1256_FSC2] = (uint8_t) (SIM_UNITY_GAIN >> 16U);
+}
+
+/**
+ * @internal
+ * Retrieves the data rate the DRATE register selects. The codes outside of the datasheet's are taken as 30000 SPS.
+ *
+ * @param none
+ * @retval const SimRate_t* The data rate.
+ */
+static const SimRate_t* GetRate(void) {
+	for (uint_fast8_t i = 0U; i < (sizeof(RATES) / sizeof(RATES[0])); ++i) {
+		if (RATES[i].code == Registers[ADS1256_DRATE]) {
+			return &RATES[i];
+		}
+	}
+	return &RATES[0];
+}
+
+/**
+ * @internal
+ * Retrieves the PGA gain the ADCON register selects, the codes above 64x also selecting 64x.
+ *
+ * @param none
+ * @retval uint8_t The gain.
+ */
+static uint8_t GetGain(void) {
+	uint8_t code = (uint8_t) ((Registers[ADS1256_ADCON] >> ADS1256_PGA_BIT) & 0x07U);
+	if (code > (uint8_t) ADS1256_PGAx64) {
+		code = (uint8_t) ADS1256_PGAx64;
+	}
+	return (uint8_t) (1U << code);
+}
+
+/**
+ * @internal
+ * Restarts the conversions from the current simulated time, the first completing once the digital filter settles.
+ * The conversion left in the output register is no longer counted as missed when it is replaced.
+ *
+ * @param none
+ * @retval none
+ */
+static void Restart(void) {
+	Mode = SIM_CONVERTING;
+	RestartTime = Sim_GetTime();
+	ConversionIndex = 0U;
+	NextTime = RestartTime + GetRate()->settle;
+	Unread = false;
+	SetDataReady(true);
+	++Counters.restarts;
+}
+
+/**
+ * @internal
+ * Starts a calibration from the current simulated time. A self calibration takes two settling times and the
+ * others a single one, after which the conversions continue from the end of the calibration.
+ *
+ * @param command uint8_t The calibration command.
+ * @retval none
+ */
+static void StartCalibration(uint8_t command) {
+	const uint64_t settle = GetRate()->settle;
+	Mode = SIM_CALIBRATING;
+	Calibration = command;
+	RestartTime = Sim_GetTime();
+	NextTime = RestartTime + ((command == (uint8_t) ADS1256_SELFCAL) ? (2U * settle) : settle);
+	Unread = false;
+	SetDataReady(true);
+}
+
+/**
+ * @internal
+ * Halts the modulator, leaving the last conversion in the output register.
+ *
+ * @param mode SimMode_t The halted state to enter.
+ * @retval none
+ */
+static void Halt(SimMode_t mode) {
+	Mode = mode;
+	NextTime = UINT64_MAX;
+}
+
+/**
+ * @internal
+ * Retrieves the code the mean differential voltage on the selected inputs over a window of simulated time converts
+ * to, before the calibration registers are applied.
+ *
+ * @param start uint64_t The start of the window in nanoseconds.
+ * @param end uint64_t The end of the window in nanoseconds.
+ * @param unsettled bool* Set to TRUE if the external multiplexer was switching during the window.
+ * @retval int32_t The code.
+ */
+static int32_t MeasureWindow(uint64_t start, uint64_t end, bool* unsettled) {
+	uint8_t switching = 0U;
+	const uint8_t pos = (uint8_t) (Registers[ADS1256_MUX] >> 4U);
+	const uint8_t neg = (uint8_t) (Registers[ADS1256_MUX] & 0x0FU);
+	const double volts = SimBoard_GetAinVoltage(pos, start, end, &switching)
+			- SimBoard_GetAinVoltage(neg, start, end, &switching);
+	*unsettled = (switching != 0U);
+	return SimADS1256_IdealCode(volts, GetGain());
+}
+
+/**
+ * @internal
+ * Completes the conversion or calibration due at the current simulated time. A conversion is taken over the time
+ * since the digital filter last settled, or since the restart for the first, and offset and scaled by the
+ * calibration registers. DRDY is pulsed high and left low, so that each conversion gives a falling edge.
+ *
+ * @param none
+ * @retval none
+ */
+static void Complete(void) {
+	const uint64_t now = Sim_GetTime();
+	const SimRate_t* rate = GetRate();
+	const int32_t offset = (int32_t) (((uint32_t) Registers[ADS1256_OFC2] << 24U)
+			| ((uint32_t) Registers[ADS1256_OFC1] << 16U) | ((uint32_t) Registers[ADS1256_OFC0] << 8U)) >> 8;
+	const int64_t gain = ((int64_t) Registers[ADS1256_FSC2] << 16U) | ((int64_t) Registers[ADS1256_FSC1] << 8U)
+			| (int64_t) Registers[ADS1256_FSC0];
+	if (Mode == SIM_CALIBRATING) {
+		bool unsettled = false;
+		Mode = SIM_CONVERTING;
+		if ((Calibration == (uint8_t) ADS1256_SELFCAL) || (Calibration == (uint8_t) ADS1256_SELFOCAL)) {
+			Registers[ADS1256_OFC0] = Registers[ADS1256_OFC1] = Registers[ADS1256_OFC2] = 0U;
+		}
+		if ((Calibration == (uint8_t) ADS1256_SELFCAL) || (Calibration == (uint8_t) ADS1256_SELFGCAL)) {
+			Registers[ADS1256_FSC0] = Registers[ADS1256_FSC1] = 0U;
+			Registers[ADS1256_FSC2] = (uint8_t) (SIM_UNITY_GAIN >> 16U);
+		}
+		if (Calibration == (uint8_t) ADS1256_SYSOCAL) {
+			const uint32_t code = (uint32_t) MeasureWindow(RestartTime, now, &unsettled);
+			Registers[ADS1256_OFC0] = (uint8_t) code;
+			Registers[ADS1256_OFC1] = (uint8_t) (code >> 8U);
+			Registers[ADS1256_OFC2] = (uint8_t) (code >> 16U);
+		}
+		if (Calibration == (uint8_t) ADS1256_SYSGCAL) {
+			const int64_t span = (int64_t) MeasureWindow(RestartTime, now, &unsettled) - offset;
+			if (span > 0) {
+				const uint32_t code = (uint32_t) (((int64_t) SIM_MAX_CODE * SIM_UNITY_GAIN) / span);
+				Registers[ADS1256_FSC0] = (uint8_t) code;
+				Registers[ADS1256_FSC1] = (uint8_t) (code >> 8U);
+				Registers[ADS1256_FSC2] = (uint8_t) (code >> 16U);
+			}
+		}
+		/* The conversions continue as though they had been restarted a settling time before the end */
+		RestartTime = now - rate->settle;
+		ConversionIndex = 0U;
+	}
+	const uint64_t settled = now - rate->settle;
+	const uint64_t start = (settled > RestartTime) ? settled : RestartTime;
+	bool unsettled = false;
+	const int64_t ideal = MeasureWindow(start, now, &unsettled);
+	int64_t code = ((ideal - offset) * gain) / SIM_UNITY_GAIN;
+	if (code > SIM_MAX_CODE) {
+		code = SIM_MAX_CODE;
+	} else if (code < SIM_MIN_CODE) {
+		code = SIM_MIN_CODE;
+	}
+	if (Unread == true) {
+		++Counters.missed;
+	}
+	Data = (int32_t) code;
+	DataUnsettled = unsettled;
+	Unread = true;
+	if (Continuous == true) {
+		DataIndex = 0U;
+	}
+	++Counters.conversions;
+	++ConversionIndex;
+	NextTime = RestartTime + rate->settle + (uint64_t) llround((double) ConversionIndex * (1.0e9 / rate->rate));
+	SetDataReady(true);
+	SetDataReady(false);
+}
+
+/**
+ * @internal
+ * Sets the level of the DRDY output, on its pin and in the status register.
+ *
+ * @param high bool TRUE while no conversion is ready.
+ * @retval none
+ */
+static void SetDataReady(bool high) {
+	Registers[ADS1256_STATUS] = (uint8_t) ((Registers[ADS1256_STATUS] & 0xFEU) | ((high == true) ? 1U : 0U));
+	SimBoard_SetDataReady((high == true) ? 1U : 0U);
+}
+
+/**
+ * @internal
+ * Applies the registers of a register write. Writing the status, multiplexer, converter control or data rate
+ * registers restarts the conversions, or with auto-calibration enabled, changing the buffer, gain or data rate
+ * starts a self calibration.
+ *
+ * @param none
+ * @retval none
+ */
+static void ApplyWrite(void) {
+	const uint8_t status = Registers[ADS1256_STATUS];
+	const uint8_t adcon = Registers[ADS1256_ADCON];
+	const uint8_t drate = Registers[ADS1256_DRATE];
+	bool restart = false;
+	for (uint_fast8_t i = 0U; i < RegisterCount; ++i) {
+		const uint8_t reg = (uint8_t) (RegisterFirst + i);
+		if (reg == (uint8_t) ADS1256_STATUS) {
+			Registers[reg] = (uint8_t) ((Registers[reg] & (uint8_t) ~SIM_STATUS_WRITABLE)
+					| (Written[i] & SIM_STATUS_WRITABLE));
+		} else {
+			Registers[reg] = Written[i];
+		}
+		if (reg <= (uint8_t) ADS1256_DRATE) {
+			restart = true;
+		}
+	}
+	if (restart == false) {
+		return;
+	}
+	const uint8_t acal = (uint8_t) (1U << ADS1256_ACAL_BIT);
+	const uint8_t bufen = (uint8_t) (1U << ADS1256_BUFFEN_BIT);
+	if (((Registers[ADS1256_STATUS] & acal) != 0U) && ((((status ^ Registers[ADS1256_STATUS]) & bufen) != 0U)
+			|| (((adcon ^ Registers[ADS1256_ADCON]) & 0x07U) != 0U) || (drate != Registers[ADS1256_DRATE]))) {
+		StartCalibration((uint8_t) ADS1256_SELFCAL);
+	} else {
+		Restart();
+	}
+}
+
+/**
+ * @internal
+ * Takes a byte clocked in while the chip is selected, returning the byte clocked out with it. Bytes waiting to be
+ * clocked out are sent before any further command is taken, but for SDATAC and RESET in continuous read mode.
+ *
+ * @param in uint8_t The byte clocked in.
+ * @retval uint8_t The byte clocked out.
+ */
+static uint8_t ClockByte(uint8_t in) {
+	++Counters.bytes;
+	if (Mode == SIM_SYNCED) {
+		/* The SYNC command completes on the first clock of the next byte */
+		Restart();
+	}
+	if (Continuous == true) {
+		if ((in == (uint8_t) ADS1256_SDATAC) || (in == (uint8_t) ADS1256_RESET)) {
+			TakeCommand(in);
+			return 0U;
+		}
+	}
+	if (OutputIndex < OutputLength) {
+		return Output[OutputIndex++];
+	}
+	if (DataIndex < SIM_NO_DATA) {
+		if (DataIndex == 0U) {
+			++Counters.reads;
+			if (DataUnsettled == true) {
+				++Counters.unsettled;
+			}
+			Unread = false;
+			SetDataReady(true);
+		}
+		const uint8_t out = (uint8_t) ((uint32_t) Data >> (8U * (2U - DataIndex)));
+		++DataIndex;
+		return out;
+	}
+	if (Continuous == true) {
+		return 0U;
+	}
+	switch (Parse) {
+	case SIM_PARSE_COMMAND:
+		TakeCommand(in);
+		break;
+	case SIM_PARSE_COUNT:
+		RegisterCount = (uint8_t) ((in & 0x0FU) + 1U);
+		if ((RegisterFirst + RegisterCount) > ADS1256_NREGS) {
+			RegisterCount = (uint8_t) (ADS1256_NREGS - RegisterFirst);
+		}
+		if (RegisterCommand == (uint8_t) ADS1256_RREG) {
+			memcpy(Output, &Registers[RegisterFirst], RegisterCount);
+			OutputLength = RegisterCount;
+			OutputIndex = 0U;
+			Parse = SIM_PARSE_COMMAND;
+		} else {
+			RegisterIndex = 0U;
+			Parse = (RegisterCount > 0U) ? SIM_PARSE_WRITE : SIM_PARSE_COMMAND;
+		}
+		break;
+	case SIM_PARSE_WRITE:
+		Written[RegisterIndex++] = in;
+		if (RegisterIndex >= RegisterCount) {
+			Parse = SIM_PARSE_COMMAND;
+			ApplyWrite();
+		}
+		break;
+	default:
+		Parse = SIM_PARSE_COMMAND;
+		break;
+	}
+	return 0U;
+}
+
+/**
+ * @internal
+ * Takes a command byte.
+ *
+ * @param command uint8_t The command.
+ * @retval none
+ */
+static void TakeCommand(uint8_t command) {
+	++Counters.commands;
+	if ((command & 0xF0U) == (uint8_t) ADS1256_RREG) {
+		RegisterCommand = (uint8_t) ADS1256_RREG;
+		RegisterFirst = (uint8_t) (command & 0x0FU);
+		Parse = (RegisterFirst < ADS1256_NREGS) ? SIM_PARSE_COUNT : SIM_PARSE_COMMAND;
+		return;
+	}
+	if ((command & 0xF0U) == (uint8_t) ADS1256_WREG) {
+		RegisterCommand = (uint8_t) ADS1256_WREG;
+		RegisterFirst = (uint8_t) (command & 0x0FU);
+		Parse = (RegisterFirst < ADS1256_NREGS) ? SIM_PARSE_COUNT : SIM_PARSE_COMMAND;
+		return;
+	}
+	switch (command) {
+	case ADS1256_WAKEUP:
+	case 0xFFU: /* The alternative WAKEUP */
+		if (Mode == SIM_STANDBY) {
+			Restart();
+		}
+		break;
+	case ADS1256_RDATA:
+		DataIndex = 0U;
+		break;
+	case ADS1256_RDATAC:
+		Continuous = true;
+		DataIndex = 0U;
+		break;
+	case ADS1256_SDATAC:
+		Continuous = false;
+		DataIndex = SIM_NO_DATA;
+		break;
+	case ADS1256_SELFCAL:
+	case ADS1256_SELFOCAL:
+	case ADS1256_SELFGCAL:
+	case ADS1256_SYSOCAL:
+	case ADS1256_SYSGCAL:
+		StartCalibration(command);
+		break;
+	case ADS1256_SYNC:
+		Halt(SIM_SYNCED);
+		break;
+	case ADS1256_STANDBY:
+		Halt(SIM_STANDBY);
+		break;
+	case ADS1256_RESET:
+		Continuous = false;
+		DataIndex = SIM_NO_DATA;
+		ResetRegisters();
+		Restart();
+		break;
+	default:
+		/* Not a command */
+		break;
+	}
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Powers up the simulated ADS1256, its registers at their defaults and converting, and clears its counters.
+ *
+ * @param none
+ * @retval none
+ */
+void SimADS1256_PowerUp(void) {
+	memset(&Counters, 0, sizeof(Counters));
+	ResetRegisters();
+	Continuous = false;
+	DataIndex = SIM_NO_DATA;
+	OutputLength = OutputIndex = 0U;
+	Parse = SIM_PARSE_COMMAND;
+	Selected = false;
+	Restart();
+}
+
+/**
+ * Called as the ADS1256's chip select changes. Deselecting the chip resets its serial interface, abandoning any
+ * command or output in progress but for continuous read mode, where selecting it again clocks out the latest
+ * conversion from its start.
+ *
+ * @param level uint8_t The level of the pin, 0 for selected.
+ * @retval none
+ */
+void SimADS1256_SetChipSelect(uint8_t level) {
+	Selected = (level == 0U);
+	if (Selected == false) {
+		Parse = SIM_PARSE_COMMAND;
+		OutputLength = OutputIndex = 0U;
+		if (Continuous == false) {
+			DataIndex = SIM_NO_DATA;
+		}
+	} else if ((Continuous == true) && (Unread == true)) {
+		DataIndex = 0U;
+	}
+}
+
+/**
+ * Called as the ADS1256's SYNC/PDWN pin changes. Taking it low halts the conversions and its rising edge restarts
+ * them. Holding it low long enough to power the chip down is not modeled.
+ *
+ * @param level uint8_t The level of the pin.
+ * @retval none
+ */
+void SimADS1256_SetSyncPin(uint8_t level) {
+	if (level == 0U) {
+		Halt(SIM_PIN_HALTED);
+	} else {
+		Restart();
+	}
+}
+
+/**
+ * Called as the ADS1256's RESET pin changes. Taking it low resets the chip and halts it, and its rising edge
+ * restarts the conversions.
+ *
+ * @param level uint8_t The level of the pin.
+ * @retval none
+ */
+void SimADS1256_SetResetPin(uint8_t level) {
+	if (level == 0U) {
+		ResetRegisters();
+		Continuous = false;
+		DataIndex = SIM_NO_DATA;
+		OutputLength = OutputIndex = 0U;
+		Parse = SIM_PARSE_COMMAND;
+		Halt(SIM_PIN_HALTED);
+	} else {
+		Restart();
+	}
+}
+
+/**
+ * Retrieves the simulated time of the next conversion or of the end of a calibration.
+ *
+ * @param none
+ * @retval uint64_t The simulated time in nanoseconds, UINT64_MAX while halted.
+ */
+uint64_t SimADS1256_GetNextEvent(void) {
+	return NextTime;
+}
+
+/**
+ * Completes the conversions and the calibration which are due at the current simulated time.
+ *
+ * @param none
+ * @retval none
+ */
+void SimADS1256_Process(void) {
+	while (Sim_GetTime() >= NextTime) {
+		Complete();
+	}
+}
+
+/**
+ * Retrieves what the simulated ADS1256 counted since it was powered up.
+ *
+ * @param counters SimADS1256_Counters_t* Filled with the counters.
+ * @retval none
+ */
+void SimADS1256_GetCounters(SimADS1256_Counters_t* counters) {
+	*counters = Counters;
+}
+
+/**
+ * Retrieves the code the ADS1256 converts a differential voltage to with its calibration registers at unity,
+ * clamped to its range.
+ *
+ * @param volts double The differential voltage.
+ * @param gain uint8_t The PGA gain, 1 to 64.
+ * @retval int32_t The code.
+ */
+int32_t SimADS1256_IdealCode(double volts, uint8_t gain) {
+	const double code = round((volts * (double) gain / (2.0 * SIM_VREF)) * (double) SIM_MAX_CODE);
+	if (code > (double) SIM_MAX_CODE) {
+		return SIM_MAX_CODE;
+	} else if (code < (double) SIM_MIN_CODE) {
+		return SIM_MIN_CODE;
+	}
+	return (int32_t) code;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* SPI CONTROLLER */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Initializes the ADS1256 connection. The simulated bus needs no setting up.
+ *
+ * @param none
+ * @retval none
+ */
+void ADS1256_SPI_Init(void) {
+}
+
+/**
+ * De-initializes the ADS1256 connection. The simulated bus needs no tearing down.
+ *
+ * @param none
+ * @retval none
+ */
+void ADS1256_SPI_DeInit(void) {
+}
+
+/**
+ * Switches the SPI clock pin to GPIO control. The simulated chip does not see the clock reset sequence.
+ *
+ * @param none
+ * @retval none
+ */
+void ADS1256_CLK_To_GPIO(void) {
+}
+
+/**
+ * Switches the SPI clock pin back to SPI control.
+ *
+ * @param none
+ * @retval none
+ */
+void ADS1256_GPIO_To_CLK(void) {
+}
+
+/**
+ * Sends a byte over the SPI line, taking the byte's time on the bus. A byte clocked while the chip is not selected
+ * is not seen by it.
+ *
+ * @param data uint8_t The byte to send.
+ * @retval uint8_t The byte received.
+ */
+uint8_t ADS1256_SendByte(uint8_t data) {
+	Sim_Advance(SIM_BYTE_NS);
+	return (Selected == true) ? ClockByte(data) : 0U;
+}
+
+/**
+ * Sends an array of bytes over the SPI line.
+ *
+ * @param data uint8_t* The bytes to send.
+ * @param n uint8_t The number of bytes.
+ * @retval none
+ */
+void ADS1256_SendBytes(uint8_t* data, uint8_t n) {
+	for (uint_fast8_t i = 0U; i < n; ++i) {
+		ADS1256_SendByte(data[i]);
+	}
+}
+
+/**
+ * Receives a byte over the SPI line, sending the dummy byte.
+ *
+ * @param none
+ * @retval uint8_t The byte received.
+ */
+uint8_t ADS1256_ReceiveByte(void) {
+	return ADS1256_SendByte(ADS1256_DUMMY_BYTE);
+}
+
+/**
+ * Receives an array of bytes over the SPI line.
+ *
+ * @param data uint8_t* Filled with the bytes received.
+ * @param n uint8_t The number of bytes.
+ * @retval none
+ */
+void ADS1256_ReceiveBytes(uint8_t* data, uint8_t n) {
+	for (uint_fast8_t i = 0U; i < n; ++i) {
+		data[i] = ADS1256_ReceiveByte();
+	}
+}
+
+/**
+ * Makes a full duplex transfer over the SPI line as the DMA engine would, calling the callback as the last byte is
+ * received, from the context of the caller.
+ *
+ * @param tx uint8_t* The bytes to send, NULL for the dummy byte.
+ * @param rx uint8_t* Filled with the bytes received, NULL to discard them.
+ * @param n uint8_t The number of bytes.
+ * @param callback ADS1256_SPI_TransferCallback The function to notify once done, may be NULL.
+ * @retval bool TRUE, the simulated bus is never busy.
+ */
+bool ADS1256_TransferBytes_DMA(uint8_t* tx, uint8_t* rx, uint8_t n, ADS1256_SPI_TransferCallback callback) {
+	for (uint_fast8_t i = 0U; i < n; ++i) {
+		const uint8_t in = ADS1256_SendByte((tx != NULL) ? tx[i] : ADS1256_DUMMY_BYTE);
+		if (rx != NULL) {
+			rx[i] = in;
+		}
+	}
+	if (callback != NULL) {
+		callback(rx, n);
+	}
+	return true;
+}
+
+/**
+ * Checks if a DMA transfer is in progress, which a simulated one never is once started.
+ *
+ * @param none
+ * @retval bool FALSE.
+ */
+bool ADS1256_SPI_IsBusy(void) {
+	return false;
+}
+
+/**
+ * Waits until any DMA transfer has completed, which a simulated one always has.
+ *
+ * @param none
+ * @retval none
+ */
+void ADS1256_SPI_WaitForTransfer(void) {
+}
+
+/**
+ * Handles the SPI receive DMA stream's interrupt, which the simulated transfers do not raise.
+ *
+ * @param none
+ * @retval none
+ */
+void ADS1256_SPI_DMA_IRQHandler(void) {
+}
@@ -0,0 +1,1156 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_SimBoard.c
+ * @brief The simulated board the acquisition firmware is run on by a host.
+ *
+ * Stands in for the parts of the board which the acquisition firmware reaches through the peripheral library and
+ * the timers module, so that ADC_StateMachine.c, Analog_Input.c and the ADS1256 driver run unchanged on a host:
+ *
+ *   - the simulated clock, its event loop and the interrupts of TIM3, TIM6 and the DRDY line's EXTI line;
+ *   - the peripheral library functions they use, on the peripheral registers mapped into host memory at their
+ *     addresses, with the semantics of the hardware where plain memory would differ, as for the flags which are
+ *     cleared by writing to them;
+ *   - the delays, local time and deadlines of Tekdaqc_Timers.c, whose time base is a counter the host can not run;
+ *   - the pins of the ADS1256, passed on to Tekdaqc_SimADS1256.c, and the external multiplexer and analog front
+ *     end, which give the voltage on each ADS1256 input over any window of time.
+ *
+ * The firmware only takes simulated time where it touches the hardware: its delays, its SPI transfers, its reads of
+ * the DRDY pin and what the program loop charges for each of its passes. Interrupts are taken when the event loop
+ * reaches the time at which they are raised, in the order of their vectors as they share a priority, so they are
+ * also only taken at those points. NVIC masking is not modeled, none of the firmware's critical sections touching
+ * the hardware.
+ *
+ * This is host code, built with the host's C99 compiler rather than as part of the firmware, see
+ * Tekdaqc_AcquisitionSim.c. It maps the peripheral addresses, so it needs a 64 bit POSIX host where they are free.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* mmap()'s anonymous mappings are not part of POSIX */
+#define _DEFAULT_SOURCE
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Sim.h"
+#include "Tekdaqc_Config.h"
+#include "Tekdaqc_Timers.h"
+#include "ADS1256_Driver.h"
+#include "ADC_StateMachine.h"
+#include "AnalogInput_Multiplexer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def SIM_PERIPH_SIZE
+ * @brief The span of the APB and AHB1 peripherals mapped from PERIPH_BASE, up to and including the DMA controllers.
+ */
+#define SIM_PERIPH_SIZE				0x80000U
+
+/**
+ * @internal
+ * @def SIM_CORE_BASE
+ * @brief The start of the Cortex-M4 private peripherals, the DWT, NVIC and SCB among them.
+ */
+#define SIM_CORE_BASE				0xE0000000UL
+
+/**
+ * @internal
+ * @def SIM_CORE_SIZE
+ * @brief The span of the Cortex-M4 private peripherals mapped from SIM_CORE_BASE.
+ */
+#define SIM_CORE_SIZE				0x10000U
+
+/**
+ * @internal
+ * @def SIM_CCM_FREE_SIZE
+ * @brief The size of the free CCM RAM the firmware finds between _sccmfree and _eccmfree.
+ */
+#define SIM_CCM_FREE_SIZE			32768U
+
+/**
+ * @internal
+ * @def SIM_IRQ_LATENCY_NS
+ * @brief The time from an interrupt being raised to its handler running, the 12 cycles of exception entry.
+ */
+#define SIM_IRQ_LATENCY_NS			72U
+
+/**
+ * @internal
+ * @def SIM_PIN_READ_NS
+ * @brief The time charged for each read of an input pin, so that polling a pin lets time pass.
+ */
+#define SIM_PIN_READ_NS				60U
+
+/**
+ * @internal
+ * @def SIM_MAX_TAIL_CHAIN
+ * @brief The most interrupts taken back to back before the simulation gives up on a handler which does not clear
+ * its flag.
+ */
+#define SIM_MAX_TAIL_CHAIN			100000U
+
+/**
+ * @internal
+ * @def SIM_MUX_HISTORY
+ * @brief The number of switches of the external multiplexer remembered, enough to cover the longest conversion.
+ */
+#define SIM_MUX_HISTORY				256U
+
+/**
+ * @internal
+ * @def SIM_VOLTAGE_POINTS
+ * @brief The number of points a conversion window is averaged over.
+ */
+#define SIM_VOLTAGE_POINTS			64U
+
+/**
+ * @internal
+ * @def SIM_DEFAULT_MUX_SETTLE_NS
+ * @brief The default time the external multiplexer takes to conduct its new input.
+ */
+#define SIM_DEFAULT_MUX_SETTLE_NS	1000U
+
+/**
+ * @internal
+ * @def SIM_TIMER_COUNT
+ * @brief The number of simulated timers, TIM3 and TIM6.
+ */
+#define SIM_TIMER_COUNT				2U
+
+/**
+ * @internal
+ * @def SIM_STRINGIFY
+ * @brief Expands its argument and makes a string of it, for the CCM symbols' assembly.
+ */
+#define SIM_STRINGIFY(X)			SIM_STRINGIFY_(X)
+#define SIM_STRINGIFY_(X)			#X
+
+/* Expands an EXTERNAL_MUX_TABLE entry to the select line code of its input */
+#define SIM_MUX_CODE(INPUT, CODE)	(uint16_t) (CODE),
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief The state of a simulated timer's counter. The counter is kept as a count of ticks since it was last
+ * started, so that it never drifts from the simulated clock, and written back to CNT as it advances.
+ */
+typedef struct {
+	TIM_TypeDef* tim; /**< The timer's registers. */
+	void (*handler)(void); /**< The firmware's handler of its interrupt. */
+	bool running; /**< TRUE while the counter counts. */
+	uint64_t base; /**< The simulated time at which the counter was started. */
+	uint64_t start; /**< The count it was started at. */
+	uint64_t position; /**< The count since it was started, the start included, it has advanced to. */
+	uint32_t cnt; /**< CNT as last written back, to see the firmware writing it. */
+	uint32_t psc; /**< PSC as last seen. */
+	uint32_t arr; /**< ARR as last seen. */
+} SimTimer_t;
+
+/**
+ * @internal
+ * @brief A switch of the external multiplexer.
+ */
+typedef struct {
+	uint64_t time; /**< The simulated time of the switch. */
+	uint8_t input; /**< The input switched to. */
+	uint8_t previous; /**< The input switched from. */
+} SimMuxSwitch_t;
+
+/**
+ * @internal
+ * @brief A deadline scheduled through Timer_ScheduleDeadline().
+ */
+typedef struct {
+	DeadlineCallback callback; /**< The function to call, NULL for a free slot. */
+	uint64_t due; /**< The local time at which it is called. */
+} SimDeadline_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The simulated time in nanoseconds */
+static uint64_t SimTime = 0U;
+
+/* The number of interrupt handlers running, which the event loop does not take further interrupts within */
+static uint32_t InterruptDepth = 0U;
+
+/* The simulated timers */
+static SimTimer_t Timers[SIM_TIMER_COUNT];
+
+/* The deadlines of the timers module */
+static SimDeadline_t Deadlines[TIMER_DEADLINE_COUNT];
+
+/* The select line codes of the external inputs, in their order */
+static const uint16_t MUX_CODES[] = { EXTERNAL_MUX_TABLE(SIM_MUX_CODE) };
+
+/* The recent switches of the external multiplexer, oldest first from MuxSwitchCount */
+static SimMuxSwitch_t MuxSwitches[SIM_MUX_HISTORY];
+
+/* The number of switches of the external multiplexer made */
+static uint32_t MuxSwitchCount = 0U;
+
+/* The time the external multiplexer takes to conduct in nanoseconds */
+static uint32_t MuxSettleTime = SIM_DEFAULT_MUX_SETTLE_NS;
+
+/* The voltages applied to the external inputs */
+static double ExternalVoltages[SIM_EXTERNAL_COUNT];
+
+/* The voltages on the ADS1256 inputs, but for AIN0 which follows the external multiplexer */
+static double AinVoltages[SIM_AIN_COUNT];
+
+/* The free CCM RAM, found by the firmware through the linker script's symbols */
+static uint8_t SimCcmFree[SIM_CCM_FREE_SIZE] __attribute__ ((used, aligned (4)));
+
+/* The linker script's symbols bounding the free CCM RAM */
+__asm__ (".globl _sccmfree\n\t.set _sccmfree, SimCcmFree\n\t"
+		".globl _eccmfree\n\t.set _eccmfree, SimCcmFree + " SIM_STRINGIFY(SIM_CCM_FREE_SIZE));
+
+/* The core clock, set by SystemInit() on the board */
+uint32_t SystemCoreClock = SIM_CORE_CLOCK_HZ;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Maps a span of the device's address space into host memory.
+ */
+static void MapRegion(uintptr_t address, size_t size);
+
+/**
+ * @internal
+ * @brief Sets the simulated time, keeping the DWT cycle counter in step.
+ */
+static void SetTime(uint64_t time);
+
+/**
+ * @internal
+ * @brief Retrieves the simulated timer of a timer's registers.
+ */
+static SimTimer_t* FindTimer(TIM_TypeDef* tim);
+
+/**
+ * @internal
+ * @brief Retrieves the simulated time at which a timer's counter reaches a count.
+ */
+static uint64_t TimerTimeOf(const SimTimer_t* timer, uint64_t count);
+
+/**
+ * @internal
+ * @brief Advances a timer's counter to the simulated time, raising its flags.
+ */
+static void TimerAdvance(SimTimer_t* timer);
+
+/**
+ * @internal
+ * @brief Picks up what the firmware wrote to a timer's registers directly.
+ */
+static void TimerReconcile(SimTimer_t* timer);
+
+/**
+ * @internal
+ * @brief Retrieves the simulated time of a timer's next event which matters, UINT64_MAX for none.
+ */
+static uint64_t TimerNextEvent(const SimTimer_t* timer);
+
+/**
+ * @internal
+ * @brief Brings a timer's registers up to date before the peripheral library touches them.
+ */
+static void TimerSync(TIM_TypeDef* tim);
+
+/**
+ * @internal
+ * @brief Indicates if a timer has an interrupt pending.
+ */
+static bool TimerPending(const SimTimer_t* timer);
+
+/**
+ * @internal
+ * @brief Takes the interrupts which are pending, one after the other.
+ */
+static void TakeInterrupts(void);
+
+/**
+ * @internal
+ * @brief Writes a port's output register, passing the pins which changed on to the board.
+ */
+static void WritePort(GPIO_TypeDef* port, uint16_t value);
+
+/**
+ * @internal
+ * @brief Retrieves the external input whose select line code the pins hold, SIM_NO_EXTERNAL for none.
+ */
+static uint8_t DecodeExternalInput(uint16_t lines);
+
+/**
+ * @internal
+ * @brief Retrieves the voltage on AIN0 at a simulated time, and whether the multiplexer was switching then.
+ */
+static double MuxVoltageAt(uint64_t time, uint8_t* switching);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * Maps a span of the device's address space into host memory, zero filled as the registers mostly reset. The span
+ * must be free in the host process, which it is for the peripheral addresses on 64 bit hosts.
+ *
+ * @param address uintptr_t The start of the span.
+ * @param size size_t The size of the span.
+ * @retval none
+ */
+static void MapRegion(uintptr_t address, size_t size) {
+	void* mapped = mmap((void*) address, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (mapped != (void*) address) {
+		fprintf(stderr, "Could not map the peripherals at 0x%08lX.\n", (unsigned long) address);
+		exit(EXIT_FAILURE);
+	}
+}
+
+/**
+ * @internal
+ * Sets the simulated time, keeping the DWT cycle counter in step with it at the core clock.
+ *
+ * @param time uint64_t The simulated time in nanoseconds.
+ * @retval none
+ */
+static void SetTime(uint64_t time) {
+	SimTime = time;
+	DWT->CYCCNT = (uint32_t) ((time * (SIM_CORE_CLOCK_HZ / 1000000U)) / 1000U);
+}
+
+/**
+ * @internal
+ * Retrieves the simulated timer of a timer's registers.
+ *
+ * @param tim TIM_TypeDef* The timer's registers.
+ * @retval SimTimer_t* The simulated timer, NULL if the timer is not simulated.
+ */
+static SimTimer_t* FindTimer(TIM_TypeDef* tim) {
+	for (uint_fast8_t i = 0U; i < SIM_TIMER_COUNT; ++i) {
+		if (Timers[i].tim == tim) {
+			return &Timers[i];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @internal
+ * Retrieves the simulated time at which a timer's counter reaches a count, the first tick edge at or after it.
+ *
+ * @param timer const SimTimer_t* The timer.
+ * @param count uint64_t The count since the timer was started, the start included.
+ * @retval uint64_t The simulated time in nanoseconds.
+ */
+static uint64_t TimerTimeOf(const SimTimer_t* timer, uint64_t count) {
+	const uint64_t ticks = count - timer->start;
+	const uint64_t scale = (uint64_t) (timer->psc + 1U) * 1000U;
+	const uint64_t clock = SIM_TIMER_CLOCK_HZ / 1000000U;
+	return timer->base + (((ticks * scale) + clock - 1U) / clock);
+}
+
+/**
+ * @internal
+ * Advances a timer's counter to the simulated time. An overflow raises the update flag, stopping the counter in
+ * one pulse mode, and passing the first compare value raises its flag.
+ *
+ * @param timer SimTimer_t* The timer.
+ * @retval none
+ */
+static void TimerAdvance(SimTimer_t* timer) {
+	if (timer->running == false) {
+		return;
+	}
+	const uint64_t period = (uint64_t) timer->arr + 1U;
+	const uint64_t scale = (uint64_t) (timer->psc + 1U) * 1000U;
+	uint64_t count = timer->start + (((SimTime - timer->base) * (SIM_TIMER_CLOCK_HZ / 1000000U)) / scale);
+	const uint64_t overflow = ((timer->position / period) + 1U) * period;
+	bool stop = false;
+	if (count >= overflow) {
+		timer->tim->SR |= TIM_SR_UIF;
+		if ((timer->tim->CR1 & TIM_CR1_OPM) != 0U) {
+			/* The counter stops at the overflow */
+			count = overflow;
+			stop = true;
+		}
+	}
+	const uint64_t compare = timer->tim->CCR1;
+	if (compare < period) {
+		/* The first count past the position which matches the compare value */
+		uint64_t match = ((timer->position / period) * period) + compare;
+		if (match <= timer->position) {
+			match += period;
+		}
+		if (match <= count) {
+			timer->tim->SR |= TIM_SR_CC1IF;
+		}
+	}
+	timer->position = count;
+	timer->cnt = (uint32_t) (count % period);
+	timer->tim->CNT = timer->cnt;
+	if (stop == true) {
+		timer->tim->CR1 &= (uint16_t) ~TIM_CR1_CEN;
+		timer->running = false;
+	}
+}
+
+/**
+ * @internal
+ * Picks up what the firmware wrote to a timer's registers directly. Starting the counter or writing its count,
+ * prescaler or reload restarts the counter's time keeping from the simulated time at the count in CNT.
+ *
+ * @param timer SimTimer_t* The timer.
+ * @retval none
+ */
+static void TimerReconcile(SimTimer_t* timer) {
+	const bool enabled = ((timer->tim->CR1 & TIM_CR1_CEN) != 0U);
+	const uint32_t arr = timer->tim->ARR & 0xFFFFU;
+	const uint32_t psc = timer->tim->PSC & 0xFFFFU;
+	const uint32_t cnt = timer->tim->CNT & 0xFFFFU;
+	if ((enabled != timer->running) || (arr != timer->arr) || (psc != timer->psc) || (cnt != timer->cnt)) {
+		timer->running = enabled;
+		timer->arr = arr;
+		timer->psc = psc;
+		timer->cnt = cnt;
+		timer->base = SimTime;
+		timer->start = (cnt <= arr) ? cnt : arr;
+		timer->position = timer->start;
+	}
+}
+
+/**
+ * @internal
+ * Retrieves the simulated time of the timer's next event which matters: an overflow while its interrupt is enabled
+ * or in one pulse mode, where it stops the counter, and a compare match while its interrupt is enabled.
+ *
+ * @param timer const SimTimer_t* The timer.
+ * @retval uint64_t The simulated time in nanoseconds, UINT64_MAX for none.
+ */
+static uint64_t TimerNextEvent(const SimTimer_t* timer) {
+	uint64_t next = UINT64_MAX;
+	if (timer->running == false) {
+		return next;
+	}
+	const uint64_t period = (uint64_t) timer->arr + 1U;
+	if (((timer->tim->DIER & TIM_DIER_UIE) != 0U) || ((timer->tim->CR1 & TIM_CR1_OPM) != 0U)) {
+		next = TimerTimeOf(timer, ((timer->position / period) + 1U) * period);
+	}
+	const uint64_t compare = timer->tim->CCR1;
+	if (((timer->tim->DIER & TIM_DIER_CC1IE) != 0U) && (compare < period)) {
+		uint64_t match = ((timer->position / period) * period) + compare;
+		if (match <= timer->position) {
+			match += period;
+		}
+		const uint64_t time = TimerTimeOf(timer, match);
+		if (time < next) {
+			next = time;
+		}
+	}
+	return next;
+}
+
+/**
+ * @internal
+ * Brings a timer's registers up to date with the simulated time before the peripheral library touches them.
+ *
+ * @param tim TIM_TypeDef* The timer's registers.
+ * @retval none
+ */
+static void TimerSync(TIM_TypeDef* tim) {
+	SimTimer_t* timer = FindTimer(tim);
+	if (timer != NULL) {
+		TimerReconcile(timer);
+		TimerAdvance(timer);
+	}
+}
+
+/**
+ * @internal
+ * Indicates if a timer has an interrupt pending, a flag raised whose interrupt is enabled.
+ *
+ * @param timer const SimTimer_t* The timer.
+ * @retval bool TRUE if its handler is to be called.
+ */
+static bool TimerPending(const SimTimer_t* timer) {
+	return (timer->tim->SR & timer->tim->DIER & (TIM_SR_UIF | TIM_SR_CC1IF)) != 0U;
+}
+
+/**
+ * @internal
+ * Takes the interrupts which are pending, tail chaining from one handler to the next until none are. TIM3, the DRDY
+ * line's EXTI15_10 and TIM6 share a priority, so they are taken in the order of their vectors.
+ *
+ * @param none
+ * @retval none
+ */
+static void TakeInterrupts(void) {
+	uint32_t taken = 0U;
+	for (;;) {
+		void (*handler)(void) = NULL;
+		if (TimerPending(&Timers[0]) == true) {
+			handler = Timers[0].handler;
+		} else if ((EXTI->PR & EXTI->IMR & ADS1256_DRDY_EXTI_LINE) != 0U) {
+			handler = &ADS1256_DRDY_IRQHandler;
+		} else if (TimerPending(&Timers[1]) == true) {
+			handler = Timers[1].handler;
+		}
+		if (handler == NULL) {
+			return;
+		}
+		if (++taken > SIM_MAX_TAIL_CHAIN) {
+			fprintf(stderr, "An interrupt handler does not clear its pending flag.\n");
+			exit(EXIT_FAILURE);
+		}
+		++InterruptDepth;
+		Sim_Advance(SIM_IRQ_LATENCY_NS);
+		handler();
+		--InterruptDepth;
+	}
+}
+
+/**
+ * @internal
+ * Writes a port's output register, passing the pins which changed on to the ADS1256 and the external multiplexer.
+ *
+ * @param port GPIO_TypeDef* The port.
+ * @param value uint16_t The new state of its pins.
+ * @retval none
+ */
+static void WritePort(GPIO_TypeDef* port, uint16_t value) {
+	const uint16_t changed = (uint16_t) (port->ODR ^ value);
+	port->ODR = value;
+	if (changed == 0U) {
+		return;
+	}
+	if ((port == ADS1256_CS_GPIO_PORT) && ((changed & ADS1256_CS_PIN) != 0U)) {
+		SimADS1256_SetChipSelect((value & ADS1256_CS_PIN) != 0U);
+	}
+	if ((port == ADS1256_SYNC_GPIO_PORT) && ((changed & ADS1256_SYNC_PIN) != 0U)) {
+		SimADS1256_SetSyncPin((value & ADS1256_SYNC_PIN) != 0U);
+	}
+	if ((port == ADS1256_RESET_GPIO_PORT) && ((changed & ADS1256_RESET_PIN) != 0U)) {
+		SimADS1256_SetResetPin((value & ADS1256_RESET_PIN) != 0U);
+	}
+	if ((port == EXT_ANALOG_IN_MUX_PORT) && ((changed & EXT_ANALOG_IN_MUX_PINS) != 0U)) {
+		SimMuxSwitch_t* last = &MuxSwitches[(MuxSwitchCount - 1U) % SIM_MUX_HISTORY];
+		SimMuxSwitch_t* next = &MuxSwitches[MuxSwitchCount % SIM_MUX_HISTORY];
+		next->previous = last->input;
+		next->input = DecodeExternalInput(value & EXT_ANALOG_IN_MUX_PINS);
+		next->time = SimTime;
+		++MuxSwitchCount;
+	}
+}
+
+/**
+ * @internal
+ * Retrieves the external input whose select line code the multiplexer's pins hold.
+ *
+ * @param lines uint16_t The state of the select lines.
+ * @retval uint8_t The external input, SIM_NO_EXTERNAL for none.
+ */
+static uint8_t DecodeExternalInput(uint16_t lines) {
+	for (uint_fast8_t i = 0U; i < (sizeof(MUX_CODES) / sizeof(MUX_CODES[0])); ++i) {
+		if (MUX_CODES[i] == lines) {
+			return (uint8_t) i;
+		}
+	}
+	return SIM_NO_EXTERNAL;
+}
+
+/**
+ * @internal
+ * Retrieves the voltage on AIN0 at a simulated time. It moves linearly from the previous input's voltage to the new
+ * input's over the multiplexer's settle time after each switch, and is 0V while no input is selected.
+ *
+ * @param time uint64_t The simulated time in nanoseconds.
+ * @param switching uint8_t* Set to 1 if the multiplexer was switching at the time.
+ * @retval double The voltage.
+ */
+static double MuxVoltageAt(uint64_t time, uint8_t* switching) {
+	const uint32_t oldest = (MuxSwitchCount > SIM_MUX_HISTORY) ? (MuxSwitchCount - SIM_MUX_HISTORY) : 0U;
+	uint32_t i = MuxSwitchCount - 1U;
+	while ((i > oldest) && (MuxSwitches[i % SIM_MUX_HISTORY].time > time)) {
+		--i;
+	}
+	const SimMuxSwitch_t* change = &MuxSwitches[i % SIM_MUX_HISTORY];
+	const double target = (change->input < SIM_EXTERNAL_COUNT) ? ExternalVoltages[change->input] : 0.0;
+	const uint64_t elapsed = (time > change->time) ? (time - change->time) : 0U;
+	if ((elapsed >= MuxSettleTime) || (change->previous == change->input)) {
+		return target;
+	}
+	*switching = 1U;
+	const double from = (change->previous < SIM_EXTERNAL_COUNT) ? ExternalVoltages[change->previous] : 0.0;
+	return from + ((target - from) * ((double) elapsed / (double) MuxSettleTime));
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Maps the peripheral memory and powers up the simulated board at time 0. The clock tree is that of the board, so
+ * the timers count at SIM_TIMER_CLOCK_HZ. The external inputs are given voltages which differ from each other, from
+ * -2V in steps of 125mV, and the ADS1256's own inputs those of the board's supplies and cold junction sensor at
+ * 25 Deg C.
+ *
+ * @param none
+ * @retval none
+ */
+void SimBoard_Init(void) {
+	MapRegion(PERIPH_BASE, SIM_PERIPH_SIZE);
+	MapRegion(SIM_CORE_BASE, SIM_CORE_SIZE);
+	SetTime(0U);
+	RCC->CFGR = RCC_CFGR_PPRE1_DIV4 | RCC_CFGR_PPRE2_DIV2;
+
+	Timers[0].tim = SNAPSHOT_FRAME_TIM;
+	Timers[0].handler = &ADC_Machine_FrameIRQHandler;
+	Timers[1].tim = EXT_MUX_SETTLE_TIM;
+	Timers[1].handler = &InputMultiplexer_SettleIRQHandler;
+
+	for (uint_fast8_t i = 0U; i < SIM_EXTERNAL_COUNT; ++i) {
+		ExternalVoltages[i] = -2.0 + (0.125 * (double) i);
+	}
+	AinVoltages[ADS1256_AIN1] = 0.0; /* The analog ground of the external inputs */
+	AinVoltages[ADS1256_AIN2] = 1.2; /* The default differential pair */
+	AinVoltages[ADS1256_AIN3] = 0.9; /* The divided 9V supply */
+	AinVoltages[ADS1256_AIN4] = 0.5; /* The divided 5V supply */
+	AinVoltages[ADS1256_AIN5] = 0.2; /* The default differential pair */
+	AinVoltages[ADS1256_AIN6] = 0.25; /* The cold junction sensor, 10mV per Deg C */
+	AinVoltages[ADS1256_AIN7] = 0.33; /* The divided 3.3V supply */
+	AinVoltages[ADS1256_AIN_COM] = 0.0;
+
+	/* The multiplexer starts on the input its pins select out of reset */
+	const uint8_t input = DecodeExternalInput(0U);
+	MuxSwitches[0].time = 0U;
+	MuxSwitches[0].input = input;
+	MuxSwitches[0].previous = input;
+	MuxSwitchCount = 1U;
+
+	SimADS1256_PowerUp();
+}
+
+/**
+ * Retrieves the simulated time.
+ *
+ * @param none
+ * @retval uint64_t The simulated time in nanoseconds since the board was powered up.
+ */
+uint64_t Sim_GetTime(void) {
+	return SimTime;
+}
+
+/**
+ * Runs the simulated hardware for the provided time. The ADS1256 and the timers are stepped from one event to the
+ * next and the interrupts they raise are taken as they are raised, the handlers' own hardware accesses letting
+ * time pass in turn. Within a handler only the hardware runs, further interrupts waiting for it to return.
+ *
+ * @param ns uint64_t The time to run for in nanoseconds.
+ * @retval none
+ */
+void Sim_Advance(uint64_t ns) {
+	const uint64_t target = SimTime + ns;
+	do {
+		uint64_t next = target;
+		for (uint_fast8_t i = 0U; i < SIM_TIMER_COUNT; ++i) {
+			TimerReconcile(&Timers[i]);
+			const uint64_t event = TimerNextEvent(&Timers[i]);
+			if (event < next) {
+				next = event;
+			}
+		}
+		const uint64_t event = SimADS1256_GetNextEvent();
+		if (event < next) {
+			next = event;
+		}
+		if (next > SimTime) {
+			SetTime(next);
+		}
+		for (uint_fast8_t i = 0U; i < SIM_TIMER_COUNT; ++i) {
+			TimerAdvance(&Timers[i]);
+		}
+		SimADS1256_Process();
+		if (InterruptDepth == 0U) {
+			TakeInterrupts();
+		}
+	} while (SimTime < target);
+}
+
+/**
+ * Sets the voltage applied to an external input, relative to the analog ground.
+ *
+ * @param input uint8_t The external input.
+ * @param volts double The voltage.
+ * @retval none
+ */
+void SimBoard_SetExternalVoltage(uint8_t input, double volts) {
+	if (input < SIM_EXTERNAL_COUNT) {
+		ExternalVoltages[input] = volts;
+	}
+}
+
+/**
+ * Sets the voltage on one of the ADS1256's own analog inputs. AIN0 follows the external multiplexer, so setting it
+ * has no effect.
+ *
+ * @param ain uint8_t The input, numbered as ADS1256_AIN_t.
+ * @param volts double The voltage.
+ * @retval none
+ */
+void SimBoard_SetAinVoltage(uint8_t ain, double volts) {
+	if (ain < SIM_AIN_COUNT) {
+		AinVoltages[ain] = volts;
+	}
+}
+
+/**
+ * Sets the time the external multiplexer takes to conduct once its select lines change.
+ *
+ * @param ns uint32_t The settle time in nanoseconds.
+ * @retval none
+ */
+void SimBoard_SetMuxSettleTime(uint32_t ns) {
+	MuxSettleTime = ns;
+}
+
+/**
+ * Retrieves the external input the external multiplexer's select lines point at.
+ *
+ * @param none
+ * @retval uint8_t The external input, SIM_NO_EXTERNAL for none.
+ */
+uint8_t SimBoard_GetExternalSelection(void) {
+	return MuxSwitches[(MuxSwitchCount - 1U) % SIM_MUX_HISTORY].input;
+}
+
+/**
+ * Retrieves the mean voltage on an ADS1256 input over a window of simulated time, as its digital filter sees it.
+ * Only AIN0 changes over time, following the external multiplexer.
+ *
+ * @param ain uint8_t The input, numbered as ADS1256_AIN_t.
+ * @param start uint64_t The start of the window in nanoseconds.
+ * @param end uint64_t The end of the window in nanoseconds.
+ * @param unsettled uint8_t* Set to 1 if the external multiplexer was switching during the window, else left as is.
+ * @retval double The mean voltage.
+ */
+double SimBoard_GetAinVoltage(uint8_t ain, uint64_t start, uint64_t end, uint8_t* unsettled) {
+	if (ain != ADS1256_AIN0) {
+		return (ain < SIM_AIN_COUNT) ? AinVoltages[ain] : 0.0;
+	}
+	const uint64_t span = (end > start) ? (end - start) : 0U;
+	double sum = 0.0;
+	for (uint_fast8_t i = 0U; i < SIM_VOLTAGE_POINTS; ++i) {
+		const uint64_t time = start + ((span * ((2U * i) + 1U)) / (2U * SIM_VOLTAGE_POINTS));
+		sum += MuxVoltageAt(time, unsettled);
+	}
+	/* A switch shorter than the spacing of the points still leaves the conversion unsettled */
+	const uint32_t oldest = (MuxSwitchCount > SIM_MUX_HISTORY) ? (MuxSwitchCount - SIM_MUX_HISTORY) : 0U;
+	for (uint32_t i = oldest; i < MuxSwitchCount; ++i) {
+		const SimMuxSwitch_t* change = &MuxSwitches[i % SIM_MUX_HISTORY];
+		if ((change->previous != change->input) && (change->time < end)
+				&& ((change->time + MuxSettleTime) > start)) {
+			*unsettled = 1U;
+		}
+	}
+	return sum / (double) SIM_VOLTAGE_POINTS;
+}
+
+/**
+ * Drives the ADS1256's DRDY output onto its pin. A falling edge is latched by the pin's EXTI line if it is set to
+ * trigger on one, whether or not the line is masked.
+ *
+ * @param level uint8_t The level of the pin, 0 for data ready.
+ * @retval none
+ */
+void SimBoard_SetDataReady(uint8_t level) {
+	const bool high = ((ADS1256_DRDY_GPIO_PORT->IDR & ADS1256_DRDY_PIN) != 0U);
+	if (level != 0U) {
+		ADS1256_DRDY_GPIO_PORT->IDR |= ADS1256_DRDY_PIN;
+		if ((high == false) && ((EXTI->RTSR & ADS1256_DRDY_EXTI_LINE) != 0U)) {
+			EXTI->PR |= ADS1256_DRDY_EXTI_LINE;
+		}
+	} else {
+		ADS1256_DRDY_GPIO_PORT->IDR &= ~((uint32_t) ADS1256_DRDY_PIN);
+		if ((high == true) && ((EXTI->FTSR & ADS1256_DRDY_EXTI_LINE) != 0U)) {
+			EXTI->PR |= ADS1256_DRDY_EXTI_LINE;
+		}
+	}
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* TIMERS MODULE */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Retrieves the local time, as Tekdaqc_Timers.c.
+ *
+ * @param none
+ * @retval uint64_t The simulated time in microseconds.
+ */
+uint64_t GetLocalTime(void) {
+	return SimTime / 1000U;
+}
+
+/**
+ * Converts a local time to an epoch time, as Tekdaqc_Timers.c without an epoch mapping.
+ *
+ * @param local uint64_t The local time in microseconds.
+ * @retval uint64_t The same time.
+ */
+uint64_t Timer_ToEpochTime(uint64_t local) {
+	return local;
+}
+
+/**
+ * Schedules a deadline, as Tekdaqc_Timers.c. A callback already scheduled is moved to the new deadline.
+ *
+ * @param callback DeadlineCallback The function to call once the deadline passes.
+ * @param us uint32_t The number of microseconds from now at which the deadline passes.
+ * @retval bool TRUE if the deadline was scheduled, FALSE if all deadlines are in use.
+ */
+bool Timer_ScheduleDeadline(DeadlineCallback callback, uint32_t us) {
+	int_fast8_t slot = -1;
+	for (uint_fast8_t i = 0U; i < TIMER_DEADLINE_COUNT; ++i) {
+		if (Deadlines[i].callback == callback) {
+			slot = (int_fast8_t) i;
+			break;
+		} else if ((Deadlines[i].callback == NULL) && (slot < 0)) {
+			slot = (int_fast8_t) i;
+		}
+	}
+	if (slot < 0) {
+		return false;
+	}
+	Deadlines[slot].due = GetLocalTime() + us;
+	Deadlines[slot].callback = callback;
+	return true;
+}
+
+/**
+ * Cancels the deadline scheduled for the provided callback, if there is one, as Tekdaqc_Timers.c.
+ *
+ * @param callback DeadlineCallback The callback of the deadline to cancel.
+ * @retval none
+ */
+void Timer_CancelDeadline(DeadlineCallback callback) {
+	for (uint_fast8_t i = 0U; i < TIMER_DEADLINE_COUNT; ++i) {
+		if (Deadlines[i].callback == callback) {
+			Deadlines[i].callback = NULL;
+		}
+	}
+}
+
+/**
+ * Makes the callbacks of the deadlines which have passed, as Tekdaqc_Timers.c. Called from the program loop.
+ *
+ * @param none
+ * @retval none
+ */
+void Timer_ServiceDeadlines(void) {
+	const uint64_t now = GetLocalTime();
+	for (uint_fast8_t i = 0U; i < TIMER_DEADLINE_COUNT; ++i) {
+		DeadlineCallback callback = Deadlines[i].callback;
+		if ((callback != NULL) && (now >= Deadlines[i].due)) {
+			Deadlines[i].callback = NULL;
+			callback();
+		}
+	}
+}
+
+/**
+ * Delays for the provided number of nanoseconds, letting the simulated hardware run.
+ *
+ * @param ns uint32_t The delay in nanoseconds.
+ * @retval none
+ */
+void Delay_ns(uint32_t ns) {
+	Sim_Advance(ns);
+}
+
+/**
+ * Delays for the provided number of microseconds, letting the simulated hardware run.
+ *
+ * @param us uint64_t The delay in microseconds.
+ * @retval none
+ */
+void Delay_us(uint64_t us) {
+	Sim_Advance(us * 1000U);
+}
+
+/**
+ * Delays for the provided number of milliseconds, letting the simulated hardware run.
+ *
+ * @param ms float The delay in milliseconds.
+ * @retval none
+ */
+void Delay_ms(float ms) {
+	Sim_Advance((uint64_t) (ms * 1000000.0f));
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PERIPHERAL LIBRARY */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Enables or disables the clock of AHB1 peripherals. The simulated peripherals are always clocked.
+ */
+void RCC_AHB1PeriphClockCmd(uint32_t RCC_AHB1Periph, FunctionalState NewState) {
+	(void) RCC_AHB1Periph;
+	(void) NewState;
+}
+
+/**
+ * Enables or disables the clock of APB1 peripherals. The simulated peripherals are always clocked.
+ */
+void RCC_APB1PeriphClockCmd(uint32_t RCC_APB1Periph, FunctionalState NewState) {
+	(void) RCC_APB1Periph;
+	(void) NewState;
+}
+
+/**
+ * Enables or disables the clock of APB2 peripherals. The simulated peripherals are always clocked.
+ */
+void RCC_APB2PeriphClockCmd(uint32_t RCC_APB2Periph, FunctionalState NewState) {
+	(void) RCC_APB2Periph;
+	(void) NewState;
+}
+
+/**
+ * Retrieves the frequencies of the board's clocks.
+ */
+void RCC_GetClocksFreq(RCC_ClocksTypeDef* RCC_Clocks) {
+	RCC_Clocks->SYSCLK_Frequency = SIM_CORE_CLOCK_HZ;
+	RCC_Clocks->HCLK_Frequency = SIM_CORE_CLOCK_HZ;
+	RCC_Clocks->PCLK1_Frequency = SIM_CORE_CLOCK_HZ / 4U;
+	RCC_Clocks->PCLK2_Frequency = SIM_CORE_CLOCK_HZ / 2U;
+}
+
+/**
+ * Configures an interrupt in the NVIC. The simulated interrupts are always enabled.
+ */
+void NVIC_Init(NVIC_InitTypeDef* NVIC_InitStruct) {
+	(void) NVIC_InitStruct;
+}
+
+/**
+ * Routes a pin to its EXTI line. Only the DRDY pin's line is simulated.
+ */
+void SYSCFG_EXTILineConfig(uint8_t EXTI_PortSourceGPIOx, uint8_t EXTI_PinSourcex) {
+	(void) EXTI_PortSourceGPIOx;
+	(void) EXTI_PinSourcex;
+}
+
+/**
+ * Configures an EXTI line, as the peripheral library does. The edges are only selected when the line is enabled.
+ */
+void EXTI_Init(EXTI_InitTypeDef* EXTI_InitStruct) {
+	volatile uint32_t* mode = (volatile uint32_t*) (uintptr_t) (EXTI_BASE + EXTI_InitStruct->EXTI_Mode);
+	if (EXTI_InitStruct->EXTI_LineCmd != DISABLE) {
+		EXTI->IMR &= ~EXTI_InitStruct->EXTI_Line;
+		EXTI->EMR &= ~EXTI_InitStruct->EXTI_Line;
+		*mode |= EXTI_InitStruct->EXTI_Line;
+		EXTI->RTSR &= ~EXTI_InitStruct->EXTI_Line;
+		EXTI->FTSR &= ~EXTI_InitStruct->EXTI_Line;
+		if (EXTI_InitStruct->EXTI_Trigger == EXTI_Trigger_Rising_Falling) {
+			EXTI->RTSR |= EXTI_InitStruct->EXTI_Line;
+			EXTI->FTSR |= EXTI_InitStruct->EXTI_Line;
+		} else {
+			*(volatile uint32_t*) (uintptr_t) (EXTI_BASE + EXTI_InitStruct->EXTI_Trigger) |= EXTI_InitStruct->EXTI_Line;
+		}
+	} else {
+		*mode &= ~EXTI_InitStruct->EXTI_Line;
+	}
+}
+
+/**
+ * Checks if an EXTI line's interrupt is pending, latched and not masked.
+ */
+ITStatus EXTI_GetITStatus(uint32_t EXTI_Line) {
+	return ((EXTI->PR & EXTI->IMR & EXTI_Line) != 0U) ? SET : RESET;
+}
+
+/**
+ * Clears an EXTI line's pending bit, which on the board is done by writing 1 to it.
+ */
+void EXTI_ClearITPendingBit(uint32_t EXTI_Line) {
+	EXTI->PR &= ~EXTI_Line;
+}
+
+/**
+ * Configures pins. The simulated pins are whatever the firmware uses them as.
+ */
+void GPIO_Init(GPIO_TypeDef* GPIOx, GPIO_InitTypeDef* GPIO_InitStruct) {
+	(void) GPIOx;
+	(void) GPIO_InitStruct;
+}
+
+/**
+ * Reads an input pin, which takes SIM_PIN_READ_NS so that polling a pin lets the hardware run.
+ */
+uint8_t GPIO_ReadInputDataBit(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin) {
+	Sim_Advance(SIM_PIN_READ_NS);
+	return ((GPIOx->IDR & GPIO_Pin) != 0U) ? (uint8_t) Bit_SET : (uint8_t) Bit_RESET;
+}
+
+/**
+ * Reads a port's output register.
+ */
+uint16_t GPIO_ReadOutputData(GPIO_TypeDef* GPIOx) {
+	return (uint16_t) GPIOx->ODR;
+}
+
+/**
+ * Sets pins of a port.
+ */
+void GPIO_SetBits(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin) {
+	WritePort(GPIOx, (uint16_t) (GPIOx->ODR | GPIO_Pin));
+}
+
+/**
+ * Clears pins of a port.
+ */
+void GPIO_ResetBits(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin) {
+	WritePort(GPIOx, (uint16_t) (GPIOx->ODR & ~GPIO_Pin));
+}
+
+/**
+ * Sets or clears pins of a port.
+ */
+void GPIO_WriteBit(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, BitAction BitVal) {
+	if (BitVal != Bit_RESET) {
+		GPIO_SetBits(GPIOx, GPIO_Pin);
+	} else {
+		GPIO_ResetBits(GPIOx, GPIO_Pin);
+	}
+}
+
+/**
+ * Writes all of the pins of a port.
+ */
+void GPIO_Write(GPIO_TypeDef* GPIOx, uint16_t PortVal) {
+	WritePort(GPIOx, PortVal);
+}
+
+/**
+ * Fills a timer's time base settings with their defaults, as the peripheral library does.
+ */
+void TIM_TimeBaseStructInit(TIM_TimeBaseInitTypeDef* TIM_TimeBaseInitStruct) {
+	TIM_TimeBaseInitStruct->TIM_Period = 0xFFFFFFFFU;
+	TIM_TimeBaseInitStruct->TIM_Prescaler = 0x0000U;
+	TIM_TimeBaseInitStruct->TIM_ClockDivision = TIM_CKD_DIV1;
+	TIM_TimeBaseInitStruct->TIM_CounterMode = TIM_CounterMode_Up;
+	TIM_TimeBaseInitStruct->TIM_RepetitionCounter = 0x0000U;
+}
+
+/**
+ * Sets up a timer's time base. As on the board the update event which loads the prescaler raises the update flag.
+ */
+void TIM_TimeBaseInit(TIM_TypeDef* TIMx, TIM_TimeBaseInitTypeDef* TIM_TimeBaseInitStruct) {
+	TimerSync(TIMx);
+	TIMx->ARR = TIM_TimeBaseInitStruct->TIM_Period & 0xFFFFU;
+	TIMx->PSC = TIM_TimeBaseInitStruct->TIM_Prescaler;
+	TIM_GenerateEvent(TIMx, TIM_EventSource_Update);
+}
+
+/**
+ * Selects a timer's one pulse mode.
+ */
+void TIM_SelectOnePulseMode(TIM_TypeDef* TIMx, uint16_t TIM_OPMode) {
+	TimerSync(TIMx);
+	TIMx->CR1 = (uint16_t) ((TIMx->CR1 & (uint16_t) ~TIM_CR1_OPM) | TIM_OPMode);
+}
+
+/**
+ * Starts or stops a timer's counter.
+ */
+void TIM_Cmd(TIM_TypeDef* TIMx, FunctionalState NewState) {
+	TimerSync(TIMx);
+	if (NewState != DISABLE) {
+		TIMx->CR1 |= TIM_CR1_CEN;
+	} else {
+		TIMx->CR1 &= (uint16_t) ~TIM_CR1_CEN;
+	}
+	TimerSync(TIMx);
+}
+
+/**
+ * Generates timer events. An update event restarts the counter from 0 and, as on the board, raises the update flag.
+ */
+void TIM_GenerateEvent(TIM_TypeDef* TIMx, uint16_t TIM_EventSource) {
+	TimerSync(TIMx);
+	if ((TIM_EventSource & TIM_EventSource_Update) != 0U) {
+		TIMx->CNT = 0U;
+	}
+	TIMx->SR |= TIM_EventSource;
+	SimTimer_t* timer = FindTimer(TIMx);
+	if (timer != NULL) {
+		/* Restart the time keeping from the new count */
+		timer->cnt = UINT32_MAX;
+		TimerReconcile(timer);
+	}
+}
+
+/**
+ * Enables or disables timer interrupts.
+ */
+void TIM_ITConfig(TIM_TypeDef* TIMx, uint16_t TIM_IT, FunctionalState NewState) {
+	TimerSync(TIMx);
+	if (NewState != DISABLE) {
+		TIMx->DIER |= TIM_IT;
+	} else {
+		TIMx->DIER &= (uint16_t) ~TIM_IT;
+	}
+}
+
+/**
+ * Checks if a timer interrupt is pending, its flag raised and the interrupt enabled.
+ */
+ITStatus TIM_GetITStatus(TIM_TypeDef* TIMx, uint16_t TIM_IT) {
+	TimerSync(TIMx);
+	return (((TIMx->SR & TIM_IT) != 0U) && ((TIMx->DIER & TIM_IT) != 0U)) ? SET : RESET;
+}
+
+/**
+ * Clears timer flags, which on the board is done by writing 0 to them.
+ */
+void TIM_ClearITPendingBit(TIM_TypeDef* TIMx, uint16_t TIM_IT) {
+	TimerSync(TIMx);
+	TIMx->SR &= (uint16_t) ~TIM_IT;
+}
+
+/**
+ * Sets a timer's first compare value.
+ */
+void TIM_SetCompare1(TIM_TypeDef* TIMx, uint32_t Compare1) {
+	TimerSync(TIMx);
+	TIMx->CCR1 = Compare1;
+}
@@ -0,0 +1,317 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_SimSink.c
+ * @brief The simulated TCP connection the acquisition firmware writes its samples to when run by a host.
+ *
+ * Stands in for the lwIP send buffer of the data connection and the host on its other end. Writes are queued all or
+ * nothing into a send buffer of TCP_SND_BUF bytes, as tcp_write() with the connection's send buffer, and the link
+ * sends the queue at a fixed rate as the simulated time passes. What is sent is decoded by the reference receiver,
+ * and each channel's samples are checked against the value the caller expects of them:
+ *
+ *   - the number of samples received and reported lost, and the values which differ from those expected;
+ *   - the first and last timestamps, the shortest and longest time between samples and any out of order;
+ *   - the longest time from a sample's timestamp to the simulated time at which it was received.
+ *
+ * This file is built against the receiver's stdbool.h, so it includes none of the firmware's headers.
+ *
+ * This is host code, built with the host's C99 compiler rather than as part of the firmware, see
+ * Tekdaqc_AcquisitionSim.c.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Sim.h"
+#include "Tekdaqc_Receiver.h"
+#include <string.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def SINK_BUFFER_SIZE
+ * @brief The largest send buffer the simulated connection can be given.
+ */
+#define SINK_BUFFER_SIZE		65536U
+
+/**
+ * @internal
+ * @def SINK_CHANNEL_COUNT
+ * @brief The number of channels checked, one for each physical input number.
+ */
+#define SINK_CHANNEL_COUNT		RECEIVER_CHANNEL_COUNT
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief What a channel's samples are expected to be.
+ */
+typedef struct {
+	bool set; /**< TRUE if the channel's samples are checked. */
+	int32_t value; /**< The value expected. */
+	int32_t tolerance; /**< The largest difference from it accepted. */
+} SinkExpectation_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The receiver on the other end of the connection, too large for the stack */
+static Tekdaqc_Receiver_t Receiver;
+
+/* The send buffer, a ring of Capacity bytes */
+static uint8_t Buffer[SINK_BUFFER_SIZE];
+
+/* The size of the send buffer */
+static uint32_t Capacity = 0U;
+
+/* The rate the link sends at, in bytes per second */
+static uint32_t Rate = 0U;
+
+/* The position of the oldest queued byte */
+static uint32_t Head = 0U;
+
+/* The number of bytes queued */
+static uint32_t Queued = 0U;
+
+/* The simulated time up to which the link has sent */
+static uint64_t SentTime = 0U;
+
+/* The link's credit towards its next byte, in bytes per second nanoseconds */
+static uint64_t Credit = 0U;
+
+/* The writes refused because the send buffer was full */
+static uint32_t Refused = 0U;
+
+/* What was seen of each channel */
+static SimSink_Channel_t Channels[SINK_CHANNEL_COUNT];
+
+/* What each channel's samples are expected to be */
+static SinkExpectation_t Expectations[SINK_CHANNEL_COUNT];
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Checks each of the receiver's events against what is expected of its channel.
+ */
+static void OnEvent(const Receiver_Event_t* event, void* context);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * Checks each of the receiver's events against what is expected of its channel. Samples are counted and checked for
+ * their value, order and latency, and the samples the board reports lost are counted.
+ *
+ * @param event const Receiver_Event_t* The event.
+ * @param context void* Unused.
+ * @retval none
+ */
+static void OnEvent(const Receiver_Event_t* event, void* context) {
+	(void) context;
+	SimSink_Channel_t* channel = &Channels[event->channel];
+	if ((event->type == RECEIVER_EVENT_CONFIG) || (event->type == RECEIVER_EVENT_GAP)) {
+		channel->lost += event->lost;
+		return;
+	}
+	if (event->type != RECEIVER_EVENT_SAMPLE) {
+		return;
+	}
+	const SinkExpectation_t* expected = &Expectations[event->channel];
+	if (expected->set == true) {
+		const int64_t difference = (int64_t) event->value - (int64_t) expected->value;
+		if ((difference > expected->tolerance) || (difference < -(int64_t) expected->tolerance)) {
+			++channel->errors;
+		}
+	}
+	if (channel->samples == 0U) {
+		channel->first = event->value;
+		channel->start = event->timestamp;
+	} else if (event->timestamp < channel->end) {
+		++channel->disordered;
+	} else {
+		const uint64_t interval = event->timestamp - channel->end;
+		if ((channel->samples == 1U) || (interval < channel->minInterval)) {
+			channel->minInterval = interval;
+		}
+		if (interval > channel->maxInterval) {
+			channel->maxInterval = interval;
+		}
+	}
+	const uint64_t now = Sim_GetTime() / 1000U;
+	const uint64_t latency = (now > event->timestamp) ? (now - event->timestamp) : 0U;
+	if (latency > channel->maxLatency) {
+		channel->maxLatency = latency;
+	}
+	channel->end = event->timestamp;
+	++channel->samples;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Sets up the simulated TCP connection, as a new connection to a new receiver. Anything queued is discarded and
+ * what was seen of the channels cleared, but their expectations are kept.
+ *
+ * @param capacity uint32_t The size of the send buffer in bytes, at most 65536.
+ * @param rate uint32_t The rate the link sends at in bytes per second.
+ * @retval none
+ */
+void SimSink_Init(uint32_t capacity, uint32_t rate) {
+	Capacity = (capacity < SINK_BUFFER_SIZE) ? capacity : SINK_BUFFER_SIZE;
+	Rate = rate;
+	Head = 0U;
+	Queued = 0U;
+	SentTime = Sim_GetTime();
+	Credit = 0U;
+	Refused = 0U;
+	Receiver_Init(&Receiver, &OnEvent, NULL);
+	SimSink_ResetChannels();
+}
+
+/**
+ * Offers data to the simulated TCP connection, which queues all of it or none.
+ *
+ * @param data const uint8_t* The data.
+ * @param length uint16_t The number of bytes.
+ * @retval SimSink_Status_t SIM_SINK_ACCEPTED if queued, SIM_SINK_FULL if there is not currently room for it or
+ * SIM_SINK_TOO_LARGE if there never will be.
+ */
+SimSink_Status_t SimSink_Write(const uint8_t* data, uint16_t length) {
+	SimSink_Service();
+	if (length > Capacity) {
+		return SIM_SINK_TOO_LARGE;
+	}
+	if (length > (Capacity - Queued)) {
+		++Refused;
+		return SIM_SINK_FULL;
+	}
+	for (uint32_t i = 0U; i < length; ++i) {
+		Buffer[(Head + Queued + i) % Capacity] = data[i];
+	}
+	Queued += length;
+	return SIM_SINK_ACCEPTED;
+}
+
+/**
+ * Sends what the link has had time to send since the last call, handing it to the receiver. The link does not
+ * save up its time while there is nothing to send.
+ *
+ * @param none
+ * @retval none
+ */
+void SimSink_Service(void) {
+	const uint64_t now = Sim_GetTime();
+	Credit += (now - SentTime) * Rate;
+	SentTime = now;
+	uint64_t sendable = Credit / 1000000000U;
+	if (sendable >= Queued) {
+		sendable = Queued;
+		Credit = 0U;
+	} else {
+		Credit -= sendable * 1000000000U;
+	}
+	while (sendable > 0U) {
+		/* The ring is handed over in at most two contiguous pieces */
+		uint32_t piece = Capacity - Head;
+		if (piece > sendable) {
+			piece = (uint32_t) sendable;
+		}
+		Receiver_Feed(&Receiver, &Buffer[Head], piece);
+		Head = (Head + piece) % Capacity;
+		Queued -= piece;
+		sendable -= piece;
+	}
+}
+
+/**
+ * Retrieves the number of bytes queued and not yet sent.
+ *
+ * @param none
+ * @retval uint32_t The number of bytes.
+ */
+uint32_t SimSink_GetQueued(void) {
+	return Queued;
+}
+
+/**
+ * Sets the value a channel's samples are expected to have, checked as they are received.
+ *
+ * @param channel uint8_t The physical input number of the channel.
+ * @param value int32_t The value expected.
+ * @param tolerance int32_t The largest difference from it accepted.
+ * @retval none
+ */
+void SimSink_Expect(uint8_t channel, int32_t value, int32_t tolerance) {
+	Expectations[channel].set = true;
+	Expectations[channel].value = value;
+	Expectations[channel].tolerance = tolerance;
+}
+
+/**
+ * Clears what was seen of every channel.
+ *
+ * @param none
+ * @retval none
+ */
+void SimSink_ResetChannels(void) {
+	memset(Channels, 0, sizeof(Channels));
+}
+
+/**
+ * Retrieves what was seen of a channel since the channels were last reset.
+ *
+ * @param channel uint8_t The physical input number of the channel.
+ * @retval const SimSink_Channel_t* What was seen of it.
+ */
+const SimSink_Channel_t* SimSink_GetChannel(uint8_t channel) {
+	return &Channels[channel];
+}
+
+/**
+ * Retrieves the number of writes refused because the send buffer was full.
+ *
+ * @param none
+ * @retval uint32_t The number of writes.
+ */
+uint32_t SimSink_GetRefusedCount(void) {
+	return Refused;
+}
+
+/**
+ * Retrieves the number of bytes the receiver could not decode.
+ *
+ * @param none
+ * @retval uint64_t The number of bytes.
+ */
+uint64_t SimSink_GetDiscardedBytes(void) {
+	return Receiver_GetCounters(&Receiver)->discarded;
+}
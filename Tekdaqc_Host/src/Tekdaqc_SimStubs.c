@@ -0,0 +1,432 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_SimStubs.c
+ * @brief Stand ins for the firmware modules the acquisition firmware calls on but which are not simulated.
+ *
+ * The analog inputs and the ADC state machine call on the command interpreter, the Telnet server, the CAN bus, the
+ * digital inputs and outputs, the calibration table and the emulated EEPROM. None of them take part in acquiring the
+ * samples, so each is stood in for by the behavior of an idle board: no CAN streaming, no digital outputs switching,
+ * an empty calibration table and an EEPROM without saved settings. The messages the firmware writes to the Telnet
+ * server and its log are printed, and the errors among them counted, so that a run can be failed on them.
+ *
+ * This is host code, built with the host's C99 compiler rather than as part of the firmware, see
+ * Tekdaqc_AcquisitionSim.c.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Sim.h"
+#include "Tekdaqc_Config.h"
+#include "Tekdaqc_CommandInterpreter.h"
+#include "Tekdaqc_Calibration.h"
+#include "Tekdaqc_CalibrationTable.h"
+#include "Tekdaqc_CAN.h"
+#include "Tekdaqc_Log.h"
+#include "TelnetServer.h"
+#include "CommandState.h"
+#include "AnalogInput_Aux.h"
+#include "Digital_Input.h"
+#include "Digital_Output.h"
+#include "DigitalOutput_Interlock.h"
+#include "DigitalOutput_PID.h"
+#include "eeprom.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The number of error messages written and errors logged */
+static uint32_t ErrorCount = 0U;
+
+/* TRUE once the ADC has signaled that its sampling completed */
+static bool SamplingCompleted = false;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The shared buffer of the ToString methods, from Tekdaqc_Config.c */
+char TOSTRING_BUFFER[SIZE_TOSTRING_BUFFER];
+
+/* The parameters of the analog input commands, from Tekdaqc_CommandInterpreter.c */
+const char* ADD_ANALOG_INPUT_PARAMS[NUM_ADD_ANALOG_INPUT_PARAMS] = { PARAMETER_INPUT, PARAMETER_BUFFER, PARAMETER_RATE,
+		PARAMETER_GAIN, PARAMETER_NAME, PARAMETER_DEADBAND, PARAMETER_HEARTBEAT };
+const char* REMOVE_ANALOG_INPUT_PARAMS[NUM_REMOVE_ANALOG_INPUT_PARAMS] = { PARAMETER_INPUT };
+const char* SET_ANALOG_INPUT_FILTER_PARAMS[NUM_SET_ANALOG_INPUT_FILTER_PARAMS] = { PARAMETER_INPUT, PARAMETER_FILTER,
+		PARAMETER_DECIMATION };
+const char* SET_ANALOG_INPUT_OVERSAMPLING_PARAMS[NUM_SET_ANALOG_INPUT_OVERSAMPLING_PARAMS] = { PARAMETER_INPUT,
+		PARAMETER_VALUE };
+const char* SET_ANALOG_INPUT_THERMOCOUPLE_PARAMS[NUM_SET_ANALOG_INPUT_THERMOCOUPLE_PARAMS] = { PARAMETER_INPUT,
+		PARAMETER_TYPE };
+const char* SET_ANALOG_INPUT_SETTLE_PARAMS[NUM_SET_ANALOG_INPUT_SETTLE_PARAMS] = { PARAMETER_INPUT, PARAMETER_TIME };
+const char* SET_ANALOG_INPUT_PAIR_PARAMS[NUM_SET_ANALOG_INPUT_PAIR_PARAMS] = { PARAMETER_INPUT, PARAMETER_POSITIVE,
+		PARAMETER_NEGATIVE };
+const char* SET_ANALOG_INPUT_AUTO_RANGE_PARAMS[NUM_SET_ANALOG_INPUT_AUTO_RANGE_PARAMS] = { PARAMETER_INPUT,
+		PARAMETER_STATE, PARAMETER_GAIN };
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* SIMULATION */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Retrieves the number of error messages the firmware wrote to the Telnet server or its log.
+ *
+ * @param none
+ * @retval uint32_t The number of errors.
+ */
+uint32_t SimStubs_GetErrorCount(void) {
+	return ErrorCount;
+}
+
+/**
+ * Checks if the ADC signaled that its sampling completed since the last call.
+ *
+ * @param none
+ * @retval uint8_t 1 if it did.
+ */
+uint8_t SimStubs_TakeSamplingCompleted(void) {
+	const bool completed = SamplingCompleted;
+	SamplingCompleted = false;
+	return (completed == true) ? 1U : 0U;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* COMMAND INTERPRETER AND STATE */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Retrieves the index of an argument among the keys of a command, as the command interpreter.
+ */
+int8_t GetIndexOfArgument(char keys[][MAX_COMMANDPART_LENGTH], const char* target, uint8_t total) {
+	for (uint_fast8_t i = 0U; i < total; ++i) {
+		if (strcmp(keys[i], target) == 0) {
+			return (int8_t) i;
+		}
+	}
+	return -1;
+}
+
+/**
+ * Signals that the ADC sampling completed.
+ */
+void CompletedADCSampling(void) {
+	SamplingCompleted = true;
+}
+
+/**
+ * Performs the system calibration, which the simulated board has no need of.
+ */
+Tekdaqc_Function_Error_t PerformSystemCalibration(void) {
+	return ERR_FUNCTION_OK;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* TELNET AND LOG */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Retrieves the data format of the connection, the packed binary frames the simulated TCP connection decodes.
+ */
+DataFormat_t TelnetGetDataFormat(void) {
+	return DATA_FORMAT_BINARY;
+}
+
+/**
+ * Retrieves the optional fields of the binary frames.
+ */
+uint8_t TelnetGetDataFields(void) {
+	return DATA_FIELDS_DEFAULT;
+}
+
+/**
+ * Prints an error message and counts it.
+ */
+void TelnetWriteErrorMessage(char* message) {
+	++ErrorCount;
+	fprintf(stderr, "[ERROR] %s\n", message);
+}
+
+/**
+ * Prints a status message.
+ */
+void TelnetWriteStatusMessage(char* message) {
+	printf("[STATUS] %s\n", message);
+}
+
+/**
+ * Prints the errors and warnings logged, counting the errors.
+ */
+void Log_Printf(LogLevel_t level, const char* format, ...) {
+	if ((level == LOG_LEVEL_NONE) || (level > LOG_LEVEL_WARNING)) {
+		return;
+	}
+	if (level == LOG_LEVEL_ERROR) {
+		++ErrorCount;
+	}
+	va_list args;
+	va_start(args, format);
+	fprintf(stderr, (level == LOG_LEVEL_ERROR) ? "[LOG ERROR] " : "[LOG WARNING] ");
+	vfprintf(stderr, format, args);
+	fprintf(stderr, "\n");
+	va_end(args);
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* CAN BUS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Indicates if samples are streamed over the CAN bus, which they never are here.
+ */
+bool Tekdaqc_CAN_IsStreaming(void) {
+	return false;
+}
+
+/**
+ * Streams data over the CAN bus, which has no other nodes.
+ */
+WriteStatus_t Tekdaqc_CAN_StreamWrite(uint8_t channel, const uint8_t* data, uint8_t length) {
+	(void) channel;
+	(void) data;
+	(void) length;
+	return WRITE_NOT_CONNECTED;
+}
+
+/**
+ * Broadcasts a sync event over the CAN bus, which has no other nodes.
+ */
+bool Tekdaqc_CAN_SendSync(CAN_SyncEvent_t event, uint32_t argument) {
+	(void) event;
+	(void) argument;
+	return true;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* CALIBRATION TABLE */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Retrieves the offset calibration of a setting, that of an ideal ADC.
+ */
+uint32_t Tekdaqc_GetOffsetCalibration(ADS1256_SPS_t rate, ADS1256_PGA_t gain, ADS1256_BUFFER_t buffer) {
+	(void) rate;
+	(void) gain;
+	(void) buffer;
+	return 0U;
+}
+
+/**
+ * Retrieves the gain calibration of a setting, that of an ideal ADC.
+ */
+uint32_t Tekdaqc_GetGainCalibration(ADS1256_SPS_t rate, ADS1256_PGA_t gain, ADS1256_BUFFER_t buffer,
+		float temperature) {
+	(void) rate;
+	(void) gain;
+	(void) buffer;
+	(void) temperature;
+	return 0x400000U;
+}
+
+/**
+ * Sets the offset calibration of a setting, which the empty table does not keep.
+ */
+void Tekdaqc_SetOffsetCalibration(uint32_t cal, ADS1256_SPS_t rate, ADS1256_PGA_t gain, ADS1256_BUFFER_t buffer) {
+	(void) cal;
+	(void) rate;
+	(void) gain;
+	(void) buffer;
+}
+
+/**
+ * Sets the base gain calibration of a setting, which the empty table does not keep.
+ */
+void Tekdaqc_SetBaseGainCalibration(uint32_t cal, ADS1256_SPS_t rate, ADS1256_PGA_t gain, ADS1256_BUFFER_t buffer) {
+	(void) cal;
+	(void) rate;
+	(void) gain;
+	(void) buffer;
+}
+
+/**
+ * Sets the base gain value of a setting, which the empty table does not keep.
+ */
+void Tekdaqc_Calibration_SetBaseGainValue(uint32_t val, ADS1256_SPS_t rate, ADS1256_PGA_t gain,
+		ADS1256_BUFFER_t buffer) {
+	(void) val;
+	(void) rate;
+	(void) gain;
+	(void) buffer;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* DIGITAL INPUTS AND OUTPUTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Starts the digital output sequence triggered by a sample, which has no outputs to switch.
+ */
+void TriggerDigitalOutputSequence(void) {
+}
+
+/**
+ * Reads the levels of the digital inputs, all low.
+ */
+uint32_t ReadDigitalInputLevels(void) {
+	return 0U;
+}
+
+/**
+ * Reads the level of a digital input, low.
+ */
+DigitalLevel_t ReadDigitalInputLevel(const Digital_Input_t* input) {
+	(void) input;
+	return LOGIC_LOW;
+}
+
+/**
+ * Retrieves the levels of the digital outputs, all off.
+ */
+DigitalOutputMask_t GetDigitalOutputLevels(void) {
+	return 0U;
+}
+
+/**
+ * Passes an analog sample to the digital output interlocks, of which there are none.
+ */
+void DigitalInterlock_ProcessAnalog(PhysicalAnalogInput_t input, int32_t value, uint64_t timestamp) {
+	(void) input;
+	(void) value;
+	(void) timestamp;
+}
+
+/**
+ * Resets the digital output PID loops, of which there are none.
+ */
+void DigitalPID_Reset(void) {
+}
+
+/**
+ * Holds the digital output PID loops, of which there are none.
+ */
+void DigitalPID_Hold(void) {
+}
+
+/**
+ * Passes an analog sample to the digital output PID loops, of which there are none.
+ */
+void DigitalPID_Process(PhysicalAnalogInput_t input, int32_t value) {
+	(void) input;
+	(void) value;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* AUXILIARY ANALOG INPUTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Converts an auxiliary input's reading to millivolts. The auxiliary inputs are not simulated.
+ */
+uint32_t AnalogAux_ToMillivolts(uint8_t input, uint16_t value) {
+	(void) input;
+	(void) value;
+	return 0U;
+}
+
+/**
+ * Retrieves the name of an auxiliary input.
+ */
+const char* AnalogAux_GetName(uint8_t input) {
+	(void) input;
+	return "";
+}
+
+/**
+ * Indicates if the auxiliary inputs are captured with the samples, which they are not.
+ */
+bool AnalogAux_IsEnabled(void) {
+	return false;
+}
+
+/**
+ * Resets the auxiliary input capture.
+ */
+void AnalogAux_Reset(void) {
+}
+
+/**
+ * Captures the auxiliary inputs.
+ */
+void AnalogAux_Capture(uint64_t timestamp) {
+	(void) timestamp;
+}
+
+/**
+ * Indicates if auxiliary input captures are waiting to be reported, which they never are.
+ */
+bool AnalogAux_IsPending(void) {
+	return false;
+}
+
+/**
+ * Retrieves the auxiliary input captures waiting to be reported, of which there are none.
+ */
+uint32_t AnalogAux_PeekStates(const AnalogAuxState_t** oldest) {
+	*oldest = NULL;
+	return 0U;
+}
+
+/**
+ * Releases reported auxiliary input captures.
+ */
+void AnalogAux_ReleaseStates(uint32_t count) {
+	(void) count;
+}
+
+/**
+ * Retrieves the number of auxiliary input captures dropped.
+ */
+uint32_t AnalogAux_GetDroppedCount(void) {
+	return 0U;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EEPROM */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Reads a variable from the emulated EEPROM, which holds none.
+ */
+uint16_t EE_ReadVariable(uint16_t VirtAddress, uint16_t* Data) {
+	(void) VirtAddress;
+	(void) Data;
+	return 1U;
+}
+
+/**
+ * Queues a write of a variable to the emulated EEPROM, which is dropped.
+ */
+uint16_t EE_QueueWrite(uint16_t VirtAddress, uint16_t Data) {
+	(void) VirtAddress;
+	(void) Data;
+	return FLASH_COMPLETE;
+}
@@ -388,13 +388,13 @@ typedef enum {
   ((SPS) == ADS1256_SPS_3750) || \
   ((SPS) == ADS1256_SPS_2000)|| \
   ((SPS) == ADS1256_SPS_1000) || \
-  ((SPS) == ADS1256_SPS_500)) || \
+  ((SPS) == ADS1256_SPS_500) || \
   ((SPS) == ADS1256_SPS_100) || \
   ((SPS) == ADS1256_SPS_60) || \
   ((SPS) == ADS1256_SPS_50) || \
   ((SPS) == ADS1256_SPS_30)|| \
   ((SPS) == ADS1256_SPS_25) || \
-  ((SPS) == ADS1256_SPS_15)) || \
+  ((SPS) == ADS1256_SPS_15) || \
   ((SPS) == ADS1256_SPS_10) || \
   ((SPS) == ADS1256_SPS_5) || \
   ((SPS) == ADS1256_SPS_2_5))
@@ -534,6 +534,40 @@ typedef enum {
 #define IS_ADS1256_REGISTER_COMMAND(CMD) (((CMD) == ADS1256_RREG)|| \
   ((CMD) == ADS1256_WREG))
 
+/*--------------------------------------------------------------------------------------------------------*/
+/* CALLBACK TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Function called from interrupt context when an asynchronous data read has completed.
+ *
+ * @param value int32_t The converted ADC reading.
+ */
+typedef void (*ADS1256_MeasurementCallback)(int32_t value);
+
+/**
+ * @brief Function called from the DRDY interrupt as soon as a conversion is latched, before it is read.
+ */
+typedef void (*ADS1256_LatchCallback)(void);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* REGISTER IMAGE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief ADS1256 register image structure.
+ * The precomputed register contents for a set of conversion settings, built once so that switching between
+ * settings only costs a comparison with the local registers and a single burst write of those which differ.
+ * The input multiplexer and GPIO are not part of the image and keep their current values.
+ */
+typedef struct {
+	uint8_t status; /**< The STATUS bits set by the image, the input buffer enable. */
+	uint8_t adcon; /**< The ADCON bits set by the image, the PGA gain. */
+	uint8_t drate; /**< The DRATE register. */
+	uint8_t offset[3]; /**< The OFC0 - OFC2 registers. */
+	uint8_t gain[3]; /**< The FSC0 - FSC2 registers. */
+} ADS1256_RegisterImage_t;
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* INITIALIZATION METHODS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -548,6 +582,16 @@ void ADS1256_Init(void);
  */
 void ADS1256_StatePins_Init(void);
 
+/**
+ * @brief Selects the ADS1256 which the driver methods operate on.
+ */
+bool ADS1256_SelectDevice(uint8_t device);
+
+/**
+ * @brief Retrieves the index of the selected ADS1256.
+ */
+uint8_t ADS1256_GetSelectedDevice(void);
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* STRING METHODS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -576,6 +620,11 @@ const char* ADS1256_StringFromPGA(ADS1256_PGA_t pga);
  */
 const char* ADS1256_StringFromBuffer(ADS1256_BUFFER_t buffer);
 
+/**
+ * @brief Return the human readable string representation of the provided analog input channel.
+ */
+const char* ADS1256_StringFromAIN(ADS1256_AIN_t ain);
+
 /**
  * @brief Convert a human readable string into the relevant ADS1256_BUFFER_t value.
  */
@@ -643,6 +692,61 @@ void ADS1256_RequestMeasurement(void);
  */
 void ADS1256_ReadData(uint8_t* data);
 
+/**
+ * @brief Start reading the 3-byte data via DMA without blocking.
+ */
+bool ADS1256_BeginReadData(ADS1256_MeasurementCallback callback);
+
+/**
+ * @brief Checks if an asynchronous data read is in progress.
+ */
+bool ADS1256_IsReadPending(void);
+
+/**
+ * @brief Enable the DRDY interrupt, reading each conversion via DMA as it completes.
+ */
+void ADS1256_EnableDataReadyInterrupt(ADS1256_MeasurementCallback callback);
+
+/**
+ * @brief Sets the function the DRDY interrupt calls as soon as each conversion is latched, before reading it.
+ */
+void ADS1256_SetDataLatchedCallback(ADS1256_LatchCallback callback);
+
+/**
+ * @brief Disable the DRDY interrupt and wait for any in progress read to finish.
+ */
+void ADS1256_DisableDataReadyInterrupt(void);
+
+/**
+ * @brief Mask the DRDY interrupt without waiting. Safe to call from interrupt context.
+ */
+void ADS1256_MaskDataReadyInterrupt(void);
+
+/**
+ * @brief Request that DRDY interrupt reads use continuous read (RDATAC) mode.
+ */
+void ADS1256_SetContinuousRead(bool enable);
+
+/**
+ * @brief Checks if the ADC is currently in continuous read (RDATAC) mode.
+ */
+bool ADS1256_IsContinuousRead(void);
+
+/**
+ * @brief Take the ADC out of continuous read (RDATAC) mode.
+ */
+void ADS1256_StopContinuousRead(void);
+
+/**
+ * @brief Interrupt handler for the DRDY external interrupt line.
+ */
+void ADS1256_DRDY_IRQHandler(void) RAM_FUNCTION;
+
+/**
+ * @brief Retrieve the time at which DRDY last signaled a completed conversion.
+ */
+uint64_t ADS1256_GetDataReadyTime(void);
+
 /**
  * @brief Wait in a loop until data is ready.
  */
@@ -658,6 +762,11 @@ bool ADS1256_IsDataReady(bool useCommand);
  */
 void ADS1256_Sync(bool useCommand);
 
+/**
+ * @brief Restarts the conversion from the SYNC pin.
+ */
+void ADS1256_SyncPulse(void);
+
 /**
  * @brief Wakeup the ADC from SYNC/PWDN.
  */
@@ -672,6 +781,16 @@ void ADS1256_Standby(void);
 /* CALIBRATION METHODS */
 /*--------------------------------------------------------------------------------------------------------*/
 
+/**
+ * @brief Starts a calibration of the ADC without waiting for it to complete.
+ */
+void ADS1256_StartCalibration(ADS1256_Command_t cmd);
+
+/**
+ * @brief Completes a calibration once the ADC has signaled it is finished.
+ */
+void ADS1256_FinishCalibration(void);
+
 /**
  * @brief Performs a complete self calibration of the ADC.
  */
@@ -705,6 +824,16 @@ void ADS1256_CalibrateSystem_Offset(void);
  */
 int32_t ADS1256_ConvertRawValue(uint32_t value);
 
+/**
+ * @brief Converts a block of packed raw ADC outputs into signed integers.
+ */
+void ADS1256_ConvertRawBlock(const uint8_t* raw, int32_t* values, uint32_t count);
+
+/**
+ * @brief Applies an offset and fixed point gain to a block of converted ADC outputs.
+ */
+void ADS1256_ScaleBlock(int32_t* values, uint32_t count, int32_t offset, int32_t gain, uint8_t shift);
+
 /**
  * @brief Retrieves the total self calibration time.
  */
@@ -730,6 +859,11 @@ float ADS1256_GetSystemGainCalTime(void);
  */
 float ADS1256_GetSettlingTime(void);
 
+/**
+ * @brief Retrieves the settling time of the ADC at a data rate.
+ */
+float ADS1256_GetSettlingTimeForRate(ADS1256_SPS_t rate);
+
 /**
  * @brief Selects remote register auto-fetch behavior.
  */
@@ -798,6 +932,11 @@ void ADS1256_GetInputChannels(void);
  */
 void ADS1256_SetInputChannels(ADS1256_AIN_t pos, ADS1256_AIN_t neg);
 
+/**
+ * @brief Set the currently selected input channels and the state of GPIO output pins in a single register write.
+ */
+void ADS1256_SetInputChannelsAndGPIO(ADS1256_AIN_t pos, ADS1256_AIN_t neg, uint8_t mask, uint8_t status);
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* ADCON REGISTER METHODS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -903,6 +1042,25 @@ uint32_t ADS1256_GetGainCalSetting(void);
  */
 void ADS1256_SetGainCalSetting(uint8_t* value);
 
+/*--------------------------------------------------------------------------------------------------------*/
+/* REGISTER IMAGE METHODS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Builds the register image for the provided conversion settings.
+ */
+void ADS1256_BuildRegisterImage(ADS1256_RegisterImage_t* image, ADS1256_BUFFER_t buffer, ADS1256_PGA_t gain, ADS1256_SPS_t rate);
+
+/**
+ * @brief Sets the calibration values of a register image.
+ */
+void ADS1256_SetRegisterImageCalibration(ADS1256_RegisterImage_t* image, uint32_t offset, uint32_t gain);
+
+/**
+ * @brief Loads a register image into the ADC, writing only the registers which differ.
+ */
+void ADS1256_LoadRegisterImage(const ADS1256_RegisterImage_t* image);
+
 /**
  * @}
  */
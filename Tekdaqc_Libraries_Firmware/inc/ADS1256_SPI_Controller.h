@@ -37,6 +37,8 @@ extern "C" {
 #include "stm32f4xx.h"
 #include "stm32f4xx_gpio.h"
 #include "Tekdaqc_Debug.h"
+#include "Tekdaqc_BSP.h"
+#include "boolean.h"
 
 /** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
  * @{
@@ -62,6 +64,24 @@ extern "C" {
  * */
 #define ADS1256_CS_HIGH()      (GPIO_SetBits(ADS1256_CS_GPIO_PORT, ADS1256_CS_PIN))
 
+/**
+ * @def ADS1256_SPI_DMA_THRESHOLD
+ * @brief The minimum number of bytes in a transfer before the blocking methods hand it to the DMA engine.
+ */
+#define ADS1256_SPI_DMA_THRESHOLD   2U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Function called from interrupt context when a DMA transfer with the ADS1256 has completed.
+ *
+ * @param data uint8_t* Pointer to the receive buffer of the transfer, or NULL if the received bytes were discarded.
+ * @param n uint8_t The number of bytes which were transferred.
+ */
+typedef void (*ADS1256_SPI_TransferCallback)(uint8_t* data, uint8_t n);
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* INITIALIZATION METHODS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -97,7 +117,7 @@ void ADS1256_GPIO_To_CLK(void);
 /*
  * @brief Send a byte over the SPI line.
  */
-uint8_t ADS1256_SendByte(uint8_t data);
+uint8_t ADS1256_SendByte(uint8_t data) RAM_FUNCTION;
 
 /**
  * @brief Send an array of bytes over the SPI line.
@@ -107,13 +127,33 @@ void ADS1256_SendBytes(uint8_t* data, uint8_t n);
 /**
  * @brief Receive a byte over the SPI line.
  */
-uint8_t ADS1256_ReceiveByte(void);
+uint8_t ADS1256_ReceiveByte(void) RAM_FUNCTION;
 
 /**
  * @brief Receive an array of bytes over the SPI line.
  */
 void ADS1256_ReceiveBytes(uint8_t* data, uint8_t n);
 
+/**
+ * @brief Start a non-blocking full duplex DMA transfer over the SPI line.
+ */
+bool ADS1256_TransferBytes_DMA(uint8_t* tx, uint8_t* rx, uint8_t n, ADS1256_SPI_TransferCallback callback);
+
+/**
+ * @brief Checks if a DMA transfer is currently in progress.
+ */
+bool ADS1256_SPI_IsBusy(void);
+
+/**
+ * @brief Wait until any in progress DMA transfer has completed.
+ */
+void ADS1256_SPI_WaitForTransfer(void);
+
+/**
+ * @brief Interrupt handler for the SPI receive DMA stream.
+ */
+void ADS1256_SPI_DMA_IRQHandler(void) RAM_FUNCTION;
+
 #ifdef __cplusplus
 }
 #endif
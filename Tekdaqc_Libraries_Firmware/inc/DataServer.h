@@ -0,0 +1,185 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file DataServer.h
+ * @brief Header file for the sample data server of the Tekdaqc.
+ *
+ * Contains public definitions and data types for the Tekdaqc sample data server. The data server is a raw TCP
+ * stream which carries only sample data, leaving the Telnet server as the command and status channel.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef DATA_SERVER_H_
+#define DATA_SERVER_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+#include "Tekdaqc_Debug.h"
+#include "Tekdaqc_Config.h"
+#include <boolean.h>
+#include "lwip/tcp.h"
+
+/** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
+ * @{
+ */
+
+/** @addtogroup data_server Data Server
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def DATA_TX_SEGMENT_SIZE
+ * @brief The size of each segment of the transmit ring. One segment fills a single TCP packet.
+ */
+#define DATA_TX_SEGMENT_SIZE TCP_MSS
+
+/**
+ * @def DATA_TX_SEGMENT_COUNT
+ * @brief The number of segments in the transmit ring. Twice enough to fill the lwIP send buffer, so the stream can
+ * ride out a longer stall of the client.
+ */
+#define DATA_TX_SEGMENT_COUNT ((uint32_t) (2U * (TCP_SND_BUF / TCP_MSS)))
+
+/**
+ * @def DATA_FLUSH_LATENCY_DEFAULT_US
+ * @brief The default time in microseconds data may wait in the transmit ring for a full segment to accumulate.
+ */
+#define DATA_FLUSH_LATENCY_DEFAULT_US ((uint32_t) 2000U)
+
+/**
+ * @def DATA_NO_DELAY_DEFAULT
+ * @brief The default no delay setting. The stream is bulk data, so Nagle's algorithm is left to coalesce the partial
+ * segments of flushes.
+ */
+#define DATA_NO_DELAY_DEFAULT false
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Data server status enumeration.
+ * The possible success/error causes for the data server's operation.
+ */
+typedef enum {
+	DATA_SERVER_OK, /**< Everything is normal with the data server. */
+	DATA_SERVER_ERR_BIND, /**< There was an error binding a socket to a port for the data server. */
+	DATA_SERVER_ERR_PCBCREATE /**< There was an error creating a PCB structure for the data server. */
+} DataServerStatus_t;
+
+/**
+ * @brief Data server transmit segment structure.
+ * A single segment of the transmit ring. Data is handed to lwIP by reference, so the bytes of a segment which
+ * have been queued must not be modified until the client has ACKed them.
+ */
+typedef struct {
+	unsigned char data[DATA_TX_SEGMENT_SIZE]; /**< The data to be transmitted to the client. */
+	uint16_t length; /**< The number of bytes of valid data in the segment. */
+	uint16_t queued; /**< The number of bytes which have been handed to lwIP for transmission. */
+	uint16_t acked; /**< The number of bytes which have been ACKed by the client. */
+} DataTxSegment_t;
+
+/**
+ * @brief Data structure to hold the state of the data server.
+ * Contains all of the necessary state variables to impliment the data server. Direct manipulation of these
+ * members is not recommended as it may leave the server in an inconsistent state.
+ */
+typedef struct {
+	struct tcp_pcb* pcb; /**< A pointer to the data session PCB data structure. */
+	DataTxSegment_t segments[DATA_TX_SEGMENT_COUNT]; /**< The ring of segments used to transmit data to the client. */
+	uint8_t txHead; /**< The index of the segment currently being filled. */
+	uint8_t txTail; /**< The index of the oldest segment which has not yet been released. */
+	uint8_t txUsed; /**< The number of segments between txTail and txHead, inclusive. */
+	uint16_t unsent; /**< The number of bytes in the transmit ring which have not been handed to lwIP. */
+	uint64_t unsentSince; /**< The local time at which the oldest unsent byte was written. */
+	uint64_t ackedAt; /**< The local time the client last ACKed data, for detecting a client which has gone. */
+} DataServer_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Creates the TCP listener for the data server.
+ */
+DataServerStatus_t InitializeDataServer(void);
+
+/**
+ * @brief Indicates if a client is connected to the data server.
+ */
+bool DataServerIsConnected(void);
+
+/**
+ * @brief Closes the data server's client connection.
+ */
+void DataServerClose(void);
+
+/**
+ * @brief Called from the main loop to send pending data once the flush policy allows it.
+ */
+void DataServerService(void);
+
+/**
+ * @brief Sets the time data may wait in the transmit ring before it is sent.
+ */
+void DataServerSetFlushLatency(uint32_t latency);
+
+/**
+ * @brief Sets whether the connection sends without delay.
+ */
+void DataServerSetNoDelay(bool enable);
+
+/**
+ * @brief Retrieves the number of bytes sent over the data connection since start up.
+ */
+uint32_t DataServerGetBytesSent(void);
+
+/**
+ * @brief Writes a sample record string to the data server.
+ */
+WriteStatus_t DataServerWriteString(char* string);
+
+/**
+ * @brief Writes a block of binary sample data to the data server.
+ */
+WriteStatus_t DataServerWriteBinary(const uint8_t* data, uint16_t length);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DATA_SERVER_H_ */
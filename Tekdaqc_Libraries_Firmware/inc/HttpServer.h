@@ -0,0 +1,173 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file HttpServer.h
+ * @brief Header file for the HTTP download server of the Tekdaqc.
+ *
+ * Contains public definitions and data types for the Tekdaqc HTTP download server. The server only handles the HTTP
+ * framing, the documents it serves are provided by the application through a table of HttpResource_t. A document
+ * may instead hand its connection over to another protocol, as the WebSocket server does.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef HTTP_SERVER_H_
+#define HTTP_SERVER_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+#include "Tekdaqc_Debug.h"
+#include <boolean.h>
+#include "lwip/tcp.h"
+
+/** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
+ * @{
+ */
+
+/** @addtogroup http_server HTTP Server
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def HTTP_MAX_REQUEST_SIZE
+ * @brief The largest request line and headers accepted, larger requests are answered with 400 Bad Request.
+ */
+#define HTTP_MAX_REQUEST_SIZE 512U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief HTTP server status enumeration.
+ * The possible success/error causes for the HTTP server's operation.
+ */
+typedef enum {
+	HTTP_SERVER_OK, /**< Everything is normal with the HTTP server. */
+	HTTP_SERVER_ERR_BIND, /**< There was an error binding a socket to a port for the HTTP server. */
+	HTTP_SERVER_ERR_PCBCREATE /**< There was an error creating a PCB structure for the HTTP server. */
+} HttpServerStatus_t;
+
+/**
+ * @brief Function pointer to prepare a document for a request.
+ * Returns FALSE if the document can not be served right now, which is answered with 503 Service Unavailable.
+ */
+typedef bool (*HttpOpenFunction)(void);
+
+/**
+ * @brief Function pointer to read a document.
+ * Points data at the bytes of the document starting at offset and sets length to how many follow contiguously there,
+ * 0 at the end of the document. They must remain valid until the next call. Returns FALSE if the document can no
+ * longer be read, which aborts the connection so the client sees the transfer fail.
+ */
+typedef bool (*HttpReadFunction)(uint32_t offset, const uint8_t** data, uint32_t* length);
+
+/**
+ * @brief HTTP upgrade result enumeration.
+ * The possible results of an HttpUpgradeFunction.
+ */
+typedef enum {
+	HTTP_UPGRADE_OK, /**< The connection was taken over, the HTTP server forgets it. */
+	HTTP_UPGRADE_BAD_REQUEST, /**< The request can not be upgraded, answered with 400 Bad Request. */
+	HTTP_UPGRADE_UNAVAILABLE /**< The request can not be upgraded right now, answered with 503 Service Unavailable. */
+} HttpUpgradeResult_t;
+
+/**
+ * @brief Function pointer to take a connection over from the HTTP server.
+ * Called with the query string of the request, after the '?' or empty, and its headers. On success the function
+ * has set its own callbacks on the PCB and answered the request itself.
+ */
+typedef HttpUpgradeResult_t (*HttpUpgradeFunction)(struct tcp_pcb* pcb, const char* query, const char* headers);
+
+/**
+ * @brief A document served by the HTTP server.
+ * The functions are called from the main loop.
+ */
+typedef struct {
+	const char* path; /**< The path the document is requested by, starting with '/'. */
+	const char* contentType; /**< The media type sent in the Content-Type header. */
+	HttpOpenFunction open; /**< Called before the response is started, NULL if the document is always available. */
+	HttpReadFunction read; /**< Reads the document as it is sent. */
+	HttpUpgradeFunction upgrade; /**< Takes the connection over in place of sending a document, NULL for none. */
+} HttpResource_t;
+
+/**
+ * @brief HTTP connection state enumeration.
+ */
+typedef enum {
+	HTTP_CONNECTION_FREE, /**< The slot is not in use. */
+	HTTP_CONNECTION_REQUEST, /**< The request is being received. */
+	HTTP_CONNECTION_BODY, /**< The document is being sent. */
+	HTTP_CONNECTION_DONE /**< The response has been queued, the connection closes once it has been sent. */
+} HttpConnectionState_t;
+
+/**
+ * @brief Data structure holding the state of an HTTP client connection.
+ */
+typedef struct {
+	struct tcp_pcb* pcb; /**< The connection's PCB, NULL if the slot is free. */
+	HttpConnectionState_t state; /**< The progress of the connection. */
+	char request[HTTP_MAX_REQUEST_SIZE]; /**< The bytes of the request received so far. */
+	uint16_t length; /**< The number of bytes in request. */
+	const HttpResource_t* resource; /**< The document being sent. */
+	uint32_t offset; /**< The number of bytes of the document queued. */
+	uint64_t ackedAt; /**< The time of the last acknowledgement from the client, in microseconds. */
+} HttpConnection_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Creates the TCP listener for the HTTP server.
+ */
+HttpServerStatus_t InitializeHttpServer(const HttpResource_t* resources, uint8_t count);
+
+/**
+ * @brief Closes the HTTP client connection.
+ */
+void HttpServerCloseAll(void);
+
+/**
+ * @brief Retrieves the number of requests the HTTP server has answered since start up.
+ */
+uint32_t HttpServerGetRequestCount(void);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HTTP_SERVER_H_ */
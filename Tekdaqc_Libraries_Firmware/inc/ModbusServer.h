@@ -0,0 +1,184 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file ModbusServer.h
+ * @brief Header file for the Modbus TCP server of the Tekdaqc.
+ *
+ * Contains public definitions and data types for the Tekdaqc Modbus TCP server. The server only handles the Modbus
+ * framing, the coils, discrete inputs and registers it serves are provided by the application through a
+ * ModbusMap_t.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef MODBUS_SERVER_H_
+#define MODBUS_SERVER_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+#include "Tekdaqc_Debug.h"
+#include <boolean.h>
+#include "lwip/tcp.h"
+
+/** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
+ * @{
+ */
+
+/** @addtogroup modbus_server Modbus Server
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def MODBUS_MAX_CONNECTIONS
+ * @brief The number of clients which may be connected at once. Further connections are refused.
+ */
+#define MODBUS_MAX_CONNECTIONS 2U
+
+/**
+ * @def MODBUS_MAX_FRAME_SIZE
+ * @brief The largest Modbus TCP frame, the 7 byte MBAP header and a 253 byte PDU.
+ */
+#define MODBUS_MAX_FRAME_SIZE 260U
+
+/**
+ * @def MODBUS_MAX_READ_BITS
+ * @brief The most coils or discrete inputs a single request may read.
+ */
+#define MODBUS_MAX_READ_BITS 2000U
+
+/**
+ * @def MODBUS_MAX_WRITE_BITS
+ * @brief The most coils a single request may write.
+ */
+#define MODBUS_MAX_WRITE_BITS 1968U
+
+/**
+ * @def MODBUS_MAX_READ_REGISTERS
+ * @brief The most registers a single request may read.
+ */
+#define MODBUS_MAX_READ_REGISTERS 125U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Modbus server status enumeration.
+ * The possible success/error causes for the Modbus server's operation.
+ */
+typedef enum {
+	MODBUS_SERVER_OK, /**< Everything is normal with the Modbus server. */
+	MODBUS_SERVER_ERR_BIND, /**< There was an error binding a socket to a port for the Modbus server. */
+	MODBUS_SERVER_ERR_PCBCREATE /**< There was an error creating a PCB structure for the Modbus server. */
+} ModbusServerStatus_t;
+
+/**
+ * @brief Modbus exception code enumeration.
+ * The results a ModbusMap_t function may report for a request, MODBUS_EXCEPTION_NONE for success.
+ */
+typedef enum {
+	MODBUS_EXCEPTION_NONE = 0x00U, /**< The request was carried out. */
+	MODBUS_EXCEPTION_ILLEGAL_FUNCTION = 0x01U, /**< The function is not supported. */
+	MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS = 0x02U, /**< Part of the addressed range does not exist. */
+	MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE = 0x03U, /**< A value in the request is not allowed. */
+	MODBUS_EXCEPTION_SERVER_DEVICE_FAILURE = 0x04U /**< The request could not be carried out. */
+} ModbusException_t;
+
+/**
+ * @brief Function pointer to read a range of registers.
+ * Fills in quantity registers starting at address.
+ */
+typedef ModbusException_t (*ModbusReadRegistersFunction)(uint16_t address, uint16_t quantity, uint16_t* registers);
+
+/**
+ * @brief Function pointer to read a range of coils or discrete inputs.
+ * Sets the bits of the ON points in the zeroed bits array, packed least significant bit first as in the response.
+ */
+typedef ModbusException_t (*ModbusReadBitsFunction)(uint16_t address, uint16_t quantity, uint8_t* bits);
+
+/**
+ * @brief Function pointer to write a range of coils.
+ * The values are packed least significant bit first as in the request.
+ */
+typedef ModbusException_t (*ModbusWriteBitsFunction)(uint16_t address, uint16_t quantity, const uint8_t* bits);
+
+/**
+ * @brief The data served by the Modbus server.
+ * Functions which are NULL answer their requests with MODBUS_EXCEPTION_ILLEGAL_FUNCTION. They are called from the
+ * main loop.
+ */
+typedef struct {
+	ModbusReadBitsFunction readCoils; /**< Serves function 0x01, Read Coils. */
+	ModbusReadBitsFunction readDiscreteInputs; /**< Serves function 0x02, Read Discrete Inputs. */
+	ModbusReadRegistersFunction readHoldingRegisters; /**< Serves function 0x03, Read Holding Registers. */
+	ModbusReadRegistersFunction readInputRegisters; /**< Serves function 0x04, Read Input Registers. */
+	ModbusWriteBitsFunction writeCoils; /**< Serves functions 0x05 and 0x0F, Write Single and Multiple Coils. */
+} ModbusMap_t;
+
+/**
+ * @brief Data structure holding the state of a Modbus client connection.
+ * Requests may arrive split over, or packed several to, TCP segments, so they are gathered here until complete.
+ */
+typedef struct {
+	struct tcp_pcb* pcb; /**< The connection's PCB, NULL if the slot is free. */
+	uint8_t request[MODBUS_MAX_FRAME_SIZE]; /**< The bytes received towards the next request. */
+	uint16_t length; /**< The number of bytes in request. */
+} ModbusConnection_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Creates the TCP listener for the Modbus server.
+ */
+ModbusServerStatus_t InitializeModbusServer(const ModbusMap_t* map);
+
+/**
+ * @brief Closes every Modbus client connection.
+ */
+void ModbusServerCloseAll(void);
+
+/**
+ * @brief Retrieves the number of requests the Modbus server has answered since start up.
+ */
+uint32_t ModbusServerGetRequestCount(void);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MODBUS_SERVER_H_ */
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file RawStream.h
+ * @brief Header file for the raw Ethernet sample stream of the Tekdaqc.
+ *
+ * Contains public definitions for the Tekdaqc raw Ethernet stream, which sends sequence numbered frames of sample
+ * data with a custom EtherType straight to the Ethernet DMA, for dedicated point to point acquisition links.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef RAW_STREAM_H_
+#define RAW_STREAM_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+#include "Tekdaqc_Debug.h"
+#include "Tekdaqc_Config.h"
+#include <boolean.h>
+
+/** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
+ * @{
+ */
+
+/** @addtogroup raw_stream Raw Ethernet Stream
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def RAW_STREAM_ETHERTYPE
+ * @brief The EtherType of the stream's frames, the IEEE 802 local experimental EtherType 1.
+ */
+#define RAW_STREAM_ETHERTYPE 0x88B5U
+
+/**
+ * @def RAW_STREAM_HEADER_SIZE
+ * @brief The size of the header of each frame: the Ethernet header, the sequence number and the payload length.
+ */
+#define RAW_STREAM_HEADER_SIZE 20U
+
+/**
+ * @def RAW_STREAM_FRAME_SIZE
+ * @brief The maximum size of a frame including its headers, a full 1500 byte Ethernet payload.
+ */
+#define RAW_STREAM_FRAME_SIZE 1514U
+
+/**
+ * @def RAW_STREAM_FRAME_COUNT
+ * @brief The number of frame buffers, one being filled while the others are transmitted.
+ */
+#define RAW_STREAM_FRAME_COUNT 4U
+
+/**
+ * @def RAW_STREAM_ADDRESS_LENGTH
+ * @brief The length of an Ethernet MAC address.
+ */
+#define RAW_STREAM_ADDRESS_LENGTH 6U
+
+/**
+ * @def RAW_STREAM_LATENCY_DEFAULT_US
+ * @brief The default time in microseconds a partial frame may wait for more samples before it is sent.
+ */
+#define RAW_STREAM_LATENCY_DEFAULT_US ((uint32_t) 2000U)
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Starts streaming sample data to the provided MAC address.
+ */
+void RawStreamStart(const uint8_t* address);
+
+/**
+ * @brief Stops streaming sample data.
+ */
+void RawStreamStop(void);
+
+/**
+ * @brief Indicates if sample data is currently being streamed.
+ */
+bool RawStreamIsActive(void);
+
+/**
+ * @brief Called from the main loop to send the current frame once it is due.
+ */
+void RawStreamService(void);
+
+/**
+ * @brief Sets the time a partial frame may wait for more samples before it is sent.
+ */
+void RawStreamSetLatency(uint32_t latency);
+
+/**
+ * @brief Retrieves the number of bytes of frames streamed since start up.
+ */
+uint32_t RawStreamGetBytesSent(void);
+
+/**
+ * @brief Adds a sample record string to the current frame.
+ */
+WriteStatus_t RawStreamWriteString(char* string);
+
+/**
+ * @brief Adds a block of binary sample data to the current frame.
+ */
+WriteStatus_t RawStreamWriteBinary(const uint8_t* data, uint16_t length);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RAW_STREAM_H_ */
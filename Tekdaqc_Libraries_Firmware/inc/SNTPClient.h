@@ -0,0 +1,130 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file SNTPClient.h
+ * @brief Header file for the SNTP client of the Tekdaqc.
+ *
+ * Contains public definitions for the Tekdaqc SNTP client, which synchronizes the mapping of local time to epoch time
+ * with a time server so that the samples of several boards can be lined up.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef SNTP_CLIENT_H_
+#define SNTP_CLIENT_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+#include "Tekdaqc_Debug.h"
+#include <boolean.h>
+#include "lwip/ip_addr.h"
+
+/** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
+ * @{
+ */
+
+/** @addtogroup sntp_client SNTP Client
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def SNTP_PORT
+ * @brief The UDP port of the time server.
+ */
+#define SNTP_PORT 123U
+
+/**
+ * @def SNTP_POLL_INTERVAL_US
+ * @brief The time in microseconds between queries of the time server once synchronized.
+ */
+#define SNTP_POLL_INTERVAL_US ((uint64_t) 16000000U)
+
+/**
+ * @def SNTP_RETRY_INTERVAL_US
+ * @brief The time in microseconds between queries of the time server until synchronized.
+ */
+#define SNTP_RETRY_INTERVAL_US ((uint64_t) 2000000U)
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief SNTP client status data structure.
+ * Holds the state of the synchronization with the time server.
+ */
+typedef struct {
+	bool synchronized; /**< Indicates if the time base has been synchronized. */
+	uint32_t updates; /**< The number of responses used to discipline the time base. */
+	int32_t offset; /**< The error of the time base found by the last response, in microseconds. */
+	uint32_t delay; /**< The round trip delay of the last response, in microseconds. */
+	int32_t drift; /**< The frequency correction of the time base, in parts per billion. */
+} SNTPClientStatus_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Creates the UDP port used by the SNTP client and loads the saved time server.
+ */
+void SNTPClientInit(void);
+
+/**
+ * @brief Sets and saves the time server to synchronize with.
+ */
+bool SNTPClientSetServer(const ip_addr_t* server);
+
+/**
+ * @brief Retrieves the time server being synchronized with.
+ */
+bool SNTPClientGetServer(ip_addr_t* server);
+
+/**
+ * @brief Retrieves the state of the synchronization with the time server.
+ */
+void SNTPClientGetStatus(SNTPClientStatus_t* status);
+
+/**
+ * @brief Called from the main loop to query the time server once it is due.
+ */
+void SNTPClientService(void);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SNTP_CLIENT_H_ */
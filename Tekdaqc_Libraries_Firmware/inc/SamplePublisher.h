@@ -0,0 +1,148 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file SamplePublisher.h
+ * @brief Header file for the UDP sample publisher of the Tekdaqc.
+ *
+ * Contains public definitions for the Tekdaqc sample publisher, which sends sequence numbered batches of sample data
+ * to a unicast or multicast UDP destination so any number of hosts can subscribe to the same stream.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef SAMPLE_PUBLISHER_H_
+#define SAMPLE_PUBLISHER_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+#include "Tekdaqc_Debug.h"
+#include "Tekdaqc_Config.h"
+#include <boolean.h>
+#include "lwip/ip_addr.h"
+
+/** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
+ * @{
+ */
+
+/** @addtogroup sample_publisher Sample Publisher
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def PUBLISH_HEADER_SIZE
+ * @brief The size of the header of each published batch, holding its little endian 32 bit sequence number.
+ */
+#define PUBLISH_HEADER_SIZE 4U
+
+/**
+ * @def PUBLISH_BATCH_SIZE
+ * @brief The maximum size of a published batch including its header. Sized to fit a single Ethernet frame.
+ */
+#define PUBLISH_BATCH_SIZE 1400U
+
+/**
+ * @def PUBLISH_HISTORY_COUNT
+ * @brief The number of sent batches kept so subscribers can request ones they missed.
+ */
+#define PUBLISH_HISTORY_COUNT 4U
+
+/**
+ * @def PUBLISH_RESEND_REQUEST
+ * @brief The first byte of a datagram requesting a batch be sent again. It is followed by the little endian 32 bit
+ * sequence number of the batch.
+ */
+#define PUBLISH_RESEND_REQUEST ((uint8_t) 'R')
+
+/**
+ * @def PUBLISH_LATENCY_DEFAULT_US
+ * @brief The default time in microseconds a partial batch may wait for more samples before it is sent.
+ */
+#define PUBLISH_LATENCY_DEFAULT_US ((uint32_t) 2000U)
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Creates the UDP port used by the sample publisher.
+ */
+void SamplePublisherInit(void);
+
+/**
+ * @brief Starts publishing sample data to the provided destination.
+ */
+void SamplePublisherStart(const ip_addr_t* address, uint16_t port);
+
+/**
+ * @brief Stops publishing sample data.
+ */
+void SamplePublisherStop(void);
+
+/**
+ * @brief Indicates if sample data is currently being published.
+ */
+bool SamplePublisherIsActive(void);
+
+/**
+ * @brief Called from the main loop to send the current batch once it is due.
+ */
+void SamplePublisherService(void);
+
+/**
+ * @brief Sets the time a partial batch may wait for more samples before it is sent.
+ */
+void SamplePublisherSetLatency(uint32_t latency);
+
+/**
+ * @brief Retrieves the number of bytes of batches published since start up.
+ */
+uint32_t SamplePublisherGetBytesSent(void);
+
+/**
+ * @brief Adds a sample record string to the current batch.
+ */
+WriteStatus_t SamplePublisherWriteString(char* string);
+
+/**
+ * @brief Adds a block of binary sample data to the current batch.
+ */
+WriteStatus_t SamplePublisherWriteBinary(const uint8_t* data, uint16_t length);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SAMPLE_PUBLISHER_H_ */
@@ -254,6 +254,31 @@ void TLE7232_ReadArbitraryRegisterAll(TLE7232_Register_t reg[NUMBER_TLE7232_CHIP
  */
 void SetOutputFaultStatusFunction(SetOutputFaultStatus func);
 
+/**
+ * @brief Starts a background read of the diagnosis registers of all devices.
+ */
+bool TLE7232_StartDiagnosis_DMA(void);
+
+/**
+ * @brief Starts a DMA write of the specified data to the specified register of all devices.
+ */
+bool TLE7232_WriteRegisterAll_DMA(TLE7232_Register_t reg, uint8_t data[NUMBER_TLE7232_CHIPS]);
+
+/**
+ * @brief Evaluates completed background diagnosis reads and starts the next one when due.
+ */
+bool TLE7232_ServiceDiagnosis(void);
+
+/**
+ * @brief Sets the period of the background diagnosis reads.
+ */
+void TLE7232_SetDiagnosisPeriod(uint32_t period_us);
+
+/**
+ * @brief Handles the background diagnosis DMA stream interrupt.
+ */
+void TLE7232_SPI_DMA_IRQHandler(void);
+
 /**
  * @}
  */
@@ -67,8 +67,113 @@ extern "C" {
  * @{
  */
 
-/* #define TEKDAQC_BOARD_TYPE ((char) 'C') */
-#define TEKDAQC_BOARD_TYPE ((char) 'D')
+/** @addtogroup board_variant Board Variant
+  * @{
+  */
+
+/**
+ * @def TEKDAQC_BOARD_VARIANT
+ * @brief The header describing the wiring of the board variant being built for, as a quoted header name. It provides
+ * TEKDAQC_BOARD_TYPE, NUMBER_TLE7232_CHIPS, the external multiplexer's select lines and the EXTERNAL_MUX_TABLE,
+ * GPI_PORT_TABLE and GPI_PIN_TABLE descriptions, from which the channel counts and every table sized by them follow.
+ * May be defined by the build to target expanded hardware. Left undefined, the standard board is built.
+ */
+#ifndef TEKDAQC_BOARD_VARIANT
+#define TEKDAQC_BOARD_VARIANT "Tekdaqc_Board_Standard.h"
+#endif
+
+#include TEKDAQC_BOARD_VARIANT
+
+/**
+ * @def BOARD_COUNT_ENTRY
+ * @brief Expands any board description table entry to a count of one, so the tables can be counted at compile time.
+ */
+#define BOARD_COUNT_ENTRY(...) + 1U
+
+/**
+ * @}
+ */
+
+/** @addtogroup memory_placement Memory Placement
+  * @{
+  */
+
+/**
+ * @def CCM_DATA
+ * @brief Places a zero initialized variable in the 64K core coupled memory, which only the CPU can reach, so the
+ * acquisition loop's state is never stalled behind DMA traffic. Never use it for anything a DMA stream, the Ethernet
+ * DMA or an lwIP pbuf may reference. The startup code zero fills the section.
+ */
+#define CCM_DATA __attribute__ ((section (".ccmbss")))
+
+/**
+ * @def ETH_DMA_DATA
+ * @brief Places a zero initialized variable in the 16K SRAM2 bank, which is kept for the Ethernet DMA descriptors and
+ * buffers so that Ethernet traffic does not contend with the CPU and the SPI DMA streams for SRAM1, where the stack,
+ * heap and sample pools live. The startup code zero fills the section.
+ */
+#define ETH_DMA_DATA __attribute__ ((section (".sram2"), aligned (4)))
+
+/**
+ * @def RAM_FUNCTION
+ * @brief Places a function in SRAM1, where it runs without FLASH wait states or ART cache misses and keeps running
+ * while the FLASH is being erased or programmed. The core coupled memory cannot hold code. Only worth it for short,
+ * hot code whose callees are RAM functions too, as a call back into FLASH gives up both. The startup code copies the
+ * section from FLASH with the initialized data. Goes after the declarator of the function's prototype.
+ */
+#define RAM_FUNCTION __attribute__ ((section (".RamFunc"), noinline, long_call))
+
+/**
+ * @}
+ */
+
+/** @addtogroup interrupt_priorities Interrupt Priorities
+  * @{
+  */
+
+/*
+ * The preemption plan of every interrupt, with NVIC_PriorityGroup_4 so there are 16 preemption levels and no sub
+ * priorities. Each peripheral's *_PREEMPT_PRIORITY below is one of these levels, never a literal, so the ordering is
+ * decided here alone. Interrupts sharing a level never preempt each other, which is what lets the acquisition
+ * interrupts share the ADS1256 SPI bus without locking. Work too long for an interrupt at its level is handed to the
+ * program loop with Scheduler_Defer(). SysTick_Config() leaves the debounce tick at the lowest level, below all of
+ * these.
+ */
+
+/**
+ * @def IRQ_PRIORITY_TIMEBASE
+ * @brief The level of the time base overflow, a single increment which every sample timestamp depends on.
+ */
+#define IRQ_PRIORITY_TIMEBASE				(0U)
+
+/**
+ * @def IRQ_PRIORITY_ACQUISITION
+ * @brief The level of ADC data capture: the DRDY, SPI DMA, multiplexer settle and snapshot frame interrupts, and the
+ * digital input edges and ethernet link which share the DRDY vector.
+ */
+#define IRQ_PRIORITY_ACQUISITION			(1U)
+
+/**
+ * @def IRQ_PRIORITY_TRIGGER
+ * @brief The level of triggers handed on from other boards, which only flag the next sample so may wait for a capture.
+ */
+#define IRQ_PRIORITY_TRIGGER				(2U)
+
+/**
+ * @def IRQ_PRIORITY_OUTPUT
+ * @brief The level of the digital output drivers and their PWM and sequence tick.
+ */
+#define IRQ_PRIORITY_OUTPUT					(3U)
+
+/**
+ * @def IRQ_PRIORITY_BACKGROUND
+ * @brief The level of communication which can always wait: the ethernet DMA, CAN transmit and the debug log.
+ */
+#define IRQ_PRIORITY_BACKGROUND				(4U)
+
+/**
+ * @}
+ */
 
 /** @addtogroup command_parser Command Parser
   * @{
@@ -107,6 +212,36 @@ extern "C" {
  */
 #define TELNET_PORT 9801U
 
+/**
+ * @def DATA_PORT
+ * @brief The port to use for the sample data server.
+ */
+#define DATA_PORT 9802U
+
+/**
+ * @def PUBLISH_PORT
+ * @brief The port the sample publisher sends from, and the default port it publishes to.
+ */
+#define PUBLISH_PORT 9803U
+
+/**
+ * @def UPGRADE_PORT
+ * @brief The port to use for the firmware upgrade server.
+ */
+#define UPGRADE_PORT 9804U
+
+/**
+ * @def MODBUS_PORT
+ * @brief The port to use for the Modbus TCP server, the port registered for Modbus.
+ */
+#define MODBUS_PORT 502U
+
+/**
+ * @def HTTP_PORT
+ * @brief The port to use for the HTTP download server, the port registered for HTTP.
+ */
+#define HTTP_PORT 80U
+
 /**
  * @}
  */
@@ -121,6 +256,9 @@ extern "C" {
 #define RTC_CONFIGURED_REG			(RTC_BKP_DR19)
 #define RTC_CONFIGURED				0x00000002U
 
+/* Names the supervised task which was running or starved when the watchdog was left to expire */
+#define SUPERVISOR_RECORD_REG		(RTC_BKP_DR18)
+
 /**
  * @}
  */
@@ -134,10 +272,15 @@ extern "C" {
 #define V_REFERENCE	((float) 2.5f)
 #define MAX_CODE 8388607U
 
-#define NUM_ANALOG_INPUTS 37U
-#define NUM_EXT_ANALOG_INPUTS 32U
+#define NUM_EXT_ANALOG_INPUTS (0U EXTERNAL_MUX_TABLE(BOARD_COUNT_ENTRY))
 #define NUM_CAL_ANALOG_INPUTS 1U
 #define NUM_INT_ANALOG_INPUTS 4U
+#define NUM_DIFF_ANALOG_INPUTS 4U
+#define NUM_ANALOG_INPUTS (NUM_EXT_ANALOG_INPUTS + NUM_CAL_ANALOG_INPUTS + NUM_INT_ANALOG_INPUTS + NUM_DIFF_ANALOG_INPUTS)
+
+#if (NUM_ANALOG_INPUTS >= 255U)
+#error "Analog inputs are numbered in a byte, 255 being NULL_CHANNEL, at most 254 inputs are supported."
+#endif
 
 #define NUM_SAMPLE_RATES			16U
 #define NUM_PGA_SETTINGS			7U
@@ -178,85 +321,53 @@ extern "C" {
 /* Cold junction input */
 #define COLD_JUNCTION_AINP (ADS1256_AIN6)
 #define COLD_JUNCTION_AINN (ADS1256_AIN_COM)
+/* Default pair of the differential inputs, the ADC inputs which are not otherwise used by the board */
+#define DIFFERENTIAL_DEFAULT_AINP (ADS1256_AIN2)
+#define DIFFERENTIAL_DEFAULT_AINN (ADS1256_AIN5)
 
-typedef enum { /* We explicitly count here because the telnet server will rely on these numbers */
-	EXTERNAL_0 = 0U,
-	EXTERNAL_1 = 1U,
-	EXTERNAL_2 = 2U,
-	EXTERNAL_3 = 3U,
-	EXTERNAL_4 = 4U,
-	EXTERNAL_5 = 5U,
-	EXTERNAL_6 = 6U,
-	EXTERNAL_7 = 7U,
-	EXTERNAL_8 = 8U,
-	EXTERNAL_9 = 9U,
-	EXTERNAL_10 = 10U,
-	EXTERNAL_11 = 11U,
-	EXTERNAL_12 = 12U,
-	EXTERNAL_13 = 13U,
-	EXTERNAL_14 = 14U,
-	EXTERNAL_15 = 15U,
-	EXTERNAL_16 = 16U,
-	EXTERNAL_17 = 17U,
-	EXTERNAL_18 = 18U,
-	EXTERNAL_19 = 19U,
-	EXTERNAL_20 = 20U,
-	EXTERNAL_21 = 21U,
-	EXTERNAL_22 = 22U,
-	EXTERNAL_23 = 23U,
-	EXTERNAL_24 = 24U,
-	EXTERNAL_25 = 25U,
-	EXTERNAL_26 = 26U,
-	EXTERNAL_27 = 27U,
-	EXTERNAL_28 = 28U,
-	EXTERNAL_29 = 29U,
-	EXTERNAL_30 = 30U,
-	EXTERNAL_31 = 31U,
-	EXTERNAL_OFFSET_CAL = 32U,
-	IN_SUPPLY_9V = 33U,
-	IN_SUPPLY_5V = 34U,
-	IN_SUPPLY_3_3V = 35U,
-	IN_COLD_JUNCTION = 36U
+/* Expands an EXTERNAL_MUX_TABLE entry to its PhysicalAnalogInput_t enumerator */
+#define EXTERNAL_INPUT_ENUMERATOR(n, code) EXTERNAL_##n = n##U,
+
+/* We explicitly count here because the telnet server will rely on these numbers. The inputs after the external inputs
+ * are numbered from NUM_EXT_ANALOG_INPUTS, so 32 to 40 on the standard board */
+typedef enum {
+	EXTERNAL_MUX_TABLE(EXTERNAL_INPUT_ENUMERATOR)
+	EXTERNAL_OFFSET_CAL = NUM_EXT_ANALOG_INPUTS,
+	IN_SUPPLY_9V = NUM_EXT_ANALOG_INPUTS + 1U,
+	IN_SUPPLY_5V = NUM_EXT_ANALOG_INPUTS + 2U,
+	IN_SUPPLY_3_3V = NUM_EXT_ANALOG_INPUTS + 3U,
+	IN_COLD_JUNCTION = NUM_EXT_ANALOG_INPUTS + 4U,
+	DIFFERENTIAL_0 = NUM_EXT_ANALOG_INPUTS + 5U,
+	DIFFERENTIAL_1 = NUM_EXT_ANALOG_INPUTS + 6U,
+	DIFFERENTIAL_2 = NUM_EXT_ANALOG_INPUTS + 7U,
+	DIFFERENTIAL_3 = NUM_EXT_ANALOG_INPUTS + 8U
 } PhysicalAnalogInput_t;
 
+/**
+ * @def INTERNAL_INPUT_TABLE
+ * @brief Board description of the inputs wired to the ADC's own multiplexer, one X(input, number, name, pos, neg)
+ * entry for each, pos and neg being the pair of ADC inputs it is read between. InternalAnalogInput_t and the
+ * multiplexer's channel and name tables are generated from it.
+ */
+#define INTERNAL_INPUT_TABLE(X) \
+	X(SUPPLY_9V, 0U, "9V SUPPLY", SUPPLY_9V_AINP, SUPPLY_9V_AINN) \
+	X(SUPPLY_5V, 1U, "5V SUPPLY", SUPPLY_5V_AINP, SUPPLY_5V_AINN) \
+	X(SUPPLY_3_3V, 2U, "3.3V SUPPLY", SUPPLY_3_3V_AINP, SUPPLY_3_3V_AINN) \
+	X(COLD_JUNCTION, 3U, "COLD JUNCTION", COLD_JUNCTION_AINP, COLD_JUNCTION_AINN) \
+	X(EXTERNAL_ANALOG_IN, 4U, "EXTERNAL ANALOG INPUT", EXTERNAL_ANALOG_IN_AINP, EXTERNAL_ANALOG_IN_AINN)
+
+/* Expands an INTERNAL_INPUT_TABLE entry to its InternalAnalogInput_t enumerator */
+#define INTERNAL_INPUT_ENUMERATOR(input, number, name, pos, neg) input = number,
+
 typedef enum {
-	SUPPLY_9V = 0U, SUPPLY_5V = 1U, SUPPLY_3_3V = 2U, COLD_JUNCTION = 3U, EXTERNAL_ANALOG_IN = 4U
+	INTERNAL_INPUT_TABLE(INTERNAL_INPUT_ENUMERATOR)
 } InternalAnalogInput_t;
 
-typedef enum {
-	EXTERN_0 = 0x1800U,
-	EXTERN_1 = 0x1000U,
-	EXTERN_2 = 0x3000U,
-	EXTERN_3 = 0x3800U,
-	EXTERN_4 = 0x7800U,
-	EXTERN_5 = 0x5000U,
-	EXTERN_6 = 0x6000U,
-	EXTERN_7 = 0x5800U,
-	EXTERN_8 = 0x9800U,
-	EXTERN_9 = 0x9000U,
-	EXTERN_10 = 0xB000U,
-	EXTERN_11 = 0xB800U,
-	EXTERN_12 = 0xF800U,
-	EXTERN_13 = 0xD000U,
-	EXTERN_14 = 0xE000U,
-	EXTERN_15 = 0xD800U,
-	EXTERN_16 = 0x0000U,
-	EXTERN_17 = 0x0800U,
-	EXTERN_18 = 0x2800U,
-	EXTERN_19 = 0x2000U,
-	EXTERN_20 = 0x4000U,
-	EXTERN_21 = 0x4800U,
-	EXTERN_22 = 0x6800U,
-	EXTERN_23 = 0x7000U,
-	EXTERN_24 = 0x8000U,
-	EXTERN_25 = 0x8800U,
-	EXTERN_26 = 0xA800U,
-	EXTERN_27 = 0xA000U,
-	EXTERN_28 = 0xC000U,
-	EXTERN_29 = 0xC800U,
-	EXTERN_30 = 0xE800U,
-	EXTERN_31 = 0xF000U,
+/* Expands an EXTERNAL_MUX_TABLE entry to its ExternalMuxedInput_t enumerator */
+#define EXTERNAL_MUX_ENUMERATOR(n, code) EXTERN_##n = code,
 
+typedef enum {
+	EXTERNAL_MUX_TABLE(EXTERNAL_MUX_ENUMERATOR)
 } ExternalMuxedInput_t;
 
 /**
@@ -299,6 +410,16 @@ typedef enum {
  */
 #define ADS1256_CLK_FREQ ((uint32_t) 7680000)
 #define ADS1256_CLK_PERIOD_US 0.13020833333333f
+#define ADS1256_CLK_PERIOD_NS 130.20833333333333f
+
+/**
+ * @def ADS1256_SPI_MAX_SCLK_HZ
+ * @brief The fastest SPI clock the ADS1256 accepts, from the minimum SCLK period t1 of 4 master clock periods. The
+ * SPI prescaler is derived from it, and it may be overridden for a board whose ADC is known to run faster.
+ */
+#ifndef ADS1256_SPI_MAX_SCLK_HZ
+#define ADS1256_SPI_MAX_SCLK_HZ (ADS1256_CLK_FREQ / 4U)
+#endif
 
 /* ADS1256 SPI Interface pins  */
 #define ADS1256_SPI                         (SPI2)
@@ -339,10 +460,46 @@ typedef enum {
 #define ADS1256_RESET_GPIO_PORT				(GPIOH)
 #define ADS1256_RESET_GPIO_CLK				(RCC_AHB1Periph_GPIOH)
 
-#define EXT_ANALOG_IN_MUX_PINS				(GPIO_Pin_15 | GPIO_Pin_14 | GPIO_Pin_13 | GPIO_Pin_12 | GPIO_Pin_11)
-#define EXT_ANALOG_IN_MUX_PORT				(GPIOD)
-#define EXT_ANALOG_IN_GPIO_CLK				(RCC_AHB1Periph_GPIOD)
-#define EXT_ANALOG_IN_BITMASK				((uint16_t) 0x07FF)
+/* ADS1256 SPI DMA streams (SPI2 RX: DMA1 Stream 3, SPI2 TX: DMA1 Stream 4, both on channel 0) */
+#define ADS1256_SPI_DMA_CLK					(RCC_AHB1Periph_DMA1)
+#define ADS1256_SPI_DMA_CHANNEL				(DMA_Channel_0)
+#define ADS1256_SPI_DMA_RX_STREAM			(DMA1_Stream3)
+#define ADS1256_SPI_DMA_RX_IRQn				(DMA1_Stream3_IRQn)
+#define ADS1256_SPI_DMA_RX_FLAGS			(DMA_FLAG_TCIF3 | DMA_FLAG_HTIF3 | DMA_FLAG_TEIF3 | DMA_FLAG_DMEIF3 | DMA_FLAG_FEIF3)
+#define ADS1256_SPI_DMA_RX_IT_TC			(DMA_IT_TCIF3)
+#define ADS1256_SPI_DMA_TX_STREAM			(DMA1_Stream4)
+#define ADS1256_SPI_DMA_TX_FLAGS			(DMA_FLAG_TCIF4 | DMA_FLAG_HTIF4 | DMA_FLAG_TEIF4 | DMA_FLAG_DMEIF4 | DMA_FLAG_FEIF4)
+#define ADS1256_SPI_DMA_PREEMPT_PRIORITY	(IRQ_PRIORITY_ACQUISITION)
+
+/* ADS1256 DRDY external interrupt (shares the EXTI15_10 vector with the ethernet link interrupt) */
+#define ADS1256_DRDY_EXTI_LINE				(EXTI_Line10)
+#define ADS1256_DRDY_EXTI_PORT_SOURCE		(EXTI_PortSourceGPIOA)
+#define ADS1256_DRDY_EXTI_PIN_SOURCE		(EXTI_PinSource10)
+#define ADS1256_DRDY_EXTI_IRQn				(EXTI15_10_IRQn)
+#define ADS1256_DRDY_PREEMPT_PRIORITY		(IRQ_PRIORITY_ACQUISITION)
+
+/* External multiplexer settle timer, sharing the priority of the DRDY interrupt so neither preempts the other's SPI transfers */
+#define EXT_MUX_SETTLE_TIM					(TIM6)
+#define EXT_MUX_SETTLE_TIM_CLK				(RCC_APB1Periph_TIM6)
+#define EXT_MUX_SETTLE_IRQn					(TIM6_DAC_IRQn)
+#define EXT_MUX_SETTLE_PREEMPT_PRIORITY		(ADS1256_DRDY_PREEMPT_PRIORITY)
+
+/* Snapshot frame timer, sharing the priority of the DRDY interrupt so neither preempts the other's SPI transfers */
+#define SNAPSHOT_FRAME_TIM					(TIM3)
+#define SNAPSHOT_FRAME_TIM_CLK				(RCC_APB1Periph_TIM3)
+#define SNAPSHOT_FRAME_IRQn					(TIM3_IRQn)
+#define SNAPSHOT_FRAME_PREEMPT_PRIORITY		(ADS1256_DRDY_PREEMPT_PRIORITY)
+
+/**
+ * @def EXT_MUX_ADC_GPIO
+ * @brief Define for board variants which route the ADS1256's GPIO pins to the external multiplexer's select lines.
+ * The lines from EXT_MUX_ADC_GPIO_SHIFT up, one for each bit of EXT_MUX_ADC_GPIO_MASK, are then driven by GPIO0 to
+ * GPIO3 and written in the same register burst as the ADC's input channels, the others stay on the processor's port.
+ * GPIO0 is also the ADC's clock output, which must be left off if it is in the mask.
+ */
+/*#define EXT_MUX_ADC_GPIO */
+#define EXT_MUX_ADC_GPIO_SHIFT				(11U)
+#define EXT_MUX_ADC_GPIO_MASK				((uint8_t) 0x0F)
 
 #define OCAL_CONTROL_PIN					(GPIO_Pin_12)
 #define OCAL_CONTROL_GPIO_PORT				(GPIOH)
@@ -358,9 +515,22 @@ typedef enum {
   * @{
   */
 
-/* SPIDER TLE7232 SPI Interface pins  */
-#define NUMBER_TLE7232_CHIPS				2
-#define NUM_DIGITAL_OUTPUTS 				16U
+/* SPIDER TLE7232 SPI Interface pins, NUMBER_TLE7232_CHIPS daisy chained devices as given by the board variant */
+#define TLE7232_NUM_CHANNELS				8U
+#define NUM_DIGITAL_OUTPUTS 				(NUMBER_TLE7232_CHIPS * TLE7232_NUM_CHANNELS)
+
+#if (NUM_DIGITAL_OUTPUTS > 32U)
+#error "The digital output levels are kept in DigitalOutputMask_t, at most 32 outputs are supported."
+#endif
+
+/**
+ * @brief Bit field over the digital outputs, bit n standing for output n, only as wide as the board variant needs.
+ */
+#if (NUM_DIGITAL_OUTPUTS > 16U)
+typedef uint32_t DigitalOutputMask_t;
+#else
+typedef uint16_t DigitalOutputMask_t;
+#endif
 
 #define TLE7232_SPI							(SPI1)
 #define TLE7232_SPI_CLK                     (RCC_APB2Periph_SPI1)
@@ -392,6 +562,26 @@ typedef enum {
 #define TLE7232_RESET_GPIO_PORT				(GPIOC)
 #define TLE7232_RESET_GPIO_CLK				(RCC_AHB1Periph_GPIOC)
 
+/* TLE7232 SPI DMA streams (SPI1 RX: DMA2 Stream 0, SPI1 TX: DMA2 Stream 3, both on channel 3) */
+#define TLE7232_SPI_DMA_CLK					(RCC_AHB1Periph_DMA2)
+#define TLE7232_SPI_DMA_CHANNEL				(DMA_Channel_3)
+#define TLE7232_SPI_DMA_RX_STREAM			(DMA2_Stream0)
+#define TLE7232_SPI_DMA_RX_IRQn				(DMA2_Stream0_IRQn)
+#define TLE7232_SPI_DMA_RX_FLAGS			(DMA_FLAG_TCIF0 | DMA_FLAG_HTIF0 | DMA_FLAG_TEIF0 | DMA_FLAG_DMEIF0 | DMA_FLAG_FEIF0)
+#define TLE7232_SPI_DMA_RX_IT_TC			(DMA_IT_TCIF0)
+#define TLE7232_SPI_DMA_TX_STREAM			(DMA2_Stream3)
+#define TLE7232_SPI_DMA_TX_FLAGS			(DMA_FLAG_TCIF3 | DMA_FLAG_HTIF3 | DMA_FLAG_TEIF3 | DMA_FLAG_DMEIF3 | DMA_FLAG_FEIF3)
+#define TLE7232_SPI_DMA_PREEMPT_PRIORITY	(IRQ_PRIORITY_OUTPUT)
+
+/* Default period of the background diagnosis of the TLE7232 drivers (us) */
+#define TLE7232_DIAGNOSIS_PERIOD_US			(100000U)
+
+/* Digital output tick timer for PWM and sequences, sharing the priority of the TLE7232 DMA so neither preempts the other */
+#define GPO_TICK_TIM						(TIM7)
+#define GPO_TICK_TIM_CLK					(RCC_APB1Periph_TIM7)
+#define GPO_TICK_IRQn						(TIM7_IRQn)
+#define GPO_TICK_PREEMPT_PRIORITY			(TLE7232_SPI_DMA_PREEMPT_PRIORITY)
+
 #define GPOn								16
 
 typedef enum {
@@ -429,121 +619,86 @@ typedef enum {
   * @{
   */
 
-/* Digital Input Interface pins  */
-/* GPI0 */
-#define GPI0_PIN							(GPIO_Pin_5)
-#define GPI0_GPIO_PORT						(GPIOE)
-/* GPI1 */
-#define GPI1_PIN							(GPIO_Pin_4)
-#define GPI1_GPIO_PORT						(GPIOE)
-/* GPI2 */
-#define GPI2_PIN							(GPIO_Pin_8)
-#define GPI2_GPIO_PORT						(GPIOI)
-/* GPI3 */
-#define GPI3_PIN							(GPIO_Pin_11)
-#define GPI3_GPIO_PORT						(GPIOI)
-/* GPI4 */
-#define GPI4_PIN							(GPIO_Pin_0)
-#define GPI4_GPIO_PORT						(GPIOH)
-/* GPI5 */
-#define GPI5_PIN							(GPIO_Pin_4)
-#define GPI5_GPIO_PORT						(GPIOH)
-/* GPI6 */
-#define GPI6_PIN							(GPIO_Pin_11)
-#define GPI6_GPIO_PORT						(GPIOF)
-/* GPI7 */
-#define GPI7_PIN							(GPIO_Pin_15)
-#define GPI7_GPIO_PORT						(GPIOF)
-/* GPI8 */
-#define GPI8_PIN							(GPIO_Pin_8)
-#define GPI8_GPIO_PORT						(GPIOE)
-/* GPI9 */
-#define GPI9_PIN							(GPIO_Pin_12)
-#define GPI9_GPIO_PORT						(GPIOE)
-/* GPI10 */
-#define GPI10_PIN							(GPIO_Pin_6)
-#define GPI10_GPIO_PORT						(GPIOH)
-/* GPI11 */
-#define GPI11_PIN							(GPIO_Pin_11)
-#define GPI11_GPIO_PORT						(GPIOH)
-/* GPI12 */
-#define GPI12_PIN							(GPIO_Pin_3)
-#define GPI12_GPIO_PORT						(GPIOE)
-/* GPI13 */
-#define GPI13_PIN							(GPIO_Pin_2)
-#define GPI13_GPIO_PORT						(GPIOE)
-/* GPI14 */
-#define GPI14_PIN							(GPIO_Pin_6)
-#define GPI14_GPIO_PORT						(GPIOE)
-/* GPI15 */
-#define GPI15_PIN							(GPIO_Pin_14)
-#define GPI15_GPIO_PORT						(GPIOC)
-/* GPI16 */
-#define GPI16_PIN							(GPIO_Pin_9)
-#define GPI16_GPIO_PORT						(GPIOF)
-/* GPI17 */
-#define GPI17_PIN							(GPIO_Pin_2)
-#define GPI17_GPIO_PORT						(GPIOH)
-/* GPI18 */
-#define GPI18_PIN							(GPIO_Pin_1)
-#define GPI18_GPIO_PORT						(GPIOB)
-/* GPI19 */
-#define GPI19_PIN							(GPIO_Pin_13)
-#define GPI19_GPIO_PORT						(GPIOF)
-/* GPI20 */
-#define GPI20_PIN							(GPIO_Pin_1)
-#define GPI20_GPIO_PORT						(GPIOG)
-/* GPI21 */
-#define GPI21_PIN							(GPIO_Pin_10)
-#define GPI21_GPIO_PORT						(GPIOE)
-/* GPI22 */
-#define GPI22_PIN							(GPIO_Pin_8)
-#define GPI22_GPIO_PORT						(GPIOH)
-/* GPI23 */
-#define GPI23_PIN							(GPIO_Pin_10)
-#define GPI23_GPIO_PORT						(GPIOH)
-
-#define GPI_PORTB_PINS						(GPI18_PIN)
-#define GPI_PORTC_PINS						(GPI15_PIN)
-#define GPI_PORTE_PINS						(GPI0_PIN | GPI1_PIN | GPI8_PIN | GPI9_PIN | GPI12_PIN | GPI13_PIN | GPI14_PIN | GPI21_PIN)
-#define GPI_PORTF_PINS						(GPI6_PIN | GPI7_PIN | GPI16_PIN | GPI19_PIN)
-#define GPI_PORTG_PINS						(GPI20_PIN)
-#define GPI_PORTH_PINS						(GPI4_PIN | GPI5_PIN | GPI10_PIN | GPI11_PIN | GPI17_PIN | GPI22_PIN | GPI23_PIN)
-#define GPI_PORTI_PINS						(GPI2_PIN | GPI3_PIN)
-
-#define GPI_GPIO_CLKS						(RCC_AHB1Periph_GPIOB | RCC_AHB1Periph_GPIOC | RCC_AHB1Periph_GPIOE \
-		| RCC_AHB1Periph_GPIOF | RCC_AHB1Periph_GPIOG | RCC_AHB1Periph_GPIOH \
-		| RCC_AHB1Periph_GPIOI)
-
-#define NUM_DIGITAL_INPUTS 				24U
+/* Expands a GPI_PORT_TABLE entry to its GPI_PortIndex_t enumerator */
+#define GPI_PORT_INDEX_ENUMERATOR(port) GPI_PORT_INDEX_##port,
+
+/**
+ * @brief Index of each GPIO port in GPI_PORT_TABLE.
+ */
+typedef enum {
+	GPI_PORT_TABLE(GPI_PORT_INDEX_ENUMERATOR)
+	NUM_GPI_PORTS /**< The number of GPIO ports the digital inputs are spread over. */
+} GPI_PortIndex_t;
+
+/* Expands a GPI_PIN_TABLE entry to its pin if it is on the port at index arg, else to nothing */
+#define GPI_PIN_IF_ON_PORT(arg, n, pin, port) | (((arg) == GPI_PORT_INDEX_##port) ? (pin) : 0U)
+
+/**
+ * @def GPI_PORT_PINS
+ * @brief The mask of the digital input pins on the GPIO port with the GPI_PortIndex_t index, a compile time constant.
+ */
+#define GPI_PORT_PINS(index)				((uint16_t) (0U GPI_PIN_TABLE(GPI_PIN_IF_ON_PORT, index)))
+
+/* GPI edge capture external interrupts. Lines 10 to 15 share the EXTI15_10 vector with the ADS1256 DRDY interrupt,
+ * so all of them run at its priority and the edge log has a single producer. */
+#define GPI_EXTI_RESERVED_LINES				(ADS1256_DRDY_EXTI_LINE | ETH_LINK_EXTI_LINE)
+#define GPI_EXTI_PREEMPT_PRIORITY			(ADS1256_DRDY_PREEMPT_PRIORITY)
+
+/* Expands a GPI_PORT_TABLE entry to its peripheral clock */
+#define GPI_PORT_CLOCK(port) | RCC_AHB1Periph_GPIO##port
+
+#define GPI_GPIO_CLKS						(0U GPI_PORT_TABLE(GPI_PORT_CLOCK))
+
+#define NUM_DIGITAL_INPUTS 				(0U GPI_PIN_TABLE(BOARD_COUNT_ENTRY, ~))
+
+#if (NUM_DIGITAL_INPUTS > 32U)
+#error "The digital input levels are kept in 32 bit words, at most 32 inputs are supported."
+#endif
+
+/* Expands a GPI_PIN_TABLE entry to its GPI_TypeDef enumerator */
+#define GPI_ENUMERATOR(arg, n, pin, port) GPI##n = n,
 
 typedef enum {
-	GPI0 = 0,
-	GPI1 = 1,
-	GPI2 = 2,
-	GPI3 = 3,
-	GPI4 = 4,
-	GPI5 = 5,
-	GPI6 = 6,
-	GPI7 = 7,
-	GPI8 = 8,
-	GPI9 = 9,
-	GPI10 = 10,
-	GPI11 = 11,
-	GPI12 = 12,
-	GPI13 = 13,
-	GPI14 = 14,
-	GPI15 = 15,
-	GPI16 = 16,
-	GPI17 = 17,
-	GPI18 = 18,
-	GPI19 = 19,
-	GPI20 = 20,
-	GPI21 = 21,
-	GPI22 = 22,
-	GPI23 = 23
+	GPI_PIN_TABLE(GPI_ENUMERATOR, ~)
 } GPI_TypeDef;
 
+#define NUM_DIGITAL_ENCODERS			(0U GPI_ENCODER_TABLE(BOARD_COUNT_ENTRY))
+
+/**
+ * @}
+ */
+
+/** @addtogroup analog_input_aux Auxiliary Analog Inputs
+  * @{
+  */
+
+/* The processor's ADC reading the auxiliary analog inputs, on the stream left free by the TLE7232's use of DMA2 Stream 0 */
+#define AUX_ANALOG_ADC						(ADC1)
+#define AUX_ANALOG_ADC_CLK					(RCC_APB2Periph_ADC1)
+#define AUX_ANALOG_ADC_PRESCALER			(ADC_Prescaler_Div4)
+#define AUX_ANALOG_DMA_CLK					(RCC_AHB1Periph_DMA2)
+#define AUX_ANALOG_DMA_CHANNEL				(DMA_Channel_0)
+#define AUX_ANALOG_DMA_STREAM				(DMA2_Stream4)
+
+/**
+ * @def AUX_ANALOG_SAMPLE_TIME
+ * @brief The sampling time of each auxiliary conversion. The temperature sensor needs at least 10 us, 480 cycles of
+ * the 21 MHz ADC clock, so each input is converted about every 23 us per input scanned.
+ */
+#define AUX_ANALOG_SAMPLE_TIME				(ADC_SampleTime_480Cycles)
+
+/**
+ * @def AUX_ANALOG_VREF_MV
+ * @brief The ADC reference, the analog supply, in millivolts, which the readings are scaled by.
+ */
+#define AUX_ANALOG_VREF_MV					(3300U)
+
+#define NUM_AUX_ANALOG_INPUTS				(0U AUX_ANALOG_TABLE(BOARD_COUNT_ENTRY))
+
+#if (NUM_AUX_ANALOG_INPUTS > 16U)
+#error "The ADC's regular sequence holds at most 16 auxiliary analog inputs."
+#endif
+
 /**
  * @}
  */
@@ -557,6 +712,9 @@ typedef enum {
 
 #define DP83848_PHY_ADDRESS       		0x01
 
+/* Ethernet DMA receive interrupt. It only flags the received frames for the network receive task. */
+#define ETH_DMA_PREEMPT_PRIORITY		(IRQ_PRIORITY_BACKGROUND)
+
 #define ETHERNET_GPIO_CLKS				(RCC_AHB1Periph_GPIOA | RCC_AHB1Periph_GPIOB | RCC_AHB1Periph_GPIOC | RCC_AHB1Periph_GPIOG)
 
 #define ETH_MDIO_PIN					(GPIO_Pin_2)
@@ -600,6 +758,8 @@ typedef enum {
 #define ETH_LINK_EXTI_PORT_SOURCE      (EXTI_PortSourceGPIOB)
 #define ETH_LINK_EXTI_PIN_SOURCE       (EXTI_PinSource14)
 #define ETH_LINK_EXTI_IRQn             (EXTI15_10_IRQn)
+/* The link interrupt shares the DRDY vector, so takes its priority. The PHY is only read once deferred to the program loop. */
+#define ETH_LINK_PREEMPT_PRIORITY      (ADS1256_DRDY_PREEMPT_PRIORITY)
 /* PB14 */
 #define ETH_LINK_PIN                   (GPIO_Pin_14)
 #define ETH_LINK_GPIO_PORT             (GPIOB)
@@ -644,6 +804,9 @@ typedef enum {
 #define CAN_AF_PORT                (GPIO_AF_CAN1)
 #define CAN_RX_SOURCE              (GPIO_PinSource0)
 #define CAN_TX_SOURCE              (GPIO_PinSource1)
+/* The receive interrupt hands triggers on, so it preempts all but capture. The transmit interrupt only refills mailboxes. */
+#define CAN_RX_PREEMPT_PRIORITY    (IRQ_PRIORITY_TRIGGER)
+#define CAN_TX_PREEMPT_PRIORITY    (IRQ_PRIORITY_BACKGROUND)
 
 /** @addtogroup com_port_driver COM Port Driver
   * @{
@@ -698,6 +861,8 @@ typedef enum {
 #define COM2_RX_SOURCE              (GPIO_PinSource9)
 #define COM2_RX_AF                  (GPIO_AF_USART3)
 #define COM2_IRQn                   (USART3_IRQn)
+/* The debug log drains through the transmit interrupt, which can always wait for everything else. */
+#define COM2_PREEMPT_PRIORITY       (IRQ_PRIORITY_BACKGROUND)
 
 /**
  * @}
@@ -720,6 +885,7 @@ typedef enum {
 #define CALIBRATION_GAIN_OFFSET		(CALIBRATION_RATE_OFFSET*NUM_SAMPLE_RATES)
 #define CALIBRATION_BUFFER_OFFSET	(CALIBRATION_GAIN_OFFSET*NUM_PGA_SETTINGS)
 #define CALIBRATION_TEMP_OFFSET		(CALIBRATION_BUFFER_OFFSET*NUM_BUFFER_SETTINGS)
+#define CALIBRATION_MAX_TEMPS		16U /* The most temperature data points the RAM image of the table holds */
 
 #define BOARD_SERIAL_NUM_ADDR		(ADDR_CALIBRATION_BASE)
 #define BOARD_SERIAL_NUM_LENGTH		32 /* Serial number is 32 bytes long (32 chars) */
@@ -731,6 +897,48 @@ typedef enum {
 #define CAL_VALID_ADDR				(CAL_TEMP_CNT_ADDR + 4)
 #define CAL_DATA_START_ADDR			(CAL_VALID_ADDR + 1)
 
+/* The table header sits at the end of the sector, clear of the data points */
+#define CALIBRATION_TABLE_VERSION	1U
+#define CAL_HEADER_ADDR				(ADDR_CALIBRATION_END + 1 - 12)
+#define CAL_HEADER_VERSION_ADDR		(CAL_HEADER_ADDR)
+#define CAL_HEADER_DIMENSIONS_ADDR	(CAL_HEADER_ADDR + 4)
+#define CAL_HEADER_CRC_ADDR			(CAL_HEADER_ADDR + 8)
+
+/**
+ * @}
+ */
+
+/** @addtogroup firmware_upgrade Firmware Upgrade
+  * @{
+  */
+
+/* The running firmware occupies sectors 0 to 5, the linker script holds it to them. A new image is staged in
+ * sectors 6 and 7 and copied over the running firmware on the next reset. */
+#define UPGRADE_APP_BASE			((uint32_t)0x08000000) /* Base @ of Sector 0 */
+#define UPGRADE_APP_SECTORS			6U /* Sectors 0 to 5, 256 Kbytes */
+#define UPGRADE_STAGING_BASE		((uint32_t)0x08040000) /* Base @ of Sector 6, 128 Kbytes */
+#define UPGRADE_STAGING_END			((uint32_t)0x0807FFFF) /* End @ of Sector 7, 128 Kbytes */
+#define UPGRADE_STAGING_SECTOR		(FLASH_Sector_6)
+#define UPGRADE_STAGING_SECTORS		2U
+
+/* The trailer recording a staged image sits at the end of the staging sectors, clear of the image */
+#define UPGRADE_TRAILER_ADDR		(UPGRADE_STAGING_END + 1 - 16)
+#define UPGRADE_MAX_IMAGE_SIZE		(UPGRADE_TRAILER_ADDR - UPGRADE_STAGING_BASE)
+
+/**
+ * @}
+ */
+
+/** @addtogroup sample_log Sample Log
+  * @{
+  */
+
+/* Sample data without a destination is logged to sector 8, the one sector left by the firmware, the upgrade staging,
+ * the EEPROM emulation and the calibration table */
+#define SAMPLE_LOG_SECTOR			(FLASH_Sector_8)
+#define SAMPLE_LOG_BASE				((uint32_t)0x08080000) /* Base @ of Sector 8, 128 Kbytes */
+#define SAMPLE_LOG_END				((uint32_t)0x0809FFFF)
+
 /**
  * @}
  */
@@ -756,13 +964,62 @@ typedef enum {
 #define PAGE1_END_ADDRESS     ((uint32_t)(EEPROM_START_ADDRESS + (2 * PAGE_SIZE - 1)))
 #define PAGE1_ID              (FLASH_Sector_10)
 
-#define NUM_EEPROM_ADDRESSES			4
-
 #define ADDR_BOARD_MAX_TEMP_HIGH		0x0000
 #define ADDR_BOARD_MAX_TEMP_LOW			0x0001
 #define ADDR_BOARD_MIN_TEMP_HIGH		0x0002
 #define ADDR_BOARD_MIN_TEMP_LOW			0x0003
 
+/* Saved channel configuration: a marker, then a record per analog input up to the differential inputs, then the digital
+ * input and output records */
+#define CONFIG_ANALOG_RECORD_WORDS		5
+#define ADDR_CONFIG_MARKER				0x0004
+#define ADDR_CONFIG_ANALOG_BASE			0x0005
+#define ADDR_CONFIG_DIGITAL_INPUTS		(ADDR_CONFIG_ANALOG_BASE + ((NUM_ANALOG_INPUTS - NUM_DIFF_ANALOG_INPUTS) * CONFIG_ANALOG_RECORD_WORDS))
+#define ADDR_CONFIG_DIGITAL_HOLDS		(ADDR_CONFIG_DIGITAL_INPUTS + 2)
+#define ADDR_CONFIG_DIGITAL_OUTPUTS		(ADDR_CONFIG_DIGITAL_HOLDS + ((NUM_DIGITAL_INPUTS + 1) / 2))
+
+/* Saved sampling job: a marker, the sample count, statistics window and period, then the publish address and port */
+#define ADDR_JOB_MARKER					(ADDR_CONFIG_DIGITAL_OUTPUTS + 1)
+#define ADDR_JOB_NUMBER					(ADDR_JOB_MARKER + 1)
+#define ADDR_JOB_WINDOW					(ADDR_JOB_NUMBER + 2)
+#define ADDR_JOB_TIME					(ADDR_JOB_WINDOW + 2)
+#define ADDR_JOB_ADDRESS				(ADDR_JOB_TIME + 2)
+#define ADDR_JOB_PORT					(ADDR_JOB_ADDRESS + 2)
+
+/* Saved network addresses: a marker, the static address, netmask and gateway, then the same for the last DHCP lease */
+#define ADDR_NET_STATIC_MARKER			(ADDR_JOB_PORT + 1)
+#define ADDR_NET_STATIC_ADDRESS			(ADDR_NET_STATIC_MARKER + 1)
+#define ADDR_NET_LEASE_MARKER			(ADDR_NET_STATIC_ADDRESS + 6)
+#define ADDR_NET_LEASE_ADDRESS			(ADDR_NET_LEASE_MARKER + 1)
+
+/* Saved time server: a marker, then its address */
+#define ADDR_TIME_SERVER_MARKER			(ADDR_NET_LEASE_ADDRESS + 6)
+#define ADDR_TIME_SERVER_ADDRESS		(ADDR_TIME_SERVER_MARKER + 1)
+
+/* Saved CAN synchronization role, marked in its upper byte */
+#define ADDR_CAN_SYNC_ROLE				(ADDR_TIME_SERVER_ADDRESS + 2)
+
+/* Saved differential inputs: an analog input record each followed by the pins of its pair. They come last so that
+ * the addresses saved before they existed are unchanged */
+#define CONFIG_DIFF_RECORD_WORDS		(CONFIG_ANALOG_RECORD_WORDS + 1)
+#define ADDR_CONFIG_DIFF_BASE			(ADDR_CAN_SYNC_ROLE + 1)
+
+/* Saved sampling job analog overflow policy, after the rest of the job was laid out */
+#define ADDR_JOB_OVERFLOW				(ADDR_CONFIG_DIFF_BASE + (NUM_DIFF_ANALOG_INPUTS * CONFIG_DIFF_RECORD_WORDS))
+
+/* Saved digital outputs from output 16 up, for board variants with more than 16 */
+#define ADDR_CONFIG_DIGITAL_OUTPUTS_HIGH	(ADDR_JOB_OVERFLOW + 1)
+
+/* Saved command macros: for each, its length in bytes, 0 for an unused slot, then its name and its lines, two
+ * characters to a word */
+#define MACRO_COUNT						4
+#define MACRO_NAME_LENGTH				16
+#define MACRO_SIZE						512
+#define MACRO_RECORD_WORDS				(1 + (MACRO_NAME_LENGTH / 2) + (MACRO_SIZE / 2))
+#define ADDR_MACRO_BASE					(ADDR_CONFIG_DIGITAL_OUTPUTS_HIGH + 1)
+
+#define NUM_EEPROM_ADDRESSES			(ADDR_MACRO_BASE + (MACRO_COUNT * MACRO_RECORD_WORDS))
+
 /* Virtual address defined by the user: 0xFFFF value is prohibited */
 extern uint16_t EEPROM_ADDRESSES[NUM_EEPROM_ADDRESSES];
 
@@ -0,0 +1,166 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Board_Standard.h
+ * @brief Board variant description of the standard Tekdaqc.
+ *
+ * Describes the wiring which differs between board variants: 32 external analog inputs behind a five line external
+ * multiplexer, 24 digital inputs over seven GPIO ports and 16 digital outputs on two daisy chained TLE7232 devices.
+ * Included by Tekdaqc_BSP.h as TEKDAQC_BOARD_VARIANT; a variant for expanded hardware is a copy of this header with
+ * its own tables, selected by the build.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_BOARD_STANDARD_H
+#define TEKDAQC_BOARD_STANDARD_H
+
+/** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
+ * @{
+ */
+
+/** @addtogroup board_variant Board Variant
+  * @{
+  */
+
+/* #define TEKDAQC_BOARD_TYPE ((char) 'C') */
+#define TEKDAQC_BOARD_TYPE ((char) 'D')
+
+/* The external multiplexer's select lines, the rest of its port being left to other uses */
+#define EXT_ANALOG_IN_MUX_PINS				(GPIO_Pin_15 | GPIO_Pin_14 | GPIO_Pin_13 | GPIO_Pin_12 | GPIO_Pin_11)
+#define EXT_ANALOG_IN_MUX_PORT				(GPIOD)
+#define EXT_ANALOG_IN_GPIO_CLK				(RCC_AHB1Periph_GPIOD)
+#define EXT_ANALOG_IN_BITMASK				((uint16_t) 0x07FF)
+
+/**
+ * @def EXTERNAL_MUX_TABLE
+ * @brief Board description of the external multiplexer, one X(n, code) entry for each external input n in order,
+ * code being the state of the select lines, EXT_ANALOG_IN_MUX_PINS, which switches the multiplexer to it.
+ * ExternalMuxedInput_t and the multiplexer's lookup tables are generated from it, so a board wired differently
+ * only changes this table.
+ */
+#define EXTERNAL_MUX_TABLE(X) \
+	X(0, 0x1800U) \
+	X(1, 0x1000U) \
+	X(2, 0x3000U) \
+	X(3, 0x3800U) \
+	X(4, 0x7800U) \
+	X(5, 0x5000U) \
+	X(6, 0x6000U) \
+	X(7, 0x5800U) \
+	X(8, 0x9800U) \
+	X(9, 0x9000U) \
+	X(10, 0xB000U) \
+	X(11, 0xB800U) \
+	X(12, 0xF800U) \
+	X(13, 0xD000U) \
+	X(14, 0xE000U) \
+	X(15, 0xD800U) \
+	X(16, 0x0000U) \
+	X(17, 0x0800U) \
+	X(18, 0x2800U) \
+	X(19, 0x2000U) \
+	X(20, 0x4000U) \
+	X(21, 0x4800U) \
+	X(22, 0x6800U) \
+	X(23, 0x7000U) \
+	X(24, 0x8000U) \
+	X(25, 0x8800U) \
+	X(26, 0xA800U) \
+	X(27, 0xA000U) \
+	X(28, 0xC000U) \
+	X(29, 0xC800U) \
+	X(30, 0xE800U) \
+	X(31, 0xF000U)
+
+/* The number of ADS1256 converters, each with its own driver state, see ADS1256_SelectDevice() */
+#define ADS1256_NUM_DEVICES					1U
+
+/* The number of daisy chained TLE7232 devices driving the digital outputs, TLE7232_NUM_CHANNELS each */
+#define NUMBER_TLE7232_CHIPS				2U
+
+/**
+ * @def GPI_PORT_TABLE
+ * @brief Board description of the GPIO ports holding digital inputs, one X(port) entry for each, port being the
+ * letter of the GPIO port. An input's port is given by its index in this table, see GPI_PortIndex_t.
+ */
+#define GPI_PORT_TABLE(X) X(B) X(C) X(E) X(F) X(G) X(H) X(I)
+
+/**
+ * @def GPI_PIN_TABLE
+ * @brief Board description of the digital input pins, one X(arg, n, pin, port) entry for each GPIn in order, arg
+ * being passed through to X. GPI_TypeDef and the digital input driver's pin map, port masks and names are generated
+ * from it, so a board wired differently only changes this table.
+ */
+#define GPI_PIN_TABLE(X, arg) \
+	X(arg, 0, GPIO_Pin_5, E) \
+	X(arg, 1, GPIO_Pin_4, E) \
+	X(arg, 2, GPIO_Pin_8, I) \
+	X(arg, 3, GPIO_Pin_11, I) \
+	X(arg, 4, GPIO_Pin_0, H) \
+	X(arg, 5, GPIO_Pin_4, H) \
+	X(arg, 6, GPIO_Pin_11, F) \
+	X(arg, 7, GPIO_Pin_15, F) \
+	X(arg, 8, GPIO_Pin_8, E) \
+	X(arg, 9, GPIO_Pin_12, E) \
+	X(arg, 10, GPIO_Pin_6, H) \
+	X(arg, 11, GPIO_Pin_11, H) \
+	X(arg, 12, GPIO_Pin_3, E) \
+	X(arg, 13, GPIO_Pin_2, E) \
+	X(arg, 14, GPIO_Pin_6, E) \
+	X(arg, 15, GPIO_Pin_14, C) \
+	X(arg, 16, GPIO_Pin_9, F) \
+	X(arg, 17, GPIO_Pin_2, H) \
+	X(arg, 18, GPIO_Pin_1, B) \
+	X(arg, 19, GPIO_Pin_13, F) \
+	X(arg, 20, GPIO_Pin_1, G) \
+	X(arg, 21, GPIO_Pin_10, E) \
+	X(arg, 22, GPIO_Pin_8, H) \
+	X(arg, 23, GPIO_Pin_10, H)
+
+/**
+ * @def GPI_ENCODER_TABLE
+ * @brief Board description of the digital input pairs which may be decoded as quadrature encoders, one
+ * X(n, a, b, timer, af, clock) entry for each encoder in order. GPIa and GPIb must be on channels 1 and 2 of timer, an
+ * APB1 timer which is otherwise unused once the board is up, af being their alternate function and clock the timer's
+ * APB1 peripheral clock. Only TIM5 is both free and wired to a pair of inputs on this board.
+ */
+#define GPI_ENCODER_TABLE(X) \
+	X(0, 23, 11, TIM5, GPIO_AF_TIM5, RCC_APB1Periph_TIM5)
+
+/**
+ * @def AUX_ANALOG_TABLE
+ * @brief Board description of the auxiliary analog inputs read by the processor's own ADC, one
+ * X(n, channel, name, pin, port, divider) entry for each in scan order, at most 16. channel is the ADC1 channel, pin
+ * and port the GPIO pin and port letter wired to it or 0U for the processor's internal channels, and divider the ratio
+ * of the resistive divider in front of the channel, so readings are given at the signal. The standard board routes
+ * no spare signal to a free ADC pin, so only the internal channels are read: the reference, from which the analog
+ * supply follows, the die temperature sensor and the backup battery, which the processor halves internally.
+ */
+#define AUX_ANALOG_TABLE(X) \
+	X(0, ADC_Channel_Vrefint, "VREFINT", 0U, A, 1U) \
+	X(1, ADC_Channel_TempSensor, "TEMPERATURE", 0U, A, 1U) \
+	X(2, ADC_Channel_Vbat, "VBAT", 0U, A, 2U)
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#endif /* TEKDAQC_BOARD_STANDARD_H */
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_BootTimes.h
+ * @brief Header file for the boot time breakdown of the Tekdaqc.
+ *
+ * Contains public definitions and data types for recording how long each stage of the start up takes, used to see
+ * where the time goes between reset and the board being ready for commands.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_BOOTTIMES_H_
+#define TEKDAQC_BOOTTIMES_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+#include "Tekdaqc_Debug.h"
+
+/** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
+ * @{
+ */
+
+/** @addtogroup tekdaqc_boot_times Tekdaqc Boot Times
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Boot stage enumeration.
+ * Defines the stages of the start up, in the order they complete.
+ */
+typedef enum {
+	BOOT_NETWORK_START, /**< Starting the time base and the Ethernet bring up, leaving the PHY in reset. */
+	BOOT_STATE_MACHINES, /**< Initializing the state machines and the ADC. */
+	BOOT_ANALOG_INPUTS, /**< Initializing the analog inputs. */
+	BOOT_DIGITAL_INPUTS, /**< Initializing the digital inputs. */
+	BOOT_DIGITAL_OUTPUTS, /**< Initializing the digital outputs and their TLE7232 drivers. */
+	BOOT_FLASH_DISK, /**< Initializing the FLASH disk. */
+	BOOT_CALIBRATION, /**< Loading the calibration table and board serial number. */
+	BOOT_CHANNEL_CONFIG, /**< Restoring the saved channel configuration. */
+	BOOT_PHY_WAIT, /**< Waiting out what remains of the PHY reset. */
+	BOOT_NETWORK_COMPLETE, /**< Completing the Ethernet bring up and starting the LwIP stack. */
+	BOOT_SERVERS, /**< Starting the servers, the command interpreter and the scheduled tasks. */
+	NUM_BOOT_STAGES /**<@internal The total number of stages. */
+} BootStage_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Records the completion of a boot stage.
+ */
+void BootTimes_Mark(BootStage_t stage);
+
+/**
+ * @brief Retrieves the time a boot stage took.
+ */
+uint32_t BootTimes_Get(BootStage_t stage);
+
+/**
+ * @brief Retrieves the time from the start of the time base to the last recorded stage.
+ */
+uint32_t BootTimes_Total(void);
+
+/**
+ * @brief Return the human readable string representation of the provided boot stage.
+ */
+const char* BootTimes_StringFromStage(BootStage_t stage);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_BOOTTIMES_H_ */
@@ -15,7 +15,8 @@
  * @file Tekdaqc_CAN.h
  * @brief Header file for the CAN driver.
  *
- * Contains public definitions and data types for the CAN driver.
+ * Contains public definitions and data types for the CAN driver and the synchronization protocol which lets
+ * several boards sample in lockstep.
  *
  * @author Jared Woolston (jwoolston@tenkiv.com)
  * @since v1.0.0.0
@@ -34,16 +35,74 @@ extern "C" {
 /* INCLUDES */
 /*--------------------------------------------------------------------------------------------------------*/
 
+#include "stm32f4xx.h"
+#include "Tekdaqc_Config.h"
+#include <boolean.h>
 
 /*--------------------------------------------------------------------------------------------------------*/
 /* EXPORTED CONSTANTS */
 /*--------------------------------------------------------------------------------------------------------*/
 
+/**
+ * @def CAN_SYNC_ID_BASE
+ * @brief The standard identifier of the first synchronization frame. The frame of each CAN_SyncEvent_t follows it,
+ * and the low identifiers win arbitration over any other traffic on the bus.
+ */
+#define CAN_SYNC_ID_BASE			((uint32_t) 0x080)
+
+/**
+ * @def CAN_STREAM_ID_DEFAULT
+ * @brief The default standard identifier of the sample frames of the first channel.
+ */
+#define CAN_STREAM_ID_DEFAULT		((uint32_t) 0x100)
+
+/**
+ * @def CAN_STREAM_ID_SPAN
+ * @brief The number of identifiers used by the sample frames, one for each channel from the stream identifier on.
+ */
+#define CAN_STREAM_ID_SPAN			((uint32_t) 32)
+
+/**
+ * @def CAN_STREAM_QUEUE_SIZE
+ * @brief The number of sample frames which may wait for a transmit mailbox.
+ */
+#define CAN_STREAM_QUEUE_SIZE		64U
+
 /*--------------------------------------------------------------------------------------------------------*/
-/* EXPORTED VARIABLES */
+/* EXPORTED TYPES */
 /*--------------------------------------------------------------------------------------------------------*/
 
-CanRxMsg RxMessage;
+/**
+ * @brief CAN synchronization role enumeration.
+ * Defines the part a board takes in synchronizing the acquisition of several boards.
+ */
+typedef enum {
+	CAN_SYNC_NONE, /**< Synchronization frames are neither sent nor acted on. */
+	CAN_SYNC_MASTER, /**< Sampling and triggers are broadcast to the slaves. */
+	CAN_SYNC_SLAVE, /**< Sampling and triggers follow the master. */
+	NUM_CAN_SYNC_ROLES /**<@internal The total number of roles. */
+} CAN_SyncRole_t;
+
+/**
+ * @brief CAN synchronization event enumeration.
+ * Defines the frames broadcast by the master.
+ */
+typedef enum {
+	CAN_SYNC_START, /**< Start sampling, with the number of samples as its argument. */
+	CAN_SYNC_STOP, /**< Stop sampling. */
+	CAN_SYNC_TRIGGER, /**< Fire an armed trigger. */
+	NUM_CAN_SYNC_EVENTS /**<@internal The total number of events. */
+} CAN_SyncEvent_t;
+
+/**
+ * @brief Function pointer called from the main loop with the start and stop events received by a slave.
+ */
+typedef void (*CAN_SyncHandler)(CAN_SyncEvent_t event, uint32_t argument);
+
+/**
+ * @brief Function pointer called from the receive interrupt when a slave receives a trigger.
+ */
+typedef void (*CAN_TriggerHandler)(void);
 
 /*--------------------------------------------------------------------------------------------------------*/
 /* PUBLIC METHODS */
@@ -54,6 +113,61 @@ CanRxMsg RxMessage;
  */
 void Tekdaqc_CAN_Config(void);
 
+/**
+ * @brief Sets and saves the synchronization role of the board.
+ */
+bool Tekdaqc_CAN_SetSyncRole(CAN_SyncRole_t role);
+
+/**
+ * @brief Retrieves the synchronization role of the board.
+ */
+CAN_SyncRole_t Tekdaqc_CAN_GetSyncRole(void);
+
+/**
+ * @brief Sets the functions which act on the synchronization frames received by a slave.
+ */
+void Tekdaqc_CAN_SetSyncHandlers(CAN_SyncHandler sync, CAN_TriggerHandler trigger);
+
+/**
+ * @brief Broadcasts a synchronization frame to the slaves.
+ */
+bool Tekdaqc_CAN_SendSync(CAN_SyncEvent_t event, uint32_t argument);
+
+/**
+ * @brief Starts sending sample frames on the CAN bus.
+ */
+bool Tekdaqc_CAN_StreamStart(uint32_t id);
+
+/**
+ * @brief Stops sending sample frames on the CAN bus.
+ */
+void Tekdaqc_CAN_StreamStop(void);
+
+/**
+ * @brief Indicates if sample frames are being sent on the CAN bus.
+ */
+bool Tekdaqc_CAN_IsStreaming(void);
+
+/**
+ * @brief Retrieves the number of sample frames which can currently be queued.
+ */
+uint16_t Tekdaqc_CAN_StreamGetFree(void);
+
+/**
+ * @brief Queues a sample frame for a channel.
+ */
+WriteStatus_t Tekdaqc_CAN_StreamWrite(uint8_t channel, const uint8_t* data, uint8_t length);
+
+/**
+ * @brief Called by the CAN transmit interrupt handler to refill the transmit mailboxes.
+ */
+void Tekdaqc_CAN_TransmitHandler(void);
+
+/**
+ * @brief Called by the CAN receive interrupt handler to take the received frames.
+ */
+void Tekdaqc_CAN_ReceiveHandler(void);
+
 #ifdef __cplusplus
 }
 #endif
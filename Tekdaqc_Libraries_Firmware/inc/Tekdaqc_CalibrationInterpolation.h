@@ -0,0 +1,142 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_CalibrationInterpolation.h
+ * @brief Temperature interpolation of the Tekdaqc's gain calibration table.
+ *
+ * Contains the fixed point arithmetic which locates a temperature between the data points of the calibration table
+ * and interpolates the gain calibration from them. It is kept apart from the table itself, which lives in FLASH, so
+ * that it depends on nothing but its arguments and can be checked off the board.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_CALIBRATION_INTERPOLATION_H_
+#define TEKDAQC_CALIBRATION_INTERPOLATION_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stddef.h>
+
+/** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
+ * @{
+ */
+
+/** @addtogroup tekdaqc_calibration_interpolation Tekdaqc Calibration Interpolation
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def CAL_TEMP_FRACTION_BITS
+ * @brief The number of fractional bits of the fixed point temperatures, i.e. temperatures are in 1/256 Deg C.
+ */
+#define CAL_TEMP_FRACTION_BITS 8U
+
+/**
+ * @def CAL_FACTOR_FRACTION_BITS
+ * @brief The number of fractional bits of the interpolation factor.
+ */
+#define CAL_FACTOR_FRACTION_BITS 16U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Converts a temperature to fixed point with CAL_TEMP_FRACTION_BITS fractional bits, rounding to the nearest.
+ *
+ * @param temperature float The temperature in Deg C.
+ * @retval int32_t The fixed point temperature.
+ */
+static inline int32_t Calibration_TemperatureToFixed(float temperature) {
+	const float scaled = temperature * (float) (1UL << CAL_TEMP_FRACTION_BITS);
+	return (int32_t) ((scaled >= 0.0f) ? (scaled + 0.5f) : (scaled - 0.5f));
+}
+
+/**
+ * Locates a fixed point temperature within the steps of a table. Temperatures outside of the table are clamped to
+ * its ends.
+ *
+ * @param temperature int32_t The fixed point temperature.
+ * @param low int32_t The fixed point temperature of the table's first data point.
+ * @param step int32_t The fixed point temperature step between the table's data points.
+ * @param count uint32_t The number of data points in the table.
+ * @param factor uint32_t* Set to the position of the temperature within the step, with CAL_FACTOR_FRACTION_BITS
+ * fractional bits. May be NULL.
+ * @retval uint32_t The step whose data point is at or below the temperature.
+ */
+static inline uint32_t Calibration_LocateTemperature(int32_t temperature, int32_t low, int32_t step, uint32_t count,
+		uint32_t* factor) {
+	uint32_t index = 0U;
+	uint32_t position = 0U;
+	if ((step > 0) && (count > 1U) && (temperature > low)) {
+		const uint32_t above = (uint32_t) (temperature - low);
+		index = above / (uint32_t) step;
+		position = above % (uint32_t) step;
+		if (index >= (count - 1U)) {
+			/* At or beyond the last data point, which is the high end of the last step */
+			index = count - 2U;
+			position = (uint32_t) step;
+		}
+	}
+	if (factor != NULL) {
+		*factor = (uint32_t) ((((uint64_t) position) << CAL_FACTOR_FRACTION_BITS) / (uint32_t) ((step > 0) ? step : 1));
+	}
+	return index;
+}
+
+/**
+ * Interpolates two calibration values based on the specified factor. The arithmetic is done in integers so the
+ * result only depends on its inputs, and is rounded to the nearest value.
+ *
+ * @param low uint32_t The lower calibration data point.
+ * @param high uint32_t The higher calibration data point.
+ * @param factor uint32_t The interpolation factor with CAL_FACTOR_FRACTION_BITS fractional bits. A value of 0
+ * corresponds to low, a value of 1 corresponds to high.
+ * @retval uint32_t The interpolated value.
+ */
+static inline uint32_t Calibration_InterpolateValue(uint32_t low, uint32_t high, uint32_t factor) {
+	const int64_t delta = (int64_t) high - (int64_t) low;
+	/* The shift is arithmetic, so halves round up whether the values rise or fall with temperature */
+	const int64_t step = ((delta * (int64_t) factor) + (1LL << (CAL_FACTOR_FRACTION_BITS - 1U))) >> CAL_FACTOR_FRACTION_BITS;
+	return (uint32_t) ((int64_t) low + step);
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_CALIBRATION_INTERPOLATION_H_ */
@@ -92,11 +92,31 @@ FLASH_Status Tekdaqc_SetCalibrationHighTemperature(float temp);
  */
 FLASH_Status Tekdaqc_SetCalibrationStepTemperature(float temp);
 
+/**
+ * @brief Sets the number of temperature entries of the table.
+ */
+FLASH_Status Tekdaqc_SetCalibrationTemperatureCount(uint32_t count);
+
+/**
+ * @brief Writes the table header, sealing the table written since entering calibration mode with its CRC.
+ */
+FLASH_Status Tekdaqc_WriteCalibrationHeader(void);
+
 /**
  * @brief Sets the gain calibration value for the specified parameters.
  */
 FLASH_Status Tekdaqc_SetGainCalibration(uint32_t cal, ADS1256_SPS_t rate, ADS1256_PGA_t gain, ADS1256_BUFFER_t buffer, float temperature);
 
+/**
+ * @brief Sets the gain calibration values of every sample rate and temperature for the specified gain and buffer setting.
+ */
+FLASH_Status Tekdaqc_SetGainCalibrationSlice(const uint32_t* values, uint32_t steps, ADS1256_PGA_t gain, ADS1256_BUFFER_t buffer);
+
+/**
+ * @brief Verifies the gain calibration slices written since entering calibration mode against a CRC.
+ */
+FLASH_Status Tekdaqc_VerifyCalibrationUpload(uint32_t crc);
+
 /**
  * @brief Sets the offset calibration value for the specified parameters.
  */
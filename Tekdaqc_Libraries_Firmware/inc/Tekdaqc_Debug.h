@@ -146,6 +146,104 @@ extern "C" {
  */
 /*#define TELNET_CHAR_DEBUG */
 
+/**
+ * @internal
+ * @def DATA_SERVER_DEBUG
+ * @brief Used to turn on debugging `printf` statements for the sample data server.
+ */
+/*#define DATA_SERVER_DEBUG */
+
+/**
+ * @internal
+ * @def MODBUS_SERVER_DEBUG
+ * @brief Used to turn on debugging `printf` statements for the Modbus TCP server.
+ */
+/*#define MODBUS_SERVER_DEBUG */
+
+/**
+ * @internal
+ * @def HTTP_SERVER_DEBUG
+ * @brief Used to turn on debugging `printf` statements for the HTTP download server.
+ */
+/*#define HTTP_SERVER_DEBUG */
+
+/**
+ * @internal
+ * @def WEBSOCKET_SERVER_DEBUG
+ * @brief Used to turn on debugging `printf` statements for the WebSocket live stream.
+ */
+/*#define WEBSOCKET_SERVER_DEBUG */
+
+/**
+ * @internal
+ * @def UPGRADE_SERVER_DEBUG
+ * @brief Used to turn on debugging `printf` statements for the firmware upgrade server.
+ */
+/*#define UPGRADE_SERVER_DEBUG */
+
+/**
+ * @internal
+ * @def UPGRADE_DEBUG
+ * @brief Used to turn on debugging `printf` statements for the staging and installation of firmware upgrades.
+ */
+/*#define UPGRADE_DEBUG */
+
+/**
+ * @internal
+ * @def SAMPLE_LOG_DEBUG
+ * @brief Used to turn on debugging `printf` statements for the store and forward log of sample data.
+ */
+/*#define SAMPLE_LOG_DEBUG */
+
+/**
+ * @internal
+ * @def PUBLISHER_DEBUG
+ * @brief Used to turn on debugging `printf` statements for the UDP sample publisher.
+ */
+/*#define PUBLISHER_DEBUG */
+
+/**
+ * @internal
+ * @def RAW_STREAM_DEBUG
+ * @brief Used to turn on debugging `printf` statements for the raw Ethernet sample stream.
+ */
+/*#define RAW_STREAM_DEBUG */
+
+/**
+ * @internal
+ * @def SNTP_DEBUG
+ * @brief Used to turn on debugging `printf` statements for the SNTP client.
+ */
+/*#define SNTP_DEBUG */
+
+/**
+ * @internal
+ * @def CAN_DEBUG
+ * @brief Used to turn on debugging `printf` statements for the CAN synchronization.
+ */
+/*#define CAN_DEBUG */
+
+/**
+ * @internal
+ * @def SCHEDULER_DEBUG
+ * @brief Used to turn on debugging `printf` statements for the cooperative task scheduler.
+ */
+/*#define SCHEDULER_DEBUG */
+
+/**
+ * @internal
+ * @def CRASH_RECORD_DEBUG
+ * @brief Used to turn on debugging `printf` statements for the reset cause and crash record.
+ */
+/*#define CRASH_RECORD_DEBUG */
+
+/**
+ * @internal
+ * @def STATISTICS_DEBUG
+ * @brief Used to turn on debugging `printf` statements for the runtime performance statistics.
+ */
+/*#define STATISTICS_DEBUG */
+
 /**
  * @internal
  * @def CALIBRATION_DEBUG
@@ -153,6 +251,69 @@ extern "C" {
  */
 /*#define CALIBRATION_DEBUG */
 
+/**
+ * @internal
+ * @def ANALOG_FILTER_DEBUG
+ * @brief Used to turn on debugging `printf` statements for the analog input filters.
+ */
+/*#define ANALOG_FILTER_DEBUG */
+
+/**
+ * @internal
+ * @def ANALOG_TRIGGER_DEBUG
+ * @brief Used to turn on debugging `printf` statements for the analog capture trigger.
+ */
+/*#define ANALOG_TRIGGER_DEBUG */
+
+/**
+ * @internal
+ * @def DIGITAL_EDGE_DEBUG
+ * @brief Used to turn on debugging `printf` statements for the digital input edge capture.
+ */
+/*#define DIGITAL_EDGE_DEBUG */
+
+/**
+ * @internal
+ * @def DIGITAL_ENCODER_DEBUG
+ * @brief Used to turn on debugging `printf` statements for the digital input quadrature encoders.
+ */
+/*#define DIGITAL_ENCODER_DEBUG */
+
+/**
+ * @internal
+ * @def DIGITAL_INTERLOCK_DEBUG
+ * @brief Used to turn on debugging `printf` statements for the digital output interlocks.
+ */
+/*#define DIGITAL_INTERLOCK_DEBUG */
+
+/**
+ * @internal
+ * @def DIGITAL_PID_DEBUG
+ * @brief Used to turn on debugging `printf` statements for the digital output PID loops.
+ */
+/*#define DIGITAL_PID_DEBUG */
+
+/**
+ * @internal
+ * @def ANALOG_POWER_DEBUG
+ * @brief Used to turn on debugging `printf` statements for the analog input power channels.
+ */
+/*#define ANALOG_POWER_DEBUG */
+
+/**
+ * @internal
+ * @def ANALOG_MATH_DEBUG
+ * @brief Used to turn on debugging `printf` statements for the analog input math channels.
+ */
+/*#define ANALOG_MATH_DEBUG */
+
+/**
+ * @internal
+ * @def CHANNEL_CONFIG_DEBUG
+ * @brief Used to turn on debugging `printf` statements for the saved channel configuration.
+ */
+/*#define CHANNEL_CONFIG_DEBUG */
+
 /**
  * @internal
  * @def CALIBRATION_TABLE_DEBUG
@@ -167,6 +328,27 @@ extern "C" {
  */
 #define LOCATOR_DEBUG
 
+/**
+ * @internal
+ * @def HOT_PATH_PROFILE
+ * @brief Used to turn on the cycle count profiling of the program loop's hot paths, reported by the PROFILE command.
+ */
+/*#define HOT_PATH_PROFILE */
+
+/**
+ * @internal
+ * @def FLOAT_BENCHMARK
+ * @brief Used to run the floating point and interrupt context save benchmarks at start up.
+ */
+/*#define FLOAT_BENCHMARK */
+
+/**
+ * @internal
+ * @def BENCHMARK_SUITE
+ * @brief Used to build a benchmark firmware, which runs the scripted acquisition scenarios at start up.
+ */
+/*#define BENCHMARK_SUITE */
+
 /**
  * @internal
  * @def SERIAL_DEBUG
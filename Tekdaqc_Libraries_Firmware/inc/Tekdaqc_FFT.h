@@ -0,0 +1,96 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_FFT.h
+ * @brief Header file for the real FFT of the Tekdaqc.
+ *
+ * Contains public definitions and function prototypes for transforming blocks of real samples to their spectrum,
+ * used to reduce vibration and AC measurements to their frequency content on the board.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_FFT_H_
+#define TEKDAQC_FFT_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+#include <boolean.h>
+
+/** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
+ * @{
+ */
+
+/** @addtogroup tekdaqc_fft Tekdaqc FFT
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def FFT_MIN_POINTS
+ * @brief The smallest block which may be transformed.
+ */
+#define FFT_MIN_POINTS		16U
+
+/**
+ * @def FFT_MAX_POINTS
+ * @brief The largest block which may be transformed. The twiddle table is built for this size.
+ */
+#define FFT_MAX_POINTS		1024U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Determines if a number of points is a block size which may be transformed.
+ */
+bool FFT_IsValidSize(uint16_t points);
+
+/**
+ * @brief Multiplies a block of samples by a Hann window.
+ */
+void FFT_ApplyHannWindow(float* data, uint16_t points);
+
+/**
+ * @brief Transforms a block of real samples in place to its spectrum.
+ */
+void FFT_Real(float* data, uint16_t points);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_FFT_H_ */
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Format.h
+ * @brief Header file for the integer formatting routines of the Tekdaqc.
+ *
+ * Contains public definitions for formatting integers as decimal text without going through the C library's
+ * printf family, which is slow for 64 bit values. Used for the lines of the text data streams, along with measuring
+ * the strings of fixed size fields.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_FORMAT_H_
+#define TEKDAQC_FORMAT_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stddef.h>
+
+/** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
+ * @{
+ */
+
+/** @addtogroup tekdaqc_format Tekdaqc Integer Formatting
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def FORMAT_UINT32_MAX_LENGTH
+ * @brief The most characters a formatted uint32_t takes, not counting the terminating NULL.
+ */
+#define FORMAT_UINT32_MAX_LENGTH	10U
+
+/**
+ * @def FORMAT_INT32_MAX_LENGTH
+ * @brief The most characters a formatted int32_t takes, not counting the terminating NULL.
+ */
+#define FORMAT_INT32_MAX_LENGTH		11U
+
+/**
+ * @def FORMAT_UINT64_MAX_LENGTH
+ * @brief The most characters a formatted uint64_t takes, not counting the terminating NULL.
+ */
+#define FORMAT_UINT64_MAX_LENGTH	20U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Formats an unsigned 32 bit integer as decimal text.
+ */
+uint8_t Format_UInt32(char* dest, uint32_t value);
+
+/**
+ * @brief Formats a signed 32 bit integer as decimal text.
+ */
+uint8_t Format_Int32(char* dest, int32_t value);
+
+/**
+ * @brief Formats an unsigned 64 bit integer as decimal text.
+ */
+uint8_t Format_UInt64(char* dest, uint64_t value);
+
+/**
+ * @brief Retrieves the length of a string held in a fixed size field, which may not be NULL terminated.
+ */
+size_t Format_BoundedLength(const char* str, size_t max);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_FORMAT_H_ */
@@ -49,6 +49,42 @@ extern "C"
 /* EXPORTED CONSTANTS */
 /*--------------------------------------------------------------------------------------------------------*/
 
+/**
+ * @def LOCATOR_SAMPLING_ANALOG
+ * @brief Flag of the extended status response set while analog inputs are being sampled.
+ */
+#define LOCATOR_SAMPLING_ANALOG		((uint8_t) 0x01)
+
+/**
+ * @def LOCATOR_SAMPLING_DIGITAL_INPUTS
+ * @brief Flag of the extended status response set while digital inputs are being sampled.
+ */
+#define LOCATOR_SAMPLING_DIGITAL_INPUTS		((uint8_t) 0x02)
+
+/**
+ * @def LOCATOR_SAMPLING_DIGITAL_OUTPUTS
+ * @brief Flag of the extended status response set while digital outputs are being sampled.
+ */
+#define LOCATOR_SAMPLING_DIGITAL_OUTPUTS	((uint8_t) 0x04)
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Locator load data structure.
+ * Holds the current load of the board, reported by the extended status response so hosts can pick an idle board
+ * without connecting to each one.
+ */
+typedef struct {
+	uint8_t sampling; /**< The LOCATOR_SAMPLING_* flags of what is being sampled. */
+	uint8_t analogInputs; /**< The number of analog inputs being sampled. */
+	uint32_t samplesPerSecond; /**< The achieved analog samples per second. */
+	uint8_t sessions; /**< The number of connected Telnet sessions. */
+	uint8_t maxSessions; /**< The most Telnet sessions which may be connected. */
+	uint16_t bufferFree; /**< The lowest free transmit buffer space of the connected sessions in bytes. */
+} Tekdaqc_LocatorLoad_t;
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PUBLIC METHODS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -58,6 +94,11 @@ extern "C"
  */
 void Tekdaqc_LocatorInit(void);
 
+/**
+ * @brief Sets the load fields of the extended status response packet.
+ */
+void Tekdaqc_LocatorLoadSet(const Tekdaqc_LocatorLoad_t* load);
+
 /**
  * @brief Sets the board type in the locator response packet.
  */
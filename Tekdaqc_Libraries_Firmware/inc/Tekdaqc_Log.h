@@ -0,0 +1,195 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Log.h
+ * @brief Header file for the debug log of the Tekdaqc.
+ *
+ * Contains public definitions and data types for the Tekdaqc's debug log, which queues leveled messages in RAM and
+ * sends them out of the debug serial port in the background.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_LOG_H_
+#define TEKDAQC_LOG_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+#include "Tekdaqc_Debug.h"
+#include <boolean.h>
+
+/** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
+ * @{
+ */
+
+/** @addtogroup tekdaqc_log Tekdaqc Log
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def LOG_BUFFER_SIZE
+ * @brief The size of the ring messages wait in to be sent. Must be a power of two.
+ */
+#define LOG_BUFFER_SIZE 4096U
+
+/**
+ * @def LOG_LINE_LENGTH
+ * @brief The longest formatted message, longer ones are truncated.
+ */
+#define LOG_LINE_LENGTH 128U
+
+/**
+ * @def LOG_LEVEL_DEFAULT
+ * @brief The level the log starts out at.
+ */
+#ifdef DEBUG
+#define LOG_LEVEL_DEFAULT LOG_LEVEL_DEBUG
+#else
+#define LOG_LEVEL_DEFAULT LOG_LEVEL_WARNING
+#endif
+
+/**
+ * @def LOG_ERROR
+ * @brief Logs a formatted message at LOG_LEVEL_ERROR.
+ */
+#define LOG_ERROR(...) Log_Printf(LOG_LEVEL_ERROR, __VA_ARGS__)
+
+/**
+ * @def LOG_WARNING
+ * @brief Logs a formatted message at LOG_LEVEL_WARNING.
+ */
+#define LOG_WARNING(...) Log_Printf(LOG_LEVEL_WARNING, __VA_ARGS__)
+
+/**
+ * @def LOG_INFO
+ * @brief Logs a formatted message at LOG_LEVEL_INFO.
+ */
+#define LOG_INFO(...) Log_Printf(LOG_LEVEL_INFO, __VA_ARGS__)
+
+/**
+ * @def LOG_DEBUG
+ * @brief Logs a formatted message at LOG_LEVEL_DEBUG.
+ */
+#define LOG_DEBUG(...) Log_Printf(LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+/**
+ * @def LOG_TRACE
+ * @brief Logs a formatted message at LOG_LEVEL_TRACE.
+ */
+#define LOG_TRACE(...) Log_Printf(LOG_LEVEL_TRACE, __VA_ARGS__)
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Log level enumeration.
+ * A message is logged if its level is at or below the log's level.
+ */
+typedef enum {
+	LOG_LEVEL_NONE, /**< Nothing is logged. */
+	LOG_LEVEL_ERROR, /**< Failures the board could not recover from by itself. */
+	LOG_LEVEL_WARNING, /**< Unexpected conditions the board recovered from. */
+	LOG_LEVEL_INFO, /**< Changes of state, such as starting and stopping a sampling. */
+	LOG_LEVEL_DEBUG, /**< Detail for tracking down a problem. */
+	LOG_LEVEL_TRACE, /**< Detail of every sample or transfer. */
+	NUM_LOG_LEVELS /**<@internal The number of log levels. */
+} LogLevel_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Configures the debug serial port and starts sending the log out of it.
+ */
+void Log_Init(void);
+
+/**
+ * @brief Sets the level of the messages which are logged.
+ */
+void Log_SetLevel(LogLevel_t level);
+
+/**
+ * @brief Retrieves the level of the messages which are logged.
+ */
+LogLevel_t Log_GetLevel(void);
+
+/**
+ * @brief Determines if messages of a level are logged.
+ */
+bool Log_IsEnabled(LogLevel_t level);
+
+/**
+ * @brief Converts a log level to its name.
+ */
+const char* Log_StringFromLevel(LogLevel_t level);
+
+/**
+ * @brief Converts the name of a log level to the level.
+ */
+bool Log_LevelFromString(const char* name, LogLevel_t* level);
+
+/**
+ * @brief Formats a message into the log if its level is enabled.
+ */
+void Log_Printf(LogLevel_t level, const char* format, ...) __attribute__ ((format (printf, 2, 3)));
+
+/**
+ * @brief Queues raw bytes to be sent out of the debug serial port.
+ */
+uint32_t Log_Write(const char* data, uint32_t length);
+
+/**
+ * @brief Sends everything waiting in the log, without relying on interrupts.
+ */
+void Log_Flush(void);
+
+/**
+ * @brief Retrieves the number of bytes discarded because the log was full.
+ */
+uint32_t Log_GetDroppedCount(void);
+
+/**
+ * @brief Sends the next waiting byte of the log. Called from the debug serial port's interrupt.
+ */
+void Log_IRQHandler(void);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_LOG_H_ */
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Profile.h
+ * @brief Header file for the hot path profiler of the Tekdaqc.
+ *
+ * Contains public definitions and data types for timing the program loop's hot paths with the DWT cycle counter.
+ * Each profiled path is bracketed with PROFILE_BEGIN() and PROFILE_END(), which compile to nothing unless
+ * HOT_PATH_PROFILE is defined.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_PROFILE_H_
+#define TEKDAQC_PROFILE_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+#include "Tekdaqc_Debug.h"
+#include <boolean.h>
+
+/** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
+ * @{
+ */
+
+/** @addtogroup tekdaqc_profile Tekdaqc Profile
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#ifdef HOT_PATH_PROFILE
+
+/**
+ * @def PROFILE_BEGIN
+ * @brief Marks the start of a profiled path. At most one may be used in a scope.
+ */
+#define PROFILE_BEGIN()			const uint32_t profileStart = DWT->CYCCNT
+
+/**
+ * @def PROFILE_END
+ * @brief Marks the end of a profiled path, recording its cycle count against the provided point.
+ */
+#define PROFILE_END(point)		Profile_Record((point), DWT->CYCCNT - profileStart)
+
+#else
+
+#define PROFILE_BEGIN()
+#define PROFILE_END(point)
+
+#endif /* HOT_PATH_PROFILE */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Profile point enumeration.
+ * Defines the profiled paths of the program loop.
+ */
+typedef enum {
+	PROFILE_ADC_SERVICE, /**< ADC_Machine_Service(), including any samples it writes. */
+	PROFILE_WRITE_ANALOG_INPUT, /**< WriteAnalogInput(). */
+	PROFILE_LWIP_PKT_HANDLE, /**< LwIP_Pkt_Handle(). */
+	PROFILE_TELNET_POLL, /**< TelnetPoll(). */
+	PROFILE_COMMAND_PARSE_LINE, /**< Command_ParseLine(), including the command it executes. */
+	PROFILE_COMPRESS_ANALOG_INPUT, /**< Compressing a run of analog samples into a packed binary record. */
+	NUM_PROFILE_POINTS /**<@internal The total number of profile points. */
+} ProfilePoint_t;
+
+/**
+ * @brief Data structure holding the cycle counts recorded for a profile point.
+ */
+typedef struct {
+	uint32_t count; /**< The number of times the path was run. */
+	uint32_t min; /**< The fewest cycles a run took. */
+	uint32_t max; /**< The most cycles a run took. */
+	uint64_t total; /**< The total cycles of all runs. */
+} ProfileStatistics_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#ifdef HOT_PATH_PROFILE
+
+/**
+ * @brief Records a run of a profiled path.
+ */
+void Profile_Record(ProfilePoint_t point, uint32_t cycles);
+
+/**
+ * @brief Retrieves the cycle counts recorded for a profile point.
+ */
+bool Profile_GetStatistics(ProfilePoint_t point, ProfileStatistics_t* statistics);
+
+/**
+ * @brief Discards the cycle counts recorded for all profile points.
+ */
+void Profile_Reset(void);
+
+#endif /* HOT_PATH_PROFILE */
+
+/**
+ * @brief Return the human readable string representation of the provided profile point.
+ */
+const char* Profile_StringFromPoint(ProfilePoint_t point);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_PROFILE_H_ */
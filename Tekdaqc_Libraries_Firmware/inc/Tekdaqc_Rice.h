@@ -0,0 +1,122 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Rice.h
+ * @brief Header file for the Rice coder of the Tekdaqc.
+ *
+ * Contains public definitions and data types for writing Rice coded numbers to a bounded bit stream, used to
+ * compress the residuals of slowly changing sample streams.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_RICE_H_
+#define TEKDAQC_RICE_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+#include <boolean.h>
+
+/** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
+ * @{
+ */
+
+/** @addtogroup tekdaqc_rice Tekdaqc Rice Coder
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def RICE_ESCAPE
+ * @brief The quotient at which a number is sent in full instead. A number whose quotient would be this or more is
+ * written as RICE_ESCAPE 1 bits, without the terminating 0, followed by the number itself.
+ */
+#define RICE_ESCAPE		16U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Data structure for writing a bit stream to a bounded buffer. Bits are packed least significant first.
+ */
+typedef struct {
+	uint8_t* dest; /**< The buffer being written. */
+	uint16_t limit; /**< The most bytes which may be written. */
+	uint16_t length; /**< The number of complete bytes written. */
+	uint32_t accumulator; /**< The bits not yet written, least significant first. */
+	uint8_t pending; /**< The number of bits in the accumulator. */
+	bool overflow; /**< TRUE if the stream did not fit in the limit. */
+} RiceWriter_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Starts a bit stream in a buffer.
+ */
+void Rice_Begin(RiceWriter_t* writer, uint8_t* dest, uint16_t limit);
+
+/**
+ * @brief Writes a number of bits to a bit stream.
+ */
+void Rice_WriteBits(RiceWriter_t* writer, uint32_t value, uint8_t bits);
+
+/**
+ * @brief Writes a Rice coded number to a bit stream.
+ */
+void Rice_WriteCode(RiceWriter_t* writer, uint32_t value, uint8_t k, uint8_t width);
+
+/**
+ * @brief Completes a bit stream, padding its last byte with zeros.
+ */
+uint16_t Rice_End(RiceWriter_t* writer);
+
+/**
+ * @brief Chooses the Rice parameter for numbers of a given mean.
+ */
+uint8_t Rice_ChooseParameter(uint32_t sum, uint32_t count, uint8_t max);
+
+/**
+ * @brief Maps a signed number onto the unsigned numbers, small magnitudes first.
+ */
+uint32_t Rice_ZigZag(int32_t value);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_RICE_H_ */
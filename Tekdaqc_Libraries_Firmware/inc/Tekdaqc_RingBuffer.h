@@ -0,0 +1,211 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_RingBuffer.h
+ * @brief Single producer, single consumer ring buffer indexing for the Tekdaqc.
+ *
+ * Contains a lock free ring buffer which manages only the indices of a ring, leaving the storage to its owner so that
+ * one ring can index several parallel arrays. The capacity must be a power of two so that indices are found with a
+ * mask. The producer and consumer may run in different contexts, such as an interrupt and the main loop, provided
+ * each side only calls its own methods.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_RING_BUFFER_H_
+#define TEKDAQC_RING_BUFFER_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+#include <boolean.h>
+
+/** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
+ * @{
+ */
+
+/** @addtogroup tekdaqc_ring_buffer Tekdaqc Ring Buffer
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def IS_RING_BUFFER_CAPACITY
+ * @brief Checks that a ring buffer capacity is a non-zero power of two.
+ */
+#define IS_RING_BUFFER_CAPACITY(CAPACITY) (((CAPACITY) != 0U) && (((CAPACITY) & ((CAPACITY) - 1U)) == 0U))
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Ring buffer index structure.
+ * The head and tail are free running counts which are only masked when used as an index, so the ring can hold
+ * its full capacity and the number of stored elements is simply their difference.
+ */
+typedef struct {
+	volatile uint32_t head; /**< The number of elements ever written. Only modified by the producer. */
+	volatile uint32_t tail; /**< The number of elements ever read. Only modified by the consumer. */
+	uint32_t mask; /**< The capacity of the ring minus one. */
+	volatile uint32_t overflows; /**< The number of elements refused because the ring was full. */
+} RingBuffer_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Initializes a ring buffer to be empty. Neither the producer nor the consumer may be using the ring.
+ *
+ * @param ring RingBuffer_t* The ring to initialize.
+ * @param capacity uint32_t The number of elements of the ring's storage. Must be a power of two.
+ * @retval none
+ */
+static inline void RingBuffer_Init(RingBuffer_t* ring, uint32_t capacity) {
+	ring->head = 0U;
+	ring->tail = 0U;
+	ring->mask = capacity - 1U;
+	ring->overflows = 0U;
+}
+
+/**
+ * Retrieves the number of elements which have been written but not yet read.
+ *
+ * @param ring const RingBuffer_t* The ring to check.
+ * @retval uint32_t The number of stored elements.
+ */
+static inline uint32_t RingBuffer_Count(const RingBuffer_t* ring) {
+	return ring->head - ring->tail;
+}
+
+/**
+ * Indicates if the ring holds no elements.
+ *
+ * @param ring const RingBuffer_t* The ring to check.
+ * @retval bool True if the ring is empty.
+ */
+static inline bool RingBuffer_IsEmpty(const RingBuffer_t* ring) {
+	return (ring->head == ring->tail);
+}
+
+/**
+ * Producer side. Retrieves the storage index of the next element to be written, without publishing it. A full ring
+ * refuses the element and counts the overflow.
+ *
+ * @param ring RingBuffer_t* The ring to write to.
+ * @param index uint32_t* Set to the storage index to fill.
+ * @retval bool True if there is room for the element.
+ */
+static inline bool RingBuffer_BeginWrite(RingBuffer_t* ring, uint32_t* index) {
+	const uint32_t head = ring->head;
+	if ((head - ring->tail) > ring->mask) {
+		++(ring->overflows);
+		return false;
+	}
+	*index = head & ring->mask;
+	return true;
+}
+
+/**
+ * Producer side. As RingBuffer_BeginWrite(), but the element is refused unless there is room for the given number of
+ * elements. Used by producers which keep storage shared by a group of elements, so the group is not started until
+ * all of its previous elements have been read.
+ *
+ * @param ring RingBuffer_t* The ring to write to.
+ * @param index uint32_t* Set to the storage index to fill.
+ * @param reserve uint32_t The number of free elements required. Must be between 1 and the capacity.
+ * @retval bool True if there is room for the element.
+ */
+static inline bool RingBuffer_BeginWriteReserve(RingBuffer_t* ring, uint32_t* index, uint32_t reserve) {
+	const uint32_t head = ring->head;
+	if ((head - ring->tail) > (ring->mask + 1U - reserve)) {
+		++(ring->overflows);
+		return false;
+	}
+	*index = head & ring->mask;
+	return true;
+}
+
+/**
+ * Producer side. Publishes the element filled after RingBuffer_BeginWrite() to the consumer. The barrier makes sure
+ * the element's storage is written before the consumer can see it.
+ *
+ * @param ring RingBuffer_t* The ring to publish to.
+ * @retval none
+ */
+static inline void RingBuffer_EndWrite(RingBuffer_t* ring) {
+	__DMB();
+	ring->head = ring->head + 1U;
+}
+
+/**
+ * Consumer side. Retrieves the storage index of a stored element without removing it.
+ *
+ * @param ring const RingBuffer_t* The ring to read from.
+ * @param offset uint32_t The position of the element from the oldest, which is 0. Must be less than the count.
+ * @retval uint32_t The storage index of the element.
+ */
+static inline uint32_t RingBuffer_PeekIndex(const RingBuffer_t* ring, uint32_t offset) {
+	return (ring->tail + offset) & ring->mask;
+}
+
+/**
+ * Consumer side. Removes the oldest elements once they have been used. The barrier makes sure they have been read
+ * before the producer can reuse their storage.
+ *
+ * @param ring RingBuffer_t* The ring to release from.
+ * @param count uint32_t The number of elements to release. Must not exceed the count.
+ * @retval none
+ */
+static inline void RingBuffer_Release(RingBuffer_t* ring, uint32_t count) {
+	__DMB();
+	ring->tail = ring->tail + count;
+}
+
+/**
+ * Retrieves the number of elements which have been refused because the ring was full.
+ *
+ * @param ring const RingBuffer_t* The ring to check.
+ * @retval uint32_t The number of overflows.
+ */
+static inline uint32_t RingBuffer_GetOverflowCount(const RingBuffer_t* ring) {
+	return ring->overflows;
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_RING_BUFFER_H_ */
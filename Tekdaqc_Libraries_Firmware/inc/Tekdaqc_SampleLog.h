@@ -0,0 +1,160 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_SampleLog.h
+ * @brief Header file for the store and forward log of sample data.
+ *
+ * Contains public definitions and data types for the log which keeps sample data in FLASH while it has no
+ * destination, and replays it in order once it has one again.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_SAMPLE_LOG_H_
+#define TEKDAQC_SAMPLE_LOG_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+#include "Tekdaqc_Debug.h"
+#include "Tekdaqc_Config.h"
+#include <boolean.h>
+
+/** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
+ * @{
+ */
+
+/** @addtogroup sample_log Sample Log
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def SAMPLE_LOG_STAGE_SIZE
+ * @brief The number of bytes of logged records held in RAM waiting to be programmed. A single record can be no
+ * larger than this, less its 4 byte header.
+ */
+#define SAMPLE_LOG_STAGE_SIZE 2048U
+
+/**
+ * @def SAMPLE_LOG_WORDS_PER_SERVICE
+ * @brief The most record words programmed by a single call of SampleLog_Service(). Each word stalls the CPU for
+ * roughly 16 us, so a service call fits the budget of the storage task.
+ */
+#define SAMPLE_LOG_WORDS_PER_SERVICE 8U
+
+/**
+ * @def SAMPLE_LOG_RECORDS_PER_SERVICE
+ * @brief The most records replayed by a single call of SampleLog_Service(). Each replayed record is marked in FLASH,
+ * which stalls the CPU as a word does.
+ */
+#define SAMPLE_LOG_RECORDS_PER_SERVICE 8U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Data structure holding the counters and usage of the sample log.
+ */
+typedef struct {
+	uint32_t used; /**< The bytes of the log sector which have been programmed since it was last erased. */
+	uint32_t backlog; /**< The bytes of logged records waiting to be replayed, programmed or not. */
+	uint32_t firstSequence; /**< The sequence number of the first record held in the log sector. */
+	uint32_t nextSequence; /**< The sequence number of the next record to be replayed. */
+	uint32_t lastSequence; /**< The sequence number of the last record logged, 0 if there has been none. */
+	uint32_t logged; /**< The number of records logged since start up. */
+	uint32_t replayed; /**< The number of records replayed since start up. */
+	uint32_t dropped; /**< The number of records lost since start up, because the log was full or failed. */
+} SampleLogCounts_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Finds the records left in the log by the last reset and prepares the log sector.
+ */
+void SampleLog_Init(WriteFunction stringWriter, BinaryWriteFunction binaryWriter);
+
+/**
+ * @brief Turns the logging of sample data without a destination on or off.
+ */
+void SampleLog_SetEnabled(bool enable);
+
+/**
+ * @brief Indicates if sample data without a destination is logged.
+ */
+bool SampleLog_IsEnabled(void);
+
+/**
+ * @brief Indicates if there are logged records waiting to be replayed.
+ */
+bool SampleLog_HasBacklog(void);
+
+/**
+ * @brief Logs a sample data string.
+ */
+WriteStatus_t SampleLog_WriteString(const char* string);
+
+/**
+ * @brief Logs a block of binary sample data.
+ */
+WriteStatus_t SampleLog_WriteBinary(const uint8_t* data, uint16_t length);
+
+/**
+ * @brief Performs the next step of programming, replaying or erasing the log.
+ */
+bool SampleLog_Service(bool idle);
+
+/**
+ * @brief Resumes the replay of the log after the last record a host has received.
+ */
+bool SampleLog_Resume(uint32_t sequence, uint32_t* first, uint32_t* last);
+
+/**
+ * @brief Indicates if the log sector is being erased.
+ */
+bool SampleLog_IsErasing(void);
+
+/**
+ * @brief Retrieves the counters and usage of the sample log.
+ */
+void SampleLog_GetCounts(SampleLogCounts_t* counts);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_SAMPLE_LOG_H_ */
@@ -0,0 +1,231 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Scheduler.h
+ * @brief Header file for the cooperative task scheduler of the Tekdaqc.
+ *
+ * Contains public definitions and data types for the Tekdaqc's cooperative task scheduler, which runs the work of
+ * the program loop by priority with a time budget for each task, and for supervising those tasks on behalf of the
+ * watchdog.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_SCHEDULER_H_
+#define TEKDAQC_SCHEDULER_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+#include "Tekdaqc_Debug.h"
+#include <boolean.h>
+
+/** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
+ * @{
+ */
+
+/** @addtogroup tekdaqc_scheduler Tekdaqc Scheduler
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def SCHEDULER_MAX_TASKS
+ * @brief The maximum number of tasks which can be added to the scheduler.
+ */
+#define SCHEDULER_MAX_TASKS 12U
+
+/**
+ * @def SCHEDULER_STARVATION_US
+ * @brief The longest time in microseconds a supervised task may go without running before the scheduler stops
+ * feeding the watchdog. It must be longer than the period of every supervised task and shorter than the watchdog
+ * timeout.
+ */
+#define SCHEDULER_STARVATION_US 2000000U
+
+/**
+ * @def SCHEDULER_MAX_IDLE_US
+ * @brief The longest time in microseconds the scheduler sleeps for while no task has work ready. Tasks with no period
+ * which poll without an interrupt to wake them are run again within this time.
+ */
+#define SCHEDULER_MAX_IDLE_US 1000U
+
+/**
+ * @def SCHEDULER_MIN_IDLE_US
+ * @brief The shortest time in microseconds worth sleeping for. Shorter idle times are spent running the tasks again.
+ */
+#define SCHEDULER_MIN_IDLE_US 20U
+
+/**
+ * @def SCHEDULER_MAX_DEFERRED
+ * @brief The maximum number of deferrals which can be waiting to run. Must be a power of two.
+ */
+#define SCHEDULER_MAX_DEFERRED 16U
+
+/**
+ * @def SCHEDULER_DEFER_BATCH
+ * @brief The most deferrals run at the start of a single pass, so that a burst of them can not starve the tasks.
+ */
+#define SCHEDULER_DEFER_BATCH 8U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Task priority enumeration.
+ * Each pass of the scheduler runs every due task of the highest priority, then every due task of the normal
+ * priority, then a single due task of the low priority. The high priority tasks therefore run again between each
+ * low priority task, and each normal priority task is guaranteed a slot on every pass.
+ */
+typedef enum {
+	TASK_PRIORITY_HIGH, /**< Time critical work, such as servicing the sampling state machines. */
+	TASK_PRIORITY_NORMAL, /**< Work which must progress on every pass, such as network receive and transmit. */
+	TASK_PRIORITY_LOW, /**< Work which may be deferred, such as command processing. */
+	NUM_TASK_PRIORITIES /**< The number of task priorities. */
+} TaskPriority_t;
+
+/**
+ * @brief Function pointer to the body of a task.
+ * A task does a bounded amount of work on each call and returns TRUE if it has more work ready, in which case
+ * it is called again while its budget allows.
+ */
+typedef bool (*TaskFunction)(void);
+
+/**
+ * @brief Function pointer to work deferred from an interrupt to the program loop.
+ * The argument is the one provided when the work was deferred.
+ */
+typedef void (*DeferredFunction)(uint32_t argument);
+
+/**
+ * @brief Watchdog reset cause enumeration.
+ * Defines what a supervised task was doing when the watchdog was left to expire.
+ */
+typedef enum {
+	SUPERVISOR_NO_RECORD, /**< The last reset was not caused by a supervised task. */
+	SUPERVISOR_STALLED, /**< The task was running and never returned. */
+	SUPERVISOR_STARVED, /**< The task had not run for SCHEDULER_STARVATION_US. */
+	NUM_SUPERVISOR_CAUSES /**<@internal The number of causes. */
+} SupervisorCause_t;
+
+/**
+ * @brief Data structure holding the supervision statistics of a task.
+ */
+typedef struct {
+	const char* name; /**< The name the task is supervised under. */
+	uint32_t timeout; /**< The longest time in microseconds a single run of the task should take. */
+	uint32_t longest; /**< The longest time in microseconds a single run has taken. */
+	uint32_t overruns; /**< The number of runs which took longer than the timeout. */
+} SupervisorStatistics_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Adds a task to the scheduler.
+ */
+bool Scheduler_AddTask(TaskFunction function, TaskPriority_t priority, uint32_t period, uint32_t budget);
+
+/**
+ * @brief Performs a single pass of the scheduler.
+ */
+void Scheduler_Run(void);
+
+/**
+ * @brief Requests that the next pass starts as soon as the running task returns.
+ */
+void Scheduler_RequestPass(void);
+
+/**
+ * @brief Defers work from an interrupt to the start of the next pass.
+ */
+bool Scheduler_Defer(DeferredFunction function, uint32_t argument);
+
+/**
+ * @brief Retrieves the number of deferrals refused because the queue was full.
+ */
+uint32_t Scheduler_GetDeferOverflows(void);
+
+/**
+ * @brief Sleeps until an interrupt, or the next task is due, if no task has work ready.
+ */
+void Scheduler_Idle(void);
+
+/**
+ * @brief Retrieves the total time the scheduler has slept for.
+ */
+uint64_t Scheduler_GetIdleTime(void);
+
+/**
+ * @brief Retrieves the number of passes the scheduler has made since start up.
+ */
+uint32_t Scheduler_GetPassCount(void);
+
+/**
+ * @brief Places a scheduled task under supervision.
+ */
+bool Scheduler_SuperviseTask(TaskFunction function, const char* name, uint32_t timeout);
+
+/**
+ * @brief Indicates if every supervised task is running normally, so that the watchdog may be fed.
+ */
+bool Scheduler_IsHealthy(void);
+
+/**
+ * @brief Retrieves the supervision statistics of a task.
+ */
+bool Scheduler_GetStatistics(uint8_t index, SupervisorStatistics_t* statistics);
+
+/**
+ * @brief Picks up the record a supervised task left before a watchdog reset.
+ */
+void Scheduler_CaptureResetRecord(bool watchdogReset);
+
+/**
+ * @brief Retrieves the record a supervised task left before the last watchdog reset.
+ */
+SupervisorCause_t Scheduler_GetResetRecord(const char** name);
+
+/**
+ * @brief Return the human readable string representation of the provided watchdog reset cause.
+ */
+const char* Scheduler_StringFromCause(SupervisorCause_t cause);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_SCHEDULER_H_ */
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_StateTrace.h
+ * @brief Header file for the state machine transition trace of the Tekdaqc.
+ *
+ * Contains public definitions and data types for recording the transitions of the ADC, digital input and digital
+ * output state machines, stamped with the DWT cycle counter, in a RAM ring which the host reads back in binary to
+ * rebuild the timeline of a scan.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_STATE_TRACE_H_
+#define TEKDAQC_STATE_TRACE_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+#include "Tekdaqc_Debug.h"
+#include <boolean.h>
+
+/** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
+ * @{
+ */
+
+/** @addtogroup tekdaqc_state_trace Tekdaqc State Trace
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def STATE_TRACE_SIZE
+ * @brief The number of transitions the trace holds. Must be a power of two. Once full, the oldest are overwritten.
+ */
+#define STATE_TRACE_SIZE			512U
+
+/**
+ * @def STATE_TRACE_FRAME_EVENTS
+ * @brief The most transitions sent in a single binary trace frame.
+ */
+#define STATE_TRACE_FRAME_EVENTS	32U
+
+/**
+ * @def STATE_TRACE_FRAME_HEADER_SIZE
+ * @brief The size in bytes of a binary trace frame before its transitions.
+ */
+#define STATE_TRACE_FRAME_HEADER_SIZE	12U
+
+/**
+ * @def STATE_TRACE_EVENT_SIZE
+ * @brief The size in bytes of a transition in a binary trace frame.
+ */
+#define STATE_TRACE_EVENT_SIZE		8U
+
+/**
+ * @def STATE_TRACE_FRAME_SIZE
+ * @brief The size in bytes of the largest binary trace frame.
+ */
+#define STATE_TRACE_FRAME_SIZE		(STATE_TRACE_FRAME_HEADER_SIZE + (STATE_TRACE_FRAME_EVENTS * STATE_TRACE_EVENT_SIZE))
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief State trace machine enumeration.
+ * Identifies the state machine a transition was made by.
+ */
+typedef enum {
+	STATE_TRACE_ADC, /**< The ADC state machine. */
+	STATE_TRACE_DI, /**< The digital input state machine. */
+	STATE_TRACE_DO, /**< The digital output state machine. */
+	NUM_STATE_TRACE_MACHINES /**<@internal The total number of traced state machines. */
+} StateTraceMachine_t;
+
+/**
+ * @brief Data structure holding a recorded transition.
+ */
+typedef struct {
+	uint32_t cycles; /**< The DWT cycle count when the transition was made. */
+	uint8_t machine; /**< The StateTraceMachine_t which made the transition. */
+	uint8_t state; /**< The state entered, as the machine's own state enumeration. */
+	uint16_t detail; /**< Machine specific detail, the position in the scan for the ADC. */
+} StateTraceEvent_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Records a state machine transition.
+ */
+void StateTrace_Record(StateTraceMachine_t machine, uint8_t state, uint16_t detail);
+
+/**
+ * @brief Builds a binary trace frame of the oldest transitions not yet read.
+ */
+uint16_t StateTrace_BuildFrame(uint8_t* frame, uint16_t* length);
+
+/**
+ * @brief Marks the transitions of the last frame built as read.
+ */
+void StateTrace_ConsumeFrame(void);
+
+/**
+ * @brief Retrieves the number of transitions recorded and not yet read, including any since overwritten.
+ */
+uint32_t StateTrace_GetPending(void);
+
+/**
+ * @brief Retrieves the number of transitions recorded since start up.
+ */
+uint32_t StateTrace_GetRecorded(void);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_STATE_TRACE_H_ */
@@ -35,6 +35,7 @@ extern "C" {
 /*--------------------------------------------------------------------------------------------------------*/
 
 #include "stm32f4xx.h"
+#include <boolean.h>
 
 /** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
  * @{
@@ -49,28 +50,55 @@ extern "C" {
 /*--------------------------------------------------------------------------------------------------------*/
 
 /**
- * @def SYSTEMTICK_PERIOD_US
- * @brief Defines the time period in microseconds for SYSTICK interrupts.
+ * @def TIMEBASE_TIM
+ * @brief The 32 bit hardware timer which counts the local time in microseconds.
  */
-#define SYSTEMTICK_PERIOD_US 			16
+#define TIMEBASE_TIM 					TIM2
+
+/**
+ * @def TIMEBASE_TIM_CLK
+ * @brief The peripheral clock of the time base timer.
+ */
+#define TIMEBASE_TIM_CLK 				RCC_APB1Periph_TIM2
+
+/**
+ * @def TIMEBASE_IRQn
+ * @brief The interrupt of the time base timer, which fires only when its counter overflows.
+ */
+#define TIMEBASE_IRQn 					TIM2_IRQn
 
 /**
- * @def SYSTEMTICK_DIVIDER_US
- * @brief Defines the clock divider for the SYSTICK timer.
+ * @def TIMEBASE_FREQUENCY
+ * @brief The count frequency of the time base timer, in Hz.
  */
-#define SYSTEMTICK_DIVIDER_US 			(1000000 / SYSTEMTICK_PERIOD_US)
+#define TIMEBASE_FREQUENCY 				1000000U
+
+/**
+ * @def SYSTEMTICK_PERIOD_US
+ * @brief Defines the time period in microseconds of a single period for Delay_Periods().
+ */
+#define SYSTEMTICK_PERIOD_US 			16
 
 /**
  * @def SYSTEMTICK_PERIOD
- * @brief Defines the time period to use for the SYSTICK interrupts. This is what is used by the setup code.
+ * @brief Defines the time period in microseconds of a single period for Delay_Periods().
  */
 #define SYSTEMTICK_PERIOD 				(SYSTEMTICK_PERIOD_US)
 
 /**
- * @def SYSTEMTICK_DIVIDER
- * @brief Defines the clock divider for the SYSTICK timer. This is what is used by the setup code.
+ * @def TIMER_DEADLINE_COUNT
+ * @brief The number of deadlines which may be scheduled at the same time.
+ */
+#define TIMER_DEADLINE_COUNT 			8U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Function pointer called from the main loop once a scheduled deadline has passed.
  */
-#define SYSTEMTICK_DIVIDER 				(SYSTEMTICK_DIVIDER_US)
+typedef void (*DeadlineCallback)(void);
 
 /*--------------------------------------------------------------------------------------------------------*/
 /* PUBLIC METHODS */
@@ -82,7 +110,7 @@ extern "C" {
 void Timer_Config(void);
 
 /**
- * @brief Called by the SYSTICK interrupt handler.
+ * @brief Called by the time base timer interrupt handler when its counter overflows.
  */
 void Time_Update(void);
 
@@ -91,6 +119,66 @@ void Time_Update(void);
  */
 uint64_t GetLocalTime(void);
 
+/**
+ * @brief Sets the mapping of local time to epoch time.
+ */
+void Timer_SetEpochMapping(uint64_t reference, int64_t offset, int32_t drift);
+
+/**
+ * @brief Clears the mapping of local time to epoch time.
+ */
+void Timer_ClearEpochMapping(void);
+
+/**
+ * @brief Indicates if local time can be converted to epoch time.
+ */
+bool Timer_IsEpochValid(void);
+
+/**
+ * @brief Converts a local time stamp to epoch time.
+ */
+uint64_t Timer_ToEpochTime(uint64_t local);
+
+/**
+ * @brief Schedules a callback to be made from the main loop once the provided time has passed.
+ */
+bool Timer_ScheduleDeadline(DeadlineCallback callback, uint32_t us);
+
+/**
+ * @brief Cancels a scheduled deadline.
+ */
+void Timer_CancelDeadline(DeadlineCallback callback);
+
+/**
+ * @brief Indicates if a deadline is scheduled for the provided callback.
+ */
+bool Timer_IsDeadlinePending(DeadlineCallback callback);
+
+/**
+ * @brief Called from the main loop to make the callbacks of any deadlines which have passed.
+ */
+void Timer_ServiceDeadlines(void);
+
+/**
+ * @brief Retrieves the earliest time any scheduled deadline may pass.
+ */
+uint64_t Timer_GetNextDeadline(void);
+
+/**
+ * @brief Arms the time base to raise an interrupt once the provided time has passed.
+ */
+void Timer_SetWakeUp(uint32_t us);
+
+/**
+ * @brief Disarms the wake up interrupt of the time base.
+ */
+void Timer_CancelWakeUp(void);
+
+/**
+ * @brief Blocking delay, measured in nanoseconds, for sub-microsecond timing.
+ */
+void Delay_ns(uint32_t ns);
+
 /**
  * @brief Blocking delay, measured in fractional milliseconds.
  */
@@ -107,7 +195,7 @@ void Delay_us(uint64_t us);
 void Delay_Periods_10MS(uint32_t nCount);
 
 /**
- * @brief Blocking delay, measured in SYSTICK periods.
+ * @brief Blocking delay, measured in SYSTEMTICK_PERIOD periods.
  */
 void Delay_Periods(uint32_t nCount);
 
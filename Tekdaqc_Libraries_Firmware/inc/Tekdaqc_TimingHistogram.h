@@ -0,0 +1,127 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_TimingHistogram.h
+ * @brief Header file for the timing histograms of the Tekdaqc.
+ *
+ * Contains public definitions and data types for the histograms of the acquisition and program loop timing, used to
+ * see how regularly samples are taken and the loop is run.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_TIMINGHISTOGRAM_H_
+#define TEKDAQC_TIMINGHISTOGRAM_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+#include "Tekdaqc_Debug.h"
+#include <boolean.h>
+
+/** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
+ * @{
+ */
+
+/** @addtogroup tekdaqc_timing_histogram Tekdaqc Timing Histogram
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def TIMING_HISTOGRAM_BUCKETS
+ * @brief The number of buckets of each histogram. Bucket 0 counts intervals of 0 us and bucket n intervals from
+ * 2^(n-1) up to 2^n us, the last bucket also counting everything longer.
+ */
+#define TIMING_HISTOGRAM_BUCKETS	20U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Timing histogram enumeration.
+ * Defines the intervals which are histogrammed.
+ */
+typedef enum {
+	TIMING_DRDY_TO_READ, /**< From DRDY signaling a conversion to its data being read. */
+	TIMING_SAMPLE_INTERVAL, /**< Between successive conversions of the same input. */
+	TIMING_LOOP_PERIOD, /**< Between successive passes of the program loop. */
+	NUM_TIMING_HISTOGRAMS /**<@internal The total number of histograms. */
+} TimingHistogram_t;
+
+/**
+ * @brief Data structure holding a histogram of intervals.
+ */
+typedef struct {
+	uint32_t count; /**< The number of intervals recorded. */
+	uint32_t min; /**< The shortest interval recorded (us), valid once the count is non zero. */
+	uint32_t max; /**< The longest interval recorded (us), valid once the count is non zero. */
+	uint32_t buckets[TIMING_HISTOGRAM_BUCKETS]; /**< The number of intervals recorded in each bucket. */
+} TimingHistogramData_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Records an interval in a histogram.
+ */
+void TimingHistogram_Record(TimingHistogram_t histogram, uint32_t interval);
+
+/**
+ * @brief Retrieves a copy of a histogram.
+ */
+bool TimingHistogram_Get(TimingHistogram_t histogram, TimingHistogramData_t* data);
+
+/**
+ * @brief Discards the intervals recorded in all histograms.
+ */
+void TimingHistogram_Reset(void);
+
+/**
+ * @brief Retrieves the exclusive upper limit of a histogram bucket.
+ */
+uint32_t TimingHistogram_BucketLimit(uint8_t bucket);
+
+/**
+ * @brief Return the human readable string representation of the provided histogram.
+ */
+const char* TimingHistogram_StringFromHistogram(TimingHistogram_t histogram);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_TIMINGHISTOGRAM_H_ */
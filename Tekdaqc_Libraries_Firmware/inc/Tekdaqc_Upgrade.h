@@ -0,0 +1,160 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Upgrade.h
+ * @brief Header file for the staging and installation of firmware upgrades.
+ *
+ * Contains public definitions and data types for staging a new firmware image in FLASH while the running firmware
+ * keeps sampling, and for installing it over the running firmware on the next reset.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef TEKDAQC_UPGRADE_H_
+#define TEKDAQC_UPGRADE_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+#include "Tekdaqc_Debug.h"
+#include <boolean.h>
+
+/** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
+ * @{
+ */
+
+/** @addtogroup firmware_upgrade Firmware Upgrade
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def UPGRADE_BUFFER_SIZE
+ * @brief The number of received image bytes held in RAM waiting to be programmed.
+ */
+#define UPGRADE_BUFFER_SIZE 1024U
+
+/**
+ * @def UPGRADE_WORDS_PER_SERVICE
+ * @brief The most image words programmed by a single call of Upgrade_Service(). Each word stalls the CPU for
+ * roughly 16 us, so a service call fits the budget of the storage task.
+ */
+#define UPGRADE_WORDS_PER_SERVICE 8U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Upgrade state enumeration.
+ * Defines the states of the staging sectors.
+ */
+typedef enum {
+	UPGRADE_IDLE, /**< The staging sectors are erased and ready for an image. */
+	UPGRADE_DIRTY, /**< The staging sectors hold an abandoned image and wait to be erased. */
+	UPGRADE_ERASING, /**< The staging sectors are being erased. */
+	UPGRADE_RECEIVING, /**< An image is being received and programmed. */
+	UPGRADE_STAGED, /**< A verified image is staged and is installed on the next reset. */
+	NUM_UPGRADE_STATES /**<@internal The number of upgrade states. */
+} UpgradeState_t;
+
+/**
+ * @brief Upgrade status enumeration.
+ * The possible results of starting an upgrade.
+ */
+typedef enum {
+	UPGRADE_OK, /**< The upgrade was started. */
+	UPGRADE_ERR_BUSY, /**< The staging sectors are not ready for an image. */
+	UPGRADE_ERR_SIZE /**< The image does not fit the staging sectors. */
+} UpgradeStatus_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Installs a staged image, if there is one, and prepares the staging sectors.
+ */
+void Upgrade_Init(void);
+
+/**
+ * @brief Starts receiving an image into the staging sectors.
+ */
+UpgradeStatus_t Upgrade_Begin(uint32_t length, uint32_t crc);
+
+/**
+ * @brief Copies received image bytes into the programming buffer.
+ */
+uint16_t Upgrade_Accept(const uint8_t* data, uint16_t length);
+
+/**
+ * @brief Abandons the image being received or the staged image.
+ */
+void Upgrade_Abort(void);
+
+/**
+ * @brief Performs the next step of programming or erasing the staging sectors.
+ */
+bool Upgrade_Service(bool idle);
+
+/**
+ * @brief Indicates if the staging sectors are being erased.
+ */
+bool Upgrade_IsErasing(void);
+
+/**
+ * @brief Retrieves the state of the staging sectors.
+ */
+UpgradeState_t Upgrade_GetState(void);
+
+/**
+ * @brief Retrieves the progress of the image being received or staged.
+ */
+void Upgrade_GetProgress(uint32_t* received, uint32_t* length, uint32_t* crc);
+
+/**
+ * @brief Retrieves the CRC of the last image installed, if the last reset installed one.
+ */
+bool Upgrade_GetInstalled(uint32_t* length, uint32_t* crc);
+
+/**
+ * @brief Return the human readable string representation of the provided upgrade state.
+ */
+const char* Upgrade_StringFromState(UpgradeState_t state);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEKDAQC_UPGRADE_H_ */
@@ -59,17 +59,75 @@ extern __IO uint32_t LSICaptureNumber;
 extern char TOSTRING_BUFFER[SIZE_TOSTRING_BUFFER];
 extern unsigned char TEKDAQC_BOARD_SERIAL_NUM[BOARD_SERIAL_NUM_LENGTH + 1]; /* 32 chars plus NULL termination */
 
+/**
+ * @def DATA_FIELD_TIMESTAMP
+ * @brief Sample data field bit, set if each analog sample carries its timestamp.
+ */
+#define DATA_FIELD_TIMESTAMP	((uint8_t) 0x01)
+
+/**
+ * @def DATA_FIELD_FLAGS
+ * @brief Sample data field bit, set if each analog sample carries its flags.
+ */
+#define DATA_FIELD_FLAGS		((uint8_t) 0x02)
+
+/**
+ * @def DATA_FIELD_SEQUENCE
+ * @brief Sample data field bit, set if each analog sample carries its sequence number. Binary frames always imply it.
+ */
+#define DATA_FIELD_SEQUENCE		((uint8_t) 0x04)
+
+/**
+ * @def DATA_FIELD_DESCRIPTOR
+ * @brief Sample data field bit, set if each sampling run starts with a descriptor of the format and fields.
+ */
+#define DATA_FIELD_DESCRIPTOR	((uint8_t) 0x80)
+
+/**
+ * @def DATA_FIELDS_DEFAULT
+ * @brief The sample data fields sent until a client selects others: every field and no descriptor.
+ */
+#define DATA_FIELDS_DEFAULT		(DATA_FIELD_TIMESTAMP | DATA_FIELD_FLAGS | DATA_FIELD_SEQUENCE)
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* EXPORTED TYPES */
 /*--------------------------------------------------------------------------------------------------------*/
 
+/**
+ * @brief Write status enumeration.
+ * Defines the possible results of a call to a WriteFunction or BinaryWriteFunction. Writes are all or nothing;
+ * unless WRITE_OK is returned, none of the data was accepted.
+ */
+typedef enum {
+	WRITE_OK, /**< All of the data was accepted. */
+	WRITE_BUSY, /**< There is not currently enough room for the data. The caller may retry later. */
+	WRITE_NOT_CONNECTED, /**< There is no destination for the data. It should be discarded. */
+	WRITE_TOO_LARGE /**< The data can never fit in the destination. It should be discarded. */
+} WriteStatus_t;
+
 /**
  * @brief A common function pointer for specifying a function to write string data.
  *
  * A common function which is used to specify a function to write string data to an arbitrary destination.
- * This abstracts the code doing the writing from the code wanting to write.
+ * This abstracts the code doing the writing from the code wanting to write. The function must not block.
+ */
+typedef WriteStatus_t (*WriteFunction)(char* str);
+
+/**
+ * @brief A common function pointer for specifying a function to write binary data.
+ *
+ * Similar to WriteFunction, but the data is not NULL terminated and may contain any byte value.
+ */
+typedef WriteStatus_t (*BinaryWriteFunction)(const uint8_t* data, uint16_t length);
+
+/**
+ * @brief Data connection format enumeration.
+ * Defines the possible formats for sample data sent over the data connection.
  */
-typedef void (*WriteFunction)(char* str);
+typedef enum {
+	DATA_FORMAT_TEXT, /**< Human readable text records. This is the default. */
+	DATA_FORMAT_BINARY /**< Packed binary sample frames. */
+} DataFormat_t;
 
 /*--------------------------------------------------------------------------------------------------------*/
 /* PUBLIC METHODS */
@@ -81,10 +139,15 @@ typedef void (*WriteFunction)(char* str);
 void Watchdog_Init(void);
 
 /**
- * @brief Initializes the Tekdaqc's ethernet communications and lwIP stack.
+ * @brief Starts the Tekdaqc's ethernet communications, leaving the PHY coming out of reset.
  */
 void Communication_Init(void);
 
+/**
+ * @brief Completes the Tekdaqc's ethernet communications and starts the lwIP stack.
+ */
+void Communication_Complete(void);
+
 /**
  * @brief Initializes the Tekdaqc's FLASH disk.
  */
@@ -134,12 +197,6 @@ void TestPin_Off(TestPin_TypeDef pin);
  * @brief Toggles the state of the specified test pin.
  */
 void TestPin_Toggle(TestPin_TypeDef pin);
-
-/**
- * @internal
- * @brief Initialize COM3 interface for serial debug.
- */
-void DebugComPort_Init(void);
 #endif /* DEBUG */
 
 /**
@@ -36,6 +36,7 @@ extern "C" {
 
 #include "stm32f4xx.h"
 #include "Tekdaqc_Debug.h"
+#include "Tekdaqc_Config.h"
 #include <boolean.h>
 #include "lwip/tcp.h"
 
@@ -53,9 +54,72 @@ extern "C" {
 
 /**
  * @def TELNET_BUFFER_LENGTH
- * @brief The length of the buffer to use for Telnet data.
+ * @brief The length of the ring used for received Telnet data. Must be a power of two no smaller than the TCP
+ * receive window, as received data is only acknowledged to TCP once it has been read out of the ring.
  */
-#define TELNET_BUFFER_LENGTH 2056
+#define TELNET_BUFFER_LENGTH 4096U
+
+/**
+ * @def TELNET_BUFFER_MASK
+ * @brief Mask which reduces a receive ring position to an index into the ring.
+ */
+#define TELNET_BUFFER_MASK (TELNET_BUFFER_LENGTH - 1U)
+
+/**
+ * @def TELNET_MAX_SESSIONS
+ * @brief The number of clients which may be connected to the Telnet server at a time.
+ */
+#define TELNET_MAX_SESSIONS 3U
+
+/**
+ * @def TELNET_OPTION_COUNT
+ * @brief The number of telnet options whose state is kept for each session.
+ */
+#define TELNET_OPTION_COUNT 2U
+
+/**
+ * @def TELNET_TX_SEGMENT_SIZE
+ * @brief The size of each segment of the transmit ring. One segment fills a single TCP packet.
+ */
+#define TELNET_TX_SEGMENT_SIZE TCP_MSS
+
+/**
+ * @def TELNET_TX_SEGMENT_COUNT
+ * @brief The number of segments in the transmit ring, enough to fill the lwIP send buffer.
+ */
+#define TELNET_TX_SEGMENT_COUNT ((uint32_t) (TCP_SND_BUF / TCP_MSS))
+
+/**
+ * @def TELNET_TX_RING_SIZE
+ * @brief The total number of bytes the transmit ring can hold.
+ */
+#define TELNET_TX_RING_SIZE (TELNET_TX_SEGMENT_SIZE * TELNET_TX_SEGMENT_COUNT)
+
+/**
+ * @def TELNET_PRIORITY_BUFFER_SIZE
+ * @brief The number of bytes of status and error messages each session can hold to be sent ahead of the transmit
+ * ring. Large enough for any message built in a SIZE_TOSTRING_BUFFER.
+ */
+#define TELNET_PRIORITY_BUFFER_SIZE 512U
+
+/**
+ * @def TELNET_PRIORITY_SPAN_COUNT
+ * @brief The number of priority writes which may wait for the client's ACK at a time.
+ */
+#define TELNET_PRIORITY_SPAN_COUNT 4U
+
+/**
+ * @def TELNET_FLUSH_LATENCY_DEFAULT_US
+ * @brief The default time in microseconds data may wait in the transmit ring for a full segment to accumulate.
+ */
+#define TELNET_FLUSH_LATENCY_DEFAULT_US ((uint32_t) 2000U)
+
+/**
+ * @def TELNET_NO_DELAY_DEFAULT
+ * @brief The default no delay setting. Replies on the control channel are small and interactive, so they are sent
+ * without Nagle's algorithm.
+ */
+#define TELNET_NO_DELAY_DEFAULT true
 
 /**
  * @def NOT_CONNECTED
@@ -150,6 +214,29 @@ typedef enum {
 	TELNET_ERR_PCBCREATE /**< There was an error creating a PCB structure for the telnet server. */
 } TelnetStatus_t;
 
+/**
+ * @brief Telnet transmit segment structure.
+ * A single segment of the transmit ring. Data is handed to lwIP by reference, so the bytes of a segment which
+ * have been queued must not be modified until the client has ACKed them.
+ */
+typedef struct {
+	unsigned char data[TELNET_TX_SEGMENT_SIZE]; /**< The data to be transmitted to the telnet client. */
+	uint16_t length; /**< The number of bytes of valid data in the segment. */
+	uint16_t queued; /**< The number of bytes which have been handed to lwIP for transmission. */
+	uint16_t acked; /**< The number of bytes which have been ACKed by the telnet client. */
+	uint16_t boundary; /**< The offset just past the last complete record written into the segment, 0 if none. */
+} TelnetTxSegment_t;
+
+/**
+ * @brief Telnet priority span structure.
+ * A write of priority data handed to lwIP, placed in the stream after a known number of transmit ring bytes. The
+ * data is copied by lwIP, the span is only kept to tell its ACKs apart from those of the ring.
+ */
+typedef struct {
+	uint32_t after; /**< The number of transmit ring bytes handed to lwIP before the priority data. */
+	uint16_t length; /**< The number of bytes of the priority data which have not yet been ACKed. */
+} TelnetPrioritySpan_t;
+
 /**
  * @brief Data structure to hold the state of the Telnet server.
  * Contains all of the necessary state variables to impliment the Telnet server. Direct manipulation of these
@@ -161,16 +248,32 @@ typedef struct {
 	TelnetState_t state; /**< The current state of the telnet option parser. */
 	volatile unsigned long outstanding; /**< A count of the number of bytes that have been transmitted but have not yet been ACKed. */
 	unsigned long close; /**< A value that is non-zero when the telnet connection should be closed down. */
-	unsigned char buffer[TELNET_BUFFER_LENGTH]; /**< A buffer used to construct a packet of data to be transmitted to the telnet client. */
-	volatile unsigned long length; /**< The number of bytes of valid data in the telnet packet buffer. */
-	unsigned char recvBuffer[TELNET_BUFFER_LENGTH]; /**< A buffer used to receive data from the telnet connection. */
-	volatile unsigned long recvWrite; /**< The offset into g_pucTelnetRecvBuffer of the next location to be written in the buffer.
-	 The buffer is full if this value is one less than g_ulTelnetRecvRead (modulo the buffer size).*/
-	volatile unsigned long recvRead; /**< The offset into g_pucTelnetRecvRead of the next location to be read from the buffer.
-	 The buffer is empty if this value is equal to g_ulTelnetRecvWrite. */
+	TelnetTxSegment_t segments[TELNET_TX_SEGMENT_COUNT]; /**< The ring of segments used to transmit data to the telnet client. */
+	uint8_t txHead; /**< The index of the segment currently being filled. */
+	uint8_t txTail; /**< The index of the oldest segment which has not yet been released. */
+	uint8_t txUsed; /**< The number of segments between txTail and txHead, inclusive. */
+	uint16_t unsent; /**< The number of bytes in the transmit ring which have not been handed to lwIP. */
+	uint64_t unsentSince; /**< The local time at which the oldest unsent byte was written. */
+	uint16_t txPeak; /**< The most bytes the transmit ring has held since the client connected. */
+	bool txAtRecord; /**< Set if the ring data handed to lwIP ends at the end of a record, where priority data may go. */
+	uint32_t ringQueued; /**< The total number of transmit ring bytes handed to lwIP, wrapping. */
+	uint32_t ringAcked; /**< The total number of transmit ring bytes ACKed by the client, wrapping. */
+	char priority[TELNET_PRIORITY_BUFFER_SIZE]; /**< Status and error messages waiting to be sent ahead of the transmit ring. */
+	uint16_t priorityLength; /**< The number of bytes waiting in the priority buffer. */
+	TelnetPrioritySpan_t prioritySpans[TELNET_PRIORITY_SPAN_COUNT]; /**< The unACKed priority writes, oldest first. */
+	uint8_t prioritySpanCount; /**< The number of priority writes waiting for the client's ACK. */
+	unsigned char recvBuffer[TELNET_BUFFER_LENGTH]; /**< The ring used to receive data from the telnet connection. */
+	volatile uint32_t recvWrite; /**< The total number of bytes written to recvBuffer, wrapping. The ring is full when
+	 this is TELNET_BUFFER_LENGTH ahead of recvRead. */
+	volatile uint32_t recvRead; /**< The total number of bytes read from recvBuffer, wrapping. The ring is empty when
+	 this is equal to recvWrite. */
 	struct tcp_pcb* pcb; /**< A pointer to the telnet session PCB data structure. */
 	unsigned char previous; /**< The character most recently received via the telnet interface.  This is used to convert CR/LF sequences
 	 into a simple CR sequence. */
+	TelnetOpts_t options[TELNET_OPTION_COUNT]; /**< The state of the telnet options negotiated with this client. */
+	bool subscribed; /**< Set if published sample data is sent to this client. */
+	uint64_t ackedAt; /**< The local time the client last ACKed data, for detecting a client which has gone. */
+	unsigned long dropped; /**< The number of messages and characters discarded because the transmit buffer was full. */
 } TelnetServer_t;
 
 /**
@@ -184,25 +287,105 @@ TelnetStatus_t InitializeTelnetServer(void);
 void TelnetClose(void);
 
 /**
- * @brief Indicates if the Telnet server is occupied or not.
+ * @brief Indicates if the Telnet server has any connected client.
  */
 bool TelnetIsConnected(void);
 
+/**
+ * @brief Indicates if the current session has a connected client.
+ */
+bool TelnetIsSessionConnected(void);
+
+/**
+ * @brief Indicates if the Telnet server can accept another client.
+ */
+bool TelnetHasFreeSession(void);
+
+/**
+ * @brief Retrieves the number of connected Telnet sessions.
+ */
+uint8_t TelnetGetSessionCount(void);
+
+/**
+ * @brief Discards the data of every session which has not yet been handed to lwIP.
+ */
+void TelnetDiscardPending(void);
+
+/**
+ * @brief Retrieves the lowest free transmit buffer space of the connected sessions.
+ */
+uint16_t TelnetGetLowestFreeSpace(void);
+
+/**
+ * @brief Makes the next session with unread data the current session.
+ */
+void TelnetSelectNextSession(void);
+
+/**
+ * @brief Sets whether the current session receives published sample data.
+ */
+void TelnetSetSubscribed(bool subscribed);
+
+/**
+ * @brief Indicates if any connected session receives published sample data.
+ */
+bool TelnetHasSubscribers(void);
+
 /**
  * @brief Called when the lwIP TCP/IP stack needs to poll the server with/for data.
  */
 err_t TelnetPoll(void *arg, struct tcp_pcb *tpcb);
 
+/**
+ * @brief Called from the main loop to send pending data once the flush policy allows it.
+ */
+void TelnetService(void);
+
+/**
+ * @brief Sets the time data may wait in the transmit ring before it is sent.
+ */
+void TelnetSetFlushLatency(uint32_t latency);
+
+/**
+ * @brief Sets whether the connection sends and ACKs without delay.
+ */
+void TelnetSetNoDelay(bool enable);
+
 /**
  * @brief Writes a character into the telnet receive buffer.
  */
 void TelnetRecvBufferWrite(char character);
 
+/**
+ * @brief Writes a block of received characters into the telnet receive buffer.
+ */
+uint16_t TelnetRecvBufferWriteBytes(const char* data, uint16_t length);
+
 /**
  * @brief Reads a character from the telnet interface.
  */
 char TelnetRead(void);
 
+/**
+ * @brief Reads a byte from the telnet interface, reporting if one was available.
+ */
+bool TelnetReadByte(char* character);
+
+/**
+ * @brief Reads up to a block of bytes from the telnet interface.
+ */
+uint16_t TelnetReadBytes(char* data, uint16_t length);
+
+/**
+ * @brief Retrieves the contiguous unread data in the receive buffer without consuming it.
+ */
+uint16_t TelnetPeek(const char** data);
+
+/**
+ * @brief Consumes received data previously retrieved with TelnetPeek().
+ */
+void TelnetConsume(uint16_t length);
+
 /**
  * @brief Writes a character to the telnet interface.
  */
@@ -212,7 +395,72 @@ void TelnetWrite(const char character);
 /**
  * @brief Writes a string to the telnet interface.
  */
-void TelnetWriteString(char* string);
+WriteStatus_t TelnetWriteString(char* string);
+
+/**
+ * @brief Writes as much of a block of data to the telnet interface as currently fits.
+ */
+uint16_t TelnetWriteBytes(const char* data, uint16_t length);
+
+/**
+ * @brief Writes a block of binary data to the telnet interface.
+ */
+WriteStatus_t TelnetWriteBinary(const uint8_t* data, uint16_t length);
+
+/**
+ * @brief Publishes a string of sample data to every subscribed session.
+ */
+WriteStatus_t TelnetPublishString(char* string);
+
+/**
+ * @brief Publishes a block of binary sample data to every subscribed session.
+ */
+WriteStatus_t TelnetPublishBinary(const uint8_t* data, uint16_t length);
+
+/**
+ * @brief Retrieves the number of bytes which can currently be written to the telnet interface.
+ */
+uint16_t TelnetGetFreeSpace(void);
+
+/**
+ * @brief Retrieves the number of bytes held in the transmit buffer of the current session.
+ */
+uint16_t TelnetGetBufferUsed(void);
+
+/**
+ * @brief Retrieves the most bytes the transmit buffer of the current session has held.
+ */
+uint16_t TelnetGetBufferPeak(void);
+
+/**
+ * @brief Retrieves the number of bytes sent over all Telnet sessions since start up.
+ */
+uint32_t TelnetGetBytesSent(void);
+
+/**
+ * @brief Retrieves the number of writes discarded because the transmit buffer was full.
+ */
+unsigned long TelnetGetDroppedCount(void);
+
+/**
+ * @brief Sets the format sample data is sent in.
+ */
+void TelnetSetDataFormat(DataFormat_t format);
+
+/**
+ * @brief Retrieves the format sample data is sent in.
+ */
+DataFormat_t TelnetGetDataFormat(void);
+
+/**
+ * @brief Sets the fields each sample is sent with.
+ */
+void TelnetSetDataFields(uint8_t fields);
+
+/**
+ * @brief Retrieves the fields each sample is sent with.
+ */
+uint8_t TelnetGetDataFields(void);
 
 /**
  * @brief Handle a WILL request for a telnet option.
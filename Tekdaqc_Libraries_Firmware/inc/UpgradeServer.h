@@ -0,0 +1,107 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file UpgradeServer.h
+ * @brief Header file for the firmware upgrade server of the Tekdaqc.
+ *
+ * Contains public definitions and data types for the Tekdaqc firmware upgrade server. The upgrade server is a raw
+ * TCP stream which receives a new firmware image into the staging sectors while the board keeps running.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef UPGRADE_SERVER_H_
+#define UPGRADE_SERVER_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+#include "Tekdaqc_Debug.h"
+#include <boolean.h>
+
+/** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
+ * @{
+ */
+
+/** @addtogroup upgrade_server Upgrade Server
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def UPGRADE_HEADER_MAGIC
+ * @brief The first word of an upload, "TKUP" sent as a little endian word.
+ */
+#define UPGRADE_HEADER_MAGIC 0x50554B54U
+
+/**
+ * @def UPGRADE_HEADER_LENGTH
+ * @brief The length of the header of an upload: the magic word, the image length and the image CRC, each a little
+ * endian word.
+ */
+#define UPGRADE_HEADER_LENGTH 12U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Upgrade server status enumeration.
+ * The possible success/error causes for the upgrade server's operation.
+ */
+typedef enum {
+	UPGRADE_SERVER_OK, /**< Everything is normal with the upgrade server. */
+	UPGRADE_SERVER_ERR_BIND, /**< There was an error binding a socket to a port for the upgrade server. */
+	UPGRADE_SERVER_ERR_PCBCREATE /**< There was an error creating a PCB structure for the upgrade server. */
+} UpgradeServerStatus_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Creates the TCP listener for the upgrade server.
+ */
+UpgradeServerStatus_t InitializeUpgradeServer(void);
+
+/**
+ * @brief Called from the main loop to pass received image data on and report the result of an upload.
+ */
+void UpgradeServerService(void);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UPGRADE_SERVER_H_ */
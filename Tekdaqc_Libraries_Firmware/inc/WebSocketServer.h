@@ -0,0 +1,165 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file WebSocketServer.h
+ * @brief Header file for the WebSocket live stream of the Tekdaqc.
+ *
+ * Contains public definitions and data types for the Tekdaqc WebSocket live stream, which pushes the sample data and
+ * a table of latest values to browser dashboards. Clients connect through the HTTP server, see HttpServer.h.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef WEBSOCKET_SERVER_H_
+#define WEBSOCKET_SERVER_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "stm32f4xx.h"
+#include "Tekdaqc_Debug.h"
+#include <boolean.h>
+#include "HttpServer.h"
+#include "lwip/tcp.h"
+
+/** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
+ * @{
+ */
+
+/** @addtogroup websocket_server WebSocket Server
+ * @{
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED CONSTANTS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @def WEBSOCKET_MAX_CLIENTS
+ * @brief The number of dashboards which may be connected at once. Further upgrades are refused.
+ */
+#define WEBSOCKET_MAX_CLIENTS 2U
+
+/**
+ * @def WEBSOCKET_TABLE_SIZE
+ * @brief The size of the buffer the table of latest values is built in.
+ */
+#define WEBSOCKET_TABLE_SIZE 1024U
+
+/**
+ * @def WEBSOCKET_TABLE_INTERVAL_DEFAULT_MS
+ * @brief The default time in milliseconds between tables of latest values, when the client asks for none.
+ */
+#define WEBSOCKET_TABLE_INTERVAL_DEFAULT_MS 250U
+
+/**
+ * @def WEBSOCKET_TABLE_INTERVAL_MIN_MS
+ * @brief The shortest time in milliseconds between tables of latest values a client may ask for.
+ */
+#define WEBSOCKET_TABLE_INTERVAL_MIN_MS 20U
+
+/**
+ * @def WEBSOCKET_MAX_CONTROL_FRAME
+ * @brief The largest frame received from a client which is kept, a control frame with the most payload it may carry.
+ */
+#define WEBSOCKET_MAX_CONTROL_FRAME 139U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Function pointer to build the table of latest values.
+ * Builds the table in buffer, at most size bytes, and returns its length. It is sent as a binary message.
+ */
+typedef uint16_t (*WebSocketTableFunction)(uint8_t* buffer, uint16_t size);
+
+/**
+ * @brief Data structure holding the state of a WebSocket client connection.
+ */
+typedef struct {
+	struct tcp_pcb* pcb; /**< The connection's PCB, NULL if the slot is free. */
+	uint32_t interval; /**< The time in milliseconds between tables of latest values, 0 for none. */
+	uint64_t tableDue; /**< The local time the next table is due. */
+	uint8_t frame[WEBSOCKET_MAX_CONTROL_FRAME]; /**< The bytes received towards the next frame. */
+	uint8_t length; /**< The number of bytes in frame. */
+	uint32_t skip; /**< The payload bytes left of a received data frame, which are discarded. */
+	uint64_t ackedAt; /**< The time of the last acknowledgement from the client, in microseconds. */
+} WebSocketClient_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Initializes the WebSocket server.
+ */
+void WebSocketServerInit(WebSocketTableFunction table);
+
+/**
+ * @brief Takes a connection over from the HTTP server, completing the WebSocket handshake.
+ */
+HttpUpgradeResult_t WebSocketServerUpgrade(struct tcp_pcb* pcb, const char* query, const char* headers);
+
+/**
+ * @brief Called from the main loop to send the tables of latest values which are due.
+ */
+void WebSocketServerService(void);
+
+/**
+ * @brief Indicates if any WebSocket client is connected.
+ */
+bool WebSocketHasClients(void);
+
+/**
+ * @brief Sends a sample record string to every WebSocket client.
+ */
+void WebSocketBroadcastString(const char* string);
+
+/**
+ * @brief Sends a block of binary sample data to every WebSocket client.
+ */
+void WebSocketBroadcastBinary(const uint8_t* data, uint16_t length);
+
+/**
+ * @brief Closes every WebSocket client connection.
+ */
+void WebSocketServerCloseAll(void);
+
+/**
+ * @brief Retrieves the number of messages dropped for full send buffers since start up.
+ */
+uint32_t WebSocketGetDroppedCount(void);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WEBSOCKET_SERVER_H_ */
@@ -37,6 +37,7 @@ extern "C" {
 /* Includes ------------------------------------------------------------------*/
 #include "stm32f4xx.h"
 #include "Tekdaqc_BSP.h"
+#include <boolean.h>
 
 /** @addtogroup tekdaqc_firmware_libraries Tekdaqc Firmware Libraries
  * @{
@@ -66,12 +67,27 @@ extern "C" {
 /* Page full define */
 #define PAGE_FULL             ((uint8_t)0x80)
 
+#define QUEUE_FULL            ((uint16_t)0x00AC)     /* No room in the write queue */
+
+/* The number of writes which may be waiting in the write queue. Writes to the same variable are combined, so
+ * the queue can not fill */
+#define EE_QUEUE_SIZE         NUM_EEPROM_ADDRESSES
+
+/* The number of variables moved to the new page by each step of a page transfer */
+#define EE_TRANSFER_BATCH     4U
+
+/* The longest time in microseconds a page erase waits for an idle window before running anyway */
+#define EE_ERASE_DEFER_LIMIT  10000000U
+
 /* Exported types ------------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
 uint16_t EE_Init(void);
 uint16_t EE_ReadVariable(uint16_t VirtAddress, uint16_t* Data);
 uint16_t EE_WriteVariable(uint16_t VirtAddress, uint16_t Data);
+uint16_t EE_QueueWrite(uint16_t VirtAddress, uint16_t Data);
+bool EE_Service(bool Idle);
+bool EE_IsBusy(void);
 
 /**
  * @}
@@ -45,6 +45,40 @@ extern "C" {
   * @{
   */
 
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Ethernet receive drop counters.
+ * Counts since start up of the ways received frames are lost when they are not read quickly enough.
+ */
+typedef struct {
+	u32_t buffer_unavailable; /**< The number of times the DMA ran out of receive descriptors. */
+	u32_t missed_no_buffer; /**< The number of frames dropped because no receive descriptor was free. */
+	u32_t missed_overflow; /**< The number of frames dropped because the receive FIFO overflowed. */
+	u32_t no_pbuf; /**< The number of frames dropped because no pool buffer was free to copy them into. */
+} ethernetif_rx_stats_t;
+
+/**
+ * @brief Ethernet transmit drop counters.
+ * Counts since start up of the frames lost because the DMA still owned the descriptors they needed.
+ */
+typedef struct {
+	u32_t no_descriptor; /**< The number of frames dropped because no transmit descriptor was free. */
+} ethernetif_tx_stats_t;
+
+/**
+ * @brief Checksum offload states.
+ * The result of verifying at start up that the MAC inserts and checks the IPv4, TCP, UDP and ICMP checksums.
+ */
+typedef enum {
+	ETHERNETIF_CHECKSUM_SOFTWARE, /**< Built without CHECKSUM_BY_HARDWARE, lwIP computes the checksums. */
+	ETHERNETIF_CHECKSUM_VERIFIED, /**< Every Tx descriptor and the MAC and DMA were configured for offload. */
+	ETHERNETIF_CHECKSUM_REPAIRED, /**< Part of the offload configuration was missing and has been restored. */
+	ETHERNETIF_CHECKSUM_FAILED /**< The offload configuration could not be restored. */
+} ethernetif_checksum_t;
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* INTERFACE METHODS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -59,6 +93,46 @@ err_t ethernetif_init(struct netif *netif);
  */
 err_t ethernetif_input(struct netif *netif);
 
+/**
+ * @brief Checks if a received frame is ready to be read from the interface.
+ */
+u32_t ethernetif_frame_received(void);
+
+/**
+ * @brief Frees the frames transmitted in place which the DMA is done with.
+ */
+void ethernetif_release_tx(void);
+
+/**
+ * @brief Transmits a complete Ethernet frame in place, bypassing lwIP.
+ */
+err_t ethernetif_output_raw(const u8_t *frame, u16_t length);
+
+/**
+ * @brief Checks if the DMA is still transmitting a raw frame.
+ */
+u32_t ethernetif_raw_frame_busy(const u8_t *frame);
+
+/**
+ * @brief Handles the Ethernet DMA interrupt, flagging received frames.
+ */
+void ethernetif_irq_handler(void);
+
+/**
+ * @brief Retrieves the receive drop counters.
+ */
+void ethernetif_get_rx_stats(ethernetif_rx_stats_t *stats);
+
+/**
+ * @brief Retrieves the transmit drop counters.
+ */
+void ethernetif_get_tx_stats(ethernetif_tx_stats_t *stats);
+
+/**
+ * @brief Retrieves the result of the checksum offload verification made at start up.
+ */
+ethernetif_checksum_t ethernetif_get_checksum_offload(void);
+
 /**
  * @}
  */
@@ -58,6 +58,20 @@ extern "C" {
 	 */
 #define NO_SYS_NO_TIMERS        1
 
+	/**
+	 * NETWORK_PROFILE_STREAMING: selects the memory profile tuned for sustained
+	 * outbound data streaming, trading receive pool buffers for a larger heap,
+	 * TCP send buffer and segment queue. Left undefined, the default profile
+	 * suits the low rate command channel. May also be defined by the build.
+	 */
+/*#define NETWORK_PROFILE_STREAMING */
+
+#ifdef NETWORK_PROFILE_STREAMING
+#define NETWORK_PROFILE_NAME    "STREAMING"
+#else
+#define NETWORK_PROFILE_NAME    "COMMAND"
+#endif
+
 	/* ---------- Memory options ---------- */
 	/* MEM_ALIGNMENT: should be set to the alignment of the CPU for which
 	 lwIP is compiled. 4 byte alignment -> define MEM_ALIGNMENT to 4, 2
@@ -66,7 +80,11 @@ extern "C" {
 
 	/* MEM_SIZE: the size of the heap memory. If the application will send
 	 a lot of data that needs to be copied, this should be set high. */
+#ifdef NETWORK_PROFILE_STREAMING
+#define MEM_SIZE                (16*1024)
+#else
 #define MEM_SIZE                (10*1024)
+#endif
 
 	/* MEMP_NUM_PBUF: the number of memp struct pbufs. If the application
 	 sends a lot of data out of ROM (or other static memory), this
@@ -77,20 +95,30 @@ extern "C" {
 #define MEMP_NUM_UDP_PCB        6
 	/* MEMP_NUM_TCP_PCB: the number of simulatenously active TCP
 	 connections. */
-#define MEMP_NUM_TCP_PCB        10
+#define MEMP_NUM_TCP_PCB        12
 	/* MEMP_NUM_TCP_PCB_LISTEN: the number of listening TCP
 	 connections. */
 #define MEMP_NUM_TCP_PCB_LISTEN 6
 	/* MEMP_NUM_TCP_SEG: the number of simultaneously queued TCP
-	 segments. */
+	 segments. Must be at least TCP_SND_QUEUELEN. */
+#ifdef NETWORK_PROFILE_STREAMING
+#define MEMP_NUM_TCP_SEG        24
+#else
 #define MEMP_NUM_TCP_SEG        12
+#endif
 	/* MEMP_NUM_SYS_TIMEOUT: the number of simulateously active
 	 timeouts. */
 #define MEMP_NUM_SYS_TIMEOUT    10
 
 	/* ---------- Pbuf options ---------- */
-	/* PBUF_POOL_SIZE: the number of buffers in the pbuf pool. */
-#define PBUF_POOL_SIZE          10
+	/* PBUF_POOL_SIZE: the number of buffers in the pbuf pool. Only frames
+	 which are not received in place in the DMA buffers take pool buffers,
+	 so a streaming board, which receives little, needs fewer. */
+#ifdef NETWORK_PROFILE_STREAMING
+#define PBUF_POOL_SIZE          12
+#else
+#define PBUF_POOL_SIZE          24
+#endif
 
 	/* PBUF_POOL_BUFSIZE: the size of each pbuf in the pbuf pool. */
 #define PBUF_POOL_BUFSIZE       500
@@ -106,20 +134,36 @@ extern "C" {
 	/* TCP Maximum segment size. */
 #define TCP_MSS                 (1500 - 40)/* TCP_MSS = (Ethernet MTU - IP header size - TCP header size) */
 
-	/* TCP sender buffer space (bytes). */
+	/* TCP sender buffer space (bytes). The transmit rings of the Telnet
+	 and data servers are sized to fill it. */
+#ifdef NETWORK_PROFILE_STREAMING
+#define TCP_SND_BUF             (8*TCP_MSS)
+#else
 #define TCP_SND_BUF             (4*TCP_MSS)
+#endif
 
 	/*  TCP_SND_QUEUELEN: TCP sender buffer space (pbufs). This must be at least
 	 as much as (2 * TCP_SND_BUF/TCP_MSS) for things to work. */
 
 #define TCP_SND_QUEUELEN        (2* TCP_SND_BUF/TCP_MSS)
 
-	/* TCP receive window. */
+	/* TCP receive window. Commands are all that is received, in either
+	 profile. */
 #define TCP_WND                 (2*TCP_MSS)
 
 	/* ---------- ICMP options ---------- */
 #define LWIP_ICMP                       1
 
+	/* ---------- ARP options ---------- */
+	/* ETHARP_TRUST_IP_MAC==1: Every received IP packet refreshes the
+	 sender's ARP entry, so a reply to a client whose own cache is still
+	 warm never waits on a request of ours. */
+#define ETHARP_TRUST_IP_MAC             1
+
+	/* ETHARP_SUPPORT_STATIC_ENTRIES==1: Allow the entries of pinned hosts,
+	 see LwIP_PinHost(), to be kept as static entries which never expire. */
+#define ETHARP_SUPPORT_STATIC_ENTRIES   1
+
 	/* ---------- DHCP options ---------- */
 	/* Define LWIP_DHCP to 1 if you want DHCP configuration of
 	 interfaces. DHCP is not implemented in lwIP 0.5.1, however, so
@@ -130,8 +174,49 @@ extern "C" {
 #define LWIP_UDP                1
 #define UDP_TTL                 255
 
+	/* ---------- SNMP options ---------- */
+	/**
+	 * SNMP_AGENT: enables the SNMP agent, serving MIB-II and the Tekdaqc's
+	 * private MIB of acquisition performance counters, see Tekdaqc_Snmp.h,
+	 * to the "public" community on UDP port 161. The agent costs a UDP PCB
+	 * and the code and RAM of the SNMP module, but nothing until it is
+	 * polled: the objects are read from the counters the STATS command
+	 * reports. Left undefined, no agent is built. May also be defined by the
+	 * build.
+	 */
+/*#define SNMP_AGENT */
+
+#ifdef SNMP_AGENT
+#define LWIP_SNMP               1
+	/* The private MIB is declared in private_mib.h */
+#define SNMP_PRIVATE_MIB        1
+#endif
+
 	/* ---------- Statistics options ---------- */
+	/**
+	 * NETWORK_STATISTICS: enables the lwIP link, TCP, heap and memory pool
+	 * statistics reported by the GET_NETWORK_STATS command, at the cost of
+	 * the counters' RAM and the time to update them. Left undefined, only the
+	 * Ethernet driver and Telnet counters are kept. May also be defined by the
+	 * build.
+	 */
+/*#define NETWORK_STATISTICS */
+
+#ifdef NETWORK_STATISTICS
+#define LWIP_STATS              1
+#define LWIP_STATS_LARGE        1
+#define LINK_STATS              1
+#define TCP_STATS               1
+#define MEM_STATS               1
+#define MEMP_STATS              1
+#define ETHARP_STATS            0
+#define IP_STATS                0
+#define IPFRAG_STATS            0
+#define ICMP_STATS              0
+#define UDP_STATS               0
+#else
 #define LWIP_STATS 0
+#endif
 #define LWIP_PROVIDE_ERRNO 1
 
 	/* ---------- link callback options ---------- */
@@ -166,7 +251,7 @@ extern "C" {
 #define CHECKSUM_CHECK_UDP              0
 	/* CHECKSUM_CHECK_TCP==0: Check checksums by hardware for incoming TCP packets.*/
 #define CHECKSUM_CHECK_TCP              0
-	/* CHECKSUM_CHECK_ICMP==0: Check checksums by hardware for incoming ICMP packets.*/
+	/* CHECKSUM_GEN_ICMP==0: Generate checksums by hardware for outgoing ICMP packets.*/
 #define CHECKSUM_GEN_ICMP               0
 #else
 	/* CHECKSUM_GEN_IP==1: Generate checksums in software for outgoing IP packets.*/
@@ -181,7 +266,7 @@ extern "C" {
 #define CHECKSUM_CHECK_UDP              1
 	/* CHECKSUM_CHECK_TCP==1: Check checksums in software for incoming TCP packets.*/
 #define CHECKSUM_CHECK_TCP              1
-	/* CHECKSUM_CHECK_ICMP==1: Check checksums by hardware for incoming ICMP packets.*/
+	/* CHECKSUM_GEN_ICMP==1: Generate checksums in software for outgoing ICMP packets.*/
 #define CHECKSUM_GEN_ICMP               1
 #endif
 
@@ -41,6 +41,9 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "stm32f4xx.h"
+#include "lwip/ip_addr.h"
+#include "lwip/tcp.h"
+#include "boolean.h"
 /* Exported types ------------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
 #define DHCP_START                 1U
@@ -48,11 +51,43 @@
 #define DHCP_ADDRESS_ASSIGNED      3U
 #define DHCP_TIMEOUT               4U
 #define DHCP_LINK_DOWN             5U
+#define DHCP_STATIC                6U
+
+/* The number of hosts besides the gateway whose ARP entries can be pinned */
+#define LWIP_PINNED_HOSTS          4U
+
+/* How long established TCP connections are held open while the link is down (ms) */
+#define LWIP_LINK_HOLD_MS          300000U
+
+/* The default keepalive of the server connections: the idle time before the first probe and the time between
+ probes (ms), and the number of unanswered probes after which the connection is aborted */
+#define LWIP_KEEPALIVE_IDLE_DEFAULT_MS      5000U
+#define LWIP_KEEPALIVE_INTERVAL_DEFAULT_MS  1000U
+#define LWIP_KEEPALIVE_COUNT_DEFAULT        5U
+
+/* The default time a server connection's peer may leave sent data unacknowledged before it is taken to be gone, 0
+ to wait on TCP's own retransmission limit (ms) */
+#define LWIP_STALL_TIMEOUT_DEFAULT_MS       10000U
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
 void LwIP_Init(void);
 void LwIP_Pkt_Handle(void);
 void LwIP_Periodic_Handle(__IO uint64_t localtime);
+uint8_t LwIP_LoadAddress(ip_addr_t *ipaddr, ip_addr_t *netmask, ip_addr_t *gw);
+bool LwIP_SaveStaticAddress(const ip_addr_t *ipaddr, const ip_addr_t *netmask, const ip_addr_t *gw);
+bool LwIP_PinHost(const ip_addr_t *ipaddr);
+void LwIP_UnpinHost(const ip_addr_t *ipaddr);
+void LwIP_ResolvePinnedHosts(void);
+void LwIP_ReleasePinnedHosts(void);
+void LwIP_LinkDown(void);
+void LwIP_LinkUp(void);
+bool LwIP_IsLinkUp(void);
+void LwIP_NoteDataFlowing(void);
+void LwIP_GetLinkRecovery(uint32_t *downs, uint32_t *recovery);
+void LwIP_SetKeepalive(uint32_t idle, uint32_t interval, uint32_t count, uint32_t stall);
+void LwIP_GetKeepalive(uint32_t *idle, uint32_t *interval, uint32_t *count, uint32_t *stall);
+void LwIP_EnableKeepalive(struct tcp_pcb *pcb);
+bool LwIP_IsPeerStalled(const struct tcp_pcb *pcb, uint64_t *progress);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file private_mib.h
+ * @brief Declares the private MIB served by the lwIP SNMP agent.
+ *
+ * lwIP includes this file when SNMP_PRIVATE_MIB is set, to attach the node mib_private under private (.1.3.6.1.4)
+ * next to MIB-II. The node is supplied by the application, the Tekdaqc's is defined in Tekdaqc_Snmp.c. This file is
+ * included before the MIB node structures are defined, so it may only declare the node.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef PRIVATE_MIB_H_
+#define PRIVATE_MIB_H_
+
+/* Define to provide proper behavior with C++ compilers ----------------------*/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* EXPORTED VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief The root of the private MIB, private (.1.3.6.1.4).
+ */
+extern const struct mib_array_node mib_private;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PRIVATE_MIB_H_ */
@@ -1764,6 +1764,8 @@ typedef struct  {
   */ 
 void ETH_DeInit(void);
 uint32_t ETH_Init(ETH_InitTypeDef* ETH_InitStruct, uint16_t PHYAddress);
+uint32_t ETH_ResetPHY(uint16_t PHYAddress);
+uint32_t ETH_InitAfterPHYReset(ETH_InitTypeDef* ETH_InitStruct, uint16_t PHYAddress);
 void ETH_StructInit(ETH_InitTypeDef* ETH_InitStruct);
 void ETH_SoftwareReset(void);
 FlagStatus ETH_GetSoftwareResetStatus(void);
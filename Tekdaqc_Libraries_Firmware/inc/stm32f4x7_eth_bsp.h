@@ -51,10 +51,13 @@
 
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
-void  ETH_BSP_Config(void);
+void  ETH_BSP_Start(void);
+void  ETH_BSP_Complete(void);
 uint32_t Eth_Link_PHYITConfig(uint16_t PHYAddress);
 void Eth_Link_EXTIConfig(void);
+void Eth_Rx_ITConfig(void);
 void Eth_Link_ITHandler(uint16_t PHYAddress);
+void Eth_Link_Deferred(uint32_t argument);
 void ETH_link_callback(struct netif *netif);
 
 #ifdef __cplusplus
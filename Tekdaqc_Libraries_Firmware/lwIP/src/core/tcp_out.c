@@ -1256,6 +1256,7 @@ tcp_rexmit_rto(struct tcp_pcb *pcb)
 
   /* increment number of retransmissions */
   ++pcb->nrtx;
+  TCP_STATS_INC(tcp.rexmit);
 
   /* Don't take any RTT measurements after retransmitting. */
   pcb->rttest = 0;
@@ -1301,6 +1302,7 @@ tcp_rexmit(struct tcp_pcb *pcb)
 #endif /* TCP_OVERSIZE */
 
   ++pcb->nrtx;
+  TCP_STATS_INC(tcp.rexmit);
 
   /* Don't take any rtt measurements after retransmitting. */
   pcb->rttest = 0;
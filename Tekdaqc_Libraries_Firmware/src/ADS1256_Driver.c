@@ -81,52 +81,73 @@
 
 
 /*--------------------------------------------------------------------------------------------------------*/
-/* PRIVATE VARIABLES */
+/* PRIVATE TYPES */
 /*--------------------------------------------------------------------------------------------------------*/
 
-/* Device ID. */
-static uint8_t ID = (uint8_t) 0xFFU;
-
-/* TODO: These need to be updated every time they are written out to the ADC */
-/* Data Order. */
-static ADS1256_ORDER_t ORDER = ADS1256_MSB_FIRST;
-/* Auto-Calibration. */
-static ADS1256_ACAL_t ACAL = ADS1256_ACAL_DISABLED;
-/* Analog Buffer. */
-static ADS1256_BUFFER_t BUFFER = ADS1256_BUFFER_DISABLED;
-
-/* Analog inputs. */
-static ADS1256_AIN_t AIN_POS = ADS1256_AIN0;
-static ADS1256_AIN_t AIN_NEG = ADS1256_AIN1;
-
-/* ADC Clock out setting. */
-static ADS1256_CLOCK_OUT_t CLOCK_OUT = ADS1256_CLOCK_OUT_OFF;
-/* ADC Sensor detect current output. */
-static ADS1256_SENSOR_DETECT_t SENSOR_CURRENT = ADS1256_SD_OFF;
-/* Programmable gain amplifier setting. */
-static ADS1256_PGA_t PGA = ADS1256_PGAx1;
-
-/* Samples per second setting. */
-static ADS1256_SPS_t SPS = ADS1256_SPS_30000;
-
-/* GPIO Port Directions. */
-static ADS1256_GPIO_DIRECTION_t GPIO_DIRECTIONS[] = { ADS1256_GPIO_OUTPUT,
-		ADS1256_GPIO_INPUT, ADS1256_GPIO_INPUT, ADS1256_GPIO_INPUT };
-/* GPIO Port Status. */
-static ADS1256_GPIO_STATUS_t GPIO_STATUS[] = { ADS1256_GPIO_LOW,
-		ADS1256_GPIO_LOW, ADS1256_GPIO_LOW, ADS1256_GPIO_LOW };
+/**
+ * @internal
+ * @brief The driver state of one ADS1256, its local register copy and the settings to restore after a reset.
+ */
+typedef struct {
+	uint8_t id; /**< Device ID. */
+	/* TODO: These need to be updated every time they are written out to the ADC */
+	ADS1256_ORDER_t order; /**< Data Order. */
+	ADS1256_ACAL_t acal; /**< Auto-Calibration. */
+	ADS1256_BUFFER_t buffer; /**< Analog Buffer. */
+	ADS1256_AIN_t ain_pos; /**< Positive analog input. */
+	ADS1256_AIN_t ain_neg; /**< Negative analog input. */
+	ADS1256_CLOCK_OUT_t clock_out; /**< ADC Clock out setting. */
+	ADS1256_SENSOR_DETECT_t sensor_current; /**< ADC Sensor detect current output. */
+	ADS1256_PGA_t pga; /**< Programmable gain amplifier setting. */
+	ADS1256_SPS_t sps; /**< Samples per second setting. */
+	ADS1256_GPIO_DIRECTION_t gpio_directions[4]; /**< GPIO Port Directions. */
+	ADS1256_GPIO_STATUS_t gpio_status[4]; /**< GPIO Port Status. */
+	bool sync_use_command; /**< Flag to indicate if command or pin should be used for SYNC of ADC. */
+	uint32_t measurement; /**< The last retrieved measurement from the ADC. */
+	/* A local copy of all the ADC registers. Note that the indexing here only works because the addresses start at 0 and count up. */
+	uint8_t registers[ADS1256_NREGS];
+	bool always_read_reg; /**< Flag for if we should always read the register from the ADS1256 for most up to date values. */
+	bool drdy_pin_ready; /**< Flag indicating the DRDY pin has been configured, so polling never needs the STATUS register. */
+	uint8_t async_data[3]; /**< Receive buffer for asynchronous data reads. Must not live in CCM RAM as it is written by DMA. */
+	volatile ADS1256_MeasurementCallback async_callback; /**< The function to notify when the current asynchronous data read completes. */
+	volatile bool async_pending; /**< Flag indicating an asynchronous data read is in progress. */
+	volatile ADS1256_MeasurementCallback drdy_callback; /**< The function to notify of each conversion read by the DRDY interrupt. */
+	volatile ADS1256_LatchCallback latched_callback; /**< The function to notify as soon as each conversion is latched. */
+	volatile uint64_t drdy_time; /**< The local time at which DRDY last signaled a completed conversion. */
+	volatile bool continuous_requested; /**< Flag indicating the next data read should place the ADC in continuous read mode. */
+	volatile bool continuous_active; /**< Flag indicating the ADC is in continuous read mode and clocks out data without a command. */
+} ADS1256_Device_t;
 
-/* Flag to indicate if command or pin should be used for SYNC of ADC. */
-static bool SYNC_USE_COMMAND = false;
 
-/* The last retrieved measurement from the ADC. */
-static uint32_t ADS1256_Measurement = 0U;
 
-/* The last retrieved state of the ADC register. */
-static uint8_t ADS1256_Registers[11]; /* A local copy of all the ADC registers. Note that the indexing here only works because the addresses start at 0 and count up. */
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
 
-/* Flag for if we should always read the register from the ADS1256 for most up to date values. */
-static bool ADS1256_AlwaysReadReg = false;
+/* The settings each device is given by ADS1256_Init(). */
+static const ADS1256_Device_t ADS1256_DEVICE_DEFAULTS = {
+	.id = 0xFFU,
+	.order = ADS1256_MSB_FIRST,
+	.acal = ADS1256_ACAL_DISABLED,
+	.buffer = ADS1256_BUFFER_DISABLED,
+	.ain_pos = ADS1256_AIN0,
+	.ain_neg = ADS1256_AIN1,
+	.clock_out = ADS1256_CLOCK_OUT_OFF,
+	.sensor_current = ADS1256_SD_OFF,
+	.pga = ADS1256_PGAx1,
+	.sps = ADS1256_SPS_30000,
+	.gpio_directions = { ADS1256_GPIO_OUTPUT, ADS1256_GPIO_INPUT, ADS1256_GPIO_INPUT, ADS1256_GPIO_INPUT },
+	.gpio_status = { ADS1256_GPIO_LOW, ADS1256_GPIO_LOW, ADS1256_GPIO_LOW, ADS1256_GPIO_LOW }
+};
+
+/* The driver state of each ADS1256 on the board. Must not live in CCM RAM as the receive buffers are written by DMA. */
+static ADS1256_Device_t ADS1256_Devices[ADS1256_NUM_DEVICES];
+
+/* The device which the driver methods currently operate on. */
+static ADS1256_Device_t* Device = &ADS1256_Devices[0];
+
+/* The device whose asynchronous data read is in progress on the SPI bus. */
+static ADS1256_Device_t* volatile ADS1256_AsyncDevice = NULL;
 
 /* Scratch string used for various string print operations. */
 static char SCRATCH_STR[150];
@@ -143,6 +164,12 @@ static char SCRATCH_STR[150];
  */
 static inline const char* ADS1256_StringFromRegister(ADS1256_Register_t reg);
 
+/**
+ * @internal
+ * @brief Completion handler for asynchronous data reads.
+ */
+static void ADS1256_ReadDataComplete(uint8_t* data, uint8_t n);
+
 
 
 /*--------------------------------------------------------------------------------------------------------*/
@@ -195,6 +222,18 @@ static void ADS1256_SetRegister(ADS1256_Register_t reg, uint8_t value);
  */
 static void ADS1256_SetRegisters(ADS1256_Register_t reg, uint8_t count, uint8_t* values);
 
+/**
+ * @internal
+ * @brief Checks if the local copy of a register is known to match the remote register.
+ */
+static bool ADS1256_IsRegisterCached(ADS1256_Register_t reg);
+
+/**
+ * @internal
+ * @brief Writes the span of registers which differ from their target contents in a single burst.
+ */
+static void ADS1256_WriteChangedRegisters(uint8_t* target);
+
 /**
  * @internal
  * @brief Fetches a remote register and updates the local copy.
@@ -233,16 +272,20 @@ static void ADS1256_WriteRegisters(ADS1256_Register_t reg, uint8_t count);
  * Initializes the ADS1256 driver and establishes proper SPI serial communication with the device. A full
  * reset of the device which consists of a reset via clock sequence, followed by a reset of the SPI module.
  * Following this, all registers of the device are read and the ADC is left waiting in the SYNC state. All
- * peripherals of the STM32 involved are enabled and configured.
+ * peripherals of the STM32 involved are enabled and configured. Every device is given the default settings and
+ * the first is selected.
  *
  * @param none
  * @retval none
  */
 void ADS1256_Init(void) {
+	for (uint_fast8_t i = 0U; i < ADS1256_NUM_DEVICES; ++i) {
+		ADS1256_Devices[i] = ADS1256_DEVICE_DEFAULTS;
+	}
+	Device = &ADS1256_Devices[0];
 	ADS1256_SPI_Init(); /* Initialize the SPI lines */
 	ADS1256_StatePins_Init(); /* Initialize the control pins */
-	ADS1256_Full_Reset(); /* Perform a full reset on the ADC */
-	ADS1256_ReadRegisters(ADS1256_STATUS, ADS1256_NREGS); /* Read out all the registers */
+	ADS1256_Full_Reset(); /* Perform a full reset on the ADC, reading out all the registers */
 	ADS1256_Sync(true); /* SYNC the ADC so it isn't free running by sending the SPI command */
 #ifdef ADS1256_DEBUG
 	ADS1256_PrintRegs(); /* Print out the registers */
@@ -294,6 +337,55 @@ void ADS1256_StatePins_Init(void) {
 
 	/* Bring the RESET pin high */
 	GPIO_SetBits(ADS1256_RESET_GPIO_PORT, ADS1256_RESET_PIN);
+
+	/* Data ready polling can now use the DRDY pin */
+	Device->drdy_pin_ready = true;
+
+	/* Route the DRDY pin to its EXTI line. The line is left masked until acquisition is requested. */
+	EXTI_InitTypeDef EXTI_InitStructure;
+	NVIC_InitTypeDef NVIC_InitStructure;
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_SYSCFG, ENABLE);
+	SYSCFG_EXTILineConfig(ADS1256_DRDY_EXTI_PORT_SOURCE, ADS1256_DRDY_EXTI_PIN_SOURCE);
+	EXTI_InitStructure.EXTI_Line = ADS1256_DRDY_EXTI_LINE;
+	EXTI_InitStructure.EXTI_Mode = EXTI_Mode_Interrupt;
+	EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Falling;
+	EXTI_InitStructure.EXTI_LineCmd = ENABLE; /* The trigger edge is only selected for an enabled line */
+	EXTI_Init(&EXTI_InitStructure);
+	EXTI->IMR &= ~ADS1256_DRDY_EXTI_LINE;
+
+	NVIC_InitStructure.NVIC_IRQChannel = ADS1256_DRDY_EXTI_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = ADS1256_DRDY_PREEMPT_PRIORITY;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+}
+
+
+
+/**
+ * Selects the ADS1256 which the driver methods operate on. Each device keeps its own local register copy,
+ * settings and read state, so switching between devices does not require any register reads. A read which is
+ * in progress on the previous device still completes to that device.
+ *
+ * @param device uint8_t The index of the device, less than ADS1256_NUM_DEVICES.
+ * @retval bool TRUE if the device was selected, FALSE if the index is out of range.
+ */
+bool ADS1256_SelectDevice(uint8_t device) {
+	if (device >= ADS1256_NUM_DEVICES) {
+		return false;
+	}
+	Device = &ADS1256_Devices[device];
+	return true;
+}
+
+/**
+ * Retrieves the index of the ADS1256 which the driver methods currently operate on.
+ *
+ * @param none
+ * @retval uint8_t The index of the selected device.
+ */
+uint8_t ADS1256_GetSelectedDevice(void) {
+	return (uint8_t) (Device - ADS1256_Devices);
 }
 
 
@@ -323,7 +415,7 @@ static inline const char* ADS1256_StringFromRegister(ADS1256_Register_t reg) {
  */
 void ADS1256_PrintRegs(void) {
 	for (uint_fast8_t i = 0; i < ADS1256_NREGS; ++i) {
-		printf(ADS1256_REGISTERS_DEBUG_FORMATTER, i, ADS1256_StringFromRegister(i), ADS1256_Registers[i]);
+		printf(ADS1256_REGISTERS_DEBUG_FORMATTER, i, ADS1256_StringFromRegister(i), Device->registers[i]);
 	}
 }
 
@@ -343,7 +435,7 @@ void ADS1256_RegistersToString(void) {
 	uint8_t n = 0;
 	for (uint_fast8_t i = 0U; i < ADS1256_NREGS; ++i) { /* For each register */
 		/* Print the register string to the scratch string, with overflow safety. This will truncate the string if necessary. */
-		n = snprintf(SCRATCH_STR, sizeof(SCRATCH_STR), ADS1256_REGISTERS_DEBUG_FORMATTER, i, ADS1256_StringFromRegister(i), ADS1256_Registers[i]);
+		n = snprintf(SCRATCH_STR, sizeof(SCRATCH_STR), ADS1256_REGISTERS_DEBUG_FORMATTER, i, ADS1256_StringFromRegister(i), Device->registers[i]);
 		if (n > 0) { /* Writing was successful */
 			/* Append the scratch string to the output string */
 			strncat(TOSTRING_BUFFER, SCRATCH_STR, (SIZE_TOSTRING_BUFFER - strlen(TOSTRING_BUFFER) - 1U)); /* Reserve one for the terminating NULL */
@@ -432,6 +524,21 @@ const char* ADS1256_StringFromPGA(ADS1256_PGA_t pga) {
 	}
 }
 
+/**
+ * Returns a human readable string representation of the requested analog input channel.
+ *
+ * @param ain ADS1256_AIN_t The analog input channel.
+ * @retval const char* The string representation.
+ */
+const char* ADS1256_StringFromAIN(ADS1256_AIN_t ain) {
+	static const char* strings[] = { "AIN0", "AIN1", "AIN2", "AIN3", "AIN4", "AIN5", "AIN6", "AIN7", "AINCOM", "INVALID" };
+	if (IS_ADS1256_AIN_SETTING(ain)) {
+		return strings[ain];
+	} else {
+		return strings[9];
+	}
+}
+
 /**
  * Returns a human readable string of the requested buffer setting.
  *
@@ -557,6 +664,7 @@ void ADS1256_Full_Reset(void) {
 	ADS1256_Reset_By_Pin(); /* Reset the ADC */
 	ADS1256_Reset_SPI(); /* Reset the SPI line */
 	ADS1256_Sync(true); /* SYNC the ADC via SPI */
+	ADS1256_ReadRegisters(ADS1256_STATUS, ADS1256_NREGS); /* The registers are back to their defaults */
 }
 
 /**
@@ -568,7 +676,7 @@ void ADS1256_Full_Reset(void) {
  * @retval none
  */
 void ADS1256_Reset_By_Command(void) {
-	ID = 0xFFU; /* Reset the stored ID so we can properly identify the ADC after reset */
+	Device->id = 0xFFU; /* Reset the stored ID so we can properly identify the ADC after reset */
 	ADS1256_CS_LOW(); /* Enable SPI communication */
 	ADS1256_Send_Command(ADS1256_RESET); /* Send the reset command */
 	ADS1256_CS_HIGH(); /* Latch the SPI communication */
@@ -583,20 +691,20 @@ void ADS1256_Reset_By_Command(void) {
  * @retval none
  */
 void ADS1256_Reset_By_Clock(void) {
-	ID = 0xFFU; /* Reset the stored ID so we can properly identify the ADC after reset. */
+	Device->id = 0xFFU; /* Reset the stored ID so we can properly identify the ADC after reset. */
 	ADS1256_CLK_To_GPIO(); /* Change the clock line from SPI mode to GPIO mode */
 	ADS1256_SCLK_LOW(); /* Start the clock reset sequence. */
 	Delay_us(10U); /* Start low */
 	ADS1256_SCLK_HIGH(); /* First high pulse */
-	Delay_us((uint64_t) (300U * ADS1256_CLK_PERIOD_US)); /* Timing characteristic t12, tuned because of timing errors */
+	Delay_ns((uint32_t) (300U * ADS1256_CLK_PERIOD_NS)); /* Timing characteristic t12, tuned because of timing errors */
 	ADS1256_SCLK_LOW(); /* First low pulse */
-	Delay_us((uint64_t) (5U * ADS1256_CLK_PERIOD_US)); /* Timing characteristic t13 */
+	Delay_ns((uint32_t) (5U * ADS1256_CLK_PERIOD_NS)); /* Timing characteristic t13 */
 	ADS1256_SCLK_HIGH(); /* Second high pulse */
-	Delay_us((uint64_t) (550U * ADS1256_CLK_PERIOD_US)); /* Timing characteristic t14, tuned because of timing errors */
+	Delay_ns((uint32_t) (550U * ADS1256_CLK_PERIOD_NS)); /* Timing characteristic t14, tuned because of timing errors */
 	ADS1256_SCLK_LOW(); /* Second low pulse */
-	Delay_us((uint64_t) (5U * ADS1256_CLK_PERIOD_US)); /* Timing characteristic t13 */
+	Delay_ns((uint32_t) (5U * ADS1256_CLK_PERIOD_NS)); /* Timing characteristic t13 */
 	ADS1256_SCLK_HIGH(); /* Third high pulse */
-	Delay_us((uint64_t) (1050U * ADS1256_CLK_PERIOD_US)); /* Timing characteristic t15, tuned because of timing errors */
+	Delay_ns((uint32_t) (1050U * ADS1256_CLK_PERIOD_NS)); /* Timing characteristic t15, tuned because of timing errors */
 	ADS1256_SCLK_LOW(); /* End the clock reset sequence. */
 	ADS1256_GPIO_To_CLK(); /* Return the clock line to SPI mode. */
 }
@@ -612,7 +720,7 @@ void ADS1256_Reset_By_Clock(void) {
  */
 void ADS1256_Reset_By_Pin(void) {
 	GPIO_ResetBits(ADS1256_RESET_GPIO_PORT, ADS1256_RESET_PIN);
-	Delay_ms(0.0006f); /* Timing characteristic t16 */
+	Delay_ns(600U); /* Timing characteristic t16 */
 	GPIO_SetBits(ADS1256_RESET_GPIO_PORT, ADS1256_RESET_PIN);
 }
 
@@ -641,27 +749,26 @@ void ADS1256_Reset_SPI(void) {
  * @retval none
  */
 void ADS1256_ResetAndReprogram(void) {
-	ADS1256_Full_Reset(); /* Perform the full reset */
-	ADS1256_ReadRegisters(ADS1256_STATUS, ADS1256_NREGS); /* Read out al registers */
+	ADS1256_Full_Reset(); /* Perform the full reset, reading out all registers */
 
 	/* Set PGA and data rate first, then calibrate */
-	ADS1256_SetInputBufferSetting(BUFFER);
-	ADS1256_SetDataRate(SPS);
-	ADS1256_SetPGASetting(PGA);
+	ADS1256_SetInputBufferSetting(Device->buffer);
+	ADS1256_SetDataRate(Device->sps);
+	ADS1256_SetPGASetting(Device->pga);
 	ADS1256_CalibrateSelf();
 
 	/* Now set other stuff */
-	ADS1256_SetInputChannels(AIN_POS, AIN_NEG);
-	ADS1256_SetAutoCalSetting(ACAL);
-	ADS1256_SetDataOutputBitOrder(ORDER);
-	ADS1256_SetClockOutRate(CLOCK_OUT);
-	ADS1256_SetSensorDetectCurrent(SENSOR_CURRENT);
+	ADS1256_SetInputChannels(Device->ain_pos, Device->ain_neg);
+	ADS1256_SetAutoCalSetting(Device->acal);
+	ADS1256_SetDataOutputBitOrder(Device->order);
+	ADS1256_SetClockOutRate(Device->clock_out);
+	ADS1256_SetSensorDetectCurrent(Device->sensor_current);
 
 	/* GPIO Stuff */
 	for (uint_fast8_t i = 0U; i < 4U; ++i) {
-		ADS1256_SetGPIODirection(i, GPIO_DIRECTIONS[i]);
-		if (GPIO_DIRECTIONS[i] == ADS1256_GPIO_OUTPUT) {
-			ADS1256_SetGPIOStatus(i, GPIO_STATUS[i]);
+		ADS1256_SetGPIODirection(i, Device->gpio_directions[i]);
+		if (Device->gpio_directions[i] == ADS1256_GPIO_OUTPUT) {
+			ADS1256_SetGPIOStatus(i, Device->gpio_status[i]);
 		}
 	}
 }
@@ -687,10 +794,10 @@ int32_t ADS1256_GetMeasurement(void) {
 	ADS1256_Sync(true);
 
 	/*  Combine the 3 bytes into one unsigned int */
-	ADS1256_Measurement = raw_data[0] << 16U;
-	ADS1256_Measurement |= raw_data[1] << 8U;
-	ADS1256_Measurement |= raw_data[2];
-	return ADS1256_ConvertRawValue(ADS1256_Measurement);
+	Device->measurement = raw_data[0] << 16U;
+	Device->measurement |= raw_data[1] << 8U;
+	Device->measurement |= raw_data[2];
+	return ADS1256_ConvertRawValue(Device->measurement);
 }
 
 /**
@@ -712,10 +819,210 @@ void ADS1256_RequestMeasurement(void) {
 void ADS1256_ReadData(uint8_t* data) {
 	ADS1256_CS_LOW(); /* Enable SPI communication */
 	ADS1256_SendByte(ADS1256_RDATA); /* Send RDATA command byte */
-	Delay_us((uint64_t) (50U * ADS1256_CLK_PERIOD_US)); /*  timing characteristic t6 */
+	Delay_ns((uint32_t) (50U * ADS1256_CLK_PERIOD_NS)); /*  timing characteristic t6 */
 	ADS1256_ReceiveBytes(data, 3U);
 	ADS1256_CS_HIGH(); /* Latch SPI communication */
-	Delay_us((uint64_t) (4U * ADS1256_CLK_PERIOD_US)); /*  timing characteristic t11 */
+	Delay_ns((uint32_t) (4U * ADS1256_CLK_PERIOD_NS)); /*  timing characteristic t11 */
+}
+
+/**
+ * Begin reading the 3 raw data bytes from the ADC without blocking. The RDATA command is sent and the data
+ * bytes are then clocked in by the DMA engine. If continuous read has been requested, RDATAC is sent instead,
+ * and while the ADC remains in that mode all subsequent reads skip the command and t6 delay entirely. When the transfer completes, chip select is released and the
+ * provided callback is invoked from interrupt context with the converted value. Unlike ADS1256_GetMeasurement(),
+ * the ADC is not placed into SYNC afterwards; that decision is left to the caller.
+ *
+ * Note that the t11 delay following the transfer is not enforced here; callers must not issue a new command
+ * within 4 ADC clock periods of the callback.
+ *
+ * @param callback ADS1256_MeasurementCallback The function to notify with the result, may be NULL.
+ * @retval bool TRUE if the read was started, FALSE if the SPI bus is busy.
+ */
+bool ADS1256_BeginReadData(ADS1256_MeasurementCallback callback) {
+	if (Device->async_pending == true || ADS1256_SPI_IsBusy() == true) {
+		return false;
+	}
+	Device->async_pending = true;
+	Device->async_callback = callback;
+	ADS1256_AsyncDevice = Device;
+	ADS1256_CS_LOW(); /* Enable SPI communication */
+	if (Device->continuous_active == false) {
+		if (Device->continuous_requested == true) {
+			ADS1256_SendByte(ADS1256_RDATAC); /* Send RDATAC command byte, data follows as for RDATA */
+			Device->continuous_active = true;
+		} else {
+			ADS1256_SendByte(ADS1256_RDATA); /* Send RDATA command byte */
+		}
+		Delay_ns((uint32_t) (50U * ADS1256_CLK_PERIOD_NS)); /*  timing characteristic t6 */
+	}
+	if (ADS1256_TransferBytes_DMA(NULL, Device->async_data, 3U, &ADS1256_ReadDataComplete) == false) {
+		ADS1256_CS_HIGH();
+		Device->async_pending = false;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Checks if an asynchronous data read started with ADS1256_BeginReadData() is still in progress.
+ *
+ * @param none
+ * @retval bool TRUE if the read has not yet completed.
+ */
+bool ADS1256_IsReadPending(void) {
+	return Device->async_pending;
+}
+
+/**
+ * Enables the falling edge interrupt on the DRDY line. Each time a conversion completes, the data is read
+ * via DMA and the result delivered to the provided callback from interrupt context. While enabled, the SPI
+ * bus belongs to the interrupt; no other driver methods may be called until ADS1256_DisableDataReadyInterrupt()
+ * has returned.
+ *
+ * @param callback ADS1256_MeasurementCallback The function to notify with each result.
+ * @retval none
+ */
+void ADS1256_EnableDataReadyInterrupt(ADS1256_MeasurementCallback callback) {
+	Device->drdy_callback = callback;
+	EXTI_ClearITPendingBit(ADS1256_DRDY_EXTI_LINE); /* Discard any edge latched while masked */
+	EXTI->IMR |= ADS1256_DRDY_EXTI_LINE;
+}
+
+/**
+ * Sets the function the DRDY interrupt calls as soon as each conversion is latched in the output register, before
+ * the read of it is started. The analog inputs are no longer needed for that conversion by then, so the caller may
+ * start switching them while the data is read. It must not use the SPI bus.
+ *
+ * @param callback ADS1256_LatchCallback The function to notify, NULL for none.
+ * @retval none
+ */
+void ADS1256_SetDataLatchedCallback(ADS1256_LatchCallback callback) {
+	Device->latched_callback = callback;
+}
+
+/**
+ * Disables the DRDY interrupt and blocks until any read it started has completed, returning control of the
+ * SPI bus to the caller.
+ *
+ * @param none
+ * @retval none
+ */
+void ADS1256_DisableDataReadyInterrupt(void) {
+	ADS1256_MaskDataReadyInterrupt();
+	while (Device->async_pending == true) {
+		/* Wait for the DMA interrupt */
+	}
+	/* No other command is understood in continuous read mode */
+	ADS1256_StopContinuousRead();
+}
+
+/**
+ * Requests that reads started by the DRDY interrupt use continuous read (RDATAC) mode. The next read will issue
+ * RDATAC, after which each conversion is clocked out as soon as DRDY falls with no command overhead. This is
+ * only useful while the ADC is left free running on a single input. The request is cleared by
+ * ADS1256_DisableDataReadyInterrupt().
+ *
+ * @param enable bool TRUE to request continuous read mode.
+ * @retval none
+ */
+void ADS1256_SetContinuousRead(bool enable) {
+	Device->continuous_requested = enable;
+}
+
+/**
+ * Checks if the ADC is currently in continuous read (RDATAC) mode.
+ *
+ * @param none
+ * @retval bool TRUE if the ADC is in continuous read mode.
+ */
+bool ADS1256_IsContinuousRead(void) {
+	return Device->continuous_active;
+}
+
+/**
+ * Takes the ADC out of continuous read (RDATAC) mode by issuing SDATAC. The command must be issued while data is
+ * ready, so this blocks until the next conversion completes. The DRDY interrupt must be masked before calling.
+ * If the ADC is not in continuous read mode this only clears any pending request.
+ *
+ * @param none
+ * @retval none
+ */
+void ADS1256_StopContinuousRead(void) {
+	Device->continuous_requested = false;
+	if (Device->continuous_active == true) {
+		ADS1256_WaitUntilDataReady(false);
+		ADS1256_Send_Command(ADS1256_SDATAC); /* Send SDATAC command byte */
+		Delay_ns((uint32_t) (4U * ADS1256_CLK_PERIOD_NS)); /*  timing characteristic t11 */
+		Device->continuous_active = false;
+	}
+}
+
+/**
+ * Masks the DRDY interrupt so no further reads are started. A read which is already in progress will still
+ * complete and notify its callback. This method does not block and may be called from the callback itself.
+ *
+ * @param none
+ * @retval none
+ */
+void ADS1256_MaskDataReadyInterrupt(void) {
+	EXTI->IMR &= ~ADS1256_DRDY_EXTI_LINE;
+	EXTI_ClearITPendingBit(ADS1256_DRDY_EXTI_LINE);
+}
+
+/**
+ * Handles the DRDY external interrupt, starting a DMA read of the completed conversion. This must be called
+ * from the EXTI IRQ handler which services the DRDY line.
+ *
+ * @param none
+ * @retval none
+ */
+void ADS1256_DRDY_IRQHandler(void) {
+	if (EXTI_GetITStatus(ADS1256_DRDY_EXTI_LINE) != RESET) {
+		/* Record the conversion time before anything else so it carries only the interrupt latency */
+		Device->drdy_time = GetLocalTime();
+		EXTI_ClearITPendingBit(ADS1256_DRDY_EXTI_LINE);
+		const ADS1256_LatchCallback latched = Device->latched_callback;
+		if (latched != NULL) {
+			latched();
+		}
+		if (ADS1256_BeginReadData(Device->drdy_callback) == false) {
+#ifdef ADS1256_DEBUG
+			printf("[ADS1256] DRDY interrupt could not start a read, the SPI bus was busy.\n\r");
+#endif
+		}
+	}
+}
+
+/**
+ * Retrieves the local time at which the DRDY interrupt last signaled a completed conversion. From the
+ * measurement callback this is the completion time of the conversion being delivered.
+ *
+ * @param none
+ * @retval uint64_t The local time stamp in microseconds.
+ */
+uint64_t ADS1256_GetDataReadyTime(void) {
+	return Device->drdy_time;
+}
+
+/**
+ * @internal
+ * Called from the DMA interrupt when the 3 data bytes of an asynchronous read have been received.
+ *
+ * @param data uint8_t* The received data bytes.
+ * @param n uint8_t The number of received bytes.
+ * @retval none
+ */
+static void ADS1256_ReadDataComplete(uint8_t* data, uint8_t n) {
+	ADS1256_Device_t* device = ADS1256_AsyncDevice; /* The selection may have changed since the read started */
+	ADS1256_CS_HIGH(); /* Latch SPI communication */
+	device->measurement = data[0] << 16U;
+	device->measurement |= data[1] << 8U;
+	device->measurement |= data[2];
+	ADS1256_MeasurementCallback callback = device->async_callback;
+	device->async_pending = false;
+	if (callback != NULL) {
+		callback(ADS1256_ConvertRawValue(device->measurement));
+	}
 }
 
 /**
@@ -732,14 +1039,15 @@ void ADS1256_WaitUntilDataReady(bool useCommand) {
 }
 
 /**
- * Checks to see if the ADC has valid data ready for a read. Allows optional use of SPI command or DRDY pin.
+ * Checks to see if the ADC has valid data ready for a read. Allows optional use of SPI command or DRDY pin. The
+ * DRDY bit is the only live STATUS bit, so once the DRDY pin has been configured it is always used instead of
+ * reading the register over SPI.
  *
  * @param useCommand bool If true, indicates that the SPI command should be used rather than the DRDY line.
  * @retval bool True if valid data is ready, false if not.
  */
 bool ADS1256_IsDataReady(bool useCommand) {
-	/* TODO: This method should be smart enough to determine if the DRDY pin has been enabled and default to SPI if not. */
-	if (useCommand) { /* If we are using the SPI command */
+	if (useCommand && Device->drdy_pin_ready == false) { /* If we are using the SPI command */
 		ADS1256_ReadRegister(ADS1256_STATUS); /* Read the status register from the device */
 		uint8_t byte = ADS1256_GetRegisterBits(ADS1256_STATUS, ADS1256_DRDY_BIT, ADS1256_DRDY_SPAN); /* Retrieve the DRDY bit from the register */
 		bool ready = false; /* Assume data is not ready */
@@ -766,14 +1074,29 @@ bool ADS1256_IsDataReady(bool useCommand) {
  */
 void ADS1256_Sync(bool useCommand) {
 	/* TODO: This method should be smart enough to determine if the SYNC pin has been enabled and default to SPI if not. */
-	SYNC_USE_COMMAND = useCommand;
+	Device->sync_use_command = useCommand;
 	if (useCommand) {
 		ADS1256_Send_Command(ADS1256_SYNC); /* Send SYNC command byte */
 		/* TODO: Write SYNC pin high */
 	} else {
 		/* TODO: use sync pin */
 	}
-	Delay_us((uint64_t) (24U * ADS1256_CLK_PERIOD_US)); /* Timing characteristic t11 for SYNC */
+	Delay_ns((uint32_t) (24U * ADS1256_CLK_PERIOD_NS)); /* Timing characteristic t11 for SYNC */
+}
+
+/**
+ * Restarts the conversion from the SYNC pin by pulsing it low and back high. The new conversion starts on the rising
+ * edge, so the ADC is synchronized to the moment of the call without any SPI traffic or command latency. The pin is
+ * only held low for the minimum pulse width, far short of the 20 DRDY periods which would power the ADC down. The
+ * ADC must be converting, not held in SYNC by command, and the DRDY interrupt owns the bus from here on if enabled.
+ *
+ * @param none
+ * @retval none
+ */
+void ADS1256_SyncPulse(void) {
+	GPIO_ResetBits(ADS1256_SYNC_GPIO_PORT, ADS1256_SYNC_PIN);
+	Delay_ns((uint32_t) (4U * ADS1256_CLK_PERIOD_NS)); /* Minimum SYNC pulse width */
+	GPIO_SetBits(ADS1256_SYNC_GPIO_PORT, ADS1256_SYNC_PIN);
 }
 
 /**
@@ -784,9 +1107,9 @@ void ADS1256_Sync(bool useCommand) {
  * @retval none
  */
 void ADS1256_Wakeup() {
-	if (SYNC_USE_COMMAND == true) { /* If we should use SPI */
+	if (Device->sync_use_command == true) { /* If we should use SPI */
 		ADS1256_Send_Command(ADS1256_WAKEUP); /* Send WAKEUP command byte */
-		SYNC_USE_COMMAND = false;
+		Device->sync_use_command = false;
 	} else {
 		/* TODO: Handle this wakeup */
 	}
@@ -800,7 +1123,7 @@ void ADS1256_Wakeup() {
  */
 void ADS1256_Standby() {
 	ADS1256_Send_Command(ADS1256_STANDBY); /* Send the STANDBY command byte */
-	SYNC_USE_COMMAND = true;
+	Device->sync_use_command = true;
 }
 
 
@@ -809,6 +1132,29 @@ void ADS1256_Standby() {
 /* CALIBRATION METHODS */
 /*--------------------------------------------------------------------------------------------------------*/
 
+/**
+ * Starts a calibration of the ADC without waiting for it to complete. The ADC signals completion on the DRDY
+ * line, after which ADS1256_FinishCalibration() must be called. This allows the program loop to keep running
+ * during calibrations which can take up to a second at the slowest data rates.
+ *
+ * @param cmd ADS1256_Command_t The calibration command to send.
+ * @retval none
+ */
+void ADS1256_StartCalibration(ADS1256_Command_t cmd) {
+	ADS1256_Send_Command(cmd); /* Send the calibration command */
+}
+
+/**
+ * Completes a calibration started by ADS1256_StartCalibration() once the ADC has signaled it is finished.
+ *
+ * @param none
+ * @retval none
+ */
+void ADS1256_FinishCalibration(void) {
+	ADS1256_Sync(true); /* Enter the SYNC state */
+	ADS1256_ReadRegisters(ADS1256_OFC0, 6U); /* The calibration registers were updated by the ADC */
+}
+
 /**
  * Performs a complete self calibration of the ADC. This method blocks (except interrupts) until the calibration
  * is complete.
@@ -817,9 +1163,9 @@ void ADS1256_Standby() {
  * @retval none
  */
 void ADS1256_CalibrateSelf() {
-	ADS1256_Send_Command(ADS1256_SELFCAL); /* Send the self cal command */
+	ADS1256_StartCalibration(ADS1256_SELFCAL); /* Send the self cal command */
 	ADS1256_WaitUntilDataReady(false); /* Wait until the ADC signals it is finished */
-	ADS1256_Sync(true); /* Enter the SYNC state */
+	ADS1256_FinishCalibration();
 }
 
 /**
@@ -830,9 +1176,9 @@ void ADS1256_CalibrateSelf() {
  * @retval none
  */
 void ADS1256_CalibrateSelf_Gain() {
-	ADS1256_Send_Command(ADS1256_SELFGCAL); /* Send the self gain cal command */
+	ADS1256_StartCalibration(ADS1256_SELFGCAL); /* Send the self gain cal command */
 	ADS1256_WaitUntilDataReady(false); /* Wait until the ADC signals it is finished */
-	ADS1256_Sync(true); /* Enter the SYNC state */
+	ADS1256_FinishCalibration();
 }
 
 /**
@@ -843,9 +1189,9 @@ void ADS1256_CalibrateSelf_Gain() {
  * @retval none
  */
 void ADS1256_CalibrateSelf_Offset() {
-	ADS1256_Send_Command(ADS1256_SELFOCAL); /* Send the self offset cal command */
+	ADS1256_StartCalibration(ADS1256_SELFOCAL); /* Send the self offset cal command */
 	ADS1256_WaitUntilDataReady(false); /* Wait until the ADC signals it is finished */
-	ADS1256_Sync(true); /* Enter the SYNC state */
+	ADS1256_FinishCalibration();
 }
 
 /**
@@ -857,9 +1203,9 @@ void ADS1256_CalibrateSelf_Offset() {
  * @retval none
  */
 void ADS1256_CalibrateSystem_Gain() {
-	ADS1256_Send_Command(ADS1256_SYSGCAL); /* Send the system gain cal command */
+	ADS1256_StartCalibration(ADS1256_SYSGCAL); /* Send the system gain cal command */
 	ADS1256_WaitUntilDataReady(false); /* Wait until the ADC signals it is finished */
-	ADS1256_Sync(true); /* Enter the SYNC state */
+	ADS1256_FinishCalibration();
 }
 
 /**
@@ -870,9 +1216,9 @@ void ADS1256_CalibrateSystem_Gain() {
  * @retval none
  */
 void ADS1256_CalibrateSystem_Offset() {
-	ADS1256_Send_Command(ADS1256_SYSOCAL); /* Send the system offset cal command */
+	ADS1256_StartCalibration(ADS1256_SYSOCAL); /* Send the system offset cal command */
 	ADS1256_WaitUntilDataReady(false); /* Wait until the ADC signals it is finished */
-	ADS1256_Sync(true); /* Enter the SYNC state */
+	ADS1256_FinishCalibration();
 }
 
 
@@ -899,6 +1245,55 @@ int32_t ADS1256_ConvertRawValue(uint32_t value) {
 	return ((int32_t) value);
 }
 
+/**
+ * Converts a block of raw 24 bit 2's compliment ADC outputs, packed 3 bytes each least significant byte first, into
+ * native signed, 32 bit integers. Four outputs exactly fill three words, so the bulk of the block is loaded a word at
+ * a time and each output is sign extended with a single arithmetic shift rather than being assembled byte by byte.
+ *
+ * @param raw const uint8_t* The packed outputs. Need not be word aligned.
+ * @param values int32_t* The converted outputs. May not overlap raw.
+ * @param count uint32_t The number of outputs to convert.
+ * @retval none
+ */
+void ADS1256_ConvertRawBlock(const uint8_t* raw, int32_t* values, uint32_t count) {
+	uint32_t words[3];
+	for (; count >= 4U; count -= 4U) {
+		memcpy(words, raw, sizeof(words));
+		values[0] = ((int32_t) (words[0] << 8U)) >> 8;
+		values[1] = ((int32_t) ((words[0] >> 16U) | (words[1] << 16U))) >> 8;
+		values[2] = ((int32_t) ((words[1] >> 8U) | (words[2] << 24U))) >> 8;
+		values[3] = ((int32_t) words[2]) >> 8;
+		raw += sizeof(words);
+		values += 4U;
+	}
+	for (; count > 0U; --count) {
+		values[0] = ((int32_t) (((uint32_t) raw[0] << 8U) | ((uint32_t) raw[1] << 16U) | ((uint32_t) raw[2] << 24U))) >> 8;
+		raw += 3U;
+		++values;
+	}
+}
+
+/**
+ * Applies an offset and fixed point gain to a block of converted ADC outputs in place, so they can be expressed in
+ * engineering units. Each output becomes ((value - offset) * gain) / 2^shift, rounded to nearest and saturated to the
+ * range of an int32_t. The product is formed with the single cycle 32x32->64 multiply.
+ *
+ * @param values int32_t* The converted outputs to scale.
+ * @param count uint32_t The number of outputs.
+ * @param offset int32_t The output corresponding to zero (ADC Counts).
+ * @param gain int32_t The multiplier with shift fractional bits.
+ * @param shift uint8_t The number of fractional bits of gain, at most 62.
+ * @retval none
+ */
+void ADS1256_ScaleBlock(int32_t* values, uint32_t count, int32_t offset, int32_t gain, uint8_t shift) {
+	const int64_t rounding = (shift > 0U) ? (1LL << (shift - 1U)) : 0;
+	for (uint32_t i = 0U; i < count; ++i) {
+		/* Both operands are 24 bit readings, so the difference cannot overflow */
+		const int64_t scaled = (((int64_t) (values[i] - offset) * gain) + rounding) >> shift;
+		values[i] = (scaled > INT32_MAX) ? INT32_MAX : ((scaled < INT32_MIN) ? INT32_MIN : (int32_t) scaled);
+	}
+}
+
 /**
  * Retrieves the total self calibration time in milliseconds. See table 21.
  *
@@ -907,9 +1302,9 @@ int32_t ADS1256_ConvertRawValue(uint32_t value) {
  */
 float ADS1256_GetSelfCalTime() {
 	float retval = 0.892f;
-	switch (SPS) {
+	switch (Device->sps) {
 	case ADS1256_SPS_30000:
-		switch (PGA) {
+		switch (Device->pga) {
 		case ADS1256_PGAx1:
 		case ADS1256_PGAx2:
 			retval = 0.596f;
@@ -930,7 +1325,7 @@ float ADS1256_GetSelfCalTime() {
 		}
 		break;
 		case ADS1256_SPS_15000:
-			switch (PGA) {
+			switch (Device->pga) {
 			case ADS1256_PGAx1:
 			case ADS1256_PGAx2:
 			case ADS1256_PGAx4:
@@ -949,7 +1344,7 @@ float ADS1256_GetSelfCalTime() {
 			}
 			break;
 			case ADS1256_SPS_7500:
-				switch (PGA) {
+				switch (Device->pga) {
 				case ADS1256_PGAx1:
 				case ADS1256_PGAx2:
 				case ADS1256_PGAx4:
@@ -1018,7 +1413,7 @@ float ADS1256_GetSelfCalTime() {
  * @retval float The calibration time in milliseconds.
  */
 float ADS1256_GetOffsetCalTime() {
-	switch (SPS) {
+	switch (Device->sps) {
 	case ADS1256_SPS_30000:
 		return 0.387f;
 	case ADS1256_SPS_15000:
@@ -1063,9 +1458,9 @@ float ADS1256_GetOffsetCalTime() {
  * @retval float The calibration time in milliseconds.
  */
 float ADS1256_GetSelfGainCalTime() {
-	switch (SPS) {
+	switch (Device->sps) {
 	case ADS1256_SPS_30000:
-		switch (PGA) {
+		switch (Device->pga) {
 		case ADS1256_PGAx1:
 		case ADS1256_PGAx2:
 			return 0.417f;
@@ -1082,7 +1477,7 @@ float ADS1256_GetSelfGainCalTime() {
 		}
 		break;
 		case ADS1256_SPS_15000:
-			switch (PGA) {
+			switch (Device->pga) {
 			case ADS1256_PGAx1:
 			case ADS1256_PGAx2:
 			case ADS1256_PGAx4:
@@ -1097,7 +1492,7 @@ float ADS1256_GetSelfGainCalTime() {
 			}
 			break;
 			case ADS1256_SPS_7500:
-				switch (PGA) {
+				switch (Device->pga) {
 				case ADS1256_PGAx1:
 				case ADS1256_PGAx2:
 				case ADS1256_PGAx4:
@@ -1149,7 +1544,7 @@ float ADS1256_GetSelfGainCalTime() {
  * @retval float The calibration time in milliseconds.
  */
 float ADS1256_GetSystemGainCalTime() {
-	switch (SPS) {
+	switch (Device->sps) {
 	case ADS1256_SPS_30000:
 		return 0.417f;
 	case ADS1256_SPS_15000:
@@ -1195,7 +1590,18 @@ float ADS1256_GetSystemGainCalTime() {
  */
 float ADS1256_GetSettlingTime() {
 	ADS1256_GetDataRate(); /* Update the register if we need to */
-	switch (SPS) {
+	return ADS1256_GetSettlingTimeForRate(Device->sps);
+}
+
+/**
+ * Retrieves the settling time of the ADC at the provided data rate, without reading or changing the ADC's
+ * configuration. Determined by timing characteristics t18.
+ *
+ * @param rate ADS1256_SPS_t The data rate to look up.
+ * @retval float The settling time of the ADC in milliseconds.
+ */
+float ADS1256_GetSettlingTimeForRate(ADS1256_SPS_t rate) {
+	switch (rate) {
 	case ADS1256_SPS_30000:
 		return 0.21f;
 	case ADS1256_SPS_15000:
@@ -1230,7 +1636,7 @@ float ADS1256_GetSettlingTime() {
 		return 400.18f;
 	default:
 #ifdef ADS1256_DEBUG
-		printf("[ADS1256] Failed to look up settling time for 0x%02X!\n\r", SPS);
+		printf("[ADS1256] Failed to look up settling time for 0x%02X!\n\r", rate);
 #endif
 		return 0;
 	}
@@ -1243,7 +1649,7 @@ float ADS1256_GetSettlingTime() {
  * @retval none
  */
 void ADS1256_AlwayFetch(bool always) {
-	ADS1256_AlwaysReadReg = always;
+	Device->always_read_reg = always;
 }
 
 
@@ -1358,8 +1764,8 @@ void ADS1256_SetInputBufferSetting(ADS1256_BUFFER_t buffer) {
  */
 void ADS1256_GetInputChannels() {
 	uint8_t val = ADS1256_GetRegister(ADS1256_MUX);
-	AIN_NEG = val & 0x0F;
-	AIN_POS = val >> 4;
+	Device->ain_neg = val & 0x0F;
+	Device->ain_pos = val >> 4;
 }
 
 /**
@@ -1378,6 +1784,36 @@ void ADS1256_SetInputChannels(ADS1256_AIN_t pos, ADS1256_AIN_t neg) {
 	}
 }
 
+/**
+ * Sets the selected input channels and the state of some of the GPIO output pins together. The MUX and IO registers
+ * are sent in one burst, so pins which drive an external multiplexer switch it in the same SPI transaction which
+ * points the ADC at it. Registers which already hold their values are not sent, so switching only the pins costs a
+ * single register write.
+ *
+ * @param pos ADS1256_AIN_t The positive input channel.
+ * @param neg ADS1256_AIN_t The negative input channel.
+ * @param mask uint8_t The GPIO pins to set, bit 0 for GPIO0. They should be configured as outputs.
+ * @param status uint8_t The logic state of each of the pins in the mask, bit 0 for GPIO0.
+ * @retval none
+ */
+void ADS1256_SetInputChannelsAndGPIO(ADS1256_AIN_t pos, ADS1256_AIN_t neg, uint8_t mask, uint8_t status) {
+	assert_param(IS_ADS1256_AIN_SETTING(pos));
+	assert_param(IS_ADS1256_AIN_SETTING(neg));
+	mask &= 0x0FU;
+	uint8_t target[ADS1256_NREGS];
+	memcpy(target, Device->registers, sizeof(target));
+	target[ADS1256_MUX] = (uint8_t) ((pos << 4U) | neg);
+	target[ADS1256_IO] = (uint8_t) ((target[ADS1256_IO] & ~mask) | (status & mask));
+	ADS1256_WriteChangedRegisters(target);
+	Device->ain_pos = pos;
+	Device->ain_neg = neg;
+	for (uint_fast8_t i = 0U; i < 4U; ++i) {
+		if ((mask & (1U << i)) != 0U) {
+			Device->gpio_status[i] = ((status & (1U << i)) != 0U) ? ADS1256_GPIO_HIGH : ADS1256_GPIO_LOW;
+		}
+	}
+}
+
 
 
 /*--------------------------------------------------------------------------------------------------------*/
@@ -1393,7 +1829,7 @@ void ADS1256_SetInputChannels(ADS1256_AIN_t pos, ADS1256_AIN_t neg) {
 ADS1256_CLOCK_OUT_t ADS1256_GetClockOutRate() {
 	ADS1256_CLOCK_OUT_t clock = ADS1256_GetRegisterBits(ADS1256_ADCON, ADS1256_CO_BIT, ADS1256_CO_SPAN);
 	assert_param(IS_ADS1256_CLOCKOUT_SETTING(clock));
-	CLOCK_OUT = clock;
+	Device->clock_out = clock;
 #ifdef ADS1256_DEBUG
 	printf("[ADS1256] Clock out rate: 0x%02X\n\r", clock);
 #endif
@@ -1410,7 +1846,7 @@ ADS1256_SENSOR_DETECT_t ADS1256_GetSensorDetectCurrent() {
 	ADS1256_SENSOR_DETECT_t current = ADS1256_GetRegisterBits(ADS1256_ADCON,
 			ADS1256_SD_BIT, ADS1256_SD_SPAN);
 	assert_param(IS_ADS1256_SENSOR_DETECT_SETTING(current));
-	SENSOR_CURRENT = current;
+	Device->sensor_current = current;
 #ifdef ADS1256_DEBUG
 	printf("[ADS1256] Sensor detect current: 0x%02X\n\r", current);
 #endif
@@ -1426,7 +1862,7 @@ ADS1256_SENSOR_DETECT_t ADS1256_GetSensorDetectCurrent() {
 ADS1256_PGA_t ADS1256_GetPGASetting() {
 	ADS1256_PGA_t setting = ADS1256_GetRegisterBits(ADS1256_ADCON, ADS1256_PGA_BIT, ADS1256_PGA_SPAN);
 	assert_param(IS_ADS1256_PGA_SETTING(setting));
-	PGA = setting;
+	Device->pga = setting;
 #ifdef ADS1256_DEBUG
 	printf("[ADS1256] PGA Setting: 0x%02X\n\r", setting);
 #endif
@@ -1442,7 +1878,7 @@ ADS1256_PGA_t ADS1256_GetPGASetting() {
 void ADS1256_SetClockOutRate(ADS1256_CLOCK_OUT_t clock) {
 	assert_param(IS_ADS1256_CLOCKOUT_SETTING(clock));
 	ADS1256_SetRegisterBits(ADS1256_ADCON, ADS1256_CO_BIT, ADS1256_CO_SPAN, clock);
-	CLOCK_OUT = clock;
+	Device->clock_out = clock;
 }
 
 /**
@@ -1453,7 +1889,7 @@ void ADS1256_SetClockOutRate(ADS1256_CLOCK_OUT_t clock) {
 void ADS1256_SetSensorDetectCurrent(ADS1256_SENSOR_DETECT_t current) {
 	assert_param(IS_ADS1256_SENSOR_DETECT_SETTING(current));
 	ADS1256_SetRegisterBits(ADS1256_ADCON, ADS1256_SD_BIT, ADS1256_SD_SPAN, current);
-	SENSOR_CURRENT = current;
+	Device->sensor_current = current;
 }
 
 /**
@@ -1466,7 +1902,7 @@ void ADS1256_SetPGASetting(ADS1256_PGA_t gain) {
 	/* Check the parameters */
 	assert_param(IS_ADS1256_PGA_SETTING(gain));
 	ADS1256_SetRegisterBits(ADS1256_ADCON, ADS1256_PGA_BIT, ADS1256_PGA_SPAN, gain);
-	PGA = gain;
+	Device->pga = gain;
 }
 
 /**
@@ -1520,12 +1956,12 @@ int32_t ADS1256_GetGainMultiplier(ADS1256_PGA_t gain) {
 ADS1256_SPS_t ADS1256_GetDataRate() {
 	ADS1256_SPS_t setting = ADS1256_GetRegister(ADS1256_DRATE);
 	if (setting) {
-		SPS = setting;
+		Device->sps = setting;
 	}
 #ifdef ADS1256_DEBUG
 	printf("[ADS1256] Data rate: 0x%02X\n\r", setting);
 #endif
-	return SPS;
+	return Device->sps;
 }
 
 /**
@@ -1537,7 +1973,7 @@ ADS1256_SPS_t ADS1256_GetDataRate() {
 void ADS1256_SetDataRate(ADS1256_SPS_t sps) {
 	/* Check the parameters */
 	ADS1256_SetRegister(ADS1256_DRATE, sps);
-	SPS = sps;
+	Device->sps = sps;
 }
 
 
@@ -1554,7 +1990,7 @@ void ADS1256_SetDataRate(ADS1256_SPS_t sps) {
  */
 ADS1256_GPIO_DIRECTION_t ADS1256_GetGPIODirection(ADS1256_GPIO_t pin) {
 	ADS1256_GPIO_DIRECTION_t dir = ADS1256_GetRegisterBits(ADS1256_IO, pin + ADS1256_GPIO_DIR_OFFSET, ADS1256_GPIO_BIT_SPAN);
-	GPIO_DIRECTIONS[pin] = dir;
+	Device->gpio_directions[pin] = dir;
 	return dir;
 }
 
@@ -1567,7 +2003,7 @@ ADS1256_GPIO_DIRECTION_t ADS1256_GetGPIODirection(ADS1256_GPIO_t pin) {
 ADS1256_GPIO_STATUS_t ADS1256_GetGPIOStatus(ADS1256_GPIO_t pin) {
 	ADS1256_GPIO_STATUS_t status = ADS1256_GetRegisterBits(ADS1256_IO, pin, ADS1256_GPIO_BIT_SPAN);
 	assert_param(IS_ADS1256_GPIO_VALUE(status));
-	GPIO_STATUS[pin] = status;
+	Device->gpio_status[pin] = status;
 	return status;
 }
 
@@ -1580,7 +2016,7 @@ ADS1256_GPIO_STATUS_t ADS1256_GetGPIOStatus(ADS1256_GPIO_t pin) {
  */
 void ADS1256_SetGPIODirection(ADS1256_GPIO_t pin, ADS1256_GPIO_DIRECTION_t direction) {
 	ADS1256_SetRegisterBits(ADS1256_IO, pin + ADS1256_GPIO_DIR_OFFSET,ADS1256_GPIO_BIT_SPAN, direction);
-	GPIO_DIRECTIONS[pin] = direction;
+	Device->gpio_directions[pin] = direction;
 }
 
 /**
@@ -1594,7 +2030,7 @@ void ADS1256_SetGPIODirection(ADS1256_GPIO_t pin, ADS1256_GPIO_DIRECTION_t direc
 void ADS1256_SetGPIOStatus(ADS1256_GPIO_t pin, ADS1256_GPIO_STATUS_t status) {
 	assert_param(IS_ADS1256_GPIO_VALUE(status));
 	ADS1256_SetRegisterBits(ADS1256_IO, pin, ADS1256_GPIO_BIT_SPAN, status);
-	GPIO_STATUS[pin] = status;
+	Device->gpio_status[pin] = status;
 }
 
 
@@ -1672,6 +2108,69 @@ void ADS1256_SetGainCalSetting(uint8_t* value) {
 
 
 
+/*--------------------------------------------------------------------------------------------------------*/
+/* REGISTER IMAGE METHODS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Builds the register image for the provided conversion settings. The calibration values are zeroed and should
+ * be set with ADS1256_SetRegisterImageCalibration().
+ *
+ * @param image ADS1256_RegisterImage_t* The image to build.
+ * @param buffer ADS1256_BUFFER_t The input buffer setting.
+ * @param gain ADS1256_PGA_t The PGA gain setting.
+ * @param rate ADS1256_SPS_t The data rate setting.
+ * @retval none
+ */
+void ADS1256_BuildRegisterImage(ADS1256_RegisterImage_t* image, ADS1256_BUFFER_t buffer, ADS1256_PGA_t gain, ADS1256_SPS_t rate) {
+	assert_param(IS_ADS1256_PGA_SETTING(gain));
+	image->status = (uint8_t) (buffer << ADS1256_BUFFEN_BIT);
+	image->adcon = (uint8_t) (gain << ADS1256_PGA_BIT);
+	image->drate = (uint8_t) rate;
+	ADS1256_SetRegisterImageCalibration(image, 0U, 0U);
+}
+
+/**
+ * Sets the calibration values of a register image.
+ *
+ * @param image ADS1256_RegisterImage_t* The image to update.
+ * @param offset uint32_t The offset calibration value, exactly as it is stored by the ADC.
+ * @param gain uint32_t The gain calibration value, exactly as it is stored by the ADC.
+ * @retval none
+ */
+void ADS1256_SetRegisterImageCalibration(ADS1256_RegisterImage_t* image, uint32_t offset, uint32_t gain) {
+	for (uint_fast8_t i = 0U; i < 3U; ++i) {
+		image->offset[i] = (uint8_t) (offset >> (8U * i));
+		image->gain[i] = (uint8_t) (gain >> (8U * i));
+	}
+}
+
+/**
+ * Loads a register image into the ADC. The image is merged with the local registers and the span from the first
+ * to the last register which differ is sent in a single write, so loading the settings already in place costs
+ * no SPI traffic at all.
+ *
+ * @param image const ADS1256_RegisterImage_t* The image to load.
+ * @retval none
+ */
+void ADS1256_LoadRegisterImage(const ADS1256_RegisterImage_t* image) {
+	static const uint8_t BUFFEN_MASK = (uint8_t) (((1U << ADS1256_BUFFEN_SPAN) - 1U) << ADS1256_BUFFEN_BIT);
+	static const uint8_t PGA_MASK = (uint8_t) (((1U << ADS1256_PGA_SPAN) - 1U) << ADS1256_PGA_BIT);
+	uint8_t target[ADS1256_NREGS];
+	memcpy(target, Device->registers, sizeof(target));
+	target[ADS1256_STATUS] = (uint8_t) ((target[ADS1256_STATUS] & ~BUFFEN_MASK) | image->status);
+	target[ADS1256_ADCON] = (uint8_t) ((target[ADS1256_ADCON] & ~PGA_MASK) | image->adcon);
+	target[ADS1256_DRATE] = image->drate;
+	memcpy(&target[ADS1256_OFC0], image->offset, sizeof(image->offset));
+	memcpy(&target[ADS1256_FSC0], image->gain, sizeof(image->gain));
+	ADS1256_WriteChangedRegisters(target);
+	Device->buffer = (ADS1256_BUFFER_t) ((image->status & BUFFEN_MASK) >> ADS1256_BUFFEN_BIT);
+	Device->pga = (ADS1256_PGA_t) ((image->adcon & PGA_MASK) >> ADS1256_PGA_BIT);
+	Device->sps = (ADS1256_SPS_t) image->drate;
+}
+
+
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* COMMAND METHODS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -1744,22 +2243,23 @@ static void ADS1256_SetRegisterBits(ADS1256_Register_t reg, uint8_t index, uint8
 	if (ADS1256_GetRegisterBits(reg, index, count) == value) {
 		return;
 	}
-	uint8_t mask = (uint8_t)((0xFFU >> count) << index); /* Create the mask, all 1's shifted left by the starting bit index */
-	byte = (byte & (~mask)) | (value << index);
+	uint8_t mask = (uint8_t)((0xFFU >> (8U - count)) << index); /* Create the mask, count 1's shifted left by the starting bit index */
+	byte = (byte & (~mask)) | ((value << index) & mask);
 	ADS1256_SetRegister(reg, byte);
 }
 
 /**
- * Retrieve the local copy of a register.
+ * Retrieve the local copy of a register. The remote register is only read if auto-fetch is enabled or the ADC may
+ * have changed it since it was last read.
  *
  * @param reg ADS1256_Register_t The register to retrieve.
  * @retval uint8_t The retrieved register value.
  */
 static uint8_t ADS1256_GetRegister(ADS1256_Register_t reg) {
-	if (ADS1256_AlwaysReadReg) {
+	if (Device->always_read_reg || !ADS1256_IsRegisterCached(reg)) {
 		ADS1256_ReadRegister(reg);
 	}
-	return ADS1256_Registers[reg];
+	return Device->registers[reg];
 }
 
 /**
@@ -1774,7 +2274,8 @@ static void ADS1256_SetRegister(ADS1256_Register_t reg, uint8_t value) {
 }
 
 /**
- * Set the contents of multiple registers, both local and remote.
+ * Set the contents of multiple registers, both local and remote. The local copy is written through to the ADC, but
+ * only the span from the first to the last register which actually changes is sent. Nothing is sent if none change.
  *
  * @param reg ADS1256_Register_t The register to start the writing at.
  * @param count uint8_t The number of registers to write.
@@ -1782,10 +2283,50 @@ static void ADS1256_SetRegister(ADS1256_Register_t reg, uint8_t value) {
  * @retval none
  */
 static void ADS1256_SetRegisters(ADS1256_Register_t reg, uint8_t count, uint8_t* values) {
+	uint_fast8_t first = count;
+	uint_fast8_t last = 0U;
 	for (uint_fast8_t i = 0; i < count; ++i) {
-		ADS1256_Registers[reg + i] = values[i];
+		if (values[i] != Device->registers[reg + i] || !ADS1256_IsRegisterCached((ADS1256_Register_t) (reg + i))) {
+			if (first == count) {
+				first = i;
+			}
+			last = i;
+		}
+		Device->registers[reg + i] = values[i];
 	}
-	ADS1256_WriteRegisters(reg, count);
+	if (first == count) {
+		return; /* Already loaded */
+	}
+	ADS1256_WriteRegisters((ADS1256_Register_t) (reg + first), (uint8_t) (last - first + 1U));
+#ifdef ADS1256_DEBUG
+	printf("[ADS1256] Wrote %i registers from %s.\n\r", (int) (last - first + 1U), ADS1256_StringFromRegister(reg + first));
+#endif
+}
+
+/**
+ * Checks if the local copy of a register is known to match the remote register. With auto-calibration enabled the
+ * ADC rewrites the calibration registers itself whenever the gain, data rate or buffer change, so they are never
+ * taken from the local copy.
+ *
+ * @param reg ADS1256_Register_t The register to check.
+ * @retval bool TRUE if the local copy can be used without reading the ADC.
+ */
+static bool ADS1256_IsRegisterCached(ADS1256_Register_t reg) {
+	if (reg < ADS1256_OFC0) {
+		return true;
+	}
+	return ((Device->registers[ADS1256_STATUS] >> ADS1256_ACAL_BIT) & 0x01U) == (uint8_t) ADS1256_ACAL_DISABLED;
+}
+
+/**
+ * Writes a full set of target register contents, sending only the span from the first to the last register which
+ * differs from the local copy, in a single burst. Nothing is sent if none differ.
+ *
+ * @param target uint8_t* The target contents of all ADS1256_NREGS registers.
+ * @retval none
+ */
+static void ADS1256_WriteChangedRegisters(uint8_t* target) {
+	ADS1256_SetRegisters(ADS1256_STATUS, ADS1256_NREGS, target);
 }
 
 /**
@@ -1808,23 +2349,23 @@ static void ADS1256_ReadRegister(ADS1256_Register_t reg) {
 static void ADS1256_ReadRegisters(ADS1256_Register_t reg, uint8_t count) {
 	ADS1256_CS_LOW();
 	ADS1256_Reg_Command(ADS1256_RREG, reg, count);
-	Delay_us(50 * ADS1256_CLK_PERIOD_US); /* timing characteristic t6 */
-	ADS1256_ReceiveBytes(ADS1256_Registers + reg, count);
+	Delay_ns((uint32_t) (50U * ADS1256_CLK_PERIOD_NS)); /* timing characteristic t6 */
+	ADS1256_ReceiveBytes(Device->registers + reg, count);
 	ADS1256_CS_HIGH();
-	Delay_us(4 * ADS1256_CLK_PERIOD_US); /* timing characteristic t11 */
+	Delay_ns((uint32_t) (4U * ADS1256_CLK_PERIOD_NS)); /* timing characteristic t11 */
 	if (reg == ADS1256_STATUS) {
 		/* We just read the status register, lets make sure things match up */
-		if (ID == 0xFF) {
+		if (Device->id == 0xFF) {
 			/* This is the first read */
-			ID = ADS1256_GetRegisterBits(ADS1256_STATUS, ADS1256_ID_BIT, ADS1256_ID_SPAN);
+			Device->id = ADS1256_GetRegisterBits(ADS1256_STATUS, ADS1256_ID_BIT, ADS1256_ID_SPAN);
 #ifdef ADS1256_DEBUG
-			printf("[ADS1256] Setting ADC ID: 0x%02X\n\r", ID);
+			printf("[ADS1256] Setting ADC ID: 0x%02X\n\r", Device->id);
 #endif
 		} else {
 			/* This is a subsequent read */
 			uint8_t tempID = ADS1256_GetRegisterBits(ADS1256_STATUS,
 					ADS1256_ID_BIT, ADS1256_ID_SPAN);
-			if (tempID != ID) {
+			if (tempID != Device->id) {
 				/* There was a problem, reset the ADC */
 #ifdef ADS1256_DEBUG
 				printf("[ADS1256] The ADC did not return the same ID, resetting and reprogramming it.\n\r");
@@ -1855,10 +2396,10 @@ static void ADS1256_WriteRegister(ADS1256_Register_t reg) {
 static void ADS1256_WriteRegisters(ADS1256_Register_t reg, uint8_t count) {
 	ADS1256_CS_LOW();
 	ADS1256_Reg_Command(ADS1256_WREG, reg, count);
-	Delay_us(50 * ADS1256_CLK_PERIOD_US); /* timing characteristic t6 */
-	ADS1256_SendBytes(ADS1256_Registers + reg, count);
+	Delay_ns((uint32_t) (50U * ADS1256_CLK_PERIOD_NS)); /* timing characteristic t6 */
+	ADS1256_SendBytes(Device->registers + reg, count);
 	ADS1256_CS_HIGH();
-	Delay_us(4 * ADS1256_CLK_PERIOD_US); /* timing characteristic t11 */
+	Delay_ns((uint32_t) (4U * ADS1256_CLK_PERIOD_NS)); /* timing characteristic t11 */
 }
 
 /**
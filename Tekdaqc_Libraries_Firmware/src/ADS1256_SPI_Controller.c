@@ -30,6 +30,7 @@
 #include "ADS1256_SPI_Controller.h"
 #include "ADS1256_Driver.h"
 #include "Tekdaqc_Config.h"
+#include <stddef.h>
 
 #ifdef PRINTF_OUTPUT
 #include <stdio.h>
@@ -39,6 +40,28 @@
 /* PRIVATE DEFINES */
 /*--------------------------------------------------------------------------------------------------------*/
 
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* Flag indicating that a DMA transfer is in progress. */
+static volatile bool DMA_Busy = false;
+
+/* The function to call when the current DMA transfer completes. */
+static volatile ADS1256_SPI_TransferCallback DMA_Callback = NULL;
+
+/* The receive buffer of the current DMA transfer. */
+static uint8_t* volatile DMA_RxBuffer = NULL;
+
+/* The byte count of the current DMA transfer. */
+static volatile uint8_t DMA_Count = 0U;
+
+/* Source byte used for transmitting when no transmit buffer is provided. */
+static uint8_t DMA_TxDummy = ADS1256_DUMMY_BYTE;
+
+/* Destination byte used for receiving when no receive buffer is provided. */
+static uint8_t DMA_RxDiscard = 0U;
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE FUNCTION PROTOTYPES */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -53,6 +76,21 @@ static void ADS1256_LowLevel_Init(void);
  */
 static void ADS1256_LowLevel_DeInit(void);
 
+/**
+ * @brief Perform the low level initialization of the DMA streams used by the SPI peripheral.
+ */
+static void ADS1256_DMA_Init(void);
+
+/**
+ * @brief Load a DMA stream with a memory address and count.
+ */
+static void ADS1256_DMA_LoadStream(DMA_Stream_TypeDef* stream, uint8_t* buffer, uint8_t n);
+
+/**
+ * @brief Select the smallest SPI prescaler which keeps the bus within the ADS1256 clock limit.
+ */
+static uint16_t ADS1256_SPI_FastestPrescaler(void);
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE FUNCTIONS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -137,6 +175,98 @@ static void ADS1256_LowLevel_DeInit(void) {
   GPIO_Init(ADS1256_CS_GPIO_PORT, &GPIO_InitStructure);
 }
 
+/**
+  * @brief  Initializes the DMA streams used by the SPI driver. The streams are left disabled and are
+  * reloaded for each transfer.
+  * @param  None
+  * @retval None
+  */
+static void ADS1256_DMA_Init(void) {
+  DMA_InitTypeDef DMA_InitStructure;
+  NVIC_InitTypeDef NVIC_InitStructure;
+
+  /* Enable the DMA clock */
+  RCC_AHB1PeriphClockCmd(ADS1256_SPI_DMA_CLK, ENABLE);
+
+  DMA_DeInit(ADS1256_SPI_DMA_RX_STREAM);
+  DMA_DeInit(ADS1256_SPI_DMA_TX_STREAM);
+
+  DMA_InitStructure.DMA_Channel = ADS1256_SPI_DMA_CHANNEL;
+  DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t) &(ADS1256_SPI->DR);
+  DMA_InitStructure.DMA_BufferSize = 1U;
+  DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+  DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+  DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+  DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+  DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+  DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+  DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+  DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+  DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+  DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+
+  /* SPI RX stream configuration */
+  DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
+  DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t) &DMA_RxDiscard;
+  DMA_Init(ADS1256_SPI_DMA_RX_STREAM, &DMA_InitStructure);
+
+  /* SPI TX stream configuration */
+  DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+  DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t) &DMA_TxDummy;
+  DMA_Init(ADS1256_SPI_DMA_TX_STREAM, &DMA_InitStructure);
+
+  /* Completion is signaled by the RX stream, since the last byte has been clocked in when it finishes */
+  DMA_ITConfig(ADS1256_SPI_DMA_RX_STREAM, DMA_IT_TC, ENABLE);
+
+  NVIC_InitStructure.NVIC_IRQChannel = ADS1256_SPI_DMA_RX_IRQn;
+  NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = ADS1256_SPI_DMA_PREEMPT_PRIORITY;
+  NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+  NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+  NVIC_Init(&NVIC_InitStructure);
+
+  DMA_Busy = false;
+}
+
+/**
+  * @brief  Loads a (disabled) DMA stream with the memory address and transfer count for the next transfer.
+  * If no buffer is provided, the stream is pointed at a single dummy byte and memory increment is disabled.
+  * @param  stream DMA_Stream_TypeDef* The stream to load.
+  * @param  buffer uint8_t* The memory buffer for the transfer, or NULL to use the dummy byte.
+  * @param  n uint8_t The number of bytes to transfer.
+  * @retval None
+  */
+static void ADS1256_DMA_LoadStream(DMA_Stream_TypeDef* stream, uint8_t* buffer, uint8_t n) {
+  if (buffer == NULL) {
+    stream->CR &= ~DMA_SxCR_MINC;
+    stream->M0AR = (stream == ADS1256_SPI_DMA_TX_STREAM) ? (uint32_t) &DMA_TxDummy : (uint32_t) &DMA_RxDiscard;
+  } else {
+    stream->CR |= DMA_SxCR_MINC;
+    stream->M0AR = (uint32_t) buffer;
+  }
+  stream->NDTR = n;
+}
+
+/**
+  * @brief  Selects the smallest SPI baud rate prescaler whose clock does not exceed ADS1256_SPI_MAX_SCLK_HZ, so
+  * the bus runs as fast as the ADC allows for the current peripheral clock. The ADS1256 SPI is on APB1.
+  * @param  None
+  * @retval uint16_t The SPI_BaudRatePrescaler_x value.
+  */
+static uint16_t ADS1256_SPI_FastestPrescaler(void) {
+  RCC_ClocksTypeDef clocks;
+  RCC_GetClocksFreq(&clocks);
+  uint16_t prescaler = SPI_BaudRatePrescaler_2;
+  uint32_t sclk = clocks.PCLK1_Frequency / 2U;
+  while ((sclk > ADS1256_SPI_MAX_SCLK_HZ) && (prescaler != SPI_BaudRatePrescaler_256)) {
+    prescaler += SPI_BaudRatePrescaler_4 - SPI_BaudRatePrescaler_2; /* Each step halves the clock */
+    sclk /= 2U;
+  }
+#ifdef ADS1256_SPI_DEBUG
+  printf("[ADS1256] SPI clock set to %lu Hz.\n\r", (unsigned long) sclk);
+#endif
+  return prescaler;
+}
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* INITIALIZATION METHODS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -164,12 +294,15 @@ void ADS1256_SPI_Init(void) {
   SPI_InitStructure.SPI_CPOL = SPI_CPOL_Low;
   SPI_InitStructure.SPI_CPHA = SPI_CPHA_2Edge;
   SPI_InitStructure.SPI_NSS = SPI_NSS_Soft;
-  SPI_InitStructure.SPI_BaudRatePrescaler = SPI_BaudRatePrescaler_8;
+  SPI_InitStructure.SPI_BaudRatePrescaler = ADS1256_SPI_FastestPrescaler();
   SPI_InitStructure.SPI_FirstBit = SPI_FirstBit_MSB;
   SPI_InitStructure.SPI_CRCPolynomial = 7;
   
   SPI_Init(ADS1256_SPI, &SPI_InitStructure);
 
+  /* Prepare the DMA streams for bulk transfers */
+  ADS1256_DMA_Init();
+
   /* Enable the ADC1256 SPI  */
   SPI_Cmd(ADS1256_SPI, ENABLE);
 }
@@ -184,6 +317,10 @@ void ADS1256_SPI_DeInit(void) {
 #ifdef ADS1256_SPI_DEBUG
   printf("[ADS1256] Deinitializing peripherals for the ADS1256.\n\r");
 #endif
+  ADS1256_SPI_WaitForTransfer();
+  NVIC_DisableIRQ(ADS1256_SPI_DMA_RX_IRQn);
+  DMA_DeInit(ADS1256_SPI_DMA_RX_STREAM);
+  DMA_DeInit(ADS1256_SPI_DMA_TX_STREAM);
   ADS1256_LowLevel_DeInit();
 }
 
@@ -256,17 +393,18 @@ uint8_t ADS1256_SendByte(uint8_t data) {
 #ifdef ADS1256_SPI_DEBUG
   printf("[ADS1256] Sending byte: 0x%02X\n\r", data);
 #endif
+  /* The registers are used directly, the peripheral library would take this RAM function back into FLASH */
   /* Send byte through the SPI peripheral */
-  SPI_I2S_SendData(ADS1256_SPI, data);
+  ADS1256_SPI->DR = data;
   
   /* Loop while DR register in not empty */
-  while (SPI_I2S_GetFlagStatus(ADS1256_SPI, SPI_I2S_FLAG_TXE) == RESET);
+  while ((ADS1256_SPI->SR & SPI_I2S_FLAG_TXE) == 0U);
 
   /* Wait to receive a byte */
-  while (SPI_I2S_GetFlagStatus(ADS1256_SPI, SPI_I2S_FLAG_RXNE) == RESET);
+  while ((ADS1256_SPI->SR & SPI_I2S_FLAG_RXNE) == 0U);
 
   /* Return the byte read from the SPI bus */
-  return SPI_I2S_ReceiveData(ADS1256_SPI);
+  return (uint8_t) ADS1256_SPI->DR;
 }
 
 /**
@@ -280,8 +418,14 @@ void ADS1256_SendBytes(uint8_t* data, const uint8_t n) {
 #ifdef ADS1256_SPI_DEBUG
   printf("[ADS1256] Sending %d bytes\n\r", n);
 #endif
-  for (uint_fast8_t i = 0; i < n; ++i) {
-    ADS1256_SendByte(data[i]);
+  if (n >= ADS1256_SPI_DMA_THRESHOLD) {
+    ADS1256_SPI_WaitForTransfer();
+    ADS1256_TransferBytes_DMA(data, NULL, n, NULL);
+    ADS1256_SPI_WaitForTransfer();
+  } else {
+    for (uint_fast8_t i = 0; i < n; ++i) {
+      ADS1256_SendByte(data[i]);
+    }
   }
 }
 
@@ -310,8 +454,98 @@ void ADS1256_ReceiveBytes(uint8_t* data, uint8_t n) {
 #ifdef ADS1256_SPI_DEBUG
   printf("[ADS1256] Receiving %d bytes\n\r", n);
 #endif
-  for (uint_fast8_t i = 0; i < n; ++i) {
-    data[i] = ADS1256_ReceiveByte();
+  if (n >= ADS1256_SPI_DMA_THRESHOLD) {
+    ADS1256_SPI_WaitForTransfer();
+    ADS1256_TransferBytes_DMA(NULL, data, n, NULL);
+    ADS1256_SPI_WaitForTransfer();
+  } else {
+    for (uint_fast8_t i = 0; i < n; ++i) {
+      data[i] = ADS1256_ReceiveByte();
+    }
+  }
+}
+
+/**
+ * Starts a full duplex transfer with the ADS1256 using the DMA engine and returns immediately. The chip
+ * select line is not touched; the caller is responsible for framing the transfer. When the final byte
+ * has been received the DMA interrupt will invoke the provided callback (if any) from interrupt context.
+ * The buffers must remain valid until the transfer has completed.
+ *
+ * @param tx uint8_t* The bytes to transmit, or NULL to transmit dummy bytes.
+ * @param rx uint8_t* The buffer to store received bytes in, or NULL to discard them.
+ * @param n uint8_t The number of bytes to transfer.
+ * @param callback ADS1256_SPI_TransferCallback The function to call on completion, may be NULL.
+ * @retval bool TRUE if the transfer was started, FALSE if a transfer is already in progress or n is 0.
+ */
+bool ADS1256_TransferBytes_DMA(uint8_t* tx, uint8_t* rx, uint8_t n, ADS1256_SPI_TransferCallback callback) {
+  if (DMA_Busy == true || n == 0U) {
+    return false;
+  }
+  DMA_Busy = true;
+  DMA_Callback = callback;
+  DMA_RxBuffer = rx;
+  DMA_Count = n;
+
+  /* Drain any stale byte left in the receive register */
+  while (SPI_I2S_GetFlagStatus(ADS1256_SPI, SPI_I2S_FLAG_RXNE) == SET) {
+    SPI_I2S_ReceiveData(ADS1256_SPI);
+  }
+
+  DMA_ClearFlag(ADS1256_SPI_DMA_RX_STREAM, ADS1256_SPI_DMA_RX_FLAGS);
+  DMA_ClearFlag(ADS1256_SPI_DMA_TX_STREAM, ADS1256_SPI_DMA_TX_FLAGS);
+  ADS1256_DMA_LoadStream(ADS1256_SPI_DMA_RX_STREAM, rx, n);
+  ADS1256_DMA_LoadStream(ADS1256_SPI_DMA_TX_STREAM, tx, n);
+
+  /* Enable the receiver first so no byte can be missed, then start clocking with the transmitter */
+  DMA_Cmd(ADS1256_SPI_DMA_RX_STREAM, ENABLE);
+  DMA_Cmd(ADS1256_SPI_DMA_TX_STREAM, ENABLE);
+  SPI_I2S_DMACmd(ADS1256_SPI, SPI_I2S_DMAReq_Rx | SPI_I2S_DMAReq_Tx, ENABLE);
+  return true;
+}
+
+/**
+ * Checks if a DMA transfer with the ADS1256 is currently in progress.
+ *
+ * @param none
+ * @retval bool TRUE if a transfer is in progress.
+ */
+bool ADS1256_SPI_IsBusy(void) {
+  return DMA_Busy;
+}
+
+/**
+ * Blocks until any in progress DMA transfer with the ADS1256 has completed. Returns immediately if
+ * no transfer is in progress.
+ *
+ * @param none
+ * @retval none
+ */
+void ADS1256_SPI_WaitForTransfer(void) {
+  while (DMA_Busy == true) {
+    /* Wait for the DMA interrupt */
+  }
+}
+
+/**
+ * Handles the transfer complete interrupt of the SPI receive DMA stream. This shuts down both streams,
+ * releases the driver for the next transfer and notifies the registered callback. This must be called
+ * from the DMA stream IRQ handler.
+ *
+ * @param none
+ * @retval none
+ */
+void ADS1256_SPI_DMA_IRQHandler(void) {
+  if (DMA_GetITStatus(ADS1256_SPI_DMA_RX_STREAM, ADS1256_SPI_DMA_RX_IT_TC) != RESET) {
+    DMA_ClearITPendingBit(ADS1256_SPI_DMA_RX_STREAM, ADS1256_SPI_DMA_RX_IT_TC);
+    SPI_I2S_DMACmd(ADS1256_SPI, SPI_I2S_DMAReq_Rx | SPI_I2S_DMAReq_Tx, DISABLE);
+    DMA_Cmd(ADS1256_SPI_DMA_RX_STREAM, DISABLE);
+    DMA_Cmd(ADS1256_SPI_DMA_TX_STREAM, DISABLE);
+    ADS1256_SPI_TransferCallback callback = DMA_Callback;
+    DMA_Callback = NULL;
+    DMA_Busy = false;
+    if (callback != NULL) {
+      callback(DMA_RxBuffer, DMA_Count);
+    }
   }
 }
 
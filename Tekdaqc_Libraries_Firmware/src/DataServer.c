@@ -0,0 +1,642 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file DataServer.c
+ * @brief Implements a raw TCP stream for the Tekdaqc's sample data.
+ *
+ * Implements a raw TCP stream which carries only sample data. Commands, status and error messages remain on the
+ * Telnet server. Nothing received from the client is interpreted, and the data is not subject to any Telnet
+ * option processing. Only a single connection is allowed at a time; further attempts are refused.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "DataServer.h"
+#include "Tekdaqc_BSP.h"
+#include "Tekdaqc_Timers.h"
+#include "netconf.h"
+#include "lwip/memp.h"
+#include "lwip/tcp.h"
+#include <string.h>
+#include <stdio.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def DATA_RECORD_SEPARATOR
+ * @brief The record separator which terminates sample records on the Telnet connection.
+ */
+#define DATA_RECORD_SEPARATOR	'\x1E'
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Pointer to the TCP port being used for the data server.
+ */
+static struct tcp_pcb *data_pcb;
+
+/**
+ * @internal
+ * @brief The state of the data server.
+ */
+static DataServer_t data_server;
+
+/**
+ * @internal
+ * @brief Indicates the connection status of the data server.
+ */
+static bool IsConnected = false;
+
+/**
+ * @internal
+ * @brief The time in microseconds data may wait in the transmit ring for a full segment to accumulate.
+ */
+static uint32_t flushLatency = DATA_FLUSH_LATENCY_DEFAULT_US;
+
+/**
+ * @internal
+ * @brief Set if small writes are sent without waiting for outstanding data to be ACKed.
+ */
+static bool noDelay = DATA_NO_DELAY_DEFAULT;
+
+/**
+ * @internal
+ * @brief The number of bytes handed to lwIP since start up.
+ */
+static uint32_t bytesSent = 0U;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Called when the lwIP TCP/IP stack has an incoming connection request on the data port.
+ */
+static err_t DataServerAccept(void *arg, struct tcp_pcb *pcb, err_t err);
+
+/**
+ * @internal
+ * @brief Called when the lwIP TCP/IP stack has an incoming packet for the data connection.
+ */
+static err_t DataServerReceive(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err);
+
+/**
+ * @internal
+ * @brief Called when the lwIP TCP/IP stack has received an acknowledge for data that has been transmitted.
+ */
+static err_t DataServerSent(void *arg, struct tcp_pcb *pcb, u16_t len);
+
+/**
+ * @internal
+ * @brief Called periodically by the lwIP TCP/IP stack for the data connection.
+ */
+static err_t DataServerPoll(void *arg, struct tcp_pcb *pcb);
+
+/**
+ * @internal
+ * @brief Called when the lwIP TCP/IP stack has detected an error.
+ */
+static void DataServerError(void *arg, err_t err);
+
+/**
+ * @internal
+ * @brief Aborts the client connection, freeing the server for a new client.
+ */
+static void DataServerAbort(void);
+
+/**
+ * @internal
+ * @brief Empties the transmit ring.
+ */
+static void DataServerResetTransmit(void);
+
+/**
+ * @internal
+ * @brief Retrieves the free space in the transmit ring.
+ */
+static uint16_t DataServerRingFree(void);
+
+/**
+ * @internal
+ * @brief Copies a complete block of data into the transmit ring if there is room for all of it.
+ */
+static WriteStatus_t DataServerQueue(const char* data, uint16_t length);
+
+/**
+ * @internal
+ * @brief Hands any unsent data in the transmit ring to lwIP.
+ */
+static void DataServerTransmit(void);
+
+/**
+ * @internal
+ * @brief Determines if the pending data in the transmit ring should be sent now.
+ */
+static bool isDataServerFlushDue(void);
+
+/**
+ * @internal
+ * @brief Releases the transmit segments which have been ACKed by the client.
+ */
+static void DataServerReleaseAcked(u16_t len);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * This function is called when the lwIP TCP/IP stack has an incoming connection request on the data port. Only a
+ * single client is served at a time.
+ *
+ * @param arg void* Argument pointer passed to the handler by the lwIP stack.
+ * @param pcb tcp_pcb* struct The PCB structure this callback is for.
+ * @param err lwIP err_t with the current error status.
+ * @retval err lwIP err_t with the result of the this function.
+ */
+static err_t DataServerAccept(void *arg, struct tcp_pcb *pcb, err_t err) {
+	LWIP_UNUSED_ARG(arg);
+	LWIP_UNUSED_ARG(err);
+	if (IsConnected == true) {
+#ifdef DATA_SERVER_DEBUG
+		printf("[Data Server] A connection was attempted while an active connection is open.\n\r");
+#endif
+		tcp_abort(pcb);
+		return ERR_ABRT;
+	}
+	tcp_accepted(pcb);
+	tcp_setprio(pcb, TCP_PRIO_MIN);
+	/* Nagle holds back the partial segment of a flush while full ones are outstanding, which suits bulk data */
+	if (noDelay == true) {
+		tcp_nagle_disable(pcb);
+	} else {
+		tcp_nagle_enable(pcb);
+	}
+
+	data_server.pcb = pcb;
+	data_server.ackedAt = GetLocalTime();
+	DataServerResetTransmit();
+	IsConnected = true;
+	LwIP_EnableKeepalive(pcb);
+
+	tcp_arg(pcb, &data_server);
+	tcp_recv(pcb, DataServerReceive);
+	tcp_err(pcb, DataServerError);
+	tcp_poll(pcb, DataServerPoll, 1);
+	tcp_sent(pcb, DataServerSent);
+#ifdef DATA_SERVER_DEBUG
+	printf("[Data Server] An incoming connection was accepted.\n\r");
+#endif
+	return ERR_OK;
+}
+
+/**
+ * @internal
+ * This function is called when the lwIP TCP/IP stack has an incoming packet for the data connection. The data
+ * connection is transmit only, so received data is discarded. A NULL packet indicates the client has closed the
+ * connection.
+ *
+ * @param arg void* Argument pointer passed to the handler by the lwIP stack.
+ * @param pcb tcp_pcb* struct The PCB structure this callback is for.
+ * @param p pbuf* struct The data buffer from the lwIP stack.
+ * @param err lwIP err_t with the current error status.
+ * @retval err lwIP err_t with the result of the this function.
+ */
+static err_t DataServerReceive(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err) {
+	LWIP_UNUSED_ARG(arg);
+	if (p != NULL ) {
+		tcp_recved(pcb, p->tot_len);
+		pbuf_free(p);
+	} else if (err == ERR_OK) {
+		DataServerClose();
+	}
+	return ERR_OK;
+}
+
+/**
+ * @internal
+ * This function is called when the lwIP TCP/IP stack has received an acknowledge for data that has been
+ * transmitted.
+ *
+ * @param arg void* Argument pointer passed to the handler by the lwIP stack.
+ * @param pcb tcp_pcb* struct The PCB structure this callback is for.
+ * @param len u16_t The number of bytes which were ACKed.
+ * @retval err lwIP err_t with the result of the this function.
+ */
+static err_t DataServerSent(void *arg, struct tcp_pcb *pcb, u16_t len) {
+	LWIP_UNUSED_ARG(arg);
+	LWIP_UNUSED_ARG(pcb);
+	data_server.ackedAt = GetLocalTime();
+	DataServerReleaseAcked(len);
+	if (isDataServerFlushDue() == true) {
+		DataServerTransmit();
+	}
+	return ERR_OK;
+}
+
+/**
+ * @internal
+ * This function is called periodically by the lwIP TCP/IP stack. Any unsent data is handed to lwIP as a backstop
+ * to DataServerService(). A client which has stopped ACKing without closing is aborted here, so a new client can
+ * connect.
+ *
+ * @param arg void* Argument pointer passed to the handler by the lwIP stack.
+ * @param pcb tcp_pcb* struct The PCB structure this callback is for.
+ * @retval err lwIP err_t with the result of the this function.
+ */
+static err_t DataServerPoll(void *arg, struct tcp_pcb *pcb) {
+	LWIP_UNUSED_ARG(arg);
+	if (LwIP_IsPeerStalled(pcb, &data_server.ackedAt) == true) {
+#ifdef DATA_SERVER_DEBUG
+		printf("[Data Server] Aborting a connection whose client stopped responding.\n\r");
+#endif
+		DataServerAbort();
+		return ERR_ABRT;
+	}
+	DataServerTransmit();
+	return ERR_OK;
+}
+
+/**
+ * @internal
+ * This function is called when a fatal error has occurred on the data connection. The PCB has already been freed
+ * by lwIP.
+ *
+ * @param arg void* Argument pointer passed to the handler by the lwIP stack.
+ * @param err lwIP err_t with the error which occurred.
+ * @retval none
+ */
+static void DataServerError(void *arg, err_t err) {
+	LWIP_UNUSED_ARG(arg);
+	LWIP_UNUSED_ARG(err);
+#ifdef DATA_SERVER_DEBUG
+	printf("[Data Server] Data server error received: %i\n\r", err);
+#endif
+	data_server.pcb = NULL;
+	IsConnected = false;
+}
+
+/**
+ * @internal
+ * Aborts the client connection, discarding the unacknowledged data so the ring is free for the next client at once.
+ * Must only be called from a callback of the connection if the callback then returns ERR_ABRT.
+ *
+ * @param none
+ * @retval none
+ */
+static void DataServerAbort(void) {
+	struct tcp_pcb *pcb = data_server.pcb;
+	if (pcb != NULL ) {
+		tcp_arg(pcb, NULL );
+		tcp_sent(pcb, NULL );
+		tcp_recv(pcb, NULL );
+		tcp_err(pcb, NULL );
+		tcp_poll(pcb, NULL, 0);
+		data_server.pcb = NULL;
+		tcp_abort(pcb);
+	}
+	DataServerResetTransmit();
+	IsConnected = false;
+}
+
+/**
+ * @internal
+ * Empties the transmit ring, leaving a single empty segment ready to be filled.
+ *
+ * @param none
+ * @retval none
+ */
+static void DataServerResetTransmit(void) {
+	for (uint_fast8_t i = 0; i < DATA_TX_SEGMENT_COUNT; ++i) {
+		data_server.segments[i].length = 0U;
+		data_server.segments[i].queued = 0U;
+		data_server.segments[i].acked = 0U;
+	}
+	data_server.txHead = 0U;
+	data_server.txTail = 0U;
+	data_server.txUsed = 1U;
+	data_server.unsent = 0U;
+	data_server.unsentSince = 0U;
+}
+
+/**
+ * @internal
+ * Retrieves the number of bytes which can currently be written into the transmit ring.
+ *
+ * @param none
+ * @retval uint16_t The number of bytes which can be written.
+ */
+static uint16_t DataServerRingFree(void) {
+	return (DATA_TX_SEGMENT_SIZE - data_server.segments[data_server.txHead].length)
+			+ ((DATA_TX_SEGMENT_COUNT - data_server.txUsed) * DATA_TX_SEGMENT_SIZE);
+}
+
+/**
+ * @internal
+ * Copies a complete block of data into the transmit ring if there is room for all of it. This never waits. A new
+ * segment is only started once the current one is full, so every segment but the last one handed to lwIP fills a
+ * whole packet.
+ *
+ * @param data const char* Pointer to the data to write.
+ * @param length uint16_t The number of bytes to write.
+ * @retval WriteStatus_t The result of the write. Nothing is copied unless WRITE_OK is returned.
+ */
+static WriteStatus_t DataServerQueue(const char* data, uint16_t length) {
+	if (IsConnected == false) {
+		return WRITE_NOT_CONNECTED;
+	}
+	if (length > (DATA_TX_SEGMENT_SIZE * DATA_TX_SEGMENT_COUNT)) {
+		return WRITE_TOO_LARGE;
+	}
+	if (DataServerRingFree() < length) {
+		return WRITE_BUSY;
+	}
+	if ((data_server.unsent == 0U) && (length > 0U)) {
+		/* The flush deadline runs from the oldest unsent byte */
+		data_server.unsentSince = GetLocalTime();
+	}
+	data_server.unsent += length;
+	while (length > 0U) {
+		DataTxSegment_t* segment = &data_server.segments[data_server.txHead];
+		if (segment->length == DATA_TX_SEGMENT_SIZE) {
+			/* The free space check guarantees there is another segment available */
+			data_server.txHead = (data_server.txHead + 1U) % DATA_TX_SEGMENT_COUNT;
+			++data_server.txUsed;
+			segment = &data_server.segments[data_server.txHead];
+			segment->length = 0U;
+			segment->queued = 0U;
+			segment->acked = 0U;
+		}
+		uint16_t count = DATA_TX_SEGMENT_SIZE - segment->length;
+		if (count > length) {
+			count = length;
+		}
+		memcpy(&segment->data[segment->length], data, count);
+		segment->length += count;
+		data += count;
+		length -= count;
+	}
+	return WRITE_OK;
+}
+
+/**
+ * @internal
+ * Hands any data in the transmit ring which has not yet been queued to lwIP, as much as the send buffer allows.
+ * The data is passed by reference rather than copied; it stays in place until DataServerReleaseAcked() is called
+ * for it.
+ *
+ * @param none
+ * @retval none
+ */
+static void DataServerTransmit(void) {
+	if (data_server.pcb == NULL ) {
+		return;
+	}
+	bool written = false;
+	uint8_t index = data_server.txTail;
+	for (uint_fast8_t i = 0; i < data_server.txUsed; ++i) {
+		DataTxSegment_t* segment = &data_server.segments[index];
+		uint16_t pending = segment->length - segment->queued;
+		if (pending > 0U) {
+			uint16_t space = tcp_sndbuf(data_server.pcb);
+			if (pending > space) {
+				pending = space;
+			}
+			if ((pending == 0U) || (tcp_write(data_server.pcb, &segment->data[segment->queued], pending, 0) != ERR_OK)) {
+				/* lwIP is out of room, the rest is sent once more data has been ACKed */
+				break;
+			}
+			segment->queued += pending;
+			data_server.unsent -= pending;
+			bytesSent += pending;
+			written = true;
+			if (segment->queued != segment->length) {
+				break;
+			}
+		}
+		index = (index + 1U) % DATA_TX_SEGMENT_COUNT;
+	}
+	if (written == true) {
+		tcp_output(data_server.pcb);
+	}
+}
+
+/**
+ * @internal
+ * Determines if the unsent data in the transmit ring should be handed to lwIP now. Data is sent as soon as a full
+ * segment is waiting, or once the oldest unsent byte has waited for the flush latency.
+ *
+ * @param none
+ * @retval bool TRUE if the pending data should be sent.
+ */
+static bool isDataServerFlushDue(void) {
+	if (data_server.unsent == 0U) {
+		return false;
+	}
+	if (data_server.unsent >= DATA_TX_SEGMENT_SIZE) {
+		return true;
+	}
+	return ((GetLocalTime() - data_server.unsentSince) >= flushLatency);
+}
+
+/**
+ * @internal
+ * Accounts for data ACKed by the client, releasing each segment back to the ring once all of it has been ACKed.
+ * ACKs arrive in order, so they always apply to the oldest segment first.
+ *
+ * @param len u16_t The number of bytes which were ACKed.
+ * @retval none
+ */
+static void DataServerReleaseAcked(u16_t len) {
+	while (len > 0U) {
+		DataTxSegment_t* segment = &data_server.segments[data_server.txTail];
+		uint16_t unacked = segment->queued - segment->acked;
+		uint16_t count = (len < unacked) ? len : unacked;
+		segment->acked += count;
+		len -= count;
+		if (segment->acked != segment->length) {
+			break;
+		}
+		/* The whole segment has been delivered, so lwIP no longer references it */
+		segment->length = 0U;
+		segment->queued = 0U;
+		segment->acked = 0U;
+		if (data_server.txTail == data_server.txHead) {
+			break;
+		}
+		data_server.txTail = (data_server.txTail + 1U) % DATA_TX_SEGMENT_COUNT;
+		--data_server.txUsed;
+	}
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Creates the TCP listener for the data server on DATA_PORT.
+ *
+ * @param none
+ * @retval DataServerStatus_t The result of the initialization.
+ */
+DataServerStatus_t InitializeDataServer(void) {
+	data_server.pcb = NULL;
+	DataServerResetTransmit();
+	data_pcb = tcp_new();
+	if (data_pcb != NULL ) {
+		if (tcp_bind(data_pcb, IP_ADDR_ANY, DATA_PORT) == ERR_OK) {
+			data_pcb = tcp_listen(data_pcb);
+#ifdef DATA_SERVER_DEBUG
+			printf("[Data Server] Now listening for incoming connections on port %i\n\r", DATA_PORT);
+#endif
+			tcp_accept(data_pcb, DataServerAccept);
+			return DATA_SERVER_OK;
+		} else {
+			/* Deallocate the pcb */
+			memp_free(MEMP_TCP_PCB, data_pcb);
+#ifdef DATA_SERVER_DEBUG
+			printf("[Data Server] Can not bind pcb\n\r");
+#endif
+			return DATA_SERVER_ERR_BIND;
+		}
+	} else {
+#ifdef DATA_SERVER_DEBUG
+		printf("[Data Server] Can not create new TCP port.\n\r");
+#endif
+		return DATA_SERVER_ERR_PCBCREATE;
+	}
+}
+
+/**
+ * Returns the connection status of the data server. Sample data writers use this to decide whether samples go to
+ * the data stream or to the Telnet connection.
+ *
+ * @param none
+ * @retval bool TRUE if the data server has a connected client.
+ */
+bool DataServerIsConnected(void) {
+	return IsConnected;
+}
+
+/**
+ * Closes the data server's client connection. Any data which has not yet been sent is discarded.
+ *
+ * @param none
+ * @retval none
+ */
+void DataServerClose(void) {
+	struct tcp_pcb *pcb = data_server.pcb;
+	if (pcb != NULL ) {
+		/* Remove all callbacks */
+		tcp_arg(pcb, NULL );
+		tcp_sent(pcb, NULL );
+		tcp_recv(pcb, NULL );
+		tcp_err(pcb, NULL );
+		tcp_poll(pcb, NULL, 0);
+		data_server.pcb = NULL;
+		tcp_close(pcb);
+	}
+	IsConnected = false;
+}
+
+/**
+ * Called from the main loop to send the data waiting in the transmit ring as soon as the flush policy allows.
+ *
+ * @param none
+ * @retval none
+ */
+void DataServerService(void) {
+	if ((IsConnected == true) && (isDataServerFlushDue() == true)) {
+		DataServerTransmit();
+	}
+}
+
+/**
+ * Sets the time data may wait in the transmit ring for a full segment to accumulate before it is sent. A latency
+ * of 0 sends data on the next service call after it is written.
+ *
+ * @param latency uint32_t The flush latency in microseconds.
+ * @retval none
+ */
+void DataServerSetFlushLatency(uint32_t latency) {
+	flushLatency = latency;
+}
+
+/**
+ * Sets whether the connection sends small writes without waiting for outstanding data to be ACKed, with Nagle's
+ * algorithm disabled. The setting applies to the current connection, if any, and to those accepted later.
+ *
+ * @param enable bool TRUE to send without delay, FALSE to coalesce with Nagle's algorithm.
+ * @retval none
+ */
+void DataServerSetNoDelay(bool enable) {
+	noDelay = enable;
+	if ((IsConnected == true) && (data_server.pcb != NULL)) {
+		if (enable == true) {
+			tcp_nagle_disable(data_server.pcb);
+		} else {
+			tcp_nagle_enable(data_server.pcb);
+		}
+	}
+}
+
+/**
+ * Retrieves the number of bytes sent over the data connection since start up. The count wraps, so the rate is found
+ * from the difference of two counts.
+ *
+ * @param none
+ * @retval uint32_t The number of bytes handed to lwIP.
+ */
+uint32_t DataServerGetBytesSent(void) {
+	return bytesSent;
+}
+
+/**
+ * Writes a sample record string to the data server. The record separator which terminates records on the Telnet
+ * connection is not needed on the raw stream and is dropped. The string is either accepted in full or not at all.
+ *
+ * @param string char* Pointer to a C-String to write.
+ * @retval WriteStatus_t The result of the write.
+ */
+WriteStatus_t DataServerWriteString(char* string) {
+	uint16_t length = strlen(string);
+	if ((length > 0U) && (string[length - 1U] == DATA_RECORD_SEPARATOR)) {
+		--length;
+	}
+	return DataServerQueue(string, length);
+}
+
+/**
+ * Writes a block of binary sample data to the data server. The block is either accepted in full or not at all.
+ *
+ * @param data const uint8_t* Pointer to the data to write.
+ * @param length uint16_t The number of bytes to write.
+ * @retval WriteStatus_t The result of the write.
+ */
+WriteStatus_t DataServerWriteBinary(const uint8_t* data, uint16_t length) {
+	return DataServerQueue((const char*) data, length);
+}
@@ -0,0 +1,636 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file HttpServer.c
+ * @brief Implements an HTTP/1.1 download server for the Tekdaqc.
+ *
+ * Implements just enough of HTTP/1.1 over the lwIP raw API for standard tools to download the documents provided by
+ * the application through a table of HttpResource_t. Only GET is supported and every response closes the connection.
+ * A document is sent with chunked transfer encoding, so its length need not be known up front: each chunk is read
+ * straight from where the document is held and queued as the send buffer frees up, driven by the acknowledgements
+ * of the client. The document is never formatted or staged on the way, so a download runs at link speed. A
+ * document with an upgrade function is not sent, its connection is handed over to that function instead.
+ *
+ * A single client is served at a time, as a second bulk download would only halve the rate of both.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "HttpServer.h"
+#include "Tekdaqc_BSP.h"
+#include "Tekdaqc_Timers.h"
+#include "netconf.h"
+#include "lwip/memp.h"
+#include "lwip/tcp.h"
+#include <string.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def HTTP_CHUNK_OVERHEAD
+ * @brief The most bytes of framing around a chunk, its length in hex, CRLF, and the CRLF which ends it.
+ */
+#define HTTP_CHUNK_OVERHEAD		8U
+
+/**
+ * @internal
+ * @def HTTP_CHUNK_SIZE
+ * @brief The most bytes of a document sent in a single chunk, so a chunk and its framing fill one segment.
+ */
+#define HTTP_CHUNK_SIZE			(TCP_MSS - HTTP_CHUNK_OVERHEAD)
+
+/**
+ * @internal
+ * @def HTTP_CHUNK_PBUFS
+ * @brief The most pbufs queuing a chunk takes, one each for its framing and its data.
+ */
+#define HTTP_CHUNK_PBUFS		3U
+
+/**
+ * @internal
+ * @def HTTP_HEADER_SIZE
+ * @brief The size of the buffer the response headers are built in.
+ */
+#define HTTP_HEADER_SIZE		256U
+
+/**
+ * @internal
+ * @def HTTP_HEADER_END
+ * @brief The blank line which ends the headers of a request.
+ */
+#define HTTP_HEADER_END			"\r\n\r\n"
+
+/**
+ * @internal
+ * @def HTTP_LAST_CHUNK
+ * @brief The zero length chunk, without trailers, which ends a chunked document.
+ */
+#define HTTP_LAST_CHUNK			"0\r\n\r\n"
+
+/** HTTP status lines answered without a document */
+#define HTTP_STATUS_BAD_REQUEST			"400 Bad Request"
+#define HTTP_STATUS_NOT_FOUND			"404 Not Found"
+#define HTTP_STATUS_NOT_ALLOWED			"405 Method Not Allowed"
+#define HTTP_STATUS_UNAVAILABLE			"503 Service Unavailable"
+#define HTTP_STATUS_NOT_SUPPORTED		"505 HTTP Version Not Supported"
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Pointer to the TCP port being used for the HTTP server.
+ */
+static struct tcp_pcb *http_pcb;
+
+/**
+ * @internal
+ * @brief The client connection of the HTTP server.
+ */
+static HttpConnection_t connection;
+
+/**
+ * @internal
+ * @brief The documents served by the HTTP server.
+ */
+static const HttpResource_t* httpResources = NULL;
+
+/**
+ * @internal
+ * @brief The number of documents in httpResources.
+ */
+static uint8_t httpResourceCount = 0U;
+
+/**
+ * @internal
+ * @brief The number of requests answered since start up.
+ */
+static uint32_t requestCount = 0U;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Called when the lwIP TCP/IP stack has an incoming connection request on the HTTP port.
+ */
+static err_t HttpServerAccept(void *arg, struct tcp_pcb *pcb, err_t err);
+
+/**
+ * @internal
+ * @brief Called when the lwIP TCP/IP stack has an incoming packet for the HTTP connection.
+ */
+static err_t HttpServerReceive(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err);
+
+/**
+ * @internal
+ * @brief Called when the lwIP TCP/IP stack has received an acknowledge for data that has been transmitted.
+ */
+static err_t HttpServerSent(void *arg, struct tcp_pcb *pcb, u16_t len);
+
+/**
+ * @internal
+ * @brief Called periodically by the lwIP TCP/IP stack.
+ */
+static err_t HttpServerPoll(void *arg, struct tcp_pcb *pcb);
+
+/**
+ * @internal
+ * @brief Called when the lwIP TCP/IP stack has detected an error.
+ */
+static void HttpServerError(void *arg, err_t err);
+
+/**
+ * @internal
+ * @brief Closes the HTTP client connection once its queued data has been sent.
+ */
+static void HttpServerClose(void);
+
+/**
+ * @internal
+ * @brief Aborts the HTTP client connection at once.
+ */
+static void HttpServerAbort(void);
+
+/**
+ * @internal
+ * @brief Answers the complete request held by the connection.
+ */
+static bool HttpServerAnswer(void);
+
+/**
+ * @internal
+ * @brief Answers the request with a status and no document.
+ */
+static bool HttpServerRespondStatus(const char* status);
+
+/**
+ * @internal
+ * @brief Queues as much of the document as the send buffer takes.
+ */
+static bool HttpServerSendBody(void);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * This function is called when the lwIP TCP/IP stack has an incoming connection request on the HTTP port. A client
+ * arriving while another is being served is refused.
+ *
+ * @param arg void* Argument pointer passed to the handler by the lwIP stack.
+ * @param pcb tcp_pcb* struct The PCB structure this callback is for.
+ * @param err lwIP err_t with the current error status.
+ * @retval err lwIP err_t with the result of the this function.
+ */
+static err_t HttpServerAccept(void *arg, struct tcp_pcb *pcb, err_t err) {
+	LWIP_UNUSED_ARG(arg);
+	LWIP_UNUSED_ARG(err);
+	if (connection.pcb != NULL) {
+#ifdef HTTP_SERVER_DEBUG
+		printf("[HTTP Server] A connection was attempted while a download is in progress.\n\r");
+#endif
+		tcp_abort(pcb);
+		return ERR_ABRT;
+	}
+	tcp_accepted(pcb);
+	tcp_setprio(pcb, TCP_PRIO_MIN);
+
+	connection.pcb = pcb;
+	connection.state = HTTP_CONNECTION_REQUEST;
+	connection.length = 0U;
+	connection.resource = NULL;
+	connection.offset = 0U;
+	connection.ackedAt = GetLocalTime();
+	LwIP_EnableKeepalive(pcb);
+
+	tcp_arg(pcb, &connection);
+	tcp_recv(pcb, HttpServerReceive);
+	tcp_err(pcb, HttpServerError);
+	tcp_poll(pcb, HttpServerPoll, 1);
+	tcp_sent(pcb, HttpServerSent);
+#ifdef HTTP_SERVER_DEBUG
+	printf("[HTTP Server] An incoming connection was accepted.\n\r");
+#endif
+	return ERR_OK;
+}
+
+/**
+ * @internal
+ * This function is called when the lwIP TCP/IP stack has an incoming packet for the HTTP connection. The bytes are
+ * gathered until the headers of the request are complete, then the request is answered. Anything received after
+ * the request is discarded. A NULL packet indicates the client has closed the connection.
+ *
+ * @param arg void* Argument pointer passed to the handler by the lwIP stack.
+ * @param pcb tcp_pcb* struct The PCB structure this callback is for.
+ * @param p pbuf* struct The data buffer from the lwIP stack.
+ * @param err lwIP err_t with the current error status.
+ * @retval err lwIP err_t with the result of the this function.
+ */
+static err_t HttpServerReceive(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err) {
+	LWIP_UNUSED_ARG(arg);
+	if (p == NULL) {
+		if (err == ERR_OK) {
+			HttpServerClose();
+		}
+		return ERR_OK;
+	}
+	tcp_recved(pcb, p->tot_len);
+	if (connection.state == HTTP_CONNECTION_REQUEST) {
+		/* Keep a byte for the terminator, so the request can be searched as a string */
+		uint16_t count = (HTTP_MAX_REQUEST_SIZE - 1U) - connection.length;
+		if (count > p->tot_len) {
+			count = p->tot_len;
+		}
+		pbuf_copy_partial(p, &connection.request[connection.length], count, 0U);
+		connection.length += count;
+		connection.request[connection.length] = '\0';
+		bool answered = true;
+		if (strstr(connection.request, HTTP_HEADER_END) != NULL) {
+			answered = HttpServerAnswer();
+		} else if (connection.length == (HTTP_MAX_REQUEST_SIZE - 1U)) {
+			answered = HttpServerRespondStatus(HTTP_STATUS_BAD_REQUEST);
+		}
+		if (answered == false) {
+			pbuf_free(p);
+			HttpServerAbort();
+			return ERR_ABRT;
+		}
+	}
+	pbuf_free(p);
+	if (connection.state == HTTP_CONNECTION_DONE) {
+		HttpServerClose();
+	} else {
+		tcp_output(pcb);
+	}
+	return ERR_OK;
+}
+
+/**
+ * @internal
+ * This function is called when the lwIP TCP/IP stack has received an acknowledge for data that has been
+ * transmitted. The send buffer space freed is refilled with the next chunks of the document.
+ *
+ * @param arg void* Argument pointer passed to the handler by the lwIP stack.
+ * @param pcb tcp_pcb* struct The PCB structure this callback is for.
+ * @param len u16_t The number of bytes which were ACKed.
+ * @retval err lwIP err_t with the result of the this function.
+ */
+static err_t HttpServerSent(void *arg, struct tcp_pcb *pcb, u16_t len) {
+	LWIP_UNUSED_ARG(arg);
+	LWIP_UNUSED_ARG(pcb);
+	LWIP_UNUSED_ARG(len);
+	connection.ackedAt = GetLocalTime();
+	if (HttpServerSendBody() == false) {
+		HttpServerAbort();
+		return ERR_ABRT;
+	}
+	if (connection.state == HTTP_CONNECTION_DONE) {
+		HttpServerClose();
+	}
+	return ERR_OK;
+}
+
+/**
+ * @internal
+ * This function is called periodically by the lwIP TCP/IP stack. The document is continued here as a backstop to
+ * HttpServerSent(). A client which has stopped ACKing without closing is aborted here, so a new client can connect.
+ *
+ * @param arg void* Argument pointer passed to the handler by the lwIP stack.
+ * @param pcb tcp_pcb* struct The PCB structure this callback is for.
+ * @retval err lwIP err_t with the result of the this function.
+ */
+static err_t HttpServerPoll(void *arg, struct tcp_pcb *pcb) {
+	LWIP_UNUSED_ARG(arg);
+	if (LwIP_IsPeerStalled(pcb, &connection.ackedAt) == true) {
+#ifdef HTTP_SERVER_DEBUG
+		printf("[HTTP Server] Aborting a connection whose client stopped responding.\n\r");
+#endif
+		HttpServerAbort();
+		return ERR_ABRT;
+	}
+	if (HttpServerSendBody() == false) {
+		HttpServerAbort();
+		return ERR_ABRT;
+	}
+	if (connection.state == HTTP_CONNECTION_DONE) {
+		HttpServerClose();
+	}
+	return ERR_OK;
+}
+
+/**
+ * @internal
+ * This function is called when a fatal error has occurred on the HTTP connection. The PCB has already been freed
+ * by lwIP.
+ *
+ * @param arg void* Argument pointer passed to the handler by the lwIP stack.
+ * @param err lwIP err_t with the error which occurred.
+ * @retval none
+ */
+static void HttpServerError(void *arg, err_t err) {
+	LWIP_UNUSED_ARG(arg);
+	LWIP_UNUSED_ARG(err);
+#ifdef HTTP_SERVER_DEBUG
+	printf("[HTTP Server] HTTP server error received: %i\n\r", err);
+#endif
+	connection.pcb = NULL;
+	connection.state = HTTP_CONNECTION_FREE;
+}
+
+/**
+ * @internal
+ * Closes the HTTP client connection, freeing its slot. lwIP sends any data still queued before the FIN.
+ *
+ * @param none
+ * @retval none
+ */
+static void HttpServerClose(void) {
+	struct tcp_pcb *pcb = connection.pcb;
+	if (pcb != NULL) {
+		/* Remove all callbacks */
+		tcp_arg(pcb, NULL );
+		tcp_recv(pcb, NULL );
+		tcp_sent(pcb, NULL );
+		tcp_poll(pcb, NULL, 0);
+		tcp_err(pcb, NULL );
+		connection.pcb = NULL;
+		if (tcp_close(pcb) != ERR_OK) {
+			tcp_abort(pcb);
+		}
+	}
+	connection.state = HTTP_CONNECTION_FREE;
+}
+
+/**
+ * @internal
+ * Aborts the HTTP client connection, freeing its slot. A chunked document cut short this way is seen by the client
+ * as a failed transfer rather than a complete one. Callers inside an lwIP callback for the connection must return
+ * ERR_ABRT.
+ *
+ * @param none
+ * @retval none
+ */
+static void HttpServerAbort(void) {
+	struct tcp_pcb *pcb = connection.pcb;
+	if (pcb != NULL) {
+		/* Remove all callbacks */
+		tcp_arg(pcb, NULL );
+		tcp_recv(pcb, NULL );
+		tcp_sent(pcb, NULL );
+		tcp_poll(pcb, NULL, 0);
+		tcp_err(pcb, NULL );
+		connection.pcb = NULL;
+		tcp_abort(pcb);
+	}
+	connection.state = HTTP_CONNECTION_FREE;
+}
+
+/**
+ * @internal
+ * Answers the complete request held by the connection. The request line is checked and its path, less any query,
+ * looked up in the documents served. The request's headers are not interpreted.
+ *
+ * @param none
+ * @retval bool FALSE if the response could not be queued.
+ */
+static bool HttpServerAnswer(void) {
+	char* method = connection.request;
+	char* target = strchr(method, ' ');
+	if (target == NULL) {
+		return HttpServerRespondStatus(HTTP_STATUS_BAD_REQUEST);
+	}
+	*target++ = '\0';
+	char* version = strchr(target, ' ');
+	if ((version == NULL) || (target[0] != '/')) {
+		return HttpServerRespondStatus(HTTP_STATUS_BAD_REQUEST);
+	}
+	*version++ = '\0';
+	char* headers = strstr(version, "\r\n");
+	if ((headers == NULL) || (strncmp(version, "HTTP/1.", 7U) != 0)) {
+		return HttpServerRespondStatus(HTTP_STATUS_NOT_SUPPORTED);
+	}
+	if (strcmp(method, "GET") != 0) {
+		return HttpServerRespondStatus(HTTP_STATUS_NOT_ALLOWED);
+	}
+	char* query = strchr(target, '?');
+	if (query != NULL) {
+		*query++ = '\0';
+	} else {
+		query = &target[strlen(target)];
+	}
+	const HttpResource_t* resource = NULL;
+	for (uint_fast8_t i = 0U; i < httpResourceCount; ++i) {
+		if (strcmp(target, httpResources[i].path) == 0) {
+			resource = &httpResources[i];
+			break;
+		}
+	}
+	if (resource == NULL) {
+		return HttpServerRespondStatus(HTTP_STATUS_NOT_FOUND);
+	}
+	if (resource->upgrade != NULL) {
+		struct tcp_pcb* pcb = connection.pcb;
+		HttpUpgradeResult_t result = resource->upgrade(pcb, query, headers + 2);
+		if (result == HTTP_UPGRADE_BAD_REQUEST) {
+			return HttpServerRespondStatus(HTTP_STATUS_BAD_REQUEST);
+		} else if (result == HTTP_UPGRADE_UNAVAILABLE) {
+			return HttpServerRespondStatus(HTTP_STATUS_UNAVAILABLE);
+		}
+		++requestCount;
+#ifdef HTTP_SERVER_DEBUG
+		printf("[HTTP Server] Handed the connection over to %s.\n\r", resource->path);
+#endif
+		/* The new owner has replaced the callbacks, so the slot is simply freed for the next download */
+		connection.pcb = NULL;
+		connection.state = HTTP_CONNECTION_FREE;
+		return true;
+	}
+	if ((resource->open != NULL) && (resource->open() == false)) {
+		return HttpServerRespondStatus(HTTP_STATUS_UNAVAILABLE);
+	}
+	char header[HTTP_HEADER_SIZE];
+	int length = snprintf(header, sizeof(header), "HTTP/1.1 200 OK\r\nContent-Type: %s\r\n"
+			"Transfer-Encoding: chunked\r\nCache-Control: no-store\r\nConnection: close\r\n\r\n", resource->contentType);
+	++requestCount;
+	if ((length <= 0) || (length >= (int) sizeof(header))
+			|| (tcp_write(connection.pcb, header, (u16_t) length, TCP_WRITE_FLAG_COPY) != ERR_OK)) {
+#ifdef HTTP_SERVER_DEBUG
+		printf("[HTTP Server] Unable to queue a response.\n\r");
+#endif
+		return false;
+	}
+#ifdef HTTP_SERVER_DEBUG
+	printf("[HTTP Server] Sending %s.\n\r", resource->path);
+#endif
+	connection.resource = resource;
+	connection.offset = 0U;
+	connection.state = HTTP_CONNECTION_BODY;
+	return HttpServerSendBody();
+}
+
+/**
+ * @internal
+ * Answers the request with a status and no document, the status line repeated as a plain text body for people
+ * using a browser.
+ *
+ * @param status const char* The status code and reason phrase to answer with.
+ * @retval bool FALSE if the response could not be queued.
+ */
+static bool HttpServerRespondStatus(const char* status) {
+	char header[HTTP_HEADER_SIZE];
+	int length = snprintf(header, sizeof(header), "HTTP/1.1 %s\r\nContent-Type: text/plain\r\nContent-Length: %u\r\n"
+			"Connection: close\r\n\r\n%s\r\n", status, (unsigned int) (strlen(status) + 2U), status);
+	++requestCount;
+	connection.state = HTTP_CONNECTION_DONE;
+#ifdef HTTP_SERVER_DEBUG
+	printf("[HTTP Server] Answering %s.\n\r", status);
+#endif
+	return (length > 0) && (length < (int) sizeof(header))
+			&& (tcp_write(connection.pcb, header, (u16_t) length, TCP_WRITE_FLAG_COPY) == ERR_OK);
+}
+
+/**
+ * @internal
+ * Queues as much of the document as the send buffer takes, a chunk at a time, followed by the last chunk once the
+ * document has been read to its end. The chunks are copied into lwIP, so the document need only stay put until
+ * the next read. A chunk is either queued whole or not at all, so a full buffer only defers it.
+ *
+ * @param none
+ * @retval bool FALSE if the document could not be read or its framing could not be queued, and the connection
+ * must be aborted.
+ */
+static bool HttpServerSendBody(void) {
+	struct tcp_pcb* pcb = connection.pcb;
+	while ((pcb != NULL) && (connection.state == HTTP_CONNECTION_BODY)
+			&& ((tcp_sndqueuelen(pcb) + HTTP_CHUNK_PBUFS) <= TCP_SND_QUEUELEN)
+			&& (tcp_sndbuf(pcb) > HTTP_CHUNK_OVERHEAD)) {
+		const uint8_t* data = NULL;
+		uint32_t length = 0U;
+		if (connection.resource->read(connection.offset, &data, &length) == false) {
+#ifdef HTTP_SERVER_DEBUG
+			printf("[HTTP Server] %s can no longer be read, aborting the download.\n\r", connection.resource->path);
+#endif
+			return false;
+		}
+		if (length == 0U) {
+			if (tcp_write(pcb, HTTP_LAST_CHUNK, sizeof(HTTP_LAST_CHUNK) - 1U, TCP_WRITE_FLAG_COPY) != ERR_OK) {
+				break;
+			}
+			connection.state = HTTP_CONNECTION_DONE;
+#ifdef HTTP_SERVER_DEBUG
+			printf("[HTTP Server] Sent %" PRIu32 " bytes of %s.\n\r", connection.offset, connection.resource->path);
+#endif
+			break;
+		}
+		uint32_t room = tcp_sndbuf(pcb) - HTTP_CHUNK_OVERHEAD;
+		if (length > room) {
+			length = room;
+		}
+		if (length > HTTP_CHUNK_SIZE) {
+			length = HTTP_CHUNK_SIZE;
+		}
+		char size[HTTP_CHUNK_OVERHEAD];
+		int count = snprintf(size, sizeof(size), "%" PRIX32 "\r\n", length);
+		if (tcp_write(pcb, size, (u16_t) count, TCP_WRITE_FLAG_COPY | TCP_WRITE_FLAG_MORE) != ERR_OK) {
+			/* Nothing of the chunk is queued, so it is tried again once more of the buffer is free */
+			break;
+		}
+		if ((tcp_write(pcb, data, (u16_t) length, TCP_WRITE_FLAG_COPY | TCP_WRITE_FLAG_MORE) != ERR_OK)
+				|| (tcp_write(pcb, "\r\n", 2U, TCP_WRITE_FLAG_COPY) != ERR_OK)) {
+			return false;
+		}
+		connection.offset += length;
+	}
+	if (pcb != NULL) {
+		tcp_output(pcb);
+	}
+	return true;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Creates the TCP listener for the HTTP server on HTTP_PORT.
+ *
+ * @param resources const HttpResource_t* Pointer to the documents to serve. They must remain valid while the server
+ * runs.
+ * @param count uint8_t The number of documents in resources.
+ * @retval HttpServerStatus_t The result of the initialization.
+ */
+HttpServerStatus_t InitializeHttpServer(const HttpResource_t* resources, uint8_t count) {
+	httpResources = resources;
+	httpResourceCount = count;
+	connection.pcb = NULL;
+	connection.state = HTTP_CONNECTION_FREE;
+	http_pcb = tcp_new();
+	if (http_pcb != NULL ) {
+		if (tcp_bind(http_pcb, IP_ADDR_ANY, HTTP_PORT) == ERR_OK) {
+			http_pcb = tcp_listen(http_pcb);
+#ifdef HTTP_SERVER_DEBUG
+			printf("[HTTP Server] Now listening for incoming connections on port %i\n\r", HTTP_PORT);
+#endif
+			tcp_accept(http_pcb, HttpServerAccept);
+			return HTTP_SERVER_OK;
+		} else {
+			/* Deallocate the pcb */
+			memp_free(MEMP_TCP_PCB, http_pcb);
+#ifdef HTTP_SERVER_DEBUG
+			printf("[HTTP Server] Can not bind pcb\n\r");
+#endif
+			return HTTP_SERVER_ERR_BIND;
+		}
+	} else {
+#ifdef HTTP_SERVER_DEBUG
+		printf("[HTTP Server] Can not create new TCP port.\n\r");
+#endif
+		return HTTP_SERVER_ERR_PCBCREATE;
+	}
+}
+
+/**
+ * Closes the HTTP client connection, cutting short any download in progress.
+ *
+ * @param none
+ * @retval none
+ */
+void HttpServerCloseAll(void) {
+	HttpServerAbort();
+}
+
+/**
+ * Retrieves the number of requests the HTTP server has answered since start up, error responses included.
+ *
+ * @param none
+ * @retval uint32_t The number of requests answered.
+ */
+uint32_t HttpServerGetRequestCount(void) {
+	return requestCount;
+}
@@ -0,0 +1,548 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file ModbusServer.c
+ * @brief Implements a Modbus TCP server for the Tekdaqc.
+ *
+ * Implements the Modbus TCP framing and the bit and register access functions over the lwIP raw API. The data
+ * served is provided by the application through a ModbusMap_t, so this server has no knowledge of the inputs and
+ * outputs behind it. Each request is answered from the receive callback, a Modbus server never sends unprompted.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "ModbusServer.h"
+#include "Tekdaqc_BSP.h"
+#include "lwip/memp.h"
+#include "lwip/tcp.h"
+#include <string.h>
+#include <stdio.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def MBAP_HEADER_SIZE
+ * @brief The size of the Modbus application protocol header; transaction id, protocol id, length and unit id.
+ */
+#define MBAP_HEADER_SIZE			7U
+
+/**
+ * @internal
+ * @def MBAP_MIN_LENGTH
+ * @brief The smallest legal MBAP length field, the unit id and a function code.
+ */
+#define MBAP_MIN_LENGTH				2U
+
+/**
+ * @internal
+ * @def MBAP_MAX_LENGTH
+ * @brief The largest legal MBAP length field, the unit id and a 253 byte PDU.
+ */
+#define MBAP_MAX_LENGTH				(MODBUS_MAX_FRAME_SIZE - MBAP_HEADER_SIZE + 1U)
+
+/**
+ * @internal
+ * @def MODBUS_EXCEPTION_FLAG
+ * @brief Set in the function code of a response reporting an exception.
+ */
+#define MODBUS_EXCEPTION_FLAG		0x80U
+
+/**
+ * @internal
+ * @def MODBUS_COIL_ON
+ * @brief The Write Single Coil value turning the coil ON.
+ */
+#define MODBUS_COIL_ON				0xFF00U
+
+/**
+ * @internal
+ * @def MODBUS_COIL_OFF
+ * @brief The Write Single Coil value turning the coil OFF.
+ */
+#define MODBUS_COIL_OFF				0x0000U
+
+/** Modbus function codes */
+#define MODBUS_FC_READ_COILS				0x01U
+#define MODBUS_FC_READ_DISCRETE_INPUTS		0x02U
+#define MODBUS_FC_READ_HOLDING_REGISTERS	0x03U
+#define MODBUS_FC_READ_INPUT_REGISTERS		0x04U
+#define MODBUS_FC_WRITE_SINGLE_COIL			0x05U
+#define MODBUS_FC_WRITE_MULTIPLE_COILS		0x0FU
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Pointer to the TCP port being used for the Modbus server.
+ */
+static struct tcp_pcb *modbus_pcb;
+
+/**
+ * @internal
+ * @brief The client connections of the Modbus server.
+ */
+static ModbusConnection_t connections[MODBUS_MAX_CONNECTIONS];
+
+/**
+ * @internal
+ * @brief The data served by the Modbus server.
+ */
+static const ModbusMap_t* modbusMap = NULL;
+
+/**
+ * @internal
+ * @brief The response being built. Requests are answered one at a time from the main loop, so one buffer serves
+ * every connection.
+ */
+static uint8_t response[MODBUS_MAX_FRAME_SIZE];
+
+/**
+ * @internal
+ * @brief The number of requests answered since start up.
+ */
+static uint32_t requestCount = 0U;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Called when the lwIP TCP/IP stack has an incoming connection request on the Modbus port.
+ */
+static err_t ModbusServerAccept(void *arg, struct tcp_pcb *pcb, err_t err);
+
+/**
+ * @internal
+ * @brief Called when the lwIP TCP/IP stack has an incoming packet for a Modbus connection.
+ */
+static err_t ModbusServerReceive(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err);
+
+/**
+ * @internal
+ * @brief Called when the lwIP TCP/IP stack has detected an error.
+ */
+static void ModbusServerError(void *arg, err_t err);
+
+/**
+ * @internal
+ * @brief Closes a Modbus client connection.
+ */
+static void ModbusServerClose(ModbusConnection_t* connection);
+
+/**
+ * @internal
+ * @brief Builds the response PDU to a request PDU.
+ */
+static uint16_t ModbusServerProcessPDU(const uint8_t* request, uint16_t length, uint8_t* pdu);
+
+/**
+ * @internal
+ * @brief Answers the complete request frame held by a connection.
+ */
+static void ModbusServerAnswer(ModbusConnection_t* connection);
+
+/**
+ * @internal
+ * @brief Reads a big endian 16 bit value.
+ */
+static uint16_t ModbusGetUint16(const uint8_t* data);
+
+/**
+ * @internal
+ * @brief Writes a big endian 16 bit value.
+ */
+static void ModbusPutUint16(uint8_t* data, uint16_t value);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * This function is called when the lwIP TCP/IP stack has an incoming connection request on the Modbus port. Up to
+ * MODBUS_MAX_CONNECTIONS clients are served at a time.
+ *
+ * @param arg void* Argument pointer passed to the handler by the lwIP stack.
+ * @param pcb tcp_pcb* struct The PCB structure this callback is for.
+ * @param err lwIP err_t with the current error status.
+ * @retval err lwIP err_t with the result of the this function.
+ */
+static err_t ModbusServerAccept(void *arg, struct tcp_pcb *pcb, err_t err) {
+	LWIP_UNUSED_ARG(arg);
+	LWIP_UNUSED_ARG(err);
+	ModbusConnection_t* connection = NULL;
+	for (uint_fast8_t i = 0; i < MODBUS_MAX_CONNECTIONS; ++i) {
+		if (connections[i].pcb == NULL) {
+			connection = &connections[i];
+			break;
+		}
+	}
+	if (connection == NULL) {
+#ifdef MODBUS_SERVER_DEBUG
+		printf("[Modbus Server] A connection was attempted while all connections are in use.\n\r");
+#endif
+		tcp_abort(pcb);
+		return ERR_ABRT;
+	}
+	tcp_accepted(pcb);
+	tcp_setprio(pcb, TCP_PRIO_MIN);
+	/* Every response is a single small write the client is waiting on */
+	tcp_nagle_disable(pcb);
+
+	connection->pcb = pcb;
+	connection->length = 0U;
+
+	tcp_arg(pcb, connection);
+	tcp_recv(pcb, ModbusServerReceive);
+	tcp_err(pcb, ModbusServerError);
+#ifdef MODBUS_SERVER_DEBUG
+	printf("[Modbus Server] An incoming connection was accepted.\n\r");
+#endif
+	return ERR_OK;
+}
+
+/**
+ * @internal
+ * This function is called when the lwIP TCP/IP stack has an incoming packet for a Modbus connection. The bytes are
+ * gathered into the connection's request buffer and each complete request is answered. A packet is refused while
+ * the send buffer could not take a full response, lwIP passes it in again later. A packet which is not a Modbus TCP
+ * frame aborts the connection, as the frame boundaries can not be recovered. A NULL packet indicates the client has
+ * closed the connection.
+ *
+ * @param arg void* Argument pointer passed to the handler by the lwIP stack.
+ * @param pcb tcp_pcb* struct The PCB structure this callback is for.
+ * @param p pbuf* struct The data buffer from the lwIP stack.
+ * @param err lwIP err_t with the current error status.
+ * @retval err lwIP err_t with the result of the this function.
+ */
+static err_t ModbusServerReceive(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err) {
+	ModbusConnection_t* connection = (ModbusConnection_t*) arg;
+	if (p == NULL) {
+		if (err == ERR_OK) {
+			ModbusServerClose(connection);
+		}
+		return ERR_OK;
+	}
+	if (tcp_sndbuf(pcb) < MODBUS_MAX_FRAME_SIZE) {
+		return ERR_MEM;
+	}
+	tcp_recved(pcb, p->tot_len);
+	for (struct pbuf* q = p; q != NULL; q = q->next) {
+		const uint8_t* data = (const uint8_t*) q->payload;
+		uint16_t remaining = q->len;
+		while (remaining > 0U) {
+			/* Gather the header first, it gives the size of the rest of the frame */
+			uint16_t needed = MBAP_HEADER_SIZE;
+			if (connection->length >= MBAP_HEADER_SIZE) {
+				uint16_t length = ModbusGetUint16(&connection->request[4]);
+				if ((ModbusGetUint16(&connection->request[2]) != 0U) || (length < MBAP_MIN_LENGTH)
+						|| (length > MBAP_MAX_LENGTH)) {
+#ifdef MODBUS_SERVER_DEBUG
+					printf("[Modbus Server] Received a malformed frame, aborting the connection.\n\r");
+#endif
+					pbuf_free(p);
+					connection->pcb = NULL;
+					tcp_abort(pcb);
+					return ERR_ABRT;
+				}
+				needed = MBAP_HEADER_SIZE + length - 1U;
+			}
+			uint16_t count = needed - connection->length;
+			if (count > remaining) {
+				count = remaining;
+			}
+			memcpy(&connection->request[connection->length], data, count);
+			connection->length += count;
+			data += count;
+			remaining -= count;
+			if ((connection->length == needed) && (needed > MBAP_HEADER_SIZE)) {
+				ModbusServerAnswer(connection);
+				connection->length = 0U;
+			}
+		}
+	}
+	pbuf_free(p);
+	tcp_output(pcb);
+	return ERR_OK;
+}
+
+/**
+ * @internal
+ * This function is called when a fatal error has occurred on a Modbus connection. The PCB has already been freed
+ * by lwIP.
+ *
+ * @param arg void* Argument pointer passed to the handler by the lwIP stack.
+ * @param err lwIP err_t with the error which occurred.
+ * @retval none
+ */
+static void ModbusServerError(void *arg, err_t err) {
+	LWIP_UNUSED_ARG(err);
+#ifdef MODBUS_SERVER_DEBUG
+	printf("[Modbus Server] Modbus server error received: %i\n\r", err);
+#endif
+	ModbusConnection_t* connection = (ModbusConnection_t*) arg;
+	if (connection != NULL) {
+		connection->pcb = NULL;
+		connection->length = 0U;
+	}
+}
+
+/**
+ * @internal
+ * Closes a Modbus client connection, freeing its slot.
+ *
+ * @param connection ModbusConnection_t* Pointer to the connection to close.
+ * @retval none
+ */
+static void ModbusServerClose(ModbusConnection_t* connection) {
+	struct tcp_pcb *pcb = connection->pcb;
+	if (pcb != NULL) {
+		/* Remove all callbacks */
+		tcp_arg(pcb, NULL );
+		tcp_recv(pcb, NULL );
+		tcp_err(pcb, NULL );
+		connection->pcb = NULL;
+		if (tcp_close(pcb) != ERR_OK) {
+			tcp_abort(pcb);
+		}
+	}
+	connection->length = 0U;
+}
+
+/**
+ * @internal
+ * Builds the response PDU to a request PDU. Requests which can not be carried out are answered with an exception
+ * response.
+ *
+ * @param request const uint8_t* Pointer to the request PDU, starting with the function code.
+ * @param length uint16_t The length of the request PDU.
+ * @param pdu uint8_t* Pointer to the buffer to build the response PDU in.
+ * @retval uint16_t The length of the response PDU.
+ */
+static uint16_t ModbusServerProcessPDU(const uint8_t* request, uint16_t length, uint8_t* pdu) {
+	uint8_t function = request[0];
+	ModbusException_t exception = MODBUS_EXCEPTION_ILLEGAL_FUNCTION;
+	uint16_t size = 0U;
+	pdu[0] = function;
+	if (modbusMap != NULL) {
+		uint16_t address = (length >= 3U) ? ModbusGetUint16(&request[1]) : 0U;
+		uint16_t quantity = (length >= 5U) ? ModbusGetUint16(&request[3]) : 0U;
+		switch (function) {
+		case MODBUS_FC_READ_COILS:
+		case MODBUS_FC_READ_DISCRETE_INPUTS: {
+			ModbusReadBitsFunction read =
+					(function == MODBUS_FC_READ_COILS) ? modbusMap->readCoils : modbusMap->readDiscreteInputs;
+			if (read == NULL) {
+				break;
+			}
+			if ((length != 5U) || (quantity == 0U) || (quantity > MODBUS_MAX_READ_BITS)) {
+				exception = MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+			} else if (((uint32_t) address + quantity) > 0x10000U) {
+				exception = MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+			} else {
+				uint8_t bytes = (quantity + 7U) / 8U;
+				memset(&pdu[2], 0, bytes);
+				exception = read(address, quantity, &pdu[2]);
+				pdu[1] = bytes;
+				size = 2U + bytes;
+			}
+			break;
+		}
+		case MODBUS_FC_READ_HOLDING_REGISTERS:
+		case MODBUS_FC_READ_INPUT_REGISTERS: {
+			ModbusReadRegistersFunction read = (function == MODBUS_FC_READ_HOLDING_REGISTERS) ?
+					modbusMap->readHoldingRegisters : modbusMap->readInputRegisters;
+			if (read == NULL) {
+				break;
+			}
+			if ((length != 5U) || (quantity == 0U) || (quantity > MODBUS_MAX_READ_REGISTERS)) {
+				exception = MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+			} else if (((uint32_t) address + quantity) > 0x10000U) {
+				exception = MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+			} else {
+				uint16_t registers[MODBUS_MAX_READ_REGISTERS];
+				exception = read(address, quantity, registers);
+				for (uint_fast8_t i = 0; i < quantity; ++i) {
+					ModbusPutUint16(&pdu[2U + (2U * i)], registers[i]);
+				}
+				pdu[1] = 2U * quantity;
+				size = 2U + (2U * quantity);
+			}
+			break;
+		}
+		case MODBUS_FC_WRITE_SINGLE_COIL: {
+			if (modbusMap->writeCoils == NULL) {
+				break;
+			}
+			/* The value field takes the place of the quantity */
+			if ((length != 5U) || ((quantity != MODBUS_COIL_ON) && (quantity != MODBUS_COIL_OFF))) {
+				exception = MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+			} else {
+				uint8_t bit = (quantity == MODBUS_COIL_ON) ? 0x01U : 0x00U;
+				exception = modbusMap->writeCoils(address, 1U, &bit);
+				/* The response echoes the request */
+				memcpy(pdu, request, 5U);
+				size = 5U;
+			}
+			break;
+		}
+		case MODBUS_FC_WRITE_MULTIPLE_COILS: {
+			if (modbusMap->writeCoils == NULL) {
+				break;
+			}
+			if ((length < 6U) || (quantity == 0U) || (quantity > MODBUS_MAX_WRITE_BITS)
+					|| (request[5] != ((quantity + 7U) / 8U)) || (length != (6U + request[5]))) {
+				exception = MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+			} else if (((uint32_t) address + quantity) > 0x10000U) {
+				exception = MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+			} else {
+				exception = modbusMap->writeCoils(address, quantity, &request[6]);
+				memcpy(pdu, request, 5U);
+				size = 5U;
+			}
+			break;
+		}
+		default:
+			break;
+		}
+	}
+	if (exception != MODBUS_EXCEPTION_NONE) {
+		pdu[0] = function | MODBUS_EXCEPTION_FLAG;
+		pdu[1] = (uint8_t) exception;
+		size = 2U;
+	}
+	return size;
+}
+
+/**
+ * @internal
+ * Answers the complete request frame held by a connection. The transaction and unit ids are echoed, the Tekdaqc
+ * answers whichever unit it is addressed as. The response is copied into lwIP, so a response which does not fit
+ * the send buffer is dropped and left to the client's timeout.
+ *
+ * @param connection ModbusConnection_t* Pointer to the connection holding the request.
+ * @retval none
+ */
+static void ModbusServerAnswer(ModbusConnection_t* connection) {
+	uint16_t length = ModbusServerProcessPDU(&connection->request[MBAP_HEADER_SIZE],
+			connection->length - MBAP_HEADER_SIZE, &response[MBAP_HEADER_SIZE]);
+	memcpy(response, connection->request, 4U);
+	ModbusPutUint16(&response[4], length + 1U);
+	response[6] = connection->request[6];
+	++requestCount;
+	if (tcp_write(connection->pcb, response, MBAP_HEADER_SIZE + length, TCP_WRITE_FLAG_COPY) != ERR_OK) {
+#ifdef MODBUS_SERVER_DEBUG
+		printf("[Modbus Server] Unable to queue a response.\n\r");
+#endif
+	}
+}
+
+/**
+ * @internal
+ * Reads a big endian 16 bit value, the byte order of every Modbus field.
+ *
+ * @param data const uint8_t* Pointer to the value.
+ * @retval uint16_t The value.
+ */
+static uint16_t ModbusGetUint16(const uint8_t* data) {
+	return (uint16_t) ((data[0] << 8) | data[1]);
+}
+
+/**
+ * @internal
+ * Writes a big endian 16 bit value, the byte order of every Modbus field.
+ *
+ * @param data uint8_t* Pointer to the location to write.
+ * @param value uint16_t The value to write.
+ * @retval none
+ */
+static void ModbusPutUint16(uint8_t* data, uint16_t value) {
+	data[0] = (uint8_t) (value >> 8);
+	data[1] = (uint8_t) value;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Creates the TCP listener for the Modbus server on MODBUS_PORT.
+ *
+ * @param map const ModbusMap_t* Pointer to the data to serve. It must remain valid while the server runs.
+ * @retval ModbusServerStatus_t The result of the initialization.
+ */
+ModbusServerStatus_t InitializeModbusServer(const ModbusMap_t* map) {
+	modbusMap = map;
+	for (uint_fast8_t i = 0; i < MODBUS_MAX_CONNECTIONS; ++i) {
+		connections[i].pcb = NULL;
+		connections[i].length = 0U;
+	}
+	modbus_pcb = tcp_new();
+	if (modbus_pcb != NULL ) {
+		if (tcp_bind(modbus_pcb, IP_ADDR_ANY, MODBUS_PORT) == ERR_OK) {
+			modbus_pcb = tcp_listen(modbus_pcb);
+#ifdef MODBUS_SERVER_DEBUG
+			printf("[Modbus Server] Now listening for incoming connections on port %i\n\r", MODBUS_PORT);
+#endif
+			tcp_accept(modbus_pcb, ModbusServerAccept);
+			return MODBUS_SERVER_OK;
+		} else {
+			/* Deallocate the pcb */
+			memp_free(MEMP_TCP_PCB, modbus_pcb);
+#ifdef MODBUS_SERVER_DEBUG
+			printf("[Modbus Server] Can not bind pcb\n\r");
+#endif
+			return MODBUS_SERVER_ERR_BIND;
+		}
+	} else {
+#ifdef MODBUS_SERVER_DEBUG
+		printf("[Modbus Server] Can not create new TCP port.\n\r");
+#endif
+		return MODBUS_SERVER_ERR_PCBCREATE;
+	}
+}
+
+/**
+ * Closes every Modbus client connection.
+ *
+ * @param none
+ * @retval none
+ */
+void ModbusServerCloseAll(void) {
+	for (uint_fast8_t i = 0; i < MODBUS_MAX_CONNECTIONS; ++i) {
+		ModbusServerClose(&connections[i]);
+	}
+}
+
+/**
+ * Retrieves the number of requests the Modbus server has answered since start up, exception responses included.
+ *
+ * @param none
+ * @retval uint32_t The number of requests answered.
+ */
+uint32_t ModbusServerGetRequestCount(void) {
+	return requestCount;
+}
@@ -0,0 +1,328 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file RawStream.c
+ * @brief Streams sample data in raw Ethernet frames, bypassing the TCP/IP stack.
+ *
+ * For a dedicated point to point acquisition link the IP, UDP or TCP headers and the lwIP code path only cost
+ * throughput. The raw stream instead appends the sample records, encoded once by the input writers, to a full size
+ * Ethernet frame with the RAW_STREAM_ETHERTYPE, and hands each frame to the Ethernet DMA in place when it is full or
+ * once it has waited for the stream latency. Nothing is retransmitted: each frame carries a sequence number so the
+ * host can tell a frame was lost. While every frame buffer is still being transmitted a write returns WRITE_BUSY, so
+ * the sampling is held back to the rate of the wire rather than dropping data on the board.
+ *
+ * Each frame is laid out as follows (multi-byte fields past the Ethernet header little endian):
+ *
+ * Byte        Description
+ * --------    ------------------------
+ * 0..5        Destination MAC address
+ * 6..11       Source MAC address, the board's
+ * 12..13      RAW_STREAM_ETHERTYPE, big endian as are all EtherTypes
+ * 14..17      Sequence number
+ * 18..19      Length of the sample records, the MAC pads short frames
+ * 20..        Sample records, in the current data format
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "RawStream.h"
+#include "Tekdaqc_Timers.h"
+#include "ethernetif.h"
+#include "lwip/netif.h"
+#include <string.h>
+#include <stdio.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def RAW_STREAM_RECORD_SEPARATOR
+ * @brief The record separator which terminates sample records on the Telnet connection.
+ */
+#define RAW_STREAM_RECORD_SEPARATOR	'\x1E'
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief A single streamed frame. Kept word aligned for the DMA.
+ */
+typedef struct {
+	uint8_t data[RAW_STREAM_FRAME_SIZE] __attribute__ ((aligned (4))); /**< The frame, starting with its headers. */
+	uint16_t length; /**< The number of valid bytes in the frame, including the headers. */
+} RawStreamFrame_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The network interface, whose address the frames are sent from */
+extern struct netif gnetif;
+
+/* The frame currently being filled, followed by those being transmitted. In SRAM, where the DMA can reach them. */
+static RawStreamFrame_t frames[RAW_STREAM_FRAME_COUNT];
+
+/* The index of the frame currently being filled */
+static uint8_t currentFrame = 0U;
+
+/* The destination of streamed frames */
+static uint8_t streamAddress[RAW_STREAM_ADDRESS_LENGTH];
+
+/* Indicates if samples are being streamed */
+static bool isStreaming = false;
+
+/* Indicates the current frame is full, or due, and waiting for a descriptor */
+static bool framePending = false;
+
+/* The sequence number of the next frame */
+static uint32_t nextSequence = 0U;
+
+/* The local time at which the first record was added to the current frame */
+static uint64_t frameStarted = 0U;
+
+/* The time in microseconds a partial frame may wait for more samples */
+static uint32_t streamLatency = RAW_STREAM_LATENCY_DEFAULT_US;
+
+/* The number of bytes of frames sent since start up */
+static uint32_t bytesSent = 0U;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Hands the current frame to the DMA and starts the next one.
+ */
+static bool SendCurrentFrame(void);
+
+/**
+ * @internal
+ * @brief Starts the current frame, holding only its headers.
+ */
+static bool StartFrame(void);
+
+/**
+ * @internal
+ * @brief Adds a block of data to the current frame.
+ */
+static WriteStatus_t AppendRecord(const uint8_t* data, uint16_t length);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * Fills in the record length of the current frame and hands it to the DMA, then starts the next frame in the
+ * following buffer. A frame which can not be handed over for want of a descriptor is left pending.
+ *
+ * @param none
+ * @retval bool TRUE if the frame was sent and the next one started.
+ */
+static bool SendCurrentFrame(void) {
+	RawStreamFrame_t* frame = &frames[currentFrame];
+	const uint16_t records = frame->length - RAW_STREAM_HEADER_SIZE;
+	frame->data[18] = (uint8_t) records;
+	frame->data[19] = (uint8_t) (records >> 8U);
+	framePending = true;
+	if (ethernetif_output_raw(frame->data, frame->length) != ERR_OK) {
+		return false;
+	}
+	framePending = false;
+	bytesSent += frame->length;
+	++nextSequence;
+	currentFrame = (currentFrame + 1U) % RAW_STREAM_FRAME_COUNT;
+	/* If the next buffer is still being transmitted it is started when the next record arrives */
+	StartFrame();
+	return true;
+}
+
+/**
+ * @internal
+ * Starts the current frame with its Ethernet header and the next sequence number, once the DMA is done with its
+ * buffer.
+ *
+ * @param none
+ * @retval bool TRUE if the frame was started, FALSE if its buffer is still being transmitted.
+ */
+static bool StartFrame(void) {
+	RawStreamFrame_t* frame = &frames[currentFrame];
+	frame->length = 0U;
+	if (ethernetif_raw_frame_busy(frame->data) != 0U) {
+		return false;
+	}
+	memcpy(&frame->data[0], streamAddress, RAW_STREAM_ADDRESS_LENGTH);
+	memcpy(&frame->data[6], gnetif.hwaddr, RAW_STREAM_ADDRESS_LENGTH);
+	frame->data[12] = (uint8_t) (RAW_STREAM_ETHERTYPE >> 8U);
+	frame->data[13] = (uint8_t) RAW_STREAM_ETHERTYPE;
+	frame->data[14] = (uint8_t) nextSequence;
+	frame->data[15] = (uint8_t) (nextSequence >> 8U);
+	frame->data[16] = (uint8_t) (nextSequence >> 16U);
+	frame->data[17] = (uint8_t) (nextSequence >> 24U);
+	frame->length = RAW_STREAM_HEADER_SIZE;
+	return true;
+}
+
+/**
+ * @internal
+ * Adds a block of data to the current frame, first sending the frame if the data does not fit in it. A record is
+ * never split across frames. While the frame can not be sent, or the next one started, the write is to be retried.
+ *
+ * @param data const uint8_t* Pointer to the data to add.
+ * @param length uint16_t The number of bytes to add.
+ * @retval WriteStatus_t The result of the write.
+ */
+static WriteStatus_t AppendRecord(const uint8_t* data, uint16_t length) {
+	if (isStreaming == false) {
+		return WRITE_NOT_CONNECTED;
+	}
+	if (length > (RAW_STREAM_FRAME_SIZE - RAW_STREAM_HEADER_SIZE)) {
+		return WRITE_TOO_LARGE;
+	}
+	RawStreamFrame_t* frame = &frames[currentFrame];
+	if ((framePending == true) || ((RAW_STREAM_FRAME_SIZE - frame->length) < length)) {
+		if (SendCurrentFrame() == false) {
+			return WRITE_BUSY;
+		}
+		frame = &frames[currentFrame];
+	}
+	if ((frame->length == 0U) && (StartFrame() == false)) {
+		return WRITE_BUSY;
+	}
+	if (frame->length == RAW_STREAM_HEADER_SIZE) {
+		frameStarted = GetLocalTime();
+	}
+	memcpy(&frame->data[frame->length], data, length);
+	frame->length += length;
+	return WRITE_OK;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Starts streaming sample data to the provided MAC address, which may be a unicast, multicast or the broadcast
+ * address. The sequence numbers continue from the previous session so the host never sees them repeat.
+ *
+ * @param address const uint8_t* Pointer to the RAW_STREAM_ADDRESS_LENGTH bytes of the destination address.
+ * @retval none
+ */
+void RawStreamStart(const uint8_t* address) {
+	memcpy(streamAddress, address, RAW_STREAM_ADDRESS_LENGTH);
+	framePending = false;
+	StartFrame();
+	isStreaming = true;
+#ifdef RAW_STREAM_DEBUG
+	printf("[Raw Stream] Streaming samples to %02X:%02X:%02X:%02X:%02X:%02X.\n\r", address[0], address[1], address[2],
+			address[3], address[4], address[5]);
+#endif
+}
+
+/**
+ * Stops streaming sample data. Any samples in the current frame are sent first, if a descriptor is free for it.
+ *
+ * @param none
+ * @retval none
+ */
+void RawStreamStop(void) {
+	if (isStreaming == true) {
+		if (frames[currentFrame].length > RAW_STREAM_HEADER_SIZE) {
+			SendCurrentFrame();
+		}
+		isStreaming = false;
+	}
+}
+
+/**
+ * Indicates if sample data is currently being streamed.
+ *
+ * @param none
+ * @retval bool TRUE if samples are being streamed.
+ */
+bool RawStreamIsActive(void) {
+	return isStreaming;
+}
+
+/**
+ * Called from the main loop to send the current frame once its oldest record has waited for the stream latency,
+ * or to retry a frame left pending for want of a descriptor.
+ *
+ * @param none
+ * @retval none
+ */
+void RawStreamService(void) {
+	if ((isStreaming == true) && (frames[currentFrame].length > RAW_STREAM_HEADER_SIZE)
+			&& ((framePending == true) || ((GetLocalTime() - frameStarted) >= streamLatency))) {
+		SendCurrentFrame();
+	}
+}
+
+/**
+ * Sets the time a partial frame may wait for more samples before it is sent.
+ *
+ * @param latency uint32_t The stream latency in microseconds.
+ * @retval none
+ */
+void RawStreamSetLatency(uint32_t latency) {
+	streamLatency = latency;
+}
+
+/**
+ * Retrieves the number of bytes of frames streamed since start up, headers included. The count wraps, so the rate
+ * is found from the difference of two counts.
+ *
+ * @param none
+ * @retval uint32_t The number of bytes sent.
+ */
+uint32_t RawStreamGetBytesSent(void) {
+	return bytesSent;
+}
+
+/**
+ * Adds a sample record string to the current frame. The record separator which terminates records on the Telnet
+ * connection is dropped, since each record is delimited by its line endings.
+ *
+ * @param string char* Pointer to a C-String to write.
+ * @retval WriteStatus_t The result of the write.
+ */
+WriteStatus_t RawStreamWriteString(char* string) {
+	uint16_t length = strlen(string);
+	if ((length > 0U) && (string[length - 1U] == RAW_STREAM_RECORD_SEPARATOR)) {
+		--length;
+	}
+	return AppendRecord((const uint8_t*) string, length);
+}
+
+/**
+ * Adds a block of binary sample data to the current frame.
+ *
+ * @param data const uint8_t* Pointer to the data to write.
+ * @param length uint16_t The number of bytes to write.
+ * @retval WriteStatus_t The result of the write.
+ */
+WriteStatus_t RawStreamWriteBinary(const uint8_t* data, uint16_t length) {
+	return AppendRecord(data, length);
+}
@@ -0,0 +1,486 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file SNTPClient.c
+ * @brief Synchronizes the time base of the Tekdaqc with a time server.
+ *
+ * Queries a unicast SNTP (RFC 4330) time server and disciplines the mapping of local time to epoch time kept by the
+ * timers. The first response steps the mapping. Later ones slew the error out over the next poll interval and adjust
+ * the frequency correction by a fraction of what remains, so epoch time stamps stay continuous while the board's
+ * oscillator is tracked. The local time itself is never changed.
+ *
+ * The transmit time stamp of each request holds the local time it was sent at, which the server echoes as the
+ * originate time stamp so a response can be matched with its request without keeping any other state.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "SNTPClient.h"
+#include "Tekdaqc_BSP.h"
+#include "Tekdaqc_Timers.h"
+#include "lwip/udp.h"
+#include "eeprom.h"
+#include <string.h>
+#include <stdio.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def SNTP_PACKET_LENGTH
+ * @brief The length of an SNTP message without the optional authenticator.
+ */
+#define SNTP_PACKET_LENGTH		48U
+
+/**
+ * @internal
+ * @def SNTP_REQUEST_HEADER
+ * @brief The first byte of a request: no leap indicator, version 4 and client mode.
+ */
+#define SNTP_REQUEST_HEADER		((uint8_t) 0x23)
+
+/**
+ * @internal
+ * @def SNTP_MODE_SERVER
+ * @brief The mode of a response from a server.
+ */
+#define SNTP_MODE_SERVER		4U
+
+/**
+ * @internal
+ * @def SNTP_LEAP_ALARM
+ * @brief The leap indicator of a server which is not synchronized itself.
+ */
+#define SNTP_LEAP_ALARM			3U
+
+/**
+ * @internal
+ * @def SNTP_UNIX_OFFSET
+ * @brief The number of seconds from the NTP epoch, 1900-01-01, to the Unix epoch, 1970-01-01.
+ */
+#define SNTP_UNIX_OFFSET		2208988800UL
+
+/**
+ * @internal
+ * @def SNTP_MAX_DELAY_US
+ * @brief The longest round trip delay of a response which is used. Longer ones say little about the offset.
+ */
+#define SNTP_MAX_DELAY_US		100000LL
+
+/**
+ * @internal
+ * @def SNTP_STEP_THRESHOLD_US
+ * @brief The error of the time base beyond which the mapping is stepped instead of slewed.
+ */
+#define SNTP_STEP_THRESHOLD_US	128000LL
+
+/**
+ * @internal
+ * @def SNTP_FREQUENCY_GAIN
+ * @brief The fraction of the frequency error found by a response which is corrected, as its reciprocal.
+ */
+#define SNTP_FREQUENCY_GAIN		4LL
+
+/**
+ * @internal
+ * @def SNTP_MAX_DRIFT_PPB
+ * @brief The largest frequency correction of the time base, in parts per billion.
+ */
+#define SNTP_MAX_DRIFT_PPB		500000LL
+
+/**
+ * @internal
+ * @def SNTP_SERVER_MARKER
+ * @brief The value of the marker word of a saved time server.
+ */
+#define SNTP_SERVER_MARKER		((uint16_t) 0x7135)
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The UDP port used to query the time server */
+static struct udp_pcb* sntp_pcb = NULL;
+
+/* The time server, or any if not synchronizing */
+static ip_addr_t serverAddress;
+
+/* The local time the last request was sent at, 0 if one is due at once */
+static uint64_t requestTime = 0U;
+
+/* Indicates if a response to the last request is still expected */
+static bool requestPending = false;
+
+/* The frequency correction of the time base in parts per billion, without the slew */
+static int32_t frequency = 0;
+
+/* The local time of the last update of the mapping */
+static uint64_t lastUpdate = 0U;
+
+/* The state of the synchronization */
+static SNTPClientStatus_t clientStatus;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Callback function to process responses received from the time server.
+ */
+static void SNTPClientReceive(void *arg, struct udp_pcb *pcb, struct pbuf *p, struct ip_addr *addr, uint16_t port);
+
+/**
+ * @internal
+ * @brief Sends a request to the time server.
+ */
+static void SNTPClientSendRequest(void);
+
+/**
+ * @internal
+ * @brief Disciplines the mapping of local time to epoch time with a measured offset.
+ */
+static void SNTPClientDiscipline(uint64_t local, int64_t offset);
+
+/**
+ * @internal
+ * @brief Limits a frequency correction to SNTP_MAX_DRIFT_PPB.
+ */
+static int32_t SNTPClientClampDrift(int64_t drift);
+
+/**
+ * @internal
+ * @brief Converts an NTP time stamp to epoch time.
+ */
+static uint64_t SNTPClientToEpoch(const uint8_t* data);
+
+/**
+ * @internal
+ * @brief Reads a big endian 32 bit word.
+ */
+static uint32_t SNTPClientReadWord(const uint8_t* data);
+
+/**
+ * @internal
+ * @brief Writes a word of the saved time server, unless it already holds the value.
+ */
+static bool SNTPClientSaveWord(uint16_t address, uint16_t value);
+
+/**
+ * @internal
+ * @brief Reads a word of the saved time server.
+ */
+static uint16_t SNTPClientLoadWord(uint16_t address);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * This function is called by the lwIP TCP/IP stack when it receives a UDP packet on the SNTP client port. A response
+ * from the time server to the last request is used to discipline the time base. A response from a server which is
+ * not synchronized itself, or which took too long to arrive, is ignored.
+ *
+ * @param arg void* Argument pointer passed to the handler by the lwIP stack.
+ * @param pcb udp_pcb* struct The PCB structure this callback is for.
+ * @param p pbuf* struct The data buffer from the lwIP stack.
+ * @param addr ip_addr* struct The IP address of the source of the UDP packet.
+ * @param port uint16_t The port number the packet was sent from.
+ * @retval none
+ */
+static void SNTPClientReceive(void *arg, struct udp_pcb *pcb, struct pbuf *p, struct ip_addr *addr, uint16_t port) {
+	LWIP_UNUSED_ARG(arg);
+	LWIP_UNUSED_ARG(pcb);
+	/* Take the arrival time before anything else */
+	const uint64_t received = GetLocalTime();
+	uint8_t data[SNTP_PACKET_LENGTH];
+	const bool valid = (requestPending == true) && (port == SNTP_PORT) && ip_addr_cmp(addr, &serverAddress)
+			&& (pbuf_copy_partial(p, data, SNTP_PACKET_LENGTH, 0U) == SNTP_PACKET_LENGTH);
+	pbuf_free(p);
+	if (valid == false) {
+		return;
+	}
+	const uint64_t originate = (((uint64_t) SNTPClientReadWord(&data[24])) << 32) | SNTPClientReadWord(&data[28]);
+	if (((data[0] & 0x07U) != SNTP_MODE_SERVER) || ((data[0] >> 6) == SNTP_LEAP_ALARM) || (data[1] == 0U)
+			|| (data[1] > 15U) || (originate != requestTime)) {
+#ifdef SNTP_DEBUG
+		printf("[SNTP] Ignoring unexpected response, stratum %i.\n\r", data[1]);
+#endif
+		return;
+	}
+	requestPending = false;
+
+	/* The server's receive and transmit time stamps */
+	const uint64_t serverReceived = SNTPClientToEpoch(&data[32]);
+	const uint64_t serverSent = SNTPClientToEpoch(&data[40]);
+	int64_t delay = (int64_t) (received - requestTime) - (int64_t) (serverSent - serverReceived);
+	if (delay < 0) {
+		delay = 0;
+	}
+	if (delay > SNTP_MAX_DELAY_US) {
+#ifdef SNTP_DEBUG
+		printf("[SNTP] Ignoring response delayed %li us.\n\r", (long) delay);
+#endif
+		return;
+	}
+	const int64_t offset = ((int64_t) (serverReceived - requestTime) + (int64_t) (serverSent - received)) / 2;
+	clientStatus.delay = (uint32_t) delay;
+	SNTPClientDiscipline(received, offset);
+}
+
+/**
+ * @internal
+ * Sends a request to the time server, with the local time it is sent at as its transmit time stamp.
+ *
+ * @param none
+ * @retval none
+ */
+static void SNTPClientSendRequest(void) {
+	struct pbuf* p = pbuf_alloc(PBUF_TRANSPORT, SNTP_PACKET_LENGTH, PBUF_RAM);
+	if (p == NULL ) {
+#ifdef SNTP_DEBUG
+		printf("[SNTP] Could not allocate pbuf for request.\n\r");
+#endif
+		return;
+	}
+	uint8_t* data = p->payload;
+	memset(data, 0, SNTP_PACKET_LENGTH);
+	data[0] = SNTP_REQUEST_HEADER;
+	requestTime = GetLocalTime();
+	for (uint_fast8_t i = 0U; i < 8U; ++i) {
+		data[40U + i] = (uint8_t) (requestTime >> (56U - (8U * i)));
+	}
+	requestPending = true;
+	udp_sendto(sntp_pcb, p, &serverAddress, SNTP_PORT);
+	pbuf_free(p);
+}
+
+/**
+ * @internal
+ * Disciplines the mapping of local time to epoch time with the offset measured by a response. The mapping is stepped
+ * when there is none yet or its error is too large to slew out. Otherwise the mapping continues from its current
+ * offset, so epoch time stamps never jump, and the error is slewed out over the next poll interval. Whatever error
+ * the previous slew left behind is put down to the frequency of the oscillator.
+ *
+ * @param local uint64_t The local time the offset was measured at.
+ * @param offset int64_t The measured offset of epoch time from local time, in microseconds.
+ * @retval none
+ */
+static void SNTPClientDiscipline(uint64_t local, int64_t offset) {
+	const int64_t error = offset - ((int64_t) Timer_ToEpochTime(local) - (int64_t) local);
+	if ((Timer_IsEpochValid() == false) || (error > SNTP_STEP_THRESHOLD_US) || (error < -SNTP_STEP_THRESHOLD_US)) {
+#ifdef SNTP_DEBUG
+		printf("[SNTP] Stepping the time base.\n\r");
+#endif
+		frequency = 0;
+		Timer_SetEpochMapping(local, offset, 0);
+	} else {
+		const int64_t elapsed = (int64_t) (local - lastUpdate);
+		int64_t drift = frequency;
+		if (elapsed > 0) {
+			drift += (error * 1000000000LL) / (elapsed * SNTP_FREQUENCY_GAIN);
+		}
+		frequency = SNTPClientClampDrift(drift);
+		drift = frequency + ((error * 1000000000LL) / (int64_t) SNTP_POLL_INTERVAL_US);
+		Timer_SetEpochMapping(local, offset - error, SNTPClientClampDrift(drift));
+	}
+	lastUpdate = local;
+	clientStatus.synchronized = true;
+	++clientStatus.updates;
+	clientStatus.offset = (int32_t) error;
+	clientStatus.drift = frequency;
+#ifdef SNTP_DEBUG
+	printf("[SNTP] Error %li us, delay %lu us, frequency %li ppb.\n\r", (long) error,
+			(unsigned long) clientStatus.delay, (long) frequency);
+#endif
+}
+
+/**
+ * @internal
+ * Limits a frequency correction to SNTP_MAX_DRIFT_PPB either way, well beyond the tolerance of the oscillator, so
+ * a bad response can not run the time base away.
+ *
+ * @param drift int64_t The frequency correction in parts per billion.
+ * @retval int32_t The limited frequency correction.
+ */
+static int32_t SNTPClientClampDrift(int64_t drift) {
+	if (drift > SNTP_MAX_DRIFT_PPB) {
+		drift = SNTP_MAX_DRIFT_PPB;
+	} else if (drift < -SNTP_MAX_DRIFT_PPB) {
+		drift = -SNTP_MAX_DRIFT_PPB;
+	}
+	return (int32_t) drift;
+}
+
+/**
+ * @internal
+ * Converts an NTP time stamp, seconds since 1900 and a binary fraction, to microseconds since 1970. Seconds below
+ * the Unix epoch are taken to be in the era starting 2036.
+ *
+ * @param data const uint8_t* Pointer to the big endian time stamp.
+ * @retval uint64_t The epoch time in microseconds.
+ */
+static uint64_t SNTPClientToEpoch(const uint8_t* data) {
+	uint64_t seconds = SNTPClientReadWord(data);
+	if (seconds < SNTP_UNIX_OFFSET) {
+		seconds += 0x100000000ULL;
+	}
+	const uint64_t fraction = SNTPClientReadWord(&data[4]);
+	return ((seconds - SNTP_UNIX_OFFSET) * 1000000U) + ((fraction * 1000000U) >> 32);
+}
+
+/**
+ * @internal
+ * Reads a big endian 32 bit word.
+ *
+ * @param data const uint8_t* Pointer to the word.
+ * @retval uint32_t The value of the word.
+ */
+static uint32_t SNTPClientReadWord(const uint8_t* data) {
+	return (((uint32_t) data[0]) << 24U) | (((uint32_t) data[1]) << 16U) | (((uint32_t) data[2]) << 8U)
+			| ((uint32_t) data[3]);
+}
+
+/**
+ * @internal
+ * Writes a word of the saved time server. Words which already hold the value are not written again, sparing the
+ * FLASH.
+ *
+ * @param address uint16_t The virtual address of the word.
+ * @param value uint16_t The value to write.
+ * @retval bool TRUE if the word holds the value.
+ */
+static bool SNTPClientSaveWord(uint16_t address, uint16_t value) {
+	uint16_t current = 0U;
+	if ((EE_ReadVariable(address, &current) == 0U) && (current == value)) {
+		return TRUE;
+	}
+	return (EE_QueueWrite(address, value) == FLASH_COMPLETE) ? TRUE : FALSE;
+}
+
+/**
+ * @internal
+ * Reads a word of the saved time server.
+ *
+ * @param address uint16_t The virtual address of the word.
+ * @retval uint16_t The value of the word, 0 if it has never been written.
+ */
+static uint16_t SNTPClientLoadWord(uint16_t address) {
+	uint16_t value = 0U;
+	if (EE_ReadVariable(address, &value) != 0U) {
+		value = 0U;
+	}
+	return value;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Creates the UDP port used by the SNTP client and loads the saved time server. Nothing is sent until a time server
+ * has been set.
+ *
+ * @param none
+ * @retval none
+ */
+void SNTPClientInit(void) {
+	memset(&clientStatus, 0, sizeof(clientStatus));
+	ip_addr_set_zero(&serverAddress);
+	if (SNTPClientLoadWord(ADDR_TIME_SERVER_MARKER) == SNTP_SERVER_MARKER) {
+		ip4_addr_set_u32(&serverAddress, ((uint32_t) SNTPClientLoadWord(ADDR_TIME_SERVER_ADDRESS + 1U) << 16)
+				| SNTPClientLoadWord(ADDR_TIME_SERVER_ADDRESS));
+	}
+	sntp_pcb = udp_new();
+	if (sntp_pcb != NULL ) {
+		udp_recv(sntp_pcb, SNTPClientReceive, NULL);
+		udp_bind(sntp_pcb, IP_ADDR_ANY, 0U);
+	}
+#ifdef SNTP_DEBUG
+	printf("[SNTP] Time server %s.\n\r", ip_addr_isany(&serverAddress) ? "not set" : ipaddr_ntoa(&serverAddress));
+#endif
+}
+
+/**
+ * Sets the time server to synchronize with and saves it, so the board synchronizes from the next reset on as well.
+ * The new server is queried at once. Without a server the time base keeps running from its last mapping.
+ *
+ * @param server const ip_addr_t* Pointer to the address of the time server, NULL to stop synchronizing.
+ * @retval bool TRUE if the time server was saved.
+ */
+bool SNTPClientSetServer(const ip_addr_t* server) {
+	bool saved;
+	if (server == NULL) {
+		ip_addr_set_zero(&serverAddress);
+		saved = SNTPClientSaveWord(ADDR_TIME_SERVER_MARKER, 0U);
+	} else {
+		ip_addr_copy(serverAddress, *server);
+		const uint32_t value = ip4_addr_get_u32(server);
+		/* The marker is written last, so an interrupted save leaves no server */
+		saved = SNTPClientSaveWord(ADDR_TIME_SERVER_MARKER, 0U)
+				&& SNTPClientSaveWord(ADDR_TIME_SERVER_ADDRESS, (uint16_t) value)
+				&& SNTPClientSaveWord(ADDR_TIME_SERVER_ADDRESS + 1U, (uint16_t) (value >> 16))
+				&& SNTPClientSaveWord(ADDR_TIME_SERVER_MARKER, SNTP_SERVER_MARKER);
+	}
+	requestTime = 0U;
+	requestPending = false;
+	return saved;
+}
+
+/**
+ * Retrieves the time server being synchronized with.
+ *
+ * @param server ip_addr_t* Filled with the address of the time server.
+ * @retval bool TRUE if a time server is set.
+ */
+bool SNTPClientGetServer(ip_addr_t* server) {
+	ip_addr_copy(*server, serverAddress);
+	return ip_addr_isany(&serverAddress) ? FALSE : TRUE;
+}
+
+/**
+ * Retrieves the state of the synchronization with the time server.
+ *
+ * @param status SNTPClientStatus_t* Filled with the state of the synchronization.
+ * @retval none
+ */
+void SNTPClientGetStatus(SNTPClientStatus_t* status) {
+	*status = clientStatus;
+}
+
+/**
+ * Called from the main loop to query the time server once it is due: every SNTP_POLL_INTERVAL_US once synchronized
+ * and every SNTP_RETRY_INTERVAL_US until then.
+ *
+ * @param none
+ * @retval none
+ */
+void SNTPClientService(void) {
+	if ((sntp_pcb == NULL) || ip_addr_isany(&serverAddress)) {
+		return;
+	}
+	const uint64_t interval = (clientStatus.synchronized == true) ? SNTP_POLL_INTERVAL_US : SNTP_RETRY_INTERVAL_US;
+	if ((requestTime == 0U) || ((GetLocalTime() - requestTime) >= interval)) {
+		SNTPClientSendRequest();
+	}
+}
@@ -0,0 +1,402 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file SamplePublisher.c
+ * @brief Publishes sample data to any number of hosts over UDP.
+ *
+ * Publishes sample data as sequence numbered UDP datagrams to a configurable unicast or multicast destination.
+ * Samples are encoded once by the input writers and appended to the current batch, which is sent when it is full
+ * or once it has waited for the publish latency. The last PUBLISH_HISTORY_COUNT batches are kept, so a subscriber
+ * which notices a gap in the sequence numbers can ask for the missing batches to be sent to it again.
+ *
+ * Each datagram is laid out as follows (little endian):
+ *
+ * Byte        Description
+ * --------    ------------------------
+ * 0..3        Sequence number
+ * 4..         Sample records, in the current data format
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "SamplePublisher.h"
+#include "Tekdaqc_BSP.h"
+#include "Tekdaqc_Timers.h"
+#include "lwip/udp.h"
+#include "netconf.h"
+#include <string.h>
+#include <stdio.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def PUBLISH_RECORD_SEPARATOR
+ * @brief The record separator which terminates sample records on the Telnet connection.
+ */
+#define PUBLISH_RECORD_SEPARATOR	'\x1E'
+
+/**
+ * @internal
+ * @def PUBLISH_RESEND_REQUEST_LENGTH
+ * @brief The length of a resend request datagram.
+ */
+#define PUBLISH_RESEND_REQUEST_LENGTH	5U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief A single published batch.
+ */
+typedef struct {
+	uint8_t data[PUBLISH_BATCH_SIZE]; /**< The datagram, starting with its header. */
+	uint16_t length; /**< The number of valid bytes in the datagram, including the header. */
+	uint32_t sequence; /**< The sequence number of the batch. */
+} PublishBatch_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The UDP port used to publish */
+static struct udp_pcb* publish_pcb = NULL;
+
+/* The destination of published batches */
+static ip_addr_t publishAddress;
+
+/* The destination port of published batches */
+static uint16_t publishPort = PUBLISH_PORT;
+
+/* Indicates if samples are being published */
+static bool isPublishing = false;
+
+/* The batch currently being filled, followed by the most recently sent batches */
+static PublishBatch_t batches[PUBLISH_HISTORY_COUNT];
+
+/* The index of the batch currently being filled */
+static uint8_t currentBatch = 0U;
+
+/* The sequence number of the next batch */
+static uint32_t nextSequence = 0U;
+
+/* The local time at which the first record was added to the current batch */
+static uint64_t batchStarted = 0U;
+
+/* The time in microseconds a partial batch may wait for more samples */
+static uint32_t publishLatency = PUBLISH_LATENCY_DEFAULT_US;
+
+/* The number of bytes of batches sent since start up, including resent batches */
+static uint32_t bytesSent = 0U;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Callback function to process resend requests received on the publish port.
+ */
+static void SamplePublisherReceive(void *arg, struct udp_pcb *pcb, struct pbuf *p, struct ip_addr *addr, uint16_t port);
+
+/**
+ * @internal
+ * @brief Sends a batch from the history to the provided destination.
+ */
+static void SendBatch(const PublishBatch_t* batch, ip_addr_t* address, uint16_t port);
+
+/**
+ * @internal
+ * @brief Sends the current batch and starts the next one.
+ */
+static void PublishCurrentBatch(void);
+
+/**
+ * @internal
+ * @brief Resets the current batch to hold only its header.
+ */
+static void StartBatch(void);
+
+/**
+ * @internal
+ * @brief Adds a block of data to the current batch.
+ */
+static WriteStatus_t AppendRecord(const uint8_t* data, uint16_t length);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * This function is called by the lwIP TCP/IP stack when it receives a UDP packet on the publish port. A valid
+ * resend request is answered with the requested batch, sent only to the requester, if it is still in the history.
+ *
+ * @param arg void* Argument pointer passed to the handler by the lwIP stack.
+ * @param pcb udp_pcb* struct The PCB structure this callback is for.
+ * @param p pbuf* struct The data buffer from the lwIP stack.
+ * @param addr ip_addr* struct The IP address of the source of the UDP packet.
+ * @param port uint16_t The port number the packet was sent from.
+ * @retval none
+ */
+static void SamplePublisherReceive(void *arg, struct udp_pcb *pcb, struct pbuf *p, struct ip_addr *addr, uint16_t port) {
+	LWIP_UNUSED_ARG(arg);
+	LWIP_UNUSED_ARG(pcb);
+	uint8_t* data = p->payload;
+	if ((p->len == PUBLISH_RESEND_REQUEST_LENGTH) && (data[0] == PUBLISH_RESEND_REQUEST)) {
+		uint32_t sequence = ((uint32_t) data[1]) | (((uint32_t) data[2]) << 8U) | (((uint32_t) data[3]) << 16U)
+				| (((uint32_t) data[4]) << 24U);
+		for (uint_fast8_t i = 0; i < PUBLISH_HISTORY_COUNT; ++i) {
+			/* The batch being filled has not been sent yet, so it can not be requested */
+			if ((i != currentBatch) && (batches[i].length > PUBLISH_HEADER_SIZE) && (batches[i].sequence == sequence)) {
+#ifdef PUBLISHER_DEBUG
+				printf("[Publisher] Resending batch %lu.\n\r", (unsigned long) sequence);
+#endif
+				SendBatch(&batches[i], addr, port);
+				break;
+			}
+		}
+	}
+	pbuf_free(p);
+}
+
+/**
+ * @internal
+ * Sends a batch to the provided destination. The batch is referenced rather than copied, and the Ethernet driver
+ * transmits it in place. This is safe since a sent batch is kept in the history, unchanged, until
+ * PUBLISH_HISTORY_COUNT - 1 further batches have been sent, long after the DMA is done with it, and lwIP copies
+ * referenced data itself if it has to queue the frame for address resolution.
+ *
+ * @param batch const PublishBatch_t* Pointer to the batch to send.
+ * @param address ip_addr_t* Pointer to the destination address.
+ * @param port uint16_t The destination port.
+ * @retval none
+ */
+static void SendBatch(const PublishBatch_t* batch, ip_addr_t* address, uint16_t port) {
+	struct pbuf* p = pbuf_alloc(PBUF_TRANSPORT, batch->length, PBUF_REF);
+	if (p == NULL ) {
+#ifdef PUBLISHER_DEBUG
+		printf("[Publisher] Could not allocate pbuf for batch.\n\r");
+#endif
+		return;
+	}
+	p->payload = (void*) batch->data;
+	if (udp_sendto(publish_pcb, p, address, port) == ERR_OK) {
+		bytesSent += batch->length;
+	}
+	pbuf_free(p);
+}
+
+/**
+ * @internal
+ * Sends the current batch to the publish destination and starts the next one, which replaces the oldest batch in
+ * the history.
+ *
+ * @param none
+ * @retval none
+ */
+static void PublishCurrentBatch(void) {
+	if (batches[currentBatch].length > PUBLISH_HEADER_SIZE) {
+		SendBatch(&batches[currentBatch], &publishAddress, publishPort);
+		currentBatch = (currentBatch + 1U) % PUBLISH_HISTORY_COUNT;
+		StartBatch();
+	}
+}
+
+/**
+ * @internal
+ * Resets the current batch to hold only its header, assigning it the next sequence number.
+ *
+ * @param none
+ * @retval none
+ */
+static void StartBatch(void) {
+	PublishBatch_t* batch = &batches[currentBatch];
+	batch->sequence = nextSequence++;
+	batch->data[0] = (uint8_t) batch->sequence;
+	batch->data[1] = (uint8_t) (batch->sequence >> 8U);
+	batch->data[2] = (uint8_t) (batch->sequence >> 16U);
+	batch->data[3] = (uint8_t) (batch->sequence >> 24U);
+	batch->length = PUBLISH_HEADER_SIZE;
+}
+
+/**
+ * @internal
+ * Adds a block of data to the current batch, first sending the batch if the data does not fit in it. A record is
+ * never split across batches.
+ *
+ * @param data const uint8_t* Pointer to the data to add.
+ * @param length uint16_t The number of bytes to add.
+ * @retval WriteStatus_t The result of the write.
+ */
+static WriteStatus_t AppendRecord(const uint8_t* data, uint16_t length) {
+	if (isPublishing == false) {
+		return WRITE_NOT_CONNECTED;
+	}
+	if (length > (PUBLISH_BATCH_SIZE - PUBLISH_HEADER_SIZE)) {
+		return WRITE_TOO_LARGE;
+	}
+	if ((PUBLISH_BATCH_SIZE - batches[currentBatch].length) < length) {
+		PublishCurrentBatch();
+	}
+	PublishBatch_t* batch = &batches[currentBatch];
+	if (batch->length == PUBLISH_HEADER_SIZE) {
+		batchStarted = GetLocalTime();
+	}
+	memcpy(&batch->data[batch->length], data, length);
+	batch->length += length;
+	return WRITE_OK;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Creates the UDP port used by the sample publisher. Publishing does not begin until SamplePublisherStart() is
+ * called.
+ *
+ * @param none
+ * @retval none
+ */
+void SamplePublisherInit(void) {
+	for (uint_fast8_t i = 0; i < PUBLISH_HISTORY_COUNT; ++i) {
+		batches[i].length = 0U;
+	}
+	ip_addr_set_zero(&publishAddress);
+	publish_pcb = udp_new();
+	if (publish_pcb != NULL ) {
+		udp_recv(publish_pcb, SamplePublisherReceive, NULL);
+		udp_bind(publish_pcb, IP_ADDR_ANY, PUBLISH_PORT);
+	}
+}
+
+/**
+ * Starts publishing sample data to the provided destination, which may be a unicast or multicast address. The
+ * sequence numbers continue from the previous session so subscribers never see them repeat.
+ *
+ * @param address const ip_addr_t* Pointer to the destination address.
+ * @param port uint16_t The destination port.
+ * @retval none
+ */
+void SamplePublisherStart(const ip_addr_t* address, uint16_t port) {
+	if (publish_pcb == NULL ) {
+		return;
+	}
+	if (!ip_addr_cmp(&publishAddress, address)) {
+		LwIP_UnpinHost(&publishAddress);
+		ip_addr_copy(publishAddress, *address);
+	}
+	publishPort = port;
+	/* Keep a unicast destination's ARP entry resolved so no batch waits on, or is dropped by, address resolution */
+	LwIP_PinHost(&publishAddress);
+	StartBatch();
+	isPublishing = true;
+#ifdef PUBLISHER_DEBUG
+	printf("[Publisher] Publishing samples to port %i.\n\r", port);
+#endif
+}
+
+/**
+ * Stops publishing sample data. Any samples in the current batch are sent first.
+ *
+ * @param none
+ * @retval none
+ */
+void SamplePublisherStop(void) {
+	if (isPublishing == true) {
+		PublishCurrentBatch();
+		isPublishing = false;
+	}
+}
+
+/**
+ * Indicates if sample data is currently being published.
+ *
+ * @param none
+ * @retval bool TRUE if samples are being published.
+ */
+bool SamplePublisherIsActive(void) {
+	return isPublishing;
+}
+
+/**
+ * Called from the main loop to send the current batch once its oldest record has waited for the publish latency.
+ *
+ * @param none
+ * @retval none
+ */
+void SamplePublisherService(void) {
+	if ((isPublishing == true) && (batches[currentBatch].length > PUBLISH_HEADER_SIZE)
+			&& ((GetLocalTime() - batchStarted) >= publishLatency)) {
+		PublishCurrentBatch();
+	}
+}
+
+/**
+ * Sets the time a partial batch may wait for more samples before it is sent.
+ *
+ * @param latency uint32_t The publish latency in microseconds.
+ * @retval none
+ */
+void SamplePublisherSetLatency(uint32_t latency) {
+	publishLatency = latency;
+}
+
+/**
+ * Retrieves the number of bytes of batches published since start up, including batches resent on request. The count
+ * wraps, so the rate is found from the difference of two counts.
+ *
+ * @param none
+ * @retval uint32_t The number of bytes sent.
+ */
+uint32_t SamplePublisherGetBytesSent(void) {
+	return bytesSent;
+}
+
+/**
+ * Adds a sample record string to the current batch. The record separator which terminates records on the Telnet
+ * connection is dropped, since each record is delimited by its line endings.
+ *
+ * @param string char* Pointer to a C-String to write.
+ * @retval WriteStatus_t The result of the write.
+ */
+WriteStatus_t SamplePublisherWriteString(char* string) {
+	uint16_t length = strlen(string);
+	if ((length > 0U) && (string[length - 1U] == PUBLISH_RECORD_SEPARATOR)) {
+		--length;
+	}
+	return AppendRecord((const uint8_t*) string, length);
+}
+
+/**
+ * Adds a block of binary sample data to the current batch.
+ *
+ * @param data const uint8_t* Pointer to the data to write.
+ * @param length uint16_t The number of bytes to write.
+ * @retval WriteStatus_t The result of the write.
+ */
+WriteStatus_t SamplePublisherWriteBinary(const uint8_t* data, uint16_t length) {
+	return AppendRecord(data, length);
+}
@@ -47,6 +47,33 @@ static SetOutputFaultStatus SetFaultStatus = NULL;
 /* Local copy of the diagnosis registers of all TLE7232 chips */
 static uint16_t DiagnosisRegisters[NUMBER_TLE7232_CHIPS];
 
+/* The diagnosis registers as last reported to the fault status function */
+static uint16_t ReportedDiagnosis[NUMBER_TLE7232_CHIPS];
+
+/* Whether the diagnosis registers have been reported at least once */
+static bool DiagnosisReported = false;
+
+/* Set when a background diagnosis read found a change which has not yet been evaluated */
+static volatile bool DiagnosisPending = false;
+
+/* The period of the background diagnosis reads, 0 if disabled (us) */
+static uint32_t DiagnosisPeriod = TLE7232_DIAGNOSIS_PERIOD_US;
+
+/* The local time the last background diagnosis read was started */
+static uint64_t LastDiagnosis = 0U;
+
+/* Indicates that a DMA transfer is in progress. */
+static volatile bool DMA_Busy = false;
+
+/* Indicates that a blocking transfer owns the bus, so no DMA transfer may be started. */
+static volatile bool BusLocked = false;
+
+/* The command frames transmitted by a DMA transfer, indexed by chip index */
+static uint16_t DMA_TxBuffer[NUMBER_TLE7232_CHIPS];
+
+/* The diagnosis registers received by a DMA transfer, indexed by chip index */
+static uint16_t DMA_RxDiagnosis[NUMBER_TLE7232_CHIPS];
+
 
 
 /*--------------------------------------------------------------------------------------------------------*/
@@ -63,6 +90,31 @@ static void TLE7232_LowLevel_Init(void);
  */
 static void TLE7232_SPI_Init(void);
 
+/**
+ * @brief Initializes the DMA streams used for background diagnosis reads.
+ */
+static void TLE7232_DMA_Init(void);
+
+/**
+ * @brief Takes the bus for a blocking transfer, waiting out any DMA transfer in progress.
+ */
+static void TLE7232_AcquireBus(void);
+
+/**
+ * @brief Returns the bus to the DMA transfers after a blocking transfer.
+ */
+static void TLE7232_ReleaseBus(void);
+
+/**
+ * @brief Claims the DMA engine for a transfer if neither it nor the bus is in use.
+ */
+static bool TLE7232_ClaimTransfer_DMA(void);
+
+/**
+ * @brief Starts the claimed DMA transfer of the transmit buffer.
+ */
+static void TLE7232_StartTransfer_DMA(void);
+
 /**
  * @brief Evaluates the state of the diagnosis registers, looking for faults.
  */
@@ -152,13 +204,141 @@ static void TLE7232_SPI_Init(void) {
 
 	SPI_Init(TLE7232_SPI, &SPI_InitStructure);
 
+	/* Prepare the DMA streams for background diagnosis reads */
+	TLE7232_DMA_Init();
+
 	/* Enable the TLE7232 SPI  */
 	SPI_Cmd(TLE7232_SPI, ENABLE);
 }
 
+/**
+ * Initializes the DMA streams used for background diagnosis reads. Both streams move half words, matching the 16 bit
+ * frames of the drivers, and are left disabled until a read is started.
+ *
+ * @param none
+ * @retval none
+ */
+static void TLE7232_DMA_Init(void) {
+	DMA_InitTypeDef DMA_InitStructure;
+	NVIC_InitTypeDef NVIC_InitStructure;
+
+	/* Enable the DMA clock */
+	RCC_AHB1PeriphClockCmd(TLE7232_SPI_DMA_CLK, ENABLE);
+
+	DMA_DeInit(TLE7232_SPI_DMA_RX_STREAM);
+	DMA_DeInit(TLE7232_SPI_DMA_TX_STREAM);
+
+	DMA_InitStructure.DMA_Channel = TLE7232_SPI_DMA_CHANNEL;
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t) &(TLE7232_SPI->DR);
+	DMA_InitStructure.DMA_BufferSize = NUMBER_TLE7232_CHIPS;
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_Low;
+	DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+	DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+	DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+	DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+
+	/* SPI RX stream configuration */
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
+	DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t) DMA_RxDiagnosis;
+	DMA_Init(TLE7232_SPI_DMA_RX_STREAM, &DMA_InitStructure);
+
+	/* SPI TX stream configuration */
+	DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+	DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t) DMA_TxBuffer;
+	DMA_Init(TLE7232_SPI_DMA_TX_STREAM, &DMA_InitStructure);
+
+	/* Completion is signaled by the RX stream, since the last frame has been clocked in when it finishes */
+	DMA_ITConfig(TLE7232_SPI_DMA_RX_STREAM, DMA_IT_TC, ENABLE);
+
+	NVIC_InitStructure.NVIC_IRQChannel = TLE7232_SPI_DMA_RX_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = TLE7232_SPI_DMA_PREEMPT_PRIORITY;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+
+	DMA_Busy = false;
+}
+
+/**
+ * Takes the bus for a blocking transfer. Once the bus is locked no DMA transfer can be started, from the foreground
+ * or from an interrupt, and any which was already in progress is waited out. A DMA transfer is only a couple of
+ * frames long, so the wait is a few microseconds at most.
+ *
+ * @param none
+ * @retval none
+ */
+static void TLE7232_AcquireBus(void) {
+	BusLocked = true;
+	while (DMA_Busy == true) {
+		/* Wait for the DMA interrupt */
+	}
+}
+
+/**
+ * Returns the bus to the DMA transfers after a blocking transfer.
+ *
+ * @param none
+ * @retval none
+ */
+static void TLE7232_ReleaseBus(void) {
+	BusLocked = false;
+}
+
+/**
+ * Claims the DMA engine for a transfer. The check and the claim are made with interrupts masked, since transfers are
+ * started both from the foreground and from interrupts. The transmit buffer may only be loaded once claimed.
+ *
+ * @param none
+ * @retval bool TRUE if the DMA engine was claimed, FALSE if it or the bus is in use.
+ */
+static bool TLE7232_ClaimTransfer_DMA(void) {
+	bool claimed = false;
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if (DMA_Busy == false && BusLocked == false) {
+		DMA_Busy = true;
+		claimed = true;
+	}
+	__set_PRIMASK(primask);
+	return claimed;
+}
+
+/**
+ * Starts the claimed DMA transfer of the transmit buffer, one frame per chip. The frame is ended and the received
+ * diagnosis registers are picked up by TLE7232_SPI_DMA_IRQHandler().
+ *
+ * @param none
+ * @retval none
+ */
+static void TLE7232_StartTransfer_DMA(void) {
+	/* Drain any stale frame left in the receive register */
+	while (SPI_I2S_GetFlagStatus(TLE7232_SPI, SPI_I2S_FLAG_RXNE) == SET) {
+		SPI_I2S_ReceiveData(TLE7232_SPI);
+	}
+
+	DMA_ClearFlag(TLE7232_SPI_DMA_RX_STREAM, TLE7232_SPI_DMA_RX_FLAGS);
+	DMA_ClearFlag(TLE7232_SPI_DMA_TX_STREAM, TLE7232_SPI_DMA_TX_FLAGS);
+	DMA_SetCurrDataCounter(TLE7232_SPI_DMA_RX_STREAM, NUMBER_TLE7232_CHIPS);
+	DMA_SetCurrDataCounter(TLE7232_SPI_DMA_TX_STREAM, NUMBER_TLE7232_CHIPS);
+
+	/* Select the TLE7232: Chip Select Low */
+	TLE7232_CS_LOW();
+
+	/* Enable the receiver first so no frame can be missed, then start clocking with the transmitter */
+	DMA_Cmd(TLE7232_SPI_DMA_RX_STREAM, ENABLE);
+	DMA_Cmd(TLE7232_SPI_DMA_TX_STREAM, ENABLE);
+	SPI_I2S_DMACmd(TLE7232_SPI, SPI_I2S_DMAReq_Rx | SPI_I2S_DMAReq_Tx, ENABLE);
+}
+
 /**
  * Evaluates the contents of the local copy of the diagnosis registers, looking for any possible fault conditions.
- * If a fault is discovered, the function pointed to by SetFaultStatus will notified of the fault.
+ * Only the channels whose status differs from what was last reported are passed to the function pointed to by
+ * SetFaultStatus, except for the first evaluation, which reports every channel.
  *
  * @param none
  * @retval none
@@ -169,16 +349,20 @@ static void TLE7232_EvaluateDiagnosis(void) {
 			/* Check the status of this chip */
 			uint16_t mask = 0x0003;
 			uint16_t reg = 0x0000;
+			uint16_t changed = DiagnosisRegisters[i] ^ ReportedDiagnosis[i];
 			TLE7232_Status_t status;
 			for (uint16_t shift = 0; shift < 16; shift+=2) { /* The 16bit index is to match the data it operates on */
+				if (DiagnosisReported == true && (changed & (mask << shift)) == 0U) {
+					continue; /* This channel has not changed */
+				}
 				reg = DiagnosisRegisters[i] & (mask << shift); /* Isolate the channel's bits */
 				reg >>= shift; /* Move the bits to the least significant bits */
 				status = (TLE7232_Status_t) reg;
-				if (SetFaultStatus != NULL) {
-					SetFaultStatus(status, i, (shift/2)); /* Set the status on the output */
-				}
+				SetFaultStatus(status, i, (shift/2)); /* Set the status on the output */
 			}
+			ReportedDiagnosis[i] = DiagnosisRegisters[i];
 		}
+		DiagnosisReported = true;
 	}
 }
 
@@ -246,10 +430,13 @@ uint16_t TLE7232_ReadDiagnosis(uint8_t chip_index) {
 		/* TODO: Set an error. */
 		return 0;
 	}
+	/* Take the bus from the background transfers */
+	TLE7232_AcquireBus();
+
 	/* Select the TLE7232: Chip Select Low */
 	TLE7232_CS_LOW();
 
-	for (int i = 0; i < NUMBER_TLE7232_CHIPS; ++i) {
+	for (uint_fast8_t i = 0; i < NUMBER_TLE7232_CHIPS; ++i) {
 		SPI_I2S_SendData(TLE7232_SPI, TLE7232_CMD_DIAGNOSIS);
 		DiagnosisRegisters[i] = SPI_I2S_ReceiveData(TLE7232_SPI);
 	}
@@ -260,6 +447,7 @@ uint16_t TLE7232_ReadDiagnosis(uint8_t chip_index) {
 
 	/* De-select the TLE7232: Chip Select High */
 	TLE7232_CS_HIGH();
+	TLE7232_ReleaseBus();
 	TLE7232_EvaluateDiagnosis();
 	return DiagnosisRegisters[chip_index];
 }
@@ -272,10 +460,13 @@ uint16_t TLE7232_ReadDiagnosis(uint8_t chip_index) {
  * @retval none
  */
 void TLE7232_ReadAllDiagnosis(void) {
+	/* Take the bus from the background transfers */
+	TLE7232_AcquireBus();
+
 	/* Select the TLE7232: Chip Select Low */
 	TLE7232_CS_LOW();
 
-	for (int i = 0; i < NUMBER_TLE7232_CHIPS; ++i) {
+	for (uint_fast8_t i = 0; i < NUMBER_TLE7232_CHIPS; ++i) {
 		SPI_I2S_SendData(TLE7232_SPI, TLE7232_CMD_DIAGNOSIS);
 		/* Fetch the specific data */
 		DiagnosisRegisters[i] = SPI_I2S_ReceiveData(TLE7232_SPI);
@@ -287,6 +478,7 @@ void TLE7232_ReadAllDiagnosis(void) {
 
 	/* Deselect the TLE7232: Chip Select High */
 	TLE7232_CS_HIGH();
+	TLE7232_ReleaseBus();
 	TLE7232_EvaluateDiagnosis();
 }
 
@@ -323,10 +515,13 @@ void TLE7232_ResetRegisters(uint8_t chip_index) {
 		/*TODO: Set an error. */
 		return;
 	}
+	/* Take the bus from the background transfers */
+	TLE7232_AcquireBus();
+
 	/* Select the TLE7232: Chip Select Low */
 	TLE7232_CS_LOW();
 
-	for (int i = 0; i < NUMBER_TLE7232_CHIPS; ++i) {
+	for (uint_fast8_t i = 0; i < NUMBER_TLE7232_CHIPS; ++i) {
 		if (i == chip_index) {
 			/* Reset the specific chip */
 			SPI_I2S_SendData(TLE7232_SPI, TLE7232_CMD_RESET_REGISTERS);
@@ -342,6 +537,7 @@ void TLE7232_ResetRegisters(uint8_t chip_index) {
 
 	/* De-select the TLE7232: Chip Select High */
 	TLE7232_CS_HIGH();
+	TLE7232_ReleaseBus();
 	TLE7232_EvaluateDiagnosis();
 }
 
@@ -352,10 +548,13 @@ void TLE7232_ResetRegisters(uint8_t chip_index) {
  * @retval none
  */
 void TLE7232_ResetAllRegisters(void) {
+	/* Take the bus from the background transfers */
+	TLE7232_AcquireBus();
+
 	/* Select the TLE7232: Chip Select Low */
 	TLE7232_CS_LOW();
 
-	for (int i = 0; i < NUMBER_TLE7232_CHIPS; ++i) {
+	for (uint_fast8_t i = 0; i < NUMBER_TLE7232_CHIPS; ++i) {
 		printf("Resetting TLE7232 %i\n", i);
 		SPI_I2S_SendData(TLE7232_SPI, TLE7232_CMD_RESET_REGISTERS);
 		/* Fetch the specific data */
@@ -368,6 +567,7 @@ void TLE7232_ResetAllRegisters(void) {
 
 	/* De-select the TLE7232: Chip Select High */
 	TLE7232_CS_HIGH();
+	TLE7232_ReleaseBus();
 	TLE7232_EvaluateDiagnosis();
 }
 
@@ -381,10 +581,13 @@ void TLE7232_ResetAllRegisters(void) {
  */
 void TLE7232_WriteRegister(TLE7232_Register_t reg, uint8_t data, uint8_t chip_index) {
 	uint16_t command = TLE7232_CMD_WRITE_REGISTER | reg | data;
+	/* Take the bus from the background transfers */
+	TLE7232_AcquireBus();
+
 	/* Select the TLE7232: Chip Select Low */
 	TLE7232_CS_LOW();
 
-	for (int i = 0; i < NUMBER_TLE7232_CHIPS; ++i) {
+	for (uint_fast8_t i = 0; i < NUMBER_TLE7232_CHIPS; ++i) {
 		if (i == chip_index) {
 			/* Write the data to the specified chip. */
 			SPI_I2S_SendData(TLE7232_SPI, command);
@@ -401,6 +604,7 @@ void TLE7232_WriteRegister(TLE7232_Register_t reg, uint8_t data, uint8_t chip_in
 
 	/* Deselect the TLE7232: Chip Select High */
 	TLE7232_CS_HIGH();
+	TLE7232_ReleaseBus();
 	TLE7232_EvaluateDiagnosis();
 }
 
@@ -413,10 +617,13 @@ void TLE7232_WriteRegister(TLE7232_Register_t reg, uint8_t data, uint8_t chip_in
  */
 void TLE7232_WriteRegisterAll(TLE7232_Register_t reg, uint8_t data[NUMBER_TLE7232_CHIPS]) {
 	uint16_t command = 0;
+	/* Take the bus from the background transfers */
+	TLE7232_AcquireBus();
+
 	/* Select the TLE7232: Chip Select Low */
 	TLE7232_CS_LOW();
 
-	for (int i = 0; i < NUMBER_TLE7232_CHIPS; ++i) {
+	for (uint_fast8_t i = 0; i < NUMBER_TLE7232_CHIPS; ++i) {
 		/* Build the command word. */
 		command = TLE7232_CMD_WRITE_REGISTER | reg | data[i];
 		/* Write the data to the chip. */
@@ -431,6 +638,7 @@ void TLE7232_WriteRegisterAll(TLE7232_Register_t reg, uint8_t data[NUMBER_TLE723
 
 	/* De-select the TLE7232: Chip Select High */
 	TLE7232_CS_HIGH();
+	TLE7232_ReleaseBus();
 	TLE7232_EvaluateDiagnosis();
 }
 
@@ -443,10 +651,13 @@ void TLE7232_WriteRegisterAll(TLE7232_Register_t reg, uint8_t data[NUMBER_TLE723
  */
 void TLE7232_WriteArbitraryRegisterAll(TLE7232_Register_t reg[NUMBER_TLE7232_CHIPS], uint8_t data[NUMBER_TLE7232_CHIPS]) {
 	uint16_t command = 0;
+	/* Take the bus from the background transfers */
+	TLE7232_AcquireBus();
+
 	/* Select the TLE7232: Chip Select Low */
 	TLE7232_CS_LOW();
 
-	for (int i = 0; i < NUMBER_TLE7232_CHIPS; ++i) {
+	for (uint_fast8_t i = 0; i < NUMBER_TLE7232_CHIPS; ++i) {
 		/* Build the command word. */
 		command = TLE7232_CMD_WRITE_REGISTER | reg[i] | data[i];
 		/* Write the data to the chip. */
@@ -461,6 +672,7 @@ void TLE7232_WriteArbitraryRegisterAll(TLE7232_Register_t reg[NUMBER_TLE7232_CHI
 
 	/* Deselect the TLE7232: Chip Select High */
 	TLE7232_CS_HIGH();
+	TLE7232_ReleaseBus();
 	TLE7232_EvaluateDiagnosis();
 }
 
@@ -473,10 +685,13 @@ void TLE7232_WriteArbitraryRegisterAll(TLE7232_Register_t reg[NUMBER_TLE7232_CHI
  */
 uint8_t TLE7232_ReadRegister(TLE7232_Register_t reg, uint8_t chip_index) {
 	uint8_t retval;
+	/* Take the bus from the background transfers */
+	TLE7232_AcquireBus();
+
 	/* Select the TLE7232: Chip Select Low */
 	TLE7232_CS_LOW();
 
-	for (int i = 0; i < NUMBER_TLE7232_CHIPS; ++i) {
+	for (uint_fast8_t i = 0; i < NUMBER_TLE7232_CHIPS; ++i) {
 		if (i == chip_index) {
 			/* Write the data to the specified chip. */
 			SPI_I2S_SendData(TLE7232_SPI, TLE7232_CMD_READ_REGISTER | reg);
@@ -497,6 +712,7 @@ uint8_t TLE7232_ReadRegister(TLE7232_Register_t reg, uint8_t chip_index) {
 
 	/* De-select the TLE7232: Chip Select High */
 	TLE7232_CS_HIGH();
+	TLE7232_ReleaseBus();
 	TLE7232_EvaluateDiagnosis();
 	return retval;
 }
@@ -510,10 +726,13 @@ uint8_t TLE7232_ReadRegister(TLE7232_Register_t reg, uint8_t chip_index) {
  */
 void TLE7232_ReadRegisterAll(TLE7232_Register_t reg, uint8_t data[NUMBER_TLE7232_CHIPS]) {
 	uint16_t command = TLE7232_CMD_READ_REGISTER | reg;
+	/* Take the bus from the background transfers */
+	TLE7232_AcquireBus();
+
 	/* Select the TLE7232: Chip Select Low */
 	TLE7232_CS_LOW();
 
-	for (int i = 0; i < NUMBER_TLE7232_CHIPS; ++i) {
+	for (uint_fast8_t i = 0; i < NUMBER_TLE7232_CHIPS; ++i) {
 		/* Write the data to the specified chip. */
 		SPI_I2S_SendData(TLE7232_SPI, command);
 		/* Fetch the diagnosis data */
@@ -528,6 +747,7 @@ void TLE7232_ReadRegisterAll(TLE7232_Register_t reg, uint8_t data[NUMBER_TLE7232
 
 	/* De-select the TLE7232: Chip Select High */
 	TLE7232_CS_HIGH();
+	TLE7232_ReleaseBus();
 	TLE7232_EvaluateDiagnosis();
 }
 
@@ -539,10 +759,13 @@ void TLE7232_ReadRegisterAll(TLE7232_Register_t reg, uint8_t data[NUMBER_TLE7232
  * @retval none
  */
 void TLE7232_ReadArbitraryRegisterAll(TLE7232_Register_t reg[NUMBER_TLE7232_CHIPS], uint8_t data[NUMBER_TLE7232_CHIPS]) {
+	/* Take the bus from the background transfers */
+	TLE7232_AcquireBus();
+
 	/* Select the TLE7232: Chip Select Low */
 	TLE7232_CS_LOW();
 
-	for (int i = 0; i < NUMBER_TLE7232_CHIPS; ++i) {
+	for (uint_fast8_t i = 0; i < NUMBER_TLE7232_CHIPS; ++i) {
 		/* Write the data to the specified chip. */
 		SPI_I2S_SendData(TLE7232_SPI, TLE7232_CMD_READ_REGISTER | reg[i]);
 		/* Fetch the diagnosis data */
@@ -557,6 +780,7 @@ void TLE7232_ReadArbitraryRegisterAll(TLE7232_Register_t reg[NUMBER_TLE7232_CHIP
 
 	/* Deselect the TLE7232: Chip Select High */
 	TLE7232_CS_HIGH();
+	TLE7232_ReleaseBus();
 	TLE7232_EvaluateDiagnosis();
 }
 
@@ -569,3 +793,113 @@ void TLE7232_ReadArbitraryRegisterAll(TLE7232_Register_t reg[NUMBER_TLE7232_CHIP
 void SetOutputFaultStatusFunction(SetOutputFaultStatus func) {
 	SetFaultStatus = func;
 }
+
+/**
+ * Starts a read of the diagnosis registers of all TLE7232 drivers in the chain using the DMA engine and returns
+ * immediately. Its result is picked up by TLE7232_ServiceDiagnosis().
+ *
+ * @param none
+ * @retval bool TRUE if the read was started, FALSE if the bus is in use.
+ */
+bool TLE7232_StartDiagnosis_DMA(void) {
+	if (TLE7232_ClaimTransfer_DMA() == false) {
+		return false;
+	}
+	for (uint_fast8_t i = 0; i < NUMBER_TLE7232_CHIPS; ++i) {
+		DMA_TxBuffer[i] = TLE7232_CMD_DIAGNOSIS;
+	}
+	TLE7232_StartTransfer_DMA();
+	return true;
+}
+
+/**
+ * Writes the provided data to the specified register of all TLE7232 drivers in the chain using the DMA engine and
+ * returns immediately. Unlike the blocking accesses this may be called from interrupt context, but it never waits
+ * for the bus, so the caller must retry if it is in use. The diagnosis registers clocked out in return are picked up
+ * as for a background diagnosis read.
+ *
+ * @param reg TLE7232_Register_t The register to write data to.
+ * @param data uint8_t[] The data to write, indexed by chip index.
+ * @retval bool TRUE if the write was started, FALSE if the bus is in use.
+ */
+bool TLE7232_WriteRegisterAll_DMA(TLE7232_Register_t reg, uint8_t data[NUMBER_TLE7232_CHIPS]) {
+	if (TLE7232_ClaimTransfer_DMA() == false) {
+		return false;
+	}
+	for (uint_fast8_t i = 0; i < NUMBER_TLE7232_CHIPS; ++i) {
+		DMA_TxBuffer[i] = TLE7232_CMD_WRITE_REGISTER | reg | data[i];
+	}
+	TLE7232_StartTransfer_DMA();
+	return true;
+}
+
+/**
+ * Services the background diagnosis of the TLE7232 drivers. If the last background read found a change in the
+ * diagnosis registers it is evaluated here, outside of interrupt context, and the next read is started once the
+ * diagnosis period has elapsed. No SPI traffic is waited on, so this is cheap enough to call from the main loop.
+ *
+ * @param none
+ * @retval bool TRUE if a change in the diagnosis registers was evaluated.
+ */
+bool TLE7232_ServiceDiagnosis(void) {
+	bool changed = false;
+	if (DMA_Busy == false) {
+		if (DiagnosisPending == true) {
+			DiagnosisPending = false;
+			TLE7232_EvaluateDiagnosis();
+			changed = true;
+		}
+		uint64_t now = GetLocalTime();
+		if (DiagnosisPeriod > 0U && (now - LastDiagnosis) >= DiagnosisPeriod) {
+			LastDiagnosis = now;
+			TLE7232_StartDiagnosis_DMA();
+		}
+	}
+	return changed;
+}
+
+/**
+ * Sets the period of the background diagnosis reads started by TLE7232_ServiceDiagnosis().
+ *
+ * @param period_us uint32_t The period between reads in microseconds, or 0 to disable them.
+ * @retval none
+ */
+void TLE7232_SetDiagnosisPeriod(uint32_t period_us) {
+	DiagnosisPeriod = period_us;
+}
+
+/**
+ * Handles the transfer complete interrupt of the SPI receive DMA stream. This shuts down both streams, ends the
+ * frame and flags the diagnosis registers for evaluation if they differ from the local copy. This must be called
+ * from the DMA stream IRQ handler.
+ *
+ * @param none
+ * @retval none
+ */
+void TLE7232_SPI_DMA_IRQHandler(void) {
+	if (DMA_GetITStatus(TLE7232_SPI_DMA_RX_STREAM, TLE7232_SPI_DMA_RX_IT_TC) != RESET) {
+		DMA_ClearITPendingBit(TLE7232_SPI_DMA_RX_STREAM, TLE7232_SPI_DMA_RX_IT_TC);
+		SPI_I2S_DMACmd(TLE7232_SPI, SPI_I2S_DMAReq_Rx | SPI_I2S_DMAReq_Tx, DISABLE);
+		DMA_Cmd(TLE7232_SPI_DMA_RX_STREAM, DISABLE);
+		DMA_Cmd(TLE7232_SPI_DMA_TX_STREAM, DISABLE);
+
+		while (SPI_I2S_GetFlagStatus(TLE7232_SPI, SPI_I2S_FLAG_BSY) == SET) {
+			/* The last frame is already in, this only waits out the final clock edge */
+		}
+
+		/* Deselect the TLE7232: Chip Select High */
+		TLE7232_CS_HIGH();
+
+		for (uint_fast8_t i = 0; i < NUMBER_TLE7232_CHIPS; ++i) {
+			if (DMA_RxDiagnosis[i] != DiagnosisRegisters[i]) {
+				DiagnosisRegisters[i] = DMA_RxDiagnosis[i];
+				DiagnosisPending = true;
+			}
+		}
+		if (DiagnosisReported == false) {
+			/* Nothing has been reported yet, so this read is evaluated whether or not it changed */
+			DiagnosisPending = true;
+		}
+		DMA_Busy = false;
+	}
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_BootTimes.c
+ * @brief Implements the boot time breakdown of the Tekdaqc.
+ *
+ * Each stage is timed from the completion of the one before it, the first from the start of the time base, so the
+ * stage times add up to the total.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "Tekdaqc_BootTimes.h"
+#include "Tekdaqc_Timers.h"
+#include <stddef.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The human readable names of the stages, indexed by BootStage_t */
+static const char* STAGE_STRINGS[NUM_BOOT_STAGES] = { "NETWORK_START", "STATE_MACHINES", "ANALOG_INPUTS",
+		"DIGITAL_INPUTS", "DIGITAL_OUTPUTS", "FLASH_DISK", "CALIBRATION", "CHANNEL_CONFIG", "PHY_WAIT",
+		"NETWORK_COMPLETE", "SERVERS" };
+
+/* The time each stage took (us) */
+static uint32_t stageTimes[NUM_BOOT_STAGES];
+
+/* The time the last stage completed (us) */
+static uint64_t lastMark = 0U;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Records the completion of a boot stage, timing it from the completion of the stage before.
+ *
+ * @param stage BootStage_t The stage which has completed.
+ * @retval none
+ */
+void BootTimes_Mark(BootStage_t stage) {
+	const uint64_t now = GetLocalTime();
+	if (stage < NUM_BOOT_STAGES) {
+		stageTimes[stage] = (uint32_t) (now - lastMark);
+	}
+	lastMark = now;
+}
+
+/**
+ * Retrieves the time a boot stage took.
+ *
+ * @param stage BootStage_t The stage.
+ * @retval uint32_t The time the stage took (us), 0 if it has not completed.
+ */
+uint32_t BootTimes_Get(BootStage_t stage) {
+	return (stage < NUM_BOOT_STAGES) ? stageTimes[stage] : 0U;
+}
+
+/**
+ * Retrieves the time from the start of the time base to the completion of the last recorded stage.
+ *
+ * @param none
+ * @retval uint32_t The total boot time (us).
+ */
+uint32_t BootTimes_Total(void) {
+	return (uint32_t) lastMark;
+}
+
+/**
+ * Return the human readable string representation of the provided boot stage.
+ *
+ * @param stage BootStage_t The stage to convert.
+ * @retval const char* The string representation, or NULL if the stage is invalid.
+ */
+const char* BootTimes_StringFromStage(BootStage_t stage) {
+	return (stage < NUM_BOOT_STAGES) ? STAGE_STRINGS[stage] : NULL;
+}
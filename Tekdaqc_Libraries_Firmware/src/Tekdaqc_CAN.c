@@ -15,7 +15,19 @@
  * @file Tekdaqc_CAN.c
  * @brief Controls the Tekdaqc CAN peripheral.
  *
- * Allows for transmission and reception of messages over CAN bus.
+ * Allows for transmission and reception of messages over CAN bus. The bus carries the synchronization protocol of
+ * several boards: a master broadcasts a frame whenever it starts or stops sampling, or its trigger fires, and the
+ * slaves follow it. Start frames carry the little endian 32 bit number of samples. The hardware filter passes only
+ * the synchronization frames, so other traffic never interrupts the processor.
+ *
+ * A trigger is handed on from the receive interrupt, so that it fires on the next sample of every board. Starting
+ * and stopping sampling is deferred to the main loop. While sample frames are streamed, the board also follows
+ * these frames without being a slave, which lets a CAN controller start, stop and trigger it.
+ *
+ * Sample frames carry the samples of one channel on the stream identifier plus the channel number. They are queued
+ * and loaded into the transmit mailboxes as they free up, from the transmit interrupt, so the bus is kept busy
+ * without the main loop polling it. Their identifiers are above those of the synchronization frames, which therefore
+ * win arbitration.
  *
  * @author Jared Woolston (jwoolston@tenkiv.com)
  * @since v1.0.0.0
@@ -30,17 +42,89 @@
 #include "stm32f4xx_can.h"
 #include "stm32f4xx.h"
 #include "misc.h"
+#include "Tekdaqc_CAN.h"
+#include "Tekdaqc_Scheduler.h"
+#include "eeprom.h"
+#include <stddef.h>
+#include <stdio.h>
 
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
 
+/**
+ * @internal
+ * @def CAN_SYNC_ID_MASK
+ * @brief The identifier bits the hardware filter compares against CAN_SYNC_ID_BASE.
+ */
+#define CAN_SYNC_ID_MASK			((uint32_t) 0x7FC)
+
+/**
+ * @internal
+ * @def CAN_FILTER_IDE_RTR
+ * @brief The IDE and RTR bits of a 32 bit filter, which must be clear for a standard data frame.
+ */
+#define CAN_FILTER_IDE_RTR			((uint16_t) 0x0006)
+
+/**
+ * @internal
+ * @def CAN_SYNC_ROLE_MARKER
+ * @brief The upper byte of the saved role word, telling it apart from a word which was never written.
+ */
+#define CAN_SYNC_ROLE_MARKER		((uint16_t) 0xC500)
+
+/**
+ * @internal
+ * @def CAN_MAX_STD_ID
+ * @brief The largest standard identifier.
+ */
+#define CAN_MAX_STD_ID				((uint32_t) 0x7FF)
 
 /*--------------------------------------------------------------------------------------------------------*/
-/* PRIVATE DEFINES */
+/* PRIVATE TYPES */
 /*--------------------------------------------------------------------------------------------------------*/
 
+/**
+ * @internal
+ * @brief A sample frame waiting for a transmit mailbox.
+ */
+typedef struct {
+	uint16_t id; /**< The standard identifier of the frame. */
+	uint8_t length; /**< The number of data bytes. */
+	uint8_t data[8]; /**< The data of the frame. */
+} CAN_StreamFrame_t;
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE VARIABLES */
 /*--------------------------------------------------------------------------------------------------------*/
 
+/* The last received message */
+static CanRxMsg RxMessage;
+
+/* The synchronization role of the board */
+static CAN_SyncRole_t SyncRole = CAN_SYNC_NONE;
+
+/* The function acting on the start and stop events */
+static CAN_SyncHandler SyncHandler = NULL;
+
+/* The function firing the trigger */
+static CAN_TriggerHandler TriggerHandler = NULL;
+
+/* Indicates if sample frames are being sent */
+static bool Streaming = FALSE;
+
+/* The identifier of the sample frames of the first channel */
+static uint32_t StreamId = CAN_STREAM_ID_DEFAULT;
+
+/* The sample frames waiting for a transmit mailbox. Filled by the main loop, emptied by the transmit interrupt */
+static CAN_StreamFrame_t StreamQueue[CAN_STREAM_QUEUE_SIZE];
+
+/* The index the next queued frame is written to */
+static volatile uint16_t StreamHead = 0U;
+
+/* The index of the next frame to transmit */
+static volatile uint16_t StreamTail = 0U;
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE FUNCTION PROTOTYPES */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -51,6 +135,23 @@
  */
 static void Init_RxMes(CanRxMsg *RxMessage);
 
+/**
+ * @internal
+ * @brief Loads queued sample frames into the free transmit mailboxes.
+ */
+static void LoadStreamFrames(void);
+
+/**
+ * @internal
+ * @brief Acts on a start event deferred from the receive interrupt.
+ */
+static void DeferredStart(uint32_t argument);
+
+/**
+ * @internal
+ * @brief Acts on a stop event deferred from the receive interrupt.
+ */
+static void DeferredStop(uint32_t argument);
 
 
 /*--------------------------------------------------------------------------------------------------------*/
@@ -76,6 +177,67 @@ static void Init_RxMes(CanRxMsg *RxMessage) {
   }
 }
 
+/**
+ * Loads queued sample frames into the transmit mailboxes until either runs out. Called with the CAN interrupts
+ * unable to run, from the transmit interrupt or with interrupts masked.
+ *
+ * @param none
+ * @retval none
+ */
+static void LoadStreamFrames(void) {
+	CanTxMsg TxMessage;
+	TxMessage.ExtId = 0x00;
+	TxMessage.IDE = CAN_ID_STD;
+	TxMessage.RTR = CAN_RTR_DATA;
+	while (StreamTail != StreamHead) {
+		const CAN_StreamFrame_t* frame = &StreamQueue[StreamTail];
+		TxMessage.StdId = frame->id;
+		TxMessage.DLC = frame->length;
+		for (uint_fast8_t i = 0U; i < frame->length; ++i) {
+			TxMessage.Data[i] = frame->data[i];
+		}
+		if (CAN_Transmit(CANx, &TxMessage) == CAN_TxStatus_NoMailBox) {
+			/* The transmit interrupt carries on once a mailbox is free */
+			return;
+		}
+		StreamTail = (StreamTail + 1U) % CAN_STREAM_QUEUE_SIZE;
+	}
+	/* Nothing is left to load, stop interrupting on completed transmissions */
+	CAN_ITConfig(CANx, CAN_IT_TME, DISABLE);
+}
+
+/**
+ * Acts on a start event deferred from the receive interrupt. Events still queued when the board stops being a slave
+ * and stops streaming are dropped, as the interrupt would have ignored them.
+ *
+ * @param argument uint32_t The argument carried by the start frame.
+ * @retval none
+ */
+static void DeferredStart(uint32_t argument) {
+#ifdef CAN_DEBUG
+	printf("[CAN] Received synchronization start event.\n\r");
+#endif
+	if ((SyncHandler != NULL) && ((SyncRole == CAN_SYNC_SLAVE) || (Streaming == TRUE))) {
+		SyncHandler(CAN_SYNC_START, argument);
+	}
+}
+
+/**
+ * Acts on a stop event deferred from the receive interrupt, dropped as for DeferredStart().
+ *
+ * @param argument uint32_t Unused.
+ * @retval none
+ */
+static void DeferredStop(uint32_t argument) {
+	(void) argument;
+#ifdef CAN_DEBUG
+	printf("[CAN] Received synchronization stop event.\n\r");
+#endif
+	if ((SyncHandler != NULL) && ((SyncRole == CAN_SYNC_SLAVE) || (Streaming == TRUE))) {
+		SyncHandler(CAN_SYNC_STOP, 0U);
+	}
+}
+
 
 
 /*--------------------------------------------------------------------------------------------------------*/
@@ -95,11 +257,15 @@ void Tekdaqc_CAN_Config(void) {
 	CAN_FilterInitTypeDef  CAN_FilterInitStructure;
 
 	NVIC_InitStructure.NVIC_IRQChannel = CAN1_RX0_IRQn;
-	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0x0;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = CAN_RX_PREEMPT_PRIORITY;
 	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0x0;
 	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
 	NVIC_Init(&NVIC_InitStructure);
 
+	NVIC_InitStructure.NVIC_IRQChannel = CAN1_TX_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = CAN_TX_PREEMPT_PRIORITY;
+	NVIC_Init(&NVIC_InitStructure);
+
 	/* CAN GPIOs configuration */
 
 	/* Enable GPIO clock */
@@ -126,7 +292,8 @@ void Tekdaqc_CAN_Config(void) {
 
 	/* CAN cell init */
 	CAN_InitStructure.CAN_TTCM = DISABLE;
-	CAN_InitStructure.CAN_ABOM = DISABLE;
+	/* Recover from bus off without software, so a slave keeps following once the bus is healthy again */
+	CAN_InitStructure.CAN_ABOM = ENABLE;
 	CAN_InitStructure.CAN_AWUM = DISABLE;
 	CAN_InitStructure.CAN_NART = DISABLE;
 	CAN_InitStructure.CAN_RFLM = DISABLE;
@@ -134,24 +301,243 @@ void Tekdaqc_CAN_Config(void) {
 	CAN_InitStructure.CAN_Mode = CAN_Mode_Normal;
 	CAN_InitStructure.CAN_SJW = CAN_SJW_1tq;
 
-	/* CAN Baudrate = 1 MBps (CAN clocked at 30 MHz) */
+	/* CAN Baudrate = 1 MBps (CAN clocked at 42 MHz, 14 time quanta per bit) */
 	CAN_InitStructure.CAN_BS1 = CAN_BS1_6tq;
-	CAN_InitStructure.CAN_BS2 = CAN_BS2_8tq;
-	CAN_InitStructure.CAN_Prescaler = 2;
+	CAN_InitStructure.CAN_BS2 = CAN_BS2_7tq;
+	CAN_InitStructure.CAN_Prescaler = 3;
 	CAN_Init(CANx, &CAN_InitStructure);
 
-	/* CAN filter init */
+	/* CAN filter init, passing only the standard data frames of the synchronization protocol */
 	CAN_FilterInitStructure.CAN_FilterNumber = 0;
 	CAN_FilterInitStructure.CAN_FilterMode = CAN_FilterMode_IdMask;
 	CAN_FilterInitStructure.CAN_FilterScale = CAN_FilterScale_32bit;
-	CAN_FilterInitStructure.CAN_FilterIdHigh = 0x0000;
+	CAN_FilterInitStructure.CAN_FilterIdHigh = (uint16_t) (CAN_SYNC_ID_BASE << 5);
 	CAN_FilterInitStructure.CAN_FilterIdLow = 0x0000;
-	CAN_FilterInitStructure.CAN_FilterMaskIdHigh = 0x0000;
-	CAN_FilterInitStructure.CAN_FilterMaskIdLow = 0x0000;
+	CAN_FilterInitStructure.CAN_FilterMaskIdHigh = (uint16_t) (CAN_SYNC_ID_MASK << 5);
+	CAN_FilterInitStructure.CAN_FilterMaskIdLow = CAN_FILTER_IDE_RTR;
 	CAN_FilterInitStructure.CAN_FilterFIFOAssignment = 0;
 	CAN_FilterInitStructure.CAN_FilterActivation = ENABLE;
 	CAN_FilterInit(&CAN_FilterInitStructure);
 
 	/* Enable FIFO 0 message pending Interrupt */
 	CAN_ITConfig(CANx, CAN_IT_FMP0, ENABLE);
+
+	/* Restore the saved synchronization role */
+	uint16_t saved = 0U;
+	if ((EE_ReadVariable(ADDR_CAN_SYNC_ROLE, &saved) == 0U) && ((saved & 0xFF00U) == CAN_SYNC_ROLE_MARKER)
+			&& ((saved & 0x00FFU) < NUM_CAN_SYNC_ROLES)) {
+		SyncRole = (CAN_SyncRole_t) (saved & 0x00FFU);
+	}
+#ifdef CAN_DEBUG
+	printf("[CAN] Synchronization role %i.\n\r", SyncRole);
+#endif
+}
+
+/**
+ * Sets the synchronization role of the board and saves it, so the board takes the same part from the next reset on.
+ *
+ * @param role CAN_SyncRole_t The synchronization role.
+ * @retval bool TRUE if the role was saved.
+ */
+bool Tekdaqc_CAN_SetSyncRole(CAN_SyncRole_t role) {
+	if (role >= NUM_CAN_SYNC_ROLES) {
+		return FALSE;
+	}
+	SyncRole = role;
+	const uint16_t value = CAN_SYNC_ROLE_MARKER | (uint16_t) role;
+	uint16_t current = 0U;
+	if ((EE_ReadVariable(ADDR_CAN_SYNC_ROLE, &current) == 0U) && (current == value)) {
+		return TRUE;
+	}
+	return (EE_QueueWrite(ADDR_CAN_SYNC_ROLE, value) == FLASH_COMPLETE) ? TRUE : FALSE;
+}
+
+/**
+ * Retrieves the synchronization role of the board.
+ *
+ * @param none
+ * @retval CAN_SyncRole_t The synchronization role.
+ */
+CAN_SyncRole_t Tekdaqc_CAN_GetSyncRole(void) {
+	return SyncRole;
+}
+
+/**
+ * Sets the functions which act on the synchronization frames received while the board is a slave.
+ *
+ * @param sync CAN_SyncHandler The function called from the main loop to start and stop sampling.
+ * @param trigger CAN_TriggerHandler The function called from the receive interrupt to fire the trigger. It must be
+ * safe to call from an interrupt.
+ * @retval none
+ */
+void Tekdaqc_CAN_SetSyncHandlers(CAN_SyncHandler sync, CAN_TriggerHandler trigger) {
+	SyncHandler = sync;
+	TriggerHandler = trigger;
+}
+
+/**
+ * Broadcasts a synchronization frame to the slaves. Nothing is sent unless the board is the master. Safe to call
+ * from an interrupt, so a trigger can be handed on from where it fires.
+ *
+ * @param event CAN_SyncEvent_t The event to broadcast.
+ * @param argument uint32_t The argument of the event, the number of samples for CAN_SYNC_START.
+ * @retval bool TRUE if the frame was queued for transmission.
+ */
+bool Tekdaqc_CAN_SendSync(CAN_SyncEvent_t event, uint32_t argument) {
+	if ((SyncRole != CAN_SYNC_MASTER) || (event >= NUM_CAN_SYNC_EVENTS)) {
+		return FALSE;
+	}
+	CanTxMsg TxMessage;
+	TxMessage.StdId = CAN_SYNC_ID_BASE + (uint32_t) event;
+	TxMessage.ExtId = 0x00;
+	TxMessage.IDE = CAN_ID_STD;
+	TxMessage.RTR = CAN_RTR_DATA;
+	TxMessage.DLC = (event == CAN_SYNC_START) ? 4U : 0U;
+	for (uint_fast8_t i = 0U; i < 4U; ++i) {
+		TxMessage.Data[i] = (uint8_t) (argument >> (8U * i));
+	}
+	/* The main loop and the interrupts may both send, and must not pick the same mailbox */
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	const uint8_t mailbox = CAN_Transmit(CANx, &TxMessage);
+	__set_PRIMASK(primask);
+	return (mailbox != CAN_TxStatus_NoMailBox) ? TRUE : FALSE;
+}
+
+/**
+ * Starts sending sample frames on the CAN bus. The frames of each channel use the provided identifier plus the
+ * channel number, and must stay clear of the synchronization frames.
+ *
+ * @param id uint32_t The standard identifier of the sample frames of the first channel.
+ * @retval bool FALSE if the identifiers are out of range or overlap the synchronization frames.
+ */
+bool Tekdaqc_CAN_StreamStart(uint32_t id) {
+	if ((id <= (CAN_SYNC_ID_BASE + NUM_CAN_SYNC_EVENTS - 1U)) || (id > (CAN_MAX_STD_ID + 1U - CAN_STREAM_ID_SPAN))) {
+		return FALSE;
+	}
+	Tekdaqc_CAN_StreamStop();
+	StreamId = id;
+	Streaming = TRUE;
+#ifdef CAN_DEBUG
+	printf("[CAN] Streaming samples from identifier 0x%03lx.\n\r", (unsigned long) id);
+#endif
+	return TRUE;
+}
+
+/**
+ * Stops sending sample frames on the CAN bus. Frames still queued are discarded, those already in a mailbox are
+ * sent.
+ *
+ * @param none
+ * @retval none
+ */
+void Tekdaqc_CAN_StreamStop(void) {
+	Streaming = FALSE;
+	CAN_ITConfig(CANx, CAN_IT_TME, DISABLE);
+	StreamTail = StreamHead;
+}
+
+/**
+ * Indicates if sample frames are being sent on the CAN bus.
+ *
+ * @param none
+ * @retval bool TRUE if sample frames are being sent.
+ */
+bool Tekdaqc_CAN_IsStreaming(void) {
+	return Streaming;
+}
+
+/**
+ * Retrieves the number of sample frames which can currently be queued, so a writer can tell how many samples it can
+ * hand over before it starts.
+ *
+ * @param none
+ * @retval uint16_t The number of free entries in the queue.
+ */
+uint16_t Tekdaqc_CAN_StreamGetFree(void) {
+	const uint16_t used = (StreamHead + CAN_STREAM_QUEUE_SIZE - StreamTail) % CAN_STREAM_QUEUE_SIZE;
+	return (CAN_STREAM_QUEUE_SIZE - 1U) - used;
+}
+
+/**
+ * Queues a sample frame for a channel and starts it on its way if a transmit mailbox is free. Called only from the
+ * main loop.
+ *
+ * @param channel uint8_t The channel the frame belongs to, below CAN_STREAM_ID_SPAN.
+ * @param data const uint8_t* Pointer to the data of the frame.
+ * @param length uint8_t The number of data bytes, at most 8.
+ * @retval WriteStatus_t The result of the write.
+ */
+WriteStatus_t Tekdaqc_CAN_StreamWrite(uint8_t channel, const uint8_t* data, uint8_t length) {
+	if (Streaming == FALSE) {
+		return WRITE_NOT_CONNECTED;
+	}
+	if ((length > 8U) || (channel >= CAN_STREAM_ID_SPAN)) {
+		return WRITE_TOO_LARGE;
+	}
+	const uint16_t next = (StreamHead + 1U) % CAN_STREAM_QUEUE_SIZE;
+	if (next == StreamTail) {
+		return WRITE_BUSY;
+	}
+	CAN_StreamFrame_t* frame = &StreamQueue[StreamHead];
+	frame->id = (uint16_t) (StreamId + channel);
+	frame->length = length;
+	for (uint_fast8_t i = 0U; i < length; ++i) {
+		frame->data[i] = data[i];
+	}
+	StreamHead = next;
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	CAN_ITConfig(CANx, CAN_IT_TME, ENABLE);
+	LoadStreamFrames();
+	__set_PRIMASK(primask);
+	return WRITE_OK;
+}
+
+/**
+ * Called by the CAN transmit interrupt handler once a mailbox has completed its transmission, to load it with the
+ * next queued sample frame.
+ *
+ * @param none
+ * @retval none
+ */
+void Tekdaqc_CAN_TransmitHandler(void) {
+	CAN_ClearITPendingBit(CANx, CAN_IT_TME);
+	LoadStreamFrames();
+}
+
+/**
+ * Called by the CAN receive interrupt handler to take the received frames. While the board is a slave or streams
+ * samples, a trigger is handed on at once, and a start or stop event is deferred to the program loop, which acts on
+ * each in the order received.
+ *
+ * @param none
+ * @retval none
+ */
+void Tekdaqc_CAN_ReceiveHandler(void) {
+	while (CAN_MessagePending(CANx, CAN_FIFO0) > 0U) {
+		CAN_Receive(CANx, CAN_FIFO0, &RxMessage);
+		if (((SyncRole != CAN_SYNC_SLAVE) && (Streaming == FALSE)) || (RxMessage.IDE != CAN_ID_STD)
+				|| (RxMessage.RTR != CAN_RTR_DATA)) {
+			continue;
+		}
+		switch (RxMessage.StdId - CAN_SYNC_ID_BASE) {
+		case CAN_SYNC_TRIGGER:
+			if (TriggerHandler != NULL) {
+				TriggerHandler();
+			}
+			break;
+		case CAN_SYNC_START:
+			if (RxMessage.DLC >= 4U) {
+				Scheduler_Defer(&DeferredStart, ((uint32_t) RxMessage.Data[0]) | (((uint32_t) RxMessage.Data[1]) << 8U)
+						| (((uint32_t) RxMessage.Data[2]) << 16U) | (((uint32_t) RxMessage.Data[3]) << 24U));
+			}
+			break;
+		case CAN_SYNC_STOP:
+			Scheduler_Defer(&DeferredStop, 0U);
+			break;
+		default:
+			break;
+		}
+	}
 }
@@ -20,7 +20,8 @@
  * The table has the ability to store values for each gain, sample rate and buffer setting on
  * the Tekdaqc, as well as for various temperature data points. When requesting a value, a temperature
  * must be specified and the value will automatically be interpolated from the closest high and low
- * temperature data points.
+ * temperature data points. The table is checked against the CRC in its header and copied from FLASH into a RAM
+ * image once at initialization, so that lookups never wait on the FLASH and can trust the data.
  *
  * Since the board has the ability to in the field perform offset calibrations, no values are specified
  * for the offset register in the table. Instead they are determined at run time by performing a complete
@@ -36,32 +37,29 @@
 
 #include "Tekdaqc_Debug.h"
 #include "Tekdaqc_CalibrationTable.h"
+#include "Tekdaqc_CalibrationInterpolation.h"
 #include "Tekdaqc_BSP.h"
 #include "TelnetServer.h"
 #include <string.h>
 #include <inttypes.h>
 
-/*--------------------------------------------------------------------------------------------------------*/
-/* PRIVATE DEFINES */
-/*--------------------------------------------------------------------------------------------------------*/
-
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE VARIABLES */
 /*--------------------------------------------------------------------------------------------------------*/
 
-/* The highest temperature that calibration data exists for */
-static float CAL_TEMP_HIGH = 0.0f;
+/* The highest temperature that calibration data exists for, fixed point */
+static int32_t CAL_TEMP_HIGH = 0;
 
-/* The lowest temperature that calibration data exists for */
-static float CAL_TEMP_LOW = 0.0f;
+/* The lowest temperature that calibration data exists for, fixed point */
+static int32_t CAL_TEMP_LOW = 0;
 
-/* The temperature step for the calibration data */
-static float CAL_TEMP_STEP = 0.0f;
+/* The temperature step for the calibration data, fixed point */
+static int32_t CAL_TEMP_STEP = 0;
 
 /* The number of calibration temperatures */
 static uint32_t CAL_TEMP_CNT = 0;
 
-/* Does valid calibration data exist */
+/* Does valid calibration data exist, i.e. the table's header matched its contents */
 static bool CALIBRATION_VALID = false;
 
 /* If calibration mode has been enabled */
@@ -73,19 +71,20 @@ static uint32_t offsetCalibrations[NUM_SAMPLE_RATES][NUM_PGA_SETTINGS][NUM_BUFFE
 /* RAM table of base gain calibrations */
 static uint32_t baseGainCalibrations[NUM_SAMPLE_RATES][NUM_PGA_SETTINGS][NUM_BUFFER_SETTINGS];
 
+/* RAM image of the gain calibration table. Only read while CALIBRATION_VALID, which requires it to have been loaded */
+static uint32_t gainCalibrations[NUM_SAMPLE_RATES][NUM_PGA_SETTINGS][NUM_BUFFER_SETTINGS][CALIBRATION_MAX_TEMPS] CCM_DATA;
+
+/* Has the out of range temperature error been reported since the temperature was last in range */
+static bool outOfRangeReported = false;
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE FUNCTION PROTOTYPES */
 /*--------------------------------------------------------------------------------------------------------*/
 
 /**
- * @brief Computes the address offset for the offset calibration value with the specified parameters.
+ * @brief Computes the address of the gain calibration value with the specified parameters.
  */
-static uint32_t ComputeOffset(ADS1256_SPS_t rate, ADS1256_PGA_t gain, ADS1256_BUFFER_t buffer, float temperature);
-
-/**
- * @brief Interpolates two calibration values with the specified interpolation factor.
- */
-static uint32_t InterpolateValue(uint32_t low, uint32_t high, float factor);
+static uint32_t ComputeAddress(uint8_t rate_index, uint8_t gain_index, uint8_t buffer_index, uint32_t step);
 
 /**
  * @brief Computes the indecies for the RAM gain and offset lookup tables based on the sampling parameters.
@@ -93,51 +92,44 @@ static uint32_t InterpolateValue(uint32_t low, uint32_t high, float factor);
 static void ComputeTableIndices(uint8_t* rateIndex, uint8_t* gain_index, uint8_t* buffer_index, ADS1256_SPS_t rate, ADS1256_PGA_t gain,
 		ADS1256_BUFFER_t buffer);
 
-/*--------------------------------------------------------------------------------------------------------*/
-/* PRIVATE METHODS */
-/*--------------------------------------------------------------------------------------------------------*/
+/**
+ * @brief Reads the calibration table in FLASH, computing its CRC and optionally copying it into the RAM image.
+ */
+static uint32_t ReadCalibrationTable(uint32_t count, bool load);
 
 /**
- * @internal
- * Computes the address offset for the offset calibration value corresponding to the specified parameters.
- *
- * @param rate ADS1256_SPS_t The sample rate to lookup for.
- * @param gain ADS1256_PGA_t The gain to lookup for.
- * @param bufer ADS1256_BUFFER_t The buffer setting to lookup for.
- * @param temperature float The temperature value to lookup for.
- * @retval The computed address offset.
+ * @brief Computes the header dimensions word of a table with the specified number of temperatures.
  */
-static uint32_t ComputeOffset(ADS1256_SPS_t rate, ADS1256_PGA_t gain, ADS1256_BUFFER_t buffer, float temperature) {
-	uint32_t offset = 0;
-	switch (buffer) {
-	case ADS1256_BUFFER_ENABLED:
-		offset += CALIBRATION_BUFFER_OFFSET;
-		break;
-	case ADS1256_BUFFER_DISABLED:
-		/* No offset, do nothing */
-		break;
-	default:
-		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER),
-				"Error computing lookup offset in calibration table for rate: %s, gain: %s, buffer: %s and temperature: %f Deg C.",
-				ADS1256_StringFromSPS(rate), ADS1256_StringFromPGA(gain), ADS1256_StringFromBuffer(buffer), temperature);
-		TelnetWriteErrorMessage(TOSTRING_BUFFER);
-		break;
-	}
-	return offset;
-}
+static uint32_t ComputeTableDimensions(uint32_t count);
+
+/**
+ * @brief Checks the calibration table in FLASH and copies it into the RAM image.
+ */
+static bool LoadCalibrationTable(void);
+
+/**
+ * @brief Programs a block of data into the calibration sector with the widest writes its alignment allows.
+ */
+static FLASH_Status ProgramCalibrationData(uint32_t address, const void* data, uint32_t length);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE METHODS */
+/*--------------------------------------------------------------------------------------------------------*/
 
 /**
  * @internal
- * Interpolates two calibration values based on the specified factor.
+ * Computes the address of the gain calibration value corresponding to the specified parameters.
  *
- * @param low uint32_t The lower calibration data point.
- * @param high uint32_t The higher calibration data point.
- * @param factor float The interpolation factor. A value of 0 corresponds to low, a value of 1 corresponds to high.
- * @retval uint32_t The interpolated value.
+ * @param rate_index uint8_t The table index of the sample rate to lookup for.
+ * @param gain_index uint8_t The table index of the gain to lookup for.
+ * @param buffer_index uint8_t The table index of the buffer setting to lookup for.
+ * @param step uint32_t The temperature step to lookup for.
+ * @retval The computed address.
  */
-static uint32_t InterpolateValue(uint32_t low, uint32_t high, float factor) {
-	uint32_t value = low + (high - low) * factor;
-	return value;
+static uint32_t ComputeAddress(uint8_t rate_index, uint8_t gain_index, uint8_t buffer_index, uint32_t step) {
+	uint32_t offset = (rate_index * CALIBRATION_RATE_OFFSET) + (gain_index * CALIBRATION_GAIN_OFFSET)
+			+ (buffer_index * CALIBRATION_BUFFER_OFFSET) + (step * CALIBRATION_TEMP_OFFSET);
+	return CAL_DATA_START_ADDR + 4U * offset; /* Multiply offset by 4 because entries are 4 bytes long */
 }
 
 static void ComputeTableIndices(uint8_t* rate_index, uint8_t* gain_index, uint8_t* buffer_index, ADS1256_SPS_t rate, ADS1256_PGA_t gain,
@@ -236,6 +228,142 @@ static void ComputeTableIndices(uint8_t* rate_index, uint8_t* gain_index, uint8_
 	}
 }
 
+/**
+ * @internal
+ * Reads the calibration table in FLASH with the hardware CRC unit. The CRC covers the temperature range words
+ * followed by every data point, ordered as the RAM image is: by sample rate, gain, buffer setting and then
+ * temperature.
+ *
+ * @param count uint32_t The number of temperatures in the table, at most CALIBRATION_MAX_TEMPS.
+ * @param load bool If TRUE, the data points are also copied into the RAM image.
+ * @retval uint32_t The CRC of the table.
+ */
+static uint32_t ReadCalibrationTable(uint32_t count, bool load) {
+	RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_CRC, ENABLE);
+	CRC_ResetDR();
+	CRC_CalcCRC(*(__IO uint32_t*) CAL_TEMP_LOW_ADDR);
+	CRC_CalcCRC(*(__IO uint32_t*) CAL_TEMP_HIGH_ADDR);
+	CRC_CalcCRC(*(__IO uint32_t*) CAL_TEMP_STEP_ADDR);
+	CRC_CalcCRC(count);
+	for (uint8_t rate_index = 0U; rate_index < NUM_SAMPLE_RATES; ++rate_index) {
+		for (uint8_t gain_index = 0U; gain_index < NUM_PGA_SETTINGS; ++gain_index) {
+			for (uint8_t buffer_index = 0U; buffer_index < NUM_BUFFER_SETTINGS; ++buffer_index) {
+				uint32_t* points = gainCalibrations[rate_index][gain_index][buffer_index];
+				for (uint32_t step = 0U; step < count; ++step) {
+					/* The data points are not word aligned in FLASH */
+					uint32_t point;
+					memcpy(&point, (const void*) ComputeAddress(rate_index, gain_index, buffer_index, step), sizeof(point));
+					CRC_CalcCRC(point);
+					if (load == true) {
+						points[step] = point;
+					}
+				}
+			}
+		}
+	}
+	return CRC_GetCRC();
+}
+
+/**
+ * @internal
+ * Computes the header dimensions word of a table with the specified number of temperatures, one byte per dimension
+ * from the sample rates in the low byte to the temperatures in the high byte.
+ *
+ * @param count uint32_t The number of temperatures in the table.
+ * @retval uint32_t The dimensions word.
+ */
+static uint32_t ComputeTableDimensions(uint32_t count) {
+	return (NUM_SAMPLE_RATES | (NUM_PGA_SETTINGS << 8U) | (NUM_BUFFER_SETTINGS << 16U) | ((count & 0xFFU) << 24U));
+}
+
+/**
+ * @internal
+ * Checks the calibration table in FLASH and copies its data points into the RAM image. The table is only treated
+ * as valid if its header has the current version and dimensions, its temperature range is sane, its data points
+ * fit within the image and their CRC matches the header's.
+ *
+ * @param none
+ * @retval bool TRUE if the table is valid and was loaded.
+ */
+static bool LoadCalibrationTable(void) {
+	/* The table stores its temperatures as floats, they are converted once here */
+	CAL_TEMP_LOW = Calibration_TemperatureToFixed(*(__IO float*) CAL_TEMP_LOW_ADDR);
+	CAL_TEMP_HIGH = Calibration_TemperatureToFixed(*(__IO float*) CAL_TEMP_HIGH_ADDR);
+	CAL_TEMP_STEP = Calibration_TemperatureToFixed(*(__IO float*) CAL_TEMP_STEP_ADDR);
+	CAL_TEMP_CNT = (*(__IO uint32_t*) CAL_TEMP_CNT_ADDR);
+	CALIBRATION_VALID = false;
+	outOfRangeReported = false;
+
+	if (((*(__IO uint32_t*) CAL_HEADER_VERSION_ADDR) != CALIBRATION_TABLE_VERSION)
+			|| ((*(__IO uint32_t*) CAL_HEADER_DIMENSIONS_ADDR) != ComputeTableDimensions(CAL_TEMP_CNT))) {
+#ifdef CALIBRATION_TABLE_DEBUG
+		printf("[Calibration Table] The calibration table has no header for this version and its dimensions.\n\r");
+#endif
+		return FALSE;
+	}
+	if ((CAL_TEMP_CNT == 0U) || (CAL_TEMP_CNT > CALIBRATION_MAX_TEMPS) || (CAL_TEMP_HIGH < CAL_TEMP_LOW)
+			|| ((CAL_TEMP_CNT > 1U) && (CAL_TEMP_STEP <= 0))) {
+#ifdef CALIBRATION_TABLE_DEBUG
+		printf("[Calibration Table] The calibration table layout is not valid (%" PRIu32 " temperatures).\n\r", CAL_TEMP_CNT);
+#endif
+		return FALSE;
+	}
+	const uint32_t crc = ReadCalibrationTable(CAL_TEMP_CNT, TRUE);
+	if (crc != (*(__IO uint32_t*) CAL_HEADER_CRC_ADDR)) {
+#ifdef CALIBRATION_TABLE_DEBUG
+		printf("[Calibration Table] The calibration table CRC 0x%08" PRIX32 " does not match its header.\n\r", crc);
+#endif
+		return FALSE;
+	}
+	CALIBRATION_VALID = true;
+	return TRUE;
+}
+
+/**
+ * @internal
+ * Programs a block of data into the calibration sector. The table's data points are not word aligned, so the block
+ * is programmed a byte and then a half word at a time until the address is word aligned, and then a word at a time.
+ * Blocks which do not lie entirely within the calibration sector are rejected.
+ *
+ * @param address uint32_t The FLASH address to program the block at.
+ * @param data const void* Pointer to the data to program.
+ * @param length uint32_t The length of the block in bytes.
+ * @retval FLASH_Status FLASH_COMPLETE on success, or the error status on failure.
+ */
+static FLASH_Status ProgramCalibrationData(uint32_t address, const void* data, uint32_t length) {
+	if ((address < ADDR_CALIBRATION_BASE) || (length > (ADDR_CALIBRATION_END + 1U - address))) {
+#ifdef CALIBRATION_TABLE_DEBUG
+		printf("[Calibration Table] Refusing to program %" PRIu32 " bytes outside of the calibration sector.\n\r", length);
+#endif
+		return FLASH_ERROR_PROGRAM;
+	}
+	const uint8_t* bytes = (const uint8_t*) data;
+	FLASH_Status status = FLASH_COMPLETE;
+	while ((length > 0U) && (status == FLASH_COMPLETE)) {
+		if (((address & 0x03U) == 0U) && (length >= 4U)) {
+			uint32_t word;
+			memcpy(&word, bytes, sizeof(word));
+			status = FLASH_ProgramWord(address, word);
+			address += 4U;
+			bytes += 4U;
+			length -= 4U;
+		} else if (((address & 0x01U) == 0U) && (length >= 2U)) {
+			uint16_t half;
+			memcpy(&half, bytes, sizeof(half));
+			status = FLASH_ProgramHalfWord(address, half);
+			address += 2U;
+			bytes += 2U;
+			length -= 2U;
+		} else {
+			status = FLASH_ProgramByte(address, *bytes);
+			++address;
+			++bytes;
+			--length;
+		}
+	}
+	return status;
+}
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PUBLIC METHODS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -260,23 +388,21 @@ void Tekdaqc_Calibration_SetBaseGainValue(uint32_t val, ADS1256_SPS_t rate, ADS1
 }
 
 /**
- * Initializes the calibration table for read operations.
+ * Initializes the calibration table for read operations, loading the table from FLASH into RAM. A missing or
+ * invalid table is not an error, lookups then return the ADC calibration only.
  *
  * @param none
  * @retval bool Always TRUE.
  */
 bool Tekdaqc_CalibrationInit(void) {
 	FLASH_SetLatency(CALIBRATION_LATENCY );
-	CAL_TEMP_LOW = (*(__IO float*) CAL_TEMP_LOW_ADDR);
-	CAL_TEMP_HIGH = (*(__IO float*) CAL_TEMP_HIGH_ADDR);
-	CAL_TEMP_STEP = (*(__IO float*) CAL_TEMP_STEP_ADDR);
-	CAL_TEMP_CNT = (*(__IO uint32_t*) CAL_TEMP_CNT_ADDR);
-	CALIBRATION_VALID = (*(__IO uint8_t*) CAL_VALID_ADDR) != 0xFF;
+	LoadCalibrationTable();
 	return TRUE;
 }
 
 /**
- * Retrieve the gain calibration value for the specified sampling parameters.
+ * Retrieve the gain calibration value for the specified sampling parameters from the RAM image of the table.
+ * The out of range error is reported once each time the temperature leaves the range of the table.
  *
  * @param rate ADS1256_SPS_t The sample rate to lookup for.
  * @param gain ADS1256_PGA_t The gain to lookup for.
@@ -297,38 +423,34 @@ uint32_t Tekdaqc_GetGainCalibration(ADS1256_SPS_t rate, ADS1256_PGA_t gain, ADS1
 #endif
 		return baseGain;
 	}
-	if (temperature < CAL_TEMP_LOW || temperature > CAL_TEMP_HIGH) {
+	int32_t fixed = Calibration_TemperatureToFixed(temperature);
+	const bool outOfRange = ((fixed < CAL_TEMP_LOW) || (fixed > CAL_TEMP_HIGH));
+	if (outOfRange == true) {
 		/* The temperature is out of range, we will return the closest */
+		fixed = (fixed < CAL_TEMP_LOW) ? CAL_TEMP_LOW : CAL_TEMP_HIGH;
+	}
+
+	/* Report leaving the range of the table once rather than on every lookup */
+	const bool report = ((outOfRange == true) && (outOfRangeReported == false));
+	outOfRangeReported = outOfRange;
+	if (report == true) {
+		const float low = (float) CAL_TEMP_LOW / (float) (1UL << CAL_TEMP_FRACTION_BITS);
+		const float high = (float) CAL_TEMP_HIGH / (float) (1UL << CAL_TEMP_FRACTION_BITS);
 #ifdef CALIBRATION_TABLE_DEBUG
 		printf("[Calibration Table] The requested temperature %f was out of range. Minimum is %f and maximum is %f.\n\r", temperature,
-				CAL_TEMP_LOW, CAL_TEMP_HIGH);
+				low, high);
 #endif
 		snprintf(TOSTRING_BUFFER, sizeof(TOSTRING_BUFFER),
 				"Error fetching the gain calibration value for temperature: %f Deg C. Temperature out of range. Allowable range is %f to %f Deg C",
-				temperature, CAL_TEMP_LOW, CAL_TEMP_HIGH);
+				temperature, low, high);
 		TelnetWriteErrorMessage(TOSTRING_BUFFER);
-		if (temperature < CAL_TEMP_LOW) {
-			temperature = CAL_TEMP_LOW;
-		} else {
-			temperature = CAL_TEMP_HIGH;
-		}
 	}
 
-	uint8_t num_temp_steps = (uint8_t) (temperature / CAL_TEMP_STEP);
-	float low_temp = CAL_TEMP_LOW * num_temp_steps;
-	float high_temp = CAL_TEMP_HIGH * num_temp_steps;
-	float factor = (temperature - CAL_TEMP_LOW) / CAL_TEMP_STEP;
-
-	uint32_t offset = ComputeOffset(rate, gain, buffer, low_temp);                                                                                                                                            //Add one for the move to gain
-	uint32_t Address = CAL_DATA_START_ADDR + 4 * offset;                                                                                                                                            //Multiply offset by 4 because entries are 4bytes long
-
-	uint32_t data_low = (*(__IO uint32_t*) Address);
-
-	offset = ComputeOffset(rate, gain, buffer, high_temp);                                                                                                                                            //Add one for the move to gain
-	Address = CAL_DATA_START_ADDR + 4 * offset;                                                                                                                                            //Multiply offset by 4 because entries are 4bytes long
-
-	uint32_t data_high = (*(__IO uint32_t*) Address);
-	return (baseGain + InterpolateValue(data_low, data_high, factor));
+	/* The data points at the low and high temperatures of the step */
+	uint32_t factor = 0U;
+	const uint32_t step = Calibration_LocateTemperature(fixed, CAL_TEMP_LOW, CAL_TEMP_STEP, CAL_TEMP_CNT, &factor);
+	const uint32_t* points = gainCalibrations[rate_index][gain_index][buffer_index];
+	return (baseGain + Calibration_InterpolateValue(points[step], points[(CAL_TEMP_CNT > 1U) ? (step + 1U) : step], factor));
 }
 
 /**
@@ -376,17 +498,7 @@ FLASH_Status Tekdaqc_SetCalibrationMode(void) {
 		return status;
 	}
 
-	/* Program the user Flash area word by word area defined by FLASH_USER_START_ADDR and FLASH_USER_END_ADDR */
-	uint32_t Address = ADDR_CALIBRATION_BASE;
-
-	while (Address < ADDR_CALIBRATION_END ) {
-		status = FLASH_ProgramWord(Address, CALIBRATION_ERASE_DATA );
-		if (status == FLASH_COMPLETE) {
-			Address = Address + 4;
-		} else {
-			return status;
-		}
-	}
+	/* The sector is left erased, the table is only valid again once its header is written */
 
 	/* Enable write protection for this sector */
 	/*FLASH_OB_WRPConfig(CALIBRATION_WPSECTOR, ENABLE);
@@ -397,6 +509,12 @@ FLASH_Status Tekdaqc_SetCalibrationMode(void) {
 	/* Disable the flash control register access */
 
 	CalibrationModeEnabled = true;
+	/* The table was erased, lookups fall back to the ADC calibration until it is reloaded */
+	CALIBRATION_VALID = false;
+
+	/* Start the CRC of the uploaded gain calibration slices */
+	RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_CRC, ENABLE);
+	CRC_ResetDR();
 	return status;
 }
 
@@ -412,6 +530,7 @@ void Tekdaqc_EndCalibrationMode(void) {
 	FLASH_Lock();
 
 	CalibrationModeEnabled = false;
+	LoadCalibrationTable();
 }
 
 /**
@@ -459,7 +578,12 @@ FLASH_Status Tekdaqc_SetCalibrationLowTemperature(float temp) {
 		return FLASH_ERROR_WRP;
 	}
 
-	FLASH_Status status = FLASH_ProgramWord(CAL_TEMP_LOW_ADDR, temp);
+	uint32_t word;
+	memcpy(&word, &temp, sizeof(word)); /* The table holds the float's representation */
+	FLASH_Status status = FLASH_ProgramWord(CAL_TEMP_LOW_ADDR, word);
+	if (status == FLASH_COMPLETE) {
+		CAL_TEMP_LOW = Calibration_TemperatureToFixed(temp);
+	}
 	return status;
 }
 
@@ -476,7 +600,12 @@ FLASH_Status Tekdaqc_SetCalibrationHighTemperature(float temp) {
 		return FLASH_ERROR_WRP;
 	}
 
-	FLASH_Status status = FLASH_ProgramWord(CAL_TEMP_HIGH_ADDR, temp);
+	uint32_t word;
+	memcpy(&word, &temp, sizeof(word)); /* The table holds the float's representation */
+	FLASH_Status status = FLASH_ProgramWord(CAL_TEMP_HIGH_ADDR, word);
+	if (status == FLASH_COMPLETE) {
+		CAL_TEMP_HIGH = Calibration_TemperatureToFixed(temp);
+	}
 	return status;
 }
 
@@ -492,10 +621,59 @@ FLASH_Status Tekdaqc_SetCalibrationStepTemperature(float temp) {
 		return FLASH_ERROR_WRP;
 	}
 
-	FLASH_Status status = FLASH_ProgramWord(CAL_TEMP_STEP_ADDR, temp);
+	uint32_t word;
+	memcpy(&word, &temp, sizeof(word)); /* The table holds the float's representation */
+	FLASH_Status status = FLASH_ProgramWord(CAL_TEMP_STEP_ADDR, word);
+	if (status == FLASH_COMPLETE) {
+		CAL_TEMP_STEP = Calibration_TemperatureToFixed(temp);
+	}
+	return status;
+}
+
+/**
+ * Writes the number of temperature data points of the table. This method requires that the board be in
+ * calibration mode and will return FLASH_ERROR_WRP if it is not.
+ *
+ * @param count uint32_t The number of temperatures, at most CALIBRATION_MAX_TEMPS.
+ * @retval FLASH_Status FLASH_COMPLETE on success, or the error status on failure.
+ */
+FLASH_Status Tekdaqc_SetCalibrationTemperatureCount(uint32_t count) {
+	if (CalibrationModeEnabled == false) {
+		return FLASH_ERROR_WRP;
+	}
+	if ((count == 0U) || (count > CALIBRATION_MAX_TEMPS)) {
+		return FLASH_ERROR_PROGRAM;
+	}
+
+	FLASH_Status status = FLASH_ProgramWord(CAL_TEMP_CNT_ADDR, count);
+	if (status == FLASH_COMPLETE) {
+		CAL_TEMP_CNT = count;
+	}
 	return status;
 }
 
+/**
+ * Writes the table header, recording the table version, its dimensions and the CRC of its contents as they are
+ * now in FLASH. This must be the last write of calibration mode, once the temperatures and every data point have
+ * been written and any upload verified with Tekdaqc_VerifyCalibrationUpload(), which shares the CRC unit. This
+ * method requires that the board be in calibration mode and will return FLASH_ERROR_WRP if it is not.
+ *
+ * @param none
+ * @retval FLASH_Status FLASH_COMPLETE on success, or the error status on failure.
+ */
+FLASH_Status Tekdaqc_WriteCalibrationHeader(void) {
+	if (CalibrationModeEnabled == false) {
+		return FLASH_ERROR_WRP;
+	}
+	const uint32_t count = (*(__IO uint32_t*) CAL_TEMP_CNT_ADDR);
+	if ((count == 0U) || (count > CALIBRATION_MAX_TEMPS)) {
+		return FLASH_ERROR_PROGRAM;
+	}
+
+	const uint32_t header[3] = { CALIBRATION_TABLE_VERSION, ComputeTableDimensions(count), ReadCalibrationTable(count, FALSE) };
+	return ProgramCalibrationData(CAL_HEADER_ADDR, header, sizeof(header));
+}
+
 /**
  * Writes the gain calibration value for the specified parameters. This method requires that the board be in
  * calibration mode and will return FLASH_ERROR_WRP if it is not.
@@ -512,11 +690,85 @@ FLASH_Status Tekdaqc_SetGainCalibration(uint32_t cal, ADS1256_SPS_t rate, ADS125
 		return FLASH_ERROR_WRP;
 	}
 
-	uint32_t addr = ComputeOffset(rate, gain, buffer, temperature);
-	FLASH_Status status = FLASH_ProgramWord(addr, cal);
+	uint8_t rate_index = 0U;
+	uint8_t gain_index = 0U;
+	uint8_t buffer_index = 0U;
+	ComputeTableIndices(&rate_index, &gain_index, &buffer_index, rate, gain, buffer);
+	/* Write the data point nearest the temperature */
+	uint32_t factor = 0U;
+	uint32_t step = Calibration_LocateTemperature(Calibration_TemperatureToFixed(temperature), CAL_TEMP_LOW, CAL_TEMP_STEP,
+			CAL_TEMP_CNT, &factor);
+	if (factor >= (1UL << (CAL_FACTOR_FRACTION_BITS - 1U))) {
+		++step;
+	}
+	uint32_t addr = ComputeAddress(rate_index, gain_index, buffer_index, step);
+	return ProgramCalibrationData(addr, &cal, sizeof(cal));
+}
+
+/**
+ * Writes the gain calibration values of every sample rate and temperature step for the specified gain and buffer
+ * setting, so that the table can be uploaded a slice at a time rather than a value at a time. The slice holds
+ * NUM_SAMPLE_RATES values for each temperature step, lowest temperature first, with the sample rates ordered from
+ * 30000 SPS to 2.5 SPS. Each value is read back from FLASH into the upload CRC once programmed. This method
+ * requires that the board be in calibration mode and will return FLASH_ERROR_WRP if it is not.
+ *
+ * @param values const uint32_t* Pointer to the NUM_SAMPLE_RATES * steps calibration values of the slice.
+ * @param steps uint32_t The number of temperature steps in the slice, at most CALIBRATION_MAX_TEMPS.
+ * @param gain ADS1256_PGA_t The gain to write for.
+ * @param buffer ADS1256_BUFFER_t The buffer setting to write for.
+ * @retval FLASH_Status FLASH_COMPLETE on success, or the error status on failure.
+ */
+FLASH_Status Tekdaqc_SetGainCalibrationSlice(const uint32_t* values, uint32_t steps, ADS1256_PGA_t gain, ADS1256_BUFFER_t buffer) {
+	if (CalibrationModeEnabled == false) {
+		return FLASH_ERROR_WRP;
+	}
+	if ((values == NULL) || (steps == 0U) || (steps > CALIBRATION_MAX_TEMPS)) {
+		return FLASH_ERROR_PROGRAM;
+	}
+
+	uint8_t rate_index = 0U;
+	uint8_t gain_index = 0U;
+	uint8_t buffer_index = 0U;
+	ComputeTableIndices(&rate_index, &gain_index, &buffer_index, ADS1256_SPS_30000, gain, buffer);
+	FLASH_Status status = FLASH_COMPLETE;
+	for (uint32_t step = 0U; (step < steps) && (status == FLASH_COMPLETE); ++step) {
+		for (rate_index = 0U; (rate_index < NUM_SAMPLE_RATES) && (status == FLASH_COMPLETE); ++rate_index) {
+			const uint32_t addr = ComputeAddress(rate_index, gain_index, buffer_index, step);
+			status = ProgramCalibrationData(addr, values++, sizeof(uint32_t));
+			if (status == FLASH_COMPLETE) {
+				uint32_t written;
+				memcpy(&written, (const void*) addr, sizeof(written));
+				CRC_CalcCRC(written);
+			}
+		}
+	}
+#ifdef CALIBRATION_TABLE_DEBUG
+	printf("[Calibration Table] Wrote the gain calibration slice for gain %" PRIu8 ", buffer %" PRIu8 " with status %i.\n\r", gain_index,
+			buffer_index, status);
+#endif
 	return status;
 }
 
+/**
+ * Verifies the gain calibration slices written since entering calibration mode. The CRC is the STM32 CRC-32
+ * (polynomial 0x04C11DB7, initial value 0xFFFFFFFF, no reflection) of every slice's values in the order they were
+ * written, as read back from FLASH. This method requires that the board be in calibration mode and will return
+ * FLASH_ERROR_WRP if it is not.
+ *
+ * @param crc uint32_t The CRC computed by the host over the uploaded slices.
+ * @retval FLASH_Status FLASH_COMPLETE if the CRC matches, FLASH_ERROR_PROGRAM if it does not.
+ */
+FLASH_Status Tekdaqc_VerifyCalibrationUpload(uint32_t crc) {
+	if (CalibrationModeEnabled == false) {
+		return FLASH_ERROR_WRP;
+	}
+	const uint32_t computed = CRC_GetCRC();
+#ifdef CALIBRATION_TABLE_DEBUG
+	printf("[Calibration Table] Calibration upload CRC 0x%08" PRIX32 ", expected 0x%08" PRIX32 ".\n\r", computed, crc);
+#endif
+	return (computed == crc) ? FLASH_COMPLETE : FLASH_ERROR_PROGRAM;
+}
+
 /**
  * Writes the offset calibration value for the specified parameters. This method does not require the board to be in calibration
  * mode and only stores the values in a RAM lookup table.
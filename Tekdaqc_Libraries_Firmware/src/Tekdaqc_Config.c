@@ -28,7 +28,9 @@
 #include "Tekdaqc_Debug.h"
 #include "Tekdaqc_Config.h"
 #include "Tekdaqc_Timers.h"
+#include "Tekdaqc_BootTimes.h"
 #include "netconf.h"
+#include "stm32f4x7_eth.h"
 #include "TLE7232_RelayDriver.h"
 #include "Tekdaqc_RTC.h"
 #include "TelnetServer.h"
@@ -47,10 +49,16 @@
 /* PRIVATE DEFINES */
 /*--------------------------------------------------------------------------------------------------------*/
 
+/* The time in microseconds the PHY is given to come out of reset, the same as the Ethernet driver's blocking delay */
+#define PHY_RESET_TIME_US	(PHY_RESET_DELAY * 10000U)
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE VARIABLES */
 /*--------------------------------------------------------------------------------------------------------*/
 
+/* Set once the PHY has had PHY_RESET_TIME_US to come out of reset */
+static volatile bool PHYResetElapsed = false;
+
 /* The LSI capture count */
 volatile uint32_t LSICaptureNumber = 0;
 
@@ -109,12 +117,27 @@ uint16_t EEPROM_ADDRESSES[NUM_EEPROM_ADDRESSES];
  */
 static uint32_t GetLSIFrequency(void);
 
+/**
+ * @brief Deadline callback marking the end of the PHY reset.
+ */
+static void PHYResetDeadline(void);
+
 
 
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE FUNCTIONS */
 /*--------------------------------------------------------------------------------------------------------*/
 
+/**
+ * Deadline callback made once the PHY has had PHY_RESET_TIME_US to come out of reset.
+ *
+ * @param none
+ * @retval none
+ */
+static void PHYResetDeadline(void) {
+	PHYResetElapsed = true;
+}
+
 /**
  * Configures timer 5 (TIM5) to accurately measure the LSI oscillator frequency so that the watchdog
  * interval is minimally affected by the variations in the oscillator.
@@ -158,7 +181,7 @@ uint32_t GetLSIFrequency() {
 
 	/* Enable TIM5 Interrupt channel */
 	NVIC_InitStructure.NVIC_IRQChannel = TIM5_IRQn;
-	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = IRQ_PRIORITY_BACKGROUND;
 	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
 	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
 	NVIC_Init(&NVIC_InitStructure);
@@ -234,8 +257,10 @@ void Watchdog_Init(void) {
 }
 
 /**
- * Initializes the Tekdaqc's Ethernet communications and lwIP stack. This is necessary for both
- * the main application functionality as well as the IAP update function.
+ * Starts the Tekdaqc's Ethernet communications. The PHY is left in reset with a deadline scheduled for the end of the
+ * reset, so that the rest of the hardware can be initialized while it comes out of it. Communication_Complete() must
+ * be called to finish the bring up. This is necessary for both the main application functionality as well as the IAP
+ * update function.
  *
  * @param none
  * @retval none
@@ -248,11 +273,37 @@ void Communication_Init(void) {
 	/* Initialize the generic delay timer */
 	Timer_Config();
 
-	/* Configure ethernet (GPIOs, clocks, MAC, DMA) */
-	ETH_BSP_Config();
+	/* Configure the ethernet GPIOs and clocks and put the PHY in reset */
+	ETH_BSP_Start();
+	PHYResetElapsed = false;
+	if (Timer_ScheduleDeadline(&PHYResetDeadline, PHY_RESET_TIME_US) == false) {
+		/* Nothing else can be done during the reset, so wait it out here */
+		Delay_us(PHY_RESET_TIME_US);
+		PHYResetElapsed = true;
+	}
+	BootTimes_Mark(BOOT_NETWORK_START);
+}
+
+/**
+ * Completes the Tekdaqc's Ethernet communications started by Communication_Init(), waiting for whatever remains of
+ * the PHY reset, and starts the lwIP stack. The link does not need to be up; if it is not, the link callback
+ * negotiates it, and DHCP runs from the periodic handler, once it is.
+ *
+ * @param none
+ * @retval none
+ */
+void Communication_Complete(void) {
+	while (PHYResetElapsed == false) {
+		Timer_ServiceDeadlines();
+	}
+	BootTimes_Mark(BOOT_PHY_WAIT);
+
+	/* Configure the ethernet MAC and DMA */
+	ETH_BSP_Complete();
 
 	/* Initilaize the LwIP stack */
 	LwIP_Init();
+	BootTimes_Mark(BOOT_NETWORK_COMPLETE);
 }
 
 /**
@@ -409,30 +460,4 @@ void TestPin_Toggle(TestPin_TypeDef pin) {
 	GPIO_PORT[pin]->ODR ^= GPIO_PIN[pin];
 }
 
-/**
- * Initialize COM2 interface for serial debug
- *
- * @param  none
- * @retval none
- */
-void DebugComPort_Init(void) {
-	USART_InitTypeDef USART_InitStructure;
-
-	/* USARTx configured as follow:
-	 - BaudRate = 115200 baud
-	 - Word Length = 8 Bits
-	 - One Stop Bit
-	 - No parity
-	 - Hardware flow control disabled (RTS and CTS signals)
-	 - Receive and transmit enabled
-	 */
-	USART_InitStructure.USART_BaudRate = 115200;
-	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
-	USART_InitStructure.USART_StopBits = USART_StopBits_1;
-	USART_InitStructure.USART_Parity = USART_Parity_No;
-	USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
-	USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
-	COMInit(COM2, &USART_InitStructure);
-}
-
 #endif /*DEBUG*/
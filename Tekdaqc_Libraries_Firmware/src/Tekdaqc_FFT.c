@@ -0,0 +1,244 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_FFT.c
+ * @brief Implements the real FFT of the Tekdaqc.
+ *
+ * A block of N real samples is transformed as an N/2 point complex FFT of its even and odd samples, an iterative
+ * radix-2 decimation in time, and the two halves are then separated into the N/2 + 1 bins of the real spectrum. The
+ * result is packed in place as by the CMSIS arm_rfft_fast_f32(): element 0 holds the real DC bin, element 1 the real
+ * bin at half the sample rate, and elements 2k and 2k + 1 the real and imaginary parts of bin k. The twiddle factors
+ * come from a quarter wave cosine table for FFT_MAX_POINTS, built on first use and strided for smaller blocks, so no
+ * trigonometric function is called per transform.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_FFT.h"
+#include <math.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def FFT_PI
+ * @brief The value of pi used to build the cosine table.
+ */
+#define FFT_PI			3.14159265358979f
+
+/**
+ * @internal
+ * @def FFT_QUARTER
+ * @brief The table index of a quarter turn.
+ */
+#define FFT_QUARTER		(FFT_MAX_POINTS / 4U)
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The cosine of each angle 2 * pi * i / FFT_MAX_POINTS of the first quarter turn, both ends included. */
+static float cosTable[FFT_QUARTER + 1U];
+
+/* TRUE once the cosine table has been built. */
+static bool tableReady = false;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Builds the cosine table if it has not been already.
+ */
+static void BuildTable(void);
+
+/**
+ * @internal
+ * @brief Looks up the cosine and sine of an angle of up to half a turn.
+ */
+static void LookupTwiddle(uint32_t index, float* cosine, float* sine);
+
+/**
+ * @internal
+ * @brief Performs a complex FFT in place.
+ */
+static void ComplexFFT(float* data, uint16_t points);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Builds the cosine table if it has not been already.
+ *
+ * @param none
+ * @retval none
+ */
+static void BuildTable(void) {
+	if (tableReady == true) {
+		return;
+	}
+	for (uint32_t i = 0U; i <= FFT_QUARTER; ++i) {
+		cosTable[i] = cosf((2.0f * FFT_PI * (float) i) / (float) FFT_MAX_POINTS);
+	}
+	tableReady = true;
+}
+
+/**
+ * Looks up the cosine and sine of the angle 2 * pi * index / FFT_MAX_POINTS from the quarter wave table.
+ *
+ * @param index uint32_t The angle in table steps, at most half a turn.
+ * @param cosine float* Set to the cosine of the angle.
+ * @param sine float* Set to the sine of the angle.
+ * @retval none
+ */
+static void LookupTwiddle(uint32_t index, float* cosine, float* sine) {
+	if (index <= FFT_QUARTER) {
+		*cosine = cosTable[index];
+		*sine = cosTable[FFT_QUARTER - index];
+	} else {
+		*cosine = -cosTable[(2U * FFT_QUARTER) - index];
+		*sine = cosTable[index - FFT_QUARTER];
+	}
+}
+
+/**
+ * Performs a radix-2 decimation in time FFT in place on interleaved complex values.
+ *
+ * @param data float* The real and imaginary parts of each value, in turn.
+ * @param points uint16_t The number of complex values, a power of 2 of at most FFT_MAX_POINTS / 2.
+ * @retval none
+ */
+static void ComplexFFT(float* data, uint16_t points) {
+	/* Put the values in bit reversed order */
+	uint32_t j = 0U;
+	for (uint32_t i = 1U; i < points; ++i) {
+		uint32_t bit = points >> 1U;
+		while ((j & bit) != 0U) {
+			j ^= bit;
+			bit >>= 1U;
+		}
+		j ^= bit;
+		if (i < j) {
+			const float re = data[2U * i];
+			const float im = data[(2U * i) + 1U];
+			data[2U * i] = data[2U * j];
+			data[(2U * i) + 1U] = data[(2U * j) + 1U];
+			data[2U * j] = re;
+			data[(2U * j) + 1U] = im;
+		}
+	}
+	for (uint32_t length = 2U; length <= points; length <<= 1U) {
+		const uint32_t half = length >> 1U;
+		const uint32_t stride = FFT_MAX_POINTS / length;
+		for (uint32_t m = 0U; m < half; ++m) {
+			float c;
+			float s;
+			LookupTwiddle(m * stride, &c, &s);
+			for (uint32_t a = m; a < points; a += length) {
+				const uint32_t b = a + half;
+				/* Multiply by the twiddle factor c - is */
+				const float tr = (c * data[2U * b]) + (s * data[(2U * b) + 1U]);
+				const float ti = (c * data[(2U * b) + 1U]) - (s * data[2U * b]);
+				data[2U * b] = data[2U * a] - tr;
+				data[(2U * b) + 1U] = data[(2U * a) + 1U] - ti;
+				data[2U * a] += tr;
+				data[(2U * a) + 1U] += ti;
+			}
+		}
+	}
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Determines if a number of points is a block size which may be transformed, a power of 2 from FFT_MIN_POINTS to
+ * FFT_MAX_POINTS.
+ *
+ * @param points uint16_t The number of points.
+ * @retval bool TRUE if a block of the size may be transformed.
+ */
+bool FFT_IsValidSize(uint16_t points) {
+	return (points >= FFT_MIN_POINTS) && (points <= FFT_MAX_POINTS) && ((points & (points - 1U)) == 0U);
+}
+
+/**
+ * Multiplies a block of samples by a periodic Hann window, which sums to half the number of points.
+ *
+ * @param data float* The samples.
+ * @param points uint16_t The number of samples, a valid FFT size.
+ * @retval none
+ */
+void FFT_ApplyHannWindow(float* data, uint16_t points) {
+	BuildTable();
+	const uint32_t stride = FFT_MAX_POINTS / points;
+	for (uint32_t n = 0U; n < points; ++n) {
+		uint32_t index = n * stride;
+		if (index > (2U * FFT_QUARTER)) {
+			/* The cosine is symmetric about half a turn */
+			index = FFT_MAX_POINTS - index;
+		}
+		float c;
+		float s;
+		LookupTwiddle(index, &c, &s);
+		data[n] *= 0.5f - (0.5f * c);
+	}
+}
+
+/**
+ * Transforms a block of real samples in place to its spectrum, packed as described at the top of this file.
+ *
+ * @param data float* The samples, replaced by the spectrum.
+ * @param points uint16_t The number of samples, a valid FFT size.
+ * @retval none
+ */
+void FFT_Real(float* data, uint16_t points) {
+	BuildTable();
+	const uint32_t half = points >> 1U;
+	/* Transform the even samples as the real parts and the odd samples as the imaginary parts */
+	ComplexFFT(data, (uint16_t) half);
+	const float dc = data[0];
+	data[0] = dc + data[1];
+	data[1] = dc - data[1];
+	const uint32_t stride = FFT_MAX_POINTS / points;
+	for (uint32_t k = 1U; k < (half >> 1U); ++k) {
+		const uint32_t j = half - k;
+		/* The spectra of the even and odd samples at k, the values at j are their conjugates */
+		const float evenRe = 0.5f * (data[2U * k] + data[2U * j]);
+		const float evenIm = 0.5f * (data[(2U * k) + 1U] - data[(2U * j) + 1U]);
+		const float oddRe = 0.5f * (data[(2U * k) + 1U] + data[(2U * j) + 1U]);
+		const float oddIm = -0.5f * (data[2U * k] - data[2U * j]);
+		float c;
+		float s;
+		LookupTwiddle(k * stride, &c, &s);
+		const float tr = (c * oddRe) + (s * oddIm);
+		const float ti = (c * oddIm) - (s * oddRe);
+		data[2U * k] = evenRe + tr;
+		data[(2U * k) + 1U] = evenIm + ti;
+		data[2U * j] = evenRe - tr;
+		data[(2U * j) + 1U] = ti - evenIm;
+	}
+	/* At a quarter of the sample rate the twiddle factor is -i, which only conjugates the value */
+	data[half + 1U] = -data[half + 1U];
+}
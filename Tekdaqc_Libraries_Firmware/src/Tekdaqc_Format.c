@@ -0,0 +1,192 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Format.c
+ * @brief Implements the integer formatting routines of the Tekdaqc.
+ *
+ * Digits are produced two at a time from a table of digit pairs, which halves the number of divisions. The divisions
+ * by constants are compiled to multiplications, so a 32 bit value costs only a few cycles per digit pair. A 64 bit
+ * value is split into chunks of 8 digits, needing at most two 64 bit divisions, rather than the division per digit
+ * the C library does.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Format.h"
+#include <string.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def FORMAT_CHUNK_DIVISOR
+ * @brief The divisor splitting a 64 bit value into chunks of 8 digits, each of which fits in 32 bits.
+ */
+#define FORMAT_CHUNK_DIVISOR	100000000U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The two digit decimal representation of 0 to 99 */
+static const char DIGIT_PAIRS[200] = "00010203040506070809"
+		"10111213141516171819"
+		"20212223242526272829"
+		"30313233343536373839"
+		"40414243444546474849"
+		"50515253545556575859"
+		"60616263646566676869"
+		"70717273747576777879"
+		"80818283848586878889"
+		"90919293949596979899";
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Writes the digits of a value backwards from the end of a buffer.
+ */
+static char* WriteDigitsBackward(char* end, uint32_t value);
+
+/**
+ * @internal
+ * @brief Writes exactly 8 digits of a value, zero padded, backwards from the end of a buffer.
+ */
+static char* WriteChunkBackward(char* end, uint32_t value);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Writes the digits of a value backwards from the end of a buffer, without leading zeros.
+ *
+ * @param end char* One past the last character to write.
+ * @param value uint32_t The value to write.
+ * @retval char* The first character written.
+ */
+static char* WriteDigitsBackward(char* end, uint32_t value) {
+	while (value >= 100U) {
+		const uint32_t pair = (value % 100U) * 2U;
+		value /= 100U;
+		*--end = DIGIT_PAIRS[pair + 1U];
+		*--end = DIGIT_PAIRS[pair];
+	}
+	if (value >= 10U) {
+		*--end = DIGIT_PAIRS[(value * 2U) + 1U];
+		*--end = DIGIT_PAIRS[value * 2U];
+	} else {
+		*--end = (char) ('0' + value);
+	}
+	return end;
+}
+
+/**
+ * Writes exactly 8 digits of a value, zero padded, backwards from the end of a buffer.
+ *
+ * @param end char* One past the last character to write.
+ * @param value uint32_t The value to write, less than FORMAT_CHUNK_DIVISOR.
+ * @retval char* The first character written.
+ */
+static char* WriteChunkBackward(char* end, uint32_t value) {
+	for (uint_fast8_t i = 0U; i < 4U; ++i) {
+		const uint32_t pair = (value % 100U) * 2U;
+		value /= 100U;
+		*--end = DIGIT_PAIRS[pair + 1U];
+		*--end = DIGIT_PAIRS[pair];
+	}
+	return end;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Formats an unsigned 32 bit integer as decimal text, as printf's %u would.
+ *
+ * @param dest char* The location to write to, with room for FORMAT_UINT32_MAX_LENGTH characters and a NULL.
+ * @param value uint32_t The value to format.
+ * @retval uint8_t The number of characters written, not counting the terminating NULL.
+ */
+uint8_t Format_UInt32(char* dest, uint32_t value) {
+	char digits[FORMAT_UINT32_MAX_LENGTH];
+	char* const end = &digits[FORMAT_UINT32_MAX_LENGTH];
+	const char* start = WriteDigitsBackward(end, value);
+	const uint8_t length = (uint8_t) (end - start);
+	memcpy(dest, start, length);
+	dest[length] = '\0';
+	return length;
+}
+
+/**
+ * Formats a signed 32 bit integer as decimal text, as printf's %i would.
+ *
+ * @param dest char* The location to write to, with room for FORMAT_INT32_MAX_LENGTH characters and a NULL.
+ * @param value int32_t The value to format.
+ * @retval uint8_t The number of characters written, not counting the terminating NULL.
+ */
+uint8_t Format_Int32(char* dest, int32_t value) {
+	if (value < 0) {
+		/* Negate in unsigned arithmetic so INT32_MIN is formatted correctly */
+		dest[0] = '-';
+		return Format_UInt32(&dest[1], 0U - (uint32_t) value) + 1U;
+	}
+	return Format_UInt32(dest, (uint32_t) value);
+}
+
+/**
+ * Formats an unsigned 64 bit integer as decimal text, as printf's %llu would.
+ *
+ * @param dest char* The location to write to, with room for FORMAT_UINT64_MAX_LENGTH characters and a NULL.
+ * @param value uint64_t The value to format.
+ * @retval uint8_t The number of characters written, not counting the terminating NULL.
+ */
+uint8_t Format_UInt64(char* dest, uint64_t value) {
+	char digits[FORMAT_UINT64_MAX_LENGTH];
+	char* const end = &digits[FORMAT_UINT64_MAX_LENGTH];
+	char* start = end;
+	while (value > UINT32_MAX) {
+		const uint64_t quotient = value / FORMAT_CHUNK_DIVISOR;
+		start = WriteChunkBackward(start, (uint32_t) (value - (quotient * FORMAT_CHUNK_DIVISOR)));
+		value = quotient;
+	}
+	start = WriteDigitsBackward(start, (uint32_t) value);
+	const uint8_t length = (uint8_t) (end - start);
+	memcpy(dest, start, length);
+	dest[length] = '\0';
+	return length;
+}
+
+/**
+ * Retrieves the length of a string held in a fixed size field, as POSIX strnlen() would. The C library does not
+ * declare strnlen() in strict C99 builds, so it is not relied on.
+ *
+ * @param str const char* The string to measure.
+ * @param max size_t The size of the field holding it. Only this many characters are read.
+ * @retval size_t The number of characters before the terminating NULL, or max if there is none.
+ */
+size_t Format_BoundedLength(const char* str, size_t max) {
+	const char* end = (const char*) memchr(str, '\0', max);
+	return (end != NULL) ? (size_t) (end - str) : max;
+}
@@ -27,10 +27,11 @@
 
 #include "Tekdaqc_Debug.h"
 #include "Tekdaqc_Locator.h"
-#include "TelnetServer.h"
+#include "Tekdaqc_Timers.h"
 #include "Tekdaqc_BSP.h"
 #include "boolean.h"
 #include "lwip/udp.h"
+#include <string.h>
 
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE DEFINES */
@@ -57,6 +58,20 @@
  */
 #define LOCATOR_DATA_LENGTH     115U
 
+/**
+ * @internal
+ * @def LOCATOR_STATUS_LENGTH
+ * @brief The length of the extended status packet returned.
+ */
+#define LOCATOR_STATUS_LENGTH   125U
+
+/**
+ * @internal
+ * @def LOCATOR_REPLY_INTERVAL_US
+ * @brief The shortest time in microseconds between two replies. Queries arriving sooner are dropped, so a discovery
+ * storm from many hosts costs little more than receiving it; hosts repeat their queries until they are answered.
+ */
+#define LOCATOR_REPLY_INTERVAL_US	5000U
 
 
 /*--------------------------------------------------------------------------------------------------------*/
@@ -82,12 +97,39 @@
  */
 static unsigned char LocatorData[LOCATOR_DATA_LENGTH];
 
+/*
+ * An array that contains the extended status response data. Bytes 0 to 113
+ * are the same as those of LocatorData, except for the Packet Length, and are
+ * followed by the load of the board:
+ *
+ * Byte        Description
+ * --------    ------------------------
+ * 114         Sampling (LOCATOR_SAMPLING_* flags)
+ * 115         Number of analog inputs being sampled
+ * 116..119    Achieved analog samples per second
+ * 120         Connected Telnet sessions
+ * 121         Maximum Telnet sessions
+ * 122..123    Lowest free Telnet transmit buffer space in bytes
+ * 124         Checksum
+ */
+static unsigned char LocatorStatusData[LOCATOR_STATUS_LENGTH];
+
 /* The contents of the received UDP packet that will cause the Tekdaqc to return a response */
 static unsigned char LocatorMessage[] = "TEKDAQC CONNECT";
 
+/* The contents of the received UDP packet that will cause the Tekdaqc to return the extended status response */
+static unsigned char LocatorStatusMessage[] = "TEKDAQC STATUS";
+
 /* The length of the expected UDP packet message */
 static uint8_t LengthLocatorMessage = 14U;
 
+/* The replies sent to every query, kept up to date with their data. NULL until allocated */
+static struct pbuf* LocatorReply = NULL;
+static struct pbuf* LocatorStatusReply = NULL;
+
+/* The local time at which the last reply was sent */
+static uint64_t LastReplyTime = 0U;
+
 
 
 /*--------------------------------------------------------------------------------------------------------*/
@@ -99,16 +141,87 @@ static uint8_t LengthLocatorMessage = 14U;
  */
 static void Tekdaqc_LocatorReceive(void *arg, struct udp_pcb *pcb, struct pbuf *p, struct ip_addr *addr, uint16_t port);
 
+/**
+ * @internal
+ * @brief Updates the checksums and the prepared replies after a field of the response data changed.
+ */
+static void LocatorDataChanged(void);
+
+/**
+ * @internal
+ * @brief Updates the checksum and the prepared reply of a response.
+ */
+static void LocatorUpdateReply(struct pbuf* reply, unsigned char* data, uint16_t length);
+
+/**
+ * @internal
+ * @brief Retrieves a prepared reply, allocating it if necessary.
+ */
+static struct pbuf* LocatorGetReply(struct pbuf** reply, const unsigned char* data, uint16_t length);
+
 
 
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE FUNCTIONS */
 /*--------------------------------------------------------------------------------------------------------*/
 
+/**
+ * Recalculates the checksums of the response data and copies them to the prepared replies, so that nothing is
+ * computed when a query is answered.
+ *
+ * @param none
+ * @retval none
+ */
+static void LocatorDataChanged(void) {
+	memcpy(LocatorStatusData, LocatorData, LOCATOR_DATA_LENGTH - 1U);
+	LocatorStatusData[1] = sizeof(LocatorStatusData);
+	LocatorUpdateReply(LocatorReply, LocatorData, sizeof(LocatorData));
+	LocatorUpdateReply(LocatorStatusReply, LocatorStatusData, sizeof(LocatorStatusData));
+}
+
+/**
+ * Recalculates the checksum in the last byte of a response and copies the response to its prepared reply.
+ *
+ * @param reply pbuf* The prepared reply, NULL if it is not allocated.
+ * @param data unsigned char* The response data.
+ * @param length uint16_t The length of the response data, including the checksum.
+ * @retval none
+ */
+static void LocatorUpdateReply(struct pbuf* reply, unsigned char* data, uint16_t length) {
+	data[length - 1U] = 0U;
+	for (uint16_t i = 0U; i < (length - 1U); ++i) {
+		data[length - 1U] -= data[i];
+	}
+	if (reply != NULL) {
+		memcpy(reply->payload, data, length);
+	}
+}
+
+/**
+ * Retrieves a prepared reply. It is allocated with room for the protocol headers, which are stripped again after
+ * each reply so the same buffer is sent every time.
+ *
+ * @param reply pbuf** The prepared reply, allocated if it is NULL.
+ * @param data const unsigned char* The response data.
+ * @param length uint16_t The length of the response data.
+ * @retval pbuf* The reply, NULL if it could not be allocated.
+ */
+static struct pbuf* LocatorGetReply(struct pbuf** reply, const unsigned char* data, uint16_t length) {
+	if (*reply == NULL) {
+		*reply = pbuf_alloc(PBUF_TRANSPORT, length, PBUF_RAM);
+		if (*reply != NULL) {
+			memcpy((*reply)->payload, data, length);
+		}
+	}
+	return *reply;
+}
+
 /**
  * This function is called by the lwIP TCP/IP stack when it receives a UDP
- * packet from the discovery port.  It produces the response packet, which is
- * sent back to the querying client.
+ * packet from the discovery port.  It sends the prepared response packet, or
+ * the extended status packet for a status query, back to the querying client,
+ * at most once every LOCATOR_REPLY_INTERVAL_US. Queries are answered whether or
+ * not clients are connected.
  *
  * @param arg void* Argument pointer passed to the handler by the lwIP stack.
  * @param pcb udp_pcb* struct The PCB structure this callback is for.
@@ -122,57 +235,51 @@ static void Tekdaqc_LocatorReceive(void *arg, struct udp_pcb *pcb, struct pbuf *
 	printf("[Locator] Packet received.\n\r");
 #endif
 
-	if (TelnetIsConnected() == TRUE) {
-#ifdef LOCATOR_DEBUG
-		printf("[Locator] Packet received while Telnet connection is active. Ignoring.\n\r");
-#endif
-		return;
-	}
-
-	unsigned char *data;
-	int i = 0;
-
-	/* Validate the contents of the datagram. This expects to see a message that matches the variable LocatorMessage */
-	data = p->payload;
-	if ((p->len != LengthLocatorMessage) || (p->len < LengthLocatorMessage)) {
-		bool VALID = true;
-		for (i = 0; i < p->len; ++i) {
-			if (data[i] != LocatorMessage[i]) {
-				VALID = false;
-				break;
-			}
-		}
-		if (!VALID) {
-			pbuf_free(p);
-			return;
+	/* Validate the contents of the datagram. This expects to see a message that starts with LocatorMessage or
+	 LocatorStatusMessage */
+	struct pbuf** reply = NULL;
+	const unsigned char* data = LocatorData;
+	uint16_t length = sizeof(LocatorData);
+	if (p->tot_len >= LengthLocatorMessage) {
+		if (pbuf_memcmp(p, 0U, LocatorMessage, LengthLocatorMessage) == 0U) {
+			reply = &LocatorReply;
+		} else if (pbuf_memcmp(p, 0U, LocatorStatusMessage, LengthLocatorMessage) == 0U) {
+			reply = &LocatorStatusReply;
+			data = LocatorStatusData;
+			length = sizeof(LocatorStatusData);
 		}
 	}
 
 	/* The incoming pbuf is no longer needed, so free it. */
 	pbuf_free(p);
-
-	/* Allocate a new pbuf for sending the response. */
-	p = pbuf_alloc(PBUF_TRANSPORT, sizeof(LocatorData), PBUF_RAM);
-	if (p == NULL ) {
+	if (reply == NULL) {
 		return;
 	}
 
-	/* Calculate and fill in the checksum on the response packet. */
-	LocatorData[sizeof(LocatorData) - 1U] = 0U;
-	for (i = 0U; i < (sizeof(LocatorData) - 1U); ++i) {
-		LocatorData[sizeof(LocatorData) - 1U] -= LocatorData[i];
+	const uint64_t now = GetLocalTime();
+	if ((now - LastReplyTime) < LOCATOR_REPLY_INTERVAL_US) {
+#ifdef LOCATOR_DEBUG
+		printf("[Locator] Query received too soon after the last reply. Ignoring.\n\r");
+#endif
+		return;
 	}
 
-	/* Copy the response packet data into the pbuf. */
-	data = p->payload;
-	for (i = 0; i < sizeof(LocatorData); ++i) {
-		data[i] = LocatorData[i];
+	p = LocatorGetReply(reply, data, length);
+	if (p == NULL) {
+		return;
 	}
+	LastReplyTime = now;
 
 	/* Send the response. */
 	udp_sendto(pcb, p, addr, port);
-	/* Free the pbuf. */
-	pbuf_free(p);
+	if (p->ref > 1U) {
+		/* It was queued waiting for ARP, so it is left to the stack and a new one is prepared for the next reply */
+		pbuf_free(p);
+		*reply = NULL;
+	} else {
+		/* Strip the headers prepended while sending */
+		pbuf_header(p, -((s16_t) (p->tot_len - length)));
+	}
 }
 
 
@@ -213,10 +320,40 @@ void Tekdaqc_LocatorInit(void) {
 	/* Fill in the Board Type */
 	Tekdaqc_LocatorBoardTypeSet(TEKDAQC_BOARD_TYPE );
 
+	/* Fill in the address the network came up with, a static address or a reused lease is known before DHCP runs */
+	if (netif_default != NULL) {
+		Tekdaqc_LocatorClientIPSet(netif_default->ip_addr.addr);
+	}
+
 	/* Create a new UDP port for listening to device locator requests. */
 	pcb = udp_new();
 	udp_recv(pcb, Tekdaqc_LocatorReceive, NULL);
 	udp_bind(pcb, IP_ADDR_ANY, LOCATOR_PORT);
+
+	/* Prepare the replies up front */
+	LocatorGetReply(&LocatorReply, LocatorData, sizeof(LocatorData));
+	LocatorGetReply(&LocatorStatusReply, LocatorStatusData, sizeof(LocatorStatusData));
+	LocatorDataChanged();
+}
+
+/**
+ * This function sets the load fields of the extended status response packet.
+ *
+ * @param load const Tekdaqc_LocatorLoad_t* Pointer to the current load of the board.
+ * @retval none
+ */
+void Tekdaqc_LocatorLoadSet(const Tekdaqc_LocatorLoad_t* load) {
+	LocatorStatusData[114] = load->sampling;
+	LocatorStatusData[115] = load->analogInputs;
+	LocatorStatusData[116] = (uint8_t) ((load->samplesPerSecond >> 24U) & 0xffU);
+	LocatorStatusData[117] = (uint8_t) ((load->samplesPerSecond >> 16U) & 0xffU);
+	LocatorStatusData[118] = (uint8_t) ((load->samplesPerSecond >> 8U) & 0xffU);
+	LocatorStatusData[119] = (uint8_t) (load->samplesPerSecond & 0xffU);
+	LocatorStatusData[120] = load->sessions;
+	LocatorStatusData[121] = load->maxSessions;
+	LocatorStatusData[122] = (uint8_t) ((load->bufferFree >> 8U) & 0xffU);
+	LocatorStatusData[123] = (uint8_t) (load->bufferFree & 0xffU);
+	LocatorUpdateReply(LocatorStatusReply, LocatorStatusData, sizeof(LocatorStatusData));
 }
 
 /**
@@ -228,6 +365,7 @@ void Tekdaqc_LocatorInit(void) {
 void Tekdaqc_LocatorBoardTypeSet(uint8_t type) {
 	/* Save the board type in the response data. */
 	LocatorData[3] = type;
+	LocatorDataChanged();
 }
 
 /*
@@ -241,6 +379,7 @@ void Tekdaqc_LocatorBoardIDSet(const unsigned char* id) {
 	for (int i = 0; i < BOARD_SERIAL_NUM_LENGTH; ++i) {
 		LocatorData[i + 4U] = id[i] & 0xffU;
 	}
+	LocatorDataChanged();
 }
 
 /**
@@ -255,6 +394,7 @@ void Tekdaqc_LocatorClientIPSet(uint32_t ip) {
 	LocatorData[37] = (unsigned char) ((ip >> 8U) & 0xffU);
 	LocatorData[38] = (unsigned char) ((ip >> 16U) & 0xffU);
 	LocatorData[39] = (unsigned char) ((ip >> 24U) & 0xffU);
+	LocatorDataChanged();
 }
 
 /**
@@ -272,6 +412,7 @@ void Tekdaqc_LocatorMACAddrSet(const unsigned char MAC[]) {
 	LocatorData[43] = (uint8_t) MAC[3U];
 	LocatorData[44] = (uint8_t) MAC[4U];
 	LocatorData[45] = (uint8_t) MAC[5U];
+	LocatorDataChanged();
 }
 
 /**
@@ -287,6 +428,7 @@ void Tekdaqc_LocatorVersionSet(uint32_t version) {
 	LocatorData[47] = (uint8_t) ((version >> 16U) & 0xffU);
 	LocatorData[48] = (uint8_t) ((version >> 8U) & 0xffU);
 	LocatorData[49] = (uint8_t) (version & 0xffU);
+	LocatorDataChanged();
 }
 
 /**
@@ -309,6 +451,7 @@ void LocatorAppTitleSet(const unsigned char *title) {
 	for (; count < 64U; ++count) {
 		LocatorData[count + 19U] = 0U;
 	}
+	LocatorDataChanged();
 }
 
 /**
@@ -0,0 +1,297 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Log.c
+ * @brief Implements the debug log of the Tekdaqc.
+ *
+ * Messages are formatted into a RAM ring and sent out of the debug serial port a byte at a time by its transmit
+ * interrupt, so logging never waits on the port and a build which logs keeps the timing of one which does not. Both
+ * of the DMA streams which could serve the port's transmitter are taken by the ADS1256 SPI, hence the interrupt.
+ * When the ring is full the rest of a message is dropped and counted.
+ *
+ * The ring may be written from any context, including interrupts, and is also what printf() writes to in debug
+ * builds, see _write().
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "Tekdaqc_Log.h"
+#include "Tekdaqc_BSP.h"
+#include "Tekdaqc_Config.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def LOG_BUFFER_MASK
+ * @brief Mask which reduces a ring position to an index into the ring.
+ */
+#define LOG_BUFFER_MASK (LOG_BUFFER_SIZE - 1U)
+
+#if ((LOG_BUFFER_SIZE & LOG_BUFFER_MASK) != 0U)
+#error "LOG_BUFFER_SIZE must be a power of two."
+#endif
+
+/**
+ * @internal
+ * @def LOG_BAUD_RATE
+ * @brief The baud rate of the debug serial port.
+ */
+#define LOG_BAUD_RATE 115200U
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The ring messages wait in to be sent */
+static char logBuffer[LOG_BUFFER_SIZE];
+
+/* The total number of bytes written to the ring, wrapping */
+static volatile uint32_t logHead = 0U;
+
+/* The total number of bytes sent from the ring, wrapping */
+static volatile uint32_t logTail = 0U;
+
+/* The number of bytes dropped because the ring was full */
+static volatile uint32_t logDropped = 0U;
+
+/* The level of the messages which are logged */
+static volatile LogLevel_t logLevel = LOG_LEVEL_DEFAULT;
+
+/* TRUE once the serial port has been configured */
+static volatile bool logStarted = false;
+
+/* The name of each log level, indexed by LogLevel_t */
+static const char* const LOG_LEVEL_NAMES[NUM_LOG_LEVELS] = { "NONE", "ERROR", "WARNING", "INFO", "DEBUG", "TRACE" };
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Configures the debug serial port for 115200 baud, 8 data bits, 1 stop bit and no parity, and enables its interrupt.
+ * Anything logged before this is called waits in the ring and is sent once it is.
+ *
+ * @param none
+ * @retval none
+ */
+void Log_Init(void) {
+	USART_InitTypeDef USART_InitStructure;
+	USART_InitStructure.USART_BaudRate = LOG_BAUD_RATE;
+	USART_InitStructure.USART_WordLength = USART_WordLength_8b;
+	USART_InitStructure.USART_StopBits = USART_StopBits_1;
+	USART_InitStructure.USART_Parity = USART_Parity_No;
+	USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
+	USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
+	COMInit(COM2, &USART_InitStructure);
+
+	NVIC_InitTypeDef NVIC_InitStructure;
+	NVIC_InitStructure.NVIC_IRQChannel = COM2_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = COM2_PREEMPT_PRIORITY;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0x0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	logStarted = true;
+	if (logHead != logTail) {
+		USART_ITConfig(COM2_USART, USART_IT_TXE, ENABLE);
+	}
+	__set_PRIMASK(primask);
+}
+
+/**
+ * Sets the level of the messages which are logged. Messages of a higher level are discarded before they are
+ * formatted, so leaving a level off costs a comparison.
+ *
+ * @param level LogLevel_t The highest level to log, LOG_LEVEL_NONE for nothing.
+ * @retval none
+ */
+void Log_SetLevel(LogLevel_t level) {
+	if (level < NUM_LOG_LEVELS) {
+		logLevel = level;
+	}
+}
+
+/**
+ * Retrieves the level of the messages which are logged.
+ *
+ * @param none
+ * @retval LogLevel_t The highest level logged.
+ */
+LogLevel_t Log_GetLevel(void) {
+	return logLevel;
+}
+
+/**
+ * Determines if messages of a level are logged.
+ *
+ * @param level LogLevel_t The level to check.
+ * @retval bool TRUE if messages of the level are logged.
+ */
+bool Log_IsEnabled(LogLevel_t level) {
+	return ((level != LOG_LEVEL_NONE) && (level <= logLevel)) ? true : false;
+}
+
+/**
+ * Converts a log level to its name.
+ *
+ * @param level LogLevel_t The level to convert.
+ * @retval const char* The name of the level.
+ */
+const char* Log_StringFromLevel(LogLevel_t level) {
+	return (level < NUM_LOG_LEVELS) ? LOG_LEVEL_NAMES[level] : "INVALID";
+}
+
+/**
+ * Converts the name of a log level to the level.
+ *
+ * @param name const char* The name of the level.
+ * @param level LogLevel_t* Filled in with the level.
+ * @retval bool FALSE if the name is not that of a level.
+ */
+bool Log_LevelFromString(const char* name, LogLevel_t* level) {
+	for (uint_fast8_t i = 0U; i < NUM_LOG_LEVELS; ++i) {
+		if (strcmp(name, LOG_LEVEL_NAMES[i]) == 0) {
+			*level = (LogLevel_t) i;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Formats a message into the log if its level is enabled. The message is formatted on the caller's stack and
+ * truncated to LOG_LINE_LENGTH, then copied into the ring; nothing waits on the serial port.
+ *
+ * @param level LogLevel_t The level of the message.
+ * @param format const char* The printf() format of the message.
+ * @retval none
+ */
+void Log_Printf(LogLevel_t level, const char* format, ...) {
+	if (Log_IsEnabled(level) == false) {
+		return;
+	}
+	char line[LOG_LINE_LENGTH];
+	va_list args;
+	va_start(args, format);
+	int length = vsnprintf(line, sizeof(line), format, args);
+	va_end(args);
+	if (length <= 0) {
+		return;
+	}
+	if (length >= (int) sizeof(line)) {
+		length = sizeof(line) - 1U;
+	}
+	Log_Write(line, (uint32_t) length);
+}
+
+/**
+ * Queues raw bytes to be sent out of the debug serial port, starting the transmit interrupt if it was idle. As many
+ * of the bytes as fit are queued and the rest are counted as dropped. May be called from any context.
+ *
+ * @param data const char* The bytes to send.
+ * @param length uint32_t The number of bytes.
+ * @retval uint32_t The number of bytes queued.
+ */
+uint32_t Log_Write(const char* data, uint32_t length) {
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	const uint32_t head = logHead;
+	const uint32_t space = LOG_BUFFER_SIZE - (head - logTail);
+	const uint32_t count = (length < space) ? length : space;
+	const uint32_t index = head & LOG_BUFFER_MASK;
+	/* The bytes are copied in at most two blocks, either side of the end of the ring */
+	const uint32_t first = ((LOG_BUFFER_SIZE - index) < count) ? (LOG_BUFFER_SIZE - index) : count;
+	memcpy(&logBuffer[index], data, first);
+	memcpy(logBuffer, &data[first], count - first);
+	logHead = head + count;
+	logDropped += (length - count);
+	if ((count > 0U) && (logStarted == true)) {
+		USART_ITConfig(COM2_USART, USART_IT_TXE, ENABLE);
+	}
+	__set_PRIMASK(primask);
+	return count;
+}
+
+/**
+ * Sends everything waiting in the log by polling the serial port, for use where the interrupt can not run, such as
+ * just before a reset.
+ *
+ * @param none
+ * @retval none
+ */
+void Log_Flush(void) {
+	if (logStarted == false) {
+		return;
+	}
+	while (logTail != logHead) {
+		while (USART_GetFlagStatus(COM2_USART, USART_FLAG_TXE) == RESET) {
+		}
+		const uint32_t primask = __get_PRIMASK();
+		__disable_irq();
+		if (logTail != logHead) {
+			USART_SendData(COM2_USART, (uint16_t) logBuffer[logTail & LOG_BUFFER_MASK]);
+			++logTail;
+		}
+		__set_PRIMASK(primask);
+	}
+	/* Wait for the last byte to leave the shift register */
+	while (USART_GetFlagStatus(COM2_USART, USART_FLAG_TC) == RESET) {
+	}
+}
+
+/**
+ * Retrieves the number of bytes discarded because the log was full.
+ *
+ * @param none
+ * @retval uint32_t The number of bytes dropped since start up.
+ */
+uint32_t Log_GetDroppedCount(void) {
+	return logDropped;
+}
+
+/**
+ * Sends the next waiting byte of the log out of the debug serial port, and stops the transmit interrupt once the
+ * ring is empty. The check and the stop are made with interrupts disabled, so a write from a higher priority
+ * interrupt can not slip in between them and be left waiting.
+ *
+ * @param none
+ * @retval none
+ */
+void Log_IRQHandler(void) {
+	if (USART_GetITStatus(COM2_USART, USART_IT_TXE) != RESET) {
+		const uint32_t primask = __get_PRIMASK();
+		__disable_irq();
+		if (logTail != logHead) {
+			USART_SendData(COM2_USART, (uint16_t) logBuffer[logTail & LOG_BUFFER_MASK]);
+			++logTail;
+		} else {
+			USART_ITConfig(COM2_USART, USART_IT_TXE, DISABLE);
+		}
+		__set_PRIMASK(primask);
+	}
+}
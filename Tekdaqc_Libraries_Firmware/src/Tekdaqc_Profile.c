@@ -0,0 +1,119 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Profile.c
+ * @brief Implements the hot path profiler of the Tekdaqc.
+ *
+ * Keeps the minimum, maximum and total cycle counts of each profiled path. All profiled paths run from the program
+ * loop, so the records need no protection from interrupts. Counts include the time of any interrupts taken during a
+ * run, and the DWT counter wraps after 2^32 cycles, so a single run must be shorter than that to be measured.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "Tekdaqc_Profile.h"
+#include <stddef.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The human readable names of the profile points, indexed by ProfilePoint_t */
+static const char* POINT_STRINGS[NUM_PROFILE_POINTS] = { "ADC_SERVICE", "WRITE_ANALOG_INPUT", "LWIP_PKT_HANDLE",
+		"TELNET_POLL", "COMMAND_PARSE_LINE", "COMPRESS_ANALOG_INPUT" };
+
+#ifdef HOT_PATH_PROFILE
+
+/* The cycle counts recorded for each profile point, min and max being valid once the count is non zero */
+static ProfileStatistics_t profiles[NUM_PROFILE_POINTS];
+
+#endif /* HOT_PATH_PROFILE */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#ifdef HOT_PATH_PROFILE
+
+/**
+ * Records a run of a profiled path. Called through PROFILE_END().
+ *
+ * @param point ProfilePoint_t The path which was run.
+ * @param cycles uint32_t The number of cycles the run took.
+ * @retval none
+ */
+void Profile_Record(ProfilePoint_t point, uint32_t cycles) {
+	ProfileStatistics_t* profile = &profiles[point];
+	if (profile->count == 0U) {
+		profile->min = cycles;
+		profile->max = cycles;
+	} else {
+		if (cycles < profile->min) {
+			profile->min = cycles;
+		}
+		if (cycles > profile->max) {
+			profile->max = cycles;
+		}
+	}
+	++(profile->count);
+	profile->total += cycles;
+}
+
+/**
+ * Retrieves the cycle counts recorded for a profile point since the last reset.
+ *
+ * @param point ProfilePoint_t The profile point to retrieve.
+ * @param statistics ProfileStatistics_t* The location to copy the cycle counts to.
+ * @retval bool FALSE if the point is invalid.
+ */
+bool Profile_GetStatistics(ProfilePoint_t point, ProfileStatistics_t* statistics) {
+	if ((point >= NUM_PROFILE_POINTS) || (statistics == NULL)) {
+		return false;
+	}
+	*statistics = profiles[point];
+	return true;
+}
+
+/**
+ * Discards the cycle counts recorded for all profile points.
+ *
+ * @param none
+ * @retval none
+ */
+void Profile_Reset(void) {
+	for (uint_fast8_t i = 0U; i < NUM_PROFILE_POINTS; ++i) {
+		profiles[i].count = 0U;
+		profiles[i].min = 0U;
+		profiles[i].max = 0U;
+		profiles[i].total = 0U;
+	}
+}
+
+#endif /* HOT_PATH_PROFILE */
+
+/**
+ * Return the human readable string representation of the provided profile point.
+ *
+ * @param point ProfilePoint_t The profile point to convert.
+ * @retval const char* The string representation, or NULL if the point is invalid.
+ */
+const char* Profile_StringFromPoint(ProfilePoint_t point) {
+	return (point < NUM_PROFILE_POINTS) ? POINT_STRINGS[point] : NULL;
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Rice.c
+ * @brief Implements the Rice coder of the Tekdaqc.
+ *
+ * A number n is coded with parameter k as n >> k in unary, that many 1 bits and a 0, followed by the low k bits of n.
+ * The unary part is capped at RICE_ESCAPE so a single outlier costs at most RICE_ESCAPE bits more than its full
+ * width, which bounds the time and space of every code. Writing stops, and the stream is marked as overflowed, as soon
+ * as it would pass its limit.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Rice.h"
+#include <stddef.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Starts a bit stream in a buffer.
+ *
+ * @param writer RiceWriter_t* The stream to start.
+ * @param dest uint8_t* The buffer to write to.
+ * @param limit uint16_t The most bytes which may be written.
+ * @retval none
+ */
+void Rice_Begin(RiceWriter_t* writer, uint8_t* dest, uint16_t limit) {
+	writer->dest = dest;
+	writer->limit = limit;
+	writer->length = 0U;
+	writer->accumulator = 0U;
+	writer->pending = 0U;
+	writer->overflow = false;
+}
+
+/**
+ * Writes a number of bits to a bit stream, least significant first. Nothing is written once the stream has
+ * overflowed.
+ *
+ * @param writer RiceWriter_t* The stream to write to.
+ * @param value uint32_t The bits to write. Bits above the count are ignored.
+ * @param bits uint8_t The number of bits to write, at most 24.
+ * @retval none
+ */
+void Rice_WriteBits(RiceWriter_t* writer, uint32_t value, uint8_t bits) {
+	if ((writer->overflow == true) || (bits == 0U)) {
+		return;
+	}
+	/* Fewer than 8 bits are ever pending, so up to 24 more always fit */
+	writer->accumulator |= (value & ((1UL << bits) - 1U)) << writer->pending;
+	writer->pending += bits;
+	while (writer->pending >= 8U) {
+		if (writer->length >= writer->limit) {
+			writer->overflow = true;
+			return;
+		}
+		writer->dest[writer->length++] = (uint8_t) writer->accumulator;
+		writer->accumulator >>= 8U;
+		writer->pending -= 8U;
+	}
+}
+
+/**
+ * Writes a Rice coded number to a bit stream. A number whose quotient would reach RICE_ESCAPE is written as
+ * RICE_ESCAPE 1 bits followed by the number in full.
+ *
+ * @param writer RiceWriter_t* The stream to write to.
+ * @param value uint32_t The number to write.
+ * @param k uint8_t The Rice parameter, less than the width.
+ * @param width uint8_t The number of bits the number is sent in when escaped, at most 24 plus k.
+ * @retval none
+ */
+void Rice_WriteCode(RiceWriter_t* writer, uint32_t value, uint8_t k, uint8_t width) {
+	const uint32_t quotient = value >> k;
+	if (quotient < RICE_ESCAPE) {
+		/* The quotient as 1 bits followed by the terminating 0 */
+		Rice_WriteBits(writer, (1UL << quotient) - 1U, (uint8_t) (quotient + 1U));
+		Rice_WriteBits(writer, value, k);
+	} else {
+		Rice_WriteBits(writer, (1UL << RICE_ESCAPE) - 1U, RICE_ESCAPE);
+		if (width > 24U) {
+			Rice_WriteBits(writer, value, 24U);
+			Rice_WriteBits(writer, value >> 24U, width - 24U);
+		} else {
+			Rice_WriteBits(writer, value, width);
+		}
+	}
+}
+
+/**
+ * Completes a bit stream, padding its last byte with zeros.
+ *
+ * @param writer RiceWriter_t* The stream to complete.
+ * @retval uint16_t The length of the stream in bytes, 0 if it did not fit in its limit.
+ */
+uint16_t Rice_End(RiceWriter_t* writer) {
+	if (writer->pending > 0U) {
+		Rice_WriteBits(writer, 0U, 8U - writer->pending);
+	}
+	return (writer->overflow == true) ? 0U : writer->length;
+}
+
+/**
+ * Chooses the Rice parameter for numbers of a given mean, the bit length of the mean less one, which is close to
+ * optimal for geometrically distributed numbers.
+ *
+ * @param sum uint32_t The sum of the numbers.
+ * @param count uint32_t The count of the numbers.
+ * @param max uint8_t The largest parameter which may be chosen.
+ * @retval uint8_t The Rice parameter.
+ */
+uint8_t Rice_ChooseParameter(uint32_t sum, uint32_t count, uint8_t max) {
+	const uint32_t mean = (count > 0U) ? (sum / count) : 0U;
+	const uint8_t k = (mean > 0U) ? (uint8_t) (31U - __CLZ(mean)) : 0U;
+	return (k > max) ? max : k;
+}
+
+/**
+ * Maps a signed number onto the unsigned numbers, small magnitudes first: 0, -1, 1, -2, 2 and so on map to 0, 1, 2,
+ * 3, 4.
+ *
+ * @param value int32_t The number to map.
+ * @retval uint32_t The mapped number.
+ */
+uint32_t Rice_ZigZag(int32_t value) {
+	return ((uint32_t) value << 1U) ^ (uint32_t) (value >> 31);
+}
@@ -0,0 +1,716 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_SampleLog.c
+ * @brief Implements the store and forward log of sample data.
+ *
+ * While sample data has no destination, the writes it would have made are logged as records in the FLASH sector set
+ * aside for the log. A record is copied into a RAM stage and returns at once; the storage task programs the staged
+ * records a few words at a time, so sampling carries on through an outage. Once there is a destination again, the
+ * storage task replays the records in the order they were logged, straight from FLASH and as fast as the destination
+ * takes them. Data written while records are waiting is logged behind them, so the order is kept across the replay.
+ *
+ * Each record is a header word followed by its data, padded to a whole word. The header holds the length and type
+ * of the record and a state byte, which is cleared once the record has been replayed. The header is programmed
+ * after the data, so a reset part way through a record never leaves a header for data which is not there. The log
+ * is append only: the sector is erased once every record in it has been replayed, but only while the inputs are
+ * idle, since an erase stalls the CPU. A log left full while sampling takes no more records until then. The first
+ * word of the sector marks it as in use, and is cleared to abandon the records in it.
+ *
+ * There is a single sector free for the log, so it is not wear levelled; it is erased at most once per outage.
+ *
+ * Every record has a sequence number, counting up across erases from 1 at start up; the sector's second word holds
+ * that of its first record. A host which has used SampleLog_Resume() is sent a marker before each replayed record:
+ *
+ *   Marker:  [SAMPLE_LOG_MARKER_START][sequence:4]
+ *
+ * with the sequence number little endian. On reconnecting, the host resumes from the last marker it received, and
+ * the records after it are replayed again if they had already been sent, so the records lost in flight with the old
+ * connection are recovered. Once a host has resumed, the sector is only erased once every record in it has been
+ * acknowledged by a later resume.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_SampleLog.h"
+#include "Tekdaqc_BSP.h"
+#include <string.h>
+
+#ifdef SAMPLE_LOG_DEBUG
+#include <stdio.h>
+#include <inttypes.h>
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def SAMPLE_LOG_MAGIC
+ * @brief The first word of a log sector holding records.
+ */
+#define SAMPLE_LOG_MAGIC			0x534C4F47U
+
+/**
+ * @internal
+ * @def SAMPLE_LOG_ABANDONED
+ * @brief The first word of a log sector whose records have been abandoned.
+ */
+#define SAMPLE_LOG_ABANDONED		0x00000000U
+
+/**
+ * @internal
+ * @def SAMPLE_LOG_ERASED
+ * @brief The value of an erased FLASH word.
+ */
+#define SAMPLE_LOG_ERASED			0xFFFFFFFFU
+
+/**
+ * @internal
+ * @def SAMPLE_LOG_SEQUENCE_ADDR
+ * @brief The address of the sequence number of the first record in the sector.
+ */
+#define SAMPLE_LOG_SEQUENCE_ADDR	(SAMPLE_LOG_BASE + sizeof(uint32_t))
+
+/**
+ * @internal
+ * @def SAMPLE_LOG_RECORDS_BASE
+ * @brief The address of the first record, after the words marking the sector.
+ */
+#define SAMPLE_LOG_RECORDS_BASE		(SAMPLE_LOG_BASE + (2U * sizeof(uint32_t)))
+
+/**
+ * @internal
+ * @def SAMPLE_LOG_MARKER_START
+ * @brief The byte which begins the marker sent before each replayed record of a resumed log (ASCII file separator).
+ */
+#define SAMPLE_LOG_MARKER_START		((uint8_t) 0x1C)
+
+/**
+ * @internal
+ * @def SAMPLE_LOG_MARKER_SIZE
+ * @brief The size in bytes of a marker.
+ */
+#define SAMPLE_LOG_MARKER_SIZE		5U
+
+/**
+ * @internal
+ * @def SAMPLE_LOG_LIMIT
+ * @brief The address just past the end of the log sector.
+ */
+#define SAMPLE_LOG_LIMIT			(SAMPLE_LOG_END + 1U)
+
+/**
+ * @internal
+ * @def SAMPLE_LOG_STAGE_WORDS
+ * @brief The number of words in the RAM stage.
+ */
+#define SAMPLE_LOG_STAGE_WORDS		(SAMPLE_LOG_STAGE_SIZE / sizeof(uint32_t))
+
+/** Record types, in the third byte of the header */
+#define SAMPLE_LOG_TYPE_STRING		0x01U
+#define SAMPLE_LOG_TYPE_BINARY		0x02U
+
+/** Record states, in the fourth byte of the header */
+#define SAMPLE_LOG_STATE_PENDING	0xFFU
+#define SAMPLE_LOG_STATE_REPLAYED	0x00U
+
+/**
+ * @internal
+ * @def SAMPLE_LOG_FLASH_ERRORS
+ * @brief The FLASH status flags cleared before each operation.
+ */
+#define SAMPLE_LOG_FLASH_ERRORS		(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR)
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The functions replayed records are written with */
+static WriteFunction stringSink = NULL;
+static BinaryWriteFunction binarySink = NULL;
+
+/* Set if sample data without a destination is logged */
+static bool enabled = false;
+
+/* Set while the log sector is being erased */
+static bool erasing = false;
+
+/* Set once the sector's first word marks it as holding records */
+static bool marked = false;
+
+/* Set when the records have been abandoned and the sector's first word is yet to be cleared */
+static bool abandonPending = false;
+
+/* The address the next record is programmed at, and the address of the next record to replay */
+static uint32_t writeAddress = SAMPLE_LOG_RECORDS_BASE;
+static uint32_t readAddress = SAMPLE_LOG_RECORDS_BASE;
+
+/* The sequence numbers of the first record in the sector, of the records at writeAddress and readAddress and of the
+ next record to be logged, which is ahead of writeSequence by the staged records */
+static uint32_t baseSequence = 1U;
+static uint32_t writeSequence = 1U;
+static uint32_t readSequence = 1U;
+static uint32_t nextSequence = 1U;
+
+/* Set once a host has resumed the log, after which replayed records are marked with their sequence numbers */
+static bool resumed = false;
+
+/* The sequence number of the last record acknowledged by a host's resume */
+static uint32_t ackedSequence = 0U;
+
+/* The staged records, a ring of words, and the number of data words of the oldest one already programmed */
+static uint32_t stage[SAMPLE_LOG_STAGE_WORDS];
+static uint16_t stageHead = 0U;
+static uint16_t stageTail = 0U;
+static uint16_t stageUsed = 0U;
+static uint16_t stageProgrammed = 0U;
+
+/* The counters reported by SampleLog_GetCounts() */
+static uint32_t loggedCount = 0U;
+static uint32_t replayedCount = 0U;
+static uint32_t droppedCount = 0U;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Retrieves the number of words a record of a given length takes, its header included.
+ */
+static uint16_t RecordWords(uint16_t length);
+
+/**
+ * @internal
+ * @brief Finds the end of the programmed records and the first record waiting to be replayed.
+ */
+static void ScanRecords(void);
+
+/**
+ * @internal
+ * @brief Abandons every record waiting in the log.
+ */
+static void Abandon(void);
+
+/**
+ * @internal
+ * @brief Starts the erase of the log sector without waiting for it to complete.
+ */
+static void StartErase(void);
+
+/**
+ * @internal
+ * @brief Copies a record into the RAM stage.
+ */
+static WriteStatus_t Stage(uint8_t type, const uint8_t* data, uint16_t length);
+
+/**
+ * @internal
+ * @brief Programs the next words of the staged records.
+ */
+static bool ProgramStaged(void);
+
+/**
+ * @internal
+ * @brief Replays the next records programmed in the log.
+ */
+static bool Replay(void);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Retrieves the number of words a record of a given length takes, its header included.
+ *
+ * @param length uint16_t The number of data bytes in the record.
+ * @retval uint16_t The number of words.
+ */
+static uint16_t RecordWords(uint16_t length) {
+	return 1U + ((length + sizeof(uint32_t) - 1U) / sizeof(uint32_t));
+}
+
+/**
+ * Walks the records programmed before the last reset to find the end of the log and the first record waiting to
+ * be replayed. Anything programmed past the last complete record, such as the data of a record whose header was
+ * never written, is skipped.
+ *
+ * @param none
+ * @retval none
+ */
+static void ScanRecords(void) {
+	uint32_t address = SAMPLE_LOG_RECORDS_BASE;
+	uint32_t sequence = baseSequence;
+	bool found = false;
+	while (address < SAMPLE_LOG_LIMIT) {
+		const uint32_t header = *(__IO uint32_t*) address;
+		const uint16_t length = (uint16_t) header;
+		const uint8_t type = (uint8_t) (header >> 16);
+		if ((header == SAMPLE_LOG_ERASED) || ((type != SAMPLE_LOG_TYPE_STRING) && (type != SAMPLE_LOG_TYPE_BINARY))
+				|| ((address + (RecordWords(length) * sizeof(uint32_t))) > SAMPLE_LOG_LIMIT)) {
+			break;
+		}
+		if ((found == false) && ((uint8_t) (header >> 24) == SAMPLE_LOG_STATE_PENDING)) {
+			readAddress = address;
+			readSequence = sequence;
+			found = true;
+		}
+		address += RecordWords(length) * sizeof(uint32_t);
+		++sequence;
+	}
+	writeSequence = sequence;
+	nextSequence = sequence;
+	/* Nothing may be programmed over words which are not erased */
+	writeAddress = SAMPLE_LOG_LIMIT;
+	while ((writeAddress > address) && (*(__IO uint32_t*) (writeAddress - sizeof(uint32_t)) == SAMPLE_LOG_ERASED)) {
+		writeAddress -= sizeof(uint32_t);
+	}
+	if (found == false) {
+		readAddress = writeAddress;
+		readSequence = writeSequence;
+	}
+}
+
+/**
+ * Abandons every record waiting in the log, both staged and programmed. The sector is marked by the next service
+ * call, so that a reset before it is erased does not bring them back; the FLASH may be busy with the EEPROM or an
+ * upgrade now.
+ *
+ * @param none
+ * @retval none
+ */
+static void Abandon(void) {
+	abandonPending = marked;
+	stageHead = 0U;
+	stageTail = 0U;
+	stageUsed = 0U;
+	stageProgrammed = 0U;
+	/* Nothing more is taken until the sector is erased */
+	readAddress = SAMPLE_LOG_LIMIT;
+	writeAddress = SAMPLE_LOG_LIMIT;
+	baseSequence = nextSequence;
+	readSequence = nextSequence;
+	writeSequence = nextSequence;
+	ackedSequence = nextSequence - 1U;
+}
+
+/**
+ * Starts the erase of the log sector without waiting for it to complete. The watchdog is reloaded first, since the
+ * CPU may stall on FLASH fetches for the duration of the erase.
+ *
+ * @param none
+ * @retval none
+ */
+static void StartErase(void) {
+	IWDG_ReloadCounter();
+	FLASH_Unlock();
+	FLASH_ClearFlag(SAMPLE_LOG_FLASH_ERRORS);
+	FLASH->CR &= ~(FLASH_CR_PSIZE | FLASH_CR_SNB);
+	FLASH->CR |= FLASH_PSIZE_WORD | FLASH_CR_SER | SAMPLE_LOG_SECTOR;
+	FLASH->CR |= FLASH_CR_STRT;
+	erasing = true;
+}
+
+/**
+ * Copies a record into the RAM stage, its header first and its last word padded with 0xFF. The record is only
+ * taken if both the stage and the log sector have room for all of it.
+ *
+ * @param type uint8_t The type of the record.
+ * @param data const uint8_t* Pointer to the record data.
+ * @param length uint16_t The number of data bytes.
+ * @retval WriteStatus_t The result of the write.
+ */
+static WriteStatus_t Stage(uint8_t type, const uint8_t* data, uint16_t length) {
+	if ((enabled == false) && (SampleLog_HasBacklog() == false)) {
+		return WRITE_NOT_CONNECTED;
+	}
+	const uint16_t words = RecordWords(length);
+	if (words > SAMPLE_LOG_STAGE_WORDS) {
+		return WRITE_TOO_LARGE;
+	}
+	if ((erasing == true) || ((SAMPLE_LOG_STAGE_WORDS - stageUsed) < words)) {
+		return WRITE_BUSY;
+	}
+	if ((writeAddress + ((uint32_t) (stageUsed + words) * sizeof(uint32_t))) > SAMPLE_LOG_LIMIT) {
+		/* The log is full, the data is lost */
+		++droppedCount;
+		return WRITE_NOT_CONNECTED;
+	}
+	stage[stageHead] = length | ((uint32_t) type << 16) | ((uint32_t) SAMPLE_LOG_STATE_PENDING << 24);
+	stageHead = (stageHead + 1U) % SAMPLE_LOG_STAGE_WORDS;
+	for (uint16_t i = 1U; i < words; ++i) {
+		uint32_t word = SAMPLE_LOG_ERASED;
+		const uint16_t count = (length < sizeof(uint32_t)) ? length : sizeof(uint32_t);
+		memcpy(&word, data, count);
+		data += count;
+		length -= count;
+		stage[stageHead] = word;
+		stageHead = (stageHead + 1U) % SAMPLE_LOG_STAGE_WORDS;
+	}
+	stageUsed += words;
+	++nextSequence;
+	++loggedCount;
+	return WRITE_OK;
+}
+
+/**
+ * Programs the next words of the staged records, at most SAMPLE_LOG_WORDS_PER_SERVICE of them. The data words of a
+ * record are programmed before its header. A failure abandons the log.
+ *
+ * @param none
+ * @retval bool TRUE if there are more staged words to program.
+ */
+static bool ProgramStaged(void) {
+	FLASH_Unlock();
+	FLASH_ClearFlag(SAMPLE_LOG_FLASH_ERRORS);
+	if (marked == false) {
+		/* The magic word commits the sector, so it goes last */
+		baseSequence = writeSequence;
+		if ((FLASH_ProgramWord(SAMPLE_LOG_SEQUENCE_ADDR, baseSequence) != FLASH_COMPLETE)
+				|| (FLASH_ProgramWord(SAMPLE_LOG_BASE, SAMPLE_LOG_MAGIC) != FLASH_COMPLETE)) {
+			Abandon();
+			++droppedCount;
+			return false;
+		}
+		marked = true;
+	}
+	for (uint_fast8_t n = 0U; (n < SAMPLE_LOG_WORDS_PER_SERVICE) && (stageUsed > 0U); ++n) {
+		const uint32_t header = stage[stageTail];
+		const uint16_t words = RecordWords((uint16_t) header);
+		uint32_t address;
+		uint32_t word;
+		if ((stageProgrammed + 1U) < words) {
+			++stageProgrammed;
+			address = writeAddress + (stageProgrammed * sizeof(uint32_t));
+			word = stage[(stageTail + stageProgrammed) % SAMPLE_LOG_STAGE_WORDS];
+		} else {
+			/* The data is in place, commit the record */
+			address = writeAddress;
+			word = header;
+			stageProgrammed = words;
+		}
+		if (FLASH_ProgramWord(address, word) != FLASH_COMPLETE) {
+#ifdef SAMPLE_LOG_DEBUG
+			printf("[Sample Log] Programming failed at 0x%08" PRIX32 ".\n\r", address);
+#endif
+			Abandon();
+			++droppedCount;
+			return false;
+		}
+		if (stageProgrammed == words) {
+			writeAddress += words * sizeof(uint32_t);
+			++writeSequence;
+			stageTail = (stageTail + words) % SAMPLE_LOG_STAGE_WORDS;
+			stageUsed -= words;
+			stageProgrammed = 0U;
+		}
+	}
+	return (stageUsed > 0U);
+}
+
+/**
+ * Replays the next records programmed in the log, at most SAMPLE_LOG_RECORDS_PER_SERVICE of them. Records already
+ * acknowledged by a resume are passed over without being sent. Replay stops at the first record its destination does
+ * not take, to be retried on the next call. Each replayed record is marked in FLASH, so a reset does not replay it
+ * again.
+ *
+ * @param none
+ * @retval bool TRUE if records were replayed and there may be more ready.
+ */
+static bool Replay(void) {
+	bool more = false;
+	for (uint_fast8_t n = 0U; (n < SAMPLE_LOG_RECORDS_PER_SERVICE) && (readAddress < writeAddress); ++n) {
+		const uint32_t header = *(__IO uint32_t*) readAddress;
+		if (header == SAMPLE_LOG_ERASED) {
+			/* The rest was programmed by a record which was never committed */
+			readAddress = writeAddress;
+			readSequence = writeSequence;
+			break;
+		}
+		const uint16_t length = (uint16_t) header;
+		const uint8_t type = (uint8_t) (header >> 16);
+		const uint8_t* data = (const uint8_t*) (readAddress + sizeof(uint32_t));
+		WriteStatus_t status = WRITE_NOT_CONNECTED;
+		if ((resumed == true) && ((int32_t) (readSequence - ackedSequence) <= 0)) {
+			/* The host already has this record */
+			status = WRITE_OK;
+		} else {
+			if ((resumed == true) && (binarySink != NULL)) {
+				uint8_t marker[SAMPLE_LOG_MARKER_SIZE];
+				marker[0] = SAMPLE_LOG_MARKER_START;
+				marker[1] = (uint8_t) readSequence;
+				marker[2] = (uint8_t) (readSequence >> 8);
+				marker[3] = (uint8_t) (readSequence >> 16);
+				marker[4] = (uint8_t) (readSequence >> 24);
+				/* A marker sent again ahead of a record which was refused is harmless, the last one received holds */
+				status = binarySink(marker, SAMPLE_LOG_MARKER_SIZE);
+				if ((status == WRITE_BUSY) || (status == WRITE_NOT_CONNECTED)) {
+					break;
+				}
+			}
+			if ((type == SAMPLE_LOG_TYPE_STRING) && (stringSink != NULL)) {
+				/* Strings are logged with their terminator, so they are written from FLASH in place */
+				status = stringSink((char*) data);
+			} else if ((type == SAMPLE_LOG_TYPE_BINARY) && (binarySink != NULL)) {
+				status = binarySink(data, length);
+			}
+			if ((status == WRITE_BUSY) || (status == WRITE_NOT_CONNECTED)) {
+				break;
+			}
+			if (status == WRITE_OK) {
+				++replayedCount;
+			} else {
+				++droppedCount;
+			}
+		}
+		if ((uint8_t) (header >> 24) == SAMPLE_LOG_STATE_PENDING) {
+			FLASH_Unlock();
+			FLASH_ClearFlag(SAMPLE_LOG_FLASH_ERRORS);
+			FLASH_ProgramByte(readAddress + 3U, SAMPLE_LOG_STATE_REPLAYED);
+		}
+		readAddress += RecordWords(length) * sizeof(uint32_t);
+		++readSequence;
+		more = true;
+	}
+	return more;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Finds the records left in the log by the last reset, which are replayed as soon as there is a destination for
+ * them. A sector which was abandoned, or does not hold a log, is erased; nothing is sampling yet, so the erase can
+ * stall the CPU now.
+ *
+ * @param stringWriter WriteFunction The function replayed strings are written with.
+ * @param binaryWriter BinaryWriteFunction The function replayed binary data is written with.
+ * @retval none
+ */
+void SampleLog_Init(WriteFunction stringWriter, BinaryWriteFunction binaryWriter) {
+	stringSink = stringWriter;
+	binarySink = binaryWriter;
+	const uint32_t mark = *(__IO uint32_t*) SAMPLE_LOG_BASE;
+	if (mark == SAMPLE_LOG_MAGIC) {
+		marked = true;
+		baseSequence = *(__IO uint32_t*) SAMPLE_LOG_SEQUENCE_ADDR;
+		ScanRecords();
+	} else {
+		marked = false;
+		writeAddress = SAMPLE_LOG_RECORDS_BASE;
+		readAddress = SAMPLE_LOG_RECORDS_BASE;
+		bool blank = true;
+		for (uint32_t address = SAMPLE_LOG_BASE; address < SAMPLE_LOG_LIMIT; address += sizeof(uint32_t)) {
+			if (*(__IO uint32_t*) address != SAMPLE_LOG_ERASED) {
+				blank = false;
+				break;
+			}
+		}
+		if (blank == false) {
+			IWDG_ReloadCounter();
+			FLASH_Unlock();
+			FLASH_ClearFlag(SAMPLE_LOG_FLASH_ERRORS);
+			if (FLASH_EraseSector(SAMPLE_LOG_SECTOR, FLASH_VOLTAGE_RANGE) != FLASH_COMPLETE) {
+				/* Try again the next time the inputs are idle */
+				readAddress = SAMPLE_LOG_LIMIT;
+				writeAddress = SAMPLE_LOG_LIMIT;
+			}
+		}
+	}
+	ackedSequence = readSequence - 1U;
+#ifdef SAMPLE_LOG_DEBUG
+	printf("[Sample Log] %" PRIu32 " bytes of records waiting to be replayed.\n\r", writeAddress - readAddress);
+#endif
+}
+
+/**
+ * Turns the logging of sample data without a destination on or off. Turning it off abandons any records waiting to be
+ * replayed.
+ *
+ * @param enable bool TRUE to log sample data without a destination.
+ * @retval none
+ */
+void SampleLog_SetEnabled(bool enable) {
+	if ((enable == false) && (SampleLog_HasBacklog() == true)) {
+		Abandon();
+	}
+	enabled = enable;
+}
+
+/**
+ * Indicates if sample data without a destination is logged.
+ *
+ * @param none
+ * @retval bool TRUE if sample data without a destination is logged.
+ */
+bool SampleLog_IsEnabled(void) {
+	return enabled;
+}
+
+/**
+ * Indicates if there are logged records waiting to be replayed. While there are, new sample data must be logged
+ * behind them rather than sent, to keep it in order.
+ *
+ * @param none
+ * @retval bool TRUE if there are records waiting.
+ */
+bool SampleLog_HasBacklog(void) {
+	return (stageUsed > 0U) || (readAddress < writeAddress);
+}
+
+/**
+ * Logs a sample data string, with its terminator. The string is either logged in full or not at all.
+ *
+ * @param string const char* Pointer to the C-String to log.
+ * @retval WriteStatus_t The result of the write.
+ */
+WriteStatus_t SampleLog_WriteString(const char* string) {
+	const size_t length = strlen(string) + 1U;
+	if (length > UINT16_MAX) {
+		return WRITE_TOO_LARGE;
+	}
+	return Stage(SAMPLE_LOG_TYPE_STRING, (const uint8_t*) string, (uint16_t) length);
+}
+
+/**
+ * Logs a block of binary sample data. The block is either logged in full or not at all.
+ *
+ * @param data const uint8_t* Pointer to the data to log.
+ * @param length uint16_t The number of bytes to log.
+ * @retval WriteStatus_t The result of the write.
+ */
+WriteStatus_t SampleLog_WriteBinary(const uint8_t* data, uint16_t length) {
+	return Stage(SAMPLE_LOG_TYPE_BINARY, data, length);
+}
+
+/**
+ * Performs the next step of the log: programming staged records, replaying programmed ones or, once every record
+ * has been replayed, erasing the sector. Must not be called while another FLASH operation is in progress.
+ *
+ * @param idle bool TRUE if the erase of the log sector may stall the CPU now.
+ * @retval bool TRUE if there is more work ready.
+ */
+bool SampleLog_Service(bool idle) {
+	if (erasing == true) {
+		if (FLASH_GetStatus() != FLASH_BUSY) {
+			FLASH->CR &= ~(FLASH_CR_SER | FLASH_CR_SNB);
+			erasing = false;
+			if (FLASH_GetStatus() == FLASH_COMPLETE) {
+				marked = false;
+				abandonPending = false;
+				writeAddress = SAMPLE_LOG_RECORDS_BASE;
+				readAddress = SAMPLE_LOG_RECORDS_BASE;
+				baseSequence = nextSequence;
+			}
+		}
+		return false;
+	}
+	if (abandonPending == true) {
+		FLASH_Unlock();
+		FLASH_ClearFlag(SAMPLE_LOG_FLASH_ERRORS);
+		FLASH_ProgramWord(SAMPLE_LOG_BASE, SAMPLE_LOG_ABANDONED);
+		abandonPending = false;
+		return true;
+	}
+	if (stageUsed > 0U) {
+		if (ProgramStaged() == true) {
+			return true;
+		}
+	}
+	if (Replay() == true) {
+		return true;
+	}
+	if ((idle == true) && (SampleLog_HasBacklog() == false) && (writeAddress != SAMPLE_LOG_RECORDS_BASE)
+			&& ((resumed == false) || ((int32_t) (writeSequence - 1U - ackedSequence) <= 0))) {
+		/* Every record has been replayed, and acknowledged if the host resumes, make the sector available again */
+		StartErase();
+	}
+	return false;
+}
+
+/**
+ * Resumes the replay of the log for a host which has received every record up to and including a sequence number.
+ * Those records are acknowledged and are not sent again; replay carries on from the record after it, going back
+ * over records which had already been sent if need be. Records which have been erased can not be replayed, the
+ * first one still held is reported so the host can tell what was lost. From now on each replayed record is preceded
+ * by a marker giving its sequence number.
+ *
+ * @param sequence uint32_t The sequence number of the last record the host has received, 0 for none.
+ * @param first uint32_t* Pointer to fill in with the sequence number of the first record to be replayed.
+ * @param last uint32_t* Pointer to fill in with the sequence number of the last record logged so far.
+ * @retval bool FALSE if the log can not be resumed now because the sector is being erased.
+ */
+bool SampleLog_Resume(uint32_t sequence, uint32_t* first, uint32_t* last) {
+	if (erasing == true) {
+		return false;
+	}
+	resumed = true;
+	/* A host can not have received records which have not been logged yet */
+	ackedSequence = ((int32_t) (sequence - nextSequence) < 0) ? sequence : (nextSequence - 1U);
+	uint32_t target = ackedSequence + 1U;
+	if ((int32_t) (target - baseSequence) < 0) {
+		target = baseSequence;
+	}
+	if ((int32_t) (target - readSequence) < 0) {
+		/* Go back to the record, walking the headers from the start of the sector */
+		uint32_t address = SAMPLE_LOG_RECORDS_BASE;
+		uint32_t current = baseSequence;
+		while ((current != target) && (address < writeAddress)
+				&& (*(__IO uint32_t*) address != SAMPLE_LOG_ERASED)) {
+			address += RecordWords((uint16_t) *(__IO uint32_t*) address) * sizeof(uint32_t);
+			++current;
+		}
+		readAddress = address;
+		readSequence = current;
+	}
+	*first = ((int32_t) (target - readSequence) > 0) ? target : readSequence;
+	*last = nextSequence - 1U;
+	return true;
+}
+
+/**
+ * Indicates if the log sector is being erased, during which no other FLASH operation may be started.
+ *
+ * @param none
+ * @retval bool TRUE if an erase is in progress.
+ */
+bool SampleLog_IsErasing(void) {
+	return erasing;
+}
+
+/**
+ * Retrieves the counters and usage of the sample log.
+ *
+ * @param counts SampleLogCounts_t* Pointer to the structure to fill in.
+ * @retval none
+ */
+void SampleLog_GetCounts(SampleLogCounts_t* counts) {
+	counts->used = (writeAddress > SAMPLE_LOG_RECORDS_BASE) ? (writeAddress - SAMPLE_LOG_BASE) : 0U;
+	counts->backlog = ((readAddress < writeAddress) ? (writeAddress - readAddress) : 0U)
+			+ ((uint32_t) stageUsed * sizeof(uint32_t));
+	counts->firstSequence = baseSequence;
+	counts->nextSequence = readSequence;
+	counts->lastSequence = nextSequence - 1U;
+	counts->logged = loggedCount;
+	counts->replayed = replayedCount;
+	counts->dropped = droppedCount;
+}
@@ -0,0 +1,614 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Scheduler.c
+ * @brief Implements the cooperative task scheduler of the Tekdaqc.
+ *
+ * Implements a small cooperative scheduler for the program loop. Tasks are run in order of priority, may be limited
+ * to a minimum period between runs and are each given a time budget for repeating while they have work ready. Tasks
+ * are never interrupted, so a budget only limits how often a task is called again within a single pass.
+ *
+ * Supervised tasks check in each time they return. A run longer than the task's timeout is counted as an overrun,
+ * and a task which goes SCHEDULER_STARVATION_US without running makes Scheduler_IsHealthy() fail so the watchdog is
+ * left to expire. While a supervised task runs its index is held in a backup register, where it survives a
+ * watchdog reset, so after the reset the task which stalled or starved can be named.
+ *
+ * When no task has work ready the program loop calls Scheduler_Idle(), which sleeps the core in a wait for interrupt
+ * until the next task or deadline is due. Interrupts which leave work for a task request a pass, both to wake the
+ * core and so that every task is given a run before the scheduler sleeps again.
+ *
+ * Interrupts which have work too slow for their priority, or which must call into lwIP or the Telnet buffers, which
+ * have no protection from interrupts with NO_SYS, defer it with Scheduler_Defer(). The queue takes any number of
+ * producers at any interrupt priorities and the program loop as its single consumer without masking interrupts: a
+ * producer reserves a slot by advancing the reserve counter with LDREX/STREX, fills it in and then marks it ready.
+ * The program loop runs ready slots in reservation order, in batches of at most SCHEDULER_DEFER_BATCH at the start
+ * of each pass, stopping at a slot still being filled by a preempted producer, which requests another pass once done.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "Tekdaqc_Scheduler.h"
+#include "Tekdaqc_Timers.h"
+#include "Tekdaqc_BSP.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Data structure holding the state of a single scheduled task.
+ */
+typedef struct {
+	TaskFunction function; /**< The body of the task. */
+	TaskPriority_t priority; /**< The priority of the task. */
+	uint32_t period; /**< The minimum time in microseconds between runs of the task. 0 runs it on every pass. */
+	uint32_t budget; /**< The time in microseconds the task may keep repeating for while it has work ready. */
+	uint64_t lastRun; /**< The local time at which the task was last run. */
+	bool ready; /**< Set while the task may have work ready, cleared when it reports none. */
+	const char* name; /**< The name the task is supervised under, NULL if it is not supervised. */
+	uint64_t lastCheckIn; /**< The local time at which the task last returned. */
+	uint32_t timeout; /**< The longest time in microseconds a single run of the task should take. */
+	uint32_t longest; /**< The longest time in microseconds a single run has taken. */
+	uint32_t overruns; /**< The number of runs which took longer than the timeout. */
+} Task_t;
+
+/**
+ * @internal
+ * @brief Data structure holding a deferral waiting to run.
+ */
+typedef struct {
+	DeferredFunction function; /**< The work to run. */
+	uint32_t argument; /**< The argument to run it with. */
+	volatile bool ready; /**< Set by the producer once the slot is filled, cleared by the program loop once taken. */
+} Deferred_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def SUPERVISOR_CAUSE_SHIFT
+ * @brief The position in the supervisor record of its SupervisorCause_t. The low bits hold the task index.
+ */
+#define SUPERVISOR_CAUSE_SHIFT 8U
+
+/**
+ * @internal
+ * @def DEFERRED_MASK
+ * @brief Masks a free running deferral counter to an index into the queue.
+ */
+#define DEFERRED_MASK (SCHEDULER_MAX_DEFERRED - 1U)
+
+#if ((SCHEDULER_MAX_DEFERRED & DEFERRED_MASK) != 0U)
+#error "SCHEDULER_MAX_DEFERRED must be a power of two."
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief The scheduled tasks.
+ */
+static Task_t Tasks[SCHEDULER_MAX_TASKS];
+
+/**
+ * @internal
+ * @brief The number of scheduled tasks.
+ */
+static uint8_t TaskCount = 0U;
+
+/**
+ * @internal
+ * @brief The index of the next low priority task to be considered.
+ */
+static uint8_t NextLowTask = 0U;
+
+/**
+ * @internal
+ * @brief Set when a new pass has been requested, typically from an interrupt, ending the repeats of a low priority task.
+ */
+static volatile bool PassRequested = false;
+
+/**
+ * @internal
+ * @brief The number of passes made since start up.
+ */
+static uint32_t PassCount = 0U;
+
+/**
+ * @internal
+ * @brief The total time in microseconds spent asleep in Scheduler_Idle().
+ */
+static uint64_t IdleTime = 0U;
+
+/**
+ * @internal
+ * @brief Set once a supervised task has starved, after which the record naming it is left alone.
+ */
+static bool Starved = false;
+
+/**
+ * @internal
+ * @brief The record left by a supervised task before the last watchdog reset.
+ */
+static uint32_t ResetRecord = 0U;
+
+/**
+ * @internal
+ * @brief The queue of deferrals, indexed by the free running counters below.
+ */
+static Deferred_t Deferred[SCHEDULER_MAX_DEFERRED];
+
+/**
+ * @internal
+ * @brief The number of slots ever reserved by producers.
+ */
+static volatile uint32_t DeferredReserved = 0U;
+
+/**
+ * @internal
+ * @brief The number of slots ever taken by the program loop.
+ */
+static volatile uint32_t DeferredTaken = 0U;
+
+/**
+ * @internal
+ * @brief The number of deferrals refused because the queue was full.
+ */
+static volatile uint32_t DeferOverflows = 0U;
+
+/**
+ * @internal
+ * @brief The human readable names of the watchdog reset causes, indexed by SupervisorCause_t.
+ */
+static const char* CAUSE_STRINGS[NUM_SUPERVISOR_CAUSES] = { "NONE", "STALLED", "STARVED" };
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Indicates if a task is due to run.
+ */
+static bool IsTaskDue(const Task_t* task, uint64_t now);
+
+/**
+ * @internal
+ * @brief Runs a task, repeating it while it has work ready and its budget allows.
+ */
+static void RunTask(Task_t* task, uint64_t now);
+
+/**
+ * @internal
+ * @brief Runs every due task of the provided priority.
+ */
+static void RunPriority(TaskPriority_t priority);
+
+/**
+ * @internal
+ * @brief Runs the next batch of ready deferrals.
+ */
+static void RunDeferred(void);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Indicates if a task is due to run, meaning its period has elapsed since it was last run.
+ *
+ * @param task const Task_t* Pointer to the task to check.
+ * @param now uint64_t The current local time.
+ * @retval bool True if the task is due.
+ */
+static bool IsTaskDue(const Task_t* task, uint64_t now) {
+	return ((task->period == 0U) || ((now - task->lastRun) >= task->period));
+}
+
+/**
+ * Runs a task once, then repeats it for as long as it reports more work ready and the time spent is within its
+ * budget. A low priority task also stops repeating once a new pass has been requested.
+ *
+ * @param task Task_t* Pointer to the task to run.
+ * @param now uint64_t The current local time.
+ * @retval none
+ */
+static void RunTask(Task_t* task, uint64_t now) {
+	task->lastRun = now;
+	const bool supervised = ((task->name != NULL) && (Starved == false));
+	if (supervised == true) {
+		/* Name the task in case it never returns */
+		RTC_WriteBackupRegister(SUPERVISOR_RECORD_REG,
+				((uint32_t) SUPERVISOR_STALLED << SUPERVISOR_CAUSE_SHIFT) | (uint32_t) (task - Tasks));
+	}
+	bool more = task->function();
+	while (more == true) {
+		if ((task->priority == TASK_PRIORITY_LOW) && (PassRequested == true)) {
+			break;
+		}
+		if ((GetLocalTime() - now) >= task->budget) {
+#ifdef SCHEDULER_DEBUG
+			printf("[Scheduler] Task %p used its budget of %" PRIu32 " us.\n\r", (void*) task->function, task->budget);
+#endif
+			break;
+		}
+		more = task->function();
+	}
+	task->ready = more;
+	if (supervised == true) {
+		RTC_WriteBackupRegister(SUPERVISOR_RECORD_REG, 0U);
+	}
+	if (task->name != NULL) {
+		/* The task checks in by returning */
+		const uint64_t end = GetLocalTime();
+		const uint32_t elapsed = ((end - now) > UINT32_MAX) ? UINT32_MAX : (uint32_t) (end - now);
+		task->lastCheckIn = end;
+		if (elapsed > task->longest) {
+			task->longest = elapsed;
+		}
+		if (elapsed > task->timeout) {
+			++(task->overruns);
+#ifdef SCHEDULER_DEBUG
+			printf("[Scheduler] Task %s overran its timeout, taking %" PRIu32 " us.\n\r", task->name, elapsed);
+#endif
+		}
+	}
+}
+
+/**
+ * Runs every due task of the provided priority, in the order they were added.
+ *
+ * @param priority TaskPriority_t The priority of the tasks to run.
+ * @retval none
+ */
+static void RunPriority(TaskPriority_t priority) {
+	for (uint_fast8_t i = 0U; i < TaskCount; ++i) {
+		if (Tasks[i].priority == priority) {
+			const uint64_t now = GetLocalTime();
+			if (IsTaskDue(&Tasks[i], now) == true) {
+				RunTask(&Tasks[i], now);
+			}
+		}
+	}
+}
+
+/**
+ * Runs up to SCHEDULER_DEFER_BATCH ready deferrals, oldest first. Each slot is freed before its work runs, so the
+ * work may itself defer more. If the batch ends with more ready another pass is requested for them.
+ *
+ * @param none
+ * @retval none
+ */
+static void RunDeferred(void) {
+	for (uint_fast8_t i = 0U; i < SCHEDULER_DEFER_BATCH; ++i) {
+		Deferred_t* slot = &Deferred[DeferredTaken & DEFERRED_MASK];
+		if (slot->ready == false) {
+			return;
+		}
+		const DeferredFunction function = slot->function;
+		const uint32_t argument = slot->argument;
+		slot->ready = false;
+		/* The slot must read as free before the producers can see it released */
+		__DMB();
+		++DeferredTaken;
+		function(argument);
+	}
+	if (Deferred[DeferredTaken & DEFERRED_MASK].ready == true) {
+		PassRequested = true;
+	}
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Adds a task to the scheduler. Tasks of the same priority are run in the order they are added.
+ *
+ * @param function TaskFunction The body of the task.
+ * @param priority TaskPriority_t The priority of the task.
+ * @param period uint32_t The minimum time in microseconds between runs of the task. 0 runs it on every pass.
+ * @param budget uint32_t The time in microseconds the task may keep repeating for while it has work ready.
+ * @retval bool True if the task was added, false if the scheduler is full.
+ */
+bool Scheduler_AddTask(TaskFunction function, TaskPriority_t priority, uint32_t period, uint32_t budget) {
+	if ((function == NULL) || (priority >= NUM_TASK_PRIORITIES) || (TaskCount >= SCHEDULER_MAX_TASKS)) {
+#ifdef SCHEDULER_DEBUG
+		printf("[Scheduler] Unable to add a task.\n\r");
+#endif
+		return false;
+	}
+	Tasks[TaskCount].function = function;
+	Tasks[TaskCount].priority = priority;
+	Tasks[TaskCount].period = period;
+	Tasks[TaskCount].budget = budget;
+	Tasks[TaskCount].lastRun = GetLocalTime();
+	Tasks[TaskCount].ready = true;
+	Tasks[TaskCount].name = NULL;
+	++TaskCount;
+	return true;
+}
+
+/**
+ * Performs a single pass of the scheduler. Every due high priority task runs, then every due normal priority task,
+ * then the next due low priority task in round robin order. The program loop calls this repeatedly, so the high
+ * priority tasks run again after each low priority task. If a pass was requested every task is assumed to have work
+ * ready until it next runs, as the interrupt may have left work for a task which is not run on this pass.
+ *
+ * @param none
+ * @retval none
+ */
+void Scheduler_Run(void) {
+	++PassCount;
+	RunDeferred();
+	if (PassRequested == true) {
+		PassRequested = false;
+		for (uint_fast8_t i = 0U; i < TaskCount; ++i) {
+			Tasks[i].ready = true;
+		}
+	}
+	RunPriority(TASK_PRIORITY_HIGH);
+	RunPriority(TASK_PRIORITY_NORMAL);
+	for (uint_fast8_t n = 0U; n < TaskCount; ++n) {
+		Task_t* task = &Tasks[NextLowTask];
+		NextLowTask = (uint8_t) ((NextLowTask + 1U) % TaskCount);
+		if (task->priority == TASK_PRIORITY_LOW) {
+			const uint64_t now = GetLocalTime();
+			if (IsTaskDue(task, now) == true) {
+				RunTask(task, now);
+				break;
+			}
+		}
+	}
+}
+
+/**
+ * Requests that the next pass starts as soon as the running task returns, rather than after a low priority task has
+ * used up its budget. Interrupts call this when they leave work for the high or normal priority tasks, such as a
+ * received Ethernet frame, which bounds the latency of that work by a single run of any task.
+ *
+ * @param none
+ * @retval none
+ */
+void Scheduler_RequestPass(void) {
+	PassRequested = true;
+}
+
+/**
+ * Defers work from an interrupt to the start of the next pass, where it runs ahead of every task, and requests that
+ * pass. Deferrals run in the order their slots were reserved, each as often as it was deferred. Safe to call from
+ * any interrupt priority and from the program loop, without masking interrupts.
+ *
+ * @param function DeferredFunction The work to run from the program loop.
+ * @param argument uint32_t The argument to run it with.
+ * @retval bool True if the work is queued, false if the queue was full.
+ */
+bool Scheduler_Defer(DeferredFunction function, uint32_t argument) {
+	if (function == NULL) {
+		return false;
+	}
+	uint32_t reserved;
+	do {
+		reserved = __LDREXW(&DeferredReserved);
+		if ((reserved - DeferredTaken) >= SCHEDULER_MAX_DEFERRED) {
+			__CLREX();
+			uint32_t overflows;
+			do {
+				overflows = __LDREXW(&DeferOverflows);
+			} while (__STREXW(overflows + 1U, &DeferOverflows) != 0U);
+			return false;
+		}
+	} while (__STREXW(reserved + 1U, &DeferredReserved) != 0U);
+	Deferred_t* slot = &Deferred[reserved & DEFERRED_MASK];
+	slot->function = function;
+	slot->argument = argument;
+	/* The slot must be filled in before the program loop can see it ready */
+	__DMB();
+	slot->ready = true;
+	PassRequested = true;
+	return true;
+}
+
+/**
+ * Retrieves the number of deferrals refused because the queue was full since start up. Any is a sign that
+ * SCHEDULER_MAX_DEFERRED is too small.
+ *
+ * @param none
+ * @retval uint32_t The number of refused deferrals.
+ */
+uint32_t Scheduler_GetDeferOverflows(void) {
+	return DeferOverflows;
+}
+
+/**
+ * Sleeps the core in a wait for interrupt if no task has work ready, rather than spinning through passes which find
+ * nothing to do. The sleep ends at the latest when the next periodic task or deadline is due, capped at
+ * SCHEDULER_MAX_IDLE_US, and earlier on any interrupt, such as a conversion completing, a received frame, a digital
+ * input edge or the debounce tick. Interrupts are masked while deciding, so a pass requested in between is never
+ * slept through; a pending interrupt still ends the wait for interrupt and is taken once they are unmasked.
+ *
+ * @param none
+ * @retval none
+ */
+void Scheduler_Idle(void) {
+	__disable_irq();
+	const uint64_t now = GetLocalTime();
+	uint64_t wake = now + SCHEDULER_MAX_IDLE_US;
+	const uint64_t deadline = Timer_GetNextDeadline();
+	if (deadline < wake) {
+		wake = deadline;
+	}
+	for (uint_fast8_t i = 0U; i < TaskCount; ++i) {
+		/* A task with work ready, or a period, is due once its period has elapsed */
+		if ((Tasks[i].ready == true) || (Tasks[i].period != 0U)) {
+			const uint64_t due = Tasks[i].lastRun + Tasks[i].period;
+			if (due < wake) {
+				wake = due;
+			}
+		}
+	}
+	if ((PassRequested == false) && (wake > (now + SCHEDULER_MIN_IDLE_US))) {
+		Timer_SetWakeUp((uint32_t) (wake - now));
+		__DSB();
+		__WFI();
+		Timer_CancelWakeUp();
+		IdleTime += GetLocalTime() - now;
+	}
+	__enable_irq();
+}
+
+/**
+ * Retrieves the total time the scheduler has slept for since start up, which against the local time gives the idle
+ * fraction of the processor.
+ *
+ * @param none
+ * @retval uint64_t The total time asleep in microseconds.
+ */
+uint64_t Scheduler_GetIdleTime(void) {
+	return IdleTime;
+}
+
+/**
+ * Retrieves the number of passes the scheduler has made since start up. The count wraps, so the rate of passes is
+ * found from the difference of two counts.
+ *
+ * @param none
+ * @retval uint32_t The number of passes made.
+ */
+uint32_t Scheduler_GetPassCount(void) {
+	return PassCount;
+}
+
+/**
+ * Places a scheduled task under supervision. Its runs are timed against the timeout and it must run at least every
+ * SCHEDULER_STARVATION_US for the scheduler to remain healthy.
+ *
+ * @param function TaskFunction The body of a task which has been added to the scheduler.
+ * @param name const char* The name to report the task under. Must remain valid.
+ * @param timeout uint32_t The longest time in microseconds a single run of the task should take.
+ * @retval bool True if the task was found.
+ */
+bool Scheduler_SuperviseTask(TaskFunction function, const char* name, uint32_t timeout) {
+	for (uint_fast8_t i = 0U; i < TaskCount; ++i) {
+		if (Tasks[i].function == function) {
+			Tasks[i].name = name;
+			Tasks[i].timeout = timeout;
+			Tasks[i].longest = 0U;
+			Tasks[i].overruns = 0U;
+			Tasks[i].lastCheckIn = GetLocalTime();
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Indicates if every supervised task is running normally, so that the watchdog may be fed. The first task found to
+ * have gone SCHEDULER_STARVATION_US without running is recorded for after the reset, and the scheduler stays
+ * unhealthy from then on so the watchdog expires.
+ *
+ * @param none
+ * @retval bool True if the watchdog may be fed.
+ */
+bool Scheduler_IsHealthy(void) {
+	if (Starved == true) {
+		return false;
+	}
+	const uint64_t now = GetLocalTime();
+	for (uint_fast8_t i = 0U; i < TaskCount; ++i) {
+		if ((Tasks[i].name != NULL) && ((now - Tasks[i].lastCheckIn) > SCHEDULER_STARVATION_US)) {
+			Starved = true;
+			RTC_WriteBackupRegister(SUPERVISOR_RECORD_REG, ((uint32_t) SUPERVISOR_STARVED << SUPERVISOR_CAUSE_SHIFT) | i);
+#ifdef SCHEDULER_DEBUG
+			printf("[Scheduler] Task %s has starved, letting the watchdog expire.\n\r", Tasks[i].name);
+#endif
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Retrieves the supervision statistics of a task.
+ *
+ * @param index uint8_t The index of the task, in the order tasks were added.
+ * @param statistics SupervisorStatistics_t* The location to store the statistics.
+ * @retval bool True if the task exists and is supervised.
+ */
+bool Scheduler_GetStatistics(uint8_t index, SupervisorStatistics_t* statistics) {
+	if ((index >= TaskCount) || (Tasks[index].name == NULL)) {
+		return false;
+	}
+	statistics->name = Tasks[index].name;
+	statistics->timeout = Tasks[index].timeout;
+	statistics->longest = Tasks[index].longest;
+	statistics->overruns = Tasks[index].overruns;
+	return true;
+}
+
+/**
+ * Picks up the record a supervised task left before a watchdog reset and clears it. Must be called at start up,
+ * once the backup domain is accessible and before any task runs.
+ *
+ * @param watchdogReset bool True if the board was reset by the watchdog. Any other record is stale and discarded.
+ * @retval none
+ */
+void Scheduler_CaptureResetRecord(bool watchdogReset) {
+	ResetRecord = (watchdogReset == true) ? RTC_ReadBackupRegister(SUPERVISOR_RECORD_REG) : 0U;
+	RTC_WriteBackupRegister(SUPERVISOR_RECORD_REG, 0U);
+}
+
+/**
+ * Retrieves the record a supervised task left before the last watchdog reset. The task is named once it has been
+ * supervised again, as tasks are added in the same order on every start up.
+ *
+ * @param name const char** The location to store the name of the task, NULL if it is not known.
+ * @retval SupervisorCause_t What the task was doing, SUPERVISOR_NO_RECORD if there is no record.
+ */
+SupervisorCause_t Scheduler_GetResetRecord(const char** name) {
+	const uint32_t cause = ResetRecord >> SUPERVISOR_CAUSE_SHIFT;
+	const uint32_t index = ResetRecord & ((1UL << SUPERVISOR_CAUSE_SHIFT) - 1U);
+	*name = NULL;
+	if ((cause == SUPERVISOR_NO_RECORD) || (cause >= NUM_SUPERVISOR_CAUSES)) {
+		return SUPERVISOR_NO_RECORD;
+	}
+	if (index < TaskCount) {
+		*name = Tasks[index].name;
+	}
+	return (SupervisorCause_t) cause;
+}
+
+/**
+ * Return the human readable string representation of the provided watchdog reset cause.
+ *
+ * @param cause SupervisorCause_t The cause to convert.
+ * @retval const char* The human readable string, or NULL if the cause is invalid.
+ */
+const char* Scheduler_StringFromCause(SupervisorCause_t cause) {
+	return (cause < NUM_SUPERVISOR_CAUSES) ? CAUSE_STRINGS[cause] : NULL;
+}
@@ -0,0 +1,201 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_StateTrace.c
+ * @brief Implements the state machine transition trace of the Tekdaqc.
+ *
+ * Transitions are made from the program loop and from the sampling interrupts, so each is recorded with interrupts
+ * held off for the few stores it takes. The ring is indexed by free running counters, the write counter doubling as
+ * the sequence number of the next transition, so the host can tell from a frame's sequence how many were overwritten
+ * before being read. Frames are laid out as follows, all multi-byte fields little endian:
+ *
+ *   Frame:   [STATE_TRACE_FRAME_START][length:2][count][sequence:4][clock:4][events...]
+ *   Event:   [cycles:4][machine][state][detail:2]
+ *
+ * The clock is the core frequency in Hz the cycle counts are of. They wrap after 2^32 cycles, so transitions more
+ * than about 25 seconds apart can not be ordered by their counts alone.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "Tekdaqc_StateTrace.h"
+#include "Tekdaqc_BSP.h"
+#include <stddef.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def STATE_TRACE_FRAME_START
+ * @brief The byte which begins every binary trace frame (ASCII record separator).
+ */
+#define STATE_TRACE_FRAME_START		((uint8_t) 0x1E)
+
+/**
+ * @internal
+ * @def STATE_TRACE_MASK
+ * @brief Masks a free running counter to an index into the trace.
+ */
+#define STATE_TRACE_MASK			(STATE_TRACE_SIZE - 1U)
+
+#if ((STATE_TRACE_SIZE & STATE_TRACE_MASK) != 0U)
+#error "STATE_TRACE_SIZE must be a power of two."
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The recorded transitions, only ever touched by the CPU */
+static StateTraceEvent_t traceEvents[STATE_TRACE_SIZE] CCM_DATA;
+
+/* The sequence number of the next transition to be recorded */
+static volatile uint32_t traceHead CCM_DATA;
+
+/* The sequence number of the oldest transition not yet read */
+static uint32_t traceRead CCM_DATA;
+
+/* The sequence number following the last frame built, to be read once the frame has been sent */
+static uint32_t traceFrameEnd CCM_DATA;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Writes a value to a frame as little endian bytes.
+ */
+static uint16_t PackLittleEndian(uint8_t* dest, uint32_t value, uint8_t size);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Writes the lowest size bytes of a value to a frame, least significant first.
+ *
+ * @param dest uint8_t* The location to write to.
+ * @param value uint32_t The value to write.
+ * @param size uint8_t The number of bytes to write.
+ * @retval uint16_t The number of bytes written.
+ */
+static uint16_t PackLittleEndian(uint8_t* dest, uint32_t value, uint8_t size) {
+	for (uint8_t i = 0U; i < size; ++i) {
+		dest[i] = (uint8_t) (value >> (8U * i));
+	}
+	return size;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Records a state machine transition, overwriting the oldest if the trace is full. Safe to call from any context.
+ *
+ * @param machine StateTraceMachine_t The state machine which made the transition.
+ * @param state uint8_t The state entered.
+ * @param detail uint16_t Machine specific detail of the transition.
+ * @retval none
+ */
+void StateTrace_Record(StateTraceMachine_t machine, uint8_t state, uint16_t detail) {
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	StateTraceEvent_t* event = &traceEvents[traceHead & STATE_TRACE_MASK];
+	event->cycles = DWT->CYCCNT;
+	event->machine = (uint8_t) machine;
+	event->state = state;
+	event->detail = detail;
+	++traceHead;
+	__set_PRIMASK(primask);
+}
+
+/**
+ * Builds a binary trace frame of up to STATE_TRACE_FRAME_EVENTS of the oldest transitions not yet read, see the
+ * framing description at the top of this file. Transitions which were overwritten before being read are skipped, the
+ * gap showing in the frame's sequence. Nothing is marked read until StateTrace_ConsumeFrame() is called, so a frame
+ * which could not be sent is built again by the next call. Only called from the program loop.
+ *
+ * @param frame uint8_t* The location to build the frame in, at least STATE_TRACE_FRAME_SIZE bytes.
+ * @param length uint16_t* Set to the length of the frame in bytes.
+ * @retval uint16_t The number of transitions in the frame, 0 if there are none to read.
+ */
+uint16_t StateTrace_BuildFrame(uint8_t* frame, uint16_t* length) {
+	uint16_t count = 0U;
+	uint16_t used = STATE_TRACE_FRAME_HEADER_SIZE;
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	const uint32_t head = traceHead;
+	if ((head - traceRead) > STATE_TRACE_SIZE) {
+		traceRead = head - STATE_TRACE_SIZE;
+	}
+	const uint32_t sequence = traceRead;
+	while (((sequence + count) != head) && (count < STATE_TRACE_FRAME_EVENTS)) {
+		const StateTraceEvent_t* event = &traceEvents[(sequence + count) & STATE_TRACE_MASK];
+		used += PackLittleEndian(&frame[used], event->cycles, 4U);
+		frame[used++] = event->machine;
+		frame[used++] = event->state;
+		used += PackLittleEndian(&frame[used], event->detail, 2U);
+		++count;
+	}
+	__set_PRIMASK(primask);
+	frame[0] = STATE_TRACE_FRAME_START;
+	PackLittleEndian(&frame[1], used - 3U, 2U);
+	frame[3] = (uint8_t) count;
+	PackLittleEndian(&frame[4], sequence, 4U);
+	PackLittleEndian(&frame[8], SystemCoreClock, 4U);
+	traceFrameEnd = sequence + count;
+	*length = used;
+	return count;
+}
+
+/**
+ * Marks the transitions of the last frame built by StateTrace_BuildFrame() as read. Only called from the program loop.
+ *
+ * @param none
+ * @retval none
+ */
+void StateTrace_ConsumeFrame(void) {
+	traceRead = traceFrameEnd;
+}
+
+/**
+ * Retrieves the number of transitions recorded and not yet read. If this exceeds STATE_TRACE_SIZE the excess was
+ * overwritten and will never be read.
+ *
+ * @param none
+ * @retval uint32_t The number of transitions not yet read.
+ */
+uint32_t StateTrace_GetPending(void) {
+	return traceHead - traceRead;
+}
+
+/**
+ * Retrieves the number of transitions recorded since start up, which wraps after 2^32.
+ *
+ * @param none
+ * @retval uint32_t The number of transitions recorded.
+ */
+uint32_t StateTrace_GetRecorded(void) {
+	return traceHead;
+}
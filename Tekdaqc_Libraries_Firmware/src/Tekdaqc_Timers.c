@@ -28,6 +28,7 @@
 #include "Tekdaqc_Debug.h"
 #include "Tekdaqc_Timers.h"
 #include "Tekdaqc_BSP.h"
+#include <stddef.h>
 
 #ifdef PRINTF_OUTPUT
 #include <stdio.h>
@@ -37,11 +38,31 @@
 /* PRIVATE VARIABLES */
 /*--------------------------------------------------------------------------------------------------------*/
 
-/* Keeps track of a local time reference incremented by the SYSTICK period */
-volatile uint64_t LocalTime = 0;
+/* The upper 32 bits of the local time, incremented each time the time base counter overflows */
+static volatile uint32_t TimeHigh = 0U;
 
-/* Used to keep track of the ending time for a delay */
-volatile uint64_t count = 0;
+/* The number of core clock cycles per microsecond */
+static uint32_t CyclesPerMicrosecond = 1U;
+
+/* The number of core clock cycles spent by a call to Delay_ns() outside of its wait */
+static uint32_t DelayOverheadCycles = 0U;
+
+/* The scheduled deadlines. An entry is free when its callback is NULL */
+static struct {
+	DeadlineCallback callback;
+	uint64_t due;
+} Deadlines[TIMER_DEADLINE_COUNT];
+
+/* The earliest time any scheduled deadline may pass, so the program loop does not scan the schedule until then */
+static uint64_t NextDeadline = UINT64_MAX;
+
+/* The mapping of local time to epoch time, invalid until set by a time synchronization */
+static struct {
+	bool valid;
+	uint64_t reference;
+	int64_t offset;
+	int32_t drift;
+} Epoch = { false, 0U, 0, 0 };
 
 
 
@@ -50,53 +71,314 @@ volatile uint64_t count = 0;
 /*--------------------------------------------------------------------------------------------------------*/
 
 /**
- * Configures the Tekdaqc's timers and any interrupts necessary for thier operation.
+ * Configures the Tekdaqc's timers and any interrupts necessary for thier operation. The local time is counted in
+ * hardware by a 32 bit timer running at 1 MHz, so its interrupt only fires on overflow, roughly every 71 minutes,
+ * where it extends the count to 64 bits.
  *
  * @param  none
  * @retval none
  */
 void Timer_Config(void) {
 #ifdef DEBUG
-	printf("[Config] Configuring SYSTICK timing.\n\r");
+	printf("[Config] Configuring time base timer.\n\r");
 #endif
 	RCC_ClocksTypeDef RCC_Clocks;
+	TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+	NVIC_InitTypeDef NVIC_InitStructure;
+	uint32_t timerClock;
 
-	/* Configure Systick clock source as HCLK */
-	SysTick_CLKSourceConfig(SysTick_CLKSource_HCLK);
-
-	/* SystTick configuration: an interrupt every 10ms */
+	/* APB1 timers are clocked at twice PCLK1 unless the APB1 prescaler is 1 */
 	RCC_GetClocksFreq(&RCC_Clocks);
-	SysTick_Config(RCC_Clocks.HCLK_Frequency / SYSTEMTICK_DIVIDER);
+	timerClock = RCC_Clocks.PCLK1_Frequency;
+	if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+		timerClock *= 2U;
+	}
+
+	RCC_APB1PeriphClockCmd(TIMEBASE_TIM_CLK, ENABLE);
 
-	/* Set Systick interrupt priority to 0*/
-	NVIC_SetPriority (SysTick_IRQn, 0U);
+	/* Free running up counter at TIMEBASE_FREQUENCY over the full 32 bit range */
+	TIM_TimeBaseStructInit(&TIM_TimeBaseStructure);
+	TIM_TimeBaseStructure.TIM_Prescaler = (uint16_t) ((timerClock / TIMEBASE_FREQUENCY) - 1U);
+	TIM_TimeBaseStructure.TIM_Period = 0xFFFFFFFFU;
+	TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+	TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+	TIM_TimeBaseInit(TIMEBASE_TIM, &TIM_TimeBaseStructure);
 
-	LocalTime = 0U;
+	/* Loading the prescaler generates an update event, which must not count as an overflow */
+	TIM_ClearITPendingBit(TIMEBASE_TIM, TIM_IT_Update);
+	TIM_SetCounter(TIMEBASE_TIM, 0U);
+	TimeHigh = 0U;
+
+	/* The overflow interrupt has the highest priority so the extension is never held off for long */
+	NVIC_InitStructure.NVIC_IRQChannel = TIMEBASE_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = IRQ_PRIORITY_TIMEBASE;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0U;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+
+	TIM_ITConfig(TIMEBASE_TIM, TIM_IT_Update, ENABLE);
+	TIM_Cmd(TIMEBASE_TIM, ENABLE);
+
+	/* Start the DWT cycle counter used for sub-microsecond delays */
+	CyclesPerMicrosecond = RCC_Clocks.HCLK_Frequency / 1000000U;
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0U;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	/* Calibrate out the cost of the call itself by timing an empty delay */
+	DelayOverheadCycles = 0U;
+	const uint32_t start = DWT->CYCCNT;
+	Delay_ns(0U);
+	DelayOverheadCycles = DWT->CYCCNT - start;
+
+	for (uint_fast8_t i = 0U; i < TIMER_DEADLINE_COUNT; ++i) {
+		Deadlines[i].callback = NULL;
+	}
+	NextDeadline = UINT64_MAX;
 }
 
 /**
- * Updates the system local time, incrementing by SYSTEMTICK_PERIOD.
+ * Extends the local time when the time base counter overflows. A wake up set by Timer_SetWakeUp() is disarmed once
+ * it has fired, as its only purpose is to end a wait for interrupt.
  *
  * @param  none
  * @retval none
  */
 void Time_Update(void) {
-	LocalTime += SYSTEMTICK_PERIOD;
+	if (TIM_GetITStatus(TIMEBASE_TIM, TIM_IT_Update) != RESET) {
+		TIM_ClearITPendingBit(TIMEBASE_TIM, TIM_IT_Update);
+		++TimeHigh;
+	}
+	if (TIM_GetITStatus(TIMEBASE_TIM, TIM_IT_CC1) != RESET) {
+		Timer_CancelWakeUp();
+	}
 }
 
 /**
- * Retrieves the current system local time stamp.
+ * Retrieves the current system local time stamp. The upper word is read on both sides of the counter so the two
+ * halves are never torn by an overflow. An overflow which is still pending, as when called with interrupts masked
+ * or from an interrupt of equal priority, is accounted for from the timer's flag. Safe to call from any context.
  *
  * @param none
  * @retval uint64_t The current local time stamp in microseconds.
  */
 uint64_t GetLocalTime(void) {
-	return LocalTime;
+	uint32_t before;
+	uint32_t high;
+	uint32_t low;
+	do {
+		before = TimeHigh;
+		low = TIMEBASE_TIM->CNT;
+		high = before;
+		if (((TIMEBASE_TIM->SR & TIM_SR_UIF) != 0U) && (low < 0x80000000U)) {
+			/* The counter has wrapped but the overflow has not been serviced yet */
+			++high;
+		}
+	} while (before != TimeHigh);
+	return (((uint64_t) high) << 32) | low;
+}
+
+/**
+ * Sets the mapping of local time to epoch time. The offset of epoch time from local time is known at a reference
+ * local time and changes by the drift from there, which disciplines the time base both in phase and frequency while
+ * leaving the local time itself monotonic for the deadlines and delays.
+ *
+ * @param reference uint64_t The local time in microseconds at which the offset applies.
+ * @param offset int64_t The offset in microseconds of epoch time from local time at the reference.
+ * @param drift int32_t The rate in parts per billion at which epoch time runs faster than local time.
+ * @retval none
+ */
+void Timer_SetEpochMapping(uint64_t reference, int64_t offset, int32_t drift) {
+	Epoch.reference = reference;
+	Epoch.offset = offset;
+	Epoch.drift = drift;
+	Epoch.valid = true;
+}
+
+/**
+ * Clears the mapping of local time to epoch time, so that timestamps are reported as local time again.
+ *
+ * @param none
+ * @retval none
+ */
+void Timer_ClearEpochMapping(void) {
+	Epoch.valid = false;
+}
+
+/**
+ * Indicates if local time can be converted to epoch time.
+ *
+ * @param none
+ * @retval bool True if a mapping to epoch time was set.
+ */
+bool Timer_IsEpochValid(void) {
+	return Epoch.valid;
+}
+
+/**
+ * Converts a local time stamp to epoch time, in microseconds since 1970-01-01 00:00:00 UTC. Until a mapping is set
+ * the local time stamp is returned unchanged. Only called from the main loop, where the mapping is updated.
+ *
+ * @param local uint64_t The local time stamp in microseconds.
+ * @retval uint64_t The epoch time stamp in microseconds, or the local time stamp if there is no mapping.
+ */
+uint64_t Timer_ToEpochTime(uint64_t local) {
+	if (Epoch.valid == false) {
+		return local;
+	}
+	const int64_t elapsed = (int64_t) (local - Epoch.reference);
+	return (uint64_t) ((int64_t) local + Epoch.offset + ((elapsed * Epoch.drift) / 1000000000LL));
+}
+
+/**
+ * Schedules a callback to be made from the main loop once the provided number of microseconds has passed. This
+ * lets a state machine wait without blocking the rest of the program loop. A callback may only be scheduled once,
+ * so scheduling it again moves its existing deadline.
+ *
+ * @param callback DeadlineCallback The function to call once the deadline has passed.
+ * @param us uint32_t The number of microseconds from now at which the deadline passes.
+ * @retval bool True if the deadline was scheduled, false if all deadlines are in use.
+ */
+bool Timer_ScheduleDeadline(DeadlineCallback callback, uint32_t us) {
+	int_fast8_t slot = -1;
+	for (uint_fast8_t i = 0U; i < TIMER_DEADLINE_COUNT; ++i) {
+		if (Deadlines[i].callback == callback) {
+			slot = (int_fast8_t) i;
+			break;
+		} else if ((Deadlines[i].callback == NULL) && (slot < 0)) {
+			slot = (int_fast8_t) i;
+		}
+	}
+	if (slot < 0) {
+#ifdef DEBUG
+		printf("[Timers] All deadlines are in use.\n\r");
+#endif
+		return false;
+	}
+	Deadlines[slot].due = GetLocalTime() + us;
+	Deadlines[slot].callback = callback;
+	if (Deadlines[slot].due < NextDeadline) {
+		NextDeadline = Deadlines[slot].due;
+	}
+	return true;
+}
+
+/**
+ * Cancels the deadline scheduled for the provided callback, if there is one.
+ *
+ * @param callback DeadlineCallback The callback of the deadline to cancel.
+ * @retval none
+ */
+void Timer_CancelDeadline(DeadlineCallback callback) {
+	for (uint_fast8_t i = 0U; i < TIMER_DEADLINE_COUNT; ++i) {
+		if (Deadlines[i].callback == callback) {
+			Deadlines[i].callback = NULL;
+		}
+	}
+}
+
+/**
+ * Indicates if a deadline is scheduled for the provided callback and has not yet been serviced.
+ *
+ * @param callback DeadlineCallback The callback of the deadline to check.
+ * @retval bool True if the deadline is pending.
+ */
+bool Timer_IsDeadlinePending(DeadlineCallback callback) {
+	for (uint_fast8_t i = 0U; i < TIMER_DEADLINE_COUNT; ++i) {
+		if (Deadlines[i].callback == callback) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Makes the callbacks of any deadlines which have passed, removing them from the schedule first so that a callback
+ * may schedule itself again. Must be called periodically from the program loop. Until the earliest deadline passes
+ * this returns after a single comparison; a cancelled deadline only costs one extra scan when it would have passed.
+ *
+ * @param none
+ * @retval none
+ */
+void Timer_ServiceDeadlines(void) {
+	const uint64_t now = GetLocalTime();
+	if (now < NextDeadline) {
+		return;
+	}
+	for (uint_fast8_t i = 0U; i < TIMER_DEADLINE_COUNT; ++i) {
+		DeadlineCallback callback = Deadlines[i].callback;
+		if ((callback != NULL) && (now >= Deadlines[i].due)) {
+			Deadlines[i].callback = NULL;
+			callback();
+		}
+	}
+
+	/* The callbacks may have scheduled deadlines, so the earliest is found over the whole schedule */
+	uint64_t next = UINT64_MAX;
+	for (uint_fast8_t i = 0U; i < TIMER_DEADLINE_COUNT; ++i) {
+		if ((Deadlines[i].callback != NULL) && (Deadlines[i].due < next)) {
+			next = Deadlines[i].due;
+		}
+	}
+	NextDeadline = next;
+}
+
+/**
+ * Retrieves the earliest time any scheduled deadline may pass. A cancelled deadline may still be reported, so the
+ * time is never later than the real earliest deadline.
+ *
+ * @param none
+ * @retval uint64_t The local time in microseconds, UINT64_MAX if no deadline is scheduled.
+ */
+uint64_t Timer_GetNextDeadline(void) {
+	return NextDeadline;
+}
+
+/**
+ * Arms the time base to raise an interrupt once the provided number of microseconds has passed, using its first
+ * compare channel against the free running counter. Nothing is called back; the interrupt only ends a wait for
+ * interrupt in the program loop, so the wake up is disarmed again when it fires.
+ *
+ * @param us uint32_t The number of microseconds from now at which to raise the interrupt.
+ * @retval none
+ */
+void Timer_SetWakeUp(uint32_t us) {
+	TIM_SetCompare1(TIMEBASE_TIM, TIMEBASE_TIM->CNT + us);
+	TIM_ClearITPendingBit(TIMEBASE_TIM, TIM_IT_CC1);
+	TIM_ITConfig(TIMEBASE_TIM, TIM_IT_CC1, ENABLE);
+}
+
+/**
+ * Disarms the wake up interrupt of the time base, if it is armed.
+ *
+ * @param none
+ * @retval none
+ */
+void Timer_CancelWakeUp(void) {
+	TIM_ITConfig(TIMEBASE_TIM, TIM_IT_CC1, DISABLE);
+	TIM_ClearITPendingBit(TIMEBASE_TIM, TIM_IT_CC1);
+}
+
+/**
+ * Inserts a delay time, measured in nanoseconds, by counting core clock cycles. This is intended for the short
+ * timing characteristics of peripherals which are well below the resolution of the local time. The overhead of the
+ * call measured by Timer_Config() is deducted, so short delays are not stretched by it.
+ *
+ * @param ns uint32_t The number of nanoseconds to wait for.
+ * @retval none
+ */
+void Delay_ns(uint32_t ns) {
+	const uint32_t start = DWT->CYCCNT;
+	uint32_t cycles = (uint32_t) ((((uint64_t) ns) * CyclesPerMicrosecond + 999U) / 1000U);
+	cycles = (cycles > DelayOverheadCycles) ? (cycles - DelayOverheadCycles) : 0U;
+	while ((DWT->CYCCNT - start) < cycles) {
+		/* Do nothing */
+	}
 }
 
 /**
- * Inserts a delay time, measured in SYSTICK periods.
- * @param  nCount uint32_t The number of SYSTICK periods to wait for.
+ * Inserts a delay time, measured in SYSTEMTICK_PERIOD periods.
+ * @param  nCount uint32_t The number of periods to wait for.
  * @retval none
  */
 void Delay_Periods(uint32_t nCount) {
@@ -125,14 +407,15 @@ void Delay_ms(float ms) {
 }
 
 /**
- * Inserts a delay time, measured in integer microseconds.
+ * Inserts a delay time, measured in integer microseconds. The end time is kept on the stack so that this
+ * may safely be called from an interrupt which preempts another delay.
  *
  * @param us uint64_t The number of microseconds to wait for.
  * @retval none
  */
 void Delay_us(uint64_t us) {
-	count = us + LocalTime;
-	while (LocalTime < count) {
+	const uint64_t count = us + GetLocalTime();
+	while (GetLocalTime() < count) {
 		/* Do nothing */
 	}
 }
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_TimingHistogram.c
+ * @brief Implements the timing histograms of the Tekdaqc.
+ *
+ * Intervals are binned by their bit length, so recording one costs a count leading zeros instruction and a few
+ * increments and can be done from the sampling interrupts. Each histogram must only be recorded from one context.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "Tekdaqc_TimingHistogram.h"
+#include <stddef.h>
+#include <string.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The human readable names of the histograms, indexed by TimingHistogram_t */
+static const char* HISTOGRAM_STRINGS[NUM_TIMING_HISTOGRAMS] = { "DRDY_TO_READ", "SAMPLE_INTERVAL", "LOOP_PERIOD" };
+
+/* The recorded histograms */
+static volatile TimingHistogramData_t histograms[NUM_TIMING_HISTOGRAMS];
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Records an interval in a histogram.
+ *
+ * @param histogram TimingHistogram_t The histogram to record in.
+ * @param interval uint32_t The interval (us).
+ * @retval none
+ */
+void TimingHistogram_Record(TimingHistogram_t histogram, uint32_t interval) {
+	volatile TimingHistogramData_t* data = &histograms[histogram];
+	uint32_t bucket = 32U - __CLZ(interval);
+	if (bucket >= TIMING_HISTOGRAM_BUCKETS) {
+		bucket = TIMING_HISTOGRAM_BUCKETS - 1U;
+	}
+	++(data->buckets[bucket]);
+	if ((data->count == 0U) || (interval < data->min)) {
+		data->min = interval;
+	}
+	if ((data->count == 0U) || (interval > data->max)) {
+		data->max = interval;
+	}
+	++(data->count);
+}
+
+/**
+ * Retrieves a copy of a histogram. Interrupts are held off during the copy so it is consistent.
+ *
+ * @param histogram TimingHistogram_t The histogram to retrieve.
+ * @param data TimingHistogramData_t* The location to copy the histogram to.
+ * @retval bool FALSE if the histogram is invalid.
+ */
+bool TimingHistogram_Get(TimingHistogram_t histogram, TimingHistogramData_t* data) {
+	if ((histogram >= NUM_TIMING_HISTOGRAMS) || (data == NULL)) {
+		return false;
+	}
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	memcpy(data, (const void*) &histograms[histogram], sizeof(TimingHistogramData_t));
+	__set_PRIMASK(primask);
+	return true;
+}
+
+/**
+ * Discards the intervals recorded in all histograms.
+ *
+ * @param none
+ * @retval none
+ */
+void TimingHistogram_Reset(void) {
+	const uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	memset((void*) histograms, 0, sizeof(histograms));
+	__set_PRIMASK(primask);
+}
+
+/**
+ * Retrieves the exclusive upper limit of a histogram bucket. The last bucket has no limit.
+ *
+ * @param bucket uint8_t The bucket.
+ * @retval uint32_t The upper limit (us), or UINT32_MAX for the last bucket.
+ */
+uint32_t TimingHistogram_BucketLimit(uint8_t bucket) {
+	return (bucket < (TIMING_HISTOGRAM_BUCKETS - 1U)) ? (1UL << bucket) : UINT32_MAX;
+}
+
+/**
+ * Return the human readable string representation of the provided histogram.
+ *
+ * @param histogram TimingHistogram_t The histogram to convert.
+ * @retval const char* The string representation, or NULL if the histogram is invalid.
+ */
+const char* TimingHistogram_StringFromHistogram(TimingHistogram_t histogram) {
+	return (histogram < NUM_TIMING_HISTOGRAMS) ? HISTOGRAM_STRINGS[histogram] : NULL;
+}
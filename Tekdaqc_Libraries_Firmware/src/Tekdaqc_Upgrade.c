@@ -0,0 +1,604 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file Tekdaqc_Upgrade.c
+ * @brief Implements the staging and installation of firmware upgrades.
+ *
+ * The STM32F407 has a single FLASH bank, so the image is staged in sectors set aside for it rather than a second bank.
+ * Received bytes are buffered in RAM and programmed a few words at a time from the storage task, so the running
+ * firmware keeps sampling. The staging sectors are only erased at start up or while the inputs are idle, since an
+ * erase stalls the CPU.
+ *
+ * Once every byte has been programmed and the CRC of the staged image matches, a trailer recording the image is
+ * written at the end of the staging sectors. The trailer is the commit point: until its magic word is written, a
+ * reset leaves the running firmware in place. On the next reset Upgrade_Init() finds the trailer, checks the staged
+ * image again and copies it over the running firmware from a routine running in RAM. The copy is not power fail
+ * safe; a board which loses power part way through is recovered with the system bootloader.
+ *
+ * The CRC is the STM32 CRC-32 (polynomial 0x04C11DB7, initial value 0xFFFFFFFF, no reflection) of the image as little
+ * endian words, the last word padded with 0xFF. It is computed in software so that the hardware CRC unit stays free
+ * for calibration uploads.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Upgrade.h"
+#include "Tekdaqc_BSP.h"
+#include <string.h>
+
+#ifdef UPGRADE_DEBUG
+#include <stdio.h>
+#include <inttypes.h>
+#endif
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def UPGRADE_TRAILER_MAGIC
+ * @brief The value marking the trailer of a staged image as valid.
+ */
+#define UPGRADE_TRAILER_MAGIC		0x54555047U
+
+/**
+ * @internal
+ * @def UPGRADE_NOT_INSTALLED
+ * @brief The installed word of a trailer whose image has not been installed yet, as left by the erase.
+ */
+#define UPGRADE_NOT_INSTALLED		0xFFFFFFFFU
+
+/**
+ * @internal
+ * @def UPGRADE_CRC_INITIAL
+ * @brief The initial value of the image CRC.
+ */
+#define UPGRADE_CRC_INITIAL			0xFFFFFFFFU
+
+/**
+ * @internal
+ * @def UPGRADE_FLASH_ERRORS
+ * @brief The FLASH status flags cleared before each operation.
+ */
+#define UPGRADE_FLASH_ERRORS		(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR)
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE TYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief The trailer recording a staged image, in the last words of the staging sectors.
+ */
+typedef struct {
+	uint32_t magic; /**< UPGRADE_TRAILER_MAGIC if the trailer is valid. */
+	uint32_t length; /**< The length of the image in bytes. */
+	uint32_t crc; /**< The CRC of the image. */
+	uint32_t installed; /**< UPGRADE_NOT_INSTALLED until the image has been installed. */
+} UpgradeTrailer_t;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/* The trailer in FLASH */
+static volatile UpgradeTrailer_t* const trailer = (volatile UpgradeTrailer_t*) UPGRADE_TRAILER_ADDR;
+
+/* The CRC-32 of each nibble, for a table a sixteenth of the size of the usual byte table */
+static const uint32_t CRC_NIBBLES[16] = { 0x00000000U, 0x04C11DB7U, 0x09823B6EU, 0x0D4326D9U, 0x130476DCU, 0x17C56B6BU,
+		0x1A864DB2U, 0x1E475005U, 0x2608EDB8U, 0x22C9F00FU, 0x2F8AD6D6U, 0x2B4BCB61U, 0x350C9B64U, 0x31CD86D3U,
+		0x3C8EA00AU, 0x384FBDBDU };
+
+/* The human readable names of the upgrade states, indexed by UpgradeState_t */
+static const char* STATE_STRINGS[NUM_UPGRADE_STATES] = { "IDLE", "DIRTY", "ERASING", "RECEIVING", "STAGED" };
+
+/* The state of the staging sectors */
+static UpgradeState_t stagingState = UPGRADE_DIRTY;
+
+/* The length and CRC of the image being received or staged */
+static uint32_t imageLength = 0U;
+static uint32_t imageCrc = 0U;
+
+/* The number of image bytes accepted and programmed */
+static uint32_t receivedBytes = 0U;
+static uint32_t programmed = 0U;
+
+/* The CRC of the image as read back from FLASH */
+static uint32_t programmedCrc = UPGRADE_CRC_INITIAL;
+
+/* The accepted bytes waiting to be programmed */
+static uint32_t buffer[UPGRADE_BUFFER_SIZE / sizeof(uint32_t)];
+static uint16_t buffered = 0U;
+
+/* The next staging sector to erase */
+static uint8_t eraseIndex = 0U;
+
+/* The image installed by the last reset */
+static bool installed = false;
+static uint32_t installedLength = 0U;
+static uint32_t installedCrc = 0U;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Adds a word to a CRC.
+ */
+static uint32_t UpdateCrc(uint32_t crc, uint32_t word);
+
+/**
+ * @internal
+ * @brief Computes the CRC of the staged image.
+ */
+static uint32_t ComputeStagedCrc(uint32_t length);
+
+/**
+ * @internal
+ * @brief Determines if the staging sectors are erased.
+ */
+static bool IsStagingBlank(void);
+
+/**
+ * @internal
+ * @brief Marks the staging sectors as waiting to be erased.
+ */
+static void MarkDirty(void);
+
+/**
+ * @internal
+ * @brief Starts the erase of the next staging sector.
+ */
+static void StartErase(void);
+
+/**
+ * @internal
+ * @brief Programs the buffered bytes of the image.
+ */
+static bool ProgramBuffered(void);
+
+/**
+ * @internal
+ * @brief Verifies the programmed image and writes its trailer.
+ */
+static void FinishImage(void);
+
+/**
+ * @internal
+ * @brief Copies the staged image over the running firmware and resets.
+ */
+static void InstallImage(uint32_t length) RAM_FUNCTION;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Adds a word to a CRC, most significant nibble first, as the hardware CRC unit does.
+ *
+ * @param crc uint32_t The CRC so far.
+ * @param word uint32_t The word to add.
+ * @retval uint32_t The updated CRC.
+ */
+static uint32_t UpdateCrc(uint32_t crc, uint32_t word) {
+	crc ^= word;
+	for (uint_fast8_t i = 0U; i < 8U; ++i) {
+		crc = (crc << 4U) ^ CRC_NIBBLES[crc >> 28U];
+	}
+	return crc;
+}
+
+/**
+ * Computes the CRC of the staged image, including the padding of its last word.
+ *
+ * @param length uint32_t The length of the image in bytes.
+ * @retval uint32_t The CRC of the image.
+ */
+static uint32_t ComputeStagedCrc(uint32_t length) {
+	uint32_t crc = UPGRADE_CRC_INITIAL;
+	for (uint32_t offset = 0U; offset < length; offset += sizeof(uint32_t)) {
+		crc = UpdateCrc(crc, *(__IO uint32_t*) (UPGRADE_STAGING_BASE + offset));
+	}
+	return crc;
+}
+
+/**
+ * Determines if every word of the staging sectors, including the trailer, is erased.
+ *
+ * @param none
+ * @retval bool TRUE if the staging sectors are erased.
+ */
+static bool IsStagingBlank(void) {
+	for (uint32_t address = UPGRADE_STAGING_BASE; address < UPGRADE_STAGING_END; address += sizeof(uint32_t)) {
+		if (*(__IO uint32_t*) address != 0xFFFFFFFFU) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Marks the staging sectors as waiting to be erased, abandoning any image in them.
+ *
+ * @param none
+ * @retval none
+ */
+static void MarkDirty(void) {
+	stagingState = UPGRADE_DIRTY;
+	eraseIndex = 0U;
+	buffered = 0U;
+}
+
+/**
+ * Starts the erase of the next staging sector without waiting for it to complete. The watchdog is reloaded first,
+ * since the CPU may stall on FLASH fetches for the duration of the erase.
+ *
+ * @param none
+ * @retval none
+ */
+static void StartErase(void) {
+	IWDG_ReloadCounter();
+	FLASH_ClearFlag(UPGRADE_FLASH_ERRORS);
+	FLASH->CR &= ~(FLASH_CR_PSIZE | FLASH_CR_SNB);
+	FLASH->CR |= FLASH_PSIZE_WORD | FLASH_CR_SER
+			| (UPGRADE_STAGING_SECTOR + (eraseIndex * (FLASH_Sector_1 - FLASH_Sector_0)));
+	FLASH->CR |= FLASH_CR_STRT;
+	stagingState = UPGRADE_ERASING;
+}
+
+/**
+ * Programs the whole words of the buffered bytes, at most UPGRADE_WORDS_PER_SERVICE of them. Once the whole image has
+ * been accepted, its last partial word is padded and programmed as well. Each word is read back into the CRC.
+ *
+ * @param none
+ * @retval bool TRUE if there are more buffered words to program.
+ */
+static bool ProgramBuffered(void) {
+	if ((receivedBytes == imageLength) && ((buffered % sizeof(uint32_t)) != 0U)) {
+		/* The image is complete, pad its last word */
+		const uint16_t pad = sizeof(uint32_t) - (buffered % sizeof(uint32_t));
+		memset(((uint8_t*) buffer) + buffered, 0xFF, pad);
+		buffered += pad;
+	}
+	uint16_t words = buffered / sizeof(uint32_t);
+	if (words > UPGRADE_WORDS_PER_SERVICE) {
+		words = UPGRADE_WORDS_PER_SERVICE;
+	}
+	for (uint16_t i = 0U; i < words; ++i) {
+		const uint32_t address = UPGRADE_STAGING_BASE + programmed;
+		if (FLASH_ProgramWord(address, buffer[i]) != FLASH_COMPLETE) {
+#ifdef UPGRADE_DEBUG
+			printf("[Upgrade] Programming failed at 0x%08" PRIX32 ".\n\r", address);
+#endif
+			MarkDirty();
+			return false;
+		}
+		programmedCrc = UpdateCrc(programmedCrc, *(__IO uint32_t*) address);
+		programmed += sizeof(uint32_t);
+	}
+	const uint16_t consumed = words * sizeof(uint32_t);
+	buffered -= consumed;
+	memmove(buffer, ((uint8_t*) buffer) + consumed, buffered);
+	return (buffered >= sizeof(uint32_t));
+}
+
+/**
+ * Verifies the CRC of the programmed image and, if it matches, writes the trailer which stages the image. The magic
+ * word is written last so that a partly written trailer is never taken as valid.
+ *
+ * @param none
+ * @retval none
+ */
+static void FinishImage(void) {
+	if (programmedCrc != imageCrc) {
+#ifdef UPGRADE_DEBUG
+		printf("[Upgrade] Image CRC 0x%08" PRIX32 ", expected 0x%08" PRIX32 ".\n\r", programmedCrc, imageCrc);
+#endif
+		MarkDirty();
+		return;
+	}
+	if ((FLASH_ProgramWord((uint32_t) &trailer->length, imageLength) != FLASH_COMPLETE)
+			|| (FLASH_ProgramWord((uint32_t) &trailer->crc, imageCrc) != FLASH_COMPLETE)
+			|| (FLASH_ProgramWord((uint32_t) &trailer->magic, UPGRADE_TRAILER_MAGIC) != FLASH_COMPLETE)) {
+		MarkDirty();
+		return;
+	}
+#ifdef UPGRADE_DEBUG
+	printf("[Upgrade] Staged a %" PRIu32 " byte image.\n\r", imageLength);
+#endif
+	stagingState = UPGRADE_STAGED;
+}
+
+/**
+ * Copies the staged image over the running firmware, then marks it installed and resets. This runs from RAM with
+ * interrupts disabled, so it touches only the FLASH, watchdog and system control registers. The sectors are rewritten
+ * from the last to the first, leaving the vector table until the end.
+ *
+ * @param length uint32_t The length of the image in bytes.
+ * @retval none
+ */
+static void InstallImage(uint32_t length) {
+	for (int32_t sector = (int32_t) UPGRADE_APP_SECTORS - 1; sector >= 0; --sector) {
+		/* Sectors 0 to 3 are 16 Kbytes, sector 4 is 64 Kbytes and the rest are 128 Kbytes */
+		uint32_t start;
+		uint32_t size;
+		if (sector < 4) {
+			start = (uint32_t) sector * 0x4000U;
+			size = 0x4000U;
+		} else if (sector == 4) {
+			start = 0x10000U;
+			size = 0x10000U;
+		} else {
+			start = (uint32_t) (sector - 4) * 0x20000U;
+			size = 0x20000U;
+		}
+		if (start >= length) {
+			continue;
+		}
+		IWDG->KR = 0xAAAAU;
+		while ((FLASH->SR & FLASH_SR_BSY) != 0U) {
+		}
+		FLASH->SR = UPGRADE_FLASH_ERRORS;
+		FLASH->CR &= ~(FLASH_CR_PSIZE | FLASH_CR_SNB);
+		FLASH->CR |= FLASH_PSIZE_WORD | FLASH_CR_SER | ((uint32_t) sector << 3U);
+		FLASH->CR |= FLASH_CR_STRT;
+		while ((FLASH->SR & FLASH_SR_BSY) != 0U) {
+		}
+		FLASH->CR &= ~(FLASH_CR_SER | FLASH_CR_SNB);
+
+		const uint32_t end = ((start + size) < length) ? (start + size) : length;
+		FLASH->CR |= FLASH_CR_PG;
+		for (uint32_t offset = start; offset < end; offset += sizeof(uint32_t)) {
+			*(__IO uint32_t*) (UPGRADE_APP_BASE + offset) = *(__IO uint32_t*) (UPGRADE_STAGING_BASE + offset);
+			while ((FLASH->SR & FLASH_SR_BSY) != 0U) {
+			}
+		}
+		FLASH->CR &= ~FLASH_CR_PG;
+	}
+
+	FLASH->CR |= FLASH_CR_PG;
+	trailer->installed = 0U;
+	while ((FLASH->SR & FLASH_SR_BSY) != 0U) {
+	}
+	FLASH->CR &= ~FLASH_CR_PG;
+
+	__DSB();
+	SCB->AIRCR = (0x5FAU << SCB_AIRCR_VECTKEY_Pos) | (SCB->AIRCR & SCB_AIRCR_PRIGROUP_Msk) | SCB_AIRCR_SYSRESETREQ_Msk;
+	__DSB();
+	for (;;) {
+	}
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Installs the staged image, if there is one and it is intact, and resets into it. Otherwise notes the image the last
+ * reset installed and erases the staging sectors if they are not already, readying them for an upload. Must be
+ * called at start up before any peripheral is initialized.
+ *
+ * @param none
+ * @retval none
+ */
+void Upgrade_Init(void) {
+	FLASH_Unlock();
+	FLASH_ClearFlag(UPGRADE_FLASH_ERRORS);
+	if ((trailer->magic == UPGRADE_TRAILER_MAGIC) && (trailer->length > 0U)
+			&& (trailer->length <= UPGRADE_MAX_IMAGE_SIZE)) {
+		if (trailer->installed == UPGRADE_NOT_INSTALLED) {
+			if (ComputeStagedCrc(trailer->length) == trailer->crc) {
+#ifdef UPGRADE_DEBUG
+				printf("[Upgrade] Installing the staged %" PRIu32 " byte image.\n\r", trailer->length);
+#endif
+				__disable_irq();
+				InstallImage(trailer->length);
+			}
+		} else {
+			installed = true;
+			installedLength = trailer->length;
+			installedCrc = trailer->crc;
+		}
+	}
+
+	stagingState = UPGRADE_IDLE;
+	if (IsStagingBlank() == false) {
+		/* Nothing is sampling yet, so the erase can stall the CPU now */
+		for (uint8_t sector = 0U; sector < UPGRADE_STAGING_SECTORS; ++sector) {
+			IWDG_ReloadCounter();
+			if (FLASH_EraseSector(UPGRADE_STAGING_SECTOR + (sector * (FLASH_Sector_1 - FLASH_Sector_0)),
+					FLASH_VOLTAGE_RANGE) != FLASH_COMPLETE) {
+				MarkDirty();
+				break;
+			}
+		}
+	}
+#ifdef UPGRADE_DEBUG
+	printf("[Upgrade] Staging sectors are %s.\n\r", STATE_STRINGS[stagingState]);
+#endif
+}
+
+/**
+ * Starts receiving an image into the staging sectors, which must be erased.
+ *
+ * @param length uint32_t The length of the image in bytes.
+ * @param crc uint32_t The CRC of the image, computed by the host.
+ * @retval UpgradeStatus_t The result of the request.
+ */
+UpgradeStatus_t Upgrade_Begin(uint32_t length, uint32_t crc) {
+	if (stagingState != UPGRADE_IDLE) {
+		return UPGRADE_ERR_BUSY;
+	}
+	if ((length == 0U) || (length > UPGRADE_MAX_IMAGE_SIZE)) {
+		return UPGRADE_ERR_SIZE;
+	}
+	imageLength = length;
+	imageCrc = crc;
+	receivedBytes = 0U;
+	programmed = 0U;
+	programmedCrc = UPGRADE_CRC_INITIAL;
+	buffered = 0U;
+	stagingState = UPGRADE_RECEIVING;
+	return UPGRADE_OK;
+}
+
+/**
+ * Copies received image bytes into the programming buffer, as many as it has room for. Bytes beyond the length of
+ * the image are not accepted.
+ *
+ * @param data const uint8_t* Pointer to the received bytes.
+ * @param length uint16_t The number of received bytes.
+ * @retval uint16_t The number of bytes accepted.
+ */
+uint16_t Upgrade_Accept(const uint8_t* data, uint16_t length) {
+	if (stagingState != UPGRADE_RECEIVING) {
+		return 0U;
+	}
+	uint32_t count = UPGRADE_BUFFER_SIZE - buffered;
+	if (count > (imageLength - receivedBytes)) {
+		count = imageLength - receivedBytes;
+	}
+	if (count > length) {
+		count = length;
+	}
+	memcpy(((uint8_t*) buffer) + buffered, data, count);
+	buffered += (uint16_t) count;
+	receivedBytes += count;
+	return (uint16_t) count;
+}
+
+/**
+ * Abandons the image being received or staged. A staged image's trailer is invalidated at once, so a reset before
+ * the staging sectors are erased can not install it.
+ *
+ * @param none
+ * @retval none
+ */
+void Upgrade_Abort(void) {
+	if (stagingState == UPGRADE_STAGED) {
+		FLASH_ProgramWord((uint32_t) &trailer->magic, 0U);
+		MarkDirty();
+	} else if (stagingState == UPGRADE_RECEIVING) {
+		MarkDirty();
+	}
+}
+
+/**
+ * Performs the next step of the staging job: programming buffered image words or erasing the staging sectors. Must
+ * not be called while another FLASH operation is in progress.
+ *
+ * @param idle bool TRUE if the erase of a staging sector may stall the CPU now.
+ * @retval bool TRUE if there is more work ready.
+ */
+bool Upgrade_Service(bool idle) {
+	bool more = false;
+	switch (stagingState) {
+	case UPGRADE_DIRTY:
+		if (idle == true) {
+			StartErase();
+		}
+		break;
+	case UPGRADE_ERASING:
+		if (FLASH_GetStatus() != FLASH_BUSY) {
+			FLASH->CR &= ~(FLASH_CR_SER | FLASH_CR_SNB);
+			if (FLASH_GetStatus() != FLASH_COMPLETE) {
+				/* Retry the sector the next time the inputs are idle */
+				stagingState = UPGRADE_DIRTY;
+			} else if (++eraseIndex < UPGRADE_STAGING_SECTORS) {
+				stagingState = UPGRADE_DIRTY;
+				more = idle;
+			} else {
+				stagingState = UPGRADE_IDLE;
+			}
+		}
+		break;
+	case UPGRADE_RECEIVING:
+		more = ProgramBuffered();
+		if ((stagingState == UPGRADE_RECEIVING) && (programmed >= imageLength)) {
+			FinishImage();
+			more = false;
+		}
+		break;
+	case UPGRADE_IDLE:
+	case UPGRADE_STAGED:
+	case NUM_UPGRADE_STATES:
+	default:
+		break;
+	}
+	return more;
+}
+
+/**
+ * Indicates if a staging sector is being erased, during which no other FLASH operation may be started.
+ *
+ * @param none
+ * @retval bool TRUE if an erase is in progress.
+ */
+bool Upgrade_IsErasing(void) {
+	return (stagingState == UPGRADE_ERASING);
+}
+
+/**
+ * Retrieves the state of the staging sectors.
+ *
+ * @param none
+ * @retval UpgradeState_t The state of the staging sectors.
+ */
+UpgradeState_t Upgrade_GetState(void) {
+	return stagingState;
+}
+
+/**
+ * Retrieves the progress of the image being received or staged.
+ *
+ * @param received uint32_t* Set to the number of image bytes received.
+ * @param length uint32_t* Set to the length of the image.
+ * @param crc uint32_t* Set to the CRC of the image.
+ * @retval none
+ */
+void Upgrade_GetProgress(uint32_t* received, uint32_t* length, uint32_t* crc) {
+	*received = receivedBytes;
+	*length = imageLength;
+	*crc = imageCrc;
+}
+
+/**
+ * Retrieves the length and CRC of the image the last reset installed.
+ *
+ * @param length uint32_t* Set to the length of the installed image.
+ * @param crc uint32_t* Set to the CRC of the installed image.
+ * @retval bool TRUE if the last reset installed an image.
+ */
+bool Upgrade_GetInstalled(uint32_t* length, uint32_t* crc) {
+	*length = installedLength;
+	*crc = installedCrc;
+	return installed;
+}
+
+/**
+ * Return the human readable string representation of the provided upgrade state.
+ *
+ * @param state UpgradeState_t The state to convert.
+ * @retval const char* The human readable string, or NULL if the state is invalid.
+ */
+const char* Upgrade_StringFromState(UpgradeState_t state) {
+	return (state < NUM_UPGRADE_STATES) ? STATE_STRINGS[state] : NULL;
+}
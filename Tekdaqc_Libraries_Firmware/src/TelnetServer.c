@@ -15,9 +15,13 @@
  * @file TelnetServer.c
  * @brief Implements a control interface for the Tekdaqc via the Telnet protocol.
  *
- * Implements a control interface for the Tekdaqc via the Telnet protocol. Only a single connection
- * is allowed at a time. Any attempts to connect while an active connection is present will result in
- * an error message from the board.
+ * Implements a control interface for the Tekdaqc via the Telnet protocol. Up to TELNET_MAX_SESSIONS clients
+ * may be connected at a time, each with its own receive buffer, transmit ring and option state, so that one client
+ * can stream data while others monitor status or send occasional commands. Any attempts to connect while every
+ * session is in use will result in an error message from the board.
+ *
+ * The public read and write methods operate on the current session, which is the session whose commands are being
+ * processed. Sample data is encoded once and published to every subscribed session.
  *
  * This file based on the Telnet server implementation in the TI Stellaris example Cave Adventure game,
  * in particular, the methods for processing the Telnet state machine.
@@ -37,11 +41,31 @@
 #include "lwip/debug.h"
 #include "lwip/stats.h"
 #include "lwip/tcp.h"
+#include "lwip/tcp_impl.h"
+#include "Tekdaqc_Timers.h"
+#include "Tekdaqc_Profile.h"
+#include "netconf.h"
+#include <string.h>
 
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE DEFINES */
 /*--------------------------------------------------------------------------------------------------------*/
 
+/**
+ * @internal
+ * @def TELNET_BUFFER_RESERVE
+ * @brief The number of bytes at the end of the transmit buffer kept free for responses to received telnet commands.
+ */
+#define TELNET_BUFFER_RESERVE	32U
+
+#if ((TELNET_BUFFER_LENGTH & TELNET_BUFFER_MASK) != 0U)
+#error "TELNET_BUFFER_LENGTH must be a power of two."
+#endif
+
+#if (TCP_WND > TELNET_BUFFER_LENGTH)
+#error "The telnet receive ring must be able to hold a full TCP receive window."
+#endif
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE VARIABLES */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -54,15 +78,47 @@ static struct tcp_pcb *telnet_pcb;
 
 /**
  * @internal
- * @brief Pointer to the current Telnet server.
+ * @brief The table of Telnet sessions. A session is in use while its pcb is set.
+ */
+static TelnetServer_t telnet_sessions[TELNET_MAX_SESSIONS];
+
+/**
+ * @internal
+ * @brief Pointer to the current Telnet session, which the public read and write methods operate on.
+ */
+static TelnetServer_t* telnet_server = &telnet_sessions[0];
+
+/**
+ * @internal
+ * @brief The format sample data is sent in. Data is encoded once for every subscribed session, so the format is
+ * shared by all of them.
  */
-static TelnetServer_t telnet_server;
+static DataFormat_t dataFormat = DATA_FORMAT_TEXT;
 
 /**
  * @internal
- * @brief Indicates the connection status of the telnet server.
+ * @brief The DATA_FIELD_ bits of the fields each sample is sent with, shared by all sessions like the format.
  */
-static bool IsConnected = false;
+static uint8_t dataFields = DATA_FIELDS_DEFAULT;
+
+/**
+ * @internal
+ * @brief The time in microseconds data may wait in the transmit ring for a full segment to accumulate.
+ */
+static uint32_t flushLatency = TELNET_FLUSH_LATENCY_DEFAULT_US;
+
+/**
+ * @internal
+ * @brief Set if small writes are sent without waiting for outstanding data to be ACKed, and received data is ACKed
+ * at once rather than delayed.
+ */
+static bool noDelay = TELNET_NO_DELAY_DEFAULT;
+
+/**
+ * @internal
+ * @brief The number of bytes handed to lwIP over all sessions since start up.
+ */
+static uint32_t bytesSent = 0U;
 
 /**
  * @internal
@@ -79,16 +135,17 @@ static const char ErrorMessage[53] = "The Tekdaqc is already in use...try again
 
 /**
  * @internal
- * @brief The initialization sequence sent to a remote telnet client when it first connects to the telnet server.
+ * @brief The initial option state of each session. This telnet server will always suppress go ahead generation,
+ * regardless of this setting.
  */
-static const char TelnetInit[] = { TELNET_IAC, TELNET_DO, TELNET_OPT_SUPPRESS_GA, TELNET_IAC, TELNET_WILL, TELNET_OPT_ECHO };
+static const TelnetOpts_t TelnetDefaultOptions[TELNET_OPTION_COUNT] = { { .option = TELNET_OPT_SUPPRESS_GA, .flags = (0x01
+		<< OPT_FLAG_WILL ) }, { .option = TELNET_OPT_ECHO, .flags = (1 << OPT_FLAG_DO ) } };
 
 /**
  * @internal
- * @brief This telnet server will always suppress go ahead generation, regardless of this setting.
+ * @brief The initialization sequence sent to a remote telnet client when it first connects to the telnet server.
  */
-static TelnetOpts_t TelnetOptions[] = { { .option = TELNET_OPT_SUPPRESS_GA, .flags = (0x01 << OPT_FLAG_WILL ) }, { .option = TELNET_OPT_ECHO,
-		.flags = (1 << OPT_FLAG_DO ) } };
+static const char TelnetInit[] = { TELNET_IAC, TELNET_DO, TELNET_OPT_SUPPRESS_GA, TELNET_IAC, TELNET_WILL, TELNET_OPT_ECHO };
 
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE FUNCTION PROTOTYPES */
@@ -120,10 +177,113 @@ static void TelnetError(void *arg, err_t err);
 static void ClearToMessageBuffer(void);
 
 /**
- * @brief Creates an initalizes a Telnet server.
+ * @brief Empties the transmit ring.
+ */
+static void TelnetResetTransmit(TelnetServer_t* server);
+
+/**
+ * @brief Retrieves the free space in the transmit ring, less a reserve.
+ */
+static uint16_t TelnetRingFree(TelnetServer_t* server, uint16_t reserve);
+
+/**
+ * @brief Copies as much of a block of data into the transmit ring as fits, less a reserve.
+ */
+static uint16_t TelnetRingWrite(TelnetServer_t* server, const char* data, uint16_t length, uint16_t reserve);
+
+/**
+ * @brief Hands any unsent data in the transmit ring to lwIP.
+ */
+static void TelnetTransmit(TelnetServer_t* server);
+
+/**
+ * @internal
+ * @brief Hands the data of the transmit ring which has not been queued to lwIP, optionally only to the end of a record.
+ */
+static bool TelnetTransmitRing(TelnetServer_t* server, bool toRecord);
+
+/**
+ * @internal
+ * @brief Hands the data waiting in the priority buffer to lwIP.
+ */
+static bool TelnetTransmitPriority(TelnetServer_t* server);
+
+/**
+ * @brief Determines if the pending data in the transmit ring should be sent now.
+ */
+static bool isTelnetFlushDue(TelnetServer_t* server);
+
+/**
+ * @brief Releases the transmit segments which have been ACKed by the client.
+ */
+static void TelnetReleaseAcked(TelnetServer_t* server, u16_t len);
+
+/**
+ * @internal
+ * @brief Discards the data of the transmit ring which has not been handed to lwIP.
+ */
+static void TelnetDiscardRing(TelnetServer_t* server);
+
+/**
+ * @internal
+ * @brief Releases ACKed data of the transmit ring.
+ */
+static void TelnetReleaseRing(TelnetServer_t* server, u16_t len);
+
+/**
+ * @brief Writes a three byte telnet option response into the transmit ring.
+ */
+static void TelnetSendOption(char command, char option);
+
+/**
+ * @brief Creates an initalizes a Telnet server in a free session.
  */
 static TelnetServer_t* CreateTelnetServer(void);
 
+/**
+ * @brief Closes the TCP connection of a session.
+ */
+static void TelnetCloseSession(TelnetServer_t* server);
+
+/**
+ * @internal
+ * @brief Aborts the TCP connection of a session, releasing the session for a new client.
+ */
+static void TelnetAbortSession(TelnetServer_t* server);
+
+/**
+ * @brief Determines if a session has a connected client.
+ */
+static bool isSessionConnected(const TelnetServer_t* server);
+
+/**
+ * @brief Writes a complete block of data to the telnet interface if there is room for it.
+ */
+static WriteStatus_t TelnetQueue(const char* data, uint16_t length);
+
+/**
+ * @internal
+ * @brief Copy a complete message into the priority buffer if there is room.
+ */
+static WriteStatus_t TelnetQueuePriority(const char* data, uint16_t length);
+
+/**
+ * @brief Writes a complete block of data to every subscribed session if all of them have room for it.
+ */
+static WriteStatus_t TelnetPublish(const char* data, uint16_t length);
+
+/**
+ * @internal
+ * @brief Stores and echoes a span of received characters which contains no IAC byte.
+ */
+static void TelnetProcessSpan(const char* data, uint16_t length);
+
+/**
+ * @internal
+ * @brief Releases bytes read out of the receive ring, reopening the TCP receive window by as much.
+ */
+static void TelnetRecvRelease(uint16_t length);
+
 /*--------------------------------------------------------------------------------------------------------*/
 /* PRIVATE METHODS */
 /*--------------------------------------------------------------------------------------------------------*/
@@ -147,12 +307,13 @@ static err_t TelnetAccept(void *arg, struct tcp_pcb *pcb, err_t err) {
 	LWIP_UNUSED_ARG(arg);
 	LWIP_UNUSED_ARG(err);
 
-	/* Check if already connected. */
-	if (TelnetIsConnected() == true) {
-		/* There is already a connected client, so refuse this connection with
+	/* Claim a free session. */
+	TelnetServer_t* server = CreateTelnetServer();
+	if (server == NULL ) {
+		/* Every session has a connected client, so refuse this connection with
 			 a message indicating this fact. */
 #ifdef TELNET_DEBUG
-		printf("[Telnet Server] A connection was attempted while an active connection is open.\n\r");
+		printf("[Telnet Server] A connection was attempted while every session is in use.\n\r");
 #endif
 		tcp_accepted(pcb);
 		tcp_arg(pcb, NULL );
@@ -166,18 +327,21 @@ static err_t TelnetAccept(void *arg, struct tcp_pcb *pcb, err_t err) {
 	/* Setup the TCP connection priority. */
 	tcp_setprio(pcb, TCP_PRIO_MIN);
 
-	CreateTelnetServer();
+	/* Output is coalesced by the transmit ring's flush policy, so Nagle would only add latency. */
+	if (noDelay == true) {
+		tcp_nagle_disable(pcb);
+	} else {
+		tcp_nagle_enable(pcb);
+	}
+
 #ifdef TELNET_DEBUG
 	printf("[Telnet Server] Initializing telnet server.\n\r");
 #endif
-	telnet_server.pcb = pcb;
-	telnet_server.pcb->so_options |= SOF_KEEPALIVE;
-	telnet_server.pcb->keep_idle = 5000;
-	telnet_server.pcb->keep_intvl = 1000;
-	telnet_server.pcb->keep_cnt = 5;
-
-	/* Mark that a client has connected. */
-	IsConnected = true;
+	/* Storing the pcb marks that a client has connected to this session. */
+	server->pcb = pcb;
+	server->ackedAt = GetLocalTime();
+	LwIP_EnableKeepalive(pcb);
+
 	/* Accept this connection. */
 	tcp_accepted(pcb);
 #ifdef TELNET_DEBUG
@@ -185,7 +349,7 @@ static err_t TelnetAccept(void *arg, struct tcp_pcb *pcb, err_t err) {
 #endif
 
 	/* Setup the TCP callback argument. */
-	tcp_arg(pcb, &telnet_server);
+	tcp_arg(pcb, server);
 
 	/* Initialize lwIP tcp_recv callback function for pcb  */
 	tcp_recv(pcb, TelnetReceive);
@@ -201,17 +365,21 @@ static err_t TelnetAccept(void *arg, struct tcp_pcb *pcb, err_t err) {
 	/* Initialize the count of outstanding bytes.  The initial byte acked as
 	 part of the SYN -> SYN/ACK sequence is included so that the byte count
 	 works out correctly at the end. */
-	telnet_server.outstanding = sizeof(TelnetInit) + 1;
+	server->outstanding = 1;
 	/* Do not close the telnet connection until requested. */
-	telnet_server.close = 0;
+	server->close = 0;
 #ifdef TELNET_DEBUG
 	printf("[Telnet Server] Writing the init messages\n\r");
 #endif
 	/* Send the telnet initialization string. */
-	tcp_write(pcb, TelnetInit, sizeof(TelnetInit), 1);
-	tcp_output(pcb);
+	TelnetRingWrite(server, TelnetInit, sizeof(TelnetInit), 0U);
 
+	/* The welcome is written through the public API, so make the new session current while it is written. */
+	TelnetServer_t* current = telnet_server;
+	telnet_server = server;
 	TelnetWriteStatusMessage("[TELNET] Telnet Server Connected. Welcome.");
+	telnet_server = current;
+	TelnetTransmit(server);
 
 	/* Return a success code. */
 	ret_err = ERR_OK;
@@ -231,8 +399,11 @@ static err_t TelnetAccept(void *arg, struct tcp_pcb *pcb, err_t err) {
  */
 static err_t TelnetReceive(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err) {
 	struct pbuf *q;
-	unsigned long ulIdx;
-	unsigned char *pucData;
+	const char* data;
+	const char* iac;
+	uint16_t remaining;
+	uint16_t span;
+	uint32_t stored;
 	TelnetServer_t* server;
 	if (arg != NULL ) {
 		server = (TelnetServer_t*) arg;
@@ -247,27 +418,90 @@ static err_t TelnetReceive(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t
 #ifdef TELNET_DEBUG
 		printf("[Telnet Server] Processing received packet.\n\r");
 #endif
-		/* Accept the packet from TCP. */
-		tcp_recved(pcb, p->tot_len);
+		/* The characters are processed through the public API, so make this session current while they are. */
+		TelnetServer_t* current = telnet_server;
+		telnet_server = server;
+		stored = server->recvWrite;
 		/* Loop through the pbufs in this packet. */
-		for (q = p, pucData = (unsigned char*) q->payload; q != NULL ; q = q->next) {
-			/* Loop through the bytes in this pbuf. */
-			for (ulIdx = 0; ulIdx < q->len; ulIdx++) {
-				/* Process this character. */
-				TelnetProcessCharacter(pucData[ulIdx]);
+		for (q = p; q != NULL ; q = q->next) {
+			data = (const char*) q->payload;
+			remaining = q->len;
+			while (remaining > 0U) {
+				if (telnet_server->state == STATE_NORMAL) {
+					/* Everything up to the next IAC byte is command text, so it is handled in bulk. */
+					iac = (const char*) memchr(data, TELNET_IAC, remaining);
+					span = (iac == NULL) ? remaining : (uint16_t) (iac - data);
+					TelnetProcessSpan(data, span);
+					data += span;
+					remaining -= span;
+					if (remaining == 0U) {
+						break;
+					}
+				}
+				/* Only the bytes of a telnet command sequence go through the option parser. */
+				TelnetProcessCharacter(*data);
+				++data;
+				--remaining;
 			}
 		}
+		telnet_server = current;
+		/* Accept the bytes which did not go into the receive ring from TCP now, the rest as they are read. Since the
+		 ring holds a full receive window, the client can never send more than it has room for. */
+		stored = server->recvWrite - stored;
+		tcp_recved(pcb, (u16_t) (p->tot_len - stored));
+		if (noDelay == true) {
+			/* ACK the command at once, so a host using Nagle can send the next without waiting for a delayed ACK */
+			tcp_ack_now(pcb);
+		}
 		/* Free the pbuf. */
 		pbuf_free(p);
 	} else if ((err == ERR_OK) && (p == NULL )) {
 		/* If a null packet is passed in, close the connection. */
-		server->length = 0;
-		TelnetClose();
+		TelnetResetTransmit(server);
+		TelnetCloseSession(server);
 	}
 	/* Return okay. */
 	return (ERR_OK);
 }
 
+/**
+ * @internal
+ * Stores a span of received characters in the receive buffer and echoes it back to the client, as
+ * TelnetProcessCharacter() does for each character in the normal state.
+ *
+ * @param data const char* Pointer to the received characters, none of which may be TELNET_IAC.
+ * @param length uint16_t The number of characters in the span.
+ * @retval none
+ */
+static void TelnetProcessSpan(const char* data, uint16_t length) {
+	uint16_t echoed;
+	TelnetRecvBufferWriteBytes(data, length);
+
+	/* Echo the span back, counting whatever did not fit as dropped. */
+	echoed = TelnetWriteBytes(data, length);
+	if (echoed < length) {
+#ifdef TELNET_DEBUG
+		printf("[Telnet Server] Telnet buffer is full!\n\r");
+#endif
+		telnet_server->dropped += (length - echoed);
+	}
+}
+
+/**
+ * @internal
+ * Releases bytes read out of the current session's receive ring. They were held back from TCP when they arrived, so
+ * they are accepted now, reopening the client's send window by as much.
+ *
+ * @param length uint16_t The number of bytes read.
+ * @retval none
+ */
+static void TelnetRecvRelease(uint16_t length) {
+	telnet_server->recvRead += length;
+	if ((telnet_server->pcb != NULL ) && (length > 0U)) {
+		tcp_recved(telnet_server->pcb, length);
+	}
+}
+
 /**
  * @internal
  * This function is called when the lwIP TCP/IP stack has received an
@@ -287,6 +521,12 @@ static err_t TelnetSent(void *arg, struct tcp_pcb *pcb, u16_t len) {
 #endif
 		/* Decrement the count of outstanding bytes. */
 		server->outstanding -= len;
+		server->ackedAt = GetLocalTime();
+		/* Hand the ACKed segments back to the ring and send anything which is ready. */
+		TelnetReleaseAcked(server, len);
+		if (isTelnetFlushDue(server) == true) {
+			TelnetTransmit(server);
+		}
 	} else {
 		/* See if this is the ACK for the error message. */
 		if (len == sizeof(ErrorMessage)) {
@@ -317,47 +557,549 @@ static void TelnetError(void *arg, err_t err) {
 	TelnetServer_t* server;
 	server = (TelnetServer_t*) arg;
 	if (server != NULL ) {
-		/* free es structure */
-		mem_free(server);
+		/* lwIP has already freed the pcb, so just release the session */
+		server->pcb = NULL;
+	}
+}
+
+/**
+ * @internal
+ * Creates and initializes a Telnet server in the first free session of the session table.
+ *
+ * @param none
+ * @retval TelnetServer_t* The structure used to represent the new session, or NULL if every session is in use.
+ */
+static TelnetServer_t* CreateTelnetServer(void) {
+#ifdef TELNET_DEBUG
+	printf("[Telnet Server] Allocating memory for server.\n\r");
+#endif
+	TelnetServer_t* server = NULL;
+	for (uint_fast8_t i = 0; i < TELNET_MAX_SESSIONS; ++i) {
+		if (telnet_sessions[i].pcb == NULL ) {
+			server = &telnet_sessions[i];
+			break;
+		}
+	}
+	if (server == NULL ) {
+		return NULL ;
+	}
+	if (TelnetIsConnected() == false) {
+		/* The first client to connect starts out with text data */
+		dataFormat = DATA_FORMAT_TEXT;
+		dataFields = DATA_FIELDS_DEFAULT;
+	}
+	server->halt = false;
+	server->state = STATE_NORMAL;
+	server->recvWrite = 0;
+	server->recvRead = 0;
+	server->previous = 0;
+	TelnetResetTransmit(server);
+	memcpy(server->options, TelnetDefaultOptions, sizeof(server->options));
+	server->subscribed = true; /* Every connection receives sample data until it unsubscribes */
+	server->dropped = 0;
+	for (uint32_t i = 0U; i < TELNET_BUFFER_LENGTH; ++i) {
+		server->recvBuffer[i] = 0;
+	}
+	return server;
+}
+
+/**
+ * @internal
+ * Closes the TCP connection of a session, releasing the session for a new client.
+ *
+ * @param server TelnetServer_t* Pointer to the session to close.
+ * @retval none
+ */
+static void TelnetCloseSession(TelnetServer_t* server) {
+	printf("Closing telnet connection.\n\r");
+	struct tcp_pcb *pcb = server->pcb;
+	if (pcb == NULL ) {
+		return;
+	}
+
+	/* Remove all callbacks */
+	tcp_arg(pcb, NULL );
+	tcp_sent(pcb, NULL );
+	tcp_recv(pcb, NULL );
+	tcp_err(pcb, NULL );
+	tcp_poll(pcb, NULL, 0);
+
+	/* Clear the telnet data structure pointer, to indicate that there is no longer a connection. */
+	server->pcb = 0;
+
+	/* Close tcp connection */
+	tcp_close(pcb);
+}
+
+/**
+ * @internal
+ * Aborts the TCP connection of a session whose client has gone, releasing the session and its transmit ring for a
+ * new client at once rather than waiting for the unacknowledged data to be ACKed. Must only be called from a
+ * callback of the connection if the callback then returns ERR_ABRT.
+ *
+ * @param server TelnetServer_t* Pointer to the session to abort.
+ * @retval none
+ */
+static void TelnetAbortSession(TelnetServer_t* server) {
+	struct tcp_pcb *pcb = server->pcb;
+	if (pcb == NULL ) {
+		return;
+	}
+	tcp_arg(pcb, NULL );
+	tcp_sent(pcb, NULL );
+	tcp_recv(pcb, NULL );
+	tcp_err(pcb, NULL );
+	tcp_poll(pcb, NULL, 0);
+	server->pcb = NULL;
+	tcp_abort(pcb);
+	TelnetResetTransmit(server);
+}
+
+/**
+ * @internal
+ * Determines if a session has a connected client.
+ *
+ * @param server const TelnetServer_t* Pointer to the session to check.
+ * @retval bool TRUE if the session has a connected client.
+ */
+static bool isSessionConnected(const TelnetServer_t* server) {
+	return (server->pcb != NULL );
+}
+
+/**
+ * @internal
+ * Clears the internal message string buffer.
+ *
+ * @param none
+ * @retval none
+ */
+static void ClearToMessageBuffer(void) {
+	for (uint_fast8_t i = 0; i < SIZE_TOSTRING_BUFFER; ++i) {
+		MESSAGE_BUFFER[i] = '\0';
+	}
+}
+
+/**
+ * @internal
+ * Copies a complete block of data into the transmit buffer if there is room for all of it. This never waits;
+ * the buffer only drains from the lwIP callbacks, which can not run while the caller is spinning.
+ *
+ * @param data const char* Pointer to the data to write.
+ * @param length uint16_t The number of bytes to write.
+ * @retval WriteStatus_t The result of the write. Nothing is copied unless WRITE_OK is returned.
+ */
+static WriteStatus_t TelnetQueue(const char* data, uint16_t length) {
+	if (isSessionConnected(telnet_server) == false) {
+		return WRITE_NOT_CONNECTED;
+	}
+	if (length > (TELNET_TX_RING_SIZE - TELNET_BUFFER_RESERVE)) {
+		return WRITE_TOO_LARGE;
+	}
+	if (TelnetGetFreeSpace() < length) {
+#ifdef TELNET_DEBUG
+		printf("[Telnet Server] Telnet buffer is full!\n\r");
+#endif
+		return WRITE_BUSY;
+	}
+	TelnetWriteBytes(data, length);
+	return WRITE_OK;
+}
+
+/**
+ * @internal
+ * Copies a complete message into the priority buffer of the current session if there is room for all of it. The
+ * buffer is sent ahead of whatever the transmit ring has not yet handed to lwIP, at the next record boundary, so
+ * status and error messages are not held up behind sample data. As with TelnetQueue(), this never waits.
+ *
+ * @param data const char* Pointer to the message to write.
+ * @param length uint16_t The number of bytes to write.
+ * @retval WriteStatus_t The result of the write. Nothing is copied unless WRITE_OK is returned.
+ */
+static WriteStatus_t TelnetQueuePriority(const char* data, uint16_t length) {
+	TelnetServer_t* server = telnet_server;
+	if (isSessionConnected(server) == false) {
+		return WRITE_NOT_CONNECTED;
+	}
+	if (length > TELNET_PRIORITY_BUFFER_SIZE) {
+		return WRITE_TOO_LARGE;
+	}
+	if ((TELNET_PRIORITY_BUFFER_SIZE - server->priorityLength) < length) {
+#ifdef TELNET_DEBUG
+		printf("[Telnet Server] Telnet priority buffer is full!\n\r");
+#endif
+		return WRITE_BUSY;
+	}
+	memcpy(&server->priority[server->priorityLength], data, length);
+	server->priorityLength += length;
+	return WRITE_OK;
+}
+
+/**
+ * @internal
+ * Copies a complete block of data into the transmit ring of every subscribed session if all of them have room for
+ * it, so that no subscriber misses part of the data. As with TelnetQueue(), this never waits.
+ *
+ * @param data const char* Pointer to the data to write.
+ * @param length uint16_t The number of bytes to write.
+ * @retval WriteStatus_t The result of the write. Nothing is copied unless WRITE_OK is returned.
+ */
+static WriteStatus_t TelnetPublish(const char* data, uint16_t length) {
+	if (TelnetHasSubscribers() == false) {
+		return WRITE_NOT_CONNECTED;
+	}
+	if (length > (TELNET_TX_RING_SIZE - TELNET_BUFFER_RESERVE)) {
+		return WRITE_TOO_LARGE;
+	}
+	for (uint_fast8_t i = 0; i < TELNET_MAX_SESSIONS; ++i) {
+		TelnetServer_t* server = &telnet_sessions[i];
+		if ((isSessionConnected(server) == true) && (server->subscribed == true)
+				&& (TelnetRingFree(server, TELNET_BUFFER_RESERVE) < length)) {
+#ifdef TELNET_DEBUG
+			printf("[Telnet Server] Telnet buffer of a subscriber is full!\n\r");
+#endif
+			return WRITE_BUSY;
+		}
+	}
+	for (uint_fast8_t i = 0; i < TELNET_MAX_SESSIONS; ++i) {
+		TelnetServer_t* server = &telnet_sessions[i];
+		if ((isSessionConnected(server) == true) && (server->subscribed == true)) {
+			TelnetRingWrite(server, data, length, TELNET_BUFFER_RESERVE);
+		}
+	}
+	return WRITE_OK;
+}
+
+/**
+ * @internal
+ * Empties the transmit ring, leaving a single empty segment ready to be filled.
+ *
+ * @param server TelnetServer_t* Pointer to the server whose ring should be emptied.
+ * @retval none
+ */
+static void TelnetResetTransmit(TelnetServer_t* server) {
+	for (uint_fast8_t i = 0; i < TELNET_TX_SEGMENT_COUNT; ++i) {
+		server->segments[i].length = 0U;
+		server->segments[i].queued = 0U;
+		server->segments[i].acked = 0U;
+		server->segments[i].boundary = 0U;
+	}
+	server->txHead = 0U;
+	server->txTail = 0U;
+	server->txUsed = 1U;
+	server->unsent = 0U;
+	server->unsentSince = 0U;
+	server->txPeak = 0U;
+	server->txAtRecord = true;
+	server->ringQueued = 0U;
+	server->ringAcked = 0U;
+	server->priorityLength = 0U;
+	server->prioritySpanCount = 0U;
+}
+
+/**
+ * @internal
+ * Retrieves the number of bytes which can be written into the transmit ring while keeping the requested number of
+ * bytes free.
+ *
+ * @param server TelnetServer_t* Pointer to the session whose ring should be checked.
+ * @param reserve uint16_t The number of bytes to keep free.
+ * @retval uint16_t The number of bytes which can be written.
+ */
+static uint16_t TelnetRingFree(TelnetServer_t* server, uint16_t reserve) {
+	uint32_t available = (TELNET_TX_SEGMENT_SIZE - server->segments[server->txHead].length)
+			+ ((TELNET_TX_SEGMENT_COUNT - server->txUsed) * TELNET_TX_SEGMENT_SIZE);
+	return (available > reserve) ? (uint16_t) (available - reserve) : 0U;
+}
+
+/**
+ * @internal
+ * Copies as much of the provided data into the transmit ring as will fit while keeping the requested number of
+ * bytes free. A new segment is only started once the current one is full, so every segment but the last one handed
+ * to lwIP fills a whole packet. A write which is accepted in full ends a record, marking where priority data may be
+ * placed between the ring's data.
+ *
+ * @param server TelnetServer_t* Pointer to the session to write to.
+ * @param data const char* Pointer to the data to write.
+ * @param length uint16_t The number of bytes to write.
+ * @param reserve uint16_t The number of bytes to keep free.
+ * @retval uint16_t The number of bytes accepted into the ring.
+ */
+static uint16_t TelnetRingWrite(TelnetServer_t* server, const char* data, uint16_t length, uint16_t reserve) {
+	uint16_t accepted = TelnetRingFree(server, reserve);
+	if (accepted > length) {
+		accepted = length;
+	}
+	if ((server->unsent == 0U) && (accepted > 0U)) {
+		/* The flush deadline runs from the oldest unsent byte */
+		server->unsentSince = GetLocalTime();
+	}
+	server->unsent += accepted;
+	uint16_t remaining = accepted;
+	while (remaining > 0U) {
+		TelnetTxSegment_t* segment = &server->segments[server->txHead];
+		if (segment->length == TELNET_TX_SEGMENT_SIZE) {
+			/* The free space check guarantees there is another segment available */
+			server->txHead = (server->txHead + 1U) % TELNET_TX_SEGMENT_COUNT;
+			++server->txUsed;
+			segment = &server->segments[server->txHead];
+			segment->length = 0U;
+			segment->queued = 0U;
+			segment->acked = 0U;
+			segment->boundary = 0U;
+		}
+		uint16_t count = TELNET_TX_SEGMENT_SIZE - segment->length;
+		if (count > remaining) {
+			count = remaining;
+		}
+		memcpy(&segment->data[segment->length], data, count);
+		segment->length += count;
+		data += count;
+		remaining -= count;
+	}
+	if (accepted == length) {
+		server->segments[server->txHead].boundary = server->segments[server->txHead].length;
+	}
+	uint16_t used = TELNET_TX_RING_SIZE - TelnetRingFree(server, 0U);
+	if (used > server->txPeak) {
+		server->txPeak = used;
+	}
+	return accepted;
+}
+
+/**
+ * @internal
+ * Hands any data waiting to be sent to lwIP, as much as the send buffer allows. Messages in the priority buffer go
+ * first, as soon as the ring data already handed to lwIP ends at a record boundary: if lwIP is part way through a
+ * record, only the rest of it is sent ahead of them. No more ring data is sent while they wait for room.
+ *
+ * @param server TelnetServer_t* Pointer to the server to transmit for.
+ * @retval none
+ */
+static void TelnetTransmit(TelnetServer_t* server) {
+	if (server->pcb == NULL ) {
+		return;
+	}
+	bool written = false;
+	if (server->priorityLength > 0U) {
+		if (server->txAtRecord == false) {
+			/* Finish the record lwIP is part way through */
+			written = TelnetTransmitRing(server, true);
+		}
+		if ((server->txAtRecord == true) && (TelnetTransmitPriority(server) == true)) {
+			written = true;
+		}
+	}
+	if ((server->priorityLength == 0U) && (TelnetTransmitRing(server, false) == true)) {
+		written = true;
+	}
+	if (written == true) {
+		/* Output the telnet data. */
+		tcp_output(server->pcb);
+	}
+}
+
+/**
+ * @internal
+ * Hands the data in the transmit ring which has not yet been queued to lwIP, as much as the send buffer allows.
+ * The data is passed by reference rather than copied; it stays in place until TelnetReleaseAcked() is called for it.
+ *
+ * @param server TelnetServer_t* Pointer to the server to transmit for.
+ * @param toRecord bool TRUE to stop at the first record boundary found.
+ * @retval bool TRUE if any data was handed to lwIP.
+ */
+static bool TelnetTransmitRing(TelnetServer_t* server, bool toRecord) {
+	bool written = false;
+	uint8_t index = server->txTail;
+	for (uint_fast8_t i = 0; i < server->txUsed; ++i) {
+		TelnetTxSegment_t* segment = &server->segments[index];
+		uint16_t pending = segment->length - segment->queued;
+		if ((toRecord == true) && (segment->boundary > segment->queued)) {
+			pending = segment->boundary - segment->queued;
+		}
+		if (pending > 0U) {
+			uint16_t space = tcp_sndbuf(server->pcb);
+			if (pending > space) {
+				pending = space;
+			}
+			if ((pending == 0U) || (tcp_write(server->pcb, &segment->data[segment->queued], pending, 0) != ERR_OK)) {
+				/* lwIP is out of room, the rest is sent once more data has been ACKed */
+				break;
+			}
+			segment->queued += pending;
+			server->unsent -= pending;
+			server->outstanding += pending;
+			server->ringQueued += pending;
+			bytesSent += pending;
+			written = true;
+			/* Only the last record boundary of each segment is known, an earlier one counts as mid record */
+			server->txAtRecord = (segment->queued == segment->boundary);
+			if ((segment->queued != segment->length) || ((toRecord == true) && (server->txAtRecord == true))) {
+				break;
+			}
+		}
+		index = (index + 1U) % TELNET_TX_SEGMENT_COUNT;
+	}
+	return written;
+}
+
+/**
+ * @internal
+ * Hands the data waiting in the priority buffer to lwIP in a single write, if the send buffer has room for all of
+ * it. lwIP copies the data, so the buffer is free again at once; the write is recorded as a span so that its ACKs
+ * are not taken for those of the ring data either side of it.
+ *
+ * @param server TelnetServer_t* Pointer to the server to transmit for.
+ * @retval bool TRUE if the data was handed to lwIP.
+ */
+static bool TelnetTransmitPriority(TelnetServer_t* server) {
+	if ((server->prioritySpanCount >= TELNET_PRIORITY_SPAN_COUNT) || (tcp_sndbuf(server->pcb) < server->priorityLength)
+			|| (tcp_write(server->pcb, server->priority, server->priorityLength, TCP_WRITE_FLAG_COPY) != ERR_OK)) {
+		return false;
+	}
+	TelnetPrioritySpan_t* span = &server->prioritySpans[server->prioritySpanCount];
+	++server->prioritySpanCount;
+	span->after = server->ringQueued;
+	span->length = server->priorityLength;
+	server->outstanding += server->priorityLength;
+	bytesSent += server->priorityLength;
+	server->priorityLength = 0U;
+	return true;
+}
+
+/**
+ * @internal
+ * Determines if the unsent data in the transmit ring should be handed to lwIP now. Data is sent as soon as a full
+ * segment is waiting, or once the oldest unsent byte has waited for the flush latency. Priority data is always sent
+ * at once.
+ *
+ * @param server TelnetServer_t* Pointer to the server to check.
+ * @retval bool TRUE if the pending data should be sent.
+ */
+static bool isTelnetFlushDue(TelnetServer_t* server) {
+	if (server->priorityLength > 0U) {
+		return true;
+	}
+	if (server->unsent == 0U) {
+		return false;
+	}
+	if (server->unsent >= TELNET_TX_SEGMENT_SIZE) {
+		return true;
+	}
+	return ((GetLocalTime() - server->unsentSince) >= flushLatency);
+}
+
+/**
+ * @internal
+ * Accounts for data ACKed by the client. ACKs arrive in the order the data was sent, so those which follow all of
+ * the ring data sent before the oldest priority write are for that write, the rest are for the ring.
+ *
+ * @param server TelnetServer_t* Pointer to the server the ACK is for.
+ * @param len u16_t The number of bytes which were ACKed.
+ * @retval none
+ */
+static void TelnetReleaseAcked(TelnetServer_t* server, u16_t len) {
+	while (len > 0U) {
+		TelnetPrioritySpan_t* span = &server->prioritySpans[0];
+		if ((server->prioritySpanCount > 0U) && (span->after == server->ringAcked)) {
+			const u16_t count = (len < span->length) ? len : span->length;
+			span->length -= count;
+			len -= count;
+			if (span->length == 0U) {
+				--server->prioritySpanCount;
+				memmove(&server->prioritySpans[0], &server->prioritySpans[1],
+						server->prioritySpanCount * sizeof(TelnetPrioritySpan_t));
+			}
+			continue;
+		}
+		u16_t count = len;
+		if ((server->prioritySpanCount > 0U) && ((span->after - server->ringAcked) < count)) {
+			count = (u16_t) (span->after - server->ringAcked);
+		}
+		TelnetReleaseRing(server, count);
+		server->ringAcked += count;
+		len -= count;
 	}
-	IsConnected = false;
 }
 
 /**
  * @internal
- * Creates and initializes a Telnet server.
+ * Releases ACKed data of the transmit ring, handing each segment back to the ring once all of it has been ACKed.
+ * ACKs arrive in order, so they always apply to the oldest segment first.
  *
- * @param none
- * @retval TelnetServer_t* The structure used to represent the current server.
+ * @param server TelnetServer_t* Pointer to the server the ACK is for.
+ * @param len u16_t The number of ring bytes which were ACKed.
+ * @retval none
  */
-static TelnetServer_t* CreateTelnetServer(void) {
-#ifdef TELNET_DEBUG
-	printf("[Telnet Server] Allocating memory for server.\n\r");
-#endif
-	/* Allocate structure server to maintain Telnet connection information */
-	IsConnected = false;
-	telnet_server.halt = false;
-	telnet_server.recvWrite = 0;
-	telnet_server.recvRead = 0;
-	telnet_server.previous = 0;
-	telnet_server.length = 0;
-	for (int i = 0; i < TELNET_BUFFER_LENGTH; ++i) {
-		telnet_server.recvBuffer[i] = 0;
+static void TelnetReleaseRing(TelnetServer_t* server, u16_t len) {
+	while (len > 0U) {
+		TelnetTxSegment_t* segment = &server->segments[server->txTail];
+		uint16_t unacked = segment->queued - segment->acked;
+		uint16_t count = (len < unacked) ? len : unacked;
+		segment->acked += count;
+		len -= count;
+		if (segment->acked != segment->length) {
+			break;
+		}
+		/* The whole segment has been delivered, so lwIP no longer references it */
+		segment->length = 0U;
+		segment->queued = 0U;
+		segment->acked = 0U;
+		segment->boundary = 0U;
+		if (server->txTail == server->txHead) {
+			break;
+		}
+		server->txTail = (server->txTail + 1U) % TELNET_TX_SEGMENT_COUNT;
+		--server->txUsed;
 	}
-	return &telnet_server;
 }
 
 /**
  * @internal
- * Clears the internal message string buffer.
+ * Discards the data of the transmit ring which has not yet been handed to lwIP, keeping only what lwIP references.
+ * If lwIP is part way through a record the rest of it is sent first, so the client never sees a partial record;
+ * should lwIP have no room for it, the ring is left as it is.
  *
- * @param none
+ * @param server TelnetServer_t* Pointer to the session whose ring should be discarded.
  * @retval none
  */
-static void ClearToMessageBuffer(void) {
-	for (uint_fast8_t i = 0; i < SIZE_TOSTRING_BUFFER; ++i) {
-		MESSAGE_BUFFER[i] = '\0';
+static void TelnetDiscardRing(TelnetServer_t* server) {
+	if ((server->txAtRecord == false) && (TelnetTransmitRing(server, true) == true)) {
+		tcp_output(server->pcb);
+	}
+	if (server->txAtRecord == false) {
+		return;
+	}
+	uint8_t index = server->txTail;
+	uint8_t head = server->txTail;
+	uint8_t used = 1U;
+	for (uint_fast8_t i = 0; i < server->txUsed; ++i) {
+		TelnetTxSegment_t* segment = &server->segments[index];
+		if ((i == 0U) || (segment->queued > 0U)) {
+			/* The ring now ends with the last segment lwIP has any of */
+			head = index;
+			used = i + 1U;
+		}
+		segment->length = segment->queued;
+		segment->boundary = segment->queued;
+		index = (index + 1U) % TELNET_TX_SEGMENT_COUNT;
 	}
+	server->txHead = head;
+	server->txUsed = used;
+	server->unsent = 0U;
+}
+
+/**
+ * @internal
+ * Writes a telnet option response into the transmit ring of the current session. Responses may use the space kept free by
+ * TELNET_BUFFER_RESERVE.
+ *
+ * @param command char The telnet command to respond with.
+ * @param option char The option the response is for.
+ * @retval none
+ */
+static void TelnetSendOption(char command, char option) {
+	char response[3] = { TELNET_IAC, command, option };
+	TelnetRingWrite(telnet_server, response, sizeof(response), 0U);
 }
 
 /**
@@ -407,41 +1149,150 @@ TelnetStatus_t InitializeTelnetServer(void) {
 }
 
 /**
- * This function is called when the the TCP connection should be closed.
+ * This function is called when the the TCP connection of the current session should be closed.
  *
  * @param none
  * @retval none
  */
 void TelnetClose(void) {
-	printf("Closing telnet connection.\n\r");
-	struct tcp_pcb *pcb = telnet_server.pcb;
+	TelnetCloseSession(telnet_server);
+}
 
-	/* Remove all callbacks */
-	tcp_arg(pcb, NULL );
-	tcp_sent(pcb, NULL );
-	tcp_recv(pcb, NULL );
-	tcp_err(pcb, NULL );
-	tcp_poll(pcb, NULL, 0);
+/**
+ * Returns the connection status of the Telnet server, allowing other parts of the program to adjust their behavior
+ * depending on if any client is connected.
+ *
+ * @param none
+ * @retval bool TRUE if the telnet server has at least one active connection.
+ */
+bool TelnetIsConnected(void) {
+	for (uint_fast8_t i = 0; i < TELNET_MAX_SESSIONS; ++i) {
+		if (isSessionConnected(&telnet_sessions[i]) == true) {
+			return true;
+		}
+	}
+	return false;
+}
 
-	/* Clear the telnet data structure pointer, to indicate that there is no longer a connection. */
-	telnet_server.pcb = 0;
+/**
+ * Returns the connection status of the current session.
+ *
+ * @param none
+ * @retval bool TRUE if the current session has an active connection.
+ */
+bool TelnetIsSessionConnected(void) {
+	return isSessionConnected(telnet_server);
+}
 
-	/* Close tcp connection */
-	tcp_close(pcb);
-	IsConnected = FALSE;
+/**
+ * Determines if an incoming connection request can be honored.
+ *
+ * @param none
+ * @retval bool TRUE if at least one session is free.
+ */
+bool TelnetHasFreeSession(void) {
+	for (uint_fast8_t i = 0; i < TELNET_MAX_SESSIONS; ++i) {
+		if (isSessionConnected(&telnet_sessions[i]) == false) {
+			return true;
+		}
+	}
+	return false;
 }
 
 /**
- * Returns the connection status of the Telnet server. Since this implementation supports only
- * one client at a time, this method can be used to determine if an incoming request can be honored
- * as well as allowing other parts of the program to adjust their behavior depending on if a client
- * is connected.
+ * Retrieves the number of connected sessions.
  *
  * @param none
- * @retval bool TRUE if the telnet server has an active connection.
+ * @retval uint8_t The number of sessions with an active connection.
  */
-bool TelnetIsConnected(void) {
-	return (IsConnected);
+uint8_t TelnetGetSessionCount(void) {
+	uint8_t count = 0U;
+	for (uint_fast8_t i = 0; i < TELNET_MAX_SESSIONS; ++i) {
+		if (isSessionConnected(&telnet_sessions[i]) == true) {
+			++count;
+		}
+	}
+	return count;
+}
+
+/**
+ * Discards the data of every session which has not yet been handed to lwIP, such as sample data a halt has made
+ * stale. Status and error messages waiting in the priority buffers are still sent.
+ *
+ * @param none
+ * @retval none
+ */
+void TelnetDiscardPending(void) {
+	for (uint_fast8_t i = 0; i < TELNET_MAX_SESSIONS; ++i) {
+		TelnetServer_t* server = &telnet_sessions[i];
+		if (isSessionConnected(server) == true) {
+			TelnetDiscardRing(server);
+		}
+	}
+}
+
+/**
+ * Retrieves the lowest free transmit buffer space of the connected sessions, which bounds the data that can be
+ * published to all of them.
+ *
+ * @param none
+ * @retval uint16_t The lowest free space, TELNET_TX_RING_SIZE if no session is connected.
+ */
+uint16_t TelnetGetLowestFreeSpace(void) {
+	uint16_t lowest = TELNET_TX_RING_SIZE;
+	for (uint_fast8_t i = 0; i < TELNET_MAX_SESSIONS; ++i) {
+		if (isSessionConnected(&telnet_sessions[i]) == true) {
+			const uint16_t free = TelnetRingFree(&telnet_sessions[i], 0U);
+			if (free < lowest) {
+				lowest = free;
+			}
+		}
+	}
+	return lowest;
+}
+
+/**
+ * Makes the next connected session with unread data the current session, taking the sessions in turn so that no
+ * client can starve the others. The current session is kept if no other session has unread data.
+ *
+ * @param none
+ * @retval none
+ */
+void TelnetSelectNextSession(void) {
+	uint_fast8_t index = telnet_server - telnet_sessions;
+	for (uint_fast8_t i = 0; i < TELNET_MAX_SESSIONS; ++i) {
+		index = (index + 1U) % TELNET_MAX_SESSIONS;
+		TelnetServer_t* server = &telnet_sessions[index];
+		if ((isSessionConnected(server) == true) && (server->recvRead != server->recvWrite)) {
+			telnet_server = server;
+			return;
+		}
+	}
+}
+
+/**
+ * Sets whether the current session receives published sample data.
+ *
+ * @param subscribed bool TRUE to receive sample data.
+ * @retval none
+ */
+void TelnetSetSubscribed(bool subscribed) {
+	telnet_server->subscribed = subscribed;
+}
+
+/**
+ * Determines if any connected session receives published sample data.
+ *
+ * @param none
+ * @retval bool TRUE if at least one connected session is subscribed.
+ */
+bool TelnetHasSubscribers(void) {
+	for (uint_fast8_t i = 0; i < TELNET_MAX_SESSIONS; ++i) {
+		if ((isSessionConnected(&telnet_sessions[i]) == true) && (telnet_sessions[i].subscribed == true)) {
+			return true;
+		}
+	}
+	return false;
 }
 
 /**
@@ -452,25 +1303,21 @@ bool TelnetIsConnected(void) {
  * @retval err_t The error/status code.
  */
 err_t TelnetPoll(void *arg, struct tcp_pcb *tpcb) {
+	PROFILE_BEGIN();
 	err_t ret_err;
 	TelnetServer_t* server;
 	server = (TelnetServer_t*) arg;
 
 	if (server != NULL ) {
-		unsigned long length = server->length;
-		if ((server->pcb != NULL )&& (length != 0)){
-			/* Write the data from the transmit buffer. */
-			tcp_write(server->pcb, server->buffer, length, 1);
-
-			/* Increment the count of outstanding bytes. */
-			server->outstanding += length;
-
-			/* Output the telnet data. */
-			tcp_output(server->pcb);
-
-			/* Reset the size of the data in the transmit buffer. */
-			server->length = 0;
+		if ((server->pcb != NULL) && (LwIP_IsPeerStalled(server->pcb, &server->ackedAt) == true)) {
+			/* The client stopped ACKing without closing, free the session for a new one */
+			printf("[Telnet Server] Aborting a session whose client stopped responding.\n\r");
+			TelnetAbortSession(server);
+			PROFILE_END(PROFILE_TELNET_POLL);
+			return ERR_ABRT;
 		}
+		/* Send anything still waiting in the transmit ring. */
+		TelnetTransmit(server);
 		/* See if the telnet connection should be closed; this will only occur once
 		 all transmitted data has been ACKed by the client (so that some or all
 		 of the final message is not lost). */
@@ -478,7 +1325,7 @@ err_t TelnetPoll(void *arg, struct tcp_pcb *tpcb) {
 #ifdef TELNET_DEBUG
 			printf("[Telnet Server] Telnet server should be closed.\n\r");
 #endif
-			TelnetClose();
+			TelnetCloseSession(server);
 		}
 		ret_err = ERR_OK;
 	} else {
@@ -489,50 +1336,112 @@ err_t TelnetPoll(void *arg, struct tcp_pcb *tpcb) {
 		tcp_abort(tpcb);
 		ret_err = ERR_ABRT;
 	}
+	PROFILE_END(PROFILE_TELNET_POLL);
 	return ret_err;
 }
 
 /**
- * Writes a character into the telnet receive buffer.
+ * Called from the main loop to send the data waiting in the transmit ring as soon as the flush policy allows,
+ * rather than waiting for the lwIP poll timer.
  *
- * @param character char The character to write.
+ * @param none
  * @retval none
  */
-void TelnetRecvBufferWrite(char character) {
-	unsigned long ulWrite;
-	/* Ignore this character if it is the NULL character. */
-	if (character == 0) {
-#ifdef TELNET_CHAR_DEBUG
-		printf("[Telnet Server] Ignorning NULL character.\n\r");
-#endif
-		return;
+void TelnetService(void) {
+	for (uint_fast8_t i = 0; i < TELNET_MAX_SESSIONS; ++i) {
+		TelnetServer_t* server = &telnet_sessions[i];
+		if ((isSessionConnected(server) == true) && (isTelnetFlushDue(server) == true)) {
+			TelnetTransmit(server);
+		}
 	}
+}
 
-	/* Ignore this character if it is the second part of a CR/LF or LF/CR sequence. */
-	if (((character == '\r') && (telnet_server.previous == '\n'))
-			|| ((character == '\n') && (telnet_server.previous == '\r'))) {
-		return;
+/**
+ * Sets the time data may wait in the transmit ring for a full segment to accumulate before it is sent. A latency
+ * of 0 sends data on the next service call after it is written.
+ *
+ * @param latency uint32_t The flush latency in microseconds.
+ * @retval none
+ */
+void TelnetSetFlushLatency(uint32_t latency) {
+	flushLatency = latency;
+}
+
+/**
+ * Sets whether the connection sends small writes without waiting for outstanding data to be ACKed, with Nagle's
+ * algorithm disabled, and ACKs received commands at once. The setting applies to the connected sessions and to those
+ * accepted later.
+ *
+ * @param enable bool TRUE to send and ACK without delay, FALSE to coalesce with Nagle's algorithm.
+ * @retval none
+ */
+void TelnetSetNoDelay(bool enable) {
+	noDelay = enable;
+	for (uint_fast8_t i = 0; i < TELNET_MAX_SESSIONS; ++i) {
+		TelnetServer_t* server = &telnet_sessions[i];
+		if (isSessionConnected(server) == true) {
+			if (enable == true) {
+				tcp_nagle_disable(server->pcb);
+			} else {
+				tcp_nagle_enable(server->pcb);
+			}
+		}
 	}
+}
+
+/**
+ * Writes a character into the telnet receive buffer.
+ *
+ * @param character char The character to write.
+ * @retval none
+ */
+void TelnetRecvBufferWrite(char character) {
+	TelnetRecvBufferWriteBytes(&character, 1U);
+}
 
-	/* Store this character into the receive buffer if there is space for it. */
-	ulWrite = telnet_server.recvWrite;
-	if (((ulWrite + 1) % sizeof(telnet_server.recvBuffer)) != telnet_server.recvRead) {
-		telnet_server.recvBuffer[ulWrite] = character;
-		telnet_server.recvWrite = (ulWrite + 1) % sizeof(telnet_server.recvBuffer);
+/**
+ * Writes a block of received characters into the telnet receive buffer. NULL characters and the second part of a
+ * CR/LF or LF/CR sequence are dropped, as are any characters which do not fit.
+ *
+ * @param data const char* Pointer to the characters to write.
+ * @param length uint16_t The number of characters to write.
+ * @retval uint16_t The number of characters stored in the receive buffer.
+ */
+uint16_t TelnetRecvBufferWriteBytes(const char* data, uint16_t length) {
+	/* The ring positions are kept in locals for the length of the block rather than updated character by character. */
+	uint32_t write = telnet_server->recvWrite;
+	const uint32_t start = write;
+	const uint32_t read = telnet_server->recvRead;
+	unsigned char previous = telnet_server->previous;
+	char character;
+	for (uint16_t i = 0U; i < length; ++i) {
+		character = data[i];
+		/* Ignore this character if it is the NULL character. */
+		if (character == 0) {
 #ifdef TELNET_CHAR_DEBUG
-		for (int i = 0; i <= telnet_server.recvWrite; ++i) {
-			printf("%c", telnet_server.recvBuffer[i]);
+			printf("[Telnet Server] Ignorning NULL character.\n\r");
+#endif
+			continue;
 		}
-		printf("\n\r");
-#endif 
-	} else {
+		/* Ignore this character if it is the second part of a CR/LF or LF/CR sequence. */
+		if (((character == '\r') && (previous == '\n')) || ((character == '\n') && (previous == '\r'))) {
+			continue;
+		}
+		/* Store this character into the receive buffer if there is space for it. */
+		if ((write - read) < TELNET_BUFFER_LENGTH) {
+			telnet_server->recvBuffer[write & TELNET_BUFFER_MASK] = character;
+			++write;
+		} else {
 #ifdef TELNET_DEBUG
-		printf("[Telnet Server] Could not store new character because buffer was full.\n\r");
+			printf("[Telnet Server] Could not store new character because buffer was full.\n\r");
 #endif
+		}
+		/* Save this character as the previously received telnet character. */
+		previous = character;
 	}
-
-	/* Save this character as the previously received telnet character. */
-	telnet_server.previous = character;
+	telnet_server->recvWrite = write;
+	telnet_server->previous = previous;
+	return (uint16_t) (write - start);
 }
 
 /**
@@ -545,17 +1454,90 @@ char TelnetRead(void) {
 	uint32_t read;
 	char ret;
 	/* Return a NULL if there is no data in the receive buffer. */
-	read = telnet_server.recvRead;
-	if (read == telnet_server.recvWrite) {
+	read = telnet_server->recvRead;
+	if (read == telnet_server->recvWrite) {
 		return (0);
 	}
 	/* Read the next byte from the receive buffer. */
-	ret = telnet_server.recvBuffer[read];
-	telnet_server.recvRead = (read + 1) % sizeof(telnet_server.recvBuffer);
+	ret = telnet_server->recvBuffer[read & TELNET_BUFFER_MASK];
+	TelnetRecvRelease(1U);
 	/* Return the byte that was read. */
 	return (ret);
 }
 
+/**
+ * Retrieves the received data which is contiguous in the receive buffer, without consuming it. Together with
+ * TelnetConsume() this lets a reader process whole spans of received data in place rather than a byte at a time.
+ *
+ * @param data const char** Pointer to the location to store a pointer to the first unread byte.
+ * @retval uint16_t The number of unread bytes available contiguously from that pointer.
+ */
+uint16_t TelnetPeek(const char** data) {
+	const uint32_t index = telnet_server->recvRead & TELNET_BUFFER_MASK;
+	const uint32_t unread = telnet_server->recvWrite - telnet_server->recvRead;
+	*data = (const char*) &telnet_server->recvBuffer[index];
+	if (unread <= (TELNET_BUFFER_LENGTH - index)) {
+		return (uint16_t) unread;
+	} else {
+		/* The unread data wraps, only the part up to the end of the buffer is contiguous */
+		return (uint16_t) (TELNET_BUFFER_LENGTH - index);
+	}
+}
+
+/**
+ * Consumes received data previously retrieved with TelnetPeek().
+ *
+ * @param length uint16_t The number of bytes to consume.
+ * @retval none
+ */
+void TelnetConsume(uint16_t length) {
+	TelnetRecvRelease(length);
+}
+
+/**
+ * Reads a byte from the telnet interface. Unlike TelnetRead(), a NULL byte can be told apart from an empty receive
+ * buffer, which binary command frames need.
+ *
+ * @param character char* Pointer to the location to store the byte read.
+ * @retval bool TRUE if a byte was read, FALSE if the receive buffer was empty.
+ */
+bool TelnetReadByte(char* character) {
+	uint32_t read = telnet_server->recvRead;
+	if (read == telnet_server->recvWrite) {
+		return FALSE;
+	}
+	*character = telnet_server->recvBuffer[read & TELNET_BUFFER_MASK];
+	TelnetRecvRelease(1U);
+	return TRUE;
+}
+
+/**
+ * Reads as many bytes as are available, up to the provided length, from the telnet interface. The unread data is
+ * copied out in at most two blocks, either side of the end of the receive ring.
+ *
+ * @param data char* Pointer to the location to store the bytes read.
+ * @param length uint16_t The most bytes to read.
+ * @retval uint16_t The number of bytes read.
+ */
+uint16_t TelnetReadBytes(char* data, uint16_t length) {
+	const char* span;
+	uint16_t count;
+	uint16_t total = 0U;
+	while (total < length) {
+		count = TelnetPeek(&span);
+		if (count == 0U) {
+			break;
+		}
+		if (count > (length - total)) {
+			count = length - total;
+		}
+		memcpy(&data[total], span, count);
+		TelnetConsume(count);
+		total += count;
+	}
+	return total;
+}
+
 /**
  * Writes a character to the telnet interface.
  *
@@ -563,33 +1545,168 @@ char TelnetRead(void) {
  * @retval none
  */
 void TelnetWrite(const char character) {
-	/* Delay until there is some space in the output buffer.  The buffer is not
+	/* Drop the character if there is no space in the output buffer.  The buffer is not
 	 completly filled here to leave some room for the processing of received
 	 telnet commands. */
-	while (telnet_server.length > (sizeof(telnet_server.buffer) - 32)) {
+	if (TelnetWriteBytes(&character, 1U) == 0U) {
 #ifdef TELNET_DEBUG
 		printf("[Telnet Server] Telnet buffer is full!\n\r");
 #endif
+		++telnet_server->dropped;
 	}
-
-	/* Write this character into the output buffer.  Disable Ethernet
-	 interrupts during this process in order to prevent an intervening
-	 interrupt from corrupting the output buffer. */
-	//TODO: Disable Ethernet interrupts and reenable. Note: This may not be necessary.
-	telnet_server.buffer[telnet_server.length++] = character;
 }
 
 /**
- * Writes a string to the specified Telnet server.
+ * Writes a string to the specified Telnet server. The string is either accepted in full or not at all.
  *
  * @param string char* Pointer to a C-String to write to the interface.
+ * @retval WriteStatus_t The result of the write.
+ */
+WriteStatus_t TelnetWriteString(char* string) {
+	return TelnetQueue(string, strlen(string));
+}
+
+/**
+ * Copies as much of the provided data as will fit into the transmit buffer, without waiting for any space to
+ * become available. The caller is responsible for retrying or discarding the remainder.
+ *
+ * @param data const char* Pointer to the data to write to the interface.
+ * @param length uint16_t The number of bytes to write.
+ * @retval uint16_t The number of bytes accepted into the transmit buffer.
+ */
+uint16_t TelnetWriteBytes(const char* data, uint16_t length) {
+	return TelnetRingWrite(telnet_server, data, length, TELNET_BUFFER_RESERVE);
+}
+
+/**
+ * Writes a block of binary data to the specified Telnet server. Unlike TelnetWriteString(), the data may
+ * contain NULL characters. The block is either accepted in full or not at all.
+ *
+ * @param data const uint8_t* Pointer to the data to write to the interface.
+ * @param length uint16_t The number of bytes to write.
+ * @retval WriteStatus_t The result of the write.
+ */
+WriteStatus_t TelnetWriteBinary(const uint8_t* data, uint16_t length) {
+	return TelnetQueue((const char*) data, length);
+}
+
+/**
+ * Publishes a string of sample data to every subscribed session. The string is either accepted by all of them or by
+ * none, so a subscriber which has fallen behind holds the data back for every other.
+ *
+ * @param string char* Pointer to a C-String to publish.
+ * @retval WriteStatus_t The result of the write.
+ */
+WriteStatus_t TelnetPublishString(char* string) {
+	return TelnetPublish(string, strlen(string));
+}
+
+/**
+ * Publishes a block of binary sample data to every subscribed session. As with TelnetPublishString(), the block is
+ * either accepted by all of them or by none.
+ *
+ * @param data const uint8_t* Pointer to the data to publish.
+ * @param length uint16_t The number of bytes to publish.
+ * @retval WriteStatus_t The result of the write.
+ */
+WriteStatus_t TelnetPublishBinary(const uint8_t* data, uint16_t length) {
+	return TelnetPublish((const char*) data, length);
+}
+
+/**
+ * Retrieves the number of bytes which can currently be written to the telnet interface without being refused.
+ *
+ * @param none
+ * @retval uint16_t The free space in the transmit buffer.
+ */
+uint16_t TelnetGetFreeSpace(void) {
+	return TelnetRingFree(telnet_server, TELNET_BUFFER_RESERVE);
+}
+
+/**
+ * Retrieves the number of bytes held in the transmit ring of the current session, whether waiting to be sent or
+ * waiting for the client's ACK.
+ *
+ * @param none
+ * @retval uint16_t The bytes held in the transmit buffer.
+ */
+uint16_t TelnetGetBufferUsed(void) {
+	return TELNET_TX_RING_SIZE - TelnetRingFree(telnet_server, 0U);
+}
+
+/**
+ * Retrieves the most bytes the transmit ring of the current session has held since its client connected. A peak
+ * near the size of the ring means writes are being refused while the client catches up.
+ *
+ * @param none
+ * @retval uint16_t The peak number of bytes held in the transmit buffer.
+ */
+uint16_t TelnetGetBufferPeak(void) {
+	return telnet_server->txPeak;
+}
+
+/**
+ * Retrieves the number of bytes sent over all Telnet sessions since start up. The count wraps, so the rate is found
+ * from the difference of two counts.
+ *
+ * @param none
+ * @retval uint32_t The number of bytes handed to lwIP.
+ */
+uint32_t TelnetGetBytesSent(void) {
+	return bytesSent;
+}
+
+/**
+ * Retrieves the number of messages and characters discarded on the current connection because the transmit
+ * buffer was full.
+ *
+ * @param none
+ * @retval unsigned long The number of discarded writes.
+ */
+unsigned long TelnetGetDroppedCount(void) {
+	return telnet_server->dropped;
+}
+
+/**
+ * Sets the format sample data is sent in. Sample data is encoded once for every subscriber, so the format applies to
+ * all sessions. The format is reset to DATA_FORMAT_TEXT when a client connects while no other is connected.
+ *
+ * @param format DataFormat_t The format to use.
  * @retval none
  */
-void TelnetWriteString(char* string) {
-	while (*string) {
-		TelnetWrite(*string);
-		++string;
-	}
+void TelnetSetDataFormat(DataFormat_t format) {
+	dataFormat = format;
+}
+
+/**
+ * Retrieves the format sample data is sent in.
+ *
+ * @param none
+ * @retval DataFormat_t The format in use.
+ */
+DataFormat_t TelnetGetDataFormat(void) {
+	return dataFormat;
+}
+
+/**
+ * Sets the fields each sample is sent with, as DATA_FIELD_ bits. Like the format they apply to all sessions, and are
+ * reset to DATA_FIELDS_DEFAULT when a client connects while no other is connected.
+ *
+ * @param fields uint8_t The DATA_FIELD_ bits of the fields to send.
+ * @retval none
+ */
+void TelnetSetDataFields(uint8_t fields) {
+	dataFields = fields;
+}
+
+/**
+ * Retrieves the fields each sample is sent with.
+ *
+ * @param none
+ * @retval uint8_t The DATA_FIELD_ bits of the fields sent.
+ */
+uint8_t TelnetGetDataFields(void) {
+	return dataFields;
 }
 
 /**
@@ -609,17 +1726,15 @@ void TelnetProcessWill(char option) {
 	printf("[Telnet Server] Processing WILL command with option: %c/0x%02X\n\r", option, option);
 #endif
 	/* Loop through the known options. */
-	for (ulIdx = 0; ulIdx < (sizeof(TelnetOptions) / sizeof(TelnetOptions[0])); ulIdx++) {
+	for (ulIdx = 0; ulIdx < TELNET_OPTION_COUNT; ulIdx++) {
 		/* See if this option matches the option in question. */
-		if (TelnetOptions[ulIdx].option == option) {
+		if (telnet_server->options[ulIdx].option == option) {
 			/* See if the WILL flag for this option has already been set. */
-			if (((TelnetOptions[ulIdx].flags >> OPT_FLAG_WILL )& 0x01)==0){
+			if (((telnet_server->options[ulIdx].flags >> OPT_FLAG_WILL )& 0x01)==0){
 				/* Set the WILL flag for this option. */
-				TelnetOptions[ulIdx].flags = (TelnetOptions[ulIdx].flags & 0xFD) | (0x01 << OPT_FLAG_WILL );
+				telnet_server->options[ulIdx].flags = (telnet_server->options[ulIdx].flags & 0xFD) | (0x01 << OPT_FLAG_WILL );
 				/* Send a DO response to this option. */
-				telnet_server.buffer[telnet_server.length++] = TELNET_IAC;
-				telnet_server.buffer[telnet_server.length++] = TELNET_DO;
-				telnet_server.buffer[telnet_server.length++] = option;
+				TelnetSendOption(TELNET_DO, option);
 			}
 			/* Return without any further processing. */
 			return;
@@ -627,9 +1742,7 @@ void TelnetProcessWill(char option) {
 	}
 
 	/* This option is not recognized, so send a DONT response. */
-	telnet_server.buffer[telnet_server.length++] = TELNET_IAC;
-	telnet_server.buffer[telnet_server.length++] = TELNET_DONT;
-	telnet_server.buffer[telnet_server.length++] = option;
+	TelnetSendOption(TELNET_DONT, option);
 }
 
 /**
@@ -650,17 +1763,15 @@ void TelnetProcessWont(char option) {
 	printf("[Telnet Server] Processing WONT command with option: %c/0x%02X\n\r", option, option);
 #endif
 	/* Loop through the known options. */
-	for (ulIdx = 0; ulIdx < (sizeof(TelnetOptions) / sizeof(TelnetOptions[0])); ulIdx++) {
+	for (ulIdx = 0; ulIdx < TELNET_OPTION_COUNT; ulIdx++) {
 		/* See if this option matches the option in question. */
-		if (TelnetOptions[ulIdx].option == option) {
+		if (telnet_server->options[ulIdx].option == option) {
 			/* See if the WILL flag for this option is currently set. */
-			if (((TelnetOptions[ulIdx].flags >> OPT_FLAG_WILL )& 0x01)==1){
+			if (((telnet_server->options[ulIdx].flags >> OPT_FLAG_WILL )& 0x01)==1){
 				/* Clear the WILL flag for this option. */
-				TelnetOptions[ulIdx].flags = (TelnetOptions[ulIdx].flags & 0xFD) | 0x00;
+				telnet_server->options[ulIdx].flags = (telnet_server->options[ulIdx].flags & 0xFD) | 0x00;
 				/* Send a DONT response to this option. */
-				telnet_server.buffer[telnet_server.length++] = TELNET_IAC;
-				telnet_server.buffer[telnet_server.length++] = TELNET_DONT;
-				telnet_server.buffer[telnet_server.length++] = option;
+				TelnetSendOption(TELNET_DONT, option);
 			}
 			/* Return without any further processing. */
 			return;
@@ -668,9 +1779,7 @@ void TelnetProcessWont(char option) {
 	}
 
 	/* This option is not recognized, so send a DONT response. */
-	telnet_server.buffer[telnet_server.length++] = TELNET_IAC;
-	telnet_server.buffer[telnet_server.length++] = TELNET_DONT;
-	telnet_server.buffer[telnet_server.length++] = option;
+	TelnetSendOption(TELNET_DONT, option);
 }
 
 /**
@@ -690,17 +1799,15 @@ void TelnetProcessDo(char option) {
 	printf("[Telnet Server] Processing DO command with option: %c/0x%02X\n\r", option, option);
 #endif
 	/* Loop through the known options. */
-	for (ulIdx = 0; ulIdx < (sizeof(TelnetOptions) / sizeof(TelnetOptions[0])); ulIdx++) {
+	for (ulIdx = 0; ulIdx < TELNET_OPTION_COUNT; ulIdx++) {
 		/* See if this option matches the option in question. */
-		if (TelnetOptions[ulIdx].option == option) {
+		if (telnet_server->options[ulIdx].option == option) {
 			/* See if the DO flag for this option has already been set. */
-			if (((TelnetOptions[ulIdx].flags >> OPT_FLAG_DO )& 0x01)==0){
+			if (((telnet_server->options[ulIdx].flags >> OPT_FLAG_DO )& 0x01)==0){
 				/* Set the DO flag for this option. */
-				TelnetOptions[ulIdx].flags = (TelnetOptions[ulIdx].flags & 0xFB) | (0x01 << OPT_FLAG_DO );
+				telnet_server->options[ulIdx].flags = (telnet_server->options[ulIdx].flags & 0xFB) | (0x01 << OPT_FLAG_DO );
 				/* Send a WILL response to this option. */
-				telnet_server.buffer[telnet_server.length++] = TELNET_IAC;
-				telnet_server.buffer[telnet_server.length++] = TELNET_WILL;
-				telnet_server.buffer[telnet_server.length++] = option;
+				TelnetSendOption(TELNET_WILL, option);
 			}
 			/* Return without any further processing. */
 			return;
@@ -708,9 +1815,7 @@ void TelnetProcessDo(char option) {
 	}
 
 	// This option is not recognized, so send a WONT response.
-	telnet_server.buffer[telnet_server.length++] = TELNET_IAC;
-	telnet_server.buffer[telnet_server.length++] = TELNET_WONT;
-	telnet_server.buffer[telnet_server.length++] = option;
+	TelnetSendOption(TELNET_WONT, option);
 }
 
 /**
@@ -730,17 +1835,15 @@ void TelnetProcessDont(char option) {
 	printf("[Telnet Server] Processing DONT command with option: %c/0x%02X\n\r", option, option);
 #endif
 	/* Loop through the known options. */
-	for (ulIdx = 0; ulIdx < (sizeof(TelnetOptions) / sizeof(TelnetOptions[0])); ulIdx++) {
+	for (ulIdx = 0; ulIdx < TELNET_OPTION_COUNT; ulIdx++) {
 		/* See if this option matches the option in question. */
-		if (TelnetOptions[ulIdx].option == option) {
+		if (telnet_server->options[ulIdx].option == option) {
 			/* See if the DO flag for this option is currently set. */
-			if (((TelnetOptions[ulIdx].flags >> OPT_FLAG_DO )& 0x01)==1){
+			if (((telnet_server->options[ulIdx].flags >> OPT_FLAG_DO )& 0x01)==1){
 				/* Clear the DO flag for this option. */
-				TelnetOptions[ulIdx].flags = (TelnetOptions[ulIdx].flags & 0xFB) | 0x00;
+				telnet_server->options[ulIdx].flags = (telnet_server->options[ulIdx].flags & 0xFB) | 0x00;
 				/* Send a WONT response to this option. */
-				telnet_server.buffer[telnet_server.length++] = TELNET_IAC;
-				telnet_server.buffer[telnet_server.length++] = TELNET_WONT;
-				telnet_server.buffer[telnet_server.length++] = option;
+				TelnetSendOption(TELNET_WONT, option);
 			}
 			/* Return without any further processing. */
 			return;
@@ -748,9 +1851,7 @@ void TelnetProcessDont(char option) {
 	}
 
 	/* This option is not recognized, so send a WONT response. */
-	telnet_server.buffer[telnet_server.length++] = TELNET_IAC;
-	telnet_server.buffer[telnet_server.length++] = TELNET_WONT;
-	telnet_server.buffer[telnet_server.length++] = option;
+	TelnetSendOption(TELNET_WONT, option);
 }
 
 /*
@@ -766,14 +1867,14 @@ void TelnetProcessCharacter(char character) {
 	printf("[Telnet Server] Processing Character: %c/0x%02X\n\r", character, character);
 #endif
 	/* Determine the current state of the telnet command parser. */
-	switch (telnet_server.state) {
+	switch (telnet_server->state) {
 	/* The normal state of the parser, were each character is either sent
 	 to the UART or is a telnet IAC character. */
 	case STATE_NORMAL: {
 		/* See if this character is the IAC character. */
 		if (character == TELNET_IAC ) {
 			/* Skip this character and go to the IAC state. */
-			telnet_server.state = STATE_IAC;
+			telnet_server->state = STATE_IAC;
 		} else {
 			/* Write this character to the receive buffer. */
 			TelnetRecvBufferWrite(character);
@@ -791,7 +1892,7 @@ void TelnetProcessCharacter(char character) {
 			/* Write 0xff to the receive buffer. */
 			TelnetRecvBufferWrite(0xff);
 			/* Switch back to normal mode. */
-			telnet_server.state = STATE_NORMAL;
+			telnet_server->state = STATE_NORMAL;
 			/* This character has been handled. */
 			break;
 		}
@@ -799,7 +1900,7 @@ void TelnetProcessCharacter(char character) {
 		case TELNET_WILL : {
 			/* Switch to the WILL mode; the next character will have
 			 the option in question. */
-			telnet_server.state = STATE_WILL;
+			telnet_server->state = STATE_WILL;
 			/* This character has been handled. */
 			break;
 		}
@@ -807,7 +1908,7 @@ void TelnetProcessCharacter(char character) {
 		case TELNET_WONT : {
 			/* Switch to the WONT mode; the next character will have
 			 the option in question. */
-			telnet_server.state = STATE_WONT;
+			telnet_server->state = STATE_WONT;
 			/* This character has been handled. */
 			break;
 		}
@@ -815,7 +1916,7 @@ void TelnetProcessCharacter(char character) {
 		case TELNET_DO : {
 			/* Switch to the DO mode; the next character will have the
 			 option in question. */
-			telnet_server.state = STATE_DO;
+			telnet_server->state = STATE_DO;
 			/* This character has been handled. */
 			break;
 		}
@@ -823,7 +1924,7 @@ void TelnetProcessCharacter(char character) {
 		case TELNET_DONT : {
 			/* Switch to the DONT mode; the next character will have
 			 the option in question. */
-			telnet_server.state = STATE_DONT;
+			telnet_server->state = STATE_DONT;
 			/* This character has been handled. */
 			break;
 		}
@@ -831,17 +1932,9 @@ void TelnetProcessCharacter(char character) {
 		case TELNET_AYT : {
 			/* Send a short string back to the client so that it knows
 			 that the server is still alive. */
-			telnet_server.buffer[telnet_server.length++] = '\r';
-			telnet_server.buffer[telnet_server.length++] = '\n';
-			telnet_server.buffer[telnet_server.length++] = '[';
-			telnet_server.buffer[telnet_server.length++] = 'Y';
-			telnet_server.buffer[telnet_server.length++] = 'e';
-			telnet_server.buffer[telnet_server.length++] = 's';
-			telnet_server.buffer[telnet_server.length++] = ']';
-			telnet_server.buffer[telnet_server.length++] = '\r';
-			telnet_server.buffer[telnet_server.length++] = '\n';
+			TelnetRingWrite(telnet_server, "\r\n[Yes]\r\n", 9U, 0U);
 			/* Switch back to normal mode. */
-			telnet_server.state = STATE_NORMAL;
+			telnet_server->state = STATE_NORMAL;
 			/* This character has been handled. */
 			break;
 		}
@@ -851,7 +1944,7 @@ void TelnetProcessCharacter(char character) {
 		case TELNET_NOP :
 		default: {
 			/* Switch back to normal mode. */
-			telnet_server.state = STATE_NORMAL;
+			telnet_server->state = STATE_NORMAL;
 			/* This character has been handled. */
 			break;
 		}
@@ -864,7 +1957,7 @@ void TelnetProcessCharacter(char character) {
 		/* Process the WILL request on this option. */
 		TelnetProcessWill(character);
 		/* Switch back to normal mode. */
-		telnet_server.state = STATE_NORMAL;
+		telnet_server->state = STATE_NORMAL;
 		/* This state has been handled. */
 		break;
 	}
@@ -873,7 +1966,7 @@ void TelnetProcessCharacter(char character) {
 		/* Process the WONT request on this option. */
 		TelnetProcessWont(character);
 		/* Switch back to normal mode. */
-		telnet_server.state = STATE_NORMAL;
+		telnet_server->state = STATE_NORMAL;
 		/* This state has been handled. */
 		break;
 	}
@@ -882,7 +1975,7 @@ void TelnetProcessCharacter(char character) {
 		/* Process the DO request on this option. */
 		TelnetProcessDo(character);
 		/* Switch back to normal mode. */
-		telnet_server.state = STATE_NORMAL;
+		telnet_server->state = STATE_NORMAL;
 		/* This state has been handled. */
 		break;
 	}
@@ -891,7 +1984,7 @@ void TelnetProcessCharacter(char character) {
 		/* Process the DONT request on this option. */
 		TelnetProcessDont(character);
 		/* Switch back to normal mode. */
-		telnet_server.state = STATE_NORMAL;
+		telnet_server->state = STATE_NORMAL;
 		/* This state has been handled. */
 		break;
 	}
@@ -899,7 +1992,7 @@ void TelnetProcessCharacter(char character) {
 		 is provided just in case it is ever needed. */
 	default: {
 		/* Switch back to normal mode. */
-		telnet_server.state = STATE_NORMAL;
+		telnet_server->state = STATE_NORMAL;
 		/* This state has been handled. */
 		break;
 	}
@@ -907,13 +2000,14 @@ void TelnetProcessCharacter(char character) {
 }
 
 /**
- * Print a message to the telnet connection formatted as an error.
+ * Print a message to the telnet connection formatted as an error. The message is sent ahead of any sample data
+ * still waiting in the transmit ring.
  *
  * @param message char* Pointer to the string to send
  * @retval none
  */
 void TelnetWriteErrorMessage(char* message) {
-	if (TelnetIsConnected() == true) {
+	if (isSessionConnected(telnet_server) == true) {
 		ClearToMessageBuffer();
 		char* character = message;
 		while (*character) {
@@ -922,19 +2016,22 @@ void TelnetWriteErrorMessage(char* message) {
 		uint8_t count = character - message;
 		uint16_t n = snprintf(MESSAGE_BUFFER, sizeof(ERROR_MESSAGE_HEADER) + count - 2, ERROR_MESSAGE_HEADER, message);
 		if (n > 0) {
-			TelnetWriteString(MESSAGE_BUFFER);
+			if (TelnetQueuePriority(MESSAGE_BUFFER, (n < sizeof(MESSAGE_BUFFER)) ? n : (sizeof(MESSAGE_BUFFER) - 1)) != WRITE_OK) {
+				++telnet_server->dropped;
+			}
 		}
 	}
 }
 
 /**
- * Print a message to the telnet connection formatted as a status.
+ * Print a message to the telnet connection formatted as a status. The message is sent ahead of any sample data
+ * still waiting in the transmit ring.
  *
  * @param message char* Pointer to the string to send
  * @retval none
  */
 void TelnetWriteStatusMessage(char* message) {
-	if (TelnetIsConnected() == true) {
+	if (isSessionConnected(telnet_server) == true) {
 		ClearToMessageBuffer();
 		uint8_t count = 0;
 		char* character = message;
@@ -944,7 +2041,9 @@ void TelnetWriteStatusMessage(char* message) {
 		}
 		uint16_t n = snprintf(MESSAGE_BUFFER, sizeof(STATUS_MESSAGE_HEADER) + count - 2, STATUS_MESSAGE_HEADER, message);
 		if (n > 0) {
-			TelnetWriteString(MESSAGE_BUFFER);
+			if (TelnetQueuePriority(MESSAGE_BUFFER, (n < sizeof(MESSAGE_BUFFER)) ? n : (sizeof(MESSAGE_BUFFER) - 1)) != WRITE_OK) {
+				++telnet_server->dropped;
+			}
 		}
 	}
 }
@@ -956,7 +2055,7 @@ void TelnetWriteStatusMessage(char* message) {
  * @retval none
  */
 void TelnetWriteDebugMessage(char* message) {
-	if (TelnetIsConnected() == true) {
+	if (isSessionConnected(telnet_server) == true) {
 		ClearToMessageBuffer();
 		char* character = message;
 		while (*character) {
@@ -965,7 +2064,9 @@ void TelnetWriteDebugMessage(char* message) {
 		uint8_t count = character - message;
 		uint16_t n = snprintf(MESSAGE_BUFFER, sizeof(DEBUG_MESSAGE_HEADER) + count - 2, DEBUG_MESSAGE_HEADER, message);
 		if (n > 0) {
-			TelnetWriteString(MESSAGE_BUFFER);
+			if (TelnetQueue(MESSAGE_BUFFER, (n < sizeof(MESSAGE_BUFFER)) ? n : (sizeof(MESSAGE_BUFFER) - 1)) != WRITE_OK) {
+				++telnet_server->dropped;
+			}
 		}
 	}
 }
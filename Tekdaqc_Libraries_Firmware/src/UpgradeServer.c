@@ -0,0 +1,445 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file UpgradeServer.c
+ * @brief Implements a raw TCP stream for uploading firmware images to the Tekdaqc.
+ *
+ * A client opens a connection, sends the UPGRADE_HEADER_LENGTH byte header followed by the image and then waits for
+ * a single line reply: STAGED once the image is programmed and verified, or FAILED, BUSY, TOO_LARGE or BAD_HEADER,
+ * after which the board closes the connection. A staged image is installed on the next reset. Only a single
+ * connection is allowed at a time; further attempts are refused.
+ *
+ * Received data is held in its pbufs until the staging buffer takes it, and the TCP window is only opened by what has
+ * been taken, so the client is paced by the FLASH programming without any data being copied twice.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "UpgradeServer.h"
+#include "Tekdaqc_Upgrade.h"
+#include "Tekdaqc_BSP.h"
+#include "lwip/memp.h"
+#include "lwip/tcp.h"
+#include <string.h>
+#include <stdio.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Pointer to the TCP port being used for the upgrade server.
+ */
+static struct tcp_pcb *upgrade_pcb;
+
+/**
+ * @internal
+ * @brief Pointer to the PCB of the connected client, NULL if there is none.
+ */
+static struct tcp_pcb *client_pcb = NULL;
+
+/**
+ * @internal
+ * @brief The received data not yet taken by the staging buffer, and the offset of the first byte not taken.
+ */
+static struct pbuf *pending = NULL;
+static uint16_t pendingOffset = 0U;
+
+/**
+ * @internal
+ * @brief The header of the upload, as received so far.
+ */
+static uint8_t header[UPGRADE_HEADER_LENGTH];
+static uint8_t headerLength = 0U;
+
+/**
+ * @internal
+ * @brief Set once the header has been accepted and the image is being received.
+ */
+static bool uploading = false;
+
+/**
+ * @internal
+ * @brief Set once the client has closed its side of the connection.
+ */
+static bool clientClosed = false;
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Called when the lwIP TCP/IP stack has an incoming connection request on the upgrade port.
+ */
+static err_t UpgradeServerAccept(void *arg, struct tcp_pcb *pcb, err_t err);
+
+/**
+ * @internal
+ * @brief Called when the lwIP TCP/IP stack has an incoming packet for the upgrade connection.
+ */
+static err_t UpgradeServerReceive(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err);
+
+/**
+ * @internal
+ * @brief Called periodically by the lwIP TCP/IP stack for the upgrade connection.
+ */
+static err_t UpgradeServerPoll(void *arg, struct tcp_pcb *pcb);
+
+/**
+ * @internal
+ * @brief Called when the lwIP TCP/IP stack has detected an error.
+ */
+static void UpgradeServerError(void *arg, err_t err);
+
+/**
+ * @internal
+ * @brief Passes the pending data to the header or the staging buffer.
+ */
+static void UpgradeServerFeed(void);
+
+/**
+ * @internal
+ * @brief Starts the upload described by the received header.
+ */
+static bool UpgradeServerStart(void);
+
+/**
+ * @internal
+ * @brief Sends a reply to the client and closes the connection.
+ */
+static void UpgradeServerFinish(const char* reply);
+
+/**
+ * @internal
+ * @brief Releases the connection state, abandoning any upload in progress.
+ */
+static void UpgradeServerRelease(void);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * This function is called when the lwIP TCP/IP stack has an incoming connection request on the upgrade port. Only
+ * a single client is served at a time.
+ *
+ * @param arg void* Argument pointer passed to the handler by the lwIP stack.
+ * @param pcb tcp_pcb* struct The PCB structure this callback is for.
+ * @param err lwIP err_t with the current error status.
+ * @retval err lwIP err_t with the result of the this function.
+ */
+static err_t UpgradeServerAccept(void *arg, struct tcp_pcb *pcb, err_t err) {
+	LWIP_UNUSED_ARG(arg);
+	LWIP_UNUSED_ARG(err);
+	if (client_pcb != NULL) {
+#ifdef UPGRADE_SERVER_DEBUG
+		printf("[Upgrade Server] A connection was attempted while an active connection is open.\n\r");
+#endif
+		tcp_abort(pcb);
+		return ERR_ABRT;
+	}
+	tcp_accepted(pcb);
+	tcp_setprio(pcb, TCP_PRIO_MIN);
+
+	client_pcb = pcb;
+	pending = NULL;
+	pendingOffset = 0U;
+	headerLength = 0U;
+	uploading = false;
+	clientClosed = false;
+
+	tcp_arg(pcb, NULL);
+	tcp_recv(pcb, UpgradeServerReceive);
+	tcp_err(pcb, UpgradeServerError);
+	tcp_poll(pcb, UpgradeServerPoll, 4);
+#ifdef UPGRADE_SERVER_DEBUG
+	printf("[Upgrade Server] An incoming connection was accepted.\n\r");
+#endif
+	return ERR_OK;
+}
+
+/**
+ * @internal
+ * This function is called when the lwIP TCP/IP stack has an incoming packet for the upgrade connection. The packet
+ * is chained onto the data waiting for the staging buffer. A NULL packet indicates the client has finished sending,
+ * which ends the upload once the waiting data has been taken.
+ *
+ * @param arg void* Argument pointer passed to the handler by the lwIP stack.
+ * @param pcb tcp_pcb* struct The PCB structure this callback is for.
+ * @param p pbuf* struct The data buffer from the lwIP stack.
+ * @param err lwIP err_t with the current error status.
+ * @retval err lwIP err_t with the result of the this function.
+ */
+static err_t UpgradeServerReceive(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err) {
+	LWIP_UNUSED_ARG(arg);
+	LWIP_UNUSED_ARG(pcb);
+	if (p != NULL) {
+		if (pending == NULL) {
+			pending = p;
+			pendingOffset = 0U;
+		} else {
+			pbuf_cat(pending, p);
+		}
+		UpgradeServerFeed();
+	} else if (err == ERR_OK) {
+		clientClosed = true;
+	}
+	return ERR_OK;
+}
+
+/**
+ * @internal
+ * This function is called periodically by the lwIP TCP/IP stack. Any waiting data is passed on as a backstop to
+ * UpgradeServerService().
+ *
+ * @param arg void* Argument pointer passed to the handler by the lwIP stack.
+ * @param pcb tcp_pcb* struct The PCB structure this callback is for.
+ * @retval err lwIP err_t with the result of the this function.
+ */
+static err_t UpgradeServerPoll(void *arg, struct tcp_pcb *pcb) {
+	LWIP_UNUSED_ARG(arg);
+	LWIP_UNUSED_ARG(pcb);
+	UpgradeServerFeed();
+	return ERR_OK;
+}
+
+/**
+ * @internal
+ * This function is called when a fatal error has occurred on the upgrade connection. The PCB has already been freed
+ * by lwIP.
+ *
+ * @param arg void* Argument pointer passed to the handler by the lwIP stack.
+ * @param err lwIP err_t with the error which occurred.
+ * @retval none
+ */
+static void UpgradeServerError(void *arg, err_t err) {
+	LWIP_UNUSED_ARG(arg);
+	LWIP_UNUSED_ARG(err);
+#ifdef UPGRADE_SERVER_DEBUG
+	printf("[Upgrade Server] Upgrade server error received: %i\n\r", err);
+#endif
+	client_pcb = NULL;
+	UpgradeServerRelease();
+}
+
+/**
+ * @internal
+ * Passes the waiting data to the header until it is complete, then to the staging buffer as far as it has room. The
+ * TCP window is opened by the number of bytes taken. Data beyond the end of the image is discarded.
+ *
+ * @param none
+ * @retval none
+ */
+static void UpgradeServerFeed(void) {
+	uint16_t taken = 0U;
+	while ((pending != NULL) && (client_pcb != NULL)) {
+		struct pbuf* q = pending;
+		uint16_t offset = pendingOffset;
+		while (offset >= q->len) {
+			offset -= q->len;
+			q = q->next;
+		}
+		const uint8_t* data = ((const uint8_t*) q->payload) + offset;
+		const uint16_t available = q->len - offset;
+		uint16_t count;
+		if (uploading == false) {
+			count = UPGRADE_HEADER_LENGTH - headerLength;
+			if (count > available) {
+				count = available;
+			}
+			memcpy(&header[headerLength], data, count);
+			headerLength += count;
+		} else if (Upgrade_GetState() == UPGRADE_RECEIVING) {
+			count = Upgrade_Accept(data, available);
+			if (count == 0U) {
+				break;
+			}
+		} else {
+			count = available;
+		}
+		pendingOffset += count;
+		taken += count;
+		if (pendingOffset == pending->tot_len) {
+			pbuf_free(pending);
+			pending = NULL;
+			pendingOffset = 0U;
+		}
+		if ((uploading == false) && (headerLength == UPGRADE_HEADER_LENGTH) && (UpgradeServerStart() == false)) {
+			return;
+		}
+	}
+	if ((taken > 0U) && (client_pcb != NULL)) {
+		tcp_recved(client_pcb, taken);
+	}
+}
+
+/**
+ * @internal
+ * Starts the upload described by the received header, replying and closing the connection if it can not be started.
+ *
+ * @param none
+ * @retval bool TRUE if the upload was started.
+ */
+static bool UpgradeServerStart(void) {
+	uint32_t magic;
+	uint32_t length;
+	uint32_t crc;
+	memcpy(&magic, &header[0], sizeof(magic));
+	memcpy(&length, &header[4], sizeof(length));
+	memcpy(&crc, &header[8], sizeof(crc));
+	if (magic != UPGRADE_HEADER_MAGIC) {
+		UpgradeServerFinish("BAD_HEADER\n\r");
+		return false;
+	}
+	switch (Upgrade_Begin(length, crc)) {
+	case UPGRADE_OK:
+		break;
+	case UPGRADE_ERR_SIZE:
+		UpgradeServerFinish("TOO_LARGE\n\r");
+		return false;
+	case UPGRADE_ERR_BUSY:
+	default:
+		UpgradeServerFinish("BUSY\n\r");
+		return false;
+	}
+#ifdef UPGRADE_SERVER_DEBUG
+	printf("[Upgrade Server] Receiving a %lu byte image.\n\r", length);
+#endif
+	uploading = true;
+	return true;
+}
+
+/**
+ * @internal
+ * Sends a reply to the client and closes the connection. The reply is copied, so it is still sent once the
+ * connection is closed.
+ *
+ * @param reply const char* The C-String to reply with.
+ * @retval none
+ */
+static void UpgradeServerFinish(const char* reply) {
+	struct tcp_pcb *pcb = client_pcb;
+	if (pcb != NULL) {
+		tcp_write(pcb, reply, strlen(reply), TCP_WRITE_FLAG_COPY);
+		tcp_output(pcb);
+		/* Remove all callbacks */
+		tcp_arg(pcb, NULL);
+		tcp_recv(pcb, NULL);
+		tcp_err(pcb, NULL);
+		tcp_poll(pcb, NULL, 0);
+		client_pcb = NULL;
+		tcp_close(pcb);
+	}
+	UpgradeServerRelease();
+}
+
+/**
+ * @internal
+ * Releases the data waiting for the staging buffer and abandons the upload if it is still being received.
+ *
+ * @param none
+ * @retval none
+ */
+static void UpgradeServerRelease(void) {
+	if (pending != NULL) {
+		pbuf_free(pending);
+		pending = NULL;
+	}
+	pendingOffset = 0U;
+	if ((uploading == true) && (Upgrade_GetState() == UPGRADE_RECEIVING)) {
+		Upgrade_Abort();
+	}
+	uploading = false;
+	headerLength = 0U;
+	clientClosed = false;
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Creates the TCP listener for the upgrade server on UPGRADE_PORT.
+ *
+ * @param none
+ * @retval UpgradeServerStatus_t The result of the initialization.
+ */
+UpgradeServerStatus_t InitializeUpgradeServer(void) {
+	upgrade_pcb = tcp_new();
+	if (upgrade_pcb != NULL) {
+		if (tcp_bind(upgrade_pcb, IP_ADDR_ANY, UPGRADE_PORT) == ERR_OK) {
+			upgrade_pcb = tcp_listen(upgrade_pcb);
+#ifdef UPGRADE_SERVER_DEBUG
+			printf("[Upgrade Server] Now listening for incoming connections on port %i\n\r", UPGRADE_PORT);
+#endif
+			tcp_accept(upgrade_pcb, UpgradeServerAccept);
+			return UPGRADE_SERVER_OK;
+		} else {
+			/* Deallocate the pcb */
+			memp_free(MEMP_TCP_PCB, upgrade_pcb);
+#ifdef UPGRADE_SERVER_DEBUG
+			printf("[Upgrade Server] Can not bind pcb\n\r");
+#endif
+			return UPGRADE_SERVER_ERR_BIND;
+		}
+	} else {
+#ifdef UPGRADE_SERVER_DEBUG
+		printf("[Upgrade Server] Can not create new TCP port.\n\r");
+#endif
+		return UPGRADE_SERVER_ERR_PCBCREATE;
+	}
+}
+
+/**
+ * Called from the main loop to pass waiting data on to the staging buffer as it drains, and to reply once the
+ * image has been staged or has failed. A client which finishes sending before the whole image has arrived abandons
+ * the upload.
+ *
+ * @param none
+ * @retval none
+ */
+void UpgradeServerService(void) {
+	if (client_pcb == NULL) {
+		return;
+	}
+	UpgradeServerFeed();
+	if ((client_pcb == NULL) || (uploading == false)) {
+		if ((client_pcb != NULL) && (clientClosed == true) && (pending == NULL)) {
+			UpgradeServerFinish("BAD_HEADER\n\r");
+		}
+		return;
+	}
+	const UpgradeState_t state = Upgrade_GetState();
+	if (state == UPGRADE_STAGED) {
+		UpgradeServerFinish("STAGED\n\r");
+	} else if (state != UPGRADE_RECEIVING) {
+		UpgradeServerFinish("FAILED\n\r");
+	} else if ((clientClosed == true) && (pending == NULL)) {
+		uint32_t received;
+		uint32_t length;
+		uint32_t crc;
+		Upgrade_GetProgress(&received, &length, &crc);
+		if (received < length) {
+			UpgradeServerFinish("FAILED\n\r");
+		}
+	}
+}
@@ -0,0 +1,897 @@
+/*
+ * Copyright 2013 Tenkiv, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License is distributed on
+ * an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the
+ * specific language governing permissions and limitations under the License.
+ */
+
+/**
+ * @file WebSocketServer.c
+ * @brief Implements a WebSocket live stream for the Tekdaqc.
+ *
+ * Implements the server side of RFC 6455 over the lwIP raw API, for browser dashboards watching the board live. A
+ * client connects by upgrading an HTTP request, after which it is sent every sample record the board writes, strings
+ * as text messages and binary frames as binary messages, together with a table of latest values built by the
+ * application at the interval the client asked for in the query of its request:
+ *
+ *   GET /stream?interval=100 HTTP/1.1
+ *
+ * The records are the ones already encoded for the sample destination, so each is encoded once however many
+ * clients watch it; only the two or four byte message header is added. A live view wants the newest data rather than
+ * all of it, so a message which does not fit a client's send buffer is dropped for that client and counted, and the
+ * sampling is never held up by a slow dashboard.
+ *
+ * What clients send is ignored apart from the close and ping control frames, which are answered.
+ *
+ * @author Jared Woolston (jwoolston@tenkiv.com)
+ * @since v1.0.0.0
+ */
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* INCLUDES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+#include "Tekdaqc_Debug.h"
+#include "WebSocketServer.h"
+#include "Tekdaqc_Timers.h"
+#include "netconf.h"
+#include "lwip/tcp.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE DEFINES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @def WEBSOCKET_GUID
+ * @brief The string appended to the client's key to compute the accept value of the handshake.
+ */
+#define WEBSOCKET_GUID				"258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+/**
+ * @internal
+ * @def WEBSOCKET_KEY_LENGTH
+ * @brief The length of the base64 encoded 16 byte key sent by the client.
+ */
+#define WEBSOCKET_KEY_LENGTH		24U
+
+/**
+ * @internal
+ * @def WEBSOCKET_ACCEPT_LENGTH
+ * @brief The length of the base64 encoded SHA-1 digest answered to the client.
+ */
+#define WEBSOCKET_ACCEPT_LENGTH		28U
+
+/**
+ * @internal
+ * @def WEBSOCKET_RESPONSE_SIZE
+ * @brief The size of the buffer the handshake response is built in.
+ */
+#define WEBSOCKET_RESPONSE_SIZE		160U
+
+/**
+ * @internal
+ * @def WEBSOCKET_HEADER_SIZE
+ * @brief The largest header of a message sent, with the 16 bit extended length.
+ */
+#define WEBSOCKET_HEADER_SIZE		4U
+
+/**
+ * @internal
+ * @def WEBSOCKET_MAX_CONTROL_PAYLOAD
+ * @brief The most payload a control frame may carry.
+ */
+#define WEBSOCKET_MAX_CONTROL_PAYLOAD	125U
+
+/** WebSocket frame header bits */
+#define WEBSOCKET_FIN				0x80U
+#define WEBSOCKET_MASK				0x80U
+#define WEBSOCKET_OPCODE_MASK		0x0FU
+#define WEBSOCKET_CONTROL			0x08U
+#define WEBSOCKET_LENGTH_16			126U
+#define WEBSOCKET_LENGTH_64			127U
+
+/** WebSocket opcodes */
+#define WEBSOCKET_OPCODE_TEXT		0x01U
+#define WEBSOCKET_OPCODE_BINARY		0x02U
+#define WEBSOCKET_OPCODE_CLOSE		0x08U
+#define WEBSOCKET_OPCODE_PING		0x09U
+#define WEBSOCKET_OPCODE_PONG		0x0AU
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE VARIABLES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief The client connections of the WebSocket server.
+ */
+static WebSocketClient_t clients[WEBSOCKET_MAX_CLIENTS];
+
+/**
+ * @internal
+ * @brief Builds the table of latest values, NULL for none.
+ */
+static WebSocketTableFunction tableBuilder = NULL;
+
+/**
+ * @internal
+ * @brief The table of latest values, built once for every client it is due for.
+ */
+static uint8_t table[WEBSOCKET_TABLE_SIZE];
+
+/**
+ * @internal
+ * @brief The number of messages dropped for full send buffers since start up.
+ */
+static uint32_t droppedCount = 0U;
+
+/**
+ * @internal
+ * @brief The characters of base64 encoding.
+ */
+static const char Base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTION PROTOTYPES */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * @brief Called when the lwIP TCP/IP stack has an incoming packet for a WebSocket connection.
+ */
+static err_t WebSocketReceive(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err);
+
+/**
+ * @internal
+ * @brief Called when the lwIP TCP/IP stack has received an acknowledge for data that has been transmitted.
+ */
+static err_t WebSocketSent(void *arg, struct tcp_pcb *pcb, u16_t len);
+
+/**
+ * @internal
+ * @brief Called periodically by the lwIP TCP/IP stack.
+ */
+static err_t WebSocketPoll(void *arg, struct tcp_pcb *pcb);
+
+/**
+ * @internal
+ * @brief Called when the lwIP TCP/IP stack has detected an error.
+ */
+static void WebSocketError(void *arg, err_t err);
+
+/**
+ * @internal
+ * @brief Closes a WebSocket client connection once its queued data has been sent.
+ */
+static void WebSocketClose(WebSocketClient_t* client);
+
+/**
+ * @internal
+ * @brief Aborts a WebSocket client connection at once.
+ */
+static void WebSocketAbort(WebSocketClient_t* client);
+
+/**
+ * @internal
+ * @brief Handles a complete control frame received from a client.
+ */
+static bool WebSocketControl(WebSocketClient_t* client, uint8_t opcode, uint8_t* payload, uint8_t length);
+
+/**
+ * @internal
+ * @brief Queues a message to a client, or drops it if it does not fit.
+ */
+static bool WebSocketSend(WebSocketClient_t* client, uint8_t opcode, const uint8_t* data, uint16_t length);
+
+/**
+ * @internal
+ * @brief Finds a header of a request.
+ */
+static const char* WebSocketFindHeader(const char* headers, const char* name, uint16_t* length);
+
+/**
+ * @internal
+ * @brief Indicates if a header value holds a token, ignoring case.
+ */
+static bool WebSocketHasToken(const char* value, uint16_t length, const char* token);
+
+/**
+ * @internal
+ * @brief Compares two strings, ignoring the case of ASCII letters.
+ */
+static bool WebSocketMatches(const char* a, const char* b, uint16_t length);
+
+/**
+ * @internal
+ * @brief Processes a 64 byte block of a SHA-1 digest.
+ */
+static void Sha1Block(uint32_t* state, const uint8_t* block);
+
+/**
+ * @internal
+ * @brief Computes the SHA-1 digest of a buffer.
+ */
+static void Sha1(const uint8_t* data, uint32_t length, uint8_t* digest);
+
+/**
+ * @internal
+ * @brief Encodes a buffer in base64.
+ */
+static void Base64Encode(const uint8_t* data, uint32_t length, char* encoded);
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PRIVATE FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * This function is called when the lwIP TCP/IP stack has an incoming packet for a WebSocket connection. Received
+ * frames are gathered a byte at a time, clients only send the occasional control frame. The payload of a data frame
+ * is skipped as it arrives, that of a control frame is unmasked and answered once complete. A frame which breaks the
+ * protocol aborts the connection. A NULL packet indicates the client has closed the connection.
+ *
+ * @param arg void* Argument pointer passed to the handler by the lwIP stack.
+ * @param pcb tcp_pcb* struct The PCB structure this callback is for.
+ * @param p pbuf* struct The data buffer from the lwIP stack.
+ * @param err lwIP err_t with the current error status.
+ * @retval err lwIP err_t with the result of the this function.
+ */
+static err_t WebSocketReceive(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err) {
+	WebSocketClient_t* client = (WebSocketClient_t*) arg;
+	if (p == NULL) {
+		if (err == ERR_OK) {
+			WebSocketClose(client);
+		}
+		return ERR_OK;
+	}
+	tcp_recved(pcb, p->tot_len);
+	bool valid = true;
+	for (struct pbuf* q = p; (q != NULL) && (valid == true) && (client->pcb != NULL); q = q->next) {
+		const uint8_t* data = (const uint8_t*) q->payload;
+		uint16_t remaining = q->len;
+		while ((remaining > 0U) && (valid == true) && (client->pcb != NULL)) {
+			if (client->skip > 0U) {
+				uint16_t count = (client->skip < remaining) ? (uint16_t) client->skip : remaining;
+				client->skip -= count;
+				data += count;
+				remaining -= count;
+				continue;
+			}
+			client->frame[client->length++] = *data++;
+			--remaining;
+			if (client->length < 2U) {
+				continue;
+			}
+			const uint8_t opcode = client->frame[0] & WEBSOCKET_OPCODE_MASK;
+			uint8_t size = client->frame[1] & ~WEBSOCKET_MASK;
+			uint8_t header = 2U;
+			if (size == WEBSOCKET_LENGTH_16) {
+				header += 2U;
+			} else if (size == WEBSOCKET_LENGTH_64) {
+				header += 8U;
+			}
+			/* Client frames are always masked */
+			header += 4U;
+			if ((client->frame[1] & WEBSOCKET_MASK) == 0U) {
+				valid = false;
+			} else if (((opcode & WEBSOCKET_CONTROL) != 0U) && (size > WEBSOCKET_MAX_CONTROL_PAYLOAD)) {
+				valid = false;
+			} else if (client->length < header) {
+				continue;
+			} else if ((opcode & WEBSOCKET_CONTROL) == 0U) {
+				/* Data from the client is not used, its payload is skipped */
+				uint32_t payload = size;
+				if (size == WEBSOCKET_LENGTH_16) {
+					payload = ((uint32_t) client->frame[2] << 8) | client->frame[3];
+				} else if (size == WEBSOCKET_LENGTH_64) {
+					/* Nothing a dashboard sends comes near 4 GB */
+					valid = ((client->frame[2] | client->frame[3] | client->frame[4] | client->frame[5]) == 0U);
+					payload = ((uint32_t) client->frame[6] << 24) | ((uint32_t) client->frame[7] << 16)
+							| ((uint32_t) client->frame[8] << 8) | client->frame[9];
+				}
+				client->skip = payload;
+				client->length = 0U;
+			} else if (client->length == (header + size)) {
+				uint8_t* payload = &client->frame[header];
+				for (uint_fast8_t i = 0U; i < size; ++i) {
+					payload[i] ^= client->frame[header - 4U + (i % 4U)];
+				}
+				client->length = 0U;
+				valid = WebSocketControl(client, opcode, payload, size);
+			}
+		}
+	}
+	pbuf_free(p);
+	if (valid == false) {
+#ifdef WEBSOCKET_SERVER_DEBUG
+		printf("[WebSocket Server] Received a malformed frame, aborting the connection.\n\r");
+#endif
+		WebSocketAbort(client);
+		return ERR_ABRT;
+	}
+	if (client->pcb != NULL) {
+		tcp_output(pcb);
+	}
+	return ERR_OK;
+}
+
+/**
+ * @internal
+ * This function is called when the lwIP TCP/IP stack has received an acknowledge for data that has been
+ * transmitted.
+ *
+ * @param arg void* Argument pointer passed to the handler by the lwIP stack.
+ * @param pcb tcp_pcb* struct The PCB structure this callback is for.
+ * @param len u16_t The number of bytes which were ACKed.
+ * @retval err lwIP err_t with the result of the this function.
+ */
+static err_t WebSocketSent(void *arg, struct tcp_pcb *pcb, u16_t len) {
+	LWIP_UNUSED_ARG(pcb);
+	LWIP_UNUSED_ARG(len);
+	WebSocketClient_t* client = (WebSocketClient_t*) arg;
+	client->ackedAt = GetLocalTime();
+	return ERR_OK;
+}
+
+/**
+ * @internal
+ * This function is called periodically by the lwIP TCP/IP stack. A client which has stopped ACKing without closing
+ * is aborted here, freeing its slot for another dashboard.
+ *
+ * @param arg void* Argument pointer passed to the handler by the lwIP stack.
+ * @param pcb tcp_pcb* struct The PCB structure this callback is for.
+ * @retval err lwIP err_t with the result of the this function.
+ */
+static err_t WebSocketPoll(void *arg, struct tcp_pcb *pcb) {
+	WebSocketClient_t* client = (WebSocketClient_t*) arg;
+	if (LwIP_IsPeerStalled(pcb, &client->ackedAt) == true) {
+#ifdef WEBSOCKET_SERVER_DEBUG
+		printf("[WebSocket Server] Aborting a connection whose client stopped responding.\n\r");
+#endif
+		WebSocketAbort(client);
+		return ERR_ABRT;
+	}
+	return ERR_OK;
+}
+
+/**
+ * @internal
+ * This function is called when a fatal error has occurred on a WebSocket connection. The PCB has already been freed
+ * by lwIP.
+ *
+ * @param arg void* Argument pointer passed to the handler by the lwIP stack.
+ * @param err lwIP err_t with the error which occurred.
+ * @retval none
+ */
+static void WebSocketError(void *arg, err_t err) {
+	LWIP_UNUSED_ARG(err);
+#ifdef WEBSOCKET_SERVER_DEBUG
+	printf("[WebSocket Server] WebSocket server error received: %i\n\r", err);
+#endif
+	WebSocketClient_t* client = (WebSocketClient_t*) arg;
+	if (client != NULL) {
+		client->pcb = NULL;
+	}
+}
+
+/**
+ * @internal
+ * Closes a WebSocket client connection, freeing its slot. lwIP sends any data still queued before the FIN.
+ *
+ * @param client WebSocketClient_t* Pointer to the connection to close.
+ * @retval none
+ */
+static void WebSocketClose(WebSocketClient_t* client) {
+	struct tcp_pcb *pcb = client->pcb;
+	if (pcb != NULL) {
+		/* Remove all callbacks */
+		tcp_arg(pcb, NULL );
+		tcp_recv(pcb, NULL );
+		tcp_sent(pcb, NULL );
+		tcp_poll(pcb, NULL, 0);
+		tcp_err(pcb, NULL );
+		client->pcb = NULL;
+		if (tcp_close(pcb) != ERR_OK) {
+			tcp_abort(pcb);
+		}
+	}
+}
+
+/**
+ * @internal
+ * Aborts a WebSocket client connection, freeing its slot. Callers inside an lwIP callback for the connection must
+ * return ERR_ABRT.
+ *
+ * @param client WebSocketClient_t* Pointer to the connection to abort.
+ * @retval none
+ */
+static void WebSocketAbort(WebSocketClient_t* client) {
+	struct tcp_pcb *pcb = client->pcb;
+	if (pcb != NULL) {
+		/* Remove all callbacks */
+		tcp_arg(pcb, NULL );
+		tcp_recv(pcb, NULL );
+		tcp_sent(pcb, NULL );
+		tcp_poll(pcb, NULL, 0);
+		tcp_err(pcb, NULL );
+		client->pcb = NULL;
+		tcp_abort(pcb);
+	}
+}
+
+/**
+ * @internal
+ * Handles a complete, unmasked control frame received from a client. A close is echoed and the connection closed
+ * after it, a ping is answered with a pong carrying the same payload, and a pong is ignored.
+ *
+ * @param client WebSocketClient_t* Pointer to the connection the frame arrived on.
+ * @param opcode uint8_t The opcode of the frame.
+ * @param payload uint8_t* Pointer to the payload of the frame.
+ * @param length uint8_t The length of the payload.
+ * @retval bool FALSE if the opcode is not a known control frame.
+ */
+static bool WebSocketControl(WebSocketClient_t* client, uint8_t opcode, uint8_t* payload, uint8_t length) {
+	switch (opcode) {
+	case WEBSOCKET_OPCODE_CLOSE:
+#ifdef WEBSOCKET_SERVER_DEBUG
+		printf("[WebSocket Server] The client closed the connection.\n\r");
+#endif
+		/* Echo only the status code, the reason is the client's */
+		WebSocketSend(client, WEBSOCKET_OPCODE_CLOSE, payload, (length >= 2U) ? 2U : 0U);
+		WebSocketClose(client);
+		return true;
+	case WEBSOCKET_OPCODE_PING:
+		WebSocketSend(client, WEBSOCKET_OPCODE_PONG, payload, length);
+		return true;
+	case WEBSOCKET_OPCODE_PONG:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * @internal
+ * Queues a single frame message to a client. The message is copied into lwIP with its header, or dropped and
+ * counted if the send buffer can not take it whole.
+ *
+ * @param client WebSocketClient_t* Pointer to the connection to send to.
+ * @param opcode uint8_t The opcode of the message.
+ * @param data const uint8_t* Pointer to the payload of the message.
+ * @param length uint16_t The length of the payload.
+ * @retval bool TRUE if the message was queued.
+ */
+static bool WebSocketSend(WebSocketClient_t* client, uint8_t opcode, const uint8_t* data, uint16_t length) {
+	struct tcp_pcb* pcb = client->pcb;
+	uint8_t header[WEBSOCKET_HEADER_SIZE];
+	uint16_t size = 2U;
+	header[0] = WEBSOCKET_FIN | opcode;
+	if (length < WEBSOCKET_LENGTH_16) {
+		header[1] = (uint8_t) length;
+	} else {
+		header[1] = WEBSOCKET_LENGTH_16;
+		header[2] = (uint8_t) (length >> 8);
+		header[3] = (uint8_t) length;
+		size = 4U;
+	}
+	if ((pcb == NULL) || (tcp_sndbuf(pcb) < (size + length)) || ((tcp_sndqueuelen(pcb) + 2U) > TCP_SND_QUEUELEN)) {
+		++droppedCount;
+		return false;
+	}
+	if (tcp_write(pcb, header, size, TCP_WRITE_FLAG_COPY | ((length > 0U) ? TCP_WRITE_FLAG_MORE : 0U)) != ERR_OK) {
+		++droppedCount;
+		return false;
+	}
+	if ((length > 0U) && (tcp_write(pcb, data, length, TCP_WRITE_FLAG_COPY) != ERR_OK)) {
+		/* The header has gone, so the stream can not be recovered */
+		WebSocketAbort(client);
+		++droppedCount;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @internal
+ * Finds a header of a request by its name, which is matched ignoring case. Leading and trailing white space is left
+ * out of the value.
+ *
+ * @param headers const char* The headers of the request, each ended by CRLF.
+ * @param name const char* The name of the header, without the colon.
+ * @param length uint16_t* Set to the length of the value.
+ * @retval const char* Pointer to the value of the header, NULL if the request does not have it.
+ */
+static const char* WebSocketFindHeader(const char* headers, const char* name, uint16_t* length) {
+	const uint16_t nameLength = strlen(name);
+	const char* line = headers;
+	while ((line != NULL) && (line[0] != '\r') && (line[0] != '\0')) {
+		const char* end = strstr(line, "\r\n");
+		if (end == NULL) {
+			return NULL;
+		}
+		if ((WebSocketMatches(line, name, nameLength) == true) && (line[nameLength] == ':')) {
+			const char* value = &line[nameLength + 1U];
+			while ((value < end) && ((*value == ' ') || (*value == '\t'))) {
+				++value;
+			}
+			while ((end > value) && ((end[-1] == ' ') || (end[-1] == '\t'))) {
+				--end;
+			}
+			*length = (uint16_t) (end - value);
+			return value;
+		}
+		line = end + 2;
+	}
+	return NULL;
+}
+
+/**
+ * @internal
+ * Indicates if a comma separated header value holds a token, ignoring case, as the Connection header of a browser
+ * holds "keep-alive, Upgrade".
+ *
+ * @param value const char* The header value.
+ * @param length uint16_t The length of the value.
+ * @param token const char* The token to look for.
+ * @retval bool TRUE if the value holds the token.
+ */
+static bool WebSocketHasToken(const char* value, uint16_t length, const char* token) {
+	const uint16_t tokenLength = strlen(token);
+	uint16_t i = 0U;
+	while (i < length) {
+		while ((i < length) && ((value[i] == ' ') || (value[i] == ','))) {
+			++i;
+		}
+		uint16_t start = i;
+		while ((i < length) && (value[i] != ',') && (value[i] != ' ')) {
+			++i;
+		}
+		if (((i - start) == tokenLength) && (WebSocketMatches(&value[start], token, tokenLength) == true)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @internal
+ * Compares the first length characters of two strings, ignoring the case of ASCII letters.
+ *
+ * @param a const char* The first string.
+ * @param b const char* The second string.
+ * @param length uint16_t The number of characters to compare.
+ * @retval bool TRUE if the characters match.
+ */
+static bool WebSocketMatches(const char* a, const char* b, uint16_t length) {
+	for (uint16_t i = 0U; i < length; ++i) {
+		char x = a[i];
+		char y = b[i];
+		if ((x >= 'A') && (x <= 'Z')) {
+			x += 'a' - 'A';
+		}
+		if ((y >= 'A') && (y <= 'Z')) {
+			y += 'a' - 'A';
+		}
+		if ((x != y) || (x == '\0')) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @internal
+ * Processes a 64 byte block of a SHA-1 digest, as given in FIPS 180-4.
+ *
+ * @param state uint32_t* The five words of the digest so far.
+ * @param block const uint8_t* Pointer to the block.
+ * @retval none
+ */
+static void Sha1Block(uint32_t* state, const uint8_t* block) {
+	uint32_t w[80];
+	for (uint_fast8_t i = 0U; i < 16U; ++i) {
+		w[i] = ((uint32_t) block[4U * i] << 24) | ((uint32_t) block[(4U * i) + 1U] << 16)
+				| ((uint32_t) block[(4U * i) + 2U] << 8) | block[(4U * i) + 3U];
+	}
+	for (uint_fast8_t i = 16U; i < 80U; ++i) {
+		const uint32_t x = w[i - 3U] ^ w[i - 8U] ^ w[i - 14U] ^ w[i - 16U];
+		w[i] = (x << 1) | (x >> 31);
+	}
+	uint32_t a = state[0];
+	uint32_t b = state[1];
+	uint32_t c = state[2];
+	uint32_t d = state[3];
+	uint32_t e = state[4];
+	for (uint_fast8_t i = 0U; i < 80U; ++i) {
+		uint32_t f;
+		uint32_t k;
+		if (i < 20U) {
+			f = (b & c) | (~b & d);
+			k = 0x5A827999U;
+		} else if (i < 40U) {
+			f = b ^ c ^ d;
+			k = 0x6ED9EBA1U;
+		} else if (i < 60U) {
+			f = (b & c) | (b & d) | (c & d);
+			k = 0x8F1BBCDCU;
+		} else {
+			f = b ^ c ^ d;
+			k = 0xCA62C1D6U;
+		}
+		const uint32_t temp = ((a << 5) | (a >> 27)) + f + e + k + w[i];
+		e = d;
+		d = c;
+		c = (b << 30) | (b >> 2);
+		b = a;
+		a = temp;
+	}
+	state[0] += a;
+	state[1] += b;
+	state[2] += c;
+	state[3] += d;
+	state[4] += e;
+}
+
+/**
+ * @internal
+ * Computes the SHA-1 digest of a buffer. The F407 has no hash processor, and the handshake is the only use, so this
+ * is a plain software implementation.
+ *
+ * @param data const uint8_t* Pointer to the buffer.
+ * @param length uint32_t The length of the buffer.
+ * @param digest uint8_t* Filled in with the 20 byte digest.
+ * @retval none
+ */
+static void Sha1(const uint8_t* data, uint32_t length, uint8_t* digest) {
+	uint32_t state[5] = { 0x67452301U, 0xEFCDAB89U, 0x98BADCFEU, 0x10325476U, 0xC3D2E1F0U };
+	uint32_t offset = 0U;
+	for (; (length - offset) >= 64U; offset += 64U) {
+		Sha1Block(state, &data[offset]);
+	}
+	/* The rest of the data, the 0x80 pad byte and the 64 bit length in bits fill one or two more blocks */
+	uint8_t tail[128];
+	const uint32_t remaining = length - offset;
+	const uint32_t blocks = ((remaining + 9U) > 64U) ? 2U : 1U;
+	memset(tail, 0, sizeof(tail));
+	memcpy(tail, &data[offset], remaining);
+	tail[remaining] = 0x80U;
+	const uint64_t bits = (uint64_t) length * 8U;
+	for (uint_fast8_t i = 0U; i < 8U; ++i) {
+		tail[(blocks * 64U) - 1U - i] = (uint8_t) (bits >> (8U * i));
+	}
+	for (uint_fast8_t i = 0U; i < blocks; ++i) {
+		Sha1Block(state, &tail[64U * i]);
+	}
+	for (uint_fast8_t i = 0U; i < 5U; ++i) {
+		digest[4U * i] = (uint8_t) (state[i] >> 24);
+		digest[(4U * i) + 1U] = (uint8_t) (state[i] >> 16);
+		digest[(4U * i) + 2U] = (uint8_t) (state[i] >> 8);
+		digest[(4U * i) + 3U] = (uint8_t) state[i];
+	}
+}
+
+/**
+ * @internal
+ * Encodes a buffer in base64 with padding.
+ *
+ * @param data const uint8_t* Pointer to the buffer.
+ * @param length uint32_t The length of the buffer.
+ * @param encoded char* Filled in with the NULL terminated encoding, 4 characters for every 3 bytes or part of.
+ * @retval none
+ */
+static void Base64Encode(const uint8_t* data, uint32_t length, char* encoded) {
+	uint32_t out = 0U;
+	for (uint32_t i = 0U; i < length; i += 3U) {
+		const uint32_t remaining = length - i;
+		const uint32_t group = ((uint32_t) data[i] << 16) | ((remaining > 1U) ? ((uint32_t) data[i + 1U] << 8) : 0U)
+				| ((remaining > 2U) ? data[i + 2U] : 0U);
+		encoded[out++] = Base64Alphabet[(group >> 18) & 0x3FU];
+		encoded[out++] = Base64Alphabet[(group >> 12) & 0x3FU];
+		encoded[out++] = (remaining > 1U) ? Base64Alphabet[(group >> 6) & 0x3FU] : '=';
+		encoded[out++] = (remaining > 2U) ? Base64Alphabet[group & 0x3FU] : '=';
+	}
+	encoded[out] = '\0';
+}
+
+/*--------------------------------------------------------------------------------------------------------*/
+/* PUBLIC FUNCTIONS */
+/*--------------------------------------------------------------------------------------------------------*/
+
+/**
+ * Initializes the WebSocket server. Clients connect through the HTTP server, whose table of documents names
+ * WebSocketServerUpgrade() for the stream.
+ *
+ * @param table WebSocketTableFunction Builds the table of latest values, NULL to send none.
+ * @retval none
+ */
+void WebSocketServerInit(WebSocketTableFunction table) {
+	tableBuilder = table;
+	for (uint_fast8_t i = 0U; i < WEBSOCKET_MAX_CLIENTS; ++i) {
+		clients[i].pcb = NULL;
+	}
+}
+
+/**
+ * Takes a connection over from the HTTP server, completing the WebSocket handshake. The request must carry the
+ * Upgrade, Connection and Sec-WebSocket-Key headers of a version 13 handshake. The interval of the table of latest
+ * values is taken from the interval parameter of the query, in milliseconds, 0 for no table.
+ *
+ * @param pcb tcp_pcb* struct The PCB of the connection.
+ * @param query const char* The query string of the request.
+ * @param headers const char* The headers of the request.
+ * @retval HttpUpgradeResult_t The result of the handshake.
+ */
+HttpUpgradeResult_t WebSocketServerUpgrade(struct tcp_pcb* pcb, const char* query, const char* headers) {
+	uint16_t length = 0U;
+	const char* value = WebSocketFindHeader(headers, "Upgrade", &length);
+	if ((value == NULL) || (WebSocketHasToken(value, length, "websocket") == false)) {
+		return HTTP_UPGRADE_BAD_REQUEST;
+	}
+	value = WebSocketFindHeader(headers, "Connection", &length);
+	if ((value == NULL) || (WebSocketHasToken(value, length, "upgrade") == false)) {
+		return HTTP_UPGRADE_BAD_REQUEST;
+	}
+	value = WebSocketFindHeader(headers, "Sec-WebSocket-Version", &length);
+	if ((value == NULL) || (length != 2U) || (strncmp(value, "13", 2U) != 0)) {
+		return HTTP_UPGRADE_BAD_REQUEST;
+	}
+	const char* key = WebSocketFindHeader(headers, "Sec-WebSocket-Key", &length);
+	if ((key == NULL) || (length != WEBSOCKET_KEY_LENGTH)) {
+		return HTTP_UPGRADE_BAD_REQUEST;
+	}
+	WebSocketClient_t* client = NULL;
+	for (uint_fast8_t i = 0U; i < WEBSOCKET_MAX_CLIENTS; ++i) {
+		if (clients[i].pcb == NULL) {
+			client = &clients[i];
+			break;
+		}
+	}
+	if (client == NULL) {
+#ifdef WEBSOCKET_SERVER_DEBUG
+		printf("[WebSocket Server] An upgrade was attempted while all connections are in use.\n\r");
+#endif
+		return HTTP_UPGRADE_UNAVAILABLE;
+	}
+
+	uint8_t concatenated[WEBSOCKET_KEY_LENGTH + sizeof(WEBSOCKET_GUID) - 1U];
+	memcpy(concatenated, key, WEBSOCKET_KEY_LENGTH);
+	memcpy(&concatenated[WEBSOCKET_KEY_LENGTH], WEBSOCKET_GUID, sizeof(WEBSOCKET_GUID) - 1U);
+	uint8_t digest[20];
+	Sha1(concatenated, sizeof(concatenated), digest);
+	char accept[WEBSOCKET_ACCEPT_LENGTH + 1U];
+	Base64Encode(digest, sizeof(digest), accept);
+	char response[WEBSOCKET_RESPONSE_SIZE];
+	int count = snprintf(response, sizeof(response), "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\n"
+			"Connection: Upgrade\r\nSec-WebSocket-Accept: %s\r\n\r\n", accept);
+	if ((count <= 0) || (count >= (int) sizeof(response))
+			|| (tcp_write(pcb, response, (u16_t) count, TCP_WRITE_FLAG_COPY) != ERR_OK)) {
+		return HTTP_UPGRADE_UNAVAILABLE;
+	}
+
+	uint32_t interval = WEBSOCKET_TABLE_INTERVAL_DEFAULT_MS;
+	const char* parameter = strstr(query, "interval=");
+	if ((parameter != NULL) && ((parameter == query) || (parameter[-1] == '&'))) {
+		interval = strtoul(&parameter[9], NULL, 10);
+		if ((interval != 0U) && (interval < WEBSOCKET_TABLE_INTERVAL_MIN_MS)) {
+			interval = WEBSOCKET_TABLE_INTERVAL_MIN_MS;
+		}
+	}
+	client->pcb = pcb;
+	client->interval = interval;
+	client->tableDue = GetLocalTime();
+	client->length = 0U;
+	client->skip = 0U;
+	client->ackedAt = GetLocalTime();
+	tcp_arg(pcb, client);
+	tcp_recv(pcb, WebSocketReceive);
+	tcp_err(pcb, WebSocketError);
+	tcp_poll(pcb, WebSocketPoll, 1);
+	tcp_sent(pcb, WebSocketSent);
+#ifdef WEBSOCKET_SERVER_DEBUG
+	printf("[WebSocket Server] A client connected, sending a table every %" PRIu32 " ms.\n\r", interval);
+#endif
+	return HTTP_UPGRADE_OK;
+}
+
+/**
+ * Called from the main loop to send the tables of latest values which are due. The table is built at most once per
+ * call, for every client it is due for.
+ *
+ * @param none
+ * @retval none
+ */
+void WebSocketServerService(void) {
+	if (tableBuilder == NULL) {
+		return;
+	}
+	const uint64_t now = GetLocalTime();
+	uint16_t length = 0U;
+	bool built = false;
+	for (uint_fast8_t i = 0U; i < WEBSOCKET_MAX_CLIENTS; ++i) {
+		WebSocketClient_t* client = &clients[i];
+		if ((client->pcb == NULL) || (client->interval == 0U) || (now < client->tableDue)) {
+			continue;
+		}
+		if (built == false) {
+			length = tableBuilder(table, sizeof(table));
+			built = true;
+		}
+		client->tableDue = now + ((uint64_t) client->interval * 1000U);
+		if (WebSocketSend(client, WEBSOCKET_OPCODE_BINARY, table, length) == true) {
+			tcp_output(client->pcb);
+		}
+	}
+}
+
+/**
+ * Indicates if any WebSocket client is connected.
+ *
+ * @param none
+ * @retval bool TRUE if at least one client is connected.
+ */
+bool WebSocketHasClients(void) {
+	for (uint_fast8_t i = 0U; i < WEBSOCKET_MAX_CLIENTS; ++i) {
+		if (clients[i].pcb != NULL) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Sends a sample record string to every WebSocket client as a text message.
+ *
+ * @param string const char* Pointer to the C-String to send.
+ * @retval none
+ */
+void WebSocketBroadcastString(const char* string) {
+	WebSocketBroadcastBinary((const uint8_t*) string, (uint16_t) strlen(string));
+}
+
+/**
+ * Sends a block of binary sample data to every WebSocket client as a binary message.
+ *
+ * @param data const uint8_t* Pointer to the data to send.
+ * @param length uint16_t The number of bytes to send.
+ * @retval none
+ */
+void WebSocketBroadcastBinary(const uint8_t* data, uint16_t length) {
+	for (uint_fast8_t i = 0U; i < WEBSOCKET_MAX_CLIENTS; ++i) {
+		if ((clients[i].pcb != NULL) && (WebSocketSend(&clients[i], WEBSOCKET_OPCODE_BINARY, data, length) == true)) {
+			tcp_output(clients[i].pcb);
+		}
+	}
+}
+
+/**
+ * Closes every WebSocket client connection.
+ *
+ * @param none
+ * @retval none
+ */
+void WebSocketServerCloseAll(void) {
+	for (uint_fast8_t i = 0U; i < WEBSOCKET_MAX_CLIENTS; ++i) {
+		WebSocketClose(&clients[i]);
+	}
+}
+
+/**
+ * Retrieves the number of messages dropped because a client's send buffer was full, since start up.
+ *
+ * @param none
+ * @retval uint32_t The number of messages dropped.
+ */
+uint32_t WebSocketGetDroppedCount(void) {
+	return droppedCount;
+}
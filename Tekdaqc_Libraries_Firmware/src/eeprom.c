@@ -22,12 +22,37 @@
 /*
  * This file has been modified from its original form by Tenkiv, Inc.
  * @since v1.0.0.0
+ *
+ * Writes made through EE_QueueWrite() are queued and programmed by EE_Service() in small steps from the program
+ * loop, including any page transfer, so that no single call blocks on more than a few FLASH operations. The page
+ * erase is started without waiting for it and is held back for an idle window, since the CPU stalls on FLASH
+ * fetches while a sector of the single bank is being erased.
+ *
+ * The latest value of each variable is also held in a RAM index, built by EE_Init() and updated on every write, so
+ * that reads do not scan the page.
  */
 
 /* Includes ------------------------------------------------------------------*/
 #include "eeprom.h"
+#include "Tekdaqc_Timers.h"
+#include <string.h>
 
 /* Private typedef -----------------------------------------------------------*/
+
+/* A write waiting in the write queue */
+typedef struct {
+	uint16_t VirtAddress;
+	uint16_t Data;
+} EE_Write_t;
+
+/* The steps of the background write job */
+typedef enum {
+	EE_JOB_IDLE, /* Programming queued writes into the valid page */
+	EE_JOB_TRANSFER, /* Moving the variables from the full page to the receiving page */
+	EE_JOB_ERASE, /* Waiting for an idle window to erase the full page */
+	EE_JOB_ERASING /* Waiting for the erase of the full page to complete */
+} EE_JobState_t;
+
 /* Private define ------------------------------------------------------------*/
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
@@ -35,12 +60,54 @@
 /* Global variable used to store variable value in read sequence */
 uint16_t DataVar = 0;
 
+/* The queue of writes waiting to be programmed */
+static EE_Write_t WriteQueue[EE_QUEUE_SIZE];
+
+/* The index of the oldest write in the queue */
+static uint16_t QueueHead = 0;
+
+/* The number of writes in the queue */
+static uint16_t QueueCount = 0;
+
+/* The step the background write job is at */
+static EE_JobState_t JobState = EE_JOB_IDLE;
+
+/* The write which started the page transfer in progress, it is in the receiving page but not yet readable there */
+static EE_Write_t TransferWrite;
+
+/* The address of the page receiving the transfer in progress */
+static uint32_t TransferPageAddress = 0;
+
+/* The sector ID of the full page the transfer in progress is from */
+static uint16_t TransferOldPageId = 0;
+
+/* The index of the next variable to move in the transfer in progress */
+static uint16_t TransferIndex = 0;
+
+/* The time the transfer in progress started waiting to erase the full page */
+static uint64_t EraseRequested = 0;
+
+/* The RAM index of the latest value of each variable */
+static uint16_t CacheData[NUM_EEPROM_ADDRESSES];
+
+/* Bit per variable, set if the variable exists and its value is in the RAM index */
+static uint32_t CacheValid[(NUM_EEPROM_ADDRESSES + 31) / 32];
+
+/* Has the RAM index been built */
+static bool CacheBuilt = FALSE;
+
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 static FLASH_Status EE_Format(void);
 static uint16_t EE_FindValidPage(uint8_t Operation);
 static uint16_t EE_VerifyPageFullWriteVariable(uint16_t VirtAddress, uint16_t Data);
 static uint16_t EE_PageTransfer(uint16_t VirtAddress, uint16_t Data);
+static uint16_t EE_StartTransfer(uint16_t VirtAddress, uint16_t Data);
+static uint16_t EE_ContinueTransfer(void);
+static void EE_StartErase(void);
+static uint16_t EE_FinishErase(void);
+static void EE_BuildCache(void);
+static void EE_CacheVariable(uint16_t VirtAddress, uint16_t Data);
 
 /**
  * @brief  Restore the pages to a known good state in case of page's status
@@ -231,6 +298,7 @@ uint16_t EE_Init(void) {
 	/* Lock the Flash Program Erase controller */
 	//FLASH_Lock();
 
+	EE_BuildCache();
 	return FLASH_COMPLETE;
 }
 
@@ -249,8 +317,35 @@ uint16_t EE_ReadVariable(uint16_t VirtAddress, uint16_t* Data) {
 	uint16_t AddressValue = 0x5555, ReadStatus = 1;
 	uint32_t Address = EEPROM_START_ADDRESS, PageStartAddress = EEPROM_START_ADDRESS;
 
-	/* Get active Page for read operation */
-	ValidPage = EE_FindValidPage(READ_FROM_VALID_PAGE );
+	/* The RAM index holds the latest value of every variable once built */
+	if ((CacheBuilt == TRUE) && (VirtAddress < NUM_EEPROM_ADDRESSES)) {
+		if ((CacheValid[VirtAddress / 32] & (1UL << (VirtAddress % 32))) == 0) {
+			return 1;
+		}
+		*Data = CacheData[VirtAddress];
+		return 0;
+	}
+
+	/* Writes which have not been programmed yet are newer than anything in FLASH, the newest first */
+	for (uint16_t i = QueueCount; i > 0; --i) {
+		const EE_Write_t* write = &WriteQueue[(QueueHead + i - 1) % EE_QUEUE_SIZE];
+		if (write->VirtAddress == VirtAddress) {
+			*Data = write->Data;
+			return 0;
+		}
+	}
+	if ((JobState != EE_JOB_IDLE) && (TransferWrite.VirtAddress == VirtAddress)) {
+		*Data = TransferWrite.Data;
+		return 0;
+	}
+
+	if ((JobState == EE_JOB_ERASE) || (JobState == EE_JOB_ERASING)) {
+		/* Every variable has been moved, and the full page is about to be erased */
+		ValidPage = (TransferPageAddress == PAGE0_BASE_ADDRESS) ? PAGE0 : PAGE1;
+	} else {
+		/* Get active Page for read operation */
+		ValidPage = EE_FindValidPage(READ_FROM_VALID_PAGE );
+	}
 
 	/* Check if there is no valid page */
 	if (ValidPage == NO_VALID_PAGE ) {
@@ -288,7 +383,9 @@ uint16_t EE_ReadVariable(uint16_t VirtAddress, uint16_t* Data) {
 }
 
 /**
- * @brief  Writes/upadtes variable data in EEPROM.
+ * @brief  Writes/upadtes variable data in EEPROM. Blocks for a page transfer
+ *   if the page is full, so EE_QueueWrite() is preferred once the program loop
+ *   runs. While the background write job is busy the write is queued instead.
  * @param  VirtAddress: Variable virtual address
  * @param  Data: 16 bit data to be written
  * @retval Success or error status:
@@ -300,6 +397,11 @@ uint16_t EE_ReadVariable(uint16_t VirtAddress, uint16_t* Data) {
 uint16_t EE_WriteVariable(uint16_t VirtAddress, uint16_t Data) {
 	uint16_t Status = 0;
 
+	/* Writing now would race the background write job, so join its queue */
+	if (EE_IsBusy() == TRUE) {
+		return EE_QueueWrite(VirtAddress, Data);
+	}
+
 	/* Write the variable virtual address and value in the EEPROM */
 	Status = EE_VerifyPageFullWriteVariable(VirtAddress, Data);
 
@@ -313,6 +415,243 @@ uint16_t EE_WriteVariable(uint16_t VirtAddress, uint16_t Data) {
 	return Status;
 }
 
+/**
+ * @brief  Queues a write of variable data in EEPROM, to be programmed by
+ *   EE_Service(). A queued write to the same variable is replaced, and reads
+ *   return the queued data until it is programmed.
+ * @param  VirtAddress: Variable virtual address
+ * @param  Data: 16 bit data to be written
+ * @retval Success or error status:
+ *           - FLASH_COMPLETE: on success
+ *           - QUEUE_FULL: if the write queue is full
+ */
+uint16_t EE_QueueWrite(uint16_t VirtAddress, uint16_t Data) {
+	for (uint16_t i = 0; i < QueueCount; ++i) {
+		EE_Write_t* write = &WriteQueue[(QueueHead + i) % EE_QUEUE_SIZE];
+		if (write->VirtAddress == VirtAddress) {
+			write->Data = Data;
+			EE_CacheVariable(VirtAddress, Data);
+			return FLASH_COMPLETE;
+		}
+	}
+	if (QueueCount >= EE_QUEUE_SIZE) {
+		return QUEUE_FULL;
+	}
+	EE_Write_t* write = &WriteQueue[(QueueHead + QueueCount) % EE_QUEUE_SIZE];
+	write->VirtAddress = VirtAddress;
+	write->Data = Data;
+	++QueueCount;
+	EE_CacheVariable(VirtAddress, Data);
+	return FLASH_COMPLETE;
+}
+
+/**
+ * @brief  Performs the next step of the background write job: programming one
+ *   queued write, moving a batch of variables during a page transfer, or
+ *   starting or completing the erase of the full page. Queued writes wait while
+ *   a page transfer is in progress, so that the transfer can not overwrite them.
+ * @param  Idle: TRUE if the erase of a full page may stall the CPU now. The erase
+ *   runs anyway once it has waited EE_ERASE_DEFER_LIMIT.
+ * @retval TRUE if there is more work ready.
+ */
+bool EE_Service(bool Idle) {
+	uint16_t Status = FLASH_COMPLETE;
+	switch (JobState) {
+	case EE_JOB_IDLE:
+		if (QueueCount == 0) {
+			return FALSE;
+		}
+		Status = EE_VerifyPageFullWriteVariable(WriteQueue[QueueHead].VirtAddress, WriteQueue[QueueHead].Data);
+		if (Status == PAGE_FULL ) {
+			Status = EE_StartTransfer(WriteQueue[QueueHead].VirtAddress, WriteQueue[QueueHead].Data);
+		}
+		/* A write which failed is dropped, rather than retried forever */
+		QueueHead = (QueueHead + 1) % EE_QUEUE_SIZE;
+		--QueueCount;
+		break;
+	case EE_JOB_TRANSFER:
+		Status = EE_ContinueTransfer();
+		break;
+	case EE_JOB_ERASE:
+		if ((Idle == FALSE) && ((GetLocalTime() - EraseRequested) < EE_ERASE_DEFER_LIMIT)) {
+			return FALSE;
+		}
+		EE_StartErase();
+		return FALSE;
+	case EE_JOB_ERASING:
+		if (FLASH_GetStatus() == FLASH_BUSY) {
+			return FALSE;
+		}
+		Status = EE_FinishErase();
+		break;
+	default:
+		JobState = EE_JOB_IDLE;
+		break;
+	}
+	if ((Status != FLASH_COMPLETE) && (JobState != EE_JOB_IDLE)) {
+		/* Abandon the transfer, EE_Init() repairs the pages on the next boot */
+		JobState = EE_JOB_IDLE;
+	}
+	return ((QueueCount > 0) || (JobState == EE_JOB_TRANSFER)) ? TRUE : FALSE;
+}
+
+/**
+ * @brief  Indicates if any queued writes or a page transfer are outstanding.
+ * @param  None
+ * @retval TRUE if the background write job has work left.
+ */
+bool EE_IsBusy(void) {
+	return ((QueueCount > 0) || (JobState != EE_JOB_IDLE)) ? TRUE : FALSE;
+}
+
+/**
+ * @brief  Starts a background page transfer, marking the other page as
+ *   receiving data and writing the variable which did not fit into it.
+ * @param  VirtAddress: 16 bit virtual address of the variable
+ * @param  Data: 16 bit data to be written as variable value
+ * @retval Success or error status:
+ *           - FLASH_COMPLETE: on success
+ *           - NO_VALID_PAGE: if no valid page was found
+ *           - Flash error code: on write Flash error
+ */
+static uint16_t EE_StartTransfer(uint16_t VirtAddress, uint16_t Data) {
+	FLASH_Status FlashStatus = FLASH_COMPLETE;
+	const uint16_t ValidPage = EE_FindValidPage(READ_FROM_VALID_PAGE );
+
+	if (ValidPage == PAGE1 ) {
+		TransferPageAddress = PAGE0_BASE_ADDRESS;
+		TransferOldPageId = PAGE1_ID;
+	} else if (ValidPage == PAGE0 ) {
+		TransferPageAddress = PAGE1_BASE_ADDRESS;
+		TransferOldPageId = PAGE0_ID;
+	} else {
+		return NO_VALID_PAGE ;
+	}
+
+	/* Set the new Page status to RECEIVE_DATA status */
+	FlashStatus = FLASH_ProgramHalfWord(TransferPageAddress, RECEIVE_DATA );
+	if (FlashStatus != FLASH_COMPLETE) {
+		return FlashStatus;
+	}
+	TransferWrite.VirtAddress = VirtAddress;
+	TransferWrite.Data = Data;
+	TransferIndex = 0;
+	JobState = EE_JOB_TRANSFER;
+
+	/* Write the variable passed as parameter in the new active page */
+	return EE_VerifyPageFullWriteVariable(VirtAddress, Data);
+}
+
+/**
+ * @brief  Moves the next batch of variables of a background page transfer to
+ *   the receiving page, then waits to erase the full page once all are moved.
+ * @param  None
+ * @retval Success or error status:
+ *           - FLASH_COMPLETE: on success
+ *           - PAGE_FULL: if valid page is full
+ *           - NO_VALID_PAGE: if no valid page was found
+ *           - Flash error code: on write Flash error
+ */
+static uint16_t EE_ContinueTransfer(void) {
+	uint16_t EepromStatus = FLASH_COMPLETE;
+	for (uint8_t moved = 0; (moved < EE_TRANSFER_BATCH) && (TransferIndex < NUM_EEPROM_ADDRESSES); ++TransferIndex) {
+		const uint16_t VirtAddress = EEPROM_ADDRESSES[TransferIndex];
+		if (VirtAddress == TransferWrite.VirtAddress) {
+			continue;
+		}
+		/* Queued writes are newer than the full page, moving them early is harmless */
+		if (EE_ReadVariable(VirtAddress, &DataVar) != 0x1) {
+			EepromStatus = EE_VerifyPageFullWriteVariable(VirtAddress, DataVar);
+			if (EepromStatus != FLASH_COMPLETE) {
+				return EepromStatus;
+			}
+			++moved;
+		}
+	}
+	if (TransferIndex >= NUM_EEPROM_ADDRESSES) {
+		EraseRequested = GetLocalTime();
+		JobState = EE_JOB_ERASE;
+	}
+	return EepromStatus;
+}
+
+/**
+ * @brief  Starts the erase of the full page of a background page transfer
+ *   without waiting for it to complete. The watchdog is reloaded first, since
+ *   the CPU may stall on FLASH fetches for the duration of the erase.
+ * @param  None
+ * @retval None
+ */
+static void EE_StartErase(void) {
+	IWDG_ReloadCounter();
+	FLASH_ClearFlag(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR );
+	FLASH->CR &= ~(FLASH_CR_PSIZE | FLASH_CR_SNB);
+	FLASH->CR |= FLASH_PSIZE_WORD | FLASH_CR_SER | TransferOldPageId;
+	FLASH->CR |= FLASH_CR_STRT;
+	JobState = EE_JOB_ERASING;
+}
+
+/**
+ * @brief  Completes a background page transfer once the erase of the full page
+ *   is done, making the receiving page the valid page.
+ * @param  None
+ * @retval Status of the erase or the final Flash write
+ */
+static uint16_t EE_FinishErase(void) {
+	FLASH->CR &= ~(FLASH_CR_SER | FLASH_CR_SNB);
+	FLASH_Status FlashStatus = FLASH_GetStatus();
+	if (FlashStatus != FLASH_COMPLETE) {
+		return FlashStatus;
+	}
+
+	/* Set new Page status to VALID_PAGE status */
+	FlashStatus = FLASH_ProgramHalfWord(TransferPageAddress, VALID_PAGE );
+	JobState = EE_JOB_IDLE;
+	return FlashStatus;
+}
+
+/**
+ * @brief  Builds the RAM index of the latest value of each variable from the
+ *   valid page. Variables are written in order, so the page is read from its
+ *   start up to the first free location and later copies replace earlier ones.
+ * @param  None
+ * @retval None
+ */
+static void EE_BuildCache(void) {
+	memset(CacheValid, 0, sizeof(CacheValid));
+	CacheBuilt = FALSE;
+
+	const uint16_t ValidPage = EE_FindValidPage(READ_FROM_VALID_PAGE );
+	if (ValidPage == NO_VALID_PAGE ) {
+		return;
+	}
+	const uint32_t PageStartAddress = (uint32_t) (EEPROM_START_ADDRESS + (uint32_t) (ValidPage * PAGE_SIZE ));
+	const uint32_t PageEndAddress = PageStartAddress + PAGE_SIZE;
+
+	/* The first word of the page holds its status */
+	for (uint32_t Address = PageStartAddress + 4; Address < PageEndAddress; Address += 4) {
+		const uint32_t Word = (*(__IO uint32_t*) Address);
+		if (Word == 0xFFFFFFFF) {
+			break;
+		}
+		EE_CacheVariable((uint16_t) (Word >> 16), (uint16_t) (Word & 0xFFFF));
+	}
+	CacheBuilt = TRUE;
+}
+
+/**
+ * @brief  Records the latest value of a variable in the RAM index.
+ * @param  VirtAddress: 16 bit virtual address of the variable
+ * @param  Data: 16 bit value of the variable
+ * @retval None
+ */
+static void EE_CacheVariable(uint16_t VirtAddress, uint16_t Data) {
+	if (VirtAddress < NUM_EEPROM_ADDRESSES) {
+		CacheData[VirtAddress] = Data;
+		CacheValid[VirtAddress / 32] |= (1UL << (VirtAddress % 32));
+	}
+}
+
 /**
  * @brief  Erases PAGE and PAGE1 and writes VALID_PAGE header to PAGE
  * @param  None
@@ -439,6 +778,9 @@ static uint16_t EE_VerifyPageFullWriteVariable(uint16_t VirtAddress, uint16_t Da
 			}
 			/* Set variable virtual address */
 			FlashStatus = FLASH_ProgramHalfWord(Address + 2, VirtAddress);
+			if (FlashStatus == FLASH_COMPLETE) {
+				EE_CacheVariable(VirtAddress, Data);
+			}
 			/* Return program operation status */
 			return FlashStatus;
 		} else {
@@ -41,17 +41,38 @@
 
 #include "lwip/opt.h"
 #include "lwip/mem.h"
+#include "lwip/stats.h"
 #include "netif/etharp.h"
 #include "ethernetif.h"
 #include "stm32f4x7_eth.h"
 #include "stm32f4xx.h"
 #include "Tekdaqc_BSP.h"
+#include "Tekdaqc_Scheduler.h"
 #include <string.h>
 
 /* Network interface name */
 #define IFNAME0 's'
 #define IFNAME1 't'
 
+/* The most Rx DMA buffers which may be lent to lwIP at once. The rest are kept
+ * for the DMA so that reception never stalls while lwIP holds on to frames,
+ * for example while TCP queues out of sequence segments; frames received when
+ * this many are lent are copied to PBUF_POOL pbufs instead. */
+#define ETH_RX_LENT_BUFFERS (ETH_RXBUFNB / 2)
+
+/* With checksum offload lwIP must not also compute the checksums in software,
+ * or every segment is summed twice on the data path */
+#if defined(CHECKSUM_BY_HARDWARE) && (CHECKSUM_GEN_IP || CHECKSUM_GEN_UDP || CHECKSUM_GEN_TCP \
+    || CHECKSUM_GEN_ICMP || CHECKSUM_CHECK_IP || CHECKSUM_CHECK_UDP || CHECKSUM_CHECK_TCP || LWIP_CHECKSUM_ON_COPY)
+#error "CHECKSUM_BY_HARDWARE is defined but lwIP is configured to compute checksums in software."
+#endif
+
+/* A custom pbuf referring to a received frame in place in its Rx DMA buffer */
+typedef struct
+{
+  struct pbuf_custom pbuf;                 /* The pbuf handed to lwIP */
+  __IO ETH_DMADESCTypeDef *descriptor;     /* The descriptor of the buffer, NULL while unused */
+} RxPbuf_t;
 
 /* Ethernet Rx & Tx DMA Descriptors */
 extern ETH_DMADESCTypeDef  DMARxDscrTab[ETH_RXBUFNB], DMATxDscrTab[ETH_TXBUFNB];
@@ -69,6 +90,181 @@ extern ETH_DMADESCTypeDef  *DMARxDescToGet;
 /* Global pointer for last received frame infos */
 extern ETH_DMA_Rx_Frame_infos *DMA_RX_FRAME_infos;
 
+/* The custom pbufs of the Rx DMA buffers lent to lwIP */
+static RxPbuf_t RxPbufs[ETH_RX_LENT_BUFFERS];
+
+/* The number of Rx DMA buffers currently lent to lwIP */
+static uint32_t RxPbufsLent = 0;
+
+/* Set by the DMA interrupt when frames may be waiting to be read. Starts set
+ * so that any frame received before the interrupt was enabled is read. */
+static volatile u32_t RxPending = 1;
+
+/* The receive drop counters */
+static ethernetif_rx_stats_t RxStats;
+
+/* The transmit drop counters */
+static ethernetif_tx_stats_t TxStats;
+
+/* The result of the checksum offload verification made at start up */
+static ethernetif_checksum_t ChecksumOffload = ETHERNETIF_CHECKSUM_SOFTWARE;
+
+/* The frames transmitted straight from their pbufs, held until the DMA is done
+ * with them. Each is stored at the index of the last descriptor of its frame. */
+static struct pbuf *TxPbufs[ETH_TXBUFNB];
+
+/* The raw frames transmitted in place by ethernetif_output_raw(), stored at
+ * the index of their descriptor until the DMA is done with them */
+static const u8_t *TxRawFrames[ETH_TXBUFNB];
+
+/**
+ * Gives a received frame's descriptors back to the DMA and resumes
+ * reception if it had stopped for want of a buffer.
+ *
+ * @param descriptor the first descriptor of the frame
+ * @param count the number of descriptors the frame used
+ */
+static void release_rx_descriptors(__IO ETH_DMADESCTypeDef *descriptor, uint32_t count)
+{
+  uint32_t i;
+
+  /* Set Own bit in Rx descriptors: gives the buffers back to DMA */
+  for (i=0; i<count; i++)
+  {
+    descriptor->Status = ETH_DMARxDesc_OWN;
+    descriptor = (ETH_DMADESCTypeDef *)(descriptor->Buffer2NextDescAddr);
+  }
+
+  /* Resume DMA reception in case it was suspended for want of a buffer. The
+   * Rx buffer unavailable flag can not be relied on, since the DMA interrupt
+   * clears it, and a poll demand is harmless while reception is running. */
+  ETH->DMASR = ETH_DMASR_RBUS;
+  ETH->DMARPDR = 0;
+}
+
+/**
+ * Called by pbuf_free() once lwIP is done with a frame received in place,
+ * giving its buffer back to the DMA.
+ *
+ * @param p the custom pbuf of the frame
+ */
+static void rx_pbuf_free(struct pbuf *p)
+{
+  RxPbuf_t *rx = (RxPbuf_t *)p;
+
+  release_rx_descriptors(rx->descriptor, 1);
+  rx->descriptor = NULL;
+  RxPbufsLent--;
+}
+
+/**
+ * Wraps a single buffer frame in a custom pbuf referring to its Rx DMA
+ * buffer, so that it can be handed to lwIP without being copied.
+ *
+ * @param frame the received frame
+ * @return the pbuf, or NULL if no more buffers may be lent
+ */
+static struct pbuf *lend_rx_buffer(FrameTypeDef *frame)
+{
+  uint32_t i;
+
+  if (RxPbufsLent >= ETH_RX_LENT_BUFFERS)
+  {
+    return NULL;
+  }
+  for (i=0; i<ETH_RX_LENT_BUFFERS; i++)
+  {
+    if (RxPbufs[i].descriptor == NULL)
+    {
+      RxPbufs[i].pbuf.custom_free_function = rx_pbuf_free;
+      RxPbufs[i].descriptor = frame->descriptor;
+      RxPbufsLent++;
+      return pbuf_alloced_custom(PBUF_RAW, frame->length, PBUF_REF, &RxPbufs[i].pbuf,
+                                 (void *)frame->buffer, ETH_RX_BUF_SIZE);
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Checks if the next Rx DMA buffer is still lent to lwIP. While it is, its
+ * descriptor still holds the status of the frame it was lent with.
+ *
+ * @return 1 if the buffer is lent, 0 otherwise
+ */
+static u32_t next_rx_buffer_lent(void)
+{
+  uint32_t i;
+
+  for (i=0; (i<ETH_RX_LENT_BUFFERS) && (RxPbufsLent > 0); i++)
+  {
+    if (RxPbufs[i].descriptor == DMARxDescToGet)
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+#ifdef CHECKSUM_BY_HARDWARE
+/**
+ * Verifies that the checksums are inserted and checked by the MAC: every Tx
+ * descriptor must request full TCP/UDP/ICMP and IPv4 header checksum
+ * insertion, the MAC checksum offload must be on and both DMA FIFOs must be
+ * in store and forward mode, which the MAC needs to sum a whole frame before
+ * sending or accepting it. Anything missing is restored. Must be called
+ * before any frame is transmitted, while the DMA owns no Tx descriptor.
+ *
+ * @return ETHERNETIF_CHECKSUM_VERIFIED if everything was configured
+ *         ETHERNETIF_CHECKSUM_REPAIRED if part of it had to be restored
+ *         ETHERNETIF_CHECKSUM_FAILED if it could not be restored
+ */
+static ethernetif_checksum_t verify_checksum_offload(void)
+{
+  const uint32_t omr = ETH_DMAOMR_TSF | ETH_DMAOMR_RSF;
+  u32_t repaired = 0;
+  u32_t failed = 0;
+  int i;
+
+  for (i = 0; i < ETH_TXBUFNB; i++)
+  {
+    if ((DMATxDscrTab[i].Status & ETH_DMATxDesc_CIC) != ETH_DMATxDesc_ChecksumTCPUDPICMPFull)
+    {
+      ETH_DMATxDescChecksumInsertionConfig(&DMATxDscrTab[i], ETH_DMATxDesc_ChecksumTCPUDPICMPFull);
+      repaired++;
+      if ((DMATxDscrTab[i].Status & ETH_DMATxDesc_CIC) != ETH_DMATxDesc_ChecksumTCPUDPICMPFull)
+      {
+        failed++;
+      }
+    }
+  }
+  if ((ETH->MACCR & ETH_MACCR_IPCO) == 0)
+  {
+    ETH->MACCR |= ETH_MACCR_IPCO;
+    repaired++;
+    if ((ETH->MACCR & ETH_MACCR_IPCO) == 0)
+    {
+      failed++;
+    }
+  }
+  if ((ETH->DMAOMR & omr) != omr)
+  {
+    ETH->DMAOMR |= omr;
+    repaired++;
+    if ((ETH->DMAOMR & omr) != omr)
+    {
+      failed++;
+    }
+  }
+
+  if (failed != 0)
+  {
+    return ETHERNETIF_CHECKSUM_FAILED;
+  }
+  return (repaired != 0) ? ETHERNETIF_CHECKSUM_REPAIRED : ETHERNETIF_CHECKSUM_VERIFIED;
+}
+#endif
+
 /**
  * In this function, the hardware should be initialized.
  * Called from ethernetif_init().
@@ -120,6 +316,115 @@ static void low_level_init(struct netif *netif)
   /* Enable MAC and DMA transmission and reception */
   ETH_Start();
 
+#ifdef CHECKSUM_BY_HARDWARE
+  ChecksumOffload = verify_checksum_offload();
+#endif
+}
+
+/**
+ * Points a Tx descriptor back at its own DMA buffer, which it may have been
+ * pointed away from to transmit a pbuf in place.
+ *
+ * @param descriptor the Tx descriptor
+ * @return the DMA buffer of the descriptor
+ */
+static u8 *tx_own_buffer(__IO ETH_DMADESCTypeDef *descriptor)
+{
+  u8 *buffer = Tx_Buff[(ETH_DMADESCTypeDef *)descriptor - DMATxDscrTab];
+
+  descriptor->Buffer1Addr = (uint32_t)buffer;
+  return buffer;
+}
+
+/**
+ * Transmits a pbuf chain by giving the DMA a descriptor for each of its pbufs.
+ * The first pbuf, which holds the headers, is copied to its descriptor's own
+ * buffer: it is small, and lwIP rewrites the headers of a TCP segment when it
+ * retransmits it. The following pbufs are transmitted in place and the frame is
+ * held until the DMA is done with it.
+ *
+ * @param p the MAC packet to send
+ * @return ERR_OK if the packet was handed to the DMA
+ *         ERR_BUF if it must be copied instead, as for a single pbuf, or when
+ *         there are not enough free descriptors
+ */
+static err_t low_level_output_chain(struct pbuf *p)
+{
+  __IO ETH_DMADESCTypeDef *DmaTxDesc;
+  __IO ETH_DMADESCTypeDef *lastDesc;
+  struct pbuf *q;
+  uint32_t count = 1;
+  uint32_t i;
+
+  if ((p->next == NULL) || (p->len > ETH_TX_BUF_SIZE))
+  {
+    return ERR_BUF;
+  }
+
+  /* Check that there is a free descriptor for the headers and each non empty pbuf */
+  for (q = p->next; q != NULL; q = q->next)
+  {
+    if (q->len != 0)
+    {
+      count++;
+    }
+  }
+  if (count > ETH_TXBUFNB)
+  {
+    return ERR_BUF;
+  }
+  DmaTxDesc = DMATxDescToSet;
+  for (i=0; i<count; i++)
+  {
+    if (((DmaTxDesc->Status & ETH_DMATxDesc_OWN) != (u32)RESET)
+        || (TxPbufs[(ETH_DMADESCTypeDef *)DmaTxDesc - DMATxDscrTab] != NULL))
+    {
+      return ERR_BUF;
+    }
+    DmaTxDesc = (ETH_DMADESCTypeDef *)(DmaTxDesc->Buffer2NextDescAddr);
+  }
+
+  /* Copy the headers into the first descriptor's buffer */
+  DmaTxDesc = DMATxDescToSet;
+  memcpy(tx_own_buffer(DmaTxDesc), p->payload, p->len);
+  DmaTxDesc->ControlBufferSize = (p->len & ETH_DMATxDesc_TBS1);
+  DmaTxDesc->Status &= ~(ETH_DMATxDesc_FS | ETH_DMATxDesc_LS);
+  DmaTxDesc->Status |= ETH_DMATxDesc_FS;
+  lastDesc = DmaTxDesc;
+
+  /* Point the following descriptors at the payloads. The DMA does not look at
+   * them before the first one is given to it. */
+  for (q = p->next; q != NULL; q = q->next)
+  {
+    if (q->len != 0)
+    {
+      DmaTxDesc = (ETH_DMADESCTypeDef *)(DmaTxDesc->Buffer2NextDescAddr);
+      DmaTxDesc->Buffer1Addr = (uint32_t)q->payload;
+      DmaTxDesc->ControlBufferSize = (q->len & ETH_DMATxDesc_TBS1);
+      DmaTxDesc->Status &= ~(ETH_DMATxDesc_FS | ETH_DMATxDesc_LS);
+      DmaTxDesc->Status |= ETH_DMATxDesc_OWN;
+      lastDesc = DmaTxDesc;
+    }
+  }
+  lastDesc->Status |= ETH_DMATxDesc_LS;
+
+  /* Hold the frame until the DMA is done with its last descriptor */
+  pbuf_ref(p);
+  TxPbufs[(ETH_DMADESCTypeDef *)lastDesc - DMATxDscrTab] = p;
+
+  /* Set Own bit of the first Tx descriptor: gives the frame to ETHERNET DMA */
+  DMATxDescToSet->Status |= ETH_DMATxDesc_OWN;
+  DMATxDescToSet = (ETH_DMADESCTypeDef *)(lastDesc->Buffer2NextDescAddr);
+
+  /* When Tx Buffer unavailable flag is set: clear it and resume transmission */
+  if ((ETH->DMASR & ETH_DMASR_TBUS) != (u32)RESET)
+  {
+    /* Clear TBUS ETHERNET DMA flag */
+    ETH->DMASR = ETH_DMASR_TBUS;
+    /* Resume DMA transmission*/
+    ETH->DMATPDR = 0;
+  }
+  return ERR_OK;
 }
 
 /**
@@ -142,24 +447,45 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p)
 {
   err_t errval;
   struct pbuf *q;
-  u8 *buffer =  (u8 *)(DMATxDescToSet->Buffer1Addr);
+  u8 *buffer;
   __IO ETH_DMADESCTypeDef *DmaTxDesc;
   uint16_t framelength = 0;
   uint32_t bufferoffset = 0;
   uint32_t byteslefttocopy = 0;
   uint32_t payloadoffset = 0;
 
+  /* Free the frames the DMA is done with, then try to send this one in place */
+  ethernetif_release_tx();
+  errval = low_level_output_chain(p);
+  if (errval == ERR_OK)
+  {
+    LINK_STATS_INC(link.xmit);
+    goto resume;
+  }
+
+  /* A descriptor the DMA still owns may be pointed at a frame sent in place,
+   * so it must not be pointed back at its own buffer yet */
   DmaTxDesc = DMATxDescToSet;
+  if((DmaTxDesc->Status & ETH_DMATxDesc_OWN) != (u32)RESET)
+  {
+    TxStats.no_descriptor++;
+    LINK_STATS_INC(link.drop);
+    errval = ERR_BUF;
+    goto resume;
+  }
+  buffer = tx_own_buffer(DmaTxDesc);
   bufferoffset = 0;
 
   /* copy frame from pbufs to driver buffers */
   for(q = p; q != NULL; q = q->next)
     {
-      /* Is this buffer available? If not, goto error */
+      /* Is this buffer available? If not, give up */
       if((DmaTxDesc->Status & ETH_DMATxDesc_OWN) != (u32)RESET)
       {
+        TxStats.no_descriptor++;
+        LINK_STATS_INC(link.drop);
         errval = ERR_BUF;
-        goto error;
+        goto resume;
       }
 
       /* Get bytes in current lwIP buffer */
@@ -178,11 +504,13 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p)
         /* Check if the buffer is available */
         if((DmaTxDesc->Status & ETH_DMATxDesc_OWN) != (u32)RESET)
         {
+          TxStats.no_descriptor++;
+          LINK_STATS_INC(link.drop);
           errval = ERR_USE;
-          goto error;
+          goto resume;
         }
 
-        buffer = (u8 *)(DmaTxDesc->Buffer1Addr);
+        buffer = tx_own_buffer(DmaTxDesc);
 
         byteslefttocopy = byteslefttocopy - (ETH_TX_BUF_SIZE - bufferoffset);
         payloadoffset = payloadoffset + (ETH_TX_BUF_SIZE - bufferoffset);
@@ -202,9 +530,10 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p)
   /* Prepare transmit descriptors to give to DMA*/ 
   ETH_Prepare_Transmit_Descriptors(framelength);
 
+  LINK_STATS_INC(link.xmit);
   errval = ERR_OK;
 
-error:
+resume:
   
   /* When Transmit Underflow flag is set, clear it and issue a Transmit Poll Demand to resume transmission */
   if ((ETH->DMASR & ETH_DMASR_TUS) != (uint32_t)RESET)
@@ -220,7 +549,9 @@ error:
 
 /**
  * Should allocate a pbuf and transfer the bytes of the incoming
- * packet from the interface into the pbuf.
+ * packet from the interface into the pbuf. A frame in a single Rx DMA buffer
+ * is handed over in place, its buffer going back to the DMA when lwIP frees
+ * it, as long as not too many buffers are lent already.
  *
  * @param netif the lwip network interface structure for this ethernetif
  * @return a pbuf filled with the received packet (including MAC header)
@@ -236,7 +567,6 @@ static struct pbuf * low_level_input(struct netif *netif)
   uint32_t bufferoffset = 0;
   uint32_t payloadoffset = 0;
   uint32_t byteslefttocopy = 0;
-  uint32_t i=0;  
   
   /* get received frame */
   frame = ETH_Get_Received_Frame();
@@ -244,6 +574,19 @@ static struct pbuf * low_level_input(struct netif *netif)
   /* Obtain the size of the packet and put it into the "len" variable. */
   len = frame.length;
   buffer = (u8 *)frame.buffer;
+
+  /* Hand a single buffer frame over without copying it */
+  if (DMA_RX_FRAME_infos->Seg_Count == 1)
+  {
+    p = lend_rx_buffer(&frame);
+    if (p != NULL)
+    {
+      /* Clear Segment_Count */
+      DMA_RX_FRAME_infos->Seg_Count =0;
+      LINK_STATS_INC(link.recv);
+      return p;
+    }
+  }
   
   /* We allocate a pbuf chain of pbufs from the Lwip buffer pool */
   p = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
@@ -275,30 +618,204 @@ static struct pbuf * low_level_input(struct netif *netif)
       memcpy( (u8_t*)((u8_t*)q->payload + payloadoffset), (u8_t*)((u8_t*)buffer + bufferoffset), byteslefttocopy);
       bufferoffset = bufferoffset + byteslefttocopy;
     }
+    LINK_STATS_INC(link.recv);
+  }
+  else
+  {
+    /* The frame is dropped, there is no pool buffer to copy it into */
+    RxStats.no_pbuf++;
+    LINK_STATS_INC(link.memerr);
+    LINK_STATS_INC(link.drop);
   }
   
   /* Release descriptors to DMA */
-  DMARxDesc =frame.descriptor;
-
-  /* Set Own bit in Rx descriptors: gives the buffers back to DMA */
-  for (i=0; i<DMA_RX_FRAME_infos->Seg_Count; i++)
-  {  
-    DMARxDesc->Status = ETH_DMARxDesc_OWN;
-    DMARxDesc = (ETH_DMADESCTypeDef *)(DMARxDesc->Buffer2NextDescAddr);
-  }
+  release_rx_descriptors(frame.descriptor, DMA_RX_FRAME_infos->Seg_Count);
   
   /* Clear Segment_Count */
   DMA_RX_FRAME_infos->Seg_Count =0;
-  
-  /* When Rx Buffer unavailable flag is set: clear it and resume reception */
-  if ((ETH->DMASR & ETH_DMASR_RBUS) != (u32)RESET)  
+  return p;
+}
+
+/**
+ * Frees the frames transmitted in place which the DMA is done with. The DMA
+ * clears the Own bits of a frame's descriptors in order, so the frame is done
+ * once its last descriptor is clear.
+ */
+void ethernetif_release_tx(void)
+{
+  uint32_t i;
+
+  for (i=0; i<ETH_TXBUFNB; i++)
+  {
+    if ((TxPbufs[i] != NULL) && ((DMATxDscrTab[i].Status & ETH_DMATxDesc_OWN) == (u32)RESET))
+    {
+      pbuf_free(TxPbufs[i]);
+      TxPbufs[i] = NULL;
+    }
+    if ((TxRawFrames[i] != NULL) && ((DMATxDscrTab[i].Status & ETH_DMATxDesc_OWN) == (u32)RESET))
+    {
+      TxRawFrames[i] = NULL;
+    }
+  }
+}
+
+/**
+ * Transmits a complete Ethernet frame, headers included, straight from the
+ * caller's buffer without passing through lwIP. The frame is given to the DMA
+ * in place in a single descriptor, so the buffer must be in SRAM, not CCM or
+ * FLASH, and must not be changed until ethernetif_raw_frame_busy() says the
+ * DMA is done with it. The MAC appends the CRC and pads short frames.
+ *
+ * @param frame the frame, starting with the destination address
+ * @param length the length of the frame, at most ETH_TX_BUF_SIZE
+ * @return ERR_OK if the frame was handed to the DMA
+ *         ERR_BUF if no descriptor is free right now, the frame may be retried
+ *         ERR_VAL if the frame is too long
+ */
+err_t ethernetif_output_raw(const u8_t *frame, u16_t length)
+{
+  __IO ETH_DMADESCTypeDef *DmaTxDesc = DMATxDescToSet;
+  uint32_t index;
+
+  if (length > ETH_TX_BUF_SIZE)
   {
-    /* Clear RBUS ETHERNET DMA flag */
-    ETH->DMASR = ETH_DMASR_RBUS;
-    /* Resume DMA reception */
-    ETH->DMARPDR = 0;
+    return ERR_VAL;
   }
-  return p;
+  ethernetif_release_tx();
+  index = (ETH_DMADESCTypeDef *)DmaTxDesc - DMATxDscrTab;
+  if (((DmaTxDesc->Status & ETH_DMATxDesc_OWN) != (u32)RESET) || (TxPbufs[index] != NULL))
+  {
+    return ERR_BUF;
+  }
+
+  DmaTxDesc->Buffer1Addr = (uint32_t)frame;
+  DmaTxDesc->ControlBufferSize = (length & ETH_DMATxDesc_TBS1);
+  DmaTxDesc->Status |= ETH_DMATxDesc_FS | ETH_DMATxDesc_LS;
+  TxRawFrames[index] = frame;
+
+  /* Set Own bit of the Tx descriptor: gives the frame to ETHERNET DMA */
+  DmaTxDesc->Status |= ETH_DMATxDesc_OWN;
+  DMATxDescToSet = (ETH_DMADESCTypeDef *)(DmaTxDesc->Buffer2NextDescAddr);
+  LINK_STATS_INC(link.xmit);
+
+  /* When Tx Buffer unavailable flag is set: clear it and resume transmission */
+  if ((ETH->DMASR & ETH_DMASR_TBUS) != (u32)RESET)
+  {
+    /* Clear TBUS ETHERNET DMA flag */
+    ETH->DMASR = ETH_DMASR_TBUS;
+    /* Resume DMA transmission*/
+    ETH->DMATPDR = 0;
+  }
+  return ERR_OK;
+}
+
+/**
+ * Checks if the DMA is still transmitting a frame handed to it by
+ * ethernetif_output_raw().
+ *
+ * @param frame the frame
+ * @return 1 if the frame's buffer is still in use, 0 if it may be reused
+ */
+u32_t ethernetif_raw_frame_busy(const u8_t *frame)
+{
+  uint32_t i;
+
+  ethernetif_release_tx();
+  for (i=0; i<ETH_TXBUFNB; i++)
+  {
+    if (TxRawFrames[i] == frame)
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * Checks if a received frame is ready to be read from the interface. This
+ * must be used instead of ETH_CheckFrameReceived(), which would take the
+ * descriptor of a buffer still lent to lwIP for a new frame. The descriptors
+ * are only looked at once the DMA interrupt has flagged a frame, and until
+ * no more are found.
+ *
+ * @return 1 if a frame is ready, 0 otherwise
+ */
+u32_t ethernetif_frame_received(void)
+{
+  if ((RxPending == 0) || next_rx_buffer_lent())
+  {
+    return 0;
+  }
+
+  /* Clear the flag before looking, so that a frame completing meanwhile sets it again */
+  RxPending = 0;
+  if (ETH_CheckFrameReceived())
+  {
+    /* There may be more frames behind this one */
+    RxPending = 1;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * Handles the Ethernet DMA interrupt. lwIP can not be called from an
+ * interrupt, so this only flags that frames are waiting and asks the
+ * scheduler for a new pass, so that the network receive task reads them
+ * promptly.
+ */
+void ethernetif_irq_handler(void)
+{
+  if (ETH_GetDMAITStatus(ETH_DMA_IT_R) != RESET)
+  {
+    RxPending = 1;
+    ETH_DMAClearITPendingBit(ETH_DMA_IT_R);
+  }
+  if (ETH_GetDMAITStatus(ETH_DMA_IT_RBU) != RESET)
+  {
+    /* Every descriptor holds a frame not yet read, or is lent to lwIP */
+    RxPending = 1;
+    RxStats.buffer_unavailable++;
+    ETH_DMAClearITPendingBit(ETH_DMA_IT_RBU);
+  }
+  ETH_DMAClearITPendingBit(ETH_DMA_IT_NIS | ETH_DMA_IT_AIS);
+  Scheduler_RequestPass();
+}
+
+/**
+ * Retrieves the receive drop counters, accumulating the missed frame counts
+ * of the DMA, which clear when read.
+ *
+ * @param stats filled with the counters since start up
+ */
+void ethernetif_get_rx_stats(ethernetif_rx_stats_t *stats)
+{
+  uint32_t missed = ETH->DMAMFBOCR;
+
+  RxStats.missed_no_buffer += (missed & ETH_DMAMFBOCR_MFC);
+  RxStats.missed_overflow += ((missed & ETH_DMAMFBOCR_MFA) >> ETH_DMA_RX_OVERFLOW_MISSEDFRAMES_COUNTERSHIFT);
+  *stats = RxStats;
+}
+
+/**
+ * Retrieves the transmit drop counters.
+ *
+ * @param stats filled with the counters since start up
+ */
+void ethernetif_get_tx_stats(ethernetif_tx_stats_t *stats)
+{
+  *stats = TxStats;
+}
+
+/**
+ * Retrieves the result of the checksum offload verification made when the
+ * interface was initialized.
+ *
+ * @return the checksum offload state
+ */
+ethernetif_checksum_t ethernetif_get_checksum_offload(void)
+{
+  return ChecksumOffload;
 }
 
 /**
@@ -39,11 +39,15 @@
 #include "lwip/tcp.h"
 #include "lwip/tcp_impl.h"
 #include "lwip/udp.h"
+#include "lwip/sys.h"
 #include "netif/etharp.h"
 #include "lwip/dhcp.h"
 #include "ethernetif.h"
 #include "netconf.h"
 #include "Tekdaqc_Locator.h"
+#include "Tekdaqc_Profile.h"
+#include "Tekdaqc_Timers.h"
+#include "eeprom.h"
 
 #ifdef PRINTF_OUTPUT
 #include <stdio.h>
@@ -52,23 +56,500 @@
 /* Private typedef -----------------------------------------------------------*/
 #define MAX_DHCP_TRIES        4
 
+/* A host whose ARP entry is kept resolved */
+typedef struct {
+	ip_addr_t address; /* The host's address, 0 if the slot is free */
+	bool isStatic; /* TRUE once the host's entry has been made static */
+} PinnedHost_t;
+
 /* Private define ------------------------------------------------------------*/
+/* The marker words of the saved static address and DHCP lease, changed whenever their layout changes */
+#define NETWORK_STATIC_MARKER ((uint16_t) 0x5A71)
+#define NETWORK_LEASE_MARKER  ((uint16_t) 0x1EA5)
+
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 struct netif gnetif;
-uint64_t TCPTimer = 0U;
-uint64_t ARPTimer = 0U;
+uint32_t TCPTimer = 0U;
+uint32_t ARPTimer = 0U;
 uint64_t IPaddress = 0U;
 
+/* Set once the earliest lwIP timer is due, all timers are checked on the first call */
+static bool TimersDue = true;
+
+/* The hosts whose ARP entries are kept resolved, the first is always the gateway */
+static PinnedHost_t PinnedHosts[LWIP_PINNED_HOSTS + 1U];
+
+/* The local time the link last went down and came up */
+static uint64_t LinkDownTime = 0U;
+static uint64_t LinkUpTime = 0U;
+
+/* Set from the link coming back up until sample data next flows */
+static bool LinkRecovering = false;
+
+/* The number of times the link has gone down, and the time data took to flow again after the last (us) */
+static uint32_t LinkDowns = 0U;
+static uint32_t LinkRecoveryTime = 0U;
+
+/* The keepalive and stall timeout of the server connections, see LwIP_SetKeepalive() */
+static uint32_t KeepaliveIdle = LWIP_KEEPALIVE_IDLE_DEFAULT_MS;
+static uint32_t KeepaliveInterval = LWIP_KEEPALIVE_INTERVAL_DEFAULT_MS;
+static uint32_t KeepaliveCount = LWIP_KEEPALIVE_COUNT_DEFAULT;
+static uint32_t StallTimeout = LWIP_STALL_TIMEOUT_DEFAULT_MS;
+
 #ifdef USE_DHCP
 uint32_t DHCPfineTimer = 0U;
 uint32_t DHCPcoarseTimer = 0U;
 __IO uint8_t DHCP_state;
+
+/* Set when the interface came up on the saved lease, which DHCP is confirming */
+static bool LeaseReused = false;
 #endif
 extern __IO uint32_t EthStatus;
 
 /* Private functions ---------------------------------------------------------*/
 void LwIP_DHCP_Process_Handle(void);
+static void LwIP_TimersDue(void);
+static uint32_t LwIP_TimerRemaining(uint32_t last, uint32_t interval, uint32_t time, uint32_t next);
+static bool LwIP_WriteWord(uint16_t address, uint16_t value);
+static uint16_t LwIP_ReadWord(uint16_t address);
+static bool LwIP_WriteAddresses(uint16_t address, const ip_addr_t *ipaddr, const ip_addr_t *netmask,
+		const ip_addr_t *gw);
+static void LwIP_ReadAddresses(uint16_t address, ip_addr_t *ipaddr, ip_addr_t *netmask, ip_addr_t *gw);
+static void LwIP_ResolvePinnedHost(PinnedHost_t *host);
+static void LwIP_ReleasePinnedHost(PinnedHost_t *host);
+static void LwIP_RefreshConnections(bool retransmit);
+
+/**
+ * @brief  Called from the program loop once the earliest lwIP timer is due
+ * @param  None
+ * @retval None
+ */
+static void LwIP_TimersDue(void) {
+	TimersDue = true;
+}
+
+/**
+ * @brief  Finds the earliest time until a timer is next due
+ * @param  last the time in ms the timer last ran
+ * @param  interval the period of the timer in ms
+ * @param  time the current time in ms
+ * @param  next the time in ms until the earliest other timer is due
+ * @retval The time in ms until the earliest of the timers is due
+ */
+static uint32_t LwIP_TimerRemaining(uint32_t last, uint32_t interval, uint32_t time, uint32_t next) {
+	const uint32_t remaining = interval - (time - last);
+	return (remaining < next) ? remaining : next;
+}
+
+/**
+ * @brief  Writes a word of the saved network addresses, skipping the write if
+ *         it is unchanged so a lease renewed at the same address does not wear
+ *         the FLASH
+ * @param  address the virtual address of the word
+ * @param  value the value to write
+ * @retval TRUE if the word holds the value
+ */
+static bool LwIP_WriteWord(uint16_t address, uint16_t value) {
+	uint16_t current = 0U;
+	if ((EE_ReadVariable(address, &current) == 0U) && (current == value)) {
+		return TRUE;
+	}
+	return (EE_QueueWrite(address, value) == FLASH_COMPLETE) ? TRUE : FALSE;
+}
+
+/**
+ * @brief  Reads a word of the saved network addresses
+ * @param  address the virtual address of the word
+ * @retval The value of the word, 0 if it has never been written
+ */
+static uint16_t LwIP_ReadWord(uint16_t address) {
+	uint16_t value = 0U;
+	if (EE_ReadVariable(address, &value) != 0U) {
+		value = 0U;
+	}
+	return value;
+}
+
+/**
+ * @brief  Writes an address, netmask and gateway as six words, low word first
+ * @param  address the virtual address of the first word
+ * @param  ipaddr the IP address
+ * @param  netmask the netmask
+ * @param  gw the gateway
+ * @retval TRUE if all of the words were written
+ */
+static bool LwIP_WriteAddresses(uint16_t address, const ip_addr_t *ipaddr, const ip_addr_t *netmask,
+		const ip_addr_t *gw) {
+	const uint32_t values[3] = { ip4_addr_get_u32(ipaddr), ip4_addr_get_u32(netmask), ip4_addr_get_u32(gw) };
+	for (uint_fast8_t i = 0U; i < 3U; ++i) {
+		if ((LwIP_WriteWord(address, (uint16_t) values[i]) == FALSE)
+				|| (LwIP_WriteWord(address + 1U, (uint16_t) (values[i] >> 16)) == FALSE)) {
+			return FALSE;
+		}
+		address += 2U;
+	}
+	return TRUE;
+}
+
+/**
+ * @brief  Reads an address, netmask and gateway written by LwIP_WriteAddresses()
+ * @param  address the virtual address of the first word
+ * @param  ipaddr filled with the IP address
+ * @param  netmask filled with the netmask
+ * @param  gw filled with the gateway
+ * @retval None
+ */
+static void LwIP_ReadAddresses(uint16_t address, ip_addr_t *ipaddr, ip_addr_t *netmask, ip_addr_t *gw) {
+	ip_addr_t *values[3] = { ipaddr, netmask, gw };
+	for (uint_fast8_t i = 0U; i < 3U; ++i) {
+		ip4_addr_set_u32(values[i], ((uint32_t) LwIP_ReadWord(address + 1U) << 16) | LwIP_ReadWord(address));
+		address += 2U;
+	}
+}
+
+/**
+ * @brief  Keeps a pinned host resolved. Once its entry is known it is made
+ *         static, so it never expires and no packet to the host waits on ARP
+ *         again until the link or the address changes. Until then a request
+ *         is sent. Hosts off the subnet are reached through the gateway and
+ *         are skipped.
+ * @param  host the pinned host
+ * @retval None
+ */
+static void LwIP_ResolvePinnedHost(PinnedHost_t *host) {
+	struct eth_addr *ethaddr = NULL;
+	ip_addr_t *ipaddr = NULL;
+
+	if ((ip_addr_isany(&host->address)) || (host->isStatic == TRUE) || (netif_is_up(&gnetif) == 0U)
+			|| (netif_is_link_up(&gnetif) == 0U) || (ip_addr_isany(&gnetif.ip_addr))
+			|| (!ip_addr_netcmp(&host->address, &gnetif.ip_addr, &gnetif.netmask))) {
+		return;
+	}
+	if (etharp_find_addr(&gnetif, &host->address, &ethaddr, &ipaddr) >= 0) {
+		/* The table entry is reused by the static one, so the hardware address is copied first */
+		struct eth_addr resolved = *ethaddr;
+		host->isStatic = (etharp_add_static_entry(&host->address, &resolved) == ERR_OK) ? TRUE : FALSE;
+	} else {
+		etharp_request(&gnetif, &host->address);
+	}
+}
+
+/**
+ * @brief  Returns the entry of a pinned host to ARP, so that it is resolved
+ *         again before it is next made static
+ * @param  host the pinned host
+ * @retval None
+ */
+static void LwIP_ReleasePinnedHost(PinnedHost_t *host) {
+	if (host->isStatic == TRUE) {
+		etharp_remove_static_entry(&host->address);
+		host->isStatic = FALSE;
+	}
+}
+
+/**
+ * @brief  Pins the ARP entry of a host packets are sent to without it
+ *         having spoken first, such as a publishing destination. The host is
+ *         resolved at once and whenever the link comes up, and its entry
+ *         never expires. Pinning a pinned host does nothing.
+ * @param  ipaddr the host's unicast address
+ * @retval TRUE if the host is pinned, FALSE if the address is not unicast
+ *         or the pinned hosts are full
+ */
+bool LwIP_PinHost(const ip_addr_t *ipaddr) {
+	PinnedHost_t *slot = NULL;
+
+	if ((ip_addr_isany(ipaddr)) || (ip_addr_ismulticast(ipaddr))) {
+		return FALSE;
+	}
+	for (uint_fast8_t i = 1U; i <= LWIP_PINNED_HOSTS; ++i) {
+		if (ip_addr_cmp(&PinnedHosts[i].address, ipaddr)) {
+			return TRUE;
+		}
+		if ((slot == NULL) && (ip_addr_isany(&PinnedHosts[i].address))) {
+			slot = &PinnedHosts[i];
+		}
+	}
+	if (slot == NULL) {
+		return FALSE;
+	}
+	ip_addr_copy(slot->address, *ipaddr);
+	slot->isStatic = FALSE;
+	LwIP_ResolvePinnedHost(slot);
+	return TRUE;
+}
+
+/**
+ * @brief  Unpins a host pinned by LwIP_PinHost(), its entry then expires as
+ *         usual
+ * @param  ipaddr the host's address
+ * @retval None
+ */
+void LwIP_UnpinHost(const ip_addr_t *ipaddr) {
+	if (ip_addr_isany(ipaddr)) {
+		return;
+	}
+	for (uint_fast8_t i = 1U; i <= LWIP_PINNED_HOSTS; ++i) {
+		if (ip_addr_cmp(&PinnedHosts[i].address, ipaddr)) {
+			LwIP_ReleasePinnedHost(&PinnedHosts[i]);
+			ip_addr_set_zero(&PinnedHosts[i].address);
+		}
+	}
+}
+
+/**
+ * @brief  Resolves the gateway and every pinned host which is not yet
+ *         static. Called when the link comes up or the address changes, and
+ *         with the ARP timer until each has been resolved.
+ * @param  None
+ * @retval None
+ */
+void LwIP_ResolvePinnedHosts(void) {
+	if (!ip_addr_cmp(&PinnedHosts[0].address, &gnetif.gw)) {
+		LwIP_ReleasePinnedHost(&PinnedHosts[0]);
+		ip_addr_copy(PinnedHosts[0].address, gnetif.gw);
+	}
+	for (uint_fast8_t i = 0U; i <= LWIP_PINNED_HOSTS; ++i) {
+		LwIP_ResolvePinnedHost(&PinnedHosts[i]);
+	}
+}
+
+/**
+ * @brief  Releases the static entries of every pinned host, which may have
+ *         changed while the link was down or may no longer be on the subnet
+ *         after an address change. They are resolved again by
+ *         LwIP_ResolvePinnedHosts().
+ * @param  None
+ * @retval None
+ */
+void LwIP_ReleasePinnedHosts(void) {
+	for (uint_fast8_t i = 0U; i <= LWIP_PINNED_HOSTS; ++i) {
+		LwIP_ReleasePinnedHost(&PinnedHosts[i]);
+	}
+}
+
+/**
+ * @brief  Restarts the keepalive and retransmission timeouts of every
+ *         established TCP connection, as if its peer had just been heard
+ *         from. While the link is down this keeps the connections open, and
+ *         once it is back up the connections carry on as before.
+ * @param  retransmit TRUE to retransmit any unacknowledged data at once,
+ *         instead of after the backed off timeout
+ * @retval None
+ */
+static void LwIP_RefreshConnections(bool retransmit) {
+	for (struct tcp_pcb *pcb = tcp_active_pcbs; pcb != NULL; pcb = pcb->next) {
+		if (pcb->state == ESTABLISHED) {
+			pcb->tmr = tcp_ticks;
+			pcb->keep_cnt_sent = 0U;
+			pcb->nrtx = 0U;
+			if ((retransmit == TRUE) && (pcb->unacked != NULL)) {
+				tcp_rexmit_rto(pcb);
+			}
+		}
+	}
+}
+
+/**
+ * @brief  Called when the link goes down. Established TCP connections are
+ *         held open for up to LWIP_LINK_HOLD_MS, so a client whose cable is
+ *         plugged back in carries on in the same session with the same
+ *         configuration.
+ * @param  None
+ * @retval None
+ */
+void LwIP_LinkDown(void) {
+	LinkDownTime = GetLocalTime();
+	LinkRecovering = false;
+	++LinkDowns;
+}
+
+/**
+ * @brief  Called once the interface is up again after the link comes back.
+ *         The held connections retransmit what was in flight straight
+ *         away, and the time until sample data flows again is measured.
+ * @param  None
+ * @retval None
+ */
+void LwIP_LinkUp(void) {
+	LwIP_RefreshConnections(TRUE);
+	LinkUpTime = GetLocalTime();
+	LinkRecovering = (LinkDowns > 0U) ? TRUE : FALSE;
+}
+
+/**
+ * @brief  Indicates if the Ethernet link is up
+ * @param  None
+ * @retval TRUE if the link is up
+ */
+bool LwIP_IsLinkUp(void) {
+	return (netif_is_link_up(&gnetif) != 0U) ? TRUE : FALSE;
+}
+
+/**
+ * @brief  Called whenever sample data is handed to a destination. The first
+ *         call after the link comes back up ends the recovery time.
+ * @param  None
+ * @retval None
+ */
+void LwIP_NoteDataFlowing(void) {
+	if (LinkRecovering == TRUE) {
+		LinkRecoveryTime = (uint32_t) (GetLocalTime() - LinkUpTime);
+		LinkRecovering = FALSE;
+	}
+}
+
+/**
+ * @brief  Retrieves the number of times the link has gone down and the time
+ *         from the link last coming back up to sample data flowing again
+ * @param  downs filled with the number of times the link has gone down
+ * @param  recovery filled with the recovery time in us, 0 until measured
+ * @retval None
+ */
+void LwIP_GetLinkRecovery(uint32_t *downs, uint32_t *recovery) {
+	*downs = LinkDowns;
+	*recovery = LinkRecoveryTime;
+}
+
+/**
+ * @brief  Sets the keepalive of the server connections, applied to every
+ *         connection using keepalive now and to those accepted later, and
+ *         the stall timeout after which a peer which has stopped
+ *         acknowledging data is taken to be gone. Together they tear down
+ *         the connection of a host which vanished without a FIN in seconds.
+ * @param  idle the idle time before the first probe in ms
+ * @param  interval the time between probes in ms
+ * @param  count the number of unanswered probes before the connection is
+ *         aborted
+ * @param  stall the stall timeout in ms, 0 to disable it
+ * @retval None
+ */
+void LwIP_SetKeepalive(uint32_t idle, uint32_t interval, uint32_t count, uint32_t stall) {
+	KeepaliveIdle = idle;
+	KeepaliveInterval = interval;
+	KeepaliveCount = count;
+	StallTimeout = stall;
+	for (struct tcp_pcb *pcb = tcp_active_pcbs; pcb != NULL; pcb = pcb->next) {
+		if ((pcb->so_options & SOF_KEEPALIVE) != 0U) {
+			LwIP_EnableKeepalive(pcb);
+		}
+	}
+}
+
+/**
+ * @brief  Retrieves the settings of LwIP_SetKeepalive()
+ * @param  idle filled with the idle time before the first probe in ms
+ * @param  interval filled with the time between probes in ms
+ * @param  count filled with the number of probes
+ * @param  stall filled with the stall timeout in ms
+ * @retval None
+ */
+void LwIP_GetKeepalive(uint32_t *idle, uint32_t *interval, uint32_t *count, uint32_t *stall) {
+	*idle = KeepaliveIdle;
+	*interval = KeepaliveInterval;
+	*count = KeepaliveCount;
+	*stall = StallTimeout;
+}
+
+/**
+ * @brief  Turns on keepalive for a server connection with the configured
+ *         timing
+ * @param  pcb the connection
+ * @retval None
+ */
+void LwIP_EnableKeepalive(struct tcp_pcb *pcb) {
+	pcb->so_options |= SOF_KEEPALIVE;
+	pcb->keep_idle = KeepaliveIdle;
+	pcb->keep_intvl = KeepaliveInterval;
+	pcb->keep_cnt = KeepaliveCount;
+}
+
+/**
+ * @brief  Checks if the peer of a server connection has left sent data
+ *         unacknowledged for longer than the stall timeout. Called from the
+ *         connection's poll callback, the server updating progress whenever
+ *         data is acknowledged. The time is held while nothing is
+ *         outstanding and while the link is down, when the connection is
+ *         being kept open on purpose.
+ * @param  pcb the connection
+ * @param  progress the local time the peer last acknowledged data
+ * @retval TRUE if the peer is taken to be gone and the connection should be
+ *         aborted
+ */
+bool LwIP_IsPeerStalled(const struct tcp_pcb *pcb, uint64_t *progress) {
+	const uint64_t now = GetLocalTime();
+	if ((pcb->unacked == NULL) || (StallTimeout == 0U) || (netif_is_link_up(&gnetif) == 0U)) {
+		*progress = now;
+		return FALSE;
+	}
+	return ((now - *progress) >= ((uint64_t) StallTimeout * 1000U)) ? TRUE : FALSE;
+}
+
+/**
+ * @brief  Retrieves the address the interface should come up with. An
+ *         address the interface still holds from before the link went down
+ *         is kept, since changing it would abort every TCP connection. A
+ *         saved static address is used as is. Otherwise the last DHCP lease
+ *         is reused straight away and confirmed by DHCP in the background,
+ *         so the board is reachable without waiting for a server.
+ * @param  ipaddr filled with the IP address, 0 if DHCP must assign one
+ * @param  netmask filled with the netmask
+ * @param  gw filled with the gateway
+ * @retval DHCP_STATIC if DHCP is not used, DHCP_START if it must be started
+ */
+uint8_t LwIP_LoadAddress(ip_addr_t *ipaddr, ip_addr_t *netmask, ip_addr_t *gw) {
+	if (!ip_addr_isany(&gnetif.ip_addr)) {
+		ip_addr_copy(*ipaddr, gnetif.ip_addr);
+		ip_addr_copy(*netmask, gnetif.netmask);
+		ip_addr_copy(*gw, gnetif.gw);
+#ifdef USE_DHCP
+		if (LwIP_ReadWord(ADDR_NET_STATIC_MARKER) != NETWORK_STATIC_MARKER) {
+			/* A DHCP address is confirmed as a reused lease, so it is kept if no server answers */
+			LeaseReused = TRUE;
+			return DHCP_START;
+		}
+#endif
+		return DHCP_STATIC;
+	}
+	if (LwIP_ReadWord(ADDR_NET_STATIC_MARKER) == NETWORK_STATIC_MARKER) {
+		LwIP_ReadAddresses(ADDR_NET_STATIC_ADDRESS, ipaddr, netmask, gw);
+		return DHCP_STATIC;
+	}
+#ifdef USE_DHCP
+	LeaseReused = (LwIP_ReadWord(ADDR_NET_LEASE_MARKER) == NETWORK_LEASE_MARKER) ? TRUE : FALSE;
+	if (LeaseReused == TRUE) {
+		LwIP_ReadAddresses(ADDR_NET_LEASE_ADDRESS, ipaddr, netmask, gw);
+	} else {
+		ip_addr_set_zero(ipaddr);
+		ip_addr_set_zero(netmask);
+		ip_addr_set_zero(gw);
+	}
+	return DHCP_START;
+#else
+	IP4_ADDR(ipaddr, IP_ADDR0, IP_ADDR1, IP_ADDR2, IP_ADDR3);
+	IP4_ADDR(netmask, NETMASK_ADDR0, NETMASK_ADDR1 , NETMASK_ADDR2, NETMASK_ADDR3);
+	IP4_ADDR(gw, GW_ADDR0, GW_ADDR1, GW_ADDR2, GW_ADDR3);
+	return DHCP_STATIC;
+#endif
+}
+
+/**
+ * @brief  Saves a static address to use from the next reset on, or clears it
+ *         to go back to DHCP. The marker is written last so that an
+ *         interrupted save leaves the previous mode.
+ * @param  ipaddr the IP address, NULL to use DHCP
+ * @param  netmask the netmask
+ * @param  gw the gateway
+ * @retval TRUE if the address was saved
+ */
+bool LwIP_SaveStaticAddress(const ip_addr_t *ipaddr, const ip_addr_t *netmask, const ip_addr_t *gw) {
+	if (ipaddr == NULL) {
+		return LwIP_WriteWord(ADDR_NET_STATIC_MARKER, 0U);
+	}
+	return LwIP_WriteWord(ADDR_NET_STATIC_MARKER, 0U) && LwIP_WriteAddresses(ADDR_NET_STATIC_ADDRESS, ipaddr, netmask, gw)
+			&& LwIP_WriteWord(ADDR_NET_STATIC_MARKER, NETWORK_STATIC_MARKER);
+}
 /**
  * @brief  Initializes the lwIP stack
  * @param  None
@@ -78,10 +559,7 @@ void LwIP_Init(void) {
 	struct ip_addr ipaddr;
 	struct ip_addr netmask;
 	struct ip_addr gw;
-#ifndef USE_DHCP
-	uint8_t iptab[4] = {0};
-	uint8_t iptxt[20];
-#endif
+	uint8_t state;
 
 	/* Initializes the dynamic memory heap defined by MEM_SIZE.*/
 	mem_init();
@@ -89,15 +567,8 @@ void LwIP_Init(void) {
 	/* Initializes the memory pools defined by MEMP_NUM_x.*/
 	memp_init();
 
-#ifdef USE_DHCP
-	ipaddr.addr = 0U;
-	netmask.addr = 0U;
-	gw.addr = 0U;
-#else
-	IP4_ADDR(&ipaddr, IP_ADDR0, IP_ADDR1, IP_ADDR2, IP_ADDR3);
-	IP4_ADDR(&netmask, NETMASK_ADDR0, NETMASK_ADDR1 , NETMASK_ADDR2, NETMASK_ADDR3);
-	IP4_ADDR(&gw, GW_ADDR0, GW_ADDR1, GW_ADDR2, GW_ADDR3);
-#endif
+	/* A static address or the last lease is used at once, DHCP starts without one */
+	state = LwIP_LoadAddress(&ipaddr, &netmask, &gw);
 
 	/* - netif_add(struct netif *netif, struct ip_addr *ipaddr,
 	 struct ip_addr *netmask, struct ip_addr *gw,
@@ -122,18 +593,16 @@ void LwIP_Init(void) {
 
 		/* When the netif is fully configured this function must be called.*/
 		netif_set_up(&gnetif);
+		LwIP_ResolvePinnedHosts();
 #ifdef USE_DHCP
-		DHCP_state = DHCP_START;
-#else
+		DHCP_state = state;
+#endif /* USE_DHCP */
 #ifdef DEBUG
-		iptab[0] = IP_ADDR3;
-		iptab[1] = IP_ADDR2;
-		iptab[2] = IP_ADDR1;
-		iptab[3] = IP_ADDR0;
-
-		printf("Static IP Address: %d.%d.%d.%d\n\r", iptab[3], iptab[2], iptab[1], iptab[0]);
+		if (ipaddr.addr != 0U) {
+			printf("%s IP Address: %d.%d.%d.%d\n\r", (state == DHCP_STATIC) ? "Static" : "Reused DHCP",
+					ip4_addr1(&ipaddr), ip4_addr2(&ipaddr), ip4_addr3(&ipaddr), ip4_addr4(&ipaddr));
+		}
 #endif /* DEBUG */
-#endif /* USE_DHCP */
 	} else {
 		/*  When the netif link is down this function must be called.*/
 		netif_set_down(&gnetif);
@@ -149,43 +618,70 @@ void LwIP_Init(void) {
 	netif_set_link_callback(&gnetif, ETH_link_callback);
 }
 
+/**
+ * @brief  The lwIP time base of a NO_SYS port, from which the SNMP agent
+ *         reports sysUpTime
+ * @param  None
+ * @retval The time since start up in ms, wrapping
+ */
+u32_t sys_now(void) {
+	return (u32_t) (GetLocalTime() / 1000U);
+}
+
 /**
  * @brief  Called when a frame is received
  * @param  None
  * @retval None
  */
 void LwIP_Pkt_Handle(void) {
+	PROFILE_BEGIN();
 	/* Read a received packet from the Ethernet buffers and send it to the lwIP for handling */
 	ethernetif_input(&gnetif);
+	PROFILE_END(PROFILE_LWIP_PKT_HANDLE);
 }
 
 /**
- * @brief  LwIP periodic tasks
+ * @brief  LwIP periodic tasks. Returns at once until the earliest timer is
+ *         due, which is then scheduled as a deadline for the next one.
  * @param  localtime the current LocalTime value
  * @retval None
  */
 void LwIP_Periodic_Handle(__IO uint64_t localtime) {
+	if (TimersDue == false) {
+		return;
+	}
+	TimersDue = false;
+
 	uint32_t time = ((uint32_t) (localtime / 1000U));
+	uint32_t next = ARP_TMR_INTERVAL;
 #if LWIP_TCP
 	/* TCP periodic process every 5 ms */
 	if (time - TCPTimer >= TCP_TMR_INTERVAL) {
 		TCPTimer = time;
+		if ((netif_is_link_up(&gnetif) == 0U) && ((localtime - LinkDownTime) < (LWIP_LINK_HOLD_MS * 1000ULL))) {
+			/* Hold the connections open while the link is down */
+			LwIP_RefreshConnections(FALSE);
+		}
 		tcp_tmr();
 	}
+	next = LwIP_TimerRemaining(TCPTimer, TCP_TMR_INTERVAL, time, next);
 #endif
 
 	/* ARP periodic process every 5s */
 	if ((time - ARPTimer) >= ARP_TMR_INTERVAL) {
 		ARPTimer = time;
 		etharp_tmr();
+		LwIP_ResolvePinnedHosts();
 	}
+	next = LwIP_TimerRemaining(ARPTimer, ARP_TMR_INTERVAL, time, next);
 
 #ifdef USE_DHCP
 	/* Fine DHCP periodic process every 500ms */
 	if (time - DHCPfineTimer >= DHCP_FINE_TIMER_MSECS) {
 		DHCPfineTimer = time;
 		dhcp_fine_tmr();
-		if ((DHCP_state != DHCP_ADDRESS_ASSIGNED) && (DHCP_state != DHCP_TIMEOUT) && (DHCP_state != DHCP_LINK_DOWN)) {
+		if ((DHCP_state != DHCP_ADDRESS_ASSIGNED) && (DHCP_state != DHCP_TIMEOUT) && (DHCP_state != DHCP_LINK_DOWN)
+				&& (DHCP_state != DHCP_STATIC)) {
 			/* process DHCP state machine */
 			LwIP_DHCP_Process_Handle();
 #ifdef DEBUG
@@ -194,14 +690,20 @@ void LwIP_Periodic_Handle(__IO uint64_t localtime) {
 #endif
 		}
 	}
+	next = LwIP_TimerRemaining(DHCPfineTimer, DHCP_FINE_TIMER_MSECS, time, next);
 
 	/* DHCP Coarse periodic process every 60s */
 	if (time - DHCPcoarseTimer >= DHCP_COARSE_TIMER_MSECS) {
 		DHCPcoarseTimer = time;
 		dhcp_coarse_tmr();
 	}
-
+	next = LwIP_TimerRemaining(DHCPcoarseTimer, DHCP_COARSE_TIMER_MSECS, time, next);
 #endif
+
+	if (Timer_ScheduleDeadline(&LwIP_TimersDue, next * 1000U) == false) {
+		/* Without a deadline, check the timers on the next pass */
+		TimersDue = true;
+	}
 }
 
 #ifdef USE_DHCP
@@ -230,15 +732,26 @@ void LwIP_DHCP_Process_Handle() {
 		break;
 
 	case DHCP_WAIT_ADDRESS: {
-		/* Read the new IP address */
-		IPaddress = gnetif.ip_addr.addr;
-
-		if (IPaddress != 0) {
+		/* The interface may already hold a reused lease, so wait for DHCP itself to bind */
+		if (gnetif.dhcp->state == DHCP_BOUND) {
+			/* Read the new IP address */
+			IPaddress = gnetif.ip_addr.addr;
 			DHCP_state = DHCP_ADDRESS_ASSIGNED;
 
 			/* Stop DHCP */
 			dhcp_stop(&gnetif);
 
+			/* Announce the address, which may differ from the reused lease, and resolve the hosts on its subnet */
+			etharp_gratuitous(&gnetif);
+			LwIP_ReleasePinnedHosts();
+			LwIP_ResolvePinnedHosts();
+
+			/* Keep the lease for the next reset, the marker is written last */
+			if ((LwIP_WriteAddresses(ADDR_NET_LEASE_ADDRESS, &gnetif.ip_addr, &gnetif.netmask, &gnetif.gw) == FALSE)
+					|| (LwIP_WriteWord(ADDR_NET_LEASE_MARKER, NETWORK_LEASE_MARKER) == FALSE)) {
+				LwIP_WriteWord(ADDR_NET_LEASE_MARKER, 0U);
+			}
+
 			iptab[0] = (uint8_t) (IPaddress >> 24);
 			iptab[1] = (uint8_t) (IPaddress >> 16);
 			iptab[2] = (uint8_t) (IPaddress >> 8);
@@ -258,21 +771,28 @@ void LwIP_DHCP_Process_Handle() {
 				/* Stop DHCP */
 				dhcp_stop(&gnetif);
 
-				/* Static address used */
-				IP4_ADDR(&ipaddr, IP_ADDR0, IP_ADDR1, IP_ADDR2, IP_ADDR3);
-				IP4_ADDR(&netmask, NETMASK_ADDR0, NETMASK_ADDR1, NETMASK_ADDR2, NETMASK_ADDR3);
-				IP4_ADDR(&gw, GW_ADDR0, GW_ADDR1, GW_ADDR2, GW_ADDR3);
-				netif_set_addr(&gnetif, &ipaddr, &netmask, &gw);
+				/* Without a server the reused lease is kept, otherwise the static address is used */
+				if (LeaseReused == FALSE) {
+					IP4_ADDR(&ipaddr, IP_ADDR0, IP_ADDR1, IP_ADDR2, IP_ADDR3);
+					IP4_ADDR(&netmask, NETMASK_ADDR0, NETMASK_ADDR1, NETMASK_ADDR2, NETMASK_ADDR3);
+					IP4_ADDR(&gw, GW_ADDR0, GW_ADDR1, GW_ADDR2, GW_ADDR3);
+					netif_set_addr(&gnetif, &ipaddr, &netmask, &gw);
+					Tekdaqc_LocatorClientIPSet(ipaddr.addr);
+					etharp_gratuitous(&gnetif);
+					LwIP_ReleasePinnedHosts();
+					LwIP_ResolvePinnedHosts();
+				}
 
 #ifdef DEBUG
 				printf("DHCP Timeout\n\r");
 
-				iptab[0] = IP_ADDR3;
-				iptab[1] = IP_ADDR2;
-				iptab[2] = IP_ADDR1;
-				iptab[3] = IP_ADDR0;
+				iptab[0] = ip4_addr4(&gnetif.ip_addr);
+				iptab[1] = ip4_addr3(&gnetif.ip_addr);
+				iptab[2] = ip4_addr2(&gnetif.ip_addr);
+				iptab[3] = ip4_addr1(&gnetif.ip_addr);
 
-				printf("Static IP address:  %d.%d.%d.%d\n\r", iptab[3], iptab[2], iptab[1], iptab[0]);
+				printf("%s IP address:  %d.%d.%d.%d\n\r", (LeaseReused == TRUE) ? "Reused DHCP" : "Static", iptab[3],
+						iptab[2], iptab[1], iptab[0]);
 #endif /* DEBUG */
 			}
 		}
@@ -89,10 +89,11 @@ uint8_t Rx_Buff[ETH_RXBUFNB][ETH_RX_BUF_SIZE]; /* Ethernet Receive Buffer */
 uint8_t Tx_Buff[ETH_TXBUFNB][ETH_TX_BUF_SIZE]; /* Ethernet Transmit Buffer */
 
 #elif defined (__GNUC__) /*!< GNU Compiler */
-ETH_DMADESCTypeDef DMARxDscrTab[ETH_RXBUFNB] __attribute__ ((aligned (4))); /* Ethernet Rx DMA Descriptor */
-ETH_DMADESCTypeDef DMATxDscrTab[ETH_TXBUFNB] __attribute__ ((aligned (4))); /* Ethernet Tx DMA Descriptor */
-uint8_t Rx_Buff[ETH_RXBUFNB][ETH_RX_BUF_SIZE] __attribute__ ((aligned (4))); /* Ethernet Receive Buffer */
-uint8_t Tx_Buff[ETH_TXBUFNB][ETH_TX_BUF_SIZE] __attribute__ ((aligned (4))); /* Ethernet Transmit Buffer */
+/* The descriptors and buffers are kept in SRAM2, away from the CPU's working memory in SRAM1 */
+ETH_DMADESCTypeDef DMARxDscrTab[ETH_RXBUFNB] ETH_DMA_DATA; /* Ethernet Rx DMA Descriptor */
+ETH_DMADESCTypeDef DMATxDscrTab[ETH_TXBUFNB] ETH_DMA_DATA; /* Ethernet Tx DMA Descriptor */
+uint8_t Rx_Buff[ETH_RXBUFNB][ETH_RX_BUF_SIZE] ETH_DMA_DATA; /* Ethernet Receive Buffer */
+uint8_t Tx_Buff[ETH_TXBUFNB][ETH_TX_BUF_SIZE] ETH_DMA_DATA; /* Ethernet Transmit Buffer */
 #elif defined  (__TASKING__) /*!< TASKING Compiler */
 __align(4) 
  ETH_DMADESCTypeDef DMARxDscrTab[ETH_RXBUFNB];/* Ethernet Rx MA Descriptor */
@@ -121,6 +122,7 @@ __IO uint32_t Frame_Rx_index;
 /** @defgroup ETH_Private_FunctionPrototypes
  * @{
  */
+static void ETH_SetMIIClockRange(void);
 /**
  * @}
  */
@@ -259,6 +261,47 @@ void ETH_StructInit(ETH_InitTypeDef* ETH_InitStruct) {
 	ETH_InitStruct->ETH_DMAArbitration = ETH_DMAArbitration_RoundRobin_RxTx_1_1;
 }
 
+/**
+ * @brief  Configures the MDC clock range of the MII management interface
+ *   for the current HCLK.
+ * @param  None
+ * @retval None
+ */
+static void ETH_SetMIIClockRange(void) {
+	uint32_t tmpreg = 0;
+	RCC_ClocksTypeDef rcc_clocks;
+	uint32_t hclk = 60000000;
+	/*---------------------- ETHERNET MACMIIAR Configuration -------------------*/
+	/* Get the ETHERNET MACMIIAR value */
+	tmpreg = ETH ->MACMIIAR;
+	/* Clear CSR Clock Range CR[2:0] bits */
+	tmpreg &= MACMIIAR_CR_MASK;
+	/* Get hclk frequency value */
+	RCC_GetClocksFreq(&rcc_clocks);
+	hclk = rcc_clocks.HCLK_Frequency;
+
+	/* Set CR bits depending on hclk value */
+	if ((hclk >= 20000000) && (hclk < 35000000)) {
+		/* CSR Clock Range between 20-35 MHz */
+		tmpreg |= (uint32_t) ETH_MACMIIAR_CR_Div16;
+	} else if ((hclk >= 35000000) && (hclk < 60000000)) {
+		/* CSR Clock Range between 35-60 MHz */
+		tmpreg |= (uint32_t) ETH_MACMIIAR_CR_Div26;
+	} else if ((hclk >= 60000000) && (hclk < 100000000)) {
+		/* CSR Clock Range between 60-100 MHz */
+		tmpreg |= (uint32_t) ETH_MACMIIAR_CR_Div42;
+	} else if ((hclk >= 100000000) && (hclk < 150000000)) {
+		/* CSR Clock Range between 100-150 MHz */
+		tmpreg |= (uint32_t) ETH_MACMIIAR_CR_Div62;
+	} else /* ((hclk >= 150000000)&&(hclk <= 168000000)) */
+	{
+		/* CSR Clock Range between 150-168 MHz */
+		tmpreg |= (uint32_t) ETH_MACMIIAR_CR_Div102;
+	}
+
+	/* Write to ETHERNET MAC MIIAR: Configure the ETHERNET CSR Clock Range */ETH ->MACMIIAR = (uint32_t) tmpreg;
+}
+
 /**
  * @brief  Initializes the ETHERNET peripheral according to the specified
  *   parameters in the ETH_InitStruct .
@@ -269,9 +312,53 @@ void ETH_StructInit(ETH_InitTypeDef* ETH_InitStruct) {
  *         ETH_SUCCESS: Ethernet successfully initialized
  */
 uint32_t ETH_Init(ETH_InitTypeDef* ETH_InitStruct, uint16_t PHYAddress) {
+	__IO uint32_t timeout = 0;
+	if (ETH_ResetPHY(PHYAddress) == ETH_SUCCESS) {
+		/* Delay to assure PHY reset */
+		_eth_delay_(PHY_RESET_DELAY);
+
+		if (ETH_InitStruct->ETH_AutoNegotiation != ETH_AutoNegotiation_Disable) {
+			/* We wait for linked status...*/
+			do {
+				timeout++;
+			} while (!(ETH_ReadPHYRegister(PHYAddress, PHY_BSR) & PHY_Linked_Status) && (timeout < PHY_READ_TO));
+		}
+	}
+	return ETH_InitAfterPHYReset(ETH_InitStruct, PHYAddress);
+}
+
+/**
+ * @brief  Puts the external PHY in reset. The PHY must be given PHY_RESET_DELAY
+ *   to come out of reset before ETH_InitAfterPHYReset() is called, which
+ *   other initialization may be done during.
+ * @param PHYAddress: external PHY address
+ * @retval ETH_ERROR: the reset could not be written
+ *         ETH_SUCCESS: the PHY is resetting
+ */
+uint32_t ETH_ResetPHY(uint16_t PHYAddress) {
+	ETH_SetMIIClockRange();
+	/*-------------------- PHY initialization and configuration ----------------*/
+	/* Put the PHY in reset mode */
+	if (!(ETH_WritePHYRegister(PHYAddress, PHY_BCR, PHY_Reset ))) {
+		/* Return ERROR in case of write timeout */
+		return ETH_ERROR;
+	}
+	return ETH_SUCCESS;
+}
+
+/**
+ * @brief  Initializes the ETHERNET peripheral according to the specified
+ *   parameters in the ETH_InitStruct, once the PHY has come out of reset.
+ *   If the link is not yet up the MAC is configured for 100M full duplex and
+ *   the negotiation is left to the link callback.
+ * @param ETH_InitStruct: pointer to a ETH_InitTypeDef structure that contains
+ *   the configuration information for the specified ETHERNET peripheral.
+ * @param PHYAddress: external PHY address
+ * @retval ETH_ERROR: Ethernet initialization failed
+ *         ETH_SUCCESS: Ethernet successfully initialized
+ */
+uint32_t ETH_InitAfterPHYReset(ETH_InitTypeDef* ETH_InitStruct, uint16_t PHYAddress) {
 	uint32_t RegValue = 0, tmpreg = 0;
-	RCC_ClocksTypeDef rcc_clocks;
-	uint32_t hclk = 60000000;
 	__IO uint32_t timeout = 0, err = ETH_SUCCESS;
 	/* Check the parameters */
 	/* MAC --------------------------*/
@@ -322,53 +409,11 @@ uint32_t ETH_Init(ETH_InitTypeDef* ETH_InitStruct, uint16_t PHYAddress) {
 	assert_param(IS_ETH_DMA_DESC_SKIP_LENGTH(ETH_InitStruct->ETH_DescriptorSkipLength));
 	assert_param(IS_ETH_DMA_ARBITRATION_ROUNDROBIN_RXTX(ETH_InitStruct->ETH_DMAArbitration));
 	/*-------------------------------- MAC Config ------------------------------*/
-	/*---------------------- ETHERNET MACMIIAR Configuration -------------------*/
-	/* Get the ETHERNET MACMIIAR value */
-	tmpreg = ETH ->MACMIIAR;
-	/* Clear CSR Clock Range CR[2:0] bits */
-	tmpreg &= MACMIIAR_CR_MASK;
-	/* Get hclk frequency value */
-	RCC_GetClocksFreq(&rcc_clocks);
-	hclk = rcc_clocks.HCLK_Frequency;
-
-	/* Set CR bits depending on hclk value */
-	if ((hclk >= 20000000) && (hclk < 35000000)) {
-		/* CSR Clock Range between 20-35 MHz */
-		tmpreg |= (uint32_t) ETH_MACMIIAR_CR_Div16;
-	} else if ((hclk >= 35000000) && (hclk < 60000000)) {
-		/* CSR Clock Range between 35-60 MHz */
-		tmpreg |= (uint32_t) ETH_MACMIIAR_CR_Div26;
-	} else if ((hclk >= 60000000) && (hclk < 100000000)) {
-		/* CSR Clock Range between 60-100 MHz */
-		tmpreg |= (uint32_t) ETH_MACMIIAR_CR_Div42;
-	} else if ((hclk >= 100000000) && (hclk < 150000000)) {
-		/* CSR Clock Range between 100-150 MHz */
-		tmpreg |= (uint32_t) ETH_MACMIIAR_CR_Div62;
-	} else /* ((hclk >= 150000000)&&(hclk <= 168000000)) */
-	{
-		/* CSR Clock Range between 150-168 MHz */
-		tmpreg |= (uint32_t) ETH_MACMIIAR_CR_Div102;
-	}
-
-	/* Write to ETHERNET MAC MIIAR: Configure the ETHERNET CSR Clock Range */ETH ->MACMIIAR = (uint32_t) tmpreg;
-	/*-------------------- PHY initialization and configuration ----------------*/
-	/* Put the PHY in reset mode */
-	if (!(ETH_WritePHYRegister(PHYAddress, PHY_BCR, PHY_Reset ))) {
-		/* Return ERROR in case of write timeout */
-		err = ETH_ERROR;
-		goto error;
-	}
-
-	/* Delay to assure PHY reset */_eth_delay_(PHY_RESET_DELAY );
+	ETH_SetMIIClockRange();
 
 	if (ETH_InitStruct->ETH_AutoNegotiation != ETH_AutoNegotiation_Disable ) {
-		/* We wait for linked status...*/
-		do {
-			timeout++;
-		} while (!(ETH_ReadPHYRegister(PHYAddress, PHY_BSR) & PHY_Linked_Status )&& (timeout < PHY_READ_TO));
-
-		/* Return ERROR in case of timeout */
-		if(timeout == PHY_READ_TO)
+		/* Negotiation is left to the link callback if the link is not up yet */
+		if (!(ETH_ReadPHYRegister(PHYAddress, PHY_BSR) & PHY_Linked_Status))
 		{
 			err = ETH_ERROR;
 			goto error;
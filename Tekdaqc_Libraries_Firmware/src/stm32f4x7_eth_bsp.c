@@ -53,16 +53,20 @@ extern __IO uint8_t DHCP_state;
 
 /* Private function prototypes -----------------------------------------------*/
 static void ETH_GPIO_Config(void);
+static void ETH_MACDMA_Reset(void);
 static void ETH_MACDMA_Config(void);
 
 /* Private functions ---------------------------------------------------------*/
 
 /**
- * @brief  ETH_BSP_Config
+ * @brief  Starts the Ethernet bring up: configures the pins, resets the MAC
+ *   and DMA and puts the PHY in reset. ETH_BSP_Complete() finishes the bring
+ *   up once the PHY has had PHY_RESET_DELAY to come out of reset, so other
+ *   initialization can be done in the meantime.
  * @param  None
  * @retval None
  */
-void ETH_BSP_Config(void) {
+void ETH_BSP_Start(void) {
 	/***************************************************************************
 	 NOTE:
 	 When using Systick to manage the delay in Ethernet driver, the Systick
@@ -73,6 +77,19 @@ void ETH_BSP_Config(void) {
 	/* Configure the GPIO ports for ethernet pins */
 	ETH_GPIO_Config();
 
+	/* Reset the Ethernet MAC/DMA */
+	ETH_MACDMA_Reset();
+
+	/* Put the PHY in reset */
+	ETH_ResetPHY(DP83848_PHY_ADDRESS);
+}
+
+/**
+ * @brief  Completes the Ethernet bring up started by ETH_BSP_Start().
+ * @param  None
+ * @retval None
+ */
+void ETH_BSP_Complete(void) {
 	/* Configure the Ethernet MAC/DMA */
 	ETH_MACDMA_Config();
 
@@ -86,14 +103,17 @@ void ETH_BSP_Config(void) {
 
 	/* Configure the EXTI for Ethernet link status. */
 	Eth_Link_EXTIConfig();
+
+	/* Configure the Ethernet DMA receive interrupt */
+	Eth_Rx_ITConfig();
 }
 
 /**
- * @brief  Configures the Ethernet Interface
+ * @brief  Resets the Ethernet MAC and DMA
  * @param  None
  * @retval None
  */
-static void ETH_MACDMA_Config(void) {
+static void ETH_MACDMA_Reset(void) {
 	/* Enable ETHERNET clock  */
 	RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_ETH_MAC | RCC_AHB1Periph_ETH_MAC_Tx | RCC_AHB1Periph_ETH_MAC_Rx, ENABLE);
 
@@ -106,7 +126,14 @@ static void ETH_MACDMA_Config(void) {
 	/* Wait for software reset */
 	while (ETH_GetSoftwareResetStatus() == SET)
 		;
+}
 
+/**
+ * @brief  Configures the Ethernet Interface
+ * @param  None
+ * @retval None
+ */
+static void ETH_MACDMA_Config(void) {
 	/* ETHERNET Configuration --------------------------------------------------*/
 	/* Call ETH_StructInit if you don't like to configure all ETH_InitStructure parameter */
 	ETH_StructInit(&ETH_InitStructure);
@@ -149,7 +176,7 @@ static void ETH_MACDMA_Config(void) {
 	ETH_InitStructure.ETH_DMAArbitration = ETH_DMAArbitration_RoundRobin_RxTx_2_1;
 
 	/* Configure Ethernet */
-	EthStatus = ETH_Init(&ETH_InitStructure, DP83848_PHY_ADDRESS);
+	EthStatus = ETH_InitAfterPHYReset(&ETH_InitStructure, DP83848_PHY_ADDRESS);
 }
 
 /**
@@ -282,15 +309,35 @@ void Eth_Link_EXTIConfig(void) {
 	EXTI_InitStructure.EXTI_LineCmd = ENABLE;
 	EXTI_Init(&EXTI_InitStructure);
 
-	/* Enable and set the EXTI interrupt to priority 1*/
-	NVIC_InitStructure.NVIC_IRQChannel = EXTI15_10_IRQn;
-	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
+	/* Enable the EXTI interrupt, which shares the ADS1256 DRDY vector and so its priority */
+	NVIC_InitStructure.NVIC_IRQChannel = ETH_LINK_EXTI_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = ETH_LINK_PREEMPT_PRIORITY;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+}
+
+/**
+ * @brief  Configures the Ethernet DMA to interrupt on each received frame and
+ *   when it runs out of receive descriptors.
+ * @param  None
+ * @retval None
+ */
+void Eth_Rx_ITConfig(void) {
+	NVIC_InitTypeDef NVIC_InitStructure;
+
+	ETH_DMAITConfig(ETH_DMA_IT_NIS | ETH_DMA_IT_R | ETH_DMA_IT_AIS | ETH_DMA_IT_RBU, ENABLE);
+
+	NVIC_InitStructure.NVIC_IRQChannel = ETH_IRQn;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = ETH_DMA_PREEMPT_PRIORITY;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
 	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
 	NVIC_Init(&NVIC_InitStructure);
 }
 
 /**
- * @brief  This function handles Ethernet link status.
+ * @brief  This function handles Ethernet link status. It reads the PHY over MDIO, which is far too slow for the
+ *   interrupt it shares with the ADS1256 DRDY line, so it is run from the program loop through Eth_Link_Deferred().
  * @param  None
  * @retval None
  */
@@ -305,6 +352,15 @@ void Eth_Link_ITHandler(uint16_t PHYAddress) {
 	}
 }
 
+/**
+ * @brief  Handles a link interrupt deferred from the EXTI interrupt to the program loop.
+ * @param  argument: The PHY address
+ * @retval None
+ */
+void Eth_Link_Deferred(uint32_t argument) {
+	Eth_Link_ITHandler((uint16_t) argument);
+}
+
 /**
  * @brief  Link callback function, this function is called on change of link status.
  * @param  The network interface
@@ -316,10 +372,7 @@ void ETH_link_callback(struct netif *netif) {
 	struct ip_addr ipaddr;
 	struct ip_addr netmask;
 	struct ip_addr gw;
-#ifndef USE_DHCP
-	uint8_t iptab[4] = {0};
-	uint8_t iptxt[20];
-#endif /* USE_DHCP */
+	uint8_t state;
 
 	if (netif_is_link_up(netif)) {
 		/* Restart the autonegotiation */
@@ -376,36 +429,35 @@ void ETH_link_callback(struct netif *netif) {
 		/* Restart MAC interface */
 		ETH_Start();
 
+		/* The address held from before the link went down, a static address or the last lease is used at once */
+		state = LwIP_LoadAddress(&ipaddr, &netmask, &gw);
 #ifdef USE_DHCP
-		ipaddr.addr = 0;
-		netmask.addr = 0;
-		gw.addr = 0;
-		DHCP_state = DHCP_START;
-#else
-		IP4_ADDR(&ipaddr, IP_ADDR0, IP_ADDR1, IP_ADDR2, IP_ADDR3);
-		IP4_ADDR(&netmask, NETMASK_ADDR0, NETMASK_ADDR1 , NETMASK_ADDR2, NETMASK_ADDR3);
-		IP4_ADDR(&gw, GW_ADDR0, GW_ADDR1, GW_ADDR2, GW_ADDR3);
+		DHCP_state = state;
 #endif /* USE_DHCP */
 
 		netif_set_addr(&gnetif, &ipaddr, &netmask, &gw);
 
-		/* When the netif is fully configured this function must be called.*/
+		/* When the netif is fully configured this function must be called, it also sends the gratuitous ARP */
 		netif_set_up(&gnetif);
 
+		/* The pinned hosts may have changed while the link was down */
+		LwIP_ReleasePinnedHosts();
+		LwIP_ResolvePinnedHosts();
+
+		/* Resume the connections held open while the link was down */
+		LwIP_LinkUp();
+
 #ifdef DEBUG
 		printf("Network cable is now connected\n\r");
 #endif /* DEBUG */
-#ifndef USE_DHCP
-		/* Display static IP address */
-		iptab[0] = IP_ADDR3;
-		iptab[1] = IP_ADDR2;
-		iptab[2] = IP_ADDR1;
-		iptab[3] = IP_ADDR0;
 #ifdef DEBUG
-		printf("Static IP address: %d.%d.%d.%d\n\r", iptab[3], iptab[2], iptab[1], iptab[0]);
+		if (ipaddr.addr != 0U) {
+			printf("%s IP address: %d.%d.%d.%d\n\r", (state == DHCP_STATIC) ? "Static" : "Reused DHCP",
+					ip4_addr1(&ipaddr), ip4_addr2(&ipaddr), ip4_addr3(&ipaddr), ip4_addr4(&ipaddr));
+		}
 #endif /* DEBUG */
-#endif /* USE_DHCP */
 	} else {
+		LwIP_LinkDown();
 		ETH_Stop();
 #ifdef USE_DHCP
 		DHCP_state = DHCP_LINK_DOWN;